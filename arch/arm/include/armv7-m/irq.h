@@ -162,6 +162,13 @@ struct xcptcontext
   uint8_t nsyscalls;
   struct xcpt_syscall_s syscall[CONFIG_SYS_NNEST];
 
+#endif
+
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+  /* Precomputed RBAR/RASR value pairs of the per-task MPU regions */
+
+  uint32_t mpu[2 * CONFIG_ARMV7M_MPU_NTASKREGIONS];
+
 #endif
 
   /* Register save area */
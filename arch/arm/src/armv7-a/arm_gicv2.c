@@ -126,6 +126,9 @@ void arm_gic0_initialize(void)
 
   DEBUGVERIFY(irq_attach(GIC_IRQ_SGI1, arm_start_handler, NULL));
   DEBUGVERIFY(irq_attach(GIC_IRQ_SGI2, arm_pause_handler, NULL));
+#ifdef CONFIG_SMP_CALL
+  DEBUGVERIFY(irq_attach(GIC_IRQ_SGI3, arm_call_handler, NULL));
+#endif
 #endif
 
   arm_gic_dump("Exit arm_gic0_initialize", true, 0);
@@ -523,6 +526,63 @@ int up_prioritize_irq(int irq, int priority)
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Restrict the set of CPUs to which an SPI may be delivered.
+ *
+ *   Since this API is not supported on all architectures, it should be
+ *   avoided in common implementations where possible.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int up_affinity_irq(int irq, cpu_set_t cpuset)
+{
+  /* Only SPIs may be routed.  SGIs and PPIs are private to each CPU. */
+
+  if (irq > GIC_IRQ_SGI15 && irq < NR_IRQS)
+    {
+      uintptr_t regaddr;
+      uint32_t regval;
+      uint32_t targets;
+
+      regaddr = GIC_ICDIPTR(irq);
+      regval  = getreg32(regaddr);
+
+      /* Keep the current CPU targets that are in the set.  If there are
+       * none, then route the SPI to the lowest numbered CPU in the set.
+       */
+
+      targets = ((regval & GIC_ICDIPTR_ID_MASK(irq)) >>
+                 GIC_ICDIPTR_ID_SHIFT(irq)) & (uint32_t)cpuset;
+      if (targets == 0)
+        {
+          targets = (uint32_t)cpuset & (~(uint32_t)cpuset + 1);
+        }
+
+      if (targets == 0 || targets > 0xff)
+        {
+          return -EINVAL;
+        }
+
+      /* Write the new CPU targets to the distributor Interrupt Processor
+       * Targets Register (GIC_ICDIPTR).
+       */
+
+      regval &= ~GIC_ICDIPTR_ID_MASK(irq);
+      regval |= GIC_ICDIPTR_ID(irq, targets);
+      putreg32(regval, regaddr);
+
+      arm_gic_dump("Exit up_affinity_irq", false, irq);
+      return OK;
+    }
+
+  return -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Name: arm_gic_irq_trigger
  *
@@ -0,0 +1,149 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arch_dcache_list.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "cache.h"
+
+#ifdef CONFIG_ARMV7M_DCACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arch_dcache_list
+ *
+ * Description:
+ *   Apply one D-Cache maintenance operation by address to each range of
+ *   the list, with one pair of barriers for the whole list.
+ *
+ ****************************************************************************/
+
+static void arch_dcache_list(uint32_t regaddr,
+                             FAR const struct arch_dcache_range_s *list,
+                             int nlist)
+{
+  uint32_t ssize;
+  int i;
+
+  ssize = CCSIDR_LINESIZE(getreg32(NVIC_CCSIDR));
+
+  ARM_DSB();
+
+  for (i = 0; i < nlist; i++)
+    {
+      arch_dcache_mva(regaddr, list[i].start, list[i].end, ssize);
+    }
+
+  ARM_DSB();
+  ARM_ISB();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arch_invalidate_dcache_list
+ *
+ * Description:
+ *   Invalidate the data cache within each range of a scatter list.
+ *
+ * Input Parameters:
+ *   list  - The list of address ranges
+ *   nlist - The number of entries in the list
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arch_invalidate_dcache_list(FAR const struct arch_dcache_range_s *list,
+                                 int nlist)
+{
+  arch_dcache_list(NVIC_DCIMVAC, list, nlist);
+}
+
+#ifndef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+/****************************************************************************
+ * Name: arch_clean_dcache_list
+ *
+ * Description:
+ *   Clean the data cache within each range of a scatter list.
+ *
+ * Input Parameters:
+ *   list  - The list of address ranges
+ *   nlist - The number of entries in the list
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arch_clean_dcache_list(FAR const struct arch_dcache_range_s *list,
+                            int nlist)
+{
+  arch_dcache_list(NVIC_DCCMVAC, list, nlist);
+}
+
+/****************************************************************************
+ * Name: arch_flush_dcache_list
+ *
+ * Description:
+ *   Clean and invalidate the data cache within each range of a scatter
+ *   list.
+ *
+ * Input Parameters:
+ *   list  - The list of address ranges
+ *   nlist - The number of entries in the list
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arch_flush_dcache_list(FAR const struct arch_dcache_range_s *list,
+                            int nlist)
+{
+  arch_dcache_list(NVIC_DCCIMVAC, list, nlist);
+}
+#endif /* !CONFIG_ARMV7M_DCACHE_WRITETHROUGH */
+
+#endif /* CONFIG_ARMV7M_DCACHE */
@@ -0,0 +1,182 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arch_dma_coherent.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/mm/gran.h>
+
+#include "mpu.h"
+#include "cache.h"
+
+#ifdef CONFIG_ARMV7M_DMA_COHERENT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DMAPOOL_SIZE CONFIG_ARMV7M_DMA_COHERENT_SIZE
+#define DMAPOOL_LOG2 CONFIG_ARMV7M_DMA_COHERENT_LOG2GRAN
+
+/* An MPU region must be a power of two in size and aligned to its size */
+
+#if (DMAPOOL_SIZE & (DMAPOOL_SIZE - 1)) != 0
+#  error CONFIG_ARMV7M_DMA_COHERENT_SIZE must be a power of two
+#endif
+
+#if DMAPOOL_LOG2 < 5
+#  error CONFIG_ARMV7M_DMA_COHERENT_LOG2GRAN must be at least 5 (32 bytes)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The DMA-coherent pool */
+
+static uint8_t g_dmapool[DMAPOOL_SIZE]
+  __attribute__((aligned(DMAPOOL_SIZE)));
+
+/* The granule allocator that manages the pool; NULL until the first
+ * allocation.
+ */
+
+static GRAN_HANDLE g_dmaheap;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arch_dma_initialize
+ *
+ * Description:
+ *   Map the pool as non-cacheable memory and create its granule allocator.
+ *   If the MPU is not yet enabled (as in FLAT builds), it is enabled with
+ *   the default memory map as background for privileged accesses.
+ *
+ ****************************************************************************/
+
+static void arch_dma_initialize(void)
+{
+  /* Make sure that no lines of the pool remain in the D-Cache */
+
+  arch_flush_dcache((uintptr_t)g_dmapool,
+                    (uintptr_t)g_dmapool + DMAPOOL_SIZE);
+
+  mpu_priv_noncache((uintptr_t)g_dmapool, DMAPOOL_SIZE);
+  if ((getreg32(MPU_CTRL) & MPU_CTRL_ENABLE) == 0)
+    {
+      mpu_control(true, false, true);
+    }
+
+  ARM_DSB();
+  ARM_ISB();
+
+  g_dmaheap = gran_initialize(g_dmapool, DMAPOOL_SIZE, DMAPOOL_LOG2,
+                              DMAPOOL_LOG2);
+  DEBUGASSERT(g_dmaheap != NULL);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arch_dma_alloc
+ *
+ * Description:
+ *   Allocate memory from the DMA-coherent pool.  The pool is mapped by an
+ *   MPU region as normal, non-cacheable memory so that DMA descriptors and
+ *   small DMA buffers allocated from it need no cache maintenance at all.
+ *
+ * Input Parameters:
+ *   size - The size of the allocation in bytes
+ *
+ * Returned Value:
+ *   The allocated memory, aligned to the granule size of the pool and
+ *   so to a cache line; NULL if the pool is exhausted.
+ *
+ ****************************************************************************/
+
+FAR void *arch_dma_alloc(size_t size)
+{
+  /* The pool is set up on first use, normally from driver initialization.
+   * Locking the scheduler keeps two first users from both setting it up.
+   */
+
+  if (g_dmaheap == NULL)
+    {
+      sched_lock();
+      if (g_dmaheap == NULL)
+        {
+          arch_dma_initialize();
+        }
+
+      sched_unlock();
+    }
+
+  return g_dmaheap != NULL ? gran_alloc(g_dmaheap, size) : NULL;
+}
+
+/****************************************************************************
+ * Name: arch_dma_free
+ *
+ * Description:
+ *   Return memory allocated by arch_dma_alloc() to the DMA-coherent pool.
+ *
+ * Input Parameters:
+ *   mem  - The memory returned by arch_dma_alloc()
+ *   size - The size passed to arch_dma_alloc()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arch_dma_free(FAR void *mem, size_t size)
+{
+  DEBUGASSERT(g_dmaheap != NULL);
+  gran_free(g_dmaheap, mem, size);
+}
+
+#endif /* CONFIG_ARMV7M_DMA_COHERENT */
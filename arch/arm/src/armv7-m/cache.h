@@ -72,6 +72,17 @@
 #define CCSIDR_LSSHIFT(n) \
   (((n) & NVIC_CCSIDR_LINESIZE_MASK) >> NVIC_CCSIDR_LINESIZE_SHIFT)
 
+/* Derived from the above:
+ *
+ *   CCSIDR_LINESIZE - Returns the cache line size in bytes
+ *   CCSIDR_SIZE     - Returns the total cache size in bytes
+ */
+
+#define CCSIDR_LINESIZE(n) \
+  (1 << (CCSIDR_LSSHIFT(n) + 4))
+#define CCSIDR_SIZE(n) \
+  ((CCSIDR_SETS(n) + 1) * (CCSIDR_WAYS(n) + 1) * CCSIDR_LINESIZE(n))
+
 /* intrinsics are used in these inline functions */
 
 #define arm_isb(n) __asm__ __volatile__ ("isb " #n : : : "memory")
@@ -83,11 +94,23 @@
 #define ARM_DMB()  arm_dmb(15)
 
 /****************************************************************************
- * Inline Functions
+ * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* One entry of a scatter list passed to the arch_*_dcache_list() functions */
+
+struct arch_dcache_range_s
+{
+  uintptr_t start;  /* Start address of the range */
+  uintptr_t end;    /* End address of the range + 1 */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: arm_clz
  *
@@ -110,6 +133,39 @@ static inline uint32_t arm_clz(unsigned int value)
   return ret;
 }
 
+/****************************************************************************
+ * Name: arch_dcache_mva
+ *
+ * Description:
+ *   Apply one D-Cache maintenance operation by address (NVIC_DCIMVAC,
+ *   NVIC_DCCMVAC or NVIC_DCCIMVAC) to each cache line that overlaps the
+ *   range.  No barrier is issued:  The caller brackets one or more calls
+ *   with ARM_DSB().
+ *
+ * Input Parameters:
+ *   regaddr - The address of the maintenance operation register
+ *   start   - virtual start address of region
+ *   end     - virtual end address of region + 1
+ *   ssize   - The cache line size in bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+static inline void arch_dcache_mva(uint32_t regaddr, uintptr_t start,
+                                   uintptr_t end, uint32_t ssize)
+{
+  start &= ~(ssize - 1);
+  while (start < end)
+    {
+      putreg32(start, regaddr);
+      start += ssize;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: arch_enable_icache
  *
@@ -467,6 +523,88 @@ void arch_flush_dcache_all(void);
 #  define arch_flush_dcache_all()
 #endif
 
+/****************************************************************************
+ * Name: arch_invalidate_dcache_list, arch_clean_dcache_list and
+ *       arch_flush_dcache_list
+ *
+ * Description:
+ *   Like arch_invalidate_dcache(), arch_clean_dcache() and
+ *   arch_flush_dcache(), but for a scatter list of ranges, such as the
+ *   descriptor and the buffer of one DMA transfer.  The barriers are issued
+ *   once for the whole list rather than once for each range.
+ *
+ * Input Parameters:
+ *   list  - The list of address ranges
+ *   nlist - The number of entries in the list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Same as for the single range functions.  The maintenance operations
+ *   are complete when the function returns but are not ordered among
+ *   themselves.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+void arch_invalidate_dcache_list(FAR const struct arch_dcache_range_s *list,
+                                 int nlist);
+#ifdef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+#  define arch_clean_dcache_list(l,n)
+#  define arch_flush_dcache_list(l,n) arch_invalidate_dcache_list(l,n)
+#else
+void arch_clean_dcache_list(FAR const struct arch_dcache_range_s *list,
+                            int nlist);
+void arch_flush_dcache_list(FAR const struct arch_dcache_range_s *list,
+                            int nlist);
+#endif
+#else
+#  define arch_invalidate_dcache_list(l,n)
+#  define arch_clean_dcache_list(l,n)
+#  define arch_flush_dcache_list(l,n)
+#endif
+
+/****************************************************************************
+ * Name: arch_dma_alloc
+ *
+ * Description:
+ *   Allocate memory from the DMA-coherent pool.  The pool is mapped by an
+ *   MPU region as normal, non-cacheable memory so that DMA descriptors and
+ *   small DMA buffers allocated from it need no cache maintenance at all.
+ *
+ * Input Parameters:
+ *   size - The size of the allocation in bytes
+ *
+ * Returned Value:
+ *   The allocated memory, aligned to the granule size of the pool and
+ *   so to a cache line; NULL if the pool is exhausted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DMA_COHERENT
+FAR void *arch_dma_alloc(size_t size);
+#endif
+
+/****************************************************************************
+ * Name: arch_dma_free
+ *
+ * Description:
+ *   Return memory allocated by arch_dma_alloc() to the DMA-coherent pool.
+ *
+ * Input Parameters:
+ *   mem  - The memory returned by arch_dma_alloc()
+ *   size - The size passed to arch_dma_alloc()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DMA_COHERENT
+void arch_dma_free(FAR void *mem, size_t size);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -63,4 +63,20 @@ void itm_syslog_initialize(void);
 #  define itm_syslog_initialize()
 #endif
 
+/****************************************************************************
+ * Name: itm_note_initialize
+ *
+ * Description:
+ *   Start streaming the scheduler notes in Common Trace Format over ITM
+ *   port CONFIG_ARMV7M_ITMNOTE_PORT (the CTF metadata goes to the next
+ *   port).  itm_syslog_initialize() must have been called first.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARMV7M_ITMSYSLOG) && defined(CONFIG_DRIVER_NOTE_CTF)
+int itm_note_initialize(void);
+#else
+#  define itm_note_initialize() (0)
+#endif
+
 #endif /* __ARCH_ARM_SRC_ARMV7_M_ITM_SYSLOG_H */
@@ -205,6 +205,55 @@ uint8_t mpu_log2regionfloor(size_t size);
 
 uint32_t mpu_subregion(uintptr_t base, size_t size, uint8_t l2size);
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+/****************************************************************************
+ * Name: mpu_taskinitialize
+ *
+ * Description:
+ *   Initialize the per-task MPU region set of a new task.  All regions are
+ *   disabled except, if CONFIG_ARMV7M_MPU_STACKGUARD is selected, the stack
+ *   guard in region set index 0.  Called from up_initial_state().
+ *
+ ****************************************************************************/
+
+struct tcb_s;
+void mpu_taskinitialize(FAR struct tcb_s *tcb);
+
+/****************************************************************************
+ * Name: mpu_taskregion
+ *
+ * Description:
+ *   Compute one region of the per-task MPU region set of 'tcb'.  If 'tcb'
+ *   is the running task, the region is also loaded into the MPU.
+ *
+ * Input Parameters:
+ *   tcb   - The task that owns the region set
+ *   index - The index in the set, 0 .. CONFIG_ARMV7M_MPU_NTASKREGIONS-1
+ *   base  - The base address of the memory to map
+ *   size  - The size of the memory to map.  Zero disables the region.
+ *   attr  - The MPU_RASR_* attribute, access permission and XN bits
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if 'index' is out of range.
+ *
+ ****************************************************************************/
+
+int mpu_taskregion(FAR struct tcb_s *tcb, int index, uintptr_t base,
+                   size_t size, uint32_t attr);
+
+/****************************************************************************
+ * Name: mpu_taskswitch
+ *
+ * Description:
+ *   Load the per-task MPU region set of the task about to be resumed.
+ *   Called with interrupts disabled on the exception return path when a
+ *   context switch is pending.
+ *
+ ****************************************************************************/
+
+void mpu_taskswitch(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -302,6 +351,52 @@ static inline void mpu_priv_stronglyordered(uintptr_t base, size_t size)
 }
 #endif
 
+/****************************************************************************
+ * Name: mpu_priv_noncache
+ *
+ * Description:
+ *   Configure a region for privileged, normal, non-cacheable memory.  This
+ *   is the mapping used for memory shared with DMA without cache
+ *   maintenance.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+static inline void mpu_priv_noncache(uintptr_t base, size_t size)
+{
+  unsigned int region = mpu_allocregion();
+  uint32_t     regval;
+  uint8_t      l2size;
+  uint8_t      subregions;
+
+  /* Select the region */
+
+  putreg32(region, MPU_RNR);
+
+  /* Select the region base address */
+
+  putreg32((base & MPU_RBAR_ADDR_MASK) | region | MPU_RBAR_VALID, MPU_RBAR);
+
+  /* Select the region size and the sub-region map */
+
+  l2size     = mpu_log2regionceil(size);
+  subregions = mpu_subregion(base, size, l2size);
+
+  /* Then configure the region */
+
+  regval = MPU_RASR_ENABLE                              | /* Enable region  */
+           MPU_RASR_SIZE_LOG2((uint32_t)l2size)         | /* Region size    */
+           ((uint32_t)subregions << MPU_RASR_SRD_SHIFT) | /* Sub-regions    */
+           (1 << MPU_RASR_TEX_SHIFT)                    | /* Normal         */
+                                                          /* Not Cacheable  */
+                                                          /* Not Bufferable */
+           MPU_RASR_S                                   | /* Shareable      */
+           MPU_RASR_AP_RWNO                             | /* P:RW   U:None  */
+           MPU_RASR_XN;                                   /* No execution   */
+  putreg32(regval, MPU_RASR);
+}
+#endif
+
 /****************************************************************************
  * Name: mpu_user_flash
  *
@@ -409,6 +409,7 @@
 #define NVIC_ICIALLU                    (ARMV7M_NVIC_BASE + NVIC_ICIALLU_OFFSET)
 #define NVIC_ICIMVAU                    (ARMV7M_NVIC_BASE + NVIC_ICIMVAU_OFFSET)
 #define NVIC_DCIMVAU                    (ARMV7M_NVIC_BASE + NVIC_DCIMVAU_OFFSET)
+#define NVIC_DCIMVAC                    NVIC_DCIMVAU /* Same register; invalidate is to PoC */
 #define NVIC_DCISW                      (ARMV7M_NVIC_BASE + NVIC_DCISW_OFFSET)
 #define NVIC_DCCMVAU                    (ARMV7M_NVIC_BASE + NVIC_DCCMVAU_OFFSET)
 #define NVIC_DCCMVAC                    (ARMV7M_NVIC_BASE + NVIC_DCCMVAC_OFFSET)
@@ -572,6 +573,23 @@
 #define NVIC_SYSHCON_BUSFAULTENA        (1 << 17) /* Bit 17: BusFault enabled */
 #define NVIC_SYSHCON_USGFAULTENA        (1 << 18) /* Bit 18: UsageFault enabled */
 
+/* Configurable fault status register (CFAULTS) */
+
+#define NVIC_CFAULTS_UNDEFINSTR         (1 << 16) /* Bit 16: Undefined instruction UsageFault */
+#define NVIC_CFAULTS_INVSTATE           (1 << 17) /* Bit 17: Invalid state UsageFault */
+#define NVIC_CFAULTS_INVPC              (1 << 18) /* Bit 18: Invalid PC load UsageFault */
+#define NVIC_CFAULTS_NOCP               (1 << 19) /* Bit 19: No coprocessor UsageFault */
+#define NVIC_CFAULTS_UNALIGNED          (1 << 24) /* Bit 24: Unaligned access UsageFault */
+#define NVIC_CFAULTS_DIVBYZERO          (1 << 25) /* Bit 25: Divide by zero UsageFault */
+
+/* Coprocessor Access Control Register (CPACR) */
+
+#define NVIC_CPACR_CP_SHIFT(n)          (2*(n))
+#define NVIC_CPACR_CP_MASK(n)           (3 << NVIC_CPACR_CP_SHIFT(n))
+#  define NVIC_CPACR_CP_DENY(n)         (0 << NVIC_CPACR_CP_SHIFT(n))
+#  define NVIC_CPACR_CP_PRIV(n)         (1 << NVIC_CPACR_CP_SHIFT(n))
+#  define NVIC_CPACR_CP_FULL(n)         (3 << NVIC_CPACR_CP_SHIFT(n))
+
 /* Cache Level ID register (Cortex-M7) */
 
 #define NVIC_CLIDR_L1CT_SHIFT           (0)      /* Bits 0-2: Level 1 cache type */
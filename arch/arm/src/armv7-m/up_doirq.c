@@ -50,6 +50,11 @@
 #include "up_arch.h"
 #include "up_internal.h"
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+#  include "sched/sched.h"
+#  include "mpu.h"
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -91,6 +96,18 @@ uint32_t *up_doirq(int irq, uint32_t *regs)
    * switch occurred during interrupt processing.
    */
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+  /* Load the MPU regions of the task being resumed.  All context switches,
+   * including those requested through SVCall, pass through here.
+   */
+
+  if (regs != (uint32_t *)CURRENT_REGS)
+    {
+      mpu_taskswitch(this_task());
+    }
+
+#endif
+
   regs = (uint32_t *)CURRENT_REGS;
 
   /* Restore the previous value of CURRENT_REGS.  NULL would indicate that
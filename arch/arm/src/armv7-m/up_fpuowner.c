@@ -0,0 +1,283 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_fpuowner.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+#include "up_arch.h"
+#include "nvic.h"
+#include "psr.h"
+#include "cache.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7M_FPUOWNER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Access to the FPU is controlled by the CP10 and CP11 fields of CPACR */
+
+#define FPU_CPACR_MASK  (NVIC_CPACR_CP_MASK(10) | NVIC_CPACR_CP_MASK(11))
+#define FPU_CPACR_FULL  (NVIC_CPACR_CP_FULL(10) | NVIC_CPACR_CP_FULL(11))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is the task whose floating point state is currently held in the FPU
+ * registers.  The saved FPU state in the register save area of every other
+ * TCB is the current FPU state of that task.  NULL means that the FPU
+ * registers hold no task's floating point state.
+ */
+
+static FAR struct tcb_s *g_fpuowner;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_fpuaccess
+ *
+ * Description:
+ *   Enable or disable access to the FPU (CP10 and CP11).
+ *
+ ****************************************************************************/
+
+static inline void up_fpuaccess(bool enable)
+{
+  uint32_t regval;
+
+  regval  = getreg32(NVIC_CPACR);
+  regval &= ~FPU_CPACR_MASK;
+
+  if (enable)
+    {
+      regval |= FPU_CPACR_FULL;
+    }
+
+  putreg32(regval, NVIC_CPACR);
+
+  /* The new access permissions must be visible before the next floating
+   * point instruction executes.
+   */
+
+  ARM_DSB();
+  ARM_ISB();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_fpuinitialize
+ *
+ * Description:
+ *   Initialize FPU ownership tracking.  The FPU is enabled when this
+ *   function is called and any floating point state in the FPU belongs to
+ *   the IDLE task that is performing the initialization.
+ *
+ *   This function must be called from up_irqinitialize() after the
+ *   UsageFault handler has been attached.
+ *
+ ****************************************************************************/
+
+void up_fpuinitialize(void)
+{
+  g_fpuowner = this_task();
+  up_fpuaccess(true);
+}
+
+/****************************************************************************
+ * Name: up_fpuswitch
+ *
+ * Description:
+ *   Called on the exception return path when a context switch is pending,
+ *   after the ready-to-run list has been updated.  Rather than restoring
+ *   the FPU registers, FPU access is enabled only if the task being
+ *   resumed is the owner of the FPU.  Any other task will take a NOCP
+ *   UsageFault on its first floating point instruction.
+ *
+ ****************************************************************************/
+
+void up_fpuswitch(void)
+{
+  up_fpuaccess(this_task() == g_fpuowner);
+}
+
+/****************************************************************************
+ * Name: up_fpufault
+ *
+ * Description:
+ *   This is the UsageFault exception handler.  A NOCP UsageFault occurs when
+ *   a task that does not own the FPU executes a floating point instruction.
+ *   Save the FPU state of the previous owner in its TCB, restore the FPU
+ *   state of the current task from its TCB, and make the current task the
+ *   FPU owner.  The faulting instruction is then re-executed on return from
+ *   the exception.
+ *
+ *   Any other UsageFault is fatal.
+ *
+ ****************************************************************************/
+
+int up_fpufault(int irq, FAR void *context, FAR void *arg)
+{
+  FAR uint32_t *regs = (FAR uint32_t *)context;
+  FAR struct tcb_s *rtcb = this_task();
+  uint32_t cfaults = getreg32(NVIC_CFAULTS);
+
+  /* The FPU may not be used in interrupt handling logic; the interrupted
+   * task state would be corrupted.
+   */
+
+  if ((cfaults & NVIC_CFAULTS_NOCP) == 0 ||
+      (regs[REG_XPSR] & ARMV7M_XPSR_ISR_MASK) != 0)
+    {
+      (void)up_irq_save();
+      _alert("PANIC!!! Usage Fault:\n");
+      _alert("  IRQ: %d regs: %p\n", irq, regs);
+      _alert("  CFAULTS: %08x PC: %08x xPSR: %08x\n",
+             cfaults, regs[REG_PC], regs[REG_XPSR]);
+      PANIC();
+    }
+
+  /* Clear the NOCP fault status (write one to clear) and enable the FPU */
+
+  putreg32(NVIC_CFAULTS_NOCP, NVIC_CFAULTS);
+  up_fpuaccess(true);
+
+  /* Transfer ownership of the FPU to the current task */
+
+  if (g_fpuowner != rtcb)
+    {
+      if (g_fpuowner != NULL)
+        {
+          up_savefpu(g_fpuowner->xcp.regs);
+        }
+
+      up_restorefpu(rtcb->xcp.regs);
+      g_fpuowner = rtcb;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: up_fpurelease
+ *
+ * Description:
+ *   A TCB is being released.  If the task owned the FPU, then the FPU
+ *   registers no longer hold the floating point state of any task.
+ *
+ ****************************************************************************/
+
+void up_fpurelease(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  if (g_fpuowner == tcb)
+    {
+      g_fpuowner = NULL;
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: up_fpusigsave and up_fpusigrestore
+ *
+ * Description:
+ *   Signal delivery saves the full register state of the task in a local
+ *   register save area and restores it when the signal handler returns.
+ *   The FPU registers in the TCB register save area are current only if
+ *   the task is not the FPU owner.  These functions save the current FPU
+ *   state of the running task into the local register save area and
+ *   restore it from there after the signal handler returns.
+ *
+ ****************************************************************************/
+
+void up_fpusigsave(FAR uint32_t *regs)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  if (g_fpuowner == this_task())
+    {
+      up_savefpu(regs);
+    }
+
+  up_irq_restore(flags);
+}
+
+void up_fpusigrestore(FAR const uint32_t *regs)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  if (g_fpuowner == rtcb)
+    {
+      up_restorefpu(regs);
+    }
+  else
+    {
+      /* Ownership was lost while the signal handler ran.  The state
+       * restored by the next NOCP fault must be the pre-signal state.
+       */
+
+      memcpy(&rtcb->xcp.regs[REG_S0], &regs[REG_S0], 4 * SW_FPU_REGS);
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_ARMV7M_FPUOWNER */
@@ -51,6 +51,10 @@
 #include "psr.h"
 #include "exc_return.h"
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+#  include "mpu.h"
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -140,6 +144,13 @@ void up_initial_state(struct tcb_s *tcb)
 
 #endif /* CONFIG_ARMV7M_CMNVECTOR && !CONFIG_ARMV7M_LAZYFPU && CONFIG_ARCH_FPU */
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+  /* Precompute the per-task MPU regions of the new task */
+
+  mpu_taskinitialize(tcb);
+
+#endif
+
   /* Enable or disable interrupts, based on user configuration */
 
 #ifdef CONFIG_SUPPRESS_INTERRUPTS
@@ -41,9 +41,13 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <errno.h>
 
 #include <nuttx/syslog/syslog.h>
+#include <nuttx/sched_note.h>
 
 #include "nvic.h"
 #include "itm.h"
@@ -72,6 +76,10 @@
 #  define CONFIG_ARMV7M_ITMSYSLOG_PORT 0
 #endif
 
+#ifndef CONFIG_ARMV7M_ITMNOTE_PORT
+#  define CONFIG_ARMV7M_ITMNOTE_PORT 1
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -81,6 +89,13 @@
 static int itm_putc(int ch);
 static int itm_flush(void);
 
+#ifdef CONFIG_DRIVER_NOTE_CTF
+/* CTF trace channel methods */
+
+static ssize_t itm_note_stream(FAR const uint8_t *buffer, size_t buflen);
+static ssize_t itm_note_metadata(FAR const uint8_t *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -94,6 +109,16 @@ static const struct syslog_channel_s g_itm_channel =
   .sc_flush = itm_flush,
 };
 
+#ifdef CONFIG_DRIVER_NOTE_CTF
+/* This structure describes the ITM CTF trace channel */
+
+static const struct note_ctf_channel_s g_itm_note_channel =
+{
+  itm_note_metadata,
+  itm_note_stream
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -139,6 +164,68 @@ static int itm_flush(void)
   return OK;
 }
 
+/****************************************************************************
+ * Name: itm_write
+ *
+ * Description:
+ *   Send a binary buffer over one ITM port, a word at a time where
+ *   possible.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVER_NOTE_CTF
+static ssize_t itm_write(int port, FAR const uint8_t *buffer, size_t buflen)
+{
+  size_t nsent = 0;
+  uint32_t word;
+
+  if ((getreg32(ITM_TCR) & ITM_TCR_ITMENA_Msk) == 0 ||
+      (getreg32(ITM_TER) & (1 << port)) == 0)
+    {
+      return -ENODEV;
+    }
+
+  while (buflen - nsent >= 4)
+    {
+      word = (uint32_t)buffer[nsent] |
+             (uint32_t)buffer[nsent + 1] << 8 |
+             (uint32_t)buffer[nsent + 2] << 16 |
+             (uint32_t)buffer[nsent + 3] << 24;
+
+      while (getreg32(ITM_PORT(port)) == 0);
+      putreg32(word, ITM_PORT(port));
+      nsent += 4;
+    }
+
+  while (nsent < buflen)
+    {
+      while (getreg32(ITM_PORT(port)) == 0);
+      putreg8(buffer[nsent], ITM_PORT(port));
+      nsent++;
+    }
+
+  return nsent;
+}
+
+/****************************************************************************
+ * Name: itm_note_stream and itm_note_metadata
+ *
+ * Description:
+ *   The CTF trace channel methods
+ *
+ ****************************************************************************/
+
+static ssize_t itm_note_stream(FAR const uint8_t *buffer, size_t buflen)
+{
+  return itm_write(CONFIG_ARMV7M_ITMNOTE_PORT, buffer, buflen);
+}
+
+static ssize_t itm_note_metadata(FAR const uint8_t *buffer, size_t buflen)
+{
+  return itm_write(CONFIG_ARMV7M_ITMNOTE_PORT + 1, buffer, buflen);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -189,4 +276,19 @@ void itm_syslog_initialize(void)
   (void)syslog_channel(&g_itm_channel);
 }
 
+/****************************************************************************
+ * Name: itm_note_initialize
+ *
+ * Description:
+ *   Start streaming the scheduler notes in Common Trace Format over ITM.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVER_NOTE_CTF
+int itm_note_initialize(void)
+{
+  return note_ctf_channel(&g_itm_note_channel);
+}
+#endif
+
 #endif /* CONFIG_ARMV7M_ITMSYSLOG */
@@ -40,9 +40,16 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <errno.h>
 #include <assert.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/tls.h>
+
+#include "sched/sched.h"
 #include "mpu.h"
+#include "cache.h"
 #include "up_internal.h"
 
 /****************************************************************************
@@ -54,6 +61,24 @@
 #  define CONFIG_ARM_MPU_NREGIONS 8
 #endif
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+/* The number of RBAR/RASR words in a per-task region set */
+
+#define MPU_TASKWORDS (2 * CONFIG_ARMV7M_MPU_NTASKREGIONS)
+
+/* The stack guard is the first aligned 32-byte block of the stack above the
+ * thread-local data kept at the bottom of the stack.
+ */
+
+#ifdef CONFIG_TLS
+#  define MPU_GUARDBASE(tcb) \
+     (((uintptr_t)(tcb)->stack_alloc_ptr + TLS_INFO_SIZE + 31) & ~31)
+#else
+#  define MPU_GUARDBASE(tcb) \
+     (((uintptr_t)(tcb)->stack_alloc_ptr + 31) & ~31)
+#endif
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -86,6 +111,22 @@ static const uint8_t g_ls_regionmask[9] =
 
 static uint8_t g_region;
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+/* The first of the regions reserved for the per-task region sets */
+
+static uint8_t g_taskregion;
+
+/* The values currently held in the per-task regions and the region set
+ * with all per-task regions disabled.  The RBAR words always carry the
+ * VALID bit and the region number, so a zero RBAR word means that the
+ * regions have not yet been reserved (or, in a TCB, that the task was not
+ * created through up_initial_state(), as is the case for the IDLE task).
+ */
+
+static uint32_t g_taskloaded[MPU_TASKWORDS];
+static uint32_t g_taskidle[MPU_TASKWORDS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -191,6 +232,75 @@ static inline uint32_t mpu_subregion_ls(size_t offset, uint8_t l2size)
   return g_ls_regionmask[nsrs];
 }
 
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+/****************************************************************************
+ * Name: mpu_load1 and mpu_load2
+ *
+ * Description:
+ *   Write the RBAR/RASR pairs of one or two regions with a single block
+ *   store to the RBAR register and its aliases.  Each RBAR value carries
+ *   the VALID bit and its own region number so that RNR need not be
+ *   written.
+ *
+ ****************************************************************************/
+
+static inline void mpu_load1(FAR const uint32_t *src)
+{
+  __asm__ __volatile__
+  (
+    "\tldmia %0, {r2-r3}\n"
+    "\tstmia %1, {r2-r3}\n"
+    :
+    : "r" (src), "r" (MPU_RBAR)
+    : "r2", "r3", "memory"
+  );
+}
+
+static inline void mpu_load2(FAR const uint32_t *src)
+{
+  __asm__ __volatile__
+  (
+    "\tldmia %0, {r2-r5}\n"
+    "\tstmia %1, {r2-r5}\n"
+    :
+    : "r" (src), "r" (MPU_RBAR)
+    : "r2", "r3", "r4", "r5", "memory"
+  );
+}
+
+/****************************************************************************
+ * Name: mpu_taskreserve
+ *
+ * Description:
+ *   Reserve the per-task regions following the regions already allocated
+ *   by the chip MPU initialization and disable them.  Called when the first
+ *   task is created, after the chip has set up all of its regions.
+ *
+ ****************************************************************************/
+
+static void mpu_taskreserve(void)
+{
+  int i;
+
+  g_taskregion = mpu_allocregion();
+  for (i = 1; i < CONFIG_ARMV7M_MPU_NTASKREGIONS; i++)
+    {
+      (void)mpu_allocregion();
+    }
+
+  DEBUGASSERT(g_region <= CONFIG_ARM_MPU_NREGIONS);
+
+  for (i = 0; i < MPU_TASKWORDS; i += 2)
+    {
+      g_taskidle[i]       = MPU_RBAR_VALID | (g_taskregion + (i >> 1));
+      g_taskidle[i + 1]   = 0;
+      g_taskloaded[i]     = g_taskidle[i];
+      g_taskloaded[i + 1] = 0;
+      mpu_load1(&g_taskidle[i]);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -314,3 +424,173 @@ uint32_t mpu_subregion(uintptr_t base, size_t size, uint8_t l2size)
   ret |= mpu_subregion_ls(offset, l2size);
   return ret;
 }
+
+#ifdef CONFIG_ARMV7M_MPU_TASKREGIONS
+/****************************************************************************
+ * Name: mpu_taskinitialize
+ *
+ * Description:
+ *   Initialize the per-task MPU region set of a new task.  All regions are
+ *   disabled except, if CONFIG_ARMV7M_MPU_STACKGUARD is selected, the stack
+ *   guard in region set index 0.  Called from up_initial_state().
+ *
+ ****************************************************************************/
+
+void mpu_taskinitialize(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  if (g_taskloaded[0] == 0)
+    {
+      mpu_taskreserve();
+    }
+
+  leave_critical_section(flags);
+
+  for (i = 0; i < MPU_TASKWORDS; i++)
+    {
+      tcb->xcp.mpu[i] = g_taskidle[i];
+    }
+
+#ifdef CONFIG_ARMV7M_MPU_STACKGUARD
+  if (tcb->stack_alloc_ptr != NULL)
+    {
+      (void)mpu_taskregion(tcb, 0, MPU_GUARDBASE(tcb), 32,
+                           MPU_RASR_AP_NONO | MPU_RASR_XN);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mpu_taskregion
+ *
+ * Description:
+ *   Compute one region of the per-task MPU region set of 'tcb'.  If 'tcb'
+ *   is the running task, the region is also loaded into the MPU.
+ *
+ * Input Parameters:
+ *   tcb   - The task that owns the region set
+ *   index - The index in the set, 0 .. CONFIG_ARMV7M_MPU_NTASKREGIONS-1
+ *   base  - The base address of the memory to map
+ *   size  - The size of the memory to map.  Zero disables the region.
+ *   attr  - The MPU_RASR_* attribute, access permission and XN bits
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if 'index' is out of range.
+ *
+ ****************************************************************************/
+
+int mpu_taskregion(FAR struct tcb_s *tcb, int index, uintptr_t base,
+                   size_t size, uint32_t attr)
+{
+  irqstate_t flags;
+  uint32_t rbar;
+  uint32_t rasr;
+  uint32_t mask;
+  uint8_t l2size;
+
+  if (index < 0 || index >= CONFIG_ARMV7M_MPU_NTASKREGIONS)
+    {
+      return -EINVAL;
+    }
+
+  rbar = MPU_RBAR_VALID | (g_taskregion + index);
+  rasr = 0;
+
+  if (size > 0)
+    {
+      /* The region must be aligned to its size.  Grow it until the aligned
+       * region spans the whole of the memory, then disable the sub-regions
+       * that are not needed.
+       */
+
+      l2size = mpu_log2regionceil(size);
+      mask   = (1 << l2size) - 1;
+
+      while ((base & mask) + size > mask + 1)
+        {
+          DEBUGASSERT(l2size < 31);
+          l2size++;
+          mask = (1 << l2size) - 1;
+        }
+
+      rbar |= base & ~mask;
+      rasr  = MPU_RASR_ENABLE                      |
+              MPU_RASR_SIZE_LOG2((uint32_t)l2size) |
+              (mpu_subregion(base, size, l2size) << MPU_RASR_SRD_SHIFT) |
+              (attr & MPU_RASR_ATTR_MASK);
+    }
+
+  /* Update the pair with interrupts disabled so that a context switch never
+   * loads half of it.
+   */
+
+  flags = enter_critical_section();
+  tcb->xcp.mpu[2 * index]     = rbar;
+  tcb->xcp.mpu[2 * index + 1] = rasr;
+
+  if (tcb == this_task())
+    {
+      mpu_taskswitch(tcb);
+      ARM_DSB();
+      ARM_ISB();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mpu_taskswitch
+ *
+ * Description:
+ *   Load the per-task MPU region set of the task about to be resumed.
+ *   Called with interrupts disabled on the exception return path when a
+ *   context switch is pending.
+ *
+ *   Only the regions that differ from the values currently in the MPU are
+ *   written.  Tasks that use the same region set (all tasks without
+ *   private regions, for example) then switch without touching the MPU.
+ *   Adjacent changed regions are written together with one block store.
+ *
+ ****************************************************************************/
+
+void mpu_taskswitch(FAR struct tcb_s *tcb)
+{
+  FAR const uint32_t *set = tcb->xcp.mpu;
+  int i;
+
+  if (set[0] == 0)
+    {
+      set = g_taskidle;
+    }
+
+  for (i = 0; i < MPU_TASKWORDS; i += 2)
+    {
+      if (set[i] == g_taskloaded[i] && set[i + 1] == g_taskloaded[i + 1])
+        {
+          continue;
+        }
+
+      if (i + 2 < MPU_TASKWORDS &&
+          (set[i + 2] != g_taskloaded[i + 2] ||
+           set[i + 3] != g_taskloaded[i + 3]))
+        {
+          mpu_load2(&set[i]);
+          g_taskloaded[i]     = set[i];
+          g_taskloaded[i + 1] = set[i + 1];
+          g_taskloaded[i + 2] = set[i + 2];
+          g_taskloaded[i + 3] = set[i + 3];
+          i += 2;
+        }
+      else
+        {
+          mpu_load1(&set[i]);
+          g_taskloaded[i]     = set[i];
+          g_taskloaded[i + 1] = set[i + 1];
+        }
+    }
+}
+#endif /* CONFIG_ARMV7M_MPU_TASKREGIONS */
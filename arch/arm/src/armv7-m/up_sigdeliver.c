@@ -100,6 +100,9 @@ void up_sigdeliver(void)
 #ifdef CONFIG_BUILD_PROTECTED
   regs[REG_LR]         = rtcb->xcp.saved_lr;
 #endif
+#ifdef CONFIG_ARMV7M_FPUOWNER
+  up_fpusigsave(regs);
+#endif
 
   /* Get a local copy of the sigdeliver function pointer. We do this so that
    * we can nullify the sigdeliver function pointer in the TCB and accept
@@ -144,6 +147,9 @@ void up_sigdeliver(void)
    */
 
   board_autoled_off(LED_SIGNAL);
+#ifdef CONFIG_ARMV7M_FPUOWNER
+  up_fpusigrestore(regs);
+#endif
   up_fullcontextrestore(regs);
 }
 
@@ -101,9 +101,13 @@ static void dispatch_syscall(void)
     " str r5, [sp, #4]\n"          /* Move parameter 5 (if any) into position */
     " str r6, [sp, #8]\n"          /* Move parameter 6 (if any) into position */
     " str lr, [sp, #12]\n"         /* Save lr in the stack frame */
+#ifdef CONFIG_SYSCALL_STATS
+    " bl syscall_dispatch\n"       /* Call the stub and account for it */
+#else
     " ldr ip, =g_stublookup\n"     /* R12=The base of the stub lookup table */
     " ldr ip, [ip, r0, lsl #2]\n"  /* R12=The address of the stub for this syscall */
     " blx ip\n"                    /* Call the stub (modifies lr) */
+#endif
     " ldr lr, [sp, #12]\n"         /* Restore lr */
     " add sp, sp, #16\n"           /* Destroy the stack frame */
     " mov r2, r0\n"                /* R2=Save return value in R2 */
@@ -179,7 +183,7 @@ int up_svcall(int irq, FAR void *context, FAR void *arg)
         {
           DEBUGASSERT(regs[REG_R1] != 0);
           memcpy((uint32_t *)regs[REG_R1], regs, XCPTCONTEXT_SIZE);
-#if defined(CONFIG_ARCH_FPU) && \
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARMV7M_FPUOWNER) && \
     (!defined(CONFIG_ARMV7M_CMNVECTOR) || defined(CONFIG_ARMV7M_LAZYFPU))
           up_savefpu((uint32_t *)regs[REG_R1]);
 #endif
@@ -228,7 +232,7 @@ int up_svcall(int irq, FAR void *context, FAR void *arg)
         {
           DEBUGASSERT(regs[REG_R1] != 0 && regs[REG_R2] != 0);
           memcpy((uint32_t *)regs[REG_R1], regs, XCPTCONTEXT_SIZE);
-#if defined(CONFIG_ARCH_FPU) && \
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARMV7M_FPUOWNER) && \
     (!defined(CONFIG_ARMV7M_CMNVECTOR) || defined(CONFIG_ARMV7M_LAZYFPU))
           up_savefpu((uint32_t *)regs[REG_R1]);
 #endif
@@ -427,6 +431,38 @@ int up_svcall(int irq, FAR void *context, FAR void *arg)
 
           DEBUGASSERT(cmd >= CONFIG_SYS_RESERVED && cmd < SYS_maxsyscall);
 
+#ifdef CONFIG_SYSCALL_FASTPATH
+          /* Perform short, non-blocking system calls right here.  This
+           * avoids the return to dispatch_syscall() in thread mode and the
+           * second trap with SYS_syscall_return.
+           */
+
+          if (syscall_isfast(cmd - CONFIG_SYS_RESERVED))
+            {
+              uintptr_t ret;
+
+              ret = syscall_dispatch(cmd - CONFIG_SYS_RESERVED,
+                                     regs[REG_R1], regs[REG_R2],
+                                     regs[REG_R3], regs[REG_R4],
+                                     regs[REG_R5], regs[REG_R6]);
+
+              /* If the call caused a context switch (sem_post() may), the
+               * registers of the caller have been saved in its TCB.
+               */
+
+              if (CURRENT_REGS != regs)
+                {
+                  rtcb->xcp.regs[REG_R0] = ret;
+                }
+              else
+                {
+                  regs[REG_R0] = ret;
+                }
+
+              break;
+            }
+#endif
+
           /* Make sure that there is a no saved syscall return address.  We
            * cannot yet handle nested system calls.
            */
@@ -97,7 +97,7 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size, bool int_stack)
       /* Skip over the TLS data structure at the bottom of the stack */
 
       DEBUGASSERT((alloc & TLS_STACK_MASK) == 0);
-      start = alloc + sizeof(struct tls_info_s);
+      start = alloc + TLS_INFO_SIZE;
     }
   else
     {
@@ -123,9 +123,11 @@
 int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 {
 #ifdef CONFIG_TLS
-   /* Add the size of the TLS information structure */
+   /* Add the size of the TLS information structure (and of the copy of
+    * the .tdata/.tbss templates)
+    */
 
-   stack_size += sizeof(struct tls_info_s);
+   stack_size += TLS_INFO_SIZE;
 
    /* The allocated stack size must not exceed the maximum possible for the
     * TLS feature.
@@ -246,6 +248,9 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
       /* Initialize the TLS data structure */
 
       memset(tcb->stack_alloc_ptr, 0, sizeof(struct tls_info_s));
+#ifdef CONFIG_TLS_NATIVE
+      tls_native_init((FAR struct tls_info_s *)tcb->stack_alloc_ptr);
+#endif
 
 #ifdef CONFIG_STACK_COLORATION
       /* If stack debug is enabled, then fill the stack with a
@@ -253,8 +258,8 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
        * water marks.
        */
 
-      stack_base = (uintptr_t)tcb->stack_alloc_ptr + sizeof(struct tls_info_s);
-      stack_size = tcb->adj_stack_size - sizeof(struct tls_info_s);
+      stack_base = (uintptr_t)tcb->stack_alloc_ptr + TLS_INFO_SIZE;
+      stack_size = tcb->adj_stack_size - TLS_INFO_SIZE;
       up_stack_color((FAR void *)stack_base, stack_size);
 
 #endif /* CONFIG_STACK_COLORATION */
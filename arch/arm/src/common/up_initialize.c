@@ -191,6 +191,12 @@ void up_initialize(void)
   arm_timer_initialize();
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* Start the CPU cycle counter used for execution time accounting */
+
+  arm_cyclecount_initialize();
+#endif
+
 #ifdef CONFIG_MM_IOB
   /* Initialize IO buffering */
 
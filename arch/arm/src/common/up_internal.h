@@ -460,10 +460,25 @@ void up_restorefpu(const uint32_t *regs);
 #  define up_restorefpu(regs)
 #endif
 
+#ifdef CONFIG_ARMV7M_FPUOWNER
+struct tcb_s; /* Forward reference */
+
+void up_fpuinitialize(void);
+void up_fpuswitch(void);
+int  up_fpufault(int irq, FAR void *context, FAR void *arg);
+void up_fpurelease(FAR struct tcb_s *tcb);
+void up_fpusigsave(FAR uint32_t *regs);
+void up_fpusigrestore(FAR const uint32_t *regs);
+#endif
+
 /* System timer *************************************************************/
 
 void arm_timer_initialize(void);
 
+#ifdef CONFIG_SCHED_CPUTIME
+void arm_cyclecount_initialize(void);
+#endif
+
 /* Low level serial output **************************************************/
 
 void up_lowputc(char ch);
@@ -122,4 +122,10 @@ void up_release_stack(FAR struct tcb_s *dtcb, uint8_t ttype)
   /* The size of the allocated stack is now zero */
 
   dtcb->adj_stack_size = 0;
+
+#ifdef CONFIG_ARMV7M_FPUOWNER
+  /* The FPU state of the defunct task, if any, is no longer needed */
+
+  up_fpurelease(dtcb);
+#endif
 }
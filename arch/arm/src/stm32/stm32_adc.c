@@ -191,6 +191,17 @@
 #  endif
 #endif
 
+/* In streaming mode the circular DMA buffer holds two halves of
+ * CONFIG_STM32_ADC_STREAM_NSCANS scans each.  Each half is handed to the
+ * upper half as one block from the half- and full-transfer interrupts.
+ */
+
+#if defined(ADC_HAVE_DMA) && defined(CONFIG_ADC_STREAM)
+#  define ADC_DMA_NSCANS (2 * CONFIG_STM32_ADC_STREAM_NSCANS)
+#else
+#  define ADC_DMA_NSCANS 1
+#endif
+
 #if defined(CONFIG_STM32_STM32F20XX) || defined(CONFIG_STM32_STM32F4XXX)
 #  define ADC_DMA_CONTROL_WORD (DMA_SCR_MSIZE_16BITS | \
                                 DMA_SCR_PSIZE_16BITS | \
@@ -323,7 +334,7 @@ struct stm32_dev_s
 
   /* DMA transfer buffer */
 
-  uint16_t dmabuffer[ADC_MAX_SAMPLES];
+  uint16_t dmabuffer[ADC_MAX_SAMPLES * ADC_DMA_NSCANS];
 #endif
 
   /* List of selected ADC channels to sample */
@@ -1671,10 +1682,33 @@ static void adc_dmaconvcallback(DMA_HANDLE handle, uint8_t isr, FAR void *arg)
 {
   FAR struct adc_dev_s   *dev  = (FAR struct adc_dev_s *)arg;
   FAR struct stm32_dev_s *priv = (FAR struct stm32_dev_s *)dev->ad_priv;
+#ifdef CONFIG_ADC_STREAM
+  int nhalf;
+#endif
   int i;
 
   /* Verify that the upper-half driver has bound its callback functions */
 
+#ifdef CONFIG_ADC_STREAM
+  /* In streaming mode, hand the half of the buffer that was just filled to
+   * the upper half as one block.  The DMA continues into the other half.
+   */
+
+  if (priv->cb != NULL && priv->cb->au_receive_block != NULL)
+    {
+      nhalf = priv->nchannels * CONFIG_STM32_ADC_STREAM_NSCANS;
+      if ((isr & DMA_STATUS_TCIF) == 0)
+        {
+          priv->cb->au_receive_block(dev, priv->dmabuffer,
+                                     nhalf * sizeof(uint16_t));
+          return;
+        }
+
+      priv->cb->au_receive_block(dev, &priv->dmabuffer[nhalf],
+                                 nhalf * sizeof(uint16_t));
+    }
+  else
+#endif
   if (priv->cb != NULL)
     {
       DEBUGASSERT(priv->cb->au_receive != NULL);
@@ -2021,10 +2055,11 @@ static void adc_reset(FAR struct adc_dev_s *dev)
       stm32_dmasetup(priv->dma,
                      priv->base + STM32_ADC_DR_OFFSET,
                      (uint32_t)priv->dmabuffer,
-                     priv->nchannels,
+                     priv->nchannels * ADC_DMA_NSCANS,
                      ADC_DMA_CONTROL_WORD);
 
-      stm32_dmastart(priv->dma, adc_dmaconvcallback, dev, false);
+      stm32_dmastart(priv->dma, adc_dmaconvcallback, dev,
+                     ADC_DMA_NSCANS > 1);
     }
 
 #endif
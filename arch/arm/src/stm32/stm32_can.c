@@ -78,6 +78,19 @@
 
 #define CAN_BIT_QUANTA (CONFIG_CAN_TSEG1 + CONFIG_CAN_TSEG2 + 1)
 
+/* Filters ******************************************************************/
+/* Number of filter banks owned by each CAN block.  Bank 0 of each block
+ * (priv->filter) accepts all messages while no other filter is in use.
+ */
+
+#if defined(CONFIG_STM32_CONNECTIVITYLINE) || \
+    defined(CONFIG_STM32_STM32F20XX) || \
+    defined(CONFIG_STM32_STM32F4XXX)
+#  define CAN_NBANKS (CAN_NFILTERS / 2)
+#else
+#  define CAN_NBANKS CAN_NFILTERS
+#endif
+
 #ifndef CONFIG_DEBUG_CAN_INFO
 #  undef CONFIG_STM32_CAN_REGDEBUG
 #endif
@@ -92,6 +105,7 @@ struct stm32_can_s
   uint8_t  canrx[2]; /* CAN RX FIFO 0/1 IRQ number */
   uint8_t  cantx;    /* CAN TX IRQ number */
   uint8_t  filter;   /* Filter number */
+  uint32_t filters;  /* Bit set of the filter banks in use (relative) */
   uint32_t base;     /* Base address of the CAN control registers */
   uint32_t fbase;    /* Base address of the CAN filter registers */
   uint32_t baud;     /* Configured baud */
@@ -124,8 +138,11 @@ static void stm32can_dumpfiltregs(FAR struct stm32_can_s *priv,
 #  define stm32can_dumpfiltregs(priv,msg)
 #endif
 
-/* Filtering (todo) */
+/* Filtering */
 
+static int  stm32can_addfilter(FAR struct stm32_can_s *priv, uint32_t fr1,
+                               uint32_t fr2, bool idlist, uint8_t prio);
+static int  stm32can_delfilter(FAR struct stm32_can_s *priv, int ndx);
 #ifdef CONFIG_CAN_EXTID
 static int  stm32can_addextfilter(FAR struct stm32_can_s *priv,
                                   FAR struct canioc_extfilter_s *arg);
@@ -1946,6 +1963,10 @@ static int stm32can_filterinit(FAR struct stm32_can_s *priv)
 
   bitmask = (uint32_t)1 << priv->filter;
 
+  /* Any filters added by CANIOC_ADD_*FILTER are lost */
+
+  priv->filters = 0;
+
   /* Enter filter initialization mode */
 
   regval  = stm32can_getfreg(priv, STM32_CAN_FMR_OFFSET);
@@ -1958,15 +1979,15 @@ static int stm32can_filterinit(FAR struct stm32_can_s *priv)
     defined(CONFIG_STM32_STM32F20XX) || \
     defined(CONFIG_STM32_STM32F4XXX)
   regval  = stm32can_getfreg(priv, STM32_CAN_FMR_OFFSET);
-  regval &= CAN_FMR_CAN2SB_MASK;
+  regval &= ~CAN_FMR_CAN2SB_MASK;
   regval |= (CAN_NFILTERS / 2) << CAN_FMR_CAN2SB_SHIFT;
   stm32can_putfreg(priv, STM32_CAN_FMR_OFFSET, regval);
 #endif
 
-  /* Disable the filter */
+  /* Disable all of the filters owned by this CAN block */
 
   regval  = stm32can_getfreg(priv, STM32_CAN_FA1R_OFFSET);
-  regval &= ~bitmask;
+  regval &= ~(((1 << CAN_NBANKS) - 1) << priv->filter);
   stm32can_putfreg(priv, STM32_CAN_FA1R_OFFSET, regval);
 
   /* Select the 32-bit scale for the filter */
@@ -2008,11 +2029,183 @@ static int stm32can_filterinit(FAR struct stm32_can_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: stm32can_addfilter
+ *
+ * Description:
+ *   Set up a free filter bank of this CAN block in 32-bit scale and disable
+ *   the accept-all filter in bank 0.
+ *
+ * Input Parameters:
+ *   priv   - A pointer to the private data structure for this CAN block
+ *   fr1    - Value of the first filter register (the ID)
+ *   fr2    - Value of the second filter register (the mask or second ID)
+ *   idlist - True: Identifier list mode; false: Identifier mask mode
+ *   prio   - CAN_MSGPRIO_HIGH messages are received in FIFO 1, all others
+ *            in FIFO 0
+ *
+ * Returned Value:
+ *   The filter index (a non-negative value) on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32can_addfilter(FAR struct stm32_can_s *priv, uint32_t fr1,
+                              uint32_t fr2, bool idlist, uint8_t prio)
+{
+  irqstate_t flags;
+  uint32_t regval;
+  uint32_t bitmask;
+  int bank;
+  int ndx;
+
+  /* Find a free filter bank.  Bank 0 is the accept-all filter. */
+
+  for (ndx = 1; ndx < CAN_NBANKS; ndx++)
+    {
+      if ((priv->filters & (1 << ndx)) == 0)
+        {
+          break;
+        }
+    }
+
+  if (ndx >= CAN_NBANKS)
+    {
+      return -ENOSPC;
+    }
+
+  bank    = priv->filter + ndx;
+  bitmask = (uint32_t)1 << bank;
+
+  caninfo("CAN%d filter %d: %08lx %08lx %s\n", priv->port, bank,
+          (unsigned long)fr1, (unsigned long)fr2, idlist ? "list" : "mask");
+
+  flags = enter_critical_section();
+
+  /* Enter filter initialization mode */
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FMR_OFFSET);
+  regval |= CAN_FMR_FINIT;
+  stm32can_putfreg(priv, STM32_CAN_FMR_OFFSET, regval);
+
+  /* Disable the filter while it is changed */
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FA1R_OFFSET);
+  regval &= ~bitmask;
+  stm32can_putfreg(priv, STM32_CAN_FA1R_OFFSET, regval);
+
+  /* Select the 32-bit scale and the mode of the filter */
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FS1R_OFFSET);
+  regval |= bitmask;
+  stm32can_putfreg(priv, STM32_CAN_FS1R_OFFSET, regval);
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FM1R_OFFSET);
+  if (idlist)
+    {
+      regval |= bitmask;
+    }
+  else
+    {
+      regval &= ~bitmask;
+    }
+
+  stm32can_putfreg(priv, STM32_CAN_FM1R_OFFSET, regval);
+
+  stm32can_putfreg(priv, STM32_CAN_FIR_OFFSET(bank, 1), fr1);
+  stm32can_putfreg(priv, STM32_CAN_FIR_OFFSET(bank, 2), fr2);
+
+  /* Assign the FIFO for the filter */
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FFA1R_OFFSET);
+  if (prio == CAN_MSGPRIO_HIGH)
+    {
+      regval |= bitmask;
+    }
+  else
+    {
+      regval &= ~bitmask;
+    }
+
+  stm32can_putfreg(priv, STM32_CAN_FFA1R_OFFSET, regval);
+
+  /* Enable the filter and disable the accept-all filter */
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FA1R_OFFSET);
+  regval |= bitmask;
+  regval &= ~((uint32_t)1 << priv->filter);
+  stm32can_putfreg(priv, STM32_CAN_FA1R_OFFSET, regval);
+
+  /* Exit filter initialization mode */
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FMR_OFFSET);
+  regval &= ~CAN_FMR_FINIT;
+  stm32can_putfreg(priv, STM32_CAN_FMR_OFFSET, regval);
+
+  priv->filters |= (1 << ndx);
+  leave_critical_section(flags);
+
+  stm32can_dumpfiltregs(priv, "After filter added");
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: stm32can_delfilter
+ *
+ * Description:
+ *   Disable a filter bank set up by stm32can_addfilter().  The accept-all
+ *   filter is enabled again when the last filter is removed.
+ *
+ * Input Parameters:
+ *   priv - A pointer to the private data structure for this CAN block
+ *   ndx  - The filter index returned by stm32can_addfilter()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32can_delfilter(FAR struct stm32_can_s *priv, int ndx)
+{
+  irqstate_t flags;
+  uint32_t regval;
+
+  if (ndx < 1 || ndx >= CAN_NBANKS || (priv->filters & (1 << ndx)) == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FMR_OFFSET);
+  regval |= CAN_FMR_FINIT;
+  stm32can_putfreg(priv, STM32_CAN_FMR_OFFSET, regval);
+
+  priv->filters &= ~(1 << ndx);
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FA1R_OFFSET);
+  regval &= ~((uint32_t)1 << (priv->filter + ndx));
+  if (priv->filters == 0)
+    {
+      regval |= (uint32_t)1 << priv->filter;
+    }
+
+  stm32can_putfreg(priv, STM32_CAN_FA1R_OFFSET, regval);
+
+  regval  = stm32can_getfreg(priv, STM32_CAN_FMR_OFFSET);
+  regval &= ~CAN_FMR_FINIT;
+  stm32can_putfreg(priv, STM32_CAN_FMR_OFFSET, regval);
+
+  leave_critical_section(flags);
+  return OK;
+}
+
 /****************************************************************************
  * Name: stm32can_addextfilter
  *
  * Description:
- *   Add a filter for extended CAN IDs
+ *   Add a filter for extended CAN IDs.  Mask and dual address filters are
+ *   supported; address ranges cannot be expressed by the filter banks.
  *
  * Input Parameters:
  *   priv - A pointer to the private data structure for this CAN block
@@ -2029,7 +2222,25 @@ static int stm32can_filterinit(FAR struct stm32_can_s *priv)
 static int stm32can_addextfilter(FAR struct stm32_can_s *priv,
                                  FAR struct canioc_extfilter_s *arg)
 {
-  return -ENOTTY;
+  uint32_t fr1;
+  uint32_t fr2;
+
+  fr1 = ((arg->xf_id1 << CAN_RIR_EXID_SHIFT) & CAN_RIR_EXID_MASK) |
+        CAN_RIR_IDE;
+  fr2 = ((arg->xf_id2 << CAN_RIR_EXID_SHIFT) & CAN_RIR_EXID_MASK) |
+        CAN_RIR_IDE;
+
+  switch (arg->xf_type)
+    {
+      case CAN_FILTER_MASK:
+        return stm32can_addfilter(priv, fr1, fr2, false, arg->xf_prio);
+
+      case CAN_FILTER_DUAL:
+        return stm32can_addfilter(priv, fr1, fr2, true, arg->xf_prio);
+
+      default:
+        return -EINVAL;
+    }
 }
 #endif
 
@@ -2054,7 +2265,7 @@ static int stm32can_addextfilter(FAR struct stm32_can_s *priv,
 #ifdef CONFIG_CAN_EXTID
 static int stm32can_delextfilter(FAR struct stm32_can_s *priv, int arg)
 {
-  return -ENOTTY;
+  return stm32can_delfilter(priv, arg);
 }
 #endif
 
@@ -2062,7 +2273,8 @@ static int stm32can_delextfilter(FAR struct stm32_can_s *priv, int arg)
  * Name: stm32can_addstdfilter
  *
  * Description:
- *   Add a filter for standard CAN IDs
+ *   Add a filter for standard CAN IDs.  Mask and dual address filters are
+ *   supported; address ranges cannot be expressed by the filter banks.
  *
  * Input Parameters:
  *   priv - A pointer to the private data structure for this CAN block
@@ -2078,7 +2290,27 @@ static int stm32can_delextfilter(FAR struct stm32_can_s *priv, int arg)
 static int stm32can_addstdfilter(FAR struct stm32_can_s *priv,
                                  FAR struct canioc_stdfilter_s *arg)
 {
-  return -ENOTTY;
+  uint32_t fr1;
+  uint32_t fr2;
+
+  fr1 = ((uint32_t)arg->sf_id1 << CAN_RIR_STID_SHIFT) & CAN_RIR_STID_MASK;
+  fr2 = ((uint32_t)arg->sf_id2 << CAN_RIR_STID_SHIFT) & CAN_RIR_STID_MASK;
+
+  switch (arg->sf_type)
+    {
+      case CAN_FILTER_MASK:
+
+        /* Also match the IDE bit so that only standard IDs are accepted */
+
+        return stm32can_addfilter(priv, fr1, fr2 | CAN_RIR_IDE, false,
+                                  arg->sf_prio);
+
+      case CAN_FILTER_DUAL:
+        return stm32can_addfilter(priv, fr1, fr2, true, arg->sf_prio);
+
+      default:
+        return -EINVAL;
+    }
 }
 
 /****************************************************************************
@@ -2101,7 +2333,7 @@ static int stm32can_addstdfilter(FAR struct stm32_can_s *priv,
 
 static int stm32can_delstdfilter(FAR struct stm32_can_s *priv, int arg)
 {
-  return -ENOTTY;
+  return stm32can_delfilter(priv, arg);
 }
 
 /****************************************************************************
@@ -206,6 +206,10 @@ void up_idle(void)
   BEGIN_IDLE();
   asm("WFI");
   END_IDLE();
+
+  /* Report the end of the idle period to the PM governor */
+
+  pm_idleexit(PM_IDLE_DOMAIN);
 #endif
 #endif
 #endif
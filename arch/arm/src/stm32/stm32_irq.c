@@ -177,6 +177,7 @@ static int stm32_busfault(int irq, FAR void *context, FAR void *arg)
   return 0;
 }
 
+#ifndef CONFIG_ARMV7M_FPUOWNER
 static int stm32_usagefault(int irq, FAR void *context, FAR void *arg)
 {
   (void)up_irq_save();
@@ -184,6 +185,7 @@ static int stm32_usagefault(int irq, FAR void *context, FAR void *arg)
   PANIC();
   return 0;
 }
+#endif
 
 static int stm32_pendsv(int irq, FAR void *context, FAR void *arg)
 {
@@ -387,6 +389,17 @@ void up_irqinitialize(void)
   up_enable_irq(STM32_IRQ_MEMFAULT);
 #endif
 
+#ifdef CONFIG_ARMV7M_FPUOWNER
+  /* If FPU ownership is tracked, then attach and enable the UsageFault
+   * handler.  The first FPU access by a task that does not own the FPU
+   * causes a NOCP UsageFault.
+   */
+
+  irq_attach(STM32_IRQ_USAGEFAULT, up_fpufault, NULL);
+  up_enable_irq(STM32_IRQ_USAGEFAULT);
+  up_fpuinitialize();
+#endif
+
 #if defined(CONFIG_RTC) && !defined(CONFIG_RTC_EXTERNAL)
   /* RTC was initialized earlier but IRQs weren't ready at that time */
 
@@ -401,7 +414,9 @@ void up_irqinitialize(void)
   irq_attach(STM32_IRQ_MEMFAULT, up_memfault, NULL);
 #endif
   irq_attach(STM32_IRQ_BUSFAULT, stm32_busfault, NULL);
+#ifndef CONFIG_ARMV7M_FPUOWNER
   irq_attach(STM32_IRQ_USAGEFAULT, stm32_usagefault, NULL);
+#endif
   irq_attach(STM32_IRQ_PENDSV, stm32_pendsv, NULL);
   irq_attach(STM32_IRQ_DBGMONITOR, stm32_dbgmonitor, NULL);
   irq_attach(STM32_IRQ_RESERVED, stm32_reserved, NULL);
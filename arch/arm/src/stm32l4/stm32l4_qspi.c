@@ -324,6 +324,9 @@ static int      qspi_memory(struct qspi_dev_s *dev,
                   struct qspi_meminfo_s *meminfo);
 static FAR void *qspi_alloc(FAR struct qspi_dev_s *dev, size_t buflen);
 static void     qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer);
+static int      qspi_memmap(FAR struct qspi_dev_s *dev,
+                  FAR const struct qspi_meminfo_s *meminfo,
+                  FAR void **base);
 
 /* Initialization */
 
@@ -345,6 +348,7 @@ static const struct qspi_ops_s g_qspi0ops =
   .memory            = qspi_memory,
   .alloc             = qspi_alloc,
   .free              = qspi_free,
+  .memmap            = qspi_memmap,
 };
 
 /* This is the overall state of the QSPI0 controller */
@@ -2322,6 +2326,152 @@ static void qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer)
     }
 }
 
+/****************************************************************************
+ * Name: qspi_entermemmap
+ *
+ * Description:
+ *   Put the QSPI device into memory mapped mode.  The caller holds the
+ *   QSPI lock.
+ *
+ * Input Parameters:
+ *   priv - Device state structure.
+ *   meminfo - parameters like for a memory transfer used for reading
+ *   lpto - The low-power timeout; zero to keep chip select asserted
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void qspi_entermemmap(struct stm32l4_qspidev_s *priv,
+                             const struct qspi_meminfo_s *meminfo,
+                             uint32_t lpto)
+{
+  uint32_t regval;
+  struct qspi_xctnspec_s xctn;
+
+  if (priv->memmap)
+    {
+      return;
+    }
+
+  /* Abort anything in-progress */
+
+  qspi_abort(priv);
+
+  /* Wait till BUSY flag reset */
+
+  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
+
+  /* if we want the 'low-power timeout counter' */
+
+  if (lpto > 0)
+    {
+      /* Set the Low Power Timeout value (automatically de-assert
+       * CS if memory is not accessed for a while)
+       */
+
+      qspi_putreg(priv, lpto, STM32L4_QUADSPI_LPTR_OFFSET);
+
+      /* Clear Timeout interrupt */
+
+      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32L4_QUADSPI_FCR);
+
+#ifdef STM32L4_QSPI_INTERRUPTS
+      /* Enable Timeout interrupt */
+
+      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
+      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
+      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
+#endif
+    }
+  else
+    {
+      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
+      regval &= ~QSPI_CR_TCEN;
+      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
+    }
+
+  /* create a transaction object */
+
+  qspi_setupxctnfrommem(&xctn, meminfo);
+
+#ifdef STM32L4_QSPI_INTERRUPTS
+  priv->xctn = NULL;
+#endif
+
+  /* set it into the ccr */
+
+  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
+  priv->memmap = true;
+
+  /* we should be in memory mapped mode now */
+
+  qspi_dumpregs(priv, "After memory mapped:");
+}
+
+/****************************************************************************
+ * Name: qspi_exitmemmap
+ *
+ * Description:
+ *   Take the QSPI device out of memory mapped mode.  The caller holds the
+ *   QSPI lock.
+ *
+ * Input Parameters:
+ *   priv - Device state structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void qspi_exitmemmap(struct stm32l4_qspidev_s *priv)
+{
+  /* A simple abort is sufficient */
+
+  qspi_abort(priv);
+  priv->memmap = false;
+}
+
+/****************************************************************************
+ * Name: QSPI_MEMMAP
+ *
+ * Description:
+ *   Enter memory mapped mode with the read command described by meminfo
+ *   and return the base of the mapped FLASH, or leave memory mapped mode if
+ *   meminfo is NULL.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read command; NULL to leave memory mapped mode
+ *   base    - The location to return the base address
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS, a negated errno on value of failure
+ *
+ ****************************************************************************/
+
+static int qspi_memmap(FAR struct qspi_dev_s *dev,
+                       FAR const struct qspi_meminfo_s *meminfo,
+                       FAR void **base)
+{
+  struct stm32l4_qspidev_s *priv = (struct stm32l4_qspidev_s *)dev;
+
+  if (meminfo == NULL)
+    {
+      qspi_exitmemmap(priv);
+      return OK;
+    }
+
+  DEBUGASSERT(base != NULL && QSPIMEM_ISREAD(meminfo->flags));
+
+  /* Keep chip select asserted between accesses (no low-power timeout) */
+
+  qspi_entermemmap(priv, meminfo, 0);
+  *base = (FAR void *)STM32L4_QSPI_BANK;
+  return OK;
+}
+
 /****************************************************************************
  * Name: qspi_hw_initialize
  *
@@ -2608,75 +2758,11 @@ void stm32l4_qspi_enter_memorymapped(struct qspi_dev_s* dev,
                                      uint32_t lpto)
 {
   struct stm32l4_qspidev_s *priv = (struct stm32l4_qspidev_s *)dev;
-  uint32_t regval;
-  struct qspi_xctnspec_s xctn;
 
   /* lock during this mode change */
 
   qspi_lock(dev, true);
-
-  if (priv->memmap)
-    {
-      qspi_lock(dev, false);
-      return;
-    }
-
-  /* Abort anything in-progress */
-
-  qspi_abort(priv);
-
-  /* Wait till BUSY flag reset */
-
-  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
-
-  /* if we want the 'low-power timeout counter' */
-
-  if (lpto > 0)
-    {
-      /* Set the Low Power Timeout value (automatically de-assert
-       * CS if memory is not accessed for a while)
-       */
-
-      qspi_putreg(priv, lpto, STM32L4_QUADSPI_LPTR_OFFSET);
-
-      /* Clear Timeout interrupt */
-
-      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32L4_QUADSPI_FCR);
-
-#ifdef STM32L4_QSPI_INTERRUPTS
-      /* Enable Timeout interrupt */
-
-      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
-      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
-      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
-#endif
-    }
-  else
-    {
-      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
-      regval &= ~QSPI_CR_TCEN;
-      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
-    }
-
-  /* create a transaction object */
-
-  qspi_setupxctnfrommem(&xctn, meminfo);
-
-#ifdef STM32L4_QSPI_INTERRUPTS
-  priv->xctn = NULL;
-#endif
-
-  /* set it into the ccr */
-
-  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
-  priv->memmap = true;
-
-  /* we should be in memory mapped mode now */
-
-  qspi_dumpregs(priv, "After memory mapped:");
-
-  /* finished this mode change */
-
+  qspi_entermemmap(priv, meminfo, lpto);
   qspi_lock(dev, false);
 }
 
@@ -2699,12 +2785,7 @@ void stm32l4_qspi_exit_memorymapped(struct qspi_dev_s* dev)
   struct stm32l4_qspidev_s *priv = (struct stm32l4_qspidev_s *)dev;
 
   qspi_lock(dev, true);
-
-  /* A simple abort is sufficient */
-
-  qspi_abort(priv);
-  priv->memmap = false;
-
+  qspi_exitmemmap(priv);
   qspi_lock(dev, false);
 }
 
@@ -44,6 +44,7 @@
 #include <string.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 #include <arch/irq.h>
 
 #include "up_internal.h"
@@ -100,6 +101,15 @@ void up_initial_state(struct tcb_s *tcb)
 
   xcp->regs[REG_EPC]     = (uint32_t)tcb->start;
 
+#ifdef CONFIG_TLS_NATIVE
+  /* Point the thread pointer at the copy of the .tdata/.tbss templates that
+   * follows the TLS information structure at the base of the stack.
+   */
+
+  xcp->regs[REG_TP]      = (uint32_t)tcb->stack_alloc_ptr +
+                           sizeof(struct tls_info_s);
+#endif
+
   /* If this task is running PIC, then set the PIC base register to the
    * address of the allocated D-Space region.
    */
@@ -46,6 +46,7 @@
 
 #include <dirent.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
@@ -54,6 +55,110 @@
 #define __SIM__ 1
 #include "hostfs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SIM_HOSTFS_READBUF
+#  define CONFIG_SIM_HOSTFS_READBUF 0
+#endif
+
+/* The number of files that may be read through a buffer at the same time.
+ * Further files are read directly.
+ */
+
+#define HOSTFS_NREADBUFS 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+/* The read buffer of one file opened read-only */
+
+struct host_readbuf_s
+{
+  int    fd;       /* Host file descriptor; -1 if the entry is free */
+  size_t pos;      /* Offset of the next unread byte in 'data' */
+  size_t len;      /* Number of valid bytes in 'data' */
+  char  *data;     /* CONFIG_SIM_HOSTFS_READBUF bytes */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+static struct host_readbuf_s g_readbufs[HOSTFS_NREADBUFS] =
+{
+  [0 ... HOSTFS_NREADBUFS - 1] = { -1 }
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+/****************************************************************************
+ * Name: host_readbuf
+ *
+ * Description:
+ *   Return the read buffer of 'fd' or NULL if it has none.
+ *
+ ****************************************************************************/
+
+static struct host_readbuf_s *host_readbuf(int fd)
+{
+  int i;
+
+  for (i = 0; i < HOSTFS_NREADBUFS; i++)
+    {
+      if (g_readbufs[i].fd == fd)
+        {
+          return &g_readbufs[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: host_readbuf_drop
+ *
+ * Description:
+ *   Discard the unread contents of the read buffer of 'fd', moving the host
+ *   file position back to the position seen by NuttX.  If 'release' is
+ *   true, the buffer is also freed.
+ *
+ ****************************************************************************/
+
+static void host_readbuf_drop(int fd, int release)
+{
+  struct host_readbuf_s *rb = host_readbuf(fd);
+
+  if (rb != NULL)
+    {
+      if (rb->pos < rb->len && !release)
+        {
+          (void)lseek(fd, -(off_t)(rb->len - rb->pos), SEEK_CUR);
+        }
+
+      rb->pos = 0;
+      rb->len = 0;
+
+      if (release)
+        {
+          free(rb->data);
+          rb->data = NULL;
+          rb->fd   = -1;
+        }
+    }
+}
+#endif
+
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -153,6 +258,38 @@ int host_open(const char *pathname, int flags, int mode)
       mapflags |= O_NONBLOCK;
     }
 
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+  if (mapflags == O_RDONLY)
+    {
+      struct host_readbuf_s *rb;
+      int fd;
+
+      fd = open(pathname, mapflags, mode);
+      if (fd >= 0)
+        {
+          /* Ask the host to read ahead and give the file a read buffer if
+           * one is free.
+           */
+
+          (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+          rb = host_readbuf(-1);
+          if (rb != NULL)
+            {
+              rb->data = malloc(CONFIG_SIM_HOSTFS_READBUF);
+              if (rb->data != NULL)
+                {
+                  rb->fd  = fd;
+                  rb->pos = 0;
+                  rb->len = 0;
+                }
+            }
+        }
+
+      return fd;
+    }
+#endif
+
   return open(pathname, mapflags, mode);
 }
 
@@ -162,6 +299,10 @@ int host_open(const char *pathname, int flags, int mode)
 
 int host_close(int fd)
 {
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+  host_readbuf_drop(fd, 1);
+#endif
+
   /* Just call the close routine */
 
   return close(fd);
@@ -173,6 +314,50 @@ int host_close(int fd)
 
 ssize_t host_read(int fd, void* buf, size_t count)
 {
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+  struct host_readbuf_s *rb = host_readbuf(fd);
+  ssize_t nread;
+  size_t ncopy;
+
+  if (rb != NULL && count > 0)
+    {
+      /* Refill the buffer if it is empty and the read is smaller than the
+       * buffer.  Larger reads go directly to the caller's buffer.
+       */
+
+      if (rb->pos >= rb->len)
+        {
+          if (count >= CONFIG_SIM_HOSTFS_READBUF)
+            {
+              return read(fd, buf, count);
+            }
+
+          nread = read(fd, rb->data, CONFIG_SIM_HOSTFS_READBUF);
+          if (nread <= 0)
+            {
+              return nread;
+            }
+
+          rb->pos = 0;
+          rb->len = nread;
+        }
+
+      /* Return what is buffered.  A short read is allowed at the end of
+       * the buffer.
+       */
+
+      ncopy = rb->len - rb->pos;
+      if (ncopy > count)
+        {
+          ncopy = count;
+        }
+
+      memcpy(buf, &rb->data[rb->pos], ncopy);
+      rb->pos += ncopy;
+      return ncopy;
+    }
+#endif
+
   /* Just call the read routine */
 
   return read(fd, buf, count);
@@ -195,6 +380,12 @@ ssize_t host_write(int fd, const void *buf, size_t count)
 
 off_t host_lseek(int fd, off_t offset, int whence)
 {
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+  /* Move the host file position back to where NuttX sees it */
+
+  host_readbuf_drop(fd, 0);
+#endif
+
   /* Just call the lseek routine */
 
   return lseek(fd, offset, whence);
@@ -228,6 +419,14 @@ void host_sync(int fd)
 
 int host_dup(int fd)
 {
+#if CONFIG_SIM_HOSTFS_READBUF > 0
+  /* The duplicate shares the host file position, so the original may no
+   * longer read ahead of it.
+   */
+
+  host_readbuf_drop(fd, 1);
+#endif
+
   return dup(fd);
 }
 
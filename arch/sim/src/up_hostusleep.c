@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <unistd.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Functions
@@ -51,3 +52,21 @@ int up_hostusleep(unsigned int usec)
 {
   return usleep(usec);
 }
+
+/****************************************************************************
+ * Name: up_hostnsec
+ *
+ * Description:
+ *   Return the host's monotonic time in nanoseconds.  The simulated system
+ *   timer only advances when the IDLE loop runs, so this is the only time
+ *   base that can be used to time busy code.
+ *
+ ****************************************************************************/
+
+unsigned long long up_hostnsec(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
@@ -230,6 +230,11 @@ volatile spinlock_t g_cpu_paused[CONFIG_SMP_NCPUS] SP_SECTION;
 int  up_setjmp(xcpt_reg_t *jb);
 void up_longjmp(xcpt_reg_t *jb, int val) noreturn_function;
 
+/* up_hostusleep.c ********************************************************/
+
+int up_hostusleep(unsigned int usec);
+unsigned long long up_hostnsec(void);
+
 /* up_simsmp.c ************************************************************/
 
 #ifdef CONFIG_SMP
@@ -265,6 +270,7 @@ void up_registerblockdevice(void);
 
 void simuart_start(void);
 int  simuart_putc(int ch);
+int  simuart_write(const char *buffer, int buflen);
 int  simuart_getc(bool block);
 bool simuart_checkc(void);
 void simuart_terminate(void);
@@ -335,12 +341,14 @@ FAR struct ioexpander_dev_s *sim_ioexpander_initialize(void);
 #if defined(CONFIG_NET_ETHERNET) && !defined(__CYGWIN__)
 void tapdev_init(void);
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen);
+bool tapdev_avail(void);
 void tapdev_send(unsigned char *buf, unsigned int buflen);
 void tapdev_ifup(in_addr_t ifaddr);
 void tapdev_ifdown(void);
 
 #  define netdev_init()           tapdev_init()
 #  define netdev_read(buf,buflen) tapdev_read(buf,buflen)
+#  define netdev_avail()          tapdev_avail()
 #  define netdev_send(buf,buflen) tapdev_send(buf,buflen)
 #  define netdev_ifup(ifaddr)     tapdev_ifup(ifaddr)
 #  define netdev_ifdown()         tapdev_ifdown()
@@ -355,6 +363,7 @@ void wpcap_send(unsigned char *buf, unsigned int buflen);
 
 #  define netdev_init()           wpcap_init()
 #  define netdev_read(buf,buflen) wpcap_read(buf,buflen)
+#  define netdev_avail()          (false)
 #  define netdev_send(buf,buflen) wpcap_send(buf,buflen)
 #  define netdev_ifup(ifaddr)     {}
 #  define netdev_ifdown()         {}
@@ -203,6 +203,8 @@ static int         qspiflash_memory(FAR struct qspi_dev_s *dev,
                      FAR struct qspi_meminfo_s *mem);
 static FAR void   *qspiflash_alloc(FAR struct qspi_dev_s *dev, size_t buflen);
 static void        qspiflash_free(FAR struct qspi_dev_s *dev, FAR void *buffer);
+static int         qspiflash_memmap(FAR struct qspi_dev_s *dev,
+                     FAR const struct qspi_meminfo_s *mem, FAR void **base);
 
 static void qspiflash_writeword(FAR struct sim_qspiflashdev_s *priv,
                     uint16_t data, FAR struct qspi_cmdinfo_s *cmdinfo);
@@ -220,7 +222,8 @@ static const struct qspi_ops_s g_qspiops =
   .command           = qspiflash_command,
   .memory            = qspiflash_memory,
   .alloc             = qspiflash_alloc,
-  .free              = qspiflash_free
+  .free              = qspiflash_free,
+  .memmap            = qspiflash_memmap
 };
 
 struct sim_qspiflashdev_s g_qspidev =
@@ -394,6 +397,37 @@ static void qspiflash_free(FAR struct qspi_dev_s *dev, FAR void *buffer)
   kmm_free(buffer);
 }
 
+/************************************************************************************
+ * Name: qspiflash_memmap
+ *
+ * Description:
+ *   Map the simulated FLASH for reading.  The FLASH contents are simply the
+ *   data array, so nothing has to change when the mapping ends.
+ *
+ * Input Parameters:
+ *   dev  - Device-specific state data
+ *   mem  - Describes the read command; NULL to end the mapping
+ *   base - The location to return the address of the FLASH
+ *
+ * Returned Value:
+ *   OK
+ *
+ ************************************************************************************/
+
+static int qspiflash_memmap(FAR struct qspi_dev_s *dev,
+                            FAR const struct qspi_meminfo_s *mem,
+                            FAR void **base)
+{
+  FAR struct sim_qspiflashdev_s *priv = (FAR struct sim_qspiflashdev_s *)dev;
+
+  if (mem != NULL)
+    {
+      *base = priv->data;
+    }
+
+  return OK;
+}
+
 /************************************************************************************
  * Name: qspiflash_sectorerase
  *
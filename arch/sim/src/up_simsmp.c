@@ -103,6 +103,9 @@ volatile spinlock_t g_cpu_paused[CONFIG_SMP_NCPUS];
 void os_start(void) __attribute__ ((noreturn));
 void up_cpu_paused(int cpu);
 void sim_smp_hook(void);
+#ifdef CONFIG_SMP_CALL
+void sched_smp_call_handler(void);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -140,6 +143,9 @@ static void *sim_cpu0_trampoline(void *arg)
 
   sigemptyset(&set);
   sigaddset(&set, SIGUSR1);
+#ifdef CONFIG_SMP_CALL
+  sigaddset(&set, SIGUSR2);
+#endif
 
   ret = pthread_sigmask(SIG_UNBLOCK, &set, NULL);
   if (ret < 0)
@@ -194,6 +200,9 @@ static void *sim_idle_trampoline(void *arg)
 
   sigemptyset(&set);
   sigaddset(&set, SIGUSR1);
+#ifdef CONFIG_SMP_CALL
+  sigaddset(&set, SIGUSR2);
+#endif
 
   ret = pthread_sigmask(SIG_UNBLOCK, &set, NULL);
   if (ret < 0)
@@ -239,6 +248,28 @@ static void sim_handle_signal(int signo, siginfo_t *info, void *context)
   (void)up_cpu_paused(cpu);
 }
 
+/****************************************************************************
+ * Name: sim_handle_callsignal
+ *
+ * Description:
+ *   This is the SIGUSR2 signal handler.  It executes the requests that other
+ *   CPUs have queued for this simulated CPU with sched_smp_call().
+ *
+ * Input Parameters:
+ *   arg - Standard sigaction arguments
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+static void sim_handle_callsignal(int signo, siginfo_t *info, void *context)
+{
+  sched_smp_call_handler();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -285,10 +316,25 @@ int sim_cpu0_initialize(void)
       return -errno;
     }
 
+#ifdef CONFIG_SMP_CALL
+  /* Register the inter-CPU call signal handler for all threads */
+
+  act.sa_sigaction = sim_handle_callsignal;
+
+  ret = sigaction(SIGUSR2, &act, NULL);
+  if (ret < 0)
+    {
+      return -errno;
+    }
+#endif
+
   /* Make sure the SIGUSR1 is not masked */
 
   sigemptyset(&set);
   sigaddset(&set, SIGUSR1);
+#ifdef CONFIG_SMP_CALL
+  sigaddset(&set, SIGUSR2);
+#endif
 
   ret = sigprocmask(SIG_UNBLOCK, &set, NULL);
   if (ret < 0)
@@ -501,3 +547,26 @@ int up_cpu_resume(int cpu)
   g_cpu_wait[cpu] = SP_UNLOCKED;
   return 0;
 }
+
+/****************************************************************************
+ * Name: up_cpu_call
+ *
+ * Description:
+ *   Signal the thread of the simulated CPU so that it will execute the
+ *   requests queued by sched_smp_call().  This function does not wait for
+ *   the target CPU to respond.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU to be interrupted.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int up_cpu_call(int cpu)
+{
+  return -pthread_kill(g_sim_cputhread[cpu], SIGUSR2);
+}
+#endif
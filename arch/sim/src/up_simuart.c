@@ -125,8 +125,9 @@ static void setrawmode(void)
 
 static void *simuart_thread(void *arg)
 {
-  unsigned char ch;
+  unsigned char buffer[SIMUART_BUFSIZE];
   ssize_t nread;
+  ssize_t i;
   int next;
   int prev;
 
@@ -134,33 +135,40 @@ static void *simuart_thread(void *arg)
 
   for (; ; )
     {
-      /* Read one character from stdin */
+      /* Read all of the characters that are available from stdin (at
+       * least one) with one host system call.
+       */
 
-      nread = read(0, &ch, 1);
+      nread = read(0, buffer, SIMUART_BUFSIZE);
 
       /* Check for failures (but don't do anything) */
 
-      if (nread == 1)
+      if (nread > 0)
         {
 #ifdef CONFIG_SIM_UART_DATAPOST
           sched_lock();
 #endif
-          /* Get the index to the next slot in the UART buffer */
-
-          prev = g_uarthead;
-          next = prev + 1;
-          if (next >= SIMUART_BUFSIZE)
+          for (i = 0; i < nread; i++)
             {
-              next = 0;
-            }
+              /* Get the index to the next slot in the UART buffer */
+
+              prev = g_uarthead;
+              next = prev + 1;
+              if (next >= SIMUART_BUFSIZE)
+                {
+                  next = 0;
+                }
 
-          /* Would adding this character cause an overflow? */
+              /* Would adding this character cause an overflow? */
+
+              if (next == g_uarttail)
+                {
+                  break;
+                }
 
-          if (next != g_uarttail)
-            {
               /* No.. Add the character to the UART buffer */
 
-              g_uartbuffer[prev] = ch;
+              g_uartbuffer[prev] = buffer[i];
 
               /* Update the head index (BEFORE posting) */
 
@@ -265,6 +273,58 @@ int simuart_putc(int ch)
   return ret;
 }
 
+/****************************************************************************
+ * Name: simuart_write
+ *
+ * Description:
+ *   Write a buffer to stdout, expanding each newline to CR-LF, with one host
+ *   system call per SIMUART_BUFSIZE bytes of output rather than one per
+ *   character.  Returns the number of bytes of 'buffer' written or -1 on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int simuart_write(const char *buffer, int buflen)
+{
+  char outbuf[SIMUART_BUFSIZE];
+  ssize_t nwritten;
+  int nout;
+  int ofs;
+  int i;
+
+  for (i = 0; i < buflen; )
+    {
+      /* Fill the output buffer, leaving room for one CR-LF pair */
+
+      for (nout = 0; i < buflen && nout < SIMUART_BUFSIZE - 1; i++)
+        {
+          if (buffer[i] == '\n')
+            {
+              outbuf[nout++] = '\r';
+            }
+
+          outbuf[nout++] = buffer[i];
+        }
+
+      for (ofs = 0; ofs < nout; ofs += nwritten)
+        {
+          nwritten = write(1, &outbuf[ofs], nout - ofs);
+          if (nwritten <= 0)
+            {
+              if (nwritten < 0 && errno == EINTR)
+                {
+                  nwritten = 0;
+                  continue;
+                }
+
+              return -1;
+            }
+        }
+    }
+
+  return buflen;
+}
+
 /****************************************************************************
  * Name: simuart_getc
  ****************************************************************************/
@@ -52,12 +52,18 @@
 #include <sys/socket.h>
 
 #include <fcntl.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
 
+#ifdef CONFIG_SIM_NET_RXTHREAD
+#  include <pthread.h>
+#  include <errno.h>
+#endif
+
 #ifdef CONFIG_SIM_NET_HOST_ROUTE
 #  include <net/route.h>
 #endif
@@ -81,6 +87,10 @@
 #define LOG_INFO      1  /* Informational message */
 #define LOG_ERR       4  /* Error conditions */
 
+/* The time that tapdev_read() waits for a frame, in microseconds */
+
+#define TAPDEV_WAIT   1000
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -96,6 +106,16 @@ struct sel_arg_struct
   struct timeval *tvp;
 };
 
+#ifdef CONFIG_SIM_NET_RXTHREAD
+/* One frame queued by the host receive thread */
+
+struct tapdev_frame_s
+{
+  unsigned int  len;
+  unsigned char data[NETDEV_BUFSIZE];
+};
+#endif
+
 /****************************************************************************
  * NuttX Domain Public Function Prototypes
  ****************************************************************************/
@@ -117,6 +137,20 @@ static char gdevname[IFNAMSIZ];
 static struct rtentry ghostroute;
 #endif
 
+#ifdef CONFIG_SIM_NET_RXTHREAD
+/* The ring of received frames.  The host receive thread is the only
+ * writer of g_rxhead and tapdev_read() is the only writer of g_rxtail.  The
+ * mutex and condition are used only to wait for the ring to become
+ * non-empty (tapdev_read()) or non-full (the receive thread).
+ */
+
+static struct tapdev_frame_s g_rxframes[CONFIG_SIM_NET_NRXFRAMES];
+static volatile int          g_rxhead;
+static volatile int          g_rxtail;
+static pthread_mutex_t       g_rxlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t        g_rxcond = PTHREAD_COND_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -139,6 +173,74 @@ static inline void dump_ethhdr(const char *msg, unsigned char *buf, int buflen)
 #  define dump_ethhdr(m,b,l)
 #endif
 
+#ifdef CONFIG_SIM_NET_RXTHREAD
+static inline int tapdev_nextframe(int index)
+{
+  return index + 1 >= CONFIG_SIM_NET_NRXFRAMES ? 0 : index + 1;
+}
+
+/****************************************************************************
+ * Name: tapdev_rxthread
+ *
+ * Description:
+ *   This thread runs in the host domain.  It blocks reading the TAP device
+ *   and queues each frame in the ring, signaling tapdev_read() if it is
+ *   waiting.  It must not call into NuttX.
+ *
+ ****************************************************************************/
+
+static void *tapdev_rxthread(void *arg)
+{
+  struct tapdev_frame_s *frame;
+  int next;
+  int ret;
+
+  for (; ; )
+    {
+      /* Wait for a free frame */
+
+      next = tapdev_nextframe(g_rxhead);
+      if (next == g_rxtail)
+        {
+          pthread_mutex_lock(&g_rxlock);
+          while (next == g_rxtail)
+            {
+              pthread_cond_wait(&g_rxcond, &g_rxlock);
+            }
+
+          pthread_mutex_unlock(&g_rxlock);
+        }
+
+      /* Read the next frame directly into the ring */
+
+      frame = &g_rxframes[g_rxhead];
+      ret   = read(gtapdevfd, frame->data, NETDEV_BUFSIZE);
+      if (ret <= 0)
+        {
+          if (ret < 0 && errno != EINTR && errno != EAGAIN)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      frame->len = ret;
+
+      /* Publish the frame (AFTER its contents) and wake up the reader */
+
+      __sync_synchronize();
+
+      pthread_mutex_lock(&g_rxlock);
+      g_rxhead = next;
+      pthread_cond_signal(&g_rxcond);
+      pthread_mutex_unlock(&g_rxlock);
+    }
+
+  return NULL;
+}
+#endif
+
 static int up_setmacaddr(void)
 {
   unsigned char mac[7];
@@ -238,8 +340,86 @@ void tapdev_init(void)
   /* Set the MAC address */
 
   up_setmacaddr();
+
+#ifdef CONFIG_SIM_NET_RXTHREAD
+  /* Start the host receive thread */
+
+  {
+    pthread_t tid;
+
+    ret = pthread_create(&tid, NULL, tapdev_rxthread, NULL);
+    if (ret != 0)
+      {
+        syslog(LOG_ERR, "TAPDEV: pthread_create failed: %d\n", ret);
+      }
+  }
+#endif
 }
 
+#ifdef CONFIG_SIM_NET_RXTHREAD
+unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
+{
+  struct tapdev_frame_s *frame;
+  struct timespec abstime;
+  unsigned int len;
+  int tail;
+
+  /* If the ring is empty, wait for a frame (or a timeout) */
+
+  tail = g_rxtail;
+  if (tail == g_rxhead)
+    {
+      clock_gettime(CLOCK_REALTIME, &abstime);
+      abstime.tv_nsec += TAPDEV_WAIT * 1000;
+      if (abstime.tv_nsec >= 1000000000)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= 1000000000;
+        }
+
+      pthread_mutex_lock(&g_rxlock);
+      while (tail == g_rxhead)
+        {
+          if (pthread_cond_timedwait(&g_rxcond, &g_rxlock, &abstime) != 0)
+            {
+              break;
+            }
+        }
+
+      pthread_mutex_unlock(&g_rxlock);
+      if (tail == g_rxhead)
+        {
+          return 0;
+        }
+    }
+
+  __sync_synchronize();
+
+  /* Copy the frame out of the ring */
+
+  frame = &g_rxframes[tail];
+  len   = frame->len < buflen ? frame->len : buflen;
+  memcpy(buf, frame->data, len);
+
+  /* Release the frame, waking up the receive thread if the ring was
+   * full.
+   */
+
+  pthread_mutex_lock(&g_rxlock);
+  g_rxtail = tapdev_nextframe(tail);
+  pthread_cond_signal(&g_rxcond);
+  pthread_mutex_unlock(&g_rxlock);
+
+  dump_ethhdr("read", buf, len);
+  return len;
+}
+
+bool tapdev_avail(void)
+{
+  return g_rxhead != g_rxtail;
+}
+
+#else
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
 {
   fd_set                fdset;
@@ -256,7 +436,7 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
   /* Wait for data on the tap device (or a timeout) */
 
   tv.tv_sec  = 0;
-  tv.tv_usec = 1000;
+  tv.tv_usec = TAPDEV_WAIT;
 
   FD_ZERO(&fdset);
   FD_SET(gtapdevfd, &fdset);
@@ -278,6 +458,28 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
   return ret;
 }
 
+bool tapdev_avail(void)
+{
+  fd_set         fdset;
+  struct timeval tv;
+
+  if (gtapdevfd < 0)
+    {
+      return false;
+    }
+
+  /* Poll the tap device without waiting */
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = 0;
+
+  FD_ZERO(&fdset);
+  FD_SET(gtapdevfd, &fdset);
+
+  return select(gtapdevfd + 1, &fdset, NULL, NULL, &tv) > 0;
+}
+#endif
+
 void tapdev_send(unsigned char *buf, unsigned int buflen)
 {
   int ret;
@@ -48,14 +48,17 @@
 #include <string.h>
 #include <semaphore.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/audio/audio.h>
 #include <mqueue.h>
 
@@ -77,6 +80,26 @@
 #  define CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO  1
 #endif
 
+/* Audio ring ***************************************************************/
+
+#ifdef CONFIG_AUDIO_RING
+#  ifndef CONFIG_AUDIO_RING_NPOLLWAITERS
+#    define CONFIG_AUDIO_RING_NPOLLWAITERS 2
+#  endif
+
+/* Completed periods are replaced from the high priority work queue if
+ * there is one; the lower half callback may run in interrupt context.
+ */
+
+#  ifdef CONFIG_SCHED_HPWORK
+#    define AUDIO_RING_WORK HPWORK
+#  else
+#    define AUDIO_RING_WORK LPWORK
+#  endif
+
+#  define AUDIO_RING_ALIGN(n) (((n) + 7) & ~7)
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -90,6 +113,13 @@ struct audio_upperhalf_s
   sem_t             exclsem;  /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   mqd_t             usermq;   /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING
+  FAR struct audio_ring_s *ring; /* mmap'able ring of period buffers */
+  struct work_s     ringwork; /* Replaces completed periods */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_AUDIO_RING_NPOLLWAITERS];
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -101,6 +131,10 @@ static int      audio_close(FAR struct file *filep);
 static ssize_t  audio_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 static ssize_t  audio_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
 static int      audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#if defined(CONFIG_AUDIO_RING) && !defined(CONFIG_DISABLE_POLL)
+static int      audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                  bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper, FAR void *session);
 static void     audio_callback(FAR void *priv, uint16_t reason,
@@ -124,14 +158,275 @@ static const struct file_operations g_audioops =
   0,           /* seek */
   audio_ioctl  /* ioctl */
 #ifndef CONFIG_DISABLE_POLL
+#ifdef CONFIG_AUDIO_RING
+  , audio_poll /* poll */
+#else
   , 0          /* poll */
 #endif
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: audio_ringready
+ *
+ * Description:
+ *   Return the poll events that are ready on the ring:  POLLOUT if a
+ *   playback period is free, POLLIN if a capture period is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_RING
+static pollevent_t audio_ringready(FAR struct audio_ring_s *ring)
+{
+  if (ring == NULL)
+    {
+      return 0;
+    }
+
+  if (ring->direction == AUDIO_RING_PLAYBACK)
+    {
+      return (ring->appl - ring->hw) < ring->nperiods ? POLLOUT : 0;
+    }
+  else
+    {
+      return ring->hw != ring->appl ? POLLIN : 0;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_pollnotify
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void audio_pollnotify(FAR struct audio_upperhalf_s *upper,
+                             pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_RING_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+#else
+#  define audio_pollnotify(upper,eventset)
+#endif
+
+/****************************************************************************
+ * Name: audio_ringsubmit
+ *
+ * Description:
+ *   Hand the periods that are ready to the lower half:  The periods
+ *   committed by the application for playback, or the free periods for
+ *   capture.  The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static int audio_ringsubmit(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct audio_ring_s *ring = upper->ring;
+  FAR struct ap_buffer_s *apb;
+  uint32_t limit;
+  int ret;
+
+  DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+
+  if (ring->direction == AUDIO_RING_PLAYBACK)
+    {
+      limit = ring->appl;
+    }
+  else
+    {
+      limit = ring->appl + ring->nperiods;
+    }
+
+  while ((int32_t)(limit - ring->queued) > 0)
+    {
+      apb          = AUDIO_RING_APB(ring, ring->queued % ring->nperiods);
+      apb->curbyte = 0;
+      apb->flags   = AUDIO_APB_RING;
+      apb->nbytes  = ring->direction == AUDIO_RING_PLAYBACK ?
+                     ring->periodsize : 0;
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+          return ret;
+        }
+
+      ring->queued++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_ringworker
+ *
+ * Description:
+ *   Replace the periods that the lower half has completed.  This runs on
+ *   the work queue so that lower halves may complete buffers from their
+ *   interrupt handlers.
+ *
+ ****************************************************************************/
+
+static void audio_ringworker(FAR void *arg)
+{
+  FAR struct audio_upperhalf_s *upper = (FAR struct audio_upperhalf_s *)arg;
+
+  if (nxsem_wait(&upper->exclsem) < 0)
+    {
+      return;
+    }
+
+  if (upper->ring != NULL && upper->started)
+    {
+      (void)audio_ringsubmit(upper);
+    }
+
+  nxsem_post(&upper->exclsem);
+}
+
+/****************************************************************************
+ * Name: audio_ringdone
+ *
+ * Description:
+ *   A period of the ring has been returned by the lower half.  Advance the
+ *   hardware position, wake up poll() waiters and schedule the replacement
+ *   of the period.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_ringdone(FAR struct audio_upperhalf_s *upper,
+                           FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_ring_s *ring = upper->ring;
+
+  DEBUGASSERT(ring != NULL);
+
+  ring->hw++;
+  if (ring->hw == ring->queued && upper->started)
+    {
+      /* The lower half has nothing left to play or nowhere to capture */
+
+      ring->xruns++;
+    }
+
+  audio_pollnotify(upper, audio_ringready(ring));
+
+  if (upper->started && work_available(&upper->ringwork))
+    {
+      (void)work_queue(AUDIO_RING_WORK, &upper->ringwork, audio_ringworker,
+                       upper, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ringfree
+ ****************************************************************************/
+
+static void audio_ringfree(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_s *ring = upper->ring;
+  int i;
+
+  if (ring != NULL)
+    {
+      (void)work_cancel(AUDIO_RING_WORK, &upper->ringwork);
+
+      for (i = 0; i < ring->nperiods; i++)
+        {
+          nxsem_destroy(&AUDIO_RING_APB(ring, i)->sem);
+        }
+
+      upper->ring = NULL;
+      kumm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ringsetup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_RINGSETUP ioctl command.  The ring is allocated
+ *   from the user heap since it is accessed directly by the application.
+ *
+ ****************************************************************************/
+
+static int audio_ringsetup(FAR struct audio_upperhalf_s *upper,
+                           FAR struct audio_ringsetup_s *setup)
+{
+  FAR struct audio_ring_s *ring;
+  FAR struct ap_buffer_s *apb;
+  uint32_t offset;
+  uint32_t stride;
+  int i;
+
+  if (setup == NULL || setup->nperiods < 2 || setup->periodsize == 0 ||
+      setup->direction > AUDIO_RING_CAPTURE)
+    {
+      return -EINVAL;
+    }
+
+  if (upper->ring != NULL || upper->started)
+    {
+      return -EBUSY;
+    }
+
+  offset = AUDIO_RING_ALIGN(sizeof(struct audio_ring_s));
+  stride = AUDIO_RING_ALIGN(sizeof(struct ap_buffer_s) + setup->periodsize);
+
+  ring = (FAR struct audio_ring_s *)
+    kumm_zalloc(offset + stride * setup->nperiods);
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->size       = offset + stride * setup->nperiods;
+  ring->offset     = offset;
+  ring->stride     = stride;
+  ring->nperiods   = setup->nperiods;
+  ring->direction  = setup->direction;
+  ring->periodsize = setup->periodsize;
+
+  for (i = 0; i < ring->nperiods; i++)
+    {
+      apb             = AUDIO_RING_APB(ring, i);
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = setup->periodsize;
+      apb->flags      = AUDIO_APB_RING;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      apb->session    = setup->session;
+#endif
+      nxsem_init(&apb->sem, 0, 1);
+    }
+
+  upper->ring = ring;
+  setup->size = ring->size;
+  return OK;
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /************************************************************************************
  * Name: audio_open
  *
@@ -232,6 +527,13 @@ static int audio_close(FAR struct file *filep)
       audinfo("calling shutdown: %d\n");
 
       lower->ops->shutdown(lower);
+
+#ifdef CONFIG_AUDIO_RING
+      /* The lower half holds no more periods of the ring */
+
+      upper->started = false;
+      audio_ringfree(upper);
+#endif
     }
 
   ret = OK;
@@ -317,6 +619,22 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
   if (!upper->started)
     {
+#ifdef CONFIG_AUDIO_RING
+      /* Prime the lower half with the periods of the ring.  Periods not
+       * returned when the stream was last stopped are handed out again.
+       */
+
+      if (upper->ring != NULL)
+        {
+          upper->ring->queued = upper->ring->hw;
+          ret = audio_ringsubmit(upper);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+#endif
+
       /* Invoke the bottom half method to start the audio stream */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -647,6 +965,80 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_RINGSETUP - Allocate the ring of period buffers
+       *
+       *   ioctl argument:  pointer to an audio_ringsetup_s structure
+       */
+
+      case AUDIOIOC_RINGSETUP:
+        {
+          audinfo("AUDIOIOC_RINGSETUP\n");
+
+          ret = audio_ringsetup(upper,
+                  (FAR struct audio_ringsetup_s *)((uintptr_t)arg));
+        }
+        break;
+
+      /* AUDIOIOC_RINGRELEASE - Free the ring of period buffers
+       *
+       *   ioctl argument:  None
+       */
+
+      case AUDIOIOC_RINGRELEASE:
+        {
+          audinfo("AUDIOIOC_RINGRELEASE\n");
+
+          if (upper->started)
+            {
+              ret = -EBUSY;
+            }
+          else
+            {
+              audio_ringfree(upper);
+              ret = OK;
+            }
+        }
+        break;
+
+      /* AUDIOIOC_RINGSYNC - Hand the committed periods to the lower half
+       *
+       *   ioctl argument:  None
+       */
+
+      case AUDIOIOC_RINGSYNC:
+        {
+          audinfo("AUDIOIOC_RINGSYNC\n");
+
+          ret = -EINVAL;
+          if (upper->ring != NULL)
+            {
+              ret = upper->started ? audio_ringsubmit(upper) : OK;
+            }
+        }
+        break;
+
+      /* FIOC_MMAP - Return the address of the ring for mmap()
+       *
+       *   ioctl argument:  pointer to receive the address
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+          audinfo("FIOC_MMAP\n");
+
+          ret = -EINVAL;
+          if (upper->ring != NULL && addr != NULL)
+            {
+              *addr = upper->ring;
+              ret = OK;
+            }
+        }
+        break;
+#endif /* CONFIG_AUDIO_RING */
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl commands */
 
       default:
@@ -662,6 +1054,79 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for a period of the ring:  POLLOUT when a playback period may be
+ *   filled, POLLIN when a captured period may be read.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_AUDIO_RING) && !defined(CONFIG_DISABLE_POLL)
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_AUDIO_RING_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_RING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Report the events that are already ready.  The position is also
+       * advanced by the lower half callback.
+       */
+
+      flags = enter_critical_section();
+      fds->revents |= (fds->events & audio_ringready(upper->ring));
+      leave_critical_section(flags);
+
+      if (fds->revents != 0)
+        {
+          nxsem_post(fds->sem);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: audio_dequeuebuffer
  *
@@ -707,6 +1172,17 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
 
   audinfo("Entry\n");
 
+#ifdef CONFIG_AUDIO_RING
+  /* Periods of the ring are reported through the ring position */
+
+  if ((apb->flags & AUDIO_APB_RING) != 0)
+    {
+      apb->flags |= AUDIO_APB_DEQUEUED;
+      audio_ringdone(upper, apb);
+      return;
+    }
+#endif
+
   /* Send a dequeue message to the user if a message queue is registered */
 
   if (upper->usermq != NULL)
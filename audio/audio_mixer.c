@@ -0,0 +1,1268 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SCHED_WORKQUEUE
+#  error Work queue support is required (CONFIG_SCHED_WORKQUEUE)
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+#  error The mixer does not support CONFIG_AUDIO_MULTI_SESSION
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_NSTREAMS
+#  define CONFIG_AUDIO_MIXER_NSTREAMS 4
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_SAMPLERATE
+#  define CONFIG_AUDIO_MIXER_SAMPLERATE 48000
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_NBUFFERS
+#  define CONFIG_AUDIO_MIXER_NBUFFERS 4
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_BUFSIZE
+#  define CONFIG_AUDIO_MIXER_BUFSIZE 1024
+#endif
+
+/* Mixing is done on the high priority work queue if there is one */
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define MIXER_WORK      HPWORK
+#else
+#  define MIXER_WORK      LPWORK
+#endif
+
+/* The output is 16-bit stereo */
+
+#define MIXER_NCHANNELS   2
+#define MIXER_FRAMESIZE   (2 * MIXER_NCHANNELS)
+
+/* Frames are mixed in blocks of this size so that the accumulator is
+ * small and the inner loops are long enough to be vectorized.
+ */
+
+#define MIXER_NFRAMES     64
+
+/* Unity gain (Q15) and unity resampling step (b16) */
+
+#define MIXER_UNITYGAIN   32768
+#define MIXER_UNITYSTEP   0x00010000
+
+#ifndef MIN
+#  define MIN(a,b)        (((a) < (b)) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one input stream */
+
+struct mixer_stream_s
+{
+  /* This is our appearance to the upper half.  This *MUST* be the first
+   * element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer; /* The mixer that owns the stream */
+  struct dq_queue_s pending;       /* Buffers waiting to be mixed */
+  int32_t  gain;                   /* Q15 gain from volume and mute */
+  uint16_t volume;                 /* Volume 0..1000 */
+  uint8_t  nchannels;              /* Mono=1, Stereo=2 */
+  uint8_t  bpsamp;                 /* Bits per sample: 8 or 16 */
+  bool     reserved;               /* The stream is reserved */
+  bool     running;                /* The stream has been started */
+  bool     paused;                 /* The stream is paused */
+  bool     mute;                   /* The stream is muted */
+  bool     final;                  /* The final buffer has been mixed */
+#ifdef CONFIG_AUDIO_MIXER_SRC
+  uint32_t step;                   /* Input frames per output frame (b16) */
+  uint32_t phase;                  /* Position between prev and cur (b16) */
+  int16_t  prev[MIXER_NCHANNELS];  /* Input frame before the position */
+  int16_t  cur[MIXER_NCHANNELS];   /* Input frame after the position */
+#endif
+};
+
+/* The state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The contained output device */
+  sem_t    exclsem;                /* Mutual exclusion */
+  struct work_s work;              /* Mixes buffers on the work queue */
+  struct dq_queue_s freeq;         /* Output buffers ready to be mixed */
+  uint8_t  nqueued;                /* Output buffers held by the device */
+  uint8_t  nreserved;              /* Number of reserved streams */
+  bool     configured;             /* The output device is configured */
+  volatile bool running;           /* The output device is started */
+  volatile bool draining;          /* The final output buffer is queued */
+  int32_t  accum[MIXER_NFRAMES * MIXER_NCHANNELS];
+  int16_t  scratch[MIXER_NFRAMES * MIXER_NCHANNELS];
+  struct mixer_stream_s streams[CONFIG_AUDIO_MIXER_NSTREAMS];
+  FAR struct ap_buffer_s *apb[CONFIG_AUDIO_MIXER_NBUFFERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helper functions *********************************************************/
+
+static void mixer_schedule(FAR struct audio_mixer_s *mixer);
+static void mixer_setgain(FAR struct mixer_stream_s *stream);
+static void mixer_flush(FAR struct mixer_stream_s *stream);
+static bool mixer_fetch(FAR struct mixer_stream_s *stream,
+                        FAR int16_t *frame);
+static int  mixer_convert(FAR struct mixer_stream_s *stream,
+                          FAR int16_t *out, int nframes);
+static void mixer_accumulate(FAR int32_t *accum, FAR const int16_t *samples,
+                             int nsamples, int32_t gain);
+static void mixer_clip(FAR const int32_t *accum, FAR uint8_t *dest,
+                       int nsamples);
+static bool mixer_anyactive(FAR struct audio_mixer_s *mixer);
+static void mixer_fill(FAR struct audio_mixer_s *mixer,
+                       FAR struct ap_buffer_s *apb);
+static void mixer_worker(FAR void *arg);
+
+/* Audio lower half methods *************************************************/
+
+static int  mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                          FAR struct audio_caps_s *caps);
+static int  mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                            FAR const struct audio_caps_s *caps);
+static int  mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int  mixer_start(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int  mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int  mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int  mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int  mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                FAR struct ap_buffer_s *apb);
+static int  mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb);
+static int  mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                        unsigned long arg);
+static int  mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int  mixer_release(FAR struct audio_lowerhalf_s *dev);
+
+/* Audio callback from the contained output device **************************/
+
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_mixerops =
+{
+  mixer_getcaps,       /* getcaps        */
+  mixer_configure,     /* configure      */
+  mixer_shutdown,      /* shutdown       */
+  mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  mixer_pause,         /* pause          */
+  mixer_resume,        /* resume         */
+#endif
+  NULL,                /* allocbuffer    */
+  NULL,                /* freebuffer     */
+  mixer_enqueuebuffer, /* enqueue_buffer */
+  mixer_cancelbuffer,  /* cancel_buffer  */
+  mixer_ioctl,         /* ioctl          */
+  NULL,                /* read           */
+  NULL,                /* write          */
+  mixer_reserve,       /* reserve        */
+  mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mixer_schedule
+ *
+ * Description:
+ *   Schedule the mixer worker.  This may be called from an interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+static void mixer_schedule(FAR struct audio_mixer_s *mixer)
+{
+  if (work_available(&mixer->work))
+    {
+      (void)work_queue(MIXER_WORK, &mixer->work, mixer_worker, mixer, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_setgain
+ ****************************************************************************/
+
+static void mixer_setgain(FAR struct mixer_stream_s *stream)
+{
+  stream->gain = stream->mute ? 0 :
+                 (int32_t)stream->volume * MIXER_UNITYGAIN / 1000;
+}
+
+/****************************************************************************
+ * Name: mixer_flush
+ *
+ * Description:
+ *   Return all of the pending buffers of a stream to its upper half.
+ *
+ ****************************************************************************/
+
+static void mixer_flush(FAR struct mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pending))
+         != NULL)
+    {
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                           apb, OK);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_fetch
+ *
+ * Description:
+ *   Read the next frame of a stream as 16-bit stereo.  Buffers that have
+ *   been consumed are returned to the upper half.
+ *
+ * Returned Value:
+ *   true if a frame was read; false if the stream has no more data.
+ *
+ ****************************************************************************/
+
+static bool mixer_fetch(FAR struct mixer_stream_s *stream,
+                        FAR int16_t *frame)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const uint8_t *src;
+  unsigned int framesize;
+
+  framesize = stream->nchannels * (stream->bpsamp >> 3);
+
+  for (; ; )
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pending);
+      if (apb == NULL)
+        {
+          return false;
+        }
+
+      if ((unsigned int)(apb->nbytes - apb->curbyte) >= framesize)
+        {
+          break;
+        }
+
+      /* This buffer has been consumed */
+
+      dq_remfirst(&stream->pending);
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          stream->final = true;
+        }
+
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                           apb, OK);
+    }
+
+  src           = &apb->samp[apb->curbyte];
+  apb->curbyte += framesize;
+
+  /* 8-bit PCM is unsigned; 16-bit PCM is signed little-endian */
+
+  if (stream->bpsamp == 8)
+    {
+      frame[0] = (int16_t)((src[0] - 128) << 8);
+      frame[1] = stream->nchannels > 1 ?
+                 (int16_t)((src[1] - 128) << 8) : frame[0];
+    }
+  else
+    {
+      frame[0] = (int16_t)((uint16_t)src[0] | ((uint16_t)src[1] << 8));
+      frame[1] = stream->nchannels > 1 ?
+                 (int16_t)((uint16_t)src[2] | ((uint16_t)src[3] << 8)) :
+                 frame[0];
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mixer_convert
+ *
+ * Description:
+ *   Produce up to 'nframes' output frames of a stream, resampled to the
+ *   output sample rate by linear interpolation if necessary.
+ *
+ * Returned Value:
+ *   The number of frames produced.  This is less than 'nframes' if the
+ *   stream runs out of data.
+ *
+ ****************************************************************************/
+
+static int mixer_convert(FAR struct mixer_stream_s *stream,
+                         FAR int16_t *out, int nframes)
+{
+  int n;
+
+#ifdef CONFIG_AUDIO_MIXER_SRC
+  if (stream->step != MIXER_UNITYSTEP)
+    {
+      int32_t frac;
+      int16_t frame[MIXER_NCHANNELS];
+
+      for (n = 0; n < nframes; n++, out += MIXER_NCHANNELS)
+        {
+          /* Advance the input until the position lies between prev and
+           * cur.
+           */
+
+          while (stream->phase >= MIXER_UNITYSTEP)
+            {
+              if (!mixer_fetch(stream, frame))
+                {
+                  return n;
+                }
+
+              stream->prev[0] = stream->cur[0];
+              stream->prev[1] = stream->cur[1];
+              stream->cur[0]  = frame[0];
+              stream->cur[1]  = frame[1];
+              stream->phase  -= MIXER_UNITYSTEP;
+            }
+
+          /* Interpolate with a 15-bit fraction so that the product of the
+           * difference and the fraction cannot overflow.
+           */
+
+          frac   = (int32_t)(stream->phase >> 1);
+          out[0] = stream->prev[0] +
+                   (((stream->cur[0] - stream->prev[0]) * frac) >> 15);
+          out[1] = stream->prev[1] +
+                   (((stream->cur[1] - stream->prev[1]) * frac) >> 15);
+
+          stream->phase += stream->step;
+        }
+
+      return n;
+    }
+#endif
+
+  for (n = 0; n < nframes; n++, out += MIXER_NCHANNELS)
+    {
+      if (!mixer_fetch(stream, out))
+        {
+          break;
+        }
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: mixer_accumulate
+ *
+ * Description:
+ *   Add scaled samples to the accumulator.  This is kept as a simple loop
+ *   over flat arrays so that the compiler can vectorize it.
+ *
+ ****************************************************************************/
+
+static void mixer_accumulate(FAR int32_t *accum, FAR const int16_t *samples,
+                             int nsamples, int32_t gain)
+{
+  int i;
+
+  if (gain == MIXER_UNITYGAIN)
+    {
+      for (i = 0; i < nsamples; i++)
+        {
+          accum[i] += samples[i];
+        }
+    }
+  else if (gain != 0)
+    {
+      for (i = 0; i < nsamples; i++)
+        {
+          accum[i] += ((int32_t)samples[i] * gain) >> 15;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_clip
+ *
+ * Description:
+ *   Saturate the accumulator to 16 bits and store it little-endian.
+ *
+ ****************************************************************************/
+
+static void mixer_clip(FAR const int32_t *accum, FAR uint8_t *dest,
+                       int nsamples)
+{
+  int32_t value;
+  int i;
+
+  for (i = 0; i < nsamples; i++, dest += 2)
+    {
+      value = accum[i];
+      if (value > INT16_MAX)
+        {
+          value = INT16_MAX;
+        }
+      else if (value < INT16_MIN)
+        {
+          value = INT16_MIN;
+        }
+
+      dest[0] = (uint8_t)value;
+      dest[1] = (uint8_t)(value >> 8);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_anyactive
+ *
+ * Description:
+ *   Return true if any stream is producing audio.
+ *
+ ****************************************************************************/
+
+static bool mixer_anyactive(FAR struct audio_mixer_s *mixer)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+    {
+      if (mixer->streams[i].running && !mixer->streams[i].paused)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mixer_fill
+ *
+ * Description:
+ *   Mix the active streams into an output buffer.  Streams that have no
+ *   data contribute silence.  Streams whose final buffer has been mixed are
+ *   completed.
+ *
+ ****************************************************************************/
+
+static void mixer_fill(FAR struct audio_mixer_s *mixer,
+                       FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_stream_s *stream;
+  FAR uint8_t *dest;
+  int nframes;
+  int done;
+  int got;
+  int n;
+  int i;
+
+  nframes = apb->nmaxbytes / MIXER_FRAMESIZE;
+  dest    = apb->samp;
+
+  for (done = 0; done < nframes; done += n)
+    {
+      n = MIN(nframes - done, MIXER_NFRAMES);
+      memset(mixer->accum, 0, n * MIXER_NCHANNELS * sizeof(int32_t));
+
+      for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+        {
+          stream = &mixer->streams[i];
+          if (stream->running && !stream->paused)
+            {
+              got = mixer_convert(stream, mixer->scratch, n);
+              mixer_accumulate(mixer->accum, mixer->scratch,
+                               got * MIXER_NCHANNELS, stream->gain);
+            }
+        }
+
+      mixer_clip(mixer->accum, dest, n * MIXER_NCHANNELS);
+      dest += n * MIXER_FRAMESIZE;
+    }
+
+  apb->nbytes  = nframes * MIXER_FRAMESIZE;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  /* Complete the streams that have played their final buffer */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+    {
+      stream = &mixer->streams[i];
+      if (stream->running && stream->final &&
+          dq_peek(&stream->pending) == NULL)
+        {
+          stream->running = false;
+          stream->final   = false;
+          stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                               NULL, OK);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_worker
+ *
+ * Description:
+ *   Mix into all free output buffers and hand them to the output device,
+ *   starting the device if necessary.  When no stream is left, the last
+ *   buffer is marked final so that the device drains and completes.
+ *
+ ****************************************************************************/
+
+static void mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  struct audio_caps_s caps;
+  irqstate_t flags;
+  int ret;
+
+  if (nxsem_wait(&mixer->exclsem) < 0)
+    {
+      return;
+    }
+
+  if (!mixer->configured && mixer_anyactive(mixer))
+    {
+      memset(&caps, 0, sizeof(struct audio_caps_s));
+      caps.ac_len            = sizeof(struct audio_caps_s);
+      caps.ac_type           = AUDIO_TYPE_OUTPUT;
+      caps.ac_channels       = MIXER_NCHANNELS;
+      caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPLERATE;
+      caps.ac_controls.b[2]  = 16;
+
+      ret = lower->ops->configure(lower, &caps);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to configure the output: %d\n", ret);
+          goto errout;
+        }
+
+      mixer->configured = true;
+    }
+
+  while (!mixer->draining && mixer_anyactive(mixer))
+    {
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      mixer_fill(mixer, apb);
+      if (!mixer_anyactive(mixer))
+        {
+          apb->flags      |= AUDIO_APB_FINAL;
+          mixer->draining  = true;
+        }
+
+      flags = enter_critical_section();
+      mixer->nqueued++;
+      leave_critical_section(flags);
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+
+          flags = enter_critical_section();
+          mixer->nqueued--;
+          dq_addlast(&apb->dq_entry, &mixer->freeq);
+          leave_critical_section(flags);
+          break;
+        }
+    }
+
+  if (!mixer->running && mixer->nqueued > 0)
+    {
+      ret = lower->ops->start(lower);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to start the output: %d\n", ret);
+        }
+      else
+        {
+          mixer->running = true;
+        }
+    }
+
+errout:
+  nxsem_post(&mixer->exclsem);
+}
+
+/****************************************************************************
+ * Name: mixer_getcaps
+ *
+ * Description:
+ *   Report the capabilities of a stream:  PCM output with volume and mute.
+ *
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = MIXER_NCHANNELS;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_format.hw     = (1 << (AUDIO_FMT_PCM - 1));
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = MIXER_NCHANNELS;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_SAMP_RATE_8K |
+                                     AUDIO_SAMP_RATE_11K |
+                                     AUDIO_SAMP_RATE_16K |
+                                     AUDIO_SAMP_RATE_22K |
+                                     AUDIO_SAMP_RATE_32K |
+                                     AUDIO_SAMP_RATE_44K |
+                                     AUDIO_SAMP_RATE_48K;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_MUTE | AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: mixer_configure
+ *
+ * Description:
+ *   Configure the sample format or the volume of a stream.
+ *
+ ****************************************************************************/
+
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  int ret;
+
+  DEBUGASSERT(stream && caps);
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_FEATURE:
+        switch (caps->ac_format.hw)
+          {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+            case AUDIO_FU_VOLUME:
+              if (caps->ac_controls.hw[0] > 1000)
+                {
+                  ret = -EDOM;
+                  break;
+                }
+
+              stream->volume = caps->ac_controls.hw[0];
+              mixer_setgain(stream);
+              break;
+#endif
+
+            case AUDIO_FU_MUTE:
+              stream->mute = (caps->ac_controls.b[0] != 0);
+              mixer_setgain(stream);
+              break;
+
+            default:
+              ret = -ENOTTY;
+              break;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0];
+        audinfo("channels=%u samprate=%lu bpsamp=%u\n",
+                caps->ac_channels, (unsigned long)samprate,
+                caps->ac_controls.b[2]);
+
+        if (caps->ac_channels < 1 || caps->ac_channels > 2 ||
+            (caps->ac_controls.b[2] != 8 && caps->ac_controls.b[2] != 16) ||
+            samprate == 0)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+#ifdef CONFIG_AUDIO_MIXER_SRC
+        stream->step  = (samprate << 16) / CONFIG_AUDIO_MIXER_SAMPLERATE;
+        stream->phase = MIXER_UNITYSTEP;
+#else
+        if (samprate != CONFIG_AUDIO_MIXER_SAMPLERATE)
+          {
+            ret = -EINVAL;
+            break;
+          }
+#endif
+
+        stream->nchannels = caps->ac_channels;
+        stream->bpsamp    = caps->ac_controls.b[2];
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_shutdown
+ *
+ * Description:
+ *   Stop the stream and return its pending buffers.  The output device is
+ *   shut down when the last stream is released.
+ *
+ ****************************************************************************/
+
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret;
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stream->running = false;
+  stream->paused  = false;
+  stream->final   = false;
+  mixer_flush(stream);
+
+  nxsem_post(&mixer->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_start
+ ****************************************************************************/
+
+static int mixer_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret;
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stream->running = true;
+  stream->paused  = false;
+  stream->final   = false;
+#ifdef CONFIG_AUDIO_MIXER_SRC
+  stream->phase   = MIXER_UNITYSTEP;
+  stream->prev[0] = 0;
+  stream->prev[1] = 0;
+  stream->cur[0]  = 0;
+  stream->cur[1]  = 0;
+#endif
+
+  nxsem_post(&mixer->exclsem);
+
+  mixer_schedule(mixer);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  bool running;
+  int ret;
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  running         = stream->running;
+  stream->running = false;
+  stream->paused  = false;
+  stream->final   = false;
+  mixer_flush(stream);
+
+  if (running)
+    {
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                           NULL, OK);
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_pause
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_resume
+ ****************************************************************************/
+
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->paused = false;
+  mixer_schedule(stream->mixer);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_enqueuebuffer
+ ****************************************************************************/
+
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret;
+
+  DEBUGASSERT(stream && apb);
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dq_addlast(&apb->dq_entry, &stream->pending);
+  nxsem_post(&mixer->exclsem);
+
+  if (stream->running && !stream->paused)
+    {
+      mixer_schedule(mixer);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_cancelbuffer
+ ****************************************************************************/
+
+static int mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                              FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_ioctl
+ *
+ * Description:
+ *   Forward device-specific commands to the output device.
+ *
+ ****************************************************************************/
+
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stream->mixer->lower;
+
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+  if (cmd == AUDIOIOC_GETBUFFERINFO)
+    {
+      /* The stream buffers are not seen by the output device */
+
+      return -ENOTTY;
+    }
+#endif
+
+  if (lower->ops->ioctl != NULL)
+    {
+      return lower->ops->ioctl(lower, cmd, arg);
+    }
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: mixer_reserve
+ *
+ * Description:
+ *   Reserve a stream.  Each stream has a single session.  The output device
+ *   is reserved along with the first stream.
+ *
+ ****************************************************************************/
+
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret;
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      if (mixer->nreserved == 0 && lower->ops->reserve != NULL)
+        {
+          ret = lower->ops->reserve(lower);
+        }
+
+      if (ret >= 0)
+        {
+          stream->reserved = true;
+          mixer->nreserved++;
+          ret = OK;
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_release
+ ****************************************************************************/
+
+static int mixer_release(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret;
+
+  ret = nxsem_wait(&mixer->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (stream->reserved)
+    {
+      stream->reserved = false;
+      if (--mixer->nreserved == 0 && lower->ops->release != NULL)
+        {
+          (void)lower->ops->release(lower);
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_callback
+ *
+ * Description:
+ *   Handle events of the output device.  Returned buffers go back on the
+ *   free list to be mixed again; completion of the final buffer stops the
+ *   output until a stream becomes active.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast(&apb->dq_entry, &mixer->freeq);
+        mixer->nqueued--;
+        leave_critical_section(flags);
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+        mixer->running  = false;
+        mixer->draining = false;
+        break;
+
+      default:
+        auderr("ERROR: Output device event %d status %d\n", reason, status);
+        return;
+    }
+
+  mixer_schedule(mixer);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a mixer in front of a low-level audio output device.  See
+ *   include/nuttx/audio/audio_mixer.h.
+ *
+ ****************************************************************************/
+
+FAR struct audio_mixer_s *
+  audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_s *mixer;
+  FAR struct mixer_stream_s *stream;
+  struct audio_buf_desc_s bufdesc;
+  int ret;
+  int i;
+
+  DEBUGASSERT(dev != NULL && dev->ops->enqueuebuffer != NULL);
+
+  mixer = (FAR struct audio_mixer_s *)
+    kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (mixer == NULL)
+    {
+      auderr("ERROR: Failed to allocate the mixer\n");
+      return NULL;
+    }
+
+  nxsem_init(&mixer->exclsem, 0, 1);
+  mixer->lower = dev;
+
+  /* Allocate the output buffers, from the device if it has special needs */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      bufdesc.numbytes   = CONFIG_AUDIO_MIXER_BUFSIZE;
+      bufdesc.u.ppBuffer = &mixer->apb[i];
+
+      if (dev->ops->allocbuffer != NULL)
+        {
+          ret = dev->ops->allocbuffer(dev, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0 || mixer->apb[i] == NULL)
+        {
+          auderr("ERROR: Failed to allocate output buffer %d\n", i);
+          goto errout;
+        }
+
+      dq_addlast(&mixer->apb[i]->dq_entry, &mixer->freeq);
+    }
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+    {
+      stream             = &mixer->streams[i];
+      stream->export.ops = &g_mixerops;
+      stream->mixer      = mixer;
+      stream->volume     = 1000;
+      stream->nchannels  = MIXER_NCHANNELS;
+      stream->bpsamp     = 16;
+#ifdef CONFIG_AUDIO_MIXER_SRC
+      stream->step       = MIXER_UNITYSTEP;
+#endif
+      mixer_setgain(stream);
+    }
+
+  /* Receive the events of the output device */
+
+  dev->upper = mixer_callback;
+  dev->priv  = mixer;
+  return mixer;
+
+errout:
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      if (mixer->apb[i] != NULL)
+        {
+          bufdesc.u.pBuffer = mixer->apb[i];
+          if (dev->ops->freebuffer != NULL)
+            {
+              (void)dev->ops->freebuffer(dev, &bufdesc);
+            }
+          else
+            {
+              apb_free(mixer->apb[i]);
+            }
+        }
+    }
+
+  nxsem_destroy(&mixer->exclsem);
+  kmm_free(mixer);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stream
+ *
+ * Description:
+ *   Return the lower half of one stream of the mixer.
+ *
+ ****************************************************************************/
+
+FAR struct audio_lowerhalf_s *
+  audio_mixer_stream(FAR struct audio_mixer_s *mixer, int stream)
+{
+  DEBUGASSERT(mixer != NULL);
+
+  if (stream < 0 || stream >= CONFIG_AUDIO_MIXER_NSTREAMS)
+    {
+      return NULL;
+    }
+
+  return &mixer->streams[stream].export;
+}
+
+#endif /* CONFIG_AUDIO_MIXER */
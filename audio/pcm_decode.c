@@ -76,6 +76,16 @@
 #  define MAX(a,b) (((a) > (b)) ? (a) : (b))
 #endif
 
+/* Format adaptation */
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+#  define PCM_MAXCHANNELS  8   /* Maximum number of input channels */
+#  define PCM_MAXFRAME     (PCM_MAXCHANNELS * 4)
+#  define PCM_MAXOFRAME    4   /* 16-bit stereo */
+#  define PCM_MAXPEND      (4 * PCM_MAXOFRAME)
+#  define PCM_MAXDECIMATE  4   /* Largest sample rate divisor tried */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -127,6 +137,24 @@ struct pcm_decode_s
   uint8_t  skip;                   /* Number of sample bytes to be skipped */
   uint8_t  npartial;               /* Size of the partially copied sample */
 #endif
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+  /* Format adaptation.  If the lower level driver does not accept the
+   * format of the WAV file, the samples are narrowed to 16 bits, the
+   * channels are reduced to stereo or mono and the sample rate is divided
+   * by an integer, in place in each audio buffer.
+   */
+
+  bool     convert;                /* Adapting the format */
+  uint8_t  obpsamp;                /* Output bits per sample */
+  uint8_t  onchannels;             /* Output number of channels */
+  uint8_t  decimate;               /* Keep one of every 'decimate' frames */
+  uint8_t  phase;                  /* Input frame count modulo decimate */
+  uint8_t  ncarry;                 /* Bytes of a partial input frame */
+  uint8_t  npend;                  /* Bytes of output not yet written */
+  uint8_t  carry[PCM_MAXFRAME];    /* Partial input frame */
+  uint8_t  pend[PCM_MAXPEND];      /* Output waiting for space */
+#endif
 };
 
 /****************************************************************************
@@ -159,6 +187,14 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
               FAR struct ap_buffer_s *apb);
 #endif
 
+static int  pcm_setformat(FAR struct pcm_decode_s *priv, uint8_t nchannels,
+              uint32_t samprate, uint8_t bpsamp);
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+static int  pcm_adapt(FAR struct pcm_decode_s *priv);
+static void pcm_convert(FAR struct pcm_decode_s *priv,
+              FAR struct ap_buffer_s *apb);
+#endif
+
 /* struct audio_lowerhalf_s methods *****************************************/
 
 static int  pcm_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
@@ -391,7 +427,28 @@ static bool pcm_parsewav(FAR struct pcm_decode_s *priv, uint8_t *data)
       priv->bpsamp      = localwav.fmt.bpsamp;    /* Bits per sample: 8 bits = 8, 16 bits = 16 */
       priv->nchannels   = localwav.fmt.nchannels; /* Mono=1, Stereo=2 */
 
-#ifndef CONFIG_AUDIO_EXCLUDE_FFORWARD
+#if defined(CONFIG_AUDIO_PCM_CONVERT)
+      /* Format adaptation handles whole bytes per sample and a limited
+       * number of channels.
+       */
+
+      if ((priv->bpsamp & 7) != 0 || priv->bpsamp < 8 || priv->bpsamp > 32)
+        {
+          auderr("ERROR: Cannot support bits per sample of %d\n",
+                 priv->bpsamp);
+          return false;
+        }
+
+      if (priv->nchannels < 1 || priv->nchannels > PCM_MAXCHANNELS)
+        {
+          auderr("ERROR: Cannot support number of channels of %d\n",
+                 priv->nchannels);
+          return false;
+        }
+
+      DEBUGASSERT(priv->align == priv->nchannels * priv->bpsamp / 8);
+
+#elif !defined(CONFIG_AUDIO_EXCLUDE_FFORWARD)
       /* We are going to subsample, there then are some restrictions on the
        * number of channels and sample sizes that we can handle.
        */
@@ -400,14 +457,14 @@ static bool pcm_parsewav(FAR struct pcm_decode_s *priv, uint8_t *data)
         {
           auderr("ERROR: Cannot support bits per sample of %d in this mode\n",
                  priv->bpsamp);
-          return -EINVAL;
+          return false;
         }
 
       if (priv->nchannels != 1 && priv->nchannels != 2)
         {
           auderr("ERROR: Cannot support number of channles of %d in this mode\n",
                  priv->nchannels);
-          return -EINVAL;
+          return false;
         }
 
       DEBUGASSERT(priv->align == priv->nchannels * priv->bpsamp / 8);
@@ -659,6 +716,235 @@ static void pcm_subsample(FAR struct pcm_decode_s *priv,
 }
 #endif
 
+/****************************************************************************
+ * Name: pcm_setformat
+ *
+ * Description:
+ *   Configure the lower level for the number of channels, sample rate and
+ *   sample bitwidth.
+ *
+ ****************************************************************************/
+
+static int pcm_setformat(FAR struct pcm_decode_s *priv, uint8_t nchannels,
+                         uint32_t samprate, uint8_t bpsamp)
+{
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+  struct audio_caps_s caps;
+
+  DEBUGASSERT(samprate < 65535);
+
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = nchannels;
+
+  caps.ac_controls.hw[0] = (uint16_t)samprate;
+  caps.ac_controls.b[2]  = bpsamp;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->configure(lower, priv->session, &caps);
+#else
+  return lower->ops->configure(lower, &caps);
+#endif
+}
+
+/****************************************************************************
+ * Name: pcm_adapt
+ *
+ * Description:
+ *   The lower level driver refused the format of the WAV file.  Look for a
+ *   format that it accepts and that the samples can be converted to in
+ *   place:  At most 16 bits per sample, stereo or mono and the sample rate
+ *   divided by a small integer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+static int pcm_adapt(FAR struct pcm_decode_s *priv)
+{
+  uint8_t nchannels;
+  uint8_t bpsamp;
+  uint8_t decimate;
+  int ret = -EINVAL;
+
+  bpsamp = MIN(priv->bpsamp, 16);
+
+  for (nchannels = MIN(priv->nchannels, 2); nchannels > 0; nchannels--)
+    {
+      for (decimate = 1; decimate <= PCM_MAXDECIMATE; decimate++)
+        {
+          /* Skip the format that was already refused and rates that are
+           * not an integer divisor.
+           */
+
+          if ((bpsamp == priv->bpsamp && nchannels == priv->nchannels &&
+               decimate == 1) || (priv->samprate % decimate) != 0)
+            {
+              continue;
+            }
+
+          ret = pcm_setformat(priv, nchannels, priv->samprate / decimate,
+                              bpsamp);
+          if (ret >= 0)
+            {
+              audinfo("Adapting to %u channels, %lu Hz, %u bits\n",
+                      nchannels, (unsigned long)priv->samprate / decimate,
+                      bpsamp);
+
+              priv->convert    = true;
+              priv->obpsamp    = bpsamp;
+              priv->onchannels = nchannels;
+              priv->decimate   = decimate;
+              return OK;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pcm_getsample
+ *
+ * Description:
+ *   Return one sample of an input frame as a signed 16-bit value.
+ *
+ ****************************************************************************/
+
+static inline int16_t pcm_getsample(FAR const uint8_t *frame,
+                                    uint8_t bpsamp, int channel)
+{
+  FAR const uint8_t *src = &frame[channel * (bpsamp >> 3)];
+
+  switch (bpsamp)
+    {
+      case 8:
+        return (int16_t)((src[0] - 128) << 8);
+
+      case 16:
+        return (int16_t)((uint16_t)src[0] | ((uint16_t)src[1] << 8));
+
+      case 24:
+        return (int16_t)((uint16_t)src[1] | ((uint16_t)src[2] << 8));
+
+      default:
+        return (int16_t)((uint16_t)src[2] | ((uint16_t)src[3] << 8));
+    }
+}
+
+/****************************************************************************
+ * Name: pcm_convert
+ *
+ * Description:
+ *   Convert the samples of an audio buffer in place to the format selected
+ *   by pcm_adapt().
+ *
+ *   Each output frame is no larger than its input frame, so output can be
+ *   written behind the input that has been read.  A frame that is split
+ *   between two audio buffers is completed from the next buffer, and its
+ *   output is held until there is room for it without overwriting unread
+ *   input.
+ *
+ ****************************************************************************/
+
+static void pcm_convert(FAR struct pcm_decode_s *priv,
+                        FAR struct ap_buffer_s *apb)
+{
+  FAR uint8_t *buf = apb->samp;
+  FAR uint8_t *out;
+  unsigned int ofsize;
+  unsigned int rpos;
+  unsigned int wpos;
+  unsigned int end;
+  unsigned int n;
+  int16_t sample;
+  int ch;
+
+  ofsize = priv->onchannels * (priv->obpsamp >> 3);
+  rpos   = apb->curbyte;
+  wpos   = apb->curbyte;
+  end    = apb->nbytes;
+
+  for (; ; )
+    {
+      /* Assemble the next input frame */
+
+      n = MIN(priv->align - priv->ncarry, end - rpos);
+      memcpy(&priv->carry[priv->ncarry], &buf[rpos], n);
+      priv->ncarry += n;
+      rpos         += n;
+
+      if (priv->ncarry < priv->align)
+        {
+          break;
+        }
+
+      priv->ncarry = 0;
+
+      /* Convert the frame unless it is dropped to reduce the rate */
+
+      if (priv->phase == 0 && priv->npend + ofsize <= PCM_MAXPEND)
+        {
+          out = &priv->pend[priv->npend];
+          for (ch = 0; ch < priv->onchannels; ch++)
+            {
+              if (priv->onchannels < priv->nchannels && priv->onchannels == 1)
+                {
+                  /* Mix down the first two channels */
+
+                  sample = (int16_t)
+                    (((int32_t)pcm_getsample(priv->carry, priv->bpsamp, 0) +
+                      (int32_t)pcm_getsample(priv->carry, priv->bpsamp, 1))
+                     >> 1);
+                }
+              else
+                {
+                  sample = pcm_getsample(priv->carry, priv->bpsamp, ch);
+                }
+
+              if (priv->obpsamp == 8)
+                {
+                  *out++ = (uint8_t)((sample >> 8) + 128);
+                }
+              else
+                {
+                  *out++ = (uint8_t)sample;
+                  *out++ = (uint8_t)(sample >> 8);
+                }
+            }
+
+          priv->npend += ofsize;
+        }
+
+      if (++priv->phase >= priv->decimate)
+        {
+          priv->phase = 0;
+        }
+
+      /* Write the output that fits behind the input read so far */
+
+      while (priv->npend >= ofsize && wpos + ofsize <= rpos)
+        {
+          memcpy(&buf[wpos], priv->pend, ofsize);
+          wpos        += ofsize;
+          priv->npend -= ofsize;
+          memmove(priv->pend, &priv->pend[ofsize], priv->npend);
+        }
+    }
+
+  /* All input has been read:  The rest of the buffer is free */
+
+  while (priv->npend >= ofsize && wpos + ofsize <= apb->nmaxbytes)
+    {
+      memcpy(&buf[wpos], priv->pend, ofsize);
+      wpos        += ofsize;
+      priv->npend -= ofsize;
+      memmove(priv->pend, &priv->pend[ofsize], priv->npend);
+    }
+
+  apb->nbytes = wpos;
+}
+#endif /* CONFIG_AUDIO_PCM_CONVERT */
+
 /****************************************************************************
  * Name: pcm_getcaps
  *
@@ -1054,6 +1340,15 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
       pcm_subsample(priv, apb);
 #endif
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+      /* Adapt the samples to the format of the lower driver */
+
+      if (priv->convert)
+        {
+          pcm_convert(priv, apb);
+        }
+#endif
+
       /* Then give the audio buffer to the lower driver */
 
       audinfo("Pass to lower enqueuebuffer: apb=%p curbyte=%d nbytes=%d\n",
@@ -1078,26 +1373,29 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
 
       if (pcm_parsewav(priv, &apb->samp[apb->curbyte]))
         {
-          struct audio_caps_s caps;
-
           /* Configure the lower level for the number of channels, bitrate,
            * and sample bitwidth.
            */
 
-          DEBUGASSERT(priv->samprate < 65535);
+          ret = pcm_setformat(priv, priv->nchannels, priv->samprate,
+                              priv->bpsamp);
 
-          caps.ac_len            = sizeof(struct audio_caps_s);
-          caps.ac_type           = AUDIO_TYPE_OUTPUT;
-          caps.ac_channels       = priv->nchannels;
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+          /* If the lower level does not support the format, look for one
+           * that the samples can be converted to.
+           */
 
-          caps.ac_controls.hw[0] = (uint16_t)priv->samprate;
-          caps.ac_controls.b[2]  = priv->bpsamp;
+          priv->convert = false;
+          priv->phase   = 0;
+          priv->ncarry  = 0;
+          priv->npend   = 0;
 
-#ifdef CONFIG_AUDIO_MULTI_SESSION
-          ret = lower->ops->configure(lower, priv->session, &caps);
-#else
-          ret = lower->ops->configure(lower, &caps);
+          if (ret < 0)
+            {
+              ret = pcm_adapt(priv);
+            }
 #endif
+
           if (ret < 0)
             {
               auderr("ERROR: Failed to set PCM configuration: %d\n", ret);
@@ -1117,6 +1415,13 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
           pcm_subsample(priv, apb);
 #endif
 
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+          if (priv->convert)
+            {
+              pcm_convert(priv, apb);
+            }
+#endif
+
           /* Then give the audio buffer to the lower driver */
 
           audinfo("Pass to lower enqueuebuffer: apb=%p curbyte=%d nbytes=%d\n",
@@ -1211,6 +1516,44 @@ static int pcm_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
   lower = priv->lower;
   DEBUGASSERT(lower && lower->ops->ioctl);
 
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+  if (cmd == AUDIOIOC_GETBUFFERINFO)
+    {
+      FAR struct ap_buffer_info_s *bufinfo =
+        (FAR struct ap_buffer_info_s *)((uintptr_t)arg);
+      int ret;
+
+      /* Size the buffers to the period of the lower driver */
+
+      ret = lower->ops->ioctl(lower, cmd, arg);
+      if (ret < 0)
+        {
+          bufinfo->nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+          bufinfo->buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+        }
+
+#ifdef CONFIG_AUDIO_PCM_CONVERT
+      /* If the data is being converted, a buffer must hold enough input
+       * to fill a whole period after conversion.
+       */
+
+      if (priv->convert)
+        {
+          bufinfo->buffer_size = bufinfo->buffer_size * priv->align *
+                                 priv->decimate /
+                                 (priv->onchannels * (priv->obpsamp >> 3));
+        }
+#endif
+
+      /* Keep enough buffers in flight to cover the latency of refilling
+       * them.
+       */
+
+      bufinfo->nbuffers = MAX(bufinfo->nbuffers, CONFIG_AUDIO_PCM_NBUFFERS);
+      return OK;
+    }
+#endif
+
   audinfo("Defer to lower ioctl, cmd=%d arg=%ld\n");
   return lower->ops->ioctl(lower, cmd, arg);
 }
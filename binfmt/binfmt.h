@@ -132,6 +132,25 @@ void binfmt_freeargv(FAR struct binary_s *bin);
 #  define binfmt_freeargv(bin)
 #endif
 
+/****************************************************************************
+ * Name: binfmt_cache_load, binfmt_cache_add, and binfmt_cache_release
+ *
+ * Description:
+ *   The image cache keeps the loaded images of recently run programs.
+ *   binfmt_cache_load() sets up 'bin' from a cached image, returning a
+ *   negated errno value if there is none that can be used.
+ *   binfmt_cache_add() takes over the image just loaded into 'bin'.
+ *   binfmt_cache_release() returns the image of a program that has exited
+ *   to the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+int binfmt_cache_load(FAR struct binary_s *bin);
+void binfmt_cache_add(FAR struct binary_s *bin);
+void binfmt_cache_release(FAR struct binary_s *bin);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
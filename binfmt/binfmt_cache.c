@@ -0,0 +1,397 @@
+/****************************************************************************
+ * binfmt/binfmt_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/binfmt/binfmt.h>
+
+#include "binfmt.h"
+
+#ifdef CONFIG_BINFMT_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached program image.  'image' holds the state returned by the
+ * binary format's load() method; the memory that it refers to belongs to
+ * the cache entry.  'snapshot' holds the initial contents of the writable
+ * data region, taken after relocation and before the program first ran.
+ */
+
+struct binfmt_cache_s
+{
+  FAR char *filename;                  /* Absolute path of the program */
+  FAR const struct symtab_s *exports;  /* Symbol table it was bound to */
+  int nexports;
+  off_t size;                          /* File size when it was loaded */
+  time_t mtime;                        /* File time when it was loaded */
+  uint32_t lastuse;                    /* For least-recently-used eviction */
+  bool busy;                           /* An instance is running */
+  bool stale;                          /* Free when the instance exits */
+  FAR void *snapshot;                  /* Initial data region contents */
+  struct binary_s image;               /* The loaded image */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct binfmt_cache_s g_bincache[CONFIG_BINFMT_CACHE_NENTRIES];
+static sem_t g_bincache_sem = SEM_INITIALIZER(1);
+static uint32_t g_bincache_clock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_cache_lock
+ ****************************************************************************/
+
+static void binfmt_cache_lock(void)
+{
+  int ret;
+
+  do
+    {
+      /* The only error expected is -EINTR, if the wait was awakened by a
+       * signal.
+       */
+
+      ret = nxsem_wait(&g_bincache_sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret < 0);
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_free
+ *
+ * Description:
+ *   Release the memory held by a cache entry and mark it unused.
+ *
+ ****************************************************************************/
+
+static void binfmt_cache_free(FAR struct binfmt_cache_s *entry)
+{
+  FAR struct binary_s *image = &entry->image;
+  int i;
+
+  binfo("Evicting %s\n", entry->filename);
+
+  if (image->unload != NULL)
+    {
+      (void)image->unload(image);
+    }
+
+  for (i = 0; i < BINFMT_NALLOC; i++)
+    {
+      if (image->alloc[i] != NULL)
+        {
+          kumm_free(image->alloc[i]);
+        }
+    }
+
+  kmm_free(entry->snapshot);
+  kmm_free(entry->filename);
+  memset(entry, 0, sizeof(struct binfmt_cache_s));
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_find
+ *
+ * Description:
+ *   Find the entry for a program loaded from 'bin->filename' and bound to
+ *   the same symbol table.  Entries for older versions of the file are
+ *   freed (or marked stale if they are running).  The cache must be
+ *   locked.
+ *
+ ****************************************************************************/
+
+static FAR struct binfmt_cache_s *
+binfmt_cache_find(FAR const struct binary_s *bin,
+                  FAR const struct stat *buf)
+{
+  FAR struct binfmt_cache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_BINFMT_CACHE_NENTRIES; i++)
+    {
+      entry = &g_bincache[i];
+      if (entry->filename == NULL || entry->stale ||
+          strcmp(entry->filename, bin->filename) != 0)
+        {
+          continue;
+        }
+
+      if (entry->size != buf->st_size || entry->mtime != buf->st_mtime)
+        {
+          /* The file has changed since it was cached */
+
+          if (entry->busy)
+            {
+              entry->stale = true;
+            }
+          else
+            {
+              binfmt_cache_free(entry);
+            }
+
+          continue;
+        }
+
+      if (entry->exports == bin->exports &&
+          entry->nexports == bin->nexports)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_cache_load
+ *
+ * Description:
+ *   Set up 'bin' from the cached image of the program, if there is one
+ *   that is not running.  Only the writable data region is restored; the
+ *   relocated code and the constructor lists are reused as they are.
+ *
+ * Returned Value:
+ *   Zero (OK) if the program was set up from the cache; a negated errno
+ *   value if it must be loaded from the file.
+ *
+ ****************************************************************************/
+
+int binfmt_cache_load(FAR struct binary_s *bin)
+{
+  FAR struct binfmt_cache_s *entry;
+  struct stat buf;
+  int ret;
+
+  ret = stat(bin->filename, &buf);
+  if (ret < 0)
+    {
+      return -ENOENT;
+    }
+
+  binfmt_cache_lock();
+
+  entry = binfmt_cache_find(bin, &buf);
+  if (entry == NULL || entry->busy)
+    {
+      nxsem_post(&g_bincache_sem);
+      return entry == NULL ? -ENOENT : -EBUSY;
+    }
+
+  entry->busy    = true;
+  entry->lastuse = ++g_bincache_clock;
+
+  memcpy(entry->image.datastart, entry->snapshot, entry->image.datasize);
+
+  /* Return everything the binary format provided except the allocations,
+   * which stay with the cache entry.
+   */
+
+  bin->entrypt   = entry->image.entrypt;
+  bin->stacksize = entry->image.stacksize;
+  bin->datastart = entry->image.datastart;
+  bin->datasize  = entry->image.datasize;
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  bin->ctors     = entry->image.ctors;
+  bin->nctors    = entry->image.nctors;
+  bin->dtors     = entry->image.dtors;
+  bin->ndtors    = entry->image.ndtors;
+#endif
+  bin->unload    = NULL;
+  bin->cache     = entry;
+
+  nxsem_post(&g_bincache_sem);
+
+  binfo("Loaded %s from the cache\n", bin->filename);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_add
+ *
+ * Description:
+ *   Take over the image just loaded into 'bin' so that later runs of the
+ *   same program can use it.  This is only possible if the binary format
+ *   described the writable data region and nothing was memory-mapped.  If
+ *   all entries are in use, the image is not cached and stays with 'bin'.
+ *
+ ****************************************************************************/
+
+void binfmt_cache_add(FAR struct binary_s *bin)
+{
+  FAR struct binfmt_cache_s *entry = NULL;
+  FAR void *snapshot;
+  FAR char *filename;
+  struct stat buf;
+  size_t len;
+  int i;
+
+  if (bin->datastart == NULL || bin->mapped != NULL ||
+      stat(bin->filename, &buf) < 0)
+    {
+      return;
+    }
+
+  len      = strlen(bin->filename) + 1;
+  snapshot = kmm_malloc(bin->datasize > 0 ? bin->datasize : 1);
+  filename = (FAR char *)kmm_malloc(len);
+  if (snapshot == NULL || filename == NULL)
+    {
+      goto errout;
+    }
+
+  memcpy(filename, bin->filename, len);
+  memcpy(snapshot, bin->datastart, bin->datasize);
+
+  binfmt_cache_lock();
+
+  /* Never cache a second copy of a program that is already cached */
+
+  if (binfmt_cache_find(bin, &buf) != NULL)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Use a free entry, or else the least recently used idle entry */
+
+  for (i = 0; i < CONFIG_BINFMT_CACHE_NENTRIES; i++)
+    {
+      FAR struct binfmt_cache_s *candidate = &g_bincache[i];
+
+      if (candidate->filename == NULL)
+        {
+          entry = candidate;
+          break;
+        }
+
+      if (!candidate->busy &&
+          (entry == NULL || candidate->lastuse < entry->lastuse))
+        {
+          entry = candidate;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      goto errout_with_lock;
+    }
+
+  if (entry->filename != NULL)
+    {
+      binfmt_cache_free(entry);
+    }
+
+  entry->filename       = filename;
+  entry->exports        = bin->exports;
+  entry->nexports       = bin->nexports;
+  entry->size           = buf.st_size;
+  entry->mtime          = buf.st_mtime;
+  entry->lastuse        = ++g_bincache_clock;
+  entry->busy           = true;
+  entry->snapshot       = snapshot;
+
+  /* The cache entry now owns the allocations and the unload method */
+
+  memcpy(&entry->image, bin, sizeof(struct binary_s));
+  entry->image.filename = filename;
+  entry->image.argv     = NULL;
+
+  memset(bin->alloc, 0, sizeof(bin->alloc));
+  bin->unload           = NULL;
+  bin->cache            = entry;
+
+  nxsem_post(&g_bincache_sem);
+  return;
+
+errout_with_lock:
+  nxsem_post(&g_bincache_sem);
+errout:
+  kmm_free(snapshot);
+  kmm_free(filename);
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_release
+ *
+ * Description:
+ *   Called when the program loaded into 'bin' from the cache has exited.
+ *   The cached image becomes available to the next run, or is freed if
+ *   the file has changed in the meantime.
+ *
+ ****************************************************************************/
+
+void binfmt_cache_release(FAR struct binary_s *bin)
+{
+  FAR struct binfmt_cache_s *entry = bin->cache;
+
+  DEBUGASSERT(entry != NULL && entry->busy);
+
+  binfmt_cache_lock();
+
+  entry->busy = false;
+  if (entry->stale)
+    {
+      binfmt_cache_free(entry);
+    }
+
+  nxsem_post(&g_bincache_sem);
+  bin->cache = NULL;
+}
+
+#endif /* CONFIG_BINFMT_CACHE */
@@ -140,9 +140,7 @@ int binfmt_copyargv(FAR struct binary_s *bin, FAR char * const *argv)
           for (i = 0; argv[i]; i++)
             {
               bin->argv[i] = ptr;
-              argsize      = strlen(argv[i]) + 1;
-              memcpy(ptr, argv[i], argsize);
-              ptr         += argsize;
+              ptr          = stpcpy(ptr, argv[i]) + 1;
             }
 
           /* Terminate the argv[] list */
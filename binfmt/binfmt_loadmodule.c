@@ -123,6 +123,16 @@ static int load_absmodule(FAR struct binary_s *bin)
 
   binfo("Loading %s\n", bin->filename);
 
+#ifdef CONFIG_BINFMT_CACHE
+  /* Reuse the image of an earlier run of the program if there is one */
+
+  if (binfmt_cache_load(bin) == OK)
+    {
+      dump_module(bin);
+      return OK;
+    }
+#endif
+
   /* Disabling pre-emption should be sufficient protection while accessing
    * the list of registered binary format handlers.
    */
@@ -154,6 +164,14 @@ static int load_absmodule(FAR struct binary_s *bin)
     }
 
   sched_unlock();
+
+#ifdef CONFIG_BINFMT_CACHE
+  if (ret == OK)
+    {
+      binfmt_cache_add(bin);
+    }
+#endif
+
   return ret;
 }
 
@@ -181,6 +181,16 @@ int unload_module(FAR struct binary_s *binp)
 
       binfmt_freeargv(binp);
 
+#ifdef CONFIG_BINFMT_CACHE
+      /* The memory of a cached image belongs to the cache */
+
+      if (binp->cache != NULL)
+        {
+          binfmt_cache_release(binp);
+          return OK;
+        }
+#endif
+
       /* Unmap mapped address spaces */
 
       if (binp->mapped)
@@ -121,6 +121,10 @@ static void elf_dumploadinfo(FAR struct elf_loadinfo_s *loadinfo)
   berr("  textsize:     %ld\n",   (long)loadinfo->textsize);
   berr("  datasize:     %ld\n",   (long)loadinfo->datasize);
   berr("  filelen:      %ld\n",   (long)loadinfo->filelen);
+#ifdef CONFIG_ELF_XIP
+  berr("  xipbase:      %08lx\n", (long)loadinfo->xipbase);
+  berr("  textbase:     %08lx\n", (long)loadinfo->textbase);
+#endif
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
   berr("  ctoralloc:    %08lx\n", (long)loadinfo->ctoralloc);
   berr("  ctors:        %08lx\n", (long)loadinfo->ctors);
@@ -262,7 +266,7 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   /* Return the load information */
 
-  binp->entrypt   = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
+  binp->entrypt   = (main_t)(ELF_TEXTBASE(&loadinfo) + loadinfo.ehdr.e_entry);
   binp->stacksize = CONFIG_ELF_STACKSIZE;
 
   /* Add the ELF allocation to the alloc[] only if there is no address
@@ -279,6 +283,13 @@ static int elf_loadbinary(FAR struct binary_s *binp)
   binp->alloc[0]  = (FAR void *)loadinfo.textalloc;
 #endif
 
+#ifdef CONFIG_BINFMT_CACHE
+  /* Report the writable data so that the image can be run again */
+
+  binp->datastart = (FAR void *)loadinfo.dataalloc;
+  binp->datasize  = loadinfo.datasize;
+#endif
+
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
   /* Save information about constructors.  NOTE:  destructors are not
    * yet supported.
@@ -48,6 +48,21 @@
 #include <nuttx/arch.h>
 #include <nuttx/binfmt/elf.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ELF_TEXTBASE is the address of the first .text section of the loaded ELF
+ * image.  Without execute-in-place support, that is always the beginning
+ * of the text allocation.
+ */
+
+#ifdef CONFIG_ELF_XIP
+#  define ELF_TEXTBASE(l) ((l)->textbase)
+#else
+#  define ELF_TEXTBASE(l) ((l)->textalloc)
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
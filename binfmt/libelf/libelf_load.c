@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -51,6 +52,7 @@
 #include <debug.h>
 
 #include <nuttx/addrenv.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/binfmt/elf.h>
 
 #include "libelf.h"
@@ -79,6 +81,60 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_xipsection
+ *
+ * Description:
+ *   Determine if a section can be executed in place.  That is possible only
+ *   if the ELF file is memory-mapped, the section is read-only, has data in
+ *   the file, is suitably aligned in the mapped file, and is not modified
+ *   by any relocation.
+ *
+ * Returned Value:
+ *   The address of the section in the memory-mapped file, or zero if the
+ *   section must be copied into RAM.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static uintptr_t elf_xipsection(FAR struct elf_loadinfo_s *loadinfo, int index)
+{
+  FAR Elf32_Shdr *shdr = &loadinfo->shdr[index];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == 0 ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+      shdr->sh_type == SHT_NOBITS)
+    {
+      return 0;
+    }
+
+  addr = loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr & (shdr->sh_addralign - 1)) != 0)
+    {
+      return 0;
+    }
+
+  /* Any relocation section that applies to this section prevents XIP */
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf32_Shdr *relsec = &loadinfo->shdr[i];
+
+      if ((relsec->sh_type == SHT_REL || relsec->sh_type == SHT_RELA) &&
+          relsec->sh_info == (Elf32_Word)index && relsec->sh_size > 0)
+        {
+          return 0;
+        }
+    }
+
+  return addr;
+}
+#else
+#  define elf_xipsection(l,i) 0
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -120,7 +176,10 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
             {
               datasize += ELF_ALIGNUP(shdr->sh_size);
             }
-          else
+
+          /* Read-only sections that execute in place need no memory */
+
+          else if (elf_xipsection(loadinfo, i) == 0)
             {
               textsize += ELF_ALIGNUP(shdr->sh_size);
             }
@@ -151,6 +210,9 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
   FAR uint8_t *text;
   FAR uint8_t *data;
   FAR uint8_t **pptr;
+#ifdef CONFIG_ELF_XIP
+  uintptr_t xipaddr;
+#endif
   int ret;
   int i;
 
@@ -160,6 +222,10 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
   text = (FAR uint8_t *)loadinfo->textalloc;
   data = (FAR uint8_t *)loadinfo->dataalloc;
 
+#ifdef CONFIG_ELF_XIP
+  loadinfo->textbase = 0;
+#endif
+
   for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
     {
       FAR Elf32_Shdr *shdr = &loadinfo->shdr[i];
@@ -182,6 +248,32 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
         }
       else
         {
+#ifdef CONFIG_ELF_XIP
+          /* A read-only section in a memory-mapped file may be used in
+           * place.
+           */
+
+          xipaddr = elf_xipsection(loadinfo, i);
+          if (xipaddr != 0)
+            {
+              binfo("%d. %08lx->%08lx (XIP)\n", i,
+                    (unsigned long)shdr->sh_addr, (unsigned long)xipaddr);
+
+              shdr->sh_addr = xipaddr;
+              if (loadinfo->textbase == 0)
+                {
+                  loadinfo->textbase = xipaddr;
+                }
+
+              continue;
+            }
+
+          if (loadinfo->textbase == 0)
+            {
+              loadinfo->textbase = (uintptr_t)text;
+            }
+#endif
+
           pptr = &text;
         }
 
@@ -262,6 +354,23 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* If the file lies on a file system that supports FIOC_MMAP (such as a
+   * ROMFS in memory-mapped FLASH), try get the address of the file in
+   * memory so that read-only sections can be executed in place.  Failure
+   * is not an error; the sections are then simply copied into RAM.
+   */
+
+  loadinfo->xipbase = 0;
+  if (ioctl(loadinfo->filfd, FIOC_MMAP,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = 0;
+    }
+
+  binfo("xipbase: %08lx\n", (unsigned long)loadinfo->xipbase);
+#endif
+
   /* Determine total size to allocate */
 
   elf_elfsize(loadinfo);
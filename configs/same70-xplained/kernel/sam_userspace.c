@@ -41,6 +41,7 @@
 
 #include <stdlib.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/userspace.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/mm/mm.h>
@@ -123,6 +124,12 @@ const struct userspace_s userspace __attribute__ ((section (".userspace"))) =
 #ifdef CONFIG_LIB_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* Time page updated by the kernel (declared in include/nuttx/clock.h) */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  .us_timepage      = &g_timepage,
+#endif
 };
 
 /****************************************************************************
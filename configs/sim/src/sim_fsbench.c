@@ -0,0 +1,634 @@
+/****************************************************************************
+ * configs/sim/src/sim_fsbench.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mount.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SIM_FSBENCH_PATH
+#  define CONFIG_SIM_FSBENCH_PATH "/tmp"
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_FSTYPE
+#  define CONFIG_SIM_FSBENCH_FSTYPE "tmpfs"
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_SOURCE
+#  define CONFIG_SIM_FSBENCH_SOURCE ""
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_FILESIZE
+#  define CONFIG_SIM_FSBENCH_FILESIZE (256 * 1024)
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_MINBLOCK
+#  define CONFIG_SIM_FSBENCH_MINBLOCK 512
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_MAXBLOCK
+#  define CONFIG_SIM_FSBENCH_MAXBLOCK 8192
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_NFILES
+#  define CONFIG_SIM_FSBENCH_NFILES 100
+#endif
+
+#ifndef CONFIG_SIM_FSBENCH_NSYNCS
+#  define CONFIG_SIM_FSBENCH_NSYNCS 100
+#endif
+
+/* The block size is multiplied by this between the block tests */
+
+#define FSBENCH_BLOCKSTEP 4
+
+/* The most operations that one test can perform */
+
+#define FSBENCH_MAXOPS \
+  (CONFIG_SIM_FSBENCH_FILESIZE / CONFIG_SIM_FSBENCH_MINBLOCK + \
+   CONFIG_SIM_FSBENCH_NFILES + CONFIG_SIM_FSBENCH_NSYNCS)
+
+/* Longest path name of a benchmark file */
+
+#define FSBENCH_PATHLEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fsbench_s
+{
+  FAR const char *path;              /* Directory or raw device */
+  bool raw;                          /* True: 'path' is a device */
+  uint32_t seed;                     /* Pseudo-random sequence */
+  uint64_t start;                    /* Host time at start of the test */
+  uint64_t last;                     /* Host time at start of the operation */
+  uint64_t nbytes;                   /* Bytes moved by the test */
+  int nops;                          /* Operations of the test */
+  FAR uint32_t *lat;                 /* Latency of each operation (nsec) */
+  FAR uint8_t *buffer;               /* Data buffer (MAXBLOCK bytes) */
+  char name[FSBENCH_PATHLEN];        /* Path of the current file */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct fsbench_s g_fsbench;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_begin, fsbench_opstart, fsbench_opend
+ *
+ * Description:
+ *   Mark the start of a test and the start and the end of each of its
+ *   operations.  The simulated clock only advances while the IDLE loop
+ *   runs, so the host time is used.
+ *
+ ****************************************************************************/
+
+static void fsbench_begin(void)
+{
+  g_fsbench.seed   = 1;
+  g_fsbench.nbytes = 0;
+  g_fsbench.nops   = 0;
+  g_fsbench.start  = up_hostnsec();
+}
+
+static inline void fsbench_opstart(void)
+{
+  g_fsbench.last = up_hostnsec();
+}
+
+static inline void fsbench_opend(size_t nbytes)
+{
+  uint64_t elapsed = up_hostnsec() - g_fsbench.last;
+
+  if (g_fsbench.nops < FSBENCH_MAXOPS)
+    {
+      g_fsbench.lat[g_fsbench.nops++] =
+        elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+    }
+
+  g_fsbench.nbytes += nbytes;
+}
+
+/****************************************************************************
+ * Name: fsbench_random
+ ****************************************************************************/
+
+static uint32_t fsbench_random(void)
+{
+  g_fsbench.seed = g_fsbench.seed * 1103515245 + 12345;
+  return g_fsbench.seed >> 8;
+}
+
+/****************************************************************************
+ * Name: fsbench_compare
+ *
+ * Description:
+ *   qsort() comparison of two latencies.
+ *
+ ****************************************************************************/
+
+static int fsbench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t la = *(FAR const uint32_t *)a;
+  uint32_t lb = *(FAR const uint32_t *)b;
+
+  return la < lb ? -1 : la > lb ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: fsbench_report
+ *
+ * Description:
+ *   Print one line of comma separated results:
+ *
+ *     fsbench,<test>,<bsize>,<ops>,<usec>,<iops>,<bytes/sec>,
+ *       <p50 nsec>,<p90 nsec>,<p99 nsec>,<max nsec>
+ *
+ *   where the last four are percentiles of the operation latencies.
+ *
+ ****************************************************************************/
+
+static void fsbench_report(FAR const char *test, size_t bsize, int ret)
+{
+  uint64_t usec;
+  int nops = g_fsbench.nops;
+
+  usec = (up_hostnsec() - g_fsbench.start) / 1000;
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+  if (ret < 0)
+    {
+      printf("# %s,%lu failed: %d\n", test, (unsigned long)bsize, ret);
+    }
+
+  if (nops == 0)
+    {
+      return;
+    }
+
+  qsort(g_fsbench.lat, nops, sizeof(uint32_t), fsbench_compare);
+
+  printf("fsbench,%s,%lu,%d,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+         test, (unsigned long)bsize, nops, (unsigned long)usec,
+         (unsigned long)((uint64_t)nops * 1000000 / usec),
+         (unsigned long)(g_fsbench.nbytes * 1000000 / usec),
+         (unsigned long)g_fsbench.lat[nops / 2],
+         (unsigned long)g_fsbench.lat[nops * 9 / 10],
+         (unsigned long)g_fsbench.lat[nops * 99 / 100],
+         (unsigned long)g_fsbench.lat[nops - 1]);
+}
+
+/****************************************************************************
+ * Name: fsbench_open
+ *
+ * Description:
+ *   Open the data file in the benchmark directory or the raw device.
+ *
+ ****************************************************************************/
+
+static int fsbench_open(int oflags)
+{
+  int fd;
+
+  if (g_fsbench.raw)
+    {
+      fd = open(g_fsbench.path, oflags & O_ACCMODE);
+    }
+  else
+    {
+      snprintf(g_fsbench.name, FSBENCH_PATHLEN, "%s/fsbench.dat",
+               g_fsbench.path);
+      fd = open(g_fsbench.name, oflags, 0666);
+    }
+
+  if (fd < 0)
+    {
+      ferr("ERROR: open failed: %d\n", errno);
+      return -errno;
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: fsbench_rw
+ *
+ * Description:
+ *   Read or write CONFIG_SIM_FSBENCH_FILESIZE bytes in blocks of 'bsize'
+ *   bytes, either sequentially or at random block offsets.  Sequential
+ *   writes create the file; the data is synchronized at the end of each
+ *   write test.
+ *
+ ****************************************************************************/
+
+static int fsbench_rw(size_t bsize, bool wr, bool rnd)
+{
+  int nblocks = CONFIG_SIM_FSBENCH_FILESIZE / bsize;
+  ssize_t nxfrd;
+  off_t offset;
+  int ret = OK;
+  int fd;
+  int i;
+
+  if (wr && !rnd)
+    {
+      fd = fsbench_open(O_WRONLY | O_CREAT | O_TRUNC);
+    }
+  else
+    {
+      fd = fsbench_open(wr ? O_RDWR : O_RDONLY);
+    }
+
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      fsbench_opstart();
+
+      if (rnd)
+        {
+          offset = (off_t)(fsbench_random() % nblocks) * bsize;
+          if (lseek(fd, offset, SEEK_SET) != offset)
+            {
+              ret = -errno;
+              break;
+            }
+        }
+
+      if (wr)
+        {
+          nxfrd = write(fd, g_fsbench.buffer, bsize);
+        }
+      else
+        {
+          nxfrd = read(fd, g_fsbench.buffer, bsize);
+        }
+
+      if (nxfrd < 0)
+        {
+          ret = -errno;
+          break;
+        }
+
+      fsbench_opend(nxfrd);
+    }
+
+  if (wr && !g_fsbench.raw && ret == OK && fsync(fd) < 0)
+    {
+      ret = -errno;
+    }
+
+  close(fd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_meta
+ *
+ * Description:
+ *   Create, stat() or unlink() CONFIG_SIM_FSBENCH_NFILES empty files.
+ *
+ ****************************************************************************/
+
+static int fsbench_meta(FAR const char *test)
+{
+  struct stat buf;
+  int ret = OK;
+  int fd;
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_FSBENCH_NFILES && ret == OK; i++)
+    {
+      snprintf(g_fsbench.name, FSBENCH_PATHLEN, "%s/fsb%05d",
+               g_fsbench.path, i);
+
+      fsbench_opstart();
+
+      switch (test[0])
+        {
+          case 'c':  /* create */
+            fd = open(g_fsbench.name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            if (fd < 0)
+              {
+                ret = -errno;
+              }
+            else
+              {
+                close(fd);
+              }
+            break;
+
+          case 's':  /* stat */
+            if (stat(g_fsbench.name, &buf) < 0)
+              {
+                ret = -errno;
+              }
+            break;
+
+          default:   /* unlink */
+            if (unlink(g_fsbench.name) < 0)
+              {
+                ret = -errno;
+              }
+            break;
+        }
+
+      fsbench_opend(0);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_fsync
+ *
+ * Description:
+ *   Overwrite the first CONFIG_SIM_FSBENCH_MINBLOCK bytes of the file and
+ *   fsync() it, CONFIG_SIM_FSBENCH_NSYNCS times.  Each operation is one
+ *   write() and fsync().
+ *
+ ****************************************************************************/
+
+static int fsbench_fsync(void)
+{
+  int ret = OK;
+  int fd;
+  int i;
+
+  fd = fsbench_open(O_WRONLY | O_CREAT);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  for (i = 0; i < CONFIG_SIM_FSBENCH_NSYNCS; i++)
+    {
+      fsbench_opstart();
+
+      if (lseek(fd, 0, SEEK_SET) != 0 ||
+          write(fd, g_fsbench.buffer, CONFIG_SIM_FSBENCH_MINBLOCK) < 0 ||
+          fsync(fd) < 0)
+        {
+          ret = -errno;
+          break;
+        }
+
+      fsbench_opend(CONFIG_SIM_FSBENCH_MINBLOCK);
+    }
+
+  close(fd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_mount and fsbench_umount
+ *
+ * Description:
+ *   Time mounting the file system at the benchmark path and unmounting it.
+ *   Nothing is done if no file system type is configured.
+ *
+ ****************************************************************************/
+
+static int fsbench_mount(void)
+{
+  FAR const char *source = CONFIG_SIM_FSBENCH_SOURCE;
+  int ret = OK;
+
+  if (CONFIG_SIM_FSBENCH_FSTYPE[0] == '\0' || g_fsbench.raw)
+    {
+      return OK;
+    }
+
+  fsbench_begin();
+  fsbench_opstart();
+
+  if (mount(source[0] != '\0' ? source : NULL, g_fsbench.path,
+            CONFIG_SIM_FSBENCH_FSTYPE, 0, NULL) < 0)
+    {
+      ret = -errno;
+    }
+  else
+    {
+      fsbench_opend(0);
+    }
+
+  fsbench_report("mount", 0, ret);
+  return ret;
+}
+
+static void fsbench_umount(void)
+{
+  if (CONFIG_SIM_FSBENCH_FSTYPE[0] == '\0' || g_fsbench.raw)
+    {
+      return;
+    }
+
+  fsbench_begin();
+  fsbench_opstart();
+
+  if (umount(g_fsbench.path) == 0)
+    {
+      fsbench_opend(0);
+    }
+
+  fsbench_report("umount", 0, OK);
+}
+
+/****************************************************************************
+ * Name: fsbench_selected
+ ****************************************************************************/
+
+static bool fsbench_selected(FAR const char *select, FAR const char *test)
+{
+  return select == NULL || strcmp(select, test) == 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_main
+ *
+ * Description:
+ *   fsbench_main is a file system and block I/O benchmark.  It mounts
+ *   CONFIG_SIM_FSBENCH_FSTYPE at the benchmark path (if configured) and
+ *   measures sequential and random reads and writes at block sizes from
+ *   CONFIG_SIM_FSBENCH_MINBLOCK to CONFIG_SIM_FSBENCH_MAXBLOCK, file
+ *   creation, stat() and unlink(), fsync() latency and the mount time.
+ *
+ *   The benchmark path is CONFIG_SIM_FSBENCH_PATH or the first argument.
+ *   If the path is not a directory, it is treated as a raw block device
+ *   (opened through the BCH layer) and only the read and write tests are
+ *   run:  Its first CONFIG_SIM_FSBENCH_FILESIZE bytes are overwritten.  A
+ *   second argument selects a single test by name.
+ *
+ ****************************************************************************/
+
+int fsbench_main(int argc, char *argv[])
+{
+  static const char *const rwtests[4] =
+  {
+    "seqwrite", "seqread", "randwrite", "randread"
+  };
+
+  FAR const char *select = argc > 2 ? argv[2] : NULL;
+  struct stat buf;
+  size_t bsize;
+  int errcount = 0;
+  int ret;
+  int i;
+
+  g_fsbench.path = argc > 1 ? argv[1] : CONFIG_SIM_FSBENCH_PATH;
+
+  g_fsbench.lat    = (FAR uint32_t *)malloc(FSBENCH_MAXOPS *
+                                            sizeof(uint32_t));
+  g_fsbench.buffer = (FAR uint8_t *)malloc(CONFIG_SIM_FSBENCH_MAXBLOCK);
+  if (g_fsbench.lat == NULL || g_fsbench.buffer == NULL)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate buffers\n");
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  memset(g_fsbench.buffer, 0xa5, CONFIG_SIM_FSBENCH_MAXBLOCK);
+
+  /* A path that exists and is not a directory is a raw device */
+
+  g_fsbench.raw = stat(g_fsbench.path, &buf) == 0 && !S_ISDIR(buf.st_mode);
+
+  printf("# fsbench,test,bsize,ops,usec,iops,bytes/sec,"
+         "p50 nsec,p90 nsec,p99 nsec,max nsec\n");
+  printf("# %s %s\n", g_fsbench.raw ? "device" : "directory",
+         g_fsbench.path);
+
+  ret = fsbench_mount();
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  for (bsize = CONFIG_SIM_FSBENCH_MINBLOCK;
+       bsize <= CONFIG_SIM_FSBENCH_MAXBLOCK;
+       bsize *= FSBENCH_BLOCKSTEP)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          if (!fsbench_selected(select, rwtests[i]))
+            {
+              continue;
+            }
+
+          fsbench_begin();
+          ret = fsbench_rw(bsize, (i & 1) == 0, i >= 2);
+          fsbench_report(rwtests[i], bsize, ret);
+          errcount += ret < 0;
+        }
+    }
+
+  if (!g_fsbench.raw)
+    {
+      static const char *const metatests[3] =
+      {
+        "create", "stat", "unlink"
+      };
+
+      for (i = 0; i < 3; i++)
+        {
+          if (fsbench_selected(select, metatests[i]))
+            {
+              fsbench_begin();
+              ret = fsbench_meta(metatests[i]);
+              fsbench_report(metatests[i], 0, ret);
+              errcount += ret < 0;
+            }
+        }
+
+      if (fsbench_selected(select, "fsync"))
+        {
+          fsbench_begin();
+          ret = fsbench_fsync();
+          fsbench_report("fsync", CONFIG_SIM_FSBENCH_MINBLOCK, ret);
+          errcount += ret < 0;
+        }
+
+      snprintf(g_fsbench.name, FSBENCH_PATHLEN, "%s/fsbench.dat",
+               g_fsbench.path);
+      (void)unlink(g_fsbench.name);
+    }
+
+  fsbench_umount();
+  ret = OK;
+
+errout:
+  free(g_fsbench.buffer);
+  free(g_fsbench.lat);
+  return ret < 0 || errcount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
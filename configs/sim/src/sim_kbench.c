@@ -0,0 +1,1719 @@
+/****************************************************************************
+ * configs/sim/src/sim_kbench.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <mqueue.h>
+#include <spawn.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/mm.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SIM_KBENCH_NOPS
+#  define CONFIG_SIM_KBENCH_NOPS 10000
+#endif
+
+#ifndef CONFIG_SIM_KBENCH_PRIORITY
+#  define CONFIG_SIM_KBENCH_PRIORITY 100
+#endif
+
+#ifndef CONFIG_SIM_KBENCH_STACKSIZE
+#  define CONFIG_SIM_KBENCH_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_SIM_KBENCH_NMUTEXTHREADS
+#  define CONFIG_SIM_KBENCH_NMUTEXTHREADS 4
+#endif
+
+#ifndef CONFIG_SIM_KBENCH_NLIVE
+#  define CONFIG_SIM_KBENCH_NLIVE 64
+#endif
+
+#ifndef CONFIG_SIM_KBENCH_PIPEBLOCK
+#  define CONFIG_SIM_KBENCH_PIPEBLOCK 256
+#endif
+
+#ifndef CONFIG_SMP_NCPUS
+#  define CONFIG_SMP_NCPUS 1
+#endif
+
+/* Which tests can be built */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+#  define KBENCH_HAVE_PIPE 1
+#endif
+
+#if defined(KBENCH_HAVE_PIPE) && CONFIG_DEV_FIFO_SIZE > 0
+#  define KBENCH_HAVE_FIFO 1
+#endif
+
+#if defined(KBENCH_HAVE_PIPE) && !defined(CONFIG_DISABLE_POLL)
+#  define KBENCH_HAVE_POLL 1
+#endif
+
+#ifndef CONFIG_BUILD_KERNEL
+#  define KBENCH_HAVE_SPAWN 1
+#endif
+
+#if defined(CONFIG_LIBM) && defined(CONFIG_HAVE_DOUBLE)
+#  define KBENCH_HAVE_MATH 1
+#endif
+
+#if defined(CONFIG_SCHED_HPWORK)
+#  define KBENCH_WORK HPWORK
+#elif defined(CONFIG_SCHED_LPWORK)
+#  define KBENCH_WORK LPWORK
+#endif
+
+/* Size of a message queue message */
+
+#define KBENCH_MSGSIZE 16
+
+/* The small block size of the pipe tests and the largest block size */
+
+#define KBENCH_PIPESMALL 16
+
+#if CONFIG_SIM_KBENCH_PIPEBLOCK > KBENCH_PIPESMALL
+#  define KBENCH_PIPEMAX CONFIG_SIM_KBENCH_PIPEBLOCK
+#else
+#  define KBENCH_PIPEMAX KBENCH_PIPESMALL
+#endif
+
+/* The pipe and FIFO tests have a different name with the single reader/
+ * single writer pipes so that the results of the two can be compared.
+ */
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+#  define KBENCH_PIPENAME(n) n "_spsc"
+#else
+#  define KBENCH_PIPENAME(n) n
+#endif
+
+/* The path of the FIFO of the FIFO test */
+
+#define KBENCH_FIFOPATH "/dev/kbfifo"
+
+/* Each string test is run with three sizes.  The buffers hold the largest
+ * size plus a terminating NUL.
+ */
+
+#define KBENCH_STRMAX 4096
+#define KBENCH_STRING(n, f) \
+  { n "16", f, 16 }, { n "256", f, 256 }, { n "4k", f, KBENCH_STRMAX }
+
+/* The number of arguments that the timed part of a math test cycles
+ * through (a power of two).
+ */
+
+#define KBENCH_NMATH 256
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state shared by main thread and the peer threads of a test */
+
+struct kbench_s
+{
+  sem_t ping;                        /* Main -> peer */
+  sem_t pong;                        /* Peer -> main */
+  sem_t go;                          /* Releases the mutex test threads */
+  pthread_mutex_t mutex;             /* Contended by the mutex test */
+  volatile uint32_t counter;         /* Protected by 'mutex' */
+  uint64_t start;                    /* Host time at start of timed section */
+  uint64_t end;                      /* Host time at end of timed section */
+  uint64_t nbytes;                   /* Bytes moved by the timed section */
+  size_t size;                       /* Block size of the current test */
+  uint32_t seed;                     /* Pseudo-random sequence */
+  int fd[2];                         /* Pipe of the pipe and poll tests */
+#ifndef CONFIG_DISABLE_MQUEUE
+  mqd_t mqping;                      /* Main -> peer */
+  mqd_t mqpong;                      /* Peer -> main */
+#endif
+#ifdef KBENCH_WORK
+  struct work_s work;                /* Queued by the work test */
+#endif
+  FAR void *live[CONFIG_SIM_KBENCH_NLIVE]; /* Used by the malloc test */
+  size_t livesize[CONFIG_SIM_KBENCH_NLIVE]; /* Used by the realloc test */
+  char src[KBENCH_STRMAX + 1];       /* Source of the string tests */
+  char dest[KBENCH_STRMAX + 1];      /* Destination of the string tests */
+#ifdef KBENCH_HAVE_MATH
+  float x[KBENCH_NMATH];             /* First arguments of a math test */
+  float y[KBENCH_NMATH];             /* Second arguments (powf() only) */
+#endif
+};
+
+/* Describes one test.  run() performs CONFIG_SIM_KBENCH_NOPS operations
+ * and brackets the timed part with kbench_begin() and kbench_end().  Tests
+ * that move data use blocks of 'size' bytes.
+ */
+
+struct kbench_test_s
+{
+  FAR const char *name;
+  CODE int (*run)(void);
+  size_t size;
+};
+
+#ifdef KBENCH_HAVE_MATH
+/* Describes the function of a math test.  Either f or f2 is used.  ref or
+ * ref2 is the double precision function that gives the reference result.
+ * The arguments are uniformly distributed in [xlo, xhi) and [ylo, yhi).
+ */
+
+struct kbench_math_s
+{
+  FAR const char *name;
+  CODE float (*f)(float x);
+  CODE double (*ref)(double x);
+  CODE float (*f2)(float x, float y);
+  CODE double (*ref2)(double x, double y);
+  float xlo;
+  float xhi;
+  float ylo;
+  float yhi;
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int kbench_ctxsw(void);
+static int kbench_sem(void);
+static int kbench_mutex(void);
+#ifndef CONFIG_DISABLE_MQUEUE
+static int kbench_mqueue(void);
+#endif
+#ifndef CONFIG_DISABLE_SIGNALS
+static int kbench_signal(void);
+#endif
+static int kbench_malloc(void);
+static int kbench_realloc(void);
+static int kbench_wdog(void);
+#ifdef KBENCH_WORK
+static int kbench_workq(void);
+#endif
+#ifdef KBENCH_HAVE_PIPE
+static int kbench_pipe(void);
+#endif
+#ifdef KBENCH_HAVE_FIFO
+static int kbench_fifo(void);
+#endif
+#ifdef KBENCH_HAVE_POLL
+static int kbench_poll(void);
+#endif
+#ifdef KBENCH_HAVE_SPAWN
+static int kbench_spawn(void);
+#endif
+static int kbench_memcpy(void);
+static int kbench_memset(void);
+static int kbench_memcmp(void);
+static int kbench_memchr(void);
+static int kbench_strlen(void);
+static int kbench_strchr(void);
+#ifdef KBENCH_HAVE_MATH
+static int kbench_sinf(void);
+static int kbench_cosf(void);
+static int kbench_expf(void);
+static int kbench_logf(void);
+static int kbench_powf(void);
+static int kbench_sqrtf(void);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct kbench_s g_kbench;
+
+static const struct kbench_test_s g_kbench_tests[] =
+{
+  { "ctxsw",  kbench_ctxsw  },  /* sched_yield() between two threads */
+  { "sem",    kbench_sem    },  /* sem_post()/sem_wait() ping-pong */
+  { "mutex",  kbench_mutex  },  /* Contended pthread mutex */
+#ifndef CONFIG_DISABLE_MQUEUE
+  { "mqueue", kbench_mqueue },  /* mq_send()/mq_receive() ping-pong */
+#endif
+#ifndef CONFIG_DISABLE_SIGNALS
+  { "signal", kbench_signal },  /* pthread_kill() to sigwaitinfo() */
+#endif
+  { "malloc", kbench_malloc },  /* malloc()/free() of mixed sizes */
+  { "realloc", kbench_realloc }, /* Growing buffers with realloc() */
+  { "wdog",   kbench_wdog   },  /* wd_start()/wd_cancel() */
+#ifdef KBENCH_WORK
+  { "workq",  kbench_workq  },  /* work_queue() to worker latency */
+#endif
+#ifdef KBENCH_HAVE_PIPE
+  { KBENCH_PIPENAME("pipe"),   kbench_pipe,  /* Pipe throughput */
+    CONFIG_SIM_KBENCH_PIPEBLOCK },
+  { KBENCH_PIPENAME("pipe16"), kbench_pipe,  /* ... with small writes */
+    KBENCH_PIPESMALL },
+#endif
+#ifdef KBENCH_HAVE_FIFO
+  { KBENCH_PIPENAME("fifo"),   kbench_fifo,  /* FIFO throughput */
+    CONFIG_SIM_KBENCH_PIPEBLOCK },
+#endif
+#ifdef KBENCH_HAVE_POLL
+  { KBENCH_PIPENAME("poll"),   kbench_poll   },  /* poll() wakeup latency */
+#endif
+#ifdef KBENCH_HAVE_SPAWN
+  { "spawn",  kbench_spawn  },  /* task_spawn() with a file action */
+#endif
+  KBENCH_STRING("memcpy", kbench_memcpy),  /* libc string functions */
+  KBENCH_STRING("memset", kbench_memset),
+  KBENCH_STRING("memcmp", kbench_memcmp),
+  KBENCH_STRING("memchr", kbench_memchr),
+  KBENCH_STRING("strlen", kbench_strlen),
+  KBENCH_STRING("strchr", kbench_strchr),
+#ifdef KBENCH_HAVE_MATH
+  { "sinf",   kbench_sinf   },  /* Single precision math functions */
+  { "cosf",   kbench_cosf   },
+  { "expf",   kbench_expf   },
+  { "logf",   kbench_logf   },
+  { "powf",   kbench_powf   },
+  { "sqrtf",  kbench_sqrtf  },
+#endif
+};
+
+#define KBENCH_NTESTS (sizeof(g_kbench_tests) / sizeof(struct kbench_test_s))
+
+#ifdef KBENCH_HAVE_MATH
+static const struct kbench_math_s g_kbench_math[] =
+{
+  { "sinf",  sinf,  sin,  NULL, NULL, -100.0f, 100.0f, 0.0f, 0.0f },
+  { "cosf",  cosf,  cos,  NULL, NULL, -100.0f, 100.0f, 0.0f, 0.0f },
+  { "expf",  expf,  exp,  NULL, NULL, -80.0f,  80.0f,  0.0f, 0.0f },
+  { "logf",  logf,  log,  NULL, NULL, 0.001f,  1.0e6f, 0.0f, 0.0f },
+  { "powf",  NULL,  NULL, powf, pow,  0.01f,   100.0f, -8.0f, 8.0f },
+  { "sqrtf", sqrtf, sqrt, NULL, NULL, 0.0f,    1.0e6f, 0.0f, 0.0f },
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_begin and kbench_end
+ *
+ * Description:
+ *   Mark the start and the end of the timed part of a test.  The simulated
+ *   clock only advances while the IDLE loop runs, so the host time is used.
+ *
+ ****************************************************************************/
+
+static inline void kbench_begin(void)
+{
+  g_kbench.start = up_hostnsec();
+}
+
+static inline void kbench_end(void)
+{
+  g_kbench.end = up_hostnsec();
+}
+
+/****************************************************************************
+ * Name: kbench_random
+ *
+ * Description:
+ *   A small linear congruential generator.  The same sequence is used for
+ *   every run so that results are comparable.
+ *
+ ****************************************************************************/
+
+static uint32_t kbench_random(void)
+{
+  g_kbench.seed = g_kbench.seed * 1103515245 + 12345;
+  return g_kbench.seed >> 8;
+}
+
+/****************************************************************************
+ * Name: kbench_thread
+ *
+ * Description:
+ *   Start a peer thread with the given scheduling policy at the priority
+ *   of the benchmark.  If 'cpu' is not negative, the thread is bound to
+ *   that CPU.
+ *
+ ****************************************************************************/
+
+static int kbench_thread(FAR pthread_t *thread, pthread_startroutine_t entry,
+                         int policy, int cpu, FAR void *arg)
+{
+  struct sched_param param;
+  pthread_attr_t attr;
+  int ret;
+
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setstacksize(&attr, CONFIG_SIM_KBENCH_STACKSIZE);
+  (void)pthread_attr_setschedpolicy(&attr, policy);
+
+  param.sched_priority = CONFIG_SIM_KBENCH_PRIORITY;
+  (void)pthread_attr_setschedparam(&attr, &param);
+
+#ifdef CONFIG_SMP
+  if (cpu >= 0)
+    {
+      cpu_set_t cpuset;
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      (void)pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  ret = pthread_create(thread, &attr, entry, arg);
+  (void)pthread_attr_destroy(&attr);
+
+  if (ret != 0)
+    {
+      serr("ERROR: pthread_create failed: %d\n", ret);
+      return -ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_bind
+ *
+ * Description:
+ *   Bind the main thread to one CPU (cpu >= 0) or allow it to run on all
+ *   CPUs (cpu < 0).  Does nothing if SMP is not enabled.
+ *
+ ****************************************************************************/
+
+static void kbench_bind(int cpu)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+  int i;
+
+  CPU_ZERO(&cpuset);
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (cpu < 0 || cpu == i)
+        {
+          CPU_SET(i, &cpuset);
+        }
+    }
+
+  (void)sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
+#endif
+}
+
+/****************************************************************************
+ * Name: kbench_ctxsw
+ *
+ * Description:
+ *   Two threads of the same priority bound to the same CPU yield to each
+ *   other.  Each operation is one round trip, i.e. two context switches.
+ *
+ ****************************************************************************/
+
+static FAR void *kbench_yielder(FAR void *arg)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      (void)sched_yield();
+    }
+
+  return NULL;
+}
+
+static int kbench_ctxsw(void)
+{
+  pthread_t peer;
+  int ret;
+  int i;
+
+  kbench_bind(0);
+
+  ret = kbench_thread(&peer, kbench_yielder, SCHED_FIFO, 0, NULL);
+  if (ret < 0)
+    {
+      kbench_bind(-1);
+      return ret;
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      (void)sched_yield();
+    }
+
+  kbench_end();
+
+  (void)pthread_join(peer, NULL);
+  kbench_bind(-1);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_sem
+ *
+ * Description:
+ *   Post a semaphore to a peer thread and wait for the peer to post back.
+ *   Each operation is one round trip.
+ *
+ ****************************************************************************/
+
+static FAR void *kbench_sempeer(FAR void *arg)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      while (sem_wait(&g_kbench.ping) < 0);
+      (void)sem_post(&g_kbench.pong);
+    }
+
+  return NULL;
+}
+
+static int kbench_sem(void)
+{
+  pthread_t peer;
+  int ret;
+  int i;
+
+  ret = kbench_thread(&peer, kbench_sempeer, SCHED_FIFO, -1, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      (void)sem_post(&g_kbench.ping);
+      while (sem_wait(&g_kbench.pong) < 0);
+    }
+
+  kbench_end();
+
+  (void)pthread_join(peer, NULL);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_mutex
+ *
+ * Description:
+ *   CONFIG_SIM_KBENCH_NMUTEXTHREADS round-robin threads lock and unlock the
+ *   same mutex.  The threads are time-sliced so that the mutex is contended
+ *   even on a single CPU.  Each operation is one lock/unlock pair.
+ *
+ ****************************************************************************/
+
+static FAR void *kbench_locker(FAR void *arg)
+{
+  int nops = (int)((intptr_t)arg);
+  int i;
+
+  while (sem_wait(&g_kbench.go) < 0);
+
+  for (i = 0; i < nops; i++)
+    {
+      (void)pthread_mutex_lock(&g_kbench.mutex);
+      g_kbench.counter++;
+      (void)pthread_mutex_unlock(&g_kbench.mutex);
+    }
+
+  return NULL;
+}
+
+static int kbench_mutex(void)
+{
+  pthread_t peer[CONFIG_SIM_KBENCH_NMUTEXTHREADS];
+  int nops = CONFIG_SIM_KBENCH_NOPS / CONFIG_SIM_KBENCH_NMUTEXTHREADS;
+  int nthreads;
+  int ret = OK;
+  int i;
+
+  g_kbench.counter = 0;
+
+  for (nthreads = 0; nthreads < CONFIG_SIM_KBENCH_NMUTEXTHREADS; nthreads++)
+    {
+      ret = kbench_thread(&peer[nthreads], kbench_locker, SCHED_RR, -1,
+                          (FAR void *)((intptr_t)nops));
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < nthreads; i++)
+    {
+      (void)sem_post(&g_kbench.go);
+    }
+
+  for (i = 0; i < nthreads; i++)
+    {
+      (void)pthread_join(peer[i], NULL);
+    }
+
+  kbench_end();
+
+  if (ret == OK && g_kbench.counter != (uint32_t)nops * nthreads)
+    {
+      serr("ERROR: Lost %lu increments\n",
+           (unsigned long)((uint32_t)nops * nthreads - g_kbench.counter));
+      ret = -EIO;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_mqueue
+ *
+ * Description:
+ *   Send a message to a peer thread and wait for the peer to send it back.
+ *   Each operation is one round trip.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static FAR void *kbench_mqpeer(FAR void *arg)
+{
+  char msg[KBENCH_MSGSIZE];
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      if (mq_receive(g_kbench.mqping, msg, KBENCH_MSGSIZE, NULL) < 0 ||
+          mq_send(g_kbench.mqpong, msg, KBENCH_MSGSIZE, 0) < 0)
+        {
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+static int kbench_mqueue(void)
+{
+  char msg[KBENCH_MSGSIZE];
+  struct mq_attr attr;
+  pthread_t peer;
+  int ret = OK;
+  int i;
+
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = KBENCH_MSGSIZE;
+  attr.mq_flags   = 0;
+
+  g_kbench.mqping = mq_open("kbping", O_RDWR | O_CREAT, 0666, &attr);
+  g_kbench.mqpong = mq_open("kbpong", O_RDWR | O_CREAT, 0666, &attr);
+  if (g_kbench.mqping == (mqd_t)-1 || g_kbench.mqpong == (mqd_t)-1)
+    {
+      serr("ERROR: mq_open failed: %d\n", errno);
+      ret = -errno;
+      goto errout;
+    }
+
+  ret = kbench_thread(&peer, kbench_mqpeer, SCHED_FIFO, -1, NULL);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  memset(msg, 0, KBENCH_MSGSIZE);
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      if (mq_send(g_kbench.mqping, msg, KBENCH_MSGSIZE, 0) < 0 ||
+          mq_receive(g_kbench.mqpong, msg, KBENCH_MSGSIZE, NULL) < 0)
+        {
+          serr("ERROR: Message %d failed: %d\n", i, errno);
+          ret = -errno;
+          break;
+        }
+    }
+
+  kbench_end();
+
+  if (ret < 0)
+    {
+      (void)pthread_cancel(peer);
+    }
+
+  (void)pthread_join(peer, NULL);
+
+errout:
+  if (g_kbench.mqping != (mqd_t)-1)
+    {
+      (void)mq_close(g_kbench.mqping);
+    }
+
+  if (g_kbench.mqpong != (mqd_t)-1)
+    {
+      (void)mq_close(g_kbench.mqpong);
+    }
+
+  (void)mq_unlink("kbping");
+  (void)mq_unlink("kbpong");
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_signal
+ *
+ * Description:
+ *   Send SIGUSR1 to a peer thread waiting in sigwaitinfo() and wait for the
+ *   peer to acknowledge it.  Each operation is one signal round trip.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_SIGNALS
+static FAR void *kbench_sigpeer(FAR void *arg)
+{
+  sigset_t set;
+  int i;
+
+  (void)sigemptyset(&set);
+  (void)sigaddset(&set, SIGUSR1);
+  (void)pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  /* Tell the main thread that the signal is now blocked */
+
+  (void)sem_post(&g_kbench.pong);
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      while (sigwaitinfo(&set, NULL) < 0);
+      (void)sem_post(&g_kbench.pong);
+    }
+
+  return NULL;
+}
+
+static int kbench_signal(void)
+{
+  pthread_t peer;
+  int ret;
+  int i;
+
+  ret = kbench_thread(&peer, kbench_sigpeer, SCHED_FIFO, -1, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (sem_wait(&g_kbench.pong) < 0);
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      (void)pthread_kill(peer, SIGUSR1);
+      while (sem_wait(&g_kbench.pong) < 0);
+    }
+
+  kbench_end();
+
+  (void)pthread_join(peer, NULL);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_malloc
+ *
+ * Description:
+ *   Replace one of CONFIG_SIM_KBENCH_NLIVE live allocations with a new one.
+ *   Half of the sizes are 8-64 bytes, a third are 64-512 bytes and the rest
+ *   are 512-4096 bytes.  Each operation is one free() and one malloc().
+ *
+ ****************************************************************************/
+
+static size_t kbench_mallocsize(void)
+{
+  uint32_t r = kbench_random();
+
+  switch (r % 6)
+    {
+      case 0:
+      case 1:
+      case 2:
+        return 8 + (r >> 3) % 56;
+
+      case 3:
+      case 4:
+        return 64 + (r >> 3) % 448;
+
+      default:
+        return 512 + (r >> 3) % 3584;
+    }
+}
+
+static int kbench_malloc(void)
+{
+  FAR uint8_t *mem;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NLIVE; i++)
+    {
+      g_kbench.live[i] = malloc(kbench_mallocsize());
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      FAR void **slot = &g_kbench.live[kbench_random() %
+                                       CONFIG_SIM_KBENCH_NLIVE];
+
+      free(*slot);
+      mem = (FAR uint8_t *)malloc(kbench_mallocsize());
+      if (mem == NULL)
+        {
+          serr("ERROR: malloc failed at operation %d\n", i);
+          ret = -ENOMEM;
+        }
+      else
+        {
+          *mem = (uint8_t)i;
+        }
+
+      *slot = mem;
+    }
+
+  kbench_end();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NLIVE; i++)
+    {
+      free(g_kbench.live[i]);
+      g_kbench.live[i] = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_realloc
+ *
+ * Description:
+ *   Grow one of CONFIG_SIM_KBENCH_NLIVE buffers by 16-271 bytes, the way
+ *   a log or an HTTP body is appended to.  A buffer that would exceed
+ *   KBENCH_STRMAX bytes is freed and starts again from 16 bytes.  Each
+ *   operation is one realloc().  With CONFIG_MM_PROFILE, the number of
+ *   reallocations that grew a chunk, moved or copied the data and the
+ *   bytes moved or copied are printed as a comment.
+ *
+ ****************************************************************************/
+
+static int kbench_realloc(void)
+{
+#ifdef CONFIG_MM_PROFILE
+  unsigned long grown  = g_mmheap.mm_realloc_grown;
+  unsigned long moved  = g_mmheap.mm_realloc_moved;
+  unsigned long copied = g_mmheap.mm_realloc_copied;
+  unsigned long bytes  = g_mmheap.mm_realloc_bytes;
+#endif
+  FAR uint8_t *mem;
+  size_t size;
+  int ret = OK;
+  int slot;
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NLIVE; i++)
+    {
+      g_kbench.live[i]     = NULL;
+      g_kbench.livesize[i] = 0;
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      slot = kbench_random() % CONFIG_SIM_KBENCH_NLIVE;
+      size = g_kbench.livesize[slot] + 16 + kbench_random() % 256;
+      if (size > KBENCH_STRMAX)
+        {
+          free(g_kbench.live[slot]);
+          g_kbench.live[slot]     = NULL;
+          g_kbench.livesize[slot] = 0;
+          size = 16;
+        }
+
+      mem = (FAR uint8_t *)realloc(g_kbench.live[slot], size);
+      if (mem == NULL)
+        {
+          serr("ERROR: realloc failed at operation %d\n", i);
+          ret = -ENOMEM;
+        }
+      else
+        {
+          mem[size - 1] = (uint8_t)i;
+          g_kbench.live[slot]     = mem;
+          g_kbench.livesize[slot] = size;
+        }
+    }
+
+  kbench_end();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NLIVE; i++)
+    {
+      free(g_kbench.live[i]);
+      g_kbench.live[i] = NULL;
+    }
+
+#ifdef CONFIG_MM_PROFILE
+  printf("# realloc: grown %lu moved %lu copied %lu bytes %lu\n",
+         g_mmheap.mm_realloc_grown - grown,
+         g_mmheap.mm_realloc_moved - moved,
+         g_mmheap.mm_realloc_copied - copied,
+         g_mmheap.mm_realloc_bytes - bytes);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_wdog
+ *
+ * Description:
+ *   Start a watchdog timer and cancel it before it expires.  Each
+ *   operation is one wd_start() and one wd_cancel().
+ *
+ ****************************************************************************/
+
+static void kbench_wdentry(int argc, wdparm_t arg1, ...)
+{
+}
+
+static int kbench_wdog(void)
+{
+  WDOG_ID wdog;
+  int ret = OK;
+  int i;
+
+  wdog = wd_create();
+  if (wdog == NULL)
+    {
+      serr("ERROR: wd_create failed\n");
+      return -ENOMEM;
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      /* Vary the delay so that the timer list is really searched */
+
+      ret = wd_start(wdog, 1000 + (i & 63), kbench_wdentry, 0);
+      if (ret < 0)
+        {
+          serr("ERROR: wd_start failed: %d\n", ret);
+          break;
+        }
+
+      (void)wd_cancel(wdog);
+    }
+
+  kbench_end();
+
+  (void)wd_delete(wdog);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_workq
+ *
+ * Description:
+ *   Queue work with no delay and wait until the worker has run.  Each
+ *   operation is the latency from work_queue() to the wakeup of the main
+ *   thread by the worker.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_WORK
+static void kbench_worker(FAR void *arg)
+{
+  (void)sem_post(&g_kbench.pong);
+}
+
+static int kbench_workq(void)
+{
+  int ret = OK;
+  int i;
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      ret = work_queue(KBENCH_WORK, &g_kbench.work, kbench_worker, NULL, 0);
+      if (ret < 0)
+        {
+          serr("ERROR: work_queue failed: %d\n", ret);
+          break;
+        }
+
+      while (sem_wait(&g_kbench.pong) < 0);
+    }
+
+  kbench_end();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_pipe and kbench_fifo
+ *
+ * Description:
+ *   Write blocks of the test's size to a pipe or FIFO that is drained by a
+ *   peer thread.  Each operation is one block.  There is exactly one
+ *   reader and one writer, so these tests also run with
+ *   CONFIG_DEV_PIPE_SPSC.  The small blocks of the pipe16 test show the
+ *   per-transfer cost rather than the copy.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_PIPE
+static FAR void *kbench_pipereader(FAR void *arg)
+{
+  uint8_t buffer[KBENCH_PIPEMAX];
+  ssize_t nread;
+
+  /* Read until the write end is closed */
+
+  do
+    {
+      nread = read(g_kbench.fd[0], buffer, g_kbench.size);
+    }
+  while (nread > 0 || (nread < 0 && errno == EINTR));
+
+  return NULL;
+}
+
+static int kbench_pipexfer(void)
+{
+  uint8_t buffer[KBENCH_PIPEMAX];
+  pthread_t peer;
+  ssize_t nwritten;
+  int ret;
+  int i;
+
+  ret = kbench_thread(&peer, kbench_pipereader, SCHED_FIFO, -1, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(buffer, 0xa5, g_kbench.size);
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      nwritten = write(g_kbench.fd[1], buffer, g_kbench.size);
+      if (nwritten < 0)
+        {
+          serr("ERROR: write failed: %d\n", errno);
+          ret = -errno;
+          break;
+        }
+
+      g_kbench.nbytes += nwritten;
+    }
+
+  /* Closing the write end ends the reader once the pipe is empty */
+
+  (void)close(g_kbench.fd[1]);
+  g_kbench.fd[1] = -1;
+
+  (void)pthread_join(peer, NULL);
+  kbench_end();
+  return ret;
+}
+
+static int kbench_pipe(void)
+{
+  int ret;
+
+  ret = pipe(g_kbench.fd);
+  if (ret < 0)
+    {
+      serr("ERROR: pipe failed: %d\n", errno);
+      return -errno;
+    }
+
+  ret = kbench_pipexfer();
+
+  if (g_kbench.fd[1] >= 0)
+    {
+      (void)close(g_kbench.fd[1]);
+    }
+
+  (void)close(g_kbench.fd[0]);
+  return ret;
+}
+#endif
+
+#ifdef KBENCH_HAVE_FIFO
+static int kbench_fifo(void)
+{
+  int ret;
+
+  ret = mkfifo(KBENCH_FIFOPATH, 0666);
+  if (ret < 0 && errno != EEXIST)
+    {
+      serr("ERROR: mkfifo failed: %d\n", errno);
+      return -errno;
+    }
+
+  /* Open the write end first.  A read-only open does not return before
+   * there is a writer.
+   */
+
+  g_kbench.fd[0] = -1;
+  g_kbench.fd[1] = open(KBENCH_FIFOPATH, O_WRONLY);
+  if (g_kbench.fd[1] >= 0)
+    {
+      g_kbench.fd[0] = open(KBENCH_FIFOPATH, O_RDONLY);
+    }
+
+  if (g_kbench.fd[0] < 0)
+    {
+      serr("ERROR: open failed: %d\n", errno);
+      ret = -errno;
+    }
+  else
+    {
+      ret = kbench_pipexfer();
+      (void)close(g_kbench.fd[0]);
+    }
+
+  if (g_kbench.fd[1] >= 0)
+    {
+      (void)close(g_kbench.fd[1]);
+    }
+
+  (void)unlink(KBENCH_FIFOPATH);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_poll
+ *
+ * Description:
+ *   Write one byte to a pipe that a peer thread waits on in poll().  The
+ *   peer reads the byte and posts a semaphore.  Each operation is one
+ *   poll() wakeup round trip.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_POLL
+static FAR void *kbench_pollpeer(FAR void *arg)
+{
+  struct pollfd fds;
+  uint8_t ch;
+  int i;
+
+  fds.fd     = g_kbench.fd[0];
+  fds.events = POLLIN;
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      fds.revents = 0;
+      if (poll(&fds, 1, -1) < 0 && errno != EINTR)
+        {
+          break;
+        }
+
+      if ((fds.revents & POLLIN) != 0)
+        {
+          if (read(g_kbench.fd[0], &ch, 1) < 1)
+            {
+              break;
+            }
+
+          (void)sem_post(&g_kbench.pong);
+        }
+      else
+        {
+          i--;
+        }
+    }
+
+  return NULL;
+}
+
+static int kbench_poll(void)
+{
+  pthread_t peer;
+  uint8_t ch = 0;
+  int ret;
+  int i;
+
+  ret = pipe(g_kbench.fd);
+  if (ret < 0)
+    {
+      serr("ERROR: pipe failed: %d\n", errno);
+      return -errno;
+    }
+
+  ret = kbench_thread(&peer, kbench_pollpeer, SCHED_FIFO, -1, NULL);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      if (write(g_kbench.fd[1], &ch, 1) < 1)
+        {
+          serr("ERROR: write failed: %d\n", errno);
+          ret = -errno;
+          break;
+        }
+
+      while (sem_wait(&g_kbench.pong) < 0);
+    }
+
+  kbench_end();
+
+  if (ret < 0)
+    {
+      (void)pthread_cancel(peer);
+    }
+
+  (void)pthread_join(peer, NULL);
+
+errout:
+  (void)close(g_kbench.fd[1]);
+  (void)close(g_kbench.fd[0]);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_spawn
+ *
+ * Description:
+ *   Start a short-lived task with task_spawn(), passing it an argument
+ *   list and one file action, and wait until the task has run.  The task
+ *   has a higher priority than the benchmark so it also exits before the
+ *   next operation.  Each operation is the latency of one spawn, including
+ *   the copy of argv[] and of the environment and the file action.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_SPAWN
+static int kbench_spawnchild(int argc, FAR char *argv[])
+{
+  (void)sem_post(&g_kbench.pong);
+  return 0;
+}
+
+static int kbench_spawn(void)
+{
+  static FAR char * const argv[] =
+  {
+    "-a", "first-argument", "-b", "second-argument", NULL
+  };
+
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  struct sched_param param;
+  pid_t pid;
+  int ret;
+  int i;
+
+  /* The file action makes the child's stderr a copy of its stdout.  This
+   * exercises the file action path of task_spawn().
+   */
+
+  ret = posix_spawn_file_actions_init(&actions);
+  if (ret == 0)
+    {
+      ret = posix_spawn_file_actions_adddup2(&actions, 1, 2);
+    }
+
+  if (ret != 0)
+    {
+      serr("ERROR: Failed to set up file actions: %d\n", ret);
+      return -ret;
+    }
+
+  memset(&param, 0, sizeof(struct sched_param));
+  param.sched_priority = CONFIG_SIM_KBENCH_PRIORITY + 1;
+
+  (void)posix_spawnattr_init(&attr);
+  (void)posix_spawnattr_setschedparam(&attr, &param);
+  (void)task_spawnattr_setstacksize(&attr, CONFIG_SIM_KBENCH_STACKSIZE);
+
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      ret = task_spawn(&pid, "kbench_spawn", kbench_spawnchild, &actions,
+                       &attr, argv, NULL);
+      if (ret != 0)
+        {
+          serr("ERROR: task_spawn failed: %d\n", ret);
+          ret = -ret;
+          break;
+        }
+
+      while (sem_wait(&g_kbench.pong) < 0);
+    }
+
+  kbench_end();
+
+  (void)posix_spawnattr_destroy(&attr);
+  (void)posix_spawn_file_actions_destroy(&actions);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_memcpy, kbench_memset, kbench_memcmp, kbench_memchr,
+ *       kbench_strlen and kbench_strchr
+ *
+ * Description:
+ *   Call a libc string function on aligned buffers of the test's size.
+ *   Each operation is one call and the throughput is the number of bytes
+ *   processed.  The searches only find their target in the last byte and
+ *   the comparison only sees equal bytes, so every byte is examined.  The
+ *   results are checked after the timed part.
+ *
+ ****************************************************************************/
+
+static void kbench_strfill(void)
+{
+  size_t i;
+
+  /* 'size' non-zero bytes ending with the '#' that the searches look for,
+   * then a NUL terminator.
+   */
+
+  for (i = 0; i < g_kbench.size; i++)
+    {
+      g_kbench.src[i] = (char)('a' + i % 26);
+    }
+
+  g_kbench.src[g_kbench.size - 1] = '#';
+  g_kbench.src[g_kbench.size]     = '\0';
+  memcpy(g_kbench.dest, g_kbench.src, g_kbench.size + 1);
+}
+
+static int kbench_strend(bool ok)
+{
+  kbench_end();
+  g_kbench.nbytes = (uint64_t)CONFIG_SIM_KBENCH_NOPS * g_kbench.size;
+
+  if (!ok)
+    {
+      serr("ERROR: Wrong result\n");
+      return -EIO;
+    }
+
+  return OK;
+}
+
+static int kbench_memcpy(void)
+{
+  int i;
+
+  kbench_strfill();
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      memcpy(g_kbench.dest, g_kbench.src, g_kbench.size);
+    }
+
+  return kbench_strend(memcmp(g_kbench.dest, g_kbench.src,
+                              g_kbench.size) == 0);
+}
+
+static int kbench_memset(void)
+{
+  int i;
+
+  kbench_strfill();
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      memset(g_kbench.dest, i, g_kbench.size);
+    }
+
+  return kbench_strend(g_kbench.dest[g_kbench.size - 1] == (char)(i - 1));
+}
+
+static int kbench_memcmp(void)
+{
+  int result = 0;
+  int i;
+
+  kbench_strfill();
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      result |= memcmp(g_kbench.dest, g_kbench.src, g_kbench.size);
+    }
+
+  return kbench_strend(result == 0);
+}
+
+static int kbench_memchr(void)
+{
+  FAR void *result = NULL;
+  int i;
+
+  kbench_strfill();
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      result = memchr(g_kbench.src, '#', g_kbench.size);
+    }
+
+  return kbench_strend(result == &g_kbench.src[g_kbench.size - 1]);
+}
+
+static int kbench_strlen(void)
+{
+  size_t result = 0;
+  int i;
+
+  kbench_strfill();
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      result = strlen(g_kbench.src);
+    }
+
+  return kbench_strend(result == g_kbench.size);
+}
+
+static int kbench_strchr(void)
+{
+  FAR char *result = NULL;
+  int i;
+
+  kbench_strfill();
+  kbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      result = strchr(g_kbench.src, '#');
+    }
+
+  return kbench_strend(result == &g_kbench.src[g_kbench.size - 1]);
+}
+
+/****************************************************************************
+ * Name: kbench_sinf, kbench_cosf, kbench_expf, kbench_logf, kbench_powf
+ *       and kbench_sqrtf
+ *
+ * Description:
+ *   Call a single precision math function with KBENCH_NMATH different
+ *   arguments in turn.  Each operation is one call.  After the timed part,
+ *   the function is called with CONFIG_SIM_KBENCH_NOPS new arguments and
+ *   the largest error in units in the last place (ulp) of the result,
+ *   relative to the double precision function, is printed as a comment.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_HAVE_MATH
+static float kbench_mathin(float lo, float hi)
+{
+  return lo + (hi - lo) * ((float)(kbench_random() & 0xffffff) /
+                           16777216.0f);
+}
+
+static int kbench_math(FAR const struct kbench_math_s *m)
+{
+  volatile float result;
+  double maxerr = 0.0;
+  double ref;
+  double err;
+  float x;
+  float y;
+  int exp;
+  int i;
+
+  for (i = 0; i < KBENCH_NMATH; i++)
+    {
+      g_kbench.x[i] = kbench_mathin(m->xlo, m->xhi);
+      g_kbench.y[i] = kbench_mathin(m->ylo, m->yhi);
+    }
+
+  kbench_begin();
+
+  if (m->f != NULL)
+    {
+      for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+        {
+          result = m->f(g_kbench.x[i & (KBENCH_NMATH - 1)]);
+        }
+    }
+  else
+    {
+      for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+        {
+          result = m->f2(g_kbench.x[i & (KBENCH_NMATH - 1)],
+                         g_kbench.y[i & (KBENCH_NMATH - 1)]);
+        }
+    }
+
+  kbench_end();
+
+  /* Measure the accuracy.  A float has a 24 bit significand so, for a
+   * result in [2^(exp-1), 2^exp), one ulp is 2^(exp-24).
+   */
+
+  for (i = 0; i < CONFIG_SIM_KBENCH_NOPS; i++)
+    {
+      x = kbench_mathin(m->xlo, m->xhi);
+      y = kbench_mathin(m->ylo, m->yhi);
+
+      if (m->f != NULL)
+        {
+          result = m->f(x);
+          ref    = m->ref(x);
+        }
+      else
+        {
+          result = m->f2(x, y);
+          ref    = m->ref2(x, y);
+        }
+
+      if (ref == 0.0)
+        {
+          continue;
+        }
+
+      (void)frexp(ref, &exp);
+      err = fabs((double)result - ref) / ldexp(1.0, exp - 24);
+      if (err > maxerr)
+        {
+          maxerr = err;
+        }
+    }
+
+  printf("# %s: max error %lu.%02lu ulp\n", m->name,
+         (unsigned long)maxerr,
+         (unsigned long)((maxerr - floor(maxerr)) * 100.0));
+  return OK;
+}
+
+static int kbench_sinf(void)
+{
+  return kbench_math(&g_kbench_math[0]);
+}
+
+static int kbench_cosf(void)
+{
+  return kbench_math(&g_kbench_math[1]);
+}
+
+static int kbench_expf(void)
+{
+  return kbench_math(&g_kbench_math[2]);
+}
+
+static int kbench_logf(void)
+{
+  return kbench_math(&g_kbench_math[3]);
+}
+
+static int kbench_powf(void)
+{
+  return kbench_math(&g_kbench_math[4]);
+}
+
+static int kbench_sqrtf(void)
+{
+  return kbench_math(&g_kbench_math[5]);
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_run
+ *
+ * Description:
+ *   Run one test and print one line of comma separated results:
+ *
+ *     kbench,<test>,<ncpus>,<ops>,<usec>,<nsec/op>,<bytes/sec>
+ *
+ *   <bytes/sec> is zero for tests that do not move data.
+ *
+ ****************************************************************************/
+
+static int kbench_run(FAR const struct kbench_test_s *test)
+{
+  uint64_t nsec;
+  uint64_t usec;
+  int ret;
+
+  g_kbench.seed   = 1;
+  g_kbench.nbytes = 0;
+  g_kbench.size   = test->size;
+
+  ret = test->run();
+  if (ret < 0)
+    {
+      printf("# %s failed: %d\n", test->name, ret);
+      return ret;
+    }
+
+  nsec = g_kbench.end - g_kbench.start;
+  usec = nsec / 1000;
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+  printf("kbench,%s,%d,%d,%lu,%lu,%lu\n",
+         test->name, CONFIG_SMP_NCPUS, CONFIG_SIM_KBENCH_NOPS,
+         (unsigned long)usec,
+         (unsigned long)(nsec / CONFIG_SIM_KBENCH_NOPS),
+         (unsigned long)(g_kbench.nbytes * 1000000 / usec));
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_main
+ *
+ * Description:
+ *   kbench_main is a microbenchmark of the kernel primitives.  Each test
+ *   performs CONFIG_SIM_KBENCH_NOPS operations and prints one line of comma
+ *   separated results (see kbench_run()).  An optional argument selects a
+ *   single test by name.  Run it in the kbench and the kbenchsmp
+ *   configurations to compare the single CPU and the SMP kernels.
+ *
+ ****************************************************************************/
+
+int kbench_main(int argc, char *argv[])
+{
+  struct sched_param param;
+  int errcount = 0;
+  int i;
+
+  /* All threads of the benchmark run at the same priority */
+
+  param.sched_priority = CONFIG_SIM_KBENCH_PRIORITY;
+  (void)sched_setscheduler(0, SCHED_FIFO, &param);
+
+  sem_init(&g_kbench.ping, 0, 0);
+  sem_init(&g_kbench.pong, 0, 0);
+  sem_init(&g_kbench.go, 0, 0);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* These are signaling semaphores */
+
+  sem_setprotocol(&g_kbench.ping, SEM_PRIO_NONE);
+  sem_setprotocol(&g_kbench.pong, SEM_PRIO_NONE);
+  sem_setprotocol(&g_kbench.go, SEM_PRIO_NONE);
+#endif
+
+  pthread_mutex_init(&g_kbench.mutex, NULL);
+
+  printf("# kbench,test,ncpus,ops,usec,nsec/op,bytes/sec\n");
+
+  for (i = 0; i < KBENCH_NTESTS; i++)
+    {
+      if (argc > 1 && strcmp(argv[1], g_kbench_tests[i].name) != 0)
+        {
+          continue;
+        }
+
+      if (kbench_run(&g_kbench_tests[i]) < 0)
+        {
+          errcount++;
+        }
+    }
+
+  pthread_mutex_destroy(&g_kbench.mutex);
+  sem_destroy(&g_kbench.go);
+  sem_destroy(&g_kbench.pong);
+  sem_destroy(&g_kbench.ping);
+
+  return errcount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
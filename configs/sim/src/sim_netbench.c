@@ -0,0 +1,1000 @@
+/****************************************************************************
+ * configs/sim/src/sim_netbench.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/net/net.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SIM_NETBENCH_PORT
+#  define CONFIG_SIM_NETBENCH_PORT 5001
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_NBYTES
+#  define CONFIG_SIM_NETBENCH_NBYTES (1024 * 1024)
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_BLOCKSIZE
+#  define CONFIG_SIM_NETBENCH_BLOCKSIZE 1024
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_UDPSIZE
+#  define CONFIG_SIM_NETBENCH_UDPSIZE 256
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_NROUNDS
+#  define CONFIG_SIM_NETBENCH_NROUNDS 1000
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_RRSIZE
+#  define CONFIG_SIM_NETBENCH_RRSIZE 64
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_NCONNECTS
+#  define CONFIG_SIM_NETBENCH_NCONNECTS 100
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_NCONNS
+#  define CONFIG_SIM_NETBENCH_NCONNS 8
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_CHKSUMSIZE
+#  define CONFIG_SIM_NETBENCH_CHKSUMSIZE 1460
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_NCHKSUMS
+#  define CONFIG_SIM_NETBENCH_NCHKSUMS 10000
+#endif
+
+#ifndef CONFIG_SIM_NETBENCH_STACKSIZE
+#  define CONFIG_SIM_NETBENCH_STACKSIZE 2048
+#endif
+
+/* The discard service is on the base port, the echo service on the next */
+
+#define NETBENCH_DISCARD   CONFIG_SIM_NETBENCH_PORT
+#define NETBENCH_ECHO      (CONFIG_SIM_NETBENCH_PORT + 1)
+
+/* The largest buffer used by any test or service */
+
+#if CONFIG_SIM_NETBENCH_BLOCKSIZE > CONFIG_SIM_NETBENCH_UDPSIZE
+#  define NETBENCH_BUFSIZE CONFIG_SIM_NETBENCH_BLOCKSIZE
+#else
+#  define NETBENCH_BUFSIZE CONFIG_SIM_NETBENCH_UDPSIZE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct netbench_s
+{
+  struct sockaddr_in server;         /* Address of the discard/echo server */
+  uint64_t start;                    /* Host time at start of timed section */
+  uint64_t end;                      /* Host time at end of timed section */
+  uint64_t nbytes;                   /* Bytes moved by the timed section */
+  int nops;                          /* Operations of the timed section */
+  volatile uint32_t udprecvd;        /* Datagrams seen by the UDP discard */
+  uint8_t buffer[NETBENCH_BUFSIZE];  /* Client data buffer */
+  uint16_t chkbuf[(CONFIG_SIM_NETBENCH_CHKSUMSIZE + 3) / 2]; /* Summed */
+};
+
+/* Describes one test.  run() performs the test and brackets the timed part
+ * with netbench_begin() and netbench_end().
+ */
+
+struct netbench_test_s
+{
+  FAR const char *name;
+  CODE int (*run)(void);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int netbench_tcpstream(void);
+static int netbench_tcprr(void);
+static int netbench_tcpcrr(void);
+static int netbench_tcpmany(void);
+static int netbench_udpstream(void);
+static int netbench_udprr(void);
+static int netbench_chksum(void);
+static int netbench_chksumodd(void);
+
+/* net_chksum() is internal to the network stack (net/utils/utils.h) */
+
+uint16_t net_chksum(FAR uint16_t *data, uint16_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct netbench_s g_netbench;
+
+static const struct netbench_test_s g_netbench_tests[] =
+{
+  { "tcp_stream", netbench_tcpstream },  /* Bulk TCP to the discard port */
+  { "tcp_rr",     netbench_tcprr     },  /* TCP request/response */
+  { "tcp_crr",    netbench_tcpcrr    },  /* TCP connect/request/close */
+  { "tcp_many",   netbench_tcpmany   },  /* Request/response on many conns */
+  { "udp_stream", netbench_udpstream },  /* Bulk UDP to the discard port */
+  { "udp_rr",     netbench_udprr     },  /* UDP request/response */
+  { "chksum",     netbench_chksum    },  /* Checksum of aligned data */
+  { "chksum_odd", netbench_chksumodd },  /* Checksum of odd-aligned data */
+};
+
+#define NETBENCH_NTESTS \
+  (sizeof(g_netbench_tests) / sizeof(struct netbench_test_s))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_begin and netbench_end
+ *
+ * Description:
+ *   Mark the start and the end of the timed part of a test.  The simulated
+ *   clock only advances while the IDLE loop runs, so the host time is used.
+ *   The network lock statistics are reset at the start.
+ *
+ ****************************************************************************/
+
+static void netbench_begin(void)
+{
+#ifdef CONFIG_NET_LOCK_STATS
+  net_lockstats(NULL, true);
+#endif
+  g_netbench.start = up_hostnsec();
+}
+
+static void netbench_end(int nops)
+{
+  g_netbench.end  = up_hostnsec();
+  g_netbench.nops = nops;
+}
+
+/****************************************************************************
+ * Name: netbench_thread
+ *
+ * Description:
+ *   Start a detached service thread.
+ *
+ ****************************************************************************/
+
+static int netbench_thread(pthread_startroutine_t entry, FAR void *arg)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int ret;
+
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setstacksize(&attr, CONFIG_SIM_NETBENCH_STACKSIZE);
+
+  ret = pthread_create(&thread, &attr, entry, arg);
+  (void)pthread_attr_destroy(&attr);
+
+  if (ret != 0)
+    {
+      nerr("ERROR: pthread_create failed: %d\n", ret);
+      return -ret;
+    }
+
+  (void)pthread_detach(thread);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_sendall and netbench_recvall
+ *
+ * Description:
+ *   Send or receive exactly 'len' bytes on a stream socket.
+ *
+ ****************************************************************************/
+
+static int netbench_sendall(int sd, FAR const uint8_t *buf, size_t len)
+{
+  ssize_t nsent;
+
+  while (len > 0)
+    {
+      nsent = send(sd, buf, len, 0);
+      if (nsent < 0)
+        {
+          return -errno;
+        }
+
+      buf += nsent;
+      len -= nsent;
+    }
+
+  return OK;
+}
+
+static int netbench_recvall(int sd, FAR uint8_t *buf, size_t len)
+{
+  ssize_t nrecvd;
+
+  while (len > 0)
+    {
+      nrecvd = recv(sd, buf, len, 0);
+      if (nrecvd <= 0)
+        {
+          return nrecvd < 0 ? -errno : -ECONNRESET;
+        }
+
+      buf += nrecvd;
+      len -= nrecvd;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_socket
+ *
+ * Description:
+ *   Create a socket bound to 'port' on all local addresses (port != 0) or
+ *   connected to 'port' of the server (stream sockets).
+ *
+ ****************************************************************************/
+
+static int netbench_socket(int type, int port, bool server)
+{
+  struct sockaddr_in addr;
+  int optval;
+  int sd;
+  int ret;
+
+  sd = socket(PF_INET, type, 0);
+  if (sd < 0)
+    {
+      nerr("ERROR: socket failed: %d\n", errno);
+      return -errno;
+    }
+
+  if (server)
+    {
+      optval = 1;
+      (void)setsockopt(sd, SOL_SOCKET, SO_REUSEADDR, &optval,
+                       sizeof(int));
+
+      addr.sin_family      = AF_INET;
+      addr.sin_port        = htons(port);
+      addr.sin_addr.s_addr = INADDR_ANY;
+
+      ret = bind(sd, (FAR struct sockaddr *)&addr,
+                 sizeof(struct sockaddr_in));
+    }
+  else
+    {
+      memcpy(&addr, &g_netbench.server, sizeof(struct sockaddr_in));
+      addr.sin_port = htons(port);
+
+      ret = connect(sd, (FAR struct sockaddr *)&addr,
+                    sizeof(struct sockaddr_in));
+    }
+
+  if (ret < 0)
+    {
+      ret = -errno;
+      nerr("ERROR: %s to port %d failed: %d\n",
+           server ? "bind" : "connect", port, ret);
+      close(sd);
+      return ret;
+    }
+
+  return sd;
+}
+
+/****************************************************************************
+ * Name: netbench_tcpconn
+ *
+ * Description:
+ *   Serve one TCP connection.  Data is echoed if 'arg' has bit 16 set and
+ *   discarded otherwise.  The low bits of 'arg' are the socket.
+ *
+ ****************************************************************************/
+
+static FAR void *netbench_tcpconn(FAR void *arg)
+{
+  uint8_t buffer[NETBENCH_BUFSIZE];
+  int sd    = (int)((intptr_t)arg & 0xffff);
+  bool echo = ((intptr_t)arg & 0x10000) != 0;
+  ssize_t nrecvd;
+
+  for (; ; )
+    {
+      nrecvd = recv(sd, buffer, NETBENCH_BUFSIZE, 0);
+      if (nrecvd <= 0)
+        {
+          break;
+        }
+
+      if (echo && netbench_sendall(sd, buffer, nrecvd) < 0)
+        {
+          break;
+        }
+    }
+
+  close(sd);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_tcpserver
+ *
+ * Description:
+ *   Accept connections to the TCP discard or echo port and start a thread
+ *   for each of them.
+ *
+ ****************************************************************************/
+
+static FAR void *netbench_tcpserver(FAR void *arg)
+{
+  int port = (int)((intptr_t)arg);
+  int listensd;
+  int sd;
+
+  listensd = netbench_socket(SOCK_STREAM, port, true);
+  if (listensd < 0)
+    {
+      return NULL;
+    }
+
+  if (listen(listensd, CONFIG_SIM_NETBENCH_NCONNS) < 0)
+    {
+      nerr("ERROR: listen failed: %d\n", errno);
+      close(listensd);
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      sd = accept(listensd, NULL, NULL);
+      if (sd < 0)
+        {
+          continue;
+        }
+
+      if (netbench_thread(netbench_tcpconn,
+                          (FAR void *)((intptr_t)sd |
+                                       (port == NETBENCH_ECHO ?
+                                        0x10000 : 0))) < 0)
+        {
+          close(sd);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_udpserver
+ *
+ * Description:
+ *   Count the datagrams received on the UDP discard port or return the
+ *   datagrams received on the UDP echo port to their sender.
+ *
+ ****************************************************************************/
+
+static FAR void *netbench_udpserver(FAR void *arg)
+{
+  uint8_t buffer[NETBENCH_BUFSIZE];
+  struct sockaddr_in from;
+  socklen_t fromlen;
+  int port = (int)((intptr_t)arg);
+  ssize_t nrecvd;
+  int sd;
+
+  sd = netbench_socket(SOCK_DGRAM, port, true);
+  if (sd < 0)
+    {
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      fromlen = sizeof(struct sockaddr_in);
+      nrecvd  = recvfrom(sd, buffer, NETBENCH_BUFSIZE, 0,
+                         (FAR struct sockaddr *)&from, &fromlen);
+      if (nrecvd < 0)
+        {
+          continue;
+        }
+
+      if (port == NETBENCH_ECHO)
+        {
+          (void)sendto(sd, buffer, nrecvd, 0,
+                       (FAR struct sockaddr *)&from, fromlen);
+        }
+      else
+        {
+          g_netbench.udprecvd++;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netbench_tcpstream
+ *
+ * Description:
+ *   Send CONFIG_SIM_NETBENCH_NBYTES to the TCP discard port in blocks of
+ *   CONFIG_SIM_NETBENCH_BLOCKSIZE bytes.  Each operation is one block.
+ *
+ ****************************************************************************/
+
+static int netbench_tcpstream(void)
+{
+  int nblocks = CONFIG_SIM_NETBENCH_NBYTES / CONFIG_SIM_NETBENCH_BLOCKSIZE;
+  int ret = OK;
+  int sd;
+  int i;
+
+  sd = netbench_socket(SOCK_STREAM, NETBENCH_DISCARD, false);
+  if (sd < 0)
+    {
+      return sd;
+    }
+
+  netbench_begin();
+
+  for (i = 0; i < nblocks && ret == OK; i++)
+    {
+      ret = netbench_sendall(sd, g_netbench.buffer,
+                             CONFIG_SIM_NETBENCH_BLOCKSIZE);
+    }
+
+  netbench_end(i);
+  g_netbench.nbytes = (uint64_t)i * CONFIG_SIM_NETBENCH_BLOCKSIZE;
+
+  close(sd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_tcprr
+ *
+ * Description:
+ *   Send CONFIG_SIM_NETBENCH_RRSIZE bytes to the TCP echo port and wait for
+ *   them to return.  Each operation is one round trip.
+ *
+ ****************************************************************************/
+
+static int netbench_tcprr(void)
+{
+  int ret = OK;
+  int sd;
+  int i;
+
+  sd = netbench_socket(SOCK_STREAM, NETBENCH_ECHO, false);
+  if (sd < 0)
+    {
+      return sd;
+    }
+
+  netbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_NETBENCH_NROUNDS && ret == OK; i++)
+    {
+      ret = netbench_sendall(sd, g_netbench.buffer,
+                             CONFIG_SIM_NETBENCH_RRSIZE);
+      if (ret == OK)
+        {
+          ret = netbench_recvall(sd, g_netbench.buffer,
+                                 CONFIG_SIM_NETBENCH_RRSIZE);
+        }
+    }
+
+  netbench_end(i);
+  g_netbench.nbytes = (uint64_t)i * CONFIG_SIM_NETBENCH_RRSIZE * 2;
+
+  close(sd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_tcpcrr
+ *
+ * Description:
+ *   Connect to the TCP echo port, exchange one byte and close the
+ *   connection.  Each operation is one connection.
+ *
+ ****************************************************************************/
+
+static int netbench_tcpcrr(void)
+{
+  int ret = OK;
+  int sd;
+  int i;
+
+  netbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_NETBENCH_NCONNECTS && ret == OK; i++)
+    {
+      sd = netbench_socket(SOCK_STREAM, NETBENCH_ECHO, false);
+      if (sd < 0)
+        {
+          ret = sd;
+          break;
+        }
+
+      ret = netbench_sendall(sd, g_netbench.buffer, 1);
+      if (ret == OK)
+        {
+          ret = netbench_recvall(sd, g_netbench.buffer, 1);
+        }
+
+      close(sd);
+    }
+
+  netbench_end(i);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_tcpmany
+ *
+ * Description:
+ *   Open CONFIG_SIM_NETBENCH_NCONNS connections to the TCP echo port.  In
+ *   each round, send a request on every connection, then collect all of the
+ *   responses.  Each operation is one request/response.
+ *
+ ****************************************************************************/
+
+static int netbench_tcpmany(void)
+{
+  int sd[CONFIG_SIM_NETBENCH_NCONNS];
+  int nrounds = CONFIG_SIM_NETBENCH_NROUNDS / CONFIG_SIM_NETBENCH_NCONNS;
+  int nconns;
+  int ret = OK;
+  int i;
+  int j;
+
+  for (nconns = 0; nconns < CONFIG_SIM_NETBENCH_NCONNS; nconns++)
+    {
+      sd[nconns] = netbench_socket(SOCK_STREAM, NETBENCH_ECHO, false);
+      if (sd[nconns] < 0)
+        {
+          ret = sd[nconns];
+          goto errout;
+        }
+    }
+
+  netbench_begin();
+
+  for (i = 0; i < nrounds && ret == OK; i++)
+    {
+      for (j = 0; j < nconns && ret == OK; j++)
+        {
+          ret = netbench_sendall(sd[j], g_netbench.buffer,
+                                 CONFIG_SIM_NETBENCH_RRSIZE);
+        }
+
+      for (j = 0; j < nconns && ret == OK; j++)
+        {
+          ret = netbench_recvall(sd[j], g_netbench.buffer,
+                                 CONFIG_SIM_NETBENCH_RRSIZE);
+        }
+    }
+
+  netbench_end(i * nconns);
+  g_netbench.nbytes = (uint64_t)i * nconns * CONFIG_SIM_NETBENCH_RRSIZE * 2;
+
+errout:
+  while (nconns > 0)
+    {
+      close(sd[--nconns]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_udpstream
+ *
+ * Description:
+ *   Send CONFIG_SIM_NETBENCH_NBYTES to the UDP discard port in datagrams of
+ *   CONFIG_SIM_NETBENCH_UDPSIZE bytes.  Each operation is one datagram.
+ *   UDP has no flow control so the number of datagrams that arrived is
+ *   reported as well (only meaningful with the local discard service).
+ *
+ ****************************************************************************/
+
+static int netbench_udpstream(void)
+{
+  struct sockaddr_in addr;
+  int ndgrams = CONFIG_SIM_NETBENCH_NBYTES / CONFIG_SIM_NETBENCH_UDPSIZE;
+  uint32_t udprecvd;
+  int ret = OK;
+  int sd;
+  int i;
+
+  sd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (sd < 0)
+    {
+      return -errno;
+    }
+
+  memcpy(&addr, &g_netbench.server, sizeof(struct sockaddr_in));
+  addr.sin_port = htons(NETBENCH_DISCARD);
+  udprecvd      = g_netbench.udprecvd;
+
+  netbench_begin();
+
+  for (i = 0; i < ndgrams; i++)
+    {
+      if (sendto(sd, g_netbench.buffer, CONFIG_SIM_NETBENCH_UDPSIZE, 0,
+                 (FAR struct sockaddr *)&addr,
+                 sizeof(struct sockaddr_in)) < 0)
+        {
+          ret = -errno;
+          break;
+        }
+    }
+
+  netbench_end(i);
+  g_netbench.nbytes = (uint64_t)i * CONFIG_SIM_NETBENCH_UDPSIZE;
+
+  /* Give the discard service a chance to catch up */
+
+  usleep(100 * 1000);
+  printf("# udp_stream: %lu of %d datagrams received\n",
+         (unsigned long)(g_netbench.udprecvd - udprecvd), i);
+
+  close(sd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_udprr
+ *
+ * Description:
+ *   Send CONFIG_SIM_NETBENCH_RRSIZE bytes to the UDP echo port and wait for
+ *   them to return.  Each operation is one round trip.  Lost datagrams are
+ *   counted if receive timeouts are supported.
+ *
+ ****************************************************************************/
+
+static int netbench_udprr(void)
+{
+  struct sockaddr_in addr;
+  int nlost = 0;
+  int ret = OK;
+  int sd;
+  int i;
+
+  sd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (sd < 0)
+    {
+      return -errno;
+    }
+
+#ifdef CONFIG_NET_SOCKOPTS
+  {
+    struct timeval tv;
+
+    tv.tv_sec  = 1;
+    tv.tv_usec = 0;
+    (void)setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, &tv,
+                     sizeof(struct timeval));
+  }
+#endif
+
+  memcpy(&addr, &g_netbench.server, sizeof(struct sockaddr_in));
+  addr.sin_port = htons(NETBENCH_ECHO);
+
+  netbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_NETBENCH_NROUNDS; i++)
+    {
+      if (sendto(sd, g_netbench.buffer, CONFIG_SIM_NETBENCH_RRSIZE, 0,
+                 (FAR struct sockaddr *)&addr,
+                 sizeof(struct sockaddr_in)) < 0)
+        {
+          ret = -errno;
+          break;
+        }
+
+      if (recv(sd, g_netbench.buffer, CONFIG_SIM_NETBENCH_RRSIZE, 0) < 0)
+        {
+          if (errno != EAGAIN)
+            {
+              ret = -errno;
+              break;
+            }
+
+          nlost++;
+        }
+    }
+
+  netbench_end(i);
+  g_netbench.nbytes = (uint64_t)i * CONFIG_SIM_NETBENCH_RRSIZE * 2;
+
+  if (nlost > 0)
+    {
+      printf("# udp_rr: %d of %d datagrams lost\n", nlost, i);
+    }
+
+  close(sd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_chksum and netbench_chksumodd
+ *
+ * Description:
+ *   Compute the Internet checksum of CONFIG_SIM_NETBENCH_CHKSUMSIZE bytes
+ *   of pseudo-random data with net_chksum(), starting at an even or at an
+ *   odd address.  Each operation is one checksum.  The result is checked
+ *   against a plain RFC 1071 sum of the same data.
+ *
+ ****************************************************************************/
+
+static int netbench_sumdata(int offset)
+{
+  FAR uint8_t *data = (FAR uint8_t *)g_netbench.chkbuf + offset;
+  volatile uint16_t result = 0;
+  uint32_t seed = 1;
+  uint32_t sum = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SIM_NETBENCH_CHKSUMSIZE; i++)
+    {
+      seed    = seed * 1103515245 + 12345;
+      data[i] = (uint8_t)(seed >> 16);
+    }
+
+  /* The reference sum of big-endian 16-bit words */
+
+  for (i = 0; i < CONFIG_SIM_NETBENCH_CHKSUMSIZE - 1; i += 2)
+    {
+      sum += ((uint32_t)data[i] << 8) | data[i + 1];
+    }
+
+  if (i < CONFIG_SIM_NETBENCH_CHKSUMSIZE)
+    {
+      sum += (uint32_t)data[i] << 8;
+    }
+
+  while ((sum >> 16) != 0)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+  netbench_begin();
+
+  for (i = 0; i < CONFIG_SIM_NETBENCH_NCHKSUMS; i++)
+    {
+      result = net_chksum((FAR uint16_t *)data,
+                          CONFIG_SIM_NETBENCH_CHKSUMSIZE);
+    }
+
+  netbench_end(i);
+  g_netbench.nbytes = (uint64_t)i * CONFIG_SIM_NETBENCH_CHKSUMSIZE;
+
+  if (result != htons((uint16_t)sum))
+    {
+      printf("# chksum: got %04x expected %04x\n",
+             (unsigned int)result, (unsigned int)htons((uint16_t)sum));
+      return -EIO;
+    }
+
+  return OK;
+}
+
+static int netbench_chksum(void)
+{
+  return netbench_sumdata(0);
+}
+
+static int netbench_chksumodd(void)
+{
+  return netbench_sumdata(1);
+}
+
+/****************************************************************************
+ * Name: netbench_run
+ *
+ * Description:
+ *   Run one test and print one line of comma separated results:
+ *
+ *     netbench,<test>,<ops>,<usec>,<nsec/op>,<bytes/sec>,<locks/op>,
+ *       <lock nsec/op>,<max lock nsec>
+ *
+ *   The last three are the number of times the network lock was taken, the
+ *   time that it was held and the longest time that it was held.  They are
+ *   zero unless CONFIG_NET_LOCK_STATS is selected.
+ *
+ ****************************************************************************/
+
+static int netbench_run(FAR const struct netbench_test_s *test)
+{
+#ifdef CONFIG_NET_LOCK_STATS
+  struct net_lockstats_s stats;
+#endif
+  unsigned long locks   = 0;
+  unsigned long lockns  = 0;
+  unsigned long maxhold = 0;
+  uint64_t nsec;
+  uint64_t usec;
+  int nops;
+  int ret;
+
+  g_netbench.nbytes = 0;
+  g_netbench.nops   = 0;
+
+  ret = test->run();
+
+#ifdef CONFIG_NET_LOCK_STATS
+  net_lockstats(&stats, false);
+#endif
+
+  if (ret < 0)
+    {
+      printf("# %s failed: %d\n", test->name, ret);
+    }
+
+  nops = g_netbench.nops > 0 ? g_netbench.nops : 1;
+  nsec = g_netbench.end - g_netbench.start;
+  usec = nsec / 1000;
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+#ifdef CONFIG_NET_LOCK_STATS
+  /* The counter is up_cyclecount(), convert to nanoseconds */
+
+  locks   = stats.nlocks / nops;
+  lockns  = (unsigned long)(stats.holdcycles * 1000 / nops /
+                            (up_cyclefreq() / 1000000));
+  maxhold = (unsigned long)((uint64_t)stats.maxhold * 1000 /
+                            (up_cyclefreq() / 1000000));
+#endif
+
+  printf("netbench,%s,%d,%lu,%lu,%lu,%lu,%lu,%lu\n",
+         test->name, g_netbench.nops, (unsigned long)usec,
+         (unsigned long)(nsec / nops),
+         (unsigned long)(g_netbench.nbytes * 1000000 / usec),
+         locks, lockns, maxhold);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_main
+ *
+ * Description:
+ *   netbench_main is a throughput and latency benchmark of the network
+ *   stack.  It starts discard and echo services on TCP and UDP ports
+ *   CONFIG_SIM_NETBENCH_PORT and CONFIG_SIM_NETBENCH_PORT+1 and runs the
+ *   tests against them over the loopback device.  If an IPv4 address is
+ *   given as the first argument, the tests are run against the services of
+ *   that host instead, for example over a TAP or TUN device.  A second
+ *   argument selects a single test by name.
+ *
+ ****************************************************************************/
+
+int netbench_main(int argc, char *argv[])
+{
+  char addrstr[INET_ADDRSTRLEN];
+  int errcount = 0;
+  int i;
+
+  g_netbench.server.sin_family      = AF_INET;
+  g_netbench.server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  if (argc > 1 &&
+      inet_pton(AF_INET, argv[1], &g_netbench.server.sin_addr) != 1)
+    {
+      fprintf(stderr, "Usage: %s [<ipaddr> [<test>]]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  memset(g_netbench.buffer, 0x5a, NETBENCH_BUFSIZE);
+
+  if (netbench_thread(netbench_tcpserver,
+                      (FAR void *)((intptr_t)NETBENCH_DISCARD)) < 0 ||
+      netbench_thread(netbench_tcpserver,
+                      (FAR void *)((intptr_t)NETBENCH_ECHO)) < 0 ||
+      netbench_thread(netbench_udpserver,
+                      (FAR void *)((intptr_t)NETBENCH_DISCARD)) < 0 ||
+      netbench_thread(netbench_udpserver,
+                      (FAR void *)((intptr_t)NETBENCH_ECHO)) < 0)
+    {
+      return EXIT_FAILURE;
+    }
+
+  /* Let the services reach accept() and recvfrom() */
+
+  usleep(100 * 1000);
+
+  printf("# netbench,test,ops,usec,nsec/op,bytes/sec,locks/op,"
+         "lock nsec/op,max lock nsec\n");
+  printf("# server %s\n",
+         inet_ntop(AF_INET, &g_netbench.server.sin_addr, addrstr,
+                   INET_ADDRSTRLEN));
+
+  for (i = 0; i < NETBENCH_NTESTS; i++)
+    {
+      if (argc > 2 && strcmp(argv[2], g_netbench_tests[i].name) != 0)
+        {
+          continue;
+        }
+
+      if (netbench_run(&g_netbench_tests[i]) < 0)
+        {
+          errcount++;
+        }
+    }
+
+  return errcount > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,679 @@
+/****************************************************************************
+ * configs/sim/src/sim_nxbench.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/boardctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SIM_NXBENCH_NWINDOWS
+#  define CONFIG_SIM_NXBENCH_NWINDOWS 1
+#endif
+
+#ifndef CONFIG_SIM_NXBENCH_NOPS
+#  define CONFIG_SIM_NXBENCH_NOPS 1000
+#endif
+
+#ifndef CONFIG_SIM_NXBENCH_LISTENERPRIO
+#  define CONFIG_SIM_NXBENCH_LISTENERPRIO 80
+#endif
+
+#ifndef CONFIG_SIM_NXBENCH_LISTENER_STACKSIZE
+#  define CONFIG_SIM_NXBENCH_LISTENER_STACKSIZE 2048
+#endif
+
+/* The simulated LCD defaults to 16 bits per pixel */
+
+#ifndef CONFIG_SIM_FBBPP
+#  define CONFIG_SIM_FBBPP 16
+#endif
+
+#ifdef CONFIG_NX_LCDDRIVER
+#  define NXBENCH_BACKEND "lcd"
+#else
+#  define NXBENCH_BACKEND "fb"
+#endif
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define NXBENCH_CLOCK CLOCK_MONOTONIC
+#else
+#  define NXBENCH_CLOCK CLOCK_REALTIME
+#endif
+
+/* The source image used by the bitmap test */
+
+#define NXBENCH_IMAGE_WIDTH   64
+#define NXBENCH_IMAGE_HEIGHT  64
+#define NXBENCH_IMAGE_STRIDE \
+  ((NXBENCH_IMAGE_WIDTH * CONFIG_SIM_FBBPP + 7) >> 3)
+#define NXBENCH_IMAGE_SIZE    (NXBENCH_IMAGE_STRIDE * NXBENCH_IMAGE_HEIGHT)
+
+/* Colors that are valid at every pixel depth */
+
+#if CONFIG_SIM_FBBPP < 16
+#  define NXBENCH_FGCOLOR     ((nxgl_mxpixel_t)((1 << CONFIG_SIM_FBBPP) - 1))
+#else
+#  define NXBENCH_FGCOLOR     ((nxgl_mxpixel_t)0xffff)
+#endif
+#define NXBENCH_BGCOLOR       ((nxgl_mxpixel_t)0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nxbench_s
+{
+  NXHANDLE hnx;                      /* Connection to the NX server */
+  NXWINDOW hbkgd;                    /* The background window */
+  NXWINDOW hwnd[CONFIG_SIM_NXBENCH_NWINDOWS]; /* hwnd[0] is the bottom window */
+  FCACHE fcache;                     /* Font cache for the glyph test */
+  struct nxgl_size_s xres;           /* Size of the display */
+  struct nxgl_size_s size;           /* Size of each window */
+  volatile bool connected;           /* True: Connected to the server */
+  volatile bool havexres;            /* True: The display size is known */
+  volatile unsigned int nredraws;    /* Number of redraw requests received */
+  sem_t eventsem;                    /* Wakes up nxbench_main() */
+  uint32_t seed;                     /* Pseudo-random number state */
+  uint8_t image[NXBENCH_IMAGE_SIZE]; /* Source image for the bitmap test */
+};
+
+/* Describes one test.  op() performs operation number 'i' of the test. */
+
+struct nxbench_test_s
+{
+  FAR const char *name;
+  CODE int (*op)(int i);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void nxbench_redraw(NXWINDOW hwnd, FAR const struct nxgl_rect_s *rect,
+                           bool more, FAR void *arg);
+static void nxbench_position(NXWINDOW hwnd,
+                             FAR const struct nxgl_size_s *size,
+                             FAR const struct nxgl_point_s *pos,
+                             FAR const struct nxgl_rect_s *bounds,
+                             FAR void *arg);
+
+static int nxbench_fill(int i);
+static int nxbench_line(int i);
+static int nxbench_circle(int i);
+static int nxbench_bitmap(int i);
+static int nxbench_glyph(int i);
+static int nxbench_scroll(int i);
+static int nxbench_winmove(int i);
+static int nxbench_raise(int i);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct nxbench_s g_nxbench;
+
+static const struct nx_callback_s g_nxbench_cb =
+{
+  nxbench_redraw,    /* redraw */
+  nxbench_position   /* position */
+#ifdef CONFIG_NX_XYINPUT
+  , NULL             /* mousein */
+#endif
+#ifdef CONFIG_NX_KBD
+  , NULL             /* kbdin */
+#endif
+  , NULL             /* blocked */
+};
+
+static const struct nxbench_test_s g_nxbench_tests[] =
+{
+  { "fill",    nxbench_fill    },  /* Fill rectangles */
+  { "line",    nxbench_line    },  /* Draw wide lines */
+  { "circle",  nxbench_circle  },  /* Fill circles */
+  { "bitmap",  nxbench_bitmap  },  /* Copy a 64x64 image */
+  { "glyph",   nxbench_glyph   },  /* Render text from the font cache */
+  { "scroll",  nxbench_scroll  },  /* Move a region within the window */
+  { "winmove", nxbench_winmove },  /* Move the top window */
+  { "raise",   nxbench_raise   },  /* Raise/lower the bottom window */
+};
+
+#define NXBENCH_NTESTS (sizeof(g_nxbench_tests) / sizeof(struct nxbench_test_s))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbench_redraw and nxbench_position
+ *
+ * Description:
+ *   NX window callbacks.  Redraw requests are only counted:  The benchmark
+ *   measures the work done by the server, not by the client.
+ *
+ ****************************************************************************/
+
+static void nxbench_redraw(NXWINDOW hwnd, FAR const struct nxgl_rect_s *rect,
+                           bool more, FAR void *arg)
+{
+  g_nxbench.nredraws++;
+}
+
+static void nxbench_position(NXWINDOW hwnd,
+                             FAR const struct nxgl_size_s *size,
+                             FAR const struct nxgl_point_s *pos,
+                             FAR const struct nxgl_rect_s *bounds,
+                             FAR void *arg)
+{
+  if (!g_nxbench.havexres)
+    {
+      g_nxbench.xres.w   = bounds->pt2.x + 1;
+      g_nxbench.xres.h   = bounds->pt2.y + 1;
+      g_nxbench.havexres = true;
+      sem_post(&g_nxbench.eventsem);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbench_listener
+ ****************************************************************************/
+
+static FAR void *nxbench_listener(FAR void *arg)
+{
+  int ret;
+
+  /* Process events forever */
+
+  for (;;)
+    {
+      ret = nx_eventhandler(g_nxbench.hnx);
+      if (ret < 0)
+        {
+          gwarn("WARNING: Lost server connection: %d\n", errno);
+          pthread_exit(NULL);
+        }
+
+      /* If we received a message, we must be connected */
+
+      if (!g_nxbench.connected)
+        {
+          g_nxbench.connected = true;
+          sem_post(&g_nxbench.eventsem);
+        }
+    }
+
+  return NULL; /* Not-reachable */
+}
+
+/****************************************************************************
+ * Name: nxbench_random
+ *
+ * Description:
+ *   Return a pseudo-random number in the range 0..range-1.  The sequence is
+ *   the same on every run so that results can be compared.
+ *
+ ****************************************************************************/
+
+static nxgl_coord_t nxbench_random(nxgl_coord_t range)
+{
+  g_nxbench.seed = g_nxbench.seed * 1103515245 + 12345;
+  return range > 0 ? (nxgl_coord_t)((g_nxbench.seed >> 16) % range) : 0;
+}
+
+/****************************************************************************
+ * Name: nxbench_fence
+ *
+ * Description:
+ *   Drawing requests are only queued to the server.  nx_bitmap() does not
+ *   return until the server has processed it, and so also every request
+ *   that was queued before it.
+ *
+ ****************************************************************************/
+
+static int nxbench_fence(void)
+{
+  FAR const void *src[CONFIG_NX_NPLANES];
+  struct nxgl_rect_s dest;
+  struct nxgl_point_s origin;
+
+  dest.pt1.x = 0;
+  dest.pt1.y = 0;
+  dest.pt2.x = 0;
+  dest.pt2.y = 0;
+  origin.x   = 0;
+  origin.y   = 0;
+  src[0]     = g_nxbench.image;
+
+  return nx_bitmap(g_nxbench.hwnd[0], &dest, src, &origin,
+                   NXBENCH_IMAGE_STRIDE);
+}
+
+/****************************************************************************
+ * Name: nxbench_* tests
+ ****************************************************************************/
+
+static int nxbench_fill(int i)
+{
+  nxgl_mxpixel_t color = (i & 1) ? NXBENCH_FGCOLOR : NXBENCH_BGCOLOR;
+  struct nxgl_rect_s rect;
+
+  rect.pt1.x = nxbench_random(g_nxbench.size.w - g_nxbench.size.w / 4);
+  rect.pt1.y = nxbench_random(g_nxbench.size.h - g_nxbench.size.h / 4);
+  rect.pt2.x = rect.pt1.x + g_nxbench.size.w / 4 - 1;
+  rect.pt2.y = rect.pt1.y + g_nxbench.size.h / 4 - 1;
+
+  return nx_fill(g_nxbench.hwnd[0], &rect, &color);
+}
+
+static int nxbench_line(int i)
+{
+  nxgl_mxpixel_t color = (i & 1) ? NXBENCH_FGCOLOR : NXBENCH_BGCOLOR;
+  struct nxgl_vector_s vector;
+
+  vector.pt1.x = nxbench_random(g_nxbench.size.w);
+  vector.pt1.y = nxbench_random(g_nxbench.size.h);
+  vector.pt2.x = nxbench_random(g_nxbench.size.w);
+  vector.pt2.y = nxbench_random(g_nxbench.size.h);
+
+  return nx_drawline(g_nxbench.hwnd[0], &vector, 4, &color,
+                     NX_LINECAP_BOTH);
+}
+
+static int nxbench_circle(int i)
+{
+  nxgl_mxpixel_t color = (i & 1) ? NXBENCH_FGCOLOR : NXBENCH_BGCOLOR;
+  struct nxgl_point_s center;
+  nxgl_coord_t radius = g_nxbench.size.h / 8;
+
+  center.x = radius + nxbench_random(g_nxbench.size.w - 2 * radius);
+  center.y = radius + nxbench_random(g_nxbench.size.h - 2 * radius);
+
+  return nx_fillcircle(g_nxbench.hwnd[0], &center, radius, &color);
+}
+
+static int nxbench_bitmap(int i)
+{
+  FAR const void *src[CONFIG_NX_NPLANES];
+  struct nxgl_rect_s dest;
+
+  dest.pt1.x = nxbench_random(g_nxbench.size.w - NXBENCH_IMAGE_WIDTH);
+  dest.pt1.y = nxbench_random(g_nxbench.size.h - NXBENCH_IMAGE_HEIGHT);
+  dest.pt2.x = dest.pt1.x + NXBENCH_IMAGE_WIDTH - 1;
+  dest.pt2.y = dest.pt1.y + NXBENCH_IMAGE_HEIGHT - 1;
+  src[0]     = g_nxbench.image;
+
+  return nx_bitmap(g_nxbench.hwnd[0], &dest, src, &dest.pt1,
+                   NXBENCH_IMAGE_STRIDE);
+}
+
+static int nxbench_glyph(int i)
+{
+  FAR const struct nxfonts_glyph_s *glyph;
+  FAR const void *src[CONFIG_NX_NPLANES];
+  struct nxgl_rect_s dest;
+  uint8_t ch = ' ' + 1 + (i % 94);
+
+  glyph = nxf_cache_getglyph(g_nxbench.fcache, ch);
+  if (glyph == NULL)
+    {
+      return ERROR;
+    }
+
+  /* Draw the text in lines of glyphs across the window */
+
+  dest.pt1.x = (i * glyph->width) % (g_nxbench.size.w - glyph->width);
+  dest.pt1.y = ((i * glyph->width) / (g_nxbench.size.w - glyph->width) *
+                glyph->height) % (g_nxbench.size.h - glyph->height);
+  dest.pt2.x = dest.pt1.x + glyph->width - 1;
+  dest.pt2.y = dest.pt1.y + glyph->height - 1;
+  src[0]     = glyph->bitmap;
+
+  return nx_bitmap(g_nxbench.hwnd[0], &dest, src, &dest.pt1,
+                   glyph->stride);
+}
+
+static int nxbench_scroll(int i)
+{
+  struct nxgl_rect_s rect;
+  struct nxgl_point_s offset;
+
+  rect.pt1.x = 0;
+  rect.pt1.y = 1;
+  rect.pt2.x = g_nxbench.size.w - 1;
+  rect.pt2.y = g_nxbench.size.h - 1;
+  offset.x   = 0;
+  offset.y   = -1;
+
+  return nx_move(g_nxbench.hwnd[0], &rect, &offset);
+}
+
+static int nxbench_winmove(int i)
+{
+  NXWINDOW hwnd = g_nxbench.hwnd[CONFIG_SIM_NXBENCH_NWINDOWS - 1];
+  struct nxgl_point_s pos;
+
+  pos.x = nxbench_random(g_nxbench.xres.w - g_nxbench.size.w);
+  pos.y = nxbench_random(g_nxbench.xres.h - g_nxbench.size.h);
+
+  return nx_setposition(hwnd, &pos);
+}
+
+static int nxbench_raise(int i)
+{
+  if ((i & 1) == 0)
+    {
+      return nx_raise(g_nxbench.hwnd[0]);
+    }
+  else
+    {
+      return nx_lower(g_nxbench.hwnd[0]);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbench_run
+ *
+ * Description:
+ *   Run one test and print one line of results in the form:
+ *
+ *     nxbench,<test>,<backend>,<bpp>,<nwindows>,<ops>,<usec>,<ops/sec>,
+ *       <redraws>
+ *
+ ****************************************************************************/
+
+static int nxbench_run(FAR const struct nxbench_test_s *test)
+{
+  struct timespec start;
+  struct timespec end;
+  unsigned int nredraws;
+  uint64_t usec;
+  int ret;
+  int i;
+
+  g_nxbench.seed = 1;
+  nredraws = g_nxbench.nredraws;
+
+  ret = nxbench_fence();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  (void)clock_gettime(NXBENCH_CLOCK, &start);
+
+  for (i = 0; i < CONFIG_SIM_NXBENCH_NOPS; i++)
+    {
+      ret = test->op(i);
+      if (ret < 0)
+        {
+          gerr("ERROR: %s failed at operation %d: %d\n",
+               test->name, i, errno);
+          return ret;
+        }
+    }
+
+  ret = nxbench_fence();
+  (void)clock_gettime(NXBENCH_CLOCK, &end);
+
+  usec = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 +
+         (end.tv_nsec - start.tv_nsec) / 1000;
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+  printf("nxbench,%s,%s,%d,%d,%d,%lu,%lu,%u\n",
+         test->name, NXBENCH_BACKEND, CONFIG_SIM_FBBPP,
+         CONFIG_SIM_NXBENCH_NWINDOWS, CONFIG_SIM_NXBENCH_NOPS,
+         (unsigned long)usec,
+         (unsigned long)((uint64_t)CONFIG_SIM_NXBENCH_NOPS * 1000000 / usec),
+         g_nxbench.nredraws - nredraws);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxbench_connect
+ *
+ * Description:
+ *   Start the NX server, connect to it and start the listener thread.
+ *
+ ****************************************************************************/
+
+static int nxbench_connect(void)
+{
+  struct sched_param param;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int ret;
+
+  /* Start the NX server kernel thread */
+
+  ret = boardctl(BOARDIOC_NX_START, 0);
+  if (ret < 0)
+    {
+      gerr("ERROR: Failed to start the NX server: %d\n", errno);
+      return ret;
+    }
+
+  /* Connect to the server */
+
+  g_nxbench.hnx = nx_connect();
+  if (g_nxbench.hnx == NULL)
+    {
+      gerr("ERROR: nx_connect failed: %d\n", errno);
+      return ERROR;
+    }
+
+  /* Start a separate thread to listen for server events */
+
+  (void)pthread_attr_init(&attr);
+  param.sched_priority = CONFIG_SIM_NXBENCH_LISTENERPRIO;
+  (void)pthread_attr_setschedparam(&attr, &param);
+  (void)pthread_attr_setstacksize(&attr,
+                                  CONFIG_SIM_NXBENCH_LISTENER_STACKSIZE);
+
+  ret = pthread_create(&thread, &attr, nxbench_listener, NULL);
+  if (ret != 0)
+    {
+      gerr("ERROR: pthread_create failed: %d\n", ret);
+      nx_disconnect(g_nxbench.hnx);
+      return ERROR;
+    }
+
+  /* Don't return until we are connected to the server */
+
+  while (!g_nxbench.connected)
+    {
+      (void)sem_wait(&g_nxbench.eventsem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxbench_openwindows
+ *
+ * Description:
+ *   Get the size of the display from the background window, then open the
+ *   overlapping test windows.  Each window covers half of the display.
+ *
+ ****************************************************************************/
+
+static int nxbench_openwindows(void)
+{
+  struct nxgl_point_s pos;
+  nxgl_coord_t dx;
+  nxgl_coord_t dy;
+  int ret;
+  int i;
+
+  ret = nx_requestbkgd(g_nxbench.hnx, &g_nxbench_cb, NULL);
+  if (ret < 0)
+    {
+      gerr("ERROR: nx_requestbkgd failed: %d\n", errno);
+      return ret;
+    }
+
+  while (!g_nxbench.havexres)
+    {
+      (void)sem_wait(&g_nxbench.eventsem);
+    }
+
+  g_nxbench.size.w = g_nxbench.xres.w / 2;
+  g_nxbench.size.h = g_nxbench.xres.h / 2;
+
+  /* Stagger the windows so that each overlaps the ones below it */
+
+  dx = g_nxbench.size.w / CONFIG_SIM_NXBENCH_NWINDOWS;
+  dy = g_nxbench.size.h / CONFIG_SIM_NXBENCH_NWINDOWS;
+
+  for (i = 0; i < CONFIG_SIM_NXBENCH_NWINDOWS; i++)
+    {
+      g_nxbench.hwnd[i] = nx_openwindow(g_nxbench.hnx, &g_nxbench_cb, NULL);
+      if (g_nxbench.hwnd[i] == NULL)
+        {
+          gerr("ERROR: nx_openwindow failed: %d\n", errno);
+          return ERROR;
+        }
+
+      pos.x = i * dx;
+      pos.y = i * dy;
+
+      ret = nx_setsize(g_nxbench.hwnd[i], &g_nxbench.size);
+      if (ret == OK)
+        {
+          ret = nx_setposition(g_nxbench.hwnd[i], &pos);
+        }
+
+      if (ret < 0)
+        {
+          gerr("ERROR: Failed to place window %d: %d\n", i, errno);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbench_main
+ *
+ * Description:
+ *   nxbench_main is a small NX throughput benchmark for the simulator.  It
+ *   opens CONFIG_SIM_NXBENCH_NWINDOWS overlapping windows, draws into the
+ *   bottom one and moves and restacks them.  Each test performs
+ *   CONFIG_SIM_NXBENCH_NOPS operations and prints one line of comma
+ *   separated results (see nxbench_run()).  Build it with the
+ *   framebuffer or the LCD back-end and with different values of
+ *   CONFIG_SIM_FBBPP to compare them.
+ *
+ ****************************************************************************/
+
+int nxbench_main(int argc, char *argv[])
+{
+  int ret;
+  int i;
+
+  sem_init(&g_nxbench.eventsem, 0, 0);
+  memset(g_nxbench.image, 0x5a, NXBENCH_IMAGE_SIZE);
+
+  ret = nxbench_connect();
+  if (ret < 0)
+    {
+      return EXIT_FAILURE;
+    }
+
+  ret = nxbench_openwindows();
+  if (ret < 0)
+    {
+      goto errout_with_nx;
+    }
+
+  g_nxbench.fcache = nxf_cache_connect(FONTID_DEFAULT, NXBENCH_FGCOLOR,
+                                       NXBENCH_BGCOLOR, CONFIG_SIM_FBBPP,
+                                       96);
+  if (g_nxbench.fcache == NULL)
+    {
+      gerr("ERROR: nxf_cache_connect failed: %d\n", errno);
+      goto errout_with_nx;
+    }
+
+  printf("# nxbench,test,backend,bpp,nwindows,ops,usec,ops/sec,redraws\n");
+  printf("# display %dx%d, windows %dx%d\n",
+         g_nxbench.xres.w, g_nxbench.xres.h,
+         g_nxbench.size.w, g_nxbench.size.h);
+
+  for (i = 0; i < NXBENCH_NTESTS; i++)
+    {
+      (void)nxbench_run(&g_nxbench_tests[i]);
+    }
+
+  nxf_cache_disconnect(g_nxbench.fcache);
+  nx_disconnect(g_nxbench.hnx);
+  return EXIT_SUCCESS;
+
+errout_with_nx:
+  nx_disconnect(g_nxbench.hnx);
+  return EXIT_FAILURE;
+}
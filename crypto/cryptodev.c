@@ -40,26 +40,66 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
 #include <poll.h>
 #include <errno.h>
 
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
 #include <nuttx/crypto/cryptodev.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+#ifndef CONFIG_CRYPTO_CRYPTODEV_NSESSIONS
+#  define CONFIG_CRYPTO_CRYPTODEV_NSESSIONS 4
+#endif
+
+/* Without an AES peripheral, the session keeps the expanded key schedule
+ * and calls the software library directly.  Otherwise the key is passed to
+ * the peripheral driver through aes_cypher().
+ */
+
+#if defined(CONFIG_CRYPTO_AES) && defined(CONFIG_CRYPTO_SW_AES) && \
+    !defined(CONFIG_ARCH_HAVE_AES)
+#  define CRYPTODEV_SWAES 1
+#endif
+
+#define CRYPTODEV_MAXKEYLEN 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One session created by CIOCGSESSION */
+
+struct cryptodev_session_s
+{
+  uint32_t cipher;                     /* CRYPTO_AES_*.  Zero: Slot is free */
+  uint32_t keylen;                     /* Length of the key in bytes */
+  uint8_t key[CRYPTODEV_MAXKEYLEN];    /* Copy of the key */
+#ifdef CRYPTODEV_SWAES
+  struct aes_context_s ctx;            /* Expanded key schedule */
 #endif
+};
+
+/* The state of one open instance of /dev/crypto.  Sessions belong to the
+ * open file and are released when it is closed.
+ */
+
+struct cryptodev_file_s
+{
+  sem_t exclsem;                       /* Mutually exclusive access */
+  struct cryptodev_session_s sessions[CONFIG_CRYPTO_CRYPTODEV_NSESSIONS];
+};
 
 /****************************************************************************
  * Private Function Prototypes
@@ -67,12 +107,14 @@
 
 /* Character driver methods */
 
+static int     cryptodev_open(FAR struct file *filep);
+static int     cryptodev_close(FAR struct file *filep);
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
                                size_t len);
-static int cryptodev_ioctl(FAR struct file *filep, int cmd,
-                           unsigned long arg);
+static int     cryptodev_ioctl(FAR struct file *filep, int cmd,
+                               unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -80,8 +122,8 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd,
 
 static const struct file_operations g_cryptodevops =
 {
-  0,                  /* open   */
-  0,                  /* close  */
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   0,                  /* seek   */
@@ -98,6 +140,39 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_open and cryptodev_close
+ ****************************************************************************/
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv;
+
+  priv = (FAR struct cryptodev_file_s *)
+    kmm_zalloc(sizeof(struct cryptodev_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&priv->exclsem, 0, 1);
+  filep->f_priv = priv;
+  return OK;
+}
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+
+  /* Don't leave keys behind in the heap */
+
+  nxsem_destroy(&priv->exclsem);
+  memset(priv, 0, sizeof(struct cryptodev_file_s));
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len)
 {
@@ -110,63 +185,283 @@ static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
   return -EACCES;
 }
 
-static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+/****************************************************************************
+ * Name: cryptodev_getsession
+ *
+ * Description:
+ *   Look up a session by the ID returned by CIOCGSESSION.
+ *
+ ****************************************************************************/
+
+static FAR struct cryptodev_session_s *
+cryptodev_getsession(FAR struct cryptodev_file_s *priv, uint32_t ses)
 {
-  switch (cmd)
-  {
-  case CIOCGSESSION:
+  FAR struct cryptodev_session_s *session;
+
+  if (ses < 1 || ses > CONFIG_CRYPTO_CRYPTODEV_NSESSIONS)
     {
-      FAR struct session_op *ses = (FAR struct session_op *)arg;
-      ses->ses = (uint32_t)ses;
-      return OK;
+      return NULL;
     }
 
-  case CIOCFSESSION:
+  session = &priv->sessions[ses - 1];
+  return session->cipher != 0 ? session : NULL;
+}
+
+/****************************************************************************
+ * Name: cryptodev_newsession
+ *
+ * Description:
+ *   CIOCGSESSION:  Copy the key into a free session slot, expanding it if
+ *   the software AES library is used, and return the session ID.
+ *
+ ****************************************************************************/
+
+static int cryptodev_newsession(FAR struct cryptodev_file_s *priv,
+                                FAR struct session_op *sop)
+{
+  FAR struct cryptodev_session_s *session;
+  int ret;
+  int i;
+
+  switch (sop->cipher)
     {
-      return OK;
+#ifdef CONFIG_CRYPTO_AES
+      case CRYPTO_AES_ECB:
+      case CRYPTO_AES_CBC:
+      case CRYPTO_AES_CTR:
+        if (sop->keylen != 16 && sop->keylen != 24 && sop->keylen != 32)
+          {
+            return -EINVAL;
+          }
+
+        break;
+#endif
+
+      default:
+        return -EINVAL;
     }
 
-#ifdef CONFIG_CRYPTO_AES
-  case CIOCCRYPT:
+  if (sop->key == NULL)
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      return -EINVAL;
+    }
 
-      switch (op->op)
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NSESSIONS; i++)
+    {
+      session = &priv->sessions[i];
+      if (session->cipher == 0)
         {
-        case COP_ENCRYPT:
-          encrypt = 1;
-          break;
+#ifdef CRYPTODEV_SWAES
+          ret = aes_keyexpand(&session->ctx, (FAR const uint8_t *)sop->key,
+                              sop->keylen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+#else
+          ret = OK;
+#endif
+
+          memcpy(session->key, sop->key, sop->keylen);
+          session->keylen = sop->keylen;
+          session->cipher = sop->cipher;
+
+          sop->ses = i + 1;
+          return ret;
+        }
+    }
+
+  return -EBUSY;
+}
 
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
+/****************************************************************************
+ * Name: cryptodev_crypt
+ *
+ * Description:
+ *   Perform one operation of a session.  The data is processed directly in
+ *   the caller's buffers; src and dst may be the same buffer.
+ *
+ ****************************************************************************/
+
+static int cryptodev_crypt(FAR struct cryptodev_file_s *priv,
+                           FAR struct crypt_op *op)
+{
+  FAR struct cryptodev_session_s *session;
+#ifdef CRYPTODEV_SWAES
+  uint8_t iv[AES_BLOCKSIZE];
+#endif
+  bool encrypt;
+
+  session = cryptodev_getsession(priv, op->ses);
+  if (session == NULL)
+    {
+      return -EINVAL;
+    }
+
+  switch (op->op)
+    {
+      case COP_ENCRYPT:
+        encrypt = true;
+        break;
+
+      case COP_DECRYPT:
+        encrypt = false;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  if (op->len > 0 && (op->src == NULL || op->dst == NULL))
+    {
+      return -EINVAL;
+    }
 
-        default:
+#ifdef CRYPTODEV_SWAES
+  /* The caller's IV is not modified, as with the AES peripheral drivers */
+
+  if (session->cipher != CRYPTO_AES_ECB)
+    {
+      if (op->iv == NULL)
+        {
           return -EINVAL;
         }
 
-      switch (ses->cipher)
+      memcpy(iv, op->iv, AES_BLOCKSIZE);
+    }
+
+  switch (session->cipher)
+    {
+      case CRYPTO_AES_ECB:
+        return aes_ecb(&session->ctx, (FAR uint8_t *)op->dst,
+                       (FAR const uint8_t *)op->src, op->len, encrypt);
+
+      case CRYPTO_AES_CBC:
+        return aes_cbc(&session->ctx, iv, (FAR uint8_t *)op->dst,
+                       (FAR const uint8_t *)op->src, op->len, encrypt);
+
+      case CRYPTO_AES_CTR:
+        return aes_ctr(&session->ctx, iv, (FAR uint8_t *)op->dst,
+                       (FAR const uint8_t *)op->src, op->len);
+
+      default:
+        return -EINVAL;
+    }
+
+#elif defined(CONFIG_CRYPTO_AES)
+  switch (session->cipher)
+    {
+      case CRYPTO_AES_ECB:
+        return aes_cypher(op->dst, op->src, op->len, op->iv, session->key,
+                          session->keylen, AES_MODE_ECB, encrypt);
+
+      case CRYPTO_AES_CBC:
+        return aes_cypher(op->dst, op->src, op->len, op->iv, session->key,
+                          session->keylen, AES_MODE_CBC, encrypt);
+
+      case CRYPTO_AES_CTR:
+        return aes_cypher(op->dst, op->src, op->len, op->iv, session->key,
+                          session->keylen, AES_MODE_CTR, encrypt);
+
+      default:
+        return -EINVAL;
+    }
+#else
+  UNUSED(encrypt);
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: cryptodev_ioctl
+ ****************************************************************************/
+
+static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+  int ret;
+
+  if (arg == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxsem_wait(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      /* Create a session.  Argument: struct session_op *.  The session ID
+       * is returned in the ses field.
+       */
+
+      case CIOCGSESSION:
+        ret = cryptodev_newsession(priv, (FAR struct session_op *)arg);
+        break;
+
+      /* Free a session.  Argument: uint32_t * referring to the session ID */
+
+      case CIOCFSESSION:
         {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
+          FAR struct cryptodev_session_s *session;
+
+          session = cryptodev_getsession(priv, *(FAR uint32_t *)arg);
+          if (session == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              memset(session, 0, sizeof(struct cryptodev_session_s));
+            }
+        }
+        break;
 
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+      /* Perform one operation.  Argument: struct crypt_op * */
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+      case CIOCCRYPT:
+        ret = cryptodev_crypt(priv, (FAR struct crypt_op *)arg);
+        break;
 
-        default:
-           return -EINVAL;
+      /* Perform a batch of operations.  Argument: struct crypt_mop *.
+       * Processing stops at the first failure and the number of requests
+       * that completed is returned in the count field.
+       */
+
+      case CIOCCRYPTM:
+        {
+          FAR struct crypt_mop *mop = (FAR struct crypt_mop *)arg;
+          unsigned int i;
+
+          if (mop->count > 0 && mop->reqs == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          for (i = 0; i < mop->count; i++)
+            {
+              ret = cryptodev_crypt(priv, &mop->reqs[i]);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          mop->count = i;
         }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
     }
-#endif
 
-  default:
-    return -ENOTTY;
-  }
+  nxsem_post(&priv->exclsem);
+  return ret;
 }
 
 /****************************************************************************
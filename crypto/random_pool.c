@@ -49,6 +49,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 
@@ -65,6 +66,32 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  ifdef CONFIG_SMP
+#    define RNG_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define RNG_NCPUS 1
+#  endif
+
+#  ifndef CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED
+#    define CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED 1024
+#  endif
+
+#  define CHACHA20_KEYWORDS   8
+#  define CHACHA20_BLOCKSIZE  64
+#  define CHACHA20_HALFBLOCK  (CHACHA20_BLOCKSIZE / 2)
+
+#  define CHACHA20_QR(a,b,c,d) \
+     do \
+       { \
+         a += b; d ^= a; d = ROTL_32(d, 16); \
+         c += d; b ^= c; b = ROTL_32(b, 12); \
+         a += b; d ^= a; d = ROTL_32(d, 8); \
+         c += d; b ^= c; b = ROTL_32(b, 7); \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -90,9 +117,32 @@ struct rng_s
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  volatile uint32_t rd_generation; /* Incremented by every reseed */
+#endif
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* A per-CPU ChaCha20 generator seeded from the BLAKE2Xs generator above.
+ * It is only accessed by its own CPU with local interrupts disabled, so
+ * getrandom() does not need the rd_sem semaphore except to reseed.
+ *
+ * Each ChaCha20 block replaces the key with its first half ("fast key
+ * erasure"), so output that was already returned cannot be reconstructed
+ * from the state.
+ */
+
+struct rng_percpu_s
+{
+  uint32_t key[CHACHA20_KEYWORDS];     /* Current ChaCha20 key */
+  uint32_t generation;                 /* rd_generation when seeded */
+  uint32_t nblocks;                    /* Blocks generated since seeded */
+  uint8_t navail;                      /* Unused bytes at the end of buf */
+  uint8_t buf[CHACHA20_HALFBLOCK];     /* Buffered output for small requests */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -108,6 +158,10 @@ enum
 
 static struct rng_s g_rng;
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_percpu_s g_rng_percpu[RNG_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -313,6 +367,12 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  /* Make the per-CPU generators reseed from the new root */
+
+  g_rng.rd_generation++;
+#endif
 }
 
 static void rng_buf_internal(FAR void *bytes, size_t nbytes)
@@ -365,6 +425,201 @@ static void rng_buf_internal(FAR void *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/****************************************************************************
+ * Name: chacha20_block
+ *
+ * Description:
+ *   Generate one 64 byte ChaCha20 block (RFC 7539) for the given key with
+ *   an all-zero nonce.
+ *
+ ****************************************************************************/
+
+static void chacha20_block(FAR const uint32_t *key, uint32_t counter,
+                           FAR uint8_t *out)
+{
+  uint32_t in[16];
+  uint32_t x[16];
+  int i;
+
+  in[0]  = 0x61707865; /* "expand 32-byte k" */
+  in[1]  = 0x3320646e;
+  in[2]  = 0x79622d32;
+  in[3]  = 0x6b206574;
+  memcpy(&in[4], key, CHACHA20_KEYWORDS * sizeof(uint32_t));
+  in[12] = counter;
+  in[13] = 0;
+  in[14] = 0;
+  in[15] = 0;
+
+  memcpy(x, in, sizeof(x));
+
+  for (i = 0; i < 10; i++)
+    {
+      CHACHA20_QR(x[0], x[4], x[8],  x[12]);
+      CHACHA20_QR(x[1], x[5], x[9],  x[13]);
+      CHACHA20_QR(x[2], x[6], x[10], x[14]);
+      CHACHA20_QR(x[3], x[7], x[11], x[15]);
+      CHACHA20_QR(x[0], x[5], x[10], x[15]);
+      CHACHA20_QR(x[1], x[6], x[11], x[12]);
+      CHACHA20_QR(x[2], x[7], x[8],  x[13]);
+      CHACHA20_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      uint32_t w = x[i] + in[i];
+
+      out[4 * i]     = (uint8_t)w;
+      out[4 * i + 1] = (uint8_t)(w >> 8);
+      out[4 * i + 2] = (uint8_t)(w >> 16);
+      out[4 * i + 3] = (uint8_t)(w >> 24);
+    }
+
+  explicit_bzero(x, sizeof(x));
+  explicit_bzero(in, sizeof(in));
+}
+
+/****************************************************************************
+ * Name: rng_percpu_step
+ *
+ * Description:
+ *   Generate one block with the per-CPU key, replace the key with the first
+ *   half of the block and return the second half in 'out'.  Must be called
+ *   with local interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void rng_percpu_step(FAR struct rng_percpu_s *rng, FAR uint8_t *out)
+{
+  uint8_t block[CHACHA20_BLOCKSIZE];
+
+  chacha20_block(rng->key, 0, block);
+  memcpy(rng->key, block, CHACHA20_HALFBLOCK);
+  memcpy(out, block + CHACHA20_HALFBLOCK, CHACHA20_HALFBLOCK);
+  explicit_bzero(block, sizeof(block));
+  rng->nblocks++;
+}
+
+/****************************************************************************
+ * Name: rng_percpu_reseed
+ *
+ * Description:
+ *   Seed the generator of the current CPU from the BLAKE2Xs generator if
+ *   it has not been seeded since the last reseed of the entropy pool or if
+ *   it has produced CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED blocks.
+ *
+ ****************************************************************************/
+
+static void rng_percpu_reseed(void)
+{
+  FAR struct rng_percpu_s *rng;
+  uint32_t seed[CHACHA20_KEYWORDS];
+  uint32_t generation;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  rng = &g_rng_percpu[up_cpu_index()];
+  if (rng->generation != 0 && rng->generation == g_rng.rd_generation &&
+      rng->nblocks < CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED)
+    {
+      return;
+    }
+
+  do
+    {
+      ret = nxsem_wait(&g_rng.rd_sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+
+  rng_buf_internal(seed, sizeof(seed));
+  generation = g_rng.rd_generation;
+  nxsem_post(&g_rng.rd_sem);
+
+  /* The thread may have moved to another CPU while waiting.  Seed the
+   * generator of the CPU that it runs on now.  Mixing the seed into the
+   * old key keeps any entropy that it already had.
+   */
+
+  flags = up_irq_save();
+  rng   = &g_rng_percpu[up_cpu_index()];
+
+  for (i = 0; i < CHACHA20_KEYWORDS; i++)
+    {
+      rng->key[i] ^= seed[i];
+    }
+
+  rng->generation = generation;
+  rng->nblocks    = 0;
+  rng->navail     = 0;
+  explicit_bzero(rng->buf, sizeof(rng->buf));
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+
+/****************************************************************************
+ * Name: rng_percpu_buf
+ *
+ * Description:
+ *   Fill a buffer from the per-CPU generator.  Small requests are served
+ *   from the buffered half block.  Larger requests take a one-time key from
+ *   the per-CPU generator and generate the output with local interrupts
+ *   enabled, so other threads on this CPU are not held off.
+ *
+ ****************************************************************************/
+
+static void rng_percpu_buf(FAR uint8_t *bytes, size_t nbytes)
+{
+  FAR struct rng_percpu_s *rng;
+  uint32_t key[CHACHA20_KEYWORDS];
+  uint8_t block[CHACHA20_BLOCKSIZE];
+  irqstate_t flags;
+  uint32_t counter;
+  size_t ncopy;
+
+  rng_percpu_reseed();
+
+  flags = up_irq_save();
+  rng   = &g_rng_percpu[up_cpu_index()];
+
+  if (nbytes <= CHACHA20_HALFBLOCK)
+    {
+      if (nbytes > rng->navail)
+        {
+          rng_percpu_step(rng, rng->buf);
+          rng->navail = CHACHA20_HALFBLOCK;
+        }
+
+      /* Take the bytes from the end of the buffer and erase them */
+
+      rng->navail -= nbytes;
+      memcpy(bytes, &rng->buf[rng->navail], nbytes);
+      explicit_bzero(&rng->buf[rng->navail], nbytes);
+      up_irq_restore(flags);
+      return;
+    }
+
+  rng_percpu_step(rng, (FAR uint8_t *)key);
+  up_irq_restore(flags);
+
+  for (counter = 0; nbytes > 0; counter++)
+    {
+      chacha20_block(key, counter, block);
+
+      ncopy = MIN(nbytes, CHACHA20_BLOCKSIZE);
+      memcpy(bytes, block, ncopy);
+      bytes  += ncopy;
+      nbytes -= ncopy;
+    }
+
+  explicit_bzero(block, sizeof(block));
+  explicit_bzero(key, sizeof(key));
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_PERCPU */
+
 static void rng_init(void)
 {
   cryptinfo("Initializing RNG\n");
@@ -549,6 +804,10 @@ void up_randompool_initialize(void)
  *   /dev/random approach is susceptible for things like the attacker
  *   exhausting file descriptors on purpose.
  *
+ *   With CONFIG_CRYPTO_RANDOM_POOL_PERCPU, the output comes from a ChaCha20
+ *   generator of the current CPU and callers only contend for the entropy
+ *   pool when that generator needs to be reseeded.
+ *
  *   Note that this function cannot fail, other than by asserting.
  *
  * Parameters:
@@ -562,6 +821,9 @@ void up_randompool_initialize(void)
 
 void getrandom(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  rng_percpu_buf(bytes, nbytes);
+#else
   int ret;
 
   do
@@ -580,4 +842,5 @@ void getrandom(FAR void *bytes, size_t nbytes)
 
   rng_buf_internal(bytes, nbytes);
   nxsem_post(&g_rng.rd_sem);
+#endif
 }
@@ -0,0 +1,357 @@
+/****************************************************************************
+ * crypto/sha256.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha256.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define SHA256_CH(x,y,z)  (((x) & (y)) ^ (~(x) & (z)))
+#define SHA256_MAJ(x,y,z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA256_S0(x)      (ROTR_32(x, 2) ^ ROTR_32(x, 13) ^ ROTR_32(x, 22))
+#define SHA256_S1(x)      (ROTR_32(x, 6) ^ ROTR_32(x, 11) ^ ROTR_32(x, 25))
+#define SHA256_G0(x)      (ROTR_32(x, 7) ^ ROTR_32(x, 18) ^ ((x) >> 3))
+#define SHA256_G1(x)      (ROTR_32(x, 17) ^ ROTR_32(x, 19) ^ ((x) >> 10))
+
+#define HMAC_IPAD         0x36
+#define HMAC_OPAD         0x5c
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_HAVE_SHA256
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_transform
+ *
+ * Description:
+ *   Process one 64 byte block.
+ *
+ ****************************************************************************/
+
+static void sha256_transform(FAR uint32_t *state, FAR const uint8_t *block)
+{
+  uint32_t w[16];
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  uint32_t f;
+  uint32_t g;
+  uint32_t h;
+  uint32_t t1;
+  uint32_t t2;
+  int i;
+
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+
+  /* The message schedule is kept in a 16 word circular buffer */
+
+  for (i = 0; i < 64; i++)
+    {
+      if (i < 16)
+        {
+          w[i] = (uint32_t)block[4 * i] << 24 |
+                 (uint32_t)block[4 * i + 1] << 16 |
+                 (uint32_t)block[4 * i + 2] << 8 |
+                 (uint32_t)block[4 * i + 3];
+        }
+      else
+        {
+          w[i & 15] += SHA256_G1(w[(i - 2) & 15]) + w[(i - 7) & 15] +
+                       SHA256_G0(w[(i - 15) & 15]);
+        }
+
+      t1 = h + SHA256_S1(e) + SHA256_CH(e, f, g) + g_sha256_k[i] + w[i & 15];
+      t2 = SHA256_S0(a) + SHA256_MAJ(a, b, c);
+      h  = g;
+      g  = f;
+      f  = e;
+      e  = d + t1;
+      d  = c;
+      c  = b;
+      b  = a;
+      a  = t1 + t2;
+    }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+#endif /* !CONFIG_ARCH_HAVE_SHA256 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_HAVE_SHA256
+/****************************************************************************
+ * Name: sha256_init
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_ctx_s *ctx)
+{
+  ctx->state[0] = 0x6a09e667;
+  ctx->state[1] = 0xbb67ae85;
+  ctx->state[2] = 0x3c6ef372;
+  ctx->state[3] = 0xa54ff53a;
+  ctx->state[4] = 0x510e527f;
+  ctx->state[5] = 0x9b05688c;
+  ctx->state[6] = 0x1f83d9ab;
+  ctx->state[7] = 0x5be0cd19;
+  ctx->count    = 0;
+}
+
+/****************************************************************************
+ * Name: sha256_update
+ ****************************************************************************/
+
+void sha256_update(FAR struct sha256_ctx_s *ctx, FAR const void *data,
+                   size_t size)
+{
+  FAR const uint8_t *src = data;
+  size_t used = (size_t)(ctx->count & (SHA256_BLOCKSIZE - 1));
+  size_t nbytes;
+
+  ctx->count += size;
+
+  /* Complete a partial block first */
+
+  if (used > 0)
+    {
+      nbytes = SHA256_BLOCKSIZE - used;
+      if (nbytes > size)
+        {
+          nbytes = size;
+        }
+
+      memcpy(&ctx->buffer[used], src, nbytes);
+      src  += nbytes;
+      size -= nbytes;
+
+      if (used + nbytes < SHA256_BLOCKSIZE)
+        {
+          return;
+        }
+
+      sha256_transform(ctx->state, ctx->buffer);
+    }
+
+  /* Then hash whole blocks directly from the caller's buffer */
+
+  for (; size >= SHA256_BLOCKSIZE; size -= SHA256_BLOCKSIZE)
+    {
+      sha256_transform(ctx->state, src);
+      src += SHA256_BLOCKSIZE;
+    }
+
+  memcpy(ctx->buffer, src, size);
+}
+
+/****************************************************************************
+ * Name: sha256_final
+ ****************************************************************************/
+
+void sha256_final(FAR struct sha256_ctx_s *ctx, FAR uint8_t *digest)
+{
+  uint64_t nbits = ctx->count << 3;
+  size_t used = (size_t)(ctx->count & (SHA256_BLOCKSIZE - 1));
+  int i;
+
+  /* Append the 0x80 terminator, zero padding and the length in bits */
+
+  ctx->buffer[used++] = 0x80;
+  if (used > SHA256_BLOCKSIZE - 8)
+    {
+      memset(&ctx->buffer[used], 0, SHA256_BLOCKSIZE - used);
+      sha256_transform(ctx->state, ctx->buffer);
+      used = 0;
+    }
+
+  memset(&ctx->buffer[used], 0, SHA256_BLOCKSIZE - 8 - used);
+  for (i = 0; i < 8; i++)
+    {
+      ctx->buffer[SHA256_BLOCKSIZE - 1 - i] = (uint8_t)(nbits >> (8 * i));
+    }
+
+  sha256_transform(ctx->state, ctx->buffer);
+
+  for (i = 0; i < 8; i++)
+    {
+      digest[4 * i]     = (uint8_t)(ctx->state[i] >> 24);
+      digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+      digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+      digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+
+  explicit_bzero(ctx, sizeof(struct sha256_ctx_s));
+}
+#endif /* !CONFIG_ARCH_HAVE_SHA256 */
+
+/****************************************************************************
+ * Name: sha256
+ ****************************************************************************/
+
+void sha256(FAR const void *data, size_t size, FAR uint8_t *digest)
+{
+  struct sha256_ctx_s ctx;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, data, size);
+  sha256_final(&ctx, digest);
+}
+
+/****************************************************************************
+ * Name: hmac_sha256_init
+ ****************************************************************************/
+
+void hmac_sha256_init(FAR struct hmac_sha256_ctx_s *ctx, FAR const void *key,
+                      size_t keysize)
+{
+  uint8_t pad[SHA256_BLOCKSIZE];
+  int i;
+
+  memset(pad, 0, SHA256_BLOCKSIZE);
+  if (keysize > SHA256_BLOCKSIZE)
+    {
+      sha256(key, keysize, pad);
+    }
+  else
+    {
+      memcpy(pad, key, keysize);
+    }
+
+  for (i = 0; i < SHA256_BLOCKSIZE; i++)
+    {
+      pad[i] ^= HMAC_IPAD;
+    }
+
+  sha256_init(&ctx->inner);
+  sha256_update(&ctx->inner, pad, SHA256_BLOCKSIZE);
+
+  for (i = 0; i < SHA256_BLOCKSIZE; i++)
+    {
+      pad[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+    }
+
+  sha256_init(&ctx->outer);
+  sha256_update(&ctx->outer, pad, SHA256_BLOCKSIZE);
+
+  explicit_bzero(pad, sizeof(pad));
+}
+
+/****************************************************************************
+ * Name: hmac_sha256_update
+ ****************************************************************************/
+
+void hmac_sha256_update(FAR struct hmac_sha256_ctx_s *ctx,
+                        FAR const void *data, size_t size)
+{
+  sha256_update(&ctx->inner, data, size);
+}
+
+/****************************************************************************
+ * Name: hmac_sha256_final
+ ****************************************************************************/
+
+void hmac_sha256_final(FAR struct hmac_sha256_ctx_s *ctx, FAR uint8_t *mac)
+{
+  uint8_t digest[SHA256_DIGESTSIZE];
+
+  sha256_final(&ctx->inner, digest);
+  sha256_update(&ctx->outer, digest, SHA256_DIGESTSIZE);
+  sha256_final(&ctx->outer, mac);
+
+  explicit_bzero(digest, sizeof(digest));
+}
+
+/****************************************************************************
+ * Name: hmac_sha256
+ ****************************************************************************/
+
+void hmac_sha256(FAR const void *key, size_t keysize, FAR const void *data,
+                 size_t size, FAR uint8_t *mac)
+{
+  struct hmac_sha256_ctx_s ctx;
+
+  hmac_sha256_init(&ctx, key, keysize);
+  hmac_sha256_update(&ctx, data, size);
+  hmac_sha256_final(&ctx, mac);
+}
@@ -43,12 +43,16 @@
 #include <stdbool.h>
 #include <string.h>
 #include <poll.h>
+#include <syslog.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/sha256.h>
+#include <crc32.h>
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -62,12 +66,40 @@
 #  define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #endif
 
-#if defined(CONFIG_CRYPTO_AES)
+#ifndef CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE
+#  define CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE 1024
+#endif
+
+#ifndef CONFIG_CRYPTO_ALGTEST_BENCHMARK_MSEC
+#  define CONFIG_CRYPTO_ALGTEST_BENCHMARK_MSEC 500
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+/****************************************************************************
+ * Name: bench_kibps
+ *
+ * Description:
+ *   Convert a number of bytes processed in 'elapsed' ticks to KiB/s.
+ *
+ ****************************************************************************/
+
+static unsigned long bench_kibps(uint32_t nbytes, systime_t elapsed)
+{
+  if (elapsed == 0)
+    {
+      elapsed = 1;
+    }
+
+  return (unsigned long)((uint64_t)nbytes * TICK_PER_SEC / 1024 / elapsed);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_AES)
+
 static int do_test_aes(FAR struct cipher_testvec *test, int mode, int encrypt)
 {
   FAR void *out = kmm_zalloc(test->rlen);
@@ -119,8 +151,223 @@ static int test_aes(void)
 
   return OK;
 }
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+/****************************************************************************
+ * Name: bench_aes
+ *
+ * Description:
+ *   Measure the throughput of aes_cypher() in place on a buffer of
+ *   CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE bytes for about
+ *   CONFIG_CRYPTO_ALGTEST_BENCHMARK_MSEC milliseconds and report it in
+ *   KiB/s.
+ *
+ ****************************************************************************/
+
+static int bench_aes(FAR uint8_t *buffer, uint32_t keysize, int mode,
+                     FAR const char *mode_str)
+{
+  static const uint8_t key[32] =
+  {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+    0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+    0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+  };
+
+  static const uint8_t iv[16] =
+  {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+  };
+
+  systime_t start;
+  systime_t elapsed;
+  systime_t limit;
+  uint32_t nbytes = 0;
+  int ret;
+
+  limit = MSEC2TICK(CONFIG_CRYPTO_ALGTEST_BENCHMARK_MSEC);
+  start = clock_systimer();
+
+  do
+    {
+      ret = aes_cypher(buffer, buffer, CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE,
+                       iv, key, keysize, mode, CYPHER_ENCRYPT);
+      if (ret < 0)
+        {
+          /* The key size is probably not supported by the hardware */
+
+          return ret;
+        }
+
+      nbytes += CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE;
+      elapsed = clock_systimer() - start;
+    }
+  while (elapsed < limit);
+
+  syslog(LOG_INFO, "crypto: AES-%u %s: %lu KiB/s\n",
+         (unsigned int)keysize * 8, mode_str,
+         bench_kibps(nbytes, elapsed));
+  return OK;
+}
+
+static void bench_aes_all(void)
+{
+  FAR uint8_t *buffer;
+  uint32_t keysize;
+
+  buffer = kmm_zalloc(CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE);
+  if (buffer == NULL)
+    {
+      return;
+    }
+
+  for (keysize = 16; keysize <= 32; keysize += 8)
+    {
+      (void)bench_aes(buffer, keysize, AES_MODE_ECB, "ECB");
+      (void)bench_aes(buffer, keysize, AES_MODE_CBC, "CBC");
+      (void)bench_aes(buffer, keysize, AES_MODE_CTR, "CTR");
+    }
+
+  kmm_free(buffer);
+}
+#endif /* CONFIG_CRYPTO_ALGTEST_BENCHMARK */
+#endif /* CONFIG_CRYPTO_AES */
+
+#ifdef CONFIG_CRYPTO_SHA256
+/****************************************************************************
+ * Name: test_sha256
+ *
+ * Description:
+ *   Check SHA-256 against FIPS 180-2 and HMAC-SHA-256 against RFC 4231.
+ *
+ ****************************************************************************/
+
+static int test_sha256(void)
+{
+  static const uint8_t abc_digest[SHA256_DIGESTSIZE] =
+  {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+  };
+
+  static const uint8_t hmac_mac[SHA256_DIGESTSIZE] =
+  {
+    0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53,
+    0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+    0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7,
+    0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7
+  };
+
+  uint8_t key[20];
+  uint8_t out[SHA256_DIGESTSIZE];
+
+  sha256("abc", 3, out);
+  if (memcmp(out, abc_digest, SHA256_DIGESTSIZE) != 0)
+    {
+      crypterr("ERROR: Failed SHA-256 test\n");
+      return -1;
+    }
+
+  memset(key, 0x0b, sizeof(key));
+  hmac_sha256(key, sizeof(key), "Hi There", 8, out);
+  if (memcmp(out, hmac_mac, SHA256_DIGESTSIZE) != 0)
+    {
+      crypterr("ERROR: Failed HMAC-SHA-256 test\n");
+      return -1;
+    }
+
+  return OK;
+}
+#endif /* CONFIG_CRYPTO_SHA256 */
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+/****************************************************************************
+ * Name: bench_hash
+ *
+ * Description:
+ *   Measure the throughput of the hash and CRC providers that are
+ *   configured, in the same way as bench_aes().
+ *
+ ****************************************************************************/
+
+static void bench_hash(void)
+{
+  FAR uint8_t *buffer;
+  systime_t start;
+  systime_t elapsed;
+  systime_t limit;
+  uint32_t nbytes;
+  uint32_t crc = 0;
+#ifdef CONFIG_CRYPTO_SHA256
+  uint8_t digest[SHA256_DIGESTSIZE];
+  struct hmac_sha256_ctx_s hmac;
+  struct sha256_ctx_s ctx;
 #endif
 
+  buffer = kmm_zalloc(CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE);
+  if (buffer == NULL)
+    {
+      return;
+    }
+
+  limit = MSEC2TICK(CONFIG_CRYPTO_ALGTEST_BENCHMARK_MSEC);
+
+  nbytes = 0;
+  start  = clock_systimer();
+  do
+    {
+      crc     = crc32part(buffer, CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE, crc);
+      nbytes += CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE;
+      elapsed = clock_systimer() - start;
+    }
+  while (elapsed < limit);
+
+  syslog(LOG_INFO, "crypto: CRC32: %lu KiB/s\n",
+         bench_kibps(nbytes, elapsed));
+
+#ifdef CONFIG_CRYPTO_SHA256
+  nbytes = 0;
+  sha256_init(&ctx);
+  start  = clock_systimer();
+  do
+    {
+      sha256_update(&ctx, buffer, CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE);
+      nbytes += CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE;
+      elapsed = clock_systimer() - start;
+    }
+  while (elapsed < limit);
+
+  sha256_final(&ctx, digest);
+  syslog(LOG_INFO, "crypto: SHA-256: %lu KiB/s\n",
+         bench_kibps(nbytes, elapsed));
+
+  /* HMAC of whole buffers, including the per-message key setup */
+
+  nbytes = 0;
+  start  = clock_systimer();
+  do
+    {
+      hmac_sha256_init(&hmac, digest, SHA256_DIGESTSIZE);
+      hmac_sha256_update(&hmac, buffer,
+                         CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE);
+      hmac_sha256_final(&hmac, digest);
+      nbytes += CONFIG_CRYPTO_ALGTEST_BENCHMARK_SIZE;
+      elapsed = clock_systimer() - start;
+    }
+  while (elapsed < limit);
+
+  syslog(LOG_INFO, "crypto: HMAC-SHA-256: %lu KiB/s\n",
+         bench_kibps(nbytes, elapsed));
+#endif
+
+  kmm_free(buffer);
+}
+#endif /* CONFIG_CRYPTO_ALGTEST_BENCHMARK */
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -128,6 +375,21 @@ int crypto_test(void)
     {
       return -1;
     }
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+  bench_aes_all();
+#endif
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+  if (test_sha256())
+    {
+      return -1;
+    }
+#endif
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCHMARK
+  bench_hash();
 #endif
 
   return OK;
@@ -52,18 +52,36 @@
 #include <unistd.h>
 #include <string.h>
 #include <semaphore.h>
+#include <sched.h>
+#include <time.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/analog/adc.h>
+#include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
 
 #include <nuttx/irq.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+#  define adc_streamempty(dev) ((dev)->ad_stream.as_count == 0)
+#  define adc_block(dev,i) \
+     ((FAR struct adc_block_s *) \
+      &(dev)->ad_stream.as_blocks[(i) * ADC_STREAM_BLOCKSIZE])
+#else
+#  define adc_streamempty(dev) true
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -75,6 +93,10 @@ static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+#ifdef CONFIG_ADC_STREAM
+static int     adc_receive_block(FAR struct adc_dev_s *dev,
+                                 FAR const void *data, size_t nbytes);
+#endif
 static void    adc_notify(FAR struct adc_dev_s *dev);
 #ifndef CONFIG_DISABLE_POLL
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup);
@@ -102,7 +124,10 @@ static const struct file_operations g_adc_fops =
 
 static const struct adc_callback_s g_adc_callback =
 {
-  adc_receive   /* au_receive */
+  adc_receive        /* au_receive */
+#ifdef CONFIG_ADC_STREAM
+  , adc_receive_block /* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -156,6 +181,11 @@ static int adc_open(FAR struct file *filep)
 
                   dev->ad_recv.af_head = 0;
                   dev->ad_recv.af_tail = 0;
+                  dev->ad_overruns     = 0;
+#ifdef CONFIG_ADC_STREAM
+                  dev->ad_stream.as_head  = 0;
+                  dev->ad_stream.as_count = 0;
+#endif
 
                   /* Finally, Enable the ADC RX interrupt */
 
@@ -223,6 +253,102 @@ static int adc_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_waitdata
+ *
+ * Description:
+ *   Wait until there is data to read: a stream block or, unless 'stream' is
+ *   true, a message in the receive FIFO.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int adc_waitdata(FAR struct file *filep, FAR struct adc_dev_s *dev,
+                        bool stream)
+{
+  int ret;
+
+  while (adc_streamempty(dev) &&
+         (stream || dev->ad_recv.af_head == dev->ad_recv.af_tail))
+    {
+      /* Nothing to read -- was non-blocking mode selected? */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* Wait for a message or a block to be received */
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: adc_readblocks
+ *
+ * Description:
+ *   Copy as many whole stream blocks as fit in the user buffer.  The copy
+ *   is done with interrupts enabled: the lower half only fills the blocks
+ *   after the filled ones, and the scheduler is locked against other
+ *   readers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static ssize_t adc_readblocks(FAR struct adc_dev_s *dev, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  FAR struct adc_block_s *block;
+  irqstate_t flags;
+  ssize_t nread = 0;
+
+  if (buflen < ADC_STREAM_BLOCKSIZE)
+    {
+      return -EINVAL;
+    }
+
+  sched_lock();
+  while (buflen - nread >= ADC_STREAM_BLOCKSIZE)
+    {
+      flags = enter_critical_section();
+      if (stream->as_count == 0)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      block = adc_block(dev, stream->as_head);
+      leave_critical_section(flags);
+
+      memcpy(&buffer[nread], block, ADC_STREAM_BLOCKSIZE);
+      nread += ADC_STREAM_BLOCKSIZE;
+
+      /* Release the block to the lower half */
+
+      flags = enter_critical_section();
+      if (++stream->as_head >= CONFIG_ADC_STREAM_NBUFFERS)
+        {
+          stream->as_head = 0;
+        }
+
+      stream->as_count--;
+      leave_critical_section(flags);
+    }
+
+  sched_unlock();
+  return nread;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_read
  ****************************************************************************/
@@ -276,26 +402,21 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
       /* Interrupts must be disabled while accessing the ad_recv FIFO */
 
       flags = enter_critical_section();
-      while (dev->ad_recv.af_head == dev->ad_recv.af_tail)
+      ret = adc_waitdata(filep, dev, false);
+      if (ret < 0)
         {
-          /* The receive FIFO is empty -- was non-blocking mode selected? */
-
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              ret = -EAGAIN;
-              goto return_with_irqdisabled;
-            }
+          goto return_with_irqdisabled;
+        }
 
-          /* Wait for a message to be received */
+#ifdef CONFIG_ADC_STREAM
+      /* Return whole stream blocks if there are any */
 
-          dev->ad_nrxwaiters++;
-          ret = nxsem_wait(&dev->ad_recv.af_sem);
-          dev->ad_nrxwaiters--;
-          if (ret < 0)
-            {
-              goto return_with_irqdisabled;
-            }
+      if (!adc_streamempty(dev))
+        {
+          leave_critical_section(flags);
+          return adc_readblocks(dev, buffer, buflen);
         }
+#endif
 
       /* The ad_recv FIFO is not empty.  Copy all buffered data that will fit
        * in the user buffer.
@@ -410,9 +531,80 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct adc_dev_s *dev = inode->i_private;
-  int ret;
+  irqstate_t flags;
+  int ret = OK;
+
+  switch (cmd)
+    {
+      case ANIOC_GET_OVERRUNS:
+        {
+          FAR uint32_t *overruns = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (overruns == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          flags            = enter_critical_section();
+          *overruns        = dev->ad_overruns;
+          dev->ad_overruns = 0;
+          leave_critical_section(flags);
+        }
+        break;
+
+#ifdef CONFIG_ADC_STREAM
+      /* Return the oldest stream block in place.  The blocks are allocated
+       * from the user heap, so that they can be used without a copy.
+       */
+
+      case ANIOC_STREAM_GET:
+        {
+          FAR struct adc_block_s **block =
+            (FAR struct adc_block_s **)((uintptr_t)arg);
+
+          if (block == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          flags = enter_critical_section();
+          ret   = adc_waitdata(filep, dev, true);
+          if (ret >= 0)
+            {
+              *block = adc_block(dev, dev->ad_stream.as_head);
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      case ANIOC_STREAM_RELEASE:
+        flags = enter_critical_section();
+        if (dev->ad_stream.as_count == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            if (++dev->ad_stream.as_head >= CONFIG_ADC_STREAM_NBUFFERS)
+              {
+                dev->ad_stream.as_head = 0;
+              }
+
+            dev->ad_stream.as_count--;
+          }
+
+        leave_critical_section(flags);
+        break;
+#endif
+
+      default:
+        ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+        break;
+    }
 
-  ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
   return ret;
 }
 
@@ -453,10 +645,67 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
 
       errcode = OK;
     }
+  else
+    {
+      dev->ad_overruns++;
+    }
 
   return errcode;
 }
 
+/****************************************************************************
+ * Name: adc_receive_block
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static int adc_receive_block(FAR struct adc_dev_s *dev,
+                             FAR const void *data, size_t nbytes)
+{
+  FAR struct adc_stream_s *stream = &dev->ad_stream;
+  FAR struct adc_block_s *block;
+  struct timespec ts;
+  int tail;
+
+  /* Drop the block if the reader has not released the older ones.  The
+   * sequence number still advances so that the reader sees the gap.
+   */
+
+  if (stream->as_count >= CONFIG_ADC_STREAM_NBUFFERS)
+    {
+      stream->as_sequence++;
+      dev->ad_overruns++;
+      return -ENOMEM;
+    }
+
+  tail = stream->as_head + stream->as_count;
+  if (tail >= CONFIG_ADC_STREAM_NBUFFERS)
+    {
+      tail -= CONFIG_ADC_STREAM_NBUFFERS;
+    }
+
+  if (nbytes > CONFIG_ADC_STREAM_BUFSIZE)
+    {
+      nbytes = CONFIG_ADC_STREAM_BUFSIZE;
+    }
+
+  (void)clock_systimespec(&ts);
+
+  block               = adc_block(dev, tail);
+  block->ab_timestamp = (uint64_t)ts.tv_sec * USEC_PER_SEC +
+                        ts.tv_nsec / NSEC_PER_USEC;
+  block->ab_sequence  = stream->as_sequence++;
+  block->ab_nbytes    = nbytes;
+  memcpy(block + 1, data, nbytes);
+
+  stream->as_count++;
+
+  /* One wake-up for the whole block */
+
+  adc_notify(dev);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_pollnotify
  ****************************************************************************/
@@ -560,7 +809,8 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (dev->ad_recv.af_head != dev->ad_recv.af_tail ||
+          !adc_streamempty(dev))
         {
           adc_pollnotify(dev, POLLIN);
         }
@@ -611,6 +861,21 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
 
   dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_STREAM
+  /* Allocate the stream blocks from the user heap so that ANIOC_STREAM_GET
+   * can hand them to the application in place.
+   */
+
+  memset(&dev->ad_stream, 0, sizeof(struct adc_stream_s));
+  dev->ad_stream.as_blocks = (FAR uint8_t *)
+    kumm_malloc(CONFIG_ADC_STREAM_NBUFFERS * ADC_STREAM_BLOCKSIZE);
+  if (dev->ad_stream.as_blocks == NULL)
+    {
+      aerr("ERROR: Failed to allocate stream blocks\n");
+      return -ENOMEM;
+    }
+#endif
+
   /* Initialize semaphores */
 
   nxsem_init(&dev->ad_recv.af_sem, 0, 0);
@@ -634,6 +899,10 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
     {
       nxsem_destroy(&dev->ad_recv.af_sem);
       nxsem_destroy(&dev->ad_closesem);
+#ifdef CONFIG_ADC_STREAM
+      kumm_free(dev->ad_stream.as_blocks);
+      dev->ad_stream.as_blocks = NULL;
+#endif
     }
 
   return ret;
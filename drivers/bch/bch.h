@@ -52,9 +52,19 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_BCH_NSECTORS
+#  define CONFIG_BCH_NSECTORS 1
+#endif
+
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Return the address of a sector in the sector cache.  The sector must have
+ * been loaded with bchlib_readsector().
+ */
+
+#define bchlib_sectbuf(b,s) (&(b)->buffer[((s) - (b)->sector) * (b)->sectsize])
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -64,13 +74,17 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the buffer */
+  uint16_t cachesects;     /* Capacity of the buffer in sectors */
+  uint16_t nvalid;         /* Number of valid sectors in the buffer */
+  uint16_t dirtyfirst;     /* First modified sector (relative to 'sector') */
+  uint16_t dirtylast;      /* Last modified sector (relative to 'sector') */
   sem_t sem;               /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Sector cache (cachesects sectors) */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -98,6 +112,9 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_markdirty(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_updatecache(FAR struct bchlib_s *bch,
+              FAR const uint8_t *buffer, size_t sector, size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
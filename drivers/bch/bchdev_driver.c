@@ -82,6 +82,12 @@ static int     bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     bch_unlink(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FS_VECTORED_IO
+static ssize_t bch_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                 int iovcnt);
+static ssize_t bch_writev(FAR struct file *filep,
+                 FAR const struct iovec *iov, int iovcnt);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -101,6 +107,10 @@ const struct file_operations bch_fops =
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , bch_unlink /* unlink */
 #endif
+#ifdef CONFIG_FS_VECTORED_IO
+  , bch_readv  /* readv */
+  , bch_writev /* writev */
+#endif
 };
 
 /****************************************************************************
@@ -341,6 +351,103 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer, size_t
   return ret;
 }
 
+/****************************************************************************
+ * Name: bch_readv
+ *
+ * Description:
+ *   Read into each element of the I/O vector while holding the BCH
+ *   semaphore only once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_VECTORED_IO
+static ssize_t bch_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                         int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t ntotal = 0;
+  ssize_t ret = 0;
+  int i;
+
+  DEBUGASSERT(inode && inode->i_private);
+  bch = (FAR struct bchlib_s *)inode->i_private;
+
+  bchlib_semtake(bch);
+  for (i = 0; i < iovcnt; i++)
+    {
+      ret = bchlib_read(bch, (FAR char *)iov[i].iov_base, filep->f_pos,
+                        iov[i].iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      /* Stop at the end of the device */
+
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  bchlib_semgive(bch);
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: bch_writev
+ *
+ * Description:
+ *   Write each element of the I/O vector while holding the BCH semaphore
+ *   only once.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t ntotal = 0;
+  ssize_t ret = 0;
+  int i;
+
+  DEBUGASSERT(inode && inode->i_private);
+  bch = (FAR struct bchlib_s *)inode->i_private;
+
+  if (bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  bchlib_semtake(bch);
+  for (i = 0; i < iovcnt; i++)
+    {
+      ret = bchlib_write(bch, (FAR const char *)iov[i].iov_base,
+                         filep->f_pos, iov[i].iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      ntotal       += ret;
+
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  bchlib_semgive(bch);
+  return ntotal > 0 ? ntotal : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: bch_ioctl
  *
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -71,13 +72,17 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 
 /****************************************************************************
  * Name: bch_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt one sector in the sector cache.
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)bchlib_sectbuf(bch, sector);
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -85,7 +90,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -111,7 +116,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the modified sectors in the sector cache (if any) to the media
+ *   with one transfer.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -122,6 +128,11 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
   ssize_t ret = OK;
+  size_t first;
+  size_t count;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t i;
+#endif
 
   /* Check if the sector has been modified and is out of synch with the
    * media.
@@ -130,19 +141,25 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
   if (bch->dirty)
     {
       inode = bch->inode;
+      first = bch->sector + bch->dirtyfirst;
+      count = bch->dirtylast - bch->dirtyfirst + 1;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      for (i = 0; i < count; i++)
+        {
+          bch_cypher(bch, first + i, CYPHER_ENCRYPT);
+        }
 #endif
 
-      /* Write the sector to the media */
+      /* Write the modified sectors to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, bchlib_sectbuf(bch, first),
+                                   first, count);
       if (ret < 0)
         {
-          ferr("Write failed: %d\n");
+          ferr("Write failed: %d\n", (int)ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -150,7 +167,10 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      for (i = 0; i < count; i++)
+        {
+          bch_cypher(bch, first + i, CYPHER_DECRYPT);
+        }
 #endif
 
       /* The sector is now in sync with the media */
@@ -165,7 +185,9 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that 'sector' is in the sector cache.  If it is not, then
+ *   flush the cache and refill it with up to 'cachesects' sectors starting
+ *   at 'sector' in one transfer.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -176,24 +198,119 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
   ssize_t ret = OK;
+  size_t nsectors;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  size_t i;
+#endif
 
-  if (bch->sector != sector)
+  if (sector < bch->sector || sector >= bch->sector + bch->nvalid)
     {
       inode = bch->inode;
 
       (void)bchlib_flushsector(bch);
       bch->sector = (size_t)-1;
+      bch->nvalid = 0;
+
+      /* Read ahead as many sectors as the cache holds */
+
+      nsectors = bch->cachesects;
+      if (sector + nsectors > bch->nsectors)
+        {
+          nsectors = bch->nsectors - sector;
+        }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = inode->u.i_bops->read(inode, bch->buffer, sector, nsectors);
       if (ret < 0)
         {
-          ferr("Read failed: %d\n");
+          ferr("Read failed: %d\n", (int)ret);
+          return (int)ret;
         }
+
       bch->sector = sector;
+      bch->nvalid = nsectors;
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      for (i = 0; i < nsectors; i++)
+        {
+          bch_cypher(bch, sector + i, CYPHER_DECRYPT);
+        }
 #endif
+
+      ret = OK;
     }
+
   return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_markdirty
+ *
+ * Description:
+ *   Record that a sector in the sector cache has been modified.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion.  The sector is in the cache.
+ *
+ ****************************************************************************/
+
+void bchlib_markdirty(FAR struct bchlib_s *bch, size_t sector)
+{
+  uint16_t index = sector - bch->sector;
+
+  DEBUGASSERT(sector >= bch->sector && index < bch->nvalid);
+
+  if (!bch->dirty)
+    {
+      bch->dirtyfirst = index;
+      bch->dirtylast  = index;
+      bch->dirty      = true;
+    }
+  else if (index < bch->dirtyfirst)
+    {
+      bch->dirtyfirst = index;
+    }
+  else if (index > bch->dirtylast)
+    {
+      bch->dirtylast = index;
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_updatecache
+ *
+ * Description:
+ *   Sectors were written directly to the media.  Copy the new data into
+ *   any of those sectors that are also in the sector cache.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion.  The copies in the cache are not
+ *   dirty.
+ *
+ ****************************************************************************/
+
+void bchlib_updatecache(FAR struct bchlib_s *bch, FAR const uint8_t *buffer,
+                        size_t sector, size_t nsectors)
+{
+  size_t first;
+  size_t last;
+
+  if (bch->nvalid == 0)
+    {
+      return;
+    }
+
+  first = sector > bch->sector ? sector : bch->sector;
+  last  = sector + nsectors;
+  if (last > bch->sector + bch->nvalid)
+    {
+      last = bch->sector + bch->nvalid;
+    }
+
+  if (first < last)
+    {
+      memcpy(bchlib_sectbuf(bch, first),
+             &buffer[(first - sector) * bch->sectsize],
+             (last - first) * bch->sectsize);
+    }
+}
+
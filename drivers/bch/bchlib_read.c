@@ -75,12 +75,18 @@
  *   Read from the block device set-up by bchlib_setup as if it were a character
  *   device.
  *
+ *   Aligned spans of at least a full cache of sectors are read directly into
+ *   the user buffer with one transfer.  Everything else is copied from the
+ *   sector cache, which reads ahead as it is refilled.
+ *
  ****************************************************************************/
 
 ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+#ifndef CONFIG_BCH_ENCRYPTION
   size_t   nsectors;
+#endif
   size_t   sector;
   uint16_t sectoffset;
   size_t   nbytes;
@@ -106,92 +112,73 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       return 0;
     }
 
-  /* Read the initial partial sector */
+  /* Loop until all of the data has been read or the end of the device is
+   * reached.
+   */
 
   bytesread = 0;
-  if (sectoffset > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the sector into the sector buffer */
-
-      bchlib_readsector(bch, sector);
-
-      /* Copy the tail end of the sector to the user buffer */
-
-      if (sectoffset + len > bch->sectsize)
+#ifndef CONFIG_BCH_ENCRYPTION
+      if (sectoffset == 0 && len >= bch->cachesects * bch->sectsize)
         {
-          nbytes = bch->sectsize - sectoffset;
+          /* Read the full sectors directly into the user buffer */
+
+          nsectors = len / bch->sectsize;
+          if (sector + nsectors > bch->nsectors)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+
+          /* Make sure that the media holds any modified cached data */
+
+          ret = bchlib_flushsector(bch);
+          if (ret >= 0)
+            {
+              ret = bch->inode->u.i_bops->read(bch->inode,
+                                               (FAR uint8_t *)buffer,
+                                               sector, nsectors);
+            }
+
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
+
+          nbytes = nsectors * bch->sectsize;
         }
       else
+#endif
         {
-          nbytes = len;
-        }
-
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
-
-      /* Adjust pointers and counts */
-
-      sector++;
-
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
+          /* Load the sector into the sector cache */
 
-      bytesread  = nbytes;
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
+          ret = bchlib_readsector(bch, sector);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
-   */
+          /* Copy as much as is available in the cache to the user buffer */
 
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
+          nbytes = (bch->sector + bch->nvalid - sector) * bch->sectsize -
+                   sectoffset;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
-        {
-          ferr("ERROR: Read failed: %d\n");
-          return ret;
+          memcpy(buffer, bchlib_sectbuf(bch, sector) + sectoffset, nbytes);
         }
 
       /* Adjust pointers and counts */
 
-      sector    += nsectors;
-      nbytes     = nsectors * bch->sectsize;
-      bytesread += nbytes;
-
-      if (sector >= bch->nsectors)
-        {
-          return bytesread;
-        }
-
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then read any partial final sector */
-
-  if (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      bchlib_readsector(bch, sector);
-
-      /* Copy the head end of the sector to the user buffer */
-
-      memcpy(buffer, bch->buffer, len);
-
-      /* Adjust counts */
-
-      bytesread += len;
+      sector     += (sectoffset + nbytes) / bch->sectsize;
+      sectoffset  = 0;
+      bytesread  += nbytes;
+      buffer     += nbytes;
+      len        -= nbytes;
     }
 
   return bytesread;
@@ -124,9 +124,23 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  /* Allocate the sector cache.  Fall back to a single sector if there is
+   * not enough memory for the configured cache size.
+   */
+
+  bch->cachesects = CONFIG_BCH_NSECTORS;
+  if (bch->cachesects > bch->nsectors)
+    {
+      bch->cachesects = bch->nsectors > 0 ? bch->nsectors : 1;
+    }
+
+  bch->buffer = (FAR uint8_t *)kmm_malloc(bch->cachesects * bch->sectsize);
+  if (!bch->buffer && bch->cachesects > 1)
+    {
+      bch->cachesects = 1;
+      bch->buffer     = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+    }
 
-  bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
   if (!bch->buffer)
     {
       ferr("ERROR: Failed to allocate sector buffer\n");
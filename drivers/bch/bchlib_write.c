@@ -62,14 +62,21 @@
  *   Write to the block device set-up by bchlib_setup as if it were a character
  *   device.
  *
+ *   Aligned, full sectors are written directly from the user buffer with
+ *   one transfer.  Partial sectors are modified in the sector cache and the
+ *   modified sectors are written back with one transfer before returning.
+ *
  ****************************************************************************/
 
 ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
         size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+#ifndef CONFIG_BCH_ENCRYPTION
   size_t   nsectors;
+#endif
   size_t   sector;
+  size_t   last;
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   byteswritten;
@@ -92,96 +99,85 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       return -EFBIG;
     }
 
-  /* Write the initial partial sector */
+  /* Loop until all of the data has been written or the end of the device
+   * is reached.
+   */
 
   byteswritten = 0;
-  if (sectoffset > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the full sector into the sector buffer */
-
-      bchlib_readsector(bch, sector);
-
-      /* Copy the tail end of the sector from the user buffer */
-
-      if (sectoffset + len > bch->sectsize)
+#ifndef CONFIG_BCH_ENCRYPTION
+      if (sectoffset == 0 && len >= bch->sectsize)
         {
-          nbytes = bch->sectsize - sectoffset;
+          /* Write the contiguous full sectors directly from the user
+           * buffer.
+           */
+
+          nsectors = len / bch->sectsize;
+          if (sector + nsectors > bch->nsectors)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+
+          /* Write any modified cached data first so that it cannot later
+           * overwrite this data.
+           */
+
+          ret = bchlib_flushsector(bch);
+          if (ret >= 0)
+            {
+              ret = bch->inode->u.i_bops->write(bch->inode,
+                                                (FAR uint8_t *)buffer,
+                                                sector, nsectors);
+            }
+
+          if (ret < 0)
+            {
+              ferr("ERROR: Write failed: %d\n", ret);
+              return ret;
+            }
+
+          /* Keep any cached copies of those sectors coherent */
+
+          bchlib_updatecache(bch, (FAR const uint8_t *)buffer, sector,
+                             nsectors);
+          nbytes = nsectors * bch->sectsize;
         }
       else
+#endif
         {
-          nbytes = len;
-        }
+          /* Read the full sector into the sector cache */
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+          ret = bchlib_readsector(bch, sector);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
 
-      /* Adjust pointers and counts */
+          /* Modify as much as is available in the cache */
 
-      sector++;
+          nbytes = (bch->sector + bch->nvalid - sector) * bch->sectsize -
+                   sectoffset;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
 
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
+          memcpy(bchlib_sectbuf(bch, sector) + sectoffset, buffer, nbytes);
 
-      byteswritten  = nbytes;
-      buffer       += nbytes;
-      len          -= nbytes;
-    }
-
-  /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
-   */
-
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
-
-      /* Write the contiguous sectors */
-
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
-      if (ret < 0)
-        {
-          ferr("ERROR: Write failed: %d\n", ret);
-          return ret;
+          last = sector + (sectoffset + nbytes - 1) / bch->sectsize;
+          bchlib_markdirty(bch, sector);
+          bchlib_markdirty(bch, last);
         }
 
       /* Adjust pointers and counts */
 
-      sector       += nsectors;
-      nbytes        = nsectors * bch->sectsize;
+      sector       += (sectoffset + nbytes) / bch->sectsize;
+      sectoffset    = 0;
       byteswritten += nbytes;
-
-      if (sector >= bch->nsectors)
-        {
-          return byteswritten;
-        }
-
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then write any partial final sector */
-
-  if (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      bchlib_readsector(bch, sector);
-
-      /* Copy the head end of the sector from the user buffer */
-
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
-
-      /* Adjust counts */
-
-      byteswritten += len;
+      buffer       += nbytes;
+      len          -= nbytes;
     }
 
   /* Finally, flush any cached writes to the device as well */
@@ -195,4 +191,3 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
   return byteswritten;
 }
-
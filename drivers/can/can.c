@@ -56,6 +56,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
@@ -1201,6 +1202,9 @@ int can_register(FAR const char *path, FAR struct can_dev_s *dev)
  * Description:
  *   Called from the CAN interrupt handler when new read data is available
  *
+ *   If CONFIG_CAN_TIMESTAMP is enabled, the ch_ts field of the header is
+ *   set to the current system time here.
+ *
  * Input Parameters:
  *   dev  - CAN driver state structure
  *   hdr  - CAN message header
@@ -1225,6 +1229,18 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
   caninfo("ID: %d DLC: %d\n", hdr->ch_id, hdr->ch_dlc);
 
+#ifdef CONFIG_CAN_TIMESTAMP
+  /* Stamp the message with the time of its reception */
+
+  {
+    struct timespec ts;
+
+    (void)clock_systimespec(&ts);
+    hdr->ch_ts.tv_sec  = ts.tv_sec;
+    hdr->ch_ts.tv_usec = ts.tv_nsec / 1000;
+  }
+#endif
+
   /* Check if adding this new message would over-run the drivers ability to
    * enqueue read data.
    */
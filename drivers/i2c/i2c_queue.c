@@ -0,0 +1,271 @@
+/****************************************************************************
+ * drivers/i2c/i2c_queue.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The transfer queue of one I2C bus */
+
+struct i2c_queue_s
+{
+  FAR struct i2c_master_s *dev;       /* The lower half */
+  sem_t waitsem;                      /* Counts submitted requests */
+  sq_queue_t pending;                 /* Requests not yet started */
+  pid_t pid;                          /* The queue thread */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_thread
+ *
+ * Description:
+ *   Perform the queued transfers of one bus, one at a time.
+ *
+ ****************************************************************************/
+
+static int i2c_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct i2c_queue_s *queue;
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(argc > 1);
+  queue = (FAR struct i2c_queue_s *)(uintptr_t)strtoul(argv[1], NULL, 16);
+
+  for (; ; )
+    {
+      ret = nxsem_wait(&queue->waitsem);
+      if (ret < 0)
+        {
+          DEBUGASSERT(ret == -EINTR);
+          continue;
+        }
+
+      /* The request may have been cancelled since it was counted */
+
+      flags = enter_critical_section();
+      req   = (FAR struct i2c_request_s *)sq_remfirst(&queue->pending);
+      leave_critical_section(flags);
+
+      if (req == NULL)
+        {
+          continue;
+        }
+
+      ret = I2C_TRANSFER(queue->dev, req->msgs, req->count);
+      if (ret < 0)
+        {
+          i2cerr("ERROR: I2C_TRANSFER failed: %d\n", ret);
+        }
+
+      if (req->callback != NULL)
+        {
+          req->callback(req, ret);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Create the transfer queue of one I2C bus and start the kernel thread
+ *   that performs the queued transfers in order of submission.
+ *
+ * Input Parameters:
+ *   dev - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *dev)
+{
+  FAR struct i2c_queue_s *queue;
+  FAR char *argv[2];
+  char arg1[16];
+
+  DEBUGASSERT(dev != NULL);
+
+  queue = (FAR struct i2c_queue_s *)kmm_zalloc(sizeof(struct i2c_queue_s));
+  if (queue == NULL)
+    {
+      i2cerr("ERROR: Failed to allocate the queue\n");
+      return NULL;
+    }
+
+  queue->dev = dev;
+  sq_init(&queue->pending);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&queue->waitsem, 0, 0);
+  nxsem_setprotocol(&queue->waitsem, SEM_PRIO_NONE);
+
+  snprintf(arg1, sizeof(arg1), "%lx", (unsigned long)((uintptr_t)queue));
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  queue->pid = kthread_create("i2cqueue", CONFIG_I2C_QUEUE_PRIORITY,
+                              CONFIG_I2C_QUEUE_STACKSIZE,
+                              (main_t)i2c_queue_thread,
+                              (FAR char * const *)argv);
+  if (queue->pid < 0)
+    {
+      i2cerr("ERROR: Failed to start the queue thread: %d\n", queue->pid);
+      nxsem_destroy(&queue->waitsem);
+      kmm_free(queue);
+      return NULL;
+    }
+
+  return queue;
+}
+
+/****************************************************************************
+ * Name: i2c_submit
+ *
+ * Description:
+ *   Queue a transfer and return immediately.  May be called from interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - The request to queue
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_submit(FAR struct i2c_queue_s *queue, FAR struct i2c_request_s *req)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  if (req->msgs == NULL || req->count <= 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  sq_addlast(&req->node, &queue->pending);
+  leave_critical_section(flags);
+
+  return nxsem_post(&queue->waitsem);
+}
+
+/****************************************************************************
+ * Name: i2c_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - The request passed to i2c_submit()
+ *
+ * Returned Value:
+ *   0 if the request was removed; -EBUSY if it has already been started
+ *   (or was never queued).
+ *
+ ****************************************************************************/
+
+int i2c_cancel(FAR struct i2c_queue_s *queue, FAR struct i2c_request_s *req)
+{
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  /* The count in waitsem is left as it is; the queue thread ignores the
+   * extra wake-up.
+   */
+
+  flags = enter_critical_section();
+
+  for (node = sq_peek(&queue->pending); node != NULL; node = sq_next(node))
+    {
+      if (node == &req->node)
+        {
+          sq_rem(node, &queue->pending);
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_I2C_QUEUE */
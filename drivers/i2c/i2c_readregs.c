@@ -0,0 +1,150 @@
+/****************************************************************************
+ * drivers/i2c/i2c_readregs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_regmsgs
+ *
+ * Description:
+ *   Format the messages that read a list of registers: for each register,
+ *   a write of the register address followed by a restarted read.
+ *
+ * Input Parameters:
+ *   config - Described the I2C configuration
+ *   regs   - The registers to read
+ *   nregs  - The number of registers in the list
+ *   msgs   - Receives 2 * nregs messages
+ *
+ * Returned Value:
+ *   The number of messages formatted (2 * nregs)
+ *
+ ****************************************************************************/
+
+int i2c_regmsgs(FAR const struct i2c_config_s *config,
+                FAR const struct i2c_regread_s *regs, int nregs,
+                FAR struct i2c_msg_s *msgs)
+{
+  FAR struct i2c_msg_s *msg = msgs;
+  unsigned int flags;
+  int i;
+
+  /* 7- or 10-bit address? */
+
+  DEBUGASSERT(config->addrlen == 10 || config->addrlen == 7);
+  flags = (config->addrlen == 10) ? I2C_M_TEN : 0;
+
+  for (i = 0; i < nregs; i++, regs++)
+    {
+      /* Write the register address ... */
+
+      msg->frequency = config->frequency;
+      msg->addr      = config->address;
+      msg->flags     = flags;
+      msg->buffer    = (FAR uint8_t *)&regs->regaddr;  /* Override const */
+      msg->length    = 1;
+      msg++;
+
+      /* ... then restart and read the value(s) */
+
+      msg->frequency = config->frequency;
+      msg->addr      = config->address;
+      msg->flags     = flags | I2C_M_READ;
+      msg->buffer    = regs->buffer;
+      msg->length    = regs->length;
+      msg++;
+    }
+
+  return msg - msgs;
+}
+
+/****************************************************************************
+ * Name: i2c_readregs
+ *
+ * Description:
+ *   Read a list of registers with one I2C transfer per I2C_READREGS_NMAX
+ *   registers.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   config - Described the I2C configuration
+ *   regs   - The registers to read
+ *   nregs  - The number of registers in the list
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_readregs(FAR struct i2c_master_s *dev,
+                 FAR const struct i2c_config_s *config,
+                 FAR const struct i2c_regread_s *regs, int nregs)
+{
+  struct i2c_msg_s msgs[2 * I2C_READREGS_NMAX];
+  int nmsgs;
+  int n;
+  int ret;
+
+  DEBUGASSERT(dev != NULL && regs != NULL);
+
+  while (nregs > 0)
+    {
+      n     = nregs > I2C_READREGS_NMAX ? I2C_READREGS_NMAX : nregs;
+      nmsgs = i2c_regmsgs(config, regs, n, msgs);
+
+      ret = I2C_TRANSFER(dev, msgs, nmsgs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      regs  += n;
+      nregs -= n;
+    }
+
+  return OK;
+}
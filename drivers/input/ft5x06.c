@@ -65,9 +65,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
-#include <fcntl.h>
 #include <semaphore.h>
-#include <poll.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -75,7 +73,6 @@
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/arch.h>
-#include <nuttx/fs/fs.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/wdog.h>
@@ -106,6 +103,16 @@
 #define POLL_MAXDELAY  MSEC2TICK(200)
 #define POLL_INCREMENT MSEC2TICK(10)
 
+/* Number of touch samples buffered by the upper half */
+
+#define FT5X06_NSAMPLES 8
+
+#ifdef CONFIG_FT5X06_SINGLEPOINT
+#  define FT5X06_MAXPOINTS 1
+#else
+#  define FT5X06_MAXPOINTS FT5x06_MAX_TOUCHES
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -114,10 +121,8 @@
 
 struct ft5x06_dev_s
 {
-  uint8_t crefs;                            /* Number of times the device
-                                             * has been opened */
-  uint8_t nwaiters;                         /* Number of threads waiting for
-                                             * FT5x06 data */
+  struct touch_lowerhalf_s lower;           /* Touchscreen lower half (must
+                                             * be first) */
   volatile bool valid;                      /* True:  New, valid touch data in
                                              * touchbuf[] */
 #ifdef CONFIG_FT5X06_SINGLEPOINT
@@ -128,8 +133,6 @@ struct ft5x06_dev_s
 #endif
   sem_t devsem;                             /* Manages exclusive access to this
                                              * structure */
-  sem_t waitsem;                            /* Used to wait for the
-                                             * availability of data */
   uint32_t frequency;                       /* Current I2C frequency */
 #ifdef CONFIG_FT5X06_POLLMODE
   uint32_t delay;                           /* Current poll delay */
@@ -143,22 +146,12 @@ struct ft5x06_dev_s
   WDOG_ID polltimer;                        /* Poll timer */
 #endif
   uint8_t touchbuf[FT5x06_TOUCH_DATA_LEN];  /* Raw touch data */
-
-#ifndef CONFIG_DISABLE_POLL
-  /* The following is a list if poll structures of threads waiting for
-   * driver events. The 'struct pollfd' reference for each open is also
-   * retained in the f_priv field of the 'struct file'.
-   */
-
-  struct pollfd *fds[CONFIG_FT5X06_NPOLLWAITERS];
-#endif
 };
 
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static void ft5x06_notify(FAR struct ft5x06_dev_s *priv);
 static void ft5x06_data_worker(FAR void *arg);
 #ifdef CONFIG_FT5X06_POLLMODE
 static void ft5x06_poll_timeout(int argc, wdparm_t arg1, ...);
@@ -167,44 +160,27 @@ static int  ft5x06_data_interrupt(int irq, FAR void *context, FAR void *arg);
 #endif
 static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
                              size_t len);
-static ssize_t ft5x06_waitsample(FAR struct ft5x06_dev_s *priv,
-                                 FAR char *buffer, size_t len);
 static int  ft5x06_bringup(FAR struct ft5x06_dev_s *priv);
 static void ft5x06_shutdown(FAR struct ft5x06_dev_s *priv);
 
-/* Character driver methods */
-
-static int  ft5x06_open(FAR struct file *filep);
-static int  ft5x06_close(FAR struct file *filep);
-static ssize_t ft5x06_read(FAR struct file *filep, FAR char *buffer,
-                           size_t len);
-static int  ft5x06_ioctl(FAR struct file *filep, int cmd,
-                         unsigned long arg);
-#ifndef CONFIG_DISABLE_POLL
-static int  ft5x06_poll(FAR struct file *filep, struct pollfd *fds,
-                        bool setup);
-#endif
+/* Touchscreen lower half methods */
+
+static int  ft5x06_open(FAR struct touch_lowerhalf_s *lower);
+static int  ft5x06_close(FAR struct touch_lowerhalf_s *lower);
+static int  ft5x06_control(FAR struct touch_lowerhalf_s *lower, int cmd,
+                           unsigned long arg);
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* This the vtable that supports the character driver interface */
+/* This the vtable that supports the touchscreen upper half */
 
-static const struct file_operations ft5x06_fops =
+static const struct touch_ops_s g_ft5x06_ops =
 {
   ft5x06_open,    /* open */
   ft5x06_close,   /* close */
-  ft5x06_read,    /* read */
-  NULL,           /* write */
-  NULL,           /* seek */
-  ft5x06_ioctl    /* ioctl */
-#ifndef CONFIG_DISABLE_POLL
-  , ft5x06_poll   /* poll */
-#endif
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , NULL          /* unlink */
-#endif
+  ft5x06_control  /* control */
 };
 
 /* Maps FT5x06 touch events into bit encoded representation used by NuttX */
@@ -221,49 +197,6 @@ static const uint8_t g_event_map[4] =
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: ft5x06_notify
- ****************************************************************************/
-
-static void ft5x06_notify(FAR struct ft5x06_dev_s *priv)
-{
-#ifndef CONFIG_DISABLE_POLL
-  int i;
-#endif
-
-  /* If there are threads waiting for read data, then signal one of them
-   * that the read data is available.
-   */
-
-  if (priv->nwaiters > 0)
-    {
-      /* After posting this semaphore, we need to exit because the FT5x06
-       * is no longer available.
-       */
-
-      nxsem_post(&priv->waitsem);
-    }
-
-#ifndef CONFIG_DISABLE_POLL
-  /* If there are threads waiting on poll() for FT5x06 data to become available,
-   * then wake them up now.  NOTE: we wake up all waiting threads because we
-   * do not know that they are going to do.  If they all try to read the data,
-   * then some make end up blocking after all.
-   */
-
-  for (i = 0; i < CONFIG_FT5X06_NPOLLWAITERS; i++)
-    {
-      struct pollfd *fds = priv->fds[i];
-      if (fds)
-        {
-          fds->revents |= POLLIN;
-          iinfo("Report events: %02x\n", fds->revents);
-          nxsem_post(fds->sem);
-        }
-    }
-#endif
-}
-
 /****************************************************************************
  * Name: ft5x06_data_worker
  ****************************************************************************/
@@ -274,6 +207,8 @@ static void ft5x06_data_worker(FAR void *arg)
   FAR const struct ft5x06_config_s *config;
   FAR struct ft5x06_touch_data_s *sample;
   struct i2c_msg_s msg[2];
+  uint32_t report[(SIZEOF_TOUCH_SAMPLE_S(FT5X06_MAXPOINTS) + 3) / 4];
+  ssize_t nbytes = 0;
   uint8_t regaddr;
   int ret;
 
@@ -328,19 +263,15 @@ static void ft5x06_data_worker(FAR void *arg)
 
       sample = (FAR struct ft5x06_touch_data_s *)priv->touchbuf;
 
-      /* Notify waiters (only if we ready some valid data).
-       *
-       * REVISIT: For improved performance consider moving the duplicate
-       * report and thresholding logic from ft5x06_sample() to here.  That
-       * would save a context switch.
+      /* Decode the touch data (only if we read some valid data).  The
+       * duplicate report and thresholding logic in ft5x06_sample() drops
+       * samples without new information.
        */
 
       if (sample->tdstatus <= FT5x06_MAX_TOUCHES)
         {
-          /* Notify any waiters that new FT5x06 data is available */
-
           priv->valid = true;
-          ft5x06_notify(priv);
+          nbytes = ft5x06_sample(priv, (FAR char *)report, sizeof(report));
         }
 
 #ifdef CONFIG_FT5X06_POLLMODE
@@ -375,6 +306,16 @@ static void ft5x06_data_worker(FAR void *arg)
 #endif
 
   nxsem_post(&priv->devsem);
+
+  /* Pass the sample to the upper half.  This is done without devsem held
+   * because the upper half holds its own lock when it calls into the
+   * driver.
+   */
+
+  if (nbytes > 0)
+    {
+      touch_report(&priv->lower, (FAR struct touch_sample_s *)report);
+    }
 }
 
 /****************************************************************************
@@ -641,83 +582,6 @@ static ssize_t ft5x06_sample(FAR struct ft5x06_dev_s *priv, FAR char *buffer,
 }
 #endif /* CONFIG_FT5X06_SINGLEPOINT */
 
-/****************************************************************************
- * Name: ft5x06_waitsample
- ****************************************************************************/
-
-static ssize_t ft5x06_waitsample(FAR struct ft5x06_dev_s *priv,
-                                 FAR char *buffer, size_t len)
-{
-  int ret;
-
-  /* Disable pre-emption to prevent other threads from getting control while
-   * we muck with the semaphores.
-   */
-
-  sched_lock();
-
-  /* Now release the semaphore that manages mutually exclusive access to
-   * the device structure.  This may cause other tasks to become ready to
-   * run, but they cannot run yet because pre-emption is disabled.
-   */
-
-  nxsem_post(&priv->devsem);
-
-  /* Try to get the a sample... if we cannot, then wait on the semaphore
-   * that is posted when new sample data is available.
-   */
-
-  while (!priv->valid)
-    {
-      /* Increment the count of waiters */
-
-      priv->nwaiters++;
-
-      /* Wait for a change in the FT5x06 state */
-
-      ret = nxsem_wait(&priv->waitsem);
-      priv->nwaiters--;
-
-      if (ret < 0)
-        {
-          /* If we are awakened by a signal, then we need to return
-           * the failure now.
-           */
-
-          ierr("ERROR: nxsem_wait failed: %d\n", ret);
-          DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-          goto errout;
-        }
-    }
-
-  /* Re-acquire the semaphore that manages mutually exclusive access to
-   * the device structure.  We may have to wait here.  But we have our sample.
-   * Interrupts and pre-emption will be re-enabled while we wait.
-   */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret >= 0)
-    {
-      /* Now sample the data.
-       *
-       * REVISIT:  Is it safe to assume that priv->valid will always be
-       * true?  I think that sched_lock() whould protect the setting.
-       */
-
-      ret = ft5x06_sample(priv, buffer, len);
-    }
-
-errout:
-  /* Restore pre-emption.  We might get suspended here but that is okay
-   * because we already have our sample.  Note:  this means that if there
-   * were two threads reading from the FT5x06 for some reason, the data
-   * might be read out of order.
-   */
-
-  sched_unlock();
-  return ret;
-}
-
 /****************************************************************************
  * Name: ft5x06_bringup
  ****************************************************************************/
@@ -789,209 +653,51 @@ static void ft5x06_shutdown(FAR struct ft5x06_dev_s *priv)
 
 /****************************************************************************
  * Name: ft5x06_open
+ *
+ * Description:
+ *   Called by the upper half on the first open of the driver.
+ *
  ****************************************************************************/
 
-static int ft5x06_open(FAR struct file *filep)
+static int ft5x06_open(FAR struct touch_lowerhalf_s *lower)
 {
-  FAR struct inode *inode;
-  FAR struct ft5x06_dev_s *priv;
-  uint8_t tmp;
+  FAR struct ft5x06_dev_s *priv = (FAR struct ft5x06_dev_s *)lower;
   int ret;
 
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Get exclusive access to the driver data structure */
-
-  ret = nxsem_wait(&priv->devsem);
+  ret = ft5x06_bringup(priv);
   if (ret < 0)
     {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Increment the reference count */
-
-  tmp = priv->crefs + 1;
-  if (tmp == 0)
-    {
-      /* More than 255 opens; uint8_t overflows to zero */
-
-      ret = -EMFILE;
-      goto errout_with_sem;
-    }
-
-  /* When the reference increments to 1, this is the first open event
-   * on the driver.. and the time when we must initialize the driver.
-   */
-
-  if (tmp == 1)
-    {
-      ret = ft5x06_bringup(priv);
-      if (ret < 0)
-        {
-          ierr("ERROR: ft5x06_bringup failed: %d\n", ret);
-          goto errout_with_sem;
-        }
+      ierr("ERROR: ft5x06_bringup failed: %d\n", ret);
     }
 
-  /* Save the new open count on success */
-
-  priv->crefs = tmp;
-
-errout_with_sem:
-  nxsem_post(&priv->devsem);
   return ret;
 }
 
 /****************************************************************************
  * Name: ft5x06_close
+ *
+ * Description:
+ *   Called by the upper half on the last close of the driver.
+ *
  ****************************************************************************/
 
-static int ft5x06_close(FAR struct file *filep)
+static int ft5x06_close(FAR struct touch_lowerhalf_s *lower)
 {
-  FAR struct inode *inode;
-  FAR struct ft5x06_dev_s *priv;
-  int ret;
-
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Get exclusive access to the driver data structure */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Decrement the reference count unless it would decrement a negative
-   * value.
-   */
-
-  if (priv->crefs >= 1)
-    {
-      priv->crefs--;
-    }
-
-  /* When the count decrements to zero, there are no further open references
-   * to the driver and it can be uninitialized.
-   */
-
-   if (priv->crefs == 0)
-     {
-       ft5x06_shutdown(priv);
-     }
-
-  nxsem_post(&priv->devsem);
+  ft5x06_shutdown((FAR struct ft5x06_dev_s *)lower);
   return OK;
 }
 
 /****************************************************************************
- * Name: ft5x06_read
- ****************************************************************************/
-
-static ssize_t ft5x06_read(FAR struct file *filep, FAR char *buffer,
-                           size_t len)
-{
-  FAR struct inode *inode;
-  FAR struct ft5x06_dev_s  *priv;
-  int ret;
-
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Verify that the caller has provided a buffer large enough to receive
-   * the touch data.
-   */
-
-  if (len < SIZEOF_TOUCH_SAMPLE_S(1))
-    {
-      /* We could provide logic to break up a touch report into segments and
-       * handle smaller reads... but why?
-       */
-
-      return -ENOSYS;
-    }
-
-  /* Get exclusive access to the driver data structure */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Try to read sample data. */
-
-  ret = ft5x06_sample(priv, buffer, len);
-  while (ret == 0)
-    {
-      /* Sample data is not available now.  We would have to wait to receive
-       * sample data.  If the user has specified the O_NONBLOCK option, then
-       * just return an error.
-       */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          ret = -EAGAIN;
-          goto errout;
-       }
-
-      /* Wait for sample data */
-
-      ret = ft5x06_waitsample(priv, buffer, len);
-      if (ret < 0)
-        {
-          /* We might have been awakened by a signal */
-
-          goto errout;
-        }
-    }
-
-  ret = SIZEOF_TOUCH_SAMPLE_S(1);
-
-errout:
-  nxsem_post(&priv->devsem);
-  return ret;
-}
-
-/****************************************************************************
- * Name: ft5x06_ioctl
+ * Name: ft5x06_control
  ****************************************************************************/
 
-static int ft5x06_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+static int ft5x06_control(FAR struct touch_lowerhalf_s *lower, int cmd,
+                          unsigned long arg)
 {
-  FAR struct inode         *inode;
-  FAR struct ft5x06_dev_s *priv;
-  int                       ret;
+  FAR struct ft5x06_dev_s *priv = (FAR struct ft5x06_dev_s *)lower;
+  int                      ret;
 
   iinfo("cmd: %d arg: %ld\n", cmd, arg);
-  DEBUGASSERT(filep);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
 
   /* Get exclusive access to the driver data structure */
 
@@ -1034,101 +740,6 @@ static int ft5x06_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
-/****************************************************************************
- * Name: ft5x06_poll
- ****************************************************************************/
-
-#ifndef CONFIG_DISABLE_POLL
-static int ft5x06_poll(FAR struct file *filep, FAR struct pollfd *fds,
-                        bool setup)
-{
-  FAR struct inode         *inode;
-  FAR struct ft5x06_dev_s *priv;
-  int                       ret;
-  int                       i;
-
-  iinfo("setup: %d\n", (int)setup);
-  DEBUGASSERT(filep && fds);
-  inode = filep->f_inode;
-
-  DEBUGASSERT(inode && inode->i_private);
-  priv  = (FAR struct ft5x06_dev_s *)inode->i_private;
-
-  /* Are we setting up the poll?  Or tearing it down? */
-
-  ret = nxsem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: nxsem_wait failed: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  if (setup)
-    {
-      /* Ignore waits that do not include POLLIN */
-
-      if ((fds->events & POLLIN) == 0)
-        {
-          ierr("ERROR: Missing POLLIN: revents: %08x\n", fds->revents);
-          ret = -EDEADLK;
-          goto errout;
-        }
-
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
-
-      for (i = 0; i < CONFIG_FT5X06_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!priv->fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              priv->fds[i] = fds;
-              fds->priv    = &priv->fds[i];
-              break;
-            }
-        }
-
-      if (i >= CONFIG_FT5X06_NPOLLWAITERS)
-        {
-          ierr("ERROR: No available slot found: %d\n", i);
-          fds->priv    = NULL;
-          ret          = -EBUSY;
-          goto errout;
-        }
-
-      /* Should we immediately notify on any of the requested events? */
-
-      if (priv->valid)
-        {
-          ft5x06_notify(priv);
-        }
-    }
-  else if (fds->priv)
-    {
-      /* This is a request to tear down the poll. */
-
-      struct pollfd **slot = (struct pollfd **)fds->priv;
-      DEBUGASSERT(slot != NULL);
-
-      /* Remove all memory of the poll setup */
-
-      *slot                = NULL;
-      fds->priv            = NULL;
-    }
-
-errout:
-  nxsem_post(&priv->devsem);
-  return ret;
-}
-#endif
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1187,18 +798,12 @@ int ft5x06_register(FAR struct i2c_master_s *i2c,
 
   /* Initialize the FT5x06 device driver instance */
 
+  priv->lower.ops = &g_ft5x06_ops;     /* Touchscreen lower half methods */
   priv->i2c       = i2c;               /* Save the I2C device handle */
   priv->config    = config;            /* Save the board configuration */
   priv->frequency = config->frequency; /* Set the current I2C frequency */
 
   nxsem_init(&priv->devsem,  0, 1);    /* Initialize device structure semaphore */
-  nxsem_init(&priv->waitsem, 0, 0);    /* Initialize pen event wait semaphore */
-
-  /* The event wait semaphore is used for signaling and, hence, should not
-   * have priority inheritance enabled.
-   */
-
-  nxsem_setprotocol(&priv->waitsem, SEM_PRIO_NONE);
 
 #ifdef CONFIG_FT5X06_POLLMODE
   /* Allocate a timer for polling the FT5x06 */
@@ -1233,10 +838,11 @@ int ft5x06_register(FAR struct i2c_master_s *i2c,
   (void)snprintf(devname, DEV_NAMELEN, DEV_FORMAT, minor);
   iinfo("Registering %s\n", devname);
 
-  ret = register_driver(devname, &ft5x06_fops, 0666, priv);
+  ret = touch_register(&priv->lower, devname, FT5X06_MAXPOINTS,
+                       FT5X06_NSAMPLES);
   if (ret < 0)
     {
-      ierr("ERROR: register_driver() failed: %d\n", ret);
+      ierr("ERROR: touch_register() failed: %d\n", ret);
       goto errout_with_timer;
     }
 
@@ -0,0 +1,814 @@
+/****************************************************************************
+ * drivers/input/touchscreen_upper.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* This file provides the common upper half of touchscreen drivers.  The
+ * lower half reports each touch sample with touch_report(); the upper half
+ * buffers the samples, coalesces movement reports and implements the
+ * character driver.  See struct touch_coalesce_s in
+ * include/nuttx/input/touchscreen.h.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/input/touchscreen.h>
+
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TOUCH_CONTACT (TOUCH_DOWN | TOUCH_UP)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct touch_upperhalf_s
+{
+  FAR struct touch_lowerhalf_s *lower; /* The lower half */
+  FAR uint8_t *ring;                 /* nsamples slots of slotsize bytes */
+  FAR struct touch_sample_s *last;   /* Copy of the last buffered sample */
+  size_t slotsize;                   /* Size of one slot (bytes) */
+  uint8_t maxpoints;                 /* Maximum points in one sample */
+  uint8_t nsamples;                  /* Capacity of the ring (samples) */
+  uint8_t head;                      /* Index of the oldest sample */
+  uint8_t count;                     /* Number of samples buffered */
+  uint8_t crefs;                     /* Number of open references */
+  uint8_t nwaiters;                  /* Number of blocked readers */
+  struct touch_coalesce_s coalesce;  /* Coalescing parameters */
+  systime_t lastwake;                /* Time readers were last woken */
+  struct work_s work;                /* Deferred wake-up of readers */
+  sem_t exclsem;                     /* Mutual exclusion */
+  sem_t readsem;                     /* Wakes up blocked readers */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_TOUCHSCREEN_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     touch_open(FAR struct file *filep);
+static int     touch_close(FAR struct file *filep);
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static int     touch_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_touch_fops =
+{
+  touch_open,  /* open */
+  touch_close, /* close */
+  touch_read,  /* read */
+  NULL,        /* write */
+  NULL,        /* seek */
+  touch_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , touch_poll /* poll */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_takesem
+ ****************************************************************************/
+
+static inline int touch_takesem(FAR sem_t *sem)
+{
+  int ret;
+
+  /* Take a count from the semaphore, possibly waiting */
+
+  ret = nxsem_wait(sem);
+
+  /* The only case that an error should occur here is if the wait
+   * was awakened by a signal
+   */
+
+  DEBUGASSERT(ret == OK || ret == -EINTR);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_forcetake
+ *
+ * Description:
+ *   Take a semaphore, ignoring signals.  Used by the lower half and by the
+ *   worker, which have no caller to return -EINTR to.
+ *
+ ****************************************************************************/
+
+static void touch_forcetake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(sem);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: touch_slot
+ ****************************************************************************/
+
+static inline FAR struct touch_sample_s *
+  touch_slot(FAR struct touch_upperhalf_s *upper, unsigned int ndx)
+{
+  if (ndx >= upper->nsamples)
+    {
+      ndx -= upper->nsamples;
+    }
+
+  return (FAR struct touch_sample_s *)(upper->ring + ndx * upper->slotsize);
+}
+
+/****************************************************************************
+ * Name: touch_ismove
+ *
+ * Description:
+ *   Return true if the sample reports movement of existing contacts only.
+ *
+ ****************************************************************************/
+
+static bool touch_ismove(FAR const struct touch_sample_s *sample)
+{
+  int i;
+
+  for (i = 0; i < sample->npoints; i++)
+    {
+      if ((sample->point[i].flags & TOUCH_CONTACT) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: touch_moved
+ *
+ * Description:
+ *   Return true if any contact of the sample moved by at least 'distance'
+ *   since the last buffered sample.
+ *
+ ****************************************************************************/
+
+static bool touch_moved(FAR struct touch_upperhalf_s *upper,
+                        FAR const struct touch_sample_s *sample)
+{
+  FAR const struct touch_point_s *point;
+  FAR const struct touch_point_s *prev;
+  int distance = upper->coalesce.distance;
+  int i;
+  int j;
+
+  if (distance == 0 || sample->npoints != upper->last->npoints)
+    {
+      return true;
+    }
+
+  for (i = 0; i < sample->npoints; i++)
+    {
+      point = &sample->point[i];
+
+      for (j = 0, prev = NULL; j < upper->last->npoints; j++)
+        {
+          if (upper->last->point[j].id == point->id)
+            {
+              prev = &upper->last->point[j];
+              break;
+            }
+        }
+
+      if (prev == NULL ||
+          point->x - prev->x >= distance || prev->x - point->x >= distance ||
+          point->y - prev->y >= distance || prev->y - point->y >= distance)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: touch_notify
+ *
+ * Description:
+ *   Wake up blocked readers and pollers.  Called with exclsem held.
+ *
+ ****************************************************************************/
+
+static void touch_notify(FAR struct touch_upperhalf_s *upper)
+{
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds;
+  int i;
+#endif
+
+  upper->lastwake = clock_systimer();
+
+  for (; upper->nwaiters > 0; upper->nwaiters--)
+    {
+      nxsem_post(&upper->readsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  for (i = 0; i < CONFIG_TOUCHSCREEN_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          nxsem_post(fds->sem);
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: touch_worker
+ *
+ * Description:
+ *   Wake up readers for the movement reports buffered during the last
+ *   coalescing interval.
+ *
+ ****************************************************************************/
+
+static void touch_worker(FAR void *arg)
+{
+  FAR struct touch_upperhalf_s *upper = (FAR struct touch_upperhalf_s *)arg;
+
+  touch_forcetake(&upper->exclsem);
+  if (upper->count > 0)
+    {
+      touch_notify(upper);
+    }
+
+  nxsem_post(&upper->exclsem);
+}
+
+/****************************************************************************
+ * Name: touch_open
+ ****************************************************************************/
+
+static int touch_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct touch_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = touch_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->crefs == UINT8_MAX)
+    {
+      ret = -EMFILE;
+    }
+  else if (upper->crefs == 0)
+    {
+      /* First open: start reporting into an empty ring */
+
+      upper->head          = 0;
+      upper->count         = 0;
+      upper->last->npoints = 0;
+
+      ret = lower->ops->open(lower);
+    }
+
+  if (ret >= 0)
+    {
+      upper->crefs++;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_close
+ ****************************************************************************/
+
+static int touch_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct touch_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = touch_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(upper->crefs > 0);
+  if (--upper->crefs == 0)
+    {
+      (void)work_cancel(HPWORK, &upper->work);
+      ret = lower->ops->close(lower);
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_read
+ *
+ * Description:
+ *   Wait for a sample, then return as many buffered samples as fit in the
+ *   user buffer.  If the oldest sample does not fit, it is returned with as
+ *   many of its points as fit.
+ *
+ ****************************************************************************/
+
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct touch_sample_s *sample;
+  FAR struct touch_sample_s *dest;
+  size_t rsize;
+  ssize_t nread = 0;
+  int npoints;
+  int ret;
+
+  if (buflen < SIZEOF_TOUCH_SAMPLE_S(1))
+    {
+      return -EINVAL;
+    }
+
+  ret = touch_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (upper->count == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      upper->nwaiters++;
+      nxsem_post(&upper->exclsem);
+
+      ret = touch_takesem(&upper->readsem);
+      if (ret < 0)
+        {
+          /* Remove ourselves from the waiter count */
+
+          touch_forcetake(&upper->exclsem);
+          if (upper->nwaiters > 0)
+            {
+              upper->nwaiters--;
+            }
+
+          goto errout;
+        }
+
+      ret = touch_takesem(&upper->exclsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Copy out the oldest samples */
+
+  while (upper->count > 0)
+    {
+      sample  = touch_slot(upper, upper->head);
+      npoints = sample->npoints;
+      rsize   = SIZEOF_TOUCH_SAMPLE_S(npoints > 0 ? npoints : 1);
+
+      if (rsize > buflen - nread)
+        {
+          if (nread > 0)
+            {
+              break;
+            }
+
+          /* Truncate the first sample to the points that fit */
+
+          npoints = (buflen - SIZEOF_TOUCH_SAMPLE_S(1)) /
+                    sizeof(struct touch_point_s) + 1;
+          rsize   = SIZEOF_TOUCH_SAMPLE_S(npoints);
+        }
+
+      dest = (FAR struct touch_sample_s *)(buffer + nread);
+      memcpy(dest, sample, rsize);
+      dest->npoints = npoints;
+      nread += rsize;
+
+      if (++upper->head >= upper->nsamples)
+        {
+          upper->head = 0;
+        }
+
+      upper->count--;
+    }
+
+  ret = nread;
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_ioctl
+ ****************************************************************************/
+
+static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct touch_lowerhalf_s *lower = upper->lower;
+  FAR struct touch_coalesce_s *coalesce;
+  int ret;
+
+  ret = touch_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case TSIOC_SETCOALESCE:
+        coalesce = (FAR struct touch_coalesce_s *)((uintptr_t)arg);
+        if (coalesce == NULL)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        upper->coalesce = *coalesce;
+        break;
+
+      case TSIOC_GETCOALESCE:
+        coalesce = (FAR struct touch_coalesce_s *)((uintptr_t)arg);
+        if (coalesce == NULL)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        *coalesce = upper->coalesce;
+        break;
+
+      default:
+        if (lower->ops->control != NULL)
+          {
+            ret = lower->ops->control(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  int ret;
+  int i;
+
+  ret = touch_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_TOUCHSCREEN_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_TOUCHSCREEN_NPOLLWAITERS)
+        {
+          ierr("ERROR: Too many poll waiters\n");
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Report immediately if samples are already buffered */
+
+      if (upper->count > 0 && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          nxsem_post(fds->sem);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* Remove all memory of the poll setup */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Register a touchscreen character driver with the common upper half.
+ *
+ * Input Parameters:
+ *   lower     - The lower half state
+ *   path      - The full path to the driver, e.g. "/dev/input0"
+ *   maxpoints - The maximum number of touch points in one sample
+ *   nsamples  - The number of samples buffered
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower, FAR const char *path,
+                   uint8_t maxpoints, uint8_t nsamples)
+{
+  FAR struct touch_upperhalf_s *upper;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL && path != NULL &&
+              lower->ops->open != NULL && lower->ops->close != NULL);
+
+  if (maxpoints == 0 || nsamples == 0)
+    {
+      return -EINVAL;
+    }
+
+  upper = (FAR struct touch_upperhalf_s *)
+    kmm_zalloc(sizeof(struct touch_upperhalf_s));
+  if (upper == NULL)
+    {
+      ierr("ERROR: Failed to allocate the upper half\n");
+      return -ENOMEM;
+    }
+
+  /* One extra slot holds the copy of the last buffered sample */
+
+  upper->slotsize = SIZEOF_TOUCH_SAMPLE_S(maxpoints);
+  upper->ring     = (FAR uint8_t *)kmm_zalloc((nsamples + 1) *
+                                              upper->slotsize);
+  if (upper->ring == NULL)
+    {
+      ierr("ERROR: Failed to allocate the sample ring\n");
+      kmm_free(upper);
+      return -ENOMEM;
+    }
+
+  upper->last = (FAR struct touch_sample_s *)
+    (upper->ring + nsamples * upper->slotsize);
+
+  upper->lower               = lower;
+  upper->maxpoints           = maxpoints;
+  upper->nsamples            = nsamples;
+  upper->coalesce.interval   = CONFIG_TOUCHSCREEN_INTERVAL * USEC_PER_MSEC;
+  upper->coalesce.distance   = CONFIG_TOUCHSCREEN_DISTANCE;
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->readsem, 0, 0);
+
+  /* The read semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&upper->readsem, SEM_PRIO_NONE);
+
+  lower->upper = upper;
+
+  ret = register_driver(path, &g_touch_fops, 0444, upper);
+  if (ret < 0)
+    {
+      ierr("ERROR: Failed to register driver: %d\n", ret);
+      nxsem_destroy(&upper->exclsem);
+      nxsem_destroy(&upper->readsem);
+      kmm_free(upper->ring);
+      kmm_free(upper);
+      lower->upper = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_report
+ *
+ * Description:
+ *   Report a touch sample.  The sample is timestamped, coalesced and
+ *   buffered.
+ *
+ * Input Parameters:
+ *   lower  - The lower half state
+ *   sample - The sample.  At most 'maxpoints' points are used.
+ *
+ ****************************************************************************/
+
+void touch_report(FAR struct touch_lowerhalf_s *lower,
+                  FAR const struct touch_sample_s *sample)
+{
+  FAR struct touch_upperhalf_s *upper;
+  FAR struct touch_sample_s *slot;
+  struct timespec ts;
+  uint64_t timestamp;
+  systime_t interval;
+  systime_t elapsed;
+  bool ismove;
+  int npoints;
+  int i;
+
+  DEBUGASSERT(lower != NULL && lower->upper != NULL && sample != NULL);
+  upper = (FAR struct touch_upperhalf_s *)lower->upper;
+
+  npoints = sample->npoints;
+  if (npoints > upper->maxpoints)
+    {
+      npoints = upper->maxpoints;
+    }
+
+  if (npoints < 1)
+    {
+      return;
+    }
+
+  (void)clock_systimespec(&ts);
+  timestamp = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  touch_forcetake(&upper->exclsem);
+
+  /* Drop movement reports that are below the distance threshold */
+
+  ismove = touch_ismove(sample);
+  if (ismove && !touch_moved(upper, sample))
+    {
+      goto out;
+    }
+
+  /* If the ring is full, merge two movement reports into the newest slot.
+   * Otherwise the oldest sample is lost.
+   */
+
+  if (upper->count >= upper->nsamples)
+    {
+      slot = touch_slot(upper, upper->head + upper->count - 1);
+      if (!ismove || !touch_ismove(slot))
+        {
+          if (++upper->head >= upper->nsamples)
+            {
+              upper->head = 0;
+            }
+
+          slot = touch_slot(upper, upper->head + upper->count - 1);
+        }
+    }
+  else
+    {
+      slot = touch_slot(upper, upper->head + upper->count);
+      upper->count++;
+    }
+
+  memcpy(slot, sample, SIZEOF_TOUCH_SAMPLE_S(npoints));
+  slot->npoints = npoints;
+  for (i = 0; i < npoints; i++)
+    {
+      slot->point[i].timestamp = timestamp;
+    }
+
+  memcpy(upper->last, slot, SIZEOF_TOUCH_SAMPLE_S(npoints));
+
+  /* Wake up readers now for new and lost contacts and when the coalescing
+   * interval has expired.  Otherwise wake them up when it expires.
+   */
+
+  interval = USEC2TICK(upper->coalesce.interval);
+  elapsed  = clock_systimer() - upper->lastwake;
+
+  if (!ismove || elapsed >= interval)
+    {
+      (void)work_cancel(HPWORK, &upper->work);
+      touch_notify(upper);
+    }
+  else if (work_available(&upper->work))
+    {
+      (void)work_queue(HPWORK, &upper->work, touch_worker, upper,
+                       interval - elapsed);
+    }
+
+out:
+  nxsem_post(&upper->exclsem);
+}
+
+#endif /* CONFIG_INPUT_TOUCHSCREEN */
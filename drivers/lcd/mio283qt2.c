@@ -636,6 +636,7 @@ static int mio283qt2_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int planen
 
   pinfo->putrun = mio283qt2_putrun;               /* Put a run into LCD memory */
   pinfo->getrun = mio283qt2_getrun;               /* Get a run from LCD memory */
+  pinfo->putarea = NULL;                          /* No area write support */
   pinfo->buffer = (FAR uint8_t *)priv->runbuffer; /* Run scratch buffer */
   pinfo->bpp    = MIO283QT2_BPP;                  /* Bits-per-pixel */
   return OK;
@@ -547,6 +547,7 @@ static int mio283qt9a_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int plane
 
   pinfo->putrun = mio283qt9a_putrun;               /* Put a run into LCD memory */
   pinfo->getrun = mio283qt9a_getrun;               /* Get a run from LCD memory */
+  pinfo->putarea = NULL;                           /* No area write support */
   pinfo->buffer = (FAR uint8_t *)priv->runbuffer;  /* Run scratch buffer */
   pinfo->bpp    = MIO283QT9A_BPP;                  /* Bits-per-pixel */
 
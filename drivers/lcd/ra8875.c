@@ -833,6 +833,7 @@ static int ra8875_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int planeno,
 
   pinfo->putrun = ra8875_putrun;                  /* Put a run into LCD memory */
   pinfo->getrun = ra8875_getrun;                  /* Get a run from LCD memory */
+  pinfo->putarea = NULL;                          /* No area write support */
   pinfo->buffer = (FAR uint8_t *)priv->runbuffer; /* Run scratch buffer */
   pinfo->bpp    = RA8875_BPP;                     /* Bits-per-pixel */
   return OK;
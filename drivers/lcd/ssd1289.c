@@ -850,6 +850,7 @@ static int ssd1289_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int planeno,
 
   pinfo->putrun = ssd1289_putrun;                 /* Put a run into LCD memory */
   pinfo->getrun = ssd1289_getrun;                 /* Get a run from LCD memory */
+  pinfo->putarea = NULL;                          /* No area write support */
   pinfo->buffer = (FAR uint8_t *)priv->runbuffer; /* Run scratch buffer */
   pinfo->bpp    = SSD1289_BPP;                    /* Bits-per-pixel */
   return OK;
@@ -835,6 +835,7 @@ static int ssd1351_getplaneinfo(FAR struct lcd_dev_s *dev,
 
   pinfo->putrun = ssd1351_putrun;
   pinfo->getrun = ssd1351_getrun;
+  pinfo->putarea = NULL;
   pinfo->buffer = (uint8_t *)priv->runbuffer;
   pinfo->bpp    = SSD1351_BPP;
 
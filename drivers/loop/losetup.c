@@ -101,6 +101,8 @@ static ssize_t loop_write(FAR struct inode *inode,
 #endif
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -117,7 +119,7 @@ static const struct block_operations g_bops =
   NULL,          /* write */
 #endif
   loop_geometry, /* geometry */
-  NULL           /* ioctl */
+  loop_ioctl     /* ioctl */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL         /* unlink */
 #endif
@@ -233,8 +235,9 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbytesread;
+  size_t nbytes;
+  size_t total;
   off_t offset;
-  off_t ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
@@ -245,33 +248,40 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
-  /* Calculate the offset to read the sectors and seek to the position */
+  /* Read all of the requested sectors with as few positioned reads of the
+   * backing file as possible.  Only a short read requires another.
+   */
 
   offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
-  if (ret < 0)
+  nbytes = nsectors * dev->sectsize;
+  total  = 0;
+
+  while (total < nbytes)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
-      return -EIO;
-    }
+      nbytesread = file_pread(&dev->devfile, buffer + total, nbytes - total,
+                              offset + total);
+      if (nbytesread < 0)
+        {
+          if (nbytesread == -EINTR)
+            {
+              continue;
+            }
 
-  /* Then read the requested number of sectors from that position */
+          ferr("ERROR: Read failed: %d\n", (int)nbytesread);
+          return nbytesread;
+        }
 
-  do
-    {
-      nbytesread = file_read(&dev->devfile, buffer,
-                             nsectors * dev->sectsize);
-      if (nbytesread < 0 && nbytesread != -EINTR)
+      if (nbytesread == 0)
         {
-          ferr("ERROR: Read failed: %d\n", nbytesread);
-          return (int)nbytesread;
+          break;
         }
+
+      total += nbytesread;
     }
-  while (nbytesread < 0);
 
   /* Return the number of sectors read */
 
-  return nbytesread / dev->sectsize;
+  return total / dev->sectsize;
 }
 
 /****************************************************************************
@@ -288,38 +298,53 @@ static ssize_t loop_write(FAR struct inode *inode,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbyteswritten;
+  size_t nbytes;
+  size_t total;
   off_t offset;
-  off_t ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
 
-  /* Calculate the offset to write the sectors and seek to the position */
-
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
-  if (ret < 0)
+  if (start_sector + nsectors > dev->nsectors)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
+      ferr("ERROR: Write past end of file\n");
+      return -EIO;
     }
 
-  /* Then write the requested number of sectors to that position */
+  /* Write all of the requested sectors with as few positioned writes to
+   * the backing file as possible.  Only a short write requires another.
+   */
+
+  offset = start_sector * dev->sectsize + dev->offset;
+  nbytes = nsectors * dev->sectsize;
+  total  = 0;
 
-  do
+  while (total < nbytes)
     {
-      nbyteswritten = file_write(&dev->devfile, buffer,
-                                 nsectors * dev->sectsize);
-      if (nbyteswritten < 0 && nbyteswritten != -EINTR)
+      nbyteswritten = file_pwrite(&dev->devfile, buffer + total,
+                                  nbytes - total, offset + total);
+      if (nbyteswritten < 0)
         {
-          ferr("ERROR: nx_write failed: %d\n", nbyteswritten);
+          if (nbyteswritten == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Write failed: %d\n", (int)nbyteswritten);
           return nbyteswritten;
         }
+
+      if (nbyteswritten == 0)
+        {
+          break;
+        }
+
+      total += nbyteswritten;
     }
-  while (nbyteswritten < 0);
 
   /* Return the number of sectors written */
 
-  return nbyteswritten / dev->sectsize;
+  return total / dev->sectsize;
 }
 #endif
 
@@ -354,6 +379,76 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description:
+ *   Support direct mapping of the loop device if the backing file can be
+ *   mapped (for example, a file in tmpfs or in ROMFS on XIP media) and
+ *   write back the backing file on BIOC_FLUSH.
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  FAR struct blockmap_s *map;
+  FAR uint8_t *base = NULL;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  switch (cmd)
+    {
+      case BIOC_XIPBASE:
+      case BIOC_MAP:
+        if (arg == 0)
+          {
+            return -EINVAL;
+          }
+
+        /* The file system returns the address of the whole file */
+
+        ret = file_ioctl(&dev->devfile, FIOC_MMAP,
+                         (unsigned long)((uintptr_t)&base));
+        if (ret < 0 || base == NULL)
+          {
+            return -ENOTTY;
+          }
+
+        base += dev->offset;
+        if (cmd == BIOC_XIPBASE)
+          {
+            *(FAR void **)((uintptr_t)arg) = (FAR void *)base;
+            return OK;
+          }
+
+        map = (FAR struct blockmap_s *)((uintptr_t)arg);
+        if (map->bm_start >= dev->nsectors ||
+            map->bm_nsectors > dev->nsectors - map->bm_start)
+          {
+            return -EINVAL;
+          }
+
+        map->bm_addr     = (FAR void *)(base + map->bm_start * dev->sectsize);
+#ifdef CONFIG_FS_WRITABLE
+        map->bm_writable = dev->writeenabled;
+#else
+        map->bm_writable = false;
+#endif
+        return OK;
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      case BIOC_FLUSH:
+        return file_fsync(&dev->devfile);
+#endif
+
+      default:
+        return -ENOTTY;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
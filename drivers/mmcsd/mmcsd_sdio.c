@@ -100,6 +100,22 @@
 
 #define IS_EMPTY(priv) (priv->type == MMCSD_CARDTYPE_UNKNOWN)
 
+#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+#  define MMCSD_HAVE_RWBUFFER 1
+#endif
+
+#ifndef CONFIG_MMCSD_NWRBLOCKS
+#  define CONFIG_MMCSD_NWRBLOCKS 16
+#endif
+
+#ifndef CONFIG_MMCSD_NRDBLOCKS
+#  define CONFIG_MMCSD_NRDBLOCKS 16
+#endif
+
+/* The largest transfer that can be announced with CMD23 */
+
+#define MMCSD_CMD23_MAXBLOCKS   0xffff
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -124,6 +140,9 @@ struct mmcsd_state_s
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
+#ifdef CONFIG_MMCSD_CMD23
+  uint8_t cmd23:1;                 /* true: card supports CMD23 SET_BLOCK_COUNT */
+#endif
 
   uint8_t mode:2;                  /* (See MMCSDMODE_* definitions) */
   uint8_t type:4;                  /* Card type (See MMCSD_CARDTYPE_* definitions) */
@@ -145,9 +164,13 @@ struct mmcsd_state_s
 #endif
   /* Read-ahead and write buffering support */
 
-#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+#ifdef MMCSD_HAVE_RWBUFFER
   struct rwbuffer_s rwbuffer;
 #endif
+
+#ifdef CONFIG_MMCSD_STATS
+  struct mmcsd_stats_s stats;      /* Transfer statistics */
+#endif
 };
 
 /****************************************************************************
@@ -204,7 +227,13 @@ static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
 static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
                  FAR uint8_t *buffer, off_t startblock, size_t nblocks);
 #endif
-#ifdef CONFIG_DRVR_READAHEAD
+#ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
+static bool    mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 size_t nblocks);
+#endif
+static ssize_t mmcsd_readblocks(FAR struct mmcsd_state_s *priv,
+                 FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+#ifdef MMCSD_HAVE_RWBUFFER
 static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 #endif
@@ -215,11 +244,19 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_state_s *priv,
 static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
                  FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
 #endif
-#ifdef CONFIG_DRVR_WRITEBUFFER
+static ssize_t mmcsd_writeblocks(FAR struct mmcsd_state_s *priv,
+                 FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+#ifdef MMCSD_HAVE_RWBUFFER
 static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 #endif
 #endif
+#ifdef CONFIG_MMCSD_STATS
+static void    mmcsd_recordstats(FAR struct mmcsd_state_s *priv, bool write,
+                 size_t nblocks, ssize_t ret, systime_t start);
+#else
+#  define mmcsd_recordstats(p,w,n,r,s)
+#endif
 
 /* Block driver methods *****************************************************/
 
@@ -595,6 +632,14 @@ static void mmcsd_decodeCSD(FAR struct mmcsd_state_s *priv, uint32_t csd[4])
   decoded.transpeed.transferrateunit =  csd[0]        & 7;
 #endif
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* SET_BLOCK_COUNT is supported by MMC v3.1 and later.  SD cards report
+   * it in the SCR.
+   */
+
+  priv->cmd23 = IS_MMC(priv->type) && ((csd[0] >> 26) & 0x0f) >= 3;
+#endif
+
   /* Word 2: Bits 64:95
    *   CCC                95:84 Card command classes
    *   READ_BL_LEN        83:80 Max. read data block length
@@ -910,7 +955,7 @@ static void mmcsd_decodeCID(FAR struct mmcsd_state_s *priv, uint32_t cid[4])
  *
  * Description:
  *   Show the contents of the SD Configuration Register (SCR).  The only
- *   value retained is:  priv->buswidth;
+ *   values retained are:  priv->buswidth and priv->cmd23;
  *
  ****************************************************************************/
 
@@ -935,6 +980,16 @@ struct mmcsd_scr_s decoded;
   priv->buswidth     = (scr[0] >> 8) & 15;
 #endif
 
+  /* CMD_SUPPORT 33:32 (SD v3.0): Bit 33 is set if CMD23 is supported */
+
+#ifdef CONFIG_MMCSD_CMD23
+#ifdef CONFIG_ENDIAN_BIG
+  priv->cmd23        = ((scr[0] >> 1) & 1) != 0;
+#else
+  priv->cmd23        = ((scr[0] >> 25) & 1) != 0;
+#endif
+#endif
+
 #ifdef CONFIG_DEBUG_FS_INFO
 #ifdef CONFIG_ENDIAN_BIG    /* Card SCR is big-endian order / CPU also big-endian
                              *   60   56   52   48   44   40   36   32
@@ -1128,6 +1183,9 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
 {
   systime_t starttime;
   systime_t elapsed;
+#ifdef CONFIG_MMCSD_STATS
+  systime_t busystart;
+#endif
   uint32_t r1;
   int ret;
 
@@ -1148,6 +1206,10 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
       return OK;
     }
 
+#ifdef CONFIG_MMCSD_STATS
+  busystart = clock_systimer();
+#endif
+
   /* The card is still present and the last transfer was a write transfer.
    * Loop, querying the card state.  Return when (1) the card is in the TRANSFER
    * state, (2) the card stays in the PROGRAMMING state too long, or (3) the
@@ -1186,6 +1248,9 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
         {
           /* Yes.. return Success */
 
+#ifdef CONFIG_MMCSD_STATS
+          priv->stats.busyticks += (uint32_t)(clock_systimer() - busystart);
+#endif
           priv->wrbusy = false;
           return OK;
         }
@@ -1244,6 +1309,44 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Announce the number of blocks of the following multiple block transfer
+ *   with CMD23 (SET_BLOCK_COUNT), if the card supports it.  Returns true if
+ *   the count was accepted; the transfer then ends without
+ *   STOP_TRANSMISSION.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
+static bool mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                                size_t nblocks)
+{
+#ifdef CONFIG_MMCSD_CMD23
+  int ret;
+
+  if (priv->cmd23 && nblocks <= MMCSD_CMD23_MAXBLOCKS)
+    {
+      mmcsd_sendcmdpoll(priv, MMC_CMD23, (uint32_t)nblocks);
+      ret = mmcsd_recvR1(priv, MMC_CMD23);
+      if (ret == OK)
+        {
+          return true;
+        }
+
+      /* Fall back to open-ended transfers with this card */
+
+      ferr("ERROR: mmcsd_recvR1 for CMD23 failed: %d\n", ret);
+      priv->cmd23 = false;
+    }
+#endif
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1426,6 +1529,7 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
 {
   size_t nbytes;
   off_t  offset;
+  bool   counted;
   int ret;
 
   finfo("startblock=%d nblocks=%d\n", startblock, nblocks);
@@ -1494,6 +1598,10 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
     return ret;
   }
 
+  /* Announce the number of blocks, if possible */
+
+  counted = mmcsd_setblockcount(priv, nblocks);
+
   /* Configure SDIO controller hardware for the read transfer */
 
   SDIO_BLOCKSETUP(priv->dev, priv->blocksize, nblocks);
@@ -1539,12 +1647,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the card knew the number of blocks */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (ret != OK)
+  if (!counted)
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+        }
     }
 
   /* On success, return the number of blocks read */
@@ -1554,22 +1665,24 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
 #endif
 
 /****************************************************************************
- * Name: mmcsd_reload
+ * Name: mmcsd_readblocks
  *
  * Description:
- *   Reload the specified number of sectors from the physical device into the
- *   read-ahead buffer.
+ *   Read the specified number of blocks from the physical device using the
+ *   best available transfer method.  The caller holds the MMC/SD semaphore.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_DRVR_READAHEAD
-static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
-                            off_t startblock, size_t nblocks)
+static ssize_t mmcsd_readblocks(FAR struct mmcsd_state_s *priv,
+                                FAR uint8_t *buffer, off_t startblock,
+                                size_t nblocks)
 {
-  FAR struct mmcsd_state_s *priv = (FAR struct mmcsd_state_s *)dev;
 #ifdef CONFIG_MMCSD_MULTIBLOCK_DISABLE
   size_t block;
   size_t endblock;
+#endif
+#ifdef CONFIG_MMCSD_STATS
+  systime_t start = clock_systimer();
 #endif
   ssize_t ret;
 
@@ -1611,10 +1724,37 @@ static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
 
 #endif
 
+  mmcsd_recordstats(priv, false, nblocks, ret, start);
+
   /* On success, return the number of blocks read */
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: mmcsd_reload
+ *
+ * Description:
+ *   Reload the specified number of sectors from the physical device into the
+ *   read-ahead buffer.  This is also the path used by rwb_read() for reads
+ *   that bypass the read-ahead buffer.
+ *
+ ****************************************************************************/
+
+#ifdef MMCSD_HAVE_RWBUFFER
+static ssize_t mmcsd_reload(FAR void *dev, FAR uint8_t *buffer,
+                            off_t startblock, size_t nblocks)
+{
+  FAR struct mmcsd_state_s *priv = (FAR struct mmcsd_state_s *)dev;
+  ssize_t ret;
+
+  DEBUGASSERT(priv != NULL && buffer != NULL && nblocks > 0);
+
+  mmcsd_takesem(priv);
+  ret = mmcsd_readblocks(priv, buffer, startblock, nblocks);
+  mmcsd_givesem(priv);
+  return ret;
+}
 #endif
 
 /****************************************************************************
@@ -1796,6 +1936,7 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 {
   off_t  offset;
   size_t nbytes;
+  bool   counted;
   int ret;
 
   finfo("startblock=%d nblocks=%d\n", startblock, nblocks);
@@ -1866,13 +2007,15 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* If this is an SD card, then send ACMD23 (SET_WR_BLK_COUNT) just before
-   * sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of write
-   * blocks to be pre-erased and might make the following multiple block write
-   * command faster.
+  /* Announce the number of blocks, if possible.  Otherwise, if this is an
+   * SD card, then send ACMD23 (SET_WR_BLK_COUNT) just before sending CMD25
+   * (WRITE_MULTIPLE_BLOCK).  This sets the number of write blocks to be
+   * pre-erased and might make the following multiple block write command
+   * faster.
    */
 
-  if (IS_SD(priv->type))
+  counted = mmcsd_setblockcount(priv, nblocks);
+  if (!counted && IS_SD(priv->type))
     {
       /* Send CMD55, APP_CMD, a verify that good R1 status is returned */
 
@@ -1886,7 +2029,7 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
       /* Send CMD23, SET_WR_BLK_COUNT, and verify that good R1 status is returned */
 
-      mmcsd_sendcmdpoll(priv, SD_ACMD23, 0);
+      mmcsd_sendcmdpoll(priv, SD_ACMD23, (uint32_t)nblocks);
       ret = mmcsd_recvR1(priv, SD_ACMD23);
       if (ret != OK)
         {
@@ -1969,13 +2112,16 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the card knew the number of blocks */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (ret != OK)
+  if (!counted)
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
-      return ret;
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+          return ret;
+        }
     }
 
   /* On success, return the number of blocks written */
@@ -1985,21 +2131,25 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 #endif
 
 /****************************************************************************
- * Name: mmcsd_flush
+ * Name: mmcsd_writeblocks
  *
  * Description:
- *   Flush the specified number of sectors from the write buffer to the card.
+ *   Write the specified number of blocks to the physical device using the
+ *   best available transfer method.  The caller holds the MMC/SD semaphore.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_DRVR_WRITEBUFFER)
-static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
-                           off_t startblock, size_t nblocks)
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t mmcsd_writeblocks(FAR struct mmcsd_state_s *priv,
+                                 FAR const uint8_t *buffer, off_t startblock,
+                                 size_t nblocks)
 {
-  FAR struct mmcsd_state_s *priv = (FAR struct mmcsd_state_s *)dev;
 #ifdef CONFIG_MMCSD_MULTIBLOCK_DISABLE
   size_t block;
   size_t endblock;
+#endif
+#ifdef CONFIG_MMCSD_STATS
+  systime_t start = clock_systimer();
 #endif
   ssize_t ret;
 
@@ -2015,10 +2165,10 @@ static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
     {
       /* Write this block from the user buffer */
 
-      ssize_t nread = mmcsd_writesingle(priv, buffer, block);
-      if (nread < 0)
+      ssize_t nwritten = mmcsd_writesingle(priv, buffer, block);
+      if (nwritten < 0)
         {
-          ret = nread;
+          ret = nwritten;
           break;
         }
 
@@ -2028,6 +2178,8 @@ static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
     }
 
 #else
+  /* Use either the single- or multiple-block transfer method */
+
   if (nblocks == 1)
     {
       ret = mmcsd_writesingle(priv, buffer, startblock);
@@ -2039,12 +2191,82 @@ static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
 
 #endif
 
+  mmcsd_recordstats(priv, true, nblocks, ret, start);
+
   /* On success, return the number of blocks written */
 
   return ret;
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_flush
+ *
+ * Description:
+ *   Flush the specified number of sectors from the write buffer to the card.
+ *   This is also the path used by rwb_write() for writes that bypass the
+ *   write buffer.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_WRITABLE) && defined(MMCSD_HAVE_RWBUFFER)
+static ssize_t mmcsd_flush(FAR void *dev, FAR const uint8_t *buffer,
+                           off_t startblock, size_t nblocks)
+{
+  FAR struct mmcsd_state_s *priv = (FAR struct mmcsd_state_s *)dev;
+  ssize_t ret;
+
+  DEBUGASSERT(priv != NULL && buffer != NULL && nblocks > 0);
+
+  mmcsd_takesem(priv);
+  ret = mmcsd_writeblocks(priv, buffer, startblock, nblocks);
+  mmcsd_givesem(priv);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: mmcsd_recordstats
+ *
+ * Description:
+ *   Account for one completed transfer.  The caller holds the MMC/SD
+ *   semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_STATS
+static void mmcsd_recordstats(FAR struct mmcsd_state_s *priv, bool write,
+                              size_t nblocks, ssize_t ret, systime_t start)
+{
+  uint32_t elapsed = (uint32_t)(clock_systimer() - start);
+
+  if (ret < 0)
+    {
+      priv->stats.nerrors++;
+    }
+  else if (write)
+    {
+      priv->stats.nwrites++;
+      priv->stats.wrblocks += nblocks;
+      priv->stats.wrticks  += elapsed;
+      if (elapsed > priv->stats.wrmax)
+        {
+          priv->stats.wrmax = elapsed;
+        }
+    }
+  else
+    {
+      priv->stats.nreads++;
+      priv->stats.rdblocks += nblocks;
+      priv->stats.rdticks  += elapsed;
+      if (elapsed > priv->stats.rdmax)
+        {
+          priv->stats.rdmax = elapsed;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Block Driver Methods
  ****************************************************************************/
@@ -2109,10 +2331,6 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t startsector, unsigned int nsectors)
 {
   FAR struct mmcsd_state_s *priv;
-#if !defined(CONFIG_DRVR_READAHEAD) && defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
-  size_t sector;
-  size_t endsector;
-#endif
   ssize_t ret = nsectors;
 
   DEBUGASSERT(inode && inode->i_private);
@@ -2122,47 +2340,18 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
 
   if (nsectors > 0)
     {
-      mmcsd_takesem(priv);
-
-#if defined(CONFIG_DRVR_READAHEAD)
-      /* Get the data from the read-ahead buffer */
+#ifdef MMCSD_HAVE_RWBUFFER
+      /* Get the data through the read-ahead buffer.  The MMC/SD semaphore
+       * is taken by mmcsd_reload() only while the card is accessed so that
+       * a concurrent write buffer flush is not blocked by buffer hits.
+       */
 
       ret = rwb_read(&priv->rwbuffer, startsector, nsectors, buffer);
-
-#elif defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
-      /* Read each block using only the single block transfer method */
-
-      endsector = startsector + nsectors - 1;
-      for (sector = startsector; sector <= endsector; sector++)
-        {
-          /* Read this sector into the user buffer */
-
-          ssize_t nread = mmcsd_readsingle(priv, buffer, sector);
-          if (nread < 0)
-            {
-              ret = nread;
-              break;
-            }
-
-          /* Increment the buffer pointer by the sector size */
-
-          buffer += priv->blocksize;
-        }
-
 #else
-      /* Use either the single- or multiple-block transfer method */
-
-      if (nsectors == 1)
-        {
-          ret = mmcsd_readsingle(priv, buffer, startsector);
-        }
-      else
-        {
-          ret = mmcsd_readmultiple(priv, buffer, startsector, nsectors);
-        }
-
-#endif
+      mmcsd_takesem(priv);
+      ret = mmcsd_readblocks(priv, buffer, startsector, nsectors);
       mmcsd_givesem(priv);
+#endif
     }
 
   /* On success, return the number of blocks read */
@@ -2184,11 +2373,7 @@ static ssize_t mmcsd_write(FAR struct inode *inode, FAR const unsigned char *buf
                            size_t startsector, unsigned int nsectors)
 {
   FAR struct mmcsd_state_s *priv;
-#if defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
-  size_t sector;
-  size_t endsector;
-#endif
-  ssize_t ret = nsectors;
+  ssize_t ret;
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct mmcsd_state_s *)inode->i_private;
@@ -2196,47 +2381,17 @@ static ssize_t mmcsd_write(FAR struct inode *inode, FAR const unsigned char *buf
   finfo("sector: %lu nsectors: %u sectorsize: %u\n",
         (unsigned long)startsector, nsectors, priv->blocksize);
 
-  mmcsd_takesem(priv);
-
-#if defined(CONFIG_DRVR_WRITEBUFFER)
-  /* Write the data to the write buffer */
+#ifdef MMCSD_HAVE_RWBUFFER
+  /* Write the data to the write buffer.  Full slots are written to the card
+   * by mmcsd_flush() on the worker thread while this thread continues.
+   */
 
   ret = rwb_write(&priv->rwbuffer, startsector, nsectors, buffer);
-
-#elif defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE)
-  /* Write each block using only the single block transfer method */
-
-  endsector = startsector + nsectors - 1;
-  for (sector = startsector; sector <= endsector; sector++)
-    {
-      /* Write this block from the user buffer */
-
-      ssize_t nread = mmcsd_writesingle(priv, buffer, sector);
-      if (nread < 0)
-        {
-          ret = nread;
-          break;
-        }
-
-      /* Increment the buffer pointer by the block size */
-
-      buffer += priv->blocksize;
-    }
-
 #else
-  /* Use either the single- or multiple-block transfer method */
-
-  if (nsectors == 1)
-    {
-      ret = mmcsd_writesingle(priv, buffer, startsector);
-    }
-  else
-    {
-      ret = mmcsd_writemultiple(priv, buffer, startsector, nsectors);
-    }
-
-#endif
+  mmcsd_takesem(priv);
+  ret = mmcsd_writeblocks(priv, buffer, startsector, nsectors);
   mmcsd_givesem(priv);
+#endif
 
   /* On success, return the number of blocks written */
 
@@ -2319,6 +2474,17 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   DEBUGASSERT(inode && inode->i_private);
   priv  = (FAR struct mmcsd_state_s *)inode->i_private;
 
+#ifdef CONFIG_DRVR_REMOVABLE
+  /* Discard buffered data before taking the MMC/SD semaphore (see
+   * mmcsd_mediachange()).
+   */
+
+  if (cmd == BIOC_EJECT)
+    {
+      rwb_mediaremoved(&priv->rwbuffer);
+    }
+#endif
+
   /* Process the IOCTL by command */
 
   mmcsd_takesem(priv);
@@ -2356,6 +2522,26 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       }
       break;
 
+#ifdef CONFIG_MMCSD_STATS
+    case BIOC_GETSTATS: /* Return transfer statistics */
+      {
+        FAR struct mmcsd_stats_s *stats = (FAR struct mmcsd_stats_s *)arg;
+
+        finfo("BIOC_GETSTATS\n");
+
+        if (stats == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            memcpy(stats, &priv->stats, sizeof(struct mmcsd_stats_s));
+            ret = OK;
+          }
+      }
+      break;
+#endif
+
     default:
       ret = -ENOTTY;
       break;
@@ -2390,6 +2576,18 @@ static void mmcsd_mediachange(FAR void *arg)
   finfo("arg: %p\n", arg);
   DEBUGASSERT(priv);
 
+#ifdef CONFIG_DRVR_REMOVABLE
+  /* Discard any buffered data for a removed card.  This must be done before
+   * taking the MMC/SD semaphore: The buffer callbacks take that semaphore
+   * while holding the buffer locks.
+   */
+
+  if (!SDIO_PRESENT(priv->dev))
+    {
+      rwb_mediaremoved(&priv->rwbuffer);
+    }
+#endif
+
   /* Is there a card present in the slot? */
 
   mmcsd_takesem(priv);
@@ -3100,6 +3298,12 @@ static int mmcsd_probe(FAR struct mmcsd_state_s *priv)
               finfo("Capacity: %lu Kbytes\n", (unsigned long)(priv->capacity / 1024));
               priv->mediachanged = true;
 
+#ifdef MMCSD_HAVE_RWBUFFER
+              /* The buffered block range follows the card in the slot */
+
+              priv->rwbuffer.nblocks = priv->nblocks;
+#endif
+
 #ifdef CONFIG_MMCSD_HAVE_CARDDETECT
               /* Set up to receive asynchronous, media removal events */
 
@@ -3356,10 +3560,25 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
             }
         }
 
-#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
-      /* Initialize buffering */
+#ifdef MMCSD_HAVE_RWBUFFER
+      /* Initialize buffering.  The number of blocks is updated each time
+       * that a card is probed.
+       */
+
+      priv->rwbuffer.blocksize   = 1 << 9;
+      priv->rwbuffer.nblocks     = priv->nblocks > 0 ? priv->nblocks : 1;
+      priv->rwbuffer.dev         = priv;
+#ifdef CONFIG_FS_WRITABLE
+#ifdef CONFIG_DRVR_WRITEBUFFER
+      priv->rwbuffer.wrmaxblocks = CONFIG_MMCSD_NWRBLOCKS;
+#endif
+      priv->rwbuffer.wrflush     = mmcsd_flush;
+#endif
+#ifdef CONFIG_DRVR_READAHEAD
+      priv->rwbuffer.rhmaxblocks = CONFIG_MMCSD_NRDBLOCKS;
+#endif
+      priv->rwbuffer.rhreload    = mmcsd_reload;
 
-#warning "Missing setup of rwbuffer"
       ret = rwb_initialize(&priv->rwbuffer);
       if (ret < 0)
         {
@@ -3384,7 +3603,7 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
   return OK;
 
 errout_with_buffers:
-#if defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)
+#ifdef MMCSD_HAVE_RWBUFFER
   rwb_uninitialize(&priv->rwbuffer);
 errout_with_hwinit:
 #endif
@@ -517,6 +517,12 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
   char devname[16];
   int ret = -ENOMEM;
 
+#ifdef CONFIG_FTL_LOG
+  /* Use the log-structured FTL instead */
+
+  return ftl_log_initialize(minor, mtd);
+#endif
+
   /* Sanity check */
 
 #ifdef CONFIG_DEBUG_FEATURES
@@ -0,0 +1,1110 @@
+/****************************************************************************
+ * drivers/mtd/ftl_log.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * This is a page-mapped, log-structured alternative to the simple FTL in
+ * ftl.c.  Sectors are never rewritten in place.  Each write goes to the
+ * next unused page of the "open" erase block and the logical-to-physical
+ * map held in RAM is updated.  Superseded pages are reclaimed by garbage
+ * collection which relocates the valid pages of the erase block with the
+ * fewest valid pages and then returns the whole block to the free pool.
+ *
+ * Each erase block begins with a few pages of metadata:
+ *
+ *   struct ftl_log_hdr_s                    Written when the block is opened
+ *   struct ftl_log_entry_s[nslots]          One per data page
+ *   Data pages [nslots]
+ *
+ * The entry for a data page is programmed only after the data page
+ * itself, so an interrupted write leaves either the old mapping or the new
+ * one.  The map is rebuilt at initialization time by scanning the entries
+ * of every block and keeping the entry with the highest sequence number
+ * for each logical sector.
+ *
+ * Entries are programmed with the MTD byte write method if it is
+ * available.  Otherwise the header page holding the entry is programmed
+ * again.  That requires a NOR-like FLASH where programming an already
+ * programmed page only clears additional bits; NAND FLASH, which permits
+ * only one program operation per page, is not supported.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+#ifdef CONFIG_FTL_LOG_BGGC
+#  include <nuttx/clock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_FTL_LOG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FTL_LOG_RESERVE
+#  define CONFIG_FTL_LOG_RESERVE 2
+#endif
+
+#if CONFIG_FTL_LOG_RESERVE < 1
+#  error CONFIG_FTL_LOG_RESERVE must be at least one
+#endif
+
+#ifdef CONFIG_FTL_LOG_BGGC
+#  ifndef CONFIG_FTL_LOG_BGGC_RESERVE
+#    define CONFIG_FTL_LOG_BGGC_RESERVE 2
+#  endif
+#  ifndef CONFIG_FTL_LOG_BGGC_DELAY
+#    define CONFIG_FTL_LOG_BGGC_DELAY 100
+#  endif
+#endif
+
+#define FTL_LOG_MAGIC     0x474f4c46   /* "FLOG" */
+#define FTL_LOG_UNMAPPED  0xffffffff   /* l2p[] value of an unwritten sector */
+#define FTL_LOG_NOBLOCK   0xffff       /* No open erase block */
+
+#define FTL_LOG_HDRSIZE   sizeof(struct ftl_log_hdr_s)
+#define FTL_LOG_ENTSIZE   sizeof(struct ftl_log_entry_s)
+
+/* Erase block states */
+
+#define FTL_LOG_FREE      0            /* Contains no valid data */
+#define FTL_LOG_OPEN      1            /* Receiving new writes */
+#define FTL_LOG_FULL      2            /* No further writes until erased */
+#define FTL_LOG_BAD       3            /* Erase failed; never used again */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Erase block header at offset zero of each erase block */
+
+struct ftl_log_hdr_s
+{
+  uint32_t magic;                /* FTL_LOG_MAGIC */
+  uint32_t seq;                  /* Sequence number when opened */
+  uint32_t ecount;               /* Times the block has been erased */
+  uint32_t check;                /* magic ^ seq ^ ecount */
+};
+
+/* Per-page entry following the header.  All ones if the page is unused */
+
+struct ftl_log_entry_s
+{
+  uint32_t lsn;                  /* Logical sector held in the page */
+  uint32_t seq;                  /* Sequence number of the write */
+  uint32_t check;                /* lsn ^ seq ^ FTL_LOG_MAGIC */
+};
+
+struct ftl_log_s
+{
+  FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
+  struct mtd_geometry_s geo;     /* Device geometry */
+  sem_t                 exclsem; /* Serializes access to the device state */
+  uint16_t              blkper;  /* R/W blocks per erase block */
+  uint16_t              hdrpages; /* Metadata pages per erase block */
+  uint16_t              nslots;  /* Data pages per erase block */
+  uint32_t              nlogical; /* Number of logical sectors exported */
+  FAR uint32_t         *l2p;     /* Logical to physical slot map */
+  FAR uint16_t         *nvalid;  /* Valid data pages in each erase block */
+  FAR uint32_t         *ecount;  /* Erase count of each erase block */
+  FAR uint8_t          *state;   /* State of each erase block */
+  FAR uint8_t          *hdrbuf;  /* Metadata pages of the open block */
+#ifdef CONFIG_FS_WRITABLE
+  FAR uint8_t          *gcbuf;   /* Metadata pages of the block being collected */
+  FAR uint8_t          *pagebuf; /* One page being relocated */
+  uint32_t              wrseq;   /* Next sequence number */
+  uint16_t              openblock; /* Erase block receiving writes */
+  uint16_t              nextslot; /* Next unused slot in the open block */
+  uint16_t              nfree;   /* Number of free erase blocks */
+  bool                  gcactive; /* Garbage collection in progress */
+#endif
+#ifdef CONFIG_FTL_LOG_BGGC
+  struct work_s         bgwork;  /* Background garbage collection work */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    ftl_log_lock(FAR struct ftl_log_s *dev);
+#define ftl_log_unlock(dev) nxsem_post(&(dev)->exclsem)
+
+static int     ftl_log_open(FAR struct inode *inode);
+static int     ftl_log_close(FAR struct inode *inode);
+static ssize_t ftl_log_read(FAR struct inode *inode, unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+#ifdef CONFIG_FS_WRITABLE
+static int     ftl_log_writesector(FAR struct ftl_log_s *dev, uint32_t lsn,
+                 FAR const uint8_t *buffer);
+static ssize_t ftl_log_write(FAR struct inode *inode,
+                 const unsigned char *buffer, size_t start_sector,
+                 unsigned int nsectors);
+#endif
+static int     ftl_log_geometry(FAR struct inode *inode,
+                 struct geometry *geometry);
+static int     ftl_log_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bops =
+{
+  ftl_log_open,     /* open     */
+  ftl_log_close,    /* close    */
+  ftl_log_read,     /* read     */
+#ifdef CONFIG_FS_WRITABLE
+  ftl_log_write,    /* write    */
+#else
+  NULL,             /* write    */
+#endif
+  ftl_log_geometry, /* geometry */
+  ftl_log_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0               /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_lock
+ *
+ * Description: Get exclusive access to the device state
+ *
+ ****************************************************************************/
+
+static void ftl_log_lock(FAR struct ftl_log_s *dev)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&dev->exclsem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: ftl_log_page
+ *
+ * Description: Return the R/W block holding a physical slot
+ *
+ ****************************************************************************/
+
+static inline off_t ftl_log_page(FAR struct ftl_log_s *dev, uint32_t psn)
+{
+  return (off_t)(psn / dev->nslots) * dev->blkper + dev->hdrpages +
+         psn % dev->nslots;
+}
+
+/****************************************************************************
+ * Name: ftl_log_reset
+ *
+ * Description: Forget all mappings.  Every erase block becomes free.
+ *
+ ****************************************************************************/
+
+static void ftl_log_reset(FAR struct ftl_log_s *dev)
+{
+  memset(dev->l2p, 0xff, dev->nlogical * sizeof(uint32_t));
+  memset(dev->nvalid, 0, dev->geo.neraseblocks * sizeof(uint16_t));
+  memset(dev->state, FTL_LOG_FREE, dev->geo.neraseblocks);
+
+#ifdef CONFIG_FS_WRITABLE
+  dev->wrseq     = 1;
+  dev->openblock = FTL_LOG_NOBLOCK;
+  dev->nextslot  = 0;
+  dev->nfree     = dev->geo.neraseblocks;
+#endif
+}
+
+/****************************************************************************
+ * Name: ftl_log_scan
+ *
+ * Description: Rebuild the logical-to-physical map from the metadata of
+ *   each erase block.  A block that was only partially written when the
+ *   system went down is treated as full; its unused pages are reclaimed
+ *   when the block is collected.
+ *
+ ****************************************************************************/
+
+static int ftl_log_scan(FAR struct ftl_log_s *dev)
+{
+  FAR struct ftl_log_hdr_s *hdr;
+  FAR struct ftl_log_entry_s *entry;
+  FAR uint32_t *seqs;
+  uint32_t maxseq = 0;
+  uint32_t psn;
+  uint16_t block;
+  uint16_t slot;
+  ssize_t nread;
+
+  ftl_log_reset(dev);
+
+  /* Sequence number of the write currently mapped for each sector */
+
+  seqs = (FAR uint32_t *)kmm_zalloc(dev->nlogical * sizeof(uint32_t));
+  if (seqs == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hdr = (FAR struct ftl_log_hdr_s *)dev->hdrbuf;
+  for (block = 0; block < dev->geo.neraseblocks; block++)
+    {
+      nread = MTD_BREAD(dev->mtd, (off_t)block * dev->blkper,
+                        dev->hdrpages, dev->hdrbuf);
+      if (nread != dev->hdrpages)
+        {
+          ferr("ERROR: Read header of block %d failed: %d\n", block, nread);
+          kmm_free(seqs);
+          return -EIO;
+        }
+
+      /* A block without a valid header is free (erased or never used) */
+
+      if (hdr->magic != FTL_LOG_MAGIC ||
+          hdr->check != (hdr->magic ^ hdr->seq ^ hdr->ecount))
+        {
+          dev->ecount[block] = 0;
+          continue;
+        }
+
+      dev->ecount[block] = hdr->ecount;
+      dev->state[block]  = FTL_LOG_FULL;
+#ifdef CONFIG_FS_WRITABLE
+      dev->nfree--;
+#endif
+
+      if (hdr->seq > maxseq)
+        {
+          maxseq = hdr->seq;
+        }
+
+      entry = (FAR struct ftl_log_entry_s *)&dev->hdrbuf[FTL_LOG_HDRSIZE];
+      for (slot = 0; slot < dev->nslots; slot++, entry++)
+        {
+          /* Skip unused and partially programmed entries */
+
+          if (entry->lsn >= dev->nlogical ||
+              entry->check != (entry->lsn ^ entry->seq ^ FTL_LOG_MAGIC))
+            {
+              continue;
+            }
+
+          if (entry->seq > maxseq)
+            {
+              maxseq = entry->seq;
+            }
+
+          /* Keep only the most recent write of each sector */
+
+          if (entry->seq > seqs[entry->lsn])
+            {
+              psn = dev->l2p[entry->lsn];
+              if (psn != FTL_LOG_UNMAPPED)
+                {
+                  dev->nvalid[psn / dev->nslots]--;
+                }
+
+              dev->l2p[entry->lsn] = (uint32_t)block * dev->nslots + slot;
+              seqs[entry->lsn]     = entry->seq;
+              dev->nvalid[block]++;
+            }
+        }
+    }
+
+#ifdef CONFIG_FS_WRITABLE
+  dev->wrseq = maxseq + 1;
+#endif
+
+  kmm_free(seqs);
+  finfo("Blocks: %d hdrpages: %d slots: %d max seq: %lu\n",
+        dev->geo.neraseblocks, dev->hdrpages, dev->nslots,
+        (unsigned long)maxseq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_program
+ *
+ * Description: Write a range of the metadata of the open block to FLASH
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_log_program(FAR struct ftl_log_s *dev, size_t offset,
+                           size_t len)
+{
+  off_t first;
+  size_t npages;
+  ssize_t nxfrd;
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  if (dev->mtd->write != NULL)
+    {
+      nxfrd = MTD_WRITE(dev->mtd,
+                        (off_t)dev->openblock * dev->geo.erasesize + offset,
+                        len, &dev->hdrbuf[offset]);
+      return nxfrd == (ssize_t)len ? OK : -EIO;
+    }
+#endif
+
+  /* Program the pages holding the range again.  The bytes outside of the
+   * range are either unchanged or still erased.
+   */
+
+  first  = offset / dev->geo.blocksize;
+  npages = (offset + len - 1) / dev->geo.blocksize - first + 1;
+  nxfrd  = MTD_BWRITE(dev->mtd, (off_t)dev->openblock * dev->blkper + first,
+                      npages, &dev->hdrbuf[first * dev->geo.blocksize]);
+  return nxfrd == (ssize_t)npages ? OK : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_openblock
+ *
+ * Description: Erase the free block with the lowest erase count and make
+ *   it the block receiving new writes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_log_openblock(FAR struct ftl_log_s *dev)
+{
+  FAR struct ftl_log_hdr_s *hdr;
+  uint16_t best;
+  uint16_t block;
+  int ret;
+
+  for (; ; )
+    {
+      best = FTL_LOG_NOBLOCK;
+      for (block = 0; block < dev->geo.neraseblocks; block++)
+        {
+          if (dev->state[block] == FTL_LOG_FREE &&
+              (best == FTL_LOG_NOBLOCK ||
+               dev->ecount[block] < dev->ecount[best]))
+            {
+              best = block;
+            }
+        }
+
+      if (best == FTL_LOG_NOBLOCK)
+        {
+          ferr("ERROR: No free erase blocks\n");
+          return -ENOSPC;
+        }
+
+      /* Free blocks are erased only when they are reused so that a block
+       * collected just before a power loss still holds its old data.
+       */
+
+      dev->nfree--;
+      ret = MTD_ERASE(dev->mtd, best, 1);
+      if (ret >= 0)
+        {
+          break;
+        }
+
+      ferr("ERROR: Erase block=%d failed: %d\n", best, ret);
+      dev->state[best] = FTL_LOG_BAD;
+    }
+
+  dev->ecount[best]++;
+  dev->state[best]  = FTL_LOG_OPEN;
+  dev->nvalid[best] = 0;
+  dev->openblock    = best;
+  dev->nextslot     = 0;
+
+  memset(dev->hdrbuf, 0xff, dev->hdrpages * dev->geo.blocksize);
+  hdr         = (FAR struct ftl_log_hdr_s *)dev->hdrbuf;
+  hdr->magic  = FTL_LOG_MAGIC;
+  hdr->seq    = dev->wrseq++;
+  hdr->ecount = dev->ecount[best];
+  hdr->check  = hdr->magic ^ hdr->seq ^ hdr->ecount;
+
+  return ftl_log_program(dev, 0, FTL_LOG_HDRSIZE);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_collect
+ *
+ * Description: Relocate the valid pages of the full block with the fewest
+ *   valid pages (provided that it has no more than 'maxvalid') and return
+ *   the block to the free pool.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_log_collect(FAR struct ftl_log_s *dev, uint16_t maxvalid)
+{
+  FAR struct ftl_log_entry_s *entry;
+  uint16_t victim = FTL_LOG_NOBLOCK;
+  uint16_t block;
+  uint16_t slot;
+  uint32_t psn;
+  ssize_t nxfrd;
+  int ret = OK;
+
+  for (block = 0; block < dev->geo.neraseblocks; block++)
+    {
+      if (dev->state[block] == FTL_LOG_FULL &&
+          dev->nvalid[block] <= maxvalid &&
+          (victim == FTL_LOG_NOBLOCK ||
+           dev->nvalid[block] < dev->nvalid[victim]))
+        {
+          victim = block;
+        }
+    }
+
+  if (victim == FTL_LOG_NOBLOCK)
+    {
+      return -ENOSPC;
+    }
+
+  finfo("Collecting block %d with %d valid pages\n",
+        victim, dev->nvalid[victim]);
+
+  if (dev->nvalid[victim] > 0)
+    {
+      nxfrd = MTD_BREAD(dev->mtd, (off_t)victim * dev->blkper,
+                        dev->hdrpages, dev->gcbuf);
+      if (nxfrd != dev->hdrpages)
+        {
+          ferr("ERROR: Read header of block %d failed: %d\n", victim, nxfrd);
+          return -EIO;
+        }
+
+      /* The pages that are still mapped are the valid ones */
+
+      dev->gcactive = true;
+      entry = (FAR struct ftl_log_entry_s *)&dev->gcbuf[FTL_LOG_HDRSIZE];
+      psn   = (uint32_t)victim * dev->nslots;
+
+      for (slot = 0; slot < dev->nslots && dev->nvalid[victim] > 0;
+           slot++, entry++, psn++)
+        {
+          if (entry->lsn >= dev->nlogical || dev->l2p[entry->lsn] != psn)
+            {
+              continue;
+            }
+
+          nxfrd = MTD_BREAD(dev->mtd, ftl_log_page(dev, psn), 1,
+                            dev->pagebuf);
+          if (nxfrd != 1)
+            {
+              ferr("ERROR: Read of slot %lu failed: %d\n",
+                   (unsigned long)psn, nxfrd);
+              ret = -EIO;
+              break;
+            }
+
+          ret = ftl_log_writesector(dev, entry->lsn, dev->pagebuf);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      dev->gcactive = false;
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  dev->state[victim] = FTL_LOG_FREE;
+  dev->nfree++;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_reserve
+ *
+ * Description: Make sure that the open block has an unused slot,
+ *   collecting garbage first if the free pool has reached the reserve.
+ *   Garbage collection itself may use the reserve.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_log_reserve(FAR struct ftl_log_s *dev)
+{
+  for (; ; )
+    {
+      if (dev->openblock != FTL_LOG_NOBLOCK)
+        {
+          if (dev->nextslot < dev->nslots)
+            {
+              return OK;
+            }
+
+          dev->state[dev->openblock] = FTL_LOG_FULL;
+          dev->openblock = FTL_LOG_NOBLOCK;
+        }
+
+      /* Collection relocates pages and so may leave a new block open */
+
+      if (dev->gcactive || dev->nfree > CONFIG_FTL_LOG_RESERVE ||
+          ftl_log_collect(dev, dev->nslots - 1) < 0)
+        {
+          break;
+        }
+    }
+
+  return ftl_log_openblock(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_writesector
+ *
+ * Description: Write one logical sector out-of-place
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_log_writesector(FAR struct ftl_log_s *dev, uint32_t lsn,
+                               FAR const uint8_t *buffer)
+{
+  FAR struct ftl_log_entry_s *entry;
+  uint32_t oldpsn;
+  uint32_t psn;
+  size_t offset;
+  ssize_t nxfrd;
+  int ret;
+
+  ret = ftl_log_reserve(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The slot is consumed even if the write fails:  A page is never
+   * programmed twice.
+   */
+
+  psn = (uint32_t)dev->openblock * dev->nslots + dev->nextslot;
+  offset = FTL_LOG_HDRSIZE + dev->nextslot * FTL_LOG_ENTSIZE;
+  dev->nextslot++;
+
+  nxfrd = MTD_BWRITE(dev->mtd, ftl_log_page(dev, psn), 1, buffer);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write of slot %lu failed: %d\n", (unsigned long)psn, nxfrd);
+      return -EIO;
+    }
+
+  /* Then commit the mapping */
+
+  entry        = (FAR struct ftl_log_entry_s *)&dev->hdrbuf[offset];
+  entry->lsn   = lsn;
+  entry->seq   = dev->wrseq++;
+  entry->check = entry->lsn ^ entry->seq ^ FTL_LOG_MAGIC;
+
+  ret = ftl_log_program(dev, offset, FTL_LOG_ENTSIZE);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write of entry %lu failed: %d\n", (unsigned long)psn, ret);
+      return ret;
+    }
+
+  oldpsn = dev->l2p[lsn];
+  if (oldpsn != FTL_LOG_UNMAPPED)
+    {
+      dev->nvalid[oldpsn / dev->nslots]--;
+    }
+
+  dev->l2p[lsn] = psn;
+  dev->nvalid[dev->openblock]++;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_bggc_worker
+ *
+ * Description: Collect blocks in the background until the free pool holds
+ *   the background reserve in addition to the foreground reserve.  Only
+ *   blocks that are at most half valid are collected; the foreground still
+ *   takes the others when it has to.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG_BGGC
+static void ftl_log_bggc_worker(FAR void *arg)
+{
+  FAR struct ftl_log_s *dev = (FAR struct ftl_log_s *)arg;
+  bool again = false;
+
+  ftl_log_lock(dev);
+  if (dev->nfree <= CONFIG_FTL_LOG_RESERVE + CONFIG_FTL_LOG_BGGC_RESERVE)
+    {
+      again = (ftl_log_collect(dev, dev->nslots >> 1) == OK);
+    }
+
+  ftl_log_unlock(dev);
+
+  /* Give the callers a chance to run between blocks */
+
+  if (again)
+    {
+      (void)work_queue(LPWORK, &dev->bgwork, ftl_log_bggc_worker, dev,
+                       MSEC2TICK(CONFIG_FTL_LOG_BGGC_DELAY));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int ftl_log_open(FAR struct inode *inode)
+{
+  finfo("Entry\n");
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_close
+ *
+ * Description: Close the block device.  There is no cached data.
+ *
+ ****************************************************************************/
+
+static int ftl_log_close(FAR struct inode *inode)
+{
+  finfo("Entry\n");
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:  Read the specified number of sectors.  Sectors that have
+ *   never been written read as erased FLASH.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_read(FAR struct inode *inode, unsigned char *buffer,
+                            size_t start_sector, unsigned int nsectors)
+{
+  FAR struct ftl_log_s *dev;
+  uint32_t psn;
+  ssize_t nread;
+  ssize_t ret = nsectors;
+  unsigned int i;
+
+  finfo("sector: %d nsectors: %d\n", start_sector, nsectors);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_log_s *)inode->i_private;
+
+  if (start_sector >= dev->nlogical ||
+      nsectors > dev->nlogical - start_sector)
+    {
+      return -EINVAL;
+    }
+
+  ftl_log_lock(dev);
+  for (i = 0; i < nsectors; i++, buffer += dev->geo.blocksize)
+    {
+      psn = dev->l2p[start_sector + i];
+      if (psn == FTL_LOG_UNMAPPED)
+        {
+          memset(buffer, 0xff, dev->geo.blocksize);
+          continue;
+        }
+
+      nread = MTD_BREAD(dev->mtd, ftl_log_page(dev, psn), 1, buffer);
+      if (nread != 1)
+        {
+          ferr("ERROR: Read of sector %d failed: %d\n",
+               start_sector + i, nread);
+          ret = -EIO;
+          break;
+        }
+    }
+
+  ftl_log_unlock(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t ftl_log_write(FAR struct inode *inode,
+                             const unsigned char *buffer, size_t start_sector,
+                             unsigned int nsectors)
+{
+  FAR struct ftl_log_s *dev;
+  unsigned int i;
+  int ret = OK;
+
+  finfo("sector: %d nsectors: %d\n", start_sector, nsectors);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_log_s *)inode->i_private;
+
+  if (start_sector >= dev->nlogical ||
+      nsectors > dev->nlogical - start_sector)
+    {
+      return -EINVAL;
+    }
+
+  ftl_log_lock(dev);
+  for (i = 0; i < nsectors; i++, buffer += dev->geo.blocksize)
+    {
+      ret = ftl_log_writesector(dev, start_sector + i, buffer);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_FTL_LOG_BGGC
+  /* Let the worker build up the reserve of free blocks */
+
+  if (dev->nfree <= CONFIG_FTL_LOG_RESERVE + CONFIG_FTL_LOG_BGGC_RESERVE &&
+      work_available(&dev->bgwork))
+    {
+      (void)work_queue(LPWORK, &dev->bgwork, ftl_log_bggc_worker, dev,
+                       MSEC2TICK(CONFIG_FTL_LOG_BGGC_DELAY));
+    }
+#endif
+
+  ftl_log_unlock(dev);
+  return ret < 0 ? (ssize_t)ret : (ssize_t)nsectors;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int ftl_log_geometry(FAR struct inode *inode,
+                            struct geometry *geometry)
+{
+  FAR struct ftl_log_s *dev;
+
+  finfo("Entry\n");
+
+  DEBUGASSERT(inode);
+  if (geometry)
+    {
+      dev = (FAR struct ftl_log_s *)inode->i_private;
+      geometry->geo_available     = true;
+      geometry->geo_mediachanged  = false;
+#ifdef CONFIG_FS_WRITABLE
+      geometry->geo_writeenabled  = true;
+#else
+      geometry->geo_writeenabled  = false;
+#endif
+      geometry->geo_nsectors      = dev->nlogical;
+      geometry->geo_sectorsize    = dev->geo.blocksize;
+
+      finfo("nsectors: %d sectorsize: %d\n",
+            geometry->geo_nsectors, geometry->geo_sectorsize);
+
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: ftl_log_ioctl
+ *
+ * Description: Handle IOCTL commands
+ *
+ ****************************************************************************/
+
+static int ftl_log_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct ftl_log_s *dev;
+  int ret;
+
+  finfo("Entry\n");
+  DEBUGASSERT(inode && inode->i_private);
+
+  /* Logical sectors are scattered over the FLASH so that the device cannot
+   * be mapped for XIP.
+   */
+
+  if (cmd == BIOC_XIPBASE)
+    {
+      return -ENOTTY;
+    }
+
+  /* Other MTD driver ioctl commands are passed through to the MTD driver
+   * (unchanged).  A bulk erase discards all of the mappings.
+   */
+
+  dev = (FAR struct ftl_log_s *)inode->i_private;
+  ftl_log_lock(dev);
+
+  ret = MTD_IOCTL(dev->mtd, cmd, arg);
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
+    }
+  else if (cmd == MTDIOC_BULKERASE)
+    {
+      ftl_log_reset(dev);
+    }
+
+  ftl_log_unlock(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_free
+ *
+ * Description: Free all of the memory allocated for the device
+ *
+ ****************************************************************************/
+
+static void ftl_log_free(FAR struct ftl_log_s *dev)
+{
+  kmm_free(dev->l2p);
+  kmm_free(dev->nvalid);
+  kmm_free(dev->ecount);
+  kmm_free(dev->state);
+  kmm_free(dev->hdrbuf);
+#ifdef CONFIG_FS_WRITABLE
+  kmm_free(dev->gcbuf);
+  kmm_free(dev->pagebuf);
+#endif
+  nxsem_destroy(&dev->exclsem);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Initialize to provide a log-structured block driver wrapper around an
+ *   MTD interface.
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The MTD block device will be
+ *      registered as as /dev/mtdblockN where N is the minor number.
+ *   mtd - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_log_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+  FAR struct ftl_log_s *dev;
+  size_t hdrsize;
+  uint16_t nusable;
+  char devname[16];
+  int ret;
+
+  /* Sanity check */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (minor < 0 || minor > 255 || !mtd)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  /* Allocate a FTL device structure */
+
+  dev = (FAR struct ftl_log_s *)kmm_zalloc(sizeof(struct ftl_log_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dev->mtd = mtd;
+  nxsem_init(&dev->exclsem, 0, 1);
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY,
+                  (unsigned long)((uintptr_t)&dev->geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(MTDIOC_GEOMETRY) failed: %d\n", ret);
+      goto errout;
+    }
+
+  dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
+  DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
+
+  /* Find the fewest metadata pages that hold the header and the entries
+   * for all of the remaining pages.
+   */
+
+  for (dev->hdrpages = 1; dev->hdrpages < dev->blkper; dev->hdrpages++)
+    {
+      hdrsize = FTL_LOG_HDRSIZE +
+                (size_t)(dev->blkper - dev->hdrpages) * FTL_LOG_ENTSIZE;
+      if (hdrsize <= (size_t)dev->hdrpages * dev->geo.blocksize)
+        {
+          break;
+        }
+    }
+
+  dev->nslots = dev->blkper - dev->hdrpages;
+
+  /* The reserve and one open block are not part of the exported capacity
+   * so that garbage collection can always make progress.
+   */
+
+  nusable = dev->geo.neraseblocks - CONFIG_FTL_LOG_RESERVE - 1;
+  if (dev->nslots < 1 || dev->geo.neraseblocks >= FTL_LOG_NOBLOCK ||
+      dev->geo.neraseblocks <= CONFIG_FTL_LOG_RESERVE + 1)
+    {
+      ferr("ERROR: Unsupported geometry\n");
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dev->nlogical = (uint32_t)nusable * dev->nslots;
+
+  dev->l2p    = (FAR uint32_t *)
+    kmm_malloc(dev->nlogical * sizeof(uint32_t));
+  dev->nvalid = (FAR uint16_t *)
+    kmm_malloc(dev->geo.neraseblocks * sizeof(uint16_t));
+  dev->ecount = (FAR uint32_t *)
+    kmm_malloc(dev->geo.neraseblocks * sizeof(uint32_t));
+  dev->state  = (FAR uint8_t *)kmm_malloc(dev->geo.neraseblocks);
+  dev->hdrbuf = (FAR uint8_t *)
+    kmm_malloc(dev->hdrpages * dev->geo.blocksize);
+
+  if (dev->l2p == NULL || dev->nvalid == NULL || dev->ecount == NULL ||
+      dev->state == NULL || dev->hdrbuf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+#ifdef CONFIG_FS_WRITABLE
+  dev->gcbuf   = (FAR uint8_t *)
+    kmm_malloc(dev->hdrpages * dev->geo.blocksize);
+  dev->pagebuf = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+
+  if (dev->gcbuf == NULL || dev->pagebuf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+#endif
+
+  /* Rebuild the map from the metadata on the FLASH */
+
+  ret = ftl_log_scan(dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: ftl_log_scan failed: %d\n", ret);
+      goto errout;
+    }
+
+  /* Create a MTD block device name */
+
+  snprintf(devname, 16, "/dev/mtdblock%d", minor);
+
+  /* Inode private data is a reference to the FTL device structure */
+
+  ret = register_blockdriver(devname, &g_bops, 0, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_blockdriver failed: %d\n", -ret);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  ftl_log_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_FTL_LOG */
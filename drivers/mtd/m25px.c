@@ -253,6 +253,7 @@ struct m25p_dev_s
 static void m25p_lock(FAR struct spi_dev_s *dev);
 static inline void m25p_unlock(FAR struct spi_dev_s *dev);
 static inline int m25p_readid(struct m25p_dev_s *priv);
+static uint8_t m25p_rdsr(struct m25p_dev_s *priv);
 static void m25p_waitwritecomplete(struct m25p_dev_s *priv);
 static void m25p_writeenable(struct m25p_dev_s *priv);
 static inline void m25p_sectorerase(struct m25p_dev_s *priv, off_t offset, uint8_t type);
@@ -458,32 +459,44 @@ static inline int m25p_readid(struct m25p_dev_s *priv)
 }
 
 /************************************************************************************
- * Name: m25p_waitwritecomplete
+ * Name: m25p_rdsr
  ************************************************************************************/
 
-static void m25p_waitwritecomplete(struct m25p_dev_s *priv)
+static uint8_t m25p_rdsr(struct m25p_dev_s *priv)
 {
   uint8_t status;
 
-  /* Loop as long as the memory is busy with a write cycle */
+  /* Select this FLASH part */
 
-  do
-    {
-      /* Select this FLASH part */
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
 
-      SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
+  /* Send "Read Status Register (RDSR)" command */
 
-      /* Send "Read Status Register (RDSR)" command */
+  (void)SPI_SEND(priv->dev, M25P_RDSR);
 
-      (void)SPI_SEND(priv->dev, M25P_RDSR);
+  /* Send a dummy byte to generate the clock needed to shift out the status */
 
-      /* Send a dummy byte to generate the clock needed to shift out the status */
+  status = SPI_SEND(priv->dev, M25P_DUMMY);
 
-      status = SPI_SEND(priv->dev, M25P_DUMMY);
+  /* Deselect the FLASH */
 
-      /* Deselect the FLASH */
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+  return status;
+}
+
+/************************************************************************************
+ * Name: m25p_waitwritecomplete
+ ************************************************************************************/
+
+static void m25p_waitwritecomplete(struct m25p_dev_s *priv)
+{
+  uint8_t status;
+
+  /* Loop as long as the memory is busy with a write cycle */
 
-      SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+  do
+    {
+      status = m25p_rdsr(priv);
 
       /* Given that writing could take up to few tens of milliseconds, and erasing
        * could take more.  The following short delay in the "busy" case will allow
@@ -1012,6 +1025,48 @@ static int m25p_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_MTD_ASYNC_ERASE
+      case MTDIOC_ERASESTART:
+        {
+          /* Start erasing one erase block but do not wait for it to complete.
+           * The M25P parts cannot suspend an erase so any other access will
+           * wait for it (in m25p_waitwritecomplete()).
+           */
+
+          uint8_t type = M25P_SE;
+          size_t neraseblocks = priv->nsectors;
+
+#ifdef CONFIG_M25P_SUBSECTOR_ERASE
+          if (priv->subsectorshift > 0)
+            {
+              type = M25P_SSE;
+              neraseblocks <<= (priv->sectorshift - priv->subsectorshift);
+            }
+#endif
+
+          if (arg >= neraseblocks)
+            {
+              ret = -ENXIO;
+            }
+          else
+            {
+              m25p_lock(priv->dev);
+              m25p_sectorerase(priv, (off_t)arg, type);
+              m25p_unlock(priv->dev);
+              ret = OK;
+            }
+        }
+        break;
+
+      case MTDIOC_ERASESTATUS:
+        {
+          m25p_lock(priv->dev);
+          ret = (m25p_rdsr(priv) & M25P_SR_WIP) != 0 ? -EBUSY : OK;
+          m25p_unlock(priv->dev);
+        }
+        break;
+#endif
+
       case MTDIOC_XIPBASE:
       default:
         ret = -ENOTTY; /* Bad command */
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <assert.h>
@@ -53,6 +54,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
+#ifdef CONFIG_MTD_PARTITION_SCHED
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#endif
 #ifdef CONFIG_FS_PROCFS
 #include <nuttx/fs/procfs.h>
 #endif
@@ -61,10 +66,69 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+#  ifndef CONFIG_MTD_PARTITION_SCHED_READBATCH
+#    define CONFIG_MTD_PARTITION_SCHED_READBATCH 8
+#  endif
+
+/* Scheduled operations.  Reads must sort before all other operations. */
+
+#  define PART_OP_BREAD     0  /* Block read */
+#  define PART_OP_READ      1  /* Byte read */
+#  define PART_OP_BWRITE    2  /* Block write */
+#  define PART_OP_WRITE     3  /* Byte write */
+#  define PART_OP_ERASE     4  /* Erase */
+
+#  define PART_OP_ISREAD(op) ((op) <= PART_OP_READ)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+/* This structure describes one request waiting for, or holding, the parent
+ * device.  It lives on the stack of the thread that submitted it.
+ */
+
+struct mtd_partition_s;
+
+struct part_req_s
+{
+  FAR struct part_req_s *flink;    /* Next request in the queue or group */
+  FAR struct part_req_s *group;    /* Requests merged behind this one */
+  FAR struct mtd_partition_s *part; /* The partition that submitted it */
+  off_t start;                     /* First parent block, erase block or byte */
+  size_t count;                    /* Number of blocks, erase blocks or bytes */
+  FAR uint8_t *buffer;             /* Data buffer (NULL for erase) */
+  off_t gstart;                    /* Start of the merged group */
+  size_t gcount;                   /* Size of the merged group */
+  FAR uint8_t *gbuffer;            /* Buffer of the merged group */
+  systime_t queued;                /* Time of submission */
+  ssize_t result;                  /* Result of the request */
+  sem_t done;                      /* Posted when admitted or completed */
+  uint8_t op;                      /* See PART_OP_* definitions */
+  bool completed;                  /* True: Completed by the group leader */
+};
+
+/* There is one scheduler for each parent device shared by all of its
+ * partitions.  The request that is admitted owns the parent device until
+ * it completes and then admits the next request.
+ */
+
+struct part_sched_s
+{
+  FAR struct part_sched_s *flink;  /* Next scheduler */
+  FAR struct mtd_dev_s *parent;    /* The parent device */
+  FAR struct part_req_s *head;     /* Queued requests in arrival order */
+  FAR struct part_req_s *tail;
+  size_t blocksize;                /* Size of one parent read/write block */
+  sem_t exclsem;                   /* Protects the queue */
+  uint8_t nreads;                  /* Reads admitted ahead of a writer */
+  bool busy;                       /* True: The parent device is owned */
+};
+#endif
+
 /* This type represents the state of the MTD device.  The struct mtd_dev_s
  * must appear at the beginning of the definition so that you can freely
  * cast between pointers to struct mtd_dev_s and struct mtd_partition_s.
@@ -95,6 +159,10 @@ struct mtd_partition_s
 #ifdef CONFIG_MTD_PARTITION_NAMES
   FAR const char *name;         /* Name of the partition */
 #endif
+#ifdef CONFIG_MTD_PARTITION_SCHED
+  FAR struct part_sched_s *sched; /* Scheduler of the parent device */
+  struct mtd_stats_s stats;     /* Request statistics */
+#endif
 };
 
 /* This structure describes one open "file" */
@@ -128,6 +196,25 @@ static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset,
 static int     part_ioctl(FAR struct mtd_dev_s *dev, int cmd,
                   unsigned long arg);
 
+/* Request scheduling */
+
+#ifdef CONFIG_MTD_PARTITION_SCHED
+static void    part_sched_wait(FAR sem_t *sem);
+static FAR struct part_req_s *part_sched_next(FAR struct part_sched_s *sched);
+static void    part_sched_merge(FAR struct part_sched_s *sched,
+                 FAR struct part_req_s *leader);
+static void    part_sched_admit(FAR struct part_sched_s *sched);
+static void    part_sched_account(FAR struct part_req_s *req,
+                 systime_t now);
+static void    part_sched_run(FAR struct part_sched_s *sched,
+                 FAR struct part_req_s *leader);
+static ssize_t part_sched_submit(FAR struct mtd_partition_s *priv,
+                 uint8_t op, off_t start, size_t count,
+                 FAR uint8_t *buffer);
+static FAR struct part_sched_s *part_sched_get(FAR struct mtd_dev_s *mtd,
+                 size_t blocksize);
+#endif
+
 /* File system methods */
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_PROCFS_EXCLUDE_PARTITIONS)
@@ -156,6 +243,10 @@ static int     part_procfs_stat(FAR const char *relpath,
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+static FAR struct part_sched_s *g_partsched = NULL;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_PROCFS_EXCLUDE_PARTITIONS)
 static struct mtd_partition_s *g_pfirstpartition = NULL;
 
@@ -215,6 +306,503 @@ static bool part_bytecheck(FAR struct mtd_partition_s *priv, off_t byoff)
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: part_sched_wait
+ *
+ * Description:
+ *   Take a scheduler semaphore.  A request must not be abandoned while it is
+ *   queued so the wait is not interruptible.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_PARTITION_SCHED
+static void part_sched_wait(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+    }
+  while (ret == -EINTR || ret == -ECANCELED);
+}
+
+/****************************************************************************
+ * Name: part_sched_next
+ *
+ * Description:
+ *   Remove the next request to be served from the queue.  That is the
+ *   oldest request unless it is a write or erase and there is a read
+ *   waiting behind it:  Reads go first, but only
+ *   CONFIG_MTD_PARTITION_SCHED_READBATCH of them in a row may pass a
+ *   waiting writer.
+ *
+ * Assumptions:
+ *   The caller holds the scheduler exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct part_req_s *part_sched_next(FAR struct part_sched_s *sched)
+{
+  FAR struct part_req_s *prev = NULL;
+  FAR struct part_req_s *req;
+  FAR struct part_req_s *rprev;
+  FAR struct part_req_s *rd;
+
+  req = sched->head;
+  if (req == NULL)
+    {
+      return NULL;
+    }
+
+  if (!PART_OP_ISREAD(req->op) &&
+      sched->nreads < CONFIG_MTD_PARTITION_SCHED_READBATCH)
+    {
+      for (rprev = req, rd = req->flink;
+           rd != NULL && !PART_OP_ISREAD(rd->op);
+           rprev = rd, rd = rd->flink);
+
+      if (rd != NULL)
+        {
+          prev = rprev;
+          req  = rd;
+          sched->nreads++;
+        }
+      else
+        {
+          sched->nreads = 0;
+        }
+    }
+  else
+    {
+      sched->nreads = 0;
+    }
+
+  /* Remove the selected request from the queue */
+
+  if (prev == NULL)
+    {
+      sched->head = req->flink;
+    }
+  else
+    {
+      prev->flink = req->flink;
+    }
+
+  if (sched->tail == req)
+    {
+      sched->tail = prev;
+    }
+
+  req->flink = NULL;
+  return req;
+}
+
+/****************************************************************************
+ * Name: part_sched_merge
+ *
+ * Description:
+ *   Move all queued requests of the same kind that extend the range of
+ *   the admitted request at either end into its group.  Reads and writes
+ *   are only merged if their buffers are contiguous as well.
+ *
+ * Assumptions:
+ *   The caller holds the scheduler exclsem.
+ *
+ ****************************************************************************/
+
+static void part_sched_merge(FAR struct part_sched_s *sched,
+                             FAR struct part_req_s *leader)
+{
+  FAR struct part_req_s *prev;
+  FAR struct part_req_s *req;
+  size_t unit;
+  bool merged;
+
+  leader->gstart  = leader->start;
+  leader->gcount  = leader->count;
+  leader->gbuffer = leader->buffer;
+  leader->group   = NULL;
+
+  switch (leader->op)
+    {
+      case PART_OP_BREAD:
+      case PART_OP_BWRITE:
+        unit = sched->blocksize;
+        break;
+
+      case PART_OP_READ:
+      case PART_OP_WRITE:
+        unit = 1;
+        break;
+
+      default:
+        unit = 0;
+        break;
+    }
+
+  do
+    {
+      merged = false;
+
+      for (prev = NULL, req = sched->head;
+           req != NULL;
+           prev = req, req = req->flink)
+        {
+          if (req->op != leader->op)
+            {
+              continue;
+            }
+
+          if (req->start == leader->gstart + leader->gcount &&
+              (unit == 0 ||
+               req->buffer == leader->gbuffer + leader->gcount * unit))
+            {
+              /* Append to the end of the group */
+            }
+          else if (req->start + req->count == leader->gstart &&
+                   (unit == 0 ||
+                    req->buffer + req->count * unit == leader->gbuffer))
+            {
+              /* Prepend to the beginning of the group */
+
+              leader->gstart  = req->start;
+              leader->gbuffer = req->buffer;
+            }
+          else
+            {
+              continue;
+            }
+
+          leader->gcount += req->count;
+
+          /* Remove the request from the queue and add it to the group */
+
+          if (prev == NULL)
+            {
+              sched->head = req->flink;
+            }
+          else
+            {
+              prev->flink = req->flink;
+            }
+
+          if (sched->tail == req)
+            {
+              sched->tail = prev;
+            }
+
+          req->flink    = leader->group;
+          leader->group = req;
+          merged        = true;
+          break;
+        }
+    }
+  while (merged);
+}
+
+/****************************************************************************
+ * Name: part_sched_admit
+ *
+ * Description:
+ *   Give the parent device to the next request, if there is one.
+ *
+ * Assumptions:
+ *   The caller holds the scheduler exclsem.
+ *
+ ****************************************************************************/
+
+static void part_sched_admit(FAR struct part_sched_s *sched)
+{
+  FAR struct part_req_s *next;
+
+  next = part_sched_next(sched);
+  if (next == NULL)
+    {
+      sched->busy = false;
+      return;
+    }
+
+  part_sched_merge(sched, next);
+  nxsem_post(&next->done);
+}
+
+/****************************************************************************
+ * Name: part_sched_account
+ *
+ * Description:
+ *   Update the statistics of the partition that submitted a request.
+ *
+ ****************************************************************************/
+
+static void part_sched_account(FAR struct part_req_s *req, systime_t now)
+{
+  FAR struct mtd_partition_s *priv = req->part;
+  FAR struct mtd_stats_s *stats = &priv->stats;
+  uint32_t elapsed = (uint32_t)(now - req->queued);
+  uint32_t nbytes;
+
+  if (req->result < 0)
+    {
+      stats->nerrors++;
+      return;
+    }
+
+  switch (req->op)
+    {
+      case PART_OP_BREAD:
+      case PART_OP_READ:
+        nbytes = req->op == PART_OP_BREAD ?
+                 (uint32_t)(req->result * priv->blocksize) :
+                 (uint32_t)req->result;
+
+        stats->nreads++;
+        stats->rdbytes += nbytes;
+        stats->rdticks += elapsed;
+        if (elapsed > stats->rdmax)
+          {
+            stats->rdmax = elapsed;
+          }
+        break;
+
+      case PART_OP_BWRITE:
+      case PART_OP_WRITE:
+        nbytes = req->op == PART_OP_BWRITE ?
+                 (uint32_t)(req->result * priv->blocksize) :
+                 (uint32_t)req->result;
+
+        stats->nwrites++;
+        stats->wrbytes += nbytes;
+        stats->wrticks += elapsed;
+        if (elapsed > stats->wrmax)
+          {
+            stats->wrmax = elapsed;
+          }
+        break;
+
+      case PART_OP_ERASE:
+        stats->nerases++;
+        stats->erbytes += (uint32_t)(req->count * priv->blkpererase *
+                                     priv->blocksize);
+        stats->erticks += elapsed;
+        if (elapsed > stats->ermax)
+          {
+            stats->ermax = elapsed;
+          }
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: part_sched_run
+ *
+ * Description:
+ *   Perform the operation of an admitted request and of all of the requests
+ *   merged into its group, complete the merged requests, then admit the
+ *   next request.
+ *
+ ****************************************************************************/
+
+static void part_sched_run(FAR struct part_sched_s *sched,
+                           FAR struct part_req_s *leader)
+{
+  FAR struct mtd_dev_s *parent = sched->parent;
+  FAR struct part_req_s *req;
+  FAR struct part_req_s *next;
+  systime_t now;
+  ssize_t ret;
+  off_t done;
+
+  switch (leader->op)
+    {
+      case PART_OP_BREAD:
+        ret = parent->bread(parent, leader->gstart, leader->gcount,
+                            leader->gbuffer);
+        break;
+
+      case PART_OP_READ:
+        ret = parent->read(parent, leader->gstart, leader->gcount,
+                           leader->gbuffer);
+        break;
+
+      case PART_OP_BWRITE:
+        ret = parent->bwrite(parent, leader->gstart, leader->gcount,
+                             leader->gbuffer);
+        break;
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+      case PART_OP_WRITE:
+        ret = parent->write(parent, leader->gstart, leader->gcount,
+                            leader->gbuffer);
+        break;
+#endif
+
+      case PART_OP_ERASE:
+        ret = parent->erase(parent, leader->gstart, leader->gcount);
+        break;
+
+      default:
+        ret = -ENOSYS;
+        break;
+    }
+
+  /* Each request receives the part of the result that covers its range.
+   * Erase methods do not all return the block count, so an erase result
+   * is only scaled if it is the count of the whole group.
+   */
+
+  now = clock_systimer();
+  req = leader;
+
+  do
+    {
+      next = (req == leader) ? leader->group : req->flink;
+
+      if (ret < 0)
+        {
+          req->result = ret;
+        }
+      else if (req->op == PART_OP_ERASE)
+        {
+          req->result = ((size_t)ret == leader->gcount) ?
+                        (ssize_t)req->count : ret;
+        }
+      else
+        {
+          done = (off_t)ret - (req->start - leader->gstart);
+          req->result = done <= 0 ? 0 :
+                        ((size_t)done > req->count ? (ssize_t)req->count :
+                        (ssize_t)done);
+        }
+
+      part_sched_account(req, now);
+
+      if (req != leader)
+        {
+          /* The submitter will release its request as soon as it wakes */
+
+          req->part->stats.nmerged++;
+          req->completed = true;
+          nxsem_post(&req->done);
+        }
+
+      req = next;
+    }
+  while (req != NULL);
+
+  part_sched_wait(&sched->exclsem);
+  part_sched_admit(sched);
+  nxsem_post(&sched->exclsem);
+}
+
+/****************************************************************************
+ * Name: part_sched_submit
+ *
+ * Description:
+ *   Submit one request to the scheduler of the parent device and wait for
+ *   it to complete.  'start' and 'count' are already translated to units
+ *   of the parent device.
+ *
+ ****************************************************************************/
+
+static ssize_t part_sched_submit(FAR struct mtd_partition_s *priv,
+                                 uint8_t op, off_t start, size_t count,
+                                 FAR uint8_t *buffer)
+{
+  FAR struct part_sched_s *sched = priv->sched;
+  struct part_req_s req;
+
+  memset(&req, 0, sizeof(struct part_req_s));
+  req.part   = priv;
+  req.start  = start;
+  req.count  = count;
+  req.buffer = buffer;
+  req.op     = op;
+  req.queued = clock_systimer();
+
+  nxsem_init(&req.done, 0, 0);
+  nxsem_setprotocol(&req.done, SEM_PRIO_NONE);
+
+  part_sched_wait(&sched->exclsem);
+  if (!sched->busy)
+    {
+      /* The device is idle (and so the queue is empty).  Take it now. */
+
+      sched->busy = true;
+      part_sched_merge(sched, &req);
+      nxsem_post(&sched->exclsem);
+    }
+  else
+    {
+      /* Queue the request and wait until it is admitted or until it is
+       * completed as part of the group of another request.
+       */
+
+      if (sched->tail == NULL)
+        {
+          sched->head = &req;
+        }
+      else
+        {
+          sched->tail->flink = &req;
+        }
+
+      sched->tail = &req;
+      nxsem_post(&sched->exclsem);
+
+      part_sched_wait(&req.done);
+    }
+
+  if (!req.completed)
+    {
+      part_sched_run(sched, &req);
+    }
+
+  nxsem_destroy(&req.done);
+  return req.result;
+}
+
+/****************************************************************************
+ * Name: part_sched_get
+ *
+ * Description:
+ *   Return the scheduler of a parent device, creating it for the first
+ *   partition of the device.
+ *
+ ****************************************************************************/
+
+static FAR struct part_sched_s *part_sched_get(FAR struct mtd_dev_s *mtd,
+                                              size_t blocksize)
+{
+  FAR struct part_sched_s *sched;
+
+  for (sched = g_partsched; sched != NULL; sched = sched->flink)
+    {
+      if (sched->parent == mtd)
+        {
+          return sched;
+        }
+    }
+
+  sched = (FAR struct part_sched_s *)kmm_zalloc(sizeof(struct part_sched_s));
+  if (sched != NULL)
+    {
+      sched->parent    = mtd;
+      sched->blocksize = blocksize;
+      nxsem_init(&sched->exclsem, 0, 1);
+
+      sched->flink     = g_partsched;
+      g_partsched      = sched;
+    }
+
+  return sched;
+}
+#endif /* CONFIG_MTD_PARTITION_SCHED */
+
 /****************************************************************************
  * Name: part_erase
  *
@@ -248,7 +836,12 @@ static int part_erase(FAR struct mtd_dev_s *dev, off_t startblock,
   eoffset = priv->firstblock / priv->blkpererase;
   DEBUGASSERT(eoffset * priv->blkpererase == priv->firstblock);
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+  return (int)part_sched_submit(priv, PART_OP_ERASE, startblock + eoffset,
+                                nblocks, NULL);
+#else
   return priv->parent->erase(priv->parent, startblock + eoffset, nblocks);
+#endif
 }
 
 /****************************************************************************
@@ -278,8 +871,13 @@ static ssize_t part_bread(FAR struct mtd_dev_s *dev, off_t startblock,
    * underlying MTD driver perform the read.
    */
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+  return part_sched_submit(priv, PART_OP_BREAD,
+                           startblock + priv->firstblock, nblocks, buf);
+#else
   return priv->parent->bread(priv->parent, startblock + priv->firstblock,
                              nblocks, buf);
+#endif
 }
 
 /****************************************************************************
@@ -309,8 +907,14 @@ static ssize_t part_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
    * underlying MTD driver perform the write.
    */
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+  return part_sched_submit(priv, PART_OP_BWRITE,
+                           startblock + priv->firstblock, nblocks,
+                           (FAR uint8_t *)buf);
+#else
   return priv->parent->bwrite(priv->parent, startblock + priv->firstblock,
                               nblocks, buf);
+#endif
 }
 
 /****************************************************************************
@@ -346,7 +950,12 @@ static ssize_t part_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
        */
 
       newoffset = offset + priv->firstblock * priv->blocksize;
+#ifdef CONFIG_MTD_PARTITION_SCHED
+      return part_sched_submit(priv, PART_OP_READ, newoffset, nbytes,
+                               buffer);
+#else
       return priv->parent->read(priv->parent, newoffset, nbytes, buffer);
+#endif
     }
 
   /* The underlying MTD driver does not support the read() method */
@@ -384,7 +993,12 @@ static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes
        */
 
       newoffset = offset + priv->firstblock * priv->blocksize;
+#ifdef CONFIG_MTD_PARTITION_SCHED
+      return part_sched_submit(priv, PART_OP_WRITE, newoffset, nbytes,
+                               (FAR uint8_t *)buffer);
+#else
       return priv->parent->write(priv->parent, newoffset, nbytes, buffer);
+#endif
     }
 
   /* The underlying MTD driver does not support the write() method */
@@ -450,9 +1064,50 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         {
           /* Erase the entire partition */
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+          ret = (int)part_sched_submit(priv, PART_OP_ERASE,
+                                       priv->firstblock / priv->blkpererase,
+                                       priv->neraseblocks, NULL);
+#else
           ret = priv->parent->erase(priv->parent,
                                     priv->firstblock / priv->blkpererase,
                                     priv->neraseblocks);
+#endif
+        }
+        break;
+
+#ifdef CONFIG_MTD_PARTITION_SCHED
+      case MTDIOC_GETSTATS:
+        {
+          FAR struct mtd_stats_s *stats = (FAR struct mtd_stats_s *)arg;
+          if (stats)
+            {
+              memcpy(stats, &priv->stats, sizeof(struct mtd_stats_s));
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
+      case MTDIOC_ERASESTART:
+        {
+          /* The argument is an erase block number relative to the start of
+           * the partition.
+           */
+
+          off_t eblock = (off_t)arg;
+
+          if (eblock < 0 || eblock >= priv->neraseblocks)
+            {
+              ferr("ERROR: Erase beyond the end of the partition\n");
+              ret = -ENXIO;
+            }
+          else
+            {
+              ret = priv->parent->ioctl(priv->parent, MTDIOC_ERASESTART,
+                                        (unsigned long)(eblock +
+                                        priv->firstblock / priv->blkpererase));
+            }
         }
         break;
 
@@ -863,6 +1518,24 @@ FAR struct mtd_dev_s *mtd_partition(FAR struct mtd_dev_s *mtd, off_t firstblock,
   part->name         = NULL;
 #endif
 
+#ifdef CONFIG_MTD_PARTITION_SCHED
+  /* All partitions of the same device share one scheduler */
+
+  part->sched        = part_sched_get(mtd, geo.blocksize);
+  if (part->sched == NULL)
+    {
+      ferr("ERROR: Failed to allocate the partition scheduler\n");
+      kmm_free(part);
+      return NULL;
+    }
+
+#ifdef CONFIG_MTD_REGISTRATION
+  /* Register the partition so that its statistics appear in /proc/mtd */
+
+  mtd_register(&part->child, "part");
+#endif
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_PROCFS_EXCLUDE_PARTITIONS)
   /* Add this partition to the list of known partitions */
 
@@ -911,6 +1584,11 @@ int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name)
 
   /* Allocate space for the name */
   priv->name = name;
+
+#if defined(CONFIG_MTD_PARTITION_SCHED) && defined(CONFIG_MTD_REGISTRATION)
+  priv->child.name = name;
+#endif
+
   return OK;
 }
 #endif
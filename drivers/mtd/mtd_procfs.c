@@ -53,6 +53,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -64,6 +65,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Average and worst latency in milliseconds */
+
+#ifdef CONFIG_MTD_PARTITION_SCHED
+#  define MTD_AVGMSEC(t,n)  ((n) > 0 ? (unsigned long)TICK2MSEC((t) / (n)) : 0ul)
+#  define MTD_MAXMSEC(t)    ((unsigned long)TICK2MSEC(t))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -198,6 +206,9 @@ static ssize_t mtd_read(FAR struct file *filep, FAR char *buffer,
                            size_t buflen)
 {
   FAR struct mtd_file_s *priv;
+#ifdef CONFIG_MTD_PARTITION_SCHED
+  struct mtd_stats_s stats;
+#endif
   ssize_t total = 0;
   ssize_t ret;
 
@@ -219,15 +230,52 @@ static ssize_t mtd_read(FAR struct file *filep, FAR char *buffer,
 
       if (priv->pnextmtd == g_pfirstmtd)
         {
+#ifdef CONFIG_MTD_PARTITION_SCHED
+          total = snprintf(buffer, buflen,
+                           "Num  Device       Reads  Writes  Erases  Merged"
+                           "     RdKb     WrKb     ErKb   Read ms  Write ms"
+                           "  Erase ms\n");
+#else
           total = snprintf(buffer, buflen, "Num  Device\n");
+#endif
         }
 
       /* The provide the requested data */
 
       do
         {
-          ret = snprintf(&buffer[total], buflen - total, "%-5d%s\n",
-                         priv->pnextmtd->mtdno, priv->pnextmtd->name);
+#ifdef CONFIG_MTD_PARTITION_SCHED
+          /* Scheduled partitions also report their statistics as
+           * counts, kilobytes and average/worst latencies.
+           */
+
+          if (MTD_IOCTL(priv->pnextmtd, MTDIOC_GETSTATS,
+                        (unsigned long)((uintptr_t)&stats)) == OK)
+            {
+              ret = snprintf(&buffer[total], buflen - total,
+                             "%-5d%-10s %7lu %7lu %7lu %7lu %8lu %8lu %8lu"
+                             " %4lu/%-4lu %4lu/%-4lu %4lu/%-4lu\n",
+                             priv->pnextmtd->mtdno, priv->pnextmtd->name,
+                             (unsigned long)stats.nreads,
+                             (unsigned long)stats.nwrites,
+                             (unsigned long)stats.nerases,
+                             (unsigned long)stats.nmerged,
+                             (unsigned long)(stats.rdbytes >> 10),
+                             (unsigned long)(stats.wrbytes >> 10),
+                             (unsigned long)(stats.erbytes >> 10),
+                             MTD_AVGMSEC(stats.rdticks, stats.nreads),
+                             MTD_MAXMSEC(stats.rdmax),
+                             MTD_AVGMSEC(stats.wrticks, stats.nwrites),
+                             MTD_MAXMSEC(stats.wrmax),
+                             MTD_AVGMSEC(stats.erticks, stats.nerases),
+                             MTD_MAXMSEC(stats.ermax));
+            }
+          else
+#endif
+            {
+              ret = snprintf(&buffer[total], buflen - total, "%-5d%s\n",
+                             priv->pnextmtd->mtdno, priv->pnextmtd->name);
+            }
 
           if (ret + total < buflen)
             {
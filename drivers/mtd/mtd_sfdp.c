@@ -0,0 +1,374 @@
+/****************************************************************************
+ * drivers/mtd/mtd_sfdp.c
+ * Serial Flash Discoverable Parameters (JESD216)
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mtd/sfdp.h>
+
+#ifdef CONFIG_MTD_SFDP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SFDP header */
+
+#define SFDP_SIGNATURE          0x50444653  /* "SFDP", little endian */
+#define SFDP_HDR_SIZE           8
+#define SFDP_PHDR_SIZE          8
+
+/* JEDEC basic FLASH parameter table (BFPT) */
+
+#define SFDP_BFPT_ID            0xff00
+#define SFDP_BFPT_MAJOR         1
+#define SFDP_BFPT_MINDWORDS     9          /* JESD216 */
+#define SFDP_BFPT_MAXDWORDS     16         /* JESD216B, the rest is ignored */
+
+/* DWORD 1 */
+
+#define BFPT1_ERASE4K_MASK      (3 << 0)
+#define BFPT1_ERASE4K           (1 << 0)
+#define BFPT1_ERASE4K_OPCODE(d) (((d) >> 8) & 0xff)
+#define BFPT1_FAST_1_1_2        (1 << 16)
+#define BFPT1_ADDRMODE(d)       (((d) >> 17) & 3)
+#define BFPT1_DTR               (1 << 19)
+#define BFPT1_FAST_1_2_2        (1 << 20)
+#define BFPT1_FAST_1_4_4        (1 << 21)
+#define BFPT1_FAST_1_1_4        (1 << 22)
+
+/* DWORD 2 */
+
+#define BFPT2_DENSITY_POW2      (1 << 31)
+#define BFPT2_DENSITY_MASK      0x7fffffff
+
+/* DWORDs 3 and 4 hold two read mode descriptions each; DWORDs 8 and 9 hold
+ * two erase type descriptions each.
+ */
+
+#define BFPT_LOHALF(d)          ((d) & 0xffff)
+#define BFPT_HIHALF(d)          ((d) >> 16)
+
+#define BFPT_RD_WAIT(h)         ((h) & 0x1f)
+#define BFPT_RD_MODE(h)         (((h) >> 5) & 7)
+#define BFPT_RD_OPCODE(h)       (((h) >> 8) & 0xff)
+
+#define BFPT_ER_SHIFT(h)        ((h) & 0xff)
+#define BFPT_ER_OPCODE(h)       (((h) >> 8) & 0xff)
+
+/* DWORD 11 */
+
+#define BFPT11_PAGESHIFT(d)     (((d) >> 4) & 0x0f)
+
+/* Fast read (1-1-1) is always available */
+
+#define SFDP_FAST_READ          0x0b
+#define SFDP_FAST_READ_DUMMIES  8
+
+/* Default program page size */
+
+#define SFDP_DEFAULT_PAGESHIFT  8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Read modes in order of preference */
+
+static const uint8_t g_rdpreference[SFDP_READ_NMODES] =
+{
+  SFDP_READ_1_4_4, SFDP_READ_1_1_4, SFDP_READ_1_2_2, SFDP_READ_1_1_2,
+  SFDP_READ_1_1_1
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sfdp_getle32
+ ****************************************************************************/
+
+static uint32_t sfdp_getle32(FAR const uint8_t *src)
+{
+  return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+         ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+/****************************************************************************
+ * Name: sfdp_rdmode
+ *
+ * Description:
+ *   Decode one half-DWORD read mode description
+ *
+ ****************************************************************************/
+
+static void sfdp_rdmode(FAR struct sfdp_rdmode_s *rdmode, uint32_t desc)
+{
+  rdmode->opcode  = BFPT_RD_OPCODE(desc);
+  rdmode->dummies = BFPT_RD_WAIT(desc) + BFPT_RD_MODE(desc);
+}
+
+/****************************************************************************
+ * Name: sfdp_erase
+ *
+ * Description:
+ *   Decode one half-DWORD erase type description
+ *
+ ****************************************************************************/
+
+static void sfdp_erase(FAR struct sfdp_erase_s *erase, uint32_t desc)
+{
+  erase->shift  = BFPT_ER_SHIFT(desc);
+  erase->opcode = erase->shift != 0 ? BFPT_ER_OPCODE(desc) : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sfdp_probe
+ *
+ * Description:
+ *   Read and decode the SFDP header and the JEDEC basic FLASH parameter
+ *   table of a serial NOR FLASH.
+ *
+ ****************************************************************************/
+
+int sfdp_probe(sfdp_read_t read, FAR void *arg, FAR struct sfdp_s *sfdp)
+{
+  uint8_t buffer[4 * SFDP_BFPT_MAXDWORDS];
+  uint32_t bfpt[SFDP_BFPT_MAXDWORDS];
+  uint32_t density;
+  uint32_t ptr = 0;
+  unsigned int ndwords = 0;
+  unsigned int nphdrs;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(read != NULL && sfdp != NULL);
+  memset(sfdp, 0, sizeof(struct sfdp_s));
+
+  /* Read and verify the SFDP header */
+
+  ret = read(arg, 0, buffer, SFDP_HDR_SIZE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (sfdp_getle32(buffer) != SFDP_SIGNATURE)
+    {
+      finfo("No SFDP signature\n");
+      return -ENODEV;
+    }
+
+  /* Find the most recent revision of the basic parameter table.  There is
+   * always one, described by the first parameter header.
+   */
+
+  nphdrs = buffer[6] + 1;
+  for (i = 0; i < nphdrs; i++)
+    {
+      ret = read(arg, SFDP_HDR_SIZE + i * SFDP_PHDR_SIZE, buffer,
+                 SFDP_PHDR_SIZE);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if ((buffer[0] | (buffer[7] << 8)) == SFDP_BFPT_ID &&
+          buffer[2] == SFDP_BFPT_MAJOR && buffer[3] >= SFDP_BFPT_MINDWORDS &&
+          (ndwords == 0 || buffer[1] > sfdp->minor))
+        {
+          sfdp->major = buffer[2];
+          sfdp->minor = buffer[1];
+          ndwords     = buffer[3];
+          ptr         = buffer[4] | (buffer[5] << 8) |
+                        ((uint32_t)buffer[6] << 16);
+        }
+    }
+
+  if (ndwords == 0)
+    {
+      ferr("ERROR: No basic FLASH parameter table\n");
+      return -ENODEV;
+    }
+
+  if (ndwords > SFDP_BFPT_MAXDWORDS)
+    {
+      ndwords = SFDP_BFPT_MAXDWORDS;
+    }
+
+  /* Read the table.  Missing DWORDs of older revisions read as zero */
+
+  ret = read(arg, ptr, buffer, 4 * ndwords);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(bfpt, 0, sizeof(bfpt));
+  for (i = 0; i < ndwords; i++)
+    {
+      bfpt[i] = sfdp_getle32(&buffer[4 * i]);
+    }
+
+  /* DWORD 1:  Supported modes and addressing */
+
+  sfdp->addrmode = BFPT1_ADDRMODE(bfpt[0]);
+  if (sfdp->addrmode > SFDP_ADDR_4BYTE)
+    {
+      sfdp->addrmode = SFDP_ADDR_3BYTE;
+    }
+
+  sfdp->dtr = (bfpt[0] & BFPT1_DTR) != 0;
+
+  /* DWORD 2:  Density in bits */
+
+  density = bfpt[1] & BFPT2_DENSITY_MASK;
+  if ((bfpt[1] & BFPT2_DENSITY_POW2) != 0)
+    {
+      sfdp->size = density >= 3 && density < 67 ?
+                   (uint64_t)1 << (density - 3) : 0;
+    }
+  else
+    {
+      sfdp->size = ((uint64_t)density + 1) >> 3;
+    }
+
+  if (sfdp->size == 0)
+    {
+      ferr("ERROR: Bad density: %08lx\n", (unsigned long)bfpt[1]);
+      return -ENODEV;
+    }
+
+  /* DWORDs 3 and 4:  Fast read modes */
+
+  sfdp->read[SFDP_READ_1_1_1].opcode  = SFDP_FAST_READ;
+  sfdp->read[SFDP_READ_1_1_1].dummies = SFDP_FAST_READ_DUMMIES;
+
+  if ((bfpt[0] & BFPT1_FAST_1_4_4) != 0)
+    {
+      sfdp_rdmode(&sfdp->read[SFDP_READ_1_4_4], BFPT_LOHALF(bfpt[2]));
+    }
+
+  if ((bfpt[0] & BFPT1_FAST_1_1_4) != 0)
+    {
+      sfdp_rdmode(&sfdp->read[SFDP_READ_1_1_4], BFPT_HIHALF(bfpt[2]));
+    }
+
+  if ((bfpt[0] & BFPT1_FAST_1_1_2) != 0)
+    {
+      sfdp_rdmode(&sfdp->read[SFDP_READ_1_1_2], BFPT_LOHALF(bfpt[3]));
+    }
+
+  if ((bfpt[0] & BFPT1_FAST_1_2_2) != 0)
+    {
+      sfdp_rdmode(&sfdp->read[SFDP_READ_1_2_2], BFPT_HIHALF(bfpt[3]));
+    }
+
+  /* DWORDs 8 and 9:  Erase types.  Fall back to the 4KiB erase opcode of
+   * DWORD 1 if none is described.
+   */
+
+  sfdp_erase(&sfdp->erase[0], BFPT_LOHALF(bfpt[7]));
+  sfdp_erase(&sfdp->erase[1], BFPT_HIHALF(bfpt[7]));
+  sfdp_erase(&sfdp->erase[2], BFPT_LOHALF(bfpt[8]));
+  sfdp_erase(&sfdp->erase[3], BFPT_HIHALF(bfpt[8]));
+
+  if (sfdp->erase[0].opcode == 0 && sfdp->erase[1].opcode == 0 &&
+      sfdp->erase[2].opcode == 0 && sfdp->erase[3].opcode == 0 &&
+      (bfpt[0] & BFPT1_ERASE4K_MASK) == BFPT1_ERASE4K)
+    {
+      sfdp->erase[0].opcode = BFPT1_ERASE4K_OPCODE(bfpt[0]);
+      sfdp->erase[0].shift  = 12;
+    }
+
+  /* DWORD 11 (JESD216A and later):  Page size */
+
+  sfdp->pageshift = SFDP_DEFAULT_PAGESHIFT;
+  if (ndwords >= 11 && BFPT11_PAGESHIFT(bfpt[10]) != 0)
+    {
+      sfdp->pageshift = BFPT11_PAGESHIFT(bfpt[10]);
+    }
+
+  finfo("SFDP %u.%u: size=%llu page=%u addrmode=%u 1-4-4=%02x/%u\n",
+        sfdp->major, sfdp->minor, (unsigned long long)sfdp->size,
+        1 << sfdp->pageshift, sfdp->addrmode,
+        sfdp->read[SFDP_READ_1_4_4].opcode,
+        sfdp->read[SFDP_READ_1_4_4].dummies);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sfdp_readmode
+ *
+ * Description:
+ *   Select the fastest read mode that is supported by both the device and
+ *   the controller.
+ *
+ ****************************************************************************/
+
+int sfdp_readmode(FAR const struct sfdp_s *sfdp, unsigned int modes)
+{
+  int mode;
+  int i;
+
+  for (i = 0; i < SFDP_READ_NMODES; i++)
+    {
+      mode = g_rdpreference[i];
+      if ((modes & SFDP_MODE(mode)) != 0 && sfdp->read[mode].opcode != 0)
+        {
+          return mode;
+        }
+    }
+
+  return -ENOSYS;
+}
+
+#endif /* CONFIG_MTD_SFDP */
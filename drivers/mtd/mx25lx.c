@@ -80,6 +80,18 @@
 #  define CONFIG_MX25L_SPIFREQUENCY 20000000
 #endif
 
+/* Asynchronous erase.  Sector erases are left running in the background and
+ * subsequent reads of other sectors suspend them.  The MTDIOC_ERASESTART
+ * ioctl is not available with CONFIG_MX25L_SECTOR512.
+ */
+
+#ifdef CONFIG_MTD_ASYNC_ERASE
+#  define MX25L_ERASE_SUSPEND 1
+#  ifndef CONFIG_MX25L_SECTOR512
+#    define MX25L_ASYNC_ERASE 1
+#  endif
+#endif
+
 /* Chip Geometries ******************************************************************/
 
 /* MX25L3233F capacity is 32Mbit  (4096Kbit x 8) =   4Mb (512kb x 8) */
@@ -179,6 +191,10 @@
 #define MX25L_SR_QE                 (1 << 6)  /* Bit 6: Quad enable */
 #define MX25L_SR_SRWD               (1 << 7)  /* Bit 7: Status register write protect */
 
+/* Security register bit definitions */
+
+#define MX25L_SCUR_ESB              (1 << 3)  /* Bit 3: Erase suspended */
+
 /* Configuration registerregister bit definitions */
 
 #define MX25L_CR_ODS                (1 << 0)  /* Bit 0: Output driver strength */
@@ -213,6 +229,10 @@ struct mx25l_dev_s
   uint8_t               sectorshift;
   uint8_t               pageshift;
   uint16_t              nsectors;
+#ifdef MX25L_ERASE_SUSPEND
+  bool                  erasing;     /* True: A sector erase may be in progress */
+  uint16_t              esector;     /* The sector being erased */
+#endif
 #if defined(CONFIG_MX25L_SECTOR512)
   uint8_t               flags;       /* Buffered sector flags */
   uint16_t              esectno;     /* Erase sector number in the cache */
@@ -229,7 +249,16 @@ struct mx25l_dev_s
 static void mx25l_lock(FAR struct spi_dev_s *dev);
 static inline void mx25l_unlock(FAR struct spi_dev_s *dev);
 static inline int mx25l_readid(FAR struct mx25l_dev_s *priv);
+static uint8_t mx25l_rdsr(FAR struct mx25l_dev_s *priv);
 static void mx25l_waitwritecomplete(FAR struct mx25l_dev_s *priv);
+#ifdef MX25L_ERASE_SUSPEND
+static void mx25l_erasewait(FAR struct mx25l_dev_s *priv);
+static bool mx25l_erasesuspend(FAR struct mx25l_dev_s *priv, off_t address,
+                               size_t nbytes);
+static void mx25l_eraseresume(FAR struct mx25l_dev_s *priv);
+#else
+#  define mx25l_erasewait(p)
+#endif
 static void mx25l_writeenable(FAR struct mx25l_dev_s *priv);
 static void mx25l_writedisable(FAR struct mx25l_dev_s *priv);
 static inline void mx25l_sectorerase(FAR struct mx25l_dev_s *priv, off_t offset);
@@ -362,32 +391,44 @@ static inline int mx25l_readid(FAR struct mx25l_dev_s *priv)
 }
 
 /************************************************************************************
- * Name: mx25l_waitwritecomplete
+ * Name: mx25l_rdsr
  ************************************************************************************/
 
-static void mx25l_waitwritecomplete(FAR struct mx25l_dev_s *priv)
+static uint8_t mx25l_rdsr(FAR struct mx25l_dev_s *priv)
 {
   uint8_t status;
 
-  /* Loop as long as the memory is busy with a write cycle */
+  /* Select this FLASH part */
 
-  do
-    {
-      /* Select this FLASH part */
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
 
-      SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
+  /* Send "Read Status Register (RDSR)" command */
 
-      /* Send "Read Status Register (RDSR)" command */
+  (void)SPI_SEND(priv->dev, MX25L_RDSR);
 
-      (void)SPI_SEND(priv->dev, MX25L_RDSR);
+  /* Send a dummy byte to generate the clock needed to shift out the status */
 
-      /* Send a dummy byte to generate the clock needed to shift out the status */
+  status = SPI_SEND(priv->dev, MX25L_DUMMY);
 
-      status = SPI_SEND(priv->dev, MX25L_DUMMY);
+  /* Deselect the FLASH */
 
-      /* Deselect the FLASH */
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+  return status;
+}
 
-      SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+/************************************************************************************
+ * Name: mx25l_waitwritecomplete
+ ************************************************************************************/
+
+static void mx25l_waitwritecomplete(FAR struct mx25l_dev_s *priv)
+{
+  uint8_t status;
+
+  /* Loop as long as the memory is busy with a write cycle */
+
+  do
+    {
+      status = mx25l_rdsr(priv);
 
       /* Given that writing could take up to few tens of milliseconds, and erasing
        * could take more.  The following short delay in the "busy" case will allow
@@ -406,6 +447,108 @@ static void mx25l_waitwritecomplete(FAR struct mx25l_dev_s *priv)
   mxlinfo("Complete\n");
 }
 
+/************************************************************************************
+ * Name: mx25l_erasewait
+ *
+ * Description:
+ *   Wait for a sector erase left running in the background to complete.  This
+ *   must precede any operation other than a read.
+ *
+ ************************************************************************************/
+
+#ifdef MX25L_ERASE_SUSPEND
+static void mx25l_erasewait(FAR struct mx25l_dev_s *priv)
+{
+  if (priv->erasing)
+    {
+      mx25l_waitwritecomplete(priv);
+      priv->erasing = false;
+    }
+}
+
+/************************************************************************************
+ * Name: mx25l_erasesuspend
+ *
+ * Description:
+ *   If a sector erase is in progress, suspend it so that the range
+ *   [address, address + nbytes) can be read.  A read of the sector being
+ *   erased must wait for the erase to complete instead.
+ *
+ * Returned Value:
+ *   True if the erase was suspended and must be resumed with
+ *   mx25l_eraseresume() after the read.
+ *
+ ************************************************************************************/
+
+static bool mx25l_erasesuspend(FAR struct mx25l_dev_s *priv, off_t address,
+                               size_t nbytes)
+{
+  off_t first;
+  off_t last;
+  uint8_t scur;
+
+  if (!priv->erasing || nbytes == 0)
+    {
+      return false;
+    }
+
+  first = address >> priv->sectorshift;
+  last  = (address + nbytes - 1) >> priv->sectorshift;
+
+  if (priv->esector >= first && priv->esector <= last)
+    {
+      return false;
+    }
+
+  if ((mx25l_rdsr(priv) & MX25L_SR_WIP) == 0)
+    {
+      /* The erase has already completed */
+
+      priv->erasing = false;
+      return false;
+    }
+
+  /* Send the "Erase Suspend" instruction */
+
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->dev, MX25L_ERS_SUSPEND);
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+
+  /* WIP clears within the erase suspend latency (20 microseconds).  That is
+   * too short to be worth sleeping.
+   */
+
+  while ((mx25l_rdsr(priv) & MX25L_SR_WIP) != 0);
+
+  /* The erase may have completed before the suspend was accepted */
+
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->dev, MX25L_RDSCUR);
+  scur = SPI_SEND(priv->dev, MX25L_DUMMY);
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+
+  if ((scur & MX25L_SCUR_ESB) == 0)
+    {
+      priv->erasing = false;
+      return false;
+    }
+
+  mxlinfo("Suspended erase of sector %u\n", priv->esector);
+  return true;
+}
+
+/************************************************************************************
+ * Name: mx25l_eraseresume
+ ************************************************************************************/
+
+static void mx25l_eraseresume(FAR struct mx25l_dev_s *priv)
+{
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->dev, MX25L_ERS_RESUME);
+  SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+}
+#endif
+
 /************************************************************************************
  * Name:  mx25l_writeenable
  ************************************************************************************/
@@ -460,6 +603,10 @@ static void mx25l_sectorerase(FAR struct mx25l_dev_s *priv, off_t sector)
 
   mxlinfo("sector: %08lx\n", (long)sector);
 
+  /* Wait for any erase left running in the background */
+
+  mx25l_erasewait(priv);
+
   /* Send write enable instruction */
 
   mx25l_writeenable(priv);
@@ -487,7 +634,16 @@ static void mx25l_sectorerase(FAR struct mx25l_dev_s *priv, off_t sector)
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
 
+#ifdef MX25L_ERASE_SUSPEND
+  /* Leave the erase running.  The next operation will wait for it or, if it
+   * is a read of some other sector, suspend it.
+   */
+
+  priv->erasing = true;
+  priv->esector = (uint16_t)sector;
+#else
   mx25l_waitwritecomplete(priv);
+#endif
 
   mxlinfo("Erased\n");
 }
@@ -500,6 +656,10 @@ static inline int mx25l_chiperase(FAR struct mx25l_dev_s *priv)
 {
   mxlinfo("priv: %p\n", priv);
 
+  /* Wait for any erase left running in the background */
+
+  mx25l_erasewait(priv);
+
   /* Send write enable instruction */
 
   mx25l_writeenable(priv);
@@ -529,15 +689,28 @@ static inline int mx25l_chiperase(FAR struct mx25l_dev_s *priv)
 static void mx25l_byteread(FAR struct mx25l_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
+#ifdef MX25L_ERASE_SUSPEND
+  bool suspended;
+#endif
+
   mxlinfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef MX25L_ERASE_SUSPEND
+  /* Suspend an erase of some other sector rather than waiting for it */
 
-  mx25l_waitwritecomplete(priv);
+  suspended = mx25l_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  /* Make sure that writing is disabled */
+      mx25l_erasewait(priv);
+      mx25l_waitwritecomplete(priv);
 
-  mx25l_writedisable(priv);
+      /* Make sure that writing is disabled */
+
+      mx25l_writedisable(priv);
+    }
 
   /* Select this FLASH part */
 
@@ -564,6 +737,13 @@ static void mx25l_byteread(FAR struct mx25l_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+
+#ifdef MX25L_ERASE_SUSPEND
+  if (suspended)
+    {
+      mx25l_eraseresume(priv);
+    }
+#endif
 }
 
 /************************************************************************************
@@ -576,6 +756,10 @@ static inline void mx25l_pagewrite(FAR struct mx25l_dev_s *priv,
 {
   mxlinfo("address: %08lx nwords: %d\n", (long)address, (int)nbytes);
 
+  /* Wait for any erase left running in the background */
+
+  mx25l_erasewait(priv);
+
   for (; nbytes > 0; nbytes -= (1 << priv->pageshift))
     {
       /* Enable the write access to the FLASH */
@@ -955,6 +1139,43 @@ static int mx25l_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef MX25L_ASYNC_ERASE
+      case MTDIOC_ERASESTART:
+        {
+          /* Start erasing one sector but do not wait for it to complete */
+
+          if (arg >= priv->nsectors)
+            {
+              ret = -ENXIO;
+            }
+          else
+            {
+              mx25l_lock(priv->dev);
+              mx25l_sectorerase(priv, (off_t)arg);
+              mx25l_unlock(priv->dev);
+              ret = OK;
+            }
+        }
+        break;
+
+      case MTDIOC_ERASESTATUS:
+        {
+          mx25l_lock(priv->dev);
+          if ((mx25l_rdsr(priv) & MX25L_SR_WIP) != 0)
+            {
+              ret = -EBUSY;
+            }
+          else
+            {
+              priv->erasing = false;
+              ret = OK;
+            }
+
+          mx25l_unlock(priv->dev);
+        }
+        break;
+#endif
+
       case MTDIOC_XIPBASE:
       default:
         ret = -ENOTTY; /* Bad command */
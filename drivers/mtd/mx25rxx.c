@@ -45,6 +45,7 @@
 #include <debug.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
@@ -52,6 +53,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/qspi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/sfdp.h>
 
 /******************************************************************************
  * Pre-processor Definitions
@@ -140,6 +142,12 @@
 #define MX25R_CR_TB                 (1 << 3)  /* Bit 3: Top/bottom selected */
 #define MX25R_CR_DC                 (1 << 6)  /* Bit 6: Dummy cycle */
 
+/* Read modes that can be requested from the QuadSPI controller */
+
+#define MX25R_SFDP_MODES            (SFDP_MODE(SFDP_READ_1_1_1) | \
+                                     SFDP_MODE(SFDP_READ_1_2_2) | \
+                                     SFDP_MODE(SFDP_READ_1_4_4))
+
 /************************************************************************************
  * Private Types
  ************************************************************************************/
@@ -156,6 +164,14 @@ struct mx25rxx_dev_s
   uint8_t                sectorshift; /* 16 or 18 */
   uint8_t                pageshift;   /* 8 */
   uint16_t               nsectors;    /* 128 or 64 */
+
+  uint8_t                rdcmd;       /* Read command */
+  uint8_t                rddummies;   /* Dummy cycles of the read command */
+  uint8_t                rdflags;     /* QSPIMEM_* flags of the read command */
+
+#ifdef CONFIG_MX25RXX_XIP
+  FAR uint8_t           *xipbase;     /* Base of the mapped FLASH, NULL if unmapped */
+#endif
 };
 
 /******************************************************************************
@@ -176,7 +192,7 @@ static int mx25rxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
 
 /* Internal driver methods */
 
-static void mx25rxx_lock(FAR struct qspi_dev_s *qspi, bool read);
+static void mx25rxx_lock(FAR struct mx25rxx_dev_s *dev, bool read);
 static void mx25rxx_unlock(FAR struct qspi_dev_s *qspi);
 static int mx25rxx_command_read(FAR struct qspi_dev_s *qspi, uint8_t cmd,
                                 FAR void *buffer, size_t buflen);
@@ -187,6 +203,15 @@ static int mx25rxx_command_address(FAR struct qspi_dev_s *qspi, uint8_t cmd,
                                   off_t addr, uint8_t addrlen);
 
 static int mx25rxx_readid(struct mx25rxx_dev_s *dev);
+#ifdef CONFIG_MTD_SFDP
+static int mx25rxx_sfdp_read(FAR void *arg, uint32_t addr, FAR void *buffer,
+                             size_t buflen);
+static void mx25rxx_sfdp(FAR struct mx25rxx_dev_s *dev);
+#endif
+#ifdef CONFIG_MX25RXX_XIP
+static int mx25rxx_xipmap(FAR struct mx25rxx_dev_s *dev);
+static void mx25rxx_xipunmap(FAR struct mx25rxx_dev_s *dev);
+#endif
 static int mx25rxx_read_byte(FAR struct mx25rxx_dev_s *dev,
                              FAR uint8_t *buffer, off_t address, size_t buflen);
 static int mx25rxx_read_status(FAR struct mx25rxx_dev_s *dev);
@@ -205,8 +230,10 @@ static int mx25rxx_erase_chip(struct mx25rxx_dev_s *priv);
  * Private Functions
  ******************************************************************************/
 
-void mx25rxx_lock(FAR struct qspi_dev_s *qspi, bool read)
+void mx25rxx_lock(FAR struct mx25rxx_dev_s *dev, bool read)
 {
+  FAR struct qspi_dev_s *qspi = dev->qspi;
+
   /* On SPI busses where there are multiple devices, it will be necessary to
    * lock SPI to have exclusive access to the busses for a sequence of
    * transfers.  The bus should be locked before the chip is selected.
@@ -218,6 +245,15 @@ void mx25rxx_lock(FAR struct qspi_dev_s *qspi, bool read)
 
   (void)QSPI_LOCK(qspi, true);
 
+#ifdef CONFIG_MX25RXX_XIP
+  /* Only reads are possible while the FLASH is memory mapped */
+
+  if (!read)
+    {
+      mx25rxx_xipunmap(dev);
+    }
+#endif
+
   /* After locking the SPI bus, the we also need call the setfrequency, setbits
    * and setmode methods to make sure that the SPI is properly configured for
    * the device.  If the SPI buss is being shared, then it may have been left
@@ -311,14 +347,11 @@ int mx25rxx_read_byte(FAR struct mx25rxx_dev_s *dev, FAR uint8_t *buffer,
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)buflen);
 
-  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.flags   = QSPIMEM_READ | dev->rdflags;
   meminfo.addrlen = 3;
-
-  /* Ignore performace enhanced mode => 2+4 dummies */
-
-  meminfo.dummies = 6;
+  meminfo.dummies = dev->rddummies;
   meminfo.buflen  = buflen;
-  meminfo.cmd     = MX25R_4READ;
+  meminfo.cmd     = dev->rdcmd;
   meminfo.addr    = address;
   meminfo.buffer  = buffer;
 
@@ -506,7 +539,7 @@ int mx25rxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
 
   /* Lock access to the SPI bus until we complete the erase */
 
-  mx25rxx_lock(priv->qspi, false);
+  mx25rxx_lock(priv, false);
 
   while (blocksleft > 0)
     {
@@ -564,7 +597,7 @@ ssize_t mx25rxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
 
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
-  mx25rxx_lock(priv->qspi, false);
+  mx25rxx_lock(priv, false);
 
   ret = mx25rxx_write_page(priv, buf, startblock << priv->pageshift,
                           nblocks << priv->pageshift);
@@ -588,8 +621,22 @@ ssize_t mx25rxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 
   /* Lock the QuadSPI bus and select this FLASH part */
 
-  mx25rxx_lock(priv->qspi, true);
-  ret = mx25rxx_read_byte(priv, buffer, offset, nbytes);
+  mx25rxx_lock(priv, true);
+
+#ifdef CONFIG_MX25RXX_XIP
+  /* Copy the data from the memory mapped FLASH if the controller can map it */
+
+  if (mx25rxx_xipmap(priv) >= 0)
+    {
+      memcpy(buffer, priv->xipbase + offset, nbytes);
+      ret = OK;
+    }
+  else
+#endif
+    {
+      ret = mx25rxx_read_byte(priv, buffer, offset, nbytes);
+    }
+
   mx25rxx_unlock(priv->qspi);
 
   if (ret < 0)
@@ -642,12 +689,36 @@ int mx25rxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         {
           /* Erase the entire device */
 
-          mx25rxx_lock(priv->qspi, false);
+          mx25rxx_lock(priv, false);
           ret = mx25rxx_erase_chip(priv);
           mx25rxx_unlock(priv->qspi);
         }
         break;
 
+#ifdef CONFIG_MX25RXX_XIP
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void**)((uintptr_t)arg);
+
+          /* Return the base of the memory mapped FLASH.  The mapping is
+           * suspended while the FLASH is erased or programmed.
+           */
+
+          if (ppv)
+            {
+              mx25rxx_lock(priv, true);
+              ret = mx25rxx_xipmap(priv);
+              if (ret >= 0)
+                {
+                  *ppv = (FAR void *)priv->xipbase;
+                }
+
+              mx25rxx_unlock(priv->qspi);
+            }
+        }
+        break;
+#endif
+
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
         break;
@@ -661,7 +732,7 @@ int mx25rxx_readid(struct mx25rxx_dev_s *dev)
 {
   /* Lock the QuadSPI bus and configure the bus. */
 
-  mx25rxx_lock(dev->qspi, false);
+  mx25rxx_lock(dev, false);
 
   /* Read the JEDEC ID */
 
@@ -702,6 +773,123 @@ int mx25rxx_readid(struct mx25rxx_dev_s *dev)
   return OK;
 }
 
+#ifdef CONFIG_MTD_SFDP
+int mx25rxx_sfdp_read(FAR void *arg, uint32_t addr, FAR void *buffer,
+                      size_t buflen)
+{
+  FAR struct mx25rxx_dev_s *dev = (FAR struct mx25rxx_dev_s *)arg;
+  struct qspi_meminfo_s meminfo;
+  FAR void *dmabuf;
+  int ret;
+
+  /* Read through a DMA-capable buffer */
+
+  dmabuf = QSPI_ALLOC(dev->qspi, buflen);
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  meminfo.flags   = QSPIMEM_READ;
+  meminfo.addrlen = SFDP_READ_ADDRLEN;
+  meminfo.dummies = SFDP_READ_DUMMIES;
+  meminfo.buflen  = buflen;
+  meminfo.cmd     = MX25R_RDSFDP;
+  meminfo.addr    = addr;
+  meminfo.buffer  = dmabuf;
+
+  ret = QSPI_MEMORY(dev->qspi, &meminfo);
+  if (ret >= 0)
+    {
+      memcpy(buffer, dmabuf, buflen);
+    }
+
+  QSPI_FREE(dev->qspi, dmabuf);
+  return ret;
+}
+
+/* Select the fastest read command that both the FLASH and the QuadSPI
+ * controller support.  The default quad I/O read is kept if the FLASH has
+ * no SFDP.
+ */
+
+void mx25rxx_sfdp(FAR struct mx25rxx_dev_s *dev)
+{
+  struct sfdp_s sfdp;
+  int mode;
+  int ret;
+
+  mx25rxx_lock(dev, false);
+  ret = sfdp_probe(mx25rxx_sfdp_read, dev, &sfdp);
+  mx25rxx_unlock(dev->qspi);
+
+  if (ret < 0)
+    {
+      finfo("No SFDP: %d\n", ret);
+      return;
+    }
+
+  mode = sfdp_readmode(&sfdp, MX25R_SFDP_MODES);
+  if (mode >= 0)
+    {
+      dev->rdcmd     = sfdp.read[mode].opcode;
+      dev->rddummies = sfdp.read[mode].dummies;
+      dev->rdflags   = mode == SFDP_READ_1_4_4 ? QSPIMEM_QUADIO :
+                       mode == SFDP_READ_1_2_2 ? QSPIMEM_DUALIO : 0;
+
+      finfo("Read command: %02x dummies: %u flags: %02x\n",
+            dev->rdcmd, dev->rddummies, dev->rdflags);
+    }
+}
+#endif
+
+#ifdef CONFIG_MX25RXX_XIP
+/* Map the FLASH into memory using the selected read command, if it is not
+ * already mapped.  The QuadSPI bus is locked by the caller.
+ */
+
+int mx25rxx_xipmap(FAR struct mx25rxx_dev_s *dev)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base;
+  int ret;
+
+  if (dev->xipbase != NULL)
+    {
+      return OK;
+    }
+
+  meminfo.flags   = QSPIMEM_READ | dev->rdflags;
+  meminfo.addrlen = 3;
+  meminfo.dummies = dev->rddummies;
+  meminfo.buflen  = 0;
+  meminfo.cmd     = dev->rdcmd;
+  meminfo.addr    = 0;
+  meminfo.buffer  = NULL;
+
+  ret = QSPI_MEMMAP(dev->qspi, &meminfo, &base);
+  if (ret >= 0)
+    {
+      dev->xipbase = (FAR uint8_t *)base;
+    }
+
+  return ret;
+}
+
+/* End the memory mapping before any other command is sent to the FLASH.
+ * The QuadSPI bus is locked by the caller.
+ */
+
+void mx25rxx_xipunmap(FAR struct mx25rxx_dev_s *dev)
+{
+  if (dev->xipbase != NULL)
+    {
+      (void)QSPI_UNMAP(dev->qspi);
+      dev->xipbase = NULL;
+    }
+}
+#endif
+
 /******************************************************************************
  * Public Functions
  ******************************************************************************/
@@ -749,6 +937,12 @@ FAR struct mtd_dev_s *mx25rxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
   dev->mtd.ioctl  = mx25rxx_ioctl;
   dev->qspi       = qspi;
 
+  /* Quad I/O read.  Ignore performace enhanced mode => 2+4 dummies */
+
+  dev->rdcmd      = MX25R_4READ;
+  dev->rddummies  = 6;
+  dev->rdflags    = QSPIMEM_QUADIO;
+
   /* Allocate a 4-byte buffer to support DMA-able command data */
 
   dev->cmdbuf = (FAR uint8_t *)QSPI_ALLOC(qspi, 4);
@@ -769,7 +963,7 @@ FAR struct mtd_dev_s *mx25rxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
       goto exit_free_cmdbuf;
     }
 
-  mx25rxx_lock(dev->qspi, false);
+  mx25rxx_lock(dev, false);
 
   /* Set MTD device in low power mode, with minimum dummy cycles */
 
@@ -788,6 +982,12 @@ FAR struct mtd_dev_s *mx25rxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
 
   mx25rxx_unlock(dev->qspi);
 
+#ifdef CONFIG_MTD_SFDP
+  /* Select the read command from the SFDP */
+
+  mx25rxx_sfdp(dev);
+#endif
+
 #ifdef CONFIG_MTD_REGISTRATION
   /* Register the MTD with the procfs system if enabled */
 
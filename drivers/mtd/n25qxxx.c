@@ -56,6 +56,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/qspi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/sfdp.h>
 
 /************************************************************************************
  * Pre-processor Definitions
@@ -119,6 +120,12 @@
 #define N25QXXX_FAST_READ_QUADIO   0xeb  /* Fast Read Quad I/O:                     *
                                           *   0xeb | ADDR | data...                 */
 
+/* Read modes that can be requested from the QuadSPI controller */
+
+#define N25QXXX_SFDP_MODES         (SFDP_MODE(SFDP_READ_1_1_1) | \
+                                    SFDP_MODE(SFDP_READ_1_2_2) | \
+                                    SFDP_MODE(SFDP_READ_1_4_4))
+
 /* Reset Commands *******************************************************************/
 /*      Command                    Value    Description:                            */
 /*                                            Data sequence                         */
@@ -276,6 +283,12 @@ struct n25qxxx_dev_s
   uint8_t                pageshift;   /* Log2 of page size */
   FAR uint8_t           *cmdbuf;      /* Allocated command buffer */
   FAR uint8_t           *readbuf;     /* Allocated status read buffer */
+  uint8_t                rdcmd;       /* Read command */
+  uint8_t                rdflags;     /* QSPIMEM_* flags of the read command */
+
+#ifdef CONFIG_N25QXXX_XIP
+  FAR uint8_t           *xipbase;     /* Base of the mapped FLASH, NULL if unmapped */
+#endif
 
 #ifdef CONFIG_N25QXXX_SECTOR512
   uint8_t                flags;       /* Buffered sector flags */
@@ -310,6 +323,17 @@ static void n25qxxx_write_enable(FAR struct n25qxxx_dev_s *priv);
 static void n25qxxx_write_disable(FAR struct n25qxxx_dev_s *priv);
 
 static int  n25qxxx_readid(FAR struct n25qxxx_dev_s *priv);
+#ifdef CONFIG_MTD_SFDP
+static int  n25qxxx_sfdp_read(FAR void *arg, uint32_t addr, FAR void *buffer,
+              size_t buflen);
+static void n25qxxx_sfdp(FAR struct n25qxxx_dev_s *priv);
+#endif
+#ifdef CONFIG_N25QXXX_XIP
+static int  n25qxxx_xipmap(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_xipunmap(FAR struct n25qxxx_dev_s *priv);
+#else
+#  define n25qxxx_xipunmap(p)
+#endif
 static int  n25qxxx_protect(FAR struct n25qxxx_dev_s *priv,
               off_t startblock, size_t nblocks);
 static int  n25qxxx_unprotect(FAR struct n25qxxx_dev_s *priv,
@@ -635,6 +659,156 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
   return OK;
 }
 
+/************************************************************************************
+ * Name: n25qxxx_sfdp_read
+ *
+ * Description:
+ *   Read from the SFDP address space on behalf of sfdp_probe().  The QuadSPI bus
+ *   is locked by the caller.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_MTD_SFDP
+static int n25qxxx_sfdp_read(FAR void *arg, uint32_t addr, FAR void *buffer,
+                             size_t buflen)
+{
+  FAR struct n25qxxx_dev_s *priv = (FAR struct n25qxxx_dev_s *)arg;
+  struct qspi_meminfo_s meminfo;
+  FAR void *dmabuf;
+  int ret;
+
+  /* Read through a DMA-capable buffer */
+
+  dmabuf = QSPI_ALLOC(priv->qspi, buflen);
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  meminfo.flags   = QSPIMEM_READ;
+  meminfo.addrlen = SFDP_READ_ADDRLEN;
+  meminfo.dummies = SFDP_READ_DUMMIES;
+  meminfo.buflen  = buflen;
+  meminfo.cmd     = SFDP_READ_CMD;
+  meminfo.addr    = addr;
+  meminfo.buffer  = dmabuf;
+
+  ret = QSPI_MEMORY(priv->qspi, &meminfo);
+  if (ret >= 0)
+    {
+      memcpy(buffer, dmabuf, buflen);
+    }
+
+  QSPI_FREE(priv->qspi, dmabuf);
+  return ret;
+}
+#endif
+
+/************************************************************************************
+ * Name: n25qxxx_sfdp
+ *
+ * Description:
+ *   Select the fastest read command that both the FLASH and the QuadSPI controller
+ *   support.  The number of dummy cycles is fixed by the volatile configuration
+ *   register for all fast read commands so only the command is taken from the
+ *   SFDP.  The default quad I/O command is kept if the FLASH has no SFDP.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_MTD_SFDP
+static void n25qxxx_sfdp(FAR struct n25qxxx_dev_s *priv)
+{
+  struct sfdp_s sfdp;
+  int mode;
+  int ret;
+
+  n25qxxx_lock(priv->qspi);
+  ret = sfdp_probe(n25qxxx_sfdp_read, priv, &sfdp);
+  n25qxxx_unlock(priv->qspi);
+
+  if (ret < 0)
+    {
+      finfo("No SFDP: %d\n", ret);
+      return;
+    }
+
+  if (sfdp.size != ((uint64_t)priv->nsectors << priv->sectorshift))
+    {
+      fwarn("WARNING: SFDP size %llu does not match the JEDEC ID\n",
+            (unsigned long long)sfdp.size);
+    }
+
+  mode = sfdp_readmode(&sfdp, N25QXXX_SFDP_MODES);
+  if (mode >= 0)
+    {
+      priv->rdcmd   = sfdp.read[mode].opcode;
+      priv->rdflags = mode == SFDP_READ_1_4_4 ? QSPIMEM_QUADIO :
+                      mode == SFDP_READ_1_2_2 ? QSPIMEM_DUALIO : 0;
+
+      finfo("Read command: %02x flags: %02x\n", priv->rdcmd, priv->rdflags);
+    }
+}
+#endif
+
+/************************************************************************************
+ * Name: n25qxxx_xipmap
+ *
+ * Description:
+ *   Map the FLASH into memory using the selected read command, if it is not
+ *   already mapped.  The QuadSPI bus is locked by the caller.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_N25QXXX_XIP
+static int n25qxxx_xipmap(FAR struct n25qxxx_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base;
+  int ret;
+
+  if (priv->xipbase != NULL)
+    {
+      return OK;
+    }
+
+  meminfo.flags   = QSPIMEM_READ | priv->rdflags;
+  meminfo.addrlen = 3;
+  meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
+  meminfo.buflen  = 0;
+  meminfo.cmd     = priv->rdcmd;
+  meminfo.addr    = 0;
+  meminfo.buffer  = NULL;
+
+  ret = QSPI_MEMMAP(priv->qspi, &meminfo, &base);
+  if (ret >= 0)
+    {
+      priv->xipbase = (FAR uint8_t *)base;
+    }
+
+  return ret;
+}
+#endif
+
+/************************************************************************************
+ * Name: n25qxxx_xipunmap
+ *
+ * Description:
+ *   End the memory mapping before any other command is sent to the FLASH.  The
+ *   QuadSPI bus is locked by the caller.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_N25QXXX_XIP
+static void n25qxxx_xipunmap(FAR struct n25qxxx_dev_s *priv)
+{
+  if (priv->xipbase != NULL)
+    {
+      (void)QSPI_UNMAP(priv->qspi);
+      priv->xipbase = NULL;
+    }
+}
+#endif
+
 /************************************************************************************
  * Name: n25qxxx_protect
  ************************************************************************************/
@@ -874,11 +1048,11 @@ static int n25qxxx_read_byte(FAR struct n25qxxx_dev_s *priv, FAR uint8_t *buffer
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)buflen);
 
-  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.flags   = QSPIMEM_READ | priv->rdflags;
   meminfo.addrlen = 3;
   meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
   meminfo.buflen  = buflen;
-  meminfo.cmd     = N25QXXX_FAST_READ_QUADIO;
+  meminfo.cmd     = priv->rdcmd;
   meminfo.addr    = address;
   meminfo.buffer  = buffer;
 
@@ -1166,6 +1340,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
   /* Lock access to the SPI bus until we complete the erase */
 
   n25qxxx_lock(priv->qspi);
+  n25qxxx_xipunmap(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1244,6 +1419,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
   n25qxxx_lock(priv->qspi);
+  n25qxxx_xipunmap(priv);
 
 #if defined(CONFIG_N25QXXX_SECTOR512)
   ret = n25qxxx_write_cache(priv, buffer, startblock, nblocks);
@@ -1281,7 +1457,21 @@ static ssize_t n25qxxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbyt
   /* Lock the QuadSPI bus and select this FLASH part */
 
   n25qxxx_lock(priv->qspi);
-  ret = n25qxxx_read_byte(priv, buffer, offset, nbytes);
+
+#ifdef CONFIG_N25QXXX_XIP
+  /* Copy the data from the memory mapped FLASH if the controller can map it */
+
+  if (n25qxxx_xipmap(priv) >= 0)
+    {
+      memcpy(buffer, priv->xipbase + offset, nbytes);
+      ret = OK;
+    }
+  else
+#endif
+    {
+      ret = n25qxxx_read_byte(priv, buffer, offset, nbytes);
+    }
+
   n25qxxx_unlock(priv->qspi);
 
   if (ret < 0)
@@ -1345,6 +1535,7 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
           /* Erase the entire device */
 
           n25qxxx_lock(priv->qspi);
+          n25qxxx_xipunmap(priv);
           ret = n25qxxx_erase_chip(priv);
           n25qxxx_unlock(priv->qspi);
         }
@@ -1356,7 +1547,10 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+          n25qxxx_lock(priv->qspi);
+          n25qxxx_xipunmap(priv);
           ret = n25qxxx_protect(priv, prot->startblock, prot->nblocks);
+          n25qxxx_unlock(priv->qspi);
         }
         break;
 
@@ -1366,9 +1560,36 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+          n25qxxx_lock(priv->qspi);
+          n25qxxx_xipunmap(priv);
           ret = n25qxxx_unprotect(priv, prot->startblock, prot->nblocks);
+          n25qxxx_unlock(priv->qspi);
+        }
+        break;
+
+#ifdef CONFIG_N25QXXX_XIP
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void**)((uintptr_t)arg);
+
+          /* Return the base of the memory mapped FLASH.  The mapping is
+           * suspended while the FLASH is erased or programmed.
+           */
+
+          if (ppv)
+            {
+              n25qxxx_lock(priv->qspi);
+              ret = n25qxxx_xipmap(priv);
+              if (ret >= 0)
+                {
+                  *ppv = (FAR void *)priv->xipbase;
+                }
+
+              n25qxxx_unlock(priv->qspi);
+            }
         }
         break;
+#endif
 
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
@@ -1424,6 +1645,8 @@ FAR struct mtd_dev_s *n25qxxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
       priv->mtd.read   = n25qxxx_read;
       priv->mtd.ioctl  = n25qxxx_ioctl;
       priv->qspi       = qspi;
+      priv->rdcmd      = N25QXXX_FAST_READ_QUADIO;
+      priv->rdflags    = QSPIMEM_QUADIO;
 
       /* Allocate a 4-byte buffer to support DMA-able command data */
 
@@ -1454,6 +1677,12 @@ FAR struct mtd_dev_s *n25qxxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
           goto errout_with_readbuf;
         }
 
+#ifdef CONFIG_MTD_SFDP
+      /* Select the read command from the SFDP */
+
+      n25qxxx_sfdp(priv);
+#endif
+
         /* Specify the number of dummy cycles via the 'volatile configuration
          * register'
          */
@@ -59,6 +59,9 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -131,6 +134,19 @@
 #  define  CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+#ifndef CONFIG_MTD_SMART_READCACHE
+#  define CONFIG_MTD_SMART_READCACHE 0
+#endif
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  ifndef CONFIG_MTD_SMART_BGGC_RESERVE
+#    define CONFIG_MTD_SMART_BGGC_RESERVE 2
+#  endif
+#  ifndef CONFIG_MTD_SMART_BGGC_DELAY
+#    define CONFIG_MTD_SMART_BGGC_DELAY 100
+#  endif
+#endif
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
@@ -266,6 +282,17 @@ struct smart_struct_s
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
 #endif
+#if CONFIG_MTD_SMART_READCACHE > 0
+  FAR uint8_t          *readcache;        /* Data of recently read logical sectors */
+  uint16_t              readcache_sector[CONFIG_MTD_SMART_READCACHE]; /* Logical sector
+                                           * held in each entry (0xffff = none) */
+  uint16_t              readcache_lastuse[CONFIG_MTD_SMART_READCACHE]; /* For LRU */
+  uint16_t              readcache_clock;  /* Incremented on each cache access */
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  sem_t                 exclsem;          /* Serializes the worker and the callers */
+  struct work_s         bgwork;           /* Background garbage collection work */
+#endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
@@ -381,11 +408,32 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
 #endif
 static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
 
+#if CONFIG_MTD_SMART_READCACHE > 0
+static FAR uint8_t *smart_readcache_lookup(FAR struct smart_struct_s *dev,
+                 uint16_t logsector);
+static void smart_readcache_add(FAR struct smart_struct_s *dev,
+                 uint16_t logsector, FAR const uint8_t *data);
+static void smart_readcache_invalidate(FAR struct smart_struct_s *dev,
+                 uint16_t logsector);
+#else
+#  define smart_readcache_invalidate(dev, logsector)
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_lock(FAR struct smart_struct_s *dev);
+#  define smart_unlock(dev) nxsem_post(&(dev)->exclsem)
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev);
+static void smart_bggc_worker(FAR void *arg);
+#else
+#  define smart_lock(dev)
+#  define smart_unlock(dev)
+#endif
+
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
@@ -434,6 +482,36 @@ static const struct file_operations g_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: smart_lock
+ *
+ * Description: Get exclusive access to the device state.  This serializes
+ *              the background garbage collector with the block driver
+ *              entry points.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_lock(FAR struct smart_struct_s *dev)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&dev->exclsem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+    }
+  while (ret == -EINTR);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_open
  *
@@ -827,6 +905,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -836,7 +915,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_lock(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -873,7 +956,11 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_lock(dev);
+
+  /* Raw writes bypass the logical sector mapping */
+
+  smart_readcache_invalidate(dev, 0xffff);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -912,10 +999,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
-              return ret;
+              goto errout;
             }
         }
 
@@ -941,10 +1025,8 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
-          return -EIO;
+          ret = -EIO;
+          goto errout;
         }
 
       /* Then update for amount written */
@@ -955,7 +1037,11 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
-  return nsectors;
+  ret = nsectors;
+
+errout:
+  smart_unlock(dev);
+  return ret;
 }
 #endif /* CONFIG_FS_WRITABLE */
 
@@ -1102,6 +1188,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       dev->rwbuffer = NULL;
     }
 
+#if CONFIG_MTD_SMART_READCACHE > 0
+  if (dev->readcache != NULL)
+    {
+      smart_free(dev, dev->readcache);
+      dev->readcache = NULL;
+    }
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   if (dev->wearstatus != NULL)
     {
@@ -1255,6 +1349,20 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       goto errexit;
     }
 
+#if CONFIG_MTD_SMART_READCACHE > 0
+  /* Allocate the read cache.  This is not fatal if it fails. */
+
+  dev->readcache = (FAR uint8_t *) smart_malloc(dev,
+    CONFIG_MTD_SMART_READCACHE * size, "Read Cache");
+
+  if (!dev->readcache)
+    {
+      ferr("ERROR: Error allocating SMART read cache\n");
+    }
+
+  smart_readcache_invalidate(dev, 0xffff);
+#endif
+
   return OK;
 
   /* On error for any allocation, we jump here and free anything that had
@@ -3721,30 +3829,122 @@ retry:
 }
 
 /****************************************************************************
- * Name: smart_garbagecollect
+ * Name: smart_collectblock
  *
- * Description:  Performs garbage collection if needed.  This is determined
- *               by the count of released sectors relative to free and
- *               total sectors.
+ * Description:  Relocates the active data in the erase block with the most
+ *               released sectors so that the block can be erased.  Blocks
+ *               with fewer than 'minrelease' released sectors are not
+ *               considered.  Returns -ENOSPC if there is no such block.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+static int smart_collectblock(FAR struct smart_struct_s *dev,
+                              uint16_t minrelease)
 {
   uint16_t  collectblock;
   uint16_t  releasemax;
-  bool      collect = TRUE;
   int       x;
   int       ret;
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   uint8_t   count;
 #endif
 
+  /* Find the block with the most released sectors */
+
+  collectblock = 0xffff;
+  releasemax = minrelease > 0 ? minrelease - 1 : 0;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+      if (count > releasemax)
+        {
+          releasemax = count;
+          collectblock = x;
+        }
+#else
+      if (dev->releasecount[x] > releasemax)
+        {
+          releasemax = dev->releasecount[x];
+          collectblock = x;
+        }
+#endif
+    }
+
+  if (collectblock == 0xffff)
+    {
+      /* Need to collect, but no sectors with released blocks! */
+
+      return -ENOSPC;
+    }
+
+#ifdef CONFIG_SMART_LOCAL_CHECKFREE
+  if (smart_checkfree(dev, __LINE__) != OK)
+    {
+      fwarn("   ...before collecting block %d\n", collectblock);
+    }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  finfo("Collecting block %d, free=%d released=%d, totalfree=%d, totalrelease=%d\n",
+      collectblock, smart_get_count(dev, dev->freecount, collectblock),
+      smart_get_count(dev, dev->releasecount, collectblock), dev->freesectors, dev->releasesectors);
+#else
+  finfo("Collecting block %d, free=%d released=%d\n",
+      collectblock, dev->freecount[collectblock],
+      dev->releasecount[collectblock]);
+#endif
+
+  /* Relocate the active data in the collection block */
+
+  ret = smart_relocate_block(dev, collectblock);
+
+#ifdef CONFIG_SMART_LOCAL_CHECKFREE
+  if (smart_checkfree(dev, __LINE__) != OK)
+    {
+      fwarn("   ...while collecting block %d\n", collectblock);
+    }
+#endif
+
+  return ret;
+}
+#endif /* CONFIG_FS_WRITABLE */
+
+/****************************************************************************
+ * Name: smart_garbagecollect
+ *
+ * Description:  Performs garbage collection if needed.  This is determined
+ *               by the count of released sectors relative to free and
+ *               total sectors.
+ *
+ *               When background garbage collection is enabled, only the
+ *               collection needed to keep the reserved free sectors is
+ *               done here.  Anything else is left to the worker so that
+ *               the caller does not wait for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+{
+  bool      collect = TRUE;
+  int       ret;
+
   while (collect)
     {
       collect = FALSE;
 
+#ifndef CONFIG_MTD_SMART_BGGC
       /* Test if the released sectors count is greater than the
        * free sectors.  If it is, then we will do garbage collection.
        */
@@ -3754,6 +3954,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           collect = TRUE;
         }
+#endif
 
       /* Test if we have more reached our reserved free sector limit */
 
@@ -3766,88 +3967,74 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 
       if (collect)
         {
-          /* Find the block with the most released sectors */
-
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
+          ret = smart_collectblock(dev, 1);
+          if (ret != OK)
             {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
+              return ret;
+            }
+        }
+    }
 
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* Let the worker build up the reserve of free sectors */
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
+  smart_bggc_schedule(dev);
 #endif
-            }
 
-          //releasemax = smart_get_count(dev, dev->releasecount, collectblock);
+  return OK;
+}
+#endif /* CONFIG_FS_WRITABLE */
 
-          if (collectblock == 0xffff)
-            {
-              /* Need to collect, but no sectors with released blocks! */
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Returns true if the background garbage collector has work
+ *               to do:  Fewer than the configured reserve of free sectors
+ *               remain (in addition to those always kept for foreground
+ *               collection) and some blocks have released sectors.
+ *
+ ****************************************************************************/
 
-              ret = -ENOSPC;
-              goto errout;
-            }
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+  uint32_t reserve;
 
-#ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...before collecting block %d\n", collectblock);
-            }
-#endif
+  reserve = (uint32_t)CONFIG_MTD_SMART_BGGC_RESERVE * dev->availSectPerBlk +
+            dev->sectorsPerBlk + 4;
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-          finfo("Collecting block %d, free=%d released=%d, totalfree=%d, totalrelease=%d\n",
-              collectblock, smart_get_count(dev, dev->freecount, collectblock),
-              smart_get_count(dev, dev->releasecount, collectblock), dev->freesectors, dev->releasesectors);
-#else
-          finfo("Collecting block %d, free=%d released=%d\n",
-              collectblock, dev->freecount[collectblock],
-              dev->releasecount[collectblock]);
-#endif
+  if (dev->releasesectors == 0 || dev->freesectors >= reserve)
+    {
+      return false;
+    }
+
+  return true;
+}
 
-          /* Relocate the active data in the collection block */
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description:  Queue the background garbage collector if it has work to
+ *               do and is not already queued.  The worker is delayed so
+ *               that it tends to run after a burst of writes.
+ *
+ ****************************************************************************/
 
-          ret = smart_relocate_block(dev, collectblock);
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+  bool needed = smart_bggc_needed(dev);
 
-#ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...while collecting block %d\n", collectblock);
-            }
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  needed |= (dev->wearflags & SMART_WEARFLAGS_FORCE_REORG) != 0;
 #endif
 
-          if (ret != OK)
-            {
-              goto errout;
-            }
-        }
+  if (needed && work_available(&dev->bgwork))
+    {
+      (void)work_queue(LPWORK, &dev->bgwork, smart_bggc_worker, dev,
+                       MSEC2TICK(CONFIG_MTD_SMART_BGGC_DELAY));
     }
-
-  return OK;
-
-errout:
-  return ret;
 }
-#endif /* CONFIG_FS_WRITABLE */
+#endif /* CONFIG_MTD_SMART_BGGC */
 
 /****************************************************************************
  * Name: smart_write_wearstatus
@@ -3962,6 +4149,99 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Background garbage collection and wear leveling.  Runs on
+ *               the low priority work queue.  Each pass relocates at most
+ *               one erase block while holding the device lock and then
+ *               requeues itself, so a foreground request never waits for
+ *               more than one block relocation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  bool again = false;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  uint16_t block;
+#endif
+
+  smart_lock(dev);
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      goto errout_with_lock;
+    }
+
+  if (smart_bggc_needed(dev))
+    {
+      /* Only collect blocks that will yield a useful number of free
+       * sectors.  Relocating a block with only a few released sectors
+       * costs an erase for little gain; the foreground collector still
+       * takes those when it is about to run out.
+       */
+
+      again = (smart_collectblock(dev, dev->availSectPerBlk >> 2) == OK);
+    }
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  else if ((dev->wearflags & SMART_WEARFLAGS_FORCE_REORG) != 0)
+    {
+      /* No unworn block has free sectors.  Move the data out of one full,
+       * unworn block so that its erase block is available for new writes
+       * instead of wearing the blocks that are already worn.
+       */
+
+      for (block = 0; block < dev->neraseblocks; block++)
+        {
+          if (smart_get_wear_level(dev, block) <
+                SMART_WEAR_FORCE_REORG_THRESHOLD &&
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+              smart_get_count(dev, dev->freecount, block) == 0)
+#else
+              dev->freecount[block] == 0)
+#endif
+            {
+              break;
+            }
+        }
+
+      if (block < dev->neraseblocks && smart_relocate_block(dev, block) < 0)
+        {
+          ferr("ERROR: Error relocating block %d\n", block);
+        }
+
+      dev->wearflags &= ~SMART_WEARFLAGS_FORCE_REORG;
+    }
+#endif
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if ((dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) != 0)
+    {
+      /* Write new wear status bits to the device */
+
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  again = again && smart_bggc_needed(dev);
+
+errout_with_lock:
+  smart_unlock(dev);
+
+  /* Continue with the next block, if any, giving any waiting foreground
+   * request the device first.
+   */
+
+  if (again)
+    {
+      (void)work_queue(LPWORK, &dev->bgwork, smart_bggc_worker, dev, 0);
+    }
+}
+#endif /* CONFIG_MTD_SMART_BGGC */
+
 /****************************************************************************
  * Name: smart_read_wearstatus
  *
@@ -4638,6 +4918,104 @@ errout:
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_readcache_lookup
+ *
+ * Description:  Return the cached data area of a logical sector or NULL if
+ *               the sector is not in the read cache.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MTD_SMART_READCACHE > 0
+static FAR uint8_t *smart_readcache_lookup(FAR struct smart_struct_s *dev,
+                    uint16_t logsector)
+{
+  int x;
+
+  if (dev->readcache == NULL)
+    {
+      return NULL;
+    }
+
+  for (x = 0; x < CONFIG_MTD_SMART_READCACHE; x++)
+    {
+      if (dev->readcache_sector[x] == logsector)
+        {
+          dev->readcache_lastuse[x] = ++dev->readcache_clock;
+          return &dev->readcache[x * dev->sectorsize];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_readcache_add
+ *
+ * Description:  Add the data area of a logical sector that was just read to
+ *               the read cache, replacing the least recently used entry.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MTD_SMART_READCACHE > 0
+static void smart_readcache_add(FAR struct smart_struct_s *dev,
+                    uint16_t logsector, FAR const uint8_t *data)
+{
+  int oldest = 0;
+  int x;
+
+  if (dev->readcache == NULL)
+    {
+      return;
+    }
+
+  for (x = 0; x < CONFIG_MTD_SMART_READCACHE; x++)
+    {
+      if (dev->readcache_sector[x] == 0xffff)
+        {
+          oldest = x;
+          break;
+        }
+
+      if ((int16_t)(dev->readcache_lastuse[x] -
+                    dev->readcache_lastuse[oldest]) < 0)
+        {
+          oldest = x;
+        }
+    }
+
+  memcpy(&dev->readcache[oldest * dev->sectorsize], data,
+         dev->sectorsize - sizeof(struct smart_sect_header_s));
+  dev->readcache_sector[oldest]  = logsector;
+  dev->readcache_lastuse[oldest] = ++dev->readcache_clock;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_readcache_invalidate
+ *
+ * Description:  Remove a logical sector from the read cache.  A sector
+ *               number of 0xffff removes all sectors.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MTD_SMART_READCACHE > 0
+static void smart_readcache_invalidate(FAR struct smart_struct_s *dev,
+                    uint16_t logsector)
+{
+  int x;
+
+  for (x = 0; x < CONFIG_MTD_SMART_READCACHE; x++)
+    {
+      if (logsector == 0xffff || dev->readcache_sector[x] == logsector)
+        {
+          dev->readcache_sector[x] = 0xffff;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_readsector
  *
@@ -4660,6 +5038,9 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
   uint32_t  readaddr;
   struct smart_sect_header_s header;
 #endif
+#if CONFIG_MTD_SMART_READCACHE > 0
+  FAR uint8_t *cached;
+#endif
 
   finfo("Entry\n");
   req = (FAR struct smart_read_write_s *) arg;
@@ -4677,6 +5058,21 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
       goto errout;
     }
 
+#if CONFIG_MTD_SMART_READCACHE > 0
+  /* If the sector was read recently, then return the cached data.  A
+   * sector is removed from the cache when it is written or released, so a
+   * cached sector is still allocated and its data is current.
+   */
+
+  cached = smart_readcache_lookup(dev, req->logsector);
+  if (cached != NULL)
+    {
+      memcpy((FAR char *) req->buffer, &cached[req->offset], req->count);
+      ret = req->count;
+      goto errout;
+    }
+#endif
+
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
   physsector = dev->sMap[req->logsector];
 #else
@@ -4738,6 +5134,13 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
       sizeof(struct smart_sect_header_s)], req->count);
   ret = req->count;
 
+#if CONFIG_MTD_SMART_READCACHE > 0
+  /* The entire, validated sector is in the read/write buffer */
+
+  smart_readcache_add(dev, req->logsector, (FAR const uint8_t *)
+                      &dev->rwbuffer[sizeof(struct smart_sect_header_s)]);
+#endif
+
 #else /* CONFIG_MTD_SMART_ENABLE_CRC */
 
   /* Read the sector header data to validate as a sanity check */
@@ -4779,6 +5182,16 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
       goto errout;
     }
 
+#if CONFIG_MTD_SMART_READCACHE > 0
+  /* Cache the sector if its entire data area was read */
+
+  if (req->offset == 0 &&
+      req->count == dev->sectorsize - sizeof(struct smart_sect_header_s))
+    {
+      smart_readcache_add(dev, req->logsector, req->buffer);
+    }
+#endif
+
 #endif
 
 errout:
@@ -5166,6 +5579,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  smart_lock(dev);
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5182,7 +5597,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5214,6 +5630,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       /* Perform a low-level format on the flash */
 
+      smart_readcache_invalidate(dev, 0xffff);
       ret = smart_llformat(dev, arg);
       goto ok_out;
 
@@ -5235,6 +5652,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       /* Free the specified logical sector */
 
+      smart_readcache_invalidate(dev, (uint16_t)arg);
       ret = smart_freesector(dev, arg);
       goto ok_out;
 
@@ -5242,6 +5660,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       /* Write to the sector */
 
+      smart_readcache_invalidate(dev,
+        ((FAR struct smart_read_write_s *)arg)->logsector);
       ret = smart_writesector(dev, arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -5324,6 +5744,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_unlock(dev);
   return ret;
 }
 
@@ -5372,6 +5793,10 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 
       dev->mtd = mtd;
 
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxsem_init(&dev->exclsem, 0, 1);
+#endif
+
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
        * from the size of a pointer).
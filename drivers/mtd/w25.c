@@ -78,6 +78,19 @@
 #  define CONFIG_W25_SPIFREQUENCY 20000000
 #endif
 
+/* Asynchronous erase.  Reads issued while a sector erase is in progress
+ * suspend the erase on W25Q parts.  The MTDIOC_ERASESTART ioctl is not
+ * available with CONFIG_W25_SECTOR512 because erasing one of the simulated
+ * 512 byte sectors is a read-modify-write of the whole 4Kb sector.
+ */
+
+#if defined(CONFIG_MTD_ASYNC_ERASE) && !defined(CONFIG_W25_READONLY)
+#  define W25_ERASE_SUSPEND 1
+#  ifndef CONFIG_W25_SECTOR512
+#    define W25_ASYNC_ERASE 1
+#  endif
+#endif
+
 /* W25 Instructions *****************************************************************/
 /*      Command                    Value      Description                           */
 /*                                                                                  */
@@ -92,6 +105,8 @@
 #define W25_BE                     0xd8    /* Block Erase (64KB)                    */
 #define W25_SE                     0x20    /* Sector erase (4KB)                    */
 #define W25_CE                     0xc7    /* Chip erase                            */
+#define W25_ES                     0x75    /* Erase/program suspend (W25Q)          */
+#define W25_ER                     0x7a    /* Erase/program resume (W25Q)           */
 #define W25_PD                     0xb9    /* Power down                            */
 #define W25_PURDID                 0xab    /* Release PD, Device ID                 */
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device            */
@@ -226,6 +241,11 @@ struct w25_dev_s
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
   uint8_t               prev_instr;  /* Previous instruction given to W25 device */
+#ifdef W25_ERASE_SUSPEND
+  bool                  suspend;     /* True: Part supports erase suspend */
+  bool                  erasing;     /* True: A sector erase may be in progress */
+  uint16_t              esector;     /* The sector being erased */
+#endif
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
@@ -246,7 +266,13 @@ static inline int w25_readid(FAR struct w25_dev_s *priv);
 #ifndef CONFIG_W25_READONLY
 static void w25_unprotect(FAR struct w25_dev_s *priv);
 #endif
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv);
 static uint8_t w25_waitwritecomplete(FAR struct w25_dev_s *priv);
+#ifdef W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes);
+static void w25_eraseresume(FAR struct w25_dev_s *priv);
+#endif
 static inline void w25_wren(FAR struct w25_dev_s *priv);
 static inline void w25_wrdi(FAR struct w25_dev_s *priv);
 static bool w25_is_erased(struct w25_dev_s *priv, off_t address, off_t size);
@@ -382,6 +408,12 @@ static inline int w25_readid(struct w25_dev_s *priv)
        * W25Q80BV
        */
 
+#ifdef W25_ERASE_SUSPEND
+      /* Only the W25Q parts support erase suspend */
+
+      priv->suspend = (memory != W25X_JEDEC_MEMORY_TYPE);
+#endif
+
       if (capacity == W25_JEDEC_CAPACITY_8MBIT)
         {
            priv->nsectors = NSECTORS_8MBIT;
@@ -480,6 +512,32 @@ static void w25_unprotect(FAR struct w25_dev_s *priv)
 }
 #endif
 
+/************************************************************************************
+ * Name: w25_rdsr
+ ************************************************************************************/
+
+static uint8_t w25_rdsr(FAR struct w25_dev_s *priv)
+{
+  uint8_t status;
+
+  /* Select this FLASH part */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+
+  /* Send "Read Status Register (RDSR)" command */
+
+  (void)SPI_SEND(priv->spi, W25_RDSR);
+
+  /* Send a dummy byte to generate the clock needed to shift out the status */
+
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+
+  /* Deselect the FLASH */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+  return status;
+}
+
 /************************************************************************************
  * Name: w25_waitwritecomplete
  ************************************************************************************/
@@ -496,21 +554,7 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
 
   do
     {
-      /* Select this FLASH part */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
-
-      /* Send "Read Status Register (RDSR)" command */
-
-      (void)SPI_SEND(priv->spi, W25_RDSR);
-
-      /* Send a dummy byte to generate the clock needed to shift out the status */
-
-      status = SPI_SEND(priv->spi, W25_DUMMY);
-
-      /* Deselect the FLASH */
-
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+      status = w25_rdsr(priv);
 
       /* Given that writing could take up to few tens of milliseconds, and erasing
        * could take more.  The following short delay in the "busy" case will allow
@@ -528,9 +572,89 @@ static uint8_t w25_waitwritecomplete(struct w25_dev_s *priv)
     }
   while ((status & W25_SR_BUSY) != 0);
 
+#ifdef W25_ERASE_SUSPEND
+  priv->erasing = false;
+#endif
   return status;
 }
 
+/************************************************************************************
+ * Name: w25_erasesuspend
+ *
+ * Description:
+ *   If a sector erase is in progress and the part supports it, suspend the
+ *   erase so that the range [address, address + nbytes) can be read.  A read
+ *   of the sector being erased must wait for the erase to complete instead.
+ *
+ * Returned Value:
+ *   True if the erase was suspended and must be resumed with
+ *   w25_eraseresume() after the read.
+ *
+ ************************************************************************************/
+
+#ifdef W25_ERASE_SUSPEND
+static bool w25_erasesuspend(FAR struct w25_dev_s *priv, off_t address,
+                             size_t nbytes)
+{
+  off_t first;
+  off_t last;
+
+  if (!priv->erasing || !priv->suspend || nbytes == 0)
+    {
+      return false;
+    }
+
+  first = address >> W25_SECTOR_SHIFT;
+  last  = (address + nbytes - 1) >> W25_SECTOR_SHIFT;
+
+  if (priv->esector >= first && priv->esector <= last)
+    {
+      return false;
+    }
+
+  if ((w25_rdsr(priv) & W25_SR_BUSY) == 0)
+    {
+      /* The erase has already completed */
+
+      priv->erasing = false;
+      return false;
+    }
+
+  /* Send the "Erase/Program Suspend" instruction */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->spi, W25_ES);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  /* BUSY clears within tSUS (20 microseconds) when the erase is suspended.
+   * That is too short to be worth sleeping.
+   */
+
+  while ((w25_rdsr(priv) & W25_SR_BUSY) != 0);
+
+  finfo("Suspended erase of sector %u\n", priv->esector);
+  return true;
+}
+
+/************************************************************************************
+ * Name: w25_eraseresume
+ *
+ * Description:
+ *   Resume an erase suspended by w25_erasesuspend().  The part ignores the
+ *   command if the erase happened to complete before it was suspended.
+ *
+ ************************************************************************************/
+
+static void w25_eraseresume(FAR struct w25_dev_s *priv)
+{
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  (void)SPI_SEND(priv->spi, W25_ER);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+  priv->prev_instr = W25_SE;
+}
+#endif
+
 /************************************************************************************
  * Name:  w25_wren
  ************************************************************************************/
@@ -654,6 +778,11 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
   (void)SPI_SEND(priv->spi, W25_SE);
   priv->prev_instr = W25_SE;
 
+#ifdef W25_ERASE_SUSPEND
+  priv->erasing    = true;
+  priv->esector    = (uint16_t)sector;
+#endif
+
   /* Send the sector address high byte first. Only the most significant bits (those
    * corresponding to the sector) have any meaning.
    */
@@ -707,17 +836,28 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
                            off_t address, size_t nbytes)
 {
   uint8_t status;
+#ifdef W25_ERASE_SUSPEND
+  bool suspended;
+#endif
 
   finfo("address: %08lx nbytes: %d\n", (long)address, (int)nbytes);
 
-  /* Wait for any preceding write or erase operation to complete. */
+#ifdef W25_ERASE_SUSPEND
+  /* Suspend an erase of some other sector rather than waiting for it */
+
+  suspended = w25_erasesuspend(priv, address, nbytes);
+  if (!suspended)
+#endif
+    {
+      /* Wait for any preceding write or erase operation to complete. */
 
-  status = w25_waitwritecomplete(priv);
-  DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
+      status = w25_waitwritecomplete(priv);
+      DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
 
-  /* Make sure that writing is disabled */
+      /* Make sure that writing is disabled */
 
-  w25_wrdi(priv);
+      w25_wrdi(priv);
+    }
 
   /* Select this FLASH part */
 
@@ -752,6 +892,13 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+
+#ifdef W25_ERASE_SUSPEND
+  if (suspended)
+    {
+      w25_eraseresume(priv);
+    }
+#endif
 }
 
 /************************************************************************************
@@ -1277,6 +1424,43 @@ static int w25_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef W25_ASYNC_ERASE
+      case MTDIOC_ERASESTART:
+        {
+          /* Start erasing one sector but do not wait for it to complete */
+
+          if (arg >= priv->nsectors)
+            {
+              ret = -ENXIO;
+            }
+          else
+            {
+              w25_lock(priv->spi);
+              w25_sectorerase(priv, (off_t)arg);
+              w25_unlock(priv->spi);
+              ret = OK;
+            }
+        }
+        break;
+
+      case MTDIOC_ERASESTATUS:
+        {
+          w25_lock(priv->spi);
+          if ((w25_rdsr(priv) & W25_SR_BUSY) != 0)
+            {
+              ret = -EBUSY;
+            }
+          else
+            {
+              priv->erasing = false;
+              ret = OK;
+            }
+
+          w25_unlock(priv->spi);
+        }
+        break;
+#endif
+
       case MTDIOC_XIPBASE:
       default:
         ret = -ENOTTY; /* Bad command */
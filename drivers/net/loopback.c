@@ -170,6 +170,14 @@ static int lo_txpoll(FAR struct net_driver_s *dev)
        NETDEV_TXPACKETS(&priv->lo_dev);
        NETDEV_RXPACKETS(&priv->lo_dev);
 
+#ifdef CONFIG_NETDEV_LOOPBACK_FASTPATH
+      /* The checksums of looped back packets were never computed and need
+       * not be verified.
+       */
+
+      IFF_SET_CSUMOK(priv->lo_dev.d_flags);
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the packet tap */
 
@@ -520,6 +528,10 @@ int localhost_initialize(void)
 #endif
   priv->lo_dev.d_buf     = g_iobuffer;   /* Attach the IO buffer */
   priv->lo_dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
+#ifdef CONFIG_NETDEV_LOOPBACK_FASTPATH
+  priv->lo_dev.d_csumcaps = NETDEV_TXCSUM_IPv4 | NETDEV_TXCSUM_TCP |
+                            NETDEV_TXCSUM_UDP;
+#endif
 
   /* Create a watchdog for timing polling for and timing of transmissions */
 
@@ -56,10 +56,6 @@
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
 
-#ifdef CONFIG_NET_PKT
-#  include <nuttx/net/pkt.h>
-#endif
-
 #ifdef CONFIG_NET_skeleton
 
 /****************************************************************************
@@ -94,9 +90,12 @@
 
 #define skeleton_TXTIMEOUT (60*CLK_TCK)
 
-/* This is a helper pointer for accessing the contents of the Ethernet header */
+/* The maximum number of RX packets processed in one pass of the work
+ * handler.  If this many packets were received, the driver stays in
+ * polling mode with the RX interrupt disabled.
+ */
 
-#define BUF ((struct eth_hdr_s *)priv->sk_dev.d_buf)
+#define skeleton_RXBUDGET 16
 
 /****************************************************************************
  * Private Types
@@ -156,8 +155,9 @@ static int  skel_txpoll(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
-static void skel_reply(struct skel_driver_s *priv)
-static void skel_receive(FAR struct skel_driver_s *priv);
+static int  skel_rxpull(FAR struct net_driver_s *dev);
+static int  skel_rxreply(FAR struct net_driver_s *dev);
+static bool skel_receive(FAR struct skel_driver_s *priv);
 static void skel_txdone(FAR struct skel_driver_s *priv);
 
 static void skel_interrupt_work(FAR void *arg);
@@ -311,160 +311,92 @@ static int skel_txpoll(FAR struct net_driver_s *dev)
 }
 
 /****************************************************************************
- * Name: skel_reply
+ * Name: skel_rxpull
  *
  * Description:
- *   After a packet has been received and dispatched to the network, it
- *   may return return with an outgoing packet.  This function checks for
- *   that case and performs the transmission if necessary.
+ *   Move the next received packet from the hardware into the network
+ *   buffer.  This is a callback from netdev_rxbatch().
  *
  * Parameters:
- *   priv - Reference to the driver state structure
+ *   dev - Reference to the NuttX driver state structure
  *
  * Returned Value:
- *   None
+ *   A positive value if a packet was received, zero if there are no more
+ *   packets, or a negated errno if a received packet was discarded.
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static void skel_reply(struct skel_driver_s *priv)
+static int skel_rxpull(FAR struct net_driver_s *dev)
 {
-  /* If the packet dispatch resulted in data that should be sent out on the
-   * network, the field d_len will set to a value > 0.
-   */
+  /* Check if there is another packet.  If not, return zero. */
 
-  if (priv->sk_dev.d_len > 0)
-    {
-      /* Update the Ethernet header with the correct MAC address */
+  /* Check for errors and update statistics */
 
-#ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-      /* Check for an outgoing IPv4 packet */
+  /* Check if the packet is a valid size for the network buffer
+   * configuration.
+   */
 
-      if (IFF_IS_IPv4(priv->sk_dev.d_flags))
-#endif
-        {
-          arp_out(&priv->sk_dev);
-        }
-#endif
+  /* Copy the data data from the hardware to dev->d_buf.  Set
+   * amount of data in dev->d_len
+   */
 
-#ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
-      /* Otherwise, it must be an outgoing IPv6 packet */
+  return 1;
+}
 
-      else
-#endif
-        {
-          neighbor_out(&skel->sk_dev);
-        }
-#endif
+/****************************************************************************
+ * Name: skel_rxreply
+ *
+ * Description:
+ *   Send the response to a received packet.  The response in the network
+ *   buffer is complete, including the Ethernet header.  This is a callback
+ *   from netdev_rxbatch().
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-      /* And send the packet */
+static int skel_rxreply(FAR struct net_driver_s *dev)
+{
+  FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)dev->d_private;
 
-      skel_transmit(priv);
-    }
+  return skel_transmit(priv);
 }
 
 /****************************************************************************
  * Name: skel_receive
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   An interrupt was received indicating the availability of new RX
+ *   packets.  Process a batch of packets.
  *
  * Parameters:
  *   priv - Reference to the driver state structure
  *
  * Returned Value:
- *   None
+ *   True if the RX budget was exhausted and more packets may be pending.
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static void skel_receive(FAR struct skel_driver_s *priv)
+static bool skel_receive(FAR struct skel_driver_s *priv)
 {
-  do
-    {
-      /* Check for errors and update statistics */
-
-      /* Check if the packet is a valid size for the network buffer
-       * configuration.
-       */
-
-      /* Copy the data data from the hardware to priv->sk_dev.d_buf.  Set
-       * amount of data in priv->sk_dev.d_len
-       */
-
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the packet tap */
-
-       pkt_input(&priv->sk_dev);
-#endif
-
-      /* We only accept IP packets of the configured type and ARP packets */
-
-#ifdef CONFIG_NET_IPv4
-      if (BUF->type == HTONS(ETHTYPE_IP))
-        {
-          ninfo("IPv4 frame\n");
-          NETDEV_RXIPV4(&priv->sk_dev);
-
-          /* Handle ARP on input, then dispatch IPv4 packet to the network
-           * layer.
-           */
-
-          arp_ipin(&priv->sk_dev);
-          ipv4_input(&priv->sk_dev);
-
-          /* Check for a reply to the IPv4 packet */
-
-          skel_reply(priv);
-        }
-      else
-#endif
-#ifdef CONFIG_NET_IPv6
-      if (BUF->type == HTONS(ETHTYPE_IP6))
-        {
-          ninfo("Iv6 frame\n");
-          NETDEV_RXIPV6(&priv->sk_dev);
-
-          /* Dispatch IPv6 packet to the network layer */
-
-          ipv6_input(&priv->sk_dev);
-
-          /* Check for a reply to the IPv6 packet */
-
-          skel_reply(priv);
-        }
-      else
-#endif
-#ifdef CONFIG_NET_ARP
-      if (BUF->type == htons(ETHTYPE_ARP))
-        {
-          /* Dispatch ARP packet to the network layer */
-
-          arp_arpin(&priv->sk_dev);
-          NETDEV_RXARP(&priv->sk_dev);
-
-          /* If the above function invocation resulted in data that should be
-           * sent out on the network, the field  d_len will set to a value > 0.
-           */
+  int nrx;
 
-          if (priv->sk_dev.d_len > 0)
-            {
-              skel_transmit(priv);
-            }
-        }
-      else
-#endif
-        {
-          NETDEV_RXDROPPED(&priv->sk_dev);
-        }
-    }
-  while (); /* While there are more packets to be processed */
+  nrx = netdev_rxbatch(&priv->sk_dev, skel_rxpull, skel_rxreply,
+                       skeleton_RXBUDGET);
+  return nrx >= skeleton_RXBUDGET;
 }
 
 /****************************************************************************
@@ -527,6 +459,7 @@ static void skel_txdone(FAR struct skel_driver_s *priv)
 static void skel_interrupt_work(FAR void *arg)
 {
   FAR struct skel_driver_s *priv = (FAR struct skel_driver_s *)arg;
+  bool rxpending;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -544,7 +477,7 @@ static void skel_interrupt_work(FAR void *arg)
 
   /* Check if we received an incoming packet, if so, call skel_receive() */
 
-  skel_receive(priv);
+  rxpending = skel_receive(priv);
 
   /* Check if a packet transmission just completed.  If so, call skel_txdone.
    * This may disable further Tx interrupts if there are no pending
@@ -554,6 +487,17 @@ static void skel_interrupt_work(FAR void *arg)
   skel_txdone(priv);
   net_unlock();
 
+  /* If the RX budget was exhausted, then more packets are probably waiting.
+   * Stay in polling mode:  Reschedule this work with interrupts still
+   * disabled so that the packet rate cannot starve the work queue.
+   */
+
+  if (rxpending)
+    {
+      work_queue(ETHWORK, &priv->sk_irqwork, skel_interrupt_work, priv, 0);
+      return;
+    }
+
   /* Re-enable Ethernet interrupts */
 
   up_enable_irq(CONFIG_skeleton_IRQ);
@@ -118,8 +118,8 @@ struct telnet_dev_s
 {
   sem_t              td_exclsem; /* Enforces mutually exclusive access */
   uint8_t            td_state;   /* (See telnet_state_e) */
-  uint8_t            td_pending; /* Number of valid, pending bytes in the rxbuffer */
-  uint8_t            td_offset;  /* Offset to the valid, pending bytes in the rxbuffer */
+  uint16_t           td_pending; /* Number of valid, pending bytes in the rxbuffer */
+  uint16_t           td_offset;  /* Offset to the valid, pending bytes in the rxbuffer */
   uint8_t            td_crefs;   /* The number of open references to the session */
   int                td_minor;   /* Minor device number */
   FAR struct socket  td_psock;   /* A clone of the internal socket structure */
@@ -153,8 +153,6 @@ static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 int *nwritten);
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
 
@@ -279,14 +277,67 @@ static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src,
                               size_t srclen, FAR char *dest, size_t destlen)
 {
+  FAR const char *end;
+  size_t ncopy;
   int nread;
   uint8_t ch;
 
   ninfo("srclen: %d destlen: %d\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  for (nread = 0; srclen > 0 && nread < destlen; )
     {
+      if (priv->td_state == STATE_NORMAL)
+        {
+          /* Copy the run of ordinary characters up to the next IAC (or
+           * carriage return) in one block.
+           */
+
+          ncopy = srclen;
+          if (ncopy > destlen - nread)
+            {
+              ncopy = destlen - nread;
+            }
+
+          end = memchr(src, TELNET_IAC, ncopy);
+          if (end != NULL)
+            {
+              ncopy = end - src;
+            }
+
+#ifndef CONFIG_TELNET_CHARACTER_MODE
+          end = memchr(src, ISO_cr, ncopy);
+          if (end != NULL)
+            {
+              ncopy = end - src;
+            }
+#endif
+
+          memcpy(&dest[nread], src, ncopy);
+          nread  += ncopy;
+          src    += ncopy;
+          srclen -= ncopy;
+
+          /* If the run ended before the source or the user buffer did,
+           * then it ended at an IAC (or an ignored carriage return).
+           */
+
+          if (srclen > 0 && nread < destlen)
+            {
+              if ((uint8_t)*src == TELNET_IAC)
+                {
+                  priv->td_state = STATE_IAC;
+                }
+
+              src++;
+              srclen--;
+            }
+
+          continue;
+        }
+
       ch = *src++;
+      srclen--;
+
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
       switch (priv->td_state)
@@ -376,14 +427,9 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
             break;
 
           case STATE_NORMAL:
-            if (ch == TELNET_IAC)
-              {
-                priv->td_state = STATE_IAC;
-              }
-            else
-              {
-                telnet_getchar(priv, ch, dest, &nread);
-              }
+          default:
+            /* Handled above */
+
             break;
         }
     }
@@ -412,49 +458,6 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
   return nread;
 }
 
-/****************************************************************************
- * Name: telnet_putchar
- *
- * Description:
- *   Put another character from the user buffer to the TX buffer.
- *
- ****************************************************************************/
-
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           int *nread)
-{
-  register int index;
-  bool ret = false;
-
-  /* Ignore carriage returns (we will put these in automatically as necesary) */
-
-  if (ch != ISO_cr)
-    {
-      /* Add all other characters to the destination buffer */
-
-      index = *nread;
-      priv->td_txbuffer[index++] = ch;
-
-      /* Check for line feeds */
-
-      if (ch == ISO_nl)
-        {
-          /* Now add the carriage return */
-
-          priv->td_txbuffer[index++] = ISO_cr;
-          priv->td_txbuffer[index++] = '\0';
-
-          /* End of line */
-
-          ret = true;
-        }
-
-      *nread = index;
-    }
-
-  return ret;
-}
-
 /****************************************************************************
  * Name: telnet_sendopt
  *
@@ -709,38 +712,81 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer, size
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
-  ssize_t nsent;
+  size_t nsent;
+  size_t nrun;
+  size_t room;
   ssize_t ret;
   int ncopied;
-  char ch;
-  bool eol;
+  uint8_t ch;
 
   ninfo("len: %d\n", len);
 
-  /* Process each character from the user buffer */
+  /* Copy the user buffer into the TX buffer, expanding line feeds and
+   * escaping IAC characters.  The TX buffer is only sent when it is full
+   * (and at the end) so that a large write needs few psock_send() calls.
+   */
 
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  for (nsent = 0, ncopied = 0; nsent < len; )
     {
-      /* Get the next character from the user buffer */
+      /* Find the run of characters that need no translation.  Three bytes
+       * are reserved for the longest translated sequence ("\n\r\0").
+       */
 
-      ch = *src++;
+      room = CONFIG_TELNET_TXBUFFER_SIZE - 3 - ncopied;
+      for (nrun = 0; nrun < len - nsent && nrun < room; nrun++)
+        {
+          ch = (uint8_t)src[nrun];
+          if (ch == ISO_nl || ch == ISO_cr || ch == TELNET_IAC)
+            {
+              break;
+            }
+        }
 
-      /* Add the character to the TX buffer */
+      memcpy(&priv->td_txbuffer[ncopied], src, nrun);
+      ncopied += nrun;
+      src     += nrun;
+      nsent   += nrun;
 
-      eol = telnet_putchar(priv, ch, &ncopied);
+      /* Then translate the character that ended the run, if any */
+
+      if (nsent < len && nrun < room)
+        {
+          ch = (uint8_t)*src++;
+          nsent++;
+
+          if (ch == ISO_nl)
+            {
+              /* Add the carriage return after the line feed */
+
+              priv->td_txbuffer[ncopied++] = ISO_nl;
+              priv->td_txbuffer[ncopied++] = ISO_cr;
+              priv->td_txbuffer[ncopied++] = '\0';
+            }
+          else if (ch == TELNET_IAC)
+            {
+              /* Escape data bytes that look like IAC */
+
+              priv->td_txbuffer[ncopied++] = TELNET_IAC;
+              priv->td_txbuffer[ncopied++] = TELNET_IAC;
+            }
+
+          /* Carriage returns are ignored (we will put these in
+           * automatically as necessary).
+           */
+        }
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n\0")?
+      /* Is the buffer too full to hold the next largest character
+       * sequence?
        */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE-3)
+      if (ncopied >= CONFIG_TELNET_TXBUFFER_SIZE - 3)
         {
           /* Yes... send the data now */
 
           ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
           if (ret < 0)
             {
-              nerr("ERROR: psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
+              nerr("ERROR: psock_send failed: %d\n", ret);
               return ret;
             }
 
@@ -757,7 +803,7 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer, size
       ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
       if (ret < 0)
         {
-          nerr("ERROR: psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
+          nerr("ERROR: psock_send failed: %d\n", ret);
           return ret;
         }
     }
@@ -58,6 +58,7 @@
 #endif
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -79,6 +80,23 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* CONFIG_DEV_PIPE_SPSC:  Order the buffer accesses against the index
+ * updates.  A compiler barrier is sufficient on a single CPU; SMP platforms
+ * also need the hardware barrier.
+ */
+
+#if defined(CONFIG_DEV_PIPE_SPSC) && defined(CONFIG_SPINLOCK)
+#  define PIPE_BARRIER() \
+  do \
+    { \
+      __asm__ __volatile__("" ::: "memory"); \
+      SP_DSB(); \
+    } \
+  while (0)
+#elif defined(CONFIG_DEV_PIPE_SPSC)
+#  define PIPE_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -154,6 +172,54 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   CONFIG_DEV_PIPE_SPSC:  Wake up the other side of the pipe if it has
+ *   announced that it is waiting.  Called after an index has been updated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+static void pipecommon_wakeup(FAR volatile bool *waiting, FAR sem_t *sem)
+{
+  PIPE_BARRIER();
+
+  if (*waiting)
+    {
+      *waiting = false;
+      nxsem_post(sem);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_spsc_pollnotify
+ *
+ * Description:
+ *   CONFIG_DEV_PIPE_SPSC:  Notify poll waiters.  d_bfsem, which protects the
+ *   d_fds[] array, is taken only if a poll is set up.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+#ifndef CONFIG_DISABLE_POLL
+static void pipecommon_spsc_pollnotify(FAR struct pipe_dev_s *dev,
+                                       pollevent_t eventset)
+{
+  if (dev->d_npolls > 0)
+    {
+      pipecommon_semtake(&dev->d_bfsem);
+      pipecommon_pollnotify(dev, eventset);
+      nxsem_post(&dev->d_bfsem);
+    }
+}
+#else
+#  define pipecommon_spsc_pollnotify(dev,event)
+#endif
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -358,6 +424,12 @@ int pipecommon_close(FAR struct file *filep)
                   nxsem_post(&dev->d_rdsem);
                 }
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+              /* A reader may be just about to wait */
+
+              pipecommon_wakeup(&dev->d_rdwaiting, &dev->d_rdsem);
+#endif
+
               /* Inform poll readers that other end closed. */
 
               pipecommon_pollnotify(dev, POLLHUP);
@@ -422,8 +494,106 @@ int pipecommon_close(FAR struct file *filep)
 
 /****************************************************************************
  * Name: pipecommon_read
+ *
+ * Description:
+ *   CONFIG_DEV_PIPE_SPSC version.  The reader owns d_rdndx and the writer
+ *   owns d_wrndx so the data transfer needs no lock.  The semaphores are
+ *   used only to block the reader on an empty pipe and the writer on a full
+ *   pipe.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  pipe_ndx_t             rdndx;
+  pipe_ndx_t             wrndx;
+  size_t                 nread  = 0;
+  size_t                 nbytes;
+  int                    ret;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  rdndx = dev->d_rdndx;
+  while ((wrndx = dev->d_wrndx) == rdndx)
+    {
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0)
+        {
+          return 0;
+        }
+
+      /* Announce that we are about to wait, then look again.  Either the
+       * writer will see d_rdwaiting or we will see the new d_wrndx.
+       */
+
+      dev->d_rdwaiting = true;
+      PIPE_BARRIER();
+
+      if (dev->d_wrndx == rdndx && dev->d_nwriters > 0)
+        {
+          ret = nxsem_wait(&dev->d_rdsem);
+          if (ret < 0)
+            {
+              dev->d_rdwaiting = false;
+              return ret;
+            }
+        }
+
+      dev->d_rdwaiting = false;
+    }
+
+  PIPE_BARRIER();
+
+  /* Copy whatever is available (in at most two contiguous pieces) */
+
+  while (nread < len && rdndx != wrndx)
+    {
+      nbytes = (wrndx > rdndx ? wrndx : dev->d_bufsize) - rdndx;
+      if (nbytes > len - nread)
+        {
+          nbytes = len - nread;
+        }
+
+      memcpy(&buffer[nread], &dev->d_buffer[rdndx], nbytes);
+      nread += nbytes;
+      rdndx += nbytes;
+
+      if (rdndx >= dev->d_bufsize)
+        {
+          rdndx = 0;
+        }
+    }
+
+  /* Release the space to the writer and wake it if it is waiting for space */
+
+  PIPE_BARRIER();
+  dev->d_rdndx = rdndx;
+
+  pipecommon_wakeup(&dev->d_wrwaiting, &dev->d_wrsem);
+  pipecommon_spsc_pollnotify(dev, POLLOUT);
+
+  pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buffer, nread);
+  return nread;
+}
+#else
 ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
   FAR struct inode      *inode  = filep->f_inode;
@@ -512,11 +682,132 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   pipe_dumpbuffer("From PIPE:", start, nread);
   return nread;
 }
+#endif /* CONFIG_DEV_PIPE_SPSC */
 
 /****************************************************************************
  * Name: pipecommon_write
+ *
+ * Description:
+ *   CONFIG_DEV_PIPE_SPSC version.  See pipecommon_read().
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  FAR struct inode      *inode    = filep->f_inode;
+  FAR struct pipe_dev_s *dev      = inode->i_private;
+  pipe_ndx_t             rdndx;
+  pipe_ndx_t             wrndx;
+  size_t                 nwritten = 0;
+  size_t                 nbytes;
+  int                    nxtwrndx;
+
+  DEBUGASSERT(dev);
+  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* This method may wait on d_wrsem so it cannot be called from interrupt
+   * handlers.
+   */
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* Loop until all of the bytes have been written */
+
+  wrndx = dev->d_wrndx;
+  for (; ; )
+    {
+      rdndx = dev->d_rdndx;
+      PIPE_BARRIER();
+
+      /* Copy as much as fits.  One byte of the buffer is always left unused
+       * so that a full buffer can be distinguished from an empty one.
+       */
+
+      while (nwritten < len)
+        {
+          if (wrndx >= rdndx)
+            {
+              nbytes = dev->d_bufsize - wrndx - (rdndx == 0 ? 1 : 0);
+            }
+          else
+            {
+              nbytes = rdndx - wrndx - 1;
+            }
+
+          if (nbytes == 0)
+            {
+              break;
+            }
+
+          if (nbytes > len - nwritten)
+            {
+              nbytes = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[wrndx], &buffer[nwritten], nbytes);
+          nwritten += nbytes;
+          wrndx    += nbytes;
+
+          if (wrndx >= dev->d_bufsize)
+            {
+              wrndx = 0;
+            }
+        }
+
+      /* Publish the new data and wake the reader if it is waiting for it */
+
+      if (wrndx != dev->d_wrndx)
+        {
+          PIPE_BARRIER();
+          dev->d_wrndx = wrndx;
+
+          pipecommon_wakeup(&dev->d_rdwaiting, &dev->d_rdsem);
+          pipecommon_spsc_pollnotify(dev, POLLIN);
+        }
+
+      /* Is the write complete? */
+
+      if (nwritten >= len)
+        {
+          return len;
+        }
+
+      /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return nwritten > 0 ? (ssize_t)nwritten : -EAGAIN;
+        }
+
+      /* The buffer is full.  Announce that we are about to wait, then look
+       * again before waiting for data to be removed from the pipe.
+       */
+
+      nxtwrndx = wrndx + 1;
+      if (nxtwrndx >= dev->d_bufsize)
+        {
+          nxtwrndx = 0;
+        }
+
+      dev->d_wrwaiting = true;
+      PIPE_BARRIER();
+
+      if (nxtwrndx == dev->d_rdndx)
+        {
+          pipecommon_semtake(&dev->d_wrsem);
+        }
+
+      dev->d_wrwaiting = false;
+    }
+}
+#else
 ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                          size_t len)
 {
@@ -646,6 +937,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 }
+#endif /* CONFIG_DEV_PIPE_SPSC */
 
 /****************************************************************************
  * Name: pipecommon_poll
@@ -683,6 +975,9 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
               dev->d_fds[i] = fds;
               fds->priv     = &dev->d_fds[i];
+#ifdef CONFIG_DEV_PIPE_SPSC
+              dev->d_npolls++;
+#endif
               break;
             }
         }
@@ -694,6 +989,14 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
           goto errout;
         }
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+      /* Make d_npolls visible before sampling the indices so that any
+       * concurrent transfer either is seen here or will notify us.
+       */
+
+      PIPE_BARRIER();
+#endif
+
       /* Should immediately notify on any of the requested events?
        * First, determine how many bytes are in the buffer
        */
@@ -762,6 +1065,9 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       *slot                = NULL;
       fds->priv            = NULL;
+#ifdef CONFIG_DEV_PIPE_SPSC
+      dev->d_npolls--;
+#endif
     }
 
 errout:
@@ -132,8 +132,16 @@ struct pipe_dev_s
   sem_t      d_bfsem;       /* Used to serialize access to d_buffer and indices */
   sem_t      d_rdsem;       /* Empty buffer - Reader waits for data write */
   sem_t      d_wrsem;       /* Full buffer - Writer waits for data read */
+#ifdef CONFIG_DEV_PIPE_SPSC
+  volatile pipe_ndx_t d_wrndx; /* Index in d_buffer to save next byte written */
+  volatile pipe_ndx_t d_rdndx; /* Index in d_buffer to return the next byte read */
+  volatile bool d_rdwaiting;   /* Reader is (about to be) waiting on d_rdsem */
+  volatile bool d_wrwaiting;   /* Writer is (about to be) waiting on d_wrsem */
+  uint8_t    d_npolls;      /* Number of poll() setups in d_fds[] */
+#else
   pipe_ndx_t d_wrndx;       /* Index in d_buffer to save next byte written */
   pipe_ndx_t d_rdndx;       /* Index in d_buffer to return the next byte read */
+#endif
   pipe_ndx_t d_bufsize;     /* allocated size of d_buffer in bytes */
   uint8_t    d_refs;        /* References counts on pipe (limited to 255) */
   uint8_t    d_nwriters;    /* Number of reference counts for write access */
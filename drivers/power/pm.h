@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <queue.h>
 
@@ -72,6 +74,10 @@
 
 #define TIME_SLICE_TICKS ((CONFIG_PM_SLICEMS * CLOCKS_PER_SEC) /  1000)
 
+/* The number of power management states */
+
+#define PM_NSTATES (PM_SLEEP + 1)
+
 /* Function-like macros *****************************************************/
 /****************************************************************************
  * Name: pm_lock
@@ -97,6 +103,17 @@
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+#ifdef CONFIG_PM_GOVERNOR
+/* Residency statistics for one power management state */
+
+struct pm_residency_s
+{
+  uint32_t count;   /* Number of idle periods spent in the state */
+  uint32_t early;   /* Periods shorter than the target residency */
+  uint64_t usec;    /* Total time spent in the state (microseconds) */
+};
+#endif
+
 /* This describes the activity and state for one domain */
 
 struct pm_domain_s
@@ -139,6 +156,27 @@ struct pm_domain_s
   /* stime - The time (in ticks) at the start of the current time slice */
 
   systime_t stime;
+
+#ifdef CONFIG_PM_GOVERNOR
+  /* Predictive governor state:
+   *
+   * idlestart - The time (in ticks) when the IDLE loop last checked the
+   *             state, i.e., the start of the current idle period.
+   * idling    - True between pm_checkstate() and pm_idleexit().
+   * hndx      - The index to the next slot in the history[] array to use.
+   * hcnt      - The number of valid entries in history[].
+   * history   - The durations of the most recent idle periods
+   *             (microseconds).
+   * residency - Statistics for each state.
+   */
+
+  systime_t idlestart;
+  bool idling;
+  uint8_t hndx;
+  uint8_t hcnt;
+  uint32_t history[CONFIG_PM_GOVERNOR_NHISTORY];
+  struct pm_residency_s residency[PM_NSTATES];
+#endif
 };
 
 /* This structure encapsulates all of the global data used by the PM module */
@@ -213,6 +251,33 @@ EXTERN struct pm_global_s g_pmglobals;
 
 void pm_update(int domain, int16_t accum);
 
+/****************************************************************************
+ * Name: pm_governor_select
+ *
+ * Description:
+ *   Refine the state recommended by the activity averaging algorithm.  The
+ *   predicted idle time is the shorter of the time until the next watchdog
+ *   expires and the typical duration of the recent idle periods.  The
+ *   deepest state whose target residency fits in the predicted idle time
+ *   and whose exit latency will not delay the next watchdog is selected,
+ *   but never a deeper state than 'recommended'.
+ *
+ * Input Parameters:
+ *   domain      - The PM domain being checked
+ *   recommended - The state recommended by pm_update()
+ *
+ * Returned Value:
+ *   The selected state.
+ *
+ * Assumptions:
+ *   Called from pm_checkstate() in the IDLE loop.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_GOVERNOR
+enum pm_state_e pm_governor_select(int domain, enum pm_state_e recommended);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -64,6 +64,10 @@
  *   not automatically changed, however.  The IDLE loop must call
  *   pm_changestate() in order to make the state change.
  *
+ *   If CONFIG_PM_GOVERNOR is selected, the recommended state is refined by
+ *   the predictive governor and the IDLE loop must call pm_idleexit() when
+ *   it wakes up.
+ *
  *   These two steps are separated because the plaform-specific IDLE loop may
  *   have additional situational information that is not available to the
  *   the PM sub-system.  For example, the IDLE loop may know that the
@@ -137,10 +141,18 @@ enum pm_state_e pm_checkstate(int domain)
   /* Return the recommended state.  Assuming that we are called from the
    * IDLE thread at the lowest priority level, any updates scheduled on the
    * worker thread above should have already been peformed and the recommended
-   * state should be current:
+   * state should be current.
+   */
+
+#ifdef CONFIG_PM_GOVERNOR
+  /* Let the predictive governor refine the recommended state using the
+   * time until the next timer event and the recent idle history.
    */
 
+  return pm_governor_select(domain, pdom->recommended);
+#else
   return pdom->recommended;
+#endif
 }
 
 #endif /* CONFIG_PM */
@@ -0,0 +1,325 @@
+/****************************************************************************
+ * drivers/power/pm_governor.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/power/pm.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+
+#include "pm.h"
+
+#ifdef CONFIG_PM_GOVERNOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Idle periods are clipped to this duration (microseconds) when they are
+ * added to the history.  This keeps the variance computation in range and
+ * any longer period is already longer than every target residency.
+ */
+
+#define PM_HISTORY_MAX  10000000
+
+/* No prediction:  The idle period is unbounded */
+
+#define PM_UNBOUNDED    UINT32_MAX
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The target residency and exit latency of each state (microseconds) */
+
+static const uint32_t g_residency[PM_NSTATES] =
+{
+  0,
+  CONFIG_PM_IDLE_RESIDENCY,
+  CONFIG_PM_STANDBY_RESIDENCY,
+  CONFIG_PM_SLEEP_RESIDENCY
+};
+
+static const uint32_t g_exitlatency[PM_NSTATES] =
+{
+  0,
+  CONFIG_PM_IDLE_EXITLATENCY,
+  CONFIG_PM_STANDBY_EXITLATENCY,
+  CONFIG_PM_SLEEP_EXITLATENCY
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_typical
+ *
+ * Description:
+ *   Return the typical duration of the recent idle periods.  If the
+ *   history is consistent (the standard deviation is within a quarter of
+ *   the average) the average is returned.  Otherwise, the longest periods
+ *   are discarded as outliers, as long as three quarters of the history
+ *   remain, and the test is repeated.
+ *
+ ****************************************************************************/
+
+static uint32_t pm_typical(FAR struct pm_domain_s *pdom)
+{
+  uint32_t thresh = PM_UNBOUNDED;
+  uint32_t max;
+  uint64_t sum;
+  uint64_t avg;
+  uint64_t var;
+  int64_t diff;
+  int n;
+  int i;
+
+  if (pdom->hcnt < CONFIG_PM_GOVERNOR_NHISTORY)
+    {
+      /* Not enough history yet */
+
+      return PM_UNBOUNDED;
+    }
+
+  for (; ; )
+    {
+      /* Average the periods below the threshold */
+
+      sum = 0;
+      max = 0;
+      n   = 0;
+
+      for (i = 0; i < pdom->hcnt; i++)
+        {
+          if (pdom->history[i] <= thresh)
+            {
+              sum += pdom->history[i];
+              n++;
+
+              if (pdom->history[i] > max)
+                {
+                  max = pdom->history[i];
+                }
+            }
+        }
+
+      if (n == 0)
+        {
+          return PM_UNBOUNDED;
+        }
+
+      avg = sum / n;
+
+      /* Then the variance of those periods */
+
+      var = 0;
+      for (i = 0; i < pdom->hcnt; i++)
+        {
+          if (pdom->history[i] <= thresh)
+            {
+              diff = (int64_t)pdom->history[i] - (int64_t)avg;
+              var += (uint64_t)(diff * diff);
+            }
+        }
+
+      var /= n;
+
+      /* Accept the average if stddev <= avg / 4 */
+
+      if (var * 16 <= avg * avg)
+        {
+          return (uint32_t)avg;
+        }
+
+      /* Discard the longest periods, but keep three quarters of the
+       * history.
+       */
+
+      if (max == 0 || (n - 1) * 4 < pdom->hcnt * 3)
+        {
+          return PM_UNBOUNDED;
+        }
+
+      thresh = max - 1;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_governor_select
+ *
+ * Description:
+ *   Refine the state recommended by the activity averaging algorithm.  See
+ *   pm.h.
+ *
+ ****************************************************************************/
+
+enum pm_state_e pm_governor_select(int domain, enum pm_state_e recommended)
+{
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+  uint64_t next;
+  uint32_t predicted;
+  uint32_t typical;
+  int state;
+  int ticks;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+  pdom = &g_pmglobals.domain[domain];
+
+  flags = enter_critical_section();
+
+  /* The CPU will be woken up by the next watchdog at the latest */
+
+  ticks = wd_getnext();
+  next  = ticks > 0 ? (uint64_t)ticks * USEC_PER_TICK : PM_UNBOUNDED;
+  if (next > PM_UNBOUNDED)
+    {
+      next = PM_UNBOUNDED;
+    }
+
+  /* And probably sooner if the recent idle periods were shorter */
+
+  predicted = (uint32_t)next;
+  typical   = pm_typical(pdom);
+  if (typical < predicted)
+    {
+      predicted = typical;
+    }
+
+  /* Select the deepest state that pays off and that does not delay the
+   * next watchdog, but no deeper than the activity recommendation.
+   */
+
+  for (state = recommended; state > PM_NORMAL; state--)
+    {
+      if (g_residency[state] <= predicted &&
+          g_exitlatency[state] <= (uint32_t)next)
+        {
+          break;
+        }
+    }
+
+  /* Start the idle period */
+
+  pdom->idlestart = clock_systimer();
+  pdom->idling    = true;
+
+  leave_critical_section(flags);
+  return (enum pm_state_e)state;
+}
+
+/****************************************************************************
+ * Name: pm_idleexit
+ *
+ * Description:
+ *   This function is called from the MCU-specific IDLE loop when it wakes
+ *   up from the low power state entered after pm_checkstate().  The
+ *   duration of the idle period is recorded in the residency statistics of
+ *   the current state and in the history used by the predictive governor.
+ *
+ * Input Parameters:
+ *   domain - The PM domain that was checked
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_idleexit(int domain)
+{
+  FAR struct pm_domain_s *pdom;
+  FAR struct pm_residency_s *residency;
+  irqstate_t flags;
+  uint64_t usec;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+  pdom = &g_pmglobals.domain[domain];
+
+  flags = enter_critical_section();
+  if (pdom->idling)
+    {
+      DEBUGASSERT(pdom->state < PM_NSTATES);
+
+      usec = (uint64_t)(clock_systimer() - pdom->idlestart) * USEC_PER_TICK;
+
+      /* Update the residency statistics of the current state */
+
+      residency         = &pdom->residency[pdom->state];
+      residency->count++;
+      residency->usec  += usec;
+
+      if (usec < g_residency[pdom->state])
+        {
+          residency->early++;
+        }
+
+      /* Add the period to the history */
+
+      if (usec > PM_HISTORY_MAX)
+        {
+          usec = PM_HISTORY_MAX;
+        }
+
+      pdom->history[pdom->hndx] = (uint32_t)usec;
+      if (++pdom->hndx >= CONFIG_PM_GOVERNOR_NHISTORY)
+        {
+          pdom->hndx = 0;
+        }
+
+      if (pdom->hcnt < CONFIG_PM_GOVERNOR_NHISTORY)
+        {
+          pdom->hcnt++;
+        }
+
+      pdom->idling = false;
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_PM_GOVERNOR */
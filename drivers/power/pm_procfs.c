@@ -0,0 +1,373 @@
+/****************************************************************************
+ * drivers/power/pm_procfs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+#if defined(CONFIG_PM_GOVERNOR) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_PM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PM_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pm_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  FAR char *buffer;           /* User provided buffer */
+  size_t remaining;           /* Number of available characters in buffer */
+  size_t ncopied;             /* Number of characters in buffer */
+  off_t offset;               /* Current file offset */
+  char line[PM_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     pm_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     pm_close(FAR struct file *filep);
+static ssize_t pm_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     pm_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     pm_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_pm_statenames[PM_NSTATES] =
+{
+  "NORMAL",
+  "IDLE",
+  "STANDBY",
+  "SLEEP"
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations pm_procfsoperations =
+{
+  pm_open,       /* open */
+  pm_close,      /* close */
+  pm_read,       /* read */
+  NULL,          /* write */
+
+  pm_dup,        /* dup */
+
+  NULL,          /* opendir */
+  NULL,          /* closedir */
+  NULL,          /* readdir */
+  NULL,          /* rewinddir */
+
+  pm_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_printf
+ *
+ * Description:
+ *   Format one line of output and copy it to the user buffer, honoring the
+ *   current file offset.
+ *
+ ****************************************************************************/
+
+static void pm_printf(FAR struct pm_file_s *pmfile,
+                      FAR const IPTR char *fmt, ...)
+{
+  va_list ap;
+  size_t linesize;
+  size_t copysize;
+
+  va_start(ap, fmt);
+  linesize = vsnprintf(pmfile->line, PM_LINELEN, fmt, ap);
+  va_end(ap);
+
+  if (linesize >= PM_LINELEN)
+    {
+      linesize = PM_LINELEN - 1;
+    }
+
+  copysize = procfs_memcpy(pmfile->line, linesize, pmfile->buffer,
+                           pmfile->remaining, &pmfile->offset);
+
+  pmfile->ncopied   += copysize;
+  pmfile->buffer    += copysize;
+  pmfile->remaining -= copysize;
+}
+
+/****************************************************************************
+ * Name: pm_open
+ ****************************************************************************/
+
+static int pm_open(FAR struct file *filep, FAR const char *relpath,
+                   int oflags, mode_t mode)
+{
+  FAR struct pm_file_s *pmfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "pm" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "pm") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  pmfile = (FAR struct pm_file_s *)kmm_zalloc(sizeof(struct pm_file_s));
+  if (!pmfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)pmfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_close
+ ****************************************************************************/
+
+static int pm_close(FAR struct file *filep)
+{
+  FAR struct pm_file_s *pmfile;
+
+  /* Recover our private data from the struct file instance */
+
+  pmfile = (FAR struct pm_file_s *)filep->f_priv;
+  DEBUGASSERT(pmfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(pmfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_read
+ *
+ * Description:
+ *   Generate the content of /proc/pm.  Output format:
+ *
+ *   DOMAIN STATE        COUNT      EARLY     TIME(ms)
+ *   DDDDDD SSSSSSS DDDDDDDDDD DDDDDDDDDD DDDDDDDDDDDD
+ *
+ *   COUNT is the number of idle periods spent in the state and TIME is
+ *   their total duration.  EARLY is the number of those periods that ended
+ *   before the target residency of the state.
+ *
+ ****************************************************************************/
+
+static ssize_t pm_read(FAR struct file *filep, FAR char *buffer,
+                       size_t buflen)
+{
+  FAR struct pm_file_s *pmfile;
+  struct pm_residency_s residency;
+  irqstate_t flags;
+  int domain;
+  int state;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  pmfile = (FAR struct pm_file_s *)filep->f_priv;
+  DEBUGASSERT(pmfile);
+
+  /* Save the file offset and the user buffer information */
+
+  pmfile->offset    = filep->f_pos;
+  pmfile->buffer    = buffer;
+  pmfile->remaining = buflen;
+  pmfile->ncopied   = 0;
+
+  pm_printf(pmfile, "DOMAIN STATE        COUNT      EARLY     TIME(ms)\n");
+
+  for (domain = 0; domain < CONFIG_PM_NDOMAINS; domain++)
+    {
+      for (state = 0; state < PM_NSTATES; state++)
+        {
+          /* Take a consistent snapshot of the statistics */
+
+          flags     = enter_critical_section();
+          residency = g_pmglobals.domain[domain].residency[state];
+          leave_critical_section(flags);
+
+          pm_printf(pmfile, "%6d %-7s %10lu %10lu %12llu\n", domain,
+                    g_pm_statenames[state],
+                    (unsigned long)residency.count,
+                    (unsigned long)residency.early,
+                    (unsigned long long)(residency.usec / 1000));
+        }
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += pmfile->ncopied;
+  return pmfile->ncopied;
+}
+
+/****************************************************************************
+ * Name: pm_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pm_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct pm_file_s *oldattr;
+  FAR struct pm_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct pm_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct pm_file_s *)kmm_malloc(sizeof(struct pm_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct pm_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pm_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "pm" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "pm") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "pm" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_PM_GOVERNOR && CONFIG_FS_PROCFS && ... */
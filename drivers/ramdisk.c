@@ -366,22 +366,48 @@ static int rd_geometry(FAR struct inode *inode, struct geometry *geometry)
 static int rd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 {
   FAR struct rd_struct_s *dev;
+  FAR struct blockmap_s *map;
   FAR void **ppv = (void**)((uintptr_t)arg);
 
   finfo("Entry\n");
 
-  /* Only one ioctl command is supported */
-
   DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct rd_struct_s *)inode->i_private;
+
   if (cmd == BIOC_XIPBASE && ppv)
     {
-      dev  = (FAR struct rd_struct_s *)inode->i_private;
       *ppv = (FAR void *)dev->rd_buffer;
 
       finfo("ppv: %p\n", *ppv);
       return OK;
     }
 
+  /* The RAM disk memory is contiguous so any range of sectors may be
+   * mapped.  Mapped sectors of a write-enabled RAM disk may be modified in
+   * place.
+   */
+
+  if (cmd == BIOC_MAP && arg != 0)
+    {
+      map = (FAR struct blockmap_s *)((uintptr_t)arg);
+      if (map->bm_start >= dev->rd_nsectors ||
+          map->bm_nsectors > dev->rd_nsectors - map->bm_start)
+        {
+          return -EINVAL;
+        }
+
+      map->bm_addr     = (FAR void *)
+                         &dev->rd_buffer[map->bm_start * dev->rd_sectsize];
+#ifdef CONFIG_FS_WRITABLE
+      map->bm_writable = RDFLAG_IS_WRENABLED(dev->rd_flags);
+#else
+      map->bm_writable = false;
+#endif
+
+      finfo("bm_addr: %p\n", map->bm_addr);
+      return OK;
+    }
+
   return -ENOTTY;
 }
 
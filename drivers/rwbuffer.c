@@ -33,7 +33,6 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *
  ****************************************************************************/
-
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -51,6 +50,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/drivers/rwbuffer.h>
@@ -71,6 +71,15 @@
 #  define CONFIG_DRVR_WRDELAY 350
 #endif
 
+/* Write slot states.  The worker owns the buffer of a FLUSHING slot; other
+ * slots are protected by wrsem.
+ */
+
+#define RWB_SLOT_EMPTY     0  /* Holds no data */
+#define RWB_SLOT_BUFFERING 1  /* Accepting writes */
+#define RWB_SLOT_PENDING   2  /* Full and queued for the worker */
+#define RWB_SLOT_FLUSHING  3  /* Being written by the worker */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -140,22 +149,92 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
 }
 
 /****************************************************************************
- * Name: rwb_resetwrbuffer
+ * Name: rwb_resetwrslot
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static inline void rwb_resetwrslot(FAR struct rwb_wrslot_s *slot)
+{
+  slot->nblocks    = 0;
+  slot->blockstart = (off_t)-1;
+  slot->state      = RWB_SLOT_EMPTY;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_flushslot
+ *
+ * Description:
+ *   Write the contents of one slot to the media and empty the slot.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore and the slot is not being flushed
+ *   by the worker.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
+static int rwb_flushslot(FAR struct rwbuffer_s *rwb,
+                         FAR struct rwb_wrslot_s *slot)
 {
-  /* We assume that the caller holds the wrsem */
+  int ret = OK;
+
+  if (slot->nblocks > 0)
+    {
+      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+            (long)slot->blockstart, slot->nblocks, slot->buffer);
+
+      /* Flush the slot.  On success, the flush method will return the
+       * number of blocks written.  Anything other than the number
+       * requested is an error.
+       */
+
+      rwb_semtake(&rwb->flushsem);
+      ret = rwb->wrflush(rwb->dev, slot->buffer, slot->blockstart,
+                         slot->nblocks);
+      rwb_semgive(&rwb->flushsem);
+
+      if (ret != slot->nblocks)
+        {
+          ferr("ERROR: Error flushing write buffer: %d\n", ret);
+          ret = ret < 0 ? ret : -EIO;
+        }
+      else
+        {
+          ret = OK;
+        }
+    }
+
+  rwb_resetwrslot(slot);
+  return ret;
+}
+#endif
 
-  rwb->wrnblocks       = 0;
-  rwb->wrblockstart    = (off_t)-1;
-  rwb->wrexpectedblock = (off_t)-1;
+/****************************************************************************
+ * Name: rwb_wrwait
+ *
+ * Description:
+ *   Wait for the worker to finish flushing a slot.  wrsem is released
+ *   while waiting so the caller must re-examine the slots afterward.  The
+ *   worker holds flushsem while it writes and empties a slot.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrwait(FAR struct rwbuffer_s *rwb)
+{
+  rwb_semgive(&rwb->wrsem);
+  rwb_semtake(&rwb->flushsem);
+  rwb_semgive(&rwb->flushsem);
+  rwb_semtake(&rwb->wrsem);
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_wrflush
+ * Name: rwb_wrflushrange
+ *
+ * Description:
+ *   Flush every slot that holds any of the specified blocks.
  *
  * Assumptions:
  *   The caller holds the wrsem semaphore.
@@ -163,31 +242,122 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrflushrange(FAR struct rwbuffer_s *rwb, off_t startblock,
+                            size_t nblocks)
 {
+  FAR struct rwb_wrslot_s *slot;
   int ret;
+  int i;
 
-  finfo("Timeout!\n");
+  for (i = 0; i < CONFIG_DRVR_WRSLOTS; i++)
+    {
+      slot = &rwb->wrslot[i];
+      if (slot->state == RWB_SLOT_EMPTY ||
+          !rwb_overlap(slot->blockstart, slot->nblocks, startblock, nblocks))
+        {
+          continue;
+        }
+
+      if (slot->state == RWB_SLOT_FLUSHING)
+        {
+          /* Wait for the worker, then start over */
+
+          rwb_wrwait(rwb);
+          i = -1;
+          continue;
+        }
+
+      ret = rwb_flushslot(rwb, slot);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+#  define rwb_wrflush(rwb) rwb_wrflushrange(rwb, 0, (rwb)->nblocks)
+#endif
 
-  if (rwb->wrnblocks > 0)
+/****************************************************************************
+ * Name: rwb_flushworker
+ *
+ * Description:
+ *   Write the full slots to the media on the worker thread so that the
+ *   writer can continue in another slot.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_flushworker(FAR void *arg)
+{
+  FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
+  FAR struct rwb_wrslot_s *slot;
+  int ret;
+  int i;
+
+  DEBUGASSERT(rwb != NULL);
+
+  rwb_semtake(&rwb->wrsem);
+  for (i = 0; i < CONFIG_DRVR_WRSLOTS; i++)
     {
-      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-      (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+      slot = &rwb->wrslot[i];
+      if (slot->state != RWB_SLOT_PENDING)
+        {
+          continue;
+        }
 
-      /* Flush cache.  On success, the flush method will return the number
-       * of blocks written.  Anything other than the number requested is
-       * an error.
+      /* Take ownership of the slot and write it without holding wrsem so
+       * that the writers are not blocked.  The slot is emptied before
+       * flushsem is released; that is what rwb_wrwait() waits for.
        */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+      slot->state = RWB_SLOT_FLUSHING;
+      rwb_semgive(&rwb->wrsem);
+
+      rwb_semtake(&rwb->flushsem);
+      ret = rwb->wrflush(rwb->dev, slot->buffer, slot->blockstart,
+                         slot->nblocks);
+      if (ret != slot->nblocks)
         {
           ferr("ERROR: Error flushing write buffer: %d\n", ret);
         }
 
-      rwb_resetwrbuffer(rwb);
+      rwb_resetwrslot(slot);
+      rwb_semgive(&rwb->flushsem);
+
+      /* Other slots may have become pending in the meantime */
+
+      rwb_semtake(&rwb->wrsem);
+      i = -1;
     }
 
+  rwb_semgive(&rwb->wrsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_queueflush
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_queueflush(FAR struct rwbuffer_s *rwb,
+                           FAR struct rwb_wrslot_s *slot)
+{
+  slot->state = RWB_SLOT_PENDING;
+
+  /* If the work is already queued, the worker will find this slot too */
+
+  if (work_available(&rwb->flushwork))
+    {
+      (void)work_queue(LPWORK, &rwb->flushwork, rwb_flushworker,
+                       (FAR void *)rwb, 0);
+    }
 }
 #endif
 
@@ -195,6 +365,7 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
  * Name: rwb_wrtimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrtimeout(FAR void *arg)
 {
   /* The following assumes that the size of a pointer is 4-bytes or less */
@@ -202,41 +373,57 @@ static void rwb_wrtimeout(FAR void *arg)
   FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
   DEBUGASSERT(rwb != NULL);
 
+  finfo("Timeout!\n");
+
   /* If a timeout elapses with with write buffer activity, this watchdog
    * handler function will be evoked on the thread of execution of the
    * worker thread.
    */
 
   rwb_semtake(&rwb->wrsem);
-  rwb_wrflush(rwb);
+  (void)rwb_wrflush(rwb);
   rwb_semgive(&rwb->wrsem);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_wrstarttimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 {
-  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds. CLK_TCK
-   * provides the clock tick of the system (frequency in Hz).
-   */
+  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds */
 
-  int ticks = (CONFIG_DRVR_WRDELAY + CLK_TCK/2) / CLK_TCK;
-  (void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
+  (void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb,
+                   MSEC2TICK(CONFIG_DRVR_WRDELAY));
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_wrcanceltimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 {
   (void)work_cancel(LPWORK, &rwb->work);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_writebuffer
+ *
+ * Description:
+ *   Add the write data to a slot.  A write that continues the stream of
+ *   blocks in a slot is appended to that slot; one that rewrites blocks
+ *   already in a slot updates them in place.  Otherwise a new stream is
+ *   started in an empty slot or, failing that, in the least recently used
+ *   slot after writing it to the media.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -244,103 +431,176 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
+  FAR struct rwb_wrslot_s *stream;
+  FAR struct rwb_wrslot_s *victim;
+  FAR struct rwb_wrslot_s *slot;
   int ret;
+  int i;
 
-  /* Write writebuffer Logic */
+restart:
+  stream = NULL;
+  for (i = 0; i < CONFIG_DRVR_WRSLOTS; i++)
+    {
+      slot = &rwb->wrslot[i];
+      if (slot->state == RWB_SLOT_EMPTY)
+        {
+          continue;
+        }
 
-  rwb_wrcanceltimeout(rwb);
+      if (rwb_overlap(slot->blockstart, slot->nblocks, startblock, nblocks))
+        {
+          /* If all of the blocks are in a slot, just update them there */
 
-  /* First: Should we flush out our cache? We would do that if (1) we already
-   * buffering blocks and the next block writing is not in the same sequence,
-   * or (2) the number of blocks would exceed our allocated buffer capacity
-   */
+          if (slot->state == RWB_SLOT_BUFFERING &&
+              startblock >= slot->blockstart &&
+              startblock + nblocks <= slot->blockstart + slot->nblocks)
+            {
+              memcpy(&slot->buffer[(startblock - slot->blockstart) *
+                                   rwb->blocksize],
+                     wrbuffer, nblocks * rwb->blocksize);
+              slot->lastuse = ++rwb->wrclock;
+              return nblocks;
+            }
 
-  if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) ||
-      ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks))
-    {
-      finfo("writebuffer miss, expected: %08x, given: %08x\n",
-            rwb->wrexpectedblock, startblock);
+          /* Otherwise, the old data must reach the media first */
 
-      /* Flush the write buffer */
+          if (slot->state == RWB_SLOT_FLUSHING)
+            {
+              rwb_wrwait(rwb);
+              goto restart;
+            }
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-      if (ret < 0)
+          ret = rwb_flushslot(rwb, slot);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+      else if (slot->state == RWB_SLOT_BUFFERING &&
+               slot->blockstart + slot->nblocks == startblock)
         {
-          ferr("ERROR: Error writing multiple from cache: %d\n", -ret);
-          return ret;
+          stream = slot;
+        }
+    }
+
+  /* Does the write continue the stream in one of the slots? */
+
+  if (stream != NULL)
+    {
+      if (stream->nblocks + nblocks <= rwb->wrmaxblocks)
+        {
+          finfo("writebuffer: appending %d blocks at block %d\n",
+                nblocks, startblock);
+
+          memcpy(&stream->buffer[stream->nblocks * rwb->blocksize],
+                 wrbuffer, nblocks * rwb->blocksize);
+          stream->nblocks += nblocks;
+          stream->lastuse  = ++rwb->wrclock;
+          return nblocks;
         }
 
-      rwb_resetwrbuffer(rwb);
+      /* The slot is full.  Let the worker write it to the media while the
+       * stream continues in another slot.
+       */
+
+      rwb_queueflush(rwb, stream);
     }
 
-  /* writebuffer is empty? Then initialize it */
+  /* Start a new stream.  Prefer an empty slot, then one that is waiting
+   * for the worker anyway, then the least recently used one.
+   */
+
+  victim = NULL;
+  for (i = 0; i < CONFIG_DRVR_WRSLOTS; i++)
+    {
+      slot = &rwb->wrslot[i];
+      if (slot->state == RWB_SLOT_EMPTY)
+        {
+          victim = slot;
+          break;
+        }
+      else if (slot->state == RWB_SLOT_PENDING)
+        {
+          victim = slot;
+        }
+      else if (slot->state == RWB_SLOT_BUFFERING &&
+               (victim == NULL ||
+                (victim->state == RWB_SLOT_BUFFERING &&
+                 (int16_t)(slot->lastuse - victim->lastuse) < 0)))
+        {
+          victim = slot;
+        }
+    }
 
-  if (rwb->wrnblocks == 0)
+  if (victim == NULL)
     {
-      finfo("Fresh cache starting at block: 0x%08x\n", startblock);
-      rwb->wrblockstart = startblock;
+      /* All slots are being flushed by the worker */
+
+      rwb_wrwait(rwb);
+      goto restart;
     }
 
-  /* Add data to cache */
+  if (victim->state != RWB_SLOT_EMPTY)
+    {
+      finfo("writebuffer miss, flushing block: %08x\n", victim->blockstart);
+
+      ret = rwb_flushslot(rwb, victim);
+      if (ret < 0)
+        {
+          ferr("ERROR: Error writing multiple from cache: %d\n", -ret);
+          return ret;
+        }
+    }
 
-  finfo("writebuffer: copying %d bytes from %p to %p\n",
-        nblocks * rwb->blocksize, wrbuffer,
-        &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-  memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize],
-         wrbuffer, nblocks * rwb->blocksize);
+  finfo("Fresh cache starting at block: 0x%08x\n", startblock);
 
-  rwb->wrnblocks      += nblocks;
-  rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
-  rwb_wrstarttimeout(rwb);
+  memcpy(victim->buffer, wrbuffer, nblocks * rwb->blocksize);
+  victim->blockstart = startblock;
+  victim->nblocks    = nblocks;
+  victim->lastuse    = ++rwb->wrclock;
+  victim->state      = RWB_SLOT_BUFFERING;
   return nblocks;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_resetrhbuffer
+ * Name: rwb_resetrhslot
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
+static inline void rwb_resetrhslot(FAR struct rwb_rhslot_s *slot)
 {
-  /* We assume that the caller holds the readAheadBufferSemphore */
+  /* We assume that the caller holds the rhsem.  The stream state is kept
+   * so that a sequential reader continues to read ahead.
+   */
 
-  rwb->rhnblocks    = 0;
-  rwb->rhblockstart = (off_t)-1;
+  slot->nblocks    = 0;
+  slot->blockstart = (off_t)-1;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_bufferread
+ * Name: rwb_resetrhbuffer
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static inline void
-rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
-               size_t nblocks, uint8_t **rdbuffer)
+static void rwb_resetrhbuffer(FAR struct rwbuffer_s *rwb, off_t startblock,
+                              size_t nblocks)
 {
-  /* We assume that (1) the caller holds the readAheadBufferSemphore, and (2)
-   * that the caller already knows that all of the blocks are in the
-   * read-ahead buffer.
-   */
-
-  /* Convert the units from blocks to bytes */
-
-  off_t  blockoffset = startblock - rwb->rhblockstart;
-  off_t  byteoffset  = rwb->blocksize * blockoffset;
-  size_t nbytes      = rwb->blocksize * nblocks;
-
-  /* Get the byte address in the read-ahead buffer */
-
-  uint8_t *rhbuffer    = rwb->rhbuffer + byteoffset;
-
-  /* Copy the data from the read-ahead buffer into the IO buffer */
+  FAR struct rwb_rhslot_s *slot;
+  int i;
 
-  memcpy(*rdbuffer, rhbuffer, nbytes);
+  /* Discard every slot holding any of the blocks */
 
-  /* Update the caller's copy for the next address */
-
-  *rdbuffer += nbytes;
+  for (i = 0; i < CONFIG_DRVR_RHSLOTS; i++)
+    {
+      slot = &rwb->rhslot[i];
+      if (slot->nblocks > 0 &&
+          rwb_overlap(slot->blockstart, slot->nblocks, startblock, nblocks))
+        {
+          rwb_resetrhslot(slot);
+        }
+    }
 }
 #endif
 
@@ -349,10 +609,11 @@ rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
+static int rwb_rhreload(FAR struct rwbuffer_s *rwb,
+                        FAR struct rwb_rhslot_s *slot, off_t startblock,
+                        size_t nblocks)
 {
   off_t  endblock;
-  size_t nblocks;
   int    ret;
 
   /* Check for attempts to read beyond the end of the media */
@@ -366,7 +627,12 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
    * read-ahead buffer
    */
 
-  endblock = startblock + rwb->rhmaxblocks;
+  if (nblocks > rwb->rhmaxblocks)
+    {
+      nblocks = rwb->rhmaxblocks;
+    }
+
+  endblock = startblock + nblocks;
 
   /* Make sure that we don't read past the end of the device */
 
@@ -379,156 +645,253 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 
   /* Reset the read buffer */
 
-  rwb_resetrhbuffer(rwb);
+  rwb_resetrhslot(slot);
 
   /* Now perform the read */
 
-  ret = rwb->rhreload(rwb->dev, rwb->rhbuffer, startblock, nblocks);
+  ret = rwb->rhreload(rwb->dev, slot->buffer, startblock, nblocks);
   if (ret == nblocks)
     {
       /* Update information about what is in the read-ahead buffer */
 
-      rwb->rhnblocks    = nblocks;
-      rwb->rhblockstart = startblock;
+      slot->nblocks    = nblocks;
+      slot->blockstart = startblock;
+      slot->window     = nblocks;
 
       /* The return value is not the number of blocks we asked to be loaded. */
 
       return nblocks;
     }
 
-  return -EIO;
+  return ret < 0 ? ret : -EIO;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_invalidate_writebuffer
+ * Name: rwb_rhstream
  *
  * Description:
- *   Invalidate a region of the write buffer
+ *   Select the slot for a read of 'startblock' that missed all of the
+ *   slots and return the number of blocks to read ahead.  A read that
+ *   continues the stream of a slot doubles the read-ahead of that slot.
+ *   Any other read starts a new stream in the least recently used slot,
+ *   reading only the requested blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD
+static FAR struct rwb_rhslot_s *rwb_rhstream(FAR struct rwbuffer_s *rwb,
+                                             off_t startblock,
+                                             size_t remaining,
+                                             FAR size_t *window)
+{
+  FAR struct rwb_rhslot_s *lru = &rwb->rhslot[0];
+  FAR struct rwb_rhslot_s *slot;
+  int i;
+
+  for (i = 0; i < CONFIG_DRVR_RHSLOTS; i++)
+    {
+      slot = &rwb->rhslot[i];
+      if (slot->nextblock == startblock)
+        {
+          *window = (size_t)slot->window << 1;
+          if (*window < remaining)
+            {
+              *window = remaining;
+            }
+
+          finfo("Sequential read at %ld, read-ahead %d\n",
+                (long)startblock, *window);
+          return slot;
+        }
+
+      if ((int16_t)(slot->lastuse - lru->lastuse) < 0)
+        {
+          lru = slot;
+        }
+    }
+
+  *window = remaining;
+  return lru;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_invalidate_wrslot
+ *
+ * Description:
+ *   Invalidate a region of one write buffer slot
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore and the slot is not being flushed
+ *   by the worker.
  *
  ****************************************************************************/
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, size_t blockcount)
+static int rwb_invalidate_wrslot(FAR struct rwbuffer_s *rwb,
+                                 FAR struct rwb_wrslot_s *slot,
+                                 off_t startblock, size_t blockcount)
 {
+  off_t wrbend;
+  off_t invend;
   int ret = OK;
 
-  /* Is there a write buffer?  Is data saved in the write buffer? */
+  /* Now there are five cases:
+   *
+   * 1. We invalidate nothing
+   */
+
+  wrbend = slot->blockstart + slot->nblocks;
+  invend = startblock + blockcount;
 
-  if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
+  if (!rwb_overlap(slot->blockstart, slot->nblocks, startblock, blockcount))
     {
-      off_t wrbend;
-      off_t invend;
+      ret = OK;
+    }
 
-      finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
+  /* 2. We invalidate the entire slot. */
 
-      rwb_semtake(&rwb->wrsem);
+  else if (slot->blockstart >= startblock && wrbend <= invend)
+    {
+      rwb_resetwrslot(slot);
+      ret = OK;
+    }
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
-       */
+  /* We are going to invalidate a subset of the slot.  Three more cases to
+   * consider:
+   *
+   * 3. We invalidate a portion in the middle of the slot
+   */
+
+  else if (slot->blockstart < startblock && wrbend > invend)
+    {
+      FAR uint8_t *src;
+      off_t        block;
+      off_t        offset;
+      size_t       nblocks;
 
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      invend = startblock + blockcount;
+      /* Write the blocks at the end of the media to hardware */
 
-      if (rwb->wrblockstart > invend || wrbend < startblock)
+      nblocks = wrbend - invend;
+      block   = invend;
+      offset  = block - slot->blockstart;
+      src     = slot->buffer + offset * rwb->blocksize;
+
+      rwb_semtake(&rwb->flushsem);
+      ret = rwb->wrflush(rwb->dev, src, block, nblocks);
+      rwb_semgive(&rwb->flushsem);
+
+      if (ret < 0)
         {
-          ret = OK;
+          ferr("ERROR: wrflush failed: %d\n", ret);
         }
 
-      /* 2. We invalidate the entire write buffer. */
+      /* Keep the blocks at the beginning of the buffer up the
+       * start of the invalidated region.
+       */
 
-      else if (rwb->wrblockstart >= startblock && wrbend <= invend)
+      else
         {
-          rwb->wrnblocks = 0;
+          slot->nblocks = startblock - slot->blockstart;
           ret = OK;
         }
+    }
 
-      /* We are going to invalidate a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 2. We invalidate a portion in the middle of the write buffer
-       */
+  /* 4. We invalidate a portion at the end of the slot */
 
-      else if (rwb->wrblockstart < startblock && wrbend > invend)
-        {
-          uint8_t *src;
-          off_t    block;
-          off_t    offset;
-          size_t   nblocks;
+  else if (slot->blockstart < startblock)
+    {
+      slot->nblocks = startblock - slot->blockstart;
+      ret = OK;
+    }
 
-          /* Write the blocks at the end of the media to hardware */
+  /* 5. We invalidate a portion at the beginning of the slot */
 
-          nblocks = wrbend - invend;
-          block   = invend;
-          offset  = block - rwb->wrblockstart;
-          src     = rwb->wrbuffer + offset * rwb->blocksize;
+  else /* if (slot->blockstart >= startblock && wrbend > invend) */
+    {
+      FAR uint8_t *src;
+      size_t       ninval;
+      size_t       nkeep;
 
-          ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: wrflush failed: %d\n", ret);
-            }
+      DEBUGASSERT(slot->blockstart >= startblock && wrbend > invend);
 
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
-          else
-            {
-              rwb->wrnblocks = startblock - rwb->wrblockstart;
-              ret = OK;
-            }
-        }
+      /* Copy the data from the uninvalidated region to the beginning
+       * of the slot.
+       *
+       * First calculate the source and destination of the transfer.
+       */
 
-      /* 3. We invalidate a portion at the end of the write buffer */
+      ninval = invend - slot->blockstart;
+      src    = slot->buffer + ninval * rwb->blocksize;
 
-      else if (wrbend > startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks = wrbend - startblock;
-          ret = OK;
-        }
+      /* Calculate the number of blocks we are keeping.  We keep
+       * the ones that we don't invalidate.
+       */
 
-      /* 4. We invalidate a portion at the beginning of the write buffer */
+      nkeep  = slot->nblocks - ninval;
 
-      else /* if (rwb->wrblockstart >= startblock && wrbend > invend) */
-        {
-          uint8_t *src;
-          size_t   ninval;
-          size_t   nkeep;
+      /* Then move the data that we are keeping to the beginning
+       * the slot.
+       */
 
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
+      memmove(slot->buffer, src, nkeep * rwb->blocksize);
 
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the write buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
+      /* Update the block info.  The first block is now the one just
+       * after the invalidation region and the number buffered blocks
+       * is the number that we kept.
+       */
 
-          ninval = invend - rwb->wrblockstart;
-          src    = rwb->wrbuffer + ninval * rwb->blocksize;
+      slot->blockstart = invend;
+      slot->nblocks    = nkeep;
+      ret = OK;
+    }
 
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
+  return ret;
+}
+#endif
 
-          nkeep  = rwb->wrnblocks - ninval;
+/****************************************************************************
+ * Name: rwb_invalidate_writebuffer
+ *
+ * Description:
+ *   Invalidate a region of the write buffer
+ *
+ ****************************************************************************/
 
-          /* Then move the data that we are keeping to the beginning
-           * the write buffer.
-           */
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
+static int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
+                                      off_t startblock, size_t blockcount)
+{
+  FAR struct rwb_wrslot_s *slot;
+  int ret = OK;
+  int i;
 
-          memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
+  /* Is there a write buffer? */
 
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
+  if (rwb->wrmaxblocks > 0)
+    {
+      finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
 
-          rwb->wrblockstart = invend;
-          rwb->wrnblocks    = nkeep;
-          ret = OK;
+      rwb_semtake(&rwb->wrsem);
+      for (i = 0; i < CONFIG_DRVR_WRSLOTS && ret >= 0; i++)
+        {
+          slot = &rwb->wrslot[i];
+          if (slot->state == RWB_SLOT_EMPTY)
+            {
+              continue;
+            }
+
+          if (slot->state == RWB_SLOT_FLUSHING)
+            {
+              /* Wait for the worker, then start over */
+
+              rwb_wrwait(rwb);
+              i = -1;
+              continue;
+            }
+
+          ret = rwb_invalidate_wrslot(rwb, slot, startblock, blockcount);
         }
 
       rwb_semgive(&rwb->wrsem);
@@ -547,83 +910,64 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
  ****************************************************************************/
 
 #if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, size_t blockcount)
+static int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
+                                    off_t startblock, size_t blockcount)
 {
-  int ret;
+  FAR struct rwb_rhslot_s *slot;
+  off_t rhbend;
+  off_t invend;
+  int i;
 
-  if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
+  if (rwb->rhmaxblocks > 0)
     {
-      off_t rhbend;
-      off_t invend;
-
       finfo("startblock=%d blockcount=%p\n", startblock, blockcount);
 
       rwb_semtake(&rwb->rhsem);
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
-       */
-
-      rhbend = rwb->rhblockstart + rwb->rhnblocks;
-      invend = startblock + blockcount;
-
-      if (rhbend <= startblock || rwb->rhblockstart >= invend)
-        {
-          ret = OK;
-        }
-
-      /* 2. We invalidate the entire read-ahead buffer. */
-
-      else if (rwb->rhblockstart >= startblock && rhbend <= invend)
+      for (i = 0; i < CONFIG_DRVR_RHSLOTS; i++)
         {
-          rwb->rhnblocks = 0;
-          ret = OK;
-        }
-
-      /* We are going to invalidate a subset of the read-ahead buffer.
-       * Three more cases to consider:
-       *
-       * 2. We invalidate a portion in the middle of the read-ahead buffer
-       */
+          slot = &rwb->rhslot[i];
 
-      else if (rwb->rhblockstart < startblock && rhbend > invend)
-        {
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
+          /* Now there are five cases:
+           *
+           * 1. We invalidate nothing
            */
 
-          rwb->rhnblocks = startblock - rwb->rhblockstart;
-          ret = OK;
-        }
+          rhbend = slot->blockstart + slot->nblocks;
+          invend = startblock + blockcount;
 
-      /* 3. We invalidate a portion at the end of the read-ahead buffer */
+          if (slot->nblocks == 0 ||
+              rhbend <= startblock || slot->blockstart >= invend)
+            {
+              continue;
+            }
 
-      else if (rhbend > startblock && rhbend <= invend)
-        {
-          rwb->rhnblocks = rhbend - startblock;
-          ret = OK;
-        }
+          /* 2. We invalidate a portion at the end of the slot (or in the
+           *    middle of it) -- keep the blocks at the beginning of the
+           *    slot up the start of the invalidated region.
+           */
 
-      /* 4. We invalidate a portion at the beginning of the write buffer */
+          else if (slot->blockstart < startblock)
+            {
+              slot->nblocks = startblock - slot->blockstart;
+            }
 
-      else /* if (rwb->rhblockstart >= startblock && rhbend > invend) */
-        {
-          /* Let's just force the whole read-ahead buffer to be reloaded.
-           * That might cost s small amount of performance, but well worth
-           * the lower complexity.
+          /* 3. We invalidate the entire slot or a portion at the
+           *    beginning of the slot.  Let's just force the whole slot to
+           *    be reloaded.  That might cost s small amount of
+           *    performance, but well worth the lower complexity.
            */
 
-          DEBUGASSERT(rwb->rhblockstart >= startblock && rhbend > invend);
-          rwb->rhnblocks = 0;
-          ret = OK;
+          else
+            {
+              rwb_resetrhslot(slot);
+            }
         }
 
       rwb_semgive(&rwb->rhsem);
     }
 
-  return ret;
+  return OK;
 }
 #endif
 
@@ -637,6 +981,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
   uint32_t allocsize;
+  int i;
 
   /* Sanity checking */
 
@@ -661,26 +1006,30 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
     {
       finfo("Initialize the write buffer\n");
 
-      /* Initialize the write buffer access semaphore */
+      /* Initialize the write buffer access and flush semaphores */
 
       nxsem_init(&rwb->wrsem, 0, 1);
+      nxsem_init(&rwb->flushsem, 0, 1);
 
-      /* Initialize write buffer parameters */
+      /* Allocate the write buffer for all of the slots */
 
-      rwb_resetwrbuffer(rwb);
+      allocsize     = CONFIG_DRVR_WRSLOTS * rwb->wrmaxblocks * rwb->blocksize;
+      rwb->wrbuffer = kmm_malloc(allocsize);
+      if (!rwb->wrbuffer)
+        {
+          ferr("Write buffer kmm_malloc(%d) failed\n", allocsize);
+          return -ENOMEM;
+        }
 
-      /* Allocate the write buffer */
+      /* Initialize write buffer parameters */
 
-      rwb->wrbuffer = NULL;
-      if (rwb->wrmaxblocks > 0)
+      rwb->wrclock = 0;
+      for (i = 0; i < CONFIG_DRVR_WRSLOTS; i++)
         {
-          allocsize     = rwb->wrmaxblocks * rwb->blocksize;
-          rwb->wrbuffer = kmm_malloc(allocsize);
-          if (!rwb->wrbuffer)
-            {
-              ferr("Write buffer kmm_malloc(%d) failed\n", allocsize);
-              return -ENOMEM;
-            }
+          rwb->wrslot[i].buffer  = rwb->wrbuffer +
+                                   i * rwb->wrmaxblocks * rwb->blocksize;
+          rwb->wrslot[i].lastuse = 0;
+          rwb_resetwrslot(&rwb->wrslot[i]);
         }
 
       finfo("Write buffer size: %d bytes\n", allocsize);
@@ -696,22 +1045,27 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       nxsem_init(&rwb->rhsem, 0, 1);
 
-      /* Initialize read-ahead buffer parameters */
+      /* Allocate the read-ahead buffer for all of the slots */
 
-      rwb_resetrhbuffer(rwb);
+      allocsize     = CONFIG_DRVR_RHSLOTS * rwb->rhmaxblocks * rwb->blocksize;
+      rwb->rhbuffer = kmm_malloc(allocsize);
+      if (!rwb->rhbuffer)
+        {
+          ferr("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
+          return -ENOMEM;
+        }
 
-      /* Allocate the read-ahead buffer */
+      /* Initialize read-ahead buffer parameters */
 
-      rwb->rhbuffer = NULL;
-      if (rwb->rhmaxblocks > 0)
+      rwb->rhclock = 0;
+      for (i = 0; i < CONFIG_DRVR_RHSLOTS; i++)
         {
-          allocsize     = rwb->rhmaxblocks * rwb->blocksize;
-          rwb->rhbuffer = kmm_malloc(allocsize);
-          if (!rwb->rhbuffer)
-            {
-              ferr("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
-              return -ENOMEM;
-            }
+          rwb->rhslot[i].buffer    = rwb->rhbuffer +
+                                     i * rwb->rhmaxblocks * rwb->blocksize;
+          rwb->rhslot[i].nextblock = (off_t)-1;
+          rwb->rhslot[i].window    = 0;
+          rwb->rhslot[i].lastuse   = 0;
+          rwb_resetrhslot(&rwb->rhslot[i]);
         }
 
       finfo("Read-ahead buffer size: %d bytes\n", allocsize);
@@ -731,7 +1085,9 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
   if (rwb->wrmaxblocks > 0)
     {
       rwb_wrcanceltimeout(rwb);
+      (void)work_cancel(LPWORK, &rwb->flushwork);
       nxsem_destroy(&rwb->wrsem);
+      nxsem_destroy(&rwb->flushsem);
       if (rwb->wrbuffer)
         {
           kmm_free(rwb->wrbuffer);
@@ -759,7 +1115,12 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
                  size_t nblocks, FAR uint8_t *rdbuffer)
 {
 #ifdef CONFIG_DRVR_READAHEAD
+  FAR struct rwb_rhslot_s *slot;
   size_t remaining;
+  size_t rdblocks;
+  size_t window;
+  off_t  bufferend;
+  int    i;
 #endif
   int ret = OK;
 
@@ -775,17 +1136,16 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 
   if (rwb->wrmaxblocks > 0)
     {
-      /* If the write buffer overlaps the block(s) requested, then flush the
-       * write buffer.
-       */
+      /* If any slot overlaps the block(s) requested, then flush it */
 
       rwb_semtake(&rwb->wrsem);
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks))
+      ret = rwb_wrflushrange(rwb, startblock, nblocks);
+      rwb_semgive(&rwb->wrsem);
+
+      if (ret < 0)
         {
-          rwb_wrflush(rwb);
+          return (ssize_t)ret;
         }
-
-      rwb_semgive(&rwb->wrsem);
     }
 #endif
 
@@ -797,44 +1157,80 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
       rwb_semtake(&rwb->rhsem);
       for (remaining = nblocks; remaining > 0; )
         {
-          /* Is there anything in the read-ahead buffer? */
+          /* Is the next block in one of the slots? */
 
-          if (rwb->rhnblocks > 0)
+          for (i = 0; i < CONFIG_DRVR_RHSLOTS; i++)
             {
-              off_t  bufferend;
+              slot      = &rwb->rhslot[i];
+              bufferend = slot->blockstart + slot->nblocks;
+              if (slot->nblocks > 0 && startblock >= slot->blockstart &&
+                  startblock < bufferend)
+                {
+                  break;
+                }
+            }
 
-              /* How many blocks are available in this buffer? */
+          if (i < CONFIG_DRVR_RHSLOTS)
+            {
+              /* Then read the data from the read-ahead buffer */
 
-              bufferend = rwb->rhblockstart + rwb->rhnblocks;
-              if (startblock >= rwb->rhblockstart && startblock < bufferend)
+              rdblocks = bufferend - startblock;
+              if (rdblocks > remaining)
                 {
-                  size_t rdblocks = bufferend - startblock;
-                  if (rdblocks > remaining)
-                    {
-                      rdblocks = remaining;
-                    }
+                  rdblocks = remaining;
+                }
 
-                  /* Then read the data from the read-ahead buffer */
+              memcpy(rdbuffer, slot->buffer + (startblock - slot->blockstart) *
+                     rwb->blocksize, rdblocks * rwb->blocksize);
 
-                  rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
-                  startblock += rdblocks;
-                  remaining  -= rdblocks;
-                }
+              rdbuffer        += rdblocks * rwb->blocksize;
+              startblock      += rdblocks;
+              remaining       -= rdblocks;
+              slot->nextblock  = startblock;
+              slot->lastuse    = ++rwb->rhclock;
+              continue;
             }
 
-          /* If we did not get all of the data from the buffer, then we have
-           * to refill the buffer and try again.
+          /* We did not get all of the data from the buffer.  Pick the slot
+           * to refill and the amount to read ahead.
            */
 
-          if (remaining > 0)
+          slot = rwb_rhstream(rwb, startblock, remaining, &window);
+          slot->lastuse = ++rwb->rhclock;
+
+          if (remaining >= rwb->rhmaxblocks)
             {
-              ret = rwb_rhreload(rwb, startblock);
-              if (ret < 0)
+              /* The request will not fit in the slot.  Read it directly into
+               * the caller's buffer.  The stream continues at full read-ahead.
+               */
+
+              ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, remaining);
+              if (ret != remaining)
                 {
-                  ferr("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
-                  return (ssize_t)ret;
+                  ret = ret < 0 ? ret : -EIO;
+                  break;
                 }
+
+              startblock      += remaining;
+              slot->nextblock  = startblock;
+              slot->window     = rwb->rhmaxblocks;
+              remaining        = 0;
+              continue;
             }
+
+          ret = rwb_rhreload(rwb, slot, startblock, window);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      rwb_semgive(&rwb->rhsem);
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
+          return (ssize_t)ret;
         }
 
       /* On success, return the number of blocks that we were requested to
@@ -842,11 +1238,10 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
        * driver read method
        */
 
-      rwb_semgive(&rwb->rhsem);
       ret = nblocks;
     }
   else
-#else
+#endif
     {
       /* No read-ahead buffering, (re)load the data directly into
        * the user buffer.
@@ -854,7 +1249,6 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
     }
-#endif
 
   return (ssize_t)ret;
 }
@@ -878,11 +1272,7 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
        */
 
       rwb_semtake(&rwb->rhsem);
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
-        {
-          rwb_resetrhbuffer(rwb);
-        }
-
+      rwb_resetrhbuffer(rwb, startblock, nblocks);
       rwb_semgive(&rwb->rhsem);
     }
 #endif
@@ -892,19 +1282,24 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
     {
       finfo("startblock=%d wrbuffer=%p\n", startblock, wrbuffer);
 
+      rwb_wrcanceltimeout(rwb);
+      rwb_semtake(&rwb->wrsem);
+
       /* Use the block cache unless the buffer size is bigger than block cache */
 
       if (nblocks > rwb->wrmaxblocks)
         {
-          /* First flush the cache */
-
-          rwb_semtake(&rwb->wrsem);
-          rwb_wrflush(rwb);
-          rwb_semgive(&rwb->wrsem);
+          /* First flush any buffered data for the same blocks */
 
-          /* Then transfer the data directly to the media */
+          ret = rwb_wrflushrange(rwb, startblock, nblocks);
+          if (ret >= 0)
+            {
+              /* Then transfer the data directly to the media */
 
-          ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+              rwb_semtake(&rwb->flushsem);
+              ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+              rwb_semgive(&rwb->flushsem);
+            }
         }
       else
         {
@@ -913,6 +1308,9 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
           ret = rwb_writebuffer(rwb, startblock, nblocks, wrbuffer);
         }
 
+      rwb_semgive(&rwb->wrsem);
+      rwb_wrstarttimeout(rwb);
+
       /* On success, return the number of blocks that we were requested to
        * write.  This is for compatibility with the normal return of a block
        * driver write method
@@ -968,11 +1366,26 @@ ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset,
 #ifdef CONFIG_DRVR_REMOVABLE
 int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
 {
+  int i;
+
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
     {
       rwb_semtake(&rwb->wrsem);
-      rwb_resetwrbuffer(rwb);
+      for (i = 0; i < CONFIG_DRVR_WRSLOTS; i++)
+        {
+          if (rwb->wrslot[i].state == RWB_SLOT_FLUSHING)
+            {
+              /* Wait for the worker, then start over */
+
+              rwb_wrwait(rwb);
+              i = -1;
+              continue;
+            }
+
+          rwb_resetwrslot(&rwb->wrslot[i]);
+        }
+
       rwb_semgive(&rwb->wrsem);
     }
 #endif
@@ -981,7 +1394,12 @@ int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
   if (rwb->rhmaxblocks > 0)
     {
       rwb_semtake(&rwb->rhsem);
-      rwb_resetrhbuffer(rwb);
+      for (i = 0; i < CONFIG_DRVR_RHSLOTS; i++)
+        {
+          rwb_resetrhslot(&rwb->rhslot[i]);
+          rwb->rhslot[i].nextblock = (off_t)-1;
+        }
+
       rwb_semgive(&rwb->rhsem);
     }
 #endif
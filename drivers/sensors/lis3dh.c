@@ -51,6 +51,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/sensors/lis3dh.h>
 #include <nuttx/sensors/ioctl.h>
+#include <nuttx/sensors/sensor.h>
 
 #if defined(CONFIG_SPI) && defined(CONFIG_LIS3DH)
 
@@ -58,8 +59,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define LIS3DH_QUEUE_MAX 32
-#define LIS3DH_FIFOBUF_SIZE ((32 * 6) + 1)
+#define LIS3DH_QUEUE_MAX 128
+#define LIS3DH_FIFO_DEPTH 32
+#define LIS3DH_FIFOBUF_SIZE ((LIS3DH_FIFO_DEPTH * 6) + 1)
+
+/* Default FIFO watermark (samples) */
+
+#define LIS3DH_FIFO_FTH 28
 
 /****************************************************************************
  * Private Types
@@ -67,18 +73,15 @@
 
 struct lis3dh_dev_s
 {
+  struct sensor_lowerhalf_s lower;      /* Common sensor upper half (first) */
   FAR struct lis3dh_config_s *config;   /* Driver configuration */
   FAR struct spi_dev_s *spi;            /* Pointer to the SPI instance */
   struct work_s work;                   /* Work Queue */
   uint8_t power_mode;                   /* The power mode used to determine mg/digit */
   uint8_t odr;                          /* The current output data rate */
-  sem_t readsem;                        /* Read notification semaphore */
+  uint8_t fth;                          /* FIFO watermark (samples) */
   uint8_t fifobuf[LIS3DH_FIFOBUF_SIZE]; /* Raw FIFO buffer */
-  struct lis3dh_sensor_data_s queue[LIS3DH_QUEUE_MAX];
-  sem_t queuesem;                       /* Queue exclusive lock */
-  uint8_t queue_rpos;                   /* Queue read position */
-  uint8_t queue_wpos;                   /* Queue write position */
-  uint8_t queue_count;                  /* Number of elements in the queue */
+  struct lis3dh_sensor_data_s samples[LIS3DH_FIFO_DEPTH];
 };
 
 struct lis3dh_sample_s
@@ -105,32 +108,32 @@ static void lis3dh_worker(FAR void *arg);
 static int lis3dh_irq_enable(FAR struct lis3dh_dev_s *dev, bool enable);
 static int lis3dh_fifo_enable(FAR struct lis3dh_dev_s *dev);
 
-static int lis3dh_open(FAR struct file *filep);
-static int lis3dh_close(FAR struct file *filep);
-static ssize_t lis3dh_read(FAR struct file *, FAR char *buffer,
-                           size_t buflen);
-static ssize_t lis3dh_write(FAR struct file *filep, FAR const char *buffer,
-                            size_t buflen);
-static int lis3dh_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+static int lis3dh_activate(FAR struct sensor_lowerhalf_s *lower,
+                           bool enable);
+static int lis3dh_set_watermark(FAR struct sensor_lowerhalf_s *lower,
+                                unsigned int nsamples);
+static int lis3dh_control(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static const struct file_operations g_lis3dh_fops =
+static const struct sensor_ops_s g_lis3dh_ops =
+{
+  lis3dh_activate,      /* activate */
+  lis3dh_set_watermark, /* set_watermark */
+  NULL,                 /* fetch */
+  lis3dh_control        /* control */
+};
+
+/* Sampling period in microseconds for each LIS3DH_ODR_* value.  The last
+ * value is that of the normal and high power modes; see lis3dh_read_fifo().
+ */
+
+static const uint32_t g_lis3dh_interval[] =
 {
-  lis3dh_open,
-  lis3dh_close,
-  lis3dh_read,
-  lis3dh_write,
-  NULL,
-  lis3dh_ioctl
-#ifndef CONFIG_DISABLE_POLL
-  , NULL
-#endif
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , NULL
-#endif
+  0, 1000000, 100000, 40000, 20000, 10000, 5000, 2500, 625, 744
 };
 
 /****************************************************************************
@@ -262,115 +265,12 @@ static int lis3dh_ident(FAR struct lis3dh_dev_s *dev)
   return -ENODEV;
 }
 
-/****************************************************************************
- * Name: lis3dh_queue_lock
- *
- * Description:
- *   Locks exclusive access to the ring buffer queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- ****************************************************************************/
-
-static void lis3dh_queue_lock(FAR struct lis3dh_dev_s *dev)
-{
-  int ret;
-
-  ret = nxsem_wait(&dev->queuesem);
-  if (ret < 0)
-    {
-      snerr("ERROR: queuesem wait error: %d\n", ret);
-      return;
-    }
-}
-
-/****************************************************************************
- * Name: lis3dh_queue_unlock
- *
- * Description:
- *   Unlocks exclusive acccess to the ring buffer queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- ****************************************************************************/
-
-static void lis3dh_queue_unlock(FAR struct lis3dh_dev_s *dev)
-{
-  nxsem_post(&dev->queuesem);
-}
-
-/****************************************************************************
- * Name: lis3dh_queue_push
- *
- * Description:
- *   Push a sensor measurement into the queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- ****************************************************************************/
-
-static int lis3dh_queue_push(FAR struct lis3dh_dev_s *dev,
-                             struct lis3dh_sensor_data_s *data)
-{
-  lis3dh_queue_lock(dev);
-  if (dev->queue_count >= LIS3DH_QUEUE_MAX)
-    {
-      lis3dh_queue_unlock(dev);
-      return -ENOMEM;
-    }
-
-  dev->queue_wpos++;
-  dev->queue[dev->queue_wpos % LIS3DH_QUEUE_MAX] = *data;
-
-  dev->queue_count++;
-  lis3dh_queue_unlock(dev);
-
-  return OK;
-}
-
-/****************************************************************************
- * Name: lis3dh_queue_pop
- *
- * Description:
- *   Pops a sensor measurement from the queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- * Returned Value:
- *   OK if a measurement was successfully dequeued
- *   -EAGAIN if the queue is empty
- *
- ****************************************************************************/
-
-static int lis3dh_queue_pop(FAR struct lis3dh_dev_s *dev,
-                            struct lis3dh_sensor_data_s *data)
-{
-  lis3dh_queue_lock(dev);
-  if (dev->queue_count == 0)
-    {
-      lis3dh_queue_unlock(dev);
-      return -EAGAIN;
-    }
-
-  dev->queue_rpos++;
-  *data = dev->queue[dev->queue_rpos % LIS3DH_QUEUE_MAX];
-
-  dev->queue_count--;
-
-  lis3dh_queue_unlock(dev);
-
-  return OK;
-}
-
 /****************************************************************************
  * Name: lis3dh_read_fifo
  *
  * Description:
- *   Reads the FIFO from the LIS3DH sensor, and pushes to the internal queue.
+ *   Reads the FIFO from the LIS3DH sensor, and pushes the samples to the
+ *   sensor upper half.
  *
  * Input Parameters:
  *   dev - Pointer to device driver instance
@@ -381,10 +281,16 @@ static int lis3dh_queue_pop(FAR struct lis3dh_dev_s *dev,
 
 static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
 {
+  uint64_t timestamp;
+  uint32_t interval;
   uint8_t fifosrc;
   uint8_t count;
   int i;
 
+  /* The newest sample in the FIFO was taken about now */
+
+  timestamp = sensor_timestamp();
+
   /* Lock the SPI bus */
 
   SPI_LOCK(dev->spi, true);
@@ -420,7 +326,7 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
 
   for (i = 0; i < count; i++)
     {
-      struct lis3dh_sensor_data_s data;
+      FAR struct lis3dh_sensor_data_s *data = &dev->samples[i];
       uint16_t x_raw;
       uint16_t y_raw;
       uint16_t z_raw;
@@ -449,9 +355,9 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             y_acc = (int16_t)y_raw >> 8;
             z_acc = (int16_t)z_raw >> 8;
 
-            data.x_acc = (float)x_acc * 0.016;
-            data.y_acc = (float)y_acc * 0.016;
-            data.z_acc = (float)z_acc * 0.016;
+            data->x_acc = (float)x_acc * 0.016;
+            data->y_acc = (float)y_acc * 0.016;
+            data->z_acc = (float)z_acc * 0.016;
             break;
 
           case LIS3DH_POWER_NORMAL:  /* 10 bit measurements */
@@ -459,9 +365,9 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             y_acc = (int16_t)y_raw >> 6;
             z_acc = (int16_t)z_raw >> 6;
 
-            data.x_acc = (float)x_acc * 0.004;
-            data.y_acc = (float)y_acc * 0.004;
-            data.z_acc = (float)z_acc * 0.004;
+            data->x_acc = (float)x_acc * 0.004;
+            data->y_acc = (float)y_acc * 0.004;
+            data->z_acc = (float)z_acc * 0.004;
             break;
 
           case LIS3DH_POWER_HIGH:    /* 12 bit measurements */
@@ -469,9 +375,9 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             y_acc = (int16_t)y_raw >> 4;
             z_acc = (int16_t)z_raw >> 4;
 
-            data.x_acc = (float)x_acc * 0.001;
-            data.y_acc = (float)y_acc * 0.001;
-            data.z_acc = (float)z_acc * 0.001;
+            data->x_acc = (float)x_acc * 0.001;
+            data->y_acc = (float)y_acc * 0.001;
+            data->z_acc = (float)z_acc * 0.001;
             break;
 
           default:
@@ -479,13 +385,17 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             return -EINVAL;
         }
 
-      if (lis3dh_queue_push(dev, &data) == OK)
-        {
-          nxsem_post(&dev->readsem);
-        }
     }
 
-  return OK;
+  /* Hand the whole FIFO to the upper half at once */
+
+  interval = g_lis3dh_interval[dev->odr];
+  if (dev->odr == LIS3DH_ODR_LP_5376HZ && dev->power_mode == LIS3DH_POWER_LOW)
+    {
+      interval = 186;
+    }
+
+  return sensor_push(&dev->lower, dev->samples, count, timestamp, interval);
 }
 
 /****************************************************************************
@@ -532,7 +442,7 @@ static int lis3dh_interrupt_handler(int irq, FAR void *context, FAR void *arg)
  * Description:
  *   Worker callback executed from high priority work queue.
  *   Performs reading the FIFO from the sensor and pushing samples to
- *   the internal device driver queue.
+ *   the sensor upper half.
  *
  * Input Parameters:
  *   arg - Pointer to device driver instance
@@ -545,7 +455,7 @@ static void lis3dh_worker(FAR void *arg)
 
   DEBUGASSERT(priv != NULL);
 
-  /* Read the FIFO and fill the queue */
+  /* Read the FIFO and push the samples to the upper half */
 
   lis3dh_read_fifo(priv);
 }
@@ -704,7 +614,7 @@ static int lis3dh_fifo_enable(FAR struct lis3dh_dev_s *dev)
 {
   uint8_t reg;
   lis3dh_write_register(dev, LIS3DH_FIFO_CTRL_REG,
-                        LIS3DH_FIFO_CTRL_REG_MODE_STREAM | 28);
+                        LIS3DH_FIFO_CTRL_REG_MODE_STREAM | dev->fth);
 
   lis3dh_read_register(dev, LIS3DH_CTRL_REG5, &reg);
   reg |= LIS3DH_CTRL_REG5_FIFO_EN;
@@ -754,30 +664,41 @@ static int lis3dh_enable(FAR struct lis3dh_dev_s *priv)
 }
 
 /****************************************************************************
- * Name: lis3dh_open
+ * Name: lis3dh_activate
  *
  * Description:
- *   Character device open call.
+ *   Start or stop sampling.  Called by the sensor upper half on the first
+ *   open and the last close.
  *
  * Input Parameters:
- *   filep - Pointer to struct file
+ *   lower  - Pointer to the lower half state
+ *   enable - true: start sampling; false: stop sampling
  *
  * Returned Value:
  *   -ENODEV - Device was not identified on the SPI bus.
- *   OK      - Sensor device was opened successfully.
+ *   OK      - Sampling was started or stopped successfully.
  *
  ****************************************************************************/
 
-static int lis3dh_open(FAR struct file *filep)
+static int lis3dh_activate(FAR struct sensor_lowerhalf_s *lower,
+                           bool enable)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
+  FAR struct lis3dh_dev_s *priv = (FAR struct lis3dh_dev_s *)lower;
 
   DEBUGASSERT(priv != NULL);
 
   /* Perform a reset */
 
   lis3dh_reset(priv);
+
+  if (!enable)
+    {
+      /* Detach the interrupt line */
+
+      (priv->config->irq_detach)(priv->config);
+      return OK;
+    }
+
   if (lis3dh_ident(priv) < 0)
     {
       snerr("ERROR: Failed to identify LIS3DH on SPI bus\n");
@@ -804,126 +725,43 @@ static int lis3dh_open(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: lis3dh_close
+ * Name: lis3dh_set_watermark
  *
  * Description:
- *   Character device close call.
+ *   Interrupt when the FIFO holds the number of samples that the reader
+ *   waits for, up to the default watermark.
  *
  * Input Parameters:
- *   filep - Pointer to struct file
+ *   lower    - Pointer to the lower half state
+ *   nsamples - The watermark of the upper half
  *
  * Returned Value:
- *   OK - Sensor device was closed successfully.
+ *   OK - The FIFO watermark was set.
  *
  ****************************************************************************/
 
-static int lis3dh_close(FAR struct file *filep)
+static int lis3dh_set_watermark(FAR struct sensor_lowerhalf_s *lower,
+                                unsigned int nsamples)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
+  FAR struct lis3dh_dev_s *priv = (FAR struct lis3dh_dev_s *)lower;
 
-  DEBUGASSERT(priv != NULL);
-
-  /* Perform a reset */
-
-  lis3dh_reset(priv);
-
-  /* Detach the interrupt line */
-
-  (priv->config->irq_detach)(priv->config);
+  DEBUGASSERT(priv != NULL && nsamples > 0);
 
+  priv->fth = nsamples < LIS3DH_FIFO_FTH ? nsamples : LIS3DH_FIFO_FTH;
+  lis3dh_write_register(priv, LIS3DH_FIFO_CTRL_REG,
+                        LIS3DH_FIFO_CTRL_REG_MODE_STREAM | priv->fth);
   return OK;
 }
 
 /****************************************************************************
- * Name: lis3dh_read
+ * Name: lis3dh_control
  *
  * Description:
- *   Character device read call. Blocks until requested buffer size is full.
+ *   Sets device parameters.  Called by the sensor upper half for the
+ *   commands that it does not handle itself.
  *
  * Input Parameters:
- *   filep - Pointer to struct file
- *   buffer - Pointer to user buffer
- *   buflen - Size of user buffer in bytes
- *
- * Returned Value:
- *   Returns the number of bytes written to the buffer.
- *   -EINVAL - Supplied buffer length invalid
- *
- ****************************************************************************/
-
-static ssize_t lis3dh_read(FAR struct file *filep, FAR char *buffer,
-                            size_t buflen)
-{
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
-  FAR struct lis3dh_sensor_data_s *data;
-  int count;
-  int remain;
-
-  DEBUGASSERT(priv != NULL);
-
-  if ((buflen % sizeof(FAR struct lis3dh_sensor_data_s)) != 0)
-    {
-      snerr("ERROR: Provided buffer must be multiple of sensor data size\n");
-      return -EINVAL;
-    }
-
-  /* Get the number of samples the user has requested */
-
-  count = buflen / sizeof(struct lis3dh_sensor_data_s);
-
-  /* Cast a pointer into the user buffer */
-
-  data = (FAR struct lis3dh_sensor_data_s *)buffer;
-
-  for (remain=count;remain > 0;remain--)
-    {
-
-      /* Wait for data to be available in the queue */
-
-      nxsem_wait(&priv->readsem);
-
-      /* Pop a sample off of the queue */
-
-      lis3dh_queue_pop(priv, data);
-
-      data++;
-    }
-
-  return count * sizeof(struct lis3dh_sensor_data_s);
-}
-
-/****************************************************************************
- * Name: lis3dh_write
- *
- * Description:
- *   Character device write call. Not supported.
- *
- * Input Parameters:
- *   filep  - Pointer to struct file
- *   buffer - Pointer to user buffer
- *   buflen - Size of user buffer in bytes
- *
- * Returned Value:
- *   -ENOSYS
- *
- ****************************************************************************/
-
-static ssize_t lis3dh_write(FAR struct file *filep, FAR const char *buffer,
-                             size_t buflen)
-{
-  return -ENOSYS;
-}
-
-/****************************************************************************
- * Name: lis3dh_ioctl
- *
- * Description:
- *   Character device ioctl call. Sets device parameters.
- *
- * Input Parameters:
- *   filep - Pointer to struct file
+ *   lower - Pointer to the lower half state
  *   cmd   - SNIOC_*
  *   arg   - ioctl specific argument
  *
@@ -933,10 +771,10 @@ static ssize_t lis3dh_write(FAR struct file *filep, FAR const char *buffer,
  *
  ****************************************************************************/
 
-static int lis3dh_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+static int lis3dh_control(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                          unsigned long arg)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
+  FAR struct lis3dh_dev_s *priv = (FAR struct lis3dh_dev_s *)lower;
   int ret = OK;
 
   switch (cmd)
@@ -988,41 +826,33 @@ int lis3dh_register(FAR const char *devpath, FAR struct spi_dev_s *spi,
 
   /* Initialize the LIS3DH device structure */
 
-  priv = (FAR struct lis3dh_dev_s *)kmm_malloc(sizeof(struct lis3dh_dev_s));
+  priv = (FAR struct lis3dh_dev_s *)kmm_zalloc(sizeof(struct lis3dh_dev_s));
   if (priv == NULL)
     {
       snerr("ERROR: Failed to allocate instance\n");
       return -ENOMEM;
     }
 
+  priv->lower.ops = &g_lis3dh_ops;
   priv->config = config;
   priv->spi = spi;
   priv->work.worker = NULL;
-  priv->queue_count = 0;
-
-  /* Initialize queue semaphore */
-
-  nxsem_init(&priv->queuesem, 0, 1);
-
-  /* Initialize read notification semaphore */
-
-  nxsem_init(&priv->readsem, 0, 0);
-  nxsem_setprotocol(&priv->readsem, SEM_PRIO_NONE);
+  priv->fth = LIS3DH_FIFO_FTH;
 
   /* Setup SPI frequency and mode */
 
   SPI_SETFREQUENCY(spi, LIS3DH_SPI_FREQUENCY);
   SPI_SETMODE(spi, LIS3DH_SPI_MODE);
 
-  /* Register the character driver */
+  /* Register the character driver with the common sensor upper half */
 
-  ret = register_driver(devpath, &g_lis3dh_fops, 0666, priv);
+  ret = sensor_register(devpath, &priv->lower,
+                        sizeof(struct lis3dh_sensor_data_s),
+                        LIS3DH_QUEUE_MAX);
   if (ret < 0)
     {
       snerr("ERROR: Failed to register driver: %d\n", ret);
       kmm_free(priv);
-      nxsem_destroy(&priv->queuesem);
-      nxsem_destroy(&priv->readsem);
       return ret;
     }
 
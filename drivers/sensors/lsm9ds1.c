@@ -1242,9 +1242,9 @@ static ssize_t lsm9ds1_read(FAR struct file *filep, FAR char *buffer,
   size_t                    nsamples;
   uint16_t                  data;
   FAR int16_t              *ptr;
-  uint8_t                   regaddr;
-  uint8_t                   lo;
-  uint8_t                   hi;
+  struct i2c_config_s       config;
+  struct i2c_regread_s      regs[6];
+  uint8_t                   raw[6];
   uint32_t                  merge = 0;
 
   /* Sanity check */
@@ -1265,43 +1265,39 @@ static ssize_t lsm9ds1_read(FAR struct file *filep, FAR char *buffer,
   nsamples   = buflen / samplesize;
   ptr        = (FAR int16_t *)buffer;
 
+  /* Read the X, Y and Z low and high bytes in one I2C transfer rather than
+   * in a write and a read transfer per byte.
+   */
+
+  config.frequency = CONFIG_LSM9DS1_I2C_FREQUENCY;
+  config.address   = priv->addr;
+  config.addrlen   = 7;
+
+  for (j = 0; j < 6; j++)
+    {
+      regs[j].regaddr = priv->datareg + j;
+      regs[j].length  = 1;
+      regs[j].buffer  = &raw[j];
+    }
+
   /* Get the requested number of samples */
 
   for (i = 0; i < nsamples; i++)
     {
-      /* Reset the register address to the X low byte register */
-
-      regaddr = priv->datareg;
+      ret = i2c_readregs(priv->i2c, &config, regs, 6);
+      if (ret < 0)
+        {
+          snerr("ERROR: i2c_readregs failed: %d\n", ret);
+          return (ssize_t)ret;
+        }
 
-      /* Read the X, Y and Z data */
+      /* Convert the X, Y and Z data */
 
       for (j = 0; j < 3; j++)
         {
-          /* Read the low byte */
-
-          ret = lsm9ds1_readreg8(priv, regaddr, &lo);
-          if (ret < 0)
-            {
-              snerr("ERROR: lsm9ds1_readreg8 failed: %d\n", ret);
-              return (ssize_t)ret;
-            }
-
-          regaddr++;
-
-          /* Read the high byte */
-
-          ret = lsm9ds1_readreg8(priv, regaddr, &hi);
-          if (ret < 0)
-            {
-              snerr("ERROR: lsm9ds1_readreg8 failed: %d\n", ret);
-              return (ssize_t)ret;
-            }
-
-          regaddr++;
-
           /* The data is 16 bits in two's complement representation */
 
-          data = ((uint16_t)hi << 8) | (uint16_t)lo;
+          data = ((uint16_t)raw[2 * j + 1] << 8) | (uint16_t)raw[2 * j];
 
           /* Collect entropy */
 
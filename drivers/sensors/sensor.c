@@ -0,0 +1,724 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sensors/ioctl.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each slot of the ring holds the timestamp followed by the sample, padded
+ * so that the next timestamp is aligned.
+ */
+
+#define SENSOR_SLOTSIZE(s)  (sizeof(uint64_t) + (((s) + 7) & ~7))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* The lower half */
+  FAR uint8_t *ring;                  /* nsamples slots */
+  size_t samplesize;                  /* Size of one sample (bytes) */
+  size_t slotsize;                    /* Size of one slot (bytes) */
+  unsigned int nsamples;              /* Capacity of the ring (samples) */
+  unsigned int head;                  /* Index of the oldest sample */
+  unsigned int count;                 /* Number of samples buffered */
+  unsigned int watermark;             /* Wake readers at this count */
+  uint32_t overruns;                  /* Samples lost to overwrites */
+  uint8_t crefs;                      /* Number of open references */
+  uint8_t nwaiters;                   /* Number of blocked readers */
+  bool timestamps;                    /* Read the timestamps too */
+  sem_t exclsem;                      /* Mutual exclusion */
+  sem_t readsem;                      /* Wakes up blocked readers */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_SENSORS_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,  /* open */
+  sensor_close, /* close */
+  sensor_read,  /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  sensor_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , sensor_poll /* poll */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_takesem
+ ****************************************************************************/
+
+static inline int sensor_takesem(FAR sem_t *sem)
+{
+  int ret;
+
+  /* Take a count from the semaphore, possibly waiting */
+
+  ret = nxsem_wait(sem);
+
+  /* The only case that an error should occur here is if the wait
+   * was awakened by a signal
+   */
+
+  DEBUGASSERT(ret == OK || ret == -EINTR);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_forcetake
+ *
+ * Description:
+ *   Take a semaphore, ignoring signals.  Used where the lock must be
+ *   retaken before returning.
+ *
+ ****************************************************************************/
+
+static void sensor_forcetake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(sem);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: sensor_notify
+ *
+ * Description:
+ *   Wake up readers and pollers if the watermark is reached.  Called with
+ *   exclsem held.
+ *
+ ****************************************************************************/
+
+static void sensor_notify(FAR struct sensor_upperhalf_s *upper)
+{
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds;
+  int i;
+#endif
+
+  if (upper->count < upper->watermark)
+    {
+      return;
+    }
+
+  for (; upper->nwaiters > 0; upper->nwaiters--)
+    {
+      nxsem_post(&upper->readsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL && (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          nxsem_post(fds->sem);
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: sensor_fetch
+ *
+ * Description:
+ *   Let a lower half without a data-ready interrupt push what it has.
+ *   Called with exclsem held, which sensor_push() needs, so it is released
+ *   around the call.
+ *
+ ****************************************************************************/
+
+static int sensor_fetch(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  nxsem_post(&upper->exclsem);
+  ret = lower->ops->fetch(lower);
+
+  sensor_forcetake(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_open
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->crefs == UINT8_MAX)
+    {
+      ret = -EMFILE;
+    }
+  else if (upper->crefs == 0)
+    {
+      /* First open: start sampling into an empty ring */
+
+      upper->head     = 0;
+      upper->count    = 0;
+      upper->overruns = 0;
+
+      ret = lower->ops->activate(lower, true);
+    }
+
+  if (ret >= 0)
+    {
+      upper->crefs++;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(upper->crefs > 0);
+  if (--upper->crefs == 0)
+    {
+      ret = lower->ops->activate(lower, false);
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Wait until the watermark is reached, then return as many whole samples
+ *   as are buffered and fit in the user buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR const uint8_t *slot;
+  size_t rsize;
+  ssize_t nread = 0;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  rsize = upper->samplesize + (upper->timestamps ? sizeof(uint64_t) : 0);
+  if (buflen < rsize)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Polled sensors are asked for samples; the others are waited for */
+
+  if (upper->count < upper->watermark && lower->ops->fetch != NULL)
+    {
+      ret = sensor_fetch(upper);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  while (upper->count == 0 ||
+         (upper->count < upper->watermark && lower->ops->fetch == NULL))
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0 || lower->ops->fetch != NULL)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      upper->nwaiters++;
+      nxsem_post(&upper->exclsem);
+
+      ret = sensor_takesem(&upper->readsem);
+      if (ret < 0)
+        {
+          /* Remove ourselves from the waiter count */
+
+          sensor_forcetake(&upper->exclsem);
+          if (upper->nwaiters > 0)
+            {
+              upper->nwaiters--;
+            }
+
+          goto errout;
+        }
+
+      ret = sensor_takesem(&upper->exclsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Copy out the oldest samples */
+
+  while (upper->count > 0 && buflen - nread >= rsize)
+    {
+      slot = upper->ring + upper->head * upper->slotsize;
+      if (upper->timestamps)
+        {
+          memcpy(buffer + nread, slot, rsize);
+        }
+      else
+        {
+          memcpy(buffer + nread, slot + sizeof(uint64_t), rsize);
+        }
+
+      nread += rsize;
+      if (++upper->head >= upper->nsamples)
+        {
+          upper->head = 0;
+        }
+
+      upper->count--;
+    }
+
+  ret = nread;
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case SNIOC_SET_WATERMARK:
+        if (arg < 1 || arg > upper->nsamples)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        if (lower->ops->set_watermark != NULL)
+          {
+            ret = lower->ops->set_watermark(lower, (unsigned int)arg);
+          }
+
+        if (ret >= 0)
+          {
+            upper->watermark = (unsigned int)arg;
+            sensor_notify(upper);
+          }
+        break;
+
+      case SNIOC_SET_TIMESTAMPS:
+        upper->timestamps = (bool)arg;
+        break;
+
+      case SNIOC_GET_OVERRUNS:
+        {
+          FAR uint32_t *overruns = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (overruns == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          *overruns       = upper->overruns;
+          upper->overruns = 0;
+        }
+        break;
+
+      case SNIOC_FLUSH:
+        upper->head  = 0;
+        upper->count = 0;
+        break;
+
+      default:
+        if (lower->ops->control != NULL)
+          {
+            ret = lower->ops->control(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct pollfd **slot;
+  int ret;
+  int i;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_NPOLLWAITERS)
+        {
+          snerr("ERROR: Too many poll waiters\n");
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      if (upper->count < upper->watermark && lower->ops->fetch != NULL)
+        {
+          (void)sensor_fetch(upper);
+        }
+
+      sensor_notify(upper);
+    }
+  else if (fds->priv != NULL)
+    {
+      /* Remove all memory of the poll setup */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor character driver with the common upper half.
+ *
+ * Input Parameters:
+ *   path       - The full path to the driver, e.g. "/dev/accel0"
+ *   lower      - The lower half state
+ *   samplesize - The size in bytes of one sample as read by the user
+ *   nsamples   - The number of samples buffered
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *path,
+                    FAR struct sensor_lowerhalf_s *lower,
+                    size_t samplesize, unsigned int nsamples)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  int ret;
+
+  DEBUGASSERT(path != NULL && lower != NULL && lower->ops != NULL &&
+              lower->ops->activate != NULL);
+
+  if (samplesize == 0 || nsamples == 0)
+    {
+      return -EINVAL;
+    }
+
+  upper = (FAR struct sensor_upperhalf_s *)
+    kmm_zalloc(sizeof(struct sensor_upperhalf_s));
+  if (upper == NULL)
+    {
+      snerr("ERROR: Failed to allocate the upper half\n");
+      return -ENOMEM;
+    }
+
+  upper->slotsize = SENSOR_SLOTSIZE(samplesize);
+  upper->ring     = (FAR uint8_t *)kmm_malloc(nsamples * upper->slotsize);
+  if (upper->ring == NULL)
+    {
+      snerr("ERROR: Failed to allocate the sample ring\n");
+      kmm_free(upper);
+      return -ENOMEM;
+    }
+
+  upper->lower      = lower;
+  upper->samplesize = samplesize;
+  upper->nsamples   = nsamples;
+  upper->watermark  = 1;
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->readsem, 0, 0);
+
+  /* The read semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&upper->readsem, SEM_PRIO_NONE);
+
+  lower->upper = upper;
+
+  ret = register_driver(path, &g_sensor_fops, 0444, upper);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to register driver: %d\n", ret);
+      nxsem_destroy(&upper->exclsem);
+      nxsem_destroy(&upper->readsem);
+      kmm_free(upper->ring);
+      kmm_free(upper);
+      lower->upper = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Add samples to the ring and wake up readers if the watermark is
+ *   reached.
+ *
+ * Input Parameters:
+ *   lower     - The lower half state
+ *   samples   - 'nsamples' consecutive samples of 'samplesize' bytes
+ *   nsamples  - The number of samples
+ *   timestamp - The time of the newest sample
+ *   interval  - The sampling period in microseconds
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_push(FAR struct sensor_lowerhalf_s *lower,
+                FAR const void *samples, unsigned int nsamples,
+                uint64_t timestamp, uint32_t interval)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  FAR const uint8_t *src = (FAR const uint8_t *)samples;
+  FAR uint8_t *slot;
+  uint64_t ts;
+  unsigned int tail;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->upper != NULL);
+  upper = (FAR struct sensor_upperhalf_s *)lower->upper;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ts = timestamp - (uint64_t)(nsamples - 1) * interval;
+  for (i = 0; i < nsamples; i++, src += upper->samplesize, ts += interval)
+    {
+      /* Overwrite the oldest sample if the ring is full */
+
+      if (upper->count >= upper->nsamples)
+        {
+          if (++upper->head >= upper->nsamples)
+            {
+              upper->head = 0;
+            }
+
+          upper->count--;
+          upper->overruns++;
+        }
+
+      tail = upper->head + upper->count;
+      if (tail >= upper->nsamples)
+        {
+          tail -= upper->nsamples;
+        }
+
+      slot = upper->ring + tail * upper->slotsize;
+      memcpy(slot, &ts, sizeof(uint64_t));
+      memcpy(slot + sizeof(uint64_t), src, upper->samplesize);
+      upper->count++;
+    }
+
+  sensor_notify(upper);
+  nxsem_post(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds since boot.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+#endif /* CONFIG_SENSORS_UPPERHALF */
@@ -108,9 +108,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* Should never be set... only for comparison to serial.c */
+/* Output post-processing is performed in a staging buffer of this size so
+ * that the sink pipe is written in blocks rather than one byte at a time.
+ */
 
-#undef CONFIG_PSEUDOTERM_FULLBLOCKS
+#define PTY_XLATSIZE 64
 
 /****************************************************************************
  * Private Types
@@ -442,9 +444,8 @@ static ssize_t pty_read(FAR struct file *filep, FAR char *buffer, size_t len)
   ssize_t ntotal;
 #ifdef CONFIG_SERIAL_TERMIOS
   ssize_t nread;
-  size_t i;
+  ssize_t i;
   char ch;
-  int ret;
 #endif
 
   DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
@@ -466,130 +467,59 @@ static ssize_t pty_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   if (dev->pd_iflag & (INLCR | IGNCR | ICRNL))
     {
-      /* We will transfer one byte at a time, making the appropriate
-       * translations.
+      /* Read whatever is available in the source pipe directly into the
+       * user buffer, then make the appropriate translations in place.  The
+       * pipe read returns early if the pipe becomes empty after some bytes
+       * were read so this never blocks once data has been received.
+       *
+       * REVISIT: Should not block if the oflags include O_NONBLOCK.
+       * How would we ripple the O_NONBLOCK characteristic to the
+       * contained source pipe?  file_vfcntl()?  Or FIONREAD? See the
+       * TODO comment at the top of this file.
        */
 
-      ntotal = 0;
-      for (i = 0; i < len; i++)
+      do
         {
-#ifndef CONFIG_PSEUDOTERM_FULLBLOCKS
-          /* This logic should return if the pipe becomes empty after some
-           * bytes were read from the pipe.  If we have already read some
-           * data, we use the FIONREAD ioctl to test if there are more bytes
-           * in the pipe.
-           *
-           * REVISIT:  An alternative design might be to (1) configure the
-           * source file as non-blocking, then (2) wait using poll() for the
-           * first byte to be received.  (3) Subsequent bytes would
-           * use file_read() without polling and would (4) terminate when no
-           * data is returned.
-           */
-
-          if (ntotal > 0)
+          nread = file_read(&dev->pd_src, buffer, len);
+          if (nread <= 0)
             {
-              int nsrc;
-
-              /* There are inherent race conditions in this test.  We lock
-               * the scheduler before the test and after the file_read()
-               * below to eliminate one race:  (a) We detect that there is
-               * data in the source file, (b) we are suspended and another
-               * thread reads the data, emptying the fifo, then (c) we
-               * resume and call file_read(), blocking indefinitely.
-               */
+              /* Error or end of file */
 
-              sched_lock();
+              ntotal = nread;
+              break;
+            }
+
+          for (i = 0, ntotal = 0; i < nread; i++)
+            {
+              ch = buffer[i];
 
-              /* Check how many bytes are waiting in the pipe */
+              /* Perform input processing */
+              /* \n -> \r or \r -> \n translation? */
 
-              ret = file_ioctl(&dev->pd_src, FIONREAD,
-                               (unsigned long)((uintptr_t)&nsrc));
-              if (ret < 0)
+              if (ch == '\n' && (dev->pd_iflag & INLCR) != 0)
                 {
-                  sched_unlock();
-                  ntotal = ret;
-                  break;
+                  ch = '\r';
                 }
-
-              /* Break out of the loop and return ntotal if the pipe is
-               * empty.  This is another race:  There fifo was empty when we
-               * called file_ioctl() above, but it might not be empty right
-               * now.  Losing that race should not lead to any bad behaviors,
-               * however, we the caller will get those bytes on the next
-               * read.
-               */
-
-              if (nsrc < 1)
+              else if (ch == '\r' && (dev->pd_iflag & ICRNL) != 0)
                 {
-                  sched_unlock();
-                  break;
+                  ch = '\n';
                 }
 
-              /* Read one byte from the source the byte.  This should not
-               * block.
-               */
-
-              nread = file_read(&dev->pd_src, &ch, 1);
-              sched_unlock();
-            }
-          else
-#else
-          /* If we wanted to return full blocks of data, then file_read()
-           * may need to be called repeatedly.  That is because the pipe
-           * read() method will return early if the fifo becomes empty
-           * after any data has been read.
-           */
-
-# error Missing logic
-#endif
-            {
-              /* Read one byte from the source the byte.  This call will
-               * block if the source pipe is empty.
-               *
-               * REVISIT: Should not block if the oflags include O_NONBLOCK.
-               * How would we ripple the O_NONBLOCK characteristic to the
-               * contained soruce pipe?  file_vfcntl()?  Or FIONREAD? See the
-               * TODO comment at the top of this file.
+              /* Discarding \r ?  Keep the character if (1) character is not
+               * \r or if (2) we were not asked to ignore \r.
                */
 
-              nread = file_read(&dev->pd_src, &ch, 1);
-            }
-
-          /* Check if file_read was successful */
-
-          if (nread < 0)
-            {
-              ntotal = nread;
-              break;
-            }
-
-          /* Perform input processing */
-          /* \n -> \r or \r -> \n translation? */
-
-          if (ch == '\n' && (dev->pd_iflag & INLCR) != 0)
-            {
-               ch = '\r';
-            }
-          else if (ch == '\r' && (dev->pd_iflag & ICRNL) != 0)
-            {
-              ch = '\n';
+              if (ch != '\r' || (dev->pd_iflag & IGNCR) == 0)
+                {
+                  buffer[ntotal++] = ch;
+                }
             }
 
-          /* Discarding \r ?  Print character if (1) character is not \r or
-           * if (2) we were not asked to ignore \r.
+          /* If every byte was discarded, then wait for more data rather
+           * than report the end of file.
            */
-
-          if (ch != '\r' || (dev->pd_iflag & IGNCR) == 0)
-            {
-
-              /* Transfer the (possibly translated) character and update the
-               * count of bytes transferred.
-               */
-
-              *buffer++ = ch;
-              ntotal++;
-            }
         }
+      while (ntotal == 0);
     }
   else
 #endif
@@ -621,7 +551,9 @@ static ssize_t pty_write(FAR struct file *filep, FAR const char *buffer, size_t
   FAR struct pty_dev_s *dev;
   ssize_t ntotal;
 #ifdef CONFIG_SERIAL_TERMIOS
+  char xlat[PTY_XLATSIZE];
   ssize_t nwritten;
+  size_t nxlat;
   size_t i;
   char ch;
 #endif
@@ -636,8 +568,8 @@ static ssize_t pty_write(FAR struct file *filep, FAR const char *buffer, size_t
 
   if ((dev->pd_oflag & OPOST) != 0)
     {
-      /* We will transfer one byte at a time, making the appropriae
-       * translations.  Specifically not handled:
+      /* Translate into a staging buffer that is written to the sink pipe
+       * whenever it fills.  Specifically not handled:
        *
        *   OXTABS - primarily a full-screen terminal optimisation
        *   ONOEOT - Unix interoperability hack
@@ -646,6 +578,8 @@ static ssize_t pty_write(FAR struct file *filep, FAR const char *buffer, size_t
        */
 
       ntotal = 0;
+      nxlat  = 0;
+
       for (i = 0; i < len; i++)
         {
           ch = *buffer++;
@@ -661,48 +595,35 @@ static ssize_t pty_write(FAR struct file *filep, FAR const char *buffer, size_t
 
           if ((ch == '\n') && (dev->pd_oflag & (ONLCR | ONLRET)) != 0)
             {
-              char cr = '\r';
-
-              /* Transfer the carriage return.  This will block if the
-               * sink pipe is full.
-               *
-               * REVISIT: Should not block if the oflags include O_NONBLOCK.
-               * How would we ripple the O_NONBLOCK characteristic to the
-               * contained sink pipe?  file_vfcntl()?  Or FIONSPACE?  See the
-               * TODO comment at the top of this file.
-               */
-
-              nwritten = file_write(&dev->pd_sink, &cr, 1);
-              if (nwritten < 0)
-                {
-                  ntotal = nwritten;
-                  break;
-                }
-
-              /* Update the count of bytes transferred */
-
-              ntotal++;
+              xlat[nxlat++] = '\r';
             }
 
-          /* Transfer the (possibly translated) character..  This will block
-           * if the sink pipe is full
+          xlat[nxlat++] = ch;
+
+          /* Write the staging buffer if it could not hold another CR-LF
+           * sequence or if this was the last character.  This will block
+           * if the sink pipe is full.
            *
            * REVISIT: Should not block if the oflags include O_NONBLOCK.
            * How would we ripple the O_NONBLOCK characteristic to the
-           * contained sink pipe?  file_vfcntl()?  Or FIONSPACe?  See the
+           * contained sink pipe?  file_vfcntl()?  Or FIONSPACE?  See the
            * TODO comment at the top of this file.
            */
 
-          nwritten = file_write(&dev->pd_sink, &ch, 1);
-          if (nwritten < 0)
+          if (nxlat > PTY_XLATSIZE - 2 || i + 1 >= len)
             {
-              ntotal = nwritten;
-              break;
-            }
+              nwritten = file_write(&dev->pd_sink, xlat, nxlat);
+              if (nwritten < 0)
+                {
+                  ntotal = nwritten;
+                  break;
+                }
 
-          /* Update the count of bytes transferred */
+              /* Update the count of bytes transferred */
 
-          ntotal++;
+              ntotal += nwritten;
+              nxlat   = 0;
+            }
         }
     }
   else
@@ -51,6 +51,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/sched.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
@@ -581,6 +582,10 @@ static int uart_open(FAR struct file *filep)
 
 #ifdef CONFIG_SERIAL_TERMIOS
       dev->tc_iflag = 0;
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+      dev->tc_vmin  = 1;
+      dev->tc_vtime = 0;
+#endif
       if (dev->isconsole)
         {
           /* Enable \n -> \r\n translation for the console */
@@ -704,7 +709,17 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
   irqstate_t flags;
   ssize_t recvd = 0;
   int16_t tail;
+#ifdef CONFIG_SERIAL_TERMIOS
   char ch;
+#endif
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+  size_t vmin;
+  uint32_t vtime;
+#endif
+#ifdef CONFIG_SERIAL_ICOUNT
+  systime_t start = 0;
+  systime_t waited;
+#endif
   int ret;
 
   /* Only one user can access rxbuf->tail at a time */
@@ -720,6 +735,16 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
       return ret;
     }
 
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+  /* Get the non-canonical read parameters.  read() returns once VMIN bytes
+   * (or the full user buffer) have been received.  If VTIME is non-zero, it
+   * also returns when no new data arrives for VTIME deciseconds.
+   */
+
+  vmin  = dev->tc_vmin < buflen ? dev->tc_vmin : buflen;
+  vtime = MSEC2TICK((uint32_t)dev->tc_vtime * 100);
+#endif
+
   /* Loop while we still have data to copy to the receive buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -755,7 +780,43 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        */
 
       tail = rxbuf->tail;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+      if (rxbuf->head != tail &&
+          (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0)
+#else
       if (rxbuf->head != tail)
+#endif
+        {
+          int16_t head = rxbuf->head;
+          size_t nbytes;
+
+          /* No input processing:  Copy the contiguous run of data from the
+           * tail of the buffer up to the head (or the end of the buffer)
+           * straight into the user buffer.
+           */
+
+          nbytes = (head > tail ? head : rxbuf->size) - tail;
+          if (nbytes > buflen - recvd)
+            {
+              nbytes = buflen - recvd;
+            }
+
+          memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+          buffer += nbytes;
+          recvd  += nbytes;
+
+          tail += nbytes;
+          if (tail >= rxbuf->size)
+            {
+              tail = 0;
+            }
+
+          rxbuf->tail = tail;
+        }
+
+#ifdef CONFIG_SERIAL_TERMIOS
+      else if (rxbuf->head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
@@ -773,28 +834,22 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
           rxbuf->tail = tail;
 
-#ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+          /* Do input processing:  \n -> \r or \r -> \n translation? */
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+          if ((ch == '\n') && (dev->tc_iflag & INLCR))
             {
-              /* \n -> \r or \r -> \n translation? */
-
-              if ((ch == '\n') && (dev->tc_iflag & INLCR))
-                {
-                  ch = '\r';
-                }
-              else if ((ch == '\r') && (dev->tc_iflag & ICRNL))
-                {
-                  ch = '\n';
-                }
+              ch = '\r';
+            }
+          else if ((ch == '\r') && (dev->tc_iflag & ICRNL))
+            {
+              ch = '\n';
+            }
 
-              /* Discarding \r ? */
+          /* Discarding \r ? */
 
-              if ((ch == '\r') & (dev->tc_iflag & IGNCR))
-                {
-                  continue;
-                }
+          if ((ch == '\r') & (dev->tc_iflag & IGNCR))
+            {
+              continue;
             }
 
           /* Specifically not handled:
@@ -805,13 +860,13 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
            * IUCLC - Not Posix
            * IXON/OXOFF - no xon/xoff flow control.
            */
-#endif
 
           /* Store the received character */
 
           *buffer++ = ch;
           recvd++;
         }
+#endif
 
 #ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
       /* No... then we would have to wait to get receive more data.
@@ -837,7 +892,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        * to the caller?
        */
 
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+      else if ((size_t)recvd >= vmin && (recvd > 0 || vtime == 0))
+#else
       else if (recvd > 0)
+#endif
        {
           /* Yes.. break out of the loop and return the number of bytes
            * received up to the wait condition.
@@ -853,9 +912,15 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
       else if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
-          /* Break out of the loop returning -EAGAIN */
+          /* Break out of the loop returning -EAGAIN if nothing was
+           * received.
+           */
+
+          if (recvd < 1)
+            {
+              recvd = -EAGAIN;
+            }
 
-          recvd = -EAGAIN;
           break;
         }
 #endif
@@ -883,9 +948,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
               flags = enter_critical_section();
 
 #ifdef CONFIG_SERIAL_DMA
-              /* If RX buffer is empty move tail and head to zero position */
+              /* If RX buffer is empty move tail and head to zero position.
+               * Not possible if a circular DMA owns the head index.
+               */
 
-              if (rxbuf->head == rxbuf->tail)
+              if (!dev->rxdmaring && rxbuf->head == rxbuf->tail)
                 {
                   rxbuf->head = rxbuf->tail = 0;
                 }
@@ -916,11 +983,54 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                    */
 
                   dev->recvwaiting = true;
-                  ret = uart_takesem(&dev->recvsem, true);
+#ifdef CONFIG_SERIAL_ICOUNT
+                  dev->icount.rdwaits++;
+                  if (start == 0)
+                    {
+                      start = clock_systimer();
+                    }
+#endif
+
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+                  if (vtime > 0 && (recvd > 0 || vmin == 0))
+                    {
+                      /* Wait for data with the VTIME timer running.  If
+                       * VMIN is zero, VTIME is an overall timeout that
+                       * starts at once.  Otherwise, it is an inter-byte
+                       * timeout that only starts after the first byte has
+                       * been received.
+                       */
+
+                      ret = nxsem_tickwait(&dev->recvsem, clock_systimer(),
+                                           vtime);
+                      if (ret == -ETIMEDOUT)
+                        {
+                          /* No one will post recvsem now */
+
+                          dev->recvwaiting = false;
+                        }
+                    }
+                  else
+#endif
+                    {
+                      ret = uart_takesem(&dev->recvsem, true);
+                    }
                 }
 
               leave_critical_section(flags);
 
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+              if (ret == -ETIMEDOUT)
+                {
+                  /* VTIME expired.  Return what we have, possibly nothing. */
+
+#ifdef CONFIG_SERIAL_ICOUNT
+                  dev->icount.rdtimeouts++;
+#endif
+                  break;
+                }
+#endif
+
               /* Was a signal received while waiting for data to be
                * received?  Was a removable device disconnected while
                * we were waiting?
@@ -971,7 +1081,7 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
   /* If RX buffer is empty move tail and head to zero position */
 
-  if (rxbuf->head == rxbuf->tail)
+  if (!dev->rxdmaring && rxbuf->head == rxbuf->tail)
     {
       rxbuf->head = rxbuf->tail = 0;
     }
@@ -1024,6 +1134,28 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
 #endif
 
+#ifdef CONFIG_SERIAL_ICOUNT
+  /* Update the read statistics */
+
+  flags = enter_critical_section();
+  if (recvd > 0)
+    {
+      dev->icount.rdcalls++;
+      dev->icount.rdbytes += recvd;
+    }
+
+  if (start != 0)
+    {
+      waited = clock_systimer() - start;
+      if (TICK2USEC(waited) > (systime_t)dev->icount.rdlatency)
+        {
+          dev->icount.rdlatency = (int)TICK2USEC(waited);
+        }
+    }
+
+  leave_critical_section(flags);
+#endif
+
   uart_givesem(&dev->recv.sem);
   return recvd;
 }
@@ -1242,6 +1374,29 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       switch (cmd)
         {
+#ifdef CONFIG_SERIAL_ICOUNT
+          /* Get the interrupt and error counts */
+
+          case TIOCGICOUNT:
+            {
+              FAR struct serial_icounter_struct *icount =
+                (FAR struct serial_icounter_struct *)((uintptr_t)arg);
+              irqstate_t flags;
+
+              if (icount == NULL)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              flags = enter_critical_section();
+              memcpy(icount, &dev->icount, sizeof(struct serial_icounter_struct));
+              leave_critical_section(flags);
+              ret = OK;
+            }
+            break;
+#endif
+
           /* Get the number of bytes that may be read from the RX buffer
            * (without waiting)
            */
@@ -1373,6 +1528,10 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               termiosp->c_iflag = dev->tc_iflag;
               termiosp->c_oflag = dev->tc_oflag;
               termiosp->c_lflag = dev->tc_lflag;
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+              termiosp->c_cc[VMIN]  = dev->tc_vmin;
+              termiosp->c_cc[VTIME] = dev->tc_vtime;
+#endif
             }
             break;
 
@@ -1391,6 +1550,10 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               dev->tc_iflag = termiosp->c_iflag;
               dev->tc_oflag = termiosp->c_oflag;
               dev->tc_lflag = termiosp->c_lflag;
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+              dev->tc_vmin  = termiosp->c_cc[VMIN];
+              dev->tc_vtime = termiosp->c_cc[VTIME];
+#endif
             }
             break;
         }
@@ -111,6 +111,9 @@ void uart_xmitchars_done(FAR uart_dev_t *dev)
   xfer->nbytes = 0;
   xfer->length = xfer->nlength = 0;
 
+  uart_icount(dev, txint, 1);
+  uart_icount(dev, tx, nbytes);
+
   /* If any bytes were removed from the buffer, inform any waiters there there is
    * space available.
    */
@@ -257,6 +260,9 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
   xfer->nbytes = 0;
   xfer->length = xfer->nlength = 0;
 
+  uart_icount(dev, rxint, 1);
+  uart_icount(dev, rx, nbytes);
+
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
    */
@@ -267,4 +273,61 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
     }
 }
 
+/************************************************************************************
+ * Name: uart_recvchars_ring
+ *
+ * Description:
+ *   Called from the lower half DMA half/full transfer interrupt or the UART
+ *   idle-line/receive timeout interrupt when the RX DMA runs in circular mode
+ *   over the RX buffer.  'head' is the buffer index where the DMA will write the
+ *   next byte.  The DMA owns the buffer; the read() logic only moves the tail.
+ *
+ ************************************************************************************/
+
+void uart_recvchars_ring(FAR uart_dev_t *dev, unsigned int head)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  unsigned int nbuffered;
+  unsigned int nbytes;
+
+  uart_icount(dev, rxint, 1);
+
+  /* How many bytes were buffered before and how many has the DMA added? */
+
+  nbuffered = (rxbuf->head + rxbuf->size - rxbuf->tail) % rxbuf->size;
+  nbytes    = (head + rxbuf->size - rxbuf->head) % rxbuf->size;
+
+  if (nbytes == 0)
+    {
+      return;
+    }
+
+  /* If the DMA wrapped over unread data, the oldest bytes are lost.  Keep the
+   * most recent size - 1 bytes.
+   */
+
+  if (nbuffered + nbytes >= rxbuf->size)
+    {
+      uart_icount(dev, buf_overrun, nbuffered + nbytes - rxbuf->size + 1);
+      rxbuf->tail = (head + 1) % rxbuf->size;
+    }
+
+  rxbuf->head = head;
+  uart_icount(dev, rx, nbytes);
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  /* Let the lower half know if the upper watermark has been crossed */
+
+  nbuffered = (rxbuf->head + rxbuf->size - rxbuf->tail) % rxbuf->size;
+  if (nbuffered >= (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK * rxbuf->size) / 100)
+    {
+      (void)uart_rxflowcontrol(dev, nbuffered, true);
+    }
+#endif
+
+  /* Inform any waiters there is new incoming data available */
+
+  uart_datareceived(dev);
+}
+
 #endif /* CONFIG_SERIAL_DMA */
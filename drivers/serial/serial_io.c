@@ -96,6 +96,9 @@ void uart_xmitchars(FAR uart_dev_t *dev)
       uart_disabletxint(dev);
     }
 
+  uart_icount(dev, txint, 1);
+  uart_icount(dev, tx, nbytes);
+
   /* If any bytes were removed from the buffer, inform any waiters there there is
    * space available.
    */
@@ -219,8 +222,15 @@ void uart_recvchars(FAR uart_dev_t *dev)
                nexthead = 0;
             }
         }
+      else
+        {
+          uart_icount(dev, buf_overrun, 1);
+        }
     }
 
+  uart_icount(dev, rxint, 1);
+  uart_icount(dev, rx, nbytes);
+
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
    */
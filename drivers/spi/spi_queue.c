@@ -0,0 +1,397 @@
+/****************************************************************************
+ * drivers/spi/spi_queue.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The transaction queue of one SPI bus */
+
+struct spi_queue_s
+{
+  FAR struct spi_dev_s *spi;          /* The lower half */
+  sem_t waitsem;                      /* Counts submitted requests */
+  sq_queue_t pending[SPI_NPRIORITIES]; /* Requests not yet started */
+  pid_t pid;                          /* The queue thread */
+};
+
+/* A request submitted by spi_queue_transfer() */
+
+struct spi_waiter_s
+{
+  struct spi_request_s req;           /* Must be first */
+  sem_t donesem;                      /* Posted on completion */
+  int result;                         /* Result of the transaction */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_dequeue
+ *
+ * Description:
+ *   Remove the first request of the highest non-empty priority class.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_request_s *spi_dequeue(FAR struct spi_queue_s *queue)
+{
+  FAR struct spi_request_s *req = NULL;
+  irqstate_t flags;
+  int prio;
+
+  flags = enter_critical_section();
+  for (prio = 0; prio < SPI_NPRIORITIES; prio++)
+    {
+      req = (FAR struct spi_request_s *)sq_remfirst(&queue->pending[prio]);
+      if (req != NULL)
+        {
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return req;
+}
+
+/****************************************************************************
+ * Name: spi_queue_thread
+ *
+ * Description:
+ *   Perform the queued transactions of one bus, one at a time.
+ *
+ ****************************************************************************/
+
+static int spi_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct spi_queue_s *queue;
+  FAR struct spi_request_s *req;
+  int ret;
+
+  DEBUGASSERT(argc > 1);
+  queue = (FAR struct spi_queue_s *)(uintptr_t)strtoul(argv[1], NULL, 16);
+
+  for (; ; )
+    {
+      ret = nxsem_wait(&queue->waitsem);
+      if (ret < 0)
+        {
+          DEBUGASSERT(ret == -EINTR);
+          continue;
+        }
+
+      /* The request may have been cancelled since it was counted */
+
+      req = spi_dequeue(queue);
+      if (req == NULL)
+        {
+          continue;
+        }
+
+      /* Let the lower half perform the whole transaction if it can (e.g.
+       * with one DMA descriptor per transfer); otherwise exchange the
+       * transfers one at a time.
+       */
+
+      ret = SPI_TRANSFER(queue->spi, req->seq);
+      if (ret == -ENOSYS)
+        {
+          ret = spi_transfer(queue->spi, req->seq);
+        }
+
+      if (ret < 0)
+        {
+          spierr("ERROR: Transaction failed: %d\n", ret);
+        }
+
+      if (req->callback != NULL)
+        {
+          req->callback(req, ret);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_waiter_done
+ *
+ * Description:
+ *   Completion callback of spi_queue_transfer().
+ *
+ ****************************************************************************/
+
+static void spi_waiter_done(FAR struct spi_request_s *req, int result)
+{
+  FAR struct spi_waiter_s *waiter = (FAR struct spi_waiter_s *)req;
+
+  waiter->result = result;
+  nxsem_post(&waiter->donesem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Create the transaction queue of one SPI bus and start the kernel thread
+ *   that performs the queued transactions.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_queue_s *queue;
+  FAR char *argv[2];
+  char arg1[16];
+  int prio;
+
+  DEBUGASSERT(spi != NULL);
+
+  queue = (FAR struct spi_queue_s *)kmm_zalloc(sizeof(struct spi_queue_s));
+  if (queue == NULL)
+    {
+      spierr("ERROR: Failed to allocate the queue\n");
+      return NULL;
+    }
+
+  queue->spi = spi;
+  for (prio = 0; prio < SPI_NPRIORITIES; prio++)
+    {
+      sq_init(&queue->pending[prio]);
+    }
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&queue->waitsem, 0, 0);
+  nxsem_setprotocol(&queue->waitsem, SEM_PRIO_NONE);
+
+  snprintf(arg1, sizeof(arg1), "%lx", (unsigned long)((uintptr_t)queue));
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  queue->pid = kthread_create("spiqueue", CONFIG_SPI_QUEUE_PRIORITY,
+                              CONFIG_SPI_QUEUE_STACKSIZE,
+                              (main_t)spi_queue_thread,
+                              (FAR char * const *)argv);
+  if (queue->pid < 0)
+    {
+      spierr("ERROR: Failed to start the queue thread: %d\n", queue->pid);
+      nxsem_destroy(&queue->waitsem);
+      kmm_free(queue);
+      return NULL;
+    }
+
+  return queue;
+}
+
+/****************************************************************************
+ * Name: spi_submit
+ *
+ * Description:
+ *   Queue a transaction and return immediately.  May be called from
+ *   interrupt handlers.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - The request to queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the request is invalid.
+ *
+ ****************************************************************************/
+
+int spi_submit(FAR struct spi_queue_s *queue, FAR struct spi_request_s *req)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  if (req->seq == NULL || req->seq->trans == NULL ||
+      req->priority >= SPI_NPRIORITIES)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  sq_addlast(&req->node, &queue->pending[req->priority]);
+  leave_critical_section(flags);
+
+  return nxsem_post(&queue->waitsem);
+}
+
+/****************************************************************************
+ * Name: spi_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - The request passed to spi_submit()
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it has already been
+ *   started (or was never queued).
+ *
+ ****************************************************************************/
+
+int spi_cancel(FAR struct spi_queue_s *queue, FAR struct spi_request_s *req)
+{
+  FAR sq_queue_t *list;
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  DEBUGASSERT(queue != NULL && req != NULL &&
+              req->priority < SPI_NPRIORITIES);
+
+  /* The count in waitsem is left as it is; the queue thread ignores the
+   * extra wake-up.
+   */
+
+  list  = &queue->pending[req->priority];
+  flags = enter_critical_section();
+
+  for (node = sq_peek(list); node != NULL; node = sq_next(node))
+    {
+      if (node == &req->node)
+        {
+          sq_rem(node, list);
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spi_queue_transfer
+ *
+ * Description:
+ *   Perform a sequence of transfers through the queue and wait for it to
+ *   complete.
+ *
+ * Input Parameters:
+ *   queue    - The queue returned by spi_queue_initialize()
+ *   seq      - Describes the sequence of transfers
+ *   priority - See enum spi_priority_e
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_transfer(FAR struct spi_queue_s *queue,
+                       FAR struct spi_sequence_s *seq, int priority)
+{
+  struct spi_waiter_s waiter;
+  int ret;
+
+  DEBUGASSERT(queue != NULL && seq != NULL);
+
+  /* Performing the transaction directly would be faster, but would let a
+   * low priority caller overtake queued high priority transactions.
+   */
+
+  waiter.req.seq      = seq;
+  waiter.req.priority = priority;
+  waiter.req.callback = spi_waiter_done;
+  waiter.req.arg      = NULL;
+  waiter.result       = OK;
+
+  nxsem_init(&waiter.donesem, 0, 0);
+  nxsem_setprotocol(&waiter.donesem, SEM_PRIO_NONE);
+
+  ret = spi_submit(queue, &waiter.req);
+  if (ret >= 0)
+    {
+      /* The request cannot be abandoned once queued, so wait through any
+       * signals.
+       */
+
+      do
+        {
+          ret = nxsem_wait(&waiter.donesem);
+        }
+      while (ret == -EINTR);
+
+      ret = waiter.result;
+    }
+
+  nxsem_destroy(&waiter.donesem);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_QUEUE */
@@ -0,0 +1,610 @@
+/****************************************************************************
+ * drivers/syslog/note_ctf.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/signal.h>
+#include <nuttx/sched_note.h>
+
+#ifdef CONFIG_DRIVER_NOTE_CTF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CTF_MAGIC              0xc1fc1fc1
+
+/* Sizes of the encoded packet header + packet context and of the largest
+ * event.
+ */
+
+#define CTF_PKTHDR_SIZE        29
+#define CTF_EVHDR_SIZE         9
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_DUMP) && \
+    CONFIG_SCHED_NOTE_STRING_SIZE > CONFIG_TASK_NAME_SIZE + 1
+#  define CTF_MAXSTRING        CONFIG_SCHED_NOTE_STRING_SIZE
+#else
+#  define CTF_MAXSTRING        (CONFIG_TASK_NAME_SIZE + 1)
+#endif
+
+#define CTF_MAXEVENT           (CTF_EVHDR_SIZE + CTF_MAXSTRING + 9)
+
+/* Offsets of the packet context fields */
+
+#define CTF_TSBEGIN_OFFSET     8
+#define CTF_TSEND_OFFSET       12
+#define CTF_CONTENT_OFFSET     16
+#define CTF_PKTSIZE_OFFSET     20
+#define CTF_DISCARDED_OFFSET   24
+#define CTF_CPUID_OFFSET       28
+
+#if CONFIG_DRIVER_NOTE_CTF_PACKETSIZE < CTF_PKTHDR_SIZE + CTF_MAXEVENT
+#  error CONFIG_DRIVER_NOTE_CTF_PACKETSIZE is too small
+#endif
+
+/* The largest raw note */
+
+#define CTF_MAXNOTE            (sizeof(struct note_common_s) + \
+                                CTF_MAXSTRING + 16)
+
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The CTF metadata.  Event IDs are the note types of enum note_type_e, the
+ * clock is the system timer.  All integers are byte aligned little endian.
+ * The clock frequency is filled in by ctf_metadata().
+ */
+
+static const char g_ctf_metafmt[] =
+  "/* CTF 1.8 */\n"
+  "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+  "typealias integer { size = 16; align = 8; signed = false; } := uint16_t;\n"
+  "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+  "typealias integer { size = 64; align = 8; signed = false; } := uint64_t;\n"
+  "trace {\n"
+  "  major = 1; minor = 8; byte_order = le;\n"
+  "  packet.header := struct { uint32_t magic; uint32_t stream_id; };\n"
+  "};\n"
+  "env { sysname = \"NuttX\"; };\n"
+  "clock { name = systimer; freq = %lu; };\n"
+  "typealias integer { size = 32; align = 8; signed = false;\n"
+  "  map = clock.systimer.value; } := tick_t;\n"
+  "stream {\n"
+  "  id = 0;\n"
+  "  packet.context := struct {\n"
+  "    tick_t timestamp_begin; tick_t timestamp_end;\n"
+  "    uint32_t content_size; uint32_t packet_size;\n"
+  "    uint32_t events_discarded; uint8_t cpu_id; };\n"
+  "  event.header := struct { uint8_t id; tick_t timestamp; };\n"
+  "  event.context := struct {\n"
+  "    uint16_t pid; uint8_t priority; uint8_t cpu; };\n"
+  "};\n"
+  "event { name = \"sched_start\"; id = 0; stream_id = 0;\n"
+  "  fields := struct { string name; }; };\n"
+  "event { name = \"sched_stop\"; id = 1; stream_id = 0;\n"
+  "  fields := struct { uint8_t unused; }; };\n"
+  "event { name = \"sched_suspend\"; id = 2; stream_id = 0;\n"
+  "  fields := struct { uint8_t state; }; };\n"
+  "event { name = \"sched_resume\"; id = 3; stream_id = 0;\n"
+  "  fields := struct { uint8_t unused; }; };\n"
+  "event { name = \"cpu_start\"; id = 4; stream_id = 0;\n"
+  "  fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_started\"; id = 5; stream_id = 0;\n"
+  "  fields := struct { uint8_t unused; }; };\n"
+  "event { name = \"cpu_pause\"; id = 6; stream_id = 0;\n"
+  "  fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_paused\"; id = 7; stream_id = 0;\n"
+  "  fields := struct { uint8_t unused; }; };\n"
+  "event { name = \"cpu_resume\"; id = 8; stream_id = 0;\n"
+  "  fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_resumed\"; id = 9; stream_id = 0;\n"
+  "  fields := struct { uint8_t unused; }; };\n"
+  "event { name = \"preempt_lock\"; id = 10; stream_id = 0;\n"
+  "  fields := struct { uint16_t count; }; };\n"
+  "event { name = \"preempt_unlock\"; id = 11; stream_id = 0;\n"
+  "  fields := struct { uint16_t count; }; };\n"
+  "event { name = \"csection_enter\"; id = 12; stream_id = 0;\n"
+  "  fields := struct { uint16_t count; }; };\n"
+  "event { name = \"csection_leave\"; id = 13; stream_id = 0;\n"
+  "  fields := struct { uint16_t count; }; };\n"
+  "event { name = \"spin_lock\"; id = 14; stream_id = 0;\n"
+  "  fields := struct { uint64_t lock; uint8_t value; }; };\n"
+  "event { name = \"spin_locked\"; id = 15; stream_id = 0;\n"
+  "  fields := struct { uint64_t lock; uint8_t value; }; };\n"
+  "event { name = \"spin_unlock\"; id = 16; stream_id = 0;\n"
+  "  fields := struct { uint64_t lock; uint8_t value; }; };\n"
+  "event { name = \"spin_abort\"; id = 17; stream_id = 0;\n"
+  "  fields := struct { uint64_t lock; uint8_t value; }; };\n"
+  "event { name = \"trace_printf\"; id = 18; stream_id = 0;\n"
+  "  fields := struct { string msg; }; };\n"
+  "event { name = \"trace_begin\"; id = 19; stream_id = 0;\n"
+  "  fields := struct { string name; }; };\n"
+  "event { name = \"trace_end\"; id = 20; stream_id = 0;\n"
+  "  fields := struct { string name; }; };\n";
+
+static char g_ctf_metadata[sizeof(g_ctf_metafmt) + 8];
+static FAR const struct note_ctf_channel_s *g_ctf_channel;
+static uint8_t g_ctf_packet[CONFIG_DRIVER_NOTE_CTF_PACKETSIZE];
+static size_t g_ctf_len;
+static bool g_ctf_started;
+
+/* State of note_ctf_file() */
+
+static char g_ctf_dirpath[64];
+static int g_ctf_mdfd = -1;
+static int g_ctf_fd = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ctf_put8/16/32/64
+ *
+ * Description:
+ *   Encode little endian integers.  Returns the pointer past the integer.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *ctf_put8(FAR uint8_t *ptr, uint8_t value)
+{
+  *ptr++ = value;
+  return ptr;
+}
+
+static FAR uint8_t *ctf_put16(FAR uint8_t *ptr, uint16_t value)
+{
+  *ptr++ = (uint8_t)(value & 0xff);
+  *ptr++ = (uint8_t)(value >> 8);
+  return ptr;
+}
+
+static FAR uint8_t *ctf_put32(FAR uint8_t *ptr, uint32_t value)
+{
+  ptr = ctf_put16(ptr, (uint16_t)(value & 0xffff));
+  return ctf_put16(ptr, (uint16_t)(value >> 16));
+}
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+static FAR uint8_t *ctf_put64(FAR uint8_t *ptr, uint64_t value)
+{
+  ptr = ctf_put32(ptr, (uint32_t)(value & 0xffffffff));
+  return ctf_put32(ptr, (uint32_t)(value >> 32));
+}
+#endif
+
+/****************************************************************************
+ * Name: ctf_metadata
+ *
+ * Description:
+ *   Format the metadata text once and return its length.
+ *
+ ****************************************************************************/
+
+static size_t ctf_metadata(void)
+{
+  if (g_ctf_metadata[0] == '\0')
+    {
+      (void)snprintf(g_ctf_metadata, sizeof(g_ctf_metadata), g_ctf_metafmt,
+                     (unsigned long)TICK_PER_SEC);
+    }
+
+  return strlen(g_ctf_metadata);
+}
+
+/****************************************************************************
+ * Name: ctf_flush
+ *
+ * Description:
+ *   Complete the packet context of the current packet and pass the packet
+ *   to the channel.  Packets are written with only their content (the
+ *   packet size equals the content size).
+ *
+ ****************************************************************************/
+
+static void ctf_flush(uint32_t tsend)
+{
+  uint32_t nbits;
+
+  if (g_ctf_len <= CTF_PKTHDR_SIZE)
+    {
+      return;
+    }
+
+  nbits = (uint32_t)g_ctf_len * 8;
+
+  (void)ctf_put32(&g_ctf_packet[CTF_TSEND_OFFSET], tsend);
+  (void)ctf_put32(&g_ctf_packet[CTF_CONTENT_OFFSET], nbits);
+  (void)ctf_put32(&g_ctf_packet[CTF_PKTSIZE_OFFSET], nbits);
+  (void)ctf_put32(&g_ctf_packet[CTF_DISCARDED_OFFSET], sched_note_dropped());
+
+  (void)g_ctf_channel->nc_stream(g_ctf_packet, g_ctf_len);
+  g_ctf_len = 0;
+}
+
+/****************************************************************************
+ * Name: ctf_encode
+ *
+ * Description:
+ *   Encode one raw note into the current packet.  Returns the timestamp of
+ *   the note.
+ *
+ ****************************************************************************/
+
+static uint32_t ctf_encode(FAR const uint8_t *buffer, size_t buflen)
+{
+  FAR const struct note_common_s *note =
+    (FAR const struct note_common_s *)buffer;
+  FAR const uint8_t *payload = buffer + sizeof(struct note_common_s);
+  FAR uint8_t *ptr;
+  uint32_t systime;
+  size_t namelen;
+  uint8_t cpu = 0;
+
+#ifdef CONFIG_SMP
+  cpu = note->nc_cpu;
+#endif
+
+  systime = (uint32_t)note->nc_systime[0] |
+            (uint32_t)note->nc_systime[1] << 8 |
+            (uint32_t)note->nc_systime[2] << 16 |
+            (uint32_t)note->nc_systime[3] << 24;
+
+  /* Start a new packet if this event might not fit */
+
+  if (g_ctf_len + CTF_MAXEVENT > CONFIG_DRIVER_NOTE_CTF_PACKETSIZE)
+    {
+      ctf_flush(systime);
+    }
+
+  if (g_ctf_len == 0)
+    {
+      ptr = ctf_put32(g_ctf_packet, CTF_MAGIC);
+      ptr = ctf_put32(ptr, 0);        /* stream_id */
+      ptr = ctf_put32(ptr, systime);  /* timestamp_begin */
+      ptr = ctf_put32(ptr, systime);  /* timestamp_end (updated on flush) */
+      ptr = ctf_put32(ptr, 0);        /* content_size (updated on flush) */
+      ptr = ctf_put32(ptr, 0);        /* packet_size (updated on flush) */
+      ptr = ctf_put32(ptr, 0);        /* events_discarded (updated on flush) */
+      ptr = ctf_put8(ptr, cpu);       /* cpu_id */
+      g_ctf_len = ptr - g_ctf_packet;
+    }
+
+  /* Event header and context */
+
+  ptr = &g_ctf_packet[g_ctf_len];
+  ptr = ctf_put8(ptr, note->nc_type);
+  ptr = ctf_put32(ptr, systime);
+  ptr = ctf_put16(ptr, (uint16_t)note->nc_pid[0] |
+                       (uint16_t)note->nc_pid[1] << 8);
+  ptr = ctf_put8(ptr, note->nc_priority);
+  ptr = ctf_put8(ptr, cpu);
+
+  /* Event fields */
+
+  switch (note->nc_type)
+    {
+      case NOTE_START:
+        {
+          namelen = 0;
+#if CONFIG_TASK_NAME_SIZE > 0
+          namelen = strnlen((FAR const char *)payload,
+                            buflen - sizeof(struct note_common_s));
+          if (namelen > CONFIG_TASK_NAME_SIZE)
+            {
+              namelen = CONFIG_TASK_NAME_SIZE;
+            }
+
+          memcpy(ptr, payload, namelen);
+#endif
+          ptr += namelen;
+          *ptr++ = '\0';
+        }
+        break;
+
+      case NOTE_SUSPEND:
+        ptr = ctf_put8(ptr, payload[0]);
+        break;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+      case NOTE_DUMP_STRING:
+      case NOTE_DUMP_BEGIN:
+      case NOTE_DUMP_END:
+        {
+          namelen = strnlen((FAR const char *)payload,
+                            buflen - sizeof(struct note_common_s));
+          if (namelen > CTF_MAXSTRING - 1)
+            {
+              namelen = CTF_MAXSTRING - 1;
+            }
+
+          memcpy(ptr, payload, namelen);
+          ptr += namelen;
+          *ptr++ = '\0';
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SMP
+      case NOTE_CPU_START:
+      case NOTE_CPU_PAUSE:
+      case NOTE_CPU_RESUME:
+        ptr = ctf_put8(ptr, payload[0]);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+      case NOTE_PREEMPT_LOCK:
+      case NOTE_PREEMPT_UNLOCK:
+        ptr = ctf_put16(ptr, (uint16_t)payload[0] |
+                             (uint16_t)payload[1] << 8);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+      case NOTE_SPINLOCK_LOCK:
+      case NOTE_SPINLOCK_LOCKED:
+      case NOTE_SPINLOCK_UNLOCK:
+      case NOTE_SPINLOCK_ABORT:
+        {
+          FAR const struct note_spinlock_s *spin =
+            (FAR const struct note_spinlock_s *)buffer;
+
+          ptr = ctf_put64(ptr, (uint64_t)(uintptr_t)spin->nsp_spinlock);
+          ptr = ctf_put8(ptr, spin->nsp_value);
+        }
+        break;
+#endif
+
+      default:
+        /* Events without fields carry one unused byte */
+
+        ptr = ctf_put8(ptr, 0);
+        break;
+    }
+
+  g_ctf_len = ptr - g_ctf_packet;
+  return systime;
+}
+
+/****************************************************************************
+ * Name: ctf_filewrite and ctf_filemetadata
+ *
+ * Description:
+ *   The channel methods used by note_ctf_file()
+ *
+ ****************************************************************************/
+
+static ssize_t ctf_filewrite(FAR const uint8_t *buffer, size_t buflen)
+{
+  return write(g_ctf_fd, buffer, buflen);
+}
+
+static ssize_t ctf_filemetadata(FAR const uint8_t *buffer, size_t buflen)
+{
+  ssize_t ret = write(g_ctf_mdfd, buffer, buflen);
+
+  close(g_ctf_mdfd);
+  g_ctf_mdfd = -1;
+  return ret;
+}
+
+static const struct note_ctf_channel_s g_ctf_filechannel =
+{
+  ctf_filemetadata,
+  ctf_filewrite
+};
+
+/****************************************************************************
+ * Name: ctf_openfiles
+ *
+ * Description:
+ *   Open the files of note_ctf_file().  This is done by the drainer thread
+ *   so that the file descriptors belong to it.
+ *
+ ****************************************************************************/
+
+static int ctf_openfiles(void)
+{
+  char path[sizeof(g_ctf_dirpath) + 10];
+
+  snprintf(path, sizeof(path), "%s/metadata", g_ctf_dirpath);
+  g_ctf_mdfd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (g_ctf_mdfd < 0)
+    {
+      return -get_errno();
+    }
+
+  snprintf(path, sizeof(path), "%s/stream", g_ctf_dirpath);
+  g_ctf_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (g_ctf_fd < 0)
+    {
+      close(g_ctf_mdfd);
+      g_ctf_mdfd = -1;
+      return -get_errno();
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ctf_drainer
+ *
+ * Description:
+ *   The low priority thread that drains the note buffer into the channel.
+ *
+ ****************************************************************************/
+
+static int ctf_drainer(int argc, FAR char *argv[])
+{
+  uint8_t note[CTF_MAXNOTE];
+  ssize_t notelen;
+  uint32_t last = 0;
+  int ret;
+
+  if (g_ctf_channel == &g_ctf_filechannel)
+    {
+      ret = ctf_openfiles();
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to open the trace files: %d\n", ret);
+          return EXIT_FAILURE;
+        }
+    }
+
+  if (g_ctf_channel->nc_metadata != NULL)
+    {
+      size_t len = ctf_metadata();
+      (void)g_ctf_channel->nc_metadata((FAR const uint8_t *)g_ctf_metadata,
+                                       len);
+    }
+
+  for (; ; )
+    {
+      /* Encode all of the notes that are buffered now */
+
+      while ((notelen = sched_note_get(note, sizeof(note))) != 0)
+        {
+          if (notelen > 0)
+            {
+              last = ctf_encode(note, notelen);
+            }
+        }
+
+      /* Then pass the partial packet on so that the trace is current */
+
+      ctf_flush(last);
+      (void)nxsig_usleep(1000 * CONFIG_DRIVER_NOTE_CTF_PERIOD);
+    }
+
+  return EXIT_SUCCESS; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: note_ctf_metadata
+ *
+ * Description:
+ *   Return the CTF metadata (TSDL) text that describes the event stream.
+ *
+ ****************************************************************************/
+
+FAR const char *note_ctf_metadata(void)
+{
+  (void)ctf_metadata();
+  return g_ctf_metadata;
+}
+
+/****************************************************************************
+ * Name: note_ctf_channel
+ *
+ * Description:
+ *   Start streaming the notes in Common Trace Format to 'channel'.
+ *
+ ****************************************************************************/
+
+int note_ctf_channel(FAR const struct note_ctf_channel_s *channel)
+{
+  int ret;
+
+  DEBUGASSERT(channel != NULL && channel->nc_stream != NULL);
+
+  if (g_ctf_started)
+    {
+      return -EBUSY;
+    }
+
+  g_ctf_channel = channel;
+  g_ctf_len     = 0;
+
+  ret = kthread_create("notectf", CONFIG_DRIVER_NOTE_CTF_PRIORITY,
+                       CONFIG_DRIVER_NOTE_CTF_STACKSIZE,
+                       (main_t)ctf_drainer, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_ctf_started = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: note_ctf_file
+ *
+ * Description:
+ *   Stream the notes in CTF to the files 'metadata' and 'stream' in the
+ *   directory 'dirpath'.
+ *
+ ****************************************************************************/
+
+int note_ctf_file(FAR const char *dirpath)
+{
+  DEBUGASSERT(dirpath != NULL);
+
+  if (strlen(dirpath) >= sizeof(g_ctf_dirpath))
+    {
+      return -ENAMETOOLONG;
+    }
+
+  strncpy(g_ctf_dirpath, dirpath, sizeof(g_ctf_dirpath));
+  return note_ctf_channel(&g_ctf_filechannel);
+}
+
+#endif /* CONFIG_DRIVER_NOTE_CTF */
@@ -56,6 +56,8 @@
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/syslog/ramlog.h>
 
@@ -63,6 +65,18 @@
 
 #ifdef CONFIG_RAMLOG
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Delay used to coalesce reader wakeups.  Zero: wake readers on every
+ * write.
+ */
+
+#ifndef CONFIG_RAMLOG_WAKEUP_DELAY
+#  define CONFIG_RAMLOG_WAKEUP_DELAY 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -89,6 +103,18 @@ struct ramlog_dev_s
 #ifndef CONFIG_DISABLE_POLL
   FAR struct pollfd *rl_fds[CONFIG_RAMLOG_NPOLLWAITERS];
 #endif
+
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  /* The total number of bytes ever added.  Each reader keeps its own
+   * position in this sequence in the f_pos field of its 'struct file'.
+   */
+
+  volatile uint32_t rl_seq;
+#endif
+
+#if CONFIG_RAMLOG_WAKEUP_DELAY > 0
+  struct work_s     rl_work;         /* Deferred (coalesced) reader wakeup */
+#endif
 };
 
 /****************************************************************************
@@ -98,6 +124,9 @@ struct ramlog_dev_s
 /* Syslog channel methods */
 
 #ifdef CONFIG_RAMLOG_SYSLOG
+#ifdef CONFIG_SYSLOG_WRITE
+static ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen);
+#endif
 static int ramlog_flush(void);
 #endif
 
@@ -107,7 +136,12 @@ static int ramlog_flush(void);
 static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                               pollevent_t eventset);
 #endif
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+static size_t  ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                             FAR const char *buffer, size_t len);
+static size_t  ramlog_addstr(FAR struct ramlog_dev_s *priv,
+                             FAR const char *buffer, size_t len);
+static void    ramlog_wakeup(FAR struct ramlog_dev_s *priv);
+static void    ramlog_notify(FAR struct ramlog_dev_s *priv);
 
 /* Character driver methods */
 
@@ -128,7 +162,7 @@ static int     ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds,
 static const struct syslog_channel_s g_ramlog_syslog_channel =
 {
 #ifdef CONFIG_SYSLOG_WRITE
-  syslog_default_write,
+  ramlog_syslog_write,
 #endif
   ramlog_putc,
   ramlog_putc,
@@ -199,6 +233,28 @@ static int ramlog_flush(void)
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syslog_write
+ *
+ * Description:
+ *   The SYSLOG channel's block write method.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_SYSLOG) && defined(CONFIG_SYSLOG_WRITE)
+static ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct ramlog_dev_s *priv = &g_sysdev;
+
+  if (ramlog_addstr(priv, buffer, buflen) > 0)
+    {
+      ramlog_notify(priv);
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: ramlog_pollnotify
  ****************************************************************************/
@@ -233,48 +289,369 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 #endif
 
 /****************************************************************************
- * Name: ramlog_addchar
+ * Name: ramlog_addbuf
+ *
+ * Description:
+ *   Copy a block of characters into the circular buffer with interrupts
+ *   disabled once for the whole block.  Returns the number of characters
+ *   taken from 'buffer'.
+ *
  ****************************************************************************/
 
-static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
+static size_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                            FAR const char *buffer, size_t len)
 {
   irqstate_t flags;
-  size_t nexthead;
+  size_t nret = len;
+  size_t space;
+  size_t ncopy;
+  size_t head;
 
   /* Disable interrupts (in case we are NOT called from interrupt handler) */
 
   flags = enter_critical_section();
 
-  /* Calculate the write index AFTER the next byte is written */
+  head  = priv->rl_head;
+  space = (priv->rl_tail + priv->rl_bufsize - head - 1) % priv->rl_bufsize;
 
-  nexthead = priv->rl_head + 1;
-  if (nexthead >= priv->rl_bufsize)
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  /* Readers never hold data back:  Keep only the newest data and discard
+   * the oldest data to make room for it.
+   */
+
+  if (len > priv->rl_bufsize - 1)
     {
-      nexthead = 0;
+      buffer += len - (priv->rl_bufsize - 1);
+      len     = priv->rl_bufsize - 1;
     }
 
-  /* Would the next write overflow the circular buffer? */
+  if (len > space)
+    {
+      priv->rl_tail = (priv->rl_tail + len - space) % priv->rl_bufsize;
+    }
+#else
+  /* When the buffer is full, the remaining data is dropped on the floor */
 
-  if (nexthead == priv->rl_tail)
+  if (len > space)
     {
-      /* Yes... Return an indication that nothing was saved in the buffer. */
+      len  = space;
+      nret = space;
+    }
+#endif
 
-      leave_critical_section(flags);
-      return -EBUSY;
+  /* Copy the data in (at most) two pieces */
+
+  ncopy = priv->rl_bufsize - head;
+  if (ncopy > len)
+    {
+      ncopy = len;
     }
 
-  /* No... copy the byte and re-enable interrupts */
+  memcpy(&priv->rl_buffer[head], buffer, ncopy);
+  memcpy(priv->rl_buffer, &buffer[ncopy], len - ncopy);
+
+  priv->rl_head = (head + len) % priv->rl_bufsize;
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  priv->rl_seq += len;
+#endif
 
-  priv->rl_buffer[priv->rl_head] = ch;
-  priv->rl_head = nexthead;
   leave_critical_section(flags);
-  return OK;
+  return nret;
+}
+
+/****************************************************************************
+ * Name: ramlog_addstr
+ *
+ * Description:
+ *   Add a string to the circular buffer, handling CONFIG_RAMLOG_CRLF.  The
+ *   runs of characters between line ends are added as blocks.  Returns the
+ *   number of characters taken from 'buffer'.
+ *
+ ****************************************************************************/
+
+static size_t ramlog_addstr(FAR struct ramlog_dev_s *priv,
+                            FAR const char *buffer, size_t len)
+{
+#ifdef CONFIG_RAMLOG_CRLF
+  size_t nwritten = 0;
+  size_t run;
+
+  while (nwritten < len)
+    {
+      /* Find the run of characters up to the next line end */
+
+      for (run = 0;
+           nwritten + run < len && buffer[nwritten + run] != '\r' &&
+           buffer[nwritten + run] != '\n';
+           run++);
+
+      if (run > 0)
+        {
+          if (ramlog_addbuf(priv, &buffer[nwritten], run) < run)
+            {
+              /* The buffer is full and the rest was dropped */
+
+              return nwritten;
+            }
+
+          nwritten += run;
+          continue;
+        }
+
+      /* Ignore carriage returns.  Pre-pend a carriage return before a
+       * linefeed.
+       */
+
+      if (buffer[nwritten] == '\n' && ramlog_addbuf(priv, "\r\n", 2) < 2)
+        {
+          return nwritten;
+        }
+
+      nwritten++;
+    }
+
+  return nwritten;
+#else
+  return ramlog_addbuf(priv, buffer, len);
+#endif
+}
+
+/****************************************************************************
+ * Name: ramlog_wakeup
+ *
+ * Description:
+ *   Wake up all readers waiting for data and notify poll waiters.
+ *
+ ****************************************************************************/
+
+static void ramlog_wakeup(FAR struct ramlog_dev_s *priv)
+{
+#if !defined(CONFIG_RAMLOG_NONBLOCKING) || !defined(CONFIG_DISABLE_POLL)
+  irqstate_t flags;
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  int i;
+#endif
+
+  /* Are there threads waiting for read data? */
+
+  flags = enter_critical_section();
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  for (i = 0; i < priv->rl_nwaiters; i++)
+    {
+      /* Yes.. Notify all of the waiting readers that more data is available */
+
+      nxsem_post(&priv->rl_waitsem);
+    }
+#endif
+
+  /* Notify all poll/select waiters that they can read from the FIFO */
+
+  ramlog_pollnotify(priv, POLLIN);
+  leave_critical_section(flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: ramlog_wakeup_worker
+ ****************************************************************************/
+
+#if CONFIG_RAMLOG_WAKEUP_DELAY > 0
+static void ramlog_wakeup_worker(FAR void *arg)
+{
+  ramlog_wakeup((FAR struct ramlog_dev_s *)arg);
+}
+#endif
+
+/****************************************************************************
+ * Name: ramlog_notify
+ *
+ * Description:
+ *   Called after data has been added.  With CONFIG_RAMLOG_WAKEUP_DELAY,
+ *   the wakeup is deferred to the low priority work queue and all writes
+ *   during the delay share one wakeup.  This may be called from an
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+static void ramlog_notify(FAR struct ramlog_dev_s *priv)
+{
+#if CONFIG_RAMLOG_WAKEUP_DELAY > 0
+  bool waiters = false;
+#ifndef CONFIG_DISABLE_POLL
+  int i;
+#endif
+
+  /* Nothing to do unless someone is waiting.  This also keeps early boot
+   * output from touching the work queue before it is started.
+   */
+
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  waiters = priv->rl_nwaiters > 0;
+#endif
+#ifndef CONFIG_DISABLE_POLL
+  for (i = 0; i < CONFIG_RAMLOG_NPOLLWAITERS && !waiters; i++)
+    {
+      waiters = priv->rl_fds[i] != NULL;
+    }
+#endif
+
+  if (waiters && work_available(&priv->rl_work))
+    {
+      (void)work_queue(LPWORK, &priv->rl_work, ramlog_wakeup_worker, priv,
+                       MSEC2TICK(CONFIG_RAMLOG_WAKEUP_DELAY));
+    }
+#else
+  ramlog_wakeup(priv);
+#endif
 }
 
 /****************************************************************************
  * Name: ramlog_read
+ *
+ * Description:
+ *   CONFIG_RAMLOG_MULTIREADER version.  Reading does not remove data from
+ *   the buffer.  Each open file reads from its own position (f_pos) in the
+ *   sequence of bytes ever written; a reader whose data has been
+ *   overwritten continues with the oldest data still in the buffer.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_RAMLOG_MULTIREADER
+static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct ramlog_dev_s *priv;
+  irqstate_t flags;
+  uint32_t pos = (uint32_t)filep->f_pos;
+  uint32_t seq;
+  ssize_t nread = 0;
+  size_t used;
+  size_t avail;
+  size_t ncopy;
+  size_t first;
+  size_t ndx;
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  int ret;
+#endif
+
+  /* Some sanity checking */
+
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct ramlog_dev_s *)inode->i_private;
+
+  /* This function may NOT be called from an interrupt handler. */
+
+  DEBUGASSERT(!up_interrupt_context());
+
+  while ((size_t)nread < len)
+    {
+      /* Get a consistent snapshot of the buffer state */
+
+      flags = enter_critical_section();
+      seq   = priv->rl_seq;
+      ndx   = priv->rl_head;
+      used  = (ndx + priv->rl_bufsize - priv->rl_tail) % priv->rl_bufsize;
+      leave_critical_section(flags);
+
+      /* Skip over data that has been overwritten.  This also places a newly
+       * opened reader at the oldest data.
+       */
+
+      if (seq - pos > used)
+        {
+          pos = seq - used;
+        }
+
+      avail = seq - pos;
+      if (avail == 0)
+        {
+#ifdef CONFIG_RAMLOG_NONBLOCKING
+          /* Return what we have (with zero mean the end-of-file) */
+
+          break;
+#else
+          /* Return what we have or -EAGAIN if the driver was opened with
+           * O_NONBLOCK.
+           */
+
+          if (nread > 0)
+            {
+              break;
+            }
+
+          if (filep->f_oflags & O_NONBLOCK)
+            {
+              nread = -EAGAIN;
+              break;
+            }
+
+          /* Otherwise, wait for something to be written */
+
+          sched_lock();
+          priv->rl_nwaiters++;
+
+          ret = OK;
+          if (priv->rl_seq == seq)
+            {
+              ret = nxsem_wait(&priv->rl_waitsem);
+            }
+
+          priv->rl_nwaiters--;
+          sched_unlock();
+
+          if (ret < 0)
+            {
+              nread = ret;
+              break;
+            }
+
+          continue;
+#endif
+        }
+
+      /* Copy the data in (at most) two pieces without holding off the
+       * writers.
+       */
+
+      ncopy = len - nread;
+      if (ncopy > avail)
+        {
+          ncopy = avail;
+        }
+
+      ndx   = (ndx + priv->rl_bufsize - avail) % priv->rl_bufsize;
+      first = priv->rl_bufsize - ndx;
+      if (first > ncopy)
+        {
+          first = ncopy;
+        }
+
+      memcpy(&buffer[nread], &priv->rl_buffer[ndx], first);
+      memcpy(&buffer[nread + first], priv->rl_buffer, ncopy - first);
+
+      /* If the writers overwrote the data while it was being copied, then
+       * discard the copy and try again with the oldest data.
+       */
+
+      flags = enter_critical_section();
+      seq   = priv->rl_seq;
+      used  = (priv->rl_head + priv->rl_bufsize - priv->rl_tail) %
+              priv->rl_bufsize;
+      leave_critical_section(flags);
+
+      if (seq - pos > used)
+        {
+          continue;
+        }
+
+      pos   += ncopy;
+      nread += ncopy;
+    }
+
+  filep->f_pos = (off_t)pos;
+  return nread;
+}
+#else
 static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
   FAR struct inode *inode = filep->f_inode;
@@ -440,6 +817,7 @@ errout_without_sem:
 
   return nread;
 }
+#endif /* CONFIG_RAMLOG_MULTIREADER */
 
 /****************************************************************************
  * Name: ramlog_write
@@ -449,97 +827,25 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
-  ssize_t nwritten;
-  char ch;
-  int ret;
 
   /* Some sanity checking */
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct ramlog_dev_s *)inode->i_private;
 
-  /* Loop until all of the bytes have been written.  This function may be
-   * called from an interrupt handler!  Semaphores cannot be used!
+  /* Add all of the bytes.  This function may be called from an interrupt
+   * handler!  Semaphores cannot be used!
    *
    * The write logic only needs to modify the rl_head index.  Therefore,
    * there is a difference in the way that rl_head and rl_tail are protected:
-   * rl_tail is protected with a semaphore; rl_tail is protected by disabling
-   * interrupts.
+   * rl_tail is protected with a semaphore; rl_head is protected by disabling
+   * interrupts.  Data that does not fit is dropped on the floor.
    */
 
-  for (nwritten = 0; (size_t)nwritten < len; nwritten++)
-    {
-      /* Get the next character to output */
-
-      ch = buffer[nwritten];
-
-      /* Ignore carriage returns */
-
-#ifdef CONFIG_RAMLOG_CRLF
-      if (ch == '\r')
-        {
-          continue;
-        }
-
-      /* Pre-pend a carriage before a linefeed */
-
-      if (ch == '\n')
-        {
-          ret = ramlog_addchar(priv, '\r');
-          if (ret < 0)
-            {
-              /* The buffer is full and nothing was saved. Break out of the
-               * loop to return the number of bytes written up to this point.
-               * The data to be written is dropped on the floor.
-               */
-
-              break;
-            }
-        }
-#endif
-
-      /* Then output the character */
-
-      ret = ramlog_addchar(priv, ch);
-      if (ret < 0)
-        {
-          /* The buffer is full and nothing was saved. Break out of the
-           * loop to return the number of bytes written up to this point.
-           * The data to be written is dropped on the floor.
-           */
-
-          break;
-        }
-    }
-
-  /* Was anything written? */
-
-#if !defined(CONFIG_RAMLOG_NONBLOCKING) || !defined(CONFIG_DISABLE_POLL)
-  if (nwritten > 0)
+  if (ramlog_addstr(priv, buffer, len) > 0)
     {
-      irqstate_t flags;
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      int i;
-#endif
-
-      /* Are there threads waiting for read data? */
-
-      flags = enter_critical_section();
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      for (i = 0; i < priv->rl_nwaiters; i++)
-        {
-          /* Yes.. Notify all of the waiting readers that more data is available */
-
-          nxsem_post(&priv->rl_waitsem);
-        }
-#endif
-
-      /* Notify all poll/select waiters that they can write to the FIFO */
-
-      ramlog_pollnotify(priv, POLLIN);
-      leave_critical_section(flags);
+      ramlog_notify(priv);
     }
-#endif
 
   /* We always have to return the number of bytes requested and NOT the
    * number of bytes that were actually written.  Otherwise, callers
@@ -559,7 +865,9 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
   pollevent_t eventset;
+#ifndef CONFIG_RAMLOG_MULTIREADER
   size_t ndx;
+#endif
   int ret;
   int i;
 
@@ -611,6 +919,15 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
       eventset = 0;
 
+#ifdef CONFIG_RAMLOG_MULTIREADER
+      /* Writes never block.  Is there unread data for this reader? */
+
+      eventset |= POLLOUT;
+      if ((uint32_t)filep->f_pos != priv->rl_seq)
+        {
+          eventset |= POLLIN;
+        }
+#else
       ndx = priv->rl_head + 1;
       if (ndx >= priv->rl_bufsize)
         {
@@ -628,6 +945,7 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
        {
          eventset |= POLLIN;
        }
+#endif
 
       if (eventset)
         {
@@ -779,38 +1097,25 @@ int ramlog_syslog_channel(void)
 int ramlog_putc(int ch)
 {
   FAR struct ramlog_dev_s *priv = &g_sysdev;
-  int ret;
+  char buf;
 
-#ifdef CONFIG_RAMLOG_CRLF
-  /* Ignore carriage returns.  But return success. */
-
-  if (ch == '\r')
-    {
-      return ch;
-    }
-
-  /* Pre-pend a newline with a carriage return */
+  /* Add the character to the RAMLOG (ramlog_addstr() handles
+   * CONFIG_RAMLOG_CRLF).
+   */
 
-  if (ch == '\n')
+  buf = ch;
+  if (ch != '\r' && ramlog_addstr(priv, &buf, 1) < 1)
     {
-      ret = ramlog_addchar(priv, '\r');
-      if (ret < 0)
-        {
-          /* The buffer is full and nothing was saved. */
+      /* The buffer is full and nothing was saved. */
 
-          return ret;
-        }
+      return -EBUSY;
     }
-#endif
 
-  /* Add the character to the RAMLOG */
+  /* Wake up readers at the end of each line */
 
-  ret = ramlog_addchar(priv, ch);
-  if (ret < 0)
+  if (ch == '\n')
     {
-      /* ramlog_addchar() failed */
-
-      return ret;
+      ramlog_notify(priv);
     }
 
   /* Return the character added on success */
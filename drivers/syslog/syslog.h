@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdarg.h>
 
 /****************************************************************************
  * Public Data
@@ -236,6 +237,51 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the drainer thread of the deferred SYSLOG.  Until this has been
+ *   called, all messages are formatted immediately.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Record a message in the current CPU's deferred SYSLOG ring.  Only the
+ *   format string pointer, the arguments and copies of string arguments
+ *   are stored; the drainer thread formats the message later.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string.  It must remain valid (constant).
+ *   ap       - The arguments (not modified)
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was recorded or dropped because the ring was
+ *   full.  A negated errno value is returned if the message must be
+ *   formatted immediately (drainer not running, too many arguments or an
+ *   unsupported conversion).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred(int priority, FAR const IPTR char *fmt,
+                    FAR va_list *ap);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
@@ -0,0 +1,848 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_NRINGS        CONFIG_SMP_NCPUS
+#  define syslog_cpu()         up_cpu_index()
+#else
+#  define SYSLOG_NRINGS        1
+#  define syslog_cpu()         0
+#endif
+
+/* Order the ring buffer accesses against the index updates */
+
+#ifdef CONFIG_SPINLOCK
+#  define SYSLOG_BARRIER() \
+  do \
+    { \
+      __asm__ __volatile__("" ::: "memory"); \
+      SP_DSB(); \
+    } \
+  while (0)
+#else
+#  define SYSLOG_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/* Argument types */
+
+#define SYSLOG_ARG_INVALID     0  /* Unsupported conversion */
+#define SYSLOG_ARG_NONE        1  /* %% */
+#define SYSLOG_ARG_INT         2  /* c, d, i, u, x, X, o (also hh, h) */
+#define SYSLOG_ARG_LONG        3  /* l */
+#define SYSLOG_ARG_LLONG       4  /* ll */
+#define SYSLOG_ARG_SIZE        5  /* z */
+#define SYSLOG_ARG_PTR         6  /* p */
+#define SYSLOG_ARG_DOUBLE      7  /* e, f, g, E, G */
+#define SYSLOG_ARG_STR         8  /* s (the string is copied) */
+
+/* Maximum size of one conversion specification after '*' substitution */
+
+#define SYSLOG_SPECSIZE        32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One recorded argument */
+
+union syslog_arg_u
+{
+  int                  i;
+  long                 l;
+#ifdef CONFIG_HAVE_LONG_LONG
+  long long            ll;
+#endif
+  size_t               z;
+  FAR void            *p;
+#ifdef CONFIG_HAVE_DOUBLE
+  double               d;
+#endif
+  uint16_t             s;          /* Offset of the string copy in r_str[] */
+};
+
+/* One message.  Only r_hdr, r_hdr.nargs arguments and the used part of
+ * r_str[] are stored in the ring.
+ */
+
+struct syslog_rechdr_s
+{
+  uint16_t             len;        /* Size of the stored record in bytes */
+  uint8_t              priority;   /* Message priority */
+  uint8_t              nargs;      /* Number of recorded arguments */
+  systime_t            ticks;      /* Time when the message was logged */
+  FAR const IPTR char *fmt;        /* The (constant) format string */
+};
+
+struct syslog_rec_s
+{
+  struct syslog_rechdr_s r_hdr;
+  union syslog_arg_u   r_arg[CONFIG_SYSLOG_DEFERRED_NARGS];
+  char                 r_str[CONFIG_SYSLOG_DEFERRED_STRSIZE];
+};
+
+/* One per-CPU ring.  The producer is the CPU that owns the ring (with local
+ * interrupts disabled), the consumer is the drainer thread.
+ */
+
+struct syslog_ring_s
+{
+  volatile uint16_t    head;       /* Written only by the producer */
+  volatile uint16_t    tail;       /* Written only by the consumer */
+  volatile uint16_t    dropped;    /* Messages lost because the ring was full */
+  bool                 kicked;     /* Drainer posted at the half-full mark */
+  uint8_t              buffer[CONFIG_SYSLOG_DEFERRED_BUFSIZE];
+};
+
+/* A parsed conversion specification */
+
+struct syslog_spec_s
+{
+  FAR const char      *start;      /* The '%' */
+  FAR const char      *end;        /* One past the conversion character */
+  uint8_t              type;       /* See SYSLOG_ARG_* */
+  bool                 wstar;      /* Width is '*' */
+  bool                 pstar;      /* Precision is '*' */
+  int                  prec;       /* Literal precision or -1 */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_rings[SYSLOG_NRINGS];
+static sem_t g_syslog_drainsem;
+static volatile bool g_syslog_ready;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parsespec
+ *
+ * Description:
+ *   Find and parse the next conversion specification in 'fmt'.  Returns
+ *   NULL if there are no further conversions.
+ *
+ ****************************************************************************/
+
+static FAR const char *syslog_parsespec(FAR const char *fmt,
+                                        FAR struct syslog_spec_s *spec)
+{
+  FAR const char *ptr;
+  int nlong = 0;
+  bool size = false;
+
+  fmt = strchr(fmt, '%');
+  if (fmt == NULL)
+    {
+      return NULL;
+    }
+
+  spec->start = fmt;
+  spec->wstar = false;
+  spec->pstar = false;
+  spec->prec  = -1;
+
+  /* Flags and width */
+
+  for (ptr = fmt + 1; *ptr != '\0' && strchr("-+ #0", *ptr) != NULL; ptr++);
+
+  if (*ptr == '*')
+    {
+      spec->wstar = true;
+      ptr++;
+    }
+  else
+    {
+      while (*ptr >= '0' && *ptr <= '9')
+        {
+          ptr++;
+        }
+    }
+
+  /* Precision */
+
+  if (*ptr == '.')
+    {
+      ptr++;
+      if (*ptr == '*')
+        {
+          spec->pstar = true;
+          ptr++;
+        }
+      else
+        {
+          spec->prec = 0;
+          while (*ptr >= '0' && *ptr <= '9')
+            {
+              spec->prec = 10 * spec->prec + (*ptr++ - '0');
+            }
+        }
+    }
+
+  /* Length modifiers */
+
+  for (; ; ptr++)
+    {
+      if (*ptr == 'l')
+        {
+          nlong++;
+        }
+      else if (*ptr == 'z')
+        {
+          size = true;
+        }
+      else if (*ptr != 'h')
+        {
+          break;
+        }
+    }
+
+  /* Conversion */
+
+  switch (*ptr)
+    {
+      case '%':
+        spec->type = SYSLOG_ARG_NONE;
+        break;
+
+      case 'c':
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+        if (size)
+          {
+            spec->type = SYSLOG_ARG_SIZE;
+          }
+        else if (nlong == 0)
+          {
+            spec->type = SYSLOG_ARG_INT;
+          }
+        else if (nlong == 1)
+          {
+            spec->type = SYSLOG_ARG_LONG;
+          }
+        else
+          {
+#ifdef CONFIG_HAVE_LONG_LONG
+            spec->type = SYSLOG_ARG_LLONG;
+#else
+            spec->type = SYSLOG_ARG_INVALID;
+#endif
+          }
+        break;
+
+      case 'p':
+        spec->type = SYSLOG_ARG_PTR;
+        break;
+
+      case 's':
+        spec->type = SYSLOG_ARG_STR;
+        break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+      case 'e':
+      case 'f':
+      case 'g':
+      case 'E':
+      case 'G':
+        spec->type = SYSLOG_ARG_DOUBLE;
+        break;
+#endif
+
+      default:
+        /* Includes %n which must not be deferred */
+
+        spec->type = SYSLOG_ARG_INVALID;
+        return fmt;
+    }
+
+  spec->end = ptr + 1;
+  return fmt;
+}
+
+/****************************************************************************
+ * Name: syslog_record
+ *
+ * Description:
+ *   Record the format string and the arguments of one message in 'rec'.
+ *   Returns the size of the record or a negated errno value if the message
+ *   cannot be deferred.
+ *
+ ****************************************************************************/
+
+static int syslog_record(FAR struct syslog_rec_s *rec,
+                         FAR const IPTR char *fmt, va_list ap)
+{
+  struct syslog_spec_s spec;
+  FAR const char *ptr = fmt;
+  FAR const char *str;
+  size_t strused = 0;
+  size_t len;
+  int nargs = 0;
+  int need;
+
+  while ((ptr = syslog_parsespec(ptr, &spec)) != NULL)
+    {
+      ptr = spec.end;
+      if (spec.type == SYSLOG_ARG_INVALID)
+        {
+          return -ENOSYS;
+        }
+      else if (spec.type == SYSLOG_ARG_NONE)
+        {
+          continue;
+        }
+
+      need = 1 + (spec.wstar ? 1 : 0) + (spec.pstar ? 1 : 0);
+      if (nargs + need > CONFIG_SYSLOG_DEFERRED_NARGS)
+        {
+          return -E2BIG;
+        }
+
+      if (spec.wstar)
+        {
+          rec->r_arg[nargs++].i = va_arg(ap, int);
+        }
+
+      if (spec.pstar)
+        {
+          spec.prec = va_arg(ap, int);
+          rec->r_arg[nargs++].i = spec.prec;
+        }
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_INT:
+            rec->r_arg[nargs].i = va_arg(ap, int);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            rec->r_arg[nargs].l = va_arg(ap, long);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            rec->r_arg[nargs].ll = va_arg(ap, long long);
+            break;
+#endif
+
+          case SYSLOG_ARG_SIZE:
+            rec->r_arg[nargs].z = va_arg(ap, size_t);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            rec->r_arg[nargs].p = va_arg(ap, FAR void *);
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case SYSLOG_ARG_DOUBLE:
+            rec->r_arg[nargs].d = va_arg(ap, double);
+            break;
+#endif
+
+          case SYSLOG_ARG_STR:
+            {
+              /* The string may not exist any longer when the message is
+               * formatted, so copy it (honoring the precision, the string
+               * need not be terminated in that case).
+               */
+
+              str = va_arg(ap, FAR const char *);
+              if (str == NULL)
+                {
+                  str = "(null)";
+                }
+
+              len = spec.prec >= 0 ? strnlen(str, spec.prec) : strlen(str);
+              if (len > CONFIG_SYSLOG_DEFERRED_STRSIZE - strused - 1)
+                {
+                  len = CONFIG_SYSLOG_DEFERRED_STRSIZE - strused - 1;
+                }
+
+              memcpy(&rec->r_str[strused], str, len);
+              rec->r_str[strused + len] = '\0';
+              rec->r_arg[nargs].s = strused;
+              strused += len + 1;
+
+              if (strused >= CONFIG_SYSLOG_DEFERRED_STRSIZE)
+                {
+                  /* No space left for the next string */
+
+                  strused = CONFIG_SYSLOG_DEFERRED_STRSIZE - 1;
+                  rec->r_str[strused] = '\0';
+                }
+            }
+            break;
+
+          default:
+            return -ENOSYS;
+        }
+
+      nargs++;
+    }
+
+  rec->r_hdr.nargs = nargs;
+  rec->r_hdr.fmt   = fmt;
+  rec->r_hdr.len   = sizeof(struct syslog_rechdr_s) +
+                     nargs * sizeof(union syslog_arg_u) + strused;
+  return rec->r_hdr.len;
+}
+
+/****************************************************************************
+ * Name: syslog_ringused
+ ****************************************************************************/
+
+static inline size_t syslog_ringused(FAR struct syslog_ring_s *ring)
+{
+  return (ring->head + CONFIG_SYSLOG_DEFERRED_BUFSIZE - ring->tail) %
+         CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+}
+
+/****************************************************************************
+ * Name: syslog_ringput and syslog_ringget
+ *
+ * Description:
+ *   Copy to/from the ring starting at index 'ndx', handling the wrap.
+ *   Returns the new index.
+ *
+ ****************************************************************************/
+
+static size_t syslog_ringput(FAR struct syslog_ring_s *ring, size_t ndx,
+                             FAR const void *src, size_t len)
+{
+  size_t ncopy = CONFIG_SYSLOG_DEFERRED_BUFSIZE - ndx;
+
+  if (ncopy > len)
+    {
+      ncopy = len;
+    }
+
+  memcpy(&ring->buffer[ndx], src, ncopy);
+  memcpy(ring->buffer, (FAR const uint8_t *)src + ncopy, len - ncopy);
+  return (ndx + len) % CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+}
+
+static size_t syslog_ringget(FAR struct syslog_ring_s *ring, size_t ndx,
+                             FAR void *dest, size_t len)
+{
+  size_t ncopy = CONFIG_SYSLOG_DEFERRED_BUFSIZE - ndx;
+
+  if (ncopy > len)
+    {
+      ncopy = len;
+    }
+
+  memcpy(dest, &ring->buffer[ndx], ncopy);
+  memcpy((FAR uint8_t *)dest + ncopy, ring->buffer, len - ncopy);
+  return (ndx + len) % CONFIG_SYSLOG_DEFERRED_BUFSIZE;
+}
+
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Format one recorded message to the SYSLOG channel.
+ *
+ ****************************************************************************/
+
+static void syslog_format(FAR struct syslog_rec_s *rec)
+{
+  struct lib_syslogstream_s stream;
+  struct syslog_spec_s spec;
+  FAR union syslog_arg_u *arg = rec->r_arg;
+  FAR const char *ptr = rec->r_hdr.fmt;
+  FAR const char *next;
+  FAR const char *src;
+  char buf[SYSLOG_SPECSIZE];
+  size_t len;
+  int val;
+
+  syslogstream_create(&stream);
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  /* Pre-pend the message with the time when it was logged */
+
+  (void)lib_sprintf(&stream.public, "[%6d.%06d]",
+                    (int)(rec->r_hdr.ticks / TICK_PER_SEC),
+                    (int)TICK2USEC(rec->r_hdr.ticks % TICK_PER_SEC));
+#endif
+
+  for (; ; )
+    {
+      next = syslog_parsespec(ptr, &spec);
+
+      /* Emit the literal text up to the next conversion */
+
+      for (src = ptr; *src != '\0' && src != next; src++)
+        {
+          stream.public.put(&stream.public, *src);
+        }
+
+      if (next == NULL)
+        {
+          break;
+        }
+
+      ptr = spec.end;
+      if (spec.type == SYSLOG_ARG_NONE)
+        {
+          stream.public.put(&stream.public, '%');
+          continue;
+        }
+
+      /* Rebuild the conversion with any '*' replaced by its value */
+
+      for (len = 0, src = spec.start;
+           src < spec.end && len < SYSLOG_SPECSIZE - 12;
+           src++)
+        {
+          if (*src != '*')
+            {
+              buf[len++] = *src;
+              continue;
+            }
+
+          val = (arg++)->i;
+          if (src[-1] == '.' && val < 0)
+            {
+              len--;  /* Negative precision: As if omitted */
+            }
+          else
+            {
+              len += snprintf(&buf[len], SYSLOG_SPECSIZE - len, "%d", val);
+            }
+        }
+
+      buf[len] = '\0';
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_INT:
+            (void)lib_sprintf(&stream.public, buf, arg->i);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            (void)lib_sprintf(&stream.public, buf, arg->l);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            (void)lib_sprintf(&stream.public, buf, arg->ll);
+            break;
+#endif
+
+          case SYSLOG_ARG_SIZE:
+            (void)lib_sprintf(&stream.public, buf, arg->z);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            (void)lib_sprintf(&stream.public, buf, arg->p);
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case SYSLOG_ARG_DOUBLE:
+            (void)lib_sprintf(&stream.public, buf, arg->d);
+            break;
+#endif
+
+          case SYSLOG_ARG_STR:
+            (void)lib_sprintf(&stream.public, buf, &rec->r_str[arg->s]);
+            break;
+
+          default:
+            break;
+        }
+
+      arg++;
+    }
+
+  syslogstream_destroy(&stream);
+}
+
+/****************************************************************************
+ * Name: syslog_drain
+ *
+ * Description:
+ *   Format and output all recorded messages, oldest first.
+ *
+ ****************************************************************************/
+
+static void syslog_drain(void)
+{
+  FAR struct syslog_ring_s *ring;
+  struct lib_syslogstream_s stream;
+  struct syslog_rec_s rec;
+  struct syslog_rechdr_s hdr;
+  systime_t oldest = 0;
+  int lost;
+  size_t tail;
+  size_t len;
+  int selected;
+  int i;
+
+  for (; ; )
+    {
+      /* Select the ring with the oldest pending message */
+
+      selected = -1;
+      for (i = 0; i < SYSLOG_NRINGS; i++)
+        {
+          ring = &g_syslog_rings[i];
+
+          if (ring->dropped > 0)
+            {
+              /* Not atomic:  A drop on the other CPU may go uncounted */
+
+              lost = ring->dropped;
+              ring->dropped -= lost;
+
+              syslogstream_create(&stream);
+              (void)lib_sprintf(&stream.public, "[%d messages lost]\n", lost);
+              syslogstream_destroy(&stream);
+            }
+
+          if (syslog_ringused(ring) > 0)
+            {
+              SYSLOG_BARRIER();
+              (void)syslog_ringget(ring, ring->tail, &hdr, sizeof(hdr));
+
+              if (selected < 0 || (int32_t)(hdr.ticks - oldest) < 0)
+                {
+                  selected = i;
+                  oldest   = hdr.ticks;
+                }
+            }
+        }
+
+      if (selected < 0)
+        {
+          break;
+        }
+
+      /* Copy the record out of the ring and release the space */
+
+      ring = &g_syslog_rings[selected];
+      tail = syslog_ringget(ring, ring->tail, &rec.r_hdr, sizeof(hdr));
+
+      len  = rec.r_hdr.nargs * sizeof(union syslog_arg_u);
+      tail = syslog_ringget(ring, tail, rec.r_arg, len);
+
+      len  = rec.r_hdr.len - sizeof(hdr) - len;
+      tail = syslog_ringget(ring, tail, rec.r_str, len);
+
+      SYSLOG_BARRIER();
+      ring->tail   = tail;
+      ring->kicked = false;
+
+      syslog_format(&rec);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_drainer
+ *
+ * Description:
+ *   The low priority drainer thread.  It runs periodically or when a ring
+ *   becomes half full.
+ *
+ ****************************************************************************/
+
+static int syslog_drainer(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      (void)nxsem_tickwait(&g_syslog_drainsem, clock_systimer(),
+                           MSEC2TICK(CONFIG_SYSLOG_DEFERRED_PERIOD));
+      syslog_drain();
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the drainer thread.  Until this has been called, all messages are
+ *   formatted immediately.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_initialize(void)
+{
+  int ret;
+
+  nxsem_init(&g_syslog_drainsem, 0, 0);
+  nxsem_setprotocol(&g_syslog_drainsem, SEM_PRIO_NONE);
+
+  ret = kthread_create("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       (main_t)syslog_drainer, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_syslog_ready = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred
+ *
+ * Description:
+ *   Record a message in the current CPU's ring for formatting by the
+ *   drainer thread.  Only the format string pointer, the arguments and
+ *   copies of any string arguments are stored.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was recorded (or dropped because the ring was
+ *   full).  A negated errno value if the message must be formatted
+ *   immediately by the caller; 'ap' is not modified in that case.
+ *
+ ****************************************************************************/
+
+int syslog_deferred(int priority, FAR const IPTR char *fmt,
+                    FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  struct syslog_rec_s rec;
+  irqstate_t flags;
+  size_t head;
+  size_t used;
+  va_list copy;
+  int len;
+
+  if (!g_syslog_ready)
+    {
+      return -EAGAIN;
+    }
+
+  /* Record the message on the stack */
+
+  va_copy(copy, *ap);
+  len = syslog_record(&rec, fmt, copy);
+  va_end(copy);
+
+  if (len < 0)
+    {
+      return len;
+    }
+
+  rec.r_hdr.priority = priority;
+  rec.r_hdr.ticks    = clock_systimer();
+
+  /* Then copy it into this CPU's ring.  Only local interrupts are disabled:
+   * No other CPU ever produces into this ring.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_rings[syslog_cpu()];
+  used  = syslog_ringused(ring);
+
+  if (used + len >= CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+    {
+      ring->dropped++;
+      up_irq_restore(flags);
+      return OK;
+    }
+
+  head = syslog_ringput(ring, ring->head, &rec.r_hdr, sizeof(rec.r_hdr));
+  head = syslog_ringput(ring, head, rec.r_arg,
+                        rec.r_hdr.nargs * sizeof(union syslog_arg_u));
+  head = syslog_ringput(ring, head, rec.r_str,
+                        len - sizeof(rec.r_hdr) -
+                        rec.r_hdr.nargs * sizeof(union syslog_arg_u));
+
+  SYSLOG_BARRIER();
+  ring->head = head;
+
+  /* Wake the drainer early if the ring is now half full */
+
+  used += len;
+  if (used >= CONFIG_SYSLOG_DEFERRED_BUFSIZE / 2 && !ring->kicked)
+    {
+      ring->kicked = true;
+      up_irq_restore(flags);
+      nxsem_post(&g_syslog_drainsem);
+      return OK;
+    }
+
+  up_irq_restore(flags);
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
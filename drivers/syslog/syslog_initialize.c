@@ -109,6 +109,15 @@ int syslog_initialize(enum syslog_init_e phase)
 
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  if (ret >= 0 && phase == SYSLOG_INIT_LATE)
+    {
+      /* Start formatting messages in the drainer thread */
+
+      ret = syslog_deferred_initialize();
+    }
+#endif
+
   return ret;
 }
 
@@ -49,6 +49,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -73,6 +75,20 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
 #ifdef CONFIG_SYSLOG_TIMESTAMP
   struct timespec ts;
+#endif
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Just record the message if possible.  The drainer thread will format
+   * it later.  Emergency output is never deferred.
+   */
+
+  if (priority != LOG_EMERG && syslog_deferred(priority, fmt, ap) >= 0)
+    {
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
 
   /* Get the current time.  Since debug output may be generated very early
    * in the start-up sequence, hardware timer support may not yet be
@@ -80,6 +80,22 @@
 
 #define CDCACM_RXDELAY   (CLK_TCK / 5)
 
+/* The size of one bulk OUT read request buffer.  This must be at least the
+ * size of the largest bulk OUT max packet.
+ */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+#  define CDCACM_RDMAXPACKET CONFIG_CDCACM_EPBULKOUT_HSSIZE
+#else
+#  define CDCACM_RDMAXPACKET CONFIG_CDCACM_EPBULKOUT_FSSIZE
+#endif
+
+#if CONFIG_CDCACM_BULKOUT_REQLEN > CDCACM_RDMAXPACKET
+#  define CDCACM_RDREQLEN CONFIG_CDCACM_BULKOUT_REQLEN
+#else
+#  define CDCACM_RDREQLEN CDCACM_RDMAXPACKET
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -168,6 +184,7 @@ struct cdcacm_alloc_s
 
 /* Transfer helpers *********************************************************/
 
+static uint16_t cdcacm_rdreqlen(FAR struct usbdev_ep_s *ep);
 static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
                  uint8_t *reqbuf, uint16_t reqlen);
 static int     cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv);
@@ -297,6 +314,29 @@ static const struct uart_ops_s g_uartops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cdcacm_rdreqlen
+ *
+ * Description:
+ *   Return the length of a bulk OUT read request.  This is the size of the
+ *   read request buffer rounded down to a multiple of the endpoint max
+ *   packet size so that a transfer can only end on a packet boundary or
+ *   with a short packet.
+ *
+ ****************************************************************************/
+
+static uint16_t cdcacm_rdreqlen(FAR struct usbdev_ep_s *ep)
+{
+  uint16_t maxpacket = ep->maxpacket;
+
+  if (maxpacket == 0 || maxpacket >= CDCACM_RDREQLEN)
+    {
+      return CDCACM_RDREQLEN;
+    }
+
+  return (CDCACM_RDREQLEN / maxpacket) * maxpacket;
+}
+
 /****************************************************************************
  * Name: cdcacm_fillrequest
  *
@@ -332,12 +372,34 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
 
   while (xmit->head != xmit->tail && nbytes < reqlen)
     {
-      *reqbuf++ = xmit->buffer[xmit->tail];
-      nbytes++;
+      uint16_t ncopy;
+
+      /* Copy the contiguous run of data up to the head pointer or to the end
+       * of the circular buffer, whichever comes first.
+       */
+
+      if (xmit->head > xmit->tail)
+        {
+          ncopy = xmit->head - xmit->tail;
+        }
+      else
+        {
+          ncopy = xmit->size - xmit->tail;
+        }
+
+      if (ncopy > reqlen - nbytes)
+        {
+          ncopy = reqlen - nbytes;
+        }
+
+      memcpy(reqbuf, &xmit->buffer[xmit->tail], ncopy);
+      reqbuf += ncopy;
+      nbytes += ncopy;
 
-      /* Increment the tail pointer */
+      /* Increment the tail pointer and check for wrap around */
 
-      if (++(xmit->tail) >= xmit->size)
+      xmit->tail += ncopy;
+      if (xmit->tail >= xmit->size)
         {
           xmit->tail = 0;
         }
@@ -482,9 +544,6 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
 
   DEBUGASSERT(priv != NULL && rdcontainer != NULL);
 
-  uinfo("head=%d tail=%d nrdq=%d reqlen=%d\n",
-        priv->serdev.recv.head, priv->serdev.recv.tail, priv->nrdq, reqlen);
-
 #ifdef CONFIG_CDCACM_IFLOWCONTROL
   DEBUGASSERT(priv->rxenabled && !priv->iactive);
 #else
@@ -500,6 +559,9 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
   serdev = &priv->serdev;
   recv   = &serdev->recv;
 
+  uinfo("head=%d tail=%d nrdq=%d reqlen=%d\n",
+        recv->head, recv->tail, priv->nrdq, reqlen);
+
   /* Get the next head index. */
 
   currhead = recv->head;
@@ -538,10 +600,14 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
    * proper way to throttle a serial device.
    */
 
-  while (nexthead != recv->tail && nbytes < reqlen)
-    {
 #if defined(CONFIG_SERIAL_IFLOWCONTROL) && \
     defined(CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS)
+  /* The watermark must be checked as each byte is added so the data is
+   * copied one byte at a time.
+   */
+
+  while (nexthead != recv->tail && nbytes < reqlen)
+    {
       unsigned int nbuffered;
 
       /* How many bytes are buffered */
@@ -570,7 +636,6 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
               break;
             }
         }
-#endif
 
       /* Copy one byte to the head of the circular RX buffer */
 
@@ -589,6 +654,53 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
           nexthead = 0;
         }
     }
+#else
+  /* Otherwise, copy the packet in contiguous runs:  Up to the byte before
+   * the tail pointer or up to the end of the circular buffer, whichever
+   * comes first.
+   */
+
+  while (nexthead != recv->tail && nbytes < reqlen)
+    {
+      uint16_t ncopy;
+
+      if (recv->tail > currhead)
+        {
+          ncopy = recv->tail - currhead - 1;
+        }
+      else
+        {
+          ncopy = recv->size - currhead;
+          if (recv->tail == 0)
+            {
+              ncopy--;
+            }
+        }
+
+      if (ncopy > reqlen - nbytes)
+        {
+          ncopy = reqlen - nbytes;
+        }
+
+      memcpy(&recv->buffer[currhead], reqbuf, ncopy);
+      reqbuf += ncopy;
+      nbytes += ncopy;
+
+      /* Update the head index and check for wrap around */
+
+      currhead += ncopy;
+      if (currhead >= recv->size)
+        {
+          currhead = 0;
+        }
+
+      nexthead = currhead + 1;
+      if (nexthead >= recv->size)
+        {
+          nexthead = 0;
+        }
+    }
+#endif
 
   /* Write back the head pointer. */
 
@@ -654,7 +766,7 @@ static int cdcacm_requeue_rdrequest(FAR struct cdcacm_dev_s *priv,
   /* Requeue the read request */
 
   ep       = priv->epbulkout;
-  req->len = ep->maxpacket;
+  req->len = cdcacm_rdreqlen(ep);
   ret      = EP_SUBMIT(ep, req);
   if (ret != OK)
     {
@@ -1116,6 +1228,7 @@ static int cdcacm_setconfig(FAR struct cdcacm_dev_s *priv, uint8_t config)
     {
       req           = priv->rdreqs[i].req;
       req->callback = cdcacm_rdcomplete;
+      req->len      = cdcacm_rdreqlen(priv->epbulkout);
       ret           = EP_SUBMIT(priv->epbulkout, req);
       if (ret != OK)
         {
@@ -1400,13 +1513,12 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
 
   priv->epbulkout->priv = priv;
 
-  /* Pre-allocate read requests.  The buffer size is one full packet. */
+  /* Pre-allocate read requests.  The buffer size is at least one full
+   * packet but may hold several packets so that multi-packet transfers can
+   * complete in a single request.
+   */
 
-#ifdef CONFIG_USBDEV_DUALSPEED
-  reqlen = CONFIG_CDCACM_EPBULKOUT_HSSIZE;
-#else
-  reqlen = CONFIG_CDCACM_EPBULKOUT_FSSIZE;
-#endif
+  reqlen = CDCACM_RDREQLEN;
 
   for (i = 0; i < CONFIG_CDCACM_NRDREQS; i++)
     {
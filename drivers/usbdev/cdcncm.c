@@ -0,0 +1,2468 @@
+/****************************************************************************
+ * drivers/usbdev/cdcncm.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <queue.h>
+#include <errno.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/arch.h>
+#include <nuttx/usb/usb.h>
+#include <nuttx/usb/cdc.h>
+#include <nuttx/usb/cdcncm.h>
+#include <nuttx/usb/usbdev.h>
+#include <nuttx/usb/usbdev_trace.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor definitions
+ ****************************************************************************/
+
+#define CDCNCM_EP0MAXPACKET     64
+#define CDCNCM_VERSIONNO        0x0100
+#define CDCNCM_SERIALSTR        "0"
+
+#define CDCNCM_NCONFIGS         (1)
+#define CDCNCM_CONFIGID         (1)
+#define CDCNCM_CONFIGIDNONE     (0)
+
+#define CDCNCM_COMMIFID         (0)
+#define CDCNCM_DATAIFID         (1)
+
+#define CDCNCM_EPINTIN_ADDR     USB_EPIN(3)
+#define CDCNCM_EPBULKIN_ADDR    USB_EPIN(1)
+#define CDCNCM_EPBULKOUT_ADDR   USB_EPOUT(2)
+
+#define CDCNCM_MANUFACTURERSTRID (1)
+#define CDCNCM_PRODUCTSTRID     (2)
+#define CDCNCM_SERIALSTRID      (3)
+#define CDCNCM_MACSTRID         (4)
+
+#define CDCNCM_STR_LANGUAGE     (0x0409) /* en-us */
+
+#define CDCNCM_MXDESCLEN        (128)
+#define CDCNCM_MAXSTRLEN        (CDCNCM_MXDESCLEN-2)
+#define CDCNCM_CTRLREQ_LEN      (256)
+#define CDCNCM_NOTIFY_LEN       \
+  SIZEOF_NOTIFICATION_S(sizeof(struct cdc_speedchange_s))
+
+/* Layout of an IN NTB:  The NTH16 is followed by an NDP16 with room for
+ * CONFIG_CDCNCM_NDATAGRAMS entries and the terminating zero entry.  The
+ * datagrams follow, each starting on a 4-byte boundary.  Keeping the NDP in
+ * front lets each datagram pointer be written as the datagram is added.
+ */
+
+#define CDCNCM_ALIGN(n)         (((n) + 3) & ~3)
+#define CDCNCM_NDP_OFFSET       SIZEOF_NCM_NTH16
+#define CDCNCM_NDP_MAXSIZE      SIZEOF_NCM_NDP16(CONFIG_CDCNCM_NDATAGRAMS + 1)
+#define CDCNCM_DGRAM_OFFSET     (CDCNCM_NDP_OFFSET + CDCNCM_NDP_MAXSIZE)
+
+/* The smallest IN NTB that a host may select must hold a full frame */
+
+#define CDCNCM_NTB_MINSIZE      2048
+
+#if CDCNCM_DGRAM_OFFSET + CONFIG_NET_ETH_MTU > CDCNCM_NTB_MINSIZE
+#  error CONFIG_NET_ETH_MTU does not fit in the smallest IN NTB
+#endif
+
+/* Notifications that are sent when the data interface is activated */
+
+#define CDCNCM_NOTIFY_NONE      0
+#define CDCNCM_NOTIFY_SPEED     1
+#define CDCNCM_NOTIFY_CONNECT   2
+
+/* TX poll delay = 1 seconds.  CLK_TCK is the number of ticks per second */
+
+#define CDCNCM_WDDELAY          (1*CLK_TCK)
+
+/* Work queue to use for network operations. LPWORK should be used here */
+
+#define ETHWORK                 LPWORK
+
+#ifndef min
+#  define min(a,b) ((a)<(b)?(a):(b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Container to support a list of requests */
+
+struct cdcncm_req_s
+{
+  FAR struct cdcncm_req_s *flink;  /* Implements a singly linked list */
+  FAR struct usbdev_req_s *req;    /* The contained request */
+};
+
+/* This structure describes the internal state of the driver */
+
+struct cdcncm_dev_s
+{
+  struct net_driver_s      netdev;       /* Network driver structure */
+  FAR struct usbdev_s     *usbdev;       /* usbdev driver pointer */
+  FAR struct usbdev_ep_s  *epintin;      /* Interrupt IN endpoint structure */
+  FAR struct usbdev_ep_s  *epbulkin;     /* Bulk IN endpoint structure */
+  FAR struct usbdev_ep_s  *epbulkout;    /* Bulk OUT endpoint structure */
+  FAR struct usbdev_req_s *ctrlreq;      /* Preallocated control request */
+  FAR struct usbdev_req_s *epintin_req;  /* Preallocated notification */
+  FAR struct usbdev_req_s *rdreq;        /* Preallocated OUT NTB request */
+  struct sq_queue_s reqlist;             /* List of free IN NTB requests */
+
+  /* Preallocated IN NTB requests */
+
+  struct cdcncm_req_s wrreqs[CONFIG_CDCNCM_NWRREQS];
+
+  struct work_s rxwork;                  /* Worker for dispatching OUT NTBs */
+  WDOG_ID txpoll;                        /* TX poll watchdog */
+  struct work_s pollwork;                /* TX poll worker */
+
+  uint8_t config;                        /* USB Configuration number */
+  uint8_t notify;                        /* Next notification to send */
+  bool connected;                        /* Data interface is active */
+  bool rdreq_submitted;                  /* The read request is submitted */
+  bool rx_blocked;                       /* OUT NTB is being dispatched */
+  bool rx_pending;                       /* OUT NTB waits for a request */
+
+  /* The IN NTB that is being assembled by the network */
+
+  FAR struct cdcncm_req_s *net_req;      /* Request assigned to network */
+  uint16_t txoffset;                     /* Offset of the next datagram */
+  uint16_t txseq;                        /* Sequence number of next NTB */
+  uint8_t txndgrams;                     /* Datagrams in net_req */
+  uint32_t ntbinsize;                    /* IN NTB size selected by host */
+
+  /* The OUT NTB that is being dispatched */
+
+  uint16_t rxlen;                        /* Size of the NTB in rdreq */
+  uint16_t rxndp;                        /* Offset of the current NDP */
+  uint16_t rxdpe;                        /* Next datagram pointer entry */
+
+  uint8_t host_mac_address[6];           /* Host side MAC address */
+};
+
+/* The internal version of the class driver */
+
+struct cdcncm_driver_s
+{
+  struct usbdevclass_driver_s drvr;
+  FAR struct cdcncm_dev_s     *dev;
+};
+
+/* This is what is allocated */
+
+struct cdcncm_alloc_s
+{
+  struct cdcncm_dev_s    dev;
+  struct cdcncm_driver_s drvr;
+};
+
+/* CDC-NCM USB configuration descriptor */
+
+struct cdcncm_cfgdesc_s
+{
+  struct usb_cfgdesc_s        cfgdesc;       /* Configuration descriptor */
+  struct usb_iaddesc_s        assocdesc;     /* Interface association */
+  struct usb_ifdesc_s         commifdesc;    /* Communication interface */
+  struct cdc_hdr_funcdesc_s   hdrdesc;       /* Header functional desc. */
+  struct cdc_union_funcdesc_s uniondesc;     /* Union functional desc. */
+  struct cdc_ecm_funcdesc_s   ecmdesc;       /* Ethernet functional desc. */
+  struct cdc_ncm_funcdesc_s   ncmdesc;       /* NCM functional desc. */
+  struct usb_epdesc_s         epintindesc;   /* Interrupt endpoint */
+  struct usb_ifdesc_s         dataif0desc;   /* Data interface, no data */
+  struct usb_ifdesc_s         dataif1desc;   /* Data interface, active */
+  struct usb_epdesc_s         epbulkindesc;  /* Bulk IN endpoint */
+  struct usb_epdesc_s         epbulkoutdesc; /* Bulk OUT endpoint */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Netdev driver callbacks */
+
+static int cdcncm_ifup(FAR struct net_driver_s *dev);
+static int cdcncm_ifdown(FAR struct net_driver_s *dev);
+static int cdcncm_txavail(FAR struct net_driver_s *dev);
+static int cdcncm_txpoll(FAR struct net_driver_s *dev);
+static void cdcncm_polltimer(int argc, uint32_t arg, ...);
+static void cdcncm_rxdispatch(FAR void *arg);
+
+/* usbclass callbacks */
+
+static int  usbclass_setup(FAR struct usbdevclass_driver_s *driver,
+                           FAR struct usbdev_s *dev,
+                           FAR const struct usb_ctrlreq_s *ctrl,
+                           FAR uint8_t *dataout, size_t outlen);
+static int  usbclass_bind(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev);
+static void usbclass_unbind(FAR struct usbdevclass_driver_s *driver,
+                            FAR struct usbdev_s *dev);
+static void usbclass_disconnect(FAR struct usbdevclass_driver_s *driver,
+                                FAR struct usbdev_s *dev);
+static int  usbclass_setconfig(FAR struct cdcncm_dev_s *priv,
+                               uint8_t config);
+static void usbclass_resetconfig(FAR struct cdcncm_dev_s *priv);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* USB driver operations */
+
+static const struct usbdevclass_driverops_s g_driverops =
+{
+  &usbclass_bind,
+  &usbclass_unbind,
+  &usbclass_setup,
+  &usbclass_disconnect,
+  NULL,
+  NULL
+};
+
+static const struct usb_devdesc_s g_devdesc =
+{
+  USB_SIZEOF_DEVDESC,                           /* len */
+  USB_DESC_TYPE_DEVICE,                         /* type */
+  {LSBYTE(0x0200), MSBYTE(0x0200)},             /* usb */
+  0,                                            /* classid */
+  0,                                            /* subclass */
+  0,                                            /* protocol */
+  CDCNCM_EP0MAXPACKET,                          /* maxpacketsize */
+  { LSBYTE(CONFIG_CDCNCM_VENDORID),             /* vendor */
+    MSBYTE(CONFIG_CDCNCM_VENDORID) },
+  { LSBYTE(CONFIG_CDCNCM_PRODUCTID),            /* product */
+    MSBYTE(CONFIG_CDCNCM_PRODUCTID) },
+  { LSBYTE(CDCNCM_VERSIONNO),                   /* device */
+    MSBYTE(CDCNCM_VERSIONNO) },
+  CDCNCM_MANUFACTURERSTRID,                     /* imfgr */
+  CDCNCM_PRODUCTSTRID,                          /* iproduct */
+  CDCNCM_SERIALSTRID,                           /* serno */
+  CDCNCM_NCONFIGS                               /* nconfigs */
+};
+
+static const struct cdcncm_cfgdesc_s g_cdcncm_cfgdesc =
+{
+  {
+    .len          = USB_SIZEOF_CFGDESC,
+    .type         = USB_DESC_TYPE_CONFIG,
+    .totallen     = {0, 0},
+    .ninterfaces  = 2,
+    .cfgvalue     = CDCNCM_CONFIGID,
+    .icfg         = 0,
+    .attr         = USB_CONFIG_ATTR_ONE | USB_CONFIG_ATTR_SELFPOWER,
+    .mxpower      = (CONFIG_USBDEV_MAXPOWER + 1) / 2
+  },
+  {
+    .len          = USB_SIZEOF_IADDESC,
+    .type         = USB_DESC_TYPE_INTERFACEASSOCIATION,
+    .firstif      = CDCNCM_COMMIFID,
+    .nifs         = 2,
+    .classid      = USB_CLASS_CDC,
+    .subclass     = CDC_SUBCLASS_NCM,
+    .protocol     = CDC_PROTO_NONE,
+    .ifunction    = 0
+  },
+  {
+    .len          = USB_SIZEOF_IFDESC,
+    .type         = USB_DESC_TYPE_INTERFACE,
+    .ifno         = CDCNCM_COMMIFID,
+    .alt          = 0,
+    .neps         = 1,
+    .classid      = USB_CLASS_CDC,
+    .subclass     = CDC_SUBCLASS_NCM,
+    .protocol     = CDC_PROTO_NONE,
+    .iif          = 0
+  },
+  {
+    .size         = SIZEOF_HDR_FUNCDESC,
+    .type         = USB_DESC_TYPE_CSINTERFACE,
+    .subtype      = CDC_DSUBTYPE_HDR,
+    .cdc          = { LSBYTE(0x0110), MSBYTE(0x0110) }
+  },
+  {
+    .size         = SIZEOF_UNION_FUNCDESC(1),
+    .type         = USB_DESC_TYPE_CSINTERFACE,
+    .subtype      = CDC_DSUBTYPE_UNION,
+    .master       = CDCNCM_COMMIFID,
+    .slave        = { CDCNCM_DATAIFID }
+  },
+  {
+    .size         = SIZEOF_ECM_FUNCDESC,
+    .type         = USB_DESC_TYPE_CSINTERFACE,
+    .subtype      = CDC_DSUBTYPE_ECM,
+    .mac          = CDCNCM_MACSTRID,
+    .stats        = { 0, 0, 0, 0 },
+    .maxseg       = { LSBYTE(CONFIG_NET_ETH_MTU),
+                      MSBYTE(CONFIG_NET_ETH_MTU) },
+    .nmcflts      = { 0, 0 },
+    .npwrflts     = 0
+  },
+  {
+    .size         = SIZEOF_NCM_FUNCDESC,
+    .type         = USB_DESC_TYPE_CSINTERFACE,
+    .subtype      = CDC_DSUBTYPE_NCM,
+    .version      = { LSBYTE(0x0100), MSBYTE(0x0100) },
+    .caps         = 0
+  },
+  {
+    .len          = USB_SIZEOF_EPDESC,
+    .type         = USB_DESC_TYPE_ENDPOINT,
+    .addr         = CDCNCM_EPINTIN_ADDR,
+    .attr         = USB_EP_ATTR_XFER_INT,
+    .mxpacketsize = { LSBYTE(16), MSBYTE(16) },
+#ifdef CONFIG_USBDEV_DUALSPEED
+    .interval     = 9
+#else
+    .interval     = 32
+#endif
+  },
+  {
+    .len          = USB_SIZEOF_IFDESC,
+    .type         = USB_DESC_TYPE_INTERFACE,
+    .ifno         = CDCNCM_DATAIFID,
+    .alt          = 0,
+    .neps         = 0,
+    .classid      = USB_CLASS_CDC_DATA,
+    .subclass     = CDC_DATA_SUBCLASS_NONE,
+    .protocol     = CDC_DATA_PROTO_NTB,
+    .iif          = 0
+  },
+  {
+    .len          = USB_SIZEOF_IFDESC,
+    .type         = USB_DESC_TYPE_INTERFACE,
+    .ifno         = CDCNCM_DATAIFID,
+    .alt          = 1,
+    .neps         = 2,
+    .classid      = USB_CLASS_CDC_DATA,
+    .subclass     = CDC_DATA_SUBCLASS_NONE,
+    .protocol     = CDC_DATA_PROTO_NTB,
+    .iif          = 0
+  },
+  {
+    .len          = USB_SIZEOF_EPDESC,
+    .type         = USB_DESC_TYPE_ENDPOINT,
+    .addr         = CDCNCM_EPBULKIN_ADDR,
+    .attr         = USB_EP_ATTR_XFER_BULK,
+#ifdef CONFIG_USBDEV_DUALSPEED
+    .mxpacketsize = { LSBYTE(512), MSBYTE(512) },
+    .interval     = 0
+#else
+    .mxpacketsize = { LSBYTE(64), MSBYTE(64) },
+    .interval     = 1
+#endif
+  },
+  {
+    .len          = USB_SIZEOF_EPDESC,
+    .type         = USB_DESC_TYPE_ENDPOINT,
+    .addr         = CDCNCM_EPBULKOUT_ADDR,
+    .attr         = USB_EP_ATTR_XFER_BULK,
+#ifdef CONFIG_USBDEV_DUALSPEED
+    .mxpacketsize = { LSBYTE(512), MSBYTE(512) },
+    .interval     = 0
+#else
+    .mxpacketsize = { LSBYTE(64), MSBYTE(64) },
+    .interval     = 1
+#endif
+  }
+};
+
+/* Default MAC address given to the host side of the interface. */
+
+static const uint8_t g_cdcncm_default_mac_addr[6] =
+{
+  0x02, 0x00, 0x00, 0x11, 0x22, 0x34
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Buffering of data is implemented in the following manner:
+ *
+ * The driver holds CONFIG_CDCNCM_NWRREQS preallocated bulk IN requests,
+ * each with a buffer for one IN NTB, and one bulk OUT request with a buffer
+ * for one OUT NTB.
+ *
+ * The network assembles IN NTBs in place:  d_buf points to the next
+ * datagram slot of the NTB that is held by the network.  Each packet that
+ * the network produces is added to the NTB and d_buf is moved to the next
+ * slot for as long as another full-sized frame fits.  The NTB is submitted
+ * when it is full or when the TX poll or RX dispatch ends.
+ *
+ * When an OUT NTB arrives, bulk OUT is blocked and a worker passes each
+ * datagram of the NTB to the network in turn.  The datagram is copied into
+ * the next slot of an IN NTB so that the response, if any, is added to that
+ * NTB without another copy.  One IN request is always left for this
+ * purpose by the TX poll.  Bulk OUT is unblocked when all datagrams of the
+ * OUT NTB have been dispatched.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_putle16 and cdcncm_putle32
+ *
+ * Description:
+ *   Store little-endian values in unaligned NTB and descriptor fields.
+ *
+ ****************************************************************************/
+
+static inline void cdcncm_putle16(FAR uint8_t *dest, uint16_t value)
+{
+  dest[0] = LSBYTE(value);
+  dest[1] = MSBYTE(value);
+}
+
+static inline void cdcncm_putle32(FAR uint8_t *dest, uint32_t value)
+{
+  cdcncm_putle16(dest, (uint16_t)(value & 0xffff));
+  cdcncm_putle16(dest + 2, (uint16_t)(value >> 16));
+}
+
+/****************************************************************************
+ * Name: cdcncm_submit_rdreq
+ *
+ * Description:
+ *   Submits the bulk OUT read request unless the data interface is
+ *   inactive or the previous OUT NTB is still being dispatched.
+ *
+ * Input Parameters:
+ *   priv: pointer to CDC-NCM device driver structure
+ *
+ * Returned Value:
+ *   The return value of the EP_SUBMIT operation
+ *
+ ****************************************************************************/
+
+static int cdcncm_submit_rdreq(FAR struct cdcncm_dev_s *priv)
+{
+  irqstate_t flags = enter_critical_section();
+  int ret = OK;
+
+  if (priv->connected && !priv->rdreq_submitted && !priv->rx_blocked)
+    {
+      priv->rdreq->len = CONFIG_CDCNCM_NTB_OUTSIZE;
+      ret = EP_SUBMIT(priv->epbulkout, priv->rdreq);
+      if (ret != OK)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDSUBMIT),
+                   (uint16_t)-priv->rdreq->result);
+        }
+      else
+        {
+          priv->rdreq_submitted = true;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_allocwrreq
+ *
+ * Description:
+ *   Allocates a bulk IN endpoint request from the list of free requests.
+ *
+ * Assumptions:
+ *   Called from critical section
+ *
+ ****************************************************************************/
+
+static FAR struct cdcncm_req_s *
+  cdcncm_allocwrreq(FAR struct cdcncm_dev_s *priv)
+{
+  return (FAR struct cdcncm_req_s *)sq_remfirst(&priv->reqlist);
+}
+
+/****************************************************************************
+ * Name: cdcncm_hasfreereqs
+ *
+ * Description:
+ *   Checks if there are free requests usable for TX data.  The last free
+ *   request is kept for the responses to received datagrams.
+ *
+ * Assumptions:
+ *   Called from critical section
+ *
+ ****************************************************************************/
+
+static bool cdcncm_hasfreereqs(FAR struct cdcncm_dev_s *priv)
+{
+  return sq_count(&priv->reqlist) > 1;
+}
+
+/****************************************************************************
+ * Name: cdcncm_freewrreq
+ *
+ * Description:
+ *   Returns a bulk IN endpoint request to the list of free requests and
+ *   resumes the dispatch of an OUT NTB that waits for one.
+ *
+ * Assumptions:
+ *   Called from critical section
+ *
+ ****************************************************************************/
+
+static void cdcncm_freewrreq(FAR struct cdcncm_dev_s *priv,
+                             FAR struct cdcncm_req_s *req)
+{
+  DEBUGASSERT(req != NULL);
+  sq_addlast((FAR sq_entry_t *)req, &priv->reqlist);
+
+  if (priv->rx_pending && work_available(&priv->rxwork))
+    {
+      priv->rx_pending = false;
+      (void)work_queue(ETHWORK, &priv->rxwork, cdcncm_rxdispatch, priv, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_startntb
+ *
+ * Description:
+ *   Assigns a request to the network and starts a new IN NTB in it.
+ *
+ * Assumptions:
+ *   Called from critical section
+ *
+ ****************************************************************************/
+
+static void cdcncm_startntb(FAR struct cdcncm_dev_s *priv,
+                            FAR struct cdcncm_req_s *req)
+{
+  priv->net_req = req;
+  if (req != NULL)
+    {
+      priv->txoffset     = CDCNCM_DGRAM_OFFSET;
+      priv->txndgrams    = 0;
+      priv->netdev.d_buf = &req->req->buf[CDCNCM_DGRAM_OFFSET];
+      priv->netdev.d_len = CONFIG_NET_ETH_MTU;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_allocnetreq
+ *
+ * Description:
+ *   Allocates an IN NTB to be filled by the TX poll.
+ *
+ * Returned Value:
+ *   true if succeeded; false if failed
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static bool cdcncm_allocnetreq(FAR struct cdcncm_dev_s *priv)
+{
+  irqstate_t flags = enter_critical_section();
+
+  DEBUGASSERT(priv->net_req == NULL);
+
+  if (cdcncm_hasfreereqs(priv))
+    {
+      cdcncm_startntb(priv, cdcncm_allocwrreq(priv));
+    }
+
+  leave_critical_section(flags);
+  return priv->net_req != NULL;
+}
+
+/****************************************************************************
+ * Name: cdcncm_allocrxnetreq
+ *
+ * Description:
+ *   Allocates an IN NTB for the datagrams of an OUT NTB and their
+ *   responses.  If no request is free, the dispatch is resumed when a
+ *   request is returned.
+ *
+ * Returned Value:
+ *   true if succeeded; false if failed
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static bool cdcncm_allocrxnetreq(FAR struct cdcncm_dev_s *priv)
+{
+  irqstate_t flags = enter_critical_section();
+
+  DEBUGASSERT(priv->net_req == NULL);
+
+  cdcncm_startntb(priv, cdcncm_allocwrreq(priv));
+  if (priv->net_req == NULL)
+    {
+      priv->rx_pending = true;
+    }
+
+  leave_critical_section(flags);
+  return priv->net_req != NULL;
+}
+
+/****************************************************************************
+ * Name: cdcncm_sendnetreq
+ *
+ * Description:
+ *   Completes the NTH16 and NDP16 of the IN NTB held by the network and
+ *   submits it.
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void cdcncm_sendnetreq(FAR struct cdcncm_dev_s *priv)
+{
+  FAR struct usbdev_req_s *req;
+  FAR struct cdc_ncm_nth16_s *nth;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR struct cdc_ncm_dpe16_s *dpe;
+  irqstate_t flags;
+
+  DEBUGASSERT(priv->net_req != NULL && priv->txndgrams > 0);
+
+  req = priv->net_req->req;
+  nth = (FAR struct cdc_ncm_nth16_s *)req->buf;
+  ndp = (FAR struct cdc_ncm_ndp16_s *)&req->buf[CDCNCM_NDP_OFFSET];
+  dpe = (FAR struct cdc_ncm_dpe16_s *)
+        &req->buf[CDCNCM_NDP_OFFSET + SIZEOF_NCM_NDP16(priv->txndgrams)];
+
+  cdcncm_putle32(nth->signature, NCM_NTH16_SIGNATURE);
+  cdcncm_putle16(nth->hdrlen, SIZEOF_NCM_NTH16);
+  cdcncm_putle16(nth->sequence, priv->txseq++);
+  cdcncm_putle16(nth->blocklen, priv->txoffset);
+  cdcncm_putle16(nth->ndpindex, CDCNCM_NDP_OFFSET);
+
+  cdcncm_putle32(ndp->signature, NCM_NDP16_SIGNATURE);
+  cdcncm_putle16(ndp->len, SIZEOF_NCM_NDP16(priv->txndgrams + 1));
+  cdcncm_putle16(ndp->nextndp, 0);
+
+  /* Terminate the datagram pointer table */
+
+  memset(dpe, 0, sizeof(struct cdc_ncm_dpe16_s));
+
+  /* A transfer shorter than the NTB size that the host expects ends with
+   * a short packet.
+   */
+
+  req->len   = priv->txoffset;
+  req->flags = priv->txoffset < priv->ntbinsize ?
+               USBDEV_REQFLAGS_NULLPKT : 0;
+  req->priv  = priv->net_req;
+
+  flags = enter_critical_section();
+  EP_SUBMIT(priv->epbulkin, req);
+
+  priv->net_req      = NULL;
+  priv->netdev.d_buf = NULL;
+  priv->netdev.d_len = 0;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cdcncm_flushnetreq
+ *
+ * Description:
+ *   Submits the IN NTB held by the network if it holds any datagrams;
+ *   frees it otherwise.
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void cdcncm_flushnetreq(FAR struct cdcncm_dev_s *priv)
+{
+  irqstate_t flags;
+
+  if (priv->net_req != NULL)
+    {
+      if (priv->txndgrams > 0)
+        {
+          cdcncm_sendnetreq(priv);
+        }
+      else
+        {
+          flags = enter_critical_section();
+          cdcncm_freewrreq(priv, priv->net_req);
+          priv->net_req      = NULL;
+          priv->netdev.d_buf = NULL;
+          priv->netdev.d_len = 0;
+          leave_critical_section(flags);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit
+ *
+ * Description:
+ *   Adds the packet in the network buffer to the IN NTB.  The NTB is
+ *   submitted if another full-sized packet would not fit; otherwise the
+ *   network buffer is moved to the next datagram slot.
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void cdcncm_transmit(FAR struct cdcncm_dev_s *priv)
+{
+  FAR uint8_t *buf = priv->net_req->req->buf;
+  FAR struct cdc_ncm_dpe16_s *dpe;
+  uint32_t maxlen;
+
+  dpe = (FAR struct cdc_ncm_dpe16_s *)
+        &buf[CDCNCM_NDP_OFFSET + SIZEOF_NCM_NDP16(priv->txndgrams)];
+
+  cdcncm_putle16(dpe->index, priv->txoffset);
+  cdcncm_putle16(dpe->len, priv->netdev.d_len);
+
+  priv->txndgrams++;
+  priv->txoffset = CDCNCM_ALIGN(priv->txoffset + priv->netdev.d_len);
+
+  maxlen = min(CONFIG_CDCNCM_NTB_INSIZE, priv->ntbinsize);
+  if (priv->txndgrams < CONFIG_CDCNCM_NDATAGRAMS &&
+      priv->txoffset + CONFIG_NET_ETH_MTU <= maxlen)
+    {
+      priv->netdev.d_buf = &buf[priv->txoffset];
+      priv->netdev.d_len = CONFIG_NET_ETH_MTU;
+    }
+  else
+    {
+      cdcncm_sendnetreq(priv);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_receive
+ *
+ * Description:
+ *   Passes the datagram in the network buffer to the network and adds the
+ *   response, if any, to the IN NTB.
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void cdcncm_receive(FAR struct cdcncm_dev_s *priv)
+{
+  FAR struct eth_hdr_s *hdr = (FAR struct eth_hdr_s *)priv->netdev.d_buf;
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (hdr->type == HTONS(ETHTYPE_IP))
+    {
+      NETDEV_RXIPV4(&priv->netdev);
+
+      /* Handle ARP on input then give the IPv4 packet to the network
+       * layer
+       */
+
+      arp_ipin(&priv->netdev);
+      ipv4_input(&priv->netdev);
+
+      if (priv->netdev.d_len > 0)
+        {
+          /* Update the Ethernet header with the correct MAC address */
+
+#ifdef CONFIG_NET_IPv6
+          if (IFF_IS_IPv4(priv->netdev.d_flags))
+#endif
+            {
+              arp_out(&priv->netdev);
+            }
+#ifdef CONFIG_NET_IPv6
+          else
+            {
+              neighbor_out(&priv->netdev);
+            }
+#endif
+
+          /* And send the packet */
+
+          cdcncm_transmit(priv);
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (hdr->type == HTONS(ETHTYPE_IP6))
+    {
+      NETDEV_RXIPV6(&priv->netdev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(&priv->netdev);
+
+      if (priv->netdev.d_len > 0)
+        {
+          /* Update the Ethernet header with the correct MAC address */
+
+#ifdef CONFIG_NET_IPv4
+          if (IFF_IS_IPv4(priv->netdev.d_flags))
+            {
+              arp_out(&priv->netdev);
+            }
+          else
+#endif
+            {
+              neighbor_out(&priv->netdev);
+            }
+
+          /* And send the packet */
+
+          cdcncm_transmit(priv);
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (hdr->type == HTONS(ETHTYPE_ARP))
+    {
+      NETDEV_RXARP(&priv->netdev);
+
+      arp_arpin(&priv->netdev);
+
+      if (priv->netdev.d_len > 0)
+        {
+          cdcncm_transmit(priv);
+        }
+    }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(&priv->netdev);
+      priv->netdev.d_len = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_rxdispatch
+ *
+ * Description:
+ *   Worker that passes the datagrams of an OUT NTB to the network.  If no
+ *   IN request is free for the responses, the position in the NTB is kept
+ *   and the worker is queued again when a request is returned.
+ *
+ * Input Parameters:
+ *   arg: pointer to CDC-NCM device driver structure
+ *
+ ****************************************************************************/
+
+static void cdcncm_rxdispatch(FAR void *arg)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)arg;
+  FAR uint8_t *buf = priv->rdreq->buf;
+  FAR struct cdc_ncm_nth16_s *nth;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR struct cdc_ncm_dpe16_s *dpe;
+  irqstate_t flags;
+  uint16_t ndplen;
+  uint16_t nextndp;
+  uint16_t index;
+  uint16_t len;
+
+  net_lock();
+
+  /* Discard the NTB if the data interface was deactivated meanwhile */
+
+  if (!priv->connected)
+    {
+      goto done;
+    }
+
+  /* Validate the NTH16 unless this continues a partly dispatched NTB */
+
+  if (priv->rxndp == 0)
+    {
+      nth = (FAR struct cdc_ncm_nth16_s *)buf;
+      len = GETUINT16(nth->blocklen);
+
+      if (GETUINT32(nth->signature) != NCM_NTH16_SIGNATURE ||
+          GETUINT16(nth->hdrlen) != SIZEOF_NCM_NTH16 ||
+          len > priv->rxlen)
+        {
+          uerr("ERROR: Bad NTH16\n");
+          NETDEV_RXERRORS(&priv->netdev);
+          goto done;
+        }
+
+      priv->rxlen = len;
+      priv->rxndp = GETUINT16(nth->ndpindex);
+      priv->rxdpe = 0;
+    }
+
+  /* Walk the chain of NDP16s */
+
+  while (priv->rxndp != 0)
+    {
+      if (priv->rxndp < SIZEOF_NCM_NTH16 || (priv->rxndp & 3) != 0 ||
+          priv->rxndp + SIZEOF_NCM_NDP16(2) > priv->rxlen)
+        {
+          uerr("ERROR: Bad NDP16 index %u\n", priv->rxndp);
+          NETDEV_RXERRORS(&priv->netdev);
+          goto done;
+        }
+
+      ndp    = (FAR struct cdc_ncm_ndp16_s *)&buf[priv->rxndp];
+      ndplen = GETUINT16(ndp->len);
+
+      if (GETUINT32(ndp->signature) != NCM_NDP16_SIGNATURE ||
+          ndplen < SIZEOF_NCM_NDP16(2) ||
+          priv->rxndp + ndplen > priv->rxlen)
+        {
+          uerr("ERROR: Bad NDP16\n");
+          NETDEV_RXERRORS(&priv->netdev);
+          goto done;
+        }
+
+      for (; priv->rxdpe < (ndplen - SIZEOF_NCM_NDP16(0)) / 4;
+           priv->rxdpe++)
+        {
+          dpe   = (FAR struct cdc_ncm_dpe16_s *)
+                  &buf[priv->rxndp + SIZEOF_NCM_NDP16(priv->rxdpe)];
+          index = GETUINT16(dpe->index);
+          len   = GETUINT16(dpe->len);
+
+          if (index == 0 || len == 0)
+            {
+              break;
+            }
+
+          if ((uint32_t)index + len > priv->rxlen ||
+              len <= ETH_HDRLEN || len > CONFIG_NET_ETH_MTU)
+            {
+              uerr("ERROR: Bad datagram dropped (%u)\n", len);
+              NETDEV_RXERRORS(&priv->netdev);
+              continue;
+            }
+
+          /* Copy the datagram into the next slot of the IN NTB so that
+           * the response can be sent from there.
+           */
+
+          if (priv->net_req == NULL && !cdcncm_allocrxnetreq(priv))
+            {
+              net_unlock();
+              return;
+            }
+
+          memcpy(priv->netdev.d_buf, &buf[index], len);
+          priv->netdev.d_len = len;
+          cdcncm_receive(priv);
+        }
+
+      /* The NDP16s must be in increasing order; this bounds the walk */
+
+      nextndp = GETUINT16(ndp->nextndp);
+      if (nextndp != 0 && nextndp <= priv->rxndp)
+        {
+          uerr("ERROR: Bad next NDP16 index %u\n", nextndp);
+          NETDEV_RXERRORS(&priv->netdev);
+          goto done;
+        }
+
+      priv->rxndp = nextndp;
+      priv->rxdpe = 0;
+    }
+
+done:
+  priv->rxndp = 0;
+  priv->rxdpe = 0;
+
+  cdcncm_flushnetreq(priv);
+
+  flags = enter_critical_section();
+  priv->rx_blocked = false;
+  cdcncm_submit_rdreq(priv);
+  leave_critical_section(flags);
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_txpoll
+ *
+ * Description:
+ *   Adds the packet that is stored in the network packet buffer to the IN
+ *   NTB. Called from work queue by e.g. txavail and txpoll callbacks.
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static int cdcncm_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)dev->d_private;
+
+  if (!priv->connected)
+    {
+      return -EBUSY;
+    }
+
+  /* If the polling resulted in data that should be sent out on the network,
+   * the field d_len is set to a value > 0.
+   */
+
+  if (priv->netdev.d_len > 0)
+    {
+      /* Look up the destination MAC address and add it to the Ethernet
+       * header.
+       */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(priv->netdev.d_flags))
+#endif
+        {
+          arp_out(&priv->netdev);
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          neighbor_out(&priv->netdev);
+        }
+#endif /* CONFIG_NET_IPv6 */
+
+      cdcncm_transmit(priv);
+
+      /* Stop the poll if the NTB was sent and no other one is free */
+
+      if (priv->net_req == NULL && !cdcncm_allocnetreq(priv))
+        {
+          return -EBUSY;
+        }
+    }
+
+  /* If zero is returned, the polling will continue until all connections
+   * have been examined.
+   */
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_pollworker
+ *
+ * Description:
+ *   Worker function called by txpoll worker.
+ *
+ ****************************************************************************/
+
+static void cdcncm_pollworker(FAR void *arg)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)arg;
+
+  DEBUGASSERT(priv != NULL);
+
+  net_lock();
+
+  if (cdcncm_allocnetreq(priv))
+    {
+      devif_timer(&priv->netdev, cdcncm_txpoll);
+      cdcncm_flushnetreq(priv);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_polltimer
+ *
+ * Description:
+ *   Network poll watchdog timer callback
+ *
+ ****************************************************************************/
+
+static void cdcncm_polltimer(int argc, uint32_t arg, ...)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)arg;
+  int ret;
+
+  if (work_available(&priv->pollwork))
+    {
+      ret = work_queue(ETHWORK, &priv->pollwork, cdcncm_pollworker,
+                       (FAR void *)priv, 0);
+      DEBUGASSERT(ret == OK);
+      UNUSED(ret);
+    }
+
+  /* Setup the watchdog poll timer again */
+
+  (void)wd_start(priv->txpoll, CDCNCM_WDDELAY, cdcncm_polltimer, 1,
+                 (wdparm_t)arg);
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifup
+ *
+ * Description:
+ *   Network ifup callback
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifup(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)dev->d_private;
+
+  (void)wd_start(priv->txpoll, CDCNCM_WDDELAY, cdcncm_polltimer,
+                 1, (wdparm_t)priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifdown
+ *
+ * Description:
+ *   Network ifdown callback
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifdown(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)dev->d_private;
+
+  wd_cancel(priv->txpoll);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_txavail_work
+ *
+ * Description:
+ *   txavail worker function
+ *
+ ****************************************************************************/
+
+static void cdcncm_txavail_work(FAR void *arg)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)arg;
+
+  net_lock();
+
+  if (priv->connected && cdcncm_allocnetreq(priv))
+    {
+      devif_poll(&priv->netdev, cdcncm_txpoll);
+      cdcncm_flushnetreq(priv);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: cdcncm_txavail
+ *
+ * Description:
+ *   Network txavail callback that's called when there are buffers available
+ *   for sending data. May be called from an interrupt, so we must queue a
+ *   worker to do the actual processing.
+ *
+ ****************************************************************************/
+
+static int cdcncm_txavail(FAR struct net_driver_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)dev->d_private;
+
+  if (work_available(&priv->pollwork))
+    {
+      work_queue(ETHWORK, &priv->pollwork, cdcncm_txavail_work, priv, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_notify
+ *
+ * Description:
+ *   Sends the next pending notification on the interrupt IN endpoint:  The
+ *   connection speed followed by the connection state.
+ *
+ * Assumptions:
+ *   Called from critical section
+ *
+ ****************************************************************************/
+
+static void cdcncm_notify(FAR struct cdcncm_dev_s *priv)
+{
+  FAR struct usbdev_req_s *req = priv->epintin_req;
+  FAR struct cdc_notification_s *notif =
+    (FAR struct cdc_notification_s *)req->buf;
+  FAR struct cdc_speedchange_s *speed;
+  uint32_t bitrate;
+
+  notif->type = USB_DIR_IN | USB_REQ_TYPE_CLASS |
+                USB_REQ_RECIPIENT_INTERFACE;
+  cdcncm_putle16(notif->index, CDCNCM_COMMIFID);
+
+  switch (priv->notify)
+    {
+      case CDCNCM_NOTIFY_SPEED:
+        bitrate = priv->usbdev->speed == USB_SPEED_HIGH ?
+                  480000000 : 12000000;
+        speed   = (FAR struct cdc_speedchange_s *)notif->data;
+
+        notif->notification = NCM_SPEED_CHANGE;
+        cdcncm_putle16(notif->value, 0);
+        cdcncm_putle16(notif->len, sizeof(struct cdc_speedchange_s));
+        cdcncm_putle32(speed->us, bitrate);
+        cdcncm_putle32(speed->ds, bitrate);
+
+        req->len     = CDCNCM_NOTIFY_LEN;
+        priv->notify = CDCNCM_NOTIFY_CONNECT;
+        break;
+
+      case CDCNCM_NOTIFY_CONNECT:
+        notif->notification = NCM_NETWORK_CONNECTION;
+        cdcncm_putle16(notif->value, priv->connected ? 1 : 0);
+        cdcncm_putle16(notif->len, 0);
+
+        req->len     = SIZEOF_NOTIFICATION_S(0);
+        priv->notify = CDCNCM_NOTIFY_NONE;
+        break;
+
+      default:
+        return;
+    }
+
+  EP_SUBMIT(priv->epintin, req);
+}
+
+/****************************************************************************
+ * Name: cdcncm_rdcomplete
+ *
+ * Description:
+ *   Handle completion of read request on the bulk OUT endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_dev_s *priv;
+  irqstate_t flags;
+  int ret;
+
+  /* Sanity check */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!ep || !ep->priv || !req)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Extract references to private data */
+
+  priv = (FAR struct cdcncm_dev_s *)ep->priv;
+
+  flags = enter_critical_section();
+  priv->rdreq_submitted = false;
+
+  switch (req->result)
+    {
+    case 0: /* Normal completion */
+      if (priv->connected && req->xfrd >= SIZEOF_NCM_NTH16)
+        {
+          /* Block bulk OUT until all datagrams of the NTB have been
+           * passed to the network.
+           */
+
+          priv->rxlen      = req->xfrd;
+          priv->rx_blocked = true;
+
+          DEBUGASSERT(work_available(&priv->rxwork));
+          ret = work_queue(ETHWORK, &priv->rxwork, cdcncm_rxdispatch,
+                           priv, 0);
+          DEBUGASSERT(ret == 0);
+          UNUSED(ret);
+
+          leave_critical_section(flags);
+          return;
+        }
+      break;
+
+    case -ESHUTDOWN: /* Disconnection */
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDSHUTDOWN), 0);
+      leave_critical_section(flags);
+      return;
+
+    default: /* Some other error occurred */
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDUNEXPECTED),
+               (uint16_t)-req->result);
+      break;
+    };
+
+  cdcncm_submit_rdreq(priv);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cdcncm_wrcomplete
+ *
+ * Description:
+ *   Handle completion of write request.  This function probably executes
+ *   in the context of an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_dev_s *priv;
+  FAR struct cdcncm_req_s *reqcontainer;
+  irqstate_t flags;
+
+  /* Sanity check */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!ep || !ep->priv || !req || !req->priv)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Extract references to our private data */
+
+  priv         = (FAR struct cdcncm_dev_s *)ep->priv;
+  reqcontainer = (FAR struct cdcncm_req_s *)req->priv;
+
+  /* Return the write request to the free list */
+
+  flags = enter_critical_section();
+  cdcncm_freewrreq(priv, reqcontainer);
+  if (cdcncm_hasfreereqs(priv))
+    {
+      cdcncm_txavail(&priv->netdev);
+    }
+
+  switch (req->result)
+    {
+    case OK: /* Normal completion */
+    case -ESHUTDOWN: /* Disconnection */
+      break;
+
+    default: /* Some other error occurred */
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_WRUNEXPECTED),
+               (uint16_t)-req->result);
+      NETDEV_TXERRORS(&priv->netdev);
+      break;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: usbclass_ep0incomplete
+ *
+ * Description:
+ *   Handle completion of EP0 control operations
+ *
+ ****************************************************************************/
+
+static void usbclass_ep0incomplete(FAR struct usbdev_ep_s *ep,
+                                   FAR struct usbdev_req_s *req)
+{
+  if (req->result || req->xfrd != req->len)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_REQRESULT),
+               (uint16_t)-req->result);
+    }
+}
+
+/****************************************************************************
+ * Name: usbclass_epintin_complete
+ *
+ * Description:
+ *   Handle completion of interrupt IN endpoint operations
+ *
+ ****************************************************************************/
+
+static void usbclass_epintin_complete(FAR struct usbdev_ep_s *ep,
+                                      FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_dev_s *priv = (FAR struct cdcncm_dev_s *)ep->priv;
+  irqstate_t flags;
+
+  if (req->result || req->xfrd != req->len)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_REQRESULT),
+               (uint16_t)-req->result);
+    }
+
+  if (req->result != -ESHUTDOWN)
+    {
+      flags = enter_critical_section();
+      cdcncm_notify(priv);
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: usbclass_freereq
+ *
+ * Description:
+ *   Free a request instance along with its buffer
+ *
+ ****************************************************************************/
+
+static void usbclass_freereq(FAR struct usbdev_ep_s *ep,
+                             FAR struct usbdev_req_s *req)
+{
+  if (ep != NULL && req != NULL)
+    {
+      if (req->buf != NULL)
+        {
+          EP_FREEBUFFER(ep, req->buf);
+        }
+
+      EP_FREEREQ(ep, req);
+    }
+}
+
+/****************************************************************************
+ * Name: usbclass_allocreq
+ *
+ * Description:
+ *   Allocate a request instance along with its buffer
+ *
+ ****************************************************************************/
+
+static FAR struct usbdev_req_s *usbclass_allocreq(FAR struct usbdev_ep_s *ep,
+                                                  uint16_t len)
+{
+  FAR struct usbdev_req_s *req;
+
+  req = EP_ALLOCREQ(ep);
+  if (req != NULL)
+    {
+      req->len = len;
+      req->buf = EP_ALLOCBUFFER(ep, len);
+
+      if (req->buf == NULL)
+        {
+          EP_FREEREQ(ep, req);
+          req = NULL;
+        }
+    }
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: usbclass_mkstrdesc
+ *
+ * Description:
+ *   Construct a string descriptor
+ *
+ ****************************************************************************/
+
+static int usbclass_mkstrdesc(FAR struct cdcncm_dev_s *priv, uint8_t id,
+                              FAR struct usb_strdesc_s *strdesc)
+{
+  static const char hexdigits[] = "0123456789ABCDEF";
+  FAR const char *str;
+  char macstr[13];
+  int len;
+  int ndata;
+  int i;
+
+  switch (id)
+    {
+      case 0:
+        {
+          /* Descriptor 0 is the language id */
+
+          strdesc->len     = 4;
+          strdesc->type    = USB_DESC_TYPE_STRING;
+          strdesc->data[0] = LSBYTE(CDCNCM_STR_LANGUAGE);
+          strdesc->data[1] = MSBYTE(CDCNCM_STR_LANGUAGE);
+          return 4;
+        }
+
+      case CDCNCM_MANUFACTURERSTRID:
+        str = CONFIG_CDCNCM_VENDORSTR;
+        break;
+
+      case CDCNCM_PRODUCTSTRID:
+        str = CONFIG_CDCNCM_PRODUCTSTR;
+        break;
+
+      case CDCNCM_SERIALSTRID:
+        str = CDCNCM_SERIALSTR;
+        break;
+
+      case CDCNCM_MACSTRID:
+        {
+          /* The host side MAC address as 12 hexadecimal digits */
+
+          for (i = 0; i < 6; i++)
+            {
+              macstr[2 * i]     = hexdigits[priv->host_mac_address[i] >> 4];
+              macstr[2 * i + 1] = hexdigits[priv->host_mac_address[i] & 15];
+            }
+
+          macstr[12] = '\0';
+          str = macstr;
+        }
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  /* The string is utf16-le.  The poor man's utf-8 to utf16-le
+   * conversion below will only handle 7-bit en-us ascii
+   */
+
+  len = strlen(str);
+  if (len > (CDCNCM_MAXSTRLEN / 2))
+    {
+      len = (CDCNCM_MAXSTRLEN / 2);
+    }
+
+  for (i = 0, ndata = 0; i < len; i++, ndata += 2)
+    {
+      strdesc->data[ndata]   = str[i];
+      strdesc->data[ndata+1] = 0;
+    }
+
+  strdesc->len  = ndata+2;
+  strdesc->type = USB_DESC_TYPE_STRING;
+  return strdesc->len;
+}
+
+/****************************************************************************
+ * Name: usbclass_mkcfgdesc
+ *
+ * Description:
+ *   Construct the configuration descriptor
+ *
+ ****************************************************************************/
+
+static int16_t usbclass_mkcfgdesc(FAR uint8_t *buf)
+{
+  FAR struct usb_cfgdesc_s *cfgdesc = (FAR struct usb_cfgdesc_s *)buf;
+  uint16_t totallen;
+
+  totallen = sizeof(g_cdcncm_cfgdesc);
+  memcpy(cfgdesc, &g_cdcncm_cfgdesc, totallen);
+
+  /* Fill in the total size of the configuration descriptor */
+
+  cfgdesc->totallen[0] = LSBYTE(totallen);
+  cfgdesc->totallen[1] = MSBYTE(totallen);
+  return totallen;
+}
+
+/****************************************************************************
+ * Name: usbclass_mkntbparms
+ *
+ * Description:
+ *   Construct the response to GET_NTB_PARAMETERS
+ *
+ ****************************************************************************/
+
+static int usbclass_mkntbparms(FAR uint8_t *buf)
+{
+  FAR struct cdc_ncm_ntbparms_s *parms = (FAR struct cdc_ncm_ntbparms_s *)buf;
+
+  memset(parms, 0, SIZEOF_NCM_NTBPARMS);
+  cdcncm_putle16(parms->len, SIZEOF_NCM_NTBPARMS);
+  cdcncm_putle16(parms->formats, 0x0001);  /* NTB16 only */
+  cdcncm_putle32(parms->inmaxsize, CONFIG_CDCNCM_NTB_INSIZE);
+  cdcncm_putle16(parms->indivisor, 4);
+  cdcncm_putle16(parms->inalign, 4);
+  cdcncm_putle32(parms->outmaxsize, CONFIG_CDCNCM_NTB_OUTSIZE);
+  cdcncm_putle16(parms->outdivisor, 4);
+  cdcncm_putle16(parms->outalign, 4);
+  return SIZEOF_NCM_NTBPARMS;
+}
+
+/****************************************************************************
+ * Name: usbclass_resetdata
+ *
+ * Description:
+ *   Select the alternate setting of the data interface without endpoints.
+ *
+ ****************************************************************************/
+
+static void usbclass_resetdata(FAR struct cdcncm_dev_s *priv)
+{
+  if (priv->connected)
+    {
+      priv->connected = false;
+
+      /* Disable endpoints.  This should force completion of all pending
+       * transfers.
+       */
+
+      EP_DISABLE(priv->epbulkin);
+      EP_DISABLE(priv->epbulkout);
+    }
+}
+
+/****************************************************************************
+ * Name: usbclass_setinterface
+ *
+ * Description:
+ *   Select an alternate setting of the data interface.  Alternate setting
+ *   1 enables the bulk endpoints and reports the connection to the host.
+ *
+ ****************************************************************************/
+
+static int usbclass_setinterface(FAR struct cdcncm_dev_s *priv,
+                                 uint16_t alt)
+{
+  int ret;
+
+  if (priv->config == CDCNCM_CONFIGIDNONE || alt > 1)
+    {
+      return -EINVAL;
+    }
+
+  usbclass_resetdata(priv);
+
+  if (alt == 0)
+    {
+      return OK;
+    }
+
+  /* Configure the IN bulk endpoint */
+
+  ret = EP_CONFIGURE(priv->epbulkin, &g_cdcncm_cfgdesc.epbulkindesc, false);
+  if (ret < 0)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPBULKINCONFIGFAIL), 0);
+      return ret;
+    }
+
+  priv->epbulkin->priv = priv;
+
+  /* Configure the OUT bulk endpoint */
+
+  ret = EP_CONFIGURE(priv->epbulkout, &g_cdcncm_cfgdesc.epbulkoutdesc,
+                     true);
+  if (ret < 0)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPBULKOUTCONFIGFAIL), 0);
+      EP_DISABLE(priv->epbulkin);
+      return ret;
+    }
+
+  priv->epbulkout->priv = priv;
+  priv->connected       = true;
+
+  /* Queue the read request on the bulk OUT endpoint */
+
+  ret = cdcncm_submit_rdreq(priv);
+  if (ret != OK)
+    {
+      usbclass_resetdata(priv);
+      return ret;
+    }
+
+  /* Report the connection to the host */
+
+  priv->notify = CDCNCM_NOTIFY_SPEED;
+  cdcncm_notify(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usbclass_bind
+ *
+ * Description:
+ *   Invoked when the driver is bound to a USB device driver
+ *
+ ****************************************************************************/
+
+static int usbclass_bind(FAR struct usbdevclass_driver_s *driver,
+                         FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv = ((FAR struct cdcncm_driver_s *)driver)->dev;
+  FAR struct cdcncm_req_s *reqcontainer;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  usbtrace(TRACE_CLASSBIND, 0);
+
+  /* Bind the structures */
+
+  priv->usbdev   = dev;
+  dev->ep0->priv = priv;
+
+  /* Preallocate control request */
+
+  priv->ctrlreq = usbclass_allocreq(dev->ep0, CDCNCM_CTRLREQ_LEN);
+  if (priv->ctrlreq == NULL)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_ALLOCCTRLREQ), 0);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  priv->ctrlreq->callback = usbclass_ep0incomplete;
+
+  /* Pre-allocate all endpoints... the endpoints will not be functional
+   * until the SET CONFIGURATION and SET INTERFACE requests are processed.
+   * This is done here because there may be calls to kmm_malloc and the
+   * SET CONFIGURATION processing probably occurrs within interrupt
+   * handling logic where kmm_malloc calls will fail.
+   */
+
+  priv->epintin = DEV_ALLOCEP(dev, CDCNCM_EPINTIN_ADDR, true,
+                              USB_EP_ATTR_XFER_INT);
+  if (!priv->epintin)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPINTINALLOCFAIL), 0);
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  priv->epintin->priv = priv;
+
+  priv->epintin_req = usbclass_allocreq(priv->epintin, CDCNCM_NOTIFY_LEN);
+  if (priv->epintin_req == NULL)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDALLOCREQ), -ENOMEM);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  priv->epintin_req->callback = usbclass_epintin_complete;
+
+  priv->epbulkin = DEV_ALLOCEP(dev, CDCNCM_EPBULKIN_ADDR, true,
+                               USB_EP_ATTR_XFER_BULK);
+  if (!priv->epbulkin)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPBULKINALLOCFAIL), 0);
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  priv->epbulkin->priv = priv;
+
+  priv->epbulkout = DEV_ALLOCEP(dev, CDCNCM_EPBULKOUT_ADDR, false,
+                                USB_EP_ATTR_XFER_BULK);
+  if (!priv->epbulkout)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPBULKOUTALLOCFAIL), 0);
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  priv->epbulkout->priv = priv;
+
+  /* Pre-allocate the read request.  The buffer holds one OUT NTB. */
+
+  priv->rdreq = usbclass_allocreq(priv->epbulkout,
+                                  CONFIG_CDCNCM_NTB_OUTSIZE);
+  if (priv->rdreq == NULL)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDALLOCREQ), -ENOMEM);
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  priv->rdreq->callback = cdcncm_rdcomplete;
+
+  /* Pre-allocate write request containers and put in a free list.  Each
+   * buffer holds one IN NTB.
+   */
+
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
+    {
+      reqcontainer      = &priv->wrreqs[i];
+      reqcontainer->req = usbclass_allocreq(priv->epbulkin,
+                                            CONFIG_CDCNCM_NTB_INSIZE);
+      if (reqcontainer->req == NULL)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_WRALLOCREQ), -ENOMEM);
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      reqcontainer->req->priv     = reqcontainer;
+      reqcontainer->req->callback = cdcncm_wrcomplete;
+
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)reqcontainer, &priv->reqlist);
+      leave_critical_section(flags);
+    }
+
+  /* Report if we are selfpowered */
+
+#ifdef CONFIG_USBDEV_SELFPOWERED
+  DEV_SETSELFPOWERED(dev);
+#endif
+
+  /* And pull-up the data line for the soft connect function */
+
+  DEV_CONNECT(dev);
+  return OK;
+
+errout:
+  usbclass_unbind(driver, dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usbclass_unbind
+ *
+ * Description:
+ *    Invoked when the driver is unbound from a USB device driver
+ *
+ ****************************************************************************/
+
+static void usbclass_unbind(FAR struct usbdevclass_driver_s *driver,
+                            FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv;
+  FAR struct cdcncm_req_s *reqcontainer;
+  irqstate_t flags;
+
+  usbtrace(TRACE_CLASSUNBIND, 0);
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!driver || !dev || !dev->ep0)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Extract reference to private data */
+
+  priv = ((FAR struct cdcncm_driver_s *)driver)->dev;
+  if (priv == NULL)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EP0NOTBOUND), 0);
+      return;
+    }
+
+  /* Make sure that the endpoints have been unconfigured.  If we were
+   * terminated gracefully, then the configuration should already have been
+   * reset.  If not, then calling usbclass_resetconfig should cause the
+   * endpoints to immediately terminate all transfers and return the
+   * requests to us (with result == -ESHUTDOWN)
+   */
+
+  usbclass_resetconfig(priv);
+  up_mdelay(50);
+
+  /* Free the pre-allocated requests */
+
+  if (priv->ctrlreq != NULL)
+    {
+      usbclass_freereq(dev->ep0, priv->ctrlreq);
+      priv->ctrlreq = NULL;
+    }
+
+  if (priv->epintin_req != NULL)
+    {
+      usbclass_freereq(priv->epintin, priv->epintin_req);
+      priv->epintin_req = NULL;
+    }
+
+  if (priv->rdreq != NULL)
+    {
+      usbclass_freereq(priv->epbulkout, priv->rdreq);
+      priv->rdreq = NULL;
+    }
+
+  /* Free write requests that are not in use (which should be all of them) */
+
+  flags = enter_critical_section();
+  while (!sq_empty(&priv->reqlist))
+    {
+      reqcontainer = (FAR struct cdcncm_req_s *)sq_remfirst(&priv->reqlist);
+      if (reqcontainer->req != NULL)
+        {
+          usbclass_freereq(priv->epbulkin, reqcontainer->req);
+          reqcontainer->req = NULL;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* Free the endpoints */
+
+  if (priv->epintin)
+    {
+      DEV_FREEEP(dev, priv->epintin);
+      priv->epintin = NULL;
+    }
+
+  if (priv->epbulkin)
+    {
+      DEV_FREEEP(dev, priv->epbulkin);
+      priv->epbulkin = NULL;
+    }
+
+  if (priv->epbulkout)
+    {
+      DEV_FREEEP(dev, priv->epbulkout);
+      priv->epbulkout = NULL;
+    }
+
+  netdev_unregister(&priv->netdev);
+}
+
+/****************************************************************************
+ * Name: usbclass_setup
+ *
+ * Description:
+ *   Invoked for ep0 control requests.  This function probably executes
+ *   in the context of an interrupt handler.
+ *
+ ****************************************************************************/
+
+static int usbclass_setup(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev,
+                          FAR const struct usb_ctrlreq_s *ctrl,
+                          FAR uint8_t *dataout, size_t outlen)
+{
+  FAR struct cdcncm_dev_s *priv;
+  FAR struct usbdev_req_s *ctrlreq;
+  uint32_t size;
+  uint16_t value;
+  uint16_t index;
+  uint16_t len;
+  int ret = -EOPNOTSUPP;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!driver || !dev || !dev->ep0 || !ctrl)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return -EIO;
+    }
+#endif
+
+  /* Extract reference to private data */
+
+  usbtrace(TRACE_CLASSSETUP, ctrl->req);
+  priv = ((FAR struct cdcncm_driver_s *)driver)->dev;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!priv || !priv->ctrlreq)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EP0NOTBOUND), 0);
+      return -ENODEV;
+    }
+#endif
+
+  ctrlreq = priv->ctrlreq;
+
+  /* Extract the little-endian 16-bit values to host order */
+
+  value = GETUINT16(ctrl->value);
+  index = GETUINT16(ctrl->index);
+  len   = GETUINT16(ctrl->len);
+
+  uinfo("type=%02x req=%02x value=%04x index=%04x len=%04x\n",
+        ctrl->type, ctrl->req, value, index, len);
+
+  switch (ctrl->type & USB_REQ_TYPE_MASK)
+    {
+     /***********************************************************************
+      * Standard Requests
+      ***********************************************************************/
+
+    case USB_REQ_TYPE_STANDARD:
+      {
+        switch (ctrl->req)
+          {
+          case USB_REQ_GETDESCRIPTOR:
+            {
+              /* The value field specifies the descriptor type in the MS
+               * byte and the descriptor index in the LS byte
+               */
+
+              switch (ctrl->value[1])
+                {
+                case USB_DESC_TYPE_DEVICE:
+                  {
+                    ret = USB_SIZEOF_DEVDESC;
+                    memcpy(ctrlreq->buf, &g_devdesc, ret);
+                  }
+                  break;
+
+                case USB_DESC_TYPE_CONFIG:
+                  {
+                    ret = usbclass_mkcfgdesc(ctrlreq->buf);
+                  }
+                  break;
+
+                case USB_DESC_TYPE_STRING:
+                  {
+                    ret = usbclass_mkstrdesc(priv, ctrl->value[0],
+                            (FAR struct usb_strdesc_s *)ctrlreq->buf);
+                  }
+                  break;
+
+                default:
+                  {
+                    usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_GETUNKNOWNDESC),
+                             value);
+                  }
+                  break;
+                }
+            }
+            break;
+
+          case USB_REQ_SETCONFIGURATION:
+            {
+              if (ctrl->type == 0)
+                {
+                  ret = usbclass_setconfig(priv, value);
+                }
+            }
+            break;
+
+          case USB_REQ_GETCONFIGURATION:
+            {
+              if (ctrl->type == USB_DIR_IN)
+                {
+                  *(FAR uint8_t *)ctrlreq->buf = priv->config;
+                  ret = 1;
+                }
+            }
+            break;
+
+          case USB_REQ_SETINTERFACE:
+            {
+              if (ctrl->type == USB_REQ_RECIPIENT_INTERFACE)
+                {
+                  if (index == CDCNCM_DATAIFID)
+                    {
+                      ret = usbclass_setinterface(priv, value);
+                    }
+                  else if (index == CDCNCM_COMMIFID && value == 0)
+                    {
+                      ret = 0;
+                    }
+                }
+            }
+            break;
+
+          case USB_REQ_GETINTERFACE:
+            {
+              if (ctrl->type == (USB_DIR_IN | USB_REQ_RECIPIENT_INTERFACE) &&
+                  priv->config != CDCNCM_CONFIGIDNONE)
+                {
+                  *(FAR uint8_t *)ctrlreq->buf =
+                    (index == CDCNCM_DATAIFID && priv->connected) ? 1 : 0;
+                  ret = 1;
+                }
+            }
+            break;
+
+          default:
+            usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_UNSUPPORTEDSTDREQ),
+                     ctrl->req);
+            break;
+          }
+      }
+      break;
+
+    /* Class requests */
+
+    case USB_REQ_TYPE_CLASS:
+      {
+        if ((ctrl->type & USB_REQ_RECIPIENT_MASK) !=
+            USB_REQ_RECIPIENT_INTERFACE)
+          {
+            break;
+          }
+
+        switch (ctrl->req)
+          {
+          case NCM_GET_NTB_PARAMETERS:
+            ret = usbclass_mkntbparms(ctrlreq->buf);
+            break;
+
+          case NCM_GET_NTB_INPUT_SIZE:
+            cdcncm_putle32(ctrlreq->buf, priv->ntbinsize);
+            ret = 4;
+            break;
+
+          case NCM_SET_NTB_INPUT_SIZE:
+            {
+              /* The IN NTB size may only be reduced.  It is kept a multiple
+               * of the datagram alignment.
+               */
+
+              if (dataout != NULL && outlen >= 4)
+                {
+                  size = GETUINT32(dataout);
+                  if (size >= CDCNCM_NTB_MINSIZE &&
+                      size <= CONFIG_CDCNCM_NTB_INSIZE)
+                    {
+                      priv->ntbinsize = size & ~3;
+                      ret = 0;
+                    }
+                  else
+                    {
+                      ret = -EINVAL;
+                    }
+                }
+            }
+            break;
+
+          case NCM_GET_NTB_FORMAT:
+            cdcncm_putle16(ctrlreq->buf, 0);  /* NTB16 */
+            ret = 2;
+            break;
+
+          case NCM_SET_NTB_FORMAT:
+            ret = value == 0 ? 0 : -EINVAL;
+            break;
+
+          case ECM_SET_PACKET_FILTER:
+
+            /* Like RNDIS, there are only two devices on this network.
+             * The packet filter is accepted and ignored.
+             */
+
+            ret = 0;
+            break;
+
+          default:
+            usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_UNSUPPORTEDCLASSREQ),
+                     ctrl->req);
+            break;
+          }
+      }
+      break;
+
+    default:
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_UNSUPPORTEDTYPE), ctrl->type);
+      break;
+    }
+
+  /* Respond to the setup command if data was returned.  On an error return
+   * value (ret < 0), the USB driver will stall.
+   */
+
+  if (ret >= 0)
+    {
+      ctrlreq->len   = min(len, ret);
+      ctrlreq->flags = USBDEV_REQFLAGS_NULLPKT;
+      ret            = EP_SUBMIT(dev->ep0, ctrlreq);
+      if (ret < 0)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPRESPQ), (uint16_t)-ret);
+          ctrlreq->result = OK;
+          usbclass_ep0incomplete(dev->ep0, ctrlreq);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usbclass_disconnect
+ *
+ * Description:
+ *   Invoked after all transfers have been stopped, when the host is
+ *   disconnected.  This function is probably called from the context of an
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+static void usbclass_disconnect(FAR struct usbdevclass_driver_s *driver,
+                                FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_dev_s *priv;
+  irqstate_t flags;
+
+  usbtrace(TRACE_CLASSDISCONNECT, 0);
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!driver || !dev || !dev->ep0)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Extract reference to private data */
+
+  priv = ((FAR struct cdcncm_driver_s *)driver)->dev;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!priv)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EP0NOTBOUND), 0);
+      return;
+    }
+#endif
+
+  /* Reset the configuration */
+
+  flags = enter_critical_section();
+  usbclass_resetconfig(priv);
+  leave_critical_section(flags);
+
+  /* Perform the soft connect function so that we will we can be
+   * re-enumerated.
+   */
+
+  DEV_CONNECT(dev);
+}
+
+/****************************************************************************
+ * Name: usbclass_resetconfig
+ *
+ * Description:
+ *   Mark the device as not configured and disable all endpoints.
+ *
+ ****************************************************************************/
+
+static void usbclass_resetconfig(FAR struct cdcncm_dev_s *priv)
+{
+  /* Are we configured? */
+
+  if (priv->config != CDCNCM_CONFIGIDNONE)
+    {
+      /* Yes.. but not anymore */
+
+      priv->config = CDCNCM_CONFIGIDNONE;
+      priv->notify = CDCNCM_NOTIFY_NONE;
+
+      priv->netdev.d_ifdown(&priv->netdev);
+
+      /* Disable endpoints.  This should force completion of all pending
+       * transfers.
+       */
+
+      usbclass_resetdata(priv);
+      EP_DISABLE(priv->epintin);
+    }
+}
+
+/****************************************************************************
+ * Name: usbclass_setconfig
+ *
+ * Description:
+ *   Set the device configuration by configuring the notification endpoint.
+ *   The bulk endpoints are configured when the host selects the alternate
+ *   setting of the data interface that has them.
+ *
+ ****************************************************************************/
+
+static int usbclass_setconfig(FAR struct cdcncm_dev_s *priv, uint8_t config)
+{
+  int ret;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (priv == NULL)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return -EIO;
+    }
+#endif
+
+  if (config == priv->config)
+    {
+      /* Already configured -- Do nothing */
+
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_ALREADYCONFIGURED), 0);
+      return 0;
+    }
+
+  /* Discard the previous configuration data */
+
+  usbclass_resetconfig(priv);
+
+  /* Was this a request to simply discard the current configuration? */
+
+  if (config == CDCNCM_CONFIGIDNONE)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_CONFIGNONE), 0);
+      return 0;
+    }
+
+  /* We only accept one configuration */
+
+  if (config != CDCNCM_CONFIGID)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_CONFIGIDBAD), 0);
+      return -EINVAL;
+    }
+
+  /* Configure the IN interrupt endpoint */
+
+  ret = EP_CONFIGURE(priv->epintin, &g_cdcncm_cfgdesc.epintindesc, false);
+  if (ret < 0)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_EPINTINCONFIGFAIL), 0);
+      return ret;
+    }
+
+  priv->epintin->priv = priv;
+
+  /* We are successfully configured.  The NTB parameters return to their
+   * defaults.
+   */
+
+  priv->config    = config;
+  priv->ntbinsize = CONFIG_CDCNCM_NTB_INSIZE;
+
+  if (priv->netdev.d_ifup(&priv->netdev) == OK)
+    {
+      priv->netdev.d_flags |= IFF_UP;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: usbdev_cdcncm_initialize
+ *
+ * Description:
+ *   Register the CDC-NCM USB device interface and the corresponding network
+ *   driver.
+ *
+ * Input Parameters:
+ *   mac_address - An array of 6 bytes which make the MAC address of the
+ *                 host side of the network.  May be NULL to use a default
+ *                 address.
+ *
+ * Returned Value:
+ *   0 on success; -errno on failure
+ *
+ ****************************************************************************/
+
+int usbdev_cdcncm_initialize(FAR const uint8_t *mac_address)
+{
+  FAR struct cdcncm_alloc_s *alloc;
+  FAR struct cdcncm_dev_s *priv;
+  FAR struct cdcncm_driver_s *drvr;
+  int ret;
+
+  /* Allocate the structures needed */
+
+  alloc = (FAR struct cdcncm_alloc_s *)
+    kmm_zalloc(sizeof(struct cdcncm_alloc_s));
+  if (!alloc)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_ALLOCDEVSTRUCT), 0);
+      return -ENOMEM;
+    }
+
+  /* Convenience pointers into the allocated blob */
+
+  priv = &alloc->dev;
+  drvr = &alloc->drvr;
+
+  /* Initialize the USB ethernet driver structure */
+
+  sq_init(&priv->reqlist);
+  memcpy(priv->host_mac_address,
+         mac_address ? mac_address : g_cdcncm_default_mac_addr, 6);
+
+  priv->ntbinsize        = CONFIG_CDCNCM_NTB_INSIZE;
+  priv->txpoll           = wd_create();
+
+  priv->netdev.d_private = priv;
+  priv->netdev.d_ifup    = &cdcncm_ifup;
+  priv->netdev.d_ifdown  = &cdcncm_ifdown;
+  priv->netdev.d_txavail = &cdcncm_txavail;
+
+  /* Initialize the USB class driver structure */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  drvr->drvr.speed       = USB_SPEED_HIGH;
+#else
+  drvr->drvr.speed       = USB_SPEED_FULL;
+#endif
+  drvr->drvr.ops         = &g_driverops;
+  drvr->dev              = priv;
+
+  /* Register the USB class driver */
+
+  ret = usbdev_register(&drvr->drvr);
+  if (ret)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_DEVREGISTER), (uint16_t)-ret);
+      goto errout_with_alloc;
+    }
+
+  ret = netdev_register(&priv->netdev, NET_LL_ETHERNET);
+  if (ret)
+    {
+      uerr("ERROR: Failed to register net device\n");
+      usbdev_unregister(&drvr->drvr);
+      goto errout_with_alloc;
+    }
+
+  return OK;
+
+errout_with_alloc:
+  kmm_free(alloc);
+  return ret;
+}
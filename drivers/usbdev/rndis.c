@@ -78,9 +78,21 @@
 
 #define CONFIG_RNDIS_NWRREQS    (2)
 
+#ifndef CONFIG_RNDIS_NPACKETS
+#  define CONFIG_RNDIS_NPACKETS 1
+#endif
+
+/* Each packet in a bulk IN transfer occupies one slot:  The RNDIS packet
+ * message header and a full-sized frame, padded to a multiple of 4 bytes.
+ */
+
 #define RNDIS_PACKET_HDR_SIZE   (sizeof(struct rndis_packet_msg))
-#define CONFIG_RNDIS_BULKIN_REQLEN (CONFIG_NET_ETH_MTU + RNDIS_PACKET_HDR_SIZE)
-#define CONFIG_RNDIS_BULKOUT_REQLEN CONFIG_RNDIS_BULKIN_REQLEN
+#define RNDIS_PACKET_SLOT_SIZE  \
+  ((RNDIS_PACKET_HDR_SIZE + CONFIG_NET_ETH_MTU + 3) & ~3)
+#define CONFIG_RNDIS_BULKIN_REQLEN \
+  (CONFIG_RNDIS_NPACKETS * RNDIS_PACKET_SLOT_SIZE)
+#define CONFIG_RNDIS_BULKOUT_REQLEN \
+  (CONFIG_NET_ETH_MTU + RNDIS_PACKET_HDR_SIZE)
 
 #define RNDIS_NCONFIGS          (1)
 #define RNDIS_CONFIGID          (1)
@@ -156,6 +168,9 @@ struct rndis_dev_s
   uint8_t config;                        /* USB Configuration number */
   FAR struct rndis_req_s *net_req;       /* Pointer to request whose buffer is assigned to network */
   FAR struct rndis_req_s *rx_req;        /* Pointer request container that holds RX buffer */
+  uint16_t txoffset;                     /* Bytes queued in net_req */
+  uint8_t txpackets;                     /* Packets queued in net_req */
+  uint32_t host_xfrsize;                 /* MaxTransferSize of the host */
   size_t current_rx_received;            /* Number of bytes of current RX datagram received over USB */
   size_t current_rx_datagram_size;       /* Total number of bytes of the current RX datagram */
   size_t current_rx_datagram_offset;     /* Offset of current RX datagram */
@@ -652,6 +667,8 @@ static bool rndis_allocnetreq(FAR struct rndis_dev_s *priv)
     {
       priv->netdev.d_buf = &priv->net_req->req->buf[RNDIS_PACKET_HDR_SIZE];
       priv->netdev.d_len = CONFIG_NET_ETH_MTU;
+      priv->txoffset     = 0;
+      priv->txpackets    = 0;
     }
 
   leave_critical_section(flags);
@@ -763,13 +780,46 @@ static void rndis_giverxreq(FAR struct rndis_dev_s *priv)
   priv->netdev.d_buf = &priv->net_req->req->buf[RNDIS_PACKET_HDR_SIZE];
   priv->netdev.d_len = CONFIG_NET_ETH_MTU;
   priv->rx_req       = NULL;
+  priv->txoffset     = 0;
+  priv->txpackets    = 0;
+}
+
+/****************************************************************************
+ * Name: rndis_flushnetreq
+ *
+ * Description:
+ *   Submits the request buffer held by the network if it holds any packet
+ *   messages; frees it otherwise.
+ *
+ * Input Parameters:
+ *   priv: pointer to RNDIS device driver structure
+ *
+ * Assumptions:
+ *   Caller holds the network lock
+ *
+ ****************************************************************************/
+
+static void rndis_flushnetreq(FAR struct rndis_dev_s *priv)
+{
+  if (priv->net_req != NULL)
+    {
+      if (priv->txpackets > 0)
+        {
+          rndis_sendnetreq(priv);
+        }
+      else
+        {
+          rndis_freenetreq(priv);
+        }
+    }
 }
 
 /****************************************************************************
  * Name: rndis_fillrequest
  *
  * Description:
- *   Fills the RNDIS header to the request buffer
+ *   Fills the RNDIS header of the packet in the network buffer and appends
+ *   the packet message to the request
  *
  * Input Parameters:
  *   priv: pointer to RNDIS device driver structure
@@ -788,24 +838,29 @@ static uint16_t rndis_fillrequest(FAR struct rndis_dev_s *priv,
 {
   size_t datalen;
 
-  req->len = 0;
-
-  datalen = min(priv->netdev.d_len,
-                CONFIG_RNDIS_BULKIN_REQLEN - RNDIS_PACKET_HDR_SIZE);
+  datalen = min(priv->netdev.d_len, CONFIG_NET_ETH_MTU);
   if (datalen > 0)
     {
-      /* Send the required headers */
+      /* Send the required headers.  Packet messages after the first are
+       * padded so that each starts on a 4-byte boundary.
+       */
+
+      FAR struct rndis_packet_msg *msg =
+        (FAR struct rndis_packet_msg *)&req->buf[priv->txoffset];
+      uint32_t msglen = (RNDIS_PACKET_HDR_SIZE + datalen + 3) & ~3;
 
-      FAR struct rndis_packet_msg *msg = (FAR struct rndis_packet_msg *)req->buf;
       memset(msg, 0, RNDIS_PACKET_HDR_SIZE);
 
       msg->msgtype    = RNDIS_PACKET_MSG;
-      msg->msglen     = RNDIS_PACKET_HDR_SIZE + datalen;
+      msg->msglen     = msglen;
       msg->dataoffset = RNDIS_PACKET_HDR_SIZE - 8;
       msg->datalen    = datalen;
 
+      priv->txoffset += msglen;
+      priv->txpackets++;
+
       req->flags      = USBDEV_REQFLAGS_NULLPKT;
-      req->len        = datalen + RNDIS_PACKET_HDR_SIZE;
+      req->len        = priv->txoffset;
     }
 
   return req->len;
@@ -931,11 +986,7 @@ static void rndis_rxdispatch(FAR void *arg)
 
   priv->current_rx_datagram_size = 0;
   rndis_unblock_rx(priv);
-
-  if (priv->net_req != NULL)
-    {
-      rndis_freenetreq(priv);
-    }
+  rndis_flushnetreq(priv);
 
   net_unlock();
 }
@@ -1015,11 +1066,28 @@ static int rndis_txpoll(FAR struct net_driver_s *dev)
 
 static int rndis_transmit(FAR struct rndis_dev_s *priv)
 {
+  FAR struct usbdev_req_s *req = priv->net_req->req;
+  size_t maxlen;
   int ret = OK;
 
   /* Queue the packet */
 
-  rndis_fillrequest(priv, priv->net_req->req);
+  rndis_fillrequest(priv, req);
+
+  /* Is there room for another full-sized packet in this transfer?  If so,
+   * let the network place the next packet after this one.  The request is
+   * submitted when it is full or when the poll ends.
+   */
+
+  maxlen = min(CONFIG_RNDIS_BULKIN_REQLEN, priv->host_xfrsize);
+  if (priv->txpackets < CONFIG_RNDIS_NPACKETS &&
+      priv->txoffset + RNDIS_PACKET_SLOT_SIZE <= maxlen)
+    {
+      priv->netdev.d_buf = &req->buf[priv->txoffset + RNDIS_PACKET_HDR_SIZE];
+      priv->netdev.d_len = CONFIG_NET_ETH_MTU;
+      return OK;
+    }
+
   rndis_sendnetreq(priv);
 
   if (!rndis_allocnetreq(priv))
@@ -1049,11 +1117,7 @@ static void rndis_pollworker(FAR void *arg)
   if (rndis_allocnetreq(priv))
     {
       devif_timer(&priv->netdev, rndis_txpoll);
-
-      if (priv->net_req != NULL)
-        {
-          rndis_freenetreq(priv);
-        }
+      rndis_flushnetreq(priv);
     }
 
   net_unlock();
@@ -1136,10 +1200,7 @@ static void rndis_txavail_work(FAR void *arg)
   if (rndis_allocnetreq(priv))
     {
       devif_poll(&priv->netdev, rndis_txpoll);
-      if (priv->net_req != NULL)
-        {
-          rndis_freenetreq(priv);
-        }
+      rndis_flushnetreq(priv);
     }
 
   net_unlock();
@@ -1375,8 +1436,16 @@ static int rndis_handle_control_message(FAR struct rndis_dev_s *priv,
     {
       case RNDIS_INITIALIZE_MSG:
         {
+          FAR struct rndis_initialize_msg *req =
+            (FAR struct rndis_initialize_msg *)dataout;
           FAR struct rndis_initialize_cmplt *resp;
 
+          /* Packets to the host are aggregated up to the size of transfer
+           * that the host accepts.
+           */
+
+          priv->host_xfrsize = req->xfrsize;
+
           rndis_prepare_response(priv, sizeof(struct rndis_initialize_cmplt), cmd_hdr);
           resp = (FAR struct rndis_initialize_cmplt *)priv->ctrlreq->buf;
 
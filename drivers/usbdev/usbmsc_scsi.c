@@ -2106,7 +2106,8 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes still buffered in iobuffer[]
+ *   niobytes   - holds the number of bytes read into iobuffer[]
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
@@ -2119,6 +2120,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+  uint32_t nsectors;
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2137,20 +2139,50 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. If the request at the head of the wrreqlist is empty and
+           * can hold whole sectors, then read them directly into the request
+           * buffer.
+           */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+          privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+          if (privreq != NULL && priv->nreqbytes == 0 &&
+              CONFIG_USBMSC_BULKINREQLEN >= lun->sectorsize)
             {
-              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
-              lun->sd     = SCSI_KCQME_UNRRE1;
-              lun->sdinfo = priv->sector;
-              break;
+              nsectors = MIN(priv->u.xfrlen,
+                             CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize);
+              nread    = USBMSC_DRVR_READ(lun, privreq->req->buf,
+                                          priv->sector, nsectors);
+              if (nread <= 0)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
+                  lun->sd     = SCSI_KCQME_UNRRE1;
+                  lun->sdinfo = priv->sector;
+                  break;
+                }
+
+              priv->nreqbytes = nread * lun->sectorsize;
+            }
+          else
+            {
+              /* Otherwise, read as many sectors as the I/O buffer holds */
+
+              nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+              nread    = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                          nsectors);
+              if (nread <= 0)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
+                  lun->sd     = SCSI_KCQME_UNRRE1;
+                  lun->sdinfo = priv->sector;
+                  break;
+                }
+
+              priv->nsectbytes = nread * lun->sectorsize;
+              priv->niobytes   = priv->nsectbytes;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->u.xfrlen -= nread;
+          priv->sector   += nread;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2178,16 +2210,19 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
       nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes, priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update counts */
 
-      memcpy(dest, src, nbytes);
-      priv->nreqbytes  += nbytes;
-      priv->nsectbytes -= nbytes;
+      if (nbytes > 0)
+        {
+          memcpy(dest, src, nbytes);
+          priv->nreqbytes  += nbytes;
+          priv->nsectbytes -= nbytes;
+        }
 
       /* If (1) the request buffer is full OR (2) this is the final request full of data,
        * then submit the request
@@ -2253,7 +2288,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be written.
  *   sector     - holds the sector number of the next sector to write
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes buffered in iobuffer[]
  *   nreqbytes  - holds the number of untransferred bytes currently in the
  *                request at the head of the rdreqlist.
  *
@@ -2265,6 +2300,8 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbmsc_req_s *privreq;
   FAR struct usbdev_req_s *req;
   ssize_t nwritten;
+  uint32_t nsectors;
+  uint32_t iolen;
   uint16_t xfrd;
   uint8_t *src;
   uint8_t *dest;
@@ -2305,18 +2342,46 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
       xfrd            = req->xfrd;
       priv->nreqbytes = xfrd;
 
+      /* If no partial sector is buffered, then the whole sectors at the
+       * beginning of the read request can be written directly from the
+       * request buffer.
+       */
+
+      if (priv->nsectbytes == 0 && xfrd >= lun->sectorsize)
+        {
+          nsectors = MIN(xfrd / lun->sectorsize, priv->u.xfrlen);
+          nwritten = USBMSC_DRVR_WRITE(lun, req->buf, priv->sector, nsectors);
+          if (nwritten != nsectors)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
+              lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+              lun->sdinfo = priv->sector;
+              goto errout;
+            }
+
+          priv->nreqbytes -= nsectors * lun->sectorsize;
+          priv->residue   -= nsectors * lun->sectorsize;
+          priv->u.xfrlen  -= nsectors;
+          priv->sector    += nsectors;
+        }
+
       /* Now loop until all of the data in the read request has been transferred
        * to the block driver OR all of the request data has been transferred.
        */
 
       while (priv->nreqbytes > 0 && priv->u.xfrlen > 0)
         {
-          /* Copy the data received in the read request into the sector I/O buffer */
+          /* Copy the data received in the read request into the sector I/O
+           * buffer.  Buffer as many sectors as the I/O buffer holds, but no
+           * more than remain to be written.
+           */
 
-          src  = &req->buf[xfrd - priv->nreqbytes];
-          dest = &priv->iobuffer[priv->nsectbytes];
+          src   = &req->buf[xfrd - priv->nreqbytes];
+          dest  = &priv->iobuffer[priv->nsectbytes];
 
-          nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
+          iolen  = MIN(priv->iosize / lun->sectorsize, priv->u.xfrlen) *
+                   lun->sectorsize;
+          nbytes = MIN(iolen - priv->nsectbytes, priv->nreqbytes);
 
           /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2326,12 +2391,14 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
           /* Is the I/O buffer full? */
 
-          if (priv->nsectbytes >= lun->sectorsize)
+          if (priv->nsectbytes >= iolen)
             {
-              /* Yes.. Write the next sector */
+              /* Yes.. Write the buffered sectors */
 
-              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, 1);
-              if (nwritten < 0)
+              nsectors = iolen / lun->sectorsize;
+              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector,
+                                           nsectors);
+              if (nwritten != nsectors)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
                   lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
@@ -2340,9 +2407,9 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
                 }
 
               priv->nsectbytes = 0;
-              priv->residue   -= lun->sectorsize;
-              priv->u.xfrlen--;
-              priv->sector++;
+              priv->residue   -= iolen;
+              priv->u.xfrlen  -= nsectors;
+              priv->sector    += nsectors;
             }
         }
 
@@ -2365,6 +2432,22 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       if (xfrd != CONFIG_USBMSC_BULKOUTREQLEN)
         {
+          /* Write any whole sectors still held in the I/O buffer */
+
+          nsectors = priv->nsectbytes / lun->sectorsize;
+          if (nsectors > 0)
+            {
+              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector,
+                                           nsectors);
+              if (nwritten == nsectors)
+                {
+                  priv->residue  -= nsectors * lun->sectorsize;
+                  priv->u.xfrlen -= nsectors;
+                  priv->sector   += nsectors;
+                }
+            }
+
+          priv->nsectbytes  = 0;
           priv->shortpacket = 1;
           goto errout;
         }
@@ -52,9 +52,11 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/scsi.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 #include <nuttx/usb/usb.h>
 #include <nuttx/usb/usbhost.h>
@@ -90,6 +92,10 @@
 #  error "Currently limited to 26 devices /dev/sda-z"
 #endif
 
+#ifndef CONFIG_USBHOST_MSC_READAHEAD
+#  define CONFIG_USBHOST_MSC_READAHEAD 0
+#endif
+
 /* Driver support ***********************************************************/
 /* This format is used to construct the /dev/sd[n] device driver path.  It
  * defined here so that it will be used consistently in all places.
@@ -137,6 +143,15 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  FAR uint8_t            *rabuffer;     /* Read-ahead buffer (I/O memory) */
+  uint32_t                rasector;     /* First sector in rabuffer */
+  uint32_t                ranblocks;    /* Valid sectors in rabuffer */
+  uint32_t                nextsector;   /* Sector following the last read */
+#endif
+#ifdef CONFIG_USBHOST_MSC_STATS
+  struct usbhost_msc_stats_s stats;     /* Transfer statistics */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -196,6 +211,21 @@ static inline int usbhost_testunitready(FAR struct usbhost_state_s *priv);
 static inline int usbhost_requestsense(FAR struct usbhost_state_s *priv);
 static inline int usbhost_readcapacity(FAR struct usbhost_state_s *priv);
 static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv);
+static ssize_t usbhost_readsectors(FAR struct usbhost_state_s *priv,
+                                   FAR uint8_t *buffer, size_t startsector,
+                                   unsigned int nsectors);
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+static ssize_t usbhost_readahead(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 unsigned int nsectors);
+#endif
+#ifdef CONFIG_USBHOST_MSC_STATS
+static void usbhost_recordstats(FAR struct usbhost_state_s *priv,
+                                bool write, unsigned int nsectors,
+                                ssize_t result, clock_t start);
+#else
+#  define usbhost_recordstats(p,w,n,r,s)
+#endif
 
 /* Worker thread actions */
 
@@ -901,6 +931,225 @@ static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv)
   return nbytes < 0 ? (int)nbytes : OK;
 }
 
+/****************************************************************************
+ * Name: usbhost_readsectors
+ *
+ * Description:
+ *   Read sectors from the device with one READ(10) command:  Send the CBW,
+ *   receive the data directly into 'buffer', then receive and check the
+ *   CSW.  The whole sequence is repeated if it is NAKed (-EAGAIN).
+ *
+ *   The Bulk-Only Transport permits only one command in flight and its CSW
+ *   must be received before the next CBW is sent, so the per-command cost
+ *   is reduced by transferring as many sectors per command as possible.
+ *
+ * Input Parameters:
+ *   priv        - A reference to the class instance.
+ *   buffer      - The buffer that receives the data
+ *   startsector - The first sector to read
+ *   nsectors    - The number of sectors to read
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem semaphore.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_readsectors(FAR struct usbhost_state_s *priv,
+                                   FAR uint8_t *buffer, size_t startsector,
+                                   unsigned int nsectors)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_cbw_s *cbw;
+  ssize_t nbytes;
+
+  /* Initialize a CBW (re-using the allocated transfer buffer) */
+
+  cbw = usbhost_cbwalloc(priv);
+  if (cbw == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Loop in the event that EAGAIN is returned (mean that the transaction
+   * was NAKed and we should try again.
+   */
+
+  do
+    {
+#ifdef CONFIG_USBHOST_MSC_STATS
+      priv->stats.ncmds++;
+#endif
+
+      /* Construct and send the CBW */
+
+      usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                             (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (nbytes >= 0)
+        {
+          /* Receive the user data */
+
+          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                 buffer, priv->blocksize * nsectors);
+          if (nbytes >= 0)
+            {
+              /* Receive the CSW */
+
+              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                     priv->tbuffer, USBMSC_CSW_SIZEOF);
+              if (nbytes >= 0)
+                {
+                  FAR struct usbmsc_csw_s *csw;
+
+                  /* Check the CSW status */
+
+                  csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+                  if (csw->status != 0)
+                    {
+                      uerr("ERROR: CSW status error: %d\n", csw->status);
+                      nbytes = -ENODEV;
+                    }
+                }
+            }
+        }
+    }
+  while (nbytes == -EAGAIN);
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: usbhost_readahead
+ *
+ * Description:
+ *   Satisfy a read from the read-ahead buffer.  A short read that misses
+ *   the buffer but continues the previous read refills the buffer with
+ *   CONFIG_USBHOST_MSC_READAHEAD sectors starting at 'startsector'.  Any
+ *   other read goes directly to the caller's buffer.
+ *
+ * Input Parameters:
+ *   priv        - A reference to the class instance.
+ *   buffer      - The buffer that receives the data
+ *   startsector - The first sector to read
+ *   nsectors    - The number of sectors to read
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+static ssize_t usbhost_readahead(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 unsigned int nsectors)
+{
+  ssize_t nbytes;
+  uint32_t nblocks;
+
+  /* Is the whole request already in the read-ahead buffer? */
+
+  if (startsector < priv->rasector ||
+      startsector + nsectors > priv->rasector + priv->ranblocks)
+    {
+      /* No.. Read directly into the caller's buffer unless this is a short
+       * read that continues the previous one.
+       */
+
+      if (priv->rabuffer == NULL ||
+          nsectors >= CONFIG_USBHOST_MSC_READAHEAD ||
+          startsector != priv->nextsector)
+        {
+          nbytes = usbhost_readsectors(priv, buffer, startsector, nsectors);
+          if (nbytes >= 0)
+            {
+              priv->nextsector = startsector + nsectors;
+            }
+
+          return nbytes;
+        }
+
+      /* Refill the read-ahead buffer, without reading past the end of the
+       * media.
+       */
+
+      nblocks = CONFIG_USBHOST_MSC_READAHEAD;
+      if (startsector + nblocks > priv->nblocks)
+        {
+          nblocks = startsector < priv->nblocks ?
+                    priv->nblocks - startsector : 0;
+          if (nblocks < nsectors)
+            {
+              nblocks = nsectors;
+            }
+        }
+
+      priv->ranblocks = 0;
+      nbytes = usbhost_readsectors(priv, priv->rabuffer, startsector,
+                                   nblocks);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      priv->rasector  = startsector;
+      priv->ranblocks = nblocks;
+    }
+#ifdef CONFIG_USBHOST_MSC_STATS
+  else
+    {
+      priv->stats.rahits += nsectors;
+    }
+#endif
+
+  memcpy(buffer,
+         &priv->rabuffer[(startsector - priv->rasector) * priv->blocksize],
+         nsectors * priv->blocksize);
+
+  priv->nextsector = startsector + nsectors;
+  return nsectors * priv->blocksize;
+}
+#endif
+
+/****************************************************************************
+ * Name: usbhost_recordstats
+ *
+ * Description:
+ *   Account one read or write request in the transfer statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBHOST_MSC_STATS
+static void usbhost_recordstats(FAR struct usbhost_state_s *priv,
+                                bool write, unsigned int nsectors,
+                                ssize_t result, clock_t start)
+{
+  uint32_t elapsed = (uint32_t)(clock_systimer() - start);
+
+  if (result < 0)
+    {
+      priv->stats.nerrors++;
+    }
+  else if (write)
+    {
+      priv->stats.nwrites++;
+      priv->stats.wrblocks += nsectors;
+      priv->stats.wrticks  += elapsed;
+    }
+  else
+    {
+      priv->stats.nreads++;
+      priv->stats.rdblocks += nsectors;
+      priv->stats.rdticks  += elapsed;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: usbhost_destroy
  *
@@ -953,6 +1202,14 @@ static void usbhost_destroy(FAR void *arg)
 
   usbhost_tfree(priv);
 
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  if (priv->rabuffer)
+    {
+      DRVR_IOFREE(hport->drvr, priv->rabuffer);
+      priv->rabuffer = NULL;
+    }
+#endif
+
   /* Destroy the semaphores */
 
   nxsem_destroy(&priv->exclsem);
@@ -1319,6 +1576,27 @@ static inline int usbhost_initvolume(FAR struct usbhost_state_s *priv)
         }
     }
 
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  /* Allocate the read-ahead buffer from the I/O memory of the host
+   * controller.  Without it, all reads simply go directly to the caller's
+   * buffer.
+   */
+
+  if (ret >= 0 && priv->rabuffer == NULL)
+    {
+      FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+
+      if (DRVR_IOALLOC(hport->drvr, &priv->rabuffer,
+                       CONFIG_USBHOST_MSC_READAHEAD * priv->blocksize) < 0)
+        {
+          uwarn("WARNING: No read-ahead buffer\n");
+          priv->rabuffer = NULL;
+        }
+
+      priv->ranblocks = 0;
+    }
+#endif
+
   /* Get information about the volume */
 
   if (ret >= 0)
@@ -1983,14 +2261,14 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                             size_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
+#ifdef CONFIG_USBHOST_MSC_STATS
+  clock_t start;
+#endif
   ssize_t nbytes = 0;
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
-
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   uinfo("startsector: %d nsectors: %d sectorsize: %d\n",
         startsector, nsectors, priv->blocksize);
@@ -2008,65 +2286,19 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
     }
   else if (nsectors > 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
-
       usbhost_takesem(&priv->exclsem);
 
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
-        {
-          /* Loop in the event that EAGAIN is returned (mean that the
-           * transaction was NAKed and we should try again.
-           */
-
-          do
-            {
-              /* Assume some device failure */
-
-              nbytes = -ENODEV;
-
-              /* Construct and send the CBW */
-
-              usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-              if (nbytes >= 0)
-                {
-                  /* Receive the user data */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
-                    {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer, USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
+#ifdef CONFIG_USBHOST_MSC_STATS
+      start = clock_systimer();
+#endif
 
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n", csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
-                    }
-                }
-            }
-          while (nbytes == -EAGAIN);
-        }
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+      nbytes = usbhost_readahead(priv, buffer, startsector, nsectors);
+#else
+      nbytes = usbhost_readsectors(priv, buffer, startsector, nsectors);
+#endif
 
+      usbhost_recordstats(priv, false, nsectors, nbytes, start);
       usbhost_givesem(&priv->exclsem);
     }
 
@@ -2090,6 +2322,9 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 {
   FAR struct usbhost_state_s *priv;
   FAR struct usbhost_hubport_s *hport;
+#ifdef CONFIG_USBHOST_MSC_STATS
+  clock_t start;
+#endif
   ssize_t nbytes;
 
   uinfo("sector: %d nsectors: %d sectorsize: %d\n");
@@ -2117,6 +2352,21 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 
       usbhost_takesem(&priv->exclsem);
 
+#ifdef CONFIG_USBHOST_MSC_STATS
+      start = clock_systimer();
+      priv->stats.ncmds++;
+#endif
+
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+      /* Discard the read-ahead data if the write overlaps it */
+
+      if (startsector < priv->rasector + priv->ranblocks &&
+          startsector + nsectors > priv->rasector)
+        {
+          priv->ranblocks = 0;
+        }
+#endif
+
      /* Assume allocation failure */
 
       nbytes = -ENOMEM;
@@ -2164,6 +2414,7 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
             }
         }
 
+      usbhost_recordstats(priv, true, nsectors, nbytes, start);
       usbhost_givesem(&priv->exclsem);
     }
 
@@ -2260,6 +2511,26 @@ static int usbhost_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       usbhost_takesem(&priv->exclsem);
       switch (cmd)
         {
+#ifdef CONFIG_USBHOST_MSC_STATS
+        case BIOC_GETSTATS: /* Return transfer statistics */
+          {
+            FAR struct usbhost_msc_stats_s *stats =
+              (FAR struct usbhost_msc_stats_s *)((uintptr_t)arg);
+
+            if (stats == NULL)
+              {
+                ret = -EINVAL;
+              }
+            else
+              {
+                memcpy(stats, &priv->stats,
+                       sizeof(struct usbhost_msc_stats_s));
+                ret = OK;
+              }
+          }
+          break;
+#endif
+
         /* Add support for ioctl commands here */
 
         default:
@@ -44,15 +44,26 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <poll.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/video/fb.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FB_NPOLLWAITERS
+#  define CONFIG_FB_NPOLLWAITERS 2
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -60,7 +71,8 @@
 /* This structure defines one framebuffer device.  Note that which is
  * everything in this structure is constant data set up and initialization
  * time.  Therefore, no there is requirement for serialized access to this
- * structure.
+ * structure.  The exception is the vertical sync state which is also
+ * modified by fb_vsync() and so is protected by disabling interrupts.
  */
 
 struct fb_chardev_s
@@ -70,6 +82,14 @@ struct fb_chardev_s
   size_t fblen;                   /* Size of the framebuffer */
   uint8_t plane;                  /* Video plan number */
   uint8_t bpp;                    /* Bits per pixel */
+#ifdef CONFIG_FB_SYNC
+  uint8_t nwaiters;               /* Number of threads waiting on vsyncsem */
+  bool panpending;                /* A pan takes effect at the next vsync */
+  sem_t vsyncsem;                 /* Posted at the next vsync */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_FB_NPOLLWAITERS];
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -84,6 +104,10 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
 static off_t   fb_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#if defined(CONFIG_FB_SYNC) && !defined(CONFIG_DISABLE_POLL)
+static int     fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                 bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -98,8 +122,12 @@ static const struct file_operations fb_fops =
   fb_seek,       /* seek */
   fb_ioctl       /* ioctl */
 #ifndef CONFIG_DISABLE_POLL
+#ifdef CONFIG_FB_SYNC
+  , fb_poll      /* poll */
+#else
   , NULL         /* poll */
 #endif
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL         /* unlink */
 #endif
@@ -175,7 +203,7 @@ static ssize_t fb_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* And transfer the data from the frame buffer */
 
-  memcpy(buffer, fb->fbmem, size);
+  memcpy(buffer, (FAR uint8_t *)fb->fbmem + start, size);
   filep->f_pos += size;
   return size;
 }
@@ -219,7 +247,7 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
 
   /* And transfer the data into the frame buffer */
 
-  memcpy(fb->fbmem, buffer, size);
+  memcpy((FAR uint8_t *)fb->fbmem + start, buffer, size);
   filep->f_pos += size;
   return size;
 }
@@ -297,6 +325,64 @@ static off_t fb_seek(FAR struct file *filep, off_t offset, int whence)
   return ret;
 }
 
+/****************************************************************************
+ * Name: fb_waitvsync
+ *
+ * Description:
+ *   Wait for the next vertical sync reported by the framebuffer driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_SYNC
+static int fb_waitvsync(FAR struct fb_chardev_s *fb)
+{
+  irqstate_t flags;
+  int ret;
+
+  /* Interrupts are disabled so that fb_vsync() cannot run between counting
+   * this thread as a waiter and waiting.  Signals are ignored because a
+   * vertical sync is never more than one frame away.
+   */
+
+  flags = enter_critical_section();
+  fb->nwaiters++;
+
+  do
+    {
+      ret = nxsem_wait(&fb->vsyncsem);
+    }
+  while (ret == -EINTR);
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: fb_pollnotify
+ ****************************************************************************/
+
+#if defined(CONFIG_FB_SYNC) && !defined(CONFIG_DISABLE_POLL)
+static void fb_pollnotify(FAR struct fb_chardev_s *fb, pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_FB_NPOLLWAITERS; i++)
+    {
+      fds = fb->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fb_ioctl
  *
@@ -404,6 +490,83 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_FB_MULTIBUFFER
+      case FBIOPAN_DISPLAY:  /* Select the displayed frame */
+        {
+          FAR struct fb_planeinfo_s *pinfo =
+            (FAR struct fb_planeinfo_s *)((uintptr_t)arg);
+          struct fb_videoinfo_s vinfo;
+          struct fb_planeinfo_s curr;
+#ifdef CONFIG_FB_SYNC
+          irqstate_t flags;
+#endif
+
+          DEBUGASSERT(pinfo != NULL && fb->vtable != NULL &&
+                      fb->vtable->getvideoinfo != NULL &&
+                      fb->vtable->getplaneinfo != NULL);
+
+          if (fb->vtable->pandisplay == NULL)
+            {
+              ret = -ENOTTY;
+              break;
+            }
+
+          /* The whole frame must lie within the frame buffer memory */
+
+          ret = fb->vtable->getvideoinfo(fb->vtable, &vinfo);
+          if (ret >= 0)
+            {
+              ret = fb->vtable->getplaneinfo(fb->vtable, fb->plane, &curr);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if ((uint32_t)pinfo->yoffset + vinfo.yres > curr.yres_virtual)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+#ifdef CONFIG_FB_SYNC
+          /* Only one pan may be pending.  Otherwise, the application could
+           * start drawing into the frame that is still being displayed.
+           */
+
+          if (fb->panpending)
+            {
+              ret = fb_waitvsync(fb);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          flags = enter_critical_section();
+          ret = fb->vtable->pandisplay(fb->vtable, fb->plane, pinfo);
+          if (ret >= 0)
+            {
+              fb->panpending = true;
+            }
+
+          leave_critical_section(flags);
+#else
+          ret = fb->vtable->pandisplay(fb->vtable, fb->plane, pinfo);
+#endif
+        }
+        break;
+#endif
+
+#ifdef CONFIG_FB_SYNC
+      case FBIO_WAITFORVSYNC:  /* Wait for vertical sync */
+        {
+          ret = fb_waitvsync(fb);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_LCD_UPDATE
       case FBIO_UPDATE:  /* Update the LCD with the modified framebuffer data  */
         {
@@ -430,6 +593,86 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: fb_poll
+ *
+ * Description:
+ *   Wait for framebuffer events.  POLLOUT is reported when no pan is
+ *   pending, i.e. when the frame selected by the last FBIOPAN_DISPLAY is
+ *   being displayed and the previous frame may be drawn into.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FB_SYNC) && !defined(CONFIG_DISABLE_POLL)
+static int fb_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+  FAR struct inode *inode;
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  /* Get the framebuffer instance */
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL && fds != NULL);
+  inode = filep->f_inode;
+  fb    = (FAR struct fb_chardev_s *)inode->i_private;
+
+  flags = enter_critical_section();
+
+  /* Are we setting up the poll?  Or tearing it down? */
+
+  if (setup)
+    {
+      /* This is a request to set up the poll.  Find an available
+       * slot for the poll structure reference
+       */
+
+      for (i = 0; i < CONFIG_FB_NPOLLWAITERS; i++)
+        {
+          if (fb->fds[i] == NULL)
+            {
+              /* Bind the poll structure and this slot */
+
+              fb->fds[i] = fds;
+              fds->priv  = &fb->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FB_NPOLLWAITERS)
+        {
+          gerr("ERROR: Too many poll waiters\n");
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Report immediately if there is no pending pan */
+
+      if (!fb->panpending)
+        {
+          fb_pollnotify(fb, POLLOUT);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      /* Remove all memory of the poll setup */
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -518,6 +761,19 @@ int fb_register(int display, int plane)
   fb->fblen  = pinfo.fblen;
   fb->bpp    = pinfo.bpp;
 
+#ifdef CONFIG_FB_SYNC
+  /* The vsyncsem semaphore is used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  nxsem_init(&fb->vsyncsem, 0, 0);
+  nxsem_setprotocol(&fb->vsyncsem, SEM_PRIO_NONE);
+
+  /* Let fb_vsync() find this instance */
+
+  fb->vtable->priv = fb;
+#endif
+
   /* Clear the framebuffer memory */
 
   memset(pinfo.fbmem, 0, pinfo.fblen);
@@ -543,6 +799,69 @@ int fb_register(int display, int plane)
   return OK;
 
 errout_with_fb:
+#ifdef CONFIG_FB_SYNC
+  if (fb->vtable != NULL && fb->vtable->priv == fb)
+    {
+      fb->vtable->priv = NULL;
+      nxsem_destroy(&fb->vsyncsem);
+    }
+#endif
+
   kmm_free(fb);
   return ret;
 }
+
+/****************************************************************************
+ * Name: fb_vsync
+ *
+ * Description:
+ *   Called by the framebuffer driver, normally from its vertical sync
+ *   interrupt handler, each time the panel begins a new frame.  This wakes
+ *   up FBIO_WAITFORVSYNC waiters, completes any pending FBIOPAN_DISPLAY,
+ *   and notifies pollers.
+ *
+ * Input Parameters:
+ *   vtable - The framebuffer object registered by fb_register()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_SYNC
+void fb_vsync(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+
+  DEBUGASSERT(vtable != NULL);
+  fb = (FAR struct fb_chardev_s *)vtable->priv;
+
+  /* Nothing to do if the device has not been registered */
+
+  if (fb == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Any pending pan has now taken effect */
+
+  fb->panpending = false;
+
+  /* Wake up all of the threads waiting for this vsync */
+
+  while (fb->nwaiters > 0)
+    {
+      fb->nwaiters--;
+      nxsem_post(&fb->vsyncsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  fb_pollnotify(fb, POLLOUT);
+#endif
+
+  leave_critical_section(flags);
+}
+#endif
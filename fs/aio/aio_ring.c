@@ -0,0 +1,565 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/aioring.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Upper limit on the number of entries in one ring */
+
+#define AIORING_MAX_ENTRIES 4096
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aioring_worker
+ *
+ * Description:
+ *   Perform all of the requests that are waiting for the worker thread.
+ *   Only one instance of the worker is scheduled per ring at a time so
+ *   that a batch of submissions costs one work queue round trip, not one
+ *   per request.
+ *
+ ****************************************************************************/
+
+static void aioring_worker(FAR void *arg)
+{
+  FAR struct aioring_s *ring = (FAR struct aioring_s *)arg;
+  FAR struct aioring_req_s *req;
+  irqstate_t flags;
+  ssize_t ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      req   = (FAR struct aioring_req_s *)sq_remfirst(&ring->pending);
+      if (req == NULL)
+        {
+          /* The ring must not be accessed after this point:  It may be
+           * torn down as soon as the worker is no longer scheduled.
+           */
+
+          ring->workqueued = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      switch (req->opcode)
+        {
+          case AIORING_OP_READ:
+            ret = file_pread(req->filep, req->buf, req->nbytes,
+                             req->offset);
+            break;
+
+          case AIORING_OP_WRITE:
+            ret = file_pwrite(req->filep, req->buf, req->nbytes,
+                              req->offset);
+            break;
+
+          case AIORING_OP_FSYNC:
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+            ret = file_fsync(req->filep);
+#else
+            ret = -EINVAL;
+#endif
+            break;
+
+          default:
+            ret = -EINVAL;
+            break;
+        }
+
+      aioring_complete(req, ret);
+    }
+}
+
+/****************************************************************************
+ * Name: aioring_start
+ *
+ * Description:
+ *   Start one request:  Pass it to the aio method of the driver or file
+ *   system if there is one and, otherwise, queue it for the worker thread.
+ *
+ ****************************************************************************/
+
+static void aioring_start(FAR struct aioring_s *ring,
+                          FAR struct aioring_req_s *req)
+{
+  FAR struct inode *inode;
+  irqstate_t flags;
+  bool queue;
+  int ret;
+
+  if (req->opcode == AIORING_OP_NOP)
+    {
+      aioring_complete(req, 0);
+      return;
+    }
+
+  inode = req->filep->f_inode;
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      aioring_complete(req, -EBADF);
+      return;
+    }
+
+  /* Check the access mode here since the aio method is not given the
+   * chance to.
+   */
+
+  if ((req->opcode == AIORING_OP_READ &&
+       (req->filep->f_oflags & O_RDOK) == 0) ||
+      (req->opcode == AIORING_OP_WRITE &&
+       (req->filep->f_oflags & O_WROK) == 0))
+    {
+      aioring_complete(req, -EBADF);
+      return;
+    }
+  else if (req->opcode > AIORING_OP_FSYNC)
+    {
+      aioring_complete(req, -EINVAL);
+      return;
+    }
+
+  ret = -ENOSYS;
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      if (inode->u.i_mops->aio != NULL)
+        {
+          ret = inode->u.i_mops->aio(req->filep, req);
+        }
+    }
+  else
+#endif
+  if (inode->u.i_ops->aio != NULL)
+    {
+      ret = inode->u.i_ops->aio(req->filep, req);
+    }
+
+  if (ret == OK)
+    {
+      /* The driver owns the request now */
+
+      return;
+    }
+  else if (ret != -ENOSYS)
+    {
+      aioring_complete(req, ret);
+      return;
+    }
+
+  /* Perform the request synchronously on the worker thread */
+
+  flags = enter_critical_section();
+  sq_addlast(&req->link, &ring->pending);
+  queue = !ring->workqueued;
+  ring->workqueued = true;
+  leave_critical_section(flags);
+
+  if (queue)
+    {
+      ret = work_queue(LPWORK, &ring->work, aioring_worker, ring, 0);
+      DEBUGASSERT(ret == OK);
+      UNUSED(ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aioring_setup
+ *
+ * Description:
+ *   Allocate the queues of a new ring.
+ *
+ * Input Parameters:
+ *   ring    - The ring to be initialized
+ *   entries - The number of entries in each queue.  Rounded up to a power
+ *             of two.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aioring_setup(FAR struct aioring_s *ring, unsigned int entries)
+{
+  unsigned int nentries;
+  unsigned int i;
+
+  DEBUGASSERT(ring != NULL);
+
+  if (entries == 0 || entries > AIORING_MAX_ENTRIES)
+    {
+      return -EINVAL;
+    }
+
+  nentries = 1;
+  while (nentries < entries)
+    {
+      nentries <<= 1;
+    }
+
+  memset(ring, 0, sizeof(struct aioring_s));
+  ring->mask = nentries - 1;
+
+  ring->sqes = (FAR struct aioring_sqe_s *)
+    kmm_zalloc(nentries * sizeof(struct aioring_sqe_s));
+  ring->cqes = (FAR struct aioring_cqe_s *)
+    kmm_zalloc(nentries * sizeof(struct aioring_cqe_s));
+  ring->reqs = (FAR struct aioring_req_s *)
+    kmm_zalloc(nentries * sizeof(struct aioring_req_s));
+
+  if (ring->sqes == NULL || ring->cqes == NULL || ring->reqs == NULL)
+    {
+      kmm_free(ring->sqes);
+      kmm_free(ring->cqes);
+      kmm_free(ring->reqs);
+      return -ENOMEM;
+    }
+
+  sq_init(&ring->freereq);
+  sq_init(&ring->pending);
+
+  for (i = 0; i < nentries; i++)
+    {
+      ring->reqs[i].ring = ring;
+      sq_addlast(&ring->reqs[i].link, &ring->freereq);
+    }
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&ring->cqsem, 0, 0);
+  (void)nxsem_setprotocol(&ring->cqsem, SEM_PRIO_NONE);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aioring_teardown
+ *
+ * Description:
+ *   Wait for all requests in flight to complete and then release the
+ *   queues of the ring.  Unseen completions are discarded.
+ *
+ ****************************************************************************/
+
+void aioring_teardown(FAR struct aioring_s *ring)
+{
+  FAR struct aioring_cqe_s *cqe;
+
+  DEBUGASSERT(ring != NULL);
+
+  /* Reap every outstanding request */
+
+  while (ring->outstanding > 0)
+    {
+      if (aioring_wait_cqe(ring, &cqe) == OK)
+        {
+          aioring_cqe_seen(ring, cqe);
+        }
+    }
+
+  /* The worker may still be about to notice that it has nothing left to
+   * do.
+   */
+
+  while (ring->workqueued)
+    {
+      (void)nxsig_usleep(USEC_PER_TICK);
+    }
+
+  nxsem_destroy(&ring->cqsem);
+  kmm_free(ring->sqes);
+  kmm_free(ring->cqes);
+  kmm_free(ring->reqs);
+  memset(ring, 0, sizeof(struct aioring_s));
+}
+
+/****************************************************************************
+ * Name: aioring_get_sqe
+ *
+ * Description:
+ *   Return the next free submission queue entry or NULL if the SQ is full.
+ *   The entry is passed to the engine by the next aioring_submit().
+ *
+ ****************************************************************************/
+
+FAR struct aioring_sqe_s *aioring_get_sqe(FAR struct aioring_s *ring)
+{
+  FAR struct aioring_sqe_s *sqe;
+
+  if (ring->sq_tail - ring->sq_head > ring->mask)
+    {
+      return NULL;
+    }
+
+  sqe = &ring->sqes[ring->sq_tail & ring->mask];
+  memset(sqe, 0, sizeof(struct aioring_sqe_s));
+  ring->sq_tail++;
+  return sqe;
+}
+
+/****************************************************************************
+ * Name: aioring_submit
+ *
+ * Description:
+ *   Start all of the submission queue entries filled in since the last
+ *   call.  Entries are started in order.  Submission stops early if the
+ *   number of requests whose completion has not yet been seen would exceed
+ *   the size of the CQ; the remaining entries stay in the SQ for the next
+ *   call.
+ *
+ * Returned Value:
+ *   The number of entries submitted.  Errors such as a bad file descriptor
+ *   are reported in the CQE of the request, not here.
+ *
+ ****************************************************************************/
+
+int aioring_submit(FAR struct aioring_s *ring)
+{
+  FAR struct aioring_sqe_s *sqe;
+  FAR struct aioring_req_s *req;
+  FAR struct file *filep;
+  irqstate_t flags;
+  int count = 0;
+  int ret;
+
+  while (ring->sq_head != ring->sq_tail)
+    {
+      /* Reserve a CQE for the request.  A request is freed before its CQE
+       * is seen so there is always a free request if a CQE is available.
+       */
+
+      flags = enter_critical_section();
+      if (ring->outstanding > ring->mask)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      req = (FAR struct aioring_req_s *)sq_remfirst(&ring->freereq);
+      ring->outstanding++;
+      leave_critical_section(flags);
+
+      DEBUGASSERT(req != NULL);
+
+      sqe = &ring->sqes[ring->sq_head & ring->mask];
+      ring->sq_head++;
+
+      req->opcode    = sqe->opcode;
+      req->buf       = sqe->buf;
+      req->nbytes    = sqe->nbytes;
+      req->offset    = sqe->offset;
+      req->user_data = sqe->user_data;
+      req->filep     = NULL;
+      count++;
+
+      /* The file descriptor is resolved now, in the context of the caller
+       * and not in that of the worker thread.
+       */
+
+      if (req->opcode != AIORING_OP_NOP)
+        {
+          ret = fs_getfilep(sqe->fd, &filep);
+          if (ret < 0)
+            {
+              aioring_complete(req, ret);
+              continue;
+            }
+
+          req->filep = filep;
+        }
+
+      aioring_start(ring, req);
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: aioring_peek_cqe, aioring_wait_cqe, and aioring_cqe_seen
+ *
+ * Description:
+ *   aioring_peek_cqe() returns the oldest unseen completion or NULL if
+ *   there is none.  aioring_wait_cqe() waits for a completion if there is
+ *   none.  The entry remains valid until released with aioring_cqe_seen().
+ *
+ * Returned Value:
+ *   aioring_wait_cqe() returns zero (OK) on success or a negated errno
+ *   value if the wait was interrupted or if nothing is outstanding.
+ *
+ ****************************************************************************/
+
+FAR struct aioring_cqe_s *aioring_peek_cqe(FAR struct aioring_s *ring)
+{
+  if (ring->cq_head == ring->cq_tail)
+    {
+      return NULL;
+    }
+
+  return &ring->cqes[ring->cq_head & ring->mask];
+}
+
+int aioring_wait_cqe(FAR struct aioring_s *ring,
+                     FAR struct aioring_cqe_s **cqe)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  /* The critical section is released while we wait and re-established
+   * when we are awakened.
+   */
+
+  flags = enter_critical_section();
+  while ((*cqe = aioring_peek_cqe(ring)) == NULL)
+    {
+      if (ring->outstanding == 0)
+        {
+          /* Nothing is in flight so no completion will ever come */
+
+          ret = -EAGAIN;
+          break;
+        }
+
+      ring->waiting = true;
+      ret = nxsem_wait(&ring->cqsem);
+      if (ret < 0)
+        {
+          ring->waiting = false;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+void aioring_cqe_seen(FAR struct aioring_s *ring,
+                      FAR struct aioring_cqe_s *cqe)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cqe == aioring_peek_cqe(ring));
+  UNUSED(cqe);
+
+  flags = enter_critical_section();
+  ring->cq_head++;
+  ring->outstanding--;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: aioring_complete
+ *
+ * Description:
+ *   Post the completion of a request.  Called by the driver or file system
+ *   that accepted the request in its aio method, possibly from an interrupt
+ *   handler.  The request must not be accessed after this call.
+ *
+ * Input Parameters:
+ *   req    - The completed request
+ *   result - The number of bytes transferred or a negated errno value
+ *
+ ****************************************************************************/
+
+void aioring_complete(FAR struct aioring_req_s *req, ssize_t result)
+{
+  FAR struct aioring_s *ring = req->ring;
+  FAR struct aioring_cqe_s *cqe;
+  irqstate_t flags;
+
+  if (result < 0)
+    {
+      finfo("Request %p failed: %d\n", (FAR void *)req->user_data,
+            (int)result);
+    }
+
+  flags = enter_critical_section();
+
+  /* A CQE was reserved for this request when it was submitted */
+
+  cqe            = &ring->cqes[ring->cq_tail & ring->mask];
+  cqe->user_data = req->user_data;
+  cqe->result    = result;
+  ring->cq_tail++;
+
+  sq_addlast(&req->link, &ring->freereq);
+
+  if (ring->waiting)
+    {
+      ring->waiting = false;
+      nxsem_post(&ring->cqsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_FS_AIO_RING */
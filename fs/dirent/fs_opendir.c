@@ -93,7 +93,7 @@ static inline int open_mountpoint(FAR struct inode *inode,
    * inode_addref() because we already hold the tree semaphore.
    */
 
-  inode->i_crefs++;
+  inode_incref(inode);
 
   /* Perform the opendir() operation */
 
@@ -108,8 +108,8 @@ static inline int open_mountpoint(FAR struct inode *inode,
        * other thread should be able to change the reference count.
        */
 
-      inode->i_crefs--;
-      DEBUGASSERT(inode->i_crefs >= 0);
+      inode_decref(inode);
+      DEBUGASSERT(inode_crefs(inode) >= 0);
 
       /* Negate the error value so that it can be used to set errno */
 
@@ -144,7 +144,8 @@ static void open_pseudodir(FAR struct inode *inode, FAR struct fs_dirent_s *dir)
    * semaphore and that would result in deadlock.
    */
 
-  inode->i_crefs       += 2;
+  inode_incref(inode);
+  inode_incref(inode);
   dir->fd_root          = inode; /* Save the inode where we start */
   dir->u.pseudo.fd_next = inode; /* This is the next node to use for readdir() */
 
@@ -127,7 +127,7 @@ static inline int readpseudodir(struct fs_dirent_s *idir)
     {
       /* Increment the reference count on this next node */
 
-      idir->u.pseudo.fd_next->i_crefs++;
+      inode_incref(idir->u.pseudo.fd_next);
     }
 
   inode_semgive();
@@ -71,7 +71,7 @@ static inline void rewindpseudodir(struct fs_dirent_s *idir)
    * should now have two references on the inode.
    */
 
-  idir->fd_root->i_crefs++;
+  inode_incref(idir->fd_root);
   inode_semgive();
 
   /* Then release the reference to the old next inode */
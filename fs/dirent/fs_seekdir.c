@@ -98,7 +98,7 @@ static inline void seekpseudodir(struct fs_dirent_s *idir, off_t offset)
     {
       /* Increment the reference count on this next node */
 
-      curr->i_crefs++;
+      inode_incref(curr);
     }
 
   inode_semgive();
@@ -122,6 +122,26 @@ int find_blockdriver(FAR const char *pathname, int mountflags,
 int block_proxy(FAR const char *blkdev, int oflags);
 #endif
 
+/****************************************************************************
+ * Name: blockcache_detach
+ *
+ * Description:
+ *   Write back and discard all cached sectors of a block driver and
+ *   restore the driver's own block operations.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -ENOENT is
+ *   returned if the driver is not attached to the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int blockcache_detach(FAR struct inode *inode);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,837 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
+#include "driver/driver.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Transfers of more than this many sectors bypass the cache so that one
+ * large sequential transfer does not evict everything else.
+ */
+
+#define BCACHE_MAXRUN  ((CONFIG_FS_BLOCKCACHE_NBUFFERS + 3) / 4)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One block driver that has been attached to the cache */
+
+struct bcache_dev_s
+{
+  FAR struct bcache_dev_s *flink;           /* Next attached driver */
+  FAR struct inode *inode;                  /* The block driver inode */
+  FAR const struct block_operations *bops;  /* The driver's own operations */
+  uint16_t sectsize;                        /* Sector size in bytes */
+};
+
+/* One cached sector */
+
+struct bcache_buf_s
+{
+  FAR struct bcache_dev_s *dev;  /* Owning driver (NULL if unused) */
+  size_t   sector;               /* Sector number on the device */
+  uint32_t lastuse;              /* Time of last use (for LRU) */
+  bool     dirty;                /* Sector must be written back */
+  uint8_t  data[CONFIG_FS_BLOCKCACHE_SECTORSIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     bcache_open(FAR struct inode *inode);
+static int     bcache_close(FAR struct inode *inode);
+static ssize_t bcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t bcache_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, size_t start_sector,
+                 unsigned int nsectors);
+#endif
+static int     bcache_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     bcache_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     bcache_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bcache_bops =
+{
+  bcache_open,      /* open     */
+  bcache_close,     /* close    */
+  bcache_read,      /* read     */
+#ifdef CONFIG_FS_WRITABLE
+  bcache_write,     /* write    */
+#else
+  NULL,             /* write    */
+#endif
+  bcache_geometry,  /* geometry */
+  bcache_ioctl      /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , bcache_unlink   /* unlink   */
+#endif
+};
+
+static sem_t g_bcache_sem = SEM_INITIALIZER(1);
+static FAR struct bcache_dev_s *g_bcache_devs;
+static struct bcache_buf_s g_bcache_bufs[CONFIG_FS_BLOCKCACHE_NBUFFERS];
+static uint32_t g_bcache_clock;
+static struct blockcache_stats_s g_bcache_stats;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_lock and bcache_unlock
+ ****************************************************************************/
+
+static void bcache_lock(void)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&g_bcache_sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define bcache_unlock() nxsem_post(&g_bcache_sem)
+
+/****************************************************************************
+ * Name: bcache_finddev
+ *
+ * Description:
+ *   Return the cache state for an attached block driver inode.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_dev_s *bcache_finddev(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev;
+
+  for (dev = g_bcache_devs; dev != NULL; dev = dev->flink)
+    {
+      if (dev->inode == inode)
+        {
+          return dev;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bcache_findbuf
+ *
+ * Description:
+ *   Return the buffer holding a sector of the device, or NULL if the
+ *   sector is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_buf_s *bcache_findbuf(FAR struct bcache_dev_s *dev,
+                                               size_t sector)
+{
+  FAR struct bcache_buf_s *buf;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLOCKCACHE_NBUFFERS; i++)
+    {
+      buf = &g_bcache_bufs[i];
+      if (buf->dev == dev && buf->sector == sector)
+        {
+          buf->lastuse = ++g_bcache_clock;
+          return buf;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bcache_writeback
+ *
+ * Description:
+ *   Write a dirty buffer back to its device.
+ *
+ ****************************************************************************/
+
+static int bcache_writeback(FAR struct bcache_buf_s *buf)
+{
+#ifdef CONFIG_FS_WRITABLE
+  FAR struct bcache_dev_s *dev = buf->dev;
+  ssize_t nwritten;
+
+  if (buf->dirty)
+    {
+      nwritten = dev->bops->write(dev->inode, buf->data, buf->sector, 1);
+      if (nwritten < 0)
+        {
+          ferr("ERROR: Write-back of sector %lu failed: %d\n",
+               (unsigned long)buf->sector, (int)nwritten);
+          return (int)nwritten;
+        }
+
+      buf->dirty = false;
+      g_bcache_stats.writebacks++;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_allocbuf
+ *
+ * Description:
+ *   Get a buffer for a new sector, evicting the least recently used buffer
+ *   (after writing it back if necessary).
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_buf_s *bcache_allocbuf(FAR struct bcache_dev_s *dev,
+                                                size_t sector)
+{
+  FAR struct bcache_buf_s *victim = NULL;
+  FAR struct bcache_buf_s *buf;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLOCKCACHE_NBUFFERS; i++)
+    {
+      buf = &g_bcache_bufs[i];
+      if (buf->dev == NULL)
+        {
+          victim = buf;
+          break;
+        }
+
+      if (victim == NULL ||
+          (int32_t)(buf->lastuse - victim->lastuse) < 0)
+        {
+          victim = buf;
+        }
+    }
+
+  DEBUGASSERT(victim != NULL);
+
+  if (victim->dev != NULL)
+    {
+      ret = bcache_writeback(victim);
+      if (ret < 0)
+        {
+          return NULL;
+        }
+
+      g_bcache_stats.evictions++;
+    }
+
+  victim->dev     = dev;
+  victim->sector  = sector;
+  victim->dirty   = false;
+  victim->lastuse = ++g_bcache_clock;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bcache_flushdev
+ *
+ * Description:
+ *   Write back all dirty sectors of one device.  If 'discard' is true, the
+ *   sectors are also removed from the cache.
+ *
+ ****************************************************************************/
+
+static int bcache_flushdev(FAR struct bcache_dev_s *dev, bool discard)
+{
+  FAR struct bcache_buf_s *buf;
+  int ret = OK;
+  int err;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLOCKCACHE_NBUFFERS; i++)
+    {
+      buf = &g_bcache_bufs[i];
+      if (buf->dev == dev)
+        {
+          err = bcache_writeback(buf);
+          if (err < 0)
+            {
+              ret = err;
+            }
+
+          if (discard)
+            {
+              buf->dev   = NULL;
+              buf->dirty = false;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_invalidate
+ *
+ * Description:
+ *   Discard all sectors of one device without writing them back.
+ *
+ ****************************************************************************/
+
+static void bcache_invalidate(FAR struct bcache_dev_s *dev)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_BLOCKCACHE_NBUFFERS; i++)
+    {
+      if (g_bcache_bufs[i].dev == dev)
+        {
+          g_bcache_bufs[i].dev   = NULL;
+          g_bcache_bufs[i].dirty = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_open
+ ****************************************************************************/
+
+static int bcache_open(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = bcache_finddev(inode);
+
+  DEBUGASSERT(dev != NULL);
+  return dev->bops->open ? dev->bops->open(inode) : OK;
+}
+
+/****************************************************************************
+ * Name: bcache_close
+ *
+ * Description:
+ *   Write back the dirty sectors of the device, then close it.
+ *
+ ****************************************************************************/
+
+static int bcache_close(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret;
+
+  bcache_lock();
+  dev = bcache_finddev(inode);
+  DEBUGASSERT(dev != NULL);
+
+  ret = bcache_flushdev(dev, false);
+  bcache_unlock();
+
+  if (dev->bops->close)
+    {
+      int err = dev->bops->close(inode);
+      if (err < 0)
+        {
+          ret = err;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:
+ *   Copy cached sectors to the caller's buffer.  Each run of sectors that
+ *   is not in the cache is read with one request to the driver directly
+ *   into the caller's buffer and, if the run is short, the sectors are then
+ *   added to the cache.
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                           size_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct bcache_buf_s *buf;
+  unsigned int nmiss;
+  unsigned int i;
+  ssize_t nread;
+  ssize_t ret = nsectors;
+
+  bcache_lock();
+  dev = bcache_finddev(inode);
+  DEBUGASSERT(dev != NULL);
+
+  while (nsectors > 0)
+    {
+      buf = bcache_findbuf(dev, start_sector);
+      if (buf != NULL)
+        {
+          memcpy(buffer, buf->data, dev->sectsize);
+          g_bcache_stats.hits++;
+          nmiss = 1;
+        }
+      else
+        {
+          /* Find the length of the run of uncached sectors */
+
+          for (nmiss = 1;
+               nmiss < nsectors &&
+               bcache_findbuf(dev, start_sector + nmiss) == NULL;
+               nmiss++);
+
+          g_bcache_stats.misses += nmiss;
+
+          nread = dev->bops->read(inode, buffer, start_sector, nmiss);
+          if (nread < 0)
+            {
+              ret = nread;
+              break;
+            }
+
+          DEBUGASSERT(nread == nmiss);
+
+          if (nmiss <= BCACHE_MAXRUN)
+            {
+              for (i = 0; i < nmiss; i++)
+                {
+                  buf = bcache_allocbuf(dev, start_sector + i);
+                  if (buf != NULL)
+                    {
+                      memcpy(buf->data, &buffer[i * dev->sectsize],
+                             dev->sectsize);
+                    }
+                }
+            }
+        }
+
+      buffer       += nmiss * dev->sectsize;
+      start_sector += nmiss;
+      nsectors     -= nmiss;
+    }
+
+  bcache_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description:
+ *   With write-back enabled, short writes only update the cache and the
+ *   sectors are written to the device when they are evicted or flushed.
+ *   Long writes, and all writes if write-back is disabled, go directly to
+ *   the device; any cached copies of the sectors are updated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t bcache_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            size_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct bcache_buf_s *buf;
+  unsigned int i;
+  ssize_t ret = nsectors;
+  bool writethrough;
+
+  bcache_lock();
+  dev = bcache_finddev(inode);
+  DEBUGASSERT(dev != NULL);
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  writethrough = (nsectors > BCACHE_MAXRUN);
+#else
+  writethrough = true;
+#endif
+
+  if (writethrough)
+    {
+      ret = dev->bops->write(inode, buffer, start_sector, nsectors);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  for (i = 0; i < nsectors; i++)
+    {
+      buf = bcache_findbuf(dev, start_sector + i);
+      if (buf == NULL && !writethrough)
+        {
+          buf = bcache_allocbuf(dev, start_sector + i);
+          if (buf == NULL)
+            {
+              /* The write-back of the evicted sector failed.  Write this
+               * sector directly.
+               */
+
+              ret = dev->bops->write(inode, &buffer[i * dev->sectsize],
+                                     start_sector + i, 1);
+              if (ret < 0)
+                {
+                  goto errout_with_lock;
+                }
+
+              continue;
+            }
+        }
+
+      if (buf != NULL)
+        {
+          memcpy(buf->data, &buffer[i * dev->sectsize], dev->sectsize);
+          buf->dirty = !writethrough;
+        }
+    }
+
+  ret = nsectors;
+
+errout_with_lock:
+  bcache_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: bcache_geometry
+ *
+ * Description:
+ *   Return the geometry of the device, discarding the cached sectors if
+ *   the media has changed.
+ *
+ ****************************************************************************/
+
+static int bcache_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret;
+
+  bcache_lock();
+  dev = bcache_finddev(inode);
+  DEBUGASSERT(dev != NULL && dev->bops->geometry != NULL);
+
+  ret = dev->bops->geometry(inode, geometry);
+  if (ret >= 0 && geometry->geo_mediachanged)
+    {
+      /* The cached sectors, dirty or not, belong to the old media */
+
+      bcache_invalidate(dev);
+    }
+
+  bcache_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_ioctl
+ *
+ * Description:
+ *   BIOC_FLUSH writes back the dirty sectors of the device.  Commands that
+ *   may change the media discard the cached sectors first.  All commands
+ *   are then passed to the driver.
+ *
+ ****************************************************************************/
+
+static int bcache_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret = OK;
+
+  bcache_lock();
+  dev = bcache_finddev(inode);
+  DEBUGASSERT(dev != NULL);
+
+  switch (cmd)
+    {
+      case BIOC_FLUSH:
+        ret = bcache_flushdev(dev, false);
+        break;
+
+      case BIOC_PROBE:
+      case BIOC_EJECT:
+      case BIOC_LLFORMAT:
+      case BIOC_XIPBASE:
+      case BIOC_MAP:
+        ret = bcache_flushdev(dev, true);
+        break;
+
+      default:
+        break;
+    }
+
+  bcache_unlock();
+
+  if (ret >= 0 && dev->bops->ioctl != NULL)
+    {
+      int err = dev->bops->ioctl(inode, cmd, arg);
+
+      /* Drivers need not support BIOC_FLUSH themselves */
+
+      if (cmd != BIOC_FLUSH || err != -ENOTTY)
+        {
+          ret = err;
+        }
+    }
+  else if (ret >= 0 && cmd != BIOC_FLUSH)
+    {
+      ret = -ENOTTY;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int bcache_unlink(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = bcache_finddev(inode);
+
+  DEBUGASSERT(dev != NULL);
+  return dev->bops->unlink ? dev->bops->unlink(inode) : OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_attach
+ *
+ * Description:
+ *   Route all accesses to the block driver at 'path' through the shared
+ *   block buffer cache.  This should be called after the driver is
+ *   registered and before it is opened or mounted.
+ *
+ * Input Parameters:
+ *   path - The path to a registered block driver
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blockcache_attach(FAR const char *path)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct inode *inode;
+  struct geometry geo;
+  int ret;
+
+  ret = find_blockdriver(path, MS_RDONLY, &inode);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The cache can hold only sectors up to the configured size */
+
+  if (inode->u.i_bops->geometry == NULL ||
+      inode->u.i_bops->geometry(inode, &geo) < 0 ||
+      geo.geo_sectorsize == 0 ||
+      geo.geo_sectorsize > CONFIG_FS_BLOCKCACHE_SECTORSIZE)
+    {
+      ferr("ERROR: %s cannot be cached\n", path);
+      ret = -EINVAL;
+      goto errout_with_inode;
+    }
+
+  dev = (FAR struct bcache_dev_s *)kmm_zalloc(sizeof(struct bcache_dev_s));
+  if (dev == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  bcache_lock();
+  if (bcache_finddev(inode) != NULL)
+    {
+      bcache_unlock();
+      kmm_free(dev);
+      ret = -EEXIST;
+      goto errout_with_inode;
+    }
+
+  dev->inode    = inode;
+  dev->bops     = inode->u.i_bops;
+  dev->sectsize = geo.geo_sectorsize;
+  dev->flink    = g_bcache_devs;
+  g_bcache_devs = dev;
+
+  /* Substitute the cache operations for the driver's own */
+
+  inode_semtake();
+  inode->u.i_bops = &g_bcache_bops;
+  inode_semgive();
+
+  bcache_unlock();
+  ret = OK;
+
+errout_with_inode:
+  inode_release(inode);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_detach
+ *
+ * Description:
+ *   Write back and discard all cached sectors of a block driver and
+ *   restore the driver's own block operations.  This is called when the
+ *   block driver is unregistered.
+ *
+ ****************************************************************************/
+
+int blockcache_detach(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *prev;
+  FAR struct bcache_dev_s *dev;
+  int ret;
+
+  bcache_lock();
+  for (prev = NULL, dev = g_bcache_devs;
+       dev != NULL && dev->inode != inode;
+       prev = dev, dev = dev->flink);
+
+  if (dev == NULL)
+    {
+      bcache_unlock();
+      return -ENOENT;
+    }
+
+  ret = bcache_flushdev(dev, true);
+
+  if (prev != NULL)
+    {
+      prev->flink = dev->flink;
+    }
+  else
+    {
+      g_bcache_devs = dev->flink;
+    }
+
+  inode_semtake();
+  inode->u.i_bops = dev->bops;
+  inode_semgive();
+  bcache_unlock();
+
+  kmm_free(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_sync
+ *
+ * Description:
+ *   Write back all dirty sectors of all attached block drivers.
+ *
+ ****************************************************************************/
+
+int blockcache_sync(void)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret = OK;
+  int err;
+
+  bcache_lock();
+  for (dev = g_bcache_devs; dev != NULL; dev = dev->flink)
+    {
+      err = bcache_flushdev(dev, false);
+      if (err < 0)
+        {
+          ret = err;
+        }
+    }
+
+  bcache_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_getstats
+ *
+ * Description:
+ *   Return the cache hit, miss, eviction and write-back counts.
+ *
+ ****************************************************************************/
+
+void blockcache_getstats(FAR struct blockcache_stats_s *stats)
+{
+  bcache_lock();
+  memcpy(stats, &g_bcache_stats, sizeof(struct blockcache_stats_s));
+  bcache_unlock();
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
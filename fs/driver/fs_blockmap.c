@@ -0,0 +1,129 @@
+/****************************************************************************
+ * fs/driver/fs_blockmap.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: block_map
+ *
+ * Description:
+ *   Return the address of a range of sectors of a block driver whose media
+ *   is directly addressable.  See include/nuttx/fs/fs.h.
+ *
+ ****************************************************************************/
+
+int block_map(FAR struct inode *inode, FAR struct blockmap_s *map)
+{
+  FAR const struct block_operations *bops;
+  struct geometry geo;
+  FAR uint8_t *base = NULL;
+  int ret;
+
+  if (inode == NULL || map == NULL || !INODE_IS_BLOCK(inode))
+    {
+      return -EINVAL;
+    }
+
+  bops = inode->u.i_bops;
+  if (bops == NULL || bops->ioctl == NULL || bops->geometry == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  /* Prefer the driver's own mapping:  It knows which parts of the media are
+   * contiguous and whether the mapped sectors may be modified in place.
+   */
+
+  ret = bops->ioctl(inode, BIOC_MAP, (unsigned long)((uintptr_t)map));
+  if (ret != -ENOTTY)
+    {
+      return ret;
+    }
+
+  /* Otherwise, map the range relative to the XIP base address of the whole
+   * media.  Such media is treated as read-only:  XIP flash cannot be
+   * written by simple stores.
+   */
+
+  ret = bops->ioctl(inode, BIOC_XIPBASE, (unsigned long)((uintptr_t)&base));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (base == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (map->bm_start >= geo.geo_nsectors ||
+      map->bm_nsectors > geo.geo_nsectors - map->bm_start)
+    {
+      return -EINVAL;
+    }
+
+  map->bm_addr     = base + map->bm_start * geo.geo_sectorsize;
+  map->bm_writable = false;
+
+  finfo("sector %lu mapped to %p\n", (unsigned long)map->bm_start,
+        map->bm_addr);
+  return OK;
+}
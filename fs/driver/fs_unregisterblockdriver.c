@@ -39,9 +39,12 @@
 
 #include <nuttx/config.h>
 
+#include <sys/mount.h>
+
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "driver/driver.h"
 
 /****************************************************************************
  * Public Functions
@@ -57,8 +60,21 @@
 
 int unregister_blockdriver(const char *path)
 {
+#ifdef CONFIG_FS_BLOCKCACHE
+  FAR struct inode *inode;
+#endif
   int ret;
 
+#ifdef CONFIG_FS_BLOCKCACHE
+  /* Write back any cached sectors and detach the driver from the cache */
+
+  if (find_blockdriver(path, MS_RDONLY, &inode) >= 0)
+    {
+      (void)blockcache_detach(inode);
+      inode_release(inode);
+    }
+#endif
+
   inode_semtake();
   ret = inode_remove(path);
   inode_semgive();
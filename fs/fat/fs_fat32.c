@@ -50,6 +50,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/ioctl.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -423,6 +424,15 @@ static int fat_close(FAR struct file *filep)
        * the file even when there is healthy mount.
        */
 
+      /* Release any reserved clusters beyond the end of the file */
+
+      if ((ff->ff_bflags & FFBUFF_PREALLOC) != 0)
+        {
+          fat_semtake(fs);
+          (void)fat_trimchain(fs, ff);
+          fat_semgive(fs);
+        }
+
       /* Synchronize the file buffers and disk content; update times */
 
       ret = fat_sync(filep);
@@ -606,13 +616,10 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and any following, adjacent clusters.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contigsectors(fs, ff, nsectors, false);
 
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
@@ -645,9 +652,8 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_advancesectors(fs, ff, nsectors);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -865,13 +871,11 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and any following, adjacent clusters.  The
+           * cluster chain is extended as necessary.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contigsectors(fs, ff, nsectors, true);
 
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
@@ -905,10 +909,9 @@ fat_write_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_advancesectors(fs, ff, nsectors);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -1299,6 +1302,17 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  /* Reserve clusters for the file */
+
+  if (cmd == FIOC_PREALLOC)
+    {
+      FAR const off_t *length = (FAR const off_t *)((uintptr_t)arg);
+
+      ret = length != NULL ? fat_prealloc(fs, ff, *length) : -EINVAL;
+      fat_semgive(fs);
+      return ret;
+    }
+
   /* ioctl calls are just passed through to the contained block driver */
 
   fat_semgive(fs);
@@ -2162,6 +2176,12 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#if CONFIG_FAT_NCACHESECTORS > 0
+  /* Write back any dirty sectors still held in the sector cache */
+
+  (void)fat_fscacheflush(fs);
+
+#endif
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2194,6 +2214,21 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_NCACHESECTORS > 0
+  if (fs->fs_cachebuffer)
+    {
+      fat_io_free(fs->fs_cachebuffer,
+                  CONFIG_FAT_NCACHESECTORS * fs->fs_hwsectorsize);
+    }
+#endif
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap[0])
+    {
+      kmm_free(fs->fs_freemap[0]);
+    }
+#endif
+
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
@@ -292,6 +292,10 @@
 
 #define UMOUNT_FORCED       8
 
+/* Clusters were reserved beyond the end of the file (ff_bflags) */
+
+#define FFBUFF_PREALLOC     16
+
 /****************************************************************************
  * These offset describe the FSINFO sector
  */
@@ -720,10 +724,40 @@
 #  define fat_io_free(m,s) kmm_free(m)
 #endif
 
+/* The number of sectors retained in the FAT sector cache in addition to
+ * fs_buffer
+ */
+
+#ifndef CONFIG_FAT_NCACHESECTORS
+#  define CONFIG_FAT_NCACHESECTORS 0
+#endif
+
+/* The maximum number of levels in the free cluster bitmap:  Enough for 2**28
+ * clusters with 32 entries per word at each level.
+ */
+
+#define FAT_FREEMAP_NLEVELS 6
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_FAT_NCACHESECTORS > 0
+/* This structure describes one sector held in the FAT sector cache.  A
+ * sector is held either in fs_buffer or in the sector cache, but never in
+ * both:  A sector is moved into the cache when it is displaced from
+ * fs_buffer and moved back into fs_buffer when it is accessed again.
+ */
+
+struct fat_cachesect_s
+{
+  off_t    cs_sector;              /* The sector number held in this entry */
+  uint32_t cs_lastuse;             /* Time of last use (for LRU replacement) */
+  bool     cs_valid;               /* true: The entry holds a sector */
+  bool     cs_dirty;               /* true: The entry must be written back */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -758,6 +792,17 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#if CONFIG_FAT_NCACHESECTORS > 0
+  uint32_t fs_cacheclock;          /* Incremented on each sector cache access */
+  uint8_t *fs_cachebuffer;         /* Sector data for each entry of fs_cache[] */
+  struct fat_cachesect_s fs_cache[CONFIG_FAT_NCACHESECTORS];
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  uint8_t  fs_freelevels;          /* Number of levels in fs_freemap[] */
+  uint32_t *fs_freemap[FAT_FREEMAP_NLEVELS]; /* Cluster bitmap (bit set if in use)
+                                    * and summaries (bit set if word below is
+                                    * full).  NULL until first used. */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -949,6 +994,18 @@ EXTERN int    fat_updatefsinfo(struct fat_mountpt_s *fs);
 EXTERN int    fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters);
 EXTERN int    fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t position);
 
+/* Contiguous multi-cluster transfers and cluster pre-allocation */
+
+EXTERN unsigned int fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                                      FAR struct fat_file_s *ff,
+                                      unsigned int nsectors, bool extend);
+EXTERN void   fat_advancesectors(FAR struct fat_mountpt_s *fs,
+                                 FAR struct fat_file_s *ff,
+                                 unsigned int nsectors);
+EXTERN int    fat_prealloc(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                           off_t length);
+EXTERN int    fat_trimchain(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -54,6 +54,7 @@
 #include <time.h>
 #include <semaphore.h>
 #include <assert.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -64,6 +65,19 @@
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The sector data of entry 'n' of the FAT sector cache */
+
+#define FAT_CACHEBUFFER(fs,n) (&(fs)->fs_cachebuffer[(n) * (fs)->fs_hwsectorsize])
+
+/* The number of words in level 'l' of the free cluster bitmap */
+
+#define FAT_FREEMAP_NWORDS(fs,l) \
+  (((fs)->fs_nclusters + ((uint32_t)1 << (5 * ((l) + 1))) - 1) >> (5 * ((l) + 1)))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -97,6 +111,485 @@ static int fat_checkfsinfo(struct fat_mountpt_s *fs)
   return -ENODEV;
 }
 
+/****************************************************************************
+ * Name: fat_writesector
+ *
+ * Description:
+ *   Write one sector from the provided buffer.  If the sector lies in the
+ *   FAT region, then the same change is made in each of the FAT copies.
+ *
+ ****************************************************************************/
+
+static int fat_writesector(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                           off_t sector)
+{
+  int ret;
+
+  ret = fat_hwwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase && sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      int i;
+
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cachefind
+ *
+ * Description:
+ *   Return the index of the sector cache entry holding 'sector' or -1 if
+ *   the sector is not in the sector cache.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCACHESECTORS > 0
+static int fat_cachefind(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      if (fs->fs_cache[i].cs_valid && fs->fs_cache[i].cs_sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_cachestash
+ *
+ * Description:
+ *   Move the sector in fs_buffer into the sector cache so that fs_buffer
+ *   may be re-used.  If the sector cache is full, then the least recently
+ *   used entry is replaced, writing it back to the media first if it is
+ *   dirty.  Upon return, fs_buffer no longer holds any sector.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NCACHESECTORS > 0
+static int fat_cachestash(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *cs;
+  bool dirty;
+  int ndx;
+  int ret;
+  int i;
+
+  if (fs->fs_currentsector < 0)
+    {
+      /* fs_buffer does not hold any sector */
+
+      return OK;
+    }
+
+  /* If the caller re-purposed fs_buffer, then there may be an older copy
+   * of the same sector in the cache.  That entry is simply overwritten.
+   */
+
+  ndx = fat_cachefind(fs, fs->fs_currentsector);
+  if (ndx >= 0)
+    {
+      cs    = &fs->fs_cache[ndx];
+      dirty = fs->fs_dirty || cs->cs_dirty;
+    }
+  else
+    {
+      /* Otherwise, use an unused entry or the least recently used entry */
+
+      for (i = 0, ndx = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+        {
+          if (!fs->fs_cache[i].cs_valid)
+            {
+              ndx = i;
+              break;
+            }
+
+          if ((int32_t)(fs->fs_cache[i].cs_lastuse -
+                        fs->fs_cache[ndx].cs_lastuse) < 0)
+            {
+              ndx = i;
+            }
+        }
+
+      /* Write back the replaced sector if it is dirty */
+
+      cs = &fs->fs_cache[ndx];
+      if (cs->cs_valid && cs->cs_dirty)
+        {
+          ret = fat_writesector(fs, FAT_CACHEBUFFER(fs, ndx), cs->cs_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      dirty = fs->fs_dirty;
+    }
+
+  /* Move the sector out of fs_buffer and into the cache entry */
+
+  memcpy(FAT_CACHEBUFFER(fs, ndx), fs->fs_buffer, fs->fs_hwsectorsize);
+
+  cs->cs_sector        = fs->fs_currentsector;
+  cs->cs_lastuse       = ++fs->fs_cacheclock;
+  cs->cs_valid         = true;
+  cs->cs_dirty         = dirty;
+
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapupdate
+ *
+ * Description:
+ *   Mark a cluster as in-use or free in the free cluster bitmap and update
+ *   the summary levels above it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static void fat_freemapupdate(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                              bool inuse)
+{
+  FAR uint32_t *word;
+  uint32_t bit;
+  bool full;
+  int level;
+
+  for (level = 0; level < fs->fs_freelevels; level++)
+    {
+      word = &fs->fs_freemap[level][cluster >> 5];
+      bit  = (uint32_t)1 << (cluster & 31);
+
+      /* The summary bit in the next level must change only if this word
+       * becomes full or is no longer full.
+       */
+
+      if (inuse)
+        {
+          *word |= bit;
+          if (*word != 0xffffffff)
+            {
+              break;
+            }
+        }
+      else
+        {
+          full   = (*word == 0xffffffff);
+          *word &= ~bit;
+          if (!full)
+            {
+              break;
+            }
+        }
+
+      cluster >>= 5;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Description:
+ *   Return the first free cluster with a cluster number greater than or
+ *   equal to 'cluster' or zero if there is none.  Each summary level has
+ *   one bit per word of the level below that is set if the word is full,
+ *   so the search skips over allocated regions in O(log n) steps.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static uint32_t fat_freemapfind(FAR struct fat_mountpt_s *fs,
+                                uint32_t cluster)
+{
+  uint32_t avail;
+  uint32_t word;
+  int level = 0;
+
+  if (cluster >= fs->fs_nclusters)
+    {
+      return 0;
+    }
+
+  for (; ; )
+    {
+      word  = cluster >> 5;
+      avail = ~fs->fs_freemap[level][word] & (0xffffffff << (cluster & 31));
+
+      if (avail != 0)
+        {
+          /* Find the first free entry in the remainder of this word */
+
+          cluster = word << 5;
+          while ((avail & 1) == 0)
+            {
+              avail >>= 1;
+              cluster++;
+            }
+
+          if (level == 0)
+            {
+              return cluster;
+            }
+
+          /* Then descend to the word that it summarizes */
+
+          level--;
+          cluster <<= 5;
+        }
+      else
+        {
+          /* Nothing is free in the rest of this word.  Continue with the
+           * following word by way of the next level up.
+           */
+
+          level++;
+          cluster = word + 1;
+
+          if (level >= fs->fs_freelevels ||
+              (cluster >> 5) >= FAT_FREEMAP_NWORDS(fs, level))
+            {
+              return 0;
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Search the free cluster bitmap for a free cluster, beginning with the
+ *   cluster after 'startcluster' and wrapping back to cluster 2.  Returns
+ *   zero if there is no free cluster.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static uint32_t fat_freemapsearch(FAR struct fat_mountpt_s *fs,
+                                  uint32_t startcluster)
+{
+  uint32_t cluster;
+
+  cluster = fat_freemapfind(fs, startcluster + 1);
+  if (cluster == 0)
+    {
+      /* There is nothing free after the start cluster.  Any free cluster
+       * found from the beginning lies at or before the start cluster.
+       */
+
+      cluster = fat_freemapfind(fs, 2);
+    }
+
+  return cluster;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapextent
+ *
+ * Description:
+ *   Return the first cluster of the first run of at least 'nclusters'
+ *   free clusters or, if there is no such run, of the longest run of free
+ *   clusters.  Returns zero if there is no free cluster.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static uint32_t fat_freemapextent(FAR struct fat_mountpt_s *fs,
+                                  uint32_t nclusters)
+{
+  FAR const uint32_t *map = fs->fs_freemap[0];
+  uint32_t bestcluster = 0;
+  uint32_t bestlength = 0;
+  uint32_t cluster;
+  uint32_t end;
+
+  cluster = fat_freemapfind(fs, 2);
+  while (cluster != 0)
+    {
+      /* Find the end of this run of free clusters, skipping over entire
+       * words with no cluster in use.
+       */
+
+      end = cluster + 1;
+      while (end < fs->fs_nclusters &&
+             (map[end >> 5] & ((uint32_t)1 << (end & 31))) == 0)
+        {
+          if ((end & 31) == 0 && map[end >> 5] == 0)
+            {
+              end += 32;
+            }
+          else
+            {
+              end++;
+            }
+        }
+
+      if (end - cluster >= nclusters)
+        {
+          return cluster;
+        }
+
+      if (end - cluster > bestlength)
+        {
+          bestcluster = cluster;
+          bestlength  = end - cluster;
+        }
+
+      cluster = fat_freemapfind(fs, end + 1);
+    }
+
+  return bestcluster;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Allocate the free cluster bitmap and its summary levels and initialize
+ *   them by scanning the entire FAT.  The free cluster count is updated as
+ *   a side effect.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  FAR uint32_t *map;
+  uint32_t nfreeclusters;
+  uint32_t nwords;
+  uint32_t cluster;
+  uint32_t total;
+  uint32_t i;
+  off_t nextcluster;
+  int level;
+
+  /* Determine the number of levels.  The top level is a single word. */
+
+  total = 0;
+  level = 0;
+
+  do
+    {
+      nwords = FAT_FREEMAP_NWORDS(fs, level);
+      total += nwords;
+      level++;
+    }
+  while (nwords > 1 && level < FAT_FREEMAP_NLEVELS);
+
+  map = (FAR uint32_t *)kmm_zalloc(total * sizeof(uint32_t));
+  if (map == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fs->fs_freelevels = level;
+  for (level = 0; level < fs->fs_freelevels; level++)
+    {
+      fs->fs_freemap[level] = map;
+      map += FAT_FREEMAP_NWORDS(fs, level);
+    }
+
+  /* Clusters 0 and 1 are reserved */
+
+  map           = fs->fs_freemap[0];
+  map[0]        = 3;
+  nfreeclusters = 0;
+
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      nextcluster = fat_getcluster(fs, cluster);
+      if (nextcluster < 0)
+        {
+          kmm_free(fs->fs_freemap[0]);
+          fs->fs_freemap[0] = NULL;
+          return (int)nextcluster;
+        }
+      else if (nextcluster != 0)
+        {
+          map[cluster >> 5] |= ((uint32_t)1 << (cluster & 31));
+        }
+      else
+        {
+          nfreeclusters++;
+        }
+    }
+
+  /* Mark the unused bits at the end of each level as in-use and build each
+   * summary level from the level below.
+   */
+
+  for (level = 0; level < fs->fs_freelevels; level++)
+    {
+      map    = fs->fs_freemap[level];
+      nwords = FAT_FREEMAP_NWORDS(fs, level);
+      i      = level > 0 ? FAT_FREEMAP_NWORDS(fs, level - 1) :
+                           fs->fs_nclusters;
+
+      for (; i < (nwords << 5); i++)
+        {
+          map[i >> 5] |= ((uint32_t)1 << (i & 31));
+        }
+
+      if (level + 1 < fs->fs_freelevels)
+        {
+          for (i = 0; i < nwords; i++)
+            {
+              if (map[i] == 0xffffffff)
+                {
+                  fs->fs_freemap[level + 1][i >> 5] |=
+                    ((uint32_t)1 << (i & 31));
+                }
+            }
+        }
+    }
+
+  /* The free cluster count is now known exactly */
+
+  if (fs->fs_fsifreecount != nfreeclusters)
+    {
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_checkbootrecord
  *
@@ -547,6 +1040,22 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#if CONFIG_FAT_NCACHESECTORS > 0
+  /* Allocate the sector cache.  fs_buffer does not yet hold any sector. */
+
+  fs->fs_cachebuffer = (FAR uint8_t *)
+    fat_io_alloc(CONFIG_FAT_NCACHESECTORS * fs->fs_hwsectorsize);
+
+  if (!fs->fs_cachebuffer)
+    {
+      ret = -ENOMEM;
+      goto errout_with_buffer;
+    }
+
+  memset(fs->fs_cache, 0, sizeof(fs->fs_cache));
+  fs->fs_currentsector = -1;
+#endif
+
   /* Search FAT boot record on the drive.  First check at sector zero.  This
    * could be either the boot record or a partition that refers to the boot
    * record.
@@ -670,6 +1179,15 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#if CONFIG_FAT_NCACHESECTORS > 0
+  if (fs->fs_cachebuffer)
+    {
+      fat_io_free(fs->fs_cachebuffer,
+                  CONFIG_FAT_NCACHESECTORS * fs->fs_hwsectorsize);
+      fs->fs_cachebuffer = NULL;
+    }
+
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
@@ -737,6 +1255,34 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
+
+#if CONFIG_FAT_NCACHESECTORS > 0
+      FAR struct fat_cachesect_s *cs;
+      int i;
+
+      /* The media is not current for any dirty sector in the sector cache
+       * that lies in the range to be read.  Write back those sectors first.
+       */
+
+      for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+        {
+          cs = &fs->fs_cache[i];
+          if (cs->cs_valid && cs->cs_dirty && cs->cs_sector >= sector &&
+              cs->cs_sector < sector + nsectors)
+            {
+              ret = fat_writesector(fs, FAT_CACHEBUFFER(fs, i),
+                                    cs->cs_sector);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              cs->cs_dirty = false;
+              ret          = -ENODEV;
+            }
+        }
+#endif
+
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
           ssize_t nSectorsRead = inode->u.i_bops->read(inode, buffer,
@@ -770,6 +1316,25 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
+
+#if CONFIG_FAT_NCACHESECTORS > 0
+      FAR struct fat_cachesect_s *cs;
+      int i;
+
+      /* Any other copy of the sectors in the sector cache is now stale */
+
+      for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+        {
+          cs = &fs->fs_cache[i];
+          if (cs->cs_valid && cs->cs_sector >= sector &&
+              cs->cs_sector < sector + nsectors &&
+              FAT_CACHEBUFFER(fs, i) != buffer)
+            {
+              cs->cs_valid = false;
+            }
+        }
+#endif
+
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nSectorsWritten =
@@ -1095,6 +1660,15 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* Keep the free cluster bitmap in agreement with the FAT */
+
+      if (fs->fs_freemap[0] != NULL && clusterno >= 2)
+        {
+          fat_freemapupdate(fs, clusterno, nextcluster != 0);
+        }
+
+#endif
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1221,61 +1795,78 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
+#ifdef CONFIG_FAT_FREEMAP
+  /* Search the free cluster bitmap (building it first if necessary) rather
+   * than reading the FAT.
    */
 
-  newcluster = startcluster;
-  for (; ; )
+  if (fs->fs_freemap[0] != NULL || fat_freemapbuild(fs) == OK)
+    {
+      newcluster = fat_freemapsearch(fs, startcluster);
+      if (newcluster == 0)
+        {
+          return 0;
+        }
+    }
+  else
+#endif
     {
-      /* Examine the next cluster in the FAT */
+      /* Loop until (1) we discover that there are not free clusters
+       * (return 0), an errors occurs (return -errno), or (3) we find
+       * the next cluster (return the new cluster number).
+       */
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
+      newcluster = startcluster;
+      for (; ; )
         {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
+          /* Examine the next cluster in the FAT */
 
-          newcluster = 2;
-          if (newcluster > startcluster)
+          newcluster++;
+          if (newcluster >= fs->fs_nclusters)
             {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
+              /* If we hit the end of the available clusters, then
+               * wrap back to the beginning because we might have
+               * started at a non-optimal place.  But don't continue
+               * past the start cluster.
                */
 
-              return 0;
+              newcluster = 2;
+              if (newcluster > startcluster)
+                {
+                  /* We are back past the starting cluster, then there
+                   * is no free cluster.
+                   */
+
+                  return 0;
+                }
             }
-        }
 
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
+          /* We have a candidate cluster.  Check if the cluster number is
+           * mapped to a group of sectors.
+           */
 
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
+          startsector = fat_getcluster(fs, newcluster);
+          if (startsector == 0)
+            {
+              /* Found have found a free cluster break out */
 
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
+              break;
+            }
+          else if (startsector < 0)
+            {
+              /* Some error occurred, return the error number */
 
-          return startsector;
-        }
+              return startsector;
+            }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+          /* We wrap all the back to the starting cluster?  If so, then
+           * there are no free clusters.
+           */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
+          if (newcluster == startcluster)
+            {
+              return 0;
+            }
         }
     }
 
@@ -1763,40 +2354,46 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
   int ret;
 
+#if CONFIG_FAT_NCACHESECTORS > 0
+  int i;
+
+  /* Write back each dirty sector in the sector cache.  This must be done
+   * before fs_buffer is written:  If fs_buffer was re-purposed, then an
+   * older copy of the same sector may still be in the sector cache.
+   */
+
+  for (i = 0; i < CONFIG_FAT_NCACHESECTORS; i++)
+    {
+      if (fs->fs_cache[i].cs_valid && fs->fs_cache[i].cs_dirty)
+        {
+          ret = fat_writesector(fs, FAT_CACHEBUFFER(fs, i),
+                                fs->fs_cache[i].cs_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          fs->fs_cache[i].cs_dirty = false;
+        }
+    }
+#endif
+
   /* Check if the fs_buffer is dirty.  In this case, we will write back the
    * contents of fs_buffer.
    */
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
+      /* Write the dirty sector (and any FAT copies).  fs_currentsector is
+       * not modified so that the sector remains in the cache.
+       */
 
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_writesector(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
-
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          int i;
-
-          /* Yes, then make the change in the FAT copy as well */
-
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
-            {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-            }
-        }
-
       /* No longer dirty */
 
       fs->fs_dirty = false;
@@ -1825,6 +2422,34 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   if (fs->fs_currentsector != sector)
     {
+#if CONFIG_FAT_NCACHESECTORS > 0
+      int ndx;
+
+      /* Move the current sector into the sector cache.  This may write back
+       * the least recently used sector in the sector cache.
+       */
+
+      ret = fat_cachestash(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* If the new sector is in the sector cache, then move it into
+       * fs_buffer.  It is no longer held in the sector cache.
+       */
+
+      ndx = fat_cachefind(fs, sector);
+      if (ndx >= 0)
+        {
+          memcpy(fs->fs_buffer, FAT_CACHEBUFFER(fs, ndx), fs->fs_hwsectorsize);
+
+          fs->fs_currentsector       = sector;
+          fs->fs_dirty               = fs->fs_cache[ndx].cs_dirty;
+          fs->fs_cache[ndx].cs_valid = false;
+          return OK;
+        }
+#else
       /* We will need to read the new sector.  First, flush the cached
        * sector if it is dirty.
        */
@@ -1834,6 +2459,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
         {
           return ret;
         }
+#endif
 
       /* Then read the specified sector into the cache */
 
@@ -2037,6 +2663,18 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
       return OK;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Otherwise, building the free cluster bitmap will count the number of
+   * free clusters.  The count is maintained exactly thereafter.
+   */
+
+  if (fs->fs_freemap[0] != NULL || fat_freemapbuild(fs) == OK)
+    {
+      *pfreeclusters = fs->fs_fsifreecount;
+      return OK;
+    }
+
+#endif
   /* Otherwise, we will have to count the number of free clusters */
 
   nfreeclusters = 0;
@@ -2081,12 +2719,9 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
                   return ret;
                 }
 
-              /* Reset the offset to the next FAT entry.
-               * Increment the sector number to read next time around.
-               */
+              /* Reset the offset to the next FAT entry */
 
               offset = 0;
-              fatsector++;
             }
 
           /* FAT16 and FAT32 differ only on the size of each cluster start
@@ -2165,3 +2800,250 @@ int fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff,
 
   return -ENOSPC;
 }
+
+/****************************************************************************
+ * Name: fat_contigsectors
+ *
+ * Description:
+ *   Return the number of physically contiguous sectors, up to 'nsectors',
+ *   beginning with the current sector of the file.  The run continues
+ *   beyond the current cluster for as long as the following clusters in
+ *   the chain are adjacent on the media.  If 'extend' is true, then the
+ *   cluster chain is extended as necessary (fat_extendchain() prefers the
+ *   cluster immediately following the last cluster of the chain).
+ *
+ *   The file position is not modified.  fat_advancesectors() must be
+ *   called after the sectors have been transferred.
+ *
+ ****************************************************************************/
+
+unsigned int fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                               FAR struct fat_file_s *ff,
+                               unsigned int nsectors, bool extend)
+{
+  unsigned int contig;
+  uint32_t cluster;
+  off_t nextcluster;
+
+  contig  = ff->ff_sectorsincluster;
+  cluster = ff->ff_currentcluster;
+
+  while (contig < nsectors)
+    {
+      if (extend)
+        {
+          nextcluster = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          nextcluster = fat_getcluster(fs, cluster);
+        }
+
+      /* Stop at the end of the chain, on any error, or if the next cluster
+       * is not adjacent.  Errors are reported when the next cluster is
+       * accessed in the normal way.
+       */
+
+      if (nextcluster < 2 || (uint32_t)nextcluster != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = nextcluster;
+      contig += fs->fs_fatsecperclus;
+    }
+
+  return contig < nsectors ? contig : nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_advancesectors
+ *
+ * Description:
+ *   Advance the current sector of the file by 'nsectors', a count returned
+ *   by fat_contigsectors().
+ *
+ ****************************************************************************/
+
+void fat_advancesectors(FAR struct fat_mountpt_s *fs,
+                        FAR struct fat_file_s *ff, unsigned int nsectors)
+{
+  unsigned int remaining = ff->ff_sectorsincluster;
+  unsigned int nclusters;
+
+  if (nsectors > remaining)
+    {
+      /* The transfer continued into the following, adjacent clusters */
+
+      nclusters = (nsectors - remaining + fs->fs_fatsecperclus - 1) /
+                  fs->fs_fatsecperclus;
+
+      ff->ff_currentcluster += nclusters;
+      remaining             += nclusters * fs->fs_fatsecperclus;
+    }
+
+  ff->ff_sectorsincluster = remaining - nsectors;
+  ff->ff_currentsector   += nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_prealloc
+ *
+ * Description:
+ *   Make sure that the cluster chain of the file is long enough to hold
+ *   'length' bytes.  New clusters are allocated following the current end
+ *   of the chain so that they are contiguous whenever free space permits.
+ *   The file size is not changed.  Clusters beyond the end of the file are
+ *   released by fat_trimchain() when the file is closed.
+ *
+ ****************************************************************************/
+
+int fat_prealloc(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
+                 off_t length)
+{
+  uint32_t clustersize;
+  uint32_t nclusters;
+  int32_t cluster;
+
+  if ((ff->ff_oflags & O_WROK) == 0)
+    {
+      return -EACCES;
+    }
+
+  clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  nclusters   = (length + clustersize - 1) / clustersize;
+  if (nclusters == 0)
+    {
+      return OK;
+    }
+
+  /* Has the starting cluster been defined? */
+
+  if (ff->ff_startcluster == 0)
+    {
+#ifdef CONFIG_FAT_FREEMAP
+      uint32_t extent;
+
+      /* Start the new chain at the beginning of a run of free clusters
+       * large enough to hold the file (or of the longest run).
+       */
+
+      if (fs->fs_freemap[0] != NULL || fat_freemapbuild(fs) == OK)
+        {
+          extent = fat_freemapextent(fs, nclusters);
+          if (extent >= 2)
+            {
+              fs->fs_fsinextfree = extent - 1;
+            }
+        }
+
+#endif
+      /* No.. we have to create a new cluster chain */
+
+      cluster = fat_createchain(fs);
+      if (cluster < 0)
+        {
+          return cluster;
+        }
+      else if (cluster < 2)
+        {
+          return -ENOSPC;
+        }
+
+      ff->ff_startcluster     = cluster;
+      ff->ff_currentcluster   = cluster;
+      ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+    }
+
+  ff->ff_bflags |= (FFBUFF_PREALLOC | FFBUFF_MODIFIED);
+
+  /* Follow the chain, extending it when its end is reached */
+
+  for (cluster = ff->ff_startcluster; nclusters > 1; nclusters--)
+    {
+      cluster = fat_extendchain(fs, cluster);
+      if (cluster < 0)
+        {
+          return cluster;
+        }
+      else if (cluster < 2 || cluster >= fs->fs_nclusters)
+        {
+          return -ENOSPC;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_trimchain
+ *
+ * Description:
+ *   Release any clusters reserved by fat_prealloc() that lie beyond the
+ *   end of the file.
+ *
+ ****************************************************************************/
+
+int fat_trimchain(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff)
+{
+  uint32_t clustersize;
+  uint32_t nclusters;
+  off_t cluster;
+  off_t nextcluster;
+  int ret = OK;
+
+  ff->ff_bflags &= ~FFBUFF_PREALLOC;
+  if (ff->ff_startcluster == 0)
+    {
+      return OK;
+    }
+
+  ff->ff_bflags |= FFBUFF_MODIFIED;
+  clustersize    = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+  nclusters      = (ff->ff_size + clustersize - 1) / clustersize;
+
+  if (nclusters == 0)
+    {
+      /* Nothing was written.  Release the entire chain. */
+
+      ret = fat_removechain(fs, ff->ff_startcluster);
+      ff->ff_startcluster   = 0;
+      ff->ff_currentcluster = 0;
+      ff->ff_currentsector  = 0;
+      return ret;
+    }
+
+  /* Find the last cluster that holds file data */
+
+  for (cluster = ff->ff_startcluster; nclusters > 1; nclusters--)
+    {
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 0)
+        {
+          return (int)cluster;
+        }
+      else if (cluster < 2 || cluster >= fs->fs_nclusters)
+        {
+          return -EINVAL;
+        }
+    }
+
+  /* Terminate the chain there and release the remainder */
+
+  nextcluster = fat_getcluster(fs, cluster);
+  if (nextcluster < 0)
+    {
+      return (int)nextcluster;
+    }
+  else if (nextcluster >= 2 && nextcluster < fs->fs_nclusters)
+    {
+      ret = fat_putcluster(fs, cluster, 0x0fffffff);
+      if (ret >= 0)
+        {
+          ret = fat_removechain(fs, nextcluster);
+        }
+    }
+
+  return ret;
+}
+
@@ -134,8 +134,8 @@ int file_detach(int fd, FAR struct file *filep)
   /* If the file was properly opened, there should be an inode assigned */
 
   _files_semtake(list);
-  parent = &list->fl_files[fd];
-  if (parent->f_inode == NULL)
+  parent = files_fget(list, fd, false);
+  if (parent == NULL || parent->f_inode == NULL)
     {
       /* File is not open */
 
@@ -152,6 +152,12 @@ int file_detach(int fd, FAR struct file *filep)
   filep->f_inode   = parent->f_inode;
   filep->f_priv    = parent->f_priv;
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* poll() registrations refer to the file descriptor being released */
+
+  poll_forget(parent);
+#endif
+
   /* Release the file descriptore *without* calling the drive close method
    * and without decrementing the inode reference count.  That will be done
    * in file_close_detached().
@@ -161,6 +167,7 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_pos    = 0;
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
+  FILES_CLRINUSE(list, fd);
 
   _files_semgive(list);
   return OK;
@@ -85,6 +85,48 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_fget
+ *
+ * Description:
+ *   Return the struct file instance of a file descriptor, allocating the
+ *   block that holds it if necessary and if 'alloc' is true.
+ *
+ * Assumptions:
+ *   The descriptor is in range.  The caller holds the list semaphore if
+ *   'alloc' is true.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+static FAR struct file *_files_fget(FAR struct filelist *list, int fd,
+                                    bool alloc)
+{
+  FAR struct file *block = list->fl_blocks[fd / FILELIST_BLKSIZE];
+
+  if (block == NULL)
+    {
+      if (!alloc)
+        {
+          return NULL;
+        }
+
+      block = (FAR struct file *)
+        kmm_zalloc(FILELIST_BLKSIZE * sizeof(struct file));
+      if (block == NULL)
+        {
+          return NULL;
+        }
+
+      list->fl_blocks[fd / FILELIST_BLKSIZE] = block;
+    }
+
+  return &block[fd % FILELIST_BLKSIZE];
+}
+#else
+#  define _files_fget(list,fd,alloc) (&(list)->fl_files[fd])
+#endif
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -105,6 +147,12 @@ static int _files_close(FAR struct file *filep)
 
   if (inode)
     {
+#ifdef CONFIG_FS_POLLCACHE
+      /* Remove any poll() registrations that outlive the poll() calls */
+
+      poll_forget(filep);
+#endif
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
@@ -181,14 +229,109 @@ void files_releaselist(FAR struct filelist *list)
 
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      (void)_files_close(&list->fl_files[i]);
+      FAR struct file *filep = _files_fget(list, i, false);
+      if (filep != NULL)
+        {
+          (void)_files_close(filep);
+        }
+    }
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+  /* Free the blocks of struct file instances */
+
+  for (i = 0; i < FILELIST_NBLOCKS; i++)
+    {
+      if (list->fl_blocks[i] != NULL)
+        {
+          kmm_free(list->fl_blocks[i]);
+          list->fl_blocks[i] = NULL;
+        }
     }
+#endif
 
   /* Destroy the semaphore */
 
   (void)nxsem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the struct file instance of a file descriptor in a list.  If
+ *   'alloc' is true, then storage for the descriptor is allocated if
+ *   necessary.
+ *
+ * Returned Value:
+ *   The struct file instance or NULL if the descriptor is out of range or
+ *   if no storage for it has been allocated (and it could not be
+ *   allocated).
+ *
+ ****************************************************************************/
+
+FAR struct file *files_fget(FAR struct filelist *list, int fd, bool alloc)
+{
+  FAR struct file *filep;
+
+  DEBUGASSERT(list != NULL);
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  filep = _files_fget(list, fd, false);
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+  if (filep == NULL && alloc)
+    {
+      _files_semtake(list);
+      filep = _files_fget(list, fd, true);
+      _files_semgive(list);
+    }
+#endif
+
+  return filep;
+}
+
+/****************************************************************************
+ * Name: files_getfd
+ *
+ * Description:
+ *   Return the file descriptor of a struct file instance in a list.
+ *
+ * Returned Value:
+ *   The file descriptor or -EBADF if the instance does not belong to the
+ *   list.
+ *
+ ****************************************************************************/
+
+int files_getfd(FAR struct filelist *list, FAR struct file *filep)
+{
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+  FAR struct file *block;
+  int i;
+
+  for (i = 0; i < FILELIST_NBLOCKS; i++)
+    {
+      block = list->fl_blocks[i];
+      if (block != NULL && filep >= block &&
+          filep < &block[FILELIST_BLKSIZE])
+        {
+          return i * FILELIST_BLKSIZE + (int)(filep - block);
+        }
+    }
+#else
+  if (filep >= list->fl_files &&
+      filep < &list->fl_files[CONFIG_NFILE_DESCRIPTORS])
+    {
+      return (int)(filep - list->fl_files);
+    }
+#endif
+
+  return -EBADF;
+}
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -211,6 +354,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
   FAR struct filelist *list;
   FAR struct inode *inode;
   int ret;
+  int fd;
 
   if (!filep1 || !filep1->f_inode || !filep2)
     {
@@ -285,6 +429,14 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 
   if (list != NULL)
     {
+      /* Mark the descriptor as in use if it belongs to our list */
+
+      fd = files_getfd(list, filep2);
+      if (fd >= 0)
+        {
+          FILES_SETINUSE(list, fd);
+        }
+
       _files_semgive(list);
     }
 
@@ -301,6 +453,14 @@ errout_with_inode:
 errout_with_sem:
   if (list != NULL)
     {
+      /* The old content of filep2 was closed */
+
+      fd = files_getfd(list, filep2);
+      if (fd >= 0)
+        {
+          FILES_CLRINUSE(list, fd);
+        }
+
       _files_semgive(list);
     }
 
@@ -312,13 +472,17 @@ errout_with_sem:
  *
  * Description:
  *   Allocate a struct files instance and associate it with an inode instance.
- *   Returns the file descriptor == index into the files array.
+ *   Returns the file descriptor == index into the files array.  The lowest
+ *   free descriptor is found from the bitmap of descriptors in use, one
+ *   32-bit word at a time.
  *
  ****************************************************************************/
 
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
+  uint32_t avail;
   int i;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
@@ -326,18 +490,61 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  if (minfd < 0)
+    {
+      minfd = 0;
+    }
+
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; )
     {
-      if (!list->fl_files[i].f_inode)
+      /* Get the free descriptors at or above 'i' in this word */
+
+      avail = ~list->fl_inuse[i >> 5] & ((uint32_t)0xffffffff << (i & 31));
+      if (avail == 0)
+        {
+          /* None.. skip to the next word */
+
+          i = ((i >> 5) + 1) << 5;
+          continue;
+        }
+
+      while ((avail & ((uint32_t)1 << (i & 31))) == 0)
+        {
+          i++;
+        }
+
+      if (i >= CONFIG_NFILE_DESCRIPTORS)
+        {
+          break;
+        }
+
+      filep = _files_fget(list, i, true);
+      if (filep == NULL)
+        {
+          /* Out of memory */
+
+          break;
+        }
+
+      FILES_SETINUSE(list, i);
+
+      /* A descriptor may have been filled in by file_dup2() without its
+       * bit being set.  The bit is now correct; try the next one.
+       */
+
+      if (filep->f_inode != NULL)
         {
-           list->fl_files[i].f_oflags = oflags;
-           list->fl_files[i].f_pos    = pos;
-           list->fl_files[i].f_inode  = inode;
-           list->fl_files[i].f_priv   = NULL;
-           _files_semgive(list);
-           return i;
+          i++;
+          continue;
         }
+
+      filep->f_oflags = oflags;
+      filep->f_pos    = pos;
+      filep->f_inode  = inode;
+      filep->f_priv   = NULL;
+      _files_semgive(list);
+      return i;
     }
 
   _files_semgive(list);
@@ -358,6 +565,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -369,7 +577,8 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS || !list->fl_files[fd].f_inode)
+  filep = files_fget(list, fd, false);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -377,7 +586,8 @@ int files_close(int fd)
   /* Perform the protected close operation */
 
   _files_semtake(list);
-  ret = _files_close(&list->fl_files[fd]);
+  ret = _files_close(filep);
+  FILES_CLRINUSE(list, fd);
   _files_semgive(list);
   return ret;
 }
@@ -394,16 +604,19 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
 
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  filep = files_fget(list, fd, false);
+  if (filep != NULL)
     {
       _files_semtake(list);
-      list->fl_files[fd].f_oflags  = 0;
-      list->fl_files[fd].f_pos     = 0;
-      list->fl_files[fd].f_inode = NULL;
+      filep->f_oflags  = 0;
+      filep->f_pos     = 0;
+      filep->f_inode = NULL;
+      FILES_CLRINUSE(list, fd);
       _files_semgive(list);
     }
 }
@@ -41,6 +41,7 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
@@ -72,6 +73,12 @@ struct inode_sem_s
   sem_t   sem;     /* The semaphore */
   pid_t   holder;  /* The current holder of the semaphore */
   int16_t count;   /* Number of counts held */
+#ifdef CONFIG_FS_INODE_LOCKFREE
+  unsigned int seq;              /* Odd while the tree may be changing */
+  unsigned int epoch;            /* Reclamation epoch */
+  int readers[2];                /* Lock-free walks, by epoch parity */
+  FAR struct inode *retired[2];  /* Inodes retired, by epoch parity */
+#endif
 };
 
 /****************************************************************************
@@ -80,6 +87,53 @@ struct inode_sem_s
 
 static struct inode_sem_s g_inode_sem;
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_reclaim
+ *
+ * Description:
+ *   Free the retired inodes that no lock-free walk can still see.  Inodes
+ *   retired in an epoch may be seen by the walks of that epoch and of the
+ *   previous one.  So once the walks of the previous epoch have finished,
+ *   the inodes retired in that epoch are freed and a new epoch begins that
+ *   reuses its reader count and retired list.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+static void inode_reclaim(void)
+{
+  FAR struct inode *node;
+  unsigned int epoch = g_inode_sem.epoch;
+  int prev = (epoch + 1) & 1;
+
+  if (g_inode_sem.retired[0] == NULL && g_inode_sem.retired[1] == NULL)
+    {
+      return;
+    }
+
+  if (__atomic_load_n(&g_inode_sem.readers[prev], __ATOMIC_SEQ_CST) != 0)
+    {
+      return;
+    }
+
+  while ((node = g_inode_sem.retired[prev]) != NULL)
+    {
+      g_inode_sem.retired[prev] = node->i_peer;
+      node->i_peer = NULL;
+      inode_free(node);
+    }
+
+  __atomic_store_n(&g_inode_sem.epoch, epoch + 1, __ATOMIC_SEQ_CST);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -158,6 +212,14 @@ void inode_semtake(void)
 
       g_inode_sem.holder = me;
       g_inode_sem.count  = 1;
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+      /* Lock-free walks that overlap with this change must not trust
+       * their results.
+       */
+
+      __atomic_add_fetch(&g_inode_sem.seq, 1, __ATOMIC_SEQ_CST);
+#endif
     }
 }
 
@@ -186,8 +248,116 @@ void inode_semgive(void)
 
   else
     {
+#ifdef CONFIG_FS_INODE_LOCKFREE
+      /* Free what can be freed and end the change of the tree */
+
+      inode_reclaim();
+      __atomic_add_fetch(&g_inode_sem.seq, 1, __ATOMIC_SEQ_CST);
+#endif
+
       g_inode_sem.holder = NO_HOLDER;
       g_inode_sem.count  = 0;
       nxsem_post(&g_inode_sem.sem);
     }
 }
+
+/****************************************************************************
+ * Name: inode_rcu_begin
+ *
+ * Description:
+ *   Start a lock-free walk of the inode tree.  Returns false if the tree is
+ *   being changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+bool inode_rcu_begin(FAR struct inode_rcu_s *rcu)
+{
+  /* Count the walk in the current epoch.  The epoch may advance before the
+   * count is visible; in that case, count the walk in the new epoch.
+   */
+
+  for (; ; )
+    {
+      rcu->epoch = __atomic_load_n(&g_inode_sem.epoch, __ATOMIC_SEQ_CST);
+      __atomic_add_fetch(&g_inode_sem.readers[rcu->epoch & 1], 1,
+                         __ATOMIC_SEQ_CST);
+
+      if (__atomic_load_n(&g_inode_sem.epoch, __ATOMIC_SEQ_CST) ==
+          rcu->epoch)
+        {
+          break;
+        }
+
+      __atomic_sub_fetch(&g_inode_sem.readers[rcu->epoch & 1], 1,
+                         __ATOMIC_SEQ_CST);
+    }
+
+  rcu->seq = __atomic_load_n(&g_inode_sem.seq, __ATOMIC_SEQ_CST);
+  if ((rcu->seq & 1) != 0)
+    {
+      inode_rcu_end(rcu);
+      return false;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: inode_rcu_changed
+ *
+ * Description:
+ *   Return true if the inode tree was changed since inode_rcu_begin().
+ *
+ ****************************************************************************/
+
+bool inode_rcu_changed(FAR const struct inode_rcu_s *rcu)
+{
+  return __atomic_load_n(&g_inode_sem.seq, __ATOMIC_SEQ_CST) != rcu->seq;
+}
+
+/****************************************************************************
+ * Name: inode_rcu_end
+ *
+ * Description:
+ *   End a lock-free walk of the inode tree.
+ *
+ ****************************************************************************/
+
+void inode_rcu_end(FAR const struct inode_rcu_s *rcu)
+{
+  __atomic_sub_fetch(&g_inode_sem.readers[rcu->epoch & 1], 1,
+                     __ATOMIC_SEQ_CST);
+}
+#endif
+
+/****************************************************************************
+ * Name: inode_retire
+ *
+ * Description:
+ *   Free an unlinked inode that has no references, once no lock-free walk
+ *   of the tree can still see it.
+ *
+ ****************************************************************************/
+
+void inode_retire(FAR struct inode *node)
+{
+  DEBUGASSERT(node != NULL && node->i_peer == NULL &&
+              (node->i_flags & FSNODEFLAG_RETIRED) == 0);
+
+  node->i_flags |= FSNODEFLAG_RETIRED;
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+  /* The retired list is linked through i_peer.  Walks that are still at
+   * the inode may follow that link, but only to inodes that are freed
+   * with this one and their results will be discarded.
+   */
+
+  DEBUGASSERT(g_inode_sem.holder == getpid());
+
+  node->i_peer = g_inode_sem.retired[g_inode_sem.epoch & 1];
+  g_inode_sem.retired[g_inode_sem.epoch & 1] = node;
+#else
+  inode_free(node);
+#endif
+}
@@ -60,8 +60,16 @@ void inode_addref(FAR struct inode *inode)
 {
   if (inode)
     {
+#ifdef CONFIG_FS_INODE_LOCKFREE
+      /* The caller holds a reference already, so the inode cannot be
+       * freed.  An atomic increment is sufficient.
+       */
+
+      inode_incref(inode);
+#else
       inode_semtake();
-      inode->i_crefs++;
+      inode_incref(inode);
       inode_semgive();
+#endif
     }
 }
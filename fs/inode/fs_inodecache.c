@@ -0,0 +1,225 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_MASK (CONFIG_FS_INODE_CACHE_NENTRIES - 1)
+
+#if (CONFIG_FS_INODE_CACHE_NENTRIES & INODE_CACHE_MASK) != 0
+#  error CONFIG_FS_INODE_CACHE_NENTRIES must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached result of inode_search() */
+
+struct inode_cache_s
+{
+  uint32_t generation;       /* Valid only if equal to g_inode_generation */
+  uint16_t pathoff;          /* Offset of the residual path */
+  uint16_t reloff;           /* Offset of the relative path */
+  FAR struct inode *node;    /* The inode found */
+  FAR struct inode *peer;    /* Node to the "left" of the inode found */
+  FAR struct inode *parent;  /* Node "above" the inode found */
+  char path[CONFIG_FS_INODE_CACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The direct mapped path cache.  All entries are invalidated at once by
+ * incrementing the generation number whenever the inode tree is
+ * modified.  Generation zero is never used so that the cache is initially
+ * empty.
+ */
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_NENTRIES];
+static uint32_t g_inode_generation = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Hash a full path (FNV-1a) and return the path length.
+ *
+ ****************************************************************************/
+
+static FAR struct inode_cache_s *inode_cache_hash(FAR const char *path,
+                                                  FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash ^= (uint8_t)*ptr++;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return &g_inode_cache[hash & INODE_CACHE_MASK];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of a previous successful search for the same path.
+ *
+ * Returned Value:
+ *   true if the search descriptor was filled in from the cache.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  size_t len;
+
+  entry = inode_cache_hash(path, &len);
+  if (entry->generation != g_inode_generation ||
+      len >= CONFIG_FS_INODE_CACHE_PATHLEN ||
+      memcmp(entry->path, path, len + 1) != 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+  /* The inode may have become a soft link after it was cached */
+
+  if (INODE_IS_SOFTLINK(entry->node))
+    {
+      return false;
+    }
+#endif
+
+  desc->path    = path + entry->pathoff;
+  desc->node    = entry->node;
+  desc->peer    = entry->peer;
+  desc->parent  = entry->parent;
+  desc->relpath = path + entry->reloff;
+  return true;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of a successful search for 'path'.  Only searches
+ *   that did not pass through a soft link can be cached.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  size_t len;
+
+  DEBUGASSERT(desc->node != NULL && desc->relpath != NULL);
+
+  entry = inode_cache_hash(path, &len);
+  if (len < CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      memcpy(entry->path, path, len + 1);
+      entry->pathoff    = desc->path - path;
+      entry->reloff     = desc->relpath - path;
+      entry->node       = desc->node;
+      entry->peer       = desc->peer;
+      entry->parent     = desc->parent;
+      entry->generation = g_inode_generation;
+    }
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Invalidate all cached search results.  Must be called whenever an inode
+ *   is inserted into or removed from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  if (++g_inode_generation == 0)
+    {
+      /* Generation zero is reserved.  Clear the cache on wrap-around. */
+
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_generation = 1;
+    }
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -59,13 +60,76 @@
  *   inode_find() is a simple wrapper around inode_search().  The primary
  *   difference between inode_find() and inode_search is that inode_find()
  *   will lock the inode tree and increment the reference count on the inode.
+ *   With CONFIG_FS_INODE_LOCKFREE, the tree is locked only if a lock-free
+ *   walk of the tree does not succeed.
  *
  ****************************************************************************/
 
 int inode_find(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODE_LOCKFREE
+  struct inode_rcu_s rcu;
+  FAR const char *path = desc->path;
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+  bool nofollow = desc->nofollow;
+#endif
+#endif
   int ret;
 
+#ifdef CONFIG_FS_INODE_LOCKFREE
+  /* First try to find the node without the semaphore */
+
+  if (inode_rcu_begin(&rcu))
+    {
+      FAR struct inode *node = NULL;
+
+      ret = inode_rcu_search(desc);
+      if (ret >= 0)
+        {
+          /* Special inodes have their own release logic.  Look them up
+           * with the semaphore.
+           */
+
+          node = desc->node;
+          if (INODE_IS_SPECIAL(node))
+            {
+              node = NULL;
+              ret  = -EAGAIN;
+            }
+          else
+            {
+              inode_incref(node);
+            }
+        }
+
+      /* The result is valid only if the tree did not change during the
+       * walk.  Otherwise, the reference is dropped while the walk still
+       * keeps the inode from being freed.
+       */
+
+      if (ret >= 0 && inode_rcu_changed(&rcu))
+        {
+          inode_release(node);
+          ret = -EAGAIN;
+        }
+
+      inode_rcu_end(&rcu);
+      if (ret >= 0)
+        {
+          return ret;
+        }
+
+      /* Reset the search descriptor and search again */
+
+      RELEASE_SEARCH(desc);
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+      SETUP_SEARCH(desc, path, nofollow);
+#else
+      SETUP_SEARCH(desc, path, false);
+#endif
+    }
+#endif
+
   /* Find the node matching the path.  If found, increment the count of
    * references on the node.
    */
@@ -81,7 +145,7 @@ int inode_find(FAR struct inode_search_s *desc)
 
       /* Increment the reference count on the inode */
 
-      node->i_crefs++;
+      inode_incref(node);
     }
 
   inode_semgive();
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
@@ -62,12 +64,30 @@ void inode_release(FAR struct inode *node)
 {
   if (node)
     {
+#ifdef CONFIG_FS_INODE_LOCKFREE
+      int32_t crefs = inode_crefs(node);
+
+      /* Drop a reference that is not the last one without the semaphore.
+       * Only the last reference may free the inode.
+       */
+
+      while (crefs > 1)
+        {
+          if (__atomic_compare_exchange_n(&node->i_crefs, &crefs, crefs - 1,
+                                          false, __ATOMIC_SEQ_CST,
+                                          __ATOMIC_SEQ_CST))
+            {
+              return;
+            }
+        }
+#endif
+
       /* Decrement the references of the inode */
 
       inode_semtake();
-      if (node->i_crefs)
+      if (inode_crefs(node) > 0)
         {
-          node->i_crefs--;
+          inode_decref(node);
         }
 
       /* If the subtree was previously deleted and the reference
@@ -75,21 +95,18 @@ void inode_release(FAR struct inode *node)
        * now.
        */
 
-      if (node->i_crefs <= 0 && (node->i_flags & FSNODEFLAG_DELETED) != 0)
+      if (inode_crefs(node) <= 0 &&
+          (node->i_flags & (FSNODEFLAG_DELETED | FSNODEFLAG_RETIRED)) ==
+          FSNODEFLAG_DELETED)
         {
           /* If the inode has been properly unlinked, then the peer pointer
            * should be NULL.
            */
 
-          inode_semgive();
-
           DEBUGASSERT(node->i_peer == NULL);
-          inode_free(node);
-        }
-      else
-        {
-          inode_semgive();
+          inode_retire(node);
         }
+
+      inode_semgive();
     }
 }
-
@@ -91,6 +91,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      /* Cached search results must not refer to the removed node */
+
+      inode_cache_invalidate();
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -147,10 +151,11 @@ int inode_remove(FAR const char *path)
   if (node)
     {
       /* Found it! But we cannot delete the inode if there are references
-       * to it
+       * to it.  A lock-free look-up that takes a reference after this
+       * check will see that the tree changed and release it again.
        */
 
-      if (node->i_crefs)
+      if (inode_crefs(node))
         {
           /* In that case, we will mark it deleted, when the filesystem
            * releases the inode, we will then, finally delete the subtree
@@ -166,7 +171,7 @@ int inode_remove(FAR const char *path)
            */
 
           DEBUGASSERT(node->i_peer == NULL);
-          inode_free(node);
+          inode_retire(node);
           return OK;
         }
     }
@@ -459,6 +459,9 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODE_CACHE
+  FAR const char *path;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -471,8 +474,33 @@ int inode_search(FAR struct inode_search_s *desc)
   desc->linktgt = NULL;
 #endif
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Check if the same path was found before */
+
+  path = desc->path;
+  if (inode_cache_lookup(desc))
+    {
+      return OK;
+    }
+#endif
+
   ret = _inode_search(desc);
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Cache the result if the search succeeded and did not involve any soft
+   * links.
+   */
+
+  if (ret >= 0
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+      && desc->linktgt == NULL && !INODE_IS_SOFTLINK(desc->node)
+#endif
+     )
+    {
+      inode_cache_add(path, desc);
+    }
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
     {
@@ -580,6 +608,45 @@ int inode_search(FAR struct inode_search_s *desc)
   return ret;
 }
 
+/****************************************************************************
+ * Name: inode_rcu_search
+ *
+ * Description:
+ *   The part of inode_search() that can be done in a lock-free walk of the
+ *   tree.  The path cache is not used because it is changed by look-ups.
+ *   Paths that involve soft links fail with -EAGAIN:  Following a link
+ *   may need an allocated path buffer and the link target is returned in
+ *   the search descriptor where it could outlive the link inode.
+ *
+ * Assumptions:
+ *   The caller is in a walk started by inode_rcu_begin()
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+int inode_rcu_search(FAR struct inode_search_s *desc)
+{
+  int ret;
+
+  DEBUGASSERT(desc != NULL);
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+  desc->linktgt = NULL;
+#endif
+
+  ret = _inode_search(desc);
+
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+  if (desc->linktgt != NULL ||
+      (ret >= 0 && INODE_IS_SOFTLINK(desc->node)))
+    {
+      ret = -EAGAIN;
+    }
+#endif
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
@@ -95,6 +95,24 @@
 
 #endif
 
+/* Inode reference counts.  With CONFIG_FS_INODE_LOCKFREE the counts are
+ * changed by atomic operations because inode_addref(), inode_release() and
+ * inode_find() do not always hold the inode semaphore.
+ */
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+#  define inode_crefs(n) \
+     __atomic_load_n(&(n)->i_crefs, __ATOMIC_SEQ_CST)
+#  define inode_incref(n) \
+     ((void)__atomic_add_fetch(&(n)->i_crefs, 1, __ATOMIC_SEQ_CST))
+#  define inode_decref(n) \
+     ((void)__atomic_sub_fetch(&(n)->i_crefs, 1, __ATOMIC_SEQ_CST))
+#else
+#  define inode_crefs(n)  ((n)->i_crefs)
+#  define inode_incref(n) ((void)(n)->i_crefs++)
+#  define inode_decref(n) ((void)(n)->i_crefs--)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -142,6 +160,19 @@ struct inode_search_s
 #endif
 };
 
+/* State of a lock-free walk of the inode tree (CONFIG_FS_INODE_LOCKFREE).
+ *  seq   - The tree sequence count when the walk started
+ *  epoch - The reclamation epoch that the walk belongs to
+ */
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+struct inode_rcu_s
+{
+  unsigned int seq;
+  unsigned int epoch;
+};
+#endif
+
 /* Callback used by foreach_inode to traverse all inodes in the pseudo-
  * file system.
  */
@@ -200,6 +231,44 @@ void inode_semtake(void);
 
 void inode_semgive(void);
 
+/****************************************************************************
+ * Name: inode_rcu_begin, inode_rcu_changed, and inode_rcu_end
+ *
+ * Description:
+ *   Walk the inode tree without the inode semaphore.  inode_rcu_begin()
+ *   starts the walk.  It fails if the tree is being changed; the caller
+ *   should then take the semaphore instead.  Inodes that are removed while
+ *   the walk is in progress are not freed before inode_rcu_end() is
+ *   called.  inode_rcu_changed() returns true if the tree was changed
+ *   after inode_rcu_begin(), so that the result of the walk may not be
+ *   valid.
+ *
+ * Assumptions:
+ *   The caller does not hold the inode semaphore.  The walk does not block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+bool inode_rcu_begin(FAR struct inode_rcu_s *rcu);
+bool inode_rcu_changed(FAR const struct inode_rcu_s *rcu);
+void inode_rcu_end(FAR const struct inode_rcu_s *rcu);
+#endif
+
+/****************************************************************************
+ * Name: inode_retire
+ *
+ * Description:
+ *   Free an unlinked inode that has no references.  With
+ *   CONFIG_FS_INODE_LOCKFREE, the inode is freed later, once no lock-free
+ *   walk of the tree can still see it.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_retire(FAR struct inode *node);
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -226,6 +295,47 @@ void inode_semgive(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_rcu_search
+ *
+ * Description:
+ *   The part of inode_search() that can be done in a lock-free walk of the
+ *   tree.  The path cache is not used.  Paths that involve soft links fail
+ *   with -EAGAIN.
+ *
+ * Assumptions:
+ *   The caller is in a walk started by inode_rcu_begin()
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_LOCKFREE
+int inode_rcu_search(FAR struct inode_search_s *desc);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_add, and inode_cache_invalidate
+ *
+ * Description:
+ *   Manage the cache of inode_search() results.  inode_cache_lookup()
+ *   fills in the search descriptor if a previous search of the same path
+ *   succeeded.  inode_cache_add() remembers the result of a successful
+ *   search.  inode_cache_invalidate() discards all cached results and must
+ *   be called whenever the inode tree is modified.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc);
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc);
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
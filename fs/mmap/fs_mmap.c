@@ -160,7 +160,9 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
   ret = ioctl(fd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
   if (ret < 0)
     {
-#ifdef CONFIG_FS_RAMMAP
+#if defined(CONFIG_FS_RAMMAP_PAGECACHE)
+      return pagemap(fd, length, offset);
+#elif defined(CONFIG_FS_RAMMAP)
       return rammap(fd, length, offset);
 #else
       ferr("ERROR: ioctl(FIOC_MMAP) failed: %d\n", get_errno());
@@ -117,6 +117,22 @@ int munmap(FAR void *start, size_t length)
   int ret;
   int errcode;
 
+#ifdef CONFIG_FS_RAMMAP_PAGECACHE
+  /* Is this a mapping from the page cache? */
+
+  ret = pagemap_unmap(start, length);
+  if (ret != -ENOENT)
+    {
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Find a region containing this start and length in the list of regions */
 
   rammap_initialize();
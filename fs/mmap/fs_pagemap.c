@@ -0,0 +1,537 @@
+/****************************************************************************
+ * fs/mmap/fs_pagemap.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/mm/gran.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP_PAGECACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One file in the page cache.  The file is identified by its inode so that
+ * every mapping of the file, through any file descriptor and in any
+ * process, shares the same physical pages.
+ */
+
+struct fs_cachedfile_s
+{
+  FAR struct fs_cachedfile_s *flink; /* Implements a singly linked list */
+  FAR struct inode *inode;           /* The file (holds a reference) */
+  unsigned int npages;               /* Size of the arrays below */
+  FAR uintptr_t *pages;              /* Physical page per file page or 0 */
+  FAR uint16_t *refs;                /* Mappings of each file page */
+  unsigned int nmaps;                /* Number of mappings of the file */
+};
+
+/* One mapping of a range of pages of a cached file into the address
+ * environment of a task group.
+ */
+
+struct fs_pagemap_s
+{
+  FAR struct fs_pagemap_s *flink;    /* Implements a singly linked list */
+  FAR struct task_group_s *group;    /* The group that holds the mapping */
+  FAR struct fs_cachedfile_s *file;  /* The mapped file */
+  uintptr_t vaddr;                   /* First user virtual address */
+  unsigned int first;                /* First file page mapped */
+  unsigned int npages;               /* Number of pages mapped */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct fs_cachedfile_s *g_cachedfiles;
+static FAR struct fs_pagemap_s *g_pagemaps;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagemap_getfile
+ *
+ * Description:
+ *   Find the cached file for an inode or create it, then make sure that
+ *   its page arrays cover at least 'npages' pages.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct fs_cachedfile_s *
+pagemap_getfile(FAR struct inode *inode, unsigned int npages)
+{
+  FAR struct fs_cachedfile_s *file;
+  FAR uintptr_t *pages;
+  FAR uint16_t *refs;
+
+  for (file = g_cachedfiles; file != NULL; file = file->flink)
+    {
+      if (file->inode == inode)
+        {
+          break;
+        }
+    }
+
+  if (file == NULL)
+    {
+      file = (FAR struct fs_cachedfile_s *)
+        kmm_zalloc(sizeof(struct fs_cachedfile_s));
+      if (file == NULL)
+        {
+          return NULL;
+        }
+
+      inode_addref(inode);
+      file->inode   = inode;
+      file->flink   = g_cachedfiles;
+      g_cachedfiles = file;
+    }
+
+  if (npages > file->npages)
+    {
+      pages = (FAR uintptr_t *)
+        kmm_realloc(file->pages, npages * sizeof(uintptr_t));
+      if (pages == NULL)
+        {
+          return NULL;
+        }
+
+      file->pages = pages;
+
+      refs = (FAR uint16_t *)
+        kmm_realloc(file->refs, npages * sizeof(uint16_t));
+      if (refs == NULL)
+        {
+          return NULL;
+        }
+
+      file->refs = refs;
+
+      memset(&file->pages[file->npages], 0,
+             (npages - file->npages) * sizeof(uintptr_t));
+      memset(&file->refs[file->npages], 0,
+             (npages - file->npages) * sizeof(uint16_t));
+      file->npages = npages;
+    }
+
+  return file;
+}
+
+/****************************************************************************
+ * Name: pagemap_putpages
+ *
+ * Description:
+ *   Drop one reference to each page in a range.  Pages with no remaining
+ *   references are returned to the page allocator.  The file is removed
+ *   from the cache if no mapping of it remains.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+static void pagemap_putpages(FAR struct fs_cachedfile_s *file,
+                             unsigned int first, unsigned int npages)
+{
+  FAR struct fs_cachedfile_s *prev;
+  unsigned int i;
+
+  for (i = first; i < first + npages; i++)
+    {
+      DEBUGASSERT(file->refs[i] > 0);
+      if (--file->refs[i] == 0)
+        {
+          mm_pgfree(file->pages[i], 1);
+          file->pages[i] = 0;
+        }
+    }
+
+  if (file->nmaps > 0)
+    {
+      return;
+    }
+
+  /* Remove the file from the cache */
+
+  if (g_cachedfiles == file)
+    {
+      g_cachedfiles = file->flink;
+    }
+  else
+    {
+      for (prev = g_cachedfiles; prev->flink != file; prev = prev->flink)
+        {
+          DEBUGASSERT(prev->flink != NULL);
+        }
+
+      prev->flink = file->flink;
+    }
+
+  inode_release(file->inode);
+  kmm_free(file->pages);
+  kmm_free(file->refs);
+  kmm_free(file);
+}
+
+/****************************************************************************
+ * Name: pagemap_remove
+ *
+ * Description:
+ *   Remove a mapping from the list of mappings.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+static void pagemap_remove(FAR struct fs_pagemap_s *map)
+{
+  FAR struct fs_pagemap_s *prev;
+
+  if (g_pagemaps == map)
+    {
+      g_pagemaps = map->flink;
+      return;
+    }
+
+  for (prev = g_pagemaps; prev->flink != map; prev = prev->flink)
+    {
+      DEBUGASSERT(prev->flink != NULL);
+    }
+
+  prev->flink = map->flink;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagemap
+ *
+ * Description:
+ *   Map a range of a file into the address environment of the calling
+ *   process using pages from the shared page cache.  Only pages of the
+ *   file that are not already cached are allocated and read; pages cached
+ *   by an earlier mapping of the same file, in this or any other process,
+ *   are shared.  As with rammap(), changes to the mapped memory are not
+ *   written back to the file.
+ *
+ * Returned Value:
+ *   On success, the mapped address.  On error, MAP_FAILED is returned and
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+FAR void *pagemap(int fd, size_t length, off_t offset)
+{
+  FAR struct fs_cachedfile_s *file;
+  FAR struct fs_pagemap_s *map;
+  FAR struct task_group_s *group;
+  FAR struct file *filep;
+  FAR uintptr_t *pages;
+  unsigned int first;
+  unsigned int npages;
+  unsigned int nalloc;
+  unsigned int i;
+  uintptr_t vaddr;
+  ssize_t nread;
+  int ret;
+
+  if (offset < 0 || !MM_ISALIGNED(offset) || length == 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode == NULL || (filep->f_oflags & O_RDOK) == 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  group = sched_self()->group;
+  DEBUGASSERT(group != NULL && group->tg_shm.gs_handle != NULL);
+
+  first  = offset >> MM_PGSHIFT;
+  npages = MM_NPAGES(length);
+
+  map = (FAR struct fs_pagemap_s *)kmm_zalloc(sizeof(struct fs_pagemap_s));
+  pages = (FAR uintptr_t *)kmm_malloc(npages * sizeof(uintptr_t));
+  if (map == NULL || pages == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_alloc;
+    }
+
+  /* Set aside a virtual address range in the shared memory region of the
+   * address environment.
+   */
+
+  vaddr = (uintptr_t)gran_alloc(group->tg_shm.gs_handle,
+                                npages << MM_PGSHIFT);
+  if (vaddr == 0)
+    {
+      ret = -ENOMEM;
+      goto errout_with_alloc;
+    }
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      goto errout_with_vaddr;
+    }
+
+  file = pagemap_getfile(filep->f_inode, first + npages);
+  if (file == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_sem;
+    }
+
+  /* Take a reference on each page, allocating those that are not cached */
+
+  for (nalloc = 0; nalloc < npages; nalloc++)
+    {
+      i = first + nalloc;
+      if (file->pages[i] == 0)
+        {
+          file->pages[i] = mm_pgalloc(1);
+          if (file->pages[i] == 0)
+            {
+              ret = -ENOMEM;
+              goto errout_with_pages;
+            }
+        }
+
+      file->refs[i]++;
+      pages[nalloc] = file->pages[i];
+    }
+
+  ret = up_shmat(pages, npages, vaddr);
+  if (ret < 0)
+    {
+      goto errout_with_pages;
+    }
+
+  /* Fill the pages that were not already cached.  These are the pages that
+   * this mapping holds the only reference to.
+   */
+
+  for (nalloc = 0; nalloc < npages; nalloc++)
+    {
+      i = first + nalloc;
+      if (file->refs[i] == 1)
+        {
+          FAR uint8_t *page = (FAR uint8_t *)(vaddr + (nalloc << MM_PGSHIFT));
+
+          nread = file_pread(filep, page, MM_PGSIZE,
+                             (off_t)i << MM_PGSHIFT);
+          if (nread < 0)
+            {
+              ret = (int)nread;
+              (void)up_shmdt(vaddr, npages);
+              goto errout_with_pages;
+            }
+
+          memset(page + nread, 0, MM_PGSIZE - nread);
+        }
+    }
+
+  map->group  = group;
+  map->file   = file;
+  map->vaddr  = vaddr;
+  map->first  = first;
+  map->npages = npages;
+  map->flink  = g_pagemaps;
+  g_pagemaps  = map;
+  file->nmaps++;
+
+  nxsem_post(&g_rammaps.exclsem);
+  kmm_free(pages);
+  return (FAR void *)vaddr;
+
+errout_with_pages:
+  pagemap_putpages(file, first, nalloc);
+
+errout_with_sem:
+  nxsem_post(&g_rammaps.exclsem);
+
+errout_with_vaddr:
+  gran_free(group->tg_shm.gs_handle, (FAR void *)vaddr,
+            npages << MM_PGSHIFT);
+
+errout_with_alloc:
+  kmm_free(map);
+  kmm_free(pages);
+
+errout:
+  set_errno(-ret);
+  return MAP_FAILED;
+}
+
+/****************************************************************************
+ * Name: pagemap_unmap
+ *
+ * Description:
+ *   Remove a mapping created by pagemap().  Only whole mappings may be
+ *   removed.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if 'start' is not the address of a
+ *   mapping created by pagemap(), or another negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int pagemap_unmap(FAR void *start, size_t length)
+{
+  FAR struct task_group_s *group = sched_self()->group;
+  FAR struct fs_pagemap_s *map;
+  int ret;
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (map = g_pagemaps; map != NULL; map = map->flink)
+    {
+      if (map->group == group && map->vaddr == (uintptr_t)start)
+        {
+          break;
+        }
+    }
+
+  if (map == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else if (MM_NPAGES(length) < map->npages)
+    {
+      ret = -ENOSYS;
+    }
+  else
+    {
+      (void)up_shmdt(map->vaddr, map->npages);
+      gran_free(group->tg_shm.gs_handle, (FAR void *)map->vaddr,
+                map->npages << MM_PGSHIFT);
+
+      pagemap_remove(map);
+      map->file->nmaps--;
+      pagemap_putpages(map->file, map->first, map->npages);
+      kmm_free(map);
+    }
+
+  nxsem_post(&g_rammaps.exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagemap_release
+ *
+ * Description:
+ *   Release the mappings still held by a task group that is exiting.  The
+ *   page tables are torn down with the address environment; here only the
+ *   references on the cached pages are dropped.
+ *
+ ****************************************************************************/
+
+void pagemap_release(FAR struct task_group_s *group)
+{
+  FAR struct fs_pagemap_s *map;
+  FAR struct fs_pagemap_s *next;
+  int ret;
+
+  rammap_initialize();
+  do
+    {
+      ret = nxsem_wait(&g_rammaps.exclsem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+
+  for (map = g_pagemaps; map != NULL; map = next)
+    {
+      next = map->flink;
+      if (map->group == group)
+        {
+          pagemap_remove(map);
+          map->file->nmaps--;
+          pagemap_putpages(map->file, map->first, map->npages);
+          kmm_free(map);
+        }
+    }
+
+  nxsem_post(&g_rammaps.exclsem);
+}
+
+#endif /* CONFIG_FS_RAMMAP_PAGECACHE */
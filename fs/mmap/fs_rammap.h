@@ -142,5 +142,19 @@ void rammap_initialize(void);
 
 FAR void *rammap(int fd, size_t length, off_t offset);
 
+/****************************************************************************
+ * Name: pagemap and pagemap_unmap
+ *
+ * Description:
+ *   Map a range of a file into the calling process using the shared page
+ *   cache, and remove such a mapping.  See fs_pagemap.c.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_PAGECACHE
+FAR void *pagemap(int fd, size_t length, off_t offset);
+int pagemap_unmap(FAR void *start, size_t length);
+#endif
+
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
@@ -362,7 +362,7 @@ int mount(FAR const char *source, FAR const char *target,
   if (blkdrvr_inode)
 #endif
     {
-      blkdrvr_inode->i_crefs++;
+      inode_incref(blkdrvr_inode);
     }
 #endif
 
@@ -386,7 +386,7 @@ int mount(FAR const char *source, FAR const char *target,
       if (blkdrvr_inode)
 #endif
         {
-          blkdrvr_inode->i_crefs--;
+          inode_decref(blkdrvr_inode);
         }
 #endif
       errcode = -ret;
@@ -159,8 +159,8 @@ int umount2(FAR const char *target, unsigned int flags)
     {
        /* Just decrement the reference count (without deleting it) */
 
-       DEBUGASSERT(mountpt_inode->i_crefs > 0);
-       mountpt_inode->i_crefs--;
+       DEBUGASSERT(inode_crefs(mountpt_inode) > 0);
+       inode_decref(mountpt_inode);
     }
   else
 #endif
@@ -186,9 +186,9 @@ void mq_inode_release(FAR struct inode *inode)
   /* Decrement the reference count on the inode */
 
   inode_semtake();
-  if (inode->i_crefs > 0)
+  if (inode_crefs(inode) > 0)
     {
-      inode->i_crefs--;
+      inode_decref(inode);
     }
 
   /* If the message queue was previously unlinked and the reference count
@@ -196,7 +196,8 @@ void mq_inode_release(FAR struct inode *inode)
    * the inode now.
    */
 
-  if (inode->i_crefs <= 0 && (inode->i_flags & FSNODEFLAG_DELETED) != 0)
+  if (inode_crefs(inode) <= 0 &&
+      (inode->i_flags & FSNODEFLAG_DELETED) != 0)
     {
       FAR struct mqueue_inode_s *msgq = inode->u.i_mqueue;
       DEBUGASSERT(msgq);
@@ -210,10 +211,9 @@ void mq_inode_release(FAR struct inode *inode)
        * unlinked, then the peer pointer should be NULL.
        */
 
-      inode_semgive();
-
       DEBUGASSERT(inode->i_peer == NULL);
-      inode_free(inode);
+      inode_retire(inode);
+      inode_semgive();
       return;
     }
 
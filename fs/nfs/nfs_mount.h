@@ -50,6 +50,8 @@
 
 #include <sys/socket.h>
 
+#include <nuttx/clock.h>
+
 #include "rpc.h"
 
 /****************************************************************************
@@ -60,6 +62,22 @@
  * Public Types
  ****************************************************************************/
 
+/* One entry in the attribute cache.  This holds the results of a recent
+ * look-up of a path so that repeated stat() and open() calls on the same
+ * path need not repeat the LOOKUP RPCs.
+ */
+
+#ifdef CONFIG_NFS_ATTRCACHE
+struct nfs_attrcache_s
+{
+  FAR char        *ac_path;                   /* Relative path (NULL if unused) */
+  systime_t        ac_time;                   /* Time the attributes were obtained */
+  uint8_t          ac_fhsize;                 /* Size of the file handle */
+  nfsfh_t          ac_fhandle;                /* File handle of the object */
+  struct nfs_fattr ac_fattr;                  /* Attributes of the object */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -104,9 +122,17 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fs;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Recently looked-up paths and their attributes */
+
+  struct nfs_attrcache_s nm_attrcache[CONFIG_NFS_ATTRCACHE_SIZE];
+  uint8_t          nm_acnext;                 /* Next cache entry to replace */
+#endif
+
   /* I/O buffer (must be a aligned to 32-bit boundaries).  This buffer used for all
    * reply messages EXCEPT for the WRITE RPC. In that case it is used for the WRITE
    * call message that contains the data to be written.  This buffer must be
@@ -58,6 +58,7 @@
 
 #define NFSNODE_OPEN           (1 << 0) /* File is still open */
 #define NFSNODE_MODIFIED       (1 << 1) /* Might have a modified buffer */
+#define NFSNODE_UNCOMMITTED    (1 << 2) /* Unstable writes need a COMMIT */
 
 /****************************************************************************
  * Public Types
@@ -79,6 +80,17 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file */
+#ifdef CONFIG_NFS_READAHEAD
+  FAR uint8_t       *n_rabuf;       /* Read-ahead buffer (nm_rsize bytes) */
+  off_t              n_raoffset;    /* File offset of the read-ahead data */
+  uint16_t           n_ralen;       /* Number of valid bytes in n_rabuf */
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+  FAR uint8_t       *n_wbbuf;       /* Write-behind buffer (nm_wsize bytes) */
+  off_t              n_wboffset;    /* File offset of the buffered data */
+  uint16_t           n_wblen;       /* Number of buffered bytes in n_wbbuf */
+  uint8_t            n_wrverf[NFSX_V3WRITEVERF]; /* Write verifier */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
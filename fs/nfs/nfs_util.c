@@ -52,6 +52,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/dirent.h>
 
@@ -118,6 +120,104 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_attrcache_find
+ *
+ * Description:
+ *   Look for a current entry for 'relpath' in the attribute cache.
+ *
+ * Returned Value:
+ *   Zero on success; ENOENT if there is no usable cache entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static int nfs_attrcache_find(FAR struct nfsmount *nmp,
+                              FAR const char *relpath,
+                              FAR struct file_handle *fhandle,
+                              FAR struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_attrcache_s *ac;
+  systime_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_SIZE; i++)
+    {
+      ac = &nmp->nm_attrcache[i];
+      if (ac->ac_path != NULL && strcmp(ac->ac_path, relpath) == 0)
+        {
+          /* Discard the entry if it has expired */
+
+          if ((systime_t)(now - ac->ac_time) >=
+              MSEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT))
+            {
+              kmm_free(ac->ac_path);
+              ac->ac_path = NULL;
+              return ENOENT;
+            }
+
+          fhandle->length = ac->ac_fhsize;
+          memcpy(&fhandle->handle, &ac->ac_fhandle, ac->ac_fhsize);
+
+          if (obj_attributes)
+            {
+              memcpy(obj_attributes, &ac->ac_fattr, sizeof(struct nfs_fattr));
+            }
+
+          return OK;
+        }
+    }
+
+  return ENOENT;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_attrcache_add
+ *
+ * Description:
+ *   Add the result of a successful look-up to the attribute cache,
+ *   replacing the oldest entry.  Failure to allocate memory is not an
+ *   error; the path is simply not cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static void nfs_attrcache_add(FAR struct nfsmount *nmp,
+                              FAR const char *relpath,
+                              FAR struct file_handle *fhandle,
+                              FAR struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_attrcache_s *ac;
+  FAR char *path;
+
+  path = (FAR char *)kmm_malloc(strlen(relpath) + 1);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  strcpy(path, relpath);
+
+  ac = &nmp->nm_attrcache[nmp->nm_acnext];
+  if (++nmp->nm_acnext >= CONFIG_NFS_ATTRCACHE_SIZE)
+    {
+      nmp->nm_acnext = 0;
+    }
+
+  if (ac->ac_path != NULL)
+    {
+      kmm_free(ac->ac_path);
+    }
+
+  ac->ac_path   = path;
+  ac->ac_time   = clock_systimer();
+  ac->ac_fhsize = (uint8_t)fhandle->length;
+  memcpy(&ac->ac_fhandle, &fhandle->handle, fhandle->length);
+  memcpy(&ac->ac_fattr, obj_attributes, sizeof(struct nfs_fattr));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -395,6 +495,16 @@ int nfs_findnode(struct nfsmount *nmp, FAR const char *relpath,
   uint32_t         tmp;
   int             error;
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* The cache does not hold the attributes of the parent directory */
+
+  if (dir_attributes == NULL &&
+      nfs_attrcache_find(nmp, relpath, fhandle, obj_attributes) == OK)
+    {
+      return OK;
+    }
+#endif
+
   /* Start with the file handle of the root directory.  */
 
   fhandle->length = nmp->nm_fhsize;
@@ -460,6 +570,9 @@ int nfs_findnode(struct nfsmount *nmp, FAR const char *relpath,
            * directory entry is in fhandle, obj_attributes, and dir_attributes.
            */
 
+#ifdef CONFIG_NFS_ATTRCACHE
+          nfs_attrcache_add(nmp, relpath, fhandle, obj_attributes);
+#endif
           return OK;
         }
 
@@ -480,6 +593,31 @@ int nfs_findnode(struct nfsmount *nmp, FAR const char *relpath,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_attrcache_flush
+ *
+ * Description:
+ *   Discard all entries in the attribute cache.  This must be called
+ *   whenever the client modifies the file system.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+void nfs_attrcache_flush(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_SIZE; i++)
+    {
+      if (nmp->nm_attrcache[i].ac_path != NULL)
+        {
+          kmm_free(nmp->nm_attrcache[i].ac_path);
+          nmp->nm_attrcache[i].ac_path = NULL;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_finddir
  *
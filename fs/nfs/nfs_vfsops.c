@@ -144,12 +144,29 @@ static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
 
+static int     nfs_readrpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR uint8_t *buffer, size_t buflen,
+                   FAR size_t *nread, FAR bool *eof);
+static int     nfs_writerpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR const uint8_t *buffer, size_t buflen,
+                   uint32_t stable, FAR size_t *nwritten);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_wbflush(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+static int     nfs_commit(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+#endif
 static int     nfs_open(FAR struct file *filep, const char *relpath,
                    int oflags, mode_t mode);
 static int     nfs_close(FAR struct file *filep);
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_sync(FAR struct file *filep);
+#endif
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
 static int     nfs_truncate(FAR struct file *filep, off_t length);
@@ -193,7 +210,11 @@ const struct mountpt_operations nfs_operations =
   NULL,                         /* seek */
   NULL,                         /* ioctl */
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  nfs_sync,                     /* sync */
+#else
   NULL,                         /* sync */
+#endif
   nfs_dup,                      /* dup */
   nfs_fstat,                    /* fstat */
   nfs_truncate,                 /* truncate */
@@ -346,6 +367,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   do
     {
       nfs_statistics(NFSPROC_CREATE);
+      nfs_attrcache_flush(nmp);
       error = nfs_request(nmp, NFSPROC_CREATE,
                           (FAR void *)&nmp->nm_msgbuffer.create, reqlen,
                           (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
@@ -461,9 +483,10 @@ static int nfs_filetruncate(FAR struct nfsmount *nmp,
       return error;
     }
 
-  /* Indicate that the file now has zero length */
+  /* Indicate that the file now has the new length */
 
-  np->n_size = 0;
+  nfs_attrcache_flush(nmp);
+  np->n_size = length;
   return OK;
 }
 
@@ -704,6 +727,9 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+#ifdef CONFIG_NFS_WRITEBEHIND
+  int error;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -740,6 +766,31 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Send any buffered data to the server and commit it to stable
+       * storage.  The file is closed even if this fails, but the failure
+       * is reported.
+       */
+
+      error = nfs_wbflush(nmp, np);
+      if (error == OK)
+        {
+          error = nfs_commit(nmp, np);
+        }
+
+      if (np->n_wbbuf != NULL)
+        {
+          kmm_free(np->n_wbbuf);
+        }
+#endif
+
+#ifdef CONFIG_NFS_READAHEAD
+      if (np->n_rabuf != NULL)
+        {
+          kmm_free(np->n_rabuf);
+        }
+#endif
+
       /* Assume file structure will not be found.  This should never happen. */
 
       ret = -EINVAL;
@@ -770,7 +821,11 @@ static int nfs_close(FAR struct file *filep)
               /* Then deallocate the file structure and return success */
 
               kmm_free(np);
+#ifdef CONFIG_NFS_WRITEBEHIND
+              ret = -error;
+#else
               ret = OK;
+#endif
               break;
             }
         }
@@ -781,6 +836,426 @@ static int nfs_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_readrpc
+ *
+ * Description:
+ *   Perform one READ RPC of up to 'buflen' bytes at 'offset'.  Fewer bytes
+ *   may be read if 'buflen' exceeds the RPC or I/O buffer limits.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                       off_t offset, FAR uint8_t *buffer, size_t buflen,
+                       FAR size_t *nread, FAR bool *eof)
+{
+  ssize_t                    readsize;
+  ssize_t                    tmp;
+  size_t                     reqlen;
+  FAR uint32_t              *ptr;
+  int                        error;
+
+  /* Make sure that the attempted read size does not exceed the RPC maximum */
+
+  readsize = buflen;
+  if (readsize > nmp->nm_rsize)
+    {
+      readsize = nmp->nm_rsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO buffer size */
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %d bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  error = nfs_request(nmp, NFSPROC_READ,
+                      (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (*ptr != 0)
+    {
+      /* Yes... just skip over the attributes for now */
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication. */
+
+  *eof = (*ptr++ != 0);
+
+  /* Then the length of the read data followed by the read data itself */
+
+  readsize = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (readsize > buflen)
+    {
+      return EIO;
+    }
+
+  /* Copy the read data into the caller's buffer */
+
+  memcpy(buffer, ptr, readsize);
+  *nread = readsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_writerpc
+ *
+ * Description:
+ *   Perform one WRITE RPC of up to 'buflen' bytes at 'offset' with the
+ *   requested stability.  Fewer bytes may be written if 'buflen' exceeds
+ *   the RPC or I/O buffer limits.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_writerpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        off_t offset, FAR const uint8_t *buffer,
+                        size_t buflen, uint32_t stable,
+                        FAR size_t *nwritten)
+{
+  ssize_t                writesize;
+  ssize_t                bufsize;
+  size_t                 reqlen;
+  FAR uint32_t          *ptr;
+  uint64_t               size;
+  uint32_t               tmp;
+  int                    error;
+
+  /* Make sure that the attempted write size does not exceed the RPC maximum */
+
+  writesize = buflen;
+  if (writesize > nmp->nm_wsize)
+    {
+      writesize = nmp->nm_wsize;
+    }
+
+  /* Make sure that the attempted write size does not exceed the IO buffer size */
+
+  bufsize = SIZEOF_rpc_call_write(writesize);
+  if (bufsize > nmp->nm_buflen)
+    {
+      writesize -= (bufsize - nmp->nm_buflen);
+    }
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(writesize);
+  *ptr++  = txdr_unsigned(stable);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(writesize);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, writesize);
+  reqlen += uint32_alignup(writesize);
+
+  /* Perform the write */
+
+  nfs_statistics(NFSPROC_WRITE);
+  error = nfs_request(nmp, NFSPROC_WRITE,
+                      (FAR void *)nmp->nm_iobuffer, reqlen,
+                      (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
+  if (error)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  /* The cached attributes of the file are no longer valid */
+
+  nfs_attrcache_flush(nmp);
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure.  The
+       * server does not yet know about data that is still buffered
+       * locally, so do not let the file size shrink.
+       */
+
+      size = np->n_size;
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      if (np->n_size < size)
+        {
+          np->n_size = size;
+        }
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < 1 || tmp > writesize)
+    {
+      return EIO;
+    }
+
+  *nwritten = tmp;
+
+  /* Check the committment level obtained.  If the data is not yet on
+   * stable storage,  then remember the write verifier:  If it changes
+   * before the data is committed, then the server has restarted and the
+   * uncommitted data may have been lost.
+   */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp == NFSV3WRITE_UNSTABLE)
+    {
+      if ((np->n_flags & NFSNODE_UNCOMMITTED) == 0)
+        {
+#ifdef CONFIG_NFS_WRITEBEHIND
+          memcpy(np->n_wrverf, ptr, NFSX_V3WRITEVERF);
+#endif
+          np->n_flags |= NFSNODE_UNCOMMITTED;
+        }
+#ifdef CONFIG_NFS_WRITEBEHIND
+      else if (memcmp(np->n_wrverf, ptr, NFSX_V3WRITEVERF) != 0)
+        {
+          ferr("ERROR: Write verifier changed\n");
+          return EIO;
+        }
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_wbflush
+ *
+ * Description:
+ *   Send any data buffered in the write-behind buffer to the server as
+ *   UNSTABLE writes.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_wbflush(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  size_t nwritten;
+  size_t pos;
+  int error = OK;
+
+  for (pos = 0; pos < np->n_wblen; pos += nwritten)
+    {
+      error = nfs_writerpc(nmp, np, np->n_wboffset + pos,
+                           &np->n_wbbuf[pos], np->n_wblen - pos,
+                           NFSV3WRITE_UNSTABLE, &nwritten);
+      if (error != OK)
+        {
+          break;
+        }
+    }
+
+  /* The buffered data is discarded even on a failure; the error is
+   * reported to the caller that forced the flush.
+   */
+
+  np->n_wblen = 0;
+  return error;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Commit all UNSTABLE writes to the file to stable storage on the
+ *   server.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+  uint32_t      tmp;
+  int           error;
+
+  if ((np->n_flags & NFSNODE_UNCOMMITTED) == 0)
+    {
+      return OK;
+    }
+
+  /* Create the COMMIT RPC call arguments.  An offset and count of zero
+   * commits the entire file.
+   */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen  = 0;
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the COMMIT RPC */
+
+  nfs_statistics(NFSPROC_COMMIT);
+  error = nfs_request(nmp, NFSPROC_COMMIT,
+                      (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  np->n_flags &= ~NFSNODE_UNCOMMITTED;
+
+  /* Skip over the file_wcc data to get to the write verifier */
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* If the verifier has changed, then the server restarted after some of
+   * the data was written and that data may have been lost.
+   */
+
+  if (memcmp(np->n_wrverf, ptr, NFSX_V3WRITEVERF) != 0)
+    {
+      ferr("ERROR: Write verifier changed\n");
+      return EIO;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_read
  *
@@ -794,11 +1269,10 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
   ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  size_t                     nread;
+  bool                       eof;
   int                        error = 0;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
@@ -824,6 +1298,16 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Make sure that the server has any data that we have buffered */
+
+  error = nfs_wbflush(nmp, np);
+  if (error != OK)
+    {
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
@@ -835,110 +1319,85 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       finfo("Read size truncated to %d\n", buflen);
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* Allocate the read-ahead buffer on the first read.  If that fails, then
+   * just read without it.
+   */
+
+  if (np->n_rabuf == NULL)
+    {
+      np->n_rabuf  = (FAR uint8_t *)kmm_malloc(nmp->nm_rsize);
+      np->n_ralen  = 0;
+    }
+#endif
+
   /* Now loop until we fill the user buffer (or hit the end of the file) */
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
+#ifdef CONFIG_NFS_READAHEAD
+      /* Is the data at the current position in the read-ahead buffer? */
 
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
+      if (np->n_ralen > 0 && filep->f_pos >= np->n_raoffset &&
+          filep->f_pos < np->n_raoffset + np->n_ralen)
         {
-          readsize = nmp->nm_rsize;
-        }
+          nread = np->n_raoffset + np->n_ralen - filep->f_pos;
+          if (nread > buflen - bytesread)
+            {
+              nread = buflen - bytesread;
+            }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
+          memcpy(buffer, &np->n_rabuf[filep->f_pos - np->n_raoffset], nread);
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
+          filep->f_pos += nread;
+          bytesread    += nread;
+          buffer       += nread;
+          continue;
         }
 
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
+      /* Small reads are performed through the read-ahead buffer so that
+       * the remainder of the full-sized READ is available to satisfy the
+       * following sequential reads.  Large reads go directly into the user
+       * buffer.
+       */
 
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
+      if (np->n_rabuf != NULL && buflen - bytesread < nmp->nm_rsize)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
-        }
-
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+          np->n_ralen = 0;
+          error = nfs_readrpc(nmp, np, filep->f_pos, np->n_rabuf,
+                              nmp->nm_rsize, &nread, &eof);
+          if (error != OK)
+            {
+              goto errout_with_semaphore;
+            }
 
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+          if (nread == 0)
+            {
+              break;
+            }
 
-      /* Check if attributes are included in the responses */
+          np->n_raoffset = filep->f_pos;
+          np->n_ralen    = nread;
+          continue;
+        }
+#endif
 
-      tmp = *ptr++;
-      if (*ptr != 0)
+      error = nfs_readrpc(nmp, np, filep->f_pos, (FAR uint8_t *)buffer,
+                          buflen - bytesread, &nread, &eof);
+      if (error != OK)
         {
-          /* Yes... just skip over the attributes for now */
-
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          goto errout_with_semaphore;
         }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
       /* Update the read state data */
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+      filep->f_pos += nread;
+      bytesread    += nread;
+      buffer       += nread;
 
       /* Check if we hit the end of file */
 
-      if (tmp != 0)
+      if (eof || nread == 0)
         {
           break;
         }
@@ -967,14 +1426,8 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 {
   struct nfsmount       *nmp;
   struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
+  size_t                 writesize;
   ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
-  int                    committed = NFSV3WRITE_FILESYNC;
   int                    error;
 
   finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
@@ -1008,140 +1461,158 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Now loop until we send the entire user buffer */
+#ifdef CONFIG_NFS_READAHEAD
+  /* Any read-ahead data may now be stale */
 
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
-    {
-      /* Make sure that the attempted write size does not exceed the RPC maximum */
+  np->n_ralen = 0;
+#endif
 
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
-        {
-          writesize = nmp->nm_wsize;
-        }
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Allocate the write-behind buffer on the first write.  If that fails,
+   * then just write without it.
+   */
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
+  if (np->n_wbbuf == NULL)
+    {
+      np->n_wbbuf = (FAR uint8_t *)kmm_malloc(nmp->nm_wsize);
+      np->n_wblen = 0;
+    }
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+  /* Buffered data that is not contiguous with this write must be sent
+   * first.
+   */
+
+  if (np->n_wblen > 0 && np->n_wboffset + np->n_wblen != filep->f_pos)
+    {
+      error = nfs_wbflush(nmp, np);
+      if (error != OK)
         {
-          writesize -= (bufsize - nmp->nm_buflen);
+          goto errout_with_semaphore;
         }
+    }
+#endif
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
+  /* Now loop until we send the entire user buffer */
 
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+  for (byteswritten = 0; byteswritten < buflen; )
+    {
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Coalesce small writes in the write-behind buffer, sending the
+       * buffer when it fills.  Large writes that are not preceded by
+       * buffered data go directly to the server.
+       */
 
-      /* Copy a chunk of the user data into the I/O buffer */
+      if (np->n_wbbuf != NULL &&
+          (np->n_wblen > 0 || buflen - byteswritten < nmp->nm_wsize))
+        {
+          if (np->n_wblen == 0)
+            {
+              np->n_wboffset = filep->f_pos;
+            }
 
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+          writesize = nmp->nm_wsize - np->n_wblen;
+          if (writesize > buflen - byteswritten)
+            {
+              writesize = buflen - byteswritten;
+            }
 
-      /* Perform the write */
+          memcpy(&np->n_wbbuf[np->n_wblen], buffer, writesize);
+          np->n_wblen += writesize;
 
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
-      if (error)
+          if (np->n_wblen >= nmp->nm_wsize)
+            {
+              error = nfs_wbflush(nmp, np);
+              if (error != OK)
+                {
+                  goto errout_with_semaphore;
+                }
+            }
+        }
+      else
+        {
+          error = nfs_writerpc(nmp, np, filep->f_pos,
+                               (FAR const uint8_t *)buffer,
+                               buflen - byteswritten, NFSV3WRITE_UNSTABLE,
+                               &writesize);
+          if (error != OK)
+            {
+              goto errout_with_semaphore;
+            }
+        }
+#else
+      error = nfs_writerpc(nmp, np, filep->f_pos,
+                           (FAR const uint8_t *)buffer,
+                           buflen - byteswritten, NFSV3WRITE_FILESYNC,
+                           &writesize);
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
           goto errout_with_semaphore;
         }
+#endif
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+      /* Update the write state data */
 
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+      filep->f_pos += writesize;
+      byteswritten += writesize;
+      buffer       += writesize;
+    }
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+  /* Account for data written beyond the end of the file */
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
-
-      /* Check if normal file attributes follow */
+  if (filep->f_pos > np->n_size)
+    {
+      np->n_size = filep->f_pos;
+    }
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+  nfs_semgive(nmp);
+  return byteswritten;
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
 
-      /* Get the count of bytes actually written */
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Send any buffered write data to the server and commit all unstable
+ *   writes to stable storage.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int error;
 
-      if (tmp < 1 || tmp > writesize)
-        {
-           error = EIO;
-           goto errout_with_semaphore;
-        }
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      writesize = tmp;
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+  DEBUGASSERT(nmp != NULL);
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error == OK)
+    {
+      error = nfs_wbflush(nmp, np);
+      if (error == OK)
         {
-          committed = commit;
+          error = nfs_commit(nmp, np);
         }
-
-      /* Update the read state data */
-
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
     }
 
-  nfs_semgive(nmp);
-  return writesize;
-
-errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
+#endif
 
 /****************************************************************************
  * Name: nfs_dup
@@ -1312,6 +1783,20 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Send any buffered data first so that it is truncated too */
+
+  error = nfs_wbflush(nmp, np);
+  if (error != OK)
+    {
+      goto errout_with_semaphore;
+    }
+#endif
+
+#ifdef CONFIG_NFS_READAHEAD
+  np->n_ralen = 0;
+#endif
+
   /* Then perform the SETATTR RPC to set the new file size */
 
   error = nfs_filetruncate(nmp, np, length);
@@ -2059,6 +2544,7 @@ static int nfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* And free any allocated resources */
 
+  nfs_attrcache_flush(nmp);
   nxsem_destroy(&nmp->nm_sem);
   kmm_free(nmp->nm_so);
   kmm_free(nmp->nm_rpcclnt);
@@ -2312,6 +2798,7 @@ static int nfs_remove(struct inode *mountpt, const char *relpath)
   /* Perform the REMOVE RPC call */
 
   nfs_statistics(NFSPROC_REMOVE);
+  nfs_attrcache_flush(nmp);
   error = nfs_request(nmp, NFSPROC_REMOVE,
                       (FAR void *)&nmp->nm_msgbuffer.removef, reqlen,
                       (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
@@ -2435,6 +2922,7 @@ static int nfs_mkdir(struct inode *mountpt, const char *relpath, mode_t mode)
   /* Perform the MKDIR RPC */
 
   nfs_statistics(NFSPROC_MKDIR);
+  nfs_attrcache_flush(nmp);
   error = nfs_request(nmp, NFSPROC_MKDIR,
                       (FAR void *)&nmp->nm_msgbuffer.mkdir, reqlen,
                       (FAR void *)&nmp->nm_iobuffer, nmp->nm_buflen);
@@ -2524,6 +3012,7 @@ static int nfs_rmdir(struct inode *mountpt, const char *relpath)
   /* Perform the RMDIR RPC */
 
   nfs_statistics(NFSPROC_RMDIR);
+  nfs_attrcache_flush(nmp);
   error = nfs_request(nmp, NFSPROC_RMDIR,
                           (FAR void *)&nmp->nm_msgbuffer.rmdir, reqlen,
                           (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
@@ -2641,6 +3130,7 @@ static int nfs_rename(struct inode *mountpt, const char *oldrelpath,
   /* Perform the RENAME RPC */
 
   nfs_statistics(NFSPROC_RENAME);
+  nfs_attrcache_flush(nmp);
   error = nfs_request(nmp, NFSPROC_RENAME,
                       (FAR void *)&nmp->nm_msgbuffer.renamef, reqlen,
                       (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
@@ -53,6 +53,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_BGPACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -284,8 +288,22 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+/* This structure describes one entry in the in-memory inode index.  The
+ * index is sorted by name hash (see CONFIG_NXFFS_INDEX).
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  uint32_t                  hash;      /* Hash of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+};
+#endif
+
 /* This structure represents the overall state of on NXFFS instance. */
 
+struct nxffs_pack_s; /* Forward reference */
+
 struct nxffs_volume_s
 {
   FAR struct mtd_dev_s     *mtd;       /* Supports FLASH access */
@@ -302,6 +320,20 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_PACKSTEP
+  FAR struct nxffs_pack_s  *packstate; /* State of the incremental pack in progress */
+  off_t                     ndeleted;  /* Bytes of inode data deleted since last pack */
+  struct nxffs_packstats_s  packstats; /* Packing statistics */
+#endif
+#ifdef CONFIG_NXFFS_BGPACK
+  struct work_s             packwork;  /* Supports background packing */
+#endif
+#ifdef CONFIG_NXFFS_INDEX
+  bool                      indexok;   /* True: The inode index is complete */
+  uint16_t                  nindex;    /* Number of entries in the inode index */
+  uint16_t                  maxindex;  /* Allocated size of the inode index */
+  FAR struct nxffs_index_s *index;     /* In-memory index of valid inodes */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -667,6 +699,150 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
 off_t nxffs_inodeend(FAR struct nxffs_volume_s *volume,
                      FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_clrindex
+ *
+ * Description:
+ *   Empty the inode index.  If 'valid' is true, the volume is known to
+ *   contain no inodes and the empty index is complete.  Otherwise, the
+ *   index is not used until it is rebuilt by nxffs_bldindex().
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   valid  - True if the empty index describes the volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_clrindex(FAR struct nxffs_volume_s *volume, bool valid);
+#else
+#  define nxffs_clrindex(v,n)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bldindex
+ *
+ * Description:
+ *   Rebuild the inode index by scanning all of the valid inodes on the
+ *   volume.  This is done after the volume has been packed.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None.  If the scan fails, the index is left unused and inodes are
+ *   found by scanning FLASH.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_bldindex(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_bldindex(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_addindex
+ *
+ * Description:
+ *   Add a newly written inode to the inode index.  If memory for the index
+ *   cannot be allocated, the index is abandoned.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   name    - The name of the inode
+ *   hoffset - The FLASH offset to the inode header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_addindex(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    off_t hoffset);
+#else
+#  define nxffs_addindex(v,n,h)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_rmindex
+ *
+ * Description:
+ *   Remove a deleted inode from the inode index.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   name    - The name of the inode
+ *   hoffset - The FLASH offset to the inode header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_rmindex(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                   off_t hoffset);
+#else
+#  define nxffs_rmindex(v,n,h)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_findindex
+ *
+ * Description:
+ *   Return the position of the first entry in the inode index with the
+ *   provided name hash, or the position where such an entry would be
+ *   inserted.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   hash   - The name hash returned by nxffs_namehash()
+ *
+ * Returned Value:
+ *   The index of the entry.  volume->nindex is returned if all entries
+ *   have smaller hash values.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_findindex(FAR struct nxffs_volume_s *volume, uint32_t hash);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_namehash
+ *
+ * Description:
+ *   Return the hash of an inode name used to order the inode index.
+ *
+ * Input Parameters:
+ *   name - The name of the inode
+ *
+ * Returned Value:
+ *   The hash value
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+uint32_t nxffs_namehash(FAR const char *name);
+#endif
+
 /****************************************************************************
  * Name: nxffs_verifyblock
  *
@@ -1082,6 +1258,78 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_packstep
+ *
+ * Description:
+ *   Perform one step of an incremental pack of the volume, beginning a new
+ *   pack if none is in progress.  At most 'neblocks' erase blocks are
+ *   packed and rewritten.
+ *
+ *   The FLASH is not consistent between steps (an inode may be only
+ *   partially moved), so all other volume accesses must first call
+ *   nxffs_packfinish().  The caller must hold the volume exclsem.
+ *
+ * Input Parameters:
+ *   volume   - The volume to be packed.
+ *   neblocks - The maximum number of erase blocks to pack in this step.
+ *
+ * Returned Value:
+ *   One (1) if the pack is still in progress.  Zero (OK) if the pack has
+ *   completed (or there was nothing to pack).  Otherwise, a negated errno
+ *   value is returned to indicate the nature of the failure; the pack is
+ *   abandoned in that case.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+int nxffs_packstep(FAR struct nxffs_volume_s *volume, int neblocks);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_packfinish
+ *
+ * Description:
+ *   Complete any incremental pack that is in progress.  This must be called
+ *   (with the volume exclsem held) before the volume is accessed.
+ *
+ * Input Parameters:
+ *   volume - The volume that may be being packed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+int nxffs_packfinish(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_packfinish(v) (OK)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_packschedule
+ *
+ * Description:
+ *   Schedule background packing if files have been deleted and the free
+ *   FLASH at the end of the volume has fallen below the configured
+ *   percentage of the volume.  The caller must hold the volume exclsem.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_packschedule(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_packschedule(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
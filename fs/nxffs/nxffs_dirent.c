@@ -87,6 +87,10 @@ int nxffs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* The requested directory must be the volume-relative "root" directory */
 
   if (relpath && relpath[0] != '\0')
@@ -134,6 +138,10 @@ int nxffs_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Read the next inode header from the offset */
 
   offset = dir->u.nxffs.nx_offset;
@@ -193,6 +201,10 @@ int nxffs_rewinddir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Reset the offset to the FLASH offset to the first valid inode */
 
   dir->u.nxffs.nx_offset = volume->inoffset;
@@ -0,0 +1,268 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <crc32.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The index is allocated in increments of this number of entries */
+
+#define NXFFS_INDEX_INCR  16
+
+/* The index size is limited by the 16-bit entry count */
+
+#define NXFFS_INDEX_MAX   0xffff
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_namehash
+ *
+ * Description:
+ *   Return the hash of an inode name used to order the inode index.
+ *
+ ****************************************************************************/
+
+uint32_t nxffs_namehash(FAR const char *name)
+{
+  return crc32((FAR const uint8_t *)name, strlen(name));
+}
+
+/****************************************************************************
+ * Name: nxffs_findindex
+ *
+ * Description:
+ *   Return the position of the first entry in the inode index with the
+ *   provided name hash, or the position where such an entry would be
+ *   inserted.
+ *
+ ****************************************************************************/
+
+int nxffs_findindex(FAR struct nxffs_volume_s *volume, uint32_t hash)
+{
+  int low  = 0;
+  int high = volume->nindex;
+  int mid;
+
+  /* Binary search for the lower bound */
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (volume->index[mid].hash < hash)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
+}
+
+/****************************************************************************
+ * Name: nxffs_clrindex
+ *
+ * Description:
+ *   Empty the inode index.  If 'valid' is true, the volume is known to
+ *   contain no inodes and the empty index is complete.  Otherwise, the
+ *   index is not used until it is rebuilt by nxffs_bldindex().
+ *
+ ****************************************************************************/
+
+void nxffs_clrindex(FAR struct nxffs_volume_s *volume, bool valid)
+{
+  volume->nindex  = 0;
+  volume->indexok = valid;
+}
+
+/****************************************************************************
+ * Name: nxffs_bldindex
+ *
+ * Description:
+ *   Rebuild the inode index by scanning all of the valid inodes on the
+ *   volume.  This is done after the volume has been packed.
+ *
+ ****************************************************************************/
+
+void nxffs_bldindex(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  nxffs_clrindex(volume, true);
+
+  offset = volume->inoffset;
+  while ((ret = nxffs_nextentry(volume, offset, &entry)) == OK)
+    {
+      nxffs_addindex(volume, entry.name, entry.hoffset);
+
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+    }
+
+  /* -ENOENT means that the end of the valid inodes was reached */
+
+  if (ret != -ENOENT)
+    {
+      ferr("ERROR: Failed to rebuild the inode index: %d\n", -ret);
+      nxffs_clrindex(volume, false);
+    }
+
+  finfo("%d inodes indexed\n", volume->nindex);
+}
+
+/****************************************************************************
+ * Name: nxffs_addindex
+ *
+ * Description:
+ *   Add a newly written inode to the inode index.  If memory for the index
+ *   cannot be allocated, the index is abandoned.
+ *
+ ****************************************************************************/
+
+void nxffs_addindex(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    off_t hoffset)
+{
+  FAR struct nxffs_index_s *newindex;
+  uint32_t hash;
+  int maxindex;
+  int ndx;
+
+  if (!volume->indexok)
+    {
+      return;
+    }
+
+  /* Make room for one more entry */
+
+  if (volume->nindex >= volume->maxindex)
+    {
+      maxindex = volume->maxindex + NXFFS_INDEX_INCR;
+      if (maxindex > NXFFS_INDEX_MAX)
+        {
+          goto errout;
+        }
+
+      newindex = (FAR struct nxffs_index_s *)
+        kmm_realloc(volume->index, maxindex * sizeof(struct nxffs_index_s));
+
+      if (newindex == NULL)
+        {
+          goto errout;
+        }
+
+      volume->index    = newindex;
+      volume->maxindex = maxindex;
+    }
+
+  /* Insert the entry in hash order */
+
+  hash = nxffs_namehash(name);
+  ndx  = nxffs_findindex(volume, hash);
+
+  memmove(&volume->index[ndx + 1], &volume->index[ndx],
+          (volume->nindex - ndx) * sizeof(struct nxffs_index_s));
+
+  volume->index[ndx].hash    = hash;
+  volume->index[ndx].hoffset = hoffset;
+  volume->nindex++;
+  return;
+
+errout:
+
+  /* Fall back to scanning FLASH for inodes */
+
+  fwarn("WARNING: Inode index abandoned\n");
+  nxffs_clrindex(volume, false);
+}
+
+/****************************************************************************
+ * Name: nxffs_rmindex
+ *
+ * Description:
+ *   Remove a deleted inode from the inode index.
+ *
+ ****************************************************************************/
+
+void nxffs_rmindex(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                   off_t hoffset)
+{
+  uint32_t hash;
+  int ndx;
+
+  if (!volume->indexok)
+    {
+      return;
+    }
+
+  hash = nxffs_namehash(name);
+  for (ndx = nxffs_findindex(volume, hash);
+       ndx < volume->nindex && volume->index[ndx].hash == hash;
+       ndx++)
+    {
+      if (volume->index[ndx].hoffset == hoffset)
+        {
+          volume->nindex--;
+          memmove(&volume->index[ndx], &volume->index[ndx + 1],
+                  (volume->nindex - ndx) * sizeof(struct nxffs_index_s));
+          return;
+        }
+    }
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
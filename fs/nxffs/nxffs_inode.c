@@ -377,6 +377,49 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
 {
   off_t offset;
   int ret;
+#ifdef CONFIG_NXFFS_INDEX
+  uint32_t hash;
+  int ndx;
+
+  /* If the inode index is complete, then only the inodes with a matching
+   * name hash need to be examined.
+   */
+
+  if (volume->indexok)
+    {
+      hash = nxffs_namehash(name);
+      for (ndx = nxffs_findindex(volume, hash);
+           ndx < volume->nindex && volume->index[ndx].hash == hash;
+           ndx++)
+        {
+          ret = nxffs_rdentry(volume, volume->index[ndx].hoffset, entry);
+          if (ret < 0)
+            {
+              /* The index does not agree with FLASH.  Stop using it and
+               * fall back to scanning.
+               */
+
+              ferr("ERROR: Bad index entry at %d: %d\n",
+                   volume->index[ndx].hoffset, -ret);
+              nxffs_clrindex(volume, false);
+              break;
+            }
+
+          if (strcmp(name, entry->name) == 0)
+            {
+              return OK;
+            }
+
+          nxffs_freeentry(entry);
+        }
+
+      if (volume->indexok)
+        {
+          finfo("No inode found\n");
+          return -ENOENT;
+        }
+    }
+#endif
 
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
@@ -92,7 +92,16 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       goto errout;
     }
 
-  /* Only a reformat and optimize commands are supported */
+  /* Finish any incremental pack unless the command is part of one */
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+  if (cmd != FIOC_PACKSTEP && cmd != FIOC_PACKSTATS)
+    {
+      (void)nxffs_packfinish(volume);
+    }
+#endif
+
+  /* Only the reformat, optimize and packing commands are supported */
 
   if (cmd == FIOC_REFORMAT)
     {
@@ -120,6 +129,39 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       ret = nxffs_pack(volume);
     }
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+  else if (cmd == FIOC_PACKSTEP)
+    {
+      finfo("Pack step command\n");
+
+      /* Pack up to the requested number of erase blocks */
+
+      ret = nxffs_packstep(volume, (int)arg > 0 ? (int)arg : 1);
+    }
+
+  else if (cmd == FIOC_PACKSTATS)
+    {
+      FAR struct nxffs_packstats_s *stats =
+        (FAR struct nxffs_packstats_s *)((uintptr_t)arg);
+
+      finfo("Pack statistics command\n");
+
+      if (stats == NULL)
+        {
+          ret = -EINVAL;
+          goto errout_with_semaphore;
+        }
+
+      memcpy(stats, &volume->packstats, sizeof(struct nxffs_packstats_s));
+      stats->neraseblocks = volume->geo.neraseblocks;
+      stats->freebytes    = volume->nblocks * volume->geo.blocksize -
+                            volume->froffset;
+      stats->ndeleted     = volume->ndeleted;
+      ret = OK;
+    }
+#endif
+
   else
     {
       /* No other commands supported */
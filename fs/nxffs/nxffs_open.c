@@ -359,6 +359,10 @@ static inline int nxffs_wrname(FAR struct nxffs_volume_s *volume,
       ferr("ERROR: Failed to write inode header block %d: %d\n",
            volume->ioblock, -ret);
     }
+  else
+    {
+      nxffs_addindex(volume, entry->name, entry->hoffset);
+    }
 
   return ret;
 }
@@ -407,6 +411,10 @@ static inline int nxffs_wropen(FAR struct nxffs_volume_s *volume,
       goto errout_with_wrsem;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Check if the file exists */
 
   ret = nxffs_findinode(volume, name, &entry);
@@ -704,6 +712,10 @@ static inline int nxffs_rdopen(FAR struct nxffs_volume_s *volume,
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Check if the file has already been opened (for reading) */
 
   ofile = nxffs_findofile(volume, name);
@@ -903,6 +915,10 @@ static inline int nxffs_wrclose(FAR struct nxffs_volume_s *volume,
 
   ret = nxffs_wrinode(volume, &wrfile->ofile.entry);
 
+  /* Packing is not started while a file is being written */
+
+  nxffs_packschedule(volume);
+
   /* The volume is now available for other writers */
 
 errout:
@@ -1149,6 +1165,10 @@ int nxffs_close(FAR struct file *filep)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Decrement the reference count on the open file */
 
   ret = OK;
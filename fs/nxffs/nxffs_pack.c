@@ -48,6 +48,8 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 
 #include "nxffs.h"
 
@@ -86,6 +88,12 @@ struct nxffs_pack_s
   off_t                ioblock;    /* I/O block number */
   off_t                block0;     /* First I/O block number in the erase block */
   uint16_t             iooffset;   /* I/O block offset */
+
+  /* These describe the progress of the overall packing operation */
+
+  off_t                eblock;     /* Next erase block to be packed */
+  bool                 packed;     /* True: All normal inodes have been packed */
+  FAR struct nxffs_wrfile_s *wrfile; /* The writer to pack (if any) */
 };
 
 /****************************************************************************
@@ -1244,42 +1252,36 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxffs_pack
+ * Name: nxffs_packsetup
  *
  * Description:
- *   Pack and re-write the filesystem in order to free up memory at the end
- *   of FLASH.
+ *   Determine where packing must begin and initialize the packing state.
  *
  * Input Parameters:
  *   volume - The volume to be packed.
+ *   pack   - The volume packing state structure to initialize.
  *
  * Returned Value:
- *   Zero on success; Otherwise, a negated errno value is returned to
- *   indicate the nature of the failure.
+ *   One (1) if packing should proceed with nxffs_packeblock().  Zero (OK)
+ *   if there is nothing to pack.  Otherwise, a negated errno value is
+ *   returned to indicate the nature of the failure.
  *
  ****************************************************************************/
 
-int nxffs_pack(FAR struct nxffs_volume_s *volume)
+static int nxffs_packsetup(FAR struct nxffs_volume_s *volume,
+                           FAR struct nxffs_pack_s *pack)
 {
-  struct nxffs_pack_s pack;
-  FAR struct nxffs_wrfile_s *wrfile;
   off_t iooffset;
-  off_t eblock;
   off_t block;
-  bool packed;
-  int i;
-  int ret = OK;
+  int ret;
 
   /* Get the offset to the first valid inode entry */
 
-  wrfile = NULL;
-  packed = false;
+  iooffset = nxffs_mediacheck(volume, pack);
+
+  pack->wrfile = NULL;
+  pack->packed = false;
 
-  iooffset = nxffs_mediacheck(volume, &pack);
   if (iooffset == 0)
     {
       /* Offset zero is only returned if no valid blocks were found on the
@@ -1291,16 +1293,16 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
       /* Is there a writer? */
 
-      wrfile = nxffs_setupwriter(volume, &pack);
-      if (wrfile)
+      pack->wrfile = nxffs_setupwriter(volume, pack);
+      if (pack->wrfile)
         {
           /* If there is a write, just set ioffset to the offset of data in
            * first block. Setting 'packed' to true will supress normal inode
            * packing operation.  Then we can start compacting the FLASH.
            */
 
-          iooffset = SIZEOF_NXFFS_BLOCK_HDR;
-          packed   = true;
+          iooffset     = SIZEOF_NXFFS_BLOCK_HDR;
+          pack->packed = true;
           goto start_pack;
         }
       else
@@ -1338,7 +1340,7 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
    * begin the packing operation.
    */
 
-  ret = nxffs_startpos(volume, &pack, &iooffset);
+  ret = nxffs_startpos(volume, pack, &iooffset);
   if (ret < 0)
     {
       /* This is a normal situation if the volume is full */
@@ -1359,14 +1361,14 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
                * operation.
                */
 
-              packed = true;
+              pack->packed = true;
 
               /* Writing is performed at the end of the free FLASH region.
                * If we are not packing files, we could still need to pack
                * the partially written file at the end of FLASH.
                */
 
-              wrfile = nxffs_setupwriter(volume, &pack);
+              pack->wrfile = nxffs_setupwriter(volume, pack);
             }
 
           /* Otherwise return OK.. meaning that there is nothing more we can
@@ -1393,211 +1395,547 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
 start_pack:
 
-  pack.ioblock     = nxffs_getblock(volume, iooffset);
-  pack.iooffset    = nxffs_getoffset(volume, iooffset, pack.ioblock);
+  /* Inodes will move.  The inode index is rebuilt when packing completes */
+
+  nxffs_clrindex(volume, false);
+
+  pack->ioblock    = nxffs_getblock(volume, iooffset);
+  pack->iooffset   = nxffs_getoffset(volume, iooffset, pack->ioblock);
+  pack->eblock     = pack->ioblock / volume->blkper;
   volume->froffset = iooffset;
+  return 1;
+}
 
-  /* Then pack all erase blocks starting with the erase block that contains
-   * the ioblock and through the final erase block on the FLASH.
+/****************************************************************************
+ * Name: nxffs_packeblock
+ *
+ * Description:
+ *   Pack the next erase block, pack->eblock, then advance pack->eblock.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *   pack   - The volume packing state structure.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+static int nxffs_packeblock(FAR struct nxffs_volume_s *volume,
+                            FAR struct nxffs_pack_s *pack)
+{
+  off_t eblock = pack->eblock;
+  off_t block;
+  bool clean;
+  int i;
+  int ret;
+
+  /* Get the starting block number of the erase block */
+
+  pack->block0 = eblock * volume->blkper;
+  pack->eblock = eblock + 1;
+
+#ifndef CONFIG_NXFFS_NAND
+  /* Read the erase block into the pack buffer.  We need to do this even
+   * if we are overwriting the entire block so that we skip over
+   * previously marked bad blocks.
    */
 
-  for (eblock = pack.ioblock / volume->blkper;
-       eblock < volume->geo.neraseblocks;
-       eblock++)
+  ret = MTD_BREAD(volume->mtd, pack->block0, volume->blkper, volume->pack);
+  if (ret < 0)
     {
-      /* Get the starting block number of the erase block */
+      ferr("ERROR: Failed to read erase block %d: %d\n", eblock, -ret);
+      return ret;
+    }
 
-      pack.block0 = eblock * volume->blkper;
+  clean = true;
 
-#ifndef CONFIG_NXFFS_NAND
-      /* Read the erase block into the pack buffer.  We need to do this even
-       * if we are overwriting the entire block so that we skip over
-       * previously marked bad blocks.
-       */
+#else
+  /* Read the entire erase block into the pack buffer, one-block-at-a-
+   * time.  We need to do this even if we are overwriting the entire
+   * block so that (1) we skip over previously marked bad blocks, and
+   * (2) we can handle individual block read failures.
+   *
+   * For most FLASH, a read failure indicates a fatal hardware failure.
+   * But for NAND FLASH, the read failure probably indicates a block
+   * with uncorrectable bit errors.
+   */
+
+  /* Read each I/O block */
 
-      ret = MTD_BREAD(volume->mtd, pack.block0, volume->blkper, volume->pack);
+  clean = true;
+  for (i = 0, block = pack->block0, pack->iobuffer = volume->pack;
+       i < volume->blkper;
+       i++, block++, pack->iobuffer += volume->geo.blocksize)
+    {
+      /* Read the next block in the erase block */
+
+      ret = MTD_BREAD(volume->mtd, block, 1, pack->iobuffer);
       if (ret < 0)
         {
-          ferr("ERROR: Failed to read erase block %d: %d\n", eblock, -ret);
-          goto errout_with_pack;
+          /* Force a the block to be an NXFFS bad block */
+
+          ferr("ERROR: Failed to read block %d: %d\n", block, ret);
+          nxffs_blkinit(volume, pack->iobuffer, BLOCK_STATE_BAD);
+          clean = false;
         }
+    }
+#endif
 
-#else
-      /* Read the entire erase block into the pack buffer, one-block-at-a-
-       * time.  We need to do this even if we are overwriting the entire
-       * block so that (1) we skip over previously marked bad blocks, and
-       * (2) we can handle individual block read failures.
-       *
-       * For most FLASH, a read failure indicates a fatal hardware failure.
-       * But for NAND FLASH, the read failure probably indicates a block
-       * with uncorrectable bit errors.
-       */
+  /* If all of the inodes and the writer have already been packed, then the
+   * loop below only erases everything after the block headers.  There is
+   * no need to erase and rewrite an erase block that is already in that
+   * state (as is normally the case beyond the old free FLASH offset).
+   */
 
-      /* Read each I/O block */
+  if (!pack->packed || pack->wrfile != NULL)
+    {
+      clean = false;
+    }
 
-      for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
-           i < volume->blkper;
-           i++, block++, pack.iobuffer += volume->geo.blocksize)
+  for (i = 0, pack->iobuffer = volume->pack;
+       clean && i < volume->blkper;
+       i++, pack->iobuffer += volume->geo.blocksize)
+    {
+      if (nxffs_erased(&pack->iobuffer[SIZEOF_NXFFS_BLOCK_HDR],
+                       volume->geo.blocksize - SIZEOF_NXFFS_BLOCK_HDR) <
+          volume->geo.blocksize - SIZEOF_NXFFS_BLOCK_HDR)
         {
-          /* Read the next block in the erase block */
-
-          ret = MTD_BREAD(volume->mtd, block, 1, pack.iobuffer);
-          if (ret < 0)
-            {
-              /* Force a the block to be an NXFFS bad block */
-
-              ferr("ERROR: Failed to read block %d: %d\n", block, ret);
-              nxffs_blkinit(volume, pack.iobuffer, BLOCK_STATE_BAD);
-            }
+          clean = false;
         }
+    }
+
+  if (clean)
+    {
+#ifdef CONFIG_NXFFS_PACKSTEP
+      volume->packstats.nskipped++;
 #endif
+      return OK;
+    }
 
-      /* Now pack each I/O block */
+  /* Now pack each I/O block */
+
+  for (i = 0, block = pack->block0, pack->iobuffer = volume->pack;
+       i < volume->blkper;
+       i++, block++, pack->iobuffer += volume->geo.blocksize)
+    {
+      /* The first time here, the ioblock may point to an offset into
+       * the erase block.  We just need to skip over those cases.
+       */
 
-      for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
-           i < volume->blkper;
-           i++, block++, pack.iobuffer += volume->geo.blocksize)
+      if (block >= pack->ioblock)
         {
-          /* The first time here, the ioblock may point to an offset into
-           * the erase block.  We just need to skip over those cases.
+          /* Set the I/O position.  Note on the first time we get
+           * pack->iooffset will hold the offset in the first I/O block
+           * to the first inode header.  After that, it will always
+           * refer to the first byte after the block header.
            */
 
-          if (block >= pack.ioblock)
-            {
-              /* Set the I/O position.  Note on the first time we get
-               * pack.iooffset will hold the offset in the first I/O block
-               * to the first inode header.  After that, it will always
-               * refer to the first byte after the block header.
-               */
+          pack->ioblock = block;
 
-              pack.ioblock = block;
+          /* If this is not a valid block or if we have already
+           * finished packing the valid inode entries, then just fall
+           * through, reset the FLASH memory to the erase state, and
+           * write the reset values to FLASH.  (The first block that
+           * we want to process will always be valid -- we have
+           * already verified that).
+           */
 
-              /* If this is not a valid block or if we have already
-               * finished packing the valid inode entries, then just fall
-               * through, reset the FLASH memory to the erase state, and
-               * write the reset values to FLASH.  (The first block that
-               * we want to process will always be valid -- we have
-               * already verified that).
-               */
+          if (nxffs_packvalid(pack))
+            {
+              /* Have we finished packing inodes? */
 
-              if (nxffs_packvalid(&pack))
+              if (!pack->packed)
                 {
-                  /* Have we finished packing inodes? */
+                  DEBUGASSERT(pack->wrfile == NULL);
 
-                  if (!packed)
-                    {
-                      DEBUGASSERT(wrfile == NULL);
+                  /* Pack inode data into this block */
 
-                      /* Pack inode data into this block */
+                  ret = nxffs_packblock(volume, pack);
+                  if (ret < 0)
+                    {
+                      /* The error -ENOSPC is a special value that simply
+                       * means that there is nothing further to be packed.
+                       */
 
-                      ret = nxffs_packblock(volume, &pack);
-                      if (ret < 0)
+                      if (ret == -ENOSPC)
                         {
-                          /* The error -ENOSPC is a special value that simply
-                           * means that there is nothing further to be packed.
+                          pack->packed = true;
+
+                          /* Writing is performed at the end of the free
+                           * FLASH region and this implemenation is restricted
+                           * to a single writer.  The new inode is not
+                           * written to FLASH until the writer is closed
+                           * and so will not be found by nxffs_packblock().
                            */
 
-                          if (ret == -ENOSPC)
-                            {
-                              packed = true;
-
-                              /* Writing is performed at the end of the free
-                               * FLASH region and this implemenation is restricted
-                               * to a single writer.  The new inode is not
-                               * written to FLASH until the writer is closed
-                               * and so will not be found by nxffs_packblock().
-                               */
-
-                              wrfile = nxffs_setupwriter(volume, &pack);
-                            }
-                          else
-                            {
-                              /* Otherwise, something really bad happened */
-
-                              ferr("ERROR: Failed to pack into block %d: %d\n",
-                                   block, ret);
-                              goto errout_with_pack;
-                            }
+                          pack->wrfile = nxffs_setupwriter(volume, pack);
+                        }
+                      else
+                        {
+                          /* Otherwise, something really bad happened */
+
+                          ferr("ERROR: Failed to pack into block %d: %d\n",
+                               block, ret);
+                          return ret;
                         }
                     }
+                }
 
-                  /* If all of the "normal" inodes have been packed, then check if
-                   * we need to pack the current, in-progress write operation.
-                   */
+              /* If all of the "normal" inodes have been packed, then check if
+               * we need to pack the current, in-progress write operation.
+               */
 
-                  if (wrfile)
-                    {
-                      DEBUGASSERT(packed == true);
+              if (pack->wrfile)
+                {
+                  DEBUGASSERT(pack->packed == true);
 
-                      /* Pack write data into this block */
+                  /* Pack write data into this block */
+
+                  ret = nxffs_packwriter(volume, pack, pack->wrfile);
+                  if (ret < 0)
+                    {
+                      /* The error -ENOSPC is a special value that simply
+                       * means that there is nothing further to be packed.
+                       */
 
-                      ret = nxffs_packwriter(volume, &pack, wrfile);
-                      if (ret < 0)
+                      if (ret == -ENOSPC)
                         {
-                          /* The error -ENOSPC is a special value that simply
-                           * means that there is nothing further to be packed.
-                           */
+                          pack->wrfile = NULL;
+                        }
+                      else
+                        {
+                          /* Otherwise, something really bad happened */
 
-                          if (ret == -ENOSPC)
-                            {
-                              wrfile = NULL;
-                            }
-                          else
-                            {
-                              /* Otherwise, something really bad happened */
-
-                              ferr("ERROR: Failed to pack into block %d: %d\n",
-                                   block, ret);
-                              goto errout_with_pack;
-                            }
+                          ferr("ERROR: Failed to pack into block %d: %d\n",
+                               block, ret);
+                          return ret;
                         }
                     }
                 }
+            }
 
-              /* Set any unused portion at the end of the block to the
-               * erased state.
-               */
+          /* Set any unused portion at the end of the block to the
+           * erased state.
+           */
 
-              if (pack.iooffset < volume->geo.blocksize)
-                {
-                  memset(&pack.iobuffer[pack.iooffset],
-                         CONFIG_NXFFS_ERASEDSTATE,
-                         volume->geo.blocksize - pack.iooffset);
-                }
+          if (pack->iooffset < volume->geo.blocksize)
+            {
+              memset(&pack->iobuffer[pack->iooffset],
+                     CONFIG_NXFFS_ERASEDSTATE,
+                     volume->geo.blocksize - pack->iooffset);
+            }
 
-              /* Next time through the loop, pack.iooffset will point to the
-               * first byte after the block header.
-               */
+          /* Next time through the loop, pack->iooffset will point to the
+           * first byte after the block header.
+           */
 
-              pack.iooffset = SIZEOF_NXFFS_BLOCK_HDR;
-            }
+          pack->iooffset = SIZEOF_NXFFS_BLOCK_HDR;
         }
+    }
 
-      /* We now have an in-memory image of how we want this erase block to
-       * appear. Now it is safe to erase the block.
-       */
+  /* We now have an in-memory image of how we want this erase block to
+   * appear. Now it is safe to erase the block.
+   */
+
+  ret = MTD_ERASE(volume->mtd, eblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to erase block %d [%d]: %d\n",
+           eblock, pack->block0, -ret);
+      return ret;
+    }
+
+  /* Write the packed I/O block to FLASH */
+
+  ret = MTD_BWRITE(volume->mtd, pack->block0, volume->blkper, volume->pack);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to write erase block %d [%d]: %d\n",
+           eblock, pack->block0, -ret);
+      return ret;
+    }
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+  volume->packstats.nerased++;
+#endif
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_packdone
+ *
+ * Description:
+ *   Release the resources of the packing operation and rebuild the inode
+ *   index after the last erase block has been packed (or after a failure).
+ *
+ * Input Parameters:
+ *   volume - The volume that was packed.
+ *   pack   - The volume packing state structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void nxffs_packdone(FAR struct nxffs_volume_s *volume,
+                           FAR struct nxffs_pack_s *pack)
+{
+  nxffs_freeentry(&pack->src.entry);
+  nxffs_freeentry(&pack->dest.entry);
+  nxffs_bldindex(volume);
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+  volume->packstats.npacks++;
+  volume->ndeleted = 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: nxffs_packworker
+ *
+ * Description:
+ *   Perform one step of background packing from the low priority work
+ *   queue.  The volume is locked only for the duration of the step.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+static void nxffs_packworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  int ret;
+
+  ret = nxsem_wait(&volume->exclsem);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  /* Don't start packing while a file is being written; the close of
+   * the writer will reschedule the work.
+   */
+
+  ret = OK;
+  if (volume->packstate != NULL || nxffs_findwriter(volume) == NULL)
+    {
+      ret = nxffs_packstep(volume, CONFIG_NXFFS_PACKSTEP_NBLOCKS);
+    }
+
+  /* Continue with the next step, if there is more to do */
+
+  if (ret > 0)
+    {
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume,
+                       0);
+    }
+
+  nxsem_post(&volume->exclsem);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_pack
+ *
+ * Description:
+ *   Pack and re-write the filesystem in order to free up memory at the end
+ *   of FLASH.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
 
-      ret = MTD_ERASE(volume->mtd, eblock, 1);
+int nxffs_pack(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_pack_s pack;
+  int ret;
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+  /* If an incremental pack is in progress, then just finish that one */
+
+  if (volume->packstate != NULL)
+    {
+      return nxffs_packfinish(volume);
+    }
+#endif
+
+  ret = nxffs_packsetup(volume, &pack);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  /* Then pack all erase blocks starting with the erase block that contains
+   * the ioblock and through the final erase block on the FLASH.
+   */
+
+  while (pack.eblock < volume->geo.neraseblocks)
+    {
+      ret = nxffs_packeblock(volume, &pack);
       if (ret < 0)
         {
-          ferr("ERROR: Failed to erase block %d [%d]: %d\n",
-               eblock, pack.block0, -ret);
-          goto errout_with_pack;
+          break;
         }
+    }
 
-      /* Write the packed I/O block to FLASH */
+  nxffs_packdone(volume, &pack);
+  return ret;
+}
 
-      ret = MTD_BWRITE(volume->mtd, pack.block0, volume->blkper, volume->pack);
+/****************************************************************************
+ * Name: nxffs_packstep
+ *
+ * Description:
+ *   Perform one step of an incremental pack of the volume, beginning a new
+ *   pack if none is in progress.  At most 'neblocks' erase blocks are
+ *   packed and rewritten.
+ *
+ *   The FLASH is not consistent between steps (an inode may be only
+ *   partially moved), so all other volume accesses must first call
+ *   nxffs_packfinish().  The caller must hold the volume exclsem.
+ *
+ * Input Parameters:
+ *   volume   - The volume to be packed.
+ *   neblocks - The maximum number of erase blocks to pack in this step.
+ *
+ * Returned Value:
+ *   One (1) if the pack is still in progress.  Zero (OK) if the pack has
+ *   completed (or there was nothing to pack).  Otherwise, a negated errno
+ *   value is returned to indicate the nature of the failure; the pack is
+ *   abandoned in that case.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+int nxffs_packstep(FAR struct nxffs_volume_s *volume, int neblocks)
+{
+  FAR struct nxffs_pack_s *pack = volume->packstate;
+  int ret;
+
+  if (pack == NULL)
+    {
+      /* Begin a new pack */
+
+      pack = (FAR struct nxffs_pack_s *)kmm_malloc(sizeof(struct nxffs_pack_s));
+      if (pack == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      ret = nxffs_packsetup(volume, pack);
+      if (ret <= 0)
+        {
+          kmm_free(pack);
+          return ret;
+        }
+
+      volume->packstate = pack;
+    }
+
+  volume->packstats.nsteps++;
+
+  /* Pack up to 'neblocks' erase blocks */
+
+  ret = OK;
+  while (neblocks-- > 0 && pack->eblock < volume->geo.neraseblocks)
+    {
+      ret = nxffs_packeblock(volume, pack);
       if (ret < 0)
         {
-          ferr("ERROR: Failed to write erase block %d [%d]: %d\n",
-               eblock, pack.block0, -ret);
-          goto errout_with_pack;
+          break;
         }
     }
 
-errout_with_pack:
-  nxffs_freeentry(&pack.src.entry);
-  nxffs_freeentry(&pack.dest.entry);
+  /* Is the pack still in progress? */
+
+  if (ret == OK && pack->eblock < volume->geo.neraseblocks)
+    {
+      volume->packstats.inprogress = true;
+      volume->packstats.eblock     = pack->eblock;
+      return 1;
+    }
+
+  nxffs_packdone(volume, pack);
+  volume->packstate            = NULL;
+  volume->packstats.inprogress = false;
+  volume->packstats.eblock     = 0;
+  kmm_free(pack);
   return ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: nxffs_packfinish
+ *
+ * Description:
+ *   Complete any incremental pack that is in progress.  This must be called
+ *   (with the volume exclsem held) before the volume is accessed.
+ *
+ * Input Parameters:
+ *   volume - The volume that may be being packed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+int nxffs_packfinish(FAR struct nxffs_volume_s *volume)
+{
+  int ret = OK;
+
+  if (volume->packstate != NULL)
+    {
+      ret = nxffs_packstep(volume, volume->geo.neraseblocks);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to complete the pack: %d\n", -ret);
+        }
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxffs_packschedule
+ *
+ * Description:
+ *   Schedule background packing if files have been deleted and the free
+ *   FLASH at the end of the volume has fallen below the configured
+ *   percentage of the volume.  The caller must hold the volume exclsem.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_packschedule(FAR struct nxffs_volume_s *volume)
+{
+  off_t volsize = volume->nblocks * volume->geo.blocksize;
+  off_t freebytes = volsize - volume->froffset;
+
+  if (volume->ndeleted > 0 &&
+      freebytes < (volsize / 100) * CONFIG_NXFFS_BGPACK_FREEPCT &&
+      work_available(&volume->packwork))
+    {
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume,
+                       MSEC2TICK(CONFIG_NXFFS_BGPACK_DELAY));
+    }
+}
+#endif
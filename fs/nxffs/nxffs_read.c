@@ -177,6 +177,10 @@ ssize_t nxffs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Check if the file was opened with read access */
 
   if ((ofile->oflags & O_RDOK) == 0)
@@ -295,6 +295,9 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
       ferr("ERROR: Bad block check failed: %d\n", -ret);
     }
 
+  /* There are no inodes on the freshly formatted volume */
+
+  nxffs_clrindex(volume, true);
   return ret;
 }
 
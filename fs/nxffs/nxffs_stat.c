@@ -87,6 +87,10 @@ int nxffs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Fill in the statfs info
    *
    * REVISIT: Need f_bfree, f_bavail, f_files, f_ffree calculation
@@ -134,6 +138,10 @@ int nxffs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Initialize the return stat instance */
 
   memset(buf, 0, sizeof(struct stat));
@@ -222,6 +230,10 @@ int nxffs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Return status information based on the directory entry */
 
   buf->st_blocks = ofile->entry.datlen /
@@ -98,6 +98,10 @@ int nxffs_truncate(FAR struct file *filep, off_t length)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Check if the file was opened with write access */
 
   if ((wrfile->ofile.oflags & O_WROK) == 0)
@@ -130,6 +130,17 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+  else
+    {
+      nxffs_rmindex(volume, name, entry.hoffset);
+
+#ifdef CONFIG_NXFFS_PACKSTEP
+      /* The space is recovered the next time that the volume is packed */
+
+      volume->ndeleted += entry.datlen;
+      nxffs_packschedule(volume);
+#endif
+    }
 
 errout_with_entry:
   nxffs_freeentry(&entry);
@@ -164,6 +175,10 @@ int nxffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Then remove the NXFFS inode */
 
   ret = nxffs_rminode(volume, relpath);
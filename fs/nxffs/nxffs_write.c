@@ -555,6 +555,10 @@ ssize_t nxffs_write(FAR struct file *filep, FAR const char *buffer, size_t bufle
       goto errout;
     }
 
+  /* Finish any incremental pack before accessing the volume */
+
+  (void)nxffs_packfinish(volume);
+
   /* Check if the file was opened with write access */
 
   if ((wrfile->ofile.oflags & O_WROK) == 0)
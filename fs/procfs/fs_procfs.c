@@ -82,6 +82,7 @@ extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations module_operations;
 extern const struct procfs_operations uptime_operations;
+extern const struct procfs_operations sched_procfsoperations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
  * deal with them here is not a good coupling. What is really needed is a
@@ -93,6 +94,7 @@ extern const struct procfs_operations net_procfsoperations;
 extern const struct procfs_operations net_procfs_routeoperations;
 extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
+extern const struct procfs_operations pm_procfsoperations;
 extern const struct procfs_operations mount_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
 
@@ -170,6 +172,38 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "partitions",    &part_procfsoperations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_PM_GOVERNOR) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PM)
+  { "pm",            &pm_procfsoperations,        PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+  { "sched/balance", &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+  { "sched/locks",   &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_SCHED_LATENCY
+  { "sched/latency", &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_WDOG_SLACK
+  { "sched/wdog",    &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+  { "sched/mutex",   &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_SIG_FASTPATH
+  { "sched/signal",  &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+  { "sched/critmon", &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_PAGING
+  { "sched/paging",  &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+#ifdef CONFIG_SYSCALL_STATS
+  { "sched/syscall", &sched_procfsoperations,     PROCFS_FILE_TYPE   },
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
   { "uptime",        &uptime_operations,          PROCFS_FILE_TYPE   },
 #endif
@@ -55,6 +55,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/mm/mempool.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -69,10 +70,57 @@
 
 #define MEMINFO_LINELEN 54
 
+#ifdef CONFIG_MM_PROFILE
+/* The heap that is profiled */
+
+#  define MEMINFO_HEAP    (&g_mmheap)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_MM_PROFILE
+/* Heap usage of one task or of one allocation call site */
+
+struct meminfo_usage_s
+{
+  FAR void *key;                  /* Task ID or caller address */
+  unsigned long nchunks;          /* Number of allocated chunks */
+  unsigned long nbytes;           /* Total size of the allocated chunks */
+};
+
+/* A snapshot of the heap taken when the file is opened.  The snapshot is
+ * not updated so that consecutive reads see consistent data.
+ */
+
+struct meminfo_profile_s
+{
+  int ntasks;                     /* Number of valid entries in tasks[] */
+  int nsites;                     /* Number of valid entries in sites[] */
+  struct meminfo_usage_s tasks[CONFIG_MAX_TASKS];
+  struct meminfo_usage_s sites[CONFIG_MM_PROFILE_NSITES];
+  struct meminfo_usage_s other;   /* Usage by sites that did not fit */
+  unsigned long nfree[MM_NNODES]; /* Free chunks by power-of-two size */
+  unsigned long grown;            /* Reallocations that grew a chunk */
+  unsigned long moved;            /* ... that moved the data in place */
+  unsigned long copied;           /* ... that copied to a new chunk */
+  unsigned long bytes;            /* Bytes moved or copied */
+};
+#endif
+
+/* The state of meminfo_read() that is passed to meminfo_pool() */
+
+struct meminfo_read_s
+{
+  FAR struct meminfo_file_s *procfile;
+  FAR char *buffer;               /* Current position in the user buffer */
+  size_t buflen;                  /* Space remaining in the user buffer */
+  size_t copysize;                /* Size of the last copy */
+  size_t totalsize;               /* Total bytes copied */
+  off_t offset;                   /* Remaining file offset to skip */
+};
+
 /* This structure describes one open "file" */
 
 struct meminfo_file_s
@@ -80,6 +128,9 @@ struct meminfo_file_s
   struct procfs_file_s base;      /* Base open file structure */
   unsigned int linesize;          /* Number of valid characters in line[] */
   char line[MEMINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
+#ifdef CONFIG_MM_PROFILE
+  FAR struct meminfo_profile_s *profile; /* Heap snapshot (may be NULL) */
+#endif
 };
 
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
@@ -100,6 +151,16 @@ struct progmem_info_s
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 static void    meminfo_progmem(FAR struct progmem_info_s *progmem);
 #endif
+#ifdef CONFIG_MM_PROFILE
+static bool    meminfo_account(FAR struct meminfo_usage_s *table,
+                 FAR int *nentries, int maxentries, FAR void *key,
+                 size_t size);
+static void    meminfo_walker(FAR struct mm_allocnode_s *node,
+                 FAR void *arg);
+static void    meminfo_sort(FAR struct meminfo_usage_s *table,
+                 int nentries);
+static FAR struct meminfo_profile_s *meminfo_snapshot(void);
+#endif
 
 /* File system methods */
 
@@ -201,6 +262,185 @@ static void meminfo_progmem(FAR struct progmem_info_s *progmem)
 }
 #endif
 
+/****************************************************************************
+ * Name: meminfo_pool
+ *
+ * Description:
+ *   mempool_foreach() callback:  Show the state of one object pool.
+ *
+ ****************************************************************************/
+
+static void meminfo_pool(FAR struct mempool_s *pool, FAR void *arg)
+{
+  FAR struct meminfo_read_s *rd = (FAR struct meminfo_read_s *)arg;
+  FAR struct meminfo_file_s *procfile = rd->procfile;
+  struct mempoolinfo_s info;
+  size_t linesize;
+
+  if (rd->totalsize < rd->buflen)
+    {
+      rd->buffer    += rd->copysize;
+      rd->buflen    -= rd->copysize;
+
+      mempool_info(pool, &info);
+
+      linesize       = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "%-10.10s%6lu%6u%6u%6u%9lu%8lu\n",
+                                info.name != NULL ? info.name : "-",
+                                (unsigned long)info.objsize,
+                                info.nobjs, info.nfree, info.maxused,
+                                (unsigned long)info.nalloc,
+                                (unsigned long)info.nfail);
+      rd->copysize   = procfs_memcpy(procfile->line, linesize, rd->buffer,
+                                     rd->buflen, &rd->offset);
+      rd->totalsize += rd->copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: meminfo_account
+ *
+ * Description:
+ *   Add one allocated chunk to the entry of 'table' for 'key', creating
+ *   the entry if there is space.  Returns false if the table is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+static bool meminfo_account(FAR struct meminfo_usage_s *table,
+                            FAR int *nentries, int maxentries,
+                            FAR void *key, size_t size)
+{
+  int i;
+
+  for (i = 0; i < *nentries; i++)
+    {
+      if (table[i].key == key)
+        {
+          break;
+        }
+    }
+
+  if (i >= *nentries)
+    {
+      if (i >= maxentries)
+        {
+          return false;
+        }
+
+      table[i].key     = key;
+      table[i].nchunks = 0;
+      table[i].nbytes  = 0;
+      (*nentries)++;
+    }
+
+  table[i].nchunks++;
+  table[i].nbytes += size;
+  return true;
+}
+
+/****************************************************************************
+ * Name: meminfo_walker
+ *
+ * Description:
+ *   mm_foreach() callback:  Add one heap chunk to the snapshot.  This runs
+ *   with the heap semaphore held and must not allocate memory.
+ *
+ ****************************************************************************/
+
+static void meminfo_walker(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct meminfo_profile_s *profile = (FAR struct meminfo_profile_s *)arg;
+  size_t size = node->size;
+  int ndx;
+
+  if ((node->preceding & MM_ALLOC_BIT) == 0)
+    {
+      /* A free chunk.  Find the power-of-two size bucket */
+
+      for (ndx = 0;
+           ndx < MM_NNODES - 1 && (size >> (MM_MIN_SHIFT + ndx + 1)) != 0;
+           ndx++);
+
+      profile->nfree[ndx]++;
+    }
+  else if (node->caller != NULL)
+    {
+      /* An allocated chunk.  Chunks with no caller are held by the heap
+       * itself (in a per-CPU cache) and have no owner.
+       */
+
+      (void)meminfo_account(profile->tasks, &profile->ntasks,
+                            CONFIG_MAX_TASKS,
+                            (FAR void *)(uintptr_t)node->pid, size);
+
+      if (!meminfo_account(profile->sites, &profile->nsites,
+                           CONFIG_MM_PROFILE_NSITES, node->caller, size))
+        {
+          profile->other.nchunks++;
+          profile->other.nbytes += size;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: meminfo_sort
+ *
+ * Description:
+ *   Sort a usage table by decreasing number of bytes.  The tables are
+ *   small so a simple insertion sort suffices.
+ *
+ ****************************************************************************/
+
+static void meminfo_sort(FAR struct meminfo_usage_s *table, int nentries)
+{
+  struct meminfo_usage_s tmp;
+  int i;
+  int j;
+
+  for (i = 1; i < nentries; i++)
+    {
+      tmp = table[i];
+      for (j = i; j > 0 && table[j - 1].nbytes < tmp.nbytes; j--)
+        {
+          table[j] = table[j - 1];
+        }
+
+      table[j] = tmp;
+    }
+}
+
+/****************************************************************************
+ * Name: meminfo_snapshot
+ *
+ * Description:
+ *   Allocate and fill in a snapshot of the heap usage.  Returns NULL if
+ *   the snapshot cannot be allocated.
+ *
+ ****************************************************************************/
+
+static FAR struct meminfo_profile_s *meminfo_snapshot(void)
+{
+  FAR struct meminfo_profile_s *profile;
+
+  profile = (FAR struct meminfo_profile_s *)
+    kmm_zalloc(sizeof(struct meminfo_profile_s));
+
+  if (profile != NULL)
+    {
+      mm_foreach(MEMINFO_HEAP, meminfo_walker, profile);
+      meminfo_sort(profile->sites, profile->nsites);
+
+      profile->grown  = MEMINFO_HEAP->mm_realloc_grown;
+      profile->moved  = MEMINFO_HEAP->mm_realloc_moved;
+      profile->copied = MEMINFO_HEAP->mm_realloc_copied;
+      profile->bytes  = MEMINFO_HEAP->mm_realloc_bytes;
+    }
+
+  return profile;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_open
  ****************************************************************************/
@@ -242,6 +482,14 @@ static int meminfo_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_MM_PROFILE
+  /* Take the heap snapshot now.  If that fails, the profile is simply
+   * omitted from the output.
+   */
+
+  procfile->profile = meminfo_snapshot();
+#endif
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)procfile;
@@ -263,6 +511,13 @@ static int meminfo_close(FAR struct file *filep)
 
   /* Release the file attributes structure */
 
+#ifdef CONFIG_MM_PROFILE
+  if (procfile->profile != NULL)
+    {
+      kmm_free(procfile->profile);
+    }
+#endif
+
   kmm_free(procfile);
   filep->f_priv = NULL;
   return OK;
@@ -409,6 +664,180 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+  /* Show the object pools */
+
+  if (totalsize < buflen)
+    {
+      struct meminfo_read_s rd;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "\nPool        size total  free  peak"
+                            "   nalloc   nfail\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+
+      rd.procfile  = procfile;
+      rd.buffer    = buffer;
+      rd.buflen    = buflen;
+      rd.copysize  = copysize;
+      rd.totalsize = totalsize;
+      rd.offset    = offset;
+
+      mempool_foreach(meminfo_pool, &rd);
+
+      buffer     = rd.buffer;
+      buflen     = rd.buflen;
+      copysize   = rd.copysize;
+      totalsize  = rd.totalsize;
+      offset     = rd.offset;
+    }
+
+#ifdef CONFIG_MM_PROFILE
+  if (procfile->profile != NULL)
+    {
+      FAR struct meminfo_profile_s *profile = procfile->profile;
+      int i;
+
+      /* Show the heap usage of each task */
+
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "\n   PID     chunks      bytes\n");
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      for (i = 0; i < profile->ntasks && totalsize < buflen; i++)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "%6d%11lu%11lu\n",
+                                (int)(uintptr_t)profile->tasks[i].key,
+                                profile->tasks[i].nchunks,
+                                profile->tasks[i].nbytes);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      /* Show the call sites holding the most memory */
+
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "\n            Caller     chunks      bytes\n");
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      for (i = 0; i < profile->nsites && totalsize < buflen; i++)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "%18p%11lu%11lu\n",
+                                profile->sites[i].key,
+                                profile->sites[i].nchunks,
+                                profile->sites[i].nbytes);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      if (profile->other.nchunks > 0 && totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "%18s%11lu%11lu\n", "other",
+                                profile->other.nchunks,
+                                profile->other.nbytes);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      /* Show the histogram of free chunk sizes */
+
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "\n  Free size     chunks\n");
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      for (i = 0; i < MM_NNODES && totalsize < buflen; i++)
+        {
+          if (profile->nfree[i] == 0)
+            {
+              continue;
+            }
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "%10lu+%11lu\n",
+                                (unsigned long)MM_MIN_CHUNK << i,
+                                profile->nfree[i]);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      /* Show how often realloc() had to move or copy the data */
+
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "\n     grown      moved     copied"
+                                "      bytes\n");
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+
+      if (totalsize < buflen)
+        {
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                                "%10lu%11lu%11lu%11lu\n",
+                                profile->grown, profile->moved,
+                                profile->copied, profile->bytes);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -449,6 +878,21 @@ static int meminfo_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   memcpy(newattr, oldattr, sizeof(struct meminfo_file_s));
 
+#ifdef CONFIG_MM_PROFILE
+  /* The new file gets its own copy of the heap snapshot */
+
+  if (oldattr->profile != NULL)
+    {
+      newattr->profile = (FAR struct meminfo_profile_s *)
+        kmm_malloc(sizeof(struct meminfo_profile_s));
+      if (newattr->profile != NULL)
+        {
+          memcpy(newattr->profile, oldattr->profile,
+                 sizeof(struct meminfo_profile_s));
+        }
+    }
+#endif
+
   /* Save the new attributes in the new file structure */
 
   newp->f_priv = (FAR void *)newattr;
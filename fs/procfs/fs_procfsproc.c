@@ -61,7 +61,7 @@
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
 
-#ifdef CONFIG_SCHED_CPULOAD
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_SCHED_CPUTIME)
 #  include <nuttx/clock.h>
 #endif
 
@@ -103,6 +103,9 @@ enum proc_node_e
   PROC_CMDLINE,                       /* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
   PROC_LOADAVG,                       /* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  PROC_CPUTIME,                       /* Execution time */
 #endif
   PROC_STACK,                         /* Task stack info */
   PROC_GROUP,                         /* Group directory */
@@ -168,6 +171,11 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -250,6 +258,13 @@ static const struct proc_node_s g_loadavg =
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+static const struct proc_node_s g_stat =
+{
+  "stat",         "stat",    (uint8_t)PROC_CPUTIME,      DTYPE_FILE        /* Execution time */
+};
+#endif
+
 static const struct proc_node_s g_stack =
 {
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
@@ -278,6 +293,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
   &g_cmdline,      /* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_stat,         /* Execution time */
 #endif
   &g_stack,        /* Task stack info */
   &g_group,        /* Group directory */
@@ -294,6 +312,9 @@ static const struct proc_node_s * const g_level0info[] =
   &g_cmdline,      /* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_stat,         /* Execution time */
 #endif
   &g_stack,        /* Task stack info */
   &g_group,        /* Group directory */
@@ -702,6 +723,39 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_cputime
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cputime(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  struct timespec ts;
+  size_t linesize;
+  size_t copysize;
+
+  /* Sample the execution time of the thread.  clock_cputime should only
+   * fail if the PID is not valid.  This could happen if the thread exited
+   * sometime after the procfs entry was opened.
+   */
+
+  if (clock_cputime(procfile->pid, &ts) < 0)
+    {
+      ts.tv_sec  = 0;
+      ts.tv_nsec = 0;
+    }
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu.%06lu\n",
+                      "CpuTime:", (unsigned long)ts.tv_sec,
+                      (unsigned long)(ts.tv_nsec / NSEC_PER_USEC));
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+
+  return copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -714,6 +768,9 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   size_t linesize;
   size_t copysize;
   size_t totalsize;
+#ifdef CONFIG_STACK_COLORATION
+  size_t used;
+#endif
 
   remaining = buflen;
   totalsize = 0;
@@ -749,10 +806,43 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
       return totalsize;
     }
 
-  /* Show the stack size */
+  /* Show the stack high-water mark */
+
+  used       = up_check_tcbstack(tcb);
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%ld\n",
+                        "StackUsed:", (long)used);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the stack that has never been used */
 
   linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%ld\n",
-                        "StackUsed:", (long)up_check_tcbstack(tcb));
+                        "StackAvail:", (long)(tcb->adj_stack_size - used));
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the peak usage as a percentage of the stack size */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%u%%\n",
+                        "StackUsage:", tcb->adj_stack_size > 0 ?
+                        (unsigned int)((used * 100) / tcb->adj_stack_size) :
+                        0);
   copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
 
   totalsize += copysize;
@@ -937,11 +1027,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files; i < CONFIG_NFILE_DESCRIPTORS; i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_fget(&group->tg_filelist, i, false);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN, "%3d %8ld %04x\n",
                                 i, (long)file->f_pos, file->f_oflags);
@@ -1175,6 +1266,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
     case PROC_LOADAVG: /* Average CPU utilization */
       ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+    case PROC_CPUTIME: /* Execution time */
+      ret = proc_cputime(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
 #endif
     case PROC_STACK: /* Task stack info */
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
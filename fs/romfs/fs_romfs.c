@@ -1107,6 +1107,9 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           kmm_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+      romfs_freeindex(rm);
+#endif
       nxsem_destroy(&rm->rm_sem);
       kmm_free(rm);
       return OK;
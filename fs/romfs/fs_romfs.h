@@ -129,6 +129,29 @@
  * Public Types
  ****************************************************************************/
 
+/* These structures describe the name index of one directory
+ * (CONFIG_FS_ROMFS_DIRINDEX).  The entries are sorted by name hash.
+ */
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+struct romfs_dirhash_s
+{
+  uint32_t dh_hash;                 /* Hash of the entry name */
+  uint32_t dh_offset;               /* Offset to the entry file header */
+};
+
+struct romfs_dirindex_s
+{
+  FAR struct romfs_dirindex_s *di_flink; /* Next indexed directory */
+  uint32_t di_firstoffset;          /* Offset to the first directory entry */
+  uint16_t di_nentries;             /* Number of entries in the directory */
+  struct romfs_dirhash_s di_entry[1]; /* Actual size is di_nentries */
+};
+
+#define SIZEOF_ROMFS_DIRINDEX_S(n) \
+  (sizeof(struct romfs_dirindex_s) + ((n) - 1) * sizeof(struct romfs_dirhash_s))
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -149,6 +172,9 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  FAR struct romfs_dirindex_s *rm_dirindex; /* Name indices of searched directories */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -213,6 +239,9 @@ int  romfs_fsconfigure(FAR struct romfs_mountpt_s *rm);
 int  romfs_fileconfigure(FAR struct romfs_mountpt_s *rm,
        FAR struct romfs_file_s *rf);
 int  romfs_checkmount(FAR struct romfs_mountpt_s *rm);
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm);
+#endif
 int  romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
        FAR struct romfs_dirinfo_s *dirinfo,
        FAR const char *path);
@@ -277,6 +277,203 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_namehash
+ *
+ * Description:
+ *   Return the (FNV-1a) hash of a name segment of length namelen.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static uint32_t romfs_namehash(FAR const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u;
+
+  while (namelen-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_compareindex
+ *
+ * Description:
+ *   qsort() comparison function used to order the directory index by hash.
+ *
+ ****************************************************************************/
+
+static int romfs_compareindex(FAR const void *a, FAR const void *b)
+{
+  uint32_t hasha = ((FAR const struct romfs_dirhash_s *)a)->dh_hash;
+  uint32_t hashb = ((FAR const struct romfs_dirhash_s *)b)->dh_hash;
+
+  return hasha < hashb ? -1 : (hasha > hashb ? 1 : 0);
+}
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Description:
+ *   Build the name index of the directory whose first entry is at
+ *   firstoffset and add it to the list of indexed directories.  NULL is
+ *   returned if the index could not be built.
+ *
+ ****************************************************************************/
+
+static FAR struct romfs_dirindex_s *
+romfs_buildindex(struct romfs_mountpt_s *rm, uint32_t firstoffset)
+{
+  FAR struct romfs_dirindex_s *dindex;
+  char name[NAME_MAX+1];
+  uint32_t offset;
+  uint32_t next;
+  int16_t  ndx;
+  int      nentries;
+  int      i;
+
+  /* Count the entries in the directory */
+
+  nentries = 0;
+  offset   = firstoffset;
+  do
+    {
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
+        {
+          return NULL;
+        }
+
+      next   = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+      offset = next;
+
+      if (++nentries >= UINT16_MAX)
+        {
+          return NULL;
+        }
+    }
+  while (next != 0);
+
+  dindex = (FAR struct romfs_dirindex_s *)
+    kmm_malloc(SIZEOF_ROMFS_DIRINDEX_S(nentries));
+  if (dindex == NULL)
+    {
+      return NULL;
+    }
+
+  /* Then record the name hash and offset of each entry */
+
+  offset = firstoffset;
+  for (i = 0; i < nentries; i++)
+    {
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0 || romfs_parsefilename(rm, offset, name) < 0)
+        {
+          kmm_free(dindex);
+          return NULL;
+        }
+
+      /* romfs_parsefilename() may have moved the cache */
+
+      ndx  = romfs_devcacheread(rm, offset);
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+
+      dindex->di_entry[i].dh_hash   = romfs_namehash(name, strlen(name));
+      dindex->di_entry[i].dh_offset = offset;
+      offset = next;
+    }
+
+  qsort(dindex->di_entry, nentries, sizeof(struct romfs_dirhash_s),
+        romfs_compareindex);
+
+  dindex->di_firstoffset = firstoffset;
+  dindex->di_nentries    = nentries;
+  dindex->di_flink       = rm->rm_dirindex;
+  rm->rm_dirindex        = dindex;
+
+  finfo("Indexed %d entries of the directory at %08lx\n",
+        nentries, (unsigned long)firstoffset);
+  return dindex;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   Find entryname in the directory beginning at dirinfo->fr_firstoffset
+ *   using the directory's name index (building the index on the first
+ *   search of the directory).  -ENOSYS is returned if no index is
+ *   available.
+ *
+ ****************************************************************************/
+
+static int romfs_searchindex(struct romfs_mountpt_s *rm,
+                             const char *entryname, int entrylen,
+                             struct romfs_dirinfo_s *dirinfo)
+{
+  FAR struct romfs_dirindex_s *dindex;
+  uint32_t firstoffset = dirinfo->rd_dir.fr_firstoffset;
+  uint32_t hash;
+  int low;
+  int high;
+  int mid;
+
+  /* Find the index of this directory */
+
+  dindex = rm->rm_dirindex;
+  while (dindex != NULL && dindex->di_firstoffset != firstoffset)
+    {
+      dindex = dindex->di_flink;
+    }
+
+  if (dindex == NULL)
+    {
+      dindex = romfs_buildindex(rm, firstoffset);
+      if (dindex == NULL)
+        {
+          return -ENOSYS;
+        }
+    }
+
+  /* Binary search for the first entry with a matching hash */
+
+  hash = romfs_namehash(entryname, entrylen);
+  low  = 0;
+  high = dindex->di_nentries;
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (dindex->di_entry[mid].dh_hash < hash)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  /* Then check each entry with that hash */
+
+  for (; low < dindex->di_nentries && dindex->di_entry[low].dh_hash == hash;
+       low++)
+    {
+      if (romfs_checkentry(rm, dindex->di_entry[low].dh_offset, entryname,
+                           entrylen, dirinfo) == OK)
+        {
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+#endif /* CONFIG_FS_ROMFS_DIRINDEX */
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -295,6 +492,16 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Use the name index of the directory if there is one */
+
+  ret = romfs_searchindex(rm, entryname, entrylen, dirinfo);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -499,6 +706,7 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
 int romfs_hwconfigure(struct romfs_mountpt_s *rm)
 {
   struct inode *inode = rm->rm_blkdriver;
+  struct blockmap_s map;
   struct geometry geo;
   int ret;
 
@@ -531,20 +739,20 @@ int romfs_hwconfigure(struct romfs_mountpt_s *rm)
 
   rm->rm_cachesector  = (uint32_t)-1;
 
-  if (inode->u.i_bops->ioctl)
+  map.bm_start    = 0;
+  map.bm_nsectors = geo.geo_nsectors;
+
+  ret = block_map(inode, &map);
+  if (ret == OK && map.bm_addr != NULL)
     {
-      ret = inode->u.i_bops->ioctl(inode, BIOC_XIPBASE,
-                                   (unsigned long)&rm->rm_xipbase);
-      if (ret == OK && rm->rm_xipbase)
-        {
-          /* Yes.. Then we will directly access the media (vs.
-           * copying into an allocated sector buffer.
-           */
+      /* Yes.. Then we will directly access the media (vs.
+       * copying into an allocated sector buffer.
+       */
 
-          rm->rm_buffer      = rm->rm_xipbase;
-          rm->rm_cachesector = 0;
-          return OK;
-        }
+      rm->rm_xipbase     = (FAR uint8_t *)map.bm_addr;
+      rm->rm_buffer      = rm->rm_xipbase;
+      rm->rm_cachesector = 0;
+      return OK;
     }
 
   /* Allocate the device cache buffer for normal sector accesses */
@@ -691,6 +899,27 @@ int romfs_checkmount(struct romfs_mountpt_s *rm)
   return -ENODEV;
 }
 
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Description:
+ *   Free the name indices of all directories of the mountpoint.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+void romfs_freeindex(struct romfs_mountpt_s *rm)
+{
+  FAR struct romfs_dirindex_s *dindex;
+
+  while ((dindex = rm->rm_dirindex) != NULL)
+    {
+      rm->rm_dirindex = dindex->di_flink;
+      kmm_free(dindex);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_finddirentry
  *
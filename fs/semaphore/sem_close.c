@@ -97,9 +97,9 @@ int sem_close(FAR sem_t *sem)
   /* Decrement the reference count on the inode */
 
   inode_semtake();
-  if (inode->i_crefs > 0)
+  if (inode_crefs(inode) > 0)
     {
-      inode->i_crefs--;
+      inode_decref(inode);
     }
 
   /* If the semaphore was previously unlinked and the reference count has
@@ -107,7 +107,8 @@ int sem_close(FAR sem_t *sem)
    * now.
    */
 
-  if (inode->i_crefs <= 0 && (inode->i_flags & FSNODEFLAG_DELETED) != 0)
+  if (inode_crefs(inode) <= 0 &&
+      (inode->i_flags & FSNODEFLAG_DELETED) != 0)
     {
       /* Destroy the semaphore and free the container */
 
@@ -118,10 +119,9 @@ int sem_close(FAR sem_t *sem)
        * unlinked, then the peer pointer should be NULL.
        */
 
-      inode_semgive();
-
       DEBUGASSERT(inode->i_peer == NULL);
-      inode_free(inode);
+      inode_retire(inode);
+      inode_semgive();
       return OK;
     }
 
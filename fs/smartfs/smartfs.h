@@ -315,6 +315,20 @@ struct smartfs_ofile_s
                                           * causes the sector to change. */
 };
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+/* This structure remembers the directory sector that held a name the last
+ * time that the name was found in a directory.
+ */
+
+struct smartfs_dirindex_s
+{
+  uint16_t                  di_dirsector; /* First sector of the directory
+                                           * (zero if the entry is unused) */
+  uint16_t                  di_hash;      /* Hash of the entry name */
+  uint16_t                  di_sector;    /* Directory sector that held the name */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a smartfs filesystem.
@@ -333,6 +347,9 @@ struct smartfs_mountpt_s
   char                       *fs_rwbuffer;  /* Read/Write working buffer */
   char                       *fs_workbuffer;/* Working buffer */
   uint8_t                     fs_rootsector;/* Root directory sector num */
+#ifdef CONFIG_SMARTFS_DIRINDEX
+  struct smartfs_dirindex_s   fs_dirindex[CONFIG_SMARTFS_DIRINDEX_NENTRIES];
+#endif
 };
 
 /****************************************************************************
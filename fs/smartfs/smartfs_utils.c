@@ -65,6 +65,76 @@
 static struct smartfs_mountpt_s *g_mounthead = NULL;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_namehash
+ *
+ * Description: Return a hash of the significant characters of a name.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_DIRINDEX
+static uint16_t smartfs_namehash(FAR const char *name, uint16_t namesize)
+{
+  uint16_t hash = 5381;
+
+  while (namesize-- > 0 && *name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: smartfs_dirindex_lookup
+ *
+ * Description: Return the directory sector where a search for a name
+ *              should begin:  The sector that last held the name, if it
+ *              is in the index, or else the first sector of the directory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_DIRINDEX
+static uint16_t smartfs_dirindex_lookup(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector, uint16_t hash)
+{
+  FAR struct smartfs_dirindex_s *di;
+
+  di = &fs->fs_dirindex[(hash ^ dirsector) % CONFIG_SMARTFS_DIRINDEX_NENTRIES];
+  if (di->di_dirsector == dirsector && di->di_hash == hash)
+    {
+      return di->di_sector;
+    }
+
+  return dirsector;
+}
+#endif
+
+/****************************************************************************
+ * Name: smartfs_dirindex_add
+ *
+ * Description: Remember the directory sector that holds a name.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_DIRINDEX
+static void smartfs_dirindex_add(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector, uint16_t hash, uint16_t sector)
+{
+  FAR struct smartfs_dirindex_s *di;
+
+  di = &fs->fs_dirindex[(hash ^ dirsector) % CONFIG_SMARTFS_DIRINDEX_NENTRIES];
+  di->di_dirsector = dirsector;
+  di->di_hash      = hash;
+  di->di_sector    = sector;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -499,6 +569,10 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
   struct      smartfs_chain_header_s *header;
   struct      smart_read_write_s readwrite;
   struct      smartfs_entry_header_s *entry;
+#ifdef CONFIG_SMARTFS_DIRINDEX
+  uint16_t    startsector;
+  uint16_t    hash;
+#endif
 
   /* Initialize directory level zero as the root sector */
 
@@ -582,6 +656,20 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
 
           dirsector = dirstack[depth];
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+          /* Begin with the directory sector that last held this name (if
+           * known).  That sector is part of this directory because the
+           * index is cleared whenever directory sectors are released.
+           */
+
+          hash        = smartfs_namehash(fs->fs_workbuffer,
+                                         fs->fs_llformat.namesize);
+          startsector = smartfs_dirindex_lookup(fs, dirsector, hash);
+          dirsector   = startsector;
+
+search_directory:
+#endif
+
           /* Read the directory */
 
           offset = 0xFFFF;
@@ -649,6 +737,11 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
                        * open it and continue searching.
                        */
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+                      smartfs_dirindex_add(fs, dirstack[depth], hash,
+                                           readwrite.logsector);
+#endif
+
                       if (*ptr == '\0')
                         {
                           /* We are at the last segment.  Report the entry */
@@ -793,6 +886,19 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
               continue;
             }
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+          /* If the search began part way into the directory, then search
+           * the entire directory before giving up.
+           */
+
+          if (startsector != dirstack[depth])
+            {
+              startsector = dirstack[depth];
+              dirsector   = startsector;
+              goto search_directory;
+            }
+#endif
+
           /* Entry not found!  Report the error.  Also, if this is the last
            * segment, then report the parent directory sector.
            */
@@ -1122,6 +1228,12 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs,
    *        bytes of the buffer to read in header info.
    */
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+  /* Directory sectors may be released below.  Forget where names were. */
+
+  memset(fs->fs_dirindex, 0, sizeof(fs->fs_dirindex));
+
+#endif
   nextsector = entry->firstsector;
   header = (struct smartfs_chain_header_s *) fs->fs_rwbuffer;
   readwrite.offset = 0;
@@ -80,6 +80,10 @@
 #define tmpfs_unlock_directory(tdo) \
            (tmpfs_unlock_object((FAR struct tmpfs_object_s *)tdo))
 
+#ifndef CONFIG_FS_TMPFS_PAGED
+#  define tmpfs_free_file(tfo) kmm_free(tfo)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -93,6 +97,16 @@ static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+              unsigned int npages);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, off_t offset,
+              FAR char *buffer, size_t buflen);
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, off_t offset,
+              FAR const char *buffer, size_t buflen);
+static int  tmpfs_coalesce_file(FAR struct tmpfs_file_s *tfo);
+#endif
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
@@ -371,10 +385,291 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Release all data pages of the file beyond the first 'npages'.  The page
+ *   table itself is freed when no pages remain.  Pages that were gathered
+ *   into one contiguous allocation by tmpfs_coalesce_file() are released
+ *   together when the first of them is released.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+                             unsigned int npages)
+{
+  while (tfo->tfo_npages > npages)
+    {
+      tfo->tfo_npages--;
+      if (tfo->tfo_npages >= tfo->tfo_ncontig)
+        {
+          kmm_free(tfo->tfo_pages[tfo->tfo_npages]);
+        }
+      else if (tfo->tfo_npages == 0)
+        {
+          kmm_free(tfo->tfo_pages[0]);
+          tfo->tfo_ncontig = 0;
+        }
+    }
+
+  /* The remaining pages in the contiguous allocation (if any) are still in
+   * use.
+   */
+
+  if (tfo->tfo_ncontig > npages)
+    {
+      tfo->tfo_ncontig = npages;
+    }
+
+  if (npages == 0 && tfo->tfo_pages != NULL)
+    {
+      kmm_free(tfo->tfo_pages);
+      tfo->tfo_pages    = NULL;
+      tfo->tfo_maxpages = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_free_pages(tfo, 0);
+  kmm_free(tfo);
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_copyout
+ *
+ * Description:
+ *   Copy file data that may span several pages into a user buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, off_t offset,
+                          FAR char *buffer, size_t buflen)
+{
+  unsigned int page = offset / TMPFS_PAGESIZE;
+  size_t pgoffset   = offset % TMPFS_PAGESIZE;
+  size_t nbytes;
+
+  while (buflen > 0)
+    {
+      DEBUGASSERT(page < tfo->tfo_npages);
+
+      nbytes = TMPFS_PAGESIZE - pgoffset;
+      if (nbytes > buflen)
+        {
+          nbytes = buflen;
+        }
+
+      memcpy(buffer, &tfo->tfo_pages[page][pgoffset], nbytes);
+
+      buffer   += nbytes;
+      buflen   -= nbytes;
+      pgoffset  = 0;
+      page++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_copyin
+ *
+ * Description:
+ *   Copy user data into file pages.  The pages must already have been
+ *   allocated by tmpfs_realloc_file().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, off_t offset,
+                         FAR const char *buffer, size_t buflen)
+{
+  unsigned int page = offset / TMPFS_PAGESIZE;
+  size_t pgoffset   = offset % TMPFS_PAGESIZE;
+  size_t nbytes;
+
+  while (buflen > 0)
+    {
+      DEBUGASSERT(page < tfo->tfo_npages);
+
+      nbytes = TMPFS_PAGESIZE - pgoffset;
+      if (nbytes > buflen)
+        {
+          nbytes = buflen;
+        }
+
+      memcpy(&tfo->tfo_pages[page][pgoffset], buffer, nbytes);
+
+      buffer   += nbytes;
+      buflen   -= nbytes;
+      pgoffset  = 0;
+      page++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_coalesce_file
+ *
+ * Description:
+ *   Gather all of the pages of a file into a single contiguous allocation
+ *   so that the file can be memory mapped.  The page table entries are
+ *   updated to refer into the new allocation so that reads and writes
+ *   through the file interface remain coherent with the mapping.  Nothing
+ *   is copied if the file is already contiguous.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int tmpfs_coalesce_file(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *block;
+  unsigned int npages;
+  unsigned int i;
+
+  npages = tfo->tfo_npages;
+  if (npages <= 1 || tfo->tfo_ncontig == npages)
+    {
+      return OK;
+    }
+
+  block = (FAR uint8_t *)kmm_malloc(npages * TMPFS_PAGESIZE);
+  if (block == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      memcpy(&block[i * TMPFS_PAGESIZE], tfo->tfo_pages[i], TMPFS_PAGESIZE);
+    }
+
+  /* Release the old pages, keeping the page table, then point the page
+   * table into the new allocation.
+   */
+
+  while (tfo->tfo_npages > 0)
+    {
+      tfo->tfo_npages--;
+      if (tfo->tfo_npages >= tfo->tfo_ncontig || tfo->tfo_npages == 0)
+        {
+          kmm_free(tfo->tfo_pages[tfo->tfo_npages]);
+        }
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      tfo->tfo_pages[i] = &block[i * TMPFS_PAGESIZE];
+    }
+
+  tfo->tfo_npages  = npages;
+  tfo->tfo_ncontig = npages;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+                              size_t newsize)
+{
+  FAR struct tmpfs_file_s *tmptfo = *tfo;
+  FAR uint8_t **newtable;
+  FAR uint8_t *page;
+  unsigned int maxpages;
+  unsigned int npages;
+  size_t pgoffset;
+  int ret = OK;
+
+  npages = TMPFS_NPAGES(newsize);
+
+  /* Is the page table large enough?  The page table is doubled in size
+   * each time that it fills so that the cost of growing the file remains
+   * proportional to the amount of data added.
+   */
+
+  if (npages > tmptfo->tfo_maxpages)
+    {
+      maxpages = tmptfo->tfo_maxpages > 0 ?
+                 tmptfo->tfo_maxpages : TMPFS_MINPAGES;
+
+      while (maxpages < npages)
+        {
+          maxpages <<= 1;
+        }
+
+      newtable = (FAR uint8_t **)
+        kmm_realloc(tmptfo->tfo_pages, maxpages * sizeof(FAR uint8_t *));
+
+      if (newtable == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tmptfo->tfo_pages    = newtable;
+      tmptfo->tfo_maxpages = maxpages;
+    }
+
+  /* Add new, zeroed pages if the file is growing.  The existing pages never
+   * move.
+   */
+
+  while (tmptfo->tfo_npages < npages)
+    {
+      page = (FAR uint8_t *)kmm_zalloc(TMPFS_PAGESIZE);
+      if (page == NULL)
+        {
+          /* Keep the pages that were allocated; the file size is not
+           * changed.
+           */
+
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      tmptfo->tfo_pages[tmptfo->tfo_npages] = page;
+      tmptfo->tfo_npages++;
+    }
+
+  /* Or release pages if the file is shrinking */
+
+  if (newsize < tmptfo->tfo_size)
+    {
+      tmpfs_free_pages(tmptfo, npages);
+
+      /* All data beyond the end of the file must read as zero if the file
+       * is later extended.
+       */
+
+      pgoffset = newsize % TMPFS_PAGESIZE;
+      if (pgoffset > 0)
+        {
+          memset(&tmptfo->tfo_pages[npages - 1][pgoffset], 0,
+                 TMPFS_PAGESIZE - pgoffset);
+        }
+    }
+
+  tmptfo->tfo_size = newsize;
+
+errout:
+  tmptfo->tfo_alloc = sizeof(struct tmpfs_file_s) +
+                      tmptfo->tfo_npages * TMPFS_PAGESIZE +
+                      tmptfo->tfo_maxpages * sizeof(FAR uint8_t *);
+  return ret;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
                               size_t newsize)
 {
@@ -439,6 +734,7 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
   *tfo              = newtfo;
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -476,7 +772,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -642,6 +938,12 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
   tfo->tfo_refs  = 1;
   tfo->tfo_flags = 0;
   tfo->tfo_size  = 0;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tfo->tfo_npages   = 0;
+  tfo->tfo_maxpages = 0;
+  tfo->tfo_ncontig  = 0;
+  tfo->tfo_pages    = NULL;
+#endif
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -1280,7 +1582,15 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   /* Free the object now */
 
   nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1543,7 +1853,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1591,7 +1901,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_copyout(tfo, startpos, buffer, nread);
+#else
   memcpy(buffer, &tfo->tfo_data[startpos], nread);
+#endif
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1646,7 +1960,11 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_copyin(tfo, startpos, buffer, nwritten);
+#else
   memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+#endif
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1733,7 +2051,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Recover our private data from the struct file instance */
 
-  tfo = filep->f_inode->i_private;
+  tfo = filep->f_priv;
 
   DEBUGASSERT(tfo != NULL);
 
@@ -1741,12 +2059,37 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
+#ifdef CONFIG_FS_TMPFS_PAGED
+      int ret;
+
+      /* The file can be mapped directly only if its pages are contiguous
+       * in memory.  Gather them into one allocation if necessary.  If the
+       * file is empty or there is not enough memory, then fail and let
+       * mmap() fall back to copying the file into RAM.
+       */
+
+      tmpfs_lock_file(tfo);
+      ret = tmpfs_coalesce_file(tfo);
+      if (ret >= 0 && tfo->tfo_npages == 0)
+        {
+          ret = -ENOTTY;
+        }
+
+      if (ret >= 0)
+        {
+          *ppv = (FAR void *)tfo->tfo_pages[0];
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
+#else
       /* Return the address on the media corresponding to the start of
        * the file.
        */
 
       *ppv = (FAR void *)tfo->tfo_data;
       return OK;
+#endif
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1858,14 +2201,16 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
       filep->f_priv = tfo;
 
+#ifndef CONFIG_FS_TMPFS_PAGED
       /* If the size has increased, then we need to zero the newly added
-       * memory.
+       * memory.  (New pages are always zeroed in the paged case).
        */
 
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2276,7 +2621,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -58,6 +58,14 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Page-granular file storage */
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+#  define TMPFS_PAGESIZE    CONFIG_FS_TMPFS_PAGESIZE
+#  define TMPFS_NPAGES(n)   (((n) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+#  define TMPFS_MINPAGES    4   /* Initial size of the page table */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -154,10 +162,21 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_PAGED
+  unsigned int tfo_npages;   /* Number of data pages allocated */
+  unsigned int tfo_maxpages; /* Number of entries in the page table */
+  unsigned int tfo_ncontig;  /* Leading pages held in one allocation */
+  FAR uint8_t **tfo_pages;   /* Page table */
+#else
   uint8_t  tfo_data[1];  /* File data starts here */
+#endif
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#ifdef CONFIG_FS_TMPFS_PAGED
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s))
+#else
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#endif
 
 /* This structure represents one instance of a TMPFS file system */
 
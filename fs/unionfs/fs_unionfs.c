@@ -75,6 +75,18 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+/* Path lookup cache */
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUPCACHE
+#  define CONFIG_FS_UNIONFS_LOOKUPCACHE 0
+#endif
+
+#define UNIONFS_ABSENT(ndx) (1 << (ndx))
+
+/* Initial allocation for the names enumerated by readdir() */
+
+#define UNIONFS_NAMES_ALLOC 256
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,11 +98,29 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+/* This structure describes one entry in the path lookup cache.  The
+ * absent set records the contained file systems on which the relative path
+ * is known not to exist.  Nothing is remembered about paths that do exist,
+ * since these must be looked up on the contained file system anyway.
+ */
+
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Relative path (allocated) */
+  uint32_t ul_hash;                  /* Hash of the relative path */
+  uint8_t ul_absent;                 /* See UNIONFS_ABSENT() */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
 {
   struct unionfs_mountpt_s ui_fs[2]; /* Contained file systems */
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+  struct unionfs_lookup_s ui_cache[CONFIG_FS_UNIONFS_LOOKUPCACHE];
+#endif
   sem_t ui_exclsem;                  /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
@@ -112,6 +142,22 @@ struct unionfs_file_s
 static int     unionfs_semtake(FAR struct unionfs_inode_s *ui, bool noint);
 #define        unionfs_semgive(ui) (void)nxsem_post(&(ui)->ui_exclsem)
 
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+static uint32_t unionfs_hash(FAR const char *relpath);
+static uint8_t unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static void    unionfs_record(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx, int result);
+static void    unionfs_flush(FAR struct unionfs_inode_s *ui);
+#else
+#  define      unionfs_lookup(ui,relpath)         (0)
+#  define      unionfs_record(ui,relpath,ndx,result)
+#  define      unionfs_flush(ui)
+#endif
+static void    unionfs_addname(FAR struct fs_unionfsdir_s *fu,
+                 FAR const char *name);
+static bool    unionfs_hasname(FAR struct fs_unionfsdir_s *fu,
+                 FAR const char *name);
 static FAR const char *unionfs_offsetpath(FAR const char *relpath,
                  FAR const char *prefix);
 static bool    unionfs_ispartprefix(FAR const char *partprefix,
@@ -266,6 +312,217 @@ static int unionfs_semtake(FAR struct unionfs_inode_s *ui, bool noint)
   return ret;
 }
 
+/****************************************************************************
+ * Name: unionfs_hash
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+static uint32_t unionfs_hash(FAR const char *relpath)
+{
+  uint32_t hash = 5381;
+
+  while (*relpath != '\0')
+    {
+      hash = ((hash << 5) + hash) ^ (uint8_t)*relpath++;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_lookup
+ *
+ * Description:
+ *   Return the set of contained file systems on which the relative path is
+ *   known not to exist.  The caller must hold the unionfs semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+static uint8_t unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath)
+{
+  FAR struct unionfs_lookup_s *ul;
+  uint32_t hash;
+
+  if (relpath == NULL)
+    {
+      relpath = "";
+    }
+
+  hash = unionfs_hash(relpath);
+  ul   = &ui->ui_cache[hash % CONFIG_FS_UNIONFS_LOOKUPCACHE];
+
+  if (ul->ul_path != NULL && ul->ul_hash == hash &&
+      strcmp(ul->ul_path, relpath) == 0)
+    {
+      return ul->ul_absent;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_record
+ *
+ * Description:
+ *   Update the path lookup cache with the result of a look-up of the
+ *   relative path on contained file system 'ndx'.  Success shows that the
+ *   path exists and -ENOENT that it does not; other failures show neither.
+ *   The caller must hold the unionfs semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+static void unionfs_record(FAR struct unionfs_inode_s *ui,
+                           FAR const char *relpath, int ndx, int result)
+{
+  FAR struct unionfs_lookup_s *ul;
+  uint32_t hash;
+
+  if (result < 0 && result != -ENOENT)
+    {
+      return;
+    }
+
+  if (relpath == NULL)
+    {
+      relpath = "";
+    }
+
+  hash = unionfs_hash(relpath);
+  ul   = &ui->ui_cache[hash % CONFIG_FS_UNIONFS_LOOKUPCACHE];
+
+  if (ul->ul_path == NULL || ul->ul_hash != hash ||
+      strcmp(ul->ul_path, relpath) != 0)
+    {
+      /* There is no entry for this path.  Only an absent path is worth
+       * remembering.  Replace whatever path was cached in this slot.
+       */
+
+      if (result >= 0)
+        {
+          return;
+        }
+
+      if (ul->ul_path != NULL)
+        {
+          kmm_free(ul->ul_path);
+        }
+
+      ul->ul_path   = strdup(relpath);
+      ul->ul_hash   = hash;
+      ul->ul_absent = 0;
+
+      if (ul->ul_path == NULL)
+        {
+          return;
+        }
+    }
+
+  if (result >= 0)
+    {
+      ul->ul_absent &= ~UNIONFS_ABSENT(ndx);
+    }
+  else
+    {
+      ul->ul_absent |= UNIONFS_ABSENT(ndx);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_flush
+ *
+ * Description:
+ *   Discard the path lookup cache.  This must be done whenever a path is
+ *   created, removed or renamed on either contained file system.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUPCACHE > 0
+static void unionfs_flush(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUPCACHE; i++)
+    {
+      if (ui->ui_cache[i].ul_path != NULL)
+        {
+          kmm_free(ui->ui_cache[i].ul_path);
+          ui->ui_cache[i].ul_path = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_addname
+ *
+ * Description:
+ *   Remember a name enumerated on file system 1 so that the same name can
+ *   be omitted when file system 2 is enumerated.  If memory cannot be
+ *   allocated, the set of names is marked incomplete and readdir() falls
+ *   back to looking up each name on file system 1.
+ *
+ ****************************************************************************/
+
+static void unionfs_addname(FAR struct fs_unionfsdir_s *fu,
+                            FAR const char *name)
+{
+  size_t len = strlen(name) + 1;
+
+  if (fu->fu_nameserr)
+    {
+      return;
+    }
+
+  if (fu->fu_nameslen + len > fu->fu_namessize)
+    {
+      FAR char *names;
+      size_t size;
+
+      size = MAX(2 * fu->fu_namessize, UNIONFS_NAMES_ALLOC);
+      size = MAX(size, fu->fu_nameslen + len);
+
+      names = (FAR char *)kmm_realloc(fu->fu_names, size);
+      if (names == NULL)
+        {
+          fu->fu_nameserr = true;
+          return;
+        }
+
+      fu->fu_names     = names;
+      fu->fu_namessize = size;
+    }
+
+  memcpy(&fu->fu_names[fu->fu_nameslen], name, len);
+  fu->fu_nameslen += len;
+}
+
+/****************************************************************************
+ * Name: unionfs_hasname
+ ****************************************************************************/
+
+static bool unionfs_hasname(FAR struct fs_unionfsdir_s *fu,
+                            FAR const char *name)
+{
+  size_t offset;
+
+  for (offset = 0; offset < fu->fu_nameslen;
+       offset += strlen(&fu->fu_names[offset]) + 1)
+    {
+      if (strcmp(&fu->fu_names[offset], name) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: unionfs_offsetpath
  ****************************************************************************/
@@ -824,6 +1081,10 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       kmm_free(ui->ui_fs[1].um_prefix);
     }
 
+  /* Discard the path lookup cache */
+
+  unionfs_flush(ui);
+
   /* And finally free the allocated unionfs state structure as well */
 
   nxsem_destroy(&ui->ui_exclsem);
@@ -840,6 +1101,7 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  uint8_t absent;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -866,6 +1128,12 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
+  /* Skip any file system on which the file is known not to exist, unless
+   * the file may be created.
+   */
+
+  absent = (oflags & O_CREAT) != 0 ? 0 : unionfs_lookup(ui, relpath);
+
   /* Try to open the file on file system 1 */
 
   um = &ui->ui_fs[0];
@@ -876,7 +1144,14 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   uf->uf_file.f_inode  = um->um_node;
   uf->uf_file.f_priv   = NULL;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+  ret = -ENOENT;
+  if ((absent & UNIONFS_ABSENT(0)) == 0)
+    {
+      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                            mode);
+      unionfs_record(ui, relpath, 0, ret);
+    }
+
   if (ret >= 0)
     {
       /* Successfully opened on file system 1 */
@@ -894,9 +1169,17 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_file.f_inode  = um->um_node;
       uf->uf_file.f_priv   = NULL;
 
-      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+      ret = -ENOENT;
+      if ((absent & UNIONFS_ABSENT(1)) == 0)
+        {
+          ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                oflags, mode);
+          unionfs_record(ui, relpath, 1, ret);
+        }
+
       if (ret < 0)
         {
+          kmm_free(uf);
           goto errout_with_semaphore;
         }
 
@@ -916,6 +1199,13 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   ret = OK;
 
 errout_with_semaphore:
+  if ((oflags & O_CREAT) != 0)
+    {
+      /* A file may have been created */
+
+      unionfs_flush(ui);
+    }
+
   unionfs_semgive(ui);
   return ret;
 }
@@ -1428,6 +1718,7 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   FAR struct fs_unionfsdir_s *fu;
   FAR const struct mountpt_operations *ops;
   FAR struct fs_dirent_s *lowerdir;
+  uint8_t absent;
   int ret;
 
   finfo("relpath: \"%s\"\n", relpath ? relpath : "NULL");
@@ -1470,15 +1761,31 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_relpath;
     }
 
+  /* Skip any file system on which the directory is known not to exist.
+   * Only the existence of the directory is recorded here.  A failure to
+   * open a directory does not prove that nothing exists at the path.
+   */
+
+  absent = unionfs_lookup(ui, relpath);
+
   /* Check file system 2 first. */
 
   um = &ui->ui_fs[1];
   lowerdir->fd_root = um->um_node;
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, lowerdir);
+
+  ret = -ENOENT;
+  if ((absent & UNIONFS_ABSENT(1)) == 0)
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               lowerdir);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 2 access info */
 
+      unionfs_record(ui, relpath, 1, ret);
+
       fu->fu_ndx = 1;
       fu->fu_lower[1] = lowerdir;
 
@@ -1508,11 +1815,20 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   um = &ui->ui_fs[0];
   lowerdir->fd_root = um->um_node;
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, lowerdir);
+
+  ret = -ENOENT;
+  if ((absent & UNIONFS_ABSENT(0)) == 0)
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               lowerdir);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 1 access info */
 
+      unionfs_record(ui, relpath, 0, ret);
+
       fu->fu_ndx = 0;
       fu->fu_lower[0] = lowerdir;
     }
@@ -1640,10 +1956,21 @@ static int unionfs_closedir(FAR struct inode *mountpt,
       kmm_free(fu->fu_relpath);
     }
 
-  fu->fu_ndx      = 0;
-  fu->fu_relpath  = NULL;
-  fu->fu_lower[0] = NULL;
-  fu->fu_lower[1] = NULL;
+  /* Free the names enumerated on file system 1 */
+
+  if (fu->fu_names != NULL)
+    {
+      kmm_free(fu->fu_names);
+    }
+
+  fu->fu_ndx       = 0;
+  fu->fu_relpath   = NULL;
+  fu->fu_lower[0]  = NULL;
+  fu->fu_lower[1]  = NULL;
+  fu->fu_names     = NULL;
+  fu->fu_nameslen  = 0;
+  fu->fu_namessize = 0;
+  fu->fu_nameserr  = false;
 
   /* Decrement the count of open reference.  If that count would go to zero
    * and if the file system has been unmounted, then destroy the file system
@@ -1860,14 +2187,35 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
                 }
             }
 
+          /* Did we successfully read a directory entry from file system
+           * 1?  If file system 2 will be enumerated next, remember the name
+           * so that the matching entry on file system 2 can be omitted.
+           */
+
+          duplicate = false;
+          if (ret >= 0 && fu->fu_ndx == 0 &&
+              (fu->fu_lower[1] != NULL || fu->fu_prefix[1]))
+            {
+              unionfs_addname(fu, fu->fu_lower[0]->fd_dir.d_name);
+            }
+
           /* Did we successfully read a directory from file system 2?  If
            * so, we need to omit an duplicates that should be occluded by
            * the matching file on file system 1 (if we are enumerating
-           * file system 1).
+           * file system 1).  Normally all of the names on file system 1
+           * were remembered as they were enumerated.
            */
 
-          duplicate = false;
-          if (ret >= 0 && fu->fu_ndx == 1 && fu->fu_lower[0] != NULL)
+          else if (ret >= 0 && fu->fu_ndx == 1 && fu->fu_lower[0] != NULL &&
+                   !fu->fu_nameserr)
+            {
+              duplicate = unionfs_hasname(fu,
+                                          fu->fu_lower[1]->fd_dir.d_name);
+            }
+
+          /* Otherwise, look each name up on file system 1 */
+
+          else if (ret >= 0 && fu->fu_ndx == 1 && fu->fu_lower[0] != NULL)
             {
               /* Get the relative path to the same file on file system 1.
                * NOTE: the on any failures we just assume that the filep
@@ -1951,9 +2299,13 @@ static int unionfs_rewinddir(struct inode *mountpt, struct fs_dirent_s *dir)
   DEBUGASSERT(fu->fu_ndx == 0 || fu->fu_ndx == 1);
   if (/* fu->fu_ndx != 0 && */ fu->fu_prefix[0] || fu->fu_lower[0] != NULL)
     {
-      /* Yes.. switch to file system 1 */
+      /* Yes.. switch to file system 1.  Its names will be enumerated and
+       * remembered again.
+       */
 
-      fu->fu_ndx = 0;
+      fu->fu_ndx      = 0;
+      fu->fu_nameslen = 0;
+      fu->fu_nameserr = false;
     }
 
   if (!fu->fu_prefix[fu->fu_ndx])
@@ -2187,6 +2539,10 @@ static int unionfs_unlink(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* The cached look-ups may not survive this change */
+
+  unionfs_flush(ui);
+
   /* Check if some exists at this path on file system 1.  This might be
    * a file or a directory
    */
@@ -2259,6 +2615,10 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+  /* The cached look-ups may not survive this change */
+
+  unionfs_flush(ui);
+
   /* Is there anything with this name on either file system? */
 
   um  = &ui->ui_fs[0];
@@ -2332,6 +2692,10 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       return ret;
     }
 
+  /* The cached look-ups may not survive this change */
+
+  unionfs_flush(ui);
+
   ret = -ENOENT;
 
   /* We really don't know any better so we will try to remove the directory
@@ -2407,6 +2771,10 @@ static int unionfs_rename(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* The cached look-ups may not survive this change */
+
+  unionfs_flush(ui);
+
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
 
   /* Is there a file with this name on file system 1 */
@@ -2464,6 +2832,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  uint8_t absent;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2481,10 +2850,23 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+  /* Skip any file system on which the path is known not to exist */
+
+  absent = unionfs_lookup(ui, relpath);
+
   /* stat this path on file system 1 */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  if ((absent & UNIONFS_ABSENT(0)) == 0)
+    {
+      um  = &ui->ui_fs[0];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      unionfs_record(ui, relpath, 0, ret);
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
@@ -2497,8 +2879,17 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* stat failed on the file system 1.  Try again on file system 2. */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  if ((absent & UNIONFS_ABSENT(1)) == 0)
+    {
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      unionfs_record(ui, relpath, 1, ret);
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
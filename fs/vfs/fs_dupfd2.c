@@ -93,7 +93,14 @@ int dup2(int fd1, int fd2)
   ret = fs_getfilep(fd1, &filep1);
   if (ret >= 0)
     {
-      ret = fs_getfilep(fd2, &filep2);
+      /* Storage for fd2 may not yet have been allocated */
+
+      filep2 = files_fget(sched_getfiles(), fd2, true);
+      if (filep2 == NULL)
+        {
+          ret = (unsigned int)fd2 < CONFIG_NFILE_DESCRIPTORS ?
+                -EMFILE : -EBADF;
+        }
     }
 
   if (ret < 0)
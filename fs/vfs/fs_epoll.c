@@ -42,14 +42,336 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 
-#ifndef CONFIG_DISABLE_POLL
+#include "inode/inode.h"
+
+#if !defined(CONFIG_DISABLE_POLL) && CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One file descriptor registered with epoll_ctl().  The poll registration
+ * with the driver is installed once, by epoll_ctl(), and persists until the
+ * descriptor is removed (or, for EPOLLONESHOT, until it is reported).  The
+ * driver posts the epoll semaphore and sets pfd.revents when an event
+ * occurs.
+ */
+
+struct epoll_node_s
+{
+  FAR struct epoll_node_s *flink; /* Link in the list of nodes to re-arm */
+  struct pollfd pfd;              /* The persistent poll registration */
+  struct epoll_event ev;          /* The events and data from epoll_ctl() */
+  bool inuse;                     /* The node holds a registered descriptor */
+  bool armed;                     /* The poll registration is installed */
+  bool queued;                    /* The node is in the re-arm list */
+};
+
+/* The state of one epoll file descriptor */
+
+struct epoll_head_s
+{
+  sem_t exclsem;                  /* Mutually exclusive access */
+  sem_t sem;                      /* Posted by the drivers on events */
+  int size;                       /* Number of nodes */
+  FAR struct epoll_node_s *rearm; /* Level-triggered nodes reported last */
+  struct epoll_node_s nodes[1];   /* The nodes (actual size is 'size') */
+};
+
+#define SIZEOF_EPOLL_HEAD(n) \
+  (sizeof(struct epoll_head_s) + ((n) - 1) * sizeof(struct epoll_node_s))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_do_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  NULL,           /* open */
+  epoll_do_close, /* close */
+  NULL,           /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  NULL,           /* ioctl */
+  NULL            /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL          /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_head
+ *
+ * Description:
+ *   Return the epoll state associated with an epoll file descriptor, or
+ *   NULL if 'epfd' is not an epoll file descriptor.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_head_s *epoll_head(int epfd)
+{
+  FAR struct file *filep;
+
+  if (fs_getfilep(epfd, &filep) < 0 || filep->f_inode == NULL ||
+      filep->f_inode->u.i_ops != &g_epoll_ops)
+    {
+      return NULL;
+    }
+
+  return (FAR struct epoll_head_s *)filep->f_inode->i_private;
+}
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define epoll_semgive(sem) nxsem_post(sem)
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Install or remove the poll registration of one file or socket
+ *   descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+{
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS+CONFIG_NSOCKET_DESCRIPTORS))
+        {
+          return net_poll(fd, fds, setup);
+        }
+      else
+#endif
+        {
+          return -EBADF;
+        }
+    }
+
+  return fdesc_poll(fd, fds, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_arm and epoll_disarm
+ *
+ * Description:
+ *   Install or remove the persistent poll registration of a node.  When the
+ *   registration is installed, the driver reports any events that are
+ *   already pending.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_head_s *eph,
+                     FAR struct epoll_node_s *node)
+{
+  int ret;
+
+  node->pfd.sem     = &eph->sem;
+  node->pfd.events  = (pollevent_t)(node->ev.events & (POLLIN | POLLOUT)) |
+                      POLLERR | POLLHUP;
+  node->pfd.revents = 0;
+  node->pfd.priv    = NULL;
+
+  ret = epoll_fdsetup(node->pfd.fd, &node->pfd, true);
+  node->armed = (ret >= 0);
+  return ret;
+}
+
+static void epoll_disarm(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_node_s *node)
+{
+  FAR struct epoll_node_s *prev;
+  FAR struct epoll_node_s *curr;
+
+  if (node->armed)
+    {
+      (void)epoll_fdsetup(node->pfd.fd, &node->pfd, false);
+      node->armed = false;
+    }
+
+  /* Remove the node from the re-arm list */
+
+  if (node->queued)
+    {
+      for (prev = NULL, curr = eph->rearm;
+           curr != node;
+           prev = curr, curr = curr->flink)
+        {
+          DEBUGASSERT(curr != NULL);
+        }
+
+      if (prev == NULL)
+        {
+          eph->rearm = node->flink;
+        }
+      else
+        {
+          prev->flink = node->flink;
+        }
+
+      node->queued = false;
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd)
+{
+  int i;
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if (eph->nodes[i].inuse && eph->nodes[i].pfd.fd == fd)
+        {
+          return &eph->nodes[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Collect the events reported by the drivers since the last call.  No
+ *   driver methods are called.
+ *
+ *   Level-triggered nodes are re-armed on the next call to epoll_wait() so
+ *   that they will be reported again if they are still ready.  EPOLLET
+ *   nodes will be reported again only when the driver reports a new event.
+ *   EPOLLONESHOT nodes are disarmed until they are modified with
+ *   EPOLL_CTL_MOD.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_node_s *node;
+  pollevent_t revents;
+  irqstate_t flags;
+  int count = 0;
+  int i;
+
+  for (i = 0; i < eph->size && count < maxevents; i++)
+    {
+      node = &eph->nodes[i];
+      if (!node->armed)
+        {
+          continue;
+        }
+
+      /* The drivers may set revents from interrupt handlers */
+
+      flags = enter_critical_section();
+      revents = node->pfd.revents;
+      node->pfd.revents = 0;
+      leave_critical_section(flags);
+
+      revents &= node->pfd.events;
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[count].events = revents;
+      evs[count].data   = node->ev.data;
+      count++;
+
+      if ((node->ev.events & EPOLLONESHOT) != 0)
+        {
+          epoll_disarm(eph, node);
+        }
+      else if ((node->ev.events & EPOLLET) == 0 && !node->queued)
+        {
+          node->flink  = eph->rearm;
+          eph->rearm   = node;
+          node->queued = true;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: epoll_do_close
+ *
+ * Description:
+ *   Close the epoll file descriptor.  The epoll state is released when the
+ *   last reference to it is closed.
+ *
+ ****************************************************************************/
+
+static int epoll_do_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct epoll_head_s *eph;
+  int i;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+
+  if (inode_crefs(inode) <= 1)
+    {
+      eph = (FAR struct epoll_head_s *)inode->i_private;
+      for (i = 0; i < eph->size; i++)
+        {
+          epoll_disarm(eph, &eph->nodes[i]);
+        }
+
+      nxsem_destroy(&eph->sem);
+      nxsem_destroy(&eph->exclsem);
+      kmm_free(eph);
+      inode->i_private = NULL;
+    }
+
+  return OK;
+}
 
 /****************************************************************************
  * Public Functions
@@ -59,180 +381,336 @@
  * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance.
  *
  * Input Parameters:
+ *   size - The maximum number of file descriptors that may be registered
+ *     with the epoll instance.
  *
  * Returned Value:
+ *   A file descriptor referring to the new epoll instance.  On error, -1
+ *   is returned and errno is set appropriately.
  *
  ****************************************************************************/
 
 int epoll_create(int size)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if (size <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(SIZEOF_EPOLL_HEAD(size));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
 
   eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  (void)nxsem_init(&eph->exclsem, 0, 1);
+  (void)nxsem_init(&eph->sem, 0, 0);
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  /* The event semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
    */
 
-  return (int)((intptr_t)eph);
+  (void)nxsem_setprotocol(&eph->sem, SEM_PRIO_NONE);
+
+  /* The epoll instance is a real file descriptor referring to an unnamed
+   * inode.  The inode is marked as deleted so that it is freed when the
+   * last reference is closed.
+   */
+
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
+
+  INODE_SET_DRIVER(inode);
+  inode->i_flags  |= FSNODEFLAG_DELETED;
+  inode->i_crefs   = 1;
+  inode->u.i_ops   = &g_epoll_ops;
+  inode->i_private = eph;
+
+  fd = files_allocate(inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_inode;
+    }
+
+  return fd;
+
+errout_with_inode:
+  kmm_free(inode);
+
+errout_with_eph:
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->exclsem);
+  kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
 }
 
 /****************************************************************************
  * Name: epoll_close
  *
  * Description:
- *
- * Input Parameters:
- *
- * Returned Value:
+ *   Close an epoll instance.  Equivalent to close(epfd).
  *
  ****************************************************************************/
 
 void epoll_close(int epfd)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
-
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-
-  kmm_free(eph->evs);
-  kmm_free(eph);
+  (void)close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a file descriptor of the epoll instance.  The
+ *   poll registration with the driver is installed here, once, rather than
+ *   on every call to epoll_wait().
+ *
+ *   NOTE:  A file descriptor must be removed from the epoll instance
+ *   before it is closed.
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD, or EPOLL_CTL_DEL
+ *   fd   - The target file or socket descriptor
+ *   ev   - The events of interest (EPOLLIN, EPOLLOUT, EPOLLET,
+ *          EPOLLONESHOT) and the data to return with the events.  Not
+ *          used with EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero on success.  On error, -1 is returned and errno is set
+ *   appropriately.
  *
  ****************************************************************************/
 
 int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  int ret = OK;
+  int i;
+
+  eph = epoll_head(epfd);
+  if (eph == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  epoll_semtake(&eph->exclsem);
+  node = epoll_find(eph, fd);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
-
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        finfo("%d CTL ADD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (node != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        for (i = 0; i < eph->size; i++)
+          {
+            if (!eph->nodes[i].inuse)
+              {
+                break;
+              }
+          }
+
+        if (i >= eph->size)
+          {
+            ret = -ENOSPC;
+            break;
+          }
+
+        node         = &eph->nodes[i];
+        node->pfd.fd = fd;
+        node->ev     = *ev;
+
+        ret = epoll_arm(eph, node);
+        node->inuse = (ret >= 0);
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        finfo("%d CTL DEL: fd=%d\n", epfd, fd);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied-1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          return -ENOENT;
-        }
+        epoll_disarm(eph, node);
+        node->inuse = false;
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
+        finfo("%d CTL MOD: fd=%d ev=%08x\n", epfd, fd, ev->events);
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+        epoll_disarm(eph, node);
+        node->ev = *ev;
 
-          return -ENOENT;
-        }
+        ret = epoll_arm(eph, node);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
+
+  epoll_semgive(&eph->exclsem);
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the epoll instance.  The events are collected from
+ *   the persistent poll registrations; no driver methods are called unless
+ *   level-triggered descriptors reported by the previous call must be
+ *   re-armed.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The location to return the events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The maximum time to wait in milliseconds.  A negative value
+ *               means wait forever; zero means do not wait.
  *
  * Returned Value:
+ *   The number of events returned, or zero on a timeout.  On error, -1 is
+ *   returned and errno is set appropriately.
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  systime_t start;
+  int count;
+  int ret = OK;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  eph = epoll_head(epfd);
+  if (eph == NULL || evs == NULL || maxevents <= 0)
+    {
+      ret = (eph == NULL) ? -EBADF : -EINVAL;
+      goto errout;
+    }
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  start = clock_systimer();
 
-  if (rc <= 0)
+  for (; ; )
     {
-      if (rc < 0)
+      epoll_semtake(&eph->exclsem);
+
+      /* Re-arm the level-triggered descriptors reported by the previous
+       * call.  The driver will report them again now if they are still
+       * ready.
+       */
+
+      while ((node = eph->rearm) != NULL)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          eph->rearm   = node->flink;
+          node->queued = false;
 
-          for (i = 0; i < eph->occupied; i++)
+          if (node->armed)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              epoll_disarm(eph, node);
+              (void)epoll_arm(eph, node);
             }
         }
 
-      return rc;
-    }
+      /* Discard stale event counts, then collect the pending events.  Any
+       * event reported after this point will post the semaphore again.
+       */
+
+      while (nxsem_trywait(&eph->sem) == OK)
+        {
+        }
 
-  /* Iterate over non NULL event fds */
+      count = epoll_collect(eph, evs, maxevents);
+      epoll_semgive(&eph->exclsem);
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
-    {
-      if (eph->evs[counter].revents != 0)
+      if (count > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Wait for a driver to report an event */
+
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, start, MSEC2TICK(timeout));
+          if (ret == -ETIMEDOUT)
+            {
+              ret = OK;
+              break;
+            }
+        }
+      else
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          ret = nxsem_wait(&eph->sem);
+        }
+
+      if (ret < 0)
+        {
+          goto errout;
         }
     }
 
-  return i;
+  leave_cancellation_point();
+  return count;
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
 }
 
-#endif /* CONFIG_DISABLE_POLL */
+#endif /* !CONFIG_DISABLE_POLL && CONFIG_NFILE_DESCRIPTORS > 0 */
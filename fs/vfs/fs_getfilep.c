@@ -102,6 +102,13 @@ int fs_getfilep(int fd, FAR struct file **filep)
 
   /* And return the file pointer from the list */
 
-  *filep = &list->fl_files[fd];
+  *filep = files_fget(list, fd, false);
+  if (*filep == NULL)
+    {
+      /* No storage has been allocated for the descriptor so it is not open */
+
+      return -EBADF;
+    }
+
   return OK;
 }
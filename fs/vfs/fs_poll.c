@@ -47,6 +47,9 @@
 #include <errno.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
@@ -64,6 +67,51 @@
 
 #define poll_semgive(sem) nxsem_post(sem)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+/* One persistent poll registration.  The registration is made on a copy of
+ * the caller's pollfd that lives in kernel memory, so it can stay installed
+ * in the driver between calls to poll().  It is kept while the thread polls
+ * the same descriptor for the same events and no events are reported on
+ * it.  A descriptor that reported events is set up again on the next call
+ * so that the driver re-evaluates its state (poll() is level-triggered).
+ */
+
+struct pollcache_entry_s
+{
+  struct pollfd pfd;           /* The registration; pfd.fd is the descriptor */
+  FAR struct file *filep;      /* The open file; NULL if the entry is free */
+  bool armed;                  /* The registration is installed */
+  bool used;                   /* Used by the poll() in progress */
+  bool rearm;                  /* Events were reported; set up again */
+  bool closed;                 /* The file was closed during the poll() */
+};
+
+/* The persistent poll registrations of one thread */
+
+struct pollcache_s
+{
+  FAR struct pollcache_s *flink; /* Link in the list of all caches */
+  sem_t exclsem;                 /* Protects the entries */
+  sem_t sem;                     /* Posted by the drivers */
+  struct pollcache_entry_s entries[CONFIG_FS_POLLCACHE_NFDS];
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+/* All caches, so that poll_forget() can find the registrations on a file */
+
+static FAR struct pollcache_s *g_pollcaches;
+static sem_t g_pollcachesem = SEM_INITIALIZER(1);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -237,6 +285,377 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds, int *count,
 }
 #endif
 
+#ifdef CONFIG_FS_POLLCACHE
+/****************************************************************************
+ * Name: poll_lock
+ *
+ * Description:
+ *   Take a semaphore, ignoring signals.
+ *
+ ****************************************************************************/
+
+static void poll_lock(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(sem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: poll_cacheget
+ *
+ * Description:
+ *   Return the poll cache of the calling thread, creating it on first use.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_s *poll_cacheget(void)
+{
+  FAR struct tcb_s *tcb = sched_self();
+  FAR struct pollcache_s *cache = tcb->pollcache;
+
+  if (cache == NULL)
+    {
+      cache = (FAR struct pollcache_s *)
+        kmm_zalloc(sizeof(struct pollcache_s));
+      if (cache == NULL)
+        {
+          return NULL;
+        }
+
+      /* The driver semaphore is used for signaling and, hence, should not
+       * have priority inheritance enabled.
+       */
+
+      nxsem_init(&cache->exclsem, 0, 1);
+      nxsem_init(&cache->sem, 0, 0);
+      nxsem_setprotocol(&cache->sem, SEM_PRIO_NONE);
+
+      poll_lock(&g_pollcachesem);
+      cache->flink  = g_pollcaches;
+      g_pollcaches  = cache;
+      tcb->pollcache = cache;
+      poll_semgive(&g_pollcachesem);
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: poll_cachedisarm
+ *
+ * Description:
+ *   Remove the registration of an entry from the driver.  The entry is
+ *   freed unless 'keep' is true.
+ *
+ ****************************************************************************/
+
+static void poll_cachedisarm(FAR struct pollcache_entry_s *entry, bool keep)
+{
+  if (entry->armed)
+    {
+      (void)file_poll(entry->filep, &entry->pfd, false);
+      entry->armed = false;
+    }
+
+  if (!keep)
+    {
+      entry->filep  = NULL;
+      entry->closed = false;
+    }
+}
+
+/****************************************************************************
+ * Name: poll_cachearm
+ *
+ * Description:
+ *   Install the registration of an entry for the events of 'fds'.  If
+ *   events are already pending, the driver posts the cache semaphore.
+ *
+ ****************************************************************************/
+
+static int poll_cachearm(FAR struct pollcache_s *cache,
+                         FAR struct pollcache_entry_s *entry,
+                         FAR struct file *filep, FAR struct pollfd *fds)
+{
+  int ret;
+
+  entry->filep       = filep;
+  entry->pfd.fd      = fds->fd;
+  entry->pfd.sem     = &cache->sem;
+  entry->pfd.events  = fds->events;
+  entry->pfd.revents = 0;
+  entry->pfd.priv    = NULL;
+  entry->rearm       = false;
+  entry->closed      = false;
+
+  ret = file_poll(filep, &entry->pfd, true);
+  entry->armed = (ret >= 0);
+  if (ret < 0)
+    {
+      entry->filep = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: poll_cacheentry
+ *
+ * Description:
+ *   Set up fds[i] through the cache.  An existing registration for the same
+ *   file and events is reused as is.  Returns NULL if the descriptor is not
+ *   an open file or all entries are in use by this poll(); the caller then
+ *   sets up the descriptor directly.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_entry_s *
+poll_cacheentry(FAR struct pollcache_s *cache, FAR struct pollfd *fds,
+                FAR int *result)
+{
+  FAR struct pollcache_entry_s *entry = NULL;
+  FAR struct pollcache_entry_s *curr;
+  FAR struct file *filep;
+  int i;
+
+  *result = OK;
+  if ((unsigned int)fds->fd >= CONFIG_NFILE_DESCRIPTORS ||
+      fs_getfilep(fds->fd, &filep) < 0 || filep->f_inode == NULL)
+    {
+      return NULL;
+    }
+
+  /* Look for the registration from the last call, else for a free entry,
+   * else for an entry that this call does not use.
+   */
+
+  for (i = 0; i < CONFIG_FS_POLLCACHE_NFDS; i++)
+    {
+      curr = &cache->entries[i];
+      if (curr->used)
+        {
+          continue;
+        }
+
+      if (curr->filep == filep && curr->pfd.fd == fds->fd && !curr->closed)
+        {
+          entry = curr;
+          break;
+        }
+
+      if (entry == NULL || (entry->filep != NULL && curr->filep == NULL))
+        {
+          entry = curr;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  entry->used = true;
+  if (entry->filep == filep && entry->armed && !entry->rearm &&
+      entry->pfd.events == fds->events)
+    {
+      /* Still installed.  Events that arrived since the last call are
+       * collected by this one.
+       */
+
+      if ((entry->pfd.revents & entry->pfd.events) != 0)
+        {
+          poll_semgive(&cache->sem);
+        }
+
+      return entry;
+    }
+
+  poll_cachedisarm(entry, false);
+  *result = poll_cachearm(cache, entry, filep, fds);
+  if (*result < 0)
+    {
+      entry->used = false;
+      return NULL;
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: poll_cachesetup
+ *
+ * Description:
+ *   Setup the poll operation for each descriptor in the list, using and
+ *   updating the persistent registrations of the calling thread.  fds[i].sem
+ *   is NULL for the descriptors that use a cached registration and
+ *   fds[i].priv then refers to the entry.
+ *
+ ****************************************************************************/
+
+static int poll_cachesetup(FAR struct pollcache_s *cache,
+                           FAR struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct pollcache_entry_s *entry;
+  unsigned int i;
+  unsigned int j;
+  int ret;
+
+  /* Discard wake-ups left over from earlier calls */
+
+  do
+    {
+      ret = nxsem_trywait(&cache->sem);
+    }
+  while (ret == OK);
+
+  for (i = 0; i < CONFIG_FS_POLLCACHE_NFDS; i++)
+    {
+      cache->entries[i].used = false;
+      if (cache->entries[i].closed)
+        {
+          poll_cachedisarm(&cache->entries[i], false);
+        }
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      fds[i].sem     = &cache->sem;
+      fds[i].revents = 0;
+      fds[i].priv    = NULL;
+
+      if (fds[i].fd < 0)
+        {
+          continue;
+        }
+
+      entry = poll_cacheentry(cache, &fds[i], &ret);
+      if (entry != NULL)
+        {
+          fds[i].sem  = NULL;
+          fds[i].priv = entry;
+          continue;
+        }
+
+      if (ret >= 0)
+        {
+          ret = poll_fdsetup(fds[i].fd, &fds[i], true);
+        }
+
+      if (ret < 0)
+        {
+          /* Teardown the descriptors that were set up directly.  The
+           * cached registrations stay installed.
+           */
+
+          for (j = 0; j < i; j++)
+            {
+              if (fds[j].fd >= 0 && fds[j].sem != NULL)
+                {
+                  (void)poll_fdsetup(fds[j].fd, &fds[j], false);
+                }
+
+              fds[j].sem  = NULL;
+              fds[j].priv = NULL;
+            }
+
+          for (j = 0; j < CONFIG_FS_POLLCACHE_NFDS; j++)
+            {
+              cache->entries[j].used = false;
+            }
+
+          fds[i].sem      = NULL;
+          fds[i].revents |= POLLERR;
+          return ret;
+        }
+    }
+
+  /* Registrations that this call does not use would only cause spurious
+   * wake-ups.
+   */
+
+  for (i = 0; i < CONFIG_FS_POLLCACHE_NFDS; i++)
+    {
+      if (!cache->entries[i].used)
+        {
+          poll_cachedisarm(&cache->entries[i], false);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: poll_cacheteardown
+ *
+ * Description:
+ *   Collect the events of each descriptor in the list and return the count
+ *   of non-zero poll events.  Descriptors set up directly are torn down;
+ *   cached registrations stay installed.
+ *
+ ****************************************************************************/
+
+static int poll_cacheteardown(FAR struct pollcache_s *cache,
+                              FAR struct pollfd *fds, nfds_t nfds,
+                              FAR int *count, int ret)
+{
+  FAR struct pollcache_entry_s *entry;
+  irqstate_t flags;
+  unsigned int i;
+  int status;
+
+  *count = 0;
+  for (i = 0; i < nfds; i++)
+    {
+      if (fds[i].fd >= 0 && fds[i].sem == NULL)
+        {
+          entry = (FAR struct pollcache_entry_s *)fds[i].priv;
+
+          /* The drivers may set revents from interrupt handlers */
+
+          flags = enter_critical_section();
+          fds[i].revents     = entry->pfd.revents;
+          entry->pfd.revents = 0;
+          leave_critical_section(flags);
+
+          if (entry->closed)
+            {
+              fds[i].revents = POLLNVAL;
+            }
+          else if (fds[i].revents != 0)
+            {
+              entry->rearm = true;
+            }
+
+          entry->used = false;
+          fds[i].priv = NULL;
+        }
+      else if (fds[i].fd >= 0)
+        {
+          status = poll_fdsetup(fds[i].fd, &fds[i], false);
+          if (status < 0)
+            {
+              ret = status;
+            }
+        }
+
+      if (fds[i].revents != 0)
+        {
+          (*count)++;
+        }
+
+      fds[i].sem = NULL;
+    }
+
+  return ret;
+}
+#endif /* CONFIG_FS_POLLCACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -348,6 +767,108 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 }
 #endif
 
+/****************************************************************************
+ * Name: poll_forget
+ *
+ * Description:
+ *   Remove any persistent poll() registrations made on an open file.  This
+ *   must be called before the file is closed or detached.  A thread that is
+ *   polling the file at the time is woken up and sees POLLNVAL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+void poll_forget(FAR struct file *filep)
+{
+  FAR struct pollcache_entry_s *entry;
+  FAR struct pollcache_s *cache;
+  int i;
+
+  poll_lock(&g_pollcachesem);
+
+  for (cache = g_pollcaches; cache != NULL; cache = cache->flink)
+    {
+      poll_lock(&cache->exclsem);
+
+      for (i = 0; i < CONFIG_FS_POLLCACHE_NFDS; i++)
+        {
+          entry = &cache->entries[i];
+          if (entry->filep != filep)
+            {
+              continue;
+            }
+
+          if (entry->used)
+            {
+              poll_cachedisarm(entry, true);
+              entry->closed = true;
+              poll_semgive(&cache->sem);
+            }
+          else
+            {
+              poll_cachedisarm(entry, false);
+            }
+        }
+
+      poll_semgive(&cache->exclsem);
+    }
+
+  poll_semgive(&g_pollcachesem);
+}
+#endif
+
+/****************************************************************************
+ * Name: poll_releasecache
+ *
+ * Description:
+ *   Remove the persistent poll() registrations of an exiting thread and
+ *   free them.  This is called from the task exit logic while the files of
+ *   the thread are still open.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+void poll_releasecache(FAR struct tcb_s *tcb)
+{
+  FAR struct pollcache_s *cache = tcb->pollcache;
+  FAR struct pollcache_s *prev;
+  int i;
+
+  if (cache == NULL)
+    {
+      return;
+    }
+
+  poll_lock(&g_pollcachesem);
+
+  if (g_pollcaches == cache)
+    {
+      g_pollcaches = cache->flink;
+    }
+  else
+    {
+      for (prev = g_pollcaches; prev->flink != cache; prev = prev->flink)
+        {
+          DEBUGASSERT(prev->flink != NULL);
+        }
+
+      prev->flink = cache->flink;
+    }
+
+  for (i = 0; i < CONFIG_FS_POLLCACHE_NFDS; i++)
+    {
+      poll_cachedisarm(&cache->entries[i], false);
+    }
+
+  poll_semgive(&g_pollcachesem);
+
+  nxsem_destroy(&cache->sem);
+  nxsem_destroy(&cache->exclsem);
+  kmm_free(cache);
+  tcb->pollcache = NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: poll
  *
@@ -381,7 +902,12 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 
 int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 {
+#ifdef CONFIG_FS_POLLCACHE
+  FAR struct pollcache_s *cache;
+#else
   sem_t sem;
+#endif
+  FAR sem_t *psem;
   int count = 0;
   int errcode;
   int ret;
@@ -390,6 +916,22 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   (void)enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Use the persistent registrations of this thread */
+
+  cache = poll_cacheget();
+  if (cache == NULL)
+    {
+      leave_cancellation_point();
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  psem = &cache->sem;
+  poll_lock(&cache->exclsem);
+  ret = poll_cachesetup(cache, fds, nfds);
+  poll_semgive(&cache->exclsem);
+#else
   /* This semaphore is used for signaling and, hence, should not have
    * priority inheritance enabled.
    */
@@ -397,7 +939,10 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   nxsem_init(&sem, 0, 0);
   nxsem_setprotocol(&sem, SEM_PRIO_NONE);
 
-  ret = poll_setup(fds, nfds, &sem);
+  psem = &sem;
+  ret  = poll_setup(fds, nfds, &sem);
+#endif
+
   if (ret >= 0)
     {
       if (timeout == 0)
@@ -435,7 +980,7 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
            * immediately.
            */
 
-           ret = nxsem_tickwait(&sem, clock_systimer(), ticks);
+           ret = nxsem_tickwait(psem, clock_systimer(), ticks);
            if (ret < 0)
              {
                if (ret == -ETIMEDOUT)
@@ -452,7 +997,7 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
         {
           /* Wait for the poll event or signal with no timeout */
 
-          ret = poll_semtake(&sem);
+          ret = poll_semtake(psem);
         }
 
       /* Teardown the poll operation and get the count of events.  Zero will be
@@ -461,14 +1006,22 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
        * Preserve ret, if negative, since it holds the result of the wait.
        */
 
+#ifdef CONFIG_FS_POLLCACHE
+      poll_lock(&cache->exclsem);
+      errcode = poll_cacheteardown(cache, fds, nfds, &count, ret);
+      poll_semgive(&cache->exclsem);
+#else
       errcode = poll_teardown(fds, nfds, &count, ret);
+#endif
       if (errcode < 0 && ret >= 0)
         {
           ret = errcode;
         }
     }
 
+#ifndef CONFIG_FS_POLLCACHE
   nxsem_destroy(&sem);
+#endif
   leave_cancellation_point();
 
   /* Check for errors */
@@ -0,0 +1,262 @@
+/****************************************************************************
+ * fs/vfs/fs_readv.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_VECTORED_IO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readv_emulate
+ *
+ * Description:
+ *   Read into each element of the iovec in turn using the single buffer
+ *   read function 'readfn'.  Reading stops after a short read so that the
+ *   caller is not blocked with data already transferred.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+static ssize_t readv_emulate(FAR struct file *filep,
+                             FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ntotal = 0;
+  ssize_t nread;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = file_read(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          return ntotal > 0 ? ntotal : nread;
+        }
+
+      ntotal += nread;
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   Equivalent to the standard readv() function except that is accepts a
+ *   struct file instance instead of a file descriptor, does not modify the
+ *   errno variable, and is not a cancellation point.  The readv method of
+ *   the driver or file system is used if it provides one.
+ *
+ * Returned Value:
+ *   The number of bytes read on success or a negated errno value on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR struct inode *inode;
+
+  /* Was this file opened for read access? */
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  inode = filep->f_inode;
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      if (inode->u.i_mops->readv != NULL)
+        {
+          return inode->u.i_mops->readv(filep, iov, iovcnt);
+        }
+    }
+  else
+#endif
+  if (inode->u.i_ops->readv != NULL)
+    {
+      return inode->u.i_ops->readv(filep, iov, iovcnt);
+    }
+
+  /* No vectored method.. read each element in turn */
+
+  return readv_emulate(filep, iov, iovcnt);
+}
+#endif
+
+/****************************************************************************
+ * Name: nx_readv
+ *
+ * Description:
+ *   Equivalent to the standard readv() function except that it does not
+ *   modify the errno variable and is not a cancellation point.
+ *
+ * Returned Value:
+ *   The number of bytes read on success or a negated errno value on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+#endif
+  ssize_t ntotal;
+  ssize_t nread;
+  int i;
+
+  if (iov == NULL || iovcnt < 0)
+    {
+      return -EINVAL;
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      ntotal = (ssize_t)fs_getfilep(fd, &filep);
+      if (ntotal >= 0)
+        {
+          ntotal = file_readv(filep, iov, iovcnt);
+        }
+
+      return ntotal;
+    }
+#endif
+
+  /* A socket descriptor (or an invalid descriptor).  Receive into each
+   * element in turn, stopping after a short read.
+   */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = nx_read(fd, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          return ntotal > 0 ? ntotal : nread;
+        }
+
+      ntotal += nread;
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The readv() function is equivalent to read(), except that it places the
+ *   input data into the iovcnt buffers specified by the members of the iov
+ *   array: iov[0], iov[1], ..., iov[iovcnt-1].  See include/sys/uio.h.
+ *
+ * Returned Value:
+ *   Upon successful completion, readv() will return a non-negative integer
+ *   indicating the number of bytes actually read.  Otherwise, the functions
+ *   will return -1 and set errno to indicate the error.  See read().
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fildes, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nx_readv(fildes, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_FS_VECTORED_IO */
@@ -60,6 +60,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_FS_SELECT_NSTACKFDS
+#  define CONFIG_FS_SELECT_NSTACKFDS 0
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -103,6 +107,9 @@
 int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
            FAR fd_set *exceptfds, FAR struct timeval *timeout)
 {
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  struct pollfd stackset[CONFIG_FS_SELECT_NSTACKFDS];
+#endif
   struct pollfd *pollset;
   int errcode = OK;
   int fd;
@@ -139,13 +146,25 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
       goto errout;
     }
 
-  /* Allocate the descriptor list for poll() */
+  /* Allocate the descriptor list for poll().  Small sets, which are the
+   * common case, use a list on the stack.
+   */
 
-  pollset = (struct pollfd *)kmm_zalloc(npfds * sizeof(struct pollfd));
-  if (!pollset)
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (npfds <= CONFIG_FS_SELECT_NSTACKFDS)
     {
-      errcode = ENOMEM;
-      goto errout;
+      pollset = stackset;
+      memset(pollset, 0, npfds * sizeof(struct pollfd));
+    }
+  else
+#endif
+    {
+      pollset = (struct pollfd *)kmm_zalloc(npfds * sizeof(struct pollfd));
+      if (!pollset)
+        {
+          errcode = ENOMEM;
+          goto errout;
+        }
     }
 
   /* Initialize the descriptor list for poll() */
@@ -280,7 +299,12 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  kmm_free(pollset);
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (pollset != stackset)
+#endif
+    {
+      kmm_free(pollset);
+    }
 
   /* Did poll() fail above? */
 
@@ -0,0 +1,300 @@
+/****************************************************************************
+ * fs/vfs/fs_writev.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_VECTORED_IO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: writev_emulate
+ *
+ * Description:
+ *   Write each element of the iovec in turn.  Each element is written
+ *   completely before proceeding to the next.
+ *
+ ****************************************************************************/
+
+static ssize_t writev_emulate(FAR struct file *filep, int fd,
+                              FAR const struct iovec *iov, int iovcnt)
+{
+  FAR const uint8_t *buffer;
+  size_t remaining;
+  ssize_t ntotal = 0;
+  ssize_t nwritten;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      buffer    = (FAR const uint8_t *)iov[i].iov_base;
+      remaining = iov[i].iov_len;
+
+      while (remaining > 0)
+        {
+#if CONFIG_NFILE_DESCRIPTORS > 0
+          if (filep != NULL)
+            {
+              nwritten = file_write(filep, buffer, remaining);
+            }
+          else
+#endif
+            {
+              nwritten = nx_write(fd, buffer, remaining);
+            }
+
+          if (nwritten < 0)
+            {
+              return ntotal > 0 ? ntotal : nwritten;
+            }
+
+          buffer    += nwritten;
+          remaining -= nwritten;
+          ntotal    += nwritten;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: writev_socket
+ *
+ * Description:
+ *   Write to a socket.  Small requests, such as a header followed by a
+ *   payload, are gathered into one buffer and sent with a single call so
+ *   that they are sent as one operation (and, for TCP, as one segment)
+ *   rather than one per element.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+static ssize_t writev_socket(int fd, FAR const struct iovec *iov,
+                             int iovcnt)
+{
+  FAR uint8_t *buffer;
+  size_t total = 0;
+  size_t offset;
+  ssize_t ret;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      total += iov[i].iov_len;
+    }
+
+  if (iovcnt < 2 || total == 0 || total > CONFIG_FS_WRITEV_COALESCE)
+    {
+      return writev_emulate(NULL, fd, iov, iovcnt);
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(total);
+  if (buffer == NULL)
+    {
+      return writev_emulate(NULL, fd, iov, iovcnt);
+    }
+
+  for (i = 0, offset = 0; i < iovcnt; i++)
+    {
+      memcpy(&buffer[offset], iov[i].iov_base, iov[i].iov_len);
+      offset += iov[i].iov_len;
+    }
+
+  ret = nx_send(fd, buffer, total, 0);
+  kmm_free(buffer);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that is accepts a
+ *   struct file instance instead of a file descriptor, does not modify the
+ *   errno variable, and is not a cancellation point.  The writev method of
+ *   the driver or file system is used if it provides one.
+ *
+ * Returned Value:
+ *   The number of bytes written on success or a negated errno value on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt)
+{
+  FAR struct inode *inode;
+
+  /* Was this file opened for write access? */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  inode = filep->f_inode;
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      if (inode->u.i_mops->writev != NULL)
+        {
+          return inode->u.i_mops->writev(filep, iov, iovcnt);
+        }
+    }
+  else
+#endif
+  if (inode->u.i_ops->writev != NULL)
+    {
+      return inode->u.i_ops->writev(filep, iov, iovcnt);
+    }
+
+  /* No vectored method.. write each element in turn */
+
+  return writev_emulate(filep, -1, iov, iovcnt);
+}
+#endif
+
+/****************************************************************************
+ * Name: nx_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that it does not
+ *   modify the errno variable and is not a cancellation point.
+ *
+ * Returned Value:
+ *   The number of bytes written on success or a negated errno value on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+  ssize_t ret;
+#endif
+
+  if (iov == NULL || iovcnt < 0)
+    {
+      return -EINVAL;
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      ret = (ssize_t)fs_getfilep(fd, &filep);
+      if (ret >= 0)
+        {
+          ret = file_writev(filep, iov, iovcnt);
+        }
+
+      return ret;
+    }
+#endif
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  return writev_socket(fd, iov, iovcnt);
+#else
+  return -EBADF;
+#endif
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *   The writev() function is equivalent to write(), except that it gathers
+ *   the output data from the iovcnt buffers specified by the members of the
+ *   iov array: iov[0], iov[1], ..., iov[iovcnt-1].  See include/sys/uio.h.
+ *
+ * Returned Value:
+ *   Upon successful completion, writev() shall return the number of bytes
+ *   actually written.  Otherwise, it shall return a value of -1 and errno
+ *   shall be set to indicate an error.
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fildes, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = nx_writev(fildes, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_FS_VECTORED_IO */
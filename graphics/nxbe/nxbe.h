@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/nx/nxbe.h>
@@ -61,6 +62,27 @@
 #define NX_CLIPORDER_BRLT    (3)   /* Bottom-right-left-top */
 #define NX_CLIPORDER_DEFAULT NX_CLIPORDER_TLRB
 
+/* nxbe_filltraplist() clips and rasterizes this many trapezoids at a time */
+
+#define NXBE_TRAPLIST_NTRAPS 16
+
+/* Hardware acceleration is only available with framebuffer drivers */
+
+#if defined(CONFIG_FB_HWACCEL) && !defined(CONFIG_NX_LCDDRIVER)
+#  define NXBE_HWACCEL 1
+#endif
+
+/* With CONFIG_NX_DAMAGE, redraw requests are accumulated by nxbe_damage()
+ * and sent to the clients later by nxbe_flush().  Otherwise, they are sent
+ * immediately.  nxfe_redrawreq() is provided by the front-end (nxfe.h).
+ */
+
+#ifdef CONFIG_NX_DAMAGE
+#  define nxbe_redrawreq(w,r) nxbe_damage(w,r)
+#else
+#  define nxbe_redrawreq(w,r) nxfe_redrawreq(w,r)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -88,6 +110,10 @@ struct nxbe_plane_s
                              FAR const struct nxgl_trapezoid_s *trap,
                              FAR const struct nxgl_rect_s *bounds,
                              nxgl_mxpixel_t color);
+  CODE void (*filltraplist)(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_trapezoid_s *traps,
+                            int ntraps, FAR const struct nxgl_rect_s *bounds,
+                            nxgl_mxpixel_t color);
   CODE void (*moverectangle)(FAR NX_PLANEINFOTYPE *pinfo,
                             FAR const struct nxgl_rect_s *rect,
                              FAR struct nxgl_point_s *offset);
@@ -97,6 +123,29 @@ struct nxbe_plane_s
                              FAR const struct nxgl_point_s *origin,
                              unsigned int srcstride);
 
+#ifdef NXBE_HWACCEL
+  /* Software rasterizers used when the framebuffer driver declines an
+   * accelerated operation.
+   */
+
+  CODE void (*swfillrectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                               FAR const struct nxgl_rect_s *rect,
+                               nxgl_mxpixel_t color);
+  CODE void (*swmoverectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                               FAR const struct nxgl_rect_s *rect,
+                               FAR struct nxgl_point_s *offset);
+  CODE void (*swcopyrectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                               FAR const struct nxgl_rect_s *dest,
+                               FAR const void *src,
+                               FAR const struct nxgl_point_s *origin,
+                               unsigned int srcstride);
+
+  /* The framebuffer driver and the plane number that it knows it by */
+
+  FAR NX_DRIVERTYPE *dev;
+  int planeno;
+#endif
+
   /* Framebuffer plane info describing destination video plane */
 
   NX_PLANEINFOTYPE pinfo;
@@ -148,6 +197,13 @@ struct nxbe_state_s
   /* Rasterizing functions selected to match the BPP reported in pinfo[] */
 
   struct nxbe_plane_s plane[CONFIG_NX_NPLANES];
+
+#ifdef CONFIG_NX_DAMAGE
+  /* Damage accumulation state */
+
+  bool damaged;                     /* True: Some window has damage[] */
+  systime_t damagetime;             /* Time when the oldest damage was added */
+#endif
 };
 
 /****************************************************************************
@@ -312,6 +368,30 @@ void nxbe_filltrapezoid(FAR struct nxbe_window_s *wnd,
                         FAR const struct nxgl_trapezoid_s *trap,
                         nxgl_mxpixel_t color[CONFIG_NX_NPLANES]);
 
+/****************************************************************************
+ * Name: nxbe_filltraplist
+ *
+ * Description:
+ *  Fill a list of trapezoidal regions in the window with the specified
+ *  color
+ *
+ * Input Parameters:
+ *   wnd    - The window structure reference
+ *   clip   - Clipping region (may be null)
+ *   traps  - The list of trapezoids to be filled
+ *   ntraps - The number of trapezoids in the list
+ *   color  - The color to use in the fill
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_filltraplist(FAR struct nxbe_window_s *wnd,
+                       FAR const struct nxgl_rect_s *clip,
+                       FAR const struct nxgl_trapezoid_s *traps, int ntraps,
+                       nxgl_mxpixel_t color[CONFIG_NX_NPLANES]);
+
 /****************************************************************************
  * Name: nxbe_getrectangle
  *
@@ -414,6 +494,34 @@ void nxbe_redrawbelow(FAR struct nxbe_state_s *be,
                       FAR struct nxbe_window_s *wnd,
                       FAR const struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Add a rectangular region (in absolute screen coordinates) to the
+ *   accumulated redraw requests for the window.  Overlapping and adjacent
+ *   regions are merged.  The requests are sent to the client by
+ *   nxbe_flush().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_DAMAGE
+void nxbe_damage(FAR struct nxbe_window_s *wnd,
+                 FAR const struct nxgl_rect_s *rect);
+
+/****************************************************************************
+ * Name: nxbe_flush
+ *
+ * Description:
+ *   Send all accumulated redraw requests to the window clients.  If 'force'
+ *   is false, the requests are only sent if the oldest one has been pending
+ *   for at least CONFIG_NX_DAMAGE_MAXDELAY milliseconds.
+ *
+ ****************************************************************************/
+
+void nxbe_flush(FAR struct nxbe_state_s *be, bool force);
+#endif
+
 /****************************************************************************
  * Name: nxbe_visible
  *
@@ -453,6 +561,30 @@ void nxbe_clipper(FAR struct nxbe_window_s *wnd,
                   FAR struct nxbe_clipops_s *cops,
                   FAR struct nxbe_plane_s *plane);
 
+/****************************************************************************
+ * Name: nxbe_hwaccel
+ *
+ * Description:
+ *   Replace the fill, move and copy rasterizers of a color plane with
+ *   wrappers that use the hardware acceleration methods of the framebuffer
+ *   driver, if it provides any.  The rasterizers selected by
+ *   nxbe_configure() are retained as the software fallback.
+ *
+ * Input Parameters:
+ *   dev     - The framebuffer driver
+ *   plane   - The color plane to configure
+ *   planeno - The number of the plane
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef NXBE_HWACCEL
+void nxbe_hwaccel(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_plane_s *plane,
+                  int planeno);
+#endif
+
 /****************************************************************************
  * Name: nxbe_clipnull
  *
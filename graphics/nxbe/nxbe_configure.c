@@ -138,6 +138,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_1bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_1bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_1bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_1bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_1bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_1bpp;
         }
@@ -150,6 +151,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_2bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_2bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_2bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_2bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_2bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_2bpp;
         }
@@ -162,6 +164,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_4bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_4bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_4bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_4bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_4bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_4bpp;
         }
@@ -174,6 +177,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_8bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_8bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_8bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_8bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_8bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_8bpp;
         }
@@ -186,6 +190,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_16bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_16bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_16bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_16bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_16bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_16bpp;
         }
@@ -198,6 +203,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_24bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_24bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_24bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_24bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_24bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_24bpp;
         }
@@ -210,6 +216,7 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           be->plane[i].fillrectangle = nxgl_fillrectangle_32bpp;
           be->plane[i].getrectangle  = nxgl_getrectangle_32bpp;
           be->plane[i].filltrapezoid = nxgl_filltrapezoid_32bpp;
+          be->plane[i].filltraplist  = nxgl_filltraplist_32bpp;
           be->plane[i].moverectangle = nxgl_moverectangle_32bpp;
           be->plane[i].copyrectangle = nxgl_copyrectangle_32bpp;
         }
@@ -219,6 +226,12 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           gerr("ERROR: Unsupported pinfo[%d] BPP: %d\n", i, be->plane[i].pinfo.bpp);
           return -ENOSYS;
         }
+
+#ifdef NXBE_HWACCEL
+      /* Use the 2D graphics engine of the driver, if it has one */
+
+      nxbe_hwaccel(dev, &be->plane[i], i);
+#endif
     }
   return OK;
 }
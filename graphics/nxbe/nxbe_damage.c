@@ -0,0 +1,241 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_damage.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+#include "nxfe.h"
+
+#ifdef CONFIG_NX_DAMAGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DAMAGE_MAXDELAY MSEC2TICK(CONFIG_NX_DAMAGE_MAXDELAY)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_rectarea
+ ****************************************************************************/
+
+static inline uint32_t nxbe_rectarea(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: nxbe_touching
+ *
+ * Description:
+ *   Return true if the two rectangles overlap or share an edge so that
+ *   their union covers no pixels that are not in either rectangle along
+ *   that edge.
+ *
+ ****************************************************************************/
+
+static bool nxbe_touching(FAR const struct nxgl_rect_s *rect1,
+                          FAR const struct nxgl_rect_s *rect2)
+{
+  return rect1->pt1.x <= rect2->pt2.x + 1 && rect2->pt1.x <= rect1->pt2.x + 1 &&
+         rect1->pt1.y <= rect2->pt2.y + 1 && rect2->pt1.y <= rect1->pt2.y + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Add a rectangular region (in absolute screen coordinates) to the
+ *   accumulated redraw requests for the window.  Overlapping and adjacent
+ *   regions are merged.  The requests are sent to the client by
+ *   nxbe_flush().
+ *
+ ****************************************************************************/
+
+void nxbe_damage(FAR struct nxbe_window_s *wnd,
+                 FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct nxbe_state_s *be = wnd->be;
+  struct nxgl_rect_s damage;
+  struct nxgl_rect_s merged;
+  uint32_t growth;
+  uint32_t best;
+  int bestndx;
+  int i;
+
+  /* Save the region in window-relative coordinates so that it remains
+   * meaningful to the client if the window is moved before the flush.
+   */
+
+  nxgl_rectoffset(&damage, rect, -wnd->bounds.pt1.x, -wnd->bounds.pt1.y);
+  if (nxgl_nullrect(&damage))
+    {
+      return;
+    }
+
+  /* Merge with every pending region that it touches.  Each merge may make
+   * the region touch others that were checked already, so start over after
+   * each one.
+   */
+
+  i = 0;
+  while (i < wnd->ndamage)
+    {
+      FAR struct nxgl_rect_s *pending = &wnd->damage[i];
+
+      if (nxgl_rectinside(pending, &damage.pt1) &&
+          nxgl_rectinside(pending, &damage.pt2))
+        {
+          /* The region is already pending */
+
+          return;
+        }
+
+      if (nxbe_touching(pending, &damage))
+        {
+          /* Absorb this entry and remove it from the list */
+
+          nxgl_rectunion(&damage, &damage, pending);
+          wnd->ndamage--;
+          nxgl_rectcopy(pending, &wnd->damage[wnd->ndamage]);
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (wnd->ndamage < CONFIG_NX_DAMAGE_NRECTS)
+    {
+      nxgl_rectcopy(&wnd->damage[wnd->ndamage], &damage);
+      wnd->ndamage++;
+    }
+  else
+    {
+      /* The list is full.  Merge with the entry that grows the least. */
+
+      best    = UINT32_MAX;
+      bestndx = 0;
+
+      for (i = 0; i < wnd->ndamage; i++)
+        {
+          nxgl_rectunion(&merged, &damage, &wnd->damage[i]);
+          growth = nxbe_rectarea(&merged) - nxbe_rectarea(&wnd->damage[i]);
+          if (growth < best)
+            {
+              best    = growth;
+              bestndx = i;
+            }
+        }
+
+      nxgl_rectunion(&wnd->damage[bestndx], &damage, &wnd->damage[bestndx]);
+    }
+
+  /* Remember when the oldest pending damage was added */
+
+  if (!be->damaged)
+    {
+      be->damaged    = true;
+      be->damagetime = clock_systimer();
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_flush
+ *
+ * Description:
+ *   Send all accumulated redraw requests to the window clients.  If 'force'
+ *   is false, the requests are only sent if the oldest one has been pending
+ *   for at least CONFIG_NX_DAMAGE_MAXDELAY milliseconds.
+ *
+ ****************************************************************************/
+
+void nxbe_flush(FAR struct nxbe_state_s *be, bool force)
+{
+  FAR struct nxbe_window_s *wnd;
+  struct nxgl_rect_s rect;
+  int i;
+
+  if (!be->damaged ||
+      (!force && clock_systimer() - be->damagetime < DAMAGE_MAXDELAY))
+    {
+      return;
+    }
+
+  be->damaged = false;
+
+  for (wnd = be->topwnd; wnd != NULL; wnd = wnd->below)
+    {
+      for (i = 0; i < wnd->ndamage; i++)
+        {
+          /* nxfe_redrawreq() expects absolute screen coordinates.  The
+           * window may have been resized since the damage was added.
+           */
+
+          nxgl_rectoffset(&rect, &wnd->damage[i],
+                          wnd->bounds.pt1.x, wnd->bounds.pt1.y);
+          nxgl_rectintersect(&rect, &rect, &wnd->bounds);
+          if (!nxgl_nullrect(&rect))
+            {
+              nxfe_redrawreq(wnd, &rect);
+            }
+        }
+
+      wnd->ndamage = 0;
+    }
+}
+
+#endif /* CONFIG_NX_DAMAGE */
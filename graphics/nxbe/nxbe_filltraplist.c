@@ -0,0 +1,222 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_filltraplist.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fixedmath.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nxbe_filltraplist_s
+{
+  struct nxbe_clipops_s cops;
+  FAR const struct nxgl_trapezoid_s *traps;
+  int ntraps;
+  nxgl_mxpixel_t color;
+#ifdef CONFIG_NX_UPDATE
+  FAR const struct nxgl_rect_s *bounds;
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_clipfilltraplist
+ *
+ * Description:
+ *  Called from nxbe_clipper() to performed the fill operation on visible
+ *  portions of the trapezoid list.
+ *
+ ****************************************************************************/
+
+static void nxbe_clipfilltraplist(FAR struct nxbe_clipops_s *cops,
+                                  FAR struct nxbe_plane_s *plane,
+                                  FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct nxbe_filltraplist_s *fillinfo =
+    (FAR struct nxbe_filltraplist_s *)cops;
+#ifdef CONFIG_NX_UPDATE
+  struct nxgl_rect_s update;
+#endif
+
+  /* Draw all of the trapezoids in one pass */
+
+  plane->filltraplist(&plane->pinfo, fillinfo->traps, fillinfo->ntraps,
+                      rect, fillinfo->color);
+
+#ifdef CONFIG_NX_UPDATE
+  /* Notify external logic that the display has been updated */
+
+  nxgl_rectintersect(&update, fillinfo->bounds, rect);
+  nx_notify_rectangle(&plane->pinfo, &update);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_filltraplist
+ *
+ * Description:
+ *  Fill a list of trapezoidal regions in the window with the specified
+ *  color.  The visible regions of the window are found once for the whole
+ *  list, rather than once for each trapezoid.
+ *
+ * Input Parameters:
+ *   wnd    - The window structure reference
+ *   clip   - Clipping region (in relative window coordinates)
+ *   traps  - The list of trapezoids (in relative window coordinates)
+ *   ntraps - The number of trapezoids in the list
+ *   color  - The color to use in the fill
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_filltraplist(FAR struct nxbe_window_s *wnd,
+                       FAR const struct nxgl_rect_s *clip,
+                       FAR const struct nxgl_trapezoid_s *traps, int ntraps,
+                       nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
+{
+  struct nxgl_trapezoid_s offset[NXBE_TRAPLIST_NTRAPS];
+  struct nxbe_filltraplist_s info;
+  struct nxgl_rect_s remaining;
+  struct nxgl_rect_s cliprect;
+  int ntaken;
+  int i;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!wnd || !traps)
+    {
+      return;
+    }
+#endif
+
+  /* Get the clipping window in absolute coordinates */
+
+  if (clip)
+    {
+      nxgl_rectoffset(&cliprect, clip, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
+      nxgl_rectintersect(&cliprect, &cliprect, &wnd->bounds);
+    }
+  else
+    {
+      nxgl_rectcopy(&cliprect, &wnd->bounds);
+    }
+
+  nxgl_rectintersect(&cliprect, &cliprect, &wnd->be->bkgd.bounds);
+
+  info.cops.visible  = nxbe_clipfilltraplist;
+  info.cops.obscured = nxbe_clipnull;
+  info.traps         = offset;
+#ifdef CONFIG_NX_UPDATE
+  info.bounds        = &remaining;
+#endif
+
+  /* Process the list NXBE_TRAPLIST_NTRAPS trapezoids at a time */
+
+  while (ntraps > 0 && !nxgl_nullrect(&cliprect))
+    {
+      ntaken = ngl_min(ntraps, NXBE_TRAPLIST_NTRAPS);
+
+      /* Offset each trapezoid by the window origin to position it within
+       * the framebuffer region and create a bounding box that contains
+       * all of them.
+       */
+
+      nxgl_trapoffset(&offset[0], &traps[0], wnd->bounds.pt1.x,
+                      wnd->bounds.pt1.y);
+
+      remaining.pt1.x = b16toi(ngl_min(offset[0].top.x1, offset[0].bot.x1));
+      remaining.pt1.y = offset[0].top.y;
+      remaining.pt2.x = b16toi(ngl_max(offset[0].top.x2, offset[0].bot.x2));
+      remaining.pt2.y = offset[0].bot.y;
+
+      for (i = 1; i < ntaken; i++)
+        {
+          nxgl_trapoffset(&offset[i], &traps[i], wnd->bounds.pt1.x,
+                          wnd->bounds.pt1.y);
+
+          remaining.pt1.x = ngl_min(remaining.pt1.x,
+                                    b16toi(ngl_min(offset[i].top.x1,
+                                                   offset[i].bot.x1)));
+          remaining.pt1.y = ngl_min(remaining.pt1.y, offset[i].top.y);
+          remaining.pt2.x = ngl_max(remaining.pt2.x,
+                                    b16toi(ngl_max(offset[i].top.x2,
+                                                   offset[i].bot.x2)));
+          remaining.pt2.y = ngl_max(remaining.pt2.y, offset[i].bot.y);
+        }
+
+      info.ntraps = ntaken;
+      traps      += ntaken;
+      ntraps     -= ntaken;
+
+      /* Clip to the user clipping window, the window and the background */
+
+      nxgl_rectintersect(&remaining, &remaining, &cliprect);
+      if (nxgl_nullrect(&remaining))
+        {
+          continue;
+        }
+
+      /* Then process each color plane */
+
+#if CONFIG_NX_NPLANES > 1
+      for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+      i = 0;
+#endif
+        {
+          info.color = color[i];
+          nxbe_clipper(wnd->above, &remaining, NX_CLIPORDER_DEFAULT,
+                       &info.cops, &wnd->be->plane[i]);
+        }
+    }
+}
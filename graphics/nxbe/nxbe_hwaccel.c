@@ -0,0 +1,206 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_hwaccel.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/video/fb.h>
+
+#include "nxbe.h"
+
+#ifdef NXBE_HWACCEL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_plane
+ *
+ * Description:
+ *   The rasterizers receive only the plane info; recover the containing
+ *   plane structure from it.
+ *
+ ****************************************************************************/
+
+static inline FAR struct nxbe_plane_s *nxbe_plane(FAR NX_PLANEINFOTYPE *pinfo)
+{
+  return (FAR struct nxbe_plane_s *)
+    ((uintptr_t)pinfo - offsetof(struct nxbe_plane_s, pinfo));
+}
+
+/****************************************************************************
+ * Name: nxbe_rect2area
+ ****************************************************************************/
+
+static inline void nxbe_rect2area(FAR const struct nxgl_rect_s *rect,
+                                  FAR struct fb_area_s *area)
+{
+  area->x = rect->pt1.x;
+  area->y = rect->pt1.y;
+  area->w = rect->pt2.x - rect->pt1.x + 1;
+  area->h = rect->pt2.y - rect->pt1.y + 1;
+}
+
+/****************************************************************************
+ * Name: nxbe_hwfillrectangle
+ ****************************************************************************/
+
+static void nxbe_hwfillrectangle(FAR NX_PLANEINFOTYPE *pinfo,
+                                 FAR const struct nxgl_rect_s *rect,
+                                 nxgl_mxpixel_t color)
+{
+  FAR struct nxbe_plane_s *plane = nxbe_plane(pinfo);
+  struct fb_area_s area;
+
+  nxbe_rect2area(rect, &area);
+  if (plane->dev->fillrect(plane->dev, plane->planeno, &area,
+                           (uint32_t)color) < 0)
+    {
+      plane->swfillrectangle(pinfo, rect, color);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_hwmoverectangle
+ ****************************************************************************/
+
+static void nxbe_hwmoverectangle(FAR NX_PLANEINFOTYPE *pinfo,
+                                 FAR const struct nxgl_rect_s *rect,
+                                 FAR struct nxgl_point_s *offset)
+{
+  FAR struct nxbe_plane_s *plane = nxbe_plane(pinfo);
+  struct fb_area_s area;
+
+  nxbe_rect2area(rect, &area);
+  if (plane->dev->moverect(plane->dev, plane->planeno, &area,
+                           offset->x, offset->y) < 0)
+    {
+      plane->swmoverectangle(pinfo, rect, offset);
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_hwcopyrectangle
+ ****************************************************************************/
+
+static void nxbe_hwcopyrectangle(FAR NX_PLANEINFOTYPE *pinfo,
+                                 FAR const struct nxgl_rect_s *dest,
+                                 FAR const void *src,
+                                 FAR const struct nxgl_point_s *origin,
+                                 unsigned int srcstride)
+{
+  FAR struct nxbe_plane_s *plane = nxbe_plane(pinfo);
+  FAR const uint8_t *sline;
+  struct fb_area_s area;
+
+  /* Get the address of the source pixel that goes to the upper left corner
+   * of the destination.  Only planes of 8 or more bits per pixel are
+   * accelerated so this is always byte aligned.
+   */
+
+  sline = (FAR const uint8_t *)src +
+          (((dest->pt1.x - origin->x) * pinfo->bpp) >> 3) +
+          (dest->pt1.y - origin->y) * srcstride;
+
+  nxbe_rect2area(dest, &area);
+  if (plane->dev->copyrect(plane->dev, plane->planeno, &area, sline,
+                           srcstride) < 0)
+    {
+      plane->swcopyrectangle(pinfo, dest, src, origin, srcstride);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_hwaccel
+ *
+ * Description:
+ *   Replace the fill, move and copy rasterizers of a color plane with
+ *   wrappers that use the hardware acceleration methods of the framebuffer
+ *   driver, if it provides any.  The rasterizers selected by
+ *   nxbe_configure() are retained as the software fallback.
+ *
+ ****************************************************************************/
+
+void nxbe_hwaccel(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_plane_s *plane,
+                  int planeno)
+{
+  plane->swfillrectangle = plane->fillrectangle;
+  plane->swmoverectangle = plane->moverectangle;
+  plane->swcopyrectangle = plane->copyrectangle;
+  plane->dev             = dev;
+  plane->planeno         = planeno;
+
+  /* Sub-byte pixel formats are left to the software rasterizers */
+
+  if (plane->pinfo.bpp < 8)
+    {
+      return;
+    }
+
+  if (dev->fillrect != NULL)
+    {
+      plane->fillrectangle = nxbe_hwfillrectangle;
+    }
+
+  if (dev->moverect != NULL)
+    {
+      plane->moverectangle = nxbe_hwmoverectangle;
+    }
+
+  if (dev->copyrect != NULL)
+    {
+      plane->copyrectangle = nxbe_hwcopyrectangle;
+    }
+
+  ginfo("Plane %d: fill %s move %s copy %s\n", planeno,
+        dev->fillrect != NULL ? "HW" : "SW",
+        dev->moverect != NULL ? "HW" : "SW",
+        dev->copyrect != NULL ? "HW" : "SW");
+}
+
+#endif /* NXBE_HWACCEL */
@@ -96,5 +96,5 @@ void nxbe_raise(FAR struct nxbe_window_s *wnd)
    * it is not obscured by another window
    */
 
-  nxfe_redrawreq(wnd, &wnd->bounds);
+  nxbe_redrawreq(wnd, &wnd->bounds);
 }
@@ -0,0 +1,267 @@
+/****************************************************************************
+ * graphics/nxglib/fb/nxglib_filltraplist.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <fixedmath.h>
+
+#include <nuttx/video/fb.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxglib_bitblit.h"
+#include "nxglib_traplist.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Make sure that this file is used in the proper context */
+
+#ifndef NXGLIB_SUFFIX
+#  error "NXGLIB_SUFFIX must be defined before including this header file"
+#endif
+
+/* The mask that selects pixel 'x' within its byte */
+
+#if NXGLIB_BITSPERPIXEL < 8
+#  define NXGL_ONEPIXEL ((1 << NXGLIB_BITSPERPIXEL) - 1)
+#  ifdef CONFIG_NX_PACKEDMSFIRST
+#    define NXGL_PIXELMASKX(x) \
+       ((uint8_t)(NXGL_ONEPIXEL << \
+        (8 - NXGLIB_BITSPERPIXEL * (NXGL_REMAINDERX(x) + 1))))
+#  else
+#    define NXGL_PIXELMASKX(x) \
+       ((uint8_t)(NXGL_ONEPIXEL << (NXGLIB_BITSPERPIXEL * NXGL_REMAINDERX(x))))
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_fillspan
+ *
+ * Description:
+ *   Fill one span of a row, clipped horizontally to 'bounds'.  If
+ *   anti-aliasing is enabled, the end pixels of an unclipped span are
+ *   blended according to how much of the pixel the span covers.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_fillspan(FAR uint8_t *line,
+                                 FAR const struct nxgl_span_s *span,
+                                 FAR const struct nxgl_rect_s *bounds,
+                                 NXGL_PIXEL_T color)
+{
+  FAR uint8_t *dest;
+  int ix1;
+  int ix2;
+#if NXGLIB_BITSPERPIXEL < 8
+  uint8_t mpixel = NXGL_MULTIPIXEL(color);
+  uint8_t mask;
+#else
+  int width;
+#endif
+
+  /* Convert the positions to integer.  Handle some corner cases where we
+   * draw nothing.  Otherwise, we will always draw at least one pixel.
+   */
+
+  ix1 = b16toi(span->x1);
+  ix2 = b16toi(span->x2);
+
+  if (ix2 < bounds->pt1.x || ix1 > bounds->pt2.x)
+    {
+      return;
+    }
+
+#if NXGLIB_BITSPERPIXEL < 8
+  ix1 = ngl_clipl(ix1, bounds->pt1.x);
+  ix2 = ngl_clipr(ix2, bounds->pt2.x);
+
+  /* Set the pixels in the fractional initial byte one at a time */
+
+  dest = line + NXGL_SCALEX(ix1);
+  mask = 0;
+
+  while (ix1 <= ix2 &&
+         (NXGL_REMAINDERX(ix1) != 0 || ix2 - ix1 < NXGL_PIXELMASK))
+    {
+      mask |= NXGL_PIXELMASKX(ix1);
+      ix1++;
+
+      if (NXGL_REMAINDERX(ix1) == 0 || ix1 > ix2)
+        {
+          *dest = (*dest & ~mask) | (mpixel & mask);
+          mask  = 0;
+          dest++;
+        }
+    }
+
+  /* Fill all of the whole bytes */
+
+  if (ix1 <= ix2)
+    {
+      int nbytes = NXGL_SCALEX(ix2 - ix1 + 1);
+
+      memset(dest, mpixel, nbytes);
+      dest += nbytes;
+      ix1  += nbytes << NXGL_PIXELSHIFT;
+    }
+
+  /* Then the fractional final byte */
+
+  for (mask = 0; ix1 <= ix2; ix1++)
+    {
+      mask |= NXGL_PIXELMASKX(ix1);
+    }
+
+  if (mask != 0)
+    {
+      *dest = (*dest & ~mask) | (mpixel & mask);
+    }
+
+#else /* NXGLIB_BITSPERPIXEL < 8 */
+
+#ifdef CONFIG_NX_ANTIALIASING
+  /* Blend the end pixels of the span according to their coverage, unless
+   * they have been clipped away.
+   */
+
+  if (ix1 < ix2)
+    {
+      if (ix1 >= bounds->pt1.x && b16frac(span->x1) != 0)
+        {
+          dest = line + NXGL_SCALEX(ix1);
+          NXGL_BLEND(dest, color, b16ONE - b16frac(span->x1));
+          ix1++;
+        }
+
+      if (ix2 <= bounds->pt2.x)
+        {
+          dest = line + NXGL_SCALEX(ix2);
+          NXGL_BLEND(dest, color, b16frac(span->x2));
+          ix2--;
+        }
+    }
+#endif
+
+  ix1   = ngl_clipl(ix1, bounds->pt1.x);
+  ix2   = ngl_clipr(ix2, bounds->pt2.x);
+  width = ix2 - ix1 + 1;
+
+  /* Then fill the fully covered pixels in between */
+
+  if (width > 0)
+    {
+      dest = line + NXGL_SCALEX(ix1);
+      NXGL_MEMSET(dest, (NXGL_PIXEL_T)color, width);
+    }
+
+#endif /* NXGLIB_BITSPERPIXEL < 8 */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxglib_filltraplist_*bpp
+ *
+ * Description:
+ *   Fill a list of trapezoidal regions in the framebuffer memory with a
+ *   fixed color, clipped to a bounding box.  The trapezoids are rasterized
+ *   together, one row at a time:  The edges of each trapezoid are stepped
+ *   incrementally and the spans of all trapezoids on a row are merged
+ *   before they are drawn.  Each pixel of a shape that was broken up into
+ *   trapezoids (such as a circle or a wide line) is then written only once.
+ *
+ ****************************************************************************/
+
+void NXGL_FUNCNAME(nxgl_filltraplist, NXGLIB_SUFFIX)(
+  FAR struct fb_planeinfo_s *pinfo,
+  FAR const struct nxgl_trapezoid_s *traps, int ntraps,
+  FAR const struct nxgl_rect_s *bounds,
+  NXGL_PIXEL_T color)
+{
+  struct nxgl_trapedge_s edges[NXGL_TRAPLIST_NEDGES];
+  struct nxgl_span_s spans[NXGL_TRAPLIST_NEDGES];
+  unsigned int stride;
+  FAR uint8_t *line;
+  nxgl_coord_t ymin;
+  nxgl_coord_t ymax;
+  nxgl_coord_t y;
+  int nedges;
+  int nspans;
+  int ntaken;
+  int i;
+
+  /* Get the width of the framebuffer in bytes */
+
+  stride = pinfo->stride;
+
+  /* Rasterize the trapezoids NXGL_TRAPLIST_NEDGES at a time */
+
+  while (ntraps > 0)
+    {
+      ntaken  = ngl_min(ntraps, NXGL_TRAPLIST_NEDGES);
+      nedges  = nxgl_trapedges(edges, traps, ntaken, bounds, &ymin, &ymax);
+      traps  += ntaken;
+      ntraps -= ntaken;
+
+      if (nedges == 0)
+        {
+          continue;
+        }
+
+      /* Then fill the trapezoids line-by-line */
+
+      line = pinfo->fbmem + ymin * stride;
+      for (y = ymin; y <= ymax; y++, line += stride)
+        {
+          nspans = nxgl_trapspans(edges, nedges, y, spans);
+          for (i = 0; i < nspans; i++)
+            {
+              nxgl_fillspan(line, &spans[i], bounds, color);
+            }
+        }
+    }
+}
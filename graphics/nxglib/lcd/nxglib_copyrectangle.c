@@ -88,7 +88,22 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   remainder = NXGL_REMAINDERX(xoffset);
 #endif
 
-  /* Copy the image, one row at a time */
+  /* If the LCD can write a whole area and the image is byte aligned, then
+   * copy the whole image in one transfer.
+   */
+
+#if NXGLIB_BITSPERPIXEL < 8
+  if (pinfo->putarea != NULL && remainder == 0)
+#else
+  if (pinfo->putarea != NULL)
+#endif
+    {
+      (void)pinfo->putarea(dest->pt1.y, dest->pt2.y, dest->pt1.x,
+                           dest->pt2.x, sline, srcstride);
+      return;
+    }
+
+  /* Otherwise, copy the image one row at a time */
 
   for (row = dest->pt1.y; row <= dest->pt2.y; row++)
     {
@@ -0,0 +1,134 @@
+/****************************************************************************
+ * graphics/nxglib/lcd/nxglib_filltraplist.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <fixedmath.h>
+
+#include <nuttx/lcd/lcd.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxglib_bitblit.h"
+#include "nxglib_fillrun.h"
+#include "nxglib_traplist.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef NXGLIB_SUFFIX
+#  error "NXGLIB_SUFFIX must be defined before including this header file"
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxglib_filltraplist_*bpp
+ *
+ * Description:
+ *   Fill a list of trapezoidal regions in the LCD memory with a fixed color,
+ *   clipped to a bounding box.  The trapezoids are rasterized together, one
+ *   row at a time, and the spans of all trapezoids on a row are merged so
+ *   that each span is written with a single putrun().
+ *
+ ****************************************************************************/
+
+void NXGL_FUNCNAME(nxgl_filltraplist, NXGLIB_SUFFIX)
+  (FAR struct lcd_planeinfo_s *pinfo,
+   FAR const struct nxgl_trapezoid_s *traps, int ntraps,
+   FAR const struct nxgl_rect_s *bounds,
+   NXGL_PIXEL_T color)
+{
+  struct nxgl_trapedge_s edges[NXGL_TRAPLIST_NEDGES];
+  struct nxgl_span_s spans[NXGL_TRAPLIST_NEDGES];
+  nxgl_coord_t ymin;
+  nxgl_coord_t ymax;
+  nxgl_coord_t y;
+  int nedges;
+  int nspans;
+  int ntaken;
+  int ix1;
+  int ix2;
+  int i;
+
+  /* Fill the run buffer for the widest run that we could need.  No span is
+   * wider than the bounding box.
+   */
+
+  NXGL_FUNCNAME(nxgl_fillrun, NXGLIB_SUFFIX)
+    ((NXGLIB_RUNTYPE *)pinfo->buffer, color,
+     bounds->pt2.x - bounds->pt1.x + 1);
+
+  /* Rasterize the trapezoids NXGL_TRAPLIST_NEDGES at a time */
+
+  while (ntraps > 0)
+    {
+      ntaken  = ngl_min(ntraps, NXGL_TRAPLIST_NEDGES);
+      nedges  = nxgl_trapedges(edges, traps, ntaken, bounds, &ymin, &ymax);
+      traps  += ntaken;
+      ntraps -= ntaken;
+
+      /* Then fill the trapezoids row-by-row */
+
+      for (y = ymin; nedges > 0 && y <= ymax; y++)
+        {
+          nspans = nxgl_trapspans(edges, nedges, y, spans);
+          for (i = 0; i < nspans; i++)
+            {
+              /* Convert the positions to integer and clip the span to fit
+               * within the bounding box.
+               */
+
+              ix1 = b16toi(spans[i].x1);
+              ix1 = ngl_clipl(ix1, bounds->pt1.x);
+              ix2 = b16toi(spans[i].x2);
+              ix2 = ngl_clipr(ix2, bounds->pt2.x);
+
+              if (ix1 <= ix2)
+                {
+                  (void)pinfo->putrun(y, ix1, pinfo->buffer, ix2 - ix1 + 1);
+                }
+            }
+        }
+    }
+}
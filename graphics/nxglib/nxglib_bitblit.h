@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -121,25 +122,10 @@
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
-     int        _nby = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+     memset((dest), (value), NXGL_SCALEX(width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     int        _nby  = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy((dest), (src), NXGL_SCALEX(width))
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
@@ -156,17 +142,7 @@
    }
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -185,29 +161,57 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+#else /* NXGLIB_BITSPERPIXEL == 8 || NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+
+#if NXGLIB_BITSPERPIXEL == 8
+
+#  define NXGL_MEMSET(dest,value,width) \
+     memset((dest), (value), (width))
+
+#elif NXGLIB_BITSPERPIXEL == 16
+
+/* Fill 16-bit pixels two at a time using aligned 32-bit stores */
 
 #  define NXGL_MEMSET(dest,value,width) \
    { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
+     FAR uint16_t *_ptr  = (FAR uint16_t*)(dest); \
+     FAR uint32_t *_wptr; \
+     uint32_t     _wide  = (uint32_t)(uint16_t)(value) * 0x00010001; \
+     nxgl_coord_t _npix  = (width); \
+     if (((uintptr_t)_ptr & 2) != 0 && _npix > 0) \
        { \
          *_ptr++ = (value); \
+         _npix--; \
+       } \
+     _wptr = (FAR uint32_t*)_ptr; \
+     while (_npix > 1) \
+       { \
+         *_wptr++ = _wide; \
+         _npix   -= 2; \
+       } \
+     if (_npix > 0) \
+       { \
+         *(FAR uint16_t*)_wptr = (value); \
        } \
    }
 
-#  define NXGL_MEMCPY(dest,src,width) \
+#else
+
+#  define NXGL_MEMSET(dest,value,width) \
    { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
+     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
+     nxgl_coord_t     _npix = (width); \
      while (_npix--) \
        { \
-         *_dptr++ = *_sptr++; \
+         *_ptr++ = (value); \
        } \
    }
 
+#endif
+
+#  define NXGL_MEMCPY(dest,src,width) \
+     memcpy((dest), (src), NXGL_SCALEX(width))
+
 #ifdef CONFIG_NX_ANTIALIASING
 
 #  define NXGL_BLEND(dest,color1,frac) \
@@ -220,6 +224,11 @@
 #endif /* CONFIG_NX_ANTIALIASING */
 #endif /* NXGLIB_BITSPERPIXEL */
 
+/* Copy between possibly overlapping regions of the same framebuffer */
+
+#define NXGL_MEMMOVE(dest,src,width) \
+   memmove((dest), (src), NXGL_SCALEX(width))
+
 /* Form a function name by concatenating two strings */
 
 #define _NXGL_FUNCNAME(a,b) a ## b
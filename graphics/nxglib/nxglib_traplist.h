@@ -0,0 +1,246 @@
+/****************************************************************************
+ * graphics/nxglib/nxglib_traplist.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __GRAPHICS_NXGLIB_NXGLIB_TRAPLIST_H
+#define __GRAPHICS_NXGLIB_NXGLIB_TRAPLIST_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <fixedmath.h>
+
+#include <nuttx/nx/nxglib.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of trapezoids that are rasterized together in one pass.  Longer
+ * lists are rasterized in several passes.
+ */
+
+#define NXGL_TRAPLIST_NEDGES 16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of the left and right edges of one trapezoid */
+
+struct nxgl_trapedge_s
+{
+  b16_t        x1;        /* Left X position on the current row */
+  b16_t        x2;        /* Right X position on the current row */
+  b16_t        dx1dy;     /* Change in x1 per row */
+  b16_t        dx2dy;     /* Change in x2 per row */
+  nxgl_coord_t y1;        /* First row, clipped */
+  nxgl_coord_t y2;        /* Last row, clipped */
+};
+
+/* One horizontal span on the current row */
+
+struct nxgl_span_s
+{
+  b16_t        x1;        /* Left X position */
+  b16_t        x2;        /* Right X position */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_trapedges
+ *
+ * Description:
+ *   Set up the edges of up to NXGL_TRAPLIST_NEDGES trapezoids, clipped
+ *   vertically to 'bounds'.  Trapezoids that lie entirely above or below
+ *   'bounds' are discarded.
+ *
+ * Returned Value:
+ *   The number of edges set up.  The range of rows covered by those edges
+ *   is returned in *ymin and *ymax.
+ *
+ ****************************************************************************/
+
+static inline int nxgl_trapedges(FAR struct nxgl_trapedge_s *edges,
+                                 FAR const struct nxgl_trapezoid_s *traps,
+                                 int ntraps,
+                                 FAR const struct nxgl_rect_s *bounds,
+                                 FAR nxgl_coord_t *ymin,
+                                 FAR nxgl_coord_t *ymax)
+{
+  FAR struct nxgl_trapedge_s *edge = edges;
+  int nrows;
+  int i;
+
+  *ymin = bounds->pt2.y;
+  *ymax = bounds->pt1.y;
+
+  for (i = 0; i < ntraps; i++, traps++)
+    {
+      if (traps->bot.y < bounds->pt1.y || traps->top.y > bounds->pt2.y ||
+          traps->bot.y < traps->top.y)
+        {
+          continue;
+        }
+
+      edge->x1 = traps->top.x1;
+      edge->x2 = traps->top.x2;
+      edge->y1 = traps->top.y;
+      edge->y2 = traps->bot.y;
+
+      nrows    = edge->y2 - edge->y1 + 1;
+      if (nrows > 1)
+        {
+          edge->dx1dy = b16divi((traps->bot.x1 - edge->x1), nrows - 1);
+          edge->dx2dy = b16divi((traps->bot.x2 - edge->x2), nrows - 1);
+        }
+      else
+        {
+          /* The trapezoid is a run! Use the average width. */
+
+          edge->x1    = (edge->x1 + traps->bot.x1) >> 1;
+          edge->x2    = (edge->x2 + traps->bot.x2) >> 1;
+          edge->dx1dy = 0;
+          edge->dx2dy = 0;
+        }
+
+      /* Advance the edges to the first visible row */
+
+      if (edge->y1 < bounds->pt1.y)
+        {
+          int dy    = bounds->pt1.y - edge->y1;
+          edge->x1 += dy * edge->dx1dy;
+          edge->x2 += dy * edge->dx2dy;
+          edge->y1  = bounds->pt1.y;
+        }
+
+      if (edge->y2 > bounds->pt2.y)
+        {
+          edge->y2 = bounds->pt2.y;
+        }
+
+      *ymin = ngl_min(*ymin, edge->y1);
+      *ymax = ngl_max(*ymax, edge->y2);
+      edge++;
+    }
+
+  return edge - edges;
+}
+
+/****************************************************************************
+ * Name: nxgl_trapspans
+ *
+ * Description:
+ *   Collect the spans of all edges that cover row 'y' and step those edges
+ *   to the next row.  Rows must be visited in order from the *ymin value
+ *   returned by nxgl_trapedges().
+ *
+ *   The spans are sorted by their left position and spans that overlap or
+ *   touch are merged.  Trapezoids that share a row (as the trapezoids of a
+ *   circle do) then produce only one span on that row, so each pixel is
+ *   written once.
+ *
+ * Returned Value:
+ *   The number of spans returned in 'spans'.
+ *
+ ****************************************************************************/
+
+static inline int nxgl_trapspans(FAR struct nxgl_trapedge_s *edges,
+                                 int nedges, nxgl_coord_t y,
+                                 FAR struct nxgl_span_s *spans)
+{
+  FAR struct nxgl_trapedge_s *edge;
+  b16_t tmp;
+  int nspans = 0;
+  int merged;
+  int i;
+  int j;
+
+  for (i = 0, edge = edges; i < nedges; i++, edge++)
+    {
+      if (y < edge->y1 || y > edge->y2)
+        {
+          continue;
+        }
+
+      /* Handle the special case where the sides cross (as in an hourglass) */
+
+      if (edge->x1 > edge->x2)
+        {
+          ngl_swap(edge->x1, edge->x2, tmp);
+          ngl_swap(edge->dx1dy, edge->dx2dy, tmp);
+        }
+
+      /* Insert the span, keeping the list sorted by the left position */
+
+      for (j = nspans; j > 0 && spans[j - 1].x1 > edge->x1; j--)
+        {
+          spans[j] = spans[j - 1];
+        }
+
+      spans[j].x1 = edge->x1;
+      spans[j].x2 = edge->x2;
+      nspans++;
+
+      /* Step the edge to the next row */
+
+      edge->x1 += edge->dx1dy;
+      edge->x2 += edge->dx2dy;
+    }
+
+  /* Merge spans that overlap or that touch at a pixel boundary */
+
+  for (i = 1, merged = 0; i < nspans; i++)
+    {
+      if (b16toi(spans[i].x1) <= b16toi(spans[merged].x2) + 1)
+        {
+          spans[merged].x2 = ngl_max(spans[merged].x2, spans[i].x2);
+        }
+      else
+        {
+          spans[++merged] = spans[i];
+        }
+    }
+
+  return nspans > 0 ? merged + 1 : 0;
+}
+
+#endif /* __GRAPHICS_NXGLIB_NXGLIB_TRAPLIST_H */
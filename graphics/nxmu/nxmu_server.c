@@ -82,6 +82,91 @@ static inline void nxmu_disconnect(FAR struct nxfe_conn_s *conn)
   (void)mq_close(conn->swrmq);
 }
 
+/****************************************************************************
+ * Name: nxmu_batch
+ *
+ * Description:
+ *   Perform each of the drawing requests in a client batch buffer, then
+ *   release the buffer back to the client.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+static void nxmu_batch(FAR struct nxsvrmsg_batch_s *batchmsg)
+{
+  FAR const uint8_t *entry = (FAR const uint8_t *)batchmsg->buffer;
+  FAR const uint8_t *end = entry + batchmsg->buflen;
+  FAR struct nxsvrmsg_s *msg;
+  uintptr_t entlen;
+
+  while (entry < end)
+    {
+      entlen = *(FAR const uintptr_t *)entry;
+      msg    = (FAR struct nxsvrmsg_s *)(entry + NXMU_BATCH_HDRSIZE);
+
+      switch (msg->msgid)
+        {
+          case NX_SVRMSG_SETPIXEL:
+            {
+              FAR struct nxsvrmsg_setpixel_s *setmsg = (FAR struct nxsvrmsg_setpixel_s *)msg;
+              nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_FILL:
+            {
+              FAR struct nxsvrmsg_fill_s *fillmsg = (FAR struct nxsvrmsg_fill_s *)msg;
+              nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_FILLTRAP:
+            {
+              FAR struct nxsvrmsg_filltrapezoid_s *trapmsg = (FAR struct nxsvrmsg_filltrapezoid_s *)msg;
+              nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip, &trapmsg->trap, trapmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_FILLTRAPLIST:
+            {
+              FAR struct nxsvrmsg_filltraplist_s *listmsg = (FAR struct nxsvrmsg_filltraplist_s *)msg;
+              nxbe_filltraplist(listmsg->wnd, &listmsg->clip, listmsg->traps, listmsg->ntraps, listmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_MOVE:
+            {
+              FAR struct nxsvrmsg_move_s *movemsg = (FAR struct nxsvrmsg_move_s *)msg;
+              nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
+            }
+            break;
+
+          case NX_SVRMSG_BITMAP:
+            {
+              FAR struct nxsvrmsg_bitmap_s *bmpmsg = (FAR struct nxsvrmsg_bitmap_s *)msg;
+              nxbe_bitmap(bmpmsg->wnd, &bmpmsg->dest, bmpmsg->src, &bmpmsg->origin, bmpmsg->stride);
+            }
+            break;
+
+          default:
+            gerr("ERROR: Unexpected batched command: %d\n", msg->msgid);
+            break;
+        }
+
+      if (entlen == 0)
+        {
+          break;
+        }
+
+      entry += entlen;
+    }
+
+  /* The client may now re-use the batch buffer */
+
+  nxsem_post(batchmsg->sem_done);
+}
+#endif
+
 /****************************************************************************
  * Name: nxmu_connect
  ****************************************************************************/
@@ -280,6 +365,9 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 {
   struct nxfe_state_s    fe;
   FAR struct nxsvrmsg_s *msg;
+#ifdef CONFIG_NX_DAMAGE
+  struct mq_attr         attr;
+#endif
   char                   buffer[NX_MXSVRMSGLEN];
   int                    nbytes;
   int                    ret;
@@ -306,6 +394,19 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
+#ifdef CONFIG_NX_DAMAGE
+       /* Send the accumulated redraw requests when there are no more
+        * messages to process, or when they have been held back too long.
+        */
+
+       if (fe.be.damaged)
+         {
+           bool idle = (mq_getattr(fe.conn.crdmq, &attr) < 0 ||
+                        attr.mq_curmsgs == 0);
+           nxbe_flush(&fe.be, idle);
+         }
+
+#endif
        /* Receive the next server message */
 
        nbytes = nxmq_receive(fe.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
@@ -446,6 +547,19 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
              nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip, &trapmsg->trap, trapmsg->color);
            }
            break;
+
+         case NX_SVRMSG_FILLTRAPLIST: /* Fill a list of trapezoidal regions with a color */
+           {
+             FAR struct nxsvrmsg_filltraplist_s *listmsg = (FAR struct nxsvrmsg_filltraplist_s *)buffer;
+             nxbe_filltraplist(listmsg->wnd, &listmsg->clip, listmsg->traps, listmsg->ntraps, listmsg->color);
+
+             if (listmsg->sem_done)
+              {
+                nxsem_post(listmsg->sem_done);
+              }
+           }
+           break;
+
          case NX_SVRMSG_MOVE: /* Move a rectangular region within the window */
            {
              FAR struct nxsvrmsg_move_s *movemsg = (FAR struct nxsvrmsg_move_s *)buffer;
@@ -506,6 +620,15 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
            }
            break;
 
+#ifdef CONFIG_NXMU_BATCH
+         case NX_SVRMSG_BATCH: /* A buffer of batched drawing requests */
+           {
+             FAR struct nxsvrmsg_batch_s *batchmsg = (FAR struct nxsvrmsg_batch_s *)buffer;
+             nxmu_batch(batchmsg);
+           }
+           break;
+
+#endif
          /* Messages sent to the background window **************************/
 
          case NX_CLIMSG_REDRAW: /* Re-draw the background window */
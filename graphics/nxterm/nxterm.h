@@ -46,6 +46,8 @@
 #include <semaphore.h>
 
 #include <nuttx/semaphore.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxtk.h>
@@ -55,6 +57,39 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_NXTERM_BATCHSIZE
+#  define CONFIG_NXTERM_BATCHSIZE 0
+#endif
+
+#ifndef CONFIG_NXTERM_REFRESH_INTERVAL
+#  define CONFIG_NXTERM_REFRESH_INTERVAL 0
+#endif
+
+/* Runs of characters can be batched into one bitmap only for byte-aligned
+ * pixel depths.
+ */
+
+#undef NXTERM_BATCH
+#if CONFIG_NXTERM_BATCHSIZE > 0 && \
+    (CONFIG_NXTERM_BPP == 8 || CONFIG_NXTERM_BPP == 16 || \
+     CONFIG_NXTERM_BPP == 32)
+#  define NXTERM_BATCH 1
+#endif
+
+/* Deferred refresh requires the work queue */
+
+#undef NXTERM_DEFERRED
+#if CONFIG_NXTERM_REFRESH_INTERVAL > 0 && defined(CONFIG_SCHED_WORKQUEUE)
+#  define NXTERM_DEFERRED 1
+#  ifdef CONFIG_SCHED_LPWORK
+#    define NXTERM_WORK LPWORK
+#  else
+#    define NXTERM_WORK HPWORK
+#  endif
+#endif
+
 /* NxTerm Definitions ****************************************************/
 /* Bitmap flags */
 
@@ -141,6 +176,17 @@ struct nxterm_state_s
 
   struct nxgl_point_s fpos;                 /* Next display position */
 
+  /* Deferred display update.  Characters are added to bm[] immediately but
+   * are only drawn, and the display only scrolled, by nxterm_flush().
+   */
+
+  uint16_t npending;                        /* Index of first undrawn char */
+  nxgl_coord_t scrollpend;                  /* Scroll not yet applied */
+#ifdef NXTERM_DEFERRED
+  systime_t lastflush;                      /* Time of the last flush */
+  struct work_s work;                       /* Deferred flush work */
+#endif
+
   /* VT100 escape sequence processing */
 
   char seq[VT100_MAX_SEQUENCE];             /* Buffered characters */
@@ -152,6 +198,12 @@ struct nxterm_state_s
   struct nxterm_bitmap_s cursor;
   struct nxterm_bitmap_s bm[CONFIG_NXTERM_MXCHARS];
 
+#ifdef NXTERM_BATCH
+  /* Composes a run of characters on one line into a single bitmap */
+
+  uint32_t runbuf[(CONFIG_NXTERM_BATCHSIZE + 3) >> 2];
+#endif
+
   /* Keyboard input support */
 
 #ifdef CONFIG_NXTERM_NXKBDIN
@@ -224,11 +276,13 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
     FAR const struct nxgl_rect_s *rect, FAR const struct nxterm_bitmap_s *bm);
 
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch);
+void nxterm_flush(FAR struct nxterm_state_s *priv);
 void nxterm_showcursor(FAR struct nxterm_state_s *priv);
 void nxterm_hidecursor(FAR struct nxterm_state_s *priv);
 
 /* Scrolling support */
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight);
+void nxterm_scrolldisplay(FAR struct nxterm_state_s *priv);
 
 #endif /* __GRAPHICS_NXTERM_NXTERM_H */
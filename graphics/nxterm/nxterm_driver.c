@@ -58,6 +58,9 @@
 static int     nxterm_open(FAR struct file *filep);
 static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
+#ifdef NXTERM_DEFERRED
+static void    nxterm_refresh(FAR void *arg);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -136,6 +139,34 @@ static int nxterm_open(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxterm_refresh
+ *
+ * Description:
+ *   Work queue callback that updates the display after a write whose
+ *   refresh was deferred.
+ *
+ ****************************************************************************/
+
+#ifdef NXTERM_DEFERRED
+static void nxterm_refresh(FAR void *arg)
+{
+  FAR struct nxterm_state_s *priv = (FAR struct nxterm_state_s *)arg;
+  int ret;
+
+  do
+    {
+      ret = nxterm_semwait(priv);
+      DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+    }
+  while (ret < 0);
+
+  nxterm_showcursor(priv);
+  priv->lastflush = clock_systimer();
+  nxterm_sempost(priv);
+}
+#endif
+
 /****************************************************************************
  * Name: nxterm_write
  ****************************************************************************/
@@ -146,6 +177,9 @@ static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct nxterm_state_s *priv;
   enum nxterm_vt100state_e state;
   ssize_t remaining;
+#ifdef NXTERM_DEFERRED
+  systime_t elapsed;
+#endif
   char ch;
   int ret;
 
@@ -241,7 +275,29 @@ static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
       while (state == VT100_ABORT);
     }
 
-  /* Show the cursor at its new position */
+#ifdef NXTERM_DEFERRED
+  /* If the display was updated only recently, then defer the update so
+   * that the output of several writes can be drawn together.
+   */
+
+  elapsed = clock_systimer() - priv->lastflush;
+  if (elapsed < MSEC2TICK(CONFIG_NXTERM_REFRESH_INTERVAL))
+    {
+      if (work_available(&priv->work))
+        {
+          (void)work_queue(NXTERM_WORK, &priv->work, nxterm_refresh, priv,
+                           MSEC2TICK(CONFIG_NXTERM_REFRESH_INTERVAL) -
+                           elapsed);
+        }
+
+      nxterm_sempost(priv);
+      return (ssize_t)buflen;
+    }
+
+  priv->lastflush = clock_systimer();
+#endif
+
+  /* Update the display and show the cursor at its new position */
 
   nxterm_showcursor(priv);
   nxterm_sempost(priv);
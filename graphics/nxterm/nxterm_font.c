@@ -207,9 +207,21 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
       ndx = priv->nchars - 1;
       bm  = &priv->bm[ndx];
 
-      /* Erase the character from the display */
+      /* Erase the character from the display.  The display must reflect any
+       * pending scroll first.  A character that has not yet been drawn does
+       * not need to be erased.
+       */
 
-      ret = nxterm_hidechar(priv, bm);
+      nxterm_scrolldisplay(priv);
+      if (ndx < priv->npending)
+        {
+          ret = nxterm_hidechar(priv, bm);
+          priv->npending = ndx;
+        }
+      else
+        {
+          ret = OK;
+        }
 
       /* The current position to the location where the last character was */
 
@@ -39,14 +39,192 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+#include <assert.h>
+
 #include <nuttx/ascii.h>
 
 #include "nxterm.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NXTERM_BYTESPP (CONFIG_NXTERM_BPP >> 3)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxterm_fillbg
+ *
+ * Description:
+ *   Set 'npixels' pixels of the run buffer to the window background color.
+ *
+ ****************************************************************************/
+
+#ifdef NXTERM_BATCH
+static void nxterm_fillbg(FAR struct nxterm_state_s *priv,
+                          FAR uint8_t *dest, nxgl_coord_t npixels)
+{
+#if CONFIG_NXTERM_BPP == 8
+  memset(dest, (uint8_t)priv->wndo.wcolor[0], npixels);
+#elif CONFIG_NXTERM_BPP == 16
+  FAR uint16_t *ptr = (FAR uint16_t *)dest;
+  uint16_t color = (uint16_t)priv->wndo.wcolor[0];
+
+  while (npixels-- > 0)
+    {
+      *ptr++ = color;
+    }
+#else
+  FAR uint32_t *ptr = (FAR uint32_t *)dest;
+  uint32_t color = (uint32_t)priv->wndo.wcolor[0];
+
+  while (npixels-- > 0)
+    {
+      *ptr++ = color;
+    }
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: nxterm_fillrun
+ *
+ * Description:
+ *   Compose the run of adjacent characters on one line beginning with
+ *   bm[first] into the run buffer and transfer them to the display with a
+ *   single bitmap operation.  Returns the index of the first character that
+ *   was not drawn.
+ *
+ ****************************************************************************/
+
+#ifdef NXTERM_BATCH
+static int nxterm_fillrun(FAR struct nxterm_state_s *priv, int first)
+{
+  FAR const struct nxterm_bitmap_s *bm;
+  FAR const struct nxfonts_glyph_s *glyph;
+  FAR const void *src;
+  FAR uint8_t *dest;
+  struct nxgl_rect_s rect;
+  struct nxgl_point_s origin;
+  unsigned int runstride;
+  nxgl_coord_t maxwidth;
+  nxgl_coord_t width;
+  nxgl_coord_t xend;
+  bool blank;
+  int last;
+  int row;
+  int ret;
+
+  /* How wide a run will fit into the run buffer? */
+
+  maxwidth  = CONFIG_NXTERM_BATCHSIZE / (priv->fheight * NXTERM_BYTESPP);
+  runstride = maxwidth * NXTERM_BYTESPP;
+
+  bm        = &priv->bm[first];
+  origin.x  = bm->pos.x;
+  origin.y  = bm->pos.y;
+  xend      = origin.x;
+  blank     = true;
+
+  if (maxwidth >= priv->fwidth)
+    {
+      /* Add each character that immediately follows the previous one on
+       * the same line.
+       */
+
+      for (last = first; last < priv->nchars; last++)
+        {
+          bm = &priv->bm[last];
+          if (bm->pos.y != origin.y || bm->pos.x != xend)
+            {
+              break;
+            }
+
+          glyph = NULL;
+          width = priv->spwidth;
+
+          if (!BM_ISSPACE(bm))
+            {
+              glyph = nxf_cache_getglyph(priv->fcache, bm->code);
+              if (glyph)
+                {
+                  width = glyph->width;
+                }
+            }
+
+          if (xend + width - origin.x > maxwidth)
+            {
+              break;
+            }
+
+          /* Copy the glyph into its column of the run buffer */
+
+          dest = (FAR uint8_t *)priv->runbuf +
+                 (xend - origin.x) * NXTERM_BYTESPP;
+
+          for (row = 0; row < priv->fheight; row++, dest += runstride)
+            {
+              if (glyph && row < glyph->height)
+                {
+                  memcpy(dest, &glyph->bitmap[row * glyph->stride],
+                         width * NXTERM_BYTESPP);
+                }
+              else
+                {
+                  nxterm_fillbg(priv, dest, width);
+                }
+            }
+
+          if (glyph)
+            {
+              blank = false;
+            }
+
+          xend += width;
+        }
+    }
+  else
+    {
+      last = first;
+    }
+
+  /* If not even one character fit, then just draw the character by
+   * itself.
+   */
+
+  if (last == first)
+    {
+      nxterm_fillchar(priv, NULL, bm);
+      return first + 1;
+    }
+
+  /* There is nothing to draw if the run is all spaces */
+
+  if (!blank)
+    {
+      rect.pt1.x = origin.x;
+      rect.pt1.y = origin.y;
+      rect.pt2.x = xend - 1;
+      rect.pt2.y = origin.y + priv->fheight - 1;
+
+      src = (FAR const void *)priv->runbuf;
+      ret = priv->ops->bitmap(priv, &rect, &src, &origin, runstride);
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+    }
+
+  return last;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: nxterm_putc
  *
@@ -57,7 +235,6 @@
 
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
 {
-  FAR const struct nxterm_bitmap_s *bm;
   int lineheight;
 
   /* Ignore carriage returns */
@@ -118,15 +295,45 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
       nxterm_scroll(priv, lineheight);
     }
 
-  /* Find the glyph associated with the character and render it onto the
-   * display.
+  /* Find the glyph associated with the character.  It will be rendered
+   * onto the display by the next nxterm_flush().
+   */
+
+  (void)nxterm_addchar(priv, ch);
+}
+
+/****************************************************************************
+ * Name: nxterm_flush
+ *
+ * Description:
+ *   Bring the display up to date:  Perform any pending scroll operation
+ *   and render all of the characters that have not yet been drawn.
+ *
+ ****************************************************************************/
+
+void nxterm_flush(FAR struct nxterm_state_s *priv)
+{
+  int i;
+
+  /* Scroll the display first so that the new characters land in the
+   * vacated lines.
    */
 
-  bm = nxterm_addchar(priv, ch);
-  if (bm)
+  nxterm_scrolldisplay(priv);
+
+  /* Then draw each pending character */
+
+  for (i = priv->npending; i < priv->nchars; )
     {
-      nxterm_fillchar(priv, NULL, bm);
+#ifdef NXTERM_BATCH
+      i = nxterm_fillrun(priv, i);
+#else
+      nxterm_fillchar(priv, NULL, &priv->bm[i]);
+      i++;
+#endif
     }
+
+  priv->npending = priv->nchars;
 }
 
 /****************************************************************************
@@ -162,6 +369,10 @@ void nxterm_showcursor(FAR struct nxterm_state_s *priv)
       nxterm_scroll(priv, lineheight);
     }
 
+  /* Make sure that the display is up to date */
+
+  nxterm_flush(priv);
+
   /* Render the cursor glyph onto the display. */
 
   priv->cursor.pos.x = priv->fpos.x;
@@ -66,6 +66,9 @@
  *   easy.  However, many displays (such as SPI-based LCDs) are often read-
  *   only.
  *
+ *   'scrollheight' is the accumulated scroll distance of all of the scroll
+ *   operations since the display was last updated.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NX_WRITEONLY
@@ -75,6 +78,7 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
   FAR struct nxterm_bitmap_s *bm;
   struct nxgl_rect_s rect;
   nxgl_coord_t row;
+  int lineheight;
   int ret;
   int i;
 
@@ -87,12 +91,13 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
   rect.pt1.x = 0;
   rect.pt2.x = priv->wndo.wsize.w - 1;
 
-  for (row = CONFIG_NXTERM_LINESEPARATION; row < bottom; row += scrollheight)
+  lineheight = priv->fheight + CONFIG_NXTERM_LINESEPARATION;
+  for (row = CONFIG_NXTERM_LINESEPARATION; row < bottom; row += lineheight)
     {
       /* Create a bounding box the size of one row of characters */
 
       rect.pt1.y = row;
-      rect.pt2.y = row + scrollheight - 1;
+      rect.pt2.y = row + lineheight - 1;
 
       /* Clear the region */
 
@@ -124,6 +129,16 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
     {
       gerr("ERROR: Fill failed: %d\n", errno);
     }
+
+  /* Characters above the bottom have all been redrawn.  There is no need
+   * to draw them again.
+   */
+
+  while (priv->npending < priv->nchars &&
+         priv->bm[priv->npending].pos.y < bottom)
+    {
+      priv->npending++;
+    }
 }
 #else
 static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
@@ -133,9 +148,26 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
   struct nxgl_point_s offset;
   int ret;
 
-  /* Add the line separation value to the scroll height */
+  rect.pt1.x = 0;
+  rect.pt2.x = priv->wndo.wsize.w - 1;
+  rect.pt2.y = priv->wndo.wsize.h - 1;
+
+  /* If everything has scrolled off of the display, then there is nothing
+   * to move.  Just clear the whole display.
+   */
+
+  if (scrollheight >= priv->wndo.wsize.h)
+    {
+      rect.pt1.y = 0;
+
+      ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
+      if (ret < 0)
+        {
+          gerr("ERROR: Fill failed: %d\n", errno);
+        }
 
-  scrollheight += CONFIG_NXTERM_LINESEPARATION;
+      return;
+    }
 
   /* Move the display in the range of 0-height up one scrollheight.  The
    * line at the bottom will be reset to the background color automatically.
@@ -143,10 +175,7 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
    * The source rectangle to be moved.
    */
 
-  rect.pt1.x = 0;
   rect.pt1.y = scrollheight;
-  rect.pt2.x = priv->wndo.wsize.w - 1;
-  rect.pt2.y = priv->wndo.wsize.h - 1;
 
   /* The offset that determines how far to move the source rectangle */
 
@@ -183,53 +212,79 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 {
+  FAR struct nxterm_bitmap_s *bm;
+  int npending;
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Adjust the vertical position of each character, compacting the
+   * characters that remain into the beginning of bm[] in a single pass.
+   */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0, npending = 0; i < priv->nchars; i++)
     {
-      FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
+      bm = &priv->bm[i];
 
-      /* Has any part of this character scrolled off the screen? */
+      /* Has any part of this character scrolled off the screen?  If so,
+       * just drop it.
+       */
 
-      if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
+      if (bm->pos.y >= scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
+          /* No.. just decrement its vertical position (moving it "up" the
+           * display by one line).
+           */
 
-          for (j = i; j < priv->nchars-1; j++)
+          bm->pos.y -= scrollheight;
+          if (i != j)
             {
-              memcpy(&priv->bm[j], &priv->bm[j+1],
-                     sizeof(struct nxterm_bitmap_s));
+              memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
             }
 
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
+          /* Keep track of how many of the retained characters have already
+           * been drawn.
            */
 
-          priv->nchars--;
-        }
-
-      /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
-       */
-
-      else
-        {
-          bm->pos.y -= scrollheight;
-
-          /* We are keeping this one so increment to the next character */
+          if (i < priv->npending)
+            {
+              npending++;
+            }
 
-          i++;
+          j++;
         }
     }
 
+  priv->nchars   = j;
+  priv->npending = npending;
+
   /* And move the next display position up by one line as well */
 
   priv->fpos.y -= scrollheight;
 
-  /* Move the display in the range of 0-height up one scrollheight. */
+  /* The display itself is scrolled later by nxterm_scrolldisplay() so
+   * that several scroll operations can be combined into one move.
+   */
+
+  priv->scrollpend += scrollheight;
+}
 
-  nxterm_movedisplay(priv, priv->fpos.y, scrollheight);
+/****************************************************************************
+ * Name: nxterm_scrolldisplay
+ *
+ * Description:
+ *   Apply all of the pending scroll operations to the display.
+ *
+ ****************************************************************************/
+
+void nxterm_scrolldisplay(FAR struct nxterm_state_s *priv)
+{
+  if (priv->scrollpend > 0)
+    {
+      /* Move the display in the range of 0-height up by the accumulated
+       * scroll height.
+       */
+
+      nxterm_movedisplay(priv, priv->fpos.y, priv->scrollpend);
+      priv->scrollpend = 0;
+    }
 }
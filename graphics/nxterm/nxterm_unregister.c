@@ -79,6 +79,13 @@ void nxterm_unregister(NXTERM handle)
   /* Get the reference to the driver structure from the handle */
 
   priv = (FAR struct nxterm_state_s *)handle;
+
+#ifdef NXTERM_DEFERRED
+  /* Cancel any pending display refresh */
+
+  (void)work_cancel(NXTERM_WORK, &priv->work);
+#endif
+
   nxsem_destroy(&priv->exclsem);
 #ifdef CONFIG_NXTERM_NXKBDIN
   nxsem_destroy(&priv->waitsem);
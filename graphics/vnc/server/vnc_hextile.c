@@ -0,0 +1,711 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_FEATURES
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  define CONFIG_DEBUG_FEATURES 1
+#  define CONFIG_DEBUG_ERROR    1
+#  define CONFIG_DEBUG_WARN     1
+#  define CONFIG_DEBUG_INFO     1
+#  define CONFIG_DEBUG_GRAPHICS 1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The maximum number of distinct colors that will be considered when
+ * selecting the background color of a tile.  Tiles with more colors than
+ * this are simply sent raw.
+ */
+
+#define HEXTILE_MAXCOLORS 8
+
+/* The maximum number of sub-rectangles that may be encoded in a tile */
+
+#define HEXTILE_MAXSUBRECTS 255
+
+/* Column bit masks for the coverage map */
+
+#define HEXTILE_BIT(n)      ((uint16_t)1 << (n))
+#define HEXTILE_SPAN(a,b)   \
+  ((uint16_t)((((uint32_t)1 << (b)) - 1) & ~(((uint32_t)1 << (a)) - 1)))
+
+/* The worst case size of one encoded tile (raw) */
+
+#define HEXTILE_MAXTILE(b) (1 + VNC_TILESIZE * VNC_TILESIZE * (b))
+
+/* Size of the FramebufferUpdate header with one rectangle */
+
+#define HEXTILE_HDRSIZE \
+  SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of one Hextile encoded rectangle */
+
+struct vnc_hextile_s
+{
+  FAR struct vnc_session_s *session;
+  FAR uint8_t *dest;             /* Next free byte in session->outbuf */
+  size_t nsent;                  /* Number of bytes sent so far */
+  lfb_color_t bg;                /* Background of the previous tile */
+  lfb_color_t fg;                /* Foreground of the previous tile */
+  bool bgvalid;                  /* True: bg may be carried over */
+  bool fgvalid;                  /* True: fg may be carried over */
+  bool bigendian;                /* True: Remote is big-endian */
+  uint8_t bytesperpixel;         /* Remote bytes per pixel */
+
+  union
+  {
+    vnc_convert8_t bpp8;
+    vnc_convert16_t bpp16;
+    vnc_convert32_t bpp32;
+  } convert;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_pixel
+ *
+ * Description:
+ *   Return the address of a pixel in the local framebuffer.
+ *
+ ****************************************************************************/
+
+static inline FAR const lfb_color_t *
+vnc_hextile_pixel(FAR struct vnc_session_s *session, nxgl_coord_t x,
+                  nxgl_coord_t y)
+{
+  return (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_putpixel
+ *
+ * Description:
+ *   Convert one local color to the remote color format and add it to the
+ *   output buffer.
+ *
+ * Input Parameters:
+ *   state - The Hextile encoding state.
+ *   dest  - The location in the output buffer to receive the pixel.
+ *   color - The color in the local framebuffer format
+ *
+ * Returned Value:
+ *   The next free location in the output buffer.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_hextile_putpixel(FAR struct vnc_hextile_s *state,
+                                         FAR uint8_t *dest,
+                                         lfb_color_t color)
+{
+  if (state->bytesperpixel == 1)
+    {
+      *dest++ = state->convert.bpp8(color);
+    }
+  else if (state->bytesperpixel == 2)
+    {
+      uint16_t pixel = state->convert.bpp16(color);
+
+      if (state->bigendian)
+        {
+          rfb_putbe16(dest, pixel);
+        }
+      else
+        {
+          rfb_putle16(dest, pixel);
+        }
+
+      dest += sizeof(uint16_t);
+    }
+  else /* bytesperpixel == 4 */
+    {
+      uint32_t pixel = state->convert.bpp32(color);
+
+      if (state->bigendian)
+        {
+          rfb_putbe32(dest, pixel);
+        }
+      else
+        {
+          rfb_putle32(dest, pixel);
+        }
+
+      dest += sizeof(uint32_t);
+    }
+
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send all of the data accumulated in the output buffer.
+ *
+ * Input Parameters:
+ *   state - The Hextile encoding state.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on a network failure.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct vnc_hextile_s *state)
+{
+  FAR struct vnc_session_s *session = state->session;
+  FAR const uint8_t *src = session->outbuf;
+  size_t size = (size_t)(state->dest - session->outbuf);
+  ssize_t nsent;
+
+  state->nsent += size;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+
+  state->dest = session->outbuf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_colors
+ *
+ * Description:
+ *   Count the colors in one tile and select the most frequent color as
+ *   the tile background.
+ *
+ * Input Parameters:
+ *   state - The Hextile encoding state.
+ *   x,y   - The position of the tile in the local framebuffer.
+ *   w,h   - The size of the tile.
+ *   bg    - The location to return the background color.
+ *   fg    - The location to return the second color (if exactly two).
+ *
+ * Returned Value:
+ *   The number of distinct colors in the tile or HEXTILE_MAXCOLORS + 1 if
+ *   there are more than HEXTILE_MAXCOLORS.
+ *
+ ****************************************************************************/
+
+static unsigned int vnc_hextile_colors(FAR struct vnc_hextile_s *state,
+                                       nxgl_coord_t x, nxgl_coord_t y,
+                                       nxgl_coord_t w, nxgl_coord_t h,
+                                       FAR lfb_color_t *bg,
+                                       FAR lfb_color_t *fg)
+{
+  FAR const lfb_color_t *src;
+  lfb_color_t colors[HEXTILE_MAXCOLORS];
+  uint16_t counts[HEXTILE_MAXCOLORS];
+  unsigned int ncolors = 0;
+  unsigned int best;
+  unsigned int i;
+  nxgl_coord_t col;
+  nxgl_coord_t row;
+
+  for (row = 0; row < h; row++)
+    {
+      src = vnc_hextile_pixel(state->session, x, y + row);
+      for (col = 0; col < w; col++, src++)
+        {
+          /* Pixels tend to repeat the most recently found color */
+
+          for (i = 0; i < ncolors && colors[i] != *src; i++)
+            {
+            }
+
+          if (i < ncolors)
+            {
+              counts[i]++;
+            }
+          else if (ncolors < HEXTILE_MAXCOLORS)
+            {
+              colors[ncolors] = *src;
+              counts[ncolors] = 1;
+              ncolors++;
+            }
+          else
+            {
+              return HEXTILE_MAXCOLORS + 1;
+            }
+        }
+    }
+
+  for (best = 0, i = 1; i < ncolors; i++)
+    {
+      if (counts[i] > counts[best])
+        {
+          best = i;
+        }
+    }
+
+  *bg = colors[best];
+  *fg = (ncolors > 1) ? colors[best == 0 ? 1 : 0] : colors[best];
+  return ncolors;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_raw
+ *
+ * Description:
+ *   Encode one tile as raw pixel data.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_raw(FAR struct vnc_hextile_s *state,
+                            FAR uint8_t *dest,
+                            nxgl_coord_t x, nxgl_coord_t y,
+                            nxgl_coord_t w, nxgl_coord_t h)
+{
+  FAR const lfb_color_t *src;
+  nxgl_coord_t col;
+  nxgl_coord_t row;
+
+  *dest++ = RFB_HEXTILE_RAW;
+
+  for (row = 0; row < h; row++)
+    {
+      src = vnc_hextile_pixel(state->session, x, y + row);
+      for (col = 0; col < w; col++)
+        {
+          dest = vnc_hextile_putpixel(state, dest, *src++);
+        }
+    }
+
+  /* Neither the background nor the foreground may be carried over a raw
+   * tile.
+   */
+
+  state->bgvalid = false;
+  state->fgvalid = false;
+  state->dest    = dest;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_subrects
+ *
+ * Description:
+ *   Encode one tile as a background with sub-rectangles.  The tile is
+ *   scanned left-to-right, top-to-bottom; each pixel that is not the
+ *   background and not already covered starts a new sub-rectangle that is
+ *   first grown horizontally and then downward for as long as the color
+ *   remains the same.
+ *
+ * Returned Value:
+ *   True if the tile was encoded; False if the encoding would be no smaller
+ *   than the raw encoding.  In that case, nothing is consumed from the
+ *   output buffer.
+ *
+ ****************************************************************************/
+
+static bool vnc_hextile_subrects(FAR struct vnc_hextile_s *state,
+                                 FAR uint8_t *dest,
+                                 nxgl_coord_t x, nxgl_coord_t y,
+                                 nxgl_coord_t w, nxgl_coord_t h,
+                                 lfb_color_t bg, lfb_color_t fg,
+                                 bool mono)
+{
+  FAR struct vnc_session_s *session = state->session;
+  FAR const lfb_color_t *src;
+  FAR uint8_t *start = dest;
+  FAR uint8_t *nsubrects;
+  FAR uint8_t *limit;
+  uint16_t done[VNC_TILESIZE];
+  uint16_t mask;
+  lfb_color_t color;
+  unsigned int nrects;
+  unsigned int subsize;
+  nxgl_coord_t col;
+  nxgl_coord_t row;
+  nxgl_coord_t x2;
+  nxgl_coord_t y2;
+  nxgl_coord_t i;
+  uint8_t subencoding;
+
+  /* The encoding is abandoned as soon as it becomes as large as the raw
+   * encoding of the same tile.
+   */
+
+  limit   = start + 1 + w * h * state->bytesperpixel;
+  subsize = mono ? 2 : 2 + state->bytesperpixel;
+
+  /* Format the tile header */
+
+  subencoding = RFB_HEXTILE_ANY;
+  dest++;
+
+  if (!state->bgvalid || state->bg != bg)
+    {
+      subencoding |= RFB_HEXTILE_BACK;
+      dest = vnc_hextile_putpixel(state, dest, bg);
+    }
+
+  if (!mono)
+    {
+      subencoding |= RFB_HEXTILE_COLORED;
+    }
+  else if (!state->fgvalid || state->fg != fg)
+    {
+      subencoding |= RFB_HEXTILE_FORE;
+      dest = vnc_hextile_putpixel(state, dest, fg);
+    }
+
+  nsubrects = dest++;
+  nrects    = 0;
+
+  /* Then the sub-rectangles */
+
+  memset(done, 0, sizeof(done));
+
+  for (row = 0; row < h; row++)
+    {
+      src = vnc_hextile_pixel(session, x, y + row);
+      for (col = 0; col < w; col++)
+        {
+          color = src[col];
+          if (color == bg || (done[row] & HEXTILE_BIT(col)) != 0)
+            {
+              continue;
+            }
+
+          if (nrects >= HEXTILE_MAXSUBRECTS || dest + subsize >= limit)
+            {
+              return false;
+            }
+
+          /* Grow the sub-rectangle to the right ... */
+
+          for (x2 = col + 1;
+               x2 < w && src[x2] == color && (done[row] & HEXTILE_BIT(x2)) == 0;
+               x2++)
+            {
+            }
+
+          mask = HEXTILE_SPAN(col, x2);
+
+          /* ... then downward while the full row span matches */
+
+          for (y2 = row + 1; y2 < h; y2++)
+            {
+              FAR const lfb_color_t *next =
+                vnc_hextile_pixel(session, x, y + y2);
+
+              if ((done[y2] & mask) != 0)
+                {
+                  break;
+                }
+
+              for (i = col; i < x2 && next[i] == color; i++)
+                {
+                }
+
+              if (i < x2)
+                {
+                  break;
+                }
+            }
+
+          for (i = row; i < y2; i++)
+            {
+              done[i] |= mask;
+            }
+
+          /* Add the sub-rectangle */
+
+          if (!mono)
+            {
+              dest = vnc_hextile_putpixel(state, dest, color);
+            }
+
+          *dest++ = (uint8_t)((col << 4) | row);
+          *dest++ = (uint8_t)(((x2 - col - 1) << 4) | (y2 - row - 1));
+          nrects++;
+        }
+    }
+
+  *start     = subencoding;
+  *nsubrects = (uint8_t)nrects;
+
+  state->bg      = bg;
+  state->bgvalid = true;
+  state->fg      = fg;
+  state->fgvalid = mono;
+  state->dest    = dest;
+  return true;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile using the most compact sub-encoding.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_tile(FAR struct vnc_hextile_s *state,
+                             nxgl_coord_t x, nxgl_coord_t y,
+                             nxgl_coord_t w, nxgl_coord_t h)
+{
+  FAR uint8_t *dest = state->dest;
+  lfb_color_t bg;
+  lfb_color_t fg;
+  unsigned int ncolors;
+
+  ncolors = vnc_hextile_colors(state, x, y, w, h, &bg, &fg);
+  if (ncolors == 1)
+    {
+      /* A solid tile.  Only the background, if it changed.  The foreground
+       * state is unaffected.
+       */
+
+      if (state->bgvalid && state->bg == bg)
+        {
+          *dest++ = 0;
+        }
+      else
+        {
+          *dest++ = RFB_HEXTILE_BACK;
+          dest    = vnc_hextile_putpixel(state, dest, bg);
+        }
+
+      state->bg      = bg;
+      state->bgvalid = true;
+      state->dest    = dest;
+    }
+  else if (ncolors > HEXTILE_MAXCOLORS ||
+           !vnc_hextile_subrects(state, dest, x, y, w, h, bg, fg,
+                                 ncolors == 2))
+    {
+      vnc_hextile_raw(state, dest, x, y, w, h);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR uint8_t *bufend;
+  struct vnc_hextile_s state;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  nxgl_coord_t w;
+  nxgl_coord_t h;
+  size_t maxtile;
+  int ret;
+
+  /* Check if the client supports the Hextile encoding */
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  /* Set up the color conversion.  The color format is sampled once:  Once
+   * the rectangle header has been sent, the rest of the rectangle must
+   * follow in the same format even if a SetPixelFormat is received
+   * asynchronously.
+   */
+
+  switch (session->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        state.convert.bpp8 = vnc_convert_rgb8_222;
+        state.bytesperpixel = 1;
+        break;
+
+      case FB_FMT_RGB8_332:
+        state.convert.bpp8 = vnc_convert_rgb8_332;
+        state.bytesperpixel = 1;
+        break;
+
+      case FB_FMT_RGB16_555:
+        state.convert.bpp16 = vnc_convert_rgb16_555;
+        state.bytesperpixel = 2;
+        break;
+
+      case FB_FMT_RGB16_565:
+        state.convert.bpp16 = vnc_convert_rgb16_565;
+        state.bytesperpixel = 2;
+        break;
+
+      case FB_FMT_RGB32:
+        state.convert.bpp32 = vnc_convert_rgb32_888;
+        state.bytesperpixel = 4;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  /* The output buffer must be able to hold at least one raw tile */
+
+  maxtile = HEXTILE_MAXTILE(state.bytesperpixel);
+  if (maxtile > VNCSERVER_UPDATE_BUFSIZE - HEXTILE_HDRSIZE)
+    {
+      return 0;
+    }
+
+  state.session   = session;
+  state.nsent     = 0;
+  state.bgvalid   = false;
+  state.fgvalid   = false;
+  state.bigendian = session->bigendian;
+
+  DEBUGASSERT(rect->pt1.x <= rect->pt2.x && rect->pt1.y <= rect->pt2.y);
+  width  = rect->pt2.x - rect->pt1.x + 1;
+  height = rect->pt2.y - rect->pt1.y + 1;
+
+  /* Format the FramebufferUpdate message with a single Hextile encoded
+   * rectangle.
+   */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos, rect->pt1.y);
+  rfb_putbe16(update->rect[0].width, width);
+  rfb_putbe16(update->rect[0].height, height);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  state.dest = session->outbuf + HEXTILE_HDRSIZE;
+  bufend     = session->outbuf + VNCSERVER_UPDATE_BUFSIZE;
+
+  /* Then encode each tile, left-to-right, top-to-bottom, flushing the
+   * output buffer whenever there might not be room for the next tile.
+   */
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += h)
+    {
+      h = MIN(VNC_TILESIZE, rect->pt2.y - y + 1);
+
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += w)
+        {
+          w = MIN(VNC_TILESIZE, rect->pt2.x - x + 1);
+
+          if (state.dest + maxtile > bufend)
+            {
+              ret = vnc_hextile_flush(&state);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          vnc_hextile_tile(&state, x, y, w, h);
+        }
+    }
+
+  ret = vnc_hextile_flush(&state);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}: %lu bytes\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y,
+          (unsigned long)state.nsent);
+  return (int)state.nsent;
+}
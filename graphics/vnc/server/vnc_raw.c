@@ -259,7 +259,7 @@ static size_t vnc_copy32(FAR struct vnc_session_s *session,
       srcleft = (FAR lfb_color_t *)((uintptr_t)srcleft + RFB_STRIDE);
     }
 
-  return (size_t)((uintptr_t)srcleft - (uintptr_t)update->rect[0].data);
+  return (size_t)((uintptr_t)dest - (uintptr_t)update->rect[0].data);
 }
 
 /****************************************************************************
@@ -278,9 +278,9 @@ static size_t vnc_copy32(FAR struct vnc_session_s *session,
  *   rect  - Describes the rectangle in the local framebuffer.
  *
  * Returned Value:
- *   Zero (OK) on success; A negated errno value is returned on failure that
- *   indicates the nature of the failure.  A failure is only returned
- *   in cases of a network failure and unexpected internal failures.
+ *   The number of bytes sent on success; A negated errno value is returned
+ *   on failure that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
  *
  ****************************************************************************/
 
@@ -301,6 +301,7 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
   unsigned int bytesperpixel;
   unsigned int maxwidth;
   size_t size;
+  size_t total;
   ssize_t nsent;
   uint8_t colorfmt;
 
@@ -386,6 +387,7 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
    * asynchronously.
    */
 
+  total = 0;
   for (y = rect->pt1.y;
        srcheight > 0 && colorfmt == session->colorfmt;
        srcheight -= updheight, y += updheight)
@@ -477,6 +479,8 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
                * and there are a limited number of IOBs available.
                */
 
+              total += size;
+
               do
                 {
                   nsent = psock_send(&session->connect, src, size, 0);
@@ -499,5 +503,5 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
         }
     }
 
-  return OK;
+  return (int)total;
 }
\ No newline at end of file
@@ -139,6 +139,24 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->state   = VNCSERVER_INITIALIZED;
   session->nwhupd  = 0;
   session->change  = true;
+  session->rre     = false;
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  session->hextile = false;
+#endif
+
+  /* Forget the throughput of any previous client */
+
+  session->txrate  = 0;
+  session->txbytes = 0;
+  session->txticks = 0;
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  /* Nothing has been sent to the new client.  It will request a whole
+   * screen update that will re-populate the tile hashes.
+   */
+
+  memset(session->tilehash, 0, sizeof(session->tilehash));
+#endif
 
   /* Careful not to disturb the keyboard/mouse callouts set by
    * vnc_fbinitialize().  Client related data left in garbage state.
@@ -47,6 +47,7 @@
 #include <pthread.h>
 #include <queue.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/video/rfb.h>
 #include <nuttx/video/vnc.h>
@@ -160,6 +161,22 @@
 #define VNCSERVER_UPDATE_BUFSIZE \
   (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
 
+#ifndef CONFIG_VNCSERVER_RAW_THRESHOLD
+#  define CONFIG_VNCSERVER_RAW_THRESHOLD 0
+#endif
+
+/* Tile geometry.  Tiles are used both by the Hextile encoding and by the
+ * tile-based change detection logic.
+ */
+
+#define VNC_TILESHIFT       4
+#define VNC_TILESIZE        (1 << VNC_TILESHIFT)
+#define VNC_XTILES          \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + VNC_TILESIZE - 1) >> VNC_TILESHIFT)
+#define VNC_YTILES          \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + VNC_TILESIZE - 1) >> VNC_TILESHIFT)
+#define VNC_NTILES          (VNC_XTILES * VNC_YTILES)
+
 /* Local framebuffer characteristics in bytes */
 
 #define RFB_BYTESPERPIXEL   ((RFB_BITSPERPIXEL + 7) >> 3)
@@ -231,6 +248,7 @@ struct vnc_fbupdate_s
 {
   FAR struct vnc_fbupdate_s *flink;
   bool whupd;                  /* True: whole screen update */
+  bool change;                 /* True: Framebuffer data change */
   struct nxgl_rect_s rect;     /* The enqueued update rectangle */
 };
 
@@ -251,6 +269,9 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -262,6 +283,12 @@ struct vnc_session_s
   /* Updater information */
 
   pthread_t updater;           /* Updater thread ID */
+  uint32_t txrate;             /* Averaged send throughput (bytes/sec) */
+  uint32_t txbytes;            /* Bytes sent in the current sample */
+  systime_t txticks;           /* Ticks spent sending in the current sample */
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  uint32_t tilehash[VNC_NTILES]; /* Hash of each tile as last sent */
+#endif
 
   /* Update list information */
 
@@ -498,6 +525,30 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -510,9 +561,9 @@ int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
  *   rect  - Describes the rectangle in the local framebuffer.
  *
  * Returned Value:
- *   Zero (OK) on success; A negated errno value is returned on failure that
- *   indicates the nature of the failure.  A failure is only returned
- *   in cases of a network failure and unexpected internal failures.
+ *   The number of bytes sent on success; A negated errno value is returned
+ *   on failure that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
  *
  ****************************************************************************/
 
@@ -60,6 +60,7 @@
 #endif
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 
 #include "vnc_server.h"
@@ -71,6 +72,10 @@
 #undef VNCSERVER_SEM_DEBUG          /* Define to dump queue/semaphore state */
 #undef VNCSERVER_SEM_DEBUG_SILENT   /* Define to dump only suspicious conditions */
 
+/* Throughput is averaged over samples of at least this much send time */
+
+#define VNC_RATE_WINDOW MSEC2TICK(500)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -381,6 +386,302 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_throughput
+ *
+ * Description:
+ *   Accumulate the time spent sending an update and update the averaged
+ *   send throughput once a full sample has been collected.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   nbytes  - The number of bytes sent
+ *   elapsed - The time spent encoding and sending the bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void vnc_throughput(FAR struct vnc_session_s *session,
+                           uint32_t nbytes, systime_t elapsed)
+{
+  uint32_t rate;
+
+  session->txbytes += nbytes;
+  session->txticks += elapsed;
+
+  if (session->txticks >= VNC_RATE_WINDOW)
+    {
+      rate = (session->txbytes / session->txticks) * TICK_PER_SEC;
+
+      /* Exponentially weighted average; each sample has weight 1/4. */
+
+      if (session->txrate == 0)
+        {
+          session->txrate = rate;
+        }
+      else
+        {
+          session->txrate = session->txrate - (session->txrate >> 2) +
+                            (rate >> 2);
+        }
+
+      updinfo("Throughput: %lu bytes/sec\n", (unsigned long)session->txrate);
+
+      session->txbytes = 0;
+      session->txticks = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_encode
+ *
+ * Description:
+ *   Send one rectangle to the client using the best available encoding:
+ *   RRE for single color regions, otherwise Hextile unless the measured
+ *   throughput shows that the link can keep up with RAW, and finally RAW.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer to be sent
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; A negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_encode(FAR struct vnc_session_s *session,
+                      FAR struct nxgl_rect_s *rect)
+{
+  systime_t start;
+  int ret;
+
+  start = clock_systimer();
+
+  /* Attempt to use RRE encoding */
+
+  ret = vnc_rre(session, rect);
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  /* Then Hextile if the link is slow (or the throughput is not known) */
+
+  if (ret == 0 &&
+      (CONFIG_VNCSERVER_RAW_THRESHOLD == 0 || session->txrate == 0 ||
+       session->txrate < CONFIG_VNCSERVER_RAW_THRESHOLD * 1024))
+    {
+      ret = vnc_hextile(session, rect);
+    }
+#endif
+
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  if (ret > 0)
+    {
+      vnc_throughput(session, (uint32_t)ret, clock_systimer() - start);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+/****************************************************************************
+ * Name: vnc_tile_hash
+ *
+ * Description:
+ *   Compute the hash of one 16x16 tile of the local framebuffer.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   tx, ty  - The tile column and row.
+ *
+ * Returned Value:
+ *   The 32-bit hash of the tile content
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_tile_hash(FAR struct vnc_session_s *session,
+                              nxgl_coord_t tx, nxgl_coord_t ty)
+{
+  FAR const lfb_color_t *src;
+  nxgl_coord_t x = tx << VNC_TILESHIFT;
+  nxgl_coord_t y = ty << VNC_TILESHIFT;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t col;
+  nxgl_coord_t row;
+  uint32_t hash;
+
+  width  = MIN(VNC_TILESIZE, CONFIG_VNCSERVER_SCREENWIDTH - x);
+  height = MIN(VNC_TILESIZE, CONFIG_VNCSERVER_SCREENHEIGHT - y);
+
+  /* FNV-1a, one pixel at a time */
+
+  hash = 2166136261ul;
+  for (row = 0; row < height; row++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + row) + RFB_BYTESPERPIXEL * x);
+
+      for (col = 0; col < width; col++)
+        {
+          hash = (hash ^ (uint32_t)*src++) * 16777619ul;
+        }
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: vnc_refresh_tiles
+ *
+ * Description:
+ *   The rectangle is about to be sent in its entirety.  Refresh the hashes
+ *   of all of the tiles that it covers completely.  Partially covered
+ *   tiles are left alone since the client will not receive all of their
+ *   content.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle in the local framebuffer to be sent
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void vnc_refresh_tiles(FAR struct vnc_session_s *session,
+                              FAR const struct nxgl_rect_s *rect)
+{
+  nxgl_coord_t tx1;
+  nxgl_coord_t ty1;
+  nxgl_coord_t tx2;
+  nxgl_coord_t ty2;
+  nxgl_coord_t tx;
+  nxgl_coord_t ty;
+
+  /* First and last+1 tiles completely inside of the rectangle */
+
+  tx1 = (rect->pt1.x + VNC_TILESIZE - 1) >> VNC_TILESHIFT;
+  ty1 = (rect->pt1.y + VNC_TILESIZE - 1) >> VNC_TILESHIFT;
+
+  tx2 = (rect->pt2.x + 1) >> VNC_TILESHIFT;
+  if (rect->pt2.x == CONFIG_VNCSERVER_SCREENWIDTH - 1)
+    {
+      tx2 = VNC_XTILES;
+    }
+
+  ty2 = (rect->pt2.y + 1) >> VNC_TILESHIFT;
+  if (rect->pt2.y == CONFIG_VNCSERVER_SCREENHEIGHT - 1)
+    {
+      ty2 = VNC_YTILES;
+    }
+
+  for (ty = ty1; ty < ty2; ty++)
+    {
+      for (tx = tx1; tx < tx2; tx++)
+        {
+          session->tilehash[ty * VNC_XTILES + tx] =
+            vnc_tile_hash(session, tx, ty);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_update_tiles
+ *
+ * Description:
+ *   Send only the tiles touched by the rectangle whose content differs from
+ *   what was last sent to the client.  Horizontally adjacent changed tiles
+ *   are merged into a single rectangle.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The changed rectangle in the local framebuffer
+ *
+ * Returned Value:
+ *   Zero (OK) or a positive byte count on success; A negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_update_tiles(FAR struct vnc_session_s *session,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  FAR uint32_t *hashes;
+  struct nxgl_rect_s run;
+  nxgl_coord_t tx1;
+  nxgl_coord_t tx2;
+  nxgl_coord_t ty2;
+  nxgl_coord_t tx;
+  nxgl_coord_t ty;
+  uint32_t hash;
+  bool changed;
+  bool inrun;
+  int ret;
+
+  tx1 = rect->pt1.x >> VNC_TILESHIFT;
+  tx2 = rect->pt2.x >> VNC_TILESHIFT;
+  ty2 = rect->pt2.y >> VNC_TILESHIFT;
+
+  for (ty = rect->pt1.y >> VNC_TILESHIFT; ty <= ty2; ty++)
+    {
+      hashes = &session->tilehash[ty * VNC_XTILES];
+      inrun  = false;
+
+      /* NOTE: One extra pass to terminate a run at the end of the row */
+
+      for (tx = tx1; tx <= tx2 + 1; tx++)
+        {
+          changed = false;
+          if (tx <= tx2)
+            {
+              /* The hash must be taken before the tile is sent so that any
+               * subsequent framebuffer change will be detected.
+               */
+
+              hash = vnc_tile_hash(session, tx, ty);
+              if (hash != hashes[tx])
+                {
+                  hashes[tx] = hash;
+                  changed    = true;
+                }
+            }
+
+          if (changed && !inrun)
+            {
+              run.pt1.x = tx << VNC_TILESHIFT;
+              inrun     = true;
+            }
+          else if (!changed && inrun)
+            {
+              run.pt1.y = ty << VNC_TILESHIFT;
+              run.pt2.x = MIN(tx << VNC_TILESHIFT,
+                              CONFIG_VNCSERVER_SCREENWIDTH) - 1;
+              run.pt2.y = MIN((ty + 1) << VNC_TILESHIFT,
+                              CONFIG_VNCSERVER_SCREENHEIGHT) - 1;
+
+              ret = vnc_encode(session, &run);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              inrun = false;
+            }
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -424,15 +725,23 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
-      /* Attempt to use RRE encoding */
+#ifdef CONFIG_VNCSERVER_TILEHASH
+      /* Framebuffer changes are reduced to the tiles that really changed.
+       * Client requests must be honored completely.
+       */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
+      if (srcrect->change)
         {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
+          ret = vnc_update_tiles(session, &srcrect->rect);
         }
+      else
+        {
+          vnc_refresh_tiles(session, &srcrect->rect);
+          ret = vnc_encode(session, &srcrect->rect);
+        }
+#else
+      ret = vnc_encode(session, &srcrect->rect);
+#endif
 
       /* Release the update structure */
 
@@ -646,7 +955,8 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
           /* Copy the clipped rectangle into the update structure */
 
-          update->whupd = whupd;
+          update->whupd  = whupd;
+          update->change = change;
           nxgl_rectcopy(&update->rect, &intersection);
 
           /* Add the upate to the end of the update queue. */
@@ -0,0 +1,181 @@
+/****************************************************************************
+ * include/dsp.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __INCLUDE_DSP_H
+#define __INCLUDE_DSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_LIBC_DSP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Limits of the fractional types */
+
+#define Q15_MAX          ((q15_t)0x7fff)        /* 0.999969482421875 */
+#define Q15_MIN          ((q15_t)0x8000)        /* -1.0 */
+#define Q31_MAX          ((q31_t)0x7fffffff)    /* 0.9999999995343387 */
+#define Q31_MIN          ((q31_t)0x80000000)    /* -1.0 */
+
+/* Largest transform supported by dsp_cfft_q15() */
+
+#define DSP_CFFT_MAXLEN  1024
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Signed fractional types with 15 and 31 fraction bits */
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+/* Q15 FIR filter instance.
+ *
+ * coeffs holds numtaps coefficients in time-reversed order, i.e.
+ * {b[numtaps-1], ..., b[1], b[0]}, the same layout used by CMSIS-DSP so that
+ * existing filter design output can be used unchanged.  state must provide
+ * numtaps + maxblock - 1 samples, where maxblock is the largest block that
+ * will ever be passed to dsp_fir_q15().
+ */
+
+struct dsp_fir_q15_s
+{
+  uint16_t numtaps;             /* Number of filter coefficients */
+  uint16_t maxblock;            /* Largest block size accepted */
+  FAR const q15_t *coeffs;      /* Time-reversed coefficients */
+  FAR q15_t *state;             /* numtaps + maxblock - 1 samples */
+};
+
+/* Q31 biquad cascade (direct form I).
+ *
+ * coeffs holds 5 values per stage: {b0, b1, b2, a1, a2}.  As with
+ * CMSIS-DSP the feedback coefficients are stored negated so that every
+ * stage computes
+ *
+ *   y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + a1 * y[n-1] + a2 * y[n-2]
+ *
+ * The sum is shifted left by postshift before saturation which allows
+ * coefficients with magnitude up to 2^postshift.  state must provide
+ * 4 values per stage.
+ */
+
+struct dsp_biquad_q31_s
+{
+  uint8_t nstages;              /* Number of second order stages */
+  uint8_t postshift;            /* Left shift applied to each stage output */
+  FAR const q31_t *coeffs;      /* 5 * nstages coefficients */
+  FAR q31_t *state;             /* 4 * nstages state values */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Conversions.  Results saturate where the destination is narrower. */
+
+void dsp_q15_to_q31(FAR const q15_t *src, FAR q31_t *dst, size_t n);
+void dsp_q31_to_q15(FAR const q31_t *src, FAR q15_t *dst, size_t n);
+#ifdef CONFIG_HAVE_FLOAT
+void dsp_float_to_q15(FAR const float *src, FAR q15_t *dst, size_t n);
+void dsp_q15_to_float(FAR const q15_t *src, FAR float *dst, size_t n);
+#endif
+
+/* Vector arithmetic on Q15 data.  dst may alias either source. */
+
+void dsp_add_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst,
+                 size_t n);
+void dsp_sub_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst,
+                 size_t n);
+void dsp_mult_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst,
+                  size_t n);
+void dsp_scale_q15(FAR const q15_t *src, q15_t scale, int shift,
+                   FAR q15_t *dst, size_t n);
+
+/* Multiply-accumulate: returns sum(a[i] * b[i]) as a Q30 value in 64 bits */
+
+int64_t dsp_dot_q15(FAR const q15_t *a, FAR const q15_t *b, size_t n);
+
+/* FIR filtering */
+
+int  dsp_fir_q15_init(FAR struct dsp_fir_q15_s *fir, uint16_t numtaps,
+                      FAR const q15_t *coeffs, FAR q15_t *state,
+                      uint16_t maxblock);
+void dsp_fir_q15(FAR struct dsp_fir_q15_s *fir, FAR const q15_t *src,
+                 FAR q15_t *dst, size_t n);
+
+/* IIR filtering */
+
+int  dsp_biquad_q31_init(FAR struct dsp_biquad_q31_s *iir, uint8_t nstages,
+                         FAR const q31_t *coeffs, FAR q31_t *state,
+                         uint8_t postshift);
+void dsp_biquad_q31(FAR struct dsp_biquad_q31_s *iir, FAR const q31_t *src,
+                    FAR q31_t *dst, size_t n);
+
+/* In-place complex FFT on n interleaved {re, im} Q15 pairs.  n must be a
+ * power of two no larger than DSP_CFFT_MAXLEN.  Every stage scales by 1/2
+ * to avoid overflow, so the forward result is scaled by 1/n.
+ */
+
+int  dsp_cfft_q15(FAR q15_t *data, size_t n, bool inverse);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LIBC_DSP */
+#endif /* __INCLUDE_DSP_H */
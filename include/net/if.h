@@ -58,6 +58,7 @@
 #define IFF_UP             (1 << 1) /* Interface is up */
 #define IFF_RUNNING        (1 << 2) /* Carrier is available */
 #define IFF_IPv6           (1 << 3) /* Configured for IPv6 packet (vs ARP or IPv4) */
+#define IFF_CSUMOK         (1 << 4) /* Hardware verified checksums of this packet */
 #define IFF_NOARP          (1 << 7) /* ARP is not required for this packet */
 
 /* Interface flag helpers */
@@ -66,16 +67,19 @@
 #define IFF_SET_UP(f)      do { (f) |= IFF_UP; } while (0)
 #define IFF_SET_RUNNING(f) do { (f) |= IFF_RUNNING; } while (0)
 #define IFF_SET_NOARP(f)   do { (f) |= IFF_NOARP; } while (0)
+#define IFF_SET_CSUMOK(f)  do { (f) |= IFF_CSUMOK; } while (0)
 
 #define IFF_CLR_DOWN(f)    do { (f) &= ~IFF_DOWN; } while (0)
 #define IFF_CLR_UP(f)      do { (f) &= ~IFF_UP; } while (0)
 #define IFF_CLR_RUNNING(f) do { (f) &= ~IFF_RUNNING; } while (0)
 #define IFF_CLR_NOARP(f)   do { (f) &= ~IFF_NOARP; } while (0)
+#define IFF_CLR_CSUMOK(f)  do { (f) &= ~IFF_CSUMOK; } while (0)
 
 #define IFF_IS_DOWN(f)     (((f) & IFF_DOWN) != 0)
 #define IFF_IS_UP(f)       (((f) & IFF_UP) != 0)
 #define IFF_IS_RUNNING(f)  (((f) & IFF_RUNNING) != 0)
 #define IFF_IS_NOARP(f)    (((f) & IFF_NOARP) != 0)
+#define IFF_IS_CSUMOK(f)   (((f) & IFF_CSUMOK) != 0)
 
 /* We only need to manage the IPv6 bit if both IPv6 and IPv4 are supported.  Otherwise,
  * we can save a few bytes by ignoring it.
@@ -209,6 +213,7 @@ struct ifreq
     uint8_t                   ifru_flags;               /* Interface flags */
     struct mii_iotcl_notify_s ifru_mii_notify;          /* PHY event notification */
     struct mii_ioctl_data_s   ifru_mii_data;            /* MII request data */
+    FAR void                 *ifru_data;                /* Command-specific data */
   } ifr_ifru;
 };
 
@@ -220,6 +225,7 @@ struct ifreq
 #define ifr_mtu               ifr_ifru.ifru_mtu         /* MTU */
 #define ifr_count             ifr_ifru.ifru_count       /* Number of devices */
 #define ifr_flags             ifr_ifru.ifru_flags       /* interface flags */
+#define ifr_data              ifr_ifru.ifru_data        /* Command-specific data */
 #define ifr_mii_notify_pid    ifr_ifru.ifru_mii_notify.pid   /* PID to be notified */
 #define ifr_mii_notify_signo  ifr_ifru.ifru_mii_notify.signo /* Signal to notify with */
 #define ifr_mii_notify_arg    ifr_ifru.ifru_mii_notify.arg   /* sigval argument */
@@ -52,6 +52,21 @@
 
 #define TCP_NODELAY  __SO_PROTOCOL /* Avoid coalescing of small segments. */
 
+/* Non-standard options.  TCP_CONGESTION gets or sets the congestion control
+ * algorithm of the socket by name (e.g., "reno" or "cubic"); it is available
+ * only with CONFIG_NET_TCP_CC.
+ */
+
+#define TCP_CONGESTION   (__SO_PROTOCOL + 1)
+#define TCP_CA_NAME_MAX  16        /* Maximum length of the algorithm name */
+
+/* Non-standard option.  While TCP_CORK is set, data is sent only in full
+ * sized segments; clearing it sends any partial segment that was held.
+ * TCP_NODELAY and TCP_CORK are available only with CONFIG_NET_TCP_NAGLE.
+ */
+
+#define TCP_CORK         (__SO_PROTOCOL + 2)
+
 /* "The macro shall be defined in the header. The implementation need not
  *  allow the value of the option to be set via setsockopt() or retrieved via
  *  getsockopt()."  -- OpenGroup.org
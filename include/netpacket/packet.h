@@ -47,6 +47,49 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options (see setsockopt() and getsockopt()) */
+
+#define SOL_PACKET            263 /* Protocol level of packet socket options */
+
+#define PACKET_RX_RING        5   /* Set up the RX ring.  arg: struct
+                                   * tpacket_req (set).  Returns the address
+                                   * of the ring as a FAR void * (get) */
+#define PACKET_STATISTICS     6   /* Read and reset the ring counters.
+                                   * arg: struct tpacket_stats (get) */
+#define PACKET_TX_RING        13  /* Set up the TX ring.  Same as
+                                   * PACKET_RX_RING */
+
+/* NuttX has no mmap() for socket descriptors.  Instead, getsockopt() of
+ * PACKET_RX_RING or PACKET_TX_RING returns the address of the ring, which
+ * is allocated from the user heap.
+ */
+
+/* Values of tp_status in RX ring frames */
+
+#define TP_STATUS_KERNEL       0  /* Frame is owned by the kernel */
+#define TP_STATUS_USER         1  /* Frame holds a packet for user space */
+#define TP_STATUS_LOSING       4  /* Frames were dropped before this one */
+
+/* Values of tp_status in TX ring frames */
+
+#define TP_STATUS_AVAILABLE    0  /* Frame may be filled by user space */
+#define TP_STATUS_SEND_REQUEST 1  /* Frame holds a packet to be sent */
+#define TP_STATUS_SENDING      2  /* Frame is being sent */
+#define TP_STATUS_WRONG_FORMAT 4  /* Frame could not be sent */
+
+/* Ring frame layout.  Each frame begins with a struct tpacket_hdr and the
+ * packet data follows at offset TPACKET_HDRLEN (RX: at tp_mac).
+ */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x) \
+  (((x) + TPACKET_ALIGNMENT - 1) & ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN         TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,4 +101,38 @@ struct sockaddr_ll
   int16_t  sll_ifindex;
 };
 
+/* The header at the beginning of each ring frame */
+
+struct tpacket_hdr
+{
+  volatile uint32_t tp_status;  /* TP_STATUS_* ownership of the frame */
+  uint32_t tp_len;              /* Length of the packet on the wire */
+  uint32_t tp_snaplen;          /* Length of the packet in the frame */
+  uint16_t tp_mac;              /* Offset of the link layer header */
+  uint16_t tp_net;              /* Offset of the network layer header */
+  uint32_t tp_sec;              /* Time of reception (seconds) */
+  uint32_t tp_usec;             /* Time of reception (microseconds) */
+};
+
+/* Ring geometry passed with PACKET_RX_RING and PACKET_TX_RING.  The ring is
+ * tp_block_nr blocks of tp_block_size bytes, each holding a whole number of
+ * frames of tp_frame_size bytes.  A tp_frame_nr of zero releases the ring.
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;   /* Size of each block */
+  unsigned int tp_block_nr;     /* Number of blocks */
+  unsigned int tp_frame_size;   /* Size of each frame */
+  unsigned int tp_frame_nr;     /* Total number of frames */
+};
+
+/* Counters returned (and reset) by PACKET_STATISTICS */
+
+struct tpacket_stats
+{
+  unsigned int tp_packets;      /* Packets received into the ring */
+  unsigned int tp_drops;        /* Packets dropped because it was full */
+};
+
 #endif  /* __INCLUDE_NETPACKET_PACKET_H */
@@ -77,6 +77,25 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#ifdef CONFIG_ADC_STREAM
+#  if !defined(CONFIG_ADC_STREAM_NBUFFERS)
+#    define CONFIG_ADC_STREAM_NBUFFERS 4
+#  elif CONFIG_ADC_STREAM_NBUFFERS > 255
+#    undef  CONFIG_ADC_STREAM_NBUFFERS
+#    define CONFIG_ADC_STREAM_NBUFFERS 255
+#  endif
+#  if !defined(CONFIG_ADC_STREAM_BUFSIZE)
+#    define CONFIG_ADC_STREAM_BUFSIZE 512
+#  endif
+
+/* The size of one stream block: the header plus the sample data, rounded up
+ * so that consecutive blocks are aligned.
+ */
+
+#  define ADC_STREAM_BLOCKSIZE \
+     ((sizeof(struct adc_block_s) + CONFIG_ADC_STREAM_BUFSIZE + 7) & ~7)
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -104,6 +123,29 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_STREAM
+  /* This method is called from the lower half, typically from its DMA half-
+   * and full-transfer interrupts, with a whole buffer of converted data.  The
+   * upper half copies the buffer into one stream block and wakes the reader
+   * once per block.  The format of the data is that of the lower half (for
+   * example, one uint16_t per conversion in scan order).
+   *
+   * Input Parameters:
+   *   dev    - The ADC device structure that was previously registered by
+   *            adc_register()
+   *   data   - The converted data
+   *   nbytes - The size of the data in bytes; at most
+   *            CONFIG_ADC_STREAM_BUFSIZE are kept
+   *
+   * Returned Value:
+   *   Zero on success; -ENOMEM if the block was dropped because the reader
+   *   has not released the older blocks.
+   */
+
+  CODE int (*au_receive_block)(FAR struct adc_dev_s *dev,
+                               FAR const void *data, size_t nbytes);
+#endif
 };
 
 /* This describes on ADC message */
@@ -114,6 +156,30 @@ begin_packed_struct struct adc_msg_s
   int32_t      am_data;                  /* ADC convert result (4 bytes) */
 } end_packed_struct;
 
+#ifdef CONFIG_ADC_STREAM
+/* This is the header of one stream block.  It is followed by ab_nbytes of
+ * converted data.  read() returns whole blocks of ADC_STREAM_BLOCKSIZE
+ * bytes; ANIOC_STREAM_GET returns a pointer to the oldest block in place.
+ */
+
+struct adc_block_s
+{
+  uint64_t     ab_timestamp;             /* Time the block was received (usec) */
+  uint32_t     ab_sequence;              /* Increments per block, dropped ones too */
+  uint32_t     ab_nbytes;                /* Number of bytes of data that follow */
+};
+
+/* This describes the ring of stream blocks */
+
+struct adc_stream_s
+{
+  uint8_t      as_head;                  /* Index of the oldest filled block */
+  uint8_t      as_count;                 /* Number of filled blocks */
+  uint32_t     as_sequence;              /* Sequence number of the next block */
+  FAR uint8_t *as_blocks;                /* CONFIG_ADC_STREAM_NBUFFERS blocks */
+};
+#endif
+
 /* This describes a FIFO of ADC messages */
 
 struct adc_fifo_s
@@ -188,6 +254,10 @@ struct adc_dev_s
   sem_t                       ad_closesem;   /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+  uint32_t                    ad_overruns;   /* Samples/blocks dropped: FIFO full */
+#ifdef CONFIG_ADC_STREAM
+  struct adc_stream_s         ad_stream;     /* Describes the stream blocks */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -65,8 +65,25 @@
                                            * IN: Threshold value
                                            * OUT: None */
 
+/* ADC upper half */
+
+#define ANIOC_GET_OVERRUNS _ANIOC(0x0004) /* Get and reset the number of
+                                           * samples or stream blocks
+                                           * dropped because the reader
+                                           * was too slow
+                                           * IN: uint32_t* pointer
+                                           * OUT: Count */
+#define ANIOC_STREAM_GET  _ANIOC(0x0005)  /* Wait for the oldest stream
+                                           * block and return it in place
+                                           * IN: FAR struct adc_block_s**
+                                           * OUT: Block pointer */
+#define ANIOC_STREAM_RELEASE _ANIOC(0x0006) /* Release the block returned
+                                           * by ANIOC_STREAM_GET
+                                           * IN: None
+                                           * OUT: None */
+
 #define AN_FIRST           0x0001         /* First common command */
-#define AN_NCMDS           3              /* Number of common commands */
+#define AN_NCMDS           6              /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half QE driver to the lower-half QE driver via the ioctl()
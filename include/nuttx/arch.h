@@ -1404,6 +1404,70 @@ void up_disable_irq(int irq);
 int up_prioritize_irq(int irq, int priority);
 #endif
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Restrict the set of CPUs to which an IRQ may be delivered.  The IRQ
+ *   will be routed to those CPUs in 'cpuset' that it is currently routed
+ *   to or, if there are none, to the lowest numbered CPU in 'cpuset'.
+ *
+ *   Since this API is not supported on all architectures, it should be
+ *   avoided in common implementations where possible.
+ *
+ * Input Parameters:
+ *   irq    - The interrupt request to modify.
+ *   cpuset - The set of CPUs that may receive the IRQ.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_ARCH_HAVE_IRQAFFINITY)
+int up_affinity_irq(int irq, cpu_set_t cpuset);
+#endif
+
+/****************************************************************************
+ * Name: up_cyclecount
+ *
+ * Description:
+ *   Return the current value of a free-running, 32-bit CPU cycle counter.
+ *   Only differences between two values are meaningful; the counter is
+ *   expected to wrap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+uint32_t up_cyclecount(void);
+#endif
+
+/****************************************************************************
+ * Name: up_cyclefreq
+ *
+ * Description:
+ *   Return the frequency of the up_cyclecount() counter in Hz.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+uint32_t up_cyclefreq(void);
+#endif
+
+/****************************************************************************
+ * Name: up_irq_entrycycles
+ *
+ * Description:
+ *   Return the up_cyclecount() value that was captured by the exception
+ *   entry logic for the interrupt that is currently being dispatched.
+ *   This is used to measure the interrupt entry latency.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_IRQTIMESTAMP
+uint32_t up_irq_entrycycles(void);
+#endif
+
 /****************************************************************************
  * Tickless OS Support.
  *
@@ -1937,6 +2001,27 @@ int up_cpu_paused(int cpu);
 int up_cpu_resume(int cpu);
 #endif
 
+/****************************************************************************
+ * Name: up_cpu_call
+ *
+ * Description:
+ *   Raise the inter-CPU call interrupt on 'cpu'.  The interrupt handler on
+ *   that CPU must call sched_smp_call_handler() in order to execute the
+ *   requests queued by sched_smp_call().  Unlike up_cpu_pause(), this
+ *   function does not wait for the target CPU to respond.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU to be interrupted.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int up_cpu_call(int cpu);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
@@ -104,6 +104,21 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSETUP - Allocate a ring of audio pipeline buffers that the
+ *   application accesses in place with mmap() (CONFIG_AUDIO_RING).
+ *
+ *   ioctl argument:  Pointer to the audio_ringsetup_s structure.
+ *
+ * AUDIOIOC_RINGRELEASE - Free the ring.  Streaming must be stopped.
+ *
+ *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSYNC - Hand the periods committed by the application to the
+ *   lower half.  This is done automatically as periods complete, so it is
+ *   only needed to prime the ring or to restart it after an underrun.
+ *
+ *   ioctl argument:  None
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -122,6 +137,9 @@
 #define AUDIOIOC_REGISTERMQ         _AUDIOIOC(14)
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
+#define AUDIOIOC_RINGSETUP          _AUDIOIOC(17)
+#define AUDIOIOC_RINGRELEASE        _AUDIOIOC(18)
+#define AUDIOIOC_RINGSYNC           _AUDIOIOC(19)
 
 /* Audio Device Types *******************************************************/
 /* The NuttX audio interface support different types of audio devices for
@@ -294,6 +312,18 @@
 #define AUDIO_APB_OUTPUT_PROCESS    (1 << 1)
 #define AUDIO_APB_DEQUEUED          (1 << 2)
 #define AUDIO_APB_FINAL             (1 << 3) /* Last buffer in the stream */
+#define AUDIO_APB_RING              (1 << 4) /* Buffer belongs to the ring */
+
+/* Audio ring directions */
+
+#define AUDIO_RING_PLAYBACK         0
+#define AUDIO_RING_CAPTURE          1
+
+/* Access the period buffer 'n' of an audio ring */
+
+#define AUDIO_RING_APB(r,n) \
+  ((FAR struct ap_buffer_s *)((FAR uint8_t *)(r) + (r)->offset + \
+                              (uint32_t)(n) * (r)->stride))
 
 /****************************************************************************
  * Public Types
@@ -431,6 +461,55 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Argument of the AUDIOIOC_RINGSETUP ioctl */
+
+struct audio_ringsetup_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  uint8_t             direction;          /* AUDIO_RING_PLAYBACK/CAPTURE */
+  uint16_t            nperiods;           /* Number of periods in the ring */
+  apb_samp_t          periodsize;         /* Bytes in each period */
+  uint32_t            size;               /* Returned: Bytes to mmap() */
+};
+
+/* The header of an audio ring.  The ring is a single allocation holding
+ * this header followed by 'nperiods' audio pipeline buffers that are
+ * 'stride' bytes apart.  It is returned by mmap() on the audio device so
+ * that the application fills (playback) or drains (capture) the period
+ * buffers in place and the same buffers are handed to the lower half.
+ *
+ * 'appl' and 'hw' are free-running period counts:
+ *
+ *   Playback:  The application fills period (appl % nperiods) and then
+ *              increments appl.  It may run ahead of the hardware by at
+ *              most nperiods periods, i.e. until appl - hw == nperiods.
+ *   Capture:   Periods appl .. hw - 1 hold captured data.  The
+ *              application reads period (appl % nperiods), using the
+ *              buffer's nbytes, and then increments appl to give the
+ *              period back to the lower half.
+ *
+ * The upper half increments hw as each period is returned by the lower
+ * half and wakes up poll() waiters: POLLOUT for playback when a period is
+ * free, POLLIN for capture when a period is full.
+ */
+
+struct audio_ring_s
+{
+  uint32_t            size;               /* Total size of the ring */
+  uint32_t            offset;             /* Offset to the first period */
+  uint32_t            stride;             /* Bytes from one period to the next */
+  uint16_t            nperiods;           /* Number of periods */
+  uint8_t             direction;          /* AUDIO_RING_PLAYBACK/CAPTURE */
+  uint8_t             reserved;
+  apb_samp_t          periodsize;         /* Bytes of samples in each period */
+  volatile uint32_t   appl;               /* Periods filled/drained by the application */
+  volatile uint32_t   hw;                 /* Periods completed by the lower half */
+  volatile uint32_t   queued;             /* Periods handed to the lower half */
+  volatile uint32_t   xruns;              /* Underruns (playback) or overruns (capture) */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
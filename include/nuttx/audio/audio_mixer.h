@@ -0,0 +1,127 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/audio/audio.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************
+ *
+ * CONFIG_AUDIO_MIXER - Enables the software audio mixer
+ * CONFIG_AUDIO_MIXER_NSTREAMS - Number of streams mixed into one device
+ * CONFIG_AUDIO_MIXER_SAMPLERATE - Sample rate of the mixed output
+ * CONFIG_AUDIO_MIXER_NBUFFERS - Number of output buffers
+ * CONFIG_AUDIO_MIXER_BUFSIZE - Size in bytes of each output buffer
+ * CONFIG_AUDIO_MIXER_SRC - Convert streams with other sample rates
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct audio_mixer_s; /* Opaque mixer state */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a mixer in front of a low-level audio output device.  The mixer
+ *   provides CONFIG_AUDIO_MIXER_NSTREAMS stream devices, each of which may
+ *   be registered with audio_register() (optionally behind
+ *   pcm_decode_initialize()) and used by a different application.  The
+ *   streams are converted to 16-bit stereo at CONFIG_AUDIO_MIXER_SAMPLERATE,
+ *   scaled by their own volume and mixed with saturation into the buffers
+ *   of the contained device.
+ *
+ * Input Parameters:
+ *   dev - A reference to the low-level audio DAC-type device to contain.
+ *
+ * Returned Value:
+ *   The new mixer on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct audio_mixer_s *
+  audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Name: audio_mixer_stream
+ *
+ * Description:
+ *   Return the lower half of one stream of the mixer.
+ *
+ * Input Parameters:
+ *   mixer  - The mixer returned by audio_mixer_initialize()
+ *   stream - The stream index, 0 .. CONFIG_AUDIO_MIXER_NSTREAMS-1
+ *
+ * Returned Value:
+ *   The stream lower half; NULL if 'stream' is out of range.
+ *
+ ****************************************************************************/
+
+FAR struct audio_lowerhalf_s *
+  audio_mixer_stream(FAR struct audio_mixer_s *mixer, int stream);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
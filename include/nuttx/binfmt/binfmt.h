@@ -81,6 +81,7 @@ typedef FAR void (*binfmt_dtor_t)(void);
  */
 
 struct symtab_s;
+struct binfmt_cache_s;
 struct binary_s
 {
   /* If CONFIG_SCHED_HAVE_PARENT is defined then schedul_unload() will
@@ -136,6 +137,16 @@ struct binary_s
 
   size_t mapsize;                      /* Size of the mapped address region (needed for munmap) */
 
+  /* Image cache.  A binary format that can run a loaded image again after
+   * restoring its writable data region reports that region here.
+   */
+
+#ifdef CONFIG_BINFMT_CACHE
+  FAR void *datastart;                 /* Writable data region (.data and .bss) */
+  size_t datasize;                     /* Size of the writable data region */
+  FAR struct binfmt_cache_s *cache;    /* Cache entry owning the image */
+#endif
+
   /* Start-up information that is provided by the loader, but may be modified
    * by the caller between load_module() and exec_module() calls.
    */
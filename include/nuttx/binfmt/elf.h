@@ -114,6 +114,19 @@ struct elf_loadinfo_s
   FAR Elf32_Shdr    *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
 
+  /* Execute-in-place.
+   *
+   * xipbase  - The address of the memory-mapped ELF file if the file lies
+   *   on a file system that supports FIOC_MMAP; zero otherwise.
+   * textbase - The address of the first .text section, either in the
+   *   memory-mapped file or in textalloc.
+   */
+
+#ifdef CONFIG_ELF_XIP
+  uintptr_t          xipbase;    /* Address of the memory-mapped ELF file */
+  uintptr_t          textbase;   /* Address of the first .text section */
+#endif
+
   /* Constructors and destructors */
 
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
@@ -44,6 +44,7 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <sys/time.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
@@ -84,6 +85,8 @@
  *   support is needed for this feature.
  * CONFIG_CAN_TXREADY_HIPRI or CONFIG_CAN_TXREADY_LOPRI - Selects which work queue
  *   will be used for the can_txready() processing.
+ * CONFIG_CAN_TIMESTAMP - Add a receive timestamp (ch_ts) to the CAN message
+ *   header.
  */
 
 /* Default configuration settings that may be overridden in the NuttX configuration
@@ -404,6 +407,10 @@
  * A more detailed report of certain errors then follows in message payload.
  * CONFIG_CAN_ERRORS=y is required in order to receive error reports.
  *
+ * If CONFIG_CAN_TIMESTAMP=y, the header is followed by a struct timeval holding
+ * the time at which the message was received.  The timestamp is ignored on
+ * transmission.
+ *
  * The struct can_msg_s holds this information in a user-friendly, unpacked form.
  * This is the form that is used at the read() and write() driver interfaces.  The
  * message structure is actually variable length -- the true length is given by
@@ -421,6 +428,9 @@ begin_packed_struct struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time the message was received */
+#endif
 } end_packed_struct;
 #else
 begin_packed_struct struct can_hdr_s
@@ -432,6 +442,9 @@ begin_packed_struct struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time the message was received */
+#endif
 } end_packed_struct;
 #endif
 
@@ -220,6 +220,34 @@ typedef int64_t ssystime_t;
 typedef int32_t ssystime_t;
 #endif
 
+/* This is the form of the time page that the kernel updates on each system
+ * timer tick in the protected build.  The time page resides in user memory
+ * (see struct userspace_s) so that user space can read the time without a
+ * system call.  The kernel never reads the time page.
+ *
+ * The sequence count is odd while an update is in progress.  A reader must
+ * retry if the count is odd or if it changed while the page was read.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+/* Writer and readers of the time page order their accesses with this
+ * barrier.  The protected build is uniprocessor so a reader can race only
+ * with the timer interrupt on the same CPU and a compiler barrier suffices.
+ */
+
+#define CLOCK_TIMEPAGE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+struct clock_timepage_s
+{
+  volatile uint32_t  tp_seq;        /* Update sequence count */
+  volatile systime_t tp_systimer;   /* clock_systimer() */
+  volatile time_t    tp_monosec;    /* CLOCK_MONOTONIC seconds */
+  volatile long      tp_mononsec;   /* CLOCK_MONOTONIC nanoseconds */
+  volatile time_t    tp_realsec;    /* CLOCK_REALTIME seconds */
+  volatile long      tp_realnsec;   /* CLOCK_REALTIME nanoseconds */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -247,6 +275,12 @@ EXTERN volatile systime_t g_system_timer;
 #endif
 #endif
 
+/* The user-space instance of the time page (see libc/time/lib_timepage.c) */
+
+#if defined(CONFIG_CLOCK_TIMEPAGE) && !defined(__KERNEL__)
+EXTERN struct clock_timepage_s g_timepage;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -382,6 +416,27 @@ int clock_systimespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cputime
+ *
+ * Description:
+ *   Return the accumulated execution time of the select PID.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE thread.
+ *   tp  - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+int clock_cputime(int pid, FAR struct timespec *tp);
+#endif
+
 /****************************************************************************
  * Name:  sched_oneshot_extclk
  *
@@ -42,13 +42,39 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_BLOCKSIZE      16
+#define AES_MAXROUNDS      14
+
+#define AES_GCM_IVSIZE     12
+#define AES_GCM_TAGSIZE    16
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The expanded key schedules of one key.  A context is set up once by
+ * aes_keyexpand() and may then be used for any number of blocks.
+ */
+
+struct aes_context_s
+{
+  uint32_t ek[4 * (AES_MAXROUNDS + 1)]; /* Encryption round keys */
+  uint32_t dk[4 * (AES_MAXROUNDS + 1)]; /* Decryption round keys */
+  int nrounds;                          /* 10, 12 or 14 */
+};
 
 /****************************************************************************
  * Public Data
@@ -61,7 +87,96 @@ extern "C"
 
 /****************************************************************************
  * Public Function Prototypes
+ ****************************************************************************/
+
 /****************************************************************************
+ * Name: aes_keyexpand
+ *
+ * Description:
+ *   Expand an AES key into the encryption and decryption key schedules of
+ *   'ctx'.
+ *
+ * Input Parameters:
+ *   ctx     - The context to initialize
+ *   key     - The key
+ *   keysize - The size of the key in bytes: 16, 24 or 32
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the key size is not supported.
+ *
+ ****************************************************************************/
+
+int aes_keyexpand(FAR struct aes_context_s *ctx, FAR const uint8_t *key,
+                  uint32_t keysize);
+
+/****************************************************************************
+ * Name: aes_blockencrypt and aes_blockdecrypt
+ *
+ * Description:
+ *   Encrypt or decrypt one 16 byte block with the key schedule in 'ctx'.
+ *   'in' and 'out' may be the same buffer and need not be aligned.
+ *
+ ****************************************************************************/
+
+void aes_blockencrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                      FAR const uint8_t *in);
+void aes_blockdecrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                      FAR const uint8_t *in);
+
+/****************************************************************************
+ * Name: aes_ecb, aes_cbc and aes_ctr
+ *
+ * Description:
+ *   Process a buffer of 'size' bytes in ECB, CBC or CTR mode.  The
+ *   operation may be performed in place.
+ *
+ *   ECB and CBC require 'size' to be a multiple of AES_BLOCKSIZE.  On
+ *   return from aes_cbc(), 'iv' holds the chaining value for the next
+ *   buffer of the same stream.  CTR accepts any size; 'ctr' is the 16 byte
+ *   counter block, which is incremented once per (partial) block.
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if 'size' is not valid for the mode.
+ *
+ ****************************************************************************/
+
+int aes_ecb(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+            FAR const uint8_t *in, size_t size, bool encrypt);
+int aes_cbc(FAR const struct aes_context_s *ctx, FAR uint8_t *iv,
+            FAR uint8_t *out, FAR const uint8_t *in, size_t size,
+            bool encrypt);
+int aes_ctr(FAR const struct aes_context_s *ctx, FAR uint8_t *ctr,
+            FAR uint8_t *out, FAR const uint8_t *in, size_t size);
+
+/****************************************************************************
+ * Name: aes_gcm
+ *
+ * Description:
+ *   Authenticated encryption or decryption in GCM mode.
+ *
+ * Input Parameters:
+ *   ctx     - The key schedule
+ *   iv      - The AES_GCM_IVSIZE byte initialization vector
+ *   aad     - Additional data that is authenticated but not encrypted
+ *   aadsize - The size of 'aad' in bytes
+ *   out     - The output buffer of 'size' bytes
+ *   in      - The input buffer of 'size' bytes
+ *   size    - The size of the plain/cipher text
+ *   tag     - The AES_GCM_TAGSIZE byte tag.  Returned when encrypting;
+ *             checked when decrypting
+ *   encrypt - true: Encrypt; false: decrypt
+ *
+ * Returned Value:
+ *   OK on success; -EBADMSG if the tag did not match when decrypting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_AES_GCM
+int aes_gcm(FAR const struct aes_context_s *ctx, FAR const uint8_t *iv,
+            FAR const uint8_t *aad, size_t aadsize, FAR uint8_t *out,
+            FAR const uint8_t *in, size_t size, FAR uint8_t *tag,
+            bool encrypt);
+#endif
 
 /****************************************************************************
  * Name: aes_encrypt
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -53,7 +55,7 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
-#define CRYPTO_ALGORITHM_MAX    1
+#define CRYPTO_ALGORITHM_MAX    3
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
 #define CRYPTO_FLAG_SOFTWARE    0x02000000 /* software implementation */
@@ -65,9 +67,16 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCCRYPTM              104 /* Batch of CIOCCRYPT operations */
 
 typedef char* caddr_t;
 
+/* CIOCGSESSION:  The key is copied when the session is created, so the
+ * structure and the key need not persist.  The session ID returned in ses
+ * is passed in crypt_op and, by reference, to CIOCFSESSION.  Sessions are
+ * released when the file is closed.
+ */
+
 struct session_op
 {
   uint32_t cipher;    /* ie. CRYPTO_AES_EBC */
@@ -81,6 +90,10 @@ struct session_op
   uint32_t ses;       /* returns: session # */
 };
 
+/* CIOCCRYPT:  src and dst are processed in place without intermediate
+ * copies and may refer to the same buffer.  The iv is not modified.
+ */
+
 struct crypt_op
 {
   uint32_t ses;
@@ -92,4 +105,15 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* CIOCCRYPTM:  Submit several operations with one call.  Processing stops
+ * at the first failure; on return, count holds the number of operations
+ * that completed.
+ */
+
+struct crypt_mop
+{
+  unsigned count;             /* Number of requests in reqs[] */
+  FAR struct crypt_op *reqs;  /* The requests */
+};
+
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
@@ -0,0 +1,152 @@
+/****************************************************************************
+ * include/nuttx/crypto/sha256.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRYPTO_SHA256_H
+#define __INCLUDE_NUTTX_CRYPTO_SHA256_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHA256_BLOCKSIZE   64
+#define SHA256_DIGESTSIZE  32
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The state of one SHA-256 computation.  Architectures that provide a hash
+ * peripheral (CONFIG_ARCH_HAVE_SHA256) may keep their own state in 'priv'.
+ */
+
+struct sha256_ctx_s
+{
+  uint32_t state[8];                   /* Intermediate hash value */
+  uint64_t count;                      /* Number of bytes processed */
+  uint8_t buffer[SHA256_BLOCKSIZE];    /* Partial block */
+#ifdef CONFIG_ARCH_HAVE_SHA256
+  FAR void *priv;                      /* Hardware state */
+#endif
+};
+
+/* The state of one HMAC-SHA-256 computation */
+
+struct hmac_sha256_ctx_s
+{
+  struct sha256_ctx_s inner;
+  struct sha256_ctx_s outer;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sha256_init, sha256_update and sha256_final
+ *
+ * Description:
+ *   Compute a SHA-256 digest (FIPS 180-4) incrementally.  sha256_final()
+ *   returns the SHA256_DIGESTSIZE byte digest and clears the context.
+ *
+ *   These are provided by crypto/sha256.c unless the architecture provides
+ *   them with a hash peripheral (CONFIG_ARCH_HAVE_SHA256).
+ *
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_ctx_s *ctx);
+void sha256_update(FAR struct sha256_ctx_s *ctx, FAR const void *data,
+                   size_t size);
+void sha256_final(FAR struct sha256_ctx_s *ctx, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: sha256
+ *
+ * Description:
+ *   Compute the SHA-256 digest of one buffer.
+ *
+ ****************************************************************************/
+
+void sha256(FAR const void *data, size_t size, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: hmac_sha256_init, hmac_sha256_update and hmac_sha256_final
+ *
+ * Description:
+ *   Compute an HMAC-SHA-256 message authentication code (RFC 2104)
+ *   incrementally.  Keys longer than SHA256_BLOCKSIZE are hashed first.
+ *
+ ****************************************************************************/
+
+void hmac_sha256_init(FAR struct hmac_sha256_ctx_s *ctx, FAR const void *key,
+                      size_t keysize);
+void hmac_sha256_update(FAR struct hmac_sha256_ctx_s *ctx,
+                        FAR const void *data, size_t size);
+void hmac_sha256_final(FAR struct hmac_sha256_ctx_s *ctx,
+                       FAR uint8_t *mac);
+
+/****************************************************************************
+ * Name: hmac_sha256
+ *
+ * Description:
+ *   Compute the HMAC-SHA-256 of one buffer.
+ *
+ ****************************************************************************/
+
+void hmac_sha256(FAR const void *key, size_t keysize, FAR const void *data,
+                 size_t size, FAR uint8_t *mac);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CRYPTO_SHA256_H */
@@ -53,6 +53,16 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Number of independently buffered streams */
+
+#ifndef CONFIG_DRVR_WRSLOTS
+#  define CONFIG_DRVR_WRSLOTS 1
+#endif
+
+#ifndef CONFIG_DRVR_RHSLOTS
+#  define CONFIG_DRVR_RHSLOTS 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -67,6 +77,37 @@ typedef ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                               off_t startblock, size_t nblocks);
 
+/* The state of one write buffer slot.  Each slot buffers one sequential
+ * stream of writes.
+ */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+struct rwb_wrslot_s
+{
+  FAR uint8_t  *buffer;          /* Buffered write data */
+  off_t         blockstart;      /* First block in the slot */
+  uint16_t      nblocks;         /* Number of blocks in the slot */
+  uint16_t      lastuse;         /* Write clock at the last write */
+  uint8_t       state;           /* Slot state (see rwbuffer.c) */
+};
+#endif
+
+/* The state of one read-ahead buffer slot.  Each slot follows one
+ * sequential stream of reads.
+ */
+
+#ifdef CONFIG_DRVR_READAHEAD
+struct rwb_rhslot_s
+{
+  FAR uint8_t  *buffer;          /* Read-ahead data */
+  off_t         blockstart;      /* First block in the slot */
+  off_t         nextblock;       /* Block following the last block read */
+  uint16_t      nblocks;         /* Number of blocks in the slot */
+  uint16_t      window;          /* Number of blocks read ahead last time */
+  uint16_t      lastuse;         /* Read clock at the last read */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -106,7 +147,8 @@ struct rwbuffer_s
 
   /* Read-ahead/Write buffer sizes.  Buffering can be disabled (even if it
    * is enabled in the configuration) by setting the buffer size to zero
-   * blocks.
+   * blocks.  These are the sizes of each of the CONFIG_DRVR_WRSLOTS write
+   * slots and each of the CONFIG_DRVR_RHSLOTS read-ahead slots.
    */
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -137,20 +179,21 @@ struct rwbuffer_s
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   sem_t         wrsem;           /* Enforces exclusive access to the write buffer */
+  sem_t         flushsem;        /* Serializes calls to wrflush */
   struct work_s work;            /* Delayed work to flush buffer after a delay with no activity */
-  uint8_t      *wrbuffer;        /* Allocated write buffer */
-  uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
-  off_t         wrexpectedblock; /* Next block expected */
+  struct work_s flushwork;       /* Work to flush full slots in the background */
+  uint8_t      *wrbuffer;        /* Allocated write buffer (all slots) */
+  uint16_t      wrclock;         /* Incremented on each buffered write */
+  struct rwb_wrslot_s wrslot[CONFIG_DRVR_WRSLOTS];
 #endif
 
   /* This is the state of the read-ahead buffering */
 
 #ifdef CONFIG_DRVR_READAHEAD
-  sem_t         rhsem;           /* Enforces exclusive access to the write buffer */
-  uint8_t      *rhbuffer;        /* Allocated read-ahead buffer */
-  uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
-  off_t         rhblockstart;    /* First block in read-ahead buffer */
+  sem_t         rhsem;           /* Enforces exclusive access to the read-ahead buffer */
+  uint8_t      *rhbuffer;        /* Allocated read-ahead buffer (all slots) */
+  uint16_t      rhclock;         /* Incremented on each buffered read */
+  struct rwb_rhslot_s rhslot[CONFIG_DRVR_RHSLOTS];
 #endif
 };
 
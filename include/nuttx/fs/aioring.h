@@ -0,0 +1,251 @@
+/****************************************************************************
+ * include/nuttx/fs/aioring.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_AIORING_H
+#define __INCLUDE_NUTTX_FS_AIORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry opcodes */
+
+#define AIORING_OP_NOP       0  /* No operation, completes immediately */
+#define AIORING_OP_READ      1  /* Positional read (pread) */
+#define AIORING_OP_WRITE     2  /* Positional write (pwrite) */
+#define AIORING_OP_FSYNC     3  /* Flush file data (fsync) */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One submission queue entry.  The caller obtains an entry with
+ * aioring_get_sqe(), fills it in, and then passes any number of filled
+ * entries to the engine with one call to aioring_submit().
+ */
+
+struct aioring_sqe_s
+{
+  uint8_t   opcode;                  /* See AIORING_OP_* definitions */
+  int       fd;                      /* File descriptor */
+  FAR void *buf;                     /* I/O buffer */
+  size_t    nbytes;                  /* Size of the transfer */
+  off_t     offset;                  /* File offset of the transfer */
+  uintptr_t user_data;               /* Returned unmodified in the CQE */
+};
+
+/* One completion queue entry */
+
+struct aioring_cqe_s
+{
+  uintptr_t user_data;               /* user_data of the submission */
+  ssize_t   result;                  /* Bytes transferred or negated errno */
+};
+
+/* One request in flight.  This is the form in which a request is passed to
+ * the aio method of a driver or file system.  The driver owns the request
+ * until it calls aioring_complete().
+ */
+
+struct file;
+struct aioring_s;
+
+struct aioring_req_s
+{
+  sq_entry_t link;                   /* Used by the engine and the driver */
+  FAR struct aioring_s *ring;        /* The ring that the request belongs to */
+  FAR struct file *filep;            /* The open file */
+  uint8_t   opcode;                  /* See AIORING_OP_* definitions */
+  FAR void *buf;                     /* I/O buffer */
+  size_t    nbytes;                  /* Size of the transfer */
+  off_t     offset;                  /* File offset of the transfer */
+  uintptr_t user_data;               /* Returned unmodified in the CQE */
+};
+
+/* The state of one submission/completion ring pair.  The SQ and the CQ
+ * each hold the same, power-of-two number of entries.  A ring may be used
+ * by only one submitting thread at a time.
+ */
+
+struct aioring_s
+{
+  uint32_t mask;                     /* Number of entries minus one */
+  uint32_t sq_head;                  /* Next SQE to be submitted */
+  uint32_t sq_tail;                  /* Next SQE to be handed to the caller */
+  volatile uint32_t cq_head;         /* Next CQE to be consumed */
+  volatile uint32_t cq_tail;         /* Next CQE to be posted */
+  uint32_t outstanding;              /* Submitted requests whose CQE has
+                                      * not yet been seen */
+  bool     waiting;                  /* A thread waits for a completion */
+  bool     workqueued;               /* The fall-back worker is scheduled */
+  FAR struct aioring_sqe_s *sqes;    /* Submission queue */
+  FAR struct aioring_cqe_s *cqes;    /* Completion queue */
+  FAR struct aioring_req_s *reqs;    /* Pre-allocated requests */
+  sq_queue_t freereq;                /* List of free requests */
+  sq_queue_t pending;                /* Requests waiting for the worker */
+  struct work_s work;                /* Fall-back worker */
+  sem_t    cqsem;                    /* Wakes the thread waiting for a CQE */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: aioring_setup
+ *
+ * Description:
+ *   Allocate the queues of a new ring.
+ *
+ * Input Parameters:
+ *   ring    - The ring to be initialized
+ *   entries - The number of entries in each queue.  Rounded up to a power
+ *             of two.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aioring_setup(FAR struct aioring_s *ring, unsigned int entries);
+
+/****************************************************************************
+ * Name: aioring_teardown
+ *
+ * Description:
+ *   Wait for all requests in flight to complete and then release the
+ *   queues of the ring.  Unseen completions are discarded.
+ *
+ ****************************************************************************/
+
+void aioring_teardown(FAR struct aioring_s *ring);
+
+/****************************************************************************
+ * Name: aioring_get_sqe
+ *
+ * Description:
+ *   Return the next free submission queue entry or NULL if the SQ is full.
+ *   The entry is passed to the engine by the next aioring_submit().
+ *
+ ****************************************************************************/
+
+FAR struct aioring_sqe_s *aioring_get_sqe(FAR struct aioring_s *ring);
+
+/****************************************************************************
+ * Name: aioring_submit
+ *
+ * Description:
+ *   Start all of the submission queue entries filled in since the last
+ *   call.  Entries are started in order.  Submission stops early if the
+ *   number of requests whose completion has not yet been seen would exceed
+ *   the size of the CQ; the remaining entries stay in the SQ for the next
+ *   call.
+ *
+ * Returned Value:
+ *   The number of entries submitted.  Errors such as a bad file descriptor
+ *   are reported in the CQE of the request, not here.
+ *
+ ****************************************************************************/
+
+int aioring_submit(FAR struct aioring_s *ring);
+
+/****************************************************************************
+ * Name: aioring_peek_cqe, aioring_wait_cqe, and aioring_cqe_seen
+ *
+ * Description:
+ *   aioring_peek_cqe() returns the oldest unseen completion or NULL if
+ *   there is none.  aioring_wait_cqe() waits for a completion if there is
+ *   none.  The entry remains valid until released with aioring_cqe_seen().
+ *
+ * Returned Value:
+ *   aioring_wait_cqe() returns zero (OK) on success or a negated errno
+ *   value if the wait was interrupted or if nothing is outstanding.
+ *
+ ****************************************************************************/
+
+FAR struct aioring_cqe_s *aioring_peek_cqe(FAR struct aioring_s *ring);
+int aioring_wait_cqe(FAR struct aioring_s *ring,
+                     FAR struct aioring_cqe_s **cqe);
+void aioring_cqe_seen(FAR struct aioring_s *ring,
+                      FAR struct aioring_cqe_s *cqe);
+
+/****************************************************************************
+ * Name: aioring_complete
+ *
+ * Description:
+ *   Post the completion of a request.  Called by the driver or file system
+ *   that accepted the request in its aio method, possibly from an interrupt
+ *   handler.  The request must not be accessed after this call.
+ *
+ * Input Parameters:
+ *   req    - The completed request
+ *   result - The number of bytes transferred or a negated errno value
+ *
+ ****************************************************************************/
+
+void aioring_complete(FAR struct aioring_req_s *req, ssize_t result);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_AIO_RING */
+#endif /* __INCLUDE_NUTTX_FS_AIORING_H */
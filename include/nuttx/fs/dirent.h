@@ -174,6 +174,10 @@ struct fs_unionfsdir_s
   bool fu_prefix[2];                          /* True: Fake directory in prefix */
   FAR char *fu_relpath;                       /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2];        /* dirent struct used by contained file system */
+  FAR char *fu_names;                         /* Names enumerated on file system 1 */
+  size_t fu_nameslen;                         /* Bytes of fu_names in use */
+  size_t fu_namessize;                        /* Bytes allocated for fu_names */
+  bool fu_nameserr;                           /* True: fu_names is incomplete */
 };
 #endif
 
@@ -50,6 +50,10 @@
 #include <stdbool.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_FS_VECTORED_IO
+#  include <sys/uio.h>
+#endif
+
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
 #  include <nuttx/semaphore.h>
 #endif
@@ -119,6 +123,7 @@
 #define   FSNODEFLAG_TYPE_SHM      0x00000006 /*   Shared memory region     */
 #define   FSNODEFLAG_TYPE_SOFTLINK 0x00000007 /*   Soft link                */
 #define FSNODEFLAG_DELETED         0x00000008 /* Unlinked                   */
+#define FSNODEFLAG_RETIRED         0x00000010 /* Waiting to be freed        */
 
 #define INODE_IS_TYPE(i,t) \
   (((i)->i_flags & FSNODEFLAG_TYPE_MASK) == (t))
@@ -193,9 +198,10 @@
  * system.  It is used to call back to perform device specific operations.
  */
 
-struct file;   /* Forward reference */
-struct pollfd; /* Forward reference */
-struct inode;  /* Forward reference */
+struct file;          /* Forward reference */
+struct pollfd;        /* Forward reference */
+struct inode;         /* Forward reference */
+struct aioring_req_s; /* Forward reference */
 
 struct file_operations
 {
@@ -222,6 +228,27 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional vectored I/O.  If not provided, readv() and writev() fall
+   * back to calling the read and write methods once per element.
+   */
+
+#ifdef CONFIG_FS_VECTORED_IO
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+#endif
+
+  /* Optional asynchronous I/O.  Returns OK if the request was started and
+   * aioring_complete() will be called when it finishes; -ENOSYS if the
+   * request should be performed synchronously on a worker thread instead;
+   * or any other negated errno value if the request failed.
+   */
+
+#ifdef CONFIG_FS_AIO_RING
+  int     (*aio)(FAR struct file *filep, FAR struct aioring_req_s *req);
+#endif
 };
 
 /* This structure provides information about the state of a block driver */
@@ -236,6 +263,30 @@ struct geometry
   size_t geo_sectorsize;   /* Size of one sector */
 };
 
+/* Describes a range of sectors to be mapped into directly addressable
+ * memory by the BIOC_MAP ioctl command (see block_map()).
+ */
+
+struct blockmap_s
+{
+  size_t    bm_start;      /* IN:  First sector of the range */
+  size_t    bm_nsectors;   /* IN:  Number of sectors in the range */
+  FAR void *bm_addr;       /* OUT: Address of the first sector */
+  bool      bm_writable;   /* OUT: true: Sectors may be modified in place */
+};
+
+/* Statistics of the shared block buffer cache (see blockcache_attach()) */
+
+#ifdef CONFIG_FS_BLOCKCACHE
+struct blockcache_stats_s
+{
+  uint32_t hits;           /* Sectors read from the cache */
+  uint32_t misses;         /* Sectors read from the driver */
+  uint32_t evictions;      /* Sectors replaced to make room for others */
+  uint32_t writebacks;     /* Dirty sectors written to the driver */
+};
+#endif
+
 /* This structure is provided by block devices when they register with the
  * system.  It is used by file systems to perform filesystem transfers.  It
  * differs from the normal driver vtable in several ways -- most notably in
@@ -333,6 +384,21 @@ struct mountpt_operations
   int     (*stat)(FAR struct inode *mountpt, FAR const char *relpath,
             FAR struct stat *buf);
 
+  /* Optional vectored I/O (see struct file_operations) */
+
+#ifdef CONFIG_FS_VECTORED_IO
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+            int iovcnt);
+#endif
+
+  /* Optional asynchronous I/O (see struct file_operations) */
+
+#ifdef CONFIG_FS_AIO_RING
+  int     (*aio)(FAR struct file *filep, FAR struct aioring_req_s *req);
+#endif
+
   /* NOTE:  More operations will be needed here to support:  disk usage
    * stats file stat(), file attributes, file truncation, etc.
    */
@@ -377,7 +443,11 @@ struct inode
 {
   FAR struct inode *i_peer;     /* Link to same level inode */
   FAR struct inode *i_child;    /* Link to lower level inode */
+#ifdef CONFIG_FS_INODE_LOCKFREE
+  int32_t           i_crefs;    /* References to inode (atomic) */
+#else
   int16_t           i_crefs;    /* References to inode */
+#endif
   uint16_t          i_flags;    /* Flags for inode */
   union inode_ops_u u;          /* Inode operations */
 #ifdef CONFIG_FILE_MODE
@@ -402,13 +472,42 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This defines a list of files indexed by the file descriptor.  A bitmap
+ * of the descriptors in use supports the allocation of the lowest free
+ * descriptor without examining each struct file.  With
+ * CONFIG_FS_FILELIST_DYNAMIC, the struct file instances are allocated in
+ * blocks as descriptors are needed and are accessed with files_fget().
+ */
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
+#define FILELIST_NWORDS  ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+#  define FILELIST_BLKSIZE CONFIG_FS_FILELIST_BLOCKSIZE
+#  define FILELIST_NBLOCKS \
+     ((CONFIG_NFILE_DESCRIPTORS + FILELIST_BLKSIZE - 1) / FILELIST_BLKSIZE)
+#endif
+
+/* Mark a descriptor as in use or free in the bitmap.  A set bit always
+ * means that the descriptor is in use.  A descriptor filled in by
+ * file_dup2() may be in use with its bit clear; files_allocate() detects
+ * and corrects that case.
+ */
+
+#define FILES_SETINUSE(l,fd) \
+  ((l)->fl_inuse[(unsigned int)(fd) >> 5] |= (uint32_t)1 << ((fd) & 31))
+#define FILES_CLRINUSE(l,fd) \
+  ((l)->fl_inuse[(unsigned int)(fd) >> 5] &= ~((uint32_t)1 << ((fd) & 31)))
+
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
+  uint32_t fl_inuse[FILELIST_NWORDS]; /* Bitmap of descriptors in use */
+#ifdef CONFIG_FS_FILELIST_DYNAMIC
+  FAR struct file *fl_blocks[FILELIST_NBLOCKS]; /* Allocated on demand */
+#else
   struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+#endif
 };
 #endif
 
@@ -566,6 +665,46 @@ int unregister_driver(FAR const char *path);
 
 int unregister_blockdriver(FAR const char *path);
 
+/****************************************************************************
+ * Name: blockcache_attach
+ *
+ * Description:
+ *   Route all accesses to the registered block driver at 'path' through
+ *   the shared block buffer cache.  This should be called before the
+ *   driver is opened or mounted.  The driver is detached from the cache
+ *   when it is unregistered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int blockcache_attach(FAR const char *path);
+#endif
+
+/****************************************************************************
+ * Name: blockcache_sync
+ *
+ * Description:
+ *   Write back the dirty sectors of all block drivers attached to the
+ *   shared block buffer cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int blockcache_sync(void);
+#endif
+
+/****************************************************************************
+ * Name: blockcache_getstats
+ *
+ * Description:
+ *   Return the statistics of the shared block buffer cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+void blockcache_getstats(FAR struct blockcache_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: inode_checkflags
  *
@@ -600,6 +739,41 @@ void files_initlist(FAR struct filelist *list);
 void files_releaselist(FAR struct filelist *list);
 #endif
 
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the struct file instance of a file descriptor in a list.  If
+ *   'alloc' is true, then storage for the descriptor is allocated if
+ *   necessary.
+ *
+ * Returned Value:
+ *   The struct file instance or NULL if the descriptor is out of range or
+ *   if no storage for it has been allocated (and it could not be
+ *   allocated).
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_fget(FAR struct filelist *list, int fd, bool alloc);
+#endif
+
+/****************************************************************************
+ * Name: files_getfd
+ *
+ * Description:
+ *   Return the file descriptor of a struct file instance in a list.
+ *
+ * Returned Value:
+ *   The file descriptor or -EBADF if the instance does not belong to the
+ *   list.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int files_getfd(FAR struct filelist *list, FAR struct file *filep);
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -783,6 +957,34 @@ int open_blockdriver(FAR const char *pathname, int mountflags,
 int close_blockdriver(FAR struct inode *inode);
 #endif
 
+/****************************************************************************
+ * Name: block_map
+ *
+ * Description:
+ *   Return the address of a range of sectors of a block driver whose media
+ *   is directly addressable (RAM disks, XIP flash, loop devices backed by
+ *   such files, ...) so that the caller may access the sectors without
+ *   copying them.  The BIOC_MAP ioctl command is used if the driver
+ *   supports it; otherwise the range is mapped relative to the address
+ *   returned by BIOC_XIPBASE.
+ *
+ * Input Parameters:
+ *   inode    - reference to the inode of an opened block driver
+ *   map      - The range of sectors to map.  The address and access of
+ *              the mapped sectors are returned in the same structure.
+ *
+ * Returned Value:
+ *   Zero on success or a negated errno value on failure:
+ *
+ *   ENOTTY  - The media of the driver is not directly addressable
+ *   EINVAL  - The range of sectors lies beyond the end of the media
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int block_map(FAR struct inode *inode, FAR struct blockmap_s *map);
+#endif
+
 /****************************************************************************
  * Name: fs_ioctl
  *
@@ -830,6 +1032,20 @@ struct tcb_s; /* Forward reference */
 FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb);
 #endif
 
+/****************************************************************************
+ * Name: pagemap_release
+ *
+ * Description:
+ *   Called when a task group exits to release the references that its
+ *   file mappings hold on pages in the shared page cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_PAGECACHE
+struct task_group_s; /* Forward reference */
+void pagemap_release(FAR struct task_group_s *group);
+#endif
+
 /****************************************************************************
  * Name: lib_flushall
  *
@@ -968,6 +1184,48 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
 
 ssize_t nx_write(int fd, FAR const void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_readv and file_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they accept a struct file instance instead of a file descriptor, do not
+ *   modify the errno variable, and are not cancellation points.  The
+ *   driver's or file system's vectored I/O method is used if it provides
+ *   one.
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success or a negated errno value on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_VECTORED_IO) && CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
+#endif
+
+/****************************************************************************
+ * Name: nx_readv and nx_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they do not modify the errno variable and are not cancellation points.
+ *   They accept both file and socket descriptors.
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success or a negated errno value on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_VECTORED_IO
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt);
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt);
+#endif
+
 /****************************************************************************
  * Name: file_pread
  *
@@ -1130,6 +1388,39 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 #endif
 
+/****************************************************************************
+ * Name: poll_forget
+ *
+ * Description:
+ *   Remove any persistent poll() registrations made on an open file.  This
+ *   must be called before the file is closed or detached.
+ *
+ * Input Parameters:
+ *   filep - The file that is being closed
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+void poll_forget(FAR struct file *filep);
+#endif
+
+/****************************************************************************
+ * Name: poll_releasecache
+ *
+ * Description:
+ *   Remove the persistent poll() registrations of a thread that is exiting
+ *   and free them.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+struct tcb_s; /* Forward reference */
+void poll_releasecache(FAR struct tcb_s *tcb);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
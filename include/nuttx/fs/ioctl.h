@@ -158,6 +158,22 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_PREALLOC   _FIOC(0x0009)     /* IN:  Pointer to off_t holding the
+                                           *      file length to reserve space for.
+                                           * OUT: None.  Space is reserved (but the
+                                           *      file size is not changed) until the
+                                           *      file is closed.
+                                           */
+#define FIOC_PACKSTEP   _FIOC(0x000a)     /* IN:  Maximum number of erase blocks
+                                           *      to pack in this step (int).
+                                           * OUT: Returns 1 if the pack is still
+                                           *      in progress, 0 if it completed.
+                                           */
+#define FIOC_PACKSTATS  _FIOC(0x000b)     /* IN:  Pointer to struct
+                                           *      nxffs_packstats_s.
+                                           * OUT: Packing progress and
+                                           *      statistics.
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -248,6 +264,22 @@
                                            *      to return geometry.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_FLUSH      _BIOC(0x000d)    /* Write back any data cached for
+                                           * the block driver.
+                                           * IN:  None
+                                           * OUT: None */
+#define BIOC_GETSTATS   _BIOC(0x000e)    /* Return driver specific statistics
+                                           * IN:  Pointer to the statistics
+                                           *      structure of the driver
+                                           * OUT: Statistics */
+#define BIOC_MAP        _BIOC(0x000f)    /* Map a range of sectors to directly
+                                           * addressable memory.
+                                           * IN:  Pointer to an instance of
+                                           *      struct blockmap_s with the
+                                           *      range of sectors to map.
+                                           * OUT: Address and access of the
+                                           *      sectors in the same
+                                           *      structure. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
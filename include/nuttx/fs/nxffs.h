@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <nuttx/fs/fs.h>
@@ -110,6 +112,27 @@
 #  endif
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Packing progress and statistics returned by the FIOC_PACKSTATS ioctl
+ * (CONFIG_NXFFS_PACKSTEP).
+ */
+
+struct nxffs_packstats_s
+{
+  bool     inprogress;         /* True: An incremental pack is in progress */
+  off_t    eblock;             /* Next erase block to pack (if in progress) */
+  off_t    neraseblocks;       /* Number of erase blocks on the volume */
+  off_t    freebytes;          /* Free FLASH at the end of the volume */
+  off_t    ndeleted;           /* Bytes of file data deleted since the last pack */
+  uint32_t npacks;             /* Number of completed packs */
+  uint32_t nsteps;             /* Number of incremental pack steps */
+  uint32_t nerased;            /* Number of erase blocks erased and rewritten */
+  uint32_t nskipped;           /* Number of clean erase blocks not rewritten */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
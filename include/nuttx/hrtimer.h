@@ -0,0 +1,163 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <time.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the form of the function that is called when a high resolution
+ * timer expires.  It is called from the alarm interrupt handler.
+ */
+
+typedef CODE void (*hrtimer_entry_t)(FAR void *arg);
+
+/* One high resolution timer.  The structure is provided by the caller,
+ * typically embedded in some larger structure, and must persist while the
+ * timer is active.  A timer is active while 'func' is non-NULL so the
+ * structure must be zeroed before its first use.
+ */
+
+struct hrtimer_s
+{
+  FAR struct hrtimer_s *flink;  /* Supports a list of active timers */
+  struct timespec expire;       /* Absolute expiration time */
+  hrtimer_entry_t func;         /* Function to call on expiration */
+  FAR void *arg;                /* Argument passed to 'func' */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a high resolution timer.  'func' will be called
+ *   from the alarm interrupt handler once 'delay' has elapsed.  The delay
+ *   is not rounded to the system tick.
+ *
+ *   hrtimer_start() may be called from the expiration function of the same
+ *   timer in order to implement a periodic timer.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to start
+ *   delay   - The delay relative to the current time
+ *   func    - The function to call on expiration
+ *   arg     - The argument to pass to 'func'
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer,
+                  FAR const struct timespec *delay,
+                  hrtimer_entry_t func, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a high resolution timer.  It is not an error to cancel a timer
+ *   that is not active.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time remaining before a high resolution timer expires.  Zero
+ *   is returned if the timer is not active.
+ *
+ * Input Parameters:
+ *   hrtimer   - The high resolution timer to query
+ *   remaining - The location to return the remaining time
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_gettime(FAR struct hrtimer_s *hrtimer,
+                    FAR struct timespec *remaining);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
@@ -47,6 +47,10 @@
 
 #include <nuttx/fs/ioctl.h>
 
+#ifdef CONFIG_I2C_QUEUE
+#  include <queue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -104,6 +108,12 @@
 
 #define I2CIOC_RESET         _I2CIOC(0x0002)
 
+/* The maximum number of registers that i2c_readregs() reads in one
+ * transfer.  Longer lists are read in several transfers.
+ */
+
+#define I2C_READREGS_NMAX    8
+
 /* Access macros ************************************************************/
 
 /****************************************************************************
@@ -208,6 +218,41 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+/* One register (or block of auto-incremented registers) to be read by
+ * i2c_readregs().
+ */
+
+struct i2c_regread_s
+{
+  uint8_t regaddr;            /* Register address to write */
+  uint8_t length;             /* Number of bytes to read */
+  FAR uint8_t *buffer;        /* Receives the register value(s) */
+};
+
+#ifdef CONFIG_I2C_QUEUE
+/* This describes one queued I2C transfer.  The request and the messages
+ * that it refers to belong to the I2C queue from i2c_submit() until the
+ * completion callback.
+ */
+
+struct i2c_request_s;
+typedef CODE void (*i2c_complete_t)(FAR struct i2c_request_s *req,
+                                    int result);
+
+struct i2c_request_s
+{
+  sq_entry_t node;            /* Queue link (private) */
+  FAR struct i2c_msg_s *msgs; /* The messages to transfer */
+  int count;                  /* The number of messages */
+  i2c_complete_t callback;    /* Called on the queue thread when done */
+  FAR void *arg;              /* Opaque argument for the callback */
+};
+
+/* The transfer queue of one I2C bus (opaque) */
+
+struct i2c_queue_s;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -317,6 +362,110 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_regmsgs
+ *
+ * Description:
+ *   Format the messages that read a list of registers: for each register,
+ *   a write of the register address followed by a restarted read.  The
+ *   messages may be passed to I2C_TRANSFER() or to i2c_submit().
+ *
+ * Input Parameters:
+ *   config - Described the I2C configuration
+ *   regs   - The registers to read
+ *   nregs  - The number of registers in the list
+ *   msgs   - Receives 2 * nregs messages
+ *
+ * Returned Value:
+ *   The number of messages formatted (2 * nregs)
+ *
+ ****************************************************************************/
+
+int i2c_regmsgs(FAR const struct i2c_config_s *config,
+                FAR const struct i2c_regread_s *regs, int nregs,
+                FAR struct i2c_msg_s *msgs);
+
+/****************************************************************************
+ * Name: i2c_readregs
+ *
+ * Description:
+ *   Read a list of registers with as few I2C transfers as possible (one
+ *   per I2C_READREGS_NMAX registers), rather than one write and one read
+ *   transfer per register.  The bus is acquired once per transfer.
+ *
+ * Input Parameters:
+ *   dev    - Device-specific state data
+ *   config - Described the I2C configuration
+ *   regs   - The registers to read
+ *   nregs  - The number of registers in the list
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_readregs(FAR struct i2c_master_s *dev,
+                 FAR const struct i2c_config_s *config,
+                 FAR const struct i2c_regread_s *regs, int nregs);
+
+#ifdef CONFIG_I2C_QUEUE
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Create the transfer queue of one I2C bus and start the kernel thread
+ *   that performs the queued transfers in order of submission.
+ *
+ * Input Parameters:
+ *   dev - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *dev);
+
+/****************************************************************************
+ * Name: i2c_submit
+ *
+ * Description:
+ *   Queue a transfer and return immediately.  req->callback, if not NULL,
+ *   is called from the queue thread with the result of I2C_TRANSFER() when
+ *   the transfer completes.  May be called from interrupt handlers, so a
+ *   data-ready interrupt may start the read of a sample directly.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - The request to queue
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_submit(FAR struct i2c_queue_s *queue, FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.  Its
+ *   callback is not called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by i2c_queue_initialize()
+ *   req   - The request passed to i2c_submit()
+ *
+ * Returned Value:
+ *   0 if the request was removed; -EBUSY if it has already been started
+ *   (or was never queued).
+ *
+ ****************************************************************************/
+
+int i2c_cancel(FAR struct i2c_queue_s *queue, FAR struct i2c_request_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -45,6 +45,10 @@
 
 #include <stdint.h>
 
+#ifdef CONFIG_DEFERRED_INIT
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +61,15 @@
 #define OSINIT_OS_READY()        (g_os_initstate >= OSINIT_OSREADY)
 #define OSINIT_OS_INITIALIZING() (g_os_initstate  < OSINIT_OSREADY)
 
+/* Boot profiling is a no-op unless CONFIG_BOOT_PROFILE is selected */
+
+#ifndef CONFIG_BOOT_PROFILE
+#  define boot_elapsed()       0
+#  define boot_mark(n)
+#  define boot_span(n,s)
+#  define boot_dump()
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -83,6 +96,30 @@ enum os_initstate_e
                           * active. */
 };
 
+#ifdef CONFIG_DEFERRED_INIT
+/* Describes one deferred initializer.  The first four fields are provided
+ * by the caller, the storage must persist until the initializer has run.
+ * 'depends' is a NULL terminated list of the names of the initializers that
+ * must complete successfully before this one may run (may be NULL).
+ */
+
+struct deferred_init_s
+{
+  FAR const char *name;                    /* Name used in 'depends' lists */
+  CODE int (*init)(FAR void *arg);         /* The initializer */
+  FAR void *arg;                           /* Argument of the initializer */
+  FAR const char * const *depends;         /* Initializers that run first */
+
+  /* Private to the deferred initialization logic */
+
+  FAR struct deferred_init_s *flink;       /* Registration list */
+  struct work_s work;                      /* Runs the initializer */
+  uint64_t start;                          /* boot_elapsed() when started */
+  uint8_t state;                           /* See os_deferred.c */
+  int result;                              /* Returned by the initializer */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +152,110 @@ int CONFIG_USER_ENTRYPOINT(int argc, char *argv[]);
 
 void os_start(void) noreturn_function;
 
+/* Functions contained in os_bootprof.c *************************************/
+
+#ifdef CONFIG_BOOT_PROFILE
+/****************************************************************************
+ * Name: boot_elapsed
+ *
+ * Description:
+ *   Return the time in microseconds since the first boot profiling call,
+ *   measured with the cycle counter if the architecture has one or with the
+ *   system timer otherwise.
+ *
+ ****************************************************************************/
+
+uint64_t boot_elapsed(void);
+
+/****************************************************************************
+ * Name: boot_mark
+ *
+ * Description:
+ *   Record the end of the boot phase 'name' in the boot log.  'name' must
+ *   be a string constant.
+ *
+ ****************************************************************************/
+
+void boot_mark(FAR const char *name);
+
+/****************************************************************************
+ * Name: boot_span
+ *
+ * Description:
+ *   Record an operation 'name' that started at boot_elapsed() time 'start'
+ *   and has just completed.  This is used for operations that overlap,
+ *   like the deferred initializers.
+ *
+ ****************************************************************************/
+
+void boot_span(FAR const char *name, uint64_t start);
+
+/****************************************************************************
+ * Name: boot_dump
+ *
+ * Description:
+ *   Send the boot log to the SYSLOG.
+ *
+ ****************************************************************************/
+
+void boot_dump(void);
+#endif
+
+/* Functions contained in os_deferred.c *************************************/
+
+#ifdef CONFIG_DEFERRED_INIT
+/****************************************************************************
+ * Name: deferred_init_register
+ *
+ * Description:
+ *   Register an initializer that is run on the work queue after the
+ *   initialization task has been started, concurrently with the
+ *   application and with other deferred initializers (one per work queue
+ *   thread), but only after all of the initializers that it depends on
+ *   have completed successfully.  Initializers that depend on one that
+ *   failed are not run.
+ *
+ *   This may be called at any time, typically from up_initialize() or
+ *   board_initialize().
+ *
+ * Input Parameters:
+ *   entry - Describes the initializer.  See struct deferred_init_s.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int deferred_init_register(FAR struct deferred_init_s *entry);
+
+/****************************************************************************
+ * Name: deferred_init_wait
+ *
+ * Description:
+ *   Wait until the deferred initializer 'name' has run or, if 'name' is
+ *   NULL, until all registered initializers have run.
+ *
+ * Returned Value:
+ *   The value returned by the initializer; -ECANCELED if it was not run
+ *   because an initializer that it depends on failed; -ENOENT if no such
+ *   initializer is registered.  Zero (OK) when waiting for all of them.
+ *
+ ****************************************************************************/
+
+int deferred_init_wait(FAR const char *name);
+
+/****************************************************************************
+ * Name: deferred_init_start
+ *
+ * Description:
+ *   Start the registered initializers.  Called by the OS bring-up logic
+ *   after the initialization task has been started.
+ *
+ ****************************************************************************/
+
+void deferred_init_start(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -64,12 +64,6 @@
  * Pre-processor Definitions
  ****************************************************************************/
 /* Configuration ************************************************************/
-/* Maximum number of threads than can be waiting for POLL events */
-
-#ifndef CONFIG_FT5X06_NPOLLWAITERS
-#  define CONFIG_FT5X06_NPOLLWAITERS 2
-#endif
-
 /* Check for some required settings.  This can save the user a lot of time
  * in getting the right configuration.
  */
@@ -50,6 +50,9 @@
  ************************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/ioctl.h>
 
 #ifdef CONFIG_INPUT
@@ -65,9 +68,11 @@
 #define TSIOC_GETCALIB       _TSIOC(0x0002)  /* arg: Pointer to int calibration value */
 #define TSIOC_SETFREQUENCY   _TSIOC(0x0003)  /* arg: Pointer to uint32_t frequency value */
 #define TSIOC_GETFREQUENCY   _TSIOC(0x0004)  /* arg: Pointer to uint32_t frequency value */
+#define TSIOC_SETCOALESCE    _TSIOC(0x0005)  /* arg: Pointer to struct touch_coalesce_s */
+#define TSIOC_GETCOALESCE    _TSIOC(0x0006)  /* arg: Pointer to struct touch_coalesce_s */
 
 #define TSC_FIRST            0x0001          /* First common command */
-#define TSC_NCMDS            4               /* Four common commands */
+#define TSC_NCMDS            6               /* Six common commands */
 
 /* User defined ioctl commands are also supported.  However, the TSC driver must
  * reserve a block of commands as follows in order prevent IOCTL command numbers
@@ -93,6 +98,30 @@
  *   TSC_B_NCMDS                 77                          <- Number of commands
  */
 
+/* Configuration of the common touchscreen upper half **************************
+ *
+ * CONFIG_INPUT_TOUCHSCREEN - Enables the common touchscreen upper half.
+ *   Selected by the drivers that use it.
+ * CONFIG_TOUCHSCREEN_NPOLLWAITERS - Maximum number of threads that can be
+ *   waiting on poll() for one touchscreen.
+ * CONFIG_TOUCHSCREEN_INTERVAL - Default minimum time in milliseconds
+ *   between wake-ups of readers for movement reports.
+ * CONFIG_TOUCHSCREEN_DISTANCE - Default minimum movement of a contact, in
+ *   device units, for a movement report to be buffered.
+ */
+
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+#  ifndef CONFIG_TOUCHSCREEN_NPOLLWAITERS
+#    define CONFIG_TOUCHSCREEN_NPOLLWAITERS 2
+#  endif
+#  ifndef CONFIG_TOUCHSCREEN_INTERVAL
+#    define CONFIG_TOUCHSCREEN_INTERVAL 0
+#  endif
+#  ifndef CONFIG_TOUCHSCREEN_DISTANCE
+#    define CONFIG_TOUCHSCREEN_DISTANCE 0
+#  endif
+#endif
+
 /* These definitions provide the meaning of all of the bits that may be
  * reported in the struct touch_point_s flags.
  */
@@ -122,6 +151,10 @@ struct touch_point_s
   int16_t  h;        /* Height of touch point (uncalibrated) */
   int16_t  w;        /* Width of touch point (uncalibrated) */
   uint16_t pressure; /* Touch pressure */
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+  uint64_t timestamp; /* Time of the report in microseconds.  Set only by
+                       * drivers that use the common upper half */
+#endif
 };
 
 /* The typical touchscreen driver is a read-only, input character device driver.
@@ -145,6 +178,60 @@ struct touch_sample_s
 };
 #define SIZEOF_TOUCH_SAMPLE_S(n) (sizeof(struct touch_sample_s) + ((n)-1)*sizeof(struct touch_point_s))
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/* Coalescing of movement reports, see TSIOC_SETCOALESCE.
+ *
+ * The common upper half buffers the reports of a driver and returns as many
+ * buffered samples as fit in the buffer passed to read(), one
+ * SIZEOF_TOUCH_SAMPLE_S(npoints) record after the other.  Reports of new or
+ * lost contacts (TOUCH_DOWN or TOUCH_UP) are buffered and wake up readers
+ * immediately.  Reports of movement only are:
+ *
+ *   - dropped if no contact moved by at least 'distance' in X or Y since
+ *     the last buffered report, and
+ *   - buffered without waking up readers if readers were woken less than
+ *     'interval' microseconds ago.  Readers are then woken when the
+ *     interval expires and collect all of the buffered reports at once.
+ */
+
+struct touch_coalesce_s
+{
+  uint32_t interval;  /* Minimum time between wake-ups, in microseconds */
+  uint16_t distance;  /* Minimum movement, in device units */
+};
+
+/* The touchscreen lower half interface.  The lower half reports touch
+ * samples with touch_report(); the upper half implements the character
+ * driver.
+ */
+
+struct touch_lowerhalf_s;
+struct touch_ops_s
+{
+  /* Start (open) or stop (close) reporting.  Called on the first open()
+   * and the last close().
+   */
+
+  CODE int (*open)(FAR struct touch_lowerhalf_s *lower);
+  CODE int (*close)(FAR struct touch_lowerhalf_s *lower);
+
+  /* Optional.  Handle any ioctl command not handled by the upper half */
+
+  CODE int (*control)(FAR struct touch_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+
+/* The lower half state.  This structure must be the first field of the
+ * lower half's own state structure.
+ */
+
+struct touch_lowerhalf_s
+{
+  FAR const struct touch_ops_s *ops;  /* Lower half operations */
+  FAR void *upper;                    /* Private to the upper half */
+};
+#endif /* CONFIG_INPUT_TOUCHSCREEN */
+
 /************************************************************************************
  * Public Function Prototypes
  ************************************************************************************/
@@ -157,6 +244,45 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/************************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Register a touchscreen character driver with the common upper half.
+ *
+ * Input Parameters:
+ *   lower     - The lower half state
+ *   path      - The full path to the driver, e.g. "/dev/input0"
+ *   maxpoints - The maximum number of touch points in one sample
+ *   nsamples  - The number of samples buffered
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ************************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower, FAR const char *path,
+                   uint8_t maxpoints, uint8_t nsamples);
+
+/************************************************************************************
+ * Name: touch_report
+ *
+ * Description:
+ *   Report a touch sample.  The sample is timestamped, coalesced as described
+ *   for struct touch_coalesce_s and buffered.  Must be called from a thread or
+ *   worker, not from an interrupt handler.
+ *
+ * Input Parameters:
+ *   lower  - The lower half state
+ *   sample - The sample.  At most 'maxpoints' points are used.
+ *
+ ************************************************************************************/
+
+void touch_report(FAR struct touch_lowerhalf_s *lower,
+                  FAR const struct touch_sample_s *sample);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -189,7 +189,8 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg);
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 irqstate_t enter_critical_section(void);
 #else
 #  define enter_critical_section(f) up_irq_save(f)
@@ -216,7 +217,8 @@ irqstate_t enter_critical_section(void);
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 void leave_critical_section(irqstate_t flags);
 #else
 #  define leave_critical_section(f) up_irq_restore(f)
@@ -283,6 +285,56 @@ void spin_unlock_irqrestore(irqstate_t flags);
 #  define spin_unlock_irqrestore(f) leave_critical_section(f)
 #endif
 
+/****************************************************************************
+ * Name: subsys_lock
+ *
+ * Description:
+ *   Disable local interrupts and take the subsystem spinlock 'lock'.  The
+ *   lock may be taken recursively by the CPU that holds it.  Subsystem
+ *   locks are used in place of enter_critical_section() to protect data
+ *   structures that are private to one OS subsystem so that unrelated
+ *   subsystems on other CPUs are not stalled.
+ *
+ *   NOTE: Like spin_lock_irqsave(), the subsystem lock must not be held
+ *   when calling kernel APIs that may suspend the caller.  If the critical
+ *   section is also required, it must be entered before the subsystem lock
+ *   is taken.
+ *
+ * Input Parameters:
+ *   lock - A reference to the subsystem lock
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to subsys_lock();
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+struct subsys_lock_s;
+irqstate_t subsys_lock(FAR struct subsys_lock_s *lock);
+#endif
+
+/****************************************************************************
+ * Name: subsys_unlock
+ *
+ * Description:
+ *   Release one count on the subsystem spinlock 'lock'.  When the count
+ *   decrements to zero, the spinlock is released and the interrupt state
+ *   is restored to the state prior to the matching call to subsys_lock().
+ *
+ * Input Parameters:
+ *   lock  - A reference to the subsystem lock
+ *   flags - The value returned by the matching call to subsys_lock()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+void subsys_unlock(FAR struct subsys_lock_s *lock, irqstate_t flags);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
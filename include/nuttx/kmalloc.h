@@ -112,10 +112,21 @@ extern "C"
 #  define kmm_trysemaphore()     umm_trysemaphore()
 #  define kmm_givesemaphore()    umm_givesemaphore()
 
+#ifdef CONFIG_MM_HEAPS
+/* Kernel allocations always come from the system heap, regardless of the
+ * default heap of the calling thread.
+ */
+
+#  define kmm_malloc(s)          mm_malloc(&g_mmheap,s)
+#  define kmm_zalloc(s)          mm_zalloc(&g_mmheap,s)
+#  define kmm_realloc(p,s)       mm_realloc(mm_heap_owner(p),p,s)
+#  define kmm_memalign(a,s)      mm_memalign(&g_mmheap,a,s)
+#else
 #  define kmm_malloc(s)          malloc(s)
 #  define kmm_zalloc(s)          zalloc(s)
 #  define kmm_realloc(p,s)       realloc(p,s)
 #  define kmm_memalign(a,s)      memalign(a,s)
+#endif
 #  define kmm_free(p)            free(p)
 #ifdef CONFIG_CAN_PASS_STRUCTS
 #  define kmm_mallinfo()         mallinfo()
@@ -94,6 +94,25 @@ struct lcd_planeinfo_s
   int (*getrun)(fb_coord_t row, fb_coord_t col, FAR uint8_t *buffer,
                 size_t npixels);
 
+  /* This optional method can be used to write a rectangular area of the LCD
+   * in one transfer.  LCDs with a settable address window can then set the
+   * window only once and send all of the pixel data as a single, possibly
+   * DMA-driven, transfer.  If NULL, putrun() is used for each row instead.
+   *
+   *  row_start - First row to write to (range: 0 <= row_start < yres)
+   *  row_end   - Last row to write to (range: row_start <= row_end < yres)
+   *  col_start - First column to write to (range: 0 <= col_start < xres)
+   *  col_end   - Last column to write to (range: col_start <= col_end < xres)
+   *  buffer    - The buffer containing the first row of the area
+   *  stride    - The length of a row of 'buffer' in bytes.  If zero, the
+   *              single row in 'buffer' is written to every row of the
+   *              area (as when filling).
+   */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, fb_coord_t stride);
+
   /* Plane color characteristics ********************************************/
 
   /* This is working memory allocated by the LCD driver for each LCD device
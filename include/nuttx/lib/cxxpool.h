@@ -0,0 +1,148 @@
+/****************************************************************************
+ * include/nuttx/lib/cxxpool.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LIB_CXXPOOL_H
+#define __INCLUDE_NUTTX_LIB_CXXPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#ifdef CONFIG_CXX_POOLALLOC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************
+ *
+ * CONFIG_CXX_POOLALLOC - Serve operator new from size-class pools
+ * CONFIG_CXX_POOLALLOC_MAXSIZE - Largest request served from the pools
+ * CONFIG_CXX_POOLALLOC_CHUNKSIZE - Size of the chunks carved into blocks
+ * CONFIG_CXX_POOLALLOC_NCACHES - Number of per-thread block caches
+ * CONFIG_CXX_POOLALLOC_CACHEDEPTH - Blocks held per class by each cache
+ * CONFIG_CXX_POOLALLOC_STATS - Keep allocation statistics
+ */
+
+/* Size classes are multiples of CXXPOOL_QUANTUM bytes */
+
+#define CXXPOOL_QUANTUM   16
+#define CXXPOOL_NCLASSES  (CONFIG_CXX_POOLALLOC_MAXSIZE / CXXPOOL_QUANTUM)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+/* Statistics for one size class */
+
+struct cxxpool_class_s
+{
+  size_t        size;      /* Largest request served by the class */
+  size_t        nblocks;   /* Blocks carved from chunks so far */
+  size_t        ncached;   /* Blocks now held in per-thread caches */
+  unsigned long nalloc;    /* Number of allocations */
+  unsigned long nfree;     /* Number of frees */
+};
+
+/* Statistics returned by cxxpool_stats() */
+
+struct cxxpool_stats_s
+{
+  size_t        chunkmem;  /* Bytes of heap held by the pools */
+  unsigned long nhits;     /* Requests satisfied by a per-thread cache */
+  unsigned long nmisses;   /* Requests that took the pool lock */
+  unsigned long nlarge;    /* Requests passed on to the heap */
+  unsigned long nlargefree;
+  struct cxxpool_class_s classes[CXXPOOL_NCLASSES];
+};
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cxxpool_flush
+ *
+ * Description:
+ *   Return the blocks held in the calling thread's cache to the shared
+ *   pools and release the cache for use by another thread.  Threads that
+ *   exit without calling this have their cache reclaimed when another
+ *   thread needs one.
+ *
+ ****************************************************************************/
+
+void cxxpool_flush(void);
+
+/****************************************************************************
+ * Name: cxxpool_stats
+ *
+ * Description:
+ *   Return a snapshot of the operator new allocation statistics.  Counts
+ *   kept by the per-thread caches are read without locking and may be
+ *   slightly stale.
+ *
+ * Input Parameters:
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+int cxxpool_stats(FAR struct cxxpool_stats_s *stats);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CXX_POOLALLOC */
+#endif /* __INCLUDE_NUTTX_LIB_CXXPOOL_H */
@@ -80,10 +80,45 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Optional pools of small and of large I/O buffers may be used along with
+ * the pool of CONFIG_IOB_NBUFFERS buffers of CONFIG_IOB_BUFSIZE bytes.
+ */
+
+#if !defined(CONFIG_IOB_SMALL_NBUFFERS)
+#  define CONFIG_IOB_SMALL_NBUFFERS 0
+#endif
+
+#if !defined(CONFIG_IOB_LARGE_NBUFFERS)
+#  define CONFIG_IOB_LARGE_NBUFFERS 0
+#endif
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+#  if CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_SMALL_BUFSIZE must be less than CONFIG_IOB_BUFSIZE
+#  endif
+#  define HAVE_IOB_POOLS 1
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  if CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_LARGE_BUFSIZE must be greater than CONFIG_IOB_BUFSIZE
+#  endif
+#  define HAVE_IOB_POOLS 1
+#  define IOB_MAXBUFSIZE CONFIG_IOB_LARGE_BUFSIZE
+#else
+#  define IOB_MAXBUFSIZE CONFIG_IOB_BUFSIZE
+#endif
+
 /* IOB helpers */
 
+#ifdef HAVE_IOB_POOLS
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -99,6 +134,10 @@
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
+ *
+ * If there are pools of small or large I/O buffers, then the buffers of a
+ * chain may differ in size and the payload is held in separate storage.
+ * Use IOB_BUFSIZE() to get the size of the payload of a buffer.
  */
 
 struct iob_s
@@ -109,7 +148,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if IOB_MAXBUFSIZE < 256
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -118,7 +157,12 @@ struct iob_s
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
 
+#ifdef HAVE_IOB_POOLS
+  uint16_t io_bufsize;  /* Size of the payload */
+  FAR uint8_t *io_data; /* The payload */
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -183,6 +227,67 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for 'size' bytes of data.  The buffer is taken
+ *   from the pool of small or of large I/O buffers if that is the best fit
+ *   for 'size' and a buffer is available in that pool.  Otherwise, this is
+ *   equivalent to iob_alloc().  The returned buffer may hold less than
+ *   'size' bytes:  Use IOB_BUFSIZE() or iob_copyin() to extend the chain.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IOB_POOLS
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled);
+#else
+#  define iob_alloc_size(s,t) iob_alloc(t)
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size() but without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IOB_POOLS
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled);
+#else
+#  define iob_tryalloc_size(s,t) iob_tryalloc(t)
+#endif
+
+/****************************************************************************
+ * Name: iob_navail
+ *
+ * Description:
+ *   Return the number of available IOBs (excluding those reserved by
+ *   CONFIG_IOB_THROTTLE if 'throttled' is true).
+ *
+ ****************************************************************************/
+
+int iob_navail(bool throttled);
+
+/****************************************************************************
+ * Name: iob_navail_size
+ *
+ * Description:
+ *   Return the number of bytes of free buffer space that iob_alloc_size()
+ *   and iob_copyin() can use for packets of 'size' bytes:  The free buffers
+ *   of the pool that is the best fit for 'size' plus the available
+ *   CONFIG_IOB_BUFSIZE buffers that they fall back to (as counted by
+ *   iob_navail()).  The count is only a snapshot.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IOB_POOLS
+uint32_t iob_navail_size(unsigned int size, bool throttled);
+#else
+#  define iob_navail_size(s,t) ((uint32_t)iob_navail(t) * CONFIG_IOB_BUFSIZE)
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
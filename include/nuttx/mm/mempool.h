@@ -0,0 +1,276 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ * Fixed-size object pools.
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_H
+#define __INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An object constructor.  It is called once for each object when the
+ * object is added to the pool, not on each allocation.  NOTE:  The first
+ * pointer-sized word of an object is used to link the object into the free
+ * list while the object is free and is not preserved.
+ */
+
+typedef CODE void (*mempool_ctor_t)(FAR void *obj, FAR void *arg);
+
+/* Called by mempool_foreach() for each pool */
+
+struct mempool_s;
+typedef CODE void (*mempool_handler_t)(FAR struct mempool_s *pool,
+                                       FAR void *arg);
+
+/* This describes one pool of fixed-size objects */
+
+struct mempool_s
+{
+  sq_queue_t mp_freelist;       /* The list of free objects */
+  FAR const char *mp_name;      /* Pool name (for reporting) */
+  mempool_ctor_t mp_ctor;       /* Object constructor (may be NULL) */
+  FAR void *mp_arg;             /* Argument passed to the constructor */
+  size_t   mp_objsize;          /* The size of one object */
+  uint16_t mp_nobjs;            /* Total number of objects in the pool */
+  uint16_t mp_nfree;            /* Number of free objects */
+  uint16_t mp_reserve;          /* Free objects reserved for interrupt level */
+  uint16_t mp_maxused;          /* High-water mark of objects in use */
+  uint32_t mp_nalloc;           /* Number of successful allocations */
+  uint32_t mp_nfail;            /* Number of failed allocations */
+#ifdef CONFIG_SPINLOCK_SUBSYS
+  struct subsys_lock_s mp_lock; /* Protects the pool */
+#endif
+  FAR struct mempool_s *mp_next; /* Next pool in the list of all pools */
+};
+
+/* Form in which the state of a pool is returned */
+
+struct mempoolinfo_s
+{
+  FAR const char *name;         /* Pool name (may be NULL) */
+  size_t   objsize;             /* The size of one object */
+  uint16_t nobjs;               /* Total number of objects in the pool */
+  uint16_t nfree;               /* Number of free objects */
+  uint16_t maxused;             /* High-water mark of objects in use */
+  uint32_t nalloc;              /* Number of successful allocations */
+  uint32_t nfail;               /* Number of failed allocations */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Set up a pool of 'nobjs' objects of size 'objsize'.  Allocation from
+ *   and release to the pool are O(1) and do not involve the heap, so the
+ *   pool may be used from interrupt handlers.
+ *
+ *   Each pool is added to the list of all pools that is traversed by
+ *   mempool_foreach().  Pools are never removed from that list, so a pool
+ *   must be initialized only once and must not be on the stack.
+ *
+ *   General Usage Summary.  A pool that is sized from the configuration
+ *   is normally backed by a static array:
+ *
+ *     static struct foo_s g_foostorage[CONFIG_PREALLOC_FOOS];
+ *     static struct mempool_s g_foopool;
+ *
+ *     mempool_initialize(&g_foopool, "foo", g_foostorage,
+ *                        sizeof(struct foo_s), CONFIG_PREALLOC_FOOS,
+ *                        0, NULL, NULL);
+ *
+ * Input Parameters:
+ *   pool    - The pool to be initialized
+ *   name    - The name of the pool (for reporting; may be NULL)
+ *   storage - Memory for the objects or NULL to allocate the objects from
+ *             the kernel heap
+ *   objsize - The size of one object.  Must be at least the size of a
+ *             pointer.
+ *   nobjs   - The number of objects in the pool
+ *   reserve - The number of free objects that may be allocated only from
+ *             interrupt handlers
+ *   ctor    - The object constructor or NULL
+ *   arg     - The argument passed to the constructor
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       FAR void *storage, size_t objsize, uint16_t nobjs,
+                       uint16_t reserve, mempool_ctor_t ctor,
+                       FAR void *arg);
+
+/****************************************************************************
+ * Name: mempool_extend
+ *
+ * Description:
+ *   Add 'nobjs' objects to an initialized pool.
+ *
+ * Input Parameters:
+ *   pool    - The pool to be extended
+ *   storage - Memory for the objects or NULL to allocate the objects from
+ *             the kernel heap
+ *   nobjs   - The number of objects to add
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int mempool_extend(FAR struct mempool_s *pool, FAR void *storage,
+                   uint16_t nobjs);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Take one object from the pool.  Outside of interrupt handlers, the
+ *   reserved objects are not used.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated object or NULL if no object is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_tryalloc
+ *
+ * Description:
+ *   Like mempool_alloc(), but an empty pool is not counted as a failed
+ *   allocation.  This is used by callers that fall back to the heap when
+ *   the pool is empty.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated object or NULL if no object is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_tryalloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return an object to the pool that it was allocated from.
+ *
+ * Input Parameters:
+ *   pool - The pool that the object was allocated from
+ *   obj  - The object to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *obj);
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return the state and statistics of a pool.
+ *
+ * Input Parameters:
+ *   pool - The pool to be queried
+ *   info - Memory location to return the pool info.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info);
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call 'handler' for each pool that has been initialized, in the order
+ *   in which the pools were initialized.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each pool
+ *   arg     - An argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_MEMPOOL_H */
@@ -123,15 +123,24 @@
  *   allocated.  It can range from 16-bytes to 4Gb.  Larger values of
  *   MM_MAX_SHIFT can cause larger data structure sizes and, perhaps,
  *   minor performance losses.
+ *
+ * Heap profiling adds the PID of the owner and the address of the caller
+ * to each chunk header.  The smallest chunk must then be twice as large.
  */
 
+#ifdef CONFIG_MM_PROFILE
+#  define MM_PROFILE_SHIFT 1
+#else
+#  define MM_PROFILE_SHIFT 0
+#endif
+
 #if defined(CONFIG_MM_SMALL) && UINTPTR_MAX <= UINT32_MAX
 /* Two byte offsets; Pointers may be 2 or 4 bytes;
  * sizeof(struct mm_freenode_s) is 8 or 12 bytes.
  * REVISIT: We could do better on machines with 16-bit addressing.
  */
 
-#  define MM_MIN_SHIFT    4  /* 16 bytes */
+#  define MM_MIN_SHIFT   (4 + MM_PROFILE_SHIFT) /* 16 bytes */
 #  define MM_MAX_SHIFT   15  /* 32 Kb */
 
 #elif defined(CONFIG_HAVE_LONG_LONG)
@@ -140,9 +149,9 @@
  */
 
 #  if UINTPTR_MAX <= UINT32_MAX
-#    define MM_MIN_SHIFT  4  /* 16 bytes */
+#    define MM_MIN_SHIFT (4 + MM_PROFILE_SHIFT) /* 16 bytes */
 #  elif UINTPTR_MAX <= UINT64_MAX
-#    define MM_MIN_SHIFT  5  /* 32 bytes */
+#    define MM_MIN_SHIFT (5 + MM_PROFILE_SHIFT) /* 32 bytes */
 #  endif
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 
@@ -151,7 +160,7 @@
  * sizeof(struct mm_freenode_s) is 16 bytes.
  */
 
-#  define MM_MIN_SHIFT    4  /* 16 bytes */
+#  define MM_MIN_SHIFT   (4 + MM_PROFILE_SHIFT) /* 16 bytes */
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 #endif
 
@@ -165,6 +174,21 @@
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
 
+/* Two-level segregated fit (TLSF) free lists.  The first level index
+ * selects a power-of-two size range; the second level index subdivides
+ * that range into MM_TLSF_SLCOUNT lists.  All chunks smaller than
+ * (1 << MM_TLSF_FLSHIFT) are kept in the first level list zero with one
+ * second level list per MM_MIN_CHUNK multiple.  All chunks of size
+ * MM_MAX_CHUNK or larger are kept in a single, final list.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_TLSF_SLBITS   CONFIG_MM_TLSF_SLBITS
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLBITS)
+#  define MM_TLSF_FLSHIFT  (MM_MIN_SHIFT + MM_TLSF_SLBITS)
+#  define MM_TLSF_FLCOUNT  (MM_MAX_SHIFT - MM_TLSF_FLSHIFT + 2)
+#endif
+
 /* An allocated chunk is distinguished from a free chunk by bit 31 (or 15)
  * of the 'preceding' chunk size.  If set, then this is an allocated chunk.
  */
@@ -177,6 +201,24 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Per-CPU allocation caches.  Size class n holds chunks of size
+ * (n + 1) * MM_MIN_CHUNK (including the chunk header).
+ */
+
+#ifdef CONFIG_MM_CACHE
+#  if CONFIG_MM_CACHE_BATCH > CONFIG_MM_CACHE_DEPTH
+#    error CONFIG_MM_CACHE_BATCH exceeds CONFIG_MM_CACHE_DEPTH
+#  endif
+
+#  ifdef CONFIG_SMP
+#    define MM_CACHE_NCPUS   CONFIG_SMP_NCPUS
+#  else
+#    define MM_CACHE_NCPUS   1
+#  endif
+
+#  define MM_CACHE_CLASS(s)  (((s) >> MM_MIN_SHIFT) - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -200,14 +242,24 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_PROFILE
+  pid_t pid;               /* PID of the owner of an allocated chunk */
+  FAR void *caller;        /* Address of the allocating caller */
+#endif
 };
 
 /* What is the size of the allocnode? */
 
 #ifdef CONFIG_MM_SMALL
-# define SIZEOF_MM_ALLOCNODE   4
+# define SIZEOF_MM_CHUNKSIZES  4
+#else
+# define SIZEOF_MM_CHUNKSIZES  8
+#endif
+
+#ifdef CONFIG_MM_PROFILE
+# define SIZEOF_MM_ALLOCNODE   (SIZEOF_MM_CHUNKSIZES + 2*MM_PTR_SIZE)
 #else
-# define SIZEOF_MM_ALLOCNODE   8
+# define SIZEOF_MM_ALLOCNODE   SIZEOF_MM_CHUNKSIZES
 #endif
 
 #define CHECK_ALLOCNODE_SIZE \
@@ -219,6 +271,10 @@ struct mm_freenode_s
 {
   mmsize_t size;                   /* Size of this chunk */
   mmsize_t preceding;              /* Size of the preceding chunk */
+#ifdef CONFIG_MM_PROFILE
+  pid_t pid;                       /* Unused in a free chunk */
+  FAR void *caller;
+#endif
   FAR struct mm_freenode_s *flink; /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
 };
@@ -231,6 +287,37 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+/* This describes the allocation cache of one CPU.  A free chunk in the
+ * cache is linked through the first pointer of its user data.
+ */
+
+#ifdef CONFIG_MM_CACHE
+struct mm_cache_s
+{
+  FAR void *mc_head[CONFIG_MM_CACHE_NCLASSES];  /* Free chunks of each class */
+  uint8_t mc_count[CONFIG_MM_CACHE_NCLASSES];   /* Number of free chunks */
+};
+#endif
+
+/* Heap profiling:  The address of the caller of an allocation function.
+ * The public allocation functions (malloc(), mm_malloc(), ...) capture
+ * their own return address and pass it down explicitly to the
+ * mm_*_caller() functions, which record it.  It is not taken further down
+ * because the intermediate calls are not tail calls in every build (e.g.,
+ * at -O0).
+ */
+
+#if defined(CONFIG_MM_PROFILE) && defined(__GNUC__)
+#  define MM_RETURN_ADDRESS() __builtin_return_address(0)
+#else
+#  define MM_RETURN_ADDRESS() NULL
+#endif
+
+/* A heap walker callback.  See mm_foreach() */
+
+typedef CODE void (*mm_walker_t)(FAR struct mm_allocnode_s *node,
+                                 FAR void *arg);
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -256,12 +343,48 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are maintained in segregated, doubly linked lists.  A bit
+   * is set in the bitmaps for each non-empty list.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Small allocation caches, one per CPU */
+
+  struct mm_cache_s mm_cache[MM_CACHE_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_PROFILE
+  /* realloc() statistics:  The number of reallocations that increased the
+   * size of a chunk, the number of those that moved the data down into
+   * the preceding free chunk or copied it to a new chunk, and the total
+   * number of bytes moved or copied.
+   */
+
+  unsigned long mm_realloc_grown;
+  unsigned long mm_realloc_moved;
+  unsigned long mm_realloc_copied;
+  unsigned long mm_realloc_bytes;
+#endif
+
+#ifdef CONFIG_MM_HEAPS
+  /* Named heaps are retained in a singly linked list */
+
+  FAR struct mm_heap_s *mm_flink;
+  FAR const char *mm_name;
+#endif
 };
 
 /****************************************************************************
@@ -367,6 +490,13 @@ void kmm_givesemaphore(void);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_malloc_caller(FAR struct mm_heap_s *heap, size_t size,
+                           FAR void *caller);
+#else
+#  define mm_malloc_caller(h,s,c) mm_malloc(h,s)
+#endif
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t alignsize);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -377,6 +507,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -388,6 +519,12 @@ void kmm_free(FAR void *mem);
 
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                      size_t size);
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_realloc_caller(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                            size_t size, FAR void *caller);
+#else
+#  define mm_realloc_caller(h,m,s,c) mm_realloc(h,m,s)
+#endif
 
 /* Functions contained in kmm_realloc.c *************************************/
 
@@ -398,6 +535,12 @@ FAR void *kmm_realloc(FAR void *oldmem, size_t newsize);
 /* Functions contained in mm_calloc.c ***************************************/
 
 FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size);
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_calloc_caller(FAR struct mm_heap_s *heap, size_t n,
+                           size_t elem_size, FAR void *caller);
+#else
+#  define mm_calloc_caller(h,n,s,c) mm_calloc(h,n,s)
+#endif
 
 /* Functions contained in kmm_calloc.c **************************************/
 
@@ -408,6 +551,12 @@ FAR void *kmm_calloc(size_t n, size_t elem_size);
 /* Functions contained in mm_zalloc.c ***************************************/
 
 FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size);
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_zalloc_caller(FAR struct mm_heap_s *heap, size_t size,
+                           FAR void *caller);
+#else
+#  define mm_zalloc_caller(h,s,c) mm_zalloc(h,s)
+#endif
 
 /* Functions contained in kmm_zalloc.c **************************************/
 
@@ -419,6 +568,12 @@ FAR void *kmm_zalloc(size_t size);
 
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size);
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_memalign_caller(FAR struct mm_heap_s *heap, size_t alignment,
+                             size_t size, FAR void *caller);
+#else
+#  define mm_memalign_caller(h,a,s,c) mm_memalign(h,a,s)
+#endif
 
 /* Functions contained in kmm_memalign.c ************************************/
 
@@ -495,6 +650,17 @@ int kmm_mallinfo(struct mallinfo *info);
 #endif /* CONFIG_CAN_PASS_STRUCTS */
 #endif /* CONFIG_MM_KERNEL_HEAP */
 
+/* Functions contained in mm_foreach.c **************************************/
+
+void mm_foreach(FAR struct mm_heap_s *heap, mm_walker_t handler,
+                FAR void *arg);
+
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_PROFILE
+void mm_profile_mark(FAR void *mem, FAR void *caller);
+#endif
+
 /* Functions contained in mm_shrinkchunk.c **********************************/
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
@@ -505,6 +671,43 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_remfreechunk.c *********************************/
+
+void mm_remfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c ********************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_TLSF
+void mm_initfreelists(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_CACHE
+void mm_cache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+void mm_cache_refill(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_cache_flush(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in umm_heaps.c **************************************/
+
+#ifdef CONFIG_MM_HEAPS
+FAR struct mm_heap_s *mm_heap_create(FAR const char *name,
+                                     FAR void *heapstart, size_t heapsize);
+FAR struct mm_heap_s *mm_heap_find(FAR const char *name);
+FAR struct mm_heap_s *mm_heap_select(FAR struct mm_heap_s *heap);
+FAR struct mm_heap_s *mm_heap_default(void);
+FAR struct mm_heap_s *mm_heap_owner(FAR void *mem);
+#endif
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * include/nuttx/mm/shmring.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_SHMRING_H
+#define __INCLUDE_NUTTX_MM_SHMRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The data area of a ring follows the header */
+
+#define SHMRING_DATA(r)  ((FAR uint8_t *)(r) + sizeof(struct shmring_s))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the header of a single producer, single consumer ring buffer
+ * placed at the beginning of a shared memory region.  The head and tail
+ * indices are free running byte counts that are written only by the
+ * producer and only by the consumer, respectively.  They are naturally
+ * aligned 32-bit words so they are read and written atomically and they
+ * serve as the keys for shmwait() and shmwake().
+ *
+ * The header contains no pointers so the processes sharing the ring may
+ * have the region attached at different addresses.
+ */
+
+struct shmring_s
+{
+  /* Written by the producer */
+
+  volatile uint32_t sr_head;     /* Number of bytes ever written */
+  volatile uint32_t sr_wwait;    /* Non-zero: Producer waits for space */
+
+  /* Written by the consumer */
+
+  volatile uint32_t sr_tail;     /* Number of bytes ever consumed */
+  volatile uint32_t sr_rwait;    /* Non-zero: Consumer waits for data */
+
+  /* Set up once by shmring_initialize() */
+
+  uint32_t sr_size;              /* Size of the data area (power of two) */
+  uint32_t sr_reserved[3];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmring_initialize
+ *
+ * Description:
+ *   Initialize a ring buffer in 'size' bytes of shared memory at 'ring'.
+ *   The data area is the largest power of two that fits after the header.
+ *   This must be done once, by either side, before the ring is used.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the memory is too small.
+ *
+ ****************************************************************************/
+
+int shmring_initialize(FAR struct shmring_s *ring, size_t size);
+
+/****************************************************************************
+ * Name: shmring_claim
+ *
+ * Description:
+ *   Producer:  Return the address of the free space at the head of the
+ *   ring and the number of contiguous bytes available there.  The data is
+ *   written directly into the ring and then published with
+ *   shmring_commit().
+ *
+ ****************************************************************************/
+
+size_t shmring_claim(FAR struct shmring_s *ring, FAR void **buffer);
+
+/****************************************************************************
+ * Name: shmring_commit
+ *
+ * Description:
+ *   Producer:  Publish 'nbytes' bytes written into the space returned by
+ *   shmring_claim() and wake the consumer if it is waiting for data.
+ *
+ ****************************************************************************/
+
+void shmring_commit(FAR struct shmring_s *ring, size_t nbytes);
+
+/****************************************************************************
+ * Name: shmring_peek
+ *
+ * Description:
+ *   Consumer:  Return the address of the oldest data in the ring and the
+ *   number of contiguous bytes available there.  The data is used in place
+ *   and then returned to the producer with shmring_release().
+ *
+ ****************************************************************************/
+
+size_t shmring_peek(FAR struct shmring_s *ring, FAR void **buffer);
+
+/****************************************************************************
+ * Name: shmring_release
+ *
+ * Description:
+ *   Consumer:  Return 'nbytes' bytes returned by shmring_peek() to the
+ *   producer and wake the producer if it is waiting for space.
+ *
+ ****************************************************************************/
+
+void shmring_release(FAR struct shmring_s *ring, size_t nbytes);
+
+/****************************************************************************
+ * Name: shmring_waitdata
+ *
+ * Description:
+ *   Consumer:  Wait until the ring holds data or until 'abstime' (if not
+ *   NULL) expires.
+ *
+ * Returned Value:
+ *   Zero (OK) if data is available; a negated errno value on timeout
+ *   (-ETIMEDOUT) or other failure.
+ *
+ ****************************************************************************/
+
+int shmring_waitdata(FAR struct shmring_s *ring,
+                     FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: shmring_waitspace
+ *
+ * Description:
+ *   Producer:  Wait until at least 'nbytes' bytes of the ring are free or
+ *   until 'abstime' (if not NULL) expires.
+ *
+ * Returned Value:
+ *   Zero (OK) if the space is available; a negated errno value on timeout
+ *   (-ETIMEDOUT) or other failure.
+ *
+ ****************************************************************************/
+
+int shmring_waitspace(FAR struct shmring_s *ring, size_t nbytes,
+                      FAR const struct timespec *abstime);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_SHM */
+#endif /* __INCLUDE_NUTTX_MM_SHMRING_H */
@@ -42,6 +42,34 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_STATS
+/* Transfer statistics returned by the BIOC_GETSTATS ioctl command.  Times
+ * are in units of system clock ticks.  The time of a write request does not
+ * include the time that the card then spends programming the data; that is
+ * accounted as busy time before the following request.
+ */
+
+struct mmcsd_stats_s
+{
+  uint32_t nreads;                 /* Number of read requests */
+  uint32_t nwrites;                /* Number of write requests */
+  uint32_t rdblocks;               /* Number of blocks read */
+  uint32_t wrblocks;               /* Number of blocks written */
+  uint32_t nerrors;                /* Number of failed requests */
+  uint32_t rdticks;                /* Total time of the read requests */
+  uint32_t wrticks;                /* Total time of the write requests */
+  uint32_t rdmax;                  /* Longest read request */
+  uint32_t wrmax;                  /* Longest write request */
+  uint32_t busyticks;              /* Time waiting for card programming */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
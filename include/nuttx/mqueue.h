@@ -115,6 +115,10 @@ struct mqueue_inode_s
 #else
   uint16_t maxmsgsize;        /* Max size of message in message queue */
 #endif
+#ifdef CONFIG_MQ_ZEROCOPY
+  FAR void *slab;             /* Preallocated message storage */
+  sq_queue_t msgfree;         /* Free messages in the preallocated storage */
+#endif
 #ifndef CONFIG_DISABLE_SIGNALS
   FAR struct mq_des *ntmqdes; /* Notification: Owning mqdes (NULL if none) */
   pid_t ntpid;                /* Notification: Receiving Task's PID */
@@ -296,6 +300,35 @@ ssize_t nxmq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
 ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                         FAR int *prio, FAR const struct timespec *abstime);
 
+/****************************************************************************
+ * Name: nxmq_msg_reserve, nxmq_msg_commit, nxmq_msg_receive, and
+ *       nxmq_msg_release
+ *
+ * Description:
+ *   Zero-copy messaging.  A sender reserves a message buffer with
+ *   nxmq_msg_reserve(), builds the message in place, and sends it with
+ *   nxmq_msg_commit().  A receiver gets the message buffer itself from
+ *   nxmq_msg_receive() and gives it back with nxmq_msg_release().  The
+ *   buffers normally come from the storage preallocated with the queue.
+ *
+ *   These interfaces are otherwise equivalent to nxmq_send() and
+ *   nxmq_receive():  They block (unless O_NONBLOCK is set) and are not
+ *   cancellation points.  A buffer must be released or committed before
+ *   the descriptor used to obtain it is closed.
+ *
+ * Returned Value:
+ *   Zero (OK), or the message length for nxmq_msg_receive(), on success.
+ *   A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+int nxmq_msg_reserve(mqd_t mqdes, FAR void **buffer);
+int nxmq_msg_commit(mqd_t mqdes, FAR void *buffer, size_t msglen, int prio);
+ssize_t nxmq_msg_receive(mqd_t mqdes, FAR void **buffer, FAR int *prio);
+int nxmq_msg_release(mqd_t mqdes, FAR void *buffer);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
@@ -82,6 +82,20 @@
                                            * OUT: None */
 #define MTDIOC_ECCSTATUS  _MTDIOC(0x0008) /* IN:  Pointer to uint8_t
                                            * OUT: ECC status */
+#define MTDIOC_ERASESTART _MTDIOC(0x0009) /* IN:  Erase block number
+                                           * OUT: None.  The erase is started
+                                           *      and the ioctl returns without
+                                           *      waiting for it to complete */
+#define MTDIOC_ERASESTATUS _MTDIOC(0x000a) /* IN:  None
+                                           * OUT: None.  Returns -EBUSY while
+                                           *      an erase started by
+                                           *      MTDIOC_ERASESTART is still in
+                                           *      progress, OK when it is done */
+#define MTDIOC_GETSTATS   _MTDIOC(0x000b) /* IN:  Pointer to write-able struct
+                                           *      mtd_stats_s in which to
+                                           *      receive the statistics
+                                           * OUT: Statistics structure is
+                                           *      populated */
 
 /* Macros to hide implementation */
 
@@ -92,6 +106,18 @@
 #define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
 #define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
 
+/* Asynchronous erase.  MTD_ERASESTART() starts erasing one erase block and
+ * returns immediately; MTD_ERASESTATUS() returns -EBUSY until that erase has
+ * completed.  Any other access to the device while the erase is in progress
+ * is still safe:  Reads are served by suspending the erase on parts that
+ * support erase-suspend and otherwise wait, as do writes and other erases.
+ * Drivers that do not support this return -ENOTTY and the caller should
+ * fall back to MTD_ERASE().
+ */
+
+#define MTD_ERASESTART(d,b) MTD_IOCTL(d,MTDIOC_ERASESTART,(unsigned long)(b))
+#define MTD_ERASESTATUS(d)  MTD_IOCTL(d,MTDIOC_ERASESTATUS,0)
+
 /* If any of the low-level device drivers declare they want sub-sector erase
  * support, then define MTD_SUBSECTOR_ERASE.
  */
@@ -145,6 +171,30 @@ struct mtd_byte_write_s
   const uint8_t *buffer;  /* Pointer to the data to write */
 };
 
+/* Throughput and latency statistics returned by MTDIOC_GETSTATS.  Latencies
+ * are measured in system clock ticks from the time that a request is
+ * submitted (including any time spent waiting behind other requests) until
+ * it completes.
+ */
+
+struct mtd_stats_s
+{
+  uint32_t nreads;        /* Number of read requests */
+  uint32_t nwrites;       /* Number of write requests */
+  uint32_t nerases;       /* Number of erase requests */
+  uint32_t nmerged;       /* Requests merged with an adjacent request */
+  uint32_t nerrors;       /* Requests that failed */
+  uint32_t rdbytes;       /* Number of bytes read */
+  uint32_t wrbytes;       /* Number of bytes written */
+  uint32_t erbytes;       /* Number of bytes erased */
+  uint32_t rdticks;       /* Sum of read latencies */
+  uint32_t wrticks;       /* Sum of write latencies */
+  uint32_t erticks;       /* Sum of erase latencies */
+  uint32_t rdmax;         /* Worst read latency */
+  uint32_t wrmax;         /* Worst write latency */
+  uint32_t ermax;         /* Worst erase latency */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
@@ -302,6 +352,25 @@ FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd);
 
 int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd);
 
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Initialize to provide a log-structured block driver wrapper around an
+ *   MTD interface.  ftl_initialize() calls this function when
+ *   CONFIG_FTL_LOG is selected.
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The MTD block device will be
+ *      registered as as /dev/mtdblockN where N is the minor number.
+ *   mtd - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+int ftl_log_initialize(int minor, FAR struct mtd_dev_s *mtd);
+#endif
+
 /****************************************************************************
  * Name: smart_initialize
  *
@@ -0,0 +1,185 @@
+/****************************************************************************
+ * include/nuttx/mtd/sfdp.h
+ * Serial Flash Discoverable Parameters (JESD216)
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_SFDP_H
+#define __INCLUDE_NUTTX_MTD_SFDP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_MTD_SFDP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The Read SFDP command:  3 address bytes and 8 dummy cycles on one line */
+
+#define SFDP_READ_CMD           0x5a
+#define SFDP_READ_ADDRLEN       3
+#define SFDP_READ_DUMMIES       8
+
+/* Read modes, named by the number of lines used for the command, address
+ * and data phases.  These are used as indices into sfdp_s.read[] and as
+ * bits in the 'modes' argument of sfdp_readmode().
+ */
+
+#define SFDP_READ_1_1_1         0  /* Fast read (0x0b) */
+#define SFDP_READ_1_1_2         1
+#define SFDP_READ_1_2_2         2
+#define SFDP_READ_1_1_4         3
+#define SFDP_READ_1_4_4         4
+#define SFDP_READ_NMODES        5
+
+#define SFDP_MODE(m)            (1 << (m))
+
+/* Addressing supported by the device */
+
+#define SFDP_ADDR_3BYTE         0  /* 3-byte only */
+#define SFDP_ADDR_3OR4BYTE      1  /* 3-byte by default, 4-byte on request */
+#define SFDP_ADDR_4BYTE         2  /* 4-byte only */
+
+/* The number of erase types described by the basic parameter table */
+
+#define SFDP_NERASE             4
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Read data from the SFDP address space of the device.  addr is an SFDP
+ * address, not a FLASH address.  Returns zero (OK) on success or a negated
+ * errno value on failure.
+ */
+
+typedef CODE int (*sfdp_read_t)(FAR void *arg, uint32_t addr,
+                                FAR void *buffer, size_t buflen);
+
+/* One read mode */
+
+struct sfdp_rdmode_s
+{
+  uint8_t  opcode;               /* Read opcode.  Zero:  Not supported */
+  uint8_t  dummies;              /* Wait states plus mode clocks */
+};
+
+/* One erase type */
+
+struct sfdp_erase_s
+{
+  uint8_t  opcode;               /* Erase opcode.  Zero:  Not supported */
+  uint8_t  shift;                /* log2 of the erase size in bytes */
+};
+
+/* What was learned from the basic FLASH parameter table */
+
+struct sfdp_s
+{
+  uint8_t  major;                /* Revision of the basic parameter table */
+  uint8_t  minor;
+  uint8_t  addrmode;             /* See SFDP_ADDR_* definitions */
+  uint8_t  pageshift;            /* log2 of the program page size */
+  bool     dtr;                  /* Double transfer rate is supported */
+  uint64_t size;                 /* Device size in bytes */
+  struct sfdp_rdmode_s read[SFDP_READ_NMODES];
+  struct sfdp_erase_s erase[SFDP_NERASE];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sfdp_probe
+ *
+ * Description:
+ *   Read and decode the SFDP header and the JEDEC basic FLASH parameter
+ *   table of a serial NOR FLASH.
+ *
+ * Input Parameters:
+ *   read - Transport-specific method that reads the SFDP address space
+ *   arg  - Argument passed to the read method
+ *   sfdp - The location to return the decoded parameters
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if the device has no valid SFDP; or any
+ *   error returned by the read method.
+ *
+ ****************************************************************************/
+
+int sfdp_probe(sfdp_read_t read, FAR void *arg, FAR struct sfdp_s *sfdp);
+
+/****************************************************************************
+ * Name: sfdp_readmode
+ *
+ * Description:
+ *   Select the fastest read mode that is supported by both the device and
+ *   the controller.
+ *
+ * Input Parameters:
+ *   sfdp  - Parameters returned by sfdp_probe()
+ *   modes - The set of read modes supported by the controller (see
+ *           SFDP_MODE())
+ *
+ * Returned Value:
+ *   The selected read mode (SFDP_READ_*) or -ENOSYS if no mode matches.
+ *
+ ****************************************************************************/
+
+int sfdp_readmode(FAR const struct sfdp_s *sfdp, unsigned int modes);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MTD_SFDP */
+#endif /* __INCLUDE_NUTTX_MTD_SFDP_H */
@@ -104,6 +104,20 @@ struct arpreq
   struct sockaddr   arp_ha;      /* Hardware address */
 };
 
+/* The structure holding the ARP statistics that are gathered if
+ * CONFIG_NET_STATISTICS is defined.
+ */
+
+#ifdef CONFIG_NET_STATISTICS
+struct arp_stats_s
+{
+  net_stats_t hit;        /* Number of outgoing packets with a cached mapping */
+  net_stats_t miss;       /* Number of outgoing packets needing an ARP request */
+  net_stats_t evict;      /* Number of valid mappings evicted to make room */
+  net_stats_t queued;     /* Number of packets held awaiting resolution */
+  net_stats_t qdrop;      /* Number of held packets that were discarded */
+};
+#endif
 
 /****************************************************************************
  * Public Data
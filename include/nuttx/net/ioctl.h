@@ -130,6 +130,13 @@
 #define SIOCTELNET       _SIOC(0x0029)  /* Create a Telnet sessions.
                                          * See include/nuttx/net/telnet.h */
 
+/* Network device statistics ************************************************/
+
+#define SIOCGIFSTATS     _SIOC(0x002a)  /* Get the statistics of a device.
+                                         * ifr_data points to a struct
+                                         * netdev_statistics_s. See
+                                         * include/nuttx/net/netdev.h */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
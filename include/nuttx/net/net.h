@@ -123,7 +123,7 @@ enum net_lltype_e
 
 /* This defines a bitmap big enough for one bit for each socket option */
 
-typedef uint16_t sockopt_t;
+typedef uint32_t sockopt_t;
 
 /* This defines the storage size of a timeout value.  This effects only
  * range of supported timeout values.  With an LSB in seciseconds, the
@@ -200,6 +200,12 @@ struct socket
 #ifdef CONFIG_NET_SOLINGER
   socktimeo_t   s_linger;    /* Linger timeout value (in deciseconds) */
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+  uint8_t       s_cpu;       /* SO_INCOMING_CPU + 1, zero if none */
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+  uint8_t       s_tstamp;    /* SO_TIMESTAMPING: SOF_TIMESTAMPING_* bits */
+#endif
 #endif
 
   FAR void     *s_conn;      /* Connection: struct tcp_conn_s or udp_conn_s */
@@ -215,16 +221,37 @@ struct socket
 #endif
 };
 
-/* This defines a list of sockets indexed by the socket descriptor */
+/* This defines a list of sockets indexed by the socket descriptor.  As
+ * with struct filelist, a set bit in sl_inuse means that the socket is in
+ * use; sockets cloned into the list by other logic may be in use with
+ * their bit clear.
+ */
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0
+#define SOCKETLIST_NWORDS ((CONFIG_NSOCKET_DESCRIPTORS + 31) >> 5)
+
 struct socketlist
 {
   sem_t         sl_sem;      /* Manage access to the socket list */
+  uint32_t      sl_inuse[SOCKETLIST_NWORDS]; /* Bitmap of sockets in use */
   struct socket sl_sockets[CONFIG_NSOCKET_DESCRIPTORS];
 };
 #endif
 
+#ifdef CONFIG_NET_LOCK_STATS
+/* Statistics of the global network lock.  Times are in up_cyclecount()
+ * cycles.
+ */
+
+struct net_lockstats_s
+{
+  uint32_t      nlocks;      /* Number of times the lock was taken */
+  uint32_t      ncontended;  /* Number of times another thread held it */
+  uint64_t      holdcycles;  /* Total time that the lock was held */
+  uint32_t      maxhold;     /* Longest time that the lock was held */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -366,6 +393,27 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime);
 
 int net_lockedwait(sem_t *sem);
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return the statistics of the network lock and optionally reset them.
+ *   The lock is only held by threads:  It measures how long the stack
+ *   keeps other threads out of the network.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics (may be NULL)
+ *   reset - True: Reset the statistics after they have been returned
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats, bool reset);
+#endif
+
 /****************************************************************************
  * Name: net_setipid
  *
@@ -856,6 +904,31 @@ ssize_t psock_sendto(FAR struct socket *psock, FAR const void *buf,
                      size_t len, int flags, FAR const struct sockaddr *to,
                      socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends the message described by a struct msghdr.  This
+ *   is an internal OS interface that is functionally equivalent to
+ *   sendmsg() except that it is not a cancellation point, it does not
+ *   modify the errno variable, and it accepts the internal socket
+ *   structure as an input rather than a socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+struct msghdr; /* Forward reference */
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                      int flags);
+
 /****************************************************************************
  * Name: psock_recvfrom
  *
@@ -896,6 +969,57 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives a message into the I/O vector of a struct
+ *   msghdr.  This is an internal OS interface that is functionally
+ *   equivalent to recvmsg() except that it is not a cancellation point, it
+ *   does not modify the errno variable, and it accepts the internal socket
+ *   structure as an input rather than a socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to receive
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On any
+ *   failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+
+/****************************************************************************
+ * Name: psock_tcp_recviob
+ *
+ * Description:
+ *   Receive the next packet of TCP stream data as an I/O buffer chain
+ *   removed, without copying, from the socket's read-ahead queue.  This is
+ *   an internal OS interface for in-kernel consumers of TCP streams.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a connected TCP socket structure
+ *   iob     - The location to return the I/O buffer chain.  The caller
+ *             must release the chain with iob_free_chain().
+ *   flags   - Receive flags (MSG_DONTWAIT)
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the I/O buffer chain.  Zero
+ *   is returned if the peer has performed an orderly shutdown.  Otherwise,
+ *   a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+struct iob_s; /* Forward reference */
+ssize_t psock_tcp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags);
+#endif
+
 /****************************************************************************
  * Name: nx_recvfrom
  *
@@ -51,6 +51,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <time.h>
 #include <net/if.h>
 
 #include <net/ethernet.h>
@@ -96,7 +97,10 @@
        } \
      while (0)
 
+#  define _NETDEV_ADD(dev,name,n) ((dev)->d_statistics.name += (n))
+
 #  define NETDEV_RXPACKETS(dev)   _NETDEV_STATISTIC(dev,rx_packets)
+#  define NETDEV_RXBYTES(dev,n)   _NETDEV_ADD(dev,rx_bytes,n)
 #  define NETDEV_RXFRAGMENTS(dev) _NETDEV_STATISTIC(dev,rx_fragments)
 #  define NETDEV_RXERRORS(dev)    _NETDEV_ERROR(dev,rx_errors)
 #  ifdef CONFIG_NET_IPv4
@@ -118,6 +122,7 @@
 
 #  define NETDEV_TXPACKETS(dev)   _NETDEV_STATISTIC(dev,tx_packets)
 #  define NETDEV_TXDONE(dev)      _NETDEV_STATISTIC(dev,tx_done)
+#  define NETDEV_TXBYTES(dev,n)   _NETDEV_ADD(dev,tx_bytes,n)
 #  define NETDEV_TXERRORS(dev)    _NETDEV_ERROR(dev,tx_errors)
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
 
@@ -126,6 +131,7 @@
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
+#  define NETDEV_RXBYTES(dev,n)
 #  define NETDEV_RXFRAGMENTS(dev)
 #  define NETDEV_RXERRORS(dev)
 #  define NETDEV_RXIPV4(dev)
@@ -135,12 +141,37 @@
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
+#  define NETDEV_TXBYTES(dev,n)
 #  define NETDEV_TXERRORS(dev)
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Checksum offload.  A driver whose hardware inserts checksums in outgoing
+ * packets advertises that by setting the NETDEV_TXCSUM_* bits in d_csumcaps
+ * when it is initialized.  The network stack then leaves the corresponding
+ * checksum field zero and the hardware is responsible for filling it in.
+ *
+ * A driver whose hardware verifies the checksums of incoming packets marks
+ * each received packet that passed verification by setting IFF_CSUMOK in
+ * d_flags before passing it to ipv4_input() or ipv6_input() (and clears
+ * the flag for packets that were not verified).  The stack then skips its
+ * own software verification of the IPv4 header, TCP and UDP checksums.
+ */
+
+#define NETDEV_TXCSUM_IPv4    (1 << 0) /* Hardware inserts IPv4 header checksum */
+#define NETDEV_TXCSUM_TCP     (1 << 1) /* Hardware inserts TCP checksum */
+#define NETDEV_TXCSUM_UDP     (1 << 2) /* Hardware inserts UDP checksum */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define NETDEV_TXCSUM(dev,f)  (((dev)->d_csumcaps & (f)) != 0)
+#  define NETDEV_RXCSUMOK(dev)  IFF_IS_CSUMOK((dev)->d_flags)
+#else
+#  define NETDEV_TXCSUM(dev,f)  (0)
+#  define NETDEV_RXCSUMOK(dev)  (0)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -149,6 +180,11 @@
 /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
  * statistics, then this structure holds the counts of network driver
  * events.
+ *
+ * The counts are only ever incremented with the network locked, but they
+ * are read without taking the lock (by procfs and SIOCGIFSTATS).  Each
+ * count is a naturally aligned 32-bit word so that such a read never sees
+ * a partially updated value; the byte counts simply wrap at 4GiB.
  */
 
 struct netdev_statistics_s
@@ -156,6 +192,7 @@ struct netdev_statistics_s
   /* Rx Status */
 
   uint32_t rx_packets;     /* Number of packets received */
+  uint32_t rx_bytes;       /* Number of bytes received (incl. link header) */
   uint32_t rx_fragments;   /* Number of fragments received */
   uint32_t rx_errors;      /* Number of receive errors */
 #ifdef CONFIG_NET_IPv4
@@ -172,6 +209,7 @@ struct netdev_statistics_s
   /* Tx Status */
 
   uint32_t tx_packets;     /* Number of Tx packets queued */
+  uint32_t tx_bytes;       /* Number of bytes passed to the driver */
   uint32_t tx_done;        /* Number of packets completed */
   uint32_t tx_errors;      /* Number of receive errors (incl timeouts) */
   uint32_t tx_timeouts;    /* Number of Tx timeout errors */
@@ -227,6 +265,12 @@ struct net_driver_s
 
   uint8_t d_flags;
 
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* Checksum offload capabilities.  See NETDEV_TXCSUM_* definitions */
+
+  uint8_t d_csumcaps;
+#endif
+
   /* Multi network devices using multiple data links protocols are selected */
 
   uint8_t d_lltype;             /* See enum net_lltype_e */
@@ -339,6 +383,17 @@ struct net_driver_s
   struct netdev_statistics_s d_statistics;
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMP
+  /* A driver whose hardware timestamps received packets stores the time
+   * of reception of the packet in d_buf here before passing the packet
+   * to ipv4_input() or ipv6_input().  The field is cleared again when the
+   * input function returns, so drivers without hardware timestamps may
+   * simply leave it untouched.  A zero value means "no timestamp".
+   */
+
+  struct timespec d_rxtime;
+#endif
+
   /* Application callbacks:
    *
    * Network device event handlers are retained in a 'list' and are called
@@ -384,6 +439,10 @@ struct net_driver_s
 
 typedef int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+/* Used by netdev_rxbatch() to load the next received frame into d_buf[] */
+
+typedef int (*netdev_rxpull_t)(FAR struct net_driver_s *dev);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -570,6 +629,27 @@ void neighbor_out(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_rxbatch
+ *
+ * Description:
+ *   Receive and process up to 'budget' Ethernet frames within a single
+ *   network lock section.  'pull' loads the next received frame into
+ *   d_buf[] (returning zero when there are no more frames) and 'reply'
+ *   sends the frame in d_buf[] as-is.  Returns the number of frames
+ *   removed from the hardware.  A return value equal to 'budget' means
+ *   that more frames are probably pending and that the driver should
+ *   continue in polling mode with its RX interrupt disabled.
+ *
+ *   The network must be locked by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ETHERNET
+int netdev_rxbatch(FAR struct net_driver_s *dev, netdev_rxpull_t pull,
+                   devif_poll_callback_t reply, int budget);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -66,6 +66,12 @@
 #ifdef CONFIG_NET_IGMP
 #  include <nuttx/net/igmp.h>
 #endif
+#ifdef CONFIG_NET_ARP
+#  include <nuttx/net/arp.h>
+#endif
+#ifdef CONFIG_NET_6LOWPAN
+#  include <nuttx/net/sixlowpan.h>
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
 
@@ -83,6 +89,10 @@
 
 struct net_stats_s
 {
+#ifdef CONFIG_NET_ARP
+  struct arp_stats_s  arp;      /* ARP statistics */
+#endif
+
 #ifdef CONFIG_NET_IPv4
   struct ipv4_stats_s ipv4;     /* IPv4 statistics */
 #endif
@@ -110,6 +120,10 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_6LOWPAN
+  struct sixlowpan_stats_s sixlowpan; /* 6LoWPAN reassembly statistics */
+#endif
 };
 
 /****************************************************************************
@@ -442,6 +442,21 @@ struct sixlowpan_reassbuf_s
   systime_t rb_time;
 };
 
+/* The structure holding the 6LoWPAN reassembly statistics that are
+ * gathered if CONFIG_NET_STATISTICS is defined.
+ */
+
+#ifdef CONFIG_NET_STATISTICS
+struct sixlowpan_stats_s
+{
+  net_stats_t reassembled; /* Number of packets successfully reassembled */
+  net_stats_t timeout;     /* Number of reassemblies that timed out */
+  net_stats_t evict;       /* Number of reassemblies evicted for a new one */
+  net_stats_t nomem;       /* Number of fragments lost for lack of IOBs */
+  net_stats_t drop;        /* Number of fragments with no reassembly */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -473,10 +488,10 @@ struct sixlowpan_reassbuf_s
  *   they are received (meaning for the driver, that two packet buffers are
  *   required:  One for reassembly of RX packets and one used for TX polling).
  *
- *   After each frame is processed into d_buf, the IOB is deallocated.  If
- *   reassembly is incomplete, the partially reassembled packet must be
- *   preserved by the radio network drvier and provided again when the next
- *   frame is received.
+ *   After each frame is processed, the IOB is deallocated.  Fragments of
+ *   packets that are not yet complete are held by the 6LoWPAN layer in
+ *   IOB chains, so the driver's d_buf need not be preserved between
+ *   frames.
  *
  *   When the packet in the d_buf is fully reassembled, it will be provided
  *   to the network as with any other received packet.  d_len will be set
@@ -696,13 +696,39 @@ int nx_filltrapezoid(NXWINDOW hwnd, FAR const struct nxgl_rect_s *clip,
                      FAR const struct nxgl_trapezoid_s *trap,
                      nxgl_mxpixel_t color[CONFIG_NX_NPLANES]);
 
+/****************************************************************************
+ * Name: nx_filltraplist
+ *
+ * Description:
+ *  Fill a list of trapezoidal regions in the window with the specified
+ *  color.  This is faster than a sequence of nx_filltrapezoid() calls:  The
+ *  list is sent to the server in one message and the server rasterizes
+ *  all of the trapezoids in a single pass.  Shapes such as circles and wide
+ *  lines that are broken up into trapezoids should be drawn this way.
+ *
+ * Input Parameters:
+ *   hwnd   - The window handle
+ *   clip   - Clipping rectangle relative to window (may be null)
+ *   traps  - The list of trapezoidal regions to be filled
+ *   ntraps - The number of trapezoids in the list
+ *   color  - The color to use in the fill
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_filltraplist(NXWINDOW hwnd, FAR const struct nxgl_rect_s *clip,
+                    FAR const struct nxgl_trapezoid_s *traps, int ntraps,
+                    nxgl_mxpixel_t color[CONFIG_NX_NPLANES]);
+
 /****************************************************************************
  * Name: nx_drawline
  *
  * Description:
  *  Fill the specified line in the window with the specified color.  This
  *  is simply a wrapper that uses nxgl_splitline() to break the line into
- *  trapezoids and then calls nx_filltrapezoid() to render the line.
+ *  trapezoids and then calls nx_filltraplist() to render the line.
  *
  * Input Parameters:
  *   hwnd   - The window handle
@@ -828,6 +854,47 @@ int nx_bitmap(NXWINDOW hwnd, FAR const struct nxgl_rect_s *dest,
               FAR const void *src[CONFIG_NX_NPLANES],
               FAR const struct nxgl_point_s *origin, unsigned int stride);
 
+/****************************************************************************
+ * Name: nx_beginbatch
+ *
+ * Description:
+ *   Begin collecting the drawing requests of this client.  Subsequent calls
+ *   to nx_fill(), nx_setpixel(), nx_filltrapezoid(), nx_filltraplist(),
+ *   nx_move(), and nx_bitmap() are buffered and sent to the server together
+ *   when the buffer fills, when nx_endbatch() is called, or before any other
+ *   request is sent to the server.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+int nx_beginbatch(NXHANDLE handle);
+#endif
+
+/****************************************************************************
+ * Name: nx_endbatch
+ *
+ * Description:
+ *   Send all of the drawing requests collected since nx_beginbatch() to the
+ *   server and stop batching.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+int nx_endbatch(NXHANDLE handle);
+#endif
+
 /****************************************************************************
  * Name: nx_notify_rectangle
  *
@@ -112,6 +112,15 @@ struct nxbe_window_s
   /* Client state information this is provide in window callbacks */
 
   FAR void *arg;
+
+#ifdef CONFIG_NX_DAMAGE
+  /* Accumulated redraw requests that have not yet been sent to the client.
+   * These are in window-relative coordinates.
+   */
+
+  uint8_t ndamage;                    /* Number of valid damage[] entries */
+  struct nxgl_rect_s damage[CONFIG_NX_DAMAGE_NRECTS];
+#endif
 };
 
 /****************************************************************************
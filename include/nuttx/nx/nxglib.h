@@ -344,6 +344,48 @@ void nxgl_filltrapezoid_32bpp(FAR NX_PLANEINFOTYPE *pinfo,
                               FAR const struct nxgl_rect_s *bounds,
                               uint32_t color);
 
+/****************************************************************************
+ * Name: nxglib_filltraplist_*bpp
+ *
+ * Description:
+ *   Fill a list of trapezoidal regions in the graphics memory with a fixed
+ *   color, clipped to a bounding box.  The trapezoids are rasterized
+ *   together, one row at a time, and the spans of all trapezoids on each
+ *   row are merged so that every pixel is written once.  This is faster
+ *   than filling the trapezoids one at a time when a complex shape has been
+ *   broken into a set of trapezoids.
+ *
+ ****************************************************************************/
+
+void nxgl_filltraplist_1bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_trapezoid_s *traps,
+                            int ntraps, FAR const struct nxgl_rect_s *bounds,
+                            uint8_t color);
+void nxgl_filltraplist_2bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_trapezoid_s *traps,
+                            int ntraps, FAR const struct nxgl_rect_s *bounds,
+                            uint8_t color);
+void nxgl_filltraplist_4bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_trapezoid_s *traps,
+                            int ntraps, FAR const struct nxgl_rect_s *bounds,
+                            uint8_t color);
+void nxgl_filltraplist_8bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                            FAR const struct nxgl_trapezoid_s *traps,
+                            int ntraps, FAR const struct nxgl_rect_s *bounds,
+                            uint8_t color);
+void nxgl_filltraplist_16bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                             FAR const struct nxgl_trapezoid_s *traps,
+                             int ntraps, FAR const struct nxgl_rect_s *bounds,
+                             uint16_t color);
+void nxgl_filltraplist_24bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                             FAR const struct nxgl_trapezoid_s *traps,
+                             int ntraps, FAR const struct nxgl_rect_s *bounds,
+                             uint32_t color);
+void nxgl_filltraplist_32bpp(FAR NX_PLANEINFOTYPE *pinfo,
+                             FAR const struct nxgl_trapezoid_s *traps,
+                             int ntraps, FAR const struct nxgl_rect_s *bounds,
+                             uint32_t color);
+
 /****************************************************************************
  * Name: nxgl_moverectangle_*bpp
  *
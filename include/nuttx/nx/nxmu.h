@@ -68,6 +68,21 @@
 #  define CONFIG_NX_MXCLIENTMSGS 16 /* Number of pending messages in each client MQ */
 #endif
 
+#ifdef CONFIG_NXMU_BATCH
+#  ifndef CONFIG_NXMU_BATCHSIZE
+#    define CONFIG_NXMU_BATCHSIZE 2048
+#  endif
+
+/* Each request in a batch buffer is preceded by a header that holds the
+ * size of the entry.  Entries are aligned so that the messages may contain
+ * pointers.
+ */
+
+#  define NXMU_BATCH_HDRSIZE   sizeof(uintptr_t)
+#  define NXMU_BATCH_ALIGN(n)  (((n) + sizeof(uintptr_t) - 1) & \
+                                ~(sizeof(uintptr_t) - 1))
+#endif
+
 /* Used to create unique client MQ name */
 
 #define NX_CLIENT_MQNAMEFMT  "nxc%d"
@@ -103,6 +118,18 @@ enum nx_clistate_e
   NX_CLISTATE_DISCONNECT_PENDING, /* Waiting for server to acknowledge disconnect */
 };
 
+#ifdef CONFIG_NXMU_BATCH
+/* A buffer of client drawing requests that are sent to the server together */
+
+struct nxmu_batch_s
+{
+  uintptr_t buffer[CONFIG_NXMU_BATCHSIZE / sizeof(uintptr_t)];
+  size_t nbytes;          /* Number of bytes queued in buffer[] */
+  bool inflight;          /* True: The server is not yet finished with buffer[] */
+  sem_t done;             /* Posted by the server when it has finished */
+};
+#endif
+
 /* This structure represents a connection between the client and the server */
 
 struct nxfe_conn_s
@@ -117,6 +144,17 @@ struct nxfe_conn_s
   mqd_t crdmq;            /* MQ to read from the server (may be non-blocking) */
   mqd_t cwrmq;            /* MQ to write to the server (blocking) */
 
+#ifdef CONFIG_NXMU_BATCH
+  /* Drawing requests are collected here between nx_beginbatch() and
+   * nx_endbatch().
+   */
+
+  sem_t batchsem;         /* Protects the batch state */
+  bool batching;          /* True: Drawing requests are being batched */
+  uint8_t curbatch;       /* Index of the batch buffer being filled */
+  FAR struct nxmu_batch_s *batch; /* Two batch buffers (allocated on first use) */
+#endif
+
   /* These are only usable on the server side of the connection */
 
   mqd_t swrmq;            /* MQ to write to the client */
@@ -154,12 +192,14 @@ enum nxmsg_e
   NX_SVRMSG_FILL,             /* Fill a rectangle in the window with a color */
   NX_SVRMSG_GETRECTANGLE,     /* Get a rectangular region in the window */
   NX_SVRMSG_FILLTRAP,         /* Fill a trapezoidal region in the window with a color */
+  NX_SVRMSG_FILLTRAPLIST,     /* Fill a list of trapezoidal regions with a color */
   NX_SVRMSG_MOVE,             /* Move a rectangular region within the window */
   NX_SVRMSG_BITMAP,           /* Copy a rectangular bitmap into the window */
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_BATCH             /* A buffer of batched drawing requests */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -388,6 +428,23 @@ struct nxsvrmsg_filltrapezoid_s
   nxgl_mxpixel_t color[CONFIG_NX_NPLANES]; /* Color to use in the fill */
 };
 
+/* Fill a list of trapezoidal regions in the window with a color.  The
+ * trapezoids remain in client memory; the server posts sem_done when it no
+ * longer needs them.  In a batch, the trapezoids follow the message in the
+ * batch buffer and sem_done is NULL.
+ */
+
+struct nxsvrmsg_filltraplist_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_FILLTRAPLIST */
+  FAR struct nxbe_window_s *wnd;   /* The window to fill  */
+  struct nxgl_rect_s clip;         /* The clipping window */
+  FAR const struct nxgl_trapezoid_s *traps; /* The trapezoidal regions to fill */
+  int ntraps;                      /* The number of trapezoids */
+  nxgl_mxpixel_t color[CONFIG_NX_NPLANES]; /* Color to use in the fill */
+  sem_t *sem_done;                 /* Semaphore to report when command is done. */
+};
+
 /* Move a rectangular region within the window */
 
 struct nxsvrmsg_move_s
@@ -411,6 +468,20 @@ struct nxsvrmsg_bitmap_s
   sem_t *sem_done;                /* Semaphore to report when command is done. */
 };
 
+/* A buffer of drawing requests.  The buffer holds a sequence of entries,
+ * each consisting of a NXMU_BATCH_HDRSIZE header (holding the size of the
+ * entry) followed by a SETPIXEL, FILL, FILLTRAP, FILLTRAPLIST, MOVE, or
+ * BITMAP message.
+ */
+
+struct nxsvrmsg_batch_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_BATCH */
+  FAR const void *buffer;          /* The batched requests */
+  size_t buflen;                   /* The size of the batched requests in bytes */
+  sem_t *sem_done;                 /* Semaphore to report when the batch is done */
+};
+
 /* Set the color of the background */
 
 struct nxsvrmsg_setbgcolor_s
@@ -561,6 +632,72 @@ int nxmu_sendserver(FAR struct nxfe_conn_s *conn,
 int nxmu_sendwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
                     size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_queuewindow
+ *
+ * Description:
+ *  Add a drawing request for a specific window to the current batch.  If
+ *  the client is not batching requests, the message is sent immediately
+ *  via nxmu_sendwindow().
+ *
+ * Input Parameters:
+ *   wnd    - A pointer to the back-end window structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+int nxmu_queuewindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
+                     size_t msglen);
+#else
+#  define nxmu_queuewindow(wnd,msg,msglen) nxmu_sendwindow(wnd,msg,msglen)
+#endif
+
+/****************************************************************************
+ * Name: nxmu_batchreserve
+ *
+ * Description:
+ *  Reserve space for a message of 'msglen' bytes in the current batch
+ *  buffer, sending the buffer to the server first if it is full.  The
+ *  caller must hold conn->batchsem.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   A pointer to the reserved space; NULL if the client is not batching or
+ *   if the message can not be batched.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+FAR void *nxmu_batchreserve(FAR struct nxfe_conn_s *conn, size_t msglen);
+#endif
+
+/****************************************************************************
+ * Name: nxmu_batchsend
+ *
+ * Description:
+ *  Send any queued drawing requests to the server.  The caller must hold
+ *  conn->batchsem.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+int nxmu_batchsend(FAR struct nxfe_conn_s *conn);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -221,8 +221,22 @@
  *   the (asynchronous) page fill logic.  If the fill takes longer than this
  *   number if microseconds, then a fatal error will be declared.
  *   Default: No timeouts monitored.
+ * CONFIG_PAGING_READAHEAD - The number of pages following a faulting page
+ *   that are also filled.  Default: 0.
+ * CONFIG_PAGING_NFILLS - The maximum number of asynchronous fills that may
+ *   be in progress at the same time.  Default: 1.
  */
 
+/* The virtual address that caused the page fault of a task.  The common
+ * paging logic also sets this to request read-ahead fills using the TCB of
+ * the page fill worker thread.  Architectures that keep the fault address
+ * elsewhere must define PG_FAULTADDR in their arch/irq.h.
+ */
+
+#ifndef PG_FAULTADDR
+#  define PG_FAULTADDR(tcb)        ((tcb)->xcp.far)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -226,6 +226,38 @@
                                              */
 #endif
 
+/* CONFIG_PM_GOVERNOR enables the predictive idle state governor.  The
+ * target residency and exit latency of each reduced power state are given
+ * in microseconds by:
+ *
+ * CONFIG_PM_xxx_RESIDENCY - The minimum time in state xxx to save energy.
+ * CONFIG_PM_xxx_EXITLATENCY - The time to resume normal operation from xxx.
+ */
+
+#ifdef CONFIG_PM_GOVERNOR
+#  ifndef CONFIG_PM_GOVERNOR_NHISTORY
+#    define CONFIG_PM_GOVERNOR_NHISTORY  8
+#  endif
+#  ifndef CONFIG_PM_IDLE_RESIDENCY
+#    define CONFIG_PM_IDLE_RESIDENCY     0
+#  endif
+#  ifndef CONFIG_PM_IDLE_EXITLATENCY
+#    define CONFIG_PM_IDLE_EXITLATENCY   0
+#  endif
+#  ifndef CONFIG_PM_STANDBY_RESIDENCY
+#    define CONFIG_PM_STANDBY_RESIDENCY  5000
+#  endif
+#  ifndef CONFIG_PM_STANDBY_EXITLATENCY
+#    define CONFIG_PM_STANDBY_EXITLATENCY 500
+#  endif
+#  ifndef CONFIG_PM_SLEEP_RESIDENCY
+#    define CONFIG_PM_SLEEP_RESIDENCY    100000
+#  endif
+#  ifndef CONFIG_PM_SLEEP_EXITLATENCY
+#    define CONFIG_PM_SLEEP_EXITLATENCY  10000
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -454,6 +486,29 @@ void pm_activity(int domain, int priority);
 
 enum pm_state_e pm_checkstate(int domain);
 
+/****************************************************************************
+ * Name: pm_idleexit
+ *
+ * Description:
+ *   This function is called from the MCU-specific IDLE loop when it wakes
+ *   up from the low power state entered after pm_checkstate().  The
+ *   duration of the idle period is recorded in the residency statistics of
+ *   the current state and in the history used by the predictive governor.
+ *
+ * Input Parameters:
+ *   domain - The PM domain that was checked
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_GOVERNOR
+void pm_idleexit(int domain);
+#else
+#  define pm_idleexit(domain)
+#endif
+
 /****************************************************************************
  * Name: pm_changestate
  *
@@ -506,6 +561,7 @@ int pm_changestate(int domain, enum pm_state_e newstate);
 #  define pm_activity(domain,prio)
 #  define pm_checkstate(domain)       (0)
 #  define pm_changestate(domain,state)
+#  define pm_idleexit(domain)
 
 #endif /* CONFIG_PM */
 #endif /* __INCLUDE_NUTTX_POWER_PM_H */
@@ -0,0 +1,270 @@
+/****************************************************************************
+ * include/nuttx/rwsem.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RWSEM_H
+#define __INCLUDE_NUTTX_RWSEM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_RWSEM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_RWSEM_LINESIZE
+#  define CONFIG_RWSEM_LINESIZE 32
+#endif
+
+/* Value of the holder field when no writer holds the lock */
+
+#define RWSEM_NO_HOLDER ((pid_t)-1)
+
+/* Initializer for statically allocated reader-writer semaphores */
+
+#define RWSEM_INITIALIZER \
+  {{{0}}, 0, RWSEM_NO_HOLDER, \
+   SEM_INITIALIZER(1), SEM_INITIALIZER(0), SEM_INITIALIZER(0)}
+
+/* Wait indefinitely */
+
+#define nxrwsem_rdlock(r)  nxrwsem_timedrdlock((r), NULL)
+#define nxrwsem_wrlock(r)  nxrwsem_timedwrlock((r), NULL)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* One CPU's count of readers.  A thread may migrate between taking and
+ * releasing a read lock so an individual count may become negative:  Only
+ * the sum of all counts is meaningful.  Each count is padded so that the
+ * counts of different CPUs fall in different cache lines.
+ */
+
+struct rwsem_count_s
+{
+  volatile int32_t count;
+  uint8_t pad[CONFIG_RWSEM_LINESIZE - sizeof(int32_t)];
+};
+
+/* A reader-writer semaphore.  Readers touch only the count of the CPU that
+ * they run on and a shared read-mostly writer count.  Writers have
+ * preference:  No new reader enters while any writer holds or is waiting
+ * for the lock.
+ */
+
+struct rwsem_s
+{
+  struct rwsem_count_s readers[CONFIG_SMP_NCPUS]; /* Per-CPU reader counts */
+  volatile int32_t writers;      /* Writers holding or waiting for the lock */
+  pid_t holder;                  /* The writer that holds the lock */
+  sem_t wlock;                   /* Serializes writers */
+  sem_t wsem;                    /* Wakes the writer waiting for readers */
+  sem_t rsem;                    /* Wakes readers waiting for writers */
+};
+
+typedef struct rwsem_s rwsem_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxrwsem_init
+ *
+ * Description:
+ *   Initialize a reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be initialized
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_init(FAR rwsem_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_destroy
+ *
+ * Description:
+ *   Destroy a reader-writer semaphore that is not locked.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be destroyed
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:  -EBUSY if the semaphore is locked.
+ *
+ ****************************************************************************/
+
+int nxrwsem_destroy(FAR rwsem_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_timedrdlock and nxrwsem_tryrdlock
+ *
+ * Description:
+ *   Lock a reader-writer semaphore for reading.  In the uncontended case,
+ *   this only increments the reader count of the current CPU.  If a writer
+ *   holds or is waiting for the lock, nxrwsem_timedrdlock() blocks until
+ *   no writer remains or until the absolute time 'abstime' (if non-NULL)
+ *   passes.  nxrwsem_tryrdlock() does not block.  Waits are not
+ *   interrupted by signals.
+ *
+ * Input Parameters:
+ *   rwsem   - The reader-writer semaphore to lock
+ *   abstime - The absolute time to wait until (CLOCK_REALTIME) or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:
+ *
+ *   -EDEADLK   - The caller holds the semaphore for writing
+ *   -EBUSY     - nxrwsem_tryrdlock() only:  A writer is present
+ *   -ETIMEDOUT - nxrwsem_timedrdlock() only:  The timeout expired
+ *
+ ****************************************************************************/
+
+int nxrwsem_timedrdlock(FAR rwsem_t *rwsem,
+                        FAR const struct timespec *abstime);
+int nxrwsem_tryrdlock(FAR rwsem_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_rdunlock
+ *
+ * Description:
+ *   Release a read lock on a reader-writer semaphore.  If this was the last
+ *   reader and a writer is waiting, the writer is awakened.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to unlock
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int nxrwsem_rdunlock(FAR rwsem_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_timedwrlock and nxrwsem_trywrlock
+ *
+ * Description:
+ *   Lock a reader-writer semaphore for writing.  New readers are held off
+ *   as soon as the writer arrives.  nxrwsem_timedwrlock() then waits for
+ *   any other writer and for the readers already in the lock to leave, or
+ *   until the absolute time 'abstime' (if non-NULL) passes.
+ *   nxrwsem_trywrlock() does not block.  Waits are not interrupted by
+ *   signals.
+ *
+ * Input Parameters:
+ *   rwsem   - The reader-writer semaphore to lock
+ *   abstime - The absolute time to wait until (CLOCK_REALTIME) or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:
+ *
+ *   -EDEADLK   - The caller already holds the semaphore for writing
+ *   -EBUSY     - nxrwsem_trywrlock() only:  The semaphore is locked
+ *   -ETIMEDOUT - nxrwsem_timedwrlock() only:  The timeout expired
+ *
+ ****************************************************************************/
+
+int nxrwsem_timedwrlock(FAR rwsem_t *rwsem,
+                        FAR const struct timespec *abstime);
+int nxrwsem_trywrlock(FAR rwsem_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_wrunlock
+ *
+ * Description:
+ *   Release the write lock on a reader-writer semaphore.  If another writer
+ *   is waiting, it receives the lock next.  Otherwise, all waiting readers
+ *   are awakened.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to unlock
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EPERM is returned if the caller
+ *   does not hold the write lock.
+ *
+ ****************************************************************************/
+
+int nxrwsem_wrunlock(FAR rwsem_t *rwsem);
+
+/****************************************************************************
+ * Name: nxrwsem_iswriter
+ *
+ * Description:
+ *   Return true if the calling thread holds the write lock.
+ *
+ ****************************************************************************/
+
+#define nxrwsem_iswriter(r) ((r)->holder == getpid())
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RWSEM */
+#endif /* __INCLUDE_NUTTX_RWSEM_H */
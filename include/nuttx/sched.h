@@ -54,6 +54,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mm/shm.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
@@ -327,6 +328,11 @@ struct sporadic_s
   uint32_t  repl_period;            /* Sporadic replenishment period            */
   uint32_t  budget;                 /* Sporadic execution budget period         */
   systime_t eventtime;              /* Time thread suspended or [re-]started    */
+#ifdef CONFIG_SCHED_DEADLINE
+  uint16_t  bandwidth;              /* Admitted bandwidth (parts per thousand)  */
+  uint32_t  deadline;               /* Relative deadline (0=not SCHED_DEADLINE) */
+  systime_t abs_deadline;           /* Absolute deadline of the current period  */
+#endif
 
   /* This is the last interval timer activated */
 
@@ -614,7 +620,7 @@ struct tcb_s
 #endif
   uint16_t flags;                        /* Misc. general status flags          */
   int16_t  lockcount;                    /* 0=preemptable (not-locked)          */
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_CRITMONITOR)
   int16_t  irqcount;                     /* 0=interrupts enabled                */
 #endif
 #ifdef CONFIG_CANCELLATION_POINTS
@@ -628,8 +634,30 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  uint32_t readytime;                    /* Time made ready (usec, 0=not set)   */
+#endif
+#ifdef CONFIG_SCHED_CPUTIME
+  uint64_t cputime;                      /* Accumulated execution time (cycles) */
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+  uint32_t premp_start;                  /* Cycle count when pre-emption disabled */
+  uint32_t premp_time;                   /* Cycles disabled before a suspension */
+  uint32_t premp_max;                    /* Longest pre-emption disabled (cycles) */
+  FAR void *premp_caller;                /* Where pre-emption was disabled      */
+  uint32_t crit_start;                   /* Cycle count when csection entered   */
+  uint32_t crit_time;                    /* Cycles held before a suspension     */
+  uint32_t crit_max;                     /* Longest critical section (cycles)   */
+  FAR void *crit_caller;                 /* Where the csection was entered      */
+#endif
 
   FAR struct wdog_s *waitdog;            /* All timed waits use this timer      */
+#ifdef CONFIG_WDOG_SLACK
+  uint32_t timerslack;                   /* Watchdog timer slack (usec)         */
+#endif
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waithrt;              /* High resolution timed waits         */
+#endif
 
   /* Stack-Related Fields *******************************************************/
 
@@ -640,6 +668,9 @@ struct tcb_s
                                          /* Need to deallocate stack            */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#ifdef CONFIG_STACK_MONITOR
+  uint8_t   stack_peak;                  /* Highest usage reported (percent)    */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -650,6 +681,10 @@ struct tcb_s
   /* POSIX Semaphore Control Fields *********************************************/
 
   sem_t *waitsem;                        /* Semaphore ID waiting on             */
+#ifdef CONFIG_SEM_HOLDERLISTS
+  FAR struct tcb_s *wflink;              /* Next thread waiting on waitsem      */
+  FAR struct semholder_s *holdings;      /* Semaphore counts held by thread     */
+#endif
 
   /* POSIX Signal Control Fields ************************************************/
 
@@ -667,6 +702,12 @@ struct tcb_s
   FAR struct mqueue_inode_s *msgwaitq;   /* Waiting for this message queue      */
 #endif
 
+  /* File System Fields *********************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+  FAR struct pollcache_s *pollcache;     /* Persistent poll() registrations     */
+#endif
+
   /* POSIX Thread Specific Data *************************************************/
 
 #if CONFIG_NPTHREAD_KEYS > 0
@@ -676,6 +717,9 @@ struct tcb_s
   /* Library related fields *****************************************************/
 
   int pterrno;                           /* Current per-thread errno            */
+#ifdef CONFIG_MM_HEAPS
+  FAR struct mm_heap_s *heap;            /* Default heap (NULL: system heap)    */
+#endif
 
   /* State save areas ***********************************************************/
   /* The form and content of these fields are platform-specific.                */
@@ -883,7 +927,9 @@ void task_vforkabort(FAR struct task_tcb_s *child, int errcode);
  ********************************************************************************/
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
-    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SMP)
+    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SMP) || \
+    defined(CONFIG_SCHED_LATENCY) || defined(CONFIG_SCHED_CPUTIME) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 void sched_resume_scheduler(FAR struct tcb_s *tcb);
 #else
 #  define sched_resume_scheduler(tcb)
@@ -905,7 +951,8 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb);
  *
  ********************************************************************************/
 
-#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION)
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION) || \
+    defined(CONFIG_SCHED_CPUTIME) || defined(CONFIG_SCHED_CRITMONITOR)
 void sched_suspend_scheduler(FAR struct tcb_s *tcb);
 #else
 #  define sched_suspend_scheduler(tcb)
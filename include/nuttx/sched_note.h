@@ -66,6 +66,10 @@
 #  define CONFIG_SCHED_NOTE_BUFSIZE 2048
 #endif
 
+#ifndef CONFIG_SCHED_NOTE_STRING_SIZE
+#  define CONFIG_SCHED_NOTE_STRING_SIZE 64
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -106,6 +110,12 @@ enum note_type_e
   NOTE_SPINLOCK_UNLOCK = 16,
   NOTE_SPINLOCK_ABORT  = 17
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  ,
+  NOTE_DUMP_STRING     = 18,
+  NOTE_DUMP_BEGIN      = 19,
+  NOTE_DUMP_END        = 20
+#endif
 };
 
 /* This structure provides the common header of each note */
@@ -234,6 +244,16 @@ struct note_spinlock_s
   uint8_t nsp_value;            /* Value of spinlock */
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+/* This is the specific form of the NOTE_DUMP_STRING/BEGIN/END note */
+
+struct note_string_s
+{
+  struct note_common_s nst_cmn; /* Common note parameters */
+  char    nst_data[1];          /* Start of the NUL terminated string */
+};
+#endif /* CONFIG_SCHED_INSTRUMENTATION_DUMP */
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -305,6 +325,39 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock);
 #  define sched_note_spinabort(t,s)
 #endif
 
+/****************************************************************************
+ * Name: sched_note_printf, sched_note_begin, sched_note_end
+ *
+ * Description:
+ *   User trace points.  These may be called from any context, including
+ *   interrupt handlers.  sched_note_printf() records a formatted string
+ *   (truncated to CONFIG_SCHED_NOTE_STRING_SIZE).  sched_note_begin() and
+ *   sched_note_end() mark the beginning and the end of a named region of
+ *   code.  The notes are attributed to the running task.
+ *
+ * Input Parameters:
+ *   fmt  - A printf() style format string, followed by its arguments
+ *   name - The name of the region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+void sched_note_printf(FAR const char *fmt, ...);
+void sched_note_begin(FAR const char *name);
+void sched_note_end(FAR const char *name);
+#else
+#  ifdef CONFIG_CPP_HAVE_VARARGS
+#    define sched_note_printf(...)
+#  else
+#    define sched_note_printf (void)
+#  endif
+#  define sched_note_begin(n)
+#  define sched_note_end(n)
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
@@ -348,6 +401,26 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen);
 ssize_t sched_note_size(void);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_dropped
+ *
+ * Description:
+ *   Return the number of notes that have been overwritten in the circular
+ *   buffer before they could be read.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   The total (free-running) number of notes lost.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
+    defined(CONFIG_SCHED_NOTE_GET)
+uint32_t sched_note_dropped(void);
+#endif
+
 /****************************************************************************
  * Name: note_register
  *
@@ -369,6 +442,66 @@ ssize_t sched_note_size(void);
 int note_register(void);
 #endif
 
+/****************************************************************************
+ * Name: note_ctf_channel
+ *
+ * Description:
+ *   Start streaming the notes in Common Trace Format (CTF 1.8).  A low
+ *   priority kernel thread drains the circular note buffer, encodes the
+ *   notes into CTF packets and passes them to the channel.  The CTF
+ *   metadata (see note_ctf_metadata()) is passed to the channel's metadata
+ *   method once, before the first packet.
+ *
+ * Input Parameters:
+ *   channel - Describes where the metadata and the packets are written.
+ *             The structure must persist.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVER_NOTE_CTF
+typedef CODE ssize_t (*note_ctf_write_t)(FAR const uint8_t *buffer,
+                                         size_t buflen);
+
+struct note_ctf_channel_s
+{
+  note_ctf_write_t nc_metadata;  /* Write the metadata (may be NULL) */
+  note_ctf_write_t nc_stream;    /* Write a packet of the event stream */
+};
+
+int note_ctf_channel(FAR const struct note_ctf_channel_s *channel);
+
+/****************************************************************************
+ * Name: note_ctf_file
+ *
+ * Description:
+ *   Stream the notes in CTF to the files 'metadata' and 'stream' in the
+ *   directory 'dirpath' (for example, on an SD card).  That directory can
+ *   be opened directly by CTF viewers such as babeltrace or Trace Compass.
+ *
+ * Input Parameters:
+ *   dirpath - The existing directory where the trace is written.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int note_ctf_file(FAR const char *dirpath);
+
+/****************************************************************************
+ * Name: note_ctf_metadata
+ *
+ * Description:
+ *   Return the CTF metadata (TSDL) text that describes the event stream.
+ *
+ ****************************************************************************/
+
+FAR const char *note_ctf_metadata(void);
+#endif
+
 #else /* CONFIG_SCHED_INSTRUMENTATION */
 
 #  define sched_note_start(t)
@@ -387,6 +520,13 @@ int note_register(void);
 #  define sched_note_spinlocked(t,s)
 #  define sched_note_spinunlock(t,s)
 #  define sched_note_spinabort(t,s)
+#  ifdef CONFIG_CPP_HAVE_VARARGS
+#    define sched_note_printf(...)
+#  else
+#    define sched_note_printf (void)
+#  endif
+#  define sched_note_begin(n)
+#  define sched_note_end(n)
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION */
 #endif /* __INCLUDE_NUTTX_SCHED_NOTE_H */
@@ -47,6 +47,11 @@
 #include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 
+#ifdef CONFIG_SPINLOCK_SUBSYS
+#  include <nuttx/irq.h>
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +62,25 @@
 #define SEM_PRIO_INHERIT          1
 #define SEM_PRIO_PROTECT          2
 
+/* In SMP configurations without priority inheritance, semaphore counts are
+ * also protected by a subsystem spinlock.  This permits nxsem_post() to
+ * increment the count of a semaphore with no waiters without entering the
+ * global critical section.  As a consequence, any logic that modifies
+ * semcount directly must do so within the critical section AND while
+ * holding the semaphore count lock.  In all other configurations, the
+ * critical section alone is sufficient and the count lock does nothing.
+ */
+
+#if defined(CONFIG_SPINLOCK_SUBSYS) && !defined(CONFIG_PRIORITY_INHERITANCE)
+#  define HAVE_SEM_COUNTLOCK    1
+#  define nxsem_countlock()     subsys_lock(&g_semlock)
+#  define nxsem_countunlock(f)  subsys_unlock(&g_semlock, (f))
+#else
+#  undef  HAVE_SEM_COUNTLOCK
+#  define nxsem_countlock()     (0)
+#  define nxsem_countunlock(f)  ((void)(f))
+#endif
+
 /* Most internal nxsem_* interfaces are not available in the user space in
  * PROTECTED and KERNEL builds.  In that context, the application semaphore
  * interfaces must be used.  The differences between the two sets of
@@ -137,6 +161,14 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef HAVE_SEM_COUNTLOCK
+/* This spinlock protects the counts of all semaphores.  See
+ * nxsem_countlock().
+ */
+
+EXTERN struct subsys_lock_s g_semlock;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
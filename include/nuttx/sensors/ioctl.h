@@ -155,4 +155,13 @@
 #define SNIOC_SET_DATA_RATE     _SNIOC(0x003e) /* Arg: LIS3DH_ODR_xxx */
 #define SNIOC_SET_DATA_FORMAT   _SNIOC(0x003f) /* Arg: LIS3DH_FORMAT_xxx */
 
+/* IOCTL commands common to all drivers that use the sensor upper half
+ * (see include/nuttx/sensors/sensor.h)
+ */
+
+#define SNIOC_SET_WATERMARK     _SNIOC(0x0040) /* Arg: unsigned int samples */
+#define SNIOC_SET_TIMESTAMPS    _SNIOC(0x0041) /* Arg: bool value */
+#define SNIOC_GET_OVERRUNS      _SNIOC(0x0042) /* Arg: uint32_t* pointer */
+#define SNIOC_FLUSH             _SNIOC(0x0043) /* Arg: None */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
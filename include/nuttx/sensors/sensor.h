@@ -0,0 +1,207 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************
+ *
+ * CONFIG_SENSORS_UPPERHALF - Enables the common sensor upper half.
+ *   Selected by the drivers that use it.
+ * CONFIG_SENSORS_NPOLLWAITERS - Maximum number of threads that can be
+ *   waiting on poll() for one sensor.
+ */
+
+#ifndef CONFIG_SENSORS_NPOLLWAITERS
+#  define CONFIG_SENSORS_NPOLLWAITERS 2
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The sensor upper half keeps a ring of timestamped samples for each
+ * sensor.  The lower half pushes samples into the ring, usually a whole
+ * hardware FIFO at a time from its data-ready or FIFO watermark interrupt
+ * worker, and readers are woken only when the number of buffered samples
+ * reaches the watermark set with SNIOC_SET_WATERMARK (default 1).  read()
+ * then returns as many whole samples as are buffered and fit in the user
+ * buffer, oldest first.
+ *
+ * By default a sample is read as the lower half's sample structure alone.
+ * After SNIOC_SET_TIMESTAMPS(true) each sample is preceded by a uint64_t
+ * timestamp in microseconds since boot:
+ *
+ *   struct
+ *   {
+ *     uint64_t timestamp;
+ *     struct <driver>_sensor_data_s data;
+ *   };
+ *
+ * When the ring is full, the oldest samples are overwritten and counted
+ * (see SNIOC_GET_OVERRUNS).
+ */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Start (enable == true) or stop sampling.  Called on the first open()
+   * and the last close().
+   */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Optional.  Let the hardware FIFO collect up to 'nsamples' samples
+   * before it interrupts.  Called when the watermark is changed.
+   */
+
+  CODE int (*set_watermark)(FAR struct sensor_lowerhalf_s *lower,
+                            unsigned int nsamples);
+
+  /* Optional.  For sensors without a data-ready interrupt: read the
+   * sample(s) available now and push them.  Called by read() and poll()
+   * when fewer samples than the watermark are buffered.
+   */
+
+  CODE int (*fetch)(FAR struct sensor_lowerhalf_s *lower);
+
+  /* Optional.  Handle any ioctl command not handled by the upper half */
+
+  CODE int (*control)(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+
+/* The lower half state.  This structure must be the first field of the
+ * lower half's own state structure.
+ */
+
+struct sensor_lowerhalf_s
+{
+  FAR const struct sensor_ops_s *ops; /* Lower half operations */
+  FAR void *upper;                    /* Private to the upper half */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor character driver with the common upper half.
+ *
+ * Input Parameters:
+ *   path       - The full path to the driver, e.g. "/dev/accel0"
+ *   lower      - The lower half state
+ *   samplesize - The size in bytes of one sample as read by the user
+ *   nsamples   - The number of samples buffered; usually a few times the
+ *                depth of the hardware FIFO
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *path,
+                    FAR struct sensor_lowerhalf_s *lower,
+                    size_t samplesize, unsigned int nsamples);
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Add samples to the ring and wake up readers if the watermark is
+ *   reached.  The samples are oldest first; sample i is timestamped
+ *   'timestamp - (nsamples - 1 - i) * interval'.  Must be called from a
+ *   thread or worker, not from an interrupt handler.
+ *
+ * Input Parameters:
+ *   lower     - The lower half state
+ *   samples   - 'nsamples' consecutive samples of 'samplesize' bytes
+ *   nsamples  - The number of samples
+ *   timestamp - The time of the newest sample (see sensor_timestamp())
+ *   interval  - The sampling period in microseconds
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_push(FAR struct sensor_lowerhalf_s *lower,
+                FAR const void *samples, unsigned int nsamples,
+                uint64_t timestamp, uint32_t interval);
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds since boot.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPERHALF */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
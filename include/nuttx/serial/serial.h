@@ -46,6 +46,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#ifdef CONFIG_SERIAL_ICOUNT
+#  include <nuttx/serial/tioctl.h>
+#endif
 #ifdef CONFIG_SERIAL_TERMIOS
 #  include <termios.h>
 #endif
@@ -116,6 +119,16 @@
     (dev->ops->rxflowcontrol && dev->ops->rxflowcontrol(dev,n,u))
 #endif
 
+/* Statistics (TIOCGICOUNT).  Lower half drivers may use these to count
+ * frame, parity and hardware overrun errors.
+ */
+
+#ifdef CONFIG_SERIAL_ICOUNT
+#  define uart_icount(dev,f,n)   ((dev)->icount.f += (n))
+#else
+#  define uart_icount(dev,f,n)
+#endif
+
 /************************************************************************************
  * Public Types
  ************************************************************************************/
@@ -286,6 +299,10 @@ struct uart_dev_s
   tcflag_t             tc_iflag;     /* Input modes */
   tcflag_t             tc_oflag;     /* Output modes */
   tcflag_t             tc_lflag;     /* Local modes */
+#ifdef CONFIG_SERIAL_TERMIOS_RAWMODE
+  cc_t                 tc_vmin;      /* Minimum number of bytes for read() */
+  cc_t                 tc_vtime;     /* read() timeout (deciseconds) */
+#endif
 #endif
 
   /* Semaphores */
@@ -308,6 +325,17 @@ struct uart_dev_s
 
   struct uart_dmaxfer_s dmatx;       /* Describes transmit DMA transfer */
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
+
+  /* true: The RX DMA runs continuously in circular mode over recv.buffer and
+   * the lower half reports progress with uart_recvchars_ring().  Set by the
+   * lower half before uart_register() is called.
+   */
+
+  bool                 rxdmaring;
+#endif
+
+#ifdef CONFIG_SERIAL_ICOUNT
+  struct serial_icounter_struct icount; /* Statistics (TIOCGICOUNT) */
 #endif
 
   /* Driver interface */
@@ -481,6 +509,22 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_recvchars_ring
+ *
+ * Description:
+ *   Used with a circular RX DMA (see 'rxdmaring').  The lower half calls this
+ *   from its DMA half-transfer and transfer-complete interrupts and from the UART
+ *   idle-line or receive timeout interrupt, passing the index in recv.buffer
+ *   where the DMA will store the next byte.  The bytes up to that index are
+ *   made available to readers without copying them anywhere else.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DMA
+void uart_recvchars_ring(FAR uart_dev_t *dev, unsigned int head);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
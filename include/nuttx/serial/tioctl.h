@@ -204,6 +204,33 @@ struct winsize
 /* uint16_t ws_ypixel;    unused */
 };
 
+/* Structure used with TIOCGICOUNT (Linux compatible, with the NuttX interrupt
+ * counts taken from the reserved fields).
+ */
+
+struct serial_icounter_struct
+{
+  int cts;                         /* CTS transitions */
+  int dsr;                         /* DSR transitions */
+  int rng;                         /* RI transitions */
+  int dcd;                         /* DCD transitions */
+  int rx;                          /* Bytes received */
+  int tx;                          /* Bytes transmitted */
+  int frame;                       /* Framing errors */
+  int overrun;                     /* Hardware (UART) overruns */
+  int parity;                      /* Parity errors */
+  int brk;                         /* Break conditions */
+  int buf_overrun;                 /* Bytes lost because the RX buffer was full */
+  int rxint;                       /* RX interrupts and RX DMA completions */
+  int txint;                       /* TX interrupts and TX DMA completions */
+  int rdcalls;                     /* read() calls that returned data */
+  int rdbytes;                     /* Bytes returned by read() */
+  int rdwaits;                     /* Times that read() waited for data */
+  int rdtimeouts;                  /* Reads ended by the VTIME timer */
+  int rdlatency;                   /* Longest time read() was blocked (usec) */
+  int reserved[2];
+};
+
 /* Structure used with TIOCSRS485 and TIOCGRS485 (Linux compatible) */
 
 struct serial_rs485
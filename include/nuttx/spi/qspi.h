@@ -226,6 +226,32 @@
 
 #define QSPI_FREE(d,b) (d)->ops->free(d,b)
 
+/****************************************************************************
+ * Name: QSPI_MEMMAP and QSPI_UNMAP
+ *
+ * Description:
+ *   Map the FLASH into the address space of the CPU (execute-in-place) so
+ *   that it can be read like memory, or end that mapping.  The controller
+ *   issues the read command described by meminfo for each access to the
+ *   mapped window.  No other command or memory transfer is possible while
+ *   the FLASH is mapped.  Optional.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read command (buflen and buffer are ignored)
+ *   base    - The location to return the address of the mapped FLASH
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOSYS if
+ *   the controller cannot map the FLASH.
+ *
+ ****************************************************************************/
+
+#define QSPI_MEMMAP(d,m,b) \
+  ((d)->ops->memmap ? (d)->ops->memmap(d,m,b) : -ENOSYS)
+#define QSPI_UNMAP(d) \
+  ((d)->ops->memmap ? (d)->ops->memmap(d,NULL,NULL) : -ENOSYS)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -283,6 +309,9 @@ struct qspi_ops_s
                     FAR struct qspi_meminfo_s *meminfo);
   CODE FAR void *(*alloc)(FAR struct qspi_dev_s *dev, size_t buflen);
   CODE void      (*free)(FAR struct qspi_dev_s *dev, FAR void *buffer);
+  CODE int       (*memmap)(FAR struct qspi_dev_s *dev,
+                    FAR const struct qspi_meminfo_s *meminfo,
+                    FAR void **base);
 };
 
 /* QSPI private data.  This structure only defines the initial fields of the
@@ -420,6 +420,31 @@
 #define SPI_REGISTERCALLBACK(d,c,a) \
   ((d)->ops->registercallback ? (d)->ops->registercallback(d,c,a) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_TRANSFER
+ *
+ * Description:
+ *   Optional.  Perform a whole sequence of transfers (see
+ *   include/nuttx/spi/spi_transfer.h), for example by chaining one DMA
+ *   descriptor per transfer, rather than one SPI_EXCHANGE() at a time.
+ *   Used by the SPI transaction queue when the lower half provides it.
+ *   The implementation locks the bus, configures it from the sequence and
+ *   handles chip select just as spi_transfer() does.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   seq - Describes the sequence of transfers
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_QUEUE
+#  define SPI_TRANSFER(d,s) \
+     ((d)->ops->transfer ? (d)->ops->transfer(d,s) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -516,6 +541,7 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+struct spi_sequence_s;
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -550,6 +576,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_QUEUE
+  CODE int      (*transfer)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_sequence_s *seq);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
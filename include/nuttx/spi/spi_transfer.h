@@ -49,6 +49,10 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 
+#ifdef CONFIG_SPI_QUEUE
+#  include <queue.h>
+#endif
+
 #ifdef CONFIG_SPI_EXCHANGE
 
 /* SPI Character Driver IOCTL Commands **************************************/
@@ -125,6 +129,46 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_QUEUE
+/* Priority classes of queued SPI transactions.  Transactions of a higher
+ * class are always started before those of a lower class; within a class
+ * they are started in order of submission.  A transaction is never
+ * interrupted once started, so a long transfer (such as a display update)
+ * should be split into several transactions to bound the latency of the
+ * higher classes.
+ */
+
+enum spi_priority_e
+{
+  SPI_PRIORITY_HIGH = 0,       /* E.g. high-rate sensor reads */
+  SPI_PRIORITY_NORMAL,         /* Default */
+  SPI_PRIORITY_LOW,            /* E.g. bulk display or flash writes */
+  SPI_NPRIORITIES
+};
+
+struct spi_request_s;
+typedef CODE void (*spi_complete_t)(FAR struct spi_request_s *req,
+                                    int result);
+
+/* This describes one queued SPI transaction.  The request and the sequence
+ * that it refers to belong to the SPI queue from spi_submit() until the
+ * completion callback.
+ */
+
+struct spi_request_s
+{
+  sq_entry_t node;             /* Queue link (private) */
+  FAR struct spi_sequence_s *seq; /* The transaction to perform */
+  uint8_t priority;            /* See enum spi_priority_e */
+  spi_complete_t callback;     /* Called on the queue thread when done */
+  FAR void *arg;               /* Opaque argument for the callback */
+};
+
+/* The transaction queue of one SPI bus (opaque) */
+
+struct spi_queue_s;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -174,6 +218,89 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+#ifdef CONFIG_SPI_QUEUE
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Create the transaction queue of one SPI bus and start the kernel thread
+ *   that performs the queued transactions.  Transactions are performed
+ *   with SPI_TRANSFER() if the lower half provides it (typically with DMA
+ *   descriptor chaining) or else with spi_transfer().  Either way the bus
+ *   is locked for each transaction, so drivers that use the bus directly
+ *   may share it with the queue.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_submit
+ *
+ * Description:
+ *   Queue a transaction and return immediately.  req->callback, if not
+ *   NULL, is called from the queue thread with the result when the
+ *   transaction completes.  May be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - The request to queue
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the request is invalid.
+ *
+ ****************************************************************************/
+
+int spi_submit(FAR struct spi_queue_s *queue,
+               FAR struct spi_request_s *req);
+
+/****************************************************************************
+ * Name: spi_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.  Its
+ *   callback is not called.
+ *
+ * Input Parameters:
+ *   queue - The queue returned by spi_queue_initialize()
+ *   req   - The request passed to spi_submit()
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it has already been
+ *   started (or was never queued).
+ *
+ ****************************************************************************/
+
+int spi_cancel(FAR struct spi_queue_s *queue, FAR struct spi_request_s *req);
+
+/****************************************************************************
+ * Name: spi_queue_transfer
+ *
+ * Description:
+ *   Perform a sequence of transfers through the queue and wait for it to
+ *   complete.  This is the drop-in replacement of spi_transfer() for
+ *   drivers that share a queued bus.
+ *
+ * Input Parameters:
+ *   queue    - The queue returned by spi_queue_initialize()
+ *   seq      - Describes the sequence of transfers
+ *   priority - See enum spi_priority_e
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_transfer(FAR struct spi_queue_s *queue,
+                       FAR struct spi_sequence_s *seq, int priority);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -112,6 +112,33 @@ struct spinlock_s
 #endif
 };
 
+#ifdef CONFIG_SPINLOCK_SUBSYS
+/* A subsystem lock is a re-entrant spinlock that also disables local
+ * interrupts.  It is used in place of the global critical section to
+ * protect the data structures of a single OS subsystem.  See
+ * subsys_lock() and subsys_unlock().
+ */
+
+struct subsys_lock_s
+{
+  volatile spinlock_t sl_lock;  /* The spinlock protecting the subsystem */
+  volatile uint8_t sl_cpu;      /* CPU holding the lock */
+  volatile uint8_t sl_count;    /* Nesting count of the CPU holding the lock */
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+  FAR const char *sl_name;      /* Subsystem name (for reporting) */
+  uint32_t sl_acquired;         /* Number of times the lock was taken */
+  uint32_t sl_contended;        /* Number of times the lock was contended */
+  uint32_t sl_spins;            /* Total spin iterations while contended */
+#endif
+};
+
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+#  define SUBSYS_LOCK_INITIALIZER(name) { SP_UNLOCKED, 0, 0, name, 0, 0, 0 }
+#else
+#  define SUBSYS_LOCK_INITIALIZER(name) { SP_UNLOCKED, 0, 0 }
+#endif
+#endif /* CONFIG_SPINLOCK_SUBSYS */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -73,6 +73,17 @@
 #define TLS_MAXSTACK      (TLS_STACK_ALIGN)
 #define TLS_INFO(sp)      ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
 
+/* The size of the TLS area at the "lower" end of each stack:  The TLS
+ * information structure followed (with CONFIG_TLS_NATIVE) by the copy of
+ * the .tdata/.tbss templates.
+ */
+
+#ifdef CONFIG_TLS_NATIVE
+#  define TLS_INFO_SIZE   (sizeof(struct tls_info_s) + tls_native_size())
+#else
+#  define TLS_INFO_SIZE   sizeof(struct tls_info_s)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -93,6 +104,15 @@
 struct tls_info_s
 {
   uintptr_t tl_elem[CONFIG_TLS_NELEM]; /* TLS elements */
+#ifdef CONFIG_TLS_NATIVE
+  /* The ELF "variant 1" thread control block.  The ARM thread pointer
+   * points here and the .tdata/.tbss block follows immediately.  On RISC-V
+   * the thread pointer points past the end of the structure, so this only
+   * keeps that block 8-byte aligned.
+   */
+
+  uintptr_t tl_tcb[2] __attribute__((aligned(8)));
+#endif
 };
 
 /****************************************************************************
@@ -136,5 +156,38 @@ uintptr_t tls_get_element(int elem);
 
 void tls_set_element(int elem, uintptr_t value);
 
+/****************************************************************************
+ * Name: tls_native_size
+ *
+ * Description:
+ *   Return the size of the per-thread copy of the .tdata/.tbss templates,
+ *   rounded up to a multiple of 8 bytes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_NATIVE
+size_t tls_native_size(void);
+#endif
+
+/****************************************************************************
+ * Name: tls_native_init
+ *
+ * Description:
+ *   Initialize the per-thread copy of the .tdata/.tbss templates that
+ *   follows the TLS information structure 'info' at the base of a new
+ *   stack.  This is called by up_create_stack() and up_use_stack().
+ *
+ * Input Parameters:
+ *   info - The TLS information structure at the base of the new stack
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_NATIVE
+void tls_native_init(FAR struct tls_info_s *info);
+#endif
+
 #endif /* CONFIG_TLS */
 #endif /* __INCLUDE_NUTTX_TLS_H */
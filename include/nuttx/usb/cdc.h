@@ -67,7 +67,9 @@
 #define CDC_SUBCLASS_CAPI       0x05 /* CAPI Control Model */
 #define CDC_SUBCLASS_ECM        0x06 /* Ethernet Networking Control Model */
 #define CDC_SUBCLASS_ATM        0x07 /* ATM Networking Control Model */
-                                     /* 0x08-0x7f Reserved (future use) */
+                                     /* 0x08-0x0c Not supported */
+#define CDC_SUBCLASS_NCM        0x0d /* Network Control Model */
+                                     /* 0x0e-0x7f Reserved (future use) */
                                      /* 0x80-0xfe Reserved (vendor specific) */
 /* Communication Interface Class Protocol Codes ********************************************/
 /* Table 17: Communication Interface Class Control Protocol Codes */
@@ -86,7 +88,8 @@
 /* Table 19: Data Interface Class Protocol Codes */
 
 #define CDC_DATA_PROTO_NONE     0x00 /* No class specific protocol required */
-                                     /* 0x01-0x2f Reserved (future use) */
+#define CDC_DATA_PROTO_NTB      0x01 /* Network Transfer Block (NCM) */
+                                     /* 0x02-0x2f Reserved (future use) */
 #define CDC_DATA_PROTO_ISDN     0x30 /* Physical interface protocol for ISDN BRI */
 #define CDC_DATA_PROTO_HDLC     0x31 /* HDLC */
 #define CDC_DATA_PROTO_TRANSP   0x32 /* Transparent */
@@ -317,6 +320,34 @@
                                       */
 #define ECM_SPEED_CHANGE        ATM_SPEED_CHANGE
 
+/* NCM 1.0, Table 6-2: Requests, Network Control Model.  Requests 0x40-0x44
+ * are the same as the Ethernet Networking Control Model requests above.
+ */
+
+#define NCM_GET_NTB_PARAMETERS  0x80 /* Returns the NTB data structure parameters
+                                      * (Required)
+                                      */
+#define NCM_GET_NET_ADDRESS     0x81 /* Returns the current EUI-48 station address
+                                      * (Optional)
+                                      */
+#define NCM_SET_NET_ADDRESS     0x82 /* Sets the EUI-48 station address (Optional) */
+#define NCM_GET_NTB_FORMAT      0x83 /* Returns the current NTB format (Optional) */
+#define NCM_SET_NTB_FORMAT      0x84 /* Selects 16- or 32-bit NTBs (Optional) */
+#define NCM_GET_NTB_INPUT_SIZE  0x85 /* Returns the current IN NTB maximum size (Required) */
+#define NCM_SET_NTB_INPUT_SIZE  0x86 /* Selects the IN NTB maximum size (Required) */
+#define NCM_GET_MAX_DATAGRAM    0x87 /* Returns the current maximum datagram size
+                                      * (Optional)
+                                      */
+#define NCM_SET_MAX_DATAGRAM    0x88 /* Sets the maximum datagram size (Optional) */
+#define NCM_GET_CRC_MODE        0x89 /* Returns the current CRC mode (Optional) */
+#define NCM_SET_CRC_MODE        0x8a /* Sets the CRC mode (Optional) */
+
+/* NCM 1.0, Table 6-3: Notifications, Network Control Model */
+
+#define NCM_NETWORK_CONNECTION  ECM_NETWORK_CONNECTION
+#define NCM_RESPONSE_AVAILABLE  ECM_RESPONSE_AVAILABLE
+#define NCM_SPEED_CHANGE        ECM_SPEED_CHANGE
+
 /* Descriptors ******************************************************************************/
 /* Table 25: bDescriptor SubType in Functional Descriptors */
 
@@ -340,7 +371,9 @@
 #define CDC_DSUBTYPE_CAPI       0x0e /* CAPI Control Management Functional Descriptor */
 #define CDC_DSUBTYPE_ECM        0x0f /* Ethernet Networking Functional Descriptor */
 #define CDC_DSUBTYPE_ATM        0x10 /* ATM Networking Functional Descriptor */
-                                     /* 0x11-0xff Reserved (future use) */
+                                     /* 0x11-0x19 Not supported */
+#define CDC_DSUBTYPE_NCM        0x1a /* NCM Functional Descriptor */
+                                     /* 0x1b-0xff Reserved (future use) */
 
 /* Table 42: Ethernet Statistics Capabilities */
 
@@ -855,6 +888,27 @@ struct cdc_atm_funcdesc_s
 };
 #define SIZEOF_ATM_FUNCDESC 12
 
+/* NCM 1.0, Table 5-2: NCM Functional Descriptor */
+
+struct cdc_ncm_funcdesc_s
+{
+  uint8_t size;      /* bFunctionLength, Size of this descriptor */
+  uint8_t type;      /* bDescriptorType, USB_DESC_TYPE_CSINTERFACE */
+  uint8_t subtype;   /* bDescriptorSubType, CDC_DSUBTYPE_NCM */
+  uint8_t version[2]; /* bcdNcmVersion, Release number of the NCM specification */
+  uint8_t caps;      /* bmNetworkCapabilities, See NCMCAP_* definitions */
+};
+#define SIZEOF_NCM_FUNCDESC 6
+
+/* NCM 1.0, Table 5-2: bmNetworkCapabilities */
+
+#define NCMCAP_PACKET_FILTER       (1 << 0)  /* SetEthernetPacketFilter */
+#define NCMCAP_NET_ADDRESS         (1 << 1)  /* Get/SetNetAddress */
+#define NCMCAP_ENCAP_COMMAND       (1 << 2)  /* Send/GetEncapsulated* */
+#define NCMCAP_MAX_DATAGRAM        (1 << 3)  /* Get/SetMaxDatagramSize */
+#define NCMCAP_CRC_MODE            (1 << 4)  /* Get/SetCrcMode */
+#define NCMCAP_NTB_INPUT_SIZE8     (1 << 5)  /* 8-byte GetNtbInputSize */
+
 /* Descriptor Data Structures ***************************************************************/
 /* Table 50: Line Coding Structure */
 
@@ -867,6 +921,60 @@ struct cdc_linecoding_s
 };
 #define SIZEOF_CDC_LINECODING 7
 
+/* NCM 1.0, Table 6-3: NTB Parameter Structure */
+
+struct cdc_ncm_ntbparms_s
+{
+  uint8_t len[2];        /* wLength, Size of this structure (28) */
+  uint8_t formats[2];    /* bmNtbFormatsSupported, Bit 0: NTB16, bit 1: NTB32 */
+  uint8_t inmaxsize[4];  /* dwNtbInMaxSize, IN NTB maximum size in bytes */
+  uint8_t indivisor[2];  /* wNdpInDivisor, IN datagram alignment modulus */
+  uint8_t inremain[2];   /* wNdpInPayloadRemainder, IN datagram alignment remainder */
+  uint8_t inalign[2];    /* wNdpInAlignment, IN NDP alignment */
+  uint8_t reserved[2];
+  uint8_t outmaxsize[4]; /* dwNtbOutMaxSize, OUT NTB maximum size in bytes */
+  uint8_t outdivisor[2]; /* wNdpOutDivisor, OUT datagram alignment modulus */
+  uint8_t outremain[2];  /* wNdpOutPayloadRemainder, OUT datagram alignment remainder */
+  uint8_t outalign[2];   /* wNdpOutAlignment, OUT NDP alignment */
+  uint8_t outmaxdg[2];   /* wNtbOutMaxDatagrams, Maximum datagrams per OUT NTB */
+};
+#define SIZEOF_NCM_NTBPARMS 28
+
+/* NCM 1.0, Table 3-1: 16-bit NCM Transfer Header (NTH16) */
+
+#define NCM_NTH16_SIGNATURE 0x484d434e /* "NCMH" */
+
+struct cdc_ncm_nth16_s
+{
+  uint8_t signature[4]; /* dwSignature, NCM_NTH16_SIGNATURE */
+  uint8_t hdrlen[2];    /* wHeaderLength, Size of this header (12) */
+  uint8_t sequence[2];  /* wSequence, Sequence number of the NTB */
+  uint8_t blocklen[2];  /* wBlockLength, Size of the NTB in bytes */
+  uint8_t ndpindex[2];  /* wNdpIndex, Offset of the first NDP in the NTB */
+};
+#define SIZEOF_NCM_NTH16 12
+
+/* NCM 1.0, Table 3-3: 16-bit NCM Datagram Pointer Table (NDP16).  The table
+ * of datagram index/length pairs is terminated by a pair of zeros.
+ */
+
+#define NCM_NDP16_SIGNATURE 0x304d434e /* "NCM0", no CRC */
+
+struct cdc_ncm_dpe16_s
+{
+  uint8_t index[2];     /* wDatagramIndex, Offset of the datagram in the NTB */
+  uint8_t len[2];       /* wDatagramLength, Size of the datagram in bytes */
+};
+
+struct cdc_ncm_ndp16_s
+{
+  uint8_t signature[4]; /* dwSignature, NCM_NDP16_SIGNATURE */
+  uint8_t len[2];       /* wLength, Size of this NDP */
+  uint8_t nextndp[2];   /* wNextNdpIndex, Offset of the next NDP or zero */
+  struct cdc_ncm_dpe16_s dpe[1]; /* Datagram pointer entries follow */
+};
+#define SIZEOF_NCM_NDP16(n) (8 + 4 * (n))
+
 /* Table 55: Line Status Information Structure */
 
 struct cdc_linestatus_s
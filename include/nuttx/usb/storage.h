@@ -120,6 +120,26 @@ struct usbmsc_csw_s
   uint8_t status;                 /* Status of transfer */
 };
 
+#ifdef CONFIG_USBHOST_MSC_STATS
+/* USB host mass storage transfer statistics returned by the BIOC_GETSTATS
+ * ioctl command.  Times are in units of system clock ticks.  The read
+ * throughput is rdblocks * sector size / rdticks.
+ */
+
+struct usbhost_msc_stats_s
+{
+  uint32_t nreads;                /* Number of read requests */
+  uint32_t nwrites;               /* Number of write requests */
+  uint32_t ncmds;                 /* Number of READ(10)/WRITE(10) commands */
+  uint32_t rdblocks;              /* Number of blocks read */
+  uint32_t wrblocks;              /* Number of blocks written */
+  uint32_t rahits;                /* Blocks read from the read-ahead buffer */
+  uint32_t nerrors;               /* Number of failed requests */
+  uint32_t rdticks;               /* Total time of the read requests */
+  uint32_t wrticks;               /* Total time of the write requests */
+};
+#endif
+
 /************************************************************************************
  * Public Data
  ************************************************************************************/
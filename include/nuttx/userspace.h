@@ -87,7 +87,8 @@
  * Public Type Definitions
  ****************************************************************************/
 
-struct mm_heaps_s; /* Forward reference */
+struct mm_heaps_s;       /* Forward reference */
+struct clock_timepage_s; /* Forward reference */
 
  /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s.  An
@@ -132,6 +133,12 @@ struct userspace_s
 #ifdef CONFIG_LIB_USRWORK
   int (*work_usrstart)(void);
 #endif
+
+  /* Time page updated by the kernel on each system timer tick */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  FAR struct clock_timepage_s *us_timepage;
+#endif
 };
 
 /****************************************************************************
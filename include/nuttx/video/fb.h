@@ -228,6 +228,17 @@
                                             *           nxgl_rect_s */
 #endif
 
+#ifdef CONFIG_FB_MULTIBUFFER
+#  define FBIOPAN_DISPLAY  _FBIOC(0x0008)  /* Select the displayed frame
+                                            * Argument: read-only struct
+                                            *           fb_planeinfo_s */
+#endif
+
+#ifdef CONFIG_FB_SYNC
+#  define FBIO_WAITFORVSYNC _FBIOC(0x0009) /* Wait for vertical sync
+                                            * Argument: None */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -259,8 +270,26 @@ struct fb_planeinfo_s
   fb_coord_t stride;      /* Length of a line in bytes */
   uint8_t    display;     /* Display number */
   uint8_t    bpp;         /* Bits per pixel */
+#ifdef CONFIG_FB_MULTIBUFFER
+  fb_coord_t yres_virtual; /* Rows in the frame buffer memory (N * yres) */
+  fb_coord_t yoffset;     /* First row of the displayed frame */
+#endif
 };
 
+/* This structure describes a rectangular region of a color plane that is
+ * operated on by the optional hardware acceleration methods.
+ */
+
+#ifdef CONFIG_FB_HWACCEL
+struct fb_area_s
+{
+  fb_coord_t x;           /* X position of the upper left corner */
+  fb_coord_t y;           /* Y position of the upper left corner */
+  fb_coord_t w;           /* Width of the area in pixels */
+  fb_coord_t h;           /* Height of the area in rows */
+};
+#endif
+
 /* On video controllers that support mapping of a pixel palette value
  * to an RGB encoding, the following structure may be used to define
  * that mapping.
@@ -381,6 +410,51 @@ struct fb_vtable_s
   int (*setcursor)(FAR struct fb_vtable_s *vtable,
                    FAR struct fb_setcursor_s *settings);
 #endif
+
+#ifdef CONFIG_FB_HWACCEL
+  /* The following are provided only if the video hardware provides a 2D
+   * graphics engine (such as the STM32 DMA2D or the i.MX PXP).  Any of
+   * these may be NULL.  Each operation must be complete when the method
+   * returns.  A negated errno value (such as -ENOSYS for an unsupported
+   * pixel format or an area too small to be worth setting up the engine)
+   * causes the caller to fall back to the software rasterizer.
+   *
+   * fillrect - Fill 'area' of the plane with the device color 'color'.
+   * moverect - Move 'area' to the position (destx, desty) within the same
+   *            plane.  Source and destination may overlap.
+   * copyrect - Copy an image into 'area'.  'src' addresses the image pixel
+   *            corresponding to the upper left corner of 'area' and
+   *            'srcstride' is the length of an image row in bytes.
+   */
+
+  int (*fillrect)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, uint32_t color);
+  int (*moverect)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, fb_coord_t destx,
+                  fb_coord_t desty);
+  int (*copyrect)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, FAR const void *src,
+                  fb_coord_t srcstride);
+#endif
+
+#ifdef CONFIG_FB_MULTIBUFFER
+  /* The following is provided only if the frame buffer memory holds more
+   * than one frame.  Display the frame that begins at row pinfo->yoffset.
+   * With CONFIG_FB_SYNC, the change should take effect at the next
+   * vertical sync, when the driver calls fb_vsync().
+   */
+
+  int (*pandisplay)(FAR struct fb_vtable_s *vtable, int planeno,
+                    FAR struct fb_planeinfo_s *pinfo);
+#endif
+
+#ifdef CONFIG_FB_SYNC
+  /* Set by fb_register() for use by fb_vsync().  This must not be modified
+   * by the framebuffer driver.
+   */
+
+  FAR void *priv;
+#endif
 };
 
 /****************************************************************************
@@ -484,6 +558,27 @@ void up_fbuninitialize(int display);
 
 int fb_register(int display, int plane);
 
+/****************************************************************************
+ * Name: fb_vsync
+ *
+ * Description:
+ *   Called by the framebuffer driver, normally from its vertical sync
+ *   interrupt handler, each time the panel begins a new frame.  This wakes
+ *   up FBIO_WAITFORVSYNC waiters, completes any pending FBIOPAN_DISPLAY,
+ *   and notifies pollers.
+ *
+ * Input Parameters:
+ *   vtable - The framebuffer object registered by fb_register()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_SYNC
+void fb_vsync(FAR struct fb_vtable_s *vtable);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
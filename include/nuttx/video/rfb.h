@@ -772,11 +772,11 @@ struct rfb_rrerect32_s
  *  bits:"
  */
 
-#define RFB_SUBENCODING_RAW      1  /* Raw */
-#define RFB_SUBENCODING_BACK     2  /* BackgroundSpecified*/
-#define RFB_SUBENCODING_FORE     4  /* ForegroundSpecified*/
-#define RFB_SUBENCODING_ANY      8  /* AnySubrects*/
-#define RFB_SUBENCODING_COLORED  16 /* SubrectsColoured*/
+#define RFB_HEXTILE_RAW          1  /* Raw */
+#define RFB_HEXTILE_BACK         2  /* BackgroundSpecified*/
+#define RFB_HEXTILE_FORE         4  /* ForegroundSpecified*/
+#define RFB_HEXTILE_ANY          8  /* AnySubrects*/
+#define RFB_HEXTILE_COLORED      16 /* SubrectsColoured*/
 
 /* "If the Raw bit is set then the other bits are irrelevant; width x height
  *  pixel values follow (where width and height are the width and height of
@@ -75,18 +75,22 @@
 #define WDOGF_ACTIVE       (1 << 0) /* Bit 0: 1=Watchdog is actively timing */
 #define WDOGF_ALLOCED      (1 << 1) /* Bit 1: 0=Pre-allocated, 1=Allocated */
 #define WDOGF_STATIC       (1 << 2) /* Bit 2: 0=[Pre-]allocated, 1=Static */
+#define WDOGF_SLACK        (1 << 3) /* Bit 3: 1=Slack set by wd_setslack() */
 
 #define WDOG_SETACTIVE(w)  do { (w)->flags |= WDOGF_ACTIVE; } while (0)
 #define WDOG_SETALLOCED(w) do { (w)->flags |= WDOGF_ALLOCED; } while (0)
 #define WDOG_SETSTATIC(w)  do { (w)->flags |= WDOGF_STATIC; } while (0)
+#define WDOG_SETSLACK(w)   do { (w)->flags |= WDOGF_SLACK; } while (0)
 
 #define WDOG_CLRACTIVE(w)  do { (w)->flags &= ~WDOGF_ACTIVE; } while (0)
 #define WDOG_CLRALLOCED(w) do { (w)->flags &= ~WDOGF_ALLOCED; } while (0)
 #define WDOG_CLRSTATIC(w)  do { (w)->flags &= ~WDOGF_STATIC; } while (0)
+#define WDOG_CLRSLACK(w)   do { (w)->flags &= ~WDOGF_SLACK; } while (0)
 
 #define WDOG_ISACTIVE(w)   (((w)->flags & WDOGF_ACTIVE) != 0)
 #define WDOG_ISALLOCED(w)  (((w)->flags & WDOGF_ALLOCED) != 0)
 #define WDOG_ISSTATIC(w)   (((w)->flags & WDOGF_STATIC) != 0)
+#define WDOG_ISSLACK(w)    (((w)->flags & WDOGF_SLACK) != 0)
 
 /* Initialization of statically allocated timers ****************************/
 
@@ -140,10 +144,20 @@ struct wdog_s
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  uint32_t           expire;     /* Absolute expiration time in ticks */
+#else
   int                lag;        /* Timer associated with the delay */
+#endif
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct wdog_s **pprev;     /* Wheel slot or previous 'next' link */
+#endif
+#ifdef CONFIG_WDOG_SLACK
+  uint16_t           slack;      /* Slack in ticks if WDOGF_SLACK is set */
+#endif
 };
 
 /* Watchdog 'handle' */
@@ -280,6 +294,50 @@ int wd_cancel(WDOG_ID wdog);
 
 int wd_gettime(WDOG_ID wdog);
 
+/****************************************************************************
+ * Name: wd_getnext
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.  It is used by power management logic to
+ *   bound the time that the CPU is expected to remain idle.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that there are no active watchdogs.  In the tickless mode,
+ *   this is relative to the start of the current timer interval.
+ *
+ ****************************************************************************/
+
+int wd_getnext(void);
+
+/****************************************************************************
+ * Name: wd_setslack
+ *
+ * Description:
+ *   Set the slack of a watchdog timer, i.e., the number of ticks by which
+ *   its expiration may be deferred so that it expires together with
+ *   another watchdog.  The slack applies the next time that the watchdog
+ *   is started.
+ *
+ * Parameters:
+ *   wdog  - watchdog ID
+ *   slack - The slack in system ticks.  A negative value restores the
+ *           default:  The slack of the task that starts the watchdog.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_SLACK
+int wd_setslack(WDOG_ID wdog, int slack);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -144,6 +144,7 @@
 
 /* Non-standard MAC ioctl calls */
 
+#define MAC802154IOC_GET_STATS                 _MAC802154IOC(0x00FC)
 #define MAC802154IOC_NOTIFY_REGISTER           _MAC802154IOC(0x00FD)
 #define MAC802154IOC_GET_EVENT                 _MAC802154IOC(0x00FE)
 #define MAC802154IOC_ENABLE_EVENTS             _MAC802154IOC(0x00FF)
@@ -1683,6 +1684,24 @@ struct ieee802154_primitive_s
   int nclients; /* Number of clients to call ieee802154_primitive_free before freed */
 };
 
+/* MAC throughput and latency counters returned by MAC802154IOC_GET_STATS.
+ * Latencies are in system clock ticks, measured from the data request to
+ * the confirmation of the transmission.
+ */
+
+struct ieee802154_macstats_s
+{
+  uint32_t txdata;        /* Data frames transmitted successfully */
+  uint32_t txfail;        /* Data frames that failed to be transmitted */
+  uint32_t txindirect;    /* Data frames queued for indirect transmission */
+  uint32_t txpurged;      /* Indirect frames purged before extraction */
+  uint32_t rxdata;        /* Data frames received */
+  uint32_t rxbatches;     /* Number of batches of indications delivered */
+  uint32_t txlatency;     /* Sum of the latencies of all confirmed frames */
+  uint32_t txlatencymax;  /* Largest latency of a confirmed frame */
+  uint16_t npending;      /* Current number of indirect frames pending */
+};
+
 /* A pointer to this structure is passed as the argument of each IOCTL
  * command.
  */
@@ -1706,6 +1725,7 @@ union ieee802154_macarg_u
   /* To be determined */                        /* MAC802154IOC_MLME_SOUNDING_REQUEST */
   /* To be determined */                        /* MAC802154IOC_MLME_CALIBRATE_REQUEST */
 
+  struct ieee802154_macstats_s     stats;       /* MAC802154IOC_GET_STATS */
   uint8_t                          signo;       /* MAC802154IOC_NOTIFY_REGISTER */
   struct ieee802154_primitive_s    primitive;   /* MAC802154IOC_GET_EVENT */
   bool                             enable;      /* MAC802154IOC_ENABLE_EVENTS */
@@ -86,6 +86,7 @@ struct ieee802154_txdesc_s
 
   bool framepending;    /* Did the ACK have the frame pending bit set */
   uint32_t purgetime;   /* Time to purge transaction */
+  uint32_t reqtime;     /* Time the transaction was requested */
   uint8_t  retrycount;  /* Number of remaining retries. Set to macMaxFrameRetries
                          * when txdescriptor is allocated
                          */
@@ -92,6 +92,16 @@
  * CONFIG_SCHED_LPWORKSTACKSIZE - The stack size allocated for the lower
  *   priority worker thread.  Default: 2048.
  *
+ * CONFIG_SCHED_WORKQUEUE_BATCH - Coalesce re-queued work and redundant
+ *   worker thread signals.
+ * CONFIG_SCHED_WORKQUEUE_BATCH_WINDOW - The coalescing window in clock
+ *   ticks.  Default: 1
+ * CONFIG_SCHED_WORKPOOL - Support additional kernel work queue pools that
+ *   are created at run time with work_pool_create().
+ * CONFIG_SCHED_WORKPOOL_NPOOLS - The maximum number of pools.  Default: 2
+ * CONFIG_SCHED_WORKPOOL_NTHREADS - The maximum number of worker threads
+ *   per queue of a pool.  Default: 2
+ *
  * The user-mode work queue is only available in the protected or kernel
  * builds.  This those configurations, the user-mode work queue provides the
  * same (non-standard) facility for use by applications.
@@ -272,6 +282,20 @@
 
 #endif /* CONFIG_LIB_USRWORK && !__KERNEL__ */
 
+/* Work queue pools:
+ *   The IDs of the kernel work queue pools follow the fixed work queue IDs.
+ *   Pool IDs are returned by work_pool_create().
+ *
+ *   WORKPOOL_PERCPU:  Create a separate queue and separate worker threads
+ *     for each CPU.  Otherwise, the pool has one queue that is served by
+ *     all of its worker threads.
+ */
+
+#ifdef CONFIG_SCHED_WORKPOOL
+#  define WORKPOOL_BASE    3          /* ID of the first pool */
+#  define WORKPOOL_PERCPU  (1 << 0)   /* One queue per CPU */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -294,8 +318,23 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   systime_t qtime;       /* Time work queued */
   systime_t delay;       /* Delay until work performed */
+#ifdef CONFIG_SCHED_WORKPOOL
+  FAR void *pqueue;      /* Pool queue holding the work (pools only) */
+#endif
 };
 
+/* Work queue statistics returned by work_stats() */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+struct work_stats_s
+{
+  uint32_t queued;       /* Number of work_queue() requests */
+  uint32_t coalesced;    /* Requests coalesced into pending work */
+  uint32_t signals;      /* Signals sent to the worker thread */
+  uint32_t suppressed;   /* Signals suppressed because one was pending */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -363,6 +402,59 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, systime_t delay);
 
+/****************************************************************************
+ * Name: work_pool_create
+ *
+ * Description:
+ *   Create a new kernel work queue pool and start its worker threads.
+ *
+ * Input Parameters:
+ *   name      - The name of the worker threads
+ *   priority  - The priority of the worker threads
+ *   stacksize - The stack size of the worker threads
+ *   nthreads  - The number of worker threads per queue
+ *   maxactive - The maximum number of work items of the pool that may
+ *               execute at the same time or zero for no limit
+ *   flags     - Zero or WORKPOOL_PERCPU
+ *
+ * Returned Value:
+ *   The work queue ID of the new pool is returned on success.  A negated
+ *   errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL
+int work_pool_create(FAR const char *name, int priority, int stacksize,
+                     int nthreads, int maxactive, uint8_t flags);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Like work_queue(), but queue the work to the queue of a specific CPU of
+ *   a per-CPU work queue pool.  work_queue() uses the queue of the CPU that
+ *   calls it.  For other work queues, the CPU is ignored.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   cpu    - The CPU that will perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, systime_t delay);
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
@@ -403,6 +495,25 @@ int work_cancel(int qid, FAR struct work_s *work);
 
 int work_signal(int qid);
 
+/****************************************************************************
+ * Name: work_stats
+ *
+ * Description:
+ *   Return the batching statistics of a kernel work queue.
+ *
+ * Input Parameters:
+ *   qid   - The work queue ID (HPWORK or LPWORK)
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+int work_stats(int qid, FAR struct work_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
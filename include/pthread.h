@@ -54,6 +54,10 @@
 
 #include <nuttx/semaphore.h> /* For sem_t and SEM_PRIO_* defines */
 
+#ifdef CONFIG_PTHREAD_RWLOCK_PERCPU
+#  include <nuttx/rwsem.h>   /* For rwsem_t */
+#endif
+
 /********************************************************************************
  * Pre-processor Definitions
  ********************************************************************************/
@@ -94,12 +98,17 @@
  *   mutex will return with an error.
  * PTHREAD_MUTEX_DEFAULT
  *  An implementation is allowed to map this mutex to one of the other mutex types.
+ * PTHREAD_MUTEX_ADAPTIVE_NP
+ *   Non-standard.  Like PTHREAD_MUTEX_ERRORCHECK but, in SMP configurations, a
+ *   thread locking the mutex spins briefly while the holder is running on
+ *   another CPU before it blocks.  Requires CONFIG_PTHREAD_MUTEX_ADAPTIVE.
  */
 
 #define PTHREAD_MUTEX_NORMAL          0
 #define PTHREAD_MUTEX_ERRORCHECK      1
 #define PTHREAD_MUTEX_RECURSIVE       2
 #define PTHREAD_MUTEX_DEFAULT         PTHREAD_MUTEX_NORMAL
+#define PTHREAD_MUTEX_ADAPTIVE_NP     3
 
 /* Valid ranges for the pthread stacksize attribute */
 
@@ -337,6 +346,12 @@ typedef struct pthread_barrier_s pthread_barrier_t;
 typedef bool pthread_once_t;
 #define __PTHREAD_ONCE_T_DEFINED 1
 
+#ifdef CONFIG_PTHREAD_RWLOCK_PERCPU
+struct pthread_rwlock_s
+{
+    rwsem_t rwsem;
+};
+#else
 struct pthread_rwlock_s
 {
     pthread_mutex_t lock;
@@ -345,14 +360,19 @@ struct pthread_rwlock_s
     unsigned int num_writers;
     bool write_in_progress;
 };
+#endif
 
 typedef struct pthread_rwlock_s pthread_rwlock_t;
 
 typedef int pthread_rwlockattr_t;
 
-#define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
-                                     PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+#ifdef CONFIG_PTHREAD_RWLOCK_PERCPU
+#  define PTHREAD_RWLOCK_INITIALIZER  {RWSEM_INITIALIZER}
+#else
+#  define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
+                                       PTHREAD_COND_INITIALIZER, \
+                                       0, 0, false}
+#endif
 
 #ifdef CONFIG_PTHREAD_CLEANUP
 /* This type describes the pthread cleanup callback (non-standard) */
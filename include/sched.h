@@ -58,6 +58,7 @@
 #define SCHED_RR                  2  /* Round robin scheduling policy */
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
 #define SCHED_OTHER               4  /* Not supported */
+#define SCHED_DEADLINE            5  /* Earliest deadline first scheduling policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -207,6 +208,13 @@ struct sched_param
   int sched_ss_max_repl;                /* Maximum pending replenishments for
                                          * sporadic server. */
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  struct timespec sched_dl_runtime;     /* Execution budget in each period */
+  struct timespec sched_dl_deadline;    /* Deadline relative to the start of
+                                         * each period (zero: the period) */
+  struct timespec sched_dl_period;      /* Activation period */
+#endif
 };
 
 /********************************************************************************
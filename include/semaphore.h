@@ -73,9 +73,19 @@ struct semholder_s
 #endif
   FAR struct tcb_s *htcb;        /* Holder TCB */
   int16_t counts;                /* Number of counts owned by this holder */
+#ifdef CONFIG_SEM_HOLDERLISTS
+  FAR struct semholder_s *tlink; /* Next semaphore held by the holder TCB */
+  FAR struct sem_s *sem;         /* The semaphore that is held */
+#endif
 };
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef CONFIG_SEM_HOLDERLISTS
+#  if CONFIG_SEM_PREALLOCHOLDERS > 0
+#    define SEMHOLDER_INITIALIZER {NULL, NULL, 0, NULL, NULL}
+#  else
+#    define SEMHOLDER_INITIALIZER {NULL, 0, NULL, NULL}
+#  endif
+#elif CONFIG_SEM_PREALLOCHOLDERS > 0
 #  define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
 #else
 #  define SEMHOLDER_INITIALIZER {NULL, 0}
@@ -99,6 +109,9 @@ struct sem_s
 # else
   struct semholder_s holder[2];  /* Slot for old and new holder */
 # endif
+# ifdef CONFIG_SEM_HOLDERLISTS
+  FAR struct tcb_s *whead;       /* Prioritized list of waiting threads */
+# endif
 #endif
 };
 
@@ -107,7 +120,13 @@ typedef struct sem_s sem_t;
 /* Initializers */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-# if CONFIG_SEM_PREALLOCHOLDERS > 0
+# if defined(CONFIG_SEM_HOLDERLISTS) && CONFIG_SEM_PREALLOCHOLDERS > 0
+#  define SEM_INITIALIZER(c) \
+    {(c), 0, NULL, NULL}         /* semcount, flags, hhead, whead */
+# elif defined(CONFIG_SEM_HOLDERLISTS)
+#  define SEM_INITIALIZER(c) \
+    {(c), 0, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}, NULL} /* semcount, flags, holder[2], whead */
+# elif CONFIG_SEM_PREALLOCHOLDERS > 0
 #  define SEM_INITIALIZER(c) \
     {(c), 0, NULL}               /* semcount, flags, hhead */
 # else
@@ -90,6 +90,8 @@
 #define putchar(c) fputc(c, stdout)
 #define getc(s)    fgetc(s)
 #define getchar()  fgetc(stdin)
+#define getchar_unlocked()   getc_unlocked(stdin)
+#define putchar_unlocked(c)  putc_unlocked((c), stdout)
 #define rewind(s)  ((void)fseek((s),0,SEEK_SET))
 
 /* Path to the directory where temporary files can be created */
@@ -168,6 +170,17 @@ void   setbuf(FAR FILE *stream, FAR char *buf);
 int    setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size);
 int    ungetc(int c, FAR FILE *stream);
 
+/* Explicit stream locking.  getc_unlocked() and putc_unlocked() are
+ * intended to be used inside of flockfile()/funlockfile() and may transfer
+ * the character directly from or to the stream buffer.
+ */
+
+void   flockfile(FAR FILE *stream);
+int    ftrylockfile(FAR FILE *stream);
+void   funlockfile(FAR FILE *stream);
+int    getc_unlocked(FAR FILE *stream);
+int    putc_unlocked(int c, FAR FILE *stream);
+
 /* Operations on the stdout stream, buffers, paths, and the whole printf-family */
 
 int    printf(FAR const IPTR char *format, ...);
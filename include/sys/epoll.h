@@ -40,6 +40,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <poll.h>
 
 /****************************************************************************
@@ -74,27 +75,26 @@ enum EPOLL_EVENTS
 #define EPOLLERR EPOLLERR
     EPOLLHUP = POLLHUP,
 #define EPOLLHUP EPOLLHUP
+    EPOLLONESHOT = (1 << 30),
+#define EPOLLONESHOT EPOLLONESHOT
+    EPOLLET = (1u << 31)
+#define EPOLLET EPOLLET
   };
 
 typedef union poll_data
 {
+  FAR void    *ptr;
   int          fd;       /* The descriptor being polled */
+  uint32_t     u32;
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t     u64;
+#endif
 } epoll_data_t;
 
 struct epoll_event
 {
-  epoll_data_t data;
-  FAR sem_t   *sem;      /* Pointer to semaphore used to post output event */
-  pollevent_t  events;   /* The input event flags */
-  pollevent_t  revents;  /* The output event flags */
-  FAR void    *priv;     /* For use by drivers */
-};
-
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
+  uint32_t     events;   /* Epoll events */
+  epoll_data_t data;     /* User data, returned unmodified by epoll_wait() */
 };
 
 /****************************************************************************
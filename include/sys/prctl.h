@@ -63,10 +63,30 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME, myname, 0);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the watchdog timer slack of the thread whose ID is in required
+ *    arg2 (int) to the number of microseconds in required arg1 (unsigned
+ *    long).  The expiration of timers started by the thread may then be
+ *    deferred by up to that amount in order to share a wakeup with another
+ *    timer.  The thread ID of 0 will set the slack of the calling thread.
+ *    Requires CONFIG_WDOG_SLACK.  As an example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 5000, 0);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the watchdog timer slack in microseconds of the thread whose ID
+ *    is in required arg2 (int) in the location pointed to by required arg1
+ *    (unsigned long *).  As an example:
+ *
+ *      unsigned long slack;
+ *      prctl(PR_GET_TIMERSLACK, &slack, 0);
  */
 
-#define PR_SET_NAME 1
-#define PR_GET_NAME 2
+#define PR_SET_NAME       1
+#define PR_GET_NAME       2
+#define PR_SET_TIMERSLACK 3
+#define PR_GET_TIMERSLACK 4
 
 /****************************************************************************
  * Public Type Definitions
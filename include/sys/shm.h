@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <sys/ipc.h>
+#include <stdint.h>
 #include <time.h>
 
 /****************************************************************************
@@ -106,6 +107,12 @@ int shmctl(int shmid, int cmd, FAR struct shmid_ds *buf);
 int shmdt(FAR const void *shmaddr);
 int shmget(key_t key, size_t size, int shmflg);
 
+/* Non-standard wait/wake interfaces on words in shared memory */
+
+int shmwait(FAR const void *addr, uint32_t value,
+            FAR const struct timespec *abstime);
+int shmwake(FAR const void *addr, int nwake);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -109,6 +110,7 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): Block for the first message only */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -148,10 +150,58 @@
                            * output function blocks because flow control prevents data from
                            * being sent(get/set). arg: struct timeval */
 #define SO_TYPE        15 /* Reports the socket type (get only). return: int */
+#define SO_REUSEPORT   16 /* Allow several sockets to bind the same address and
+                           * port, flows are balanced among them (get/set).
+                           * arg: pointer to integer containing a boolean value */
+#define SO_INCOMING_CPU 17 /* Preferred CPU for the flows of an SO_REUSEPORT
+                           * socket (get/set).  arg: integer value, -1 for none */
+#define SO_TIMESTAMP   18 /* Return the receive time of each datagram in an
+                           * SCM_TIMESTAMP control message (get/set).
+                           * arg: pointer to integer containing a boolean value */
+#define SO_TIMESTAMPING 19 /* Select the SCM_TIMESTAMPING receive timestamps
+                           * (get/set).  arg: integer, SOF_TIMESTAMPING_* bits */
 
 /* Protocol-level socket options may begin with this value */
 
-#define __SO_PROTOCOL  16
+#define __SO_PROTOCOL  20
+
+/* Bits of the SO_TIMESTAMPING option value.  The generation bits select
+ * which timestamps are taken, the reporting bits which are returned; a
+ * timestamp is returned only if both are set.
+ */
+
+#define SOF_TIMESTAMPING_RX_HARDWARE (1 << 2) /* Generate hardware Rx stamps */
+#define SOF_TIMESTAMPING_RX_SOFTWARE (1 << 3) /* Generate software Rx stamps */
+#define SOF_TIMESTAMPING_SOFTWARE    (1 << 4) /* Report software stamps */
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6) /* Report hardware stamps */
+
+/* Control message types at level SOL_SOCKET */
+
+#define SCM_TIMESTAMP   SO_TIMESTAMP    /* data: struct timeval */
+#define SCM_TIMESTAMPING SO_TIMESTAMPING /* data: struct timespec[3]; [0] is
+                                         * the software and [2] the raw
+                                         * hardware timestamp */
+
+/* Access to the control messages in the ancillary data of a msghdr */
+
+#define CMSG_ALIGN(len) \
+  (((len) + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1))
+#define CMSG_SPACE(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + CMSG_ALIGN(len))
+#define CMSG_LEN(len)   (CMSG_ALIGN(sizeof(struct cmsghdr)) + (len))
+#define CMSG_DATA(cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN(sizeof(struct cmsghdr)))
+
+#define CMSG_FIRSTHDR(mhdr) \
+  ((mhdr)->msg_controllen >= sizeof(struct cmsghdr) ? \
+   (FAR struct cmsghdr *)(mhdr)->msg_control : (FAR struct cmsghdr *)0)
+#define CMSG_NXTHDR(mhdr, cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len) + \
+   sizeof(struct cmsghdr) > \
+   (FAR unsigned char *)(mhdr)->msg_control + (mhdr)->msg_controllen ? \
+   (FAR struct cmsghdr *)0 : \
+   (FAR struct cmsghdr *)((FAR unsigned char *)(cmsg) + \
+                          CMSG_ALIGN((cmsg)->cmsg_len)))
 
 /* Values for the 'how' argument of shutdown() */
 
@@ -195,6 +245,39 @@ struct sockaddr
   char        sa_data[14];     /* 14-bytes of address data */
 };
 
+/* Describes a message for sendmsg() and recvmsg().  The only ancillary
+ * data supported are the receive timestamps of UDP sockets; otherwise
+ * msg_controllen is returned as zero.
+ */
+
+struct msghdr
+{
+  FAR void *msg_name;          /* Optional address */
+  socklen_t msg_namelen;       /* Size of address */
+  FAR struct iovec *msg_iov;   /* Scatter/gather array */
+  int msg_iovlen;              /* Members in msg_iov */
+  FAR void *msg_control;       /* Ancillary data */
+  socklen_t msg_controllen;    /* Ancillary data buffer length */
+  int msg_flags;               /* Flags on received message */
+};
+
+/* One message of the vector used with sendmmsg() and recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;       /* Message header */
+  unsigned int msg_len;        /* Number of bytes transmitted */
+};
+
+/* Header of one control message in the ancillary data of a msghdr */
+
+struct cmsghdr
+{
+  socklen_t cmsg_len;          /* Length of header and data: CMSG_LEN() */
+  int cmsg_level;              /* Originating protocol: SOL_SOCKET */
+  int cmsg_type;               /* Protocol-specific type: SCM_* */
+};
+
 /* Used with the SO_LINGER socket option */
 
 struct linger
@@ -231,6 +314,15 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
                  FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags);
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
+
+struct timespec; /* Forward reference */
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+
 int shutdown(int sockfd, int how);
 
 int setsockopt(int sockfd, int level, int option,
@@ -45,6 +45,7 @@
 
 #ifndef __ASSEMBLY__
 #  include <stdint.h>
+#  include <stdbool.h>
 #endif
 
 #ifdef CONFIG_LIB_SYSCALL
@@ -405,7 +406,9 @@
 #    define SYS_shmat                  (__SYS_shm+1)
 #    define SYS_shmctl                 (__SYS_shm+2)
 #    define SYS_shmdt                  (__SYS_shm+3)
-#    define __SYS_pthread              (__SYS_shm+4)
+#    define SYS_shmwait                (__SYS_shm+4)
+#    define SYS_shmwake                (__SYS_shm+5)
+#    define __SYS_pthread              (__SYS_shm+6)
 #else
 #  define __SYS_pthread                __SYS_shm
 #endif
@@ -522,11 +525,15 @@
 #  define SYS_listen                   (__SYS_network+4)
 #  define SYS_recv                     (__SYS_network+5)
 #  define SYS_recvfrom                 (__SYS_network+6)
-#  define SYS_send                     (__SYS_network+7)
-#  define SYS_sendto                   (__SYS_network+8)
-#  define SYS_setsockopt               (__SYS_network+9)
-#  define SYS_socket                   (__SYS_network+10)
-#  define SYS_nnetsocket               (__SYS_network+11)
+#  define SYS_recvmmsg                 (__SYS_network+7)
+#  define SYS_recvmsg                  (__SYS_network+8)
+#  define SYS_send                     (__SYS_network+9)
+#  define SYS_sendmmsg                 (__SYS_network+10)
+#  define SYS_sendmsg                  (__SYS_network+11)
+#  define SYS_sendto                   (__SYS_network+12)
+#  define SYS_setsockopt               (__SYS_network+13)
+#  define SYS_socket                   (__SYS_network+14)
+#  define SYS_nnetsocket               (__SYS_network+15)
 #else
 #  define SYS_nnetsocket               __SYS_network
 #endif
@@ -534,19 +541,29 @@
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
 #if CONFIG_TASK_NAME_SIZE > 0
-#  define SYS_prctl                    (SYS_nnetsocket+1)
-#else
 #  define SYS_prctl                    SYS_nnetsocket
+#  define __SYS_getrandom              (SYS_nnetsocket+1)
+#else
+#  define __SYS_getrandom              SYS_nnetsocket
 #endif
 
 /* The following is defined only if entropy pool random number generator
  * is enabled. */
 
 #ifdef CONFIG_CRYPTO_RANDOM_POOL
-#  define SYS_getrandom                (SYS_prctl+1)
-#  define SYS_maxsyscall               (SYS_prctl+2)
+#  define SYS_getrandom                __SYS_getrandom
+#  define __SYS_batch                  (__SYS_getrandom+1)
 #else
-#  define SYS_maxsyscall               SYS_prctl
+#  define __SYS_batch                  __SYS_getrandom
+#endif
+
+/* The following is defined only if batched system calls are enabled */
+
+#ifdef CONFIG_SYSCALL_BATCH
+#  define SYS_syscall_batch            __SYS_batch
+#  define SYS_maxsyscall               (__SYS_batch+1)
+#else
+#  define SYS_maxsyscall               __SYS_batch
 #endif
 
 /* Note that the reported number of system calls does *NOT* include the
@@ -560,12 +577,38 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifndef __ASSEMBLY__
+
+#ifdef CONFIG_SYSCALL_BATCH
+/* One system call of a batch passed to syscall_batch().  'nbr' and 'parm'
+ * are provided by the caller; the value returned by the system call and
+ * the errno value that it left are returned in 'result' and 'errcode'.
+ */
+
+struct syscall_batch_s
+{
+  unsigned int nbr;            /* SYS_ system call number */
+  uintptr_t parm[6];           /* Parameters; unused ones are ignored */
+  uintptr_t result;            /* Returned value */
+  int errcode;                 /* errno after the call, zero if unchanged */
+};
+#endif
+
+#if defined(CONFIG_SYSCALL_STATS) && defined(__KERNEL__)
+/* Statistics for one system call, see /proc/sched/syscall */
+
+struct syscall_stats_s
+{
+  uint32_t count;              /* Number of calls */
+  uint32_t maxcycles;          /* Longest call in up_cyclecount() cycles */
+  uint64_t cycles;             /* Total time in up_cyclecount() cycles */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-#ifndef __ASSEMBLY__
-
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -593,6 +636,15 @@ EXTERN const uintptr_t g_funclookup[SYS_nsyscalls];
 
 EXTERN const uintptr_t g_stublookup[SYS_nsyscalls];
 
+#ifdef CONFIG_SYSCALL_STATS
+/* Per-system call statistics and the names of the system calls, both
+ * indexed by the system call number less CONFIG_SYS_RESERVED.
+ */
+
+EXTERN struct syscall_stats_s g_syscallstats[SYS_nsyscalls];
+EXTERN FAR const char * const g_syscallnames[SYS_nsyscalls];
+#endif
+
 #endif
 
 /* Given the system call number, the corresponding entry in this table
@@ -605,6 +657,73 @@ EXTERN const uint8_t g_funcnparms[SYS_nsyscalls];
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Perform a vector of system calls with a single transition into the
+ *   kernel.  The calls are performed in order and errno is cleared before
+ *   each one.  Nested batches and the system calls that do not return to
+ *   the caller (_exit, exit, vfork) are not permitted.
+ *
+ * Input Parameters:
+ *   calls  - The system calls to perform.  The results are returned in
+ *            the same array.
+ *   ncalls - The number of entries in 'calls'
+ *
+ * Returned Value:
+ *   The number of system calls performed on success.  Otherwise -1 is
+ *   returned with errno set to EINVAL if an entry holds an invalid or
+ *   forbidden system call number; no call is performed in that case.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_BATCH
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls);
+#endif
+
+#ifdef __KERNEL__
+/****************************************************************************
+ * Name: syscall_dispatch
+ *
+ * Description:
+ *   Call the stub of a system call, accounting for the call in
+ *   g_syscallstats[] if CONFIG_SYSCALL_STATS is selected.  This has the
+ *   same interface as the stubs and is called by the architecture-specific
+ *   dispatch logic instead of the stub from g_stublookup[].
+ *
+ * Input Parameters:
+ *   nbr     - The system call number less CONFIG_SYS_RESERVED
+ *   parm1-6 - The system call parameters
+ *
+ * Returned Value:
+ *   The value returned by the stub.
+ *
+ ****************************************************************************/
+
+uintptr_t syscall_dispatch(unsigned int nbr, uintptr_t parm1,
+                           uintptr_t parm2, uintptr_t parm3,
+                           uintptr_t parm4, uintptr_t parm5,
+                           uintptr_t parm6);
+
+/****************************************************************************
+ * Name: syscall_isfast
+ *
+ * Description:
+ *   Return true if the system call never blocks and is short enough to be
+ *   performed directly in the system call exception handler, instead of
+ *   returning to privileged thread mode and trapping again on return.
+ *
+ * Input Parameters:
+ *   nbr - The system call number less CONFIG_SYS_RESERVED
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_FASTPATH
+bool syscall_isfast(unsigned int nbr);
+#endif
+#endif /* __KERNEL__ */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
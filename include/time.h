@@ -90,6 +90,12 @@
 #  define CLOCK_MONOTONIC  1
 #endif
 
+/* The CPU time consumed by the calling thread */
+
+#ifdef CONFIG_SCHED_CPUTIME
+#  define CLOCK_THREAD_CPUTIME_ID 3
+#endif
+
 /* This is a flag that may be passed to the timer_settime() and
  * clock_nanosleep() functions.
  */
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * libc/dsp/lib_dsp.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __LIBC_DSP_LIB_DSP_H
+#define __LIBC_DSP_LIB_DSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The ARMv7E-M DSP extension (Cortex-M4/M7) provides saturating and
+ * dual 16-bit multiply-accumulate instructions.  The kernels use them
+ * whenever the compiler is targeting a core that has them and fall back to
+ * the portable C definitions below otherwise.
+ */
+
+#if defined(__GNUC__) && defined(__ARM_FEATURE_DSP)
+#  define DSP_HAVE_SIMD 1
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/* Saturate a 32-bit value to Q15 */
+
+static inline q15_t dsp_sat15(int32_t x)
+{
+#ifdef DSP_HAVE_SIMD
+  int32_t r;
+  __asm__ ("ssat %0, #16, %1" : "=r" (r) : "r" (x));
+  return (q15_t)r;
+#else
+  if (x > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (x < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return (q15_t)x;
+#endif
+}
+
+/* Saturate a 64-bit value to Q31 */
+
+static inline q31_t dsp_sat31(int64_t x)
+{
+  if (x > INT32_MAX)
+    {
+      return INT32_MAX;
+    }
+  else if (x < INT32_MIN)
+    {
+      return INT32_MIN;
+    }
+
+  return (q31_t)x;
+}
+
+/* Load two adjacent Q15 values as one 32-bit word.  ARMv7-M permits
+ * unaligned word loads, and memcpy() lets the compiler emit a single LDR.
+ */
+
+static inline uint32_t dsp_read_q15x2(FAR const q15_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void dsp_write_q15x2(FAR q15_t *p, uint32_t v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+
+#ifdef DSP_HAVE_SIMD
+/* Dual 16-bit multiply with 32-bit accumulate: acc + x.lo*y.lo + x.hi*y.hi */
+
+static inline int32_t dsp_smlad(uint32_t x, uint32_t y, int32_t acc)
+{
+  int32_t r;
+  __asm__ ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (x), "r" (y), "r" (acc));
+  return r;
+}
+
+/* Dual 16-bit multiply with 64-bit accumulate */
+
+static inline int64_t dsp_smlald(uint32_t x, uint32_t y, int64_t acc)
+{
+  union
+  {
+    int64_t  v;
+    uint32_t w[2];
+  } u;
+
+  u.v = acc;
+  __asm__ ("smlald %0, %1, %2, %3"
+           : "+r" (u.w[0]), "+r" (u.w[1]) : "r" (x), "r" (y));
+  return u.v;
+}
+
+/* Saturating dual 16-bit add and subtract */
+
+static inline uint32_t dsp_qadd16(uint32_t x, uint32_t y)
+{
+  uint32_t r;
+  __asm__ ("qadd16 %0, %1, %2" : "=r" (r) : "r" (x), "r" (y));
+  return r;
+}
+
+static inline uint32_t dsp_qsub16(uint32_t x, uint32_t y)
+{
+  uint32_t r;
+  __asm__ ("qsub16 %0, %1, %2" : "=r" (r) : "r" (x), "r" (y));
+  return r;
+}
+#endif
+
+#endif /* __LIBC_DSP_LIB_DSP_H */
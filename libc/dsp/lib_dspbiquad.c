@@ -0,0 +1,152 @@
+/****************************************************************************
+ * libc/dsp/lib_dspbiquad.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_biquad_q31_init
+ *
+ * Description:
+ *   Initialize a biquad cascade and clear its state.
+ *
+ * Input Parameters:
+ *   iir       - The filter instance to initialize
+ *   nstages   - Number of second order stages
+ *   coeffs    - 5 * nstages coefficients, {b0, b1, b2, a1, a2} per stage
+ *   state     - Caller provided buffer of 4 * nstages values
+ *   postshift - Left shift applied to each stage output (0..31)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dsp_biquad_q31_init(FAR struct dsp_biquad_q31_s *iir, uint8_t nstages,
+                        FAR const q31_t *coeffs, FAR q31_t *state,
+                        uint8_t postshift)
+{
+  if (nstages == 0 || postshift > 31 || coeffs == NULL || state == NULL)
+    {
+      return -EINVAL;
+    }
+
+  iir->nstages   = nstages;
+  iir->postshift = postshift;
+  iir->coeffs    = coeffs;
+  iir->state     = state;
+
+  memset(state, 0, 4 * nstages * sizeof(q31_t));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dsp_biquad_q31
+ *
+ * Description:
+ *   Filter n samples from src into dst through all stages.  src and dst may
+ *   be the same buffer.  Each stage runs over the whole block before the
+ *   next one so that its coefficients and state stay in registers.
+ *
+ ****************************************************************************/
+
+void dsp_biquad_q31(FAR struct dsp_biquad_q31_s *iir, FAR const q31_t *src,
+                    FAR q31_t *dst, size_t n)
+{
+  FAR const q31_t *coeffs = iir->coeffs;
+  FAR q31_t *state = iir->state;
+  int shift = 31 - iir->postshift;
+  int stage;
+
+  for (stage = 0; stage < iir->nstages; stage++)
+    {
+      q31_t b0 = coeffs[0];
+      q31_t b1 = coeffs[1];
+      q31_t b2 = coeffs[2];
+      q31_t a1 = coeffs[3];
+      q31_t a2 = coeffs[4];
+      q31_t x1 = state[0];
+      q31_t x2 = state[1];
+      q31_t y1 = state[2];
+      q31_t y2 = state[3];
+      FAR const q31_t *in = src;
+      FAR q31_t *out = dst;
+      size_t i;
+
+      for (i = 0; i < n; i++)
+        {
+          q31_t x = *in++;
+          int64_t acc;
+
+          acc  = (int64_t)b0 * x;
+          acc += (int64_t)b1 * x1;
+          acc += (int64_t)b2 * x2;
+          acc += (int64_t)a1 * y1;
+          acc += (int64_t)a2 * y2;
+
+          x2 = x1;
+          x1 = x;
+          y2 = y1;
+          y1 = dsp_sat31(acc >> shift);
+
+          *out++ = y1;
+        }
+
+      state[0] = x1;
+      state[1] = x2;
+      state[2] = y1;
+      state[3] = y2;
+
+      /* Later stages filter the output of the previous one in place */
+
+      src     = dst;
+      coeffs += 5;
+      state  += 4;
+    }
+}
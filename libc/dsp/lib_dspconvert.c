@@ -0,0 +1,125 @@
+/****************************************************************************
+ * libc/dsp/lib_dspconvert.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_q15_to_q31
+ ****************************************************************************/
+
+void dsp_q15_to_q31(FAR const q15_t *src, FAR q31_t *dst, size_t n)
+{
+  while (n-- > 0)
+    {
+      *dst++ = (q31_t)*src++ << 16;
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_q31_to_q15
+ *
+ * Description:
+ *   Convert with rounding to nearest.  Values that round beyond Q15_MAX
+ *   are saturated.
+ *
+ ****************************************************************************/
+
+void dsp_q31_to_q15(FAR const q31_t *src, FAR q15_t *dst, size_t n)
+{
+  while (n-- > 0)
+    {
+      *dst++ = dsp_sat15((int32_t)(((int64_t)*src++ + 0x8000) >> 16));
+    }
+}
+
+#ifdef CONFIG_HAVE_FLOAT
+/****************************************************************************
+ * Name: dsp_float_to_q15
+ *
+ * Description:
+ *   Convert floating point values in [-1.0, 1.0) to Q15 with rounding to
+ *   nearest.  Out of range values are saturated.
+ *
+ ****************************************************************************/
+
+void dsp_float_to_q15(FAR const float *src, FAR q15_t *dst, size_t n)
+{
+  float v;
+
+  while (n-- > 0)
+    {
+      v = *src++ * 32768.0F;
+      v = v < 0.0F ? v - 0.5F : v + 0.5F;
+
+      if (v >= 32767.0F)
+        {
+          *dst++ = Q15_MAX;
+        }
+      else if (v <= -32768.0F)
+        {
+          *dst++ = Q15_MIN;
+        }
+      else
+        {
+          *dst++ = (q15_t)v;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_q15_to_float
+ ****************************************************************************/
+
+void dsp_q15_to_float(FAR const q15_t *src, FAR float *dst, size_t n)
+{
+  while (n-- > 0)
+    {
+      *dst++ = (float)*src++ * (1.0F / 32768.0F);
+    }
+}
+#endif
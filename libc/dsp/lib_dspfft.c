@@ -0,0 +1,217 @@
+/****************************************************************************
+ * libc/dsp/lib_dspfft.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* One quarter of a sine wave in Q15: g_dsp_sintab[i] = sin(i * pi / 512).
+ * The full-circle table of DSP_CFFT_MAXLEN points is derived from it.
+ */
+
+static const q15_t g_dsp_sintab[DSP_CFFT_MAXLEN / 4 + 1] =
+{
+       0,    201,    402,    603,    804,   1005,   1206,   1407,
+    1608,   1809,   2009,   2210,   2411,   2611,   2811,   3012,
+    3212,   3412,   3612,   3812,   4011,   4211,   4410,   4609,
+    4808,   5007,   5205,   5404,   5602,   5800,   5998,   6195,
+    6393,   6590,   6787,   6983,   7180,   7376,   7571,   7767,
+    7962,   8157,   8351,   8546,   8740,   8933,   9127,   9319,
+    9512,   9704,   9896,  10088,  10279,  10469,  10660,  10850,
+   11039,  11228,  11417,  11605,  11793,  11980,  12167,  12354,
+   12540,  12725,  12910,  13095,  13279,  13463,  13646,  13828,
+   14010,  14192,  14373,  14553,  14733,  14912,  15091,  15269,
+   15447,  15624,  15800,  15976,  16151,  16326,  16500,  16673,
+   16846,  17018,  17190,  17361,  17531,  17700,  17869,  18037,
+   18205,  18372,  18538,  18703,  18868,  19032,  19195,  19358,
+   19520,  19681,  19841,  20001,  20160,  20318,  20475,  20632,
+   20788,  20943,  21097,  21251,  21403,  21555,  21706,  21856,
+   22006,  22154,  22302,  22449,  22595,  22740,  22884,  23028,
+   23170,  23312,  23453,  23593,  23732,  23870,  24008,  24144,
+   24279,  24414,  24548,  24680,  24812,  24943,  25073,  25202,
+   25330,  25457,  25583,  25708,  25833,  25956,  26078,  26199,
+   26320,  26439,  26557,  26674,  26791,  26906,  27020,  27133,
+   27246,  27357,  27467,  27576,  27684,  27791,  27897,  28002,
+   28106,  28209,  28311,  28411,  28511,  28610,  28707,  28803,
+   28899,  28993,  29086,  29178,  29269,  29359,  29448,  29535,
+   29622,  29707,  29792,  29875,  29957,  30038,  30118,  30196,
+   30274,  30350,  30425,  30499,  30572,  30644,  30715,  30784,
+   30853,  30920,  30986,  31050,  31114,  31177,  31238,  31298,
+   31357,  31415,  31471,  31527,  31581,  31634,  31686,  31737,
+   31786,  31834,  31881,  31927,  31972,  32015,  32058,  32099,
+   32138,  32177,  32214,  32251,  32286,  32319,  32352,  32383,
+   32413,  32442,  32470,  32496,  32522,  32546,  32568,  32590,
+   32610,  32629,  32647,  32664,  32679,  32693,  32706,  32718,
+   32729,  32738,  32746,  32753,  32758,  32762,  32766,  32767,
+   32767
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_sin1024
+ *
+ * Description:
+ *   Return sin(2 * pi * i / 1024) in Q15 for any i.
+ *
+ ****************************************************************************/
+
+static q15_t dsp_sin1024(unsigned int i)
+{
+  unsigned int q = DSP_CFFT_MAXLEN / 4;
+
+  i &= DSP_CFFT_MAXLEN - 1;
+  if (i < q)
+    {
+      return g_dsp_sintab[i];
+    }
+  else if (i < 2 * q)
+    {
+      return g_dsp_sintab[2 * q - i];
+    }
+  else if (i < 3 * q)
+    {
+      return -g_dsp_sintab[i - 2 * q];
+    }
+  else
+    {
+      return -g_dsp_sintab[4 * q - i];
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_cfft_q15
+ *
+ * Description:
+ *   Radix-2 decimation-in-time complex FFT, performed in place.
+ *
+ * Input Parameters:
+ *   data    - n complex values stored as interleaved {re, im} pairs
+ *   n       - Transform length, a power of two in 2..DSP_CFFT_MAXLEN
+ *   inverse - Compute the inverse transform
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if n is not supported.
+ *
+ ****************************************************************************/
+
+int dsp_cfft_q15(FAR q15_t *data, size_t n, bool inverse)
+{
+  size_t half;
+  size_t step;
+  size_t i;
+  size_t j;
+  size_t k;
+
+  if (n < 2 || n > DSP_CFFT_MAXLEN || (n & (n - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Bit-reversal permutation */
+
+  for (i = 1, j = 0; i < n; i++)
+    {
+      size_t bit = n >> 1;
+
+      for (; (j & bit) != 0; bit >>= 1)
+        {
+          j ^= bit;
+        }
+
+      j |= bit;
+
+      if (i < j)
+        {
+          uint32_t tmp = dsp_read_q15x2(&data[2 * i]);
+          dsp_write_q15x2(&data[2 * i], dsp_read_q15x2(&data[2 * j]));
+          dsp_write_q15x2(&data[2 * j], tmp);
+        }
+    }
+
+  /* Butterflies, scaling every stage by 1/2 */
+
+  for (half = 1; half < n; half <<= 1)
+    {
+      step = DSP_CFFT_MAXLEN / (2 * half);
+
+      for (k = 0; k < half; k++)
+        {
+          int32_t wr = dsp_sin1024(k * step + DSP_CFFT_MAXLEN / 4);
+          int32_t wi = dsp_sin1024(k * step);
+
+          if (!inverse)
+            {
+              wi = -wi;
+            }
+
+          for (i = k; i < n; i += 2 * half)
+            {
+              FAR q15_t *a = &data[2 * i];
+              FAR q15_t *b = &data[2 * (i + half)];
+              int32_t tr = (wr * b[0] - wi * b[1]) >> 15;
+              int32_t ti = (wr * b[1] + wi * b[0]) >> 15;
+              int32_t ar = a[0];
+              int32_t ai = a[1];
+
+              a[0] = dsp_sat15((ar + tr) >> 1);
+              a[1] = dsp_sat15((ai + ti) >> 1);
+              b[0] = dsp_sat15((ar - tr) >> 1);
+              b[1] = dsp_sat15((ai - ti) >> 1);
+            }
+        }
+    }
+
+  return OK;
+}
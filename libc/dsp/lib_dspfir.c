@@ -0,0 +1,128 @@
+/****************************************************************************
+ * libc/dsp/lib_dspfir.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_fir_q15_init
+ *
+ * Description:
+ *   Initialize a FIR filter instance and clear its history.
+ *
+ * Input Parameters:
+ *   fir      - The filter instance to initialize
+ *   numtaps  - Number of coefficients
+ *   coeffs   - numtaps coefficients in time-reversed order
+ *   state    - Caller provided buffer of numtaps + maxblock - 1 samples
+ *   maxblock - Largest number of samples processed per dsp_fir_q15() pass
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dsp_fir_q15_init(FAR struct dsp_fir_q15_s *fir, uint16_t numtaps,
+                     FAR const q15_t *coeffs, FAR q15_t *state,
+                     uint16_t maxblock)
+{
+  if (numtaps == 0 || maxblock == 0 || coeffs == NULL || state == NULL)
+    {
+      return -EINVAL;
+    }
+
+  fir->numtaps  = numtaps;
+  fir->maxblock = maxblock;
+  fir->coeffs   = coeffs;
+  fir->state    = state;
+
+  memset(state, 0, (numtaps + maxblock - 1) * sizeof(q15_t));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dsp_fir_q15
+ *
+ * Description:
+ *   Filter n samples from src into dst.  src and dst may be the same
+ *   buffer.  New samples are appended to the history in state so that
+ *   each output is a single contiguous dot product, which is what lets
+ *   dsp_dot_q15() use dual multiply-accumulates.
+ *
+ ****************************************************************************/
+
+void dsp_fir_q15(FAR struct dsp_fir_q15_s *fir, FAR const q15_t *src,
+                 FAR q15_t *dst, size_t n)
+{
+  FAR q15_t *state = fir->state;
+  size_t hist = fir->numtaps - 1;
+  size_t blk;
+  size_t i;
+
+  while (n > 0)
+    {
+      blk = n < fir->maxblock ? n : fir->maxblock;
+
+      memcpy(&state[hist], src, blk * sizeof(q15_t));
+
+      for (i = 0; i < blk; i++)
+        {
+          dst[i] = dsp_sat15((int32_t)(dsp_dot_q15(&state[i], fir->coeffs,
+                                                   fir->numtaps) >> 15));
+        }
+
+      /* Keep the newest numtaps - 1 samples for the next block */
+
+      memmove(state, &state[blk], hist * sizeof(q15_t));
+
+      src += blk;
+      dst += blk;
+      n   -= blk;
+    }
+}
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * libc/dsp/lib_dspvector.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_add_q15
+ *
+ * Description:
+ *   dst[i] = sat(a[i] + b[i])
+ *
+ ****************************************************************************/
+
+void dsp_add_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst,
+                 size_t n)
+{
+#ifdef DSP_HAVE_SIMD
+  for (; n >= 2; n -= 2, a += 2, b += 2, dst += 2)
+    {
+      dsp_write_q15x2(dst, dsp_qadd16(dsp_read_q15x2(a),
+                                      dsp_read_q15x2(b)));
+    }
+#endif
+
+  while (n-- > 0)
+    {
+      *dst++ = dsp_sat15((int32_t)*a++ + *b++);
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_sub_q15
+ *
+ * Description:
+ *   dst[i] = sat(a[i] - b[i])
+ *
+ ****************************************************************************/
+
+void dsp_sub_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst,
+                 size_t n)
+{
+#ifdef DSP_HAVE_SIMD
+  for (; n >= 2; n -= 2, a += 2, b += 2, dst += 2)
+    {
+      dsp_write_q15x2(dst, dsp_qsub16(dsp_read_q15x2(a),
+                                      dsp_read_q15x2(b)));
+    }
+#endif
+
+  while (n-- > 0)
+    {
+      *dst++ = dsp_sat15((int32_t)*a++ - *b++);
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_mult_q15
+ *
+ * Description:
+ *   dst[i] = sat(a[i] * b[i]).  Only -1.0 * -1.0 actually saturates.
+ *
+ ****************************************************************************/
+
+void dsp_mult_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *dst,
+                  size_t n)
+{
+  while (n-- > 0)
+    {
+      *dst++ = dsp_sat15(((int32_t)*a++ * *b++) >> 15);
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_scale_q15
+ *
+ * Description:
+ *   dst[i] = sat((src[i] * scale) << shift).  A positive shift allows
+ *   gains larger than 1.0; a negative one attenuates further.  shift must
+ *   be in the range -16..15.
+ *
+ ****************************************************************************/
+
+void dsp_scale_q15(FAR const q15_t *src, q15_t scale, int shift,
+                   FAR q15_t *dst, size_t n)
+{
+  int rshift = 15 - shift;
+
+  while (n-- > 0)
+    {
+      *dst++ = dsp_sat15((int32_t)(((int64_t)*src++ * scale) >> rshift));
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_dot_q15
+ *
+ * Description:
+ *   Return sum(a[i] * b[i]) as a Q30 value.  The 64-bit accumulator cannot
+ *   overflow for any practical n.
+ *
+ ****************************************************************************/
+
+int64_t dsp_dot_q15(FAR const q15_t *a, FAR const q15_t *b, size_t n)
+{
+  int64_t sum = 0;
+
+#ifdef DSP_HAVE_SIMD
+  for (; n >= 4; n -= 4, a += 4, b += 4)
+    {
+      sum = dsp_smlald(dsp_read_q15x2(a), dsp_read_q15x2(b), sum);
+      sum = dsp_smlald(dsp_read_q15x2(a + 2), dsp_read_q15x2(b + 2), sum);
+    }
+#endif
+
+  while (n-- > 0)
+    {
+      sum += (int32_t)*a++ * *b++;
+    }
+
+  return sum;
+}
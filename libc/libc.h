@@ -71,6 +71,7 @@
 #ifdef CONFIG_STDIO_DISABLE_BUFFERING
 #  define lib_sem_initialize(s)
 #  define lib_take_semaphore(s)
+#  define lib_trytake_semaphore(s) (OK)
 #  define lib_give_semaphore(s)
 #endif
 
@@ -121,6 +122,18 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* Helpers for the word-at-a-time string functions selected by
+ * CONFIG_LIBC_STRING_OPTSPEED.  LIB_HASZERO(w) is non-zero if any byte of
+ * the word w is zero.
+ */
+
+#define LIB_WORDSIZE       sizeof(uintptr_t)
+#define LIB_WORDMASK       (sizeof(uintptr_t) - 1)
+#define LIB_WORDONES       ((uintptr_t)-1 / 0xff)
+#define LIB_WORDHIGHS      (LIB_WORDONES << 7)
+#define LIB_HASZERO(w)     (((w) - LIB_WORDONES) & ~(w) & LIB_WORDHIGHS)
+#define LIB_UNALIGNED(p)   (((uintptr_t)(p) & LIB_WORDMASK) != 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -190,6 +203,7 @@ int lib_wrflush(FAR FILE *stream);
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
 void lib_sem_initialize(FAR struct file_struct *stream);
 void lib_take_semaphore(FAR struct file_struct *stream);
+int  lib_trytake_semaphore(FAR struct file_struct *stream);
 void lib_give_semaphore(FAR struct file_struct *stream);
 #endif
 
@@ -222,6 +236,14 @@ double lib_expi(size_t n);
 float lib_sqrtapprox(float x);
 #endif
 
+/* Defined in lib_librempio2f.c */
+
+#ifdef CONFIG_LIBM
+int   lib_rempio2f(float x, float *y);
+float lib_sindf(float x);
+float lib_cosdf(float x);
+#endif
+
 /* Defined in lib_parsehostfile.c */
 
 #ifdef CONFIG_NETDB_HOSTFILE
@@ -3,7 +3,7 @@
  *
  * This file is a part of NuttX:
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2018 Gregory Nutt. All rights reserved.
  *   Ported by: Darcy Gong
  *
  * It derives from the Rhombus OS math library by Nick Johnson which has
@@ -29,13 +29,48 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float cosf(float x)
 {
-  return sinf(x + M_PI_2_F);
+  float y;
+  int n;
+
+  if (isnan(x) || isinf_f(x))
+    {
+      return NAN_F;
+    }
+
+  /* Small arguments need no reduction */
+
+  if (fabsf(x) <= 0.7853981634F)
+    {
+      return lib_cosdf(x);
+    }
+
+  /* Reduce to [-pi/4, pi/4] and select the quadrant */
+
+  n = lib_rempio2f(x, &y);
+  switch (n & 3)
+    {
+      case 0:
+        return lib_cosdf(y);
+
+      case 1:
+        return -lib_sindf(y);
+
+      case 2:
+        return -lib_cosdf(y);
+
+      default:
+        return lib_sindf(y);
+    }
 }
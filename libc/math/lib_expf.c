@@ -29,29 +29,28 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
-#include <math.h>
+#include <nuttx/config.h>
 
-#include "libc.h"
+#include <math.h>
 
 /****************************************************************************
- * Private Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
-static float _flt_inv_fact[] =
-{
-  1.0 / 1.0,                    /* 1/0! */
-  1.0 / 1.0,                    /* 1/1! */
-  1.0 / 2.0,                    /* 1/2! */
-  1.0 / 6.0,                    /* 1/3! */
-  1.0 / 24.0,                   /* 1/4! */
-  1.0 / 120.0,                  /* 1/5! */
-  1.0 / 720.0,                  /* 1/6! */
-  1.0 / 5040.0,                 /* 1/7! */
-  1.0 / 40320.0,                /* 1/8! */
-  1.0 / 362880.0,               /* 1/9! */
-  1.0 / 3628800.0,              /* 1/10! */
-};
+#define EXPF_MAX     88.7228393F   /* expf(x) overflows above this */
+#define EXPF_MIN    -103.972084F   /* expf(x) underflows to zero below this */
+
+/* ln(2) split so that k * LN2_HI is exact for the range of k used here */
+
+#define LN2_HI       6.9314575195e-01F
+#define LN2_LO       1.4286067653e-06F
+
+/* Remez coefficients for the rational approximation of exp(r) on
+ * [-ln(2)/2, ln(2)/2]
+ */
+
+#define P1           1.6666625440e-01F
+#define P2          -2.7667332906e-03F
 
 /****************************************************************************
  * Public Functions
@@ -59,54 +58,44 @@ static float _flt_inv_fact[] =
 
 float expf(float x)
 {
-  size_t int_part;
-  bool invert;
-  float value;
-  float x0;
-  size_t i;
-
-  if (x == 0)
+  float hi;
+  float lo;
+  float r;
+  float rr;
+  float c;
+  float fk;
+  int k;
+
+  if (isnan(x))
     {
-      return 1;
+      return x;
     }
-  else if (x < 0)
+
+  if (x > EXPF_MAX)
     {
-      invert = true;
-      x = -x;
+      return INFINITY_F;
     }
-  else
+
+  if (x < EXPF_MIN)
     {
-      invert = false;
+      return 0.0F;
     }
 
-  /* Extract integer component */
+  /* Reduce x = k * ln(2) + r with |r| <= ln(2)/2 */
 
-  int_part = (size_t) x;
+  fk = x * (float)M_LOG2E;
+  k  = (int)(fk < 0.0F ? fk - 0.5F : fk + 0.5F);
+  fk = (float)k;
 
-  /* set x to fractional component */
+  hi = x - fk * LN2_HI;
+  lo = fk * LN2_LO;
+  r  = hi - lo;
 
-  x -= (float)int_part;
+  /* exp(r) = 1 + r + r * c / (2 - c) */
 
-  /* Perform Taylor series approximation with eleven terms */
+  rr = r * r;
+  c  = r - rr * (P1 + rr * P2);
+  r  = 1.0F + (r * c / (2.0F - c) - lo + hi);
 
-  value = 0.0F;
-  x0 = 1.0F;
-  for (i = 0; i < 10; i++)
-    {
-      value += x0 * _flt_inv_fact[i];
-      x0 *= x;
-    }
-
-  /* Multiply by exp of the integer component */
-
-  value *= lib_expif(int_part);
-
-  if (invert)
-    {
-      return (1.0F / value);
-    }
-  else
-    {
-      return value;
-    }
+  return k == 0 ? r : ldexpf(r, k);
 }
@@ -3,7 +3,7 @@
  *
  * This file is a part of NuttX:
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2018 Gregory Nutt. All rights reserved.
  *   Ported by: Darcy Gong
  *
  * It derives from the Rhombus OS math library by Nick Johnson which has
@@ -29,13 +29,60 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <math.h>
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+union ldexpf_u
+{
+  float    f;
+  uint32_t i;
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float ldexpf(float x, int n)
 {
-  return (x * powf(2.0F, (float)n));
+  union ldexpf_u u;
+
+  /* Scale in steps that stay within the normal exponent range so that
+   * overflow and gradual underflow are produced by the final multiply.
+   */
+
+  if (n > 127)
+    {
+      x *= 1.7014118e38F;                     /* 2^127 */
+      n -= 127;
+      if (n > 127)
+        {
+          x *= 1.7014118e38F;
+          n -= 127;
+          if (n > 127)
+            {
+              n = 127;
+            }
+        }
+    }
+  else if (n < -126)
+    {
+      x *= 1.9721523e-31F;                    /* 2^-102 */
+      n += 102;
+      if (n < -126)
+        {
+          x *= 1.9721523e-31F;
+          n += 102;
+          if (n < -126)
+            {
+              n = -126;
+            }
+        }
+    }
+
+  u.i = (uint32_t)(n + 127) << 23;
+  return x * u.f;
 }
@@ -0,0 +1,167 @@
+/****************************************************************************
+ * libc/math/lib_librempio2f.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <math.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 split into pieces for Cody-Waite argument reduction.  The first
+ * three pieces have only 12 significant bits so that n * PIO2_x is exact
+ * in single precision for |n| < 2^12.
+ */
+
+#define PIO2_1      1.5703125F              /* 0x3fc90000 */
+#define PIO2_2      4.8375129699707031e-04F /* 0x39fda000 */
+#define PIO2_3      7.5495336204767227e-08F /* 0x33a22000 */
+#define PIO2_4      2.5633440682570896e-12F /* 0x2c34611a */
+
+/* Above this magnitude n no longer fits in 12 bits and the reduction is
+ * done in double precision instead, using pi/2 split into a 33-bit head
+ * and a tail.  That keeps the result accurate up to roughly 2^28 * pi/2;
+ * beyond that the reduction degrades gracefully.
+ */
+
+#define PIO2F_LIMIT 6000.0F
+#define PIO2_1D     1.57079631090164184570e+00
+#define PIO2_1TD    1.58932547735281966916e-08
+
+/* Minimax coefficients for sin(x) and cos(x) on [-pi/4, pi/4] */
+
+#define S1         -1.6666666641626524e-01F
+#define S2          8.3333293858894632e-03F
+#define S3         -1.9839334836096632e-04F
+#define S4          2.7183114939898219e-06F
+
+#define C0         -4.9999999725103100e-01F
+#define C1          4.1666623323739063e-02F
+#define C2         -1.3886763774609929e-03F
+#define C3          2.4390448796277409e-05F
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_rempio2f
+ *
+ * Description:
+ *   Reduce x to y = x - n * pi/2 with |y| <= ~pi/4 and return n.  Callers
+ *   only need the low two bits of n to select the quadrant.
+ *
+ ****************************************************************************/
+
+int lib_rempio2f(float x, float *y)
+{
+  float fn;
+  int n;
+
+  if (fabsf(x) < PIO2F_LIMIT)
+    {
+      fn = x * (float)M_2_PI;
+      n  = (int)(fn < 0.0F ? fn - 0.5F : fn + 0.5F);
+      fn = (float)n;
+
+      *y = (((x - fn * PIO2_1) - fn * PIO2_2) - fn * PIO2_3) - fn * PIO2_4;
+      return n;
+    }
+  else
+    {
+#ifdef CONFIG_HAVE_DOUBLE
+      double dx = (double)x;
+      double dn;
+
+      /* Keep n representable; the quadrant only depends on n mod 4 */
+
+      if (fabs(dx) > 1.0e9)
+        {
+          dx = fmod(dx, 2.0 * M_PI);
+        }
+
+      dn = floor(dx * M_2_PI + 0.5);
+      *y = (float)((dx - dn * PIO2_1D) - dn * PIO2_1TD);
+      return (int)dn;
+#else
+      x  = fmodf(x, 2.0F * M_PI_F);
+      fn = x * (float)M_2_PI;
+      n  = (int)(fn < 0.0F ? fn - 0.5F : fn + 0.5F);
+      fn = (float)n;
+
+      *y = (((x - fn * PIO2_1) - fn * PIO2_2) - fn * PIO2_3) - fn * PIO2_4;
+      return n;
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: lib_sindf
+ *
+ * Description:
+ *   sin(x) for |x| <= ~pi/4
+ *
+ ****************************************************************************/
+
+float lib_sindf(float x)
+{
+  float z = x * x;
+
+  return x + x * z * (S1 + z * (S2 + z * (S3 + z * S4)));
+}
+
+/****************************************************************************
+ * Name: lib_cosdf
+ *
+ * Description:
+ *   cos(x) for |x| <= ~pi/4
+ *
+ ****************************************************************************/
+
+float lib_cosdf(float x)
+{
+  float z = x * x;
+
+  return 1.0F + z * (C0 + z * (C1 + z * (C2 + z * C3)));
+}
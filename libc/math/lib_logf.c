@@ -3,7 +3,7 @@
  *
  * This file is a part of NuttX:
  *
- *   Copyright (C) 2012, 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2017-2018 Gregory Nutt. All rights reserved.
  *   Ported by: Darcy Gong
  *
  * It derives from the Rhombus OS math library by Nick Johnson which has
@@ -29,10 +29,35 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
-#include <float.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LN2_HI       6.9313812256e-01F  /* 0x3f317180 */
+#define LN2_LO       9.0580006145e-06F  /* 0x3717f7d1 */
+
+/* Coefficients of the approximation of log(1 + f) on [sqrt(2)/2, sqrt(2)] */
 
-#define FLT_MAX_EXP_X   88.0F
+#define LG1          0.66666662693F     /* 0xaaaaaa.0p-24 */
+#define LG2          0.40000972152F     /* 0xccce13.0p-25 */
+#define LG3          0.28498786688F     /* 0x91e9ee.0p-25 */
+#define LG4          0.24279078841F     /* 0xf89e26.0p-26 */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+union logf_u
+{
+  float    f;
+  uint32_t i;
+};
 
 /****************************************************************************
  * Public Functions
@@ -44,43 +69,63 @@
 
 float logf(float x)
 {
-  float y;
-  float y_old;
-  float ey;
-  float epsilon;
+  union logf_u u;
+  float hfsq;
+  float f;
+  float s;
+  float z;
+  float w;
+  float r;
+  float dk;
+  int k;
 
-  y       = 0.0F;
-  y_old   = 1.0F;
-  epsilon = FLT_EPSILON;
-
-  while (y > y_old + epsilon || y < y_old - epsilon)
+  if (isnan(x))
     {
-      y_old = y;
-      ey    = expf(y);
-      y    -= (ey - x) / ey;
-
-      if (y > FLT_MAX_EXP_X)
-        {
-          y = FLT_MAX_EXP_X;
-        }
+      return x;
+    }
 
-      if (y < -FLT_MAX_EXP_X)
-        {
-          y = -FLT_MAX_EXP_X;
-        }
+  if (x < 0.0F)
+    {
+      set_errno(EDOM);
+      return NAN_F;
+    }
 
-      epsilon = (fabsf(y) > 1.0F) ? fabsf(y) * FLT_EPSILON : FLT_EPSILON;
+  if (x == 0.0F)
+    {
+      set_errno(ERANGE);
+      return -INFINITY_F;
     }
 
-  if (y == FLT_MAX_EXP_X)
+  if (isinf_f(x))
     {
-      return INFINITY;
+      return x;
     }
 
-  if (y == -FLT_MAX_EXP_X)
+  /* Write x = 2^k * m with m in [sqrt(2)/2, sqrt(2)) */
+
+  k = 0;
+  u.f = x;
+  if (u.i < 0x00800000)
     {
-      return INFINITY;
+      /* Subnormal: scale into the normal range first */
+
+      k   = -25;
+      u.f = x * 33554432.0F;            /* 2^25 */
     }
 
-  return y;
+  u.i += 0x3f800000 - 0x3f3504f3;
+  k   += (int)(u.i >> 23) - 127;
+  u.i  = (u.i & 0x007fffff) + 0x3f3504f3;
+
+  /* log(1 + f) = f - f^2/2 + s * (f^2/2 + R(s^2)) with s = f / (2 + f) */
+
+  f    = u.f - 1.0F;
+  s    = f / (2.0F + f);
+  z    = s * s;
+  w    = z * z;
+  r    = z * (LG1 + w * LG3) + w * (LG2 + w * LG4);
+  hfsq = 0.5F * f * f;
+  dk   = (float)k;
+
+  return s * (hfsq + r) + dk * LN2_LO - hfsq + f + dk * LN2_HI;
 }
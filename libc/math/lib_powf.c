@@ -3,7 +3,7 @@
  *
  * This file is a part of NuttX:
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2018 Gregory Nutt. All rights reserved.
  *   Ported by: Darcy Gong
  *
  * It derives from the Rhombus OS math library by Nick Johnson which has
@@ -29,13 +29,102 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdbool.h>
 #include <math.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Integer exponents up to this magnitude use repeated squaring.  This is
+ * both faster and more accurate than going through expf(e * logf(b)).
+ */
+
+#define POWF_MAX_INTEXP 64
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float powf(float b, float e)
 {
-  return expf(e * logf(b));
+  float result;
+  float ip;
+  bool  odd;
+  long  n;
+
+  /* Special cases */
+
+  if (e == 0.0F || b == 1.0F)
+    {
+      return 1.0F;
+    }
+
+  if (isnan(b) || isnan(e))
+    {
+      return NAN_F;
+    }
+
+  if (b == -1.0F && isinf_f(e))
+    {
+      return 1.0F;
+    }
+
+  /* Classify the exponent: is it an (odd) integer? */
+
+  odd = false;
+  if (modff(e, &ip) == 0.0F)
+    {
+      if (fabsf(ip) < 16777216.0F)
+        {
+          odd = ((long)ip & 1) != 0;
+        }
+
+      if (fabsf(ip) <= POWF_MAX_INTEXP)
+        {
+          n      = (long)ip;
+          result = 1.0F;
+
+          if (n < 0)
+            {
+              n = -n;
+              b = 1.0F / b;
+            }
+
+          for (; ; )
+            {
+              if ((n & 1) != 0)
+                {
+                  result *= b;
+                }
+
+              n >>= 1;
+              if (n == 0)
+                {
+                  break;
+                }
+
+              b *= b;
+            }
+
+          return result;
+        }
+    }
+  else if (b < 0.0F)
+    {
+      /* Negative base with a non-integer exponent */
+
+      return NAN_F;
+    }
+
+  if (b == 0.0F)
+    {
+      result = e > 0.0F ? 0.0F : INFINITY_F;
+      return odd ? copysignf(result, b) : result;
+    }
+
+  result = expf(e * logf(fabsf(b)));
+  return (b < 0.0F && odd) ? -result : result;
 }
@@ -3,7 +3,7 @@
  *
  * This file is a part of NuttX:
  *
- *   Copyright (C) 2012 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2012, 2018 Gregory Nutt. All rights reserved.
  *   Ported by: Darcy Gong
  *
  * It derives from the Rhombus OS math library by Nick Johnson which has
@@ -29,22 +29,11 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
+#include <nuttx/config.h>
+
 #include <math.h>
 
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-static float _flt_inv_fact[] =
-{
-  1.0 / 1.0,                    /* 1 / 1! */
-  1.0 / 6.0,                    /* 1 / 3! */
-  1.0 / 120.0,                  /* 1 / 5! */
-  1.0 / 5040.0,                 /* 1 / 7! */
-  1.0 / 362880.0,               /* 1 / 9! */
-  1.0 / 39916800.0,             /* 1 / 11! */
-};
+#include "libc.h"
 
 /****************************************************************************
  * Public Functions
@@ -52,53 +41,36 @@ static float _flt_inv_fact[] =
 
 float sinf(float x)
 {
-  float x_squared;
-  float sin_x;
-  size_t i;
-
-  /* Move x to [-pi, pi) */
-
-  x = fmodf(x, 2 * M_PI_F);
-  if (x >= M_PI_F)
-    {
-      x -= 2 * M_PI_F;
-    }
+  float y;
+  int n;
 
-  if (x < -M_PI_F)
+  if (isnan(x) || isinf_f(x))
     {
-      x += 2 * M_PI_F;
+      return NAN_F;
     }
 
-  /* Move x to [-pi/2, pi/2) */
+  /* Small arguments need no reduction */
 
-  if (x >= M_PI_2_F)
+  if (fabsf(x) <= 0.7853981634F)
     {
-      x = M_PI_F - x;
+      return lib_sindf(x);
     }
 
-  if (x < -M_PI_2_F)
-    {
-      x = -M_PI_F - x;
-    }
+  /* Reduce to [-pi/4, pi/4] and select the quadrant */
 
-  x_squared = x * x;
-  sin_x = 0.0F;
+  n = lib_rempio2f(x, &y);
+  switch (n & 3)
+    {
+      case 0:
+        return lib_sindf(y);
 
-  /* Perform Taylor series approximation for sin(x) with six terms */
+      case 1:
+        return lib_cosdf(y);
 
-  for (i = 0; i < 6; i++)
-    {
-      if (i % 2 == 0)
-        {
-          sin_x += x * _flt_inv_fact[i];
-        }
-      else
-        {
-          sin_x -= x * _flt_inv_fact[i];
-        }
+      case 2:
+        return -lib_sindf(y);
 
-      x *= x_squared;
+      default:
+        return -lib_cosdf(y);
     }
-
-  return sin_x;
 }
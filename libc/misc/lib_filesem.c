@@ -110,6 +110,38 @@ void lib_take_semaphore(FAR struct file_struct *stream)
     }
 }
 
+/****************************************************************************
+ * lib_trytake_semaphore
+ ****************************************************************************/
+
+int lib_trytake_semaphore(FAR struct file_struct *stream)
+{
+  pid_t my_pid = getpid();
+  int ret;
+
+  /* Do I already have the semaphore? */
+
+  if (stream->fs_holder == my_pid)
+    {
+      /* Yes, just increment the number of references that I have */
+
+      stream->fs_counts++;
+      return OK;
+    }
+
+  /* Try to take the semaphore without waiting */
+
+  ret = _SEM_TRYWAIT(&stream->fs_sem);
+  if (ret < 0)
+    {
+      return -_SEM_ERRNO(ret);
+    }
+
+  stream->fs_holder = my_pid;
+  stream->fs_counts = 1;
+  return OK;
+}
+
 /****************************************************************************
  * lib_give_semaphore
  ****************************************************************************/
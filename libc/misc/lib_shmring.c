@@ -0,0 +1,248 @@
+/****************************************************************************
+ * libc/misc/lib_shmring.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/shm.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/mm/shmring.h>
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A full memory barrier orders the accesses to the data and to the indices
+ * as seen by the other side, possibly running on another CPU.
+ */
+
+#ifdef __GNUC__
+#  define shmring_barrier() __sync_synchronize()
+#else
+#  define shmring_barrier()
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_initialize
+ ****************************************************************************/
+
+int shmring_initialize(FAR struct shmring_s *ring, size_t size)
+{
+  uint32_t datasize;
+
+  if (size < sizeof(struct shmring_s) + 1)
+    {
+      return -EINVAL;
+    }
+
+  /* Use the largest power of two that fits after the header */
+
+  size -= sizeof(struct shmring_s);
+  for (datasize = 1; datasize <= size / 2 && datasize < 0x80000000u;
+       datasize <<= 1);
+
+  memset(ring, 0, sizeof(struct shmring_s));
+  ring->sr_size = datasize;
+  shmring_barrier();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmring_claim
+ ****************************************************************************/
+
+size_t shmring_claim(FAR struct shmring_s *ring, FAR void **buffer)
+{
+  uint32_t head   = ring->sr_head;
+  uint32_t offset = head & (ring->sr_size - 1);
+  uint32_t nfree  = ring->sr_size - (head - ring->sr_tail);
+
+  /* The free space may wrap around the end of the data area */
+
+  *buffer = SHMRING_DATA(ring) + offset;
+  return nfree < ring->sr_size - offset ? nfree : ring->sr_size - offset;
+}
+
+/****************************************************************************
+ * Name: shmring_commit
+ ****************************************************************************/
+
+void shmring_commit(FAR struct shmring_s *ring, size_t nbytes)
+{
+  /* Make the data visible before the new head */
+
+  shmring_barrier();
+  ring->sr_head += nbytes;
+
+  /* Publish the head before checking for a waiting consumer.  A consumer
+   * that announces its wait after this point will see the new head.
+   */
+
+  shmring_barrier();
+  if (ring->sr_rwait != 0)
+    {
+      (void)shmwake((FAR const void *)&ring->sr_head, 1);
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_peek
+ ****************************************************************************/
+
+size_t shmring_peek(FAR struct shmring_s *ring, FAR void **buffer)
+{
+  uint32_t tail   = ring->sr_tail;
+  uint32_t offset = tail & (ring->sr_size - 1);
+  uint32_t navail = ring->sr_head - tail;
+
+  /* Don't read the data before the head that published it */
+
+  shmring_barrier();
+
+  *buffer = SHMRING_DATA(ring) + offset;
+  return navail < ring->sr_size - offset ? navail : ring->sr_size - offset;
+}
+
+/****************************************************************************
+ * Name: shmring_release
+ ****************************************************************************/
+
+void shmring_release(FAR struct shmring_s *ring, size_t nbytes)
+{
+  /* Finish reading the data before handing the space back */
+
+  shmring_barrier();
+  ring->sr_tail += nbytes;
+
+  shmring_barrier();
+  if (ring->sr_wwait != 0)
+    {
+      (void)shmwake((FAR const void *)&ring->sr_tail, 1);
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_waitdata
+ ****************************************************************************/
+
+int shmring_waitdata(FAR struct shmring_s *ring,
+                     FAR const struct timespec *abstime)
+{
+  uint32_t head;
+  int ret = OK;
+
+  for (; ; )
+    {
+      /* Announce the wait, then check again */
+
+      ring->sr_rwait = 1;
+      shmring_barrier();
+
+      head = ring->sr_head;
+      if (head != ring->sr_tail)
+        {
+          break;
+        }
+
+      /* Sleep unless the head has moved in the meantime */
+
+      if (shmwait((FAR const void *)&ring->sr_head, head, abstime) < 0 &&
+          get_errno() != EAGAIN)
+        {
+          ret = -get_errno();
+          break;
+        }
+    }
+
+  ring->sr_rwait = 0;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmring_waitspace
+ ****************************************************************************/
+
+int shmring_waitspace(FAR struct shmring_s *ring, size_t nbytes,
+                      FAR const struct timespec *abstime)
+{
+  uint32_t tail;
+  int ret = OK;
+
+  if (nbytes > ring->sr_size)
+    {
+      return -EINVAL;
+    }
+
+  for (; ; )
+    {
+      /* Announce the wait, then check again */
+
+      ring->sr_wwait = 1;
+      shmring_barrier();
+
+      tail = ring->sr_tail;
+      if (ring->sr_size - (ring->sr_head - tail) >= nbytes)
+        {
+          break;
+        }
+
+      /* Sleep unless the tail has moved in the meantime */
+
+      if (shmwait((FAR const void *)&ring->sr_tail, tail, abstime) < 0 &&
+          get_errno() != EAGAIN)
+        {
+          ret = -get_errno();
+          break;
+        }
+    }
+
+  ring->sr_wwait = 0;
+  return ret;
+}
+
+#endif /* CONFIG_MM_SHM */
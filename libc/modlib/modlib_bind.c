@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <elf32.h>
@@ -50,8 +51,43 @@
 #include <nuttx/lib/modlib.h>
 #include <nuttx/binfmt/symtab.h>
 
+#include "libc.h"
 #include "modlib/modlib.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MODLIB_RELOCATION_BUFFERCOUNT
+#  define CONFIG_MODLIB_RELOCATION_BUFFERCOUNT 1
+#endif
+
+#ifndef CONFIG_MODLIB_SYMBOL_CACHECOUNT
+#  define CONFIG_MODLIB_SYMBOL_CACHECOUNT 0
+#endif
+
+#define REL_BUFFERCOUNT CONFIG_MODLIB_RELOCATION_BUFFERCOUNT
+#define SYM_CACHECOUNT  CONFIG_MODLIB_SYMBOL_CACHECOUNT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry of the direct-mapped cache of resolved symbols.  Objects
+ * typically reference the same few imported symbols from many relocations;
+ * the cache avoids re-reading the symbol entry and re-searching the symbol
+ * table for each of them.
+ */
+
+#if SYM_CACHECOUNT > 0
+struct modlib_symcache_s
+{
+  int       idx;                /* Symbol table index (-1 if unused) */
+  bool      named;              /* False: Undefined symbol with no name */
+  Elf32_Sym sym;                /* Symbol with resolved st_value */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -60,31 +96,34 @@
  * Name: modlib_readrel
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read up to 'count' consecutive ELF32_Rel structures into memory,
+ *   beginning with relocation 'index'.
  *
  ****************************************************************************/
 
 static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
                                  FAR const Elf32_Shdr *relsec,
-                                 int index, FAR Elf32_Rel *rel)
+                                 int index, int count, FAR Elf32_Rel *rel)
 {
   off_t offset;
+  int nrels = relsec->sh_size / sizeof(Elf32_Rel);
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the relocation indices lie within relocation table */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || count <= 0 || index + count > nrels)
     {
       serr("ERROR: Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  /* Get the file offset to the first relocation table entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation table entries into memory */
 
-  return modlib_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
+  return modlib_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel) * count,
+                     offset);
 }
 
 /****************************************************************************
@@ -93,6 +132,12 @@ static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
  * Description:
  *   Perform all relocations associated with a section.
  *
+ *   Relocation entries are read from the file in blocks of up to
+ *   CONFIG_MODLIB_RELOCATION_BUFFERCOUNT entries and resolved symbols are
+ *   remembered in a small cache of CONFIG_MODLIB_SYMBOL_CACHECOUNT entries.
+ *   If either buffer cannot be allocated, the relocations are performed
+ *   one entry at a time without the cache.
+ *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
  *   failure.
@@ -101,42 +146,124 @@ static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
 
 static int modlib_relocate(FAR struct module_s *modp,
                            FAR struct mod_loadinfo_s *loadinfo, int relidx)
-
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+#if SYM_CACHECOUNT > 0
+  FAR struct modlib_symcache_s *cache;
+  FAR struct modlib_symcache_s *entry;
+#endif
+  FAR Elf32_Rel  *rels;
+  FAR Elf32_Rel  *rel;
+  Elf32_Rel       onerel;
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+  int             nrels;
+  int             nbuffer;
+  int             nread;
   int             symidx;
   int             ret;
   int             i;
+  int             j;
+
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  if (nrels <= 0)
+    {
+      return OK;
+    }
+
+  /* Allocate a buffer to hold a block of relocation entries */
+
+  rels    = &onerel;
+  nbuffer = 1;
+
+#if REL_BUFFERCOUNT > 1
+  if (nrels > 1)
+    {
+      nbuffer = nrels < REL_BUFFERCOUNT ? nrels : REL_BUFFERCOUNT;
+      rels    = (FAR Elf32_Rel *)lib_malloc(nbuffer * sizeof(Elf32_Rel));
+      if (rels == NULL)
+        {
+          rels    = &onerel;
+          nbuffer = 1;
+        }
+    }
+#endif
+
+#if SYM_CACHECOUNT > 0
+  /* Allocate and initialize the symbol cache */
+
+  cache = (FAR struct modlib_symcache_s *)
+    lib_malloc(SYM_CACHECOUNT * sizeof(struct modlib_symcache_s));
+
+  if (cache != NULL)
+    {
+      for (j = 0; j < SYM_CACHECOUNT; j++)
+        {
+          cache[j].idx = -1;
+        }
+    }
+#endif
 
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  ret   = OK;
+  nread = 0;
+  j     = 0;
+
+  for (i = 0; i < nrels; i++, j++)
     {
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next block of relocation entries into memory when the
+       * buffer has been consumed.
+       */
 
-      ret = modlib_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if (j >= nread)
         {
-          serr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          nread = nrels - i < nbuffer ? nrels - i : nbuffer;
+          j     = 0;
+
+          ret = modlib_readrel(loadinfo, relsec, i, nread, rels);
+          if (ret < 0)
+            {
+              serr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              break;
+            }
         }
 
+      rel = &rels[j];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
+
+#if SYM_CACHECOUNT > 0
+      /* Check if this symbol has already been resolved */
+
+      entry = NULL;
+      if (cache != NULL)
+        {
+          entry = &cache[symidx % SYM_CACHECOUNT];
+          if (entry->idx == symidx)
+            {
+              memcpy(&sym, &entry->sym, sizeof(Elf32_Sym));
+              if (!entry->named)
+                {
+                  psym = NULL;
+                }
+
+              goto relocate;
+            }
+        }
+#endif
 
       /* Read the symbol table entry into memory */
 
@@ -145,7 +272,7 @@ static int modlib_relocate(FAR struct module_s *modp,
         {
           serr("ERROR: Section %d reloc %d: Failed to read symbol[%d]: %d\n",
                relidx, i, symidx, ret);
-          return ret;
+          break;
         }
 
       /* Get the value of the symbol (in sym.st_value) */
@@ -173,32 +300,60 @@ static int modlib_relocate(FAR struct module_s *modp,
             {
               serr("ERROR: Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
                   relidx, i, symidx, ret);
-              return ret;
+              break;
             }
         }
 
+#if SYM_CACHECOUNT > 0
+      /* Remember the resolved symbol for subsequent relocations */
+
+      if (entry != NULL)
+        {
+          entry->idx   = symidx;
+          entry->named = (psym != NULL);
+          memcpy(&entry->sym, &sym, sizeof(Elf32_Sym));
+        }
+
+relocate:
+#endif
+
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           serr("ERROR: Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
-          return -EINVAL;
+               relidx, i, rel->r_offset, dstsec->sh_size);
+          ret = -EINVAL;
+          break;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           serr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
-          return ret;
+          break;
         }
     }
 
-  return OK;
+  /* Free the relocation buffer and the symbol cache */
+
+#if SYM_CACHECOUNT > 0
+  if (cache != NULL)
+    {
+      lib_free(cache);
+    }
+#endif
+
+  if (rels != &onerel)
+    {
+      lib_free(rels);
+    }
+
+  return ret < 0 ? ret : OK;
 }
 
 static int modlib_relocateadd(FAR struct module_s *modp,
@@ -46,6 +46,7 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -76,6 +77,10 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 30
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -208,6 +213,8 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
  *   hostname - The hostname string to be cached.
  *   addr     - The IP address associated with the hostname
  *   addrlen  - The size of the of the IP address.
+ *   ttl      - Time to live of the answer in seconds.  This is capped at
+ *              CONFIG_NETDB_DNSCLIENT_LIFESEC, if non-zero.
  *
  * Returned Value:
  *   None
@@ -216,7 +223,27 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 void dns_save_answer(FAR const char *hostname,
-                     FAR const struct sockaddr *addr, socklen_t addrlen);
+                     FAR const struct sockaddr *addr, socklen_t addrlen,
+                     uint32_t ttl);
+#endif
+
+/****************************************************************************
+ * Name: dns_save_failure
+ *
+ * Description:
+ *   Remember that hostname did not resolve so that repeated lookups do not
+ *   go to the network for CONFIG_NETDB_DNSCLIENT_NEGLIFESEC seconds.
+ *
+ * Input Parameters:
+ *   hostname - The hostname string that could not be resolved.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 && CONFIG_NETDB_DNSCLIENT_NEGLIFESEC > 0
+void dns_save_failure(FAR const char *hostname);
 #endif
 
 /****************************************************************************
@@ -236,8 +263,9 @@ void dns_save_answer(FAR const char *hostname,
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned:  -ENOENT meaning that the hostname was not
+ *   found in the cache or -EADDRNOTAVAIL meaning that the hostname is
+ *   cached as not resolvable.
  *
  ****************************************************************************/
 
@@ -1,7 +1,7 @@
 /****************************************************************************
  * libc/netdb/lib_dnscache.c
  *
- *   Copyright (C) 2007, 2009, 2012, 2014-2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007, 2009, 2012, 2014-2016, 2018 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/time.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
@@ -61,17 +62,25 @@
 #  define DNS_CLOCK CLOCK_REALTIME
 #endif
 
+/* Seconds left before an entry expires; <= 0 means the entry is stale.
+ * The signed difference keeps this correct across time_t wrap-around.
+ */
+
+#define DNS_REMAINING(e,now) ((int32_t)((uint32_t)(e)->expire - (uint32_t)(now)))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames */
+/* This described one entry in the cache of resolved hostnames.  An entry
+ * whose address family is AF_UNSPEC records a name that is known not to
+ * resolve (negative caching).
+ */
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t              ctime;      /* Creation time */
-#endif
+  uint32_t            hash;       /* Hash of name; zero if entry is free */
+  time_t              expire;     /* Time at which the entry expires */
   char                name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
   union dns_server_u  addr;       /* Resolved address */
 };
@@ -80,9 +89,6 @@ struct dns_cache_s
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
-
 /* This is the DNS resolver cache */
 
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
@@ -92,82 +98,196 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  ****************************************************************************/
 
 /****************************************************************************
- * Public Functions
+ * Name: dns_hash
+ *
+ * Description:
+ *   FNV-1a hash of the (possibly truncated) hostname.  Lookups compare
+ *   hashes first so that strncmp() only runs on the entry that matches.
+ *
  ****************************************************************************/
 
+static uint32_t dns_hash(FAR const char *hostname)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE && hostname[i] != '\0'; i++)
+    {
+      hash ^= (uint8_t)hostname[i];
+      hash *= 16777619u;
+    }
+
+  /* Zero marks a free entry */
+
+  return hash != 0 ? hash : 1;
+}
+
 /****************************************************************************
- * Name: dns_save_answer
+ * Name: dns_now
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Return the current time in seconds, using CLOCK_MONOTONIC if possible
  *
- * Input Parameters:
- *   hostname - The hostname string to be cached.
- *   addr     - The IP address associated with the hostname
- *   addrlen  - The size of the of the IP address.
+ ****************************************************************************/
+
+static time_t dns_now(void)
+{
+  struct timespec now;
+
+  if (clock_gettime(DNS_CLOCK, &now) < 0)
+    {
+      return 0;
+    }
+
+  return (time_t)now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_save_entry
  *
- * Returned Value:
- *   None
+ * Description:
+ *   Add or refresh the cache entry for hostname.  A NULL addr creates a
+ *   negative entry.  If the cache is full, the entry closest to expiry is
+ *   replaced.
  *
  ****************************************************************************/
 
-void dns_save_answer(FAR const char *hostname,
-                     FAR const struct sockaddr *addr, socklen_t addrlen)
+static void dns_save_entry(FAR const char *hostname,
+                           FAR const struct sockaddr *addr,
+                           socklen_t addrlen, uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
+  FAR struct dns_cache_s *victim;
+  int32_t remaining;
+  int32_t minremaining;
+  uint32_t hash;
+  time_t now;
   int ndx;
 
-  /* Get exclusive access to the DNS cache */
+  /* A TTL of zero means that the answer must not be cached (RFC 1035) */
 
-  dns_semtake();
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  if (ttl > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+    {
+      ttl = CONFIG_NETDB_DNSCLIENT_LIFESEC;
+    }
+#endif
 
-  /* Get the index to the new head of the list */
+  if (ttl == 0 || addrlen > sizeof(union dns_server_u))
+    {
+      return;
+    }
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  /* Keep the expiry arithmetic well inside int32_t */
+
+  if (ttl > INT32_MAX / 2)
     {
-      next = 0;
+      ttl = INT32_MAX / 2;
     }
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
+  hash = dns_hash(hostname);
+
+  /* Get exclusive access to the DNS cache */
+
+  dns_semtake();
+  now = dns_now();
+
+  /* Prefer the existing entry for this name, then a free or stale entry,
+   * and finally the entry that would expire first anyway.
    */
 
-  if (next == g_dns_tail)
+  victim       = &g_dns_cache[0];
+  minremaining = INT32_MAX;
+
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      entry = &g_dns_cache[ndx];
+
+      if (entry->hash == hash &&
+          strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
         {
-          tmp = 0;
+          victim = entry;
+          break;
         }
 
-      g_dns_tail = tmp;
+      remaining = entry->hash == 0 ? INT32_MIN : DNS_REMAINING(entry, now);
+      if (remaining < minremaining)
+        {
+          minremaining = remaining;
+          victim       = entry;
+        }
     }
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
+  victim->hash   = hash;
+  victim->expire = now + (time_t)ttl;
+  strncpy(victim->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
+  if (addr != NULL)
+    {
+      memcpy(&victim->addr.addr, addr, addrlen);
+    }
+  else
+    {
+      memset(&victim->addr, 0, sizeof(victim->addr));
+      victim->addr.addr.sa_family = AF_UNSPEC;
+    }
 
-  (void)clock_gettime(DNS_CLOCK, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
+  dns_semgive();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
-  memcpy(&entry->addr.addr, addr, addrlen);
+/****************************************************************************
+ * Name: dns_save_answer
+ *
+ * Description:
+ *   Same the last resolved hostname in the DNS cache
+ *
+ * Input Parameters:
+ *   hostname - The hostname string to be cached.
+ *   addr     - The IP address associated with the hostname
+ *   addrlen  - The size of the of the IP address.
+ *   ttl      - Time to live of the answer in seconds.  This is capped at
+ *              CONFIG_NETDB_DNSCLIENT_LIFESEC, if non-zero.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-  /* Save the updated head index */
+void dns_save_answer(FAR const char *hostname,
+                     FAR const struct sockaddr *addr, socklen_t addrlen,
+                     uint32_t ttl)
+{
+  dns_save_entry(hostname, addr, addrlen, ttl);
+}
 
-  g_dns_head = next;
-  dns_semgive();
+/****************************************************************************
+ * Name: dns_save_failure
+ *
+ * Description:
+ *   Remember that hostname did not resolve so that repeated lookups do not
+ *   go to the network for CONFIG_NETDB_DNSCLIENT_NEGLIFESEC seconds.
+ *
+ * Input Parameters:
+ *   hostname - The hostname string that could not be resolved.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDB_DNSCLIENT_NEGLIFESEC > 0
+void dns_save_failure(FAR const char *hostname)
+{
+  dns_save_entry(hostname, NULL, 0, CONFIG_NETDB_DNSCLIENT_NEGLIFESEC);
 }
+#endif
 
 /****************************************************************************
  * Name: dns_find_answer
@@ -186,8 +306,9 @@ void dns_save_answer(FAR const char *hostname,
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned:  -ENOENT meaning that the hostname was not
+ *   found in the cache or -EADDRNOTAVAIL meaning that the hostname is
+ *   cached as not resolvable.
  *
  ****************************************************************************/
 
@@ -195,12 +316,10 @@ int dns_find_answer(FAR const char *hostname, FAR struct sockaddr *addr,
                     FAR socklen_t *addrlen)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
+  socklen_t inlen;
+  uint32_t hash;
+  time_t now;
   int ret;
-#endif
-  int next;
   int ndx;
 
   /* If DNS not initialized, no need to proceed */
@@ -211,98 +330,77 @@ int dns_find_answer(FAR const char *hostname, FAR struct sockaddr *addr,
       return -EAGAIN;
     }
 
+  hash = dns_hash(hostname);
+
   /* Get exclusive access to the DNS cache */
 
   dns_semtake();
+  now = dns_now();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  ret = clock_gettime(DNS_CLOCK, &now);
-#endif
-
-  /* REVISIT: This is not thread safe */
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
     {
       entry = &g_dns_cache[ndx];
 
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
+      /* Compare hashes first.  Notice that because the names are truncated
+       * to CONFIG_NETDB_DNSCLIENT_NAMESIZE, this has the possibility of
+       * aliasing two names and returning the wrong entry from the cache.
        */
 
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      if (entry->hash != hash ||
+          strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) != 0)
         {
-          next = 0;
+          continue;
         }
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
+      /* Check if this entry has expired; if so, free it */
 
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+      if (DNS_REMAINING(entry, now) <= 0)
         {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
-
-          g_dns_tail = next;
+          entry->hash = 0;
+          break;
         }
-      else
-#endif
-        {
-          /* The entry has not expired, check for a name match.  Notice that
-           * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
-           */
 
-          if (strncmp(hostname, entry->name, CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              socklen_t inlen;
-
-              /* We have a match.  Return the resolved host address */
+      /* We have a match.  Return the resolved host address */
 
 #ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-              if (entry->addr.addr.sa_family == AF_INET)
-#endif
-                {
-                   inlen = sizeof(struct sockaddr_in);
-                }
+      if (entry->addr.addr.sa_family == AF_INET)
+        {
+          inlen = sizeof(struct sockaddr_in);
+        }
+      else
 #endif
-
 #ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
-              else
-#endif
-                {
-                   inlen = sizeof(struct sockaddr_in6);
-                }
+      if (entry->addr.addr.sa_family == AF_INET6)
+        {
+          inlen = sizeof(struct sockaddr_in6);
+        }
+      else
 #endif
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              if (*addrlen < inlen)
-                {
-                  ret = -ERANGE;
-                  goto errout_with_sem;
-                }
+        {
+          /* A negative entry */
 
-              /* Return the address information */
+          ret = -EADDRNOTAVAIL;
+          goto errout_with_sem;
+        }
 
-              memcpy(addr, &entry->addr.addr, inlen);
-              *addrlen = inlen;
+      /* Make sure that the address will fit in the caller-provided
+       * buffer.
+       */
 
-              dns_semgive();
-              return OK;
-            }
+      if (*addrlen < inlen)
+        {
+          ret = -ERANGE;
+          goto errout_with_sem;
         }
+
+      /* Return the address information */
+
+      memcpy(addr, &entry->addr.addr, inlen);
+      *addrlen = inlen;
+
+      dns_semgive();
+      return OK;
     }
 
   ret = -ENOENT;
@@ -313,4 +411,3 @@ errout_with_sem:
 }
 
 #endif /* CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 */
-
@@ -63,9 +63,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* The maximum number of retries when asking for a name */
+/* The number of times that the queries are resent to all name servers
+ * when no response arrives within the socket receive timeout.
+ */
+
+#define MAX_ROUNDS       3
 
-#define MAX_RETRIES      8
+/* The maximum number of queries outstanding at once.  With both IPv4 and
+ * IPv6 enabled, each name server receives an A and an AAAA query.
+ */
+
+#define MAX_PENDING      8
 
 /* Buffer sizes
  *
@@ -88,13 +96,16 @@ struct dns_query_s
   FAR const char *hostname;       /* Hostname to lookup */
   FAR struct sockaddr *addr;      /* Location to return host address */
   FAR socklen_t *addrlen;         /* Length of the address */
+  uint8_t npending;               /* Number of unanswered queries */
+  bool negative;                  /* All answers so far said "no address" */
+  uint16_t ids[MAX_PENDING];      /* IDs of the unanswered queries */
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_seqno;           /* Sequence number of the next request */
+static uint16_t g_seqno;          /* Sequence number of the next request */
 
 /****************************************************************************
  * Private Functions
@@ -164,31 +175,25 @@ static FAR uint8_t *dns_parse_name(FAR uint8_t *query, FAR uint8_t *queryend)
  * Name: dns_send_query
  *
  * Description:
- *   Runs through the list of names to see if there are any that have
- *   not yet been queried and, if so, sends out a query.
+ *   Send one query of type rectype for name to the name server at uaddr,
+ *   using seqno as the DNS message ID.
  *
  ****************************************************************************/
 
 static int dns_send_query(int sd, FAR const char *name,
-                          FAR union dns_server_u *uaddr, uint16_t rectype)
+                          FAR union dns_server_u *uaddr, uint16_t rectype,
+                          uint16_t seqno)
 {
   register FAR struct dns_header_s *hdr;
   FAR uint8_t *dest;
   FAR uint8_t *nptr;
   FAR const char *src;
   uint8_t buffer[SEND_BUFFER_SIZE];
-  uint8_t seqno;
   socklen_t addrlen;
   int errcode;
   int ret;
   int n;
 
-  /* Increment the sequence number */
-
-  dns_semtake();
-  seqno = g_seqno++;
-  dns_semgive();
-
   /* Initialize the request header */
 
   hdr               = (FAR struct dns_header_s *)buffer;
@@ -265,13 +270,22 @@ static int dns_send_query(int sd, FAR const char *name,
  * Name: dns_recv_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Receive one response and, if it answers one of the outstanding
+ *   queries, remove that query from the pending list and parse it.
+ *
+ * Returned Value:
+ *   OK if an address was returned in query->addr and its TTL in *ttl;
+ *   -ESRCH if the message does not answer any outstanding query; -EAGAIN
+ *   on receive timeout; -EADDRNOTAVAIL if the name has no address of the
+ *   requested type; another negated errno value on other failures.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR struct sockaddr *addr,
-                             FAR socklen_t *addrlen)
+static int dns_recv_response(FAR struct dns_query_s *query,
+                             FAR uint32_t *ttl)
 {
+  FAR struct sockaddr *addr = query->addr;
+  FAR socklen_t *addrlen = query->addrlen;
   FAR uint8_t *nameptr;
   FAR uint8_t *endofbuffer;
   char buffer[RECV_BUFFER_SIZE];
@@ -281,12 +295,14 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
   uint8_t nquestions;
 #endif
   uint8_t nanswers;
+  uint16_t id;
   int errcode;
   int ret;
+  int i;
 
   /* Receive the response */
 
-  ret = _NX_RECV(sd, buffer, RECV_BUFFER_SIZE, 0);
+  ret = _NX_RECV(query->sd, buffer, RECV_BUFFER_SIZE, 0);
   if (ret < 0)
     {
       errcode = -_NX_GETERRNO(ret);
@@ -299,12 +315,30 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
       /* DNS header can't fit in received data */
 
       nerr("ERROR: DNS response is too short\n");
-      return -EILSEQ;
+      return -ESRCH;
     }
 
   hdr         = (FAR struct dns_header_s *)buffer;
   endofbuffer = (FAR uint8_t*)buffer + ret;
 
+  /* Match the response against the outstanding queries.  Anything else is
+   * a late answer to an earlier round (or a spoofing attempt) and is
+   * ignored.
+   */
+
+  id = ntohs(hdr->id);
+  for (i = 0; i < query->npending && query->ids[i] != id; i++)
+    {
+    }
+
+  if (i >= query->npending || (hdr->flags1 & DNS_FLAG1_RESPONSE) == 0)
+    {
+      ninfo("Ignoring response with ID %u\n", id);
+      return -ESRCH;
+    }
+
+  query->ids[i] = query->ids[--query->npending];
+
   ninfo("ID %d\n", htons(hdr->id));
   ninfo("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
   ninfo("Error %d\n", hdr->flags2 & DNS_FLAG2_ERR_MASK);
@@ -317,7 +351,8 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
   if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
     {
       nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
-      return -EPROTO;
+      return (hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME ?
+             -EADDRNOTAVAIL : -EPROTO;
     }
 
   /* We only care about the question(s) and the answers. The authrr
@@ -393,7 +428,7 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
       if (ans->type  == HTONS(DNS_RECTYPE_A) &&
           ans->class == HTONS(DNS_CLASS_IN) &&
           ans->len   == HTONS(4) &&
-          nameptr + 10 + 4 < endofbuffer)
+          nameptr + 10 + 4 <= endofbuffer)
         {
           ans->u.ipv4.s_addr = *(FAR uint32_t *)(nameptr + 10);
 
@@ -413,6 +448,8 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
               inaddr->sin_addr.s_addr = ans->u.ipv4.s_addr;
 
               *addrlen = sizeof(struct sockaddr_in);
+              *ttl     = ((uint32_t)ntohs(ans->ttl[0]) << 16) |
+                         ntohs(ans->ttl[1]);
               return OK;
             }
           else
@@ -426,7 +463,7 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
       if (ans->type  == HTONS(DNS_RECTYPE_AAAA) &&
           ans->class == HTONS(DNS_CLASS_IN) &&
           ans->len   == HTONS(16) &&
-          nameptr + 10 + 16 < endofbuffer)
+          nameptr + 10 + 16 <= endofbuffer)
         {
           memcpy(&ans->u.ipv6.s6_addr, nameptr + 10, 16);
 
@@ -441,11 +478,13 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
               FAR struct sockaddr_in6 *inaddr;
 
               inaddr                  = (FAR struct sockaddr_in6 *)addr;
-              inaddr->sin6_family      = AF_INET;
+              inaddr->sin6_family      = AF_INET6;
               inaddr->sin6_port        = 0;
               memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
               *addrlen = sizeof(struct sockaddr_in6);
+              *ttl     = ((uint32_t)ntohs(ans->ttl[0]) << 16) |
+                         ntohs(ans->ttl[1]);
               return OK;
             }
           else
@@ -467,8 +506,9 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
  * Name: dns_query_callback
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   Send the queries for the hostname to this DNS server.  The responses
+ *   are collected afterwards by dns_query(), so all name servers are asked
+ *   in parallel and the first usable answer wins.
  *
  * Input Parameters:
  *   arg      - Query arguements
@@ -476,9 +516,10 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) to stop the traversal when no more queries can be
+ *   outstanding.  Zero is returned in all other cases.  The result field
+ *   of the query structure is set to a negated errno value indicate the
+ *   reason for the last failure (only).
  *
  ****************************************************************************/
 
@@ -486,189 +527,88 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
-  int retries;
-  int ret;
-
-  /* Loop while receive timeout errors occur and there are remaining retries */
-
-  for (retries = 0; retries < 3; retries++)
-    {
+  static const uint16_t rectypes[] =
+  {
 #ifdef CONFIG_NET_IPv4
-      /* Is this an IPv4 address? */
-
-      if (addr->sa_family == AF_INET)
-        {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in))
-            {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
-
-              nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
-
-          /* Send the IPv4 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                               (FAR union dns_server_u *)addr,
-                               DNS_RECTYPE_A);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv4 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
-
-          /* Obtain the IPv4 response */
-
-          ret = dns_recv_response(query->sd, query->addr, query->addrlen);
-          if (ret >= 0)
-            {
-              /* IPv4 response received successfully */
-
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
-
-              dns_save_answer(query->hostname, query->addr, *query->addrlen);
+    DNS_RECTYPE_A,
 #endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
-            }
-
-          /* Handle errors */
+#ifdef CONFIG_NET_IPv6
+    DNS_RECTYPE_AAAA,
+#endif
+  };
 
-          nerr("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
+  uint16_t seqno;
+  int ret;
+  int i;
 
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv4 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+  /* Verify the address size */
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next namserver
-               * address in resolv.conf.
-               */
+#ifdef CONFIG_NET_IPv4
+  if (addr->sa_family == AF_INET)
+    {
+      if (addrlen < sizeof(struct sockaddr_in))
+        {
+          /* Return zero to skip this address and try the next
+           * namserver address in resolv.conf.
+           */
 
-              query->result = ret;
-              return 0;
-            }
+          nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
         }
-      else
-#endif /* CONFIG_NET_IPv4 */
-
+    }
+  else
+#endif
 #ifdef CONFIG_NET_IPv6
-      /* Is this an IPv4 address? */
-
-      if (query->addr->sa_family == AF_INET6)
+  if (addr->sa_family == AF_INET6)
+    {
+      if (addrlen < sizeof(struct sockaddr_in6))
         {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in6))
-            {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
-
-              nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
-
-          /* Send the IPv6 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                              (FAR union dns_server_u *)addr,
-                               DNS_RECTYPE_AAAA);
-          if (ret < 0)
-            {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
-            }
-
-          /* Obtain the IPv6 response */
-
-          ret = dns_recv_response(query->sd, query->addr, query->addrlen);
-          if (ret >= 0)
-            {
-              /* IPv6 response received successfully */
-
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
-
-              dns_save_answer(query->hostname, query->addr, *query->addrlen);
+          nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
+          query->result = -EINVAL;
+          return 0;
+        }
+    }
+  else
 #endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
-            }
+    {
+      /* Unsupported address family. Return zero to continue the
+       * tranversal with the next nameserver address in resolv.conf.
+       */
 
-          /* Handle errors */
+      return 0;
+    }
 
-          nerr("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
+  /* Send an A and/or AAAA query, as enabled */
 
-          if (ret == -EADDRNOTAVAIL)
-            {
-              /* The IPv6 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+  for (i = 0; i < sizeof(rectypes) / sizeof(rectypes[0]); i++)
+    {
+      if (query->npending >= MAX_PENDING)
+        {
+          return 1;
+        }
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next namserver
-               * address in resolv.conf.
-               */
+      dns_semtake();
+      seqno = g_seqno++;
+      dns_semgive();
 
-              query->result = ret;
-              return 0;
-            }
-        }
-      else
-#endif
+      ret = dns_send_query(query->sd, query->hostname,
+                           (FAR union dns_server_u *)addr, rectypes[i],
+                           seqno);
+      if (ret < 0)
         {
-           /* Unsupported address family. Return zero to continue the
-            * tranversal with the next nameserver address in resolv.conf.
-            */
+          /* Skip this address and try the next namserver address in
+           * resolv.conf.
+           */
 
-           return 0;
+          nerr("ERROR: dns_send_query failed: %d\n", ret);
+          query->result = ret;
+          return 0;
         }
-    }
 
-  /* We tried three times and could not communicate with this nameserver.
-   * Perhaps it is down?  Return zero to continue with the next address
-   * in the resolv.conf file.
-   */
+      query->ids[query->npending++] = seqno;
+    }
 
-  query->result = -ETIMEDOUT;
   return 0;
 }
 
@@ -701,6 +641,8 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
               FAR socklen_t *addrlen)
 {
   FAR struct dns_query_s query;
+  uint32_t ttl;
+  int round;
   int ret;
 
   /* Set up the query info structure */
@@ -710,25 +652,84 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
   query.hostname = hostname;
   query.addr     = addr;
   query.addrlen  = addrlen;
+  query.negative = true;
 
-  /* Perform the query. dns_foreach_nameserver() will return:
-   *
-   *  1 - The query was successful.
-   *  0 - Look up failed
-   * <0 - Some other failure (?, shouldn't happen)
-   */
-
-  ret = dns_foreach_nameserver(dns_query_callback, &query);
-  if (ret > 0)
+  for (round = 0; round < MAX_ROUNDS; round++)
     {
-      /* The lookup was successful */
+      /* Send the queries to every name server */
+
+      query.npending = 0;
+      ret = dns_foreach_nameserver(dns_query_callback, &query);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (query.npending == 0)
+        {
+          /* Nothing could be sent */
+
+          return query.result;
+        }
+
+      /* Collect responses until one provides an address, all have failed,
+       * or the receive times out.
+       */
+
+      while (query.npending > 0)
+        {
+          int npending = query.npending;
+
+          ret = dns_recv_response(&query, &ttl);
+          if (ret >= 0)
+            {
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+              /* Save the answer in the DNS cache */
+
+              dns_save_answer(hostname, addr, *addrlen, ttl);
+#endif
+              return OK;
+            }
+          else if (ret == -ESRCH)
+            {
+              /* Not one of ours; keep waiting */
 
-      ret = OK;
+              continue;
+            }
+          else if (query.npending == npending)
+            {
+              /* The receive itself failed or timed out.  Ask again */
+
+              query.result = (ret == -EAGAIN) ? -ETIMEDOUT : ret;
+              break;
+            }
+
+          /* One query was answered without an address.  Wait for the
+           * others.
+           */
+
+          nerr("ERROR: dns_recv_response failed: %d\n", ret);
+          query.result = ret;
+          if (ret != -EADDRNOTAVAIL)
+            {
+              query.negative = false;
+            }
+        }
+
+      if (query.npending == 0)
+        {
+          /* Every query was answered and none produced an address */
+
+          break;
+        }
     }
-  else if (ret == 0)
+
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 && CONFIG_NETDB_DNSCLIENT_NEGLIFESEC > 0
+  if (query.negative && query.npending == 0)
     {
-      ret = query.result;
+      dns_save_failure(hostname);
     }
+#endif
 
-  return ret;
+  return query.result;
 }
@@ -777,16 +777,23 @@ int gethostbyname_r(FAR const char *name, FAR struct hostent *host,
 
       return OK;
     }
-#endif
 
-  /* Try to get the host address using the DNS name server */
+  /* If the cache says that the name recently failed to resolve, don't
+   * ask the name servers again.
+   */
 
-  ret = lib_dns_lookup(name, host, buf, buflen);
-  if (ret >= 0)
+  if (ret != -EADDRNOTAVAIL)
+#endif
     {
-      /* Successful DNS lookup! */
+      /* Try to get the host address using the DNS name server */
 
-      return OK;
+      ret = lib_dns_lookup(name, host, buf, buflen);
+      if (ret >= 0)
+        {
+          /* Successful DNS lookup! */
+
+          return OK;
+        }
     }
 #endif /* CONFIG_NETDB_DNSCLIENT */
 
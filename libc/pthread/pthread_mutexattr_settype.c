@@ -65,7 +65,11 @@
 
 int pthread_mutexattr_settype(pthread_mutexattr_t *attr, int type)
 {
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+  if (attr && type >= PTHREAD_MUTEX_NORMAL && type <= PTHREAD_MUTEX_ADAPTIVE_NP)
+#else
   if (attr && type >= PTHREAD_MUTEX_NORMAL && type <= PTHREAD_MUTEX_RECURSIVE)
+#endif
     {
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
       attr->type = type;
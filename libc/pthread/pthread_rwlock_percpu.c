@@ -0,0 +1,158 @@
+/****************************************************************************
+ * libc/pthread/pthread_rwlock_percpu.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/rwsem.h>
+
+#ifdef CONFIG_PTHREAD_RWLOCK_PERCPU
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_rwlock_init and pthread_rwlock_destroy
+ *
+ * Description:
+ *   Initialize or destroy a read/write lock.  No attributes are supported.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_init(FAR pthread_rwlock_t *rw_lock,
+                        FAR const pthread_rwlockattr_t *attr)
+{
+  if (attr != NULL)
+    {
+      return ENOSYS;
+    }
+
+  return -nxrwsem_init(&rw_lock->rwsem);
+}
+
+int pthread_rwlock_destroy(FAR pthread_rwlock_t *rw_lock)
+{
+  return -nxrwsem_destroy(&rw_lock->rwsem);
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_rdlock, pthread_rwlock_timedrdlock, and
+ *       pthread_rwlock_tryrdlock
+ *
+ * Description:
+ *   Lock a read/write lock for reading.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return -nxrwsem_tryrdlock(&rw_lock->rwsem);
+}
+
+int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
+                               FAR const struct timespec *ts)
+{
+  return -nxrwsem_timedrdlock(&rw_lock->rwsem, ts);
+}
+
+int pthread_rwlock_rdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return -nxrwsem_rdlock(&rw_lock->rwsem);
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_wrlock, pthread_rwlock_timedwrlock, and
+ *       pthread_rwlock_trywrlock
+ *
+ * Description:
+ *   Lock a read/write lock for writing.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return -nxrwsem_trywrlock(&rw_lock->rwsem);
+}
+
+int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
+                               FAR const struct timespec *ts)
+{
+  return -nxrwsem_timedwrlock(&rw_lock->rwsem, ts);
+}
+
+int pthread_rwlock_wrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return -nxrwsem_wrlock(&rw_lock->rwsem);
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_unlock
+ *
+ * Description:
+ *   Release a read or write lock.  The lock is a write lock if the calling
+ *   thread is the writer; otherwise the caller must hold a read lock.
+ *
+ * Returned Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
+{
+  if (nxrwsem_iswriter(&rw_lock->rwsem))
+    {
+      return -nxrwsem_wrunlock(&rw_lock->rwsem);
+    }
+
+  return -nxrwsem_rdunlock(&rw_lock->rwsem);
+}
+
+#endif /* CONFIG_PTHREAD_RWLOCK_PERCPU */
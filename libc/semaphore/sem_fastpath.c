@@ -0,0 +1,212 @@
+/****************************************************************************
+ * libc/semaphore/sem_fastpath.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <syscall.h>
+
+#if defined(CONFIG_SEM_USERFASTPATH) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_fastpath
+ *
+ * Description:
+ *   Return true if the semaphore count may be updated in user space.  The
+ *   kernel must see every count taken on a semaphore with priority
+ *   inheritance so that it can record the holder.
+ *
+ ****************************************************************************/
+
+static inline bool sem_fastpath(FAR sem_t *sem)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  return (sem->flags & PRIOINHERIT_FLAGS_DISABLE) != 0;
+#else
+  return true;
+#endif
+}
+
+/****************************************************************************
+ * Name: sem_fasttake
+ *
+ * Description:
+ *   Take one count from the semaphore if one is available.  The count is
+ *   updated with a compare-and-swap so that the update fails, and is
+ *   retried, if the kernel modified the count in the meantime.
+ *
+ * Returned Value:
+ *   True if a count was taken; false if none was available.
+ *
+ ****************************************************************************/
+
+static bool sem_fasttake(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      false, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: sem_cancelpt
+ *
+ * Description:
+ *   sem_wait() and sem_timedwait() are cancellation points even if they do
+ *   not block.  task_testcancel() enters and leaves a cancellation point in
+ *   the kernel, acting on any pending deferred cancellation, just as the
+ *   kernel sem_wait() does.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CANCELLATION_POINTS
+#  define sem_cancelpt() task_testcancel()
+#else
+#  define sem_cancelpt()
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_wait, sem_timedwait, and sem_trywait
+ *
+ * Description:
+ *   The user-space semaphore wait functions.  If a count is available it
+ *   is taken without a system call.  Otherwise, the system call is made and
+ *   the kernel blocks the caller (or fails) as usual.
+ *
+ *   sem_wait() and sem_timedwait() are cancellation points on the fast
+ *   path too.  With CONFIG_CANCELLATION_POINTS, that costs one system call
+ *   to test for a pending cancellation.
+ *
+ ****************************************************************************/
+
+int sem_wait(FAR sem_t *sem)
+{
+  sem_cancelpt();
+
+  if (sem != NULL && sem_fastpath(sem) && sem_fasttake(sem))
+    {
+      return OK;
+    }
+
+  return (int)sys_call1((unsigned int)SYS_sem_wait, (uintptr_t)sem);
+}
+
+int sem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime)
+{
+  sem_cancelpt();
+
+  if (sem != NULL && sem_fastpath(sem) && sem_fasttake(sem))
+    {
+      return OK;
+    }
+
+  return (int)sys_call2((unsigned int)SYS_sem_timedwait, (uintptr_t)sem,
+                        (uintptr_t)abstime);
+}
+
+int sem_trywait(FAR sem_t *sem)
+{
+  if (sem != NULL && sem_fastpath(sem) && sem_fasttake(sem))
+    {
+      return OK;
+    }
+
+  return (int)sys_call1((unsigned int)SYS_sem_trywait, (uintptr_t)sem);
+}
+
+/****************************************************************************
+ * Name: sem_post
+ *
+ * Description:
+ *   The user-space sem_post().  If no thread is waiting for the semaphore,
+ *   the count is incremented without a system call.  Otherwise, the system
+ *   call is made so that the kernel can wake up the waiting thread.
+ *
+ ****************************************************************************/
+
+int sem_post(FAR sem_t *sem)
+{
+  int16_t count;
+
+  if (sem != NULL && sem_fastpath(sem))
+    {
+      count = sem->semcount;
+
+      /* A negative count means that there are waiters that the kernel must
+       * wake up.  The kernel also reports the overflow error.
+       */
+
+      while (count >= 0 && count < SEM_VALUE_MAX)
+        {
+          if (__atomic_compare_exchange_n(&sem->semcount, &count,
+                                          count + 1, false,
+                                          __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED))
+            {
+              return OK;
+            }
+        }
+    }
+
+  return (int)sys_call1((unsigned int)SYS_sem_post, (uintptr_t)sem);
+}
+
+#endif /* CONFIG_SEM_USERFASTPATH && !__KERNEL__ */
@@ -99,6 +99,9 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
       sem->holder[1].htcb   = NULL;
       sem->holder[1].counts = 0;
 #  endif
+#  ifdef CONFIG_SEM_HOLDERLISTS
+      sem->whead            = NULL;
+#  endif
 #endif
       return OK;
     }
@@ -121,12 +121,20 @@ ssize_t lib_fread(FAR void *ptr, size_t count, FAR FILE *stream)
             {
               /* Is there readable data in the buffer? */
 
-              while ((count > 0) && (stream->fs_bufpos < stream->fs_bufread))
+              if (stream->fs_bufpos < stream->fs_bufread)
                 {
-                  /* Yes, copy a byte into the user buffer */
+                  /* Yes, copy as much as is needed into the user buffer */
 
-                  *dest++ = *stream->fs_bufpos++;
-                  count--;
+                  size_t ncopy = stream->fs_bufread - stream->fs_bufpos;
+                  if (ncopy > count)
+                    {
+                      ncopy = count;
+                    }
+
+                  memcpy(dest, stream->fs_bufpos, ncopy);
+                  stream->fs_bufpos += ncopy;
+                  dest              += ncopy;
+                  count             -= ncopy;
                 }
 
               /* The buffer is empty OR we have already supplied the number of
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -64,7 +65,6 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
   FAR const unsigned char *start = ptr;
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
-  unsigned char *dest;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -116,9 +116,35 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   while (count > 0)
     {
+      size_t gulp_size;
+
+      /* If the buffer is empty and the remaining user data would fill it,
+       * then write the user data directly.  Copying it through the buffer
+       * would only add a memcpy() and split it into buffer-sized writes.
+       */
+
+      if (stream->fs_bufpos == stream->fs_bufstart &&
+          count >= (size_t)(stream->fs_bufend - stream->fs_bufstart))
+        {
+          ssize_t nwritten = _NX_WRITE(stream->fs_fd, src, count);
+          if (nwritten < 0)
+            {
+              _NX_SETERRNO(nwritten);
+              goto errout_with_semaphore;
+            }
+          else if (nwritten == 0)
+            {
+              break;
+            }
+
+          src   += nwritten;
+          count -= nwritten;
+          continue;
+        }
+
       /* Determine the number of bytes left in the buffer */
 
-      size_t gulp_size = stream->fs_bufend - stream->fs_bufpos;
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
 
       /* Will the user data fit into the amount of buffer space
        * that we have left?
@@ -139,16 +165,13 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       /* Transfer the data into the buffer */
 
-      for (dest = stream->fs_bufpos; gulp_size > 0; gulp_size--)
-        {
-          *dest++ = *src++;
-        }
-
-      stream->fs_bufpos = dest;
+      memcpy(stream->fs_bufpos, src, gulp_size);
+      stream->fs_bufpos += gulp_size;
+      src               += gulp_size;
 
       /* Is the buffer full? */
 
-      if (dest >= stream->fs_bufend)
+      if (stream->fs_bufpos >= stream->fs_bufend)
         {
           /* Flush the buffered data to the IO stream */
 
@@ -143,6 +143,11 @@ enum
  * Private Function Prototypes
  ****************************************************************************/
 
+/* Block output */
+
+static void vsprintf_puts(FAR struct lib_outstream_s *obj,
+                          FAR const char *buf, int len);
+
 /* Pointer to ASCII conversion */
 
 #ifdef CONFIG_PTR_IS_NOT_INT
@@ -214,6 +219,19 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt,
 
 static const char g_nullstring[] = "(null)";
 
+/* Pairs of decimal digits "00" through "99".  Decimal conversions emit two
+ * digits per division.
+ */
+
+static const char g_decdigits[200] =
+{
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899"
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -224,6 +242,31 @@ static const char g_nullstring[] = "(null)";
 #  include "stdio/lib_libdtoa.c"
 #endif
 
+/****************************************************************************
+ * Name: vsprintf_puts
+ *
+ * Description:
+ *   Output a block of characters, using the stream's bulk write method if
+ *   it has one.
+ *
+ ****************************************************************************/
+
+static void vsprintf_puts(FAR struct lib_outstream_s *obj,
+                          FAR const char *buf, int len)
+{
+  if (obj->puts != NULL)
+    {
+      obj->puts(obj, buf, len);
+    }
+  else
+    {
+      while (len-- > 0)
+        {
+          obj->put(obj, *buf++);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: ptohex
  ****************************************************************************/
@@ -289,15 +332,36 @@ static int getpsize(uint8_t flags, FAR void *p)
 
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 {
-  unsigned int remainder = n % 10;
-  unsigned int dividend  = n / 10;
+  char buf[3 * sizeof(unsigned int)];
+  FAR char *ptr = &buf[sizeof(buf)];
+  unsigned int pair;
 
-  if (dividend)
+  /* Convert two digits at a time, from the least significant end of the
+   * buffer.
+   */
+
+  while (n >= 100)
     {
-      utodec(obj, dividend);
+      pair   = (unsigned int)(n % 100) << 1;
+      n     /= 100;
+      ptr   -= 2;
+      ptr[0] = g_decdigits[pair];
+      ptr[1] = g_decdigits[pair + 1];
     }
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  if (n >= 10)
+    {
+      pair   = (unsigned int)n << 1;
+      ptr   -= 2;
+      ptr[0] = g_decdigits[pair];
+      ptr[1] = g_decdigits[pair + 1];
+    }
+  else
+    {
+      *--ptr = (char)n + '0';
+    }
+
+  vsprintf_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -559,15 +623,36 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-  unsigned int  remainder = n % 10;
-  unsigned long dividend  = n / 10;
+  char buf[3 * sizeof(unsigned long)];
+  FAR char *ptr = &buf[sizeof(buf)];
+  unsigned int pair;
 
-  if (dividend)
+  /* Convert two digits at a time, from the least significant end of the
+   * buffer.
+   */
+
+  while (n >= 100)
     {
-      lutodec(obj, dividend);
+      pair   = (unsigned int)(n % 100) << 1;
+      n     /= 100;
+      ptr   -= 2;
+      ptr[0] = g_decdigits[pair];
+      ptr[1] = g_decdigits[pair + 1];
     }
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  if (n >= 10)
+    {
+      pair   = (unsigned int)n << 1;
+      ptr   -= 2;
+      ptr[0] = g_decdigits[pair];
+      ptr[1] = g_decdigits[pair + 1];
+    }
+  else
+    {
+      *--ptr = (char)n + '0';
+    }
+
+  vsprintf_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -811,15 +896,36 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-  unsigned int remainder = n % 10;
-  unsigned long long dividend = n / 10;
+  char buf[3 * sizeof(unsigned long long)];
+  FAR char *ptr = &buf[sizeof(buf)];
+  unsigned int pair;
 
-  if (dividend)
+  /* Convert two digits at a time, from the least significant end of the
+   * buffer.
+   */
+
+  while (n >= 100)
     {
-      llutodec(obj, dividend);
+      pair   = (unsigned int)(n % 100) << 1;
+      n     /= 100;
+      ptr   -= 2;
+      ptr[0] = g_decdigits[pair];
+      ptr[1] = g_decdigits[pair + 1];
     }
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  if (n >= 10)
+    {
+      pair   = (unsigned int)n << 1;
+      ptr   -= 2;
+      ptr[0] = g_decdigits[pair];
+      ptr[1] = g_decdigits[pair + 1];
+    }
+  else
+    {
+      *--ptr = (char)n + '0';
+    }
+
+  vsprintf_puts(obj, ptr, &buf[sizeof(buf)] - ptr);
 }
 
 /****************************************************************************
@@ -1185,9 +1291,24 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR != '%')
         {
+#ifndef CONFIG_ARCH_ROMGETC
+           FAR const char *run = src;
+
+           /* Output the run of regular characters up to the next format
+            * specifier or through the next newline as one block.
+            */
+
+           while (src[1] != '\0' && src[1] != '%' && *src != '\n')
+             {
+               src++;
+             }
+
+           vsprintf_puts(obj, run, src - run + 1);
+#else
            /* Output the character */
 
            obj->put(obj, FMT_CHAR);
+#endif
 
            /* Flush the buffer if a newline is encountered */
 
@@ -1351,10 +1472,8 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR == 's')
         {
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           int swidth;
-          int left;
-#endif
+
           /* Get the string to output */
 
           ptmp = va_arg(ap, FAR char *);
@@ -1371,21 +1490,12 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           swidth = (IS_HASDOT(flags) && trunc >= 0)
                       ? strnlen(ptmp, trunc) : strlen(ptmp);
           prejustify(obj, fmt, 0, width, swidth);
-          left = swidth;
+#else
+          swidth = strlen(ptmp);
 #endif
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
-              if (left-- <= 0)
-                {
-                  break;
-                }
-#endif
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
+          vsprintf_puts(obj, ptmp, swidth);
 
           /* Perform left-justification operations. */
 
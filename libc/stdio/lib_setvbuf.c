@@ -203,6 +203,18 @@ int setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size)
 
                 flags |= __FS_FLAG_UBF;
               }
+
+            /* Re-use the buffer allocated when the stream was opened if it
+             * is large enough.  This avoids freeing and re-allocating heap
+             * memory just to select a smaller buffer size.
+             */
+
+            else if (stream->fs_bufstart != NULL &&
+                     (stream->fs_flags & __FS_FLAG_UBF) == 0 &&
+                     size <= (size_t)(stream->fs_bufend - stream->fs_bufstart))
+              {
+                newbuf = stream->fs_bufstart;
+              }
             else
               {
                 newbuf = (FAR unsigned char *)lib_malloc(size);
@@ -241,7 +253,7 @@ int setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size)
     * on a previous call to setvbuf().
     */
 
-   if (stream->fs_bufstart != NULL &&
+   if (stream->fs_bufstart != NULL && stream->fs_bufstart != newbuf &&
        (stream->fs_flags & __FS_FLAG_UBF) == 0)
     {
       lib_free(stream->fs_bufstart);
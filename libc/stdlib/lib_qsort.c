@@ -93,6 +93,15 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
                              CODE int (*compar)(FAR const void *,
                              FAR const void *));
+static void siftdown(FAR char *base, size_t root, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *, FAR const void *),
+                     int swaptype);
+static void heapsort(FAR char *base, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *, FAR const void *),
+                     int swaptype);
+static void introsort(FAR void *base, size_t nel, size_t width,
+                      CODE int(*compar)(FAR const void *, FAR const void *),
+                      int depth);
 
 /****************************************************************************
  * Private Functions
@@ -120,50 +129,92 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: siftdown
+ *
+ * Description:
+ *   Restore the max-heap property of the 'nel' element heap at 'base' below
+ *   element 'root'.
+ *
  ****************************************************************************/
 
+static void siftdown(FAR char *base, size_t root, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *, FAR const void *),
+                     int swaptype)
+{
+  FAR char *pr;
+  FAR char *pc;
+  size_t child;
+
+  while ((child = 2 * root + 1) < nel)
+    {
+      /* Select the larger of the two children */
+
+      pc = base + child * width;
+      if (child + 1 < nel && compar(pc, pc + width) < 0)
+        {
+          child++;
+          pc += width;
+        }
+
+      /* Done if the root is not smaller than its larger child */
+
+      pr = base + root * width;
+      if (compar(pr, pc) >= 0)
+        {
+          return;
+        }
+
+      swap(pr, pc);
+      root = child;
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: heapsort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ *   Sort 'nel' elements in place in O(n log n) worst case time.  Used when
+ *   the quicksort partitioning degenerates.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heapsort(FAR char *base, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *, FAR const void *),
+                     int swaptype)
+{
+  size_t i;
+
+  /* Build the heap */
+
+  for (i = nel / 2; i > 0; i--)
+    {
+      siftdown(base, i - 1, nel, width, compar, swaptype);
+    }
+
+  /* Then repeatedly move the largest element to the end */
+
+  for (i = nel - 1; i > 0; i--)
+    {
+      swap(base, base + i * width);
+      siftdown(base, 0, i, width, compar, swaptype);
+    }
+}
+
+/****************************************************************************
+ * Name: introsort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Bentley & McIlroy quicksort with a limit on the partitioning depth.
+ *   When 'depth' is exhausted the remaining partition is heap sorted so
+ *   that adversarial inputs cannot push the sort to O(n^2).  Only the
+ *   smaller partition is sorted recursively which bounds the stack usage
+ *   to O(log n).
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void introsort(FAR void *base, size_t nel, size_t width,
+                      CODE int(*compar)(FAR const void *, FAR const void *),
+                      int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -172,6 +223,8 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t nleft;
+  size_t nright;
   int swaptype;
   int swap_cnt;
   int d;
@@ -198,6 +251,14 @@ loop:
       return;
   }
 
+  /* Fall back to heapsort if partitioning has gone too deep */
+
+  if (depth-- <= 0)
+    {
+      heapsort(base, nel, width, compar, swaptype);
+      return;
+    }
+
   pm = (FAR char *)base + (nel / 2) * width;
   if (nel > 7)
     {
@@ -257,7 +318,13 @@ loop:
 
   if (swap_cnt == 0)
     {
-      /* Switch to insertion sort */
+      /* Switch to insertion sort.  The partition moved nothing so the data
+       * is probably nearly sorted, but that is not guaranteed:  Give up and
+       * partition again (the depth limit still applies) if the insertion
+       * sort moves more than 'nel' elements.
+       */
+
+      size_t moves = 0;
 
       for (pm = (FAR char *)base + width;
            pm < (FAR char *)base + nel * width;
@@ -268,6 +335,10 @@ loop:
                pl -= width)
             {
               swap(pl, pl - width);
+              if (++moves > nel)
+                {
+                  goto loop;
+                }
             }
         }
 
@@ -281,17 +352,95 @@ loop:
   r  = min(pd - pc, pn - pd - width);
   vecswap(pb, pn - r, r);
 
-  if ((r = pb - pa) > width)
+  /* Recurse into the smaller partition and iterate on the larger one */
+
+  nleft  = (pb - pa) / width;
+  nright = (pd - pc) / width;
+
+  if (nleft < nright)
     {
-      qsort(base, r / width, width, compar);
-    }
+      if (nleft > 1)
+        {
+          introsort(base, nleft, width, compar, depth);
+        }
 
-  if ((r = pd - pc) > width)
+      base = pn - (pd - pc);
+      nel  = nright;
+    }
+  else
     {
-      /* Iterate rather than recurse to save stack space */
+      if (nright > 1)
+        {
+          introsort(pn - (pd - pc), nright, width, compar, depth);
+        }
+
+      nel  = nleft;
+    }
 
-      base = pn - r;
-      nel = r / width;
+  if (nel > 1)
+    {
       goto loop;
     }
 }
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ *   The partitioning depth is limited to 2 * log2(nel) with a fall back to
+ *   heapsort (introsort) so the worst case is O(n log n).
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth = 0;
+
+  /* Limit the partitioning depth to 2 * log2(nel) */
+
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
+    }
+
+  introsort(base, nel, width, compar, depth);
+}
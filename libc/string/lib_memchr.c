@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +68,29 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      FAR const uintptr_t *wp;
+      uintptr_t cmask = LIB_WORDONES * (unsigned char)c;
+
+      for (; n > 0 && LIB_UNALIGNED(p); p++, n--)
+        {
+          if (*p == (unsigned char)c)
+            {
+              return (FAR void *)p;
+            }
+        }
+
+      /* Skip whole words that do not contain the character.  The byte loop
+       * below then locates it within the word.
+       */
+
+      for (wp = (FAR const uintptr_t *)p;
+           n >= LIB_WORDSIZE && !LIB_HASZERO(*wp ^ cmask);
+           wp++, n -= LIB_WORDSIZE);
+
+      p = (FAR const unsigned char *)wp;
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,9 +67,37 @@ FAR char *strchr(FAR const char *s, int c)
 {
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      FAR const uintptr_t *ws;
+      uintptr_t cmask = LIB_WORDONES * (unsigned char)c;
+
+      for (; LIB_UNALIGNED(s); s++)
+        {
+          if (*s == (char)c)
+            {
+              return (FAR char *)s;
+            }
+
+          if (!*s)
+            {
+              return NULL;
+            }
+        }
+
+      /* Skip whole words that contain neither the character nor the
+       * terminator.  The byte loop below then finds which one it was.
+       */
+
+      for (ws = (FAR const uintptr_t *)s;
+           !LIB_HASZERO(*ws) && !LIB_HASZERO(*ws ^ cmask);
+           ws++);
+
+      s = (FAR const char *)ws;
+#endif
+
       for (; ; s++)
         {
-          if (*s == c)
+          if (*s == (char)c)
             {
               return (FAR char *)s;
             }
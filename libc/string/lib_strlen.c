@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,7 +52,32 @@
 size_t strlen(const char *s)
 {
   const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  FAR const uintptr_t *ws;
+
+  /* Test bytes until the pointer is word aligned */
+
+  for (sc = s; LIB_UNALIGNED(sc); ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  /* Then test whole words until one contains a zero byte.  An aligned word
+   * never crosses a page or region boundary so reading past the terminator
+   * within the final word is safe.
+   */
+
+  for (ws = (FAR const uintptr_t *)sc; !LIB_HASZERO(*ws); ws++);
+  sc = (FAR const char *)ws;
+#else
+  sc = s;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
@@ -123,6 +123,20 @@
 #define EPOCH_YEAR          1970
 #define EPOCH_WDAY          TM_THURSDAY
 
+/* Times within this many seconds of the epoch (about +/- 3000 years) are
+ * converted to a calendar date with closed-form arithmetic in timesub().
+ * Anything further out takes the general, overflow-checked path.
+ */
+
+#define FASTDATE_LIMIT      ((int_fast64_t)100000000000LL)
+
+/* Days from 0000-03-01 to 1970-01-01 in the proleptic Gregorian calendar,
+ * and the length of the 400 year Gregorian cycle.
+ */
+
+#define DAYS_0000_TO_EPOCH  719468
+#define DAYSPER400YEARS     146097
+
 #define isleap(y)           (((y) % 4) == 0 && (((y) % 100) != 0 || ((y) % 400) == 0))
 
 /* Since everything in isleap is modulo 400 (or a factor of 400), we know that
@@ -283,6 +297,7 @@ struct state_s
   char chars[BIGGEST(BIGGEST(TZ_MAX_CHARS + 1, GMTLEN), (2 * (MY_TZNAME_MAX + 1)))];
   struct lsinfo_s lsis[TZ_MAX_LEAPS];
   int defaulttype;            /* For early times or if no transitions */
+  int lastidx;                /* Transition found by the last lookup */
 };
 
 struct rule_s
@@ -1637,6 +1652,7 @@ static void tzsetwall(void)
       gmtload(lclptr);
     }
 
+  lclptr->lastidx = 0;
   settzname();
 }
 
@@ -1727,21 +1743,36 @@ static struct tm *localsub(FAR const time_t * const timep,
     }
   else
     {
-      int lo = 1;
-      int hi = sp->timecnt;
+      int lo = sp->lastidx;
+      int hi;
+
+      /* Successive calls are nearly always for times in the same period
+       * (e.g. "now"), so check the previous result before searching.  The
+       * hint is validated against the table, so a stale or concurrently
+       * updated value only costs the search.
+       */
 
-      while (lo < hi)
+      if (lo < 1 || lo > sp->timecnt || t < sp->ats[lo - 1] ||
+          (lo < sp->timecnt && t >= sp->ats[lo]))
         {
-          int mid = (lo + hi) >> 1;
+          lo = 1;
+          hi = sp->timecnt;
 
-          if (t < sp->ats[mid])
-            {
-              hi = mid;
-            }
-          else
+          while (lo < hi)
             {
-              lo = mid + 1;
+              int mid = (lo + hi) >> 1;
+
+              if (t < sp->ats[mid])
+                {
+                  hi = mid;
+                }
+              else
+                {
+                  lo = mid + 1;
+                }
             }
+
+          sp->lastidx = lo;
         }
 
       i = (int)sp->types[lo - 1];
@@ -1835,6 +1866,68 @@ static struct tm *timesub(FAR const time_t * const timep,
         }
     }
 
+  /* Fast path: convert days since the epoch straight to a civil date
+   * (Howard Hinnant's days_from_civil inverse) instead of stepping through
+   * years and months.
+   */
+
+  if (*timep > -FASTDATE_LIMIT && *timep < FASTDATE_LIMIT)
+    {
+      int_fast64_t secs = (int_fast64_t)*timep + offset - corr;
+      int_fast32_t days;
+      int_fast32_t era;
+      int_fast32_t doe;
+      int_fast32_t yoe;
+      int_fast32_t doy;
+      int_fast32_t mp;
+
+      days = (int_fast32_t)(secs / SECSPERDAY);
+      rem  = secs - (int_fast64_t)days * SECSPERDAY;
+      if (rem < 0)
+        {
+          rem += SECSPERDAY;
+          days--;
+        }
+
+      tmp->tm_wday = (int)((days + EPOCH_WDAY) % DAYSPERWEEK);
+      if (tmp->tm_wday < 0)
+        {
+          tmp->tm_wday += DAYSPERWEEK;
+        }
+
+      days += DAYS_0000_TO_EPOCH;
+      era   = (days >= 0 ? days : days - (DAYSPER400YEARS - 1)) /
+              DAYSPER400YEARS;
+      doe   = days - era * DAYSPER400YEARS;
+      yoe   = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+      doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);
+      mp    = (5 * doy + 2) / 153;
+      y     = (int)(yoe + era * 400);
+
+      /* doy and mp count from March 1 */
+
+      if (mp < 10)
+        {
+          tmp->tm_mon = (int)mp + TM_MARCH;
+        }
+      else
+        {
+          tmp->tm_mon = (int)mp - 10;
+          y++;
+        }
+
+      tmp->tm_mday = (int)(doy - (153 * mp + 2) / 5 + 1);
+      tmp->tm_yday = (int)(mp < 10 ? doy + 59 + isleap(y) : doy - 306);
+      tmp->tm_year = y - TM_YEAR_BASE;
+      tmp->tm_hour = (int)(rem / SECSPERHOUR);
+      rem %= SECSPERHOUR;
+      tmp->tm_min  = (int)(rem / SECSPERMIN);
+      tmp->tm_sec  = (int)(rem % SECSPERMIN) + hit;
+      tmp->tm_isdst = 0;
+
+      return tmp;
+    }
+
   y = EPOCH_YEAR;
   tdays = *timep / SECSPERDAY;
   rem = *timep - tdays * SECSPERDAY;
@@ -2509,6 +2602,7 @@ void tzset(void)
         }
     }
 
+  lclptr->lastidx = 0;
   settzname();
 }
 
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * libc/time/lib_timepage.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <syscall.h>
+
+#include <nuttx/clock.h>
+
+#if defined(CONFIG_CLOCK_TIMEPAGE) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The time page.  Its address is provided to the kernel in the struct
+ * userspace_s header of the user-space blob.
+ */
+
+struct clock_timepage_s g_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   The user-space clock_gettime():  CLOCK_REALTIME and CLOCK_MONOTONIC are
+ *   read from the time page without a system call.  All other clocks are
+ *   obtained from the kernel through the clock_gettime() system call.
+ *
+ * Input Parameters:
+ *   clock_id - The clock to read
+ *   tp       - The location to return the time
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) with the errno variable set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  uint32_t seq;
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      do
+        {
+          seq = g_timepage.tp_seq;
+          CLOCK_TIMEPAGE_BARRIER();
+          tp->tv_sec  = g_timepage.tp_realsec;
+          tp->tv_nsec = g_timepage.tp_realnsec;
+          CLOCK_TIMEPAGE_BARRIER();
+        }
+      while ((seq & 1) != 0 || seq != g_timepage.tp_seq);
+
+      return OK;
+    }
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clock_id == CLOCK_MONOTONIC)
+    {
+      do
+        {
+          seq = g_timepage.tp_seq;
+          CLOCK_TIMEPAGE_BARRIER();
+          tp->tv_sec  = g_timepage.tp_monosec;
+          tp->tv_nsec = g_timepage.tp_mononsec;
+          CLOCK_TIMEPAGE_BARRIER();
+        }
+      while ((seq & 1) != 0 || seq != g_timepage.tp_seq);
+
+      return OK;
+    }
+#endif
+
+  return (int)sys_call2((unsigned int)SYS_clock_gettime,
+                        (uintptr_t)clock_id, (uintptr_t)tp);
+}
+
+/****************************************************************************
+ * Name: clock_systimer
+ *
+ * Description:
+ *   The user-space clock_systimer():  Read the system timer from the time
+ *   page without a system call.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The current value of the system timer counter
+ *
+ ****************************************************************************/
+
+systime_t clock_systimer(void)
+{
+  systime_t ticks;
+  uint32_t seq;
+
+  do
+    {
+      seq = g_timepage.tp_seq;
+      CLOCK_TIMEPAGE_BARRIER();
+      ticks = g_timepage.tp_systimer;
+      CLOCK_TIMEPAGE_BARRIER();
+    }
+  while ((seq & 1) != 0 || seq != g_timepage.tp_seq);
+
+  return ticks;
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE && !__KERNEL__ */
@@ -0,0 +1,109 @@
+/****************************************************************************
+ * libc/tls/tls_native.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/tls.h>
+
+#ifdef CONFIG_TLS_NATIVE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* These symbols are provided by the board linker script and delimit the
+ * .tdata and .tbss templates.
+ */
+
+extern const uint8_t _stdata[];
+extern const uint8_t _etdata[];
+extern const uint8_t _stbss[];
+extern const uint8_t _etbss[];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tls_native_size
+ *
+ * Description:
+ *   Return the size of the per-thread copy of the .tdata/.tbss templates,
+ *   rounded up to a multiple of 8 bytes.
+ *
+ ****************************************************************************/
+
+size_t tls_native_size(void)
+{
+  return ((uintptr_t)_etbss - (uintptr_t)_stdata + 7) & ~7;
+}
+
+/****************************************************************************
+ * Name: tls_native_init
+ *
+ * Description:
+ *   Initialize the per-thread copy of the .tdata/.tbss templates that
+ *   follows the TLS information structure 'info' at the base of a new
+ *   stack.  This is called by up_create_stack() and up_use_stack().
+ *
+ * Input Parameters:
+ *   info - The TLS information structure at the base of the new stack
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tls_native_init(FAR struct tls_info_s *info)
+{
+  FAR uint8_t *block = (FAR uint8_t *)(info + 1);
+  size_t tdatasize = (uintptr_t)_etdata - (uintptr_t)_stdata;
+
+  /* Copy the initialized data, then clear everything after it:  This
+   * includes any alignment gap between .tdata and .tbss.
+   */
+
+  memcpy(block, _stdata, tdatasize);
+  memset(block + tdatasize, 0, tls_native_size() - tdatasize);
+}
+
+#endif /* CONFIG_TLS_NATIVE */
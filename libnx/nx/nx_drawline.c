@@ -50,6 +50,8 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#define NCIRCLE_TRAPS 8
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -76,7 +78,7 @@
  * Description:
  *  Fill the specified line in the window with the specified color.  This
  *  is simply a wrapper that uses nxgl_splitline() to break the line into
- *  trapezoids and then calls nx_filltrapezoid() to render the line.
+ *  trapezoids and then calls nx_filltraplist() to render the line.
  *
  * Input Parameters:
  *   hwnd   - The window handle
@@ -95,8 +97,9 @@ int nx_drawline(NXWINDOW hwnd, FAR struct nxgl_vector_s *vector,
                 nxgl_coord_t width, nxgl_mxpixel_t color[CONFIG_NX_NPLANES],
                 uint8_t caps)
 {
-  struct nxgl_trapezoid_s trap[3];
+  struct nxgl_trapezoid_s traps[3 + 2 * NCIRCLE_TRAPS];
   struct nxgl_rect_s rect;
+  int ntraps;
   int ret;
 
 #ifdef CONFIG_DEBUG_FEATURES
@@ -109,7 +112,7 @@ int nx_drawline(NXWINDOW hwnd, FAR struct nxgl_vector_s *vector,
 
   /* Split the line into trapezoids */
 
-  ret = nxgl_splitline(vector, trap, &rect, width);
+  ret = nxgl_splitline(vector, traps, &rect, width);
   switch (ret)
     {
       /* 0: Line successfully broken up into three trapezoids.  Values in
@@ -117,15 +120,7 @@ int nx_drawline(NXWINDOW hwnd, FAR struct nxgl_vector_s *vector,
        */
 
       case 0:
-        ret = nx_filltrapezoid(hwnd, NULL, &trap[0], color);
-        if (ret == OK)
-          {
-            ret = nx_filltrapezoid(hwnd, NULL, &trap[1], color);
-            if (ret == OK)
-              {
-                ret = nx_filltrapezoid(hwnd, NULL, &trap[2], color);
-              }
-          }
+        ntraps = 3;
         break;
 
       /* 1: Line successfully represented by one trapezoid. Value in traps[1]
@@ -133,7 +128,8 @@ int nx_drawline(NXWINDOW hwnd, FAR struct nxgl_vector_s *vector,
        */
 
       case 1:
-        ret = nx_filltrapezoid(hwnd, NULL, &trap[1], color);
+        nxgl_trapcopy(&traps[0], &traps[1]);
+        ntraps = 1;
         break;
 
       /* 2: Line successfully represented by one rectangle. Value in rect is
@@ -142,6 +138,12 @@ int nx_drawline(NXWINDOW hwnd, FAR struct nxgl_vector_s *vector,
 
       case 2:
         ret = nx_fill(hwnd, &rect, color);
+        if (ret != OK)
+          {
+            return ret;
+          }
+
+        ntraps = 0;
         break;
 
       /* <0: On errors, a negated errno value is returned. */
@@ -151,27 +153,30 @@ int nx_drawline(NXWINDOW hwnd, FAR struct nxgl_vector_s *vector,
         return ERROR;
     }
 
-  /* Draw circular caps at each end of the line to support better line joins */
+  /* Add circular caps at each end of the line to support better line joins */
 
   if (caps != NX_LINECAP_NONE && width >= 3)
     {
       nxgl_coord_t radius = width >> 1;
 
-      /* Draw a circle at pt1 */
+      /* Add a circle at pt1 */
 
-      ret = OK;
       if ((caps & NX_LINECAP_PT1) != 0)
         {
-          ret = nx_fillcircle(hwnd, &vector->pt1, radius, color);
+          nxgl_circletraps(&vector->pt1, radius, &traps[ntraps]);
+          ntraps += NCIRCLE_TRAPS;
         }
 
-      /* Draw a circle at pt2 */
+      /* Add a circle at pt2 */
 
-      if (ret == OK && (caps & NX_LINECAP_PT2) != 0)
+      if ((caps & NX_LINECAP_PT2) != 0)
         {
-          ret = nx_fillcircle(hwnd, &vector->pt2, radius, color);
+          nxgl_circletraps(&vector->pt2, radius, &traps[ntraps]);
+          ntraps += NCIRCLE_TRAPS;
         }
     }
 
-  return ret;
+  /* Then render the line and its caps together */
+
+  return nx_filltraplist(hwnd, NULL, traps, ntraps, color);
 }
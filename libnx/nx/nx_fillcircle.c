@@ -92,24 +92,13 @@
 int nx_fillcircle(NXWINDOW hwnd, FAR const struct nxgl_point_s *center,
                   nxgl_coord_t radius, nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
 {
-  FAR struct nxgl_trapezoid_s traps[NCIRCLE_TRAPS];
-  int i;
-  int ret;
+  struct nxgl_trapezoid_s traps[NCIRCLE_TRAPS];
 
   /* Describe the circular region as a sequence of 8 trapezoids */
 
   nxgl_circletraps(center, radius, traps);
 
-  /* Then rend those trapezoids */
+  /* Then rend those trapezoids together */
 
-  for (i = 0; i < NCIRCLE_TRAPS; i++)
-    {
-      ret = nx_filltrapezoid(hwnd, NULL, &traps[i], color);
-      if (ret != OK)
-        {
-          return ret;
-        }
-    }
-
-  return OK;
+  return nx_filltraplist(hwnd, NULL, traps, NCIRCLE_TRAPS, color);
 }
@@ -50,6 +50,31 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_NXFONTS_CACHE_MAXBYTES
+#  define CONFIG_NXFONTS_CACHE_MAXBYTES 0
+#endif
+
+/* Glyphs are hashed on the character code.  Must be a power of two. */
+
+#define NXF_HASHSIZE    32
+#define NXF_HASH(ch)    ((ch) & (NXF_HASHSIZE - 1))
+
+/* Range of characters pre-rendered when a font cache is created */
+
+#define NXF_PRELOAD_FIRST 0x20
+#define NXF_PRELOAD_LAST  0x7e
+
+/* The allocated size of a glyph */
+
+#define NXF_GLYPHSIZE(g) \
+  SIZEOF_NXFONTS_GLYPH_S((size_t)(g)->stride * (g)->height)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -76,11 +101,15 @@ struct nxfonts_fcache_s
   nxgl_mxpixel_t fgcolor;              /* Foreground color */
   nxgl_mxpixel_t bgcolor;              /* Background color */
   nxf_renderer_t renderer;             /* Font renderer */
+  size_t nbytes;                       /* Memory used by cached glyphs */
 
-  /* Glyph cache data storage */
+  /* Glyph cache data storage.  The list is kept in LRU order:  The most
+   * recently used glyph is at the head.
+   */
 
   FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
   FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+  FAR struct nxfonts_glyph_s *hash[NXF_HASHSIZE]; /* Glyphs by code */
 };
 
 /****************************************************************************
@@ -185,53 +214,62 @@ static void nxf_cache_lock(FAR struct nxfonts_fcache_s *priv)
  *
  ****************************************************************************/
 
-static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+static void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
+                            FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s *curr;
+  FAR struct nxfonts_glyph_s *prev;
+  int ndx;
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
+  /* Remove the glyph from the LRU list */
 
-  if (prev == NULL)
+  if (glyph->blink == NULL)
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
-
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
+    }
+  else
+    {
+      glyph->blink->flink = glyph->flink;
     }
 
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
-
-  else if (glyph->flink == NULL)
+  if (glyph->flink == NULL)
+    {
+      priv->tail = glyph->blink;
+    }
+  else
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      glyph->flink->blink = glyph->blink;
     }
 
-  /* No.. Remove from mid-list */
+  glyph->flink = NULL;
+  glyph->blink = NULL;
+
+  /* Remove the glyph from its hash chain */
+
+  ndx = NXF_HASH(glyph->code);
+  for (prev = NULL, curr = priv->hash[ndx];
+       curr != NULL && curr != glyph;
+       prev = curr, curr = curr->hlink);
 
+  DEBUGASSERT(curr == glyph);
+  if (prev == NULL)
+    {
+      priv->hash[ndx] = glyph->hlink;
+    }
   else
     {
-      prev->flink = glyph->flink;
+      prev->hlink = glyph->hlink;
     }
 
-  glyph->flink = NULL;
+  glyph->hlink = NULL;
 
   /* Decrement the count of glyphs in the font cache */
 
-  DEBUGASSERT(priv->nglyphs > 0);
+  DEBUGASSERT(priv->nglyphs > 0 && priv->nbytes >= NXF_GLYPHSIZE(glyph));
   priv->nglyphs--;
+  priv->nbytes -= NXF_GLYPHSIZE(glyph);
 }
 
 /****************************************************************************
@@ -242,26 +280,40 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
  *
  ****************************************************************************/
 
-static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
-                                FAR struct nxfonts_glyph_s *glyph)
+static void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
+                         FAR struct nxfonts_glyph_s *glyph)
 {
+  int ndx;
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Add the glyph to the head of the list */
+  /* Add the glyph to the head of the LRU list */
 
+  glyph->blink = NULL;
   glyph->flink = priv->head;
 
   if (priv->head == NULL)
     {
       priv->tail = glyph;
     }
+  else
+    {
+      priv->head->blink = glyph;
+    }
 
   priv->head = glyph;
 
+  /* And to its hash chain */
+
+  ndx             = NXF_HASH(glyph->code);
+  glyph->hlink    = priv->hash[ndx];
+  priv->hash[ndx] = glyph;
+
   /* Increment the count of glyphs in the font cache. */
 
   DEBUGASSERT(priv->nglyphs < priv->maxglyphs);
   priv->nglyphs++;
+  priv->nbytes += NXF_GLYPHSIZE(glyph);
 }
 
 /****************************************************************************
@@ -271,15 +323,10 @@ static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
  *   Find the glyph for the specific character 'ch' in the list of pre-
  *   rendered fonts in the font cache.
  *
- *   This is logically a part of nxf_cache_getglyph().  nxf_cache_getglyph()
- *   will attempt to find the cached glyph before rendering a new one.  So
- *   this function has two unexpected side-effects:  (1) If the font cache
- *   is full and the font is not found, then the least-recently-used glyph
- *   is deleted to make space for the new glyph that will be allocated.
- *
- *   (2) If the glyph is found, then it is moved to the head of the list of
- *   glyphs since it is now the most recently used (leaving the least
- *   recently used glyph at the tail of the list).
+ *   This is logically a part of nxf_cache_getglyph().  If the glyph is
+ *   found, then it is moved to the head of the list of glyphs since it is
+ *   now the most recently used (leaving the least recently used glyph at
+ *   the tail of the list).
  *
  * Assumptions:
  *   The caller has exclusive access to the font cache.
@@ -290,53 +337,59 @@ static FAR struct nxfonts_glyph_s *
 nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
+  /* Try to find the glyph in the hash chain for this character code */
 
-   for (prev = NULL, glyph = priv->head;
-        glyph != NULL;
-        prev = glyph, glyph = glyph->flink)
+  for (glyph = priv->hash[NXF_HASH(ch)];
+       glyph != NULL;
+       glyph = glyph->hlink)
     {
-      /* Check if we found the glyph for this character */
-
       if (glyph->code == ch)
         {
           /* This is now the most recently used glyph.  Move it to the head
            * of the list (if it is not already at the head of the list).
            */
 
-          if (prev != NULL)
+          if (glyph != priv->head)
             {
-              nxf_removeglyph(priv, glyph, prev);
+              nxf_removeglyph(priv, glyph);
               nxf_addglyph(priv, glyph);
             }
 
-          /* And return the glyph that we found */
-
           return glyph;
         }
+    }
 
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
+  return NULL;
+}
 
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
+/****************************************************************************
+ * Name: nxf_makeroom
+ *
+ * Description:
+ *   Discard least-recently-used glyphs until there is space in the font
+ *   cache for one more glyph of 'size' bytes.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the font cache.
+ *
+ ****************************************************************************/
 
-          nxf_removeglyph(priv, glyph, prev);
-          return NULL;
-        }
-    }
+static void nxf_makeroom(FAR struct nxfonts_fcache_s *priv, size_t size)
+{
+  FAR struct nxfonts_glyph_s *glyph;
 
-  return NULL;
+  while ((glyph = priv->tail) != NULL &&
+         (priv->nglyphs >= priv->maxglyphs ||
+          (CONFIG_NXFONTS_CACHE_MAXBYTES > 0 &&
+           priv->nbytes + size > CONFIG_NXFONTS_CACHE_MAXBYTES)))
+    {
+      nxf_removeglyph(priv, glyph);
+      lib_free(glyph);
+    }
 }
 
 /****************************************************************************
@@ -538,9 +591,15 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 
   stride = (width * priv->bpp + 7) >> 3;
 
-  /* Allocate the glyph (always succeeds) */
+  /* Make space in the cache, discarding the least recently used glyphs if
+   * necessary.
+   */
 
   bmsize = stride * height;
+  nxf_makeroom(priv, SIZEOF_NXFONTS_GLYPH_S(bmsize));
+
+  /* Allocate the glyph (always succeeds) */
+
   glyph  = (FAR struct nxfonts_glyph_s *)lib_malloc(SIZEOF_NXFONTS_GLYPH_S(bmsize));
 
   if (glyph != NULL)
@@ -578,6 +637,59 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
   return glyph;
 }
 
+/****************************************************************************
+ * Name: nxf_preload
+ *
+ * Description:
+ *   Pre-render the printable ASCII character set into a new font cache so
+ *   that rendering is not performed when the glyphs are first used.
+ *   Pre-loading stops when the cache is full; nothing is ever discarded.
+ *
+ * Assumptions:
+ *   The font cache is not yet visible to any other client.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFONTS_CACHE_PRELOAD
+static void nxf_preload(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR const struct nx_fontbitmap_s *fbm;
+  unsigned int stride;
+  size_t size;
+  int ch;
+
+  for (ch = NXF_PRELOAD_FIRST;
+       ch <= NXF_PRELOAD_LAST && priv->nglyphs < priv->maxglyphs;
+       ch++)
+    {
+      fbm = nxf_getbitmap(priv->font, ch);
+      if (fbm == NULL)
+        {
+          continue;
+        }
+
+      stride = ((fbm->metric.width + fbm->metric.xoffset) *
+                priv->bpp + 7) >> 3;
+      size   = SIZEOF_NXFONTS_GLYPH_S(stride *
+                 (fbm->metric.height + fbm->metric.yoffset));
+
+      if (CONFIG_NXFONTS_CACHE_MAXBYTES > 0 &&
+          priv->nbytes + size > CONFIG_NXFONTS_CACHE_MAXBYTES)
+        {
+          break;
+        }
+
+      if (nxf_renderglyph(priv, fbm, ch) == NULL)
+        {
+          break;
+        }
+    }
+
+  ginfo("Pre-loaded %d glyphs, %lu bytes\n",
+        priv->nglyphs, (unsigned long)priv->nbytes);
+}
+#endif
+
 /****************************************************************************
  * Name: nxf_findcache
  *
@@ -750,6 +862,12 @@ FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
           goto errout_with_fcache;
         }
 
+#ifdef CONFIG_NXFONTS_CACHE_PRELOAD
+      /* Render the commonly used glyphs now, rather than on first use */
+
+      nxf_preload(priv);
+#endif
+
       /* Initialize the mutual exclusion semaphore */
 
       (void)nxsem_init(&priv->fsem, 0, 1);
@@ -833,7 +951,7 @@ void nxf_cache_disconnect(FCACHE fhandle)
 
       for (prev = NULL, fcache = g_fcaches;
            fcache != priv && fcache != NULL;
-           fcache = fcache->flink);
+           prev = fcache, fcache = fcache->flink);
 
       ASSERT(fcache == priv);
       nxf_removecache(fcache, prev);
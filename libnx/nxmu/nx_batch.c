@@ -0,0 +1,158 @@
+/****************************************************************************
+ * libnx/nxmu/nx_batch.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+#include "nxcontext.h"
+
+#ifdef CONFIG_NXMU_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_beginbatch
+ *
+ * Description:
+ *   Begin collecting the drawing requests of this client.  Subsequent calls
+ *   to nx_fill(), nx_setpixel(), nx_filltrapezoid(), nx_filltraplist(),
+ *   nx_move(), and nx_bitmap() are buffered and sent to the server together
+ *   when the buffer fills, when nx_endbatch() is called, or before any other
+ *   request is sent to the server.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_beginbatch(NXHANDLE handle)
+{
+  FAR struct nxfe_conn_s *conn = (FAR struct nxfe_conn_s *)handle;
+  int i;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!conn)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  nxmu_semtake(&conn->batchsem);
+
+  /* Allocate the batch buffers on first use */
+
+  if (conn->batch == NULL)
+    {
+      conn->batch = (FAR struct nxmu_batch_s *)
+        lib_uzalloc(2 * sizeof(struct nxmu_batch_s));
+
+      if (conn->batch == NULL)
+        {
+          nxmu_semgive(&conn->batchsem);
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+
+      /* The done semaphores are used for signaling and, hence, should not
+       * have priority inheritance enabled.
+       */
+
+      for (i = 0; i < 2; i++)
+        {
+          (void)_SEM_INIT(&conn->batch[i].done, 0, 0);
+          (void)_SEM_SETPROTOCOL(&conn->batch[i].done, SEM_PRIO_NONE);
+        }
+    }
+
+  conn->batching = true;
+  nxmu_semgive(&conn->batchsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_endbatch
+ *
+ * Description:
+ *   Send all of the drawing requests collected since nx_beginbatch() to the
+ *   server and stop batching.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_endbatch(NXHANDLE handle)
+{
+  FAR struct nxfe_conn_s *conn = (FAR struct nxfe_conn_s *)handle;
+  int ret;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!conn)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  nxmu_semtake(&conn->batchsem);
+  ret = nxmu_batchsend(conn);
+  conn->batching = false;
+  nxmu_semgive(&conn->batchsem);
+
+  return ret;
+}
+
+#endif /* CONFIG_NXMU_BATCH */
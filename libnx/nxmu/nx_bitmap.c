@@ -40,6 +40,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -48,6 +49,83 @@
 #include <nuttx/nx/nxbe.h>
 #include <nuttx/nx/nxmu.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_batchbitmap
+ *
+ * Description:
+ *   Copy the rows of the source image covered by 'dest' into the current
+ *   batch buffer along with the bitmap request.  The server will then draw
+ *   from the batch buffer and the caller is free to re-use the source
+ *   image immediately.
+ *
+ * Returned Value:
+ *   true if the bitmap was batched; false if it must be sent directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+static bool nx_batchbitmap(FAR struct nxbe_window_s *wnd,
+                           FAR const struct nxgl_rect_s *dest,
+                           FAR const void *src[CONFIG_NX_NPLANES],
+                           FAR const struct nxgl_point_s *origin,
+                           unsigned int stride)
+{
+  FAR struct nxfe_conn_s *conn = wnd->conn;
+  FAR struct nxsvrmsg_bitmap_s *bmpmsg;
+  FAR uint8_t *data;
+  size_t msglen;
+  size_t datalen;
+  size_t offset;
+  int i;
+
+  if (NXBE_ISBLOCKED(wnd) || dest->pt1.y < origin->y ||
+      dest->pt2.y < dest->pt1.y)
+    {
+      return false;
+    }
+
+  /* Only the rows of the image that will be drawn are copied */
+
+  msglen  = NXMU_BATCH_ALIGN(sizeof(struct nxsvrmsg_bitmap_s));
+  datalen = (size_t)(dest->pt2.y - dest->pt1.y + 1) * stride;
+  offset  = (size_t)(dest->pt1.y - origin->y) * stride;
+
+  nxmu_semtake(&conn->batchsem);
+
+  bmpmsg = (FAR struct nxsvrmsg_bitmap_s *)
+    nxmu_batchreserve(conn, msglen + CONFIG_NX_NPLANES * datalen);
+
+  if (bmpmsg == NULL)
+    {
+      nxmu_semgive(&conn->batchsem);
+      return false;
+    }
+
+  bmpmsg->msgid    = NX_SVRMSG_BITMAP;
+  bmpmsg->wnd      = wnd;
+  bmpmsg->stride   = stride;
+  bmpmsg->origin.x = origin->x;
+  bmpmsg->origin.y = dest->pt1.y;
+  bmpmsg->sem_done = NULL;
+  nxgl_rectcopy(&bmpmsg->dest, dest);
+
+  data = (FAR uint8_t *)bmpmsg + msglen;
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      memcpy(data, (FAR const uint8_t *)src[i] + offset, datalen);
+      bmpmsg->src[i] = data;
+      data += datalen;
+    }
+
+  nxmu_semgive(&conn->batchsem);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -92,6 +170,17 @@ int nx_bitmap(NXWINDOW hwnd, FAR const struct nxgl_rect_s *dest,
     }
 #endif
 
+#ifdef CONFIG_NXMU_BATCH
+  /* If the client is batching requests, then try to send the image in the
+   * batch buffer.  Then there is no need to wait for the server.
+   */
+
+  if (wnd->conn->batching && nx_batchbitmap(wnd, dest, src, origin, stride))
+    {
+      return OK;
+    }
+#endif
+
   /* Format the bitmap command */
 
   outmsg.msgid      = NX_SVRMSG_BITMAP;
@@ -134,6 +134,12 @@ NXHANDLE nx_connectinstance(FAR const char *svrmqname)
 
   sprintf(climqname, NX_CLIENT_MQNAMEFMT, conn->cid);
 
+#ifdef CONFIG_NXMU_BATCH
+  /* Initialize the batch state (the buffers are allocated on first use) */
+
+  _SEM_INIT(&conn->batchsem, 0, 1);
+#endif
+
   /* Open the client MQ for reading */
 
   attr.mq_maxmsg  = CONFIG_NX_MXCLIENTMSGS;
@@ -82,6 +82,21 @@ static inline void nx_disconnected(FAR struct nxfe_conn_s *conn)
   (void)mq_close(conn->cwrmq);
   (void)mq_close(conn->crdmq);
 
+#ifdef CONFIG_NXMU_BATCH
+  /* Free the batch buffers.  The server processes messages in order, so it
+   * has already finished with them.
+   */
+
+  if (conn->batch != NULL)
+    {
+      (void)_SEM_DESTROY(&conn->batch[0].done);
+      (void)_SEM_DESTROY(&conn->batch[1].done);
+      lib_ufree(conn->batch);
+    }
+
+  (void)_SEM_DESTROY(&conn->batchsem);
+#endif
+
   /* And free the client structure */
 
   lib_ufree(conn);
@@ -0,0 +1,244 @@
+/****************************************************************************
+ * libnx/nxmu/nx_filltraplist.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxbe.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_batchtraplist
+ *
+ * Description:
+ *   Copy the trapezoids into the current batch buffer along with the fill
+ *   request.  Then there is no need to wait for the server.
+ *
+ * Returned Value:
+ *   true if the request was batched; false if it must be sent directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXMU_BATCH
+static bool nx_batchtraplist(FAR struct nxbe_window_s *wnd,
+                             FAR const struct nxgl_rect_s *clip,
+                             FAR const struct nxgl_trapezoid_s *traps,
+                             int ntraps,
+                             nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
+{
+  FAR struct nxfe_conn_s *conn = wnd->conn;
+  FAR struct nxsvrmsg_filltraplist_s *listmsg;
+  FAR struct nxgl_trapezoid_s *data;
+  size_t msglen;
+  size_t datalen;
+  int i;
+
+  msglen  = NXMU_BATCH_ALIGN(sizeof(struct nxsvrmsg_filltraplist_s));
+  datalen = ntraps * sizeof(struct nxgl_trapezoid_s);
+
+  nxmu_semtake(&conn->batchsem);
+
+  listmsg = (FAR struct nxsvrmsg_filltraplist_s *)
+    nxmu_batchreserve(conn, msglen + datalen);
+
+  if (listmsg == NULL)
+    {
+      nxmu_semgive(&conn->batchsem);
+      return false;
+    }
+
+  data = (FAR struct nxgl_trapezoid_s *)((FAR uint8_t *)listmsg + msglen);
+  memcpy(data, traps, datalen);
+
+  listmsg->msgid    = NX_SVRMSG_FILLTRAPLIST;
+  listmsg->wnd      = wnd;
+  listmsg->traps    = data;
+  listmsg->ntraps   = ntraps;
+  listmsg->sem_done = NULL;
+  nxgl_rectcopy(&listmsg->clip, clip);
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      listmsg->color[i] = color[i];
+    }
+
+  nxmu_semgive(&conn->batchsem);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_filltraplist
+ *
+ * Description:
+ *  Fill a list of trapezoidal regions in the window with the specified
+ *  color.  The server rasterizes all of the trapezoids in one pass.
+ *
+ * Input Parameters:
+ *   hwnd   - The window handle
+ *   clip   - Clipping region (may be null)
+ *   traps  - The list of trapezoidal regions to be filled
+ *   ntraps - The number of trapezoids in the list
+ *   color  - The color to use in the fill
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_filltraplist(NXWINDOW hwnd, FAR const struct nxgl_rect_s *clip,
+                    FAR const struct nxgl_trapezoid_s *traps, int ntraps,
+                    nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
+{
+  FAR struct nxbe_window_s *wnd = (FAR struct nxbe_window_s *)hwnd;
+  struct nxsvrmsg_filltraplist_s outmsg;
+  struct nxgl_rect_s relclip;
+  sem_t sem_done;
+  int ret;
+  int i;
+
+  /* Some debug-only sanity checks */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!wnd || !traps || ntraps < 0 || !color)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  /* Nothing is drawn in a blocked window, so there is no need to wait for
+   * the server.
+   */
+
+  if (ntraps == 0 || NXBE_ISBLOCKED(wnd))
+    {
+      return OK;
+    }
+
+  /* If no clipping window was provided, then use the entire window (in
+   * relative window coordinates).
+   */
+
+  if (!clip)
+    {
+      nxgl_rectoffset(&relclip, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+      clip = &relclip;
+    }
+
+#ifdef CONFIG_NXMU_BATCH
+  /* If the client is batching requests, then try to copy the trapezoids
+   * into the batch buffer.
+   */
+
+  if (wnd->conn->batching &&
+      nx_batchtraplist(wnd, clip, traps, ntraps, color))
+    {
+      return OK;
+    }
+#endif
+
+  /* Format the fill command */
+
+  outmsg.msgid  = NX_SVRMSG_FILLTRAPLIST;
+  outmsg.wnd    = wnd;
+  outmsg.traps  = traps;
+  outmsg.ntraps = ntraps;
+  nxgl_rectcopy(&outmsg.clip, clip);
+
+#if CONFIG_NX_NPLANES > 1
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+#else
+  i = 0;
+#endif
+    {
+      outmsg.color[i] = color[i];
+    }
+
+  /* Create a semaphore for tracking command completion */
+
+  outmsg.sem_done = &sem_done;
+
+  ret = _SEM_INIT(&sem_done, 0, 0);
+  if (ret < 0)
+    {
+      gerr("ERROR: _SEM_INIT failed: %d\n", _SEM_ERRNO(ret));
+      return ret;
+    }
+
+  /* The sem_done semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)_SEM_SETPROTOCOL(&sem_done, SEM_PRIO_NONE);
+
+  /* Forward the fill command to the server */
+
+  ret = nxmu_sendwindow(wnd, &outmsg, sizeof(struct nxsvrmsg_filltraplist_s));
+
+  /* Wait until the command is completed so that the caller can re-use the
+   * trapezoid list.
+   */
+
+  if (ret == OK)
+    {
+      ret = _SEM_WAIT(&sem_done);
+    }
+
+  /* Destroy the semaphore and return. */
+
+  (void)_SEM_DESTROY(&sem_done);
+
+  return ret;
+}
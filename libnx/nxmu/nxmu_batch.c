@@ -0,0 +1,241 @@
+/****************************************************************************
+ * libnx/nxmu/nxmu_batch.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mqueue.h>
+#include <nuttx/nx/nxbe.h>
+#include <nuttx/nx/nxmu.h>
+
+#ifdef CONFIG_NXMU_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batchsend
+ *
+ * Description:
+ *  Send any queued drawing requests to the server.  The caller must hold
+ *  conn->batchsem.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_batchsend(FAR struct nxfe_conn_s *conn)
+{
+  FAR struct nxmu_batch_s *batch;
+  struct nxsvrmsg_batch_s outmsg;
+  int ret;
+
+  if (conn->batch == NULL)
+    {
+      return OK;
+    }
+
+  batch = &conn->batch[conn->curbatch];
+  if (batch->nbytes == 0)
+    {
+      return OK;
+    }
+
+  /* Send the batch buffer to the server */
+
+  outmsg.msgid    = NX_SVRMSG_BATCH;
+  outmsg.buffer   = batch->buffer;
+  outmsg.buflen   = batch->nbytes;
+  outmsg.sem_done = &batch->done;
+
+  ret = _MQ_SEND(conn->cwrmq, (FAR const char *)&outmsg,
+                 sizeof(struct nxsvrmsg_batch_s), NX_SVRMSG_PRIO);
+  if (ret < 0)
+    {
+      gerr("ERROR: _MQ_SEND failed: %d\n", _MQ_GETERRNO(ret));
+      batch->nbytes = 0;
+      return ret;
+    }
+
+  batch->inflight = true;
+
+  /* Switch to the other buffer.  If the server has not yet finished with
+   * it, then we have to wait.
+   */
+
+  conn->curbatch ^= 1;
+  batch = &conn->batch[conn->curbatch];
+
+  if (batch->inflight)
+    {
+      nxmu_semtake(&batch->done);
+      batch->inflight = false;
+    }
+
+  batch->nbytes = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmu_batchreserve
+ *
+ * Description:
+ *  Reserve space for a message of 'msglen' bytes in the current batch
+ *  buffer, sending the buffer to the server first if it is full.  The
+ *  caller must hold conn->batchsem.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   A pointer to the reserved space; NULL if the client is not batching or
+ *   if the message can not be batched.
+ *
+ ****************************************************************************/
+
+FAR void *nxmu_batchreserve(FAR struct nxfe_conn_s *conn, size_t msglen)
+{
+  FAR struct nxmu_batch_s *batch;
+  FAR uint8_t *entry;
+  size_t entlen;
+
+  entlen = NXMU_BATCH_ALIGN(NXMU_BATCH_HDRSIZE + msglen);
+  if (!conn->batching || entlen > CONFIG_NXMU_BATCHSIZE)
+    {
+      return NULL;
+    }
+
+  /* Is there space for the message in the current buffer? */
+
+  batch = &conn->batch[conn->curbatch];
+  if (batch->nbytes + entlen > CONFIG_NXMU_BATCHSIZE)
+    {
+      /* No.. send the current buffer */
+
+      if (nxmu_batchsend(conn) < 0)
+        {
+          return NULL;
+        }
+
+      batch = &conn->batch[conn->curbatch];
+    }
+
+  /* Set up the header and return the space for the message */
+
+  entry = (FAR uint8_t *)batch->buffer + batch->nbytes;
+  *(FAR uintptr_t *)entry = entlen;
+  batch->nbytes += entlen;
+
+  return entry + NXMU_BATCH_HDRSIZE;
+}
+
+/****************************************************************************
+ * Name: nxmu_queuewindow
+ *
+ * Description:
+ *  Add a drawing request for a specific window to the current batch.  If
+ *  the client is not batching requests, the message is sent immediately
+ *  via nxmu_sendwindow().
+ *
+ * Input Parameters:
+ *   wnd    - A pointer to the back-end window structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_queuewindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
+                     size_t msglen)
+{
+  FAR struct nxfe_conn_s *conn;
+  FAR void *entry;
+
+  /* Sanity checking */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!wnd || !wnd->conn)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  /* Ignore messages destined to a blocked window (no errors reported) */
+
+  if (NXBE_ISBLOCKED(wnd))
+    {
+      return OK;
+    }
+
+  /* Add the message to the current batch, if possible */
+
+  conn = wnd->conn;
+  nxmu_semtake(&conn->batchsem);
+
+  entry = nxmu_batchreserve(conn, msglen);
+  if (entry != NULL)
+    {
+      memcpy(entry, msg, msglen);
+      nxmu_semgive(&conn->batchsem);
+      return OK;
+    }
+
+  nxmu_semgive(&conn->batchsem);
+
+  /* Otherwise, send it now */
+
+  return nxmu_sendwindow(wnd, msg, msglen);
+}
+
+#endif /* CONFIG_NXMU_BATCH */
@@ -81,6 +81,15 @@ int nxmu_sendserver(FAR struct nxfe_conn_s *conn, FAR const void *msg,
     }
 #endif
 
+#ifdef CONFIG_NXMU_BATCH
+  /* Any batched drawing requests must be processed by the server before
+   * this message.
+   */
+
+  nxmu_semtake(&conn->batchsem);
+  (void)nxmu_batchsend(conn);
+#endif
+
   /* Send the message to the server */
 
   ret = _MQ_SEND(conn->cwrmq, msg, msglen, NX_SVRMSG_PRIO);
@@ -89,5 +98,9 @@ int nxmu_sendserver(FAR struct nxfe_conn_s *conn, FAR const void *msg,
       gerr("ERROR: _MQ_SEND failed: %d\n", _MQ_GETERRNO(ret));
     }
 
+#ifdef CONFIG_NXMU_BATCH
+  nxmu_semgive(&conn->batchsem);
+#endif
+
   return ret;
 }
@@ -44,8 +44,11 @@
 #include <errno.h>
 
 #include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxtk.h>
 
+#include "nxtk.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -93,24 +96,19 @@ int nxtk_fillcircletoolbar(NXWINDOW hfwnd, FAR const struct nxgl_point_s *center
                            nxgl_coord_t radius,
                            nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
 {
-  FAR struct nxgl_trapezoid_s traps[NCIRCLE_TRAPS];
-  int i;
-  int ret;
+  FAR struct nxtk_framedwindow_s *fwnd = (FAR struct nxtk_framedwindow_s *)hfwnd;
+  struct nxgl_trapezoid_s traps[NCIRCLE_TRAPS];
+  struct nxgl_rect_s relclip;
 
   /* Describe the circular region as a sequence of 8 trapezoids */
 
   nxgl_circletraps(center, radius, traps);
 
-  /* Then rend those trapezoids */
+  /* Then rend those trapezoids together, clipping to the toolbar */
 
-  for (i = 0; i < NCIRCLE_TRAPS; i++)
-    {
-      ret = nxtk_filltraptoolbar(hfwnd, &traps[i], color);
-      if (ret != OK)
-        {
-          return ret;
-        }
-    }
+  nxgl_rectoffset(&relclip, &fwnd->tbrect, -fwnd->wnd.bounds.pt1.x,
+                  -fwnd->wnd.bounds.pt1.y);
 
-  return OK;
+  return nx_filltraplist((NXWINDOW)hfwnd, &relclip, traps, NCIRCLE_TRAPS,
+                         color);
 }
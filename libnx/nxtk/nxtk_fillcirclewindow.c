@@ -44,8 +44,11 @@
 #include <errno.h>
 
 #include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxtk.h>
 
+#include "nxtk.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -93,24 +96,29 @@ int nxtk_fillcirclewindow(NXWINDOW hfwnd, FAR const struct nxgl_point_s *center,
                           nxgl_coord_t radius,
                           nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
 {
-  FAR struct nxgl_trapezoid_s traps[NCIRCLE_TRAPS];
+  FAR struct nxtk_framedwindow_s *fwnd = (FAR struct nxtk_framedwindow_s *)hfwnd;
+  struct nxgl_trapezoid_s traps[NCIRCLE_TRAPS];
+  struct nxgl_rect_s relclip;
   int i;
-  int ret;
 
   /* Describe the circular region as a sequence of 8 trapezoids */
 
   nxgl_circletraps(center, radius, traps);
 
-  /* Then rend those trapezoids */
+  /* Move the trapezoids from window contents area to window area */
 
   for (i = 0; i < NCIRCLE_TRAPS; i++)
     {
-      ret = nxtk_filltrapwindow(hfwnd, &traps[i], color);
-      if (ret != OK)
-        {
-          return ret;
-        }
+      nxgl_trapoffset(&traps[i], &traps[i],
+                      fwnd->fwrect.pt1.x - fwnd->wnd.bounds.pt1.x,
+                      fwnd->fwrect.pt1.y - fwnd->wnd.bounds.pt1.y);
     }
 
-  return OK;
+  /* Then rend those trapezoids together, clipping to the client window */
+
+  nxgl_rectoffset(&relclip, &fwnd->fwrect, -fwnd->wnd.bounds.pt1.x,
+                  -fwnd->wnd.bounds.pt1.y);
+
+  return nx_filltraplist((NXWINDOW)hfwnd, &relclip, traps, NCIRCLE_TRAPS,
+                         color);
 }
@@ -67,6 +67,19 @@
 #  define lib_free(p)      free(p)
 #endif
 
+// The new and delete operators allocate through libxx_alloc() and
+// libxx_free().  These use the size-class pools of libxx_pool.cxx if
+// CONFIG_CXX_POOLALLOC is selected and the C library heap otherwise.  The
+// size passed to libxx_free() is zero if it is not known.
+
+#ifdef CONFIG_CXX_POOLALLOC
+#  define libxx_alloc(s)   libxx_poolalloc(s)
+#  define libxx_free(p,s)  libxx_poolfree(p,s)
+#else
+#  define libxx_alloc(s)   lib_malloc(s)
+#  define libxx_free(p,s)  lib_free(p)
+#endif
+
 //***************************************************************************
 // Public Types
 //***************************************************************************/
@@ -85,4 +98,9 @@ extern "C" FAR void *__dso_handle;
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
 
+#ifdef CONFIG_CXX_POOLALLOC
+FAR void *libxx_poolalloc(size_t nbytes);
+void libxx_poolfree(FAR void *ptr, size_t nbytes);
+#endif
+
 #endif // __LIBXX_LIBXX_HXX
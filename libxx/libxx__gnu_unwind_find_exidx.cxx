@@ -37,70 +37,245 @@
 // Included Files
 //***************************************************************************
 
+#include <nuttx/config.h>
+
+#include <sched.h>
+
 #include "libxx__gnu_unwind_find_exidx.hxx"
 
 //***************************************************************************
 // Pre-processor Definitions
 //***************************************************************************
 
+#ifndef CONFIG_CXX_EXIDX_NMODULES
+#  define CONFIG_CXX_EXIDX_NMODULES 4
+#endif
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+// The exception index table of one loaded ELF module.  'lo' is the address
+// of the first function described by the table.  The table is taken to
+// cover all code from 'lo' up to the 'lo' of the next module.
+
+struct exidx_module_s
+{
+  _uw lo;                                // Lowest function address
+  _uw hi;                                // Highest function address
+  FAR __EIT_entry *table;                // The .ARM.exidx section
+  int nrec;                              // Number of entries in the table
+};
+
 //***************************************************************************
 // Private Data
 //***************************************************************************
 
+// Loaded modules, sorted by 'lo'.  Lookups do not lock: they retry if
+// g_exidxseq was odd or changed while they searched.  Changes are made with
+// the scheduler locked.
+
+static struct exidx_module_s g_exidx[CONFIG_CXX_EXIDX_NMODULES];
+static int g_nexidx;
+static volatile unsigned int g_exidxseq;
+
+// The module that satisfied the last lookup.  Consecutive frames of an
+// unwind usually lie in the same module.
+
+static volatile int g_exidxlast;
+
 //***************************************************************************
-// Operators
+// Private Functions
 //***************************************************************************
 
 //***************************************************************************
-// Name:  __gnu_Unwind_Find_exidx
+// Name: exidx_fnaddr
 //
 // Description:
-//    This function is called (if exists) by the gcc generated unwind
-//    run-time in order to retrieve an alternative .ARM.exidx Exception
-//    index section.
-//    This is the case for an ELF module loaded by the elf binary loader.
-//    It is needed to support exception handling for loadable ELF modules.
+//   Decode the prel31 function offset of an exception index entry.
 //
-//    NOTES:
+//***************************************************************************
+
+static inline _uw exidx_fnaddr(FAR const __EIT_entry *entry)
+{
+  _uw offset = entry->fnoffset;
+
+  // Sign extend the 31-bit offset, which is relative to the entry itself
+
+  offset = (_uw)(((int)(offset << 1)) >> 1);
+  return (_uw)&entry->fnoffset + offset;
+}
+
+//***************************************************************************
+// Name: exidx_search
 //
-//     1. The section to be searched is chosen by the address of the calling
-//        site: if we are in a runtime loaded ELF, the code will be executed
-//        in ram ( > 0x20000000 ) otherwise we will  be executing code  from
-//        flash (0x08000000) (running nuttx from ram will break this logic)
+// Description:
+//   Return the index of the module whose code contains 'addr', or -1 if the
+//   address lies below all modules.
 //
-//     2. __exidx_start  and  __exidx_end refers to main nuttx elf image and
-//        are defined in its linker script.
+//***************************************************************************
+
+static int exidx_search(_uw addr)
+{
+  int last = g_exidxlast;
+  int low;
+  int high;
+
+  if (last < g_nexidx && g_exidx[last].lo <= addr &&
+      (last + 1 >= g_nexidx || addr < g_exidx[last + 1].lo))
+    {
+      return last;
+    }
+
+  // Find the last module with lo <= addr
+
+  low  = 0;
+  high = g_nexidx - 1;
+  last = -1;
+
+  while (low <= high)
+    {
+      int mid = (low + high) >> 1;
+
+      if (g_exidx[mid].lo <= addr)
+        {
+          last = mid;
+          low  = mid + 1;
+        }
+      else
+        {
+          high = mid - 1;
+        }
+    }
+
+  if (last >= 0)
+    {
+      g_exidxlast = last;
+    }
+
+  return last;
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name:  init_unwind_exidx
+//
+// Description:
+//    Register the .ARM.exidx section of an ELF module loaded by the elf
+//    binary loader.  Modules that occupied the same memory earlier are
+//    forgotten.  If the table is full, the module with the lowest address
+//    is replaced.
 //
-//     2. __exidx_start_elf  and  __exidx_end_elf refers  to the elf module
-//        loaded by the elf binary loader, and are initialized at run-time.
+//***************************************************************************
+
+extern "C" void init_unwind_exidx(Elf32_Addr start, Elf32_Word size)
+{
+  FAR __EIT_entry *table = (FAR __EIT_entry *)start;
+  struct exidx_module_s module;
+  int i;
+  int j;
+
+  module.nrec = size / sizeof(__EIT_entry);
+  if (module.nrec < 1)
+    {
+      return;
+    }
+
+  module.table = table;
+  module.lo    = exidx_fnaddr(&table[0]);
+  module.hi    = exidx_fnaddr(&table[module.nrec - 1]);
+
+  sched_lock();
+  g_exidxseq++;
+  __sync_synchronize();
+
+  // Drop modules that overlap the new one
+
+  for (i = 0, j = 0; i < g_nexidx; i++)
+    {
+      if (g_exidx[i].hi < module.lo || g_exidx[i].lo > module.hi)
+        {
+          g_exidx[j++] = g_exidx[i];
+        }
+    }
+
+  g_nexidx = j;
+  if (g_nexidx >= CONFIG_CXX_EXIDX_NMODULES)
+    {
+      for (i = 1; i < g_nexidx; i++)
+        {
+          g_exidx[i - 1] = g_exidx[i];
+        }
+
+      g_nexidx--;
+    }
+
+  // Insert the new module in order
+
+  for (i = g_nexidx; i > 0 && g_exidx[i - 1].lo > module.lo; i--)
+    {
+      g_exidx[i] = g_exidx[i - 1];
+    }
+
+  g_exidx[i]  = module;
+  g_nexidx++;
+  g_exidxlast = i;
+
+  __sync_synchronize();
+  g_exidxseq++;
+  sched_unlock();
+}
+
+//***************************************************************************
+// Name:  __gnu_Unwind_Find_exidx
 //
-//     3. TODO: if nuttx itself is running from ram, this logic will not work
+// Description:
+//    This function is called (if exists) by the gcc generated unwind
+//    run-time in order to retrieve an alternative .ARM.exidx Exception
+//    index section.  The unwinder then binary-searches the returned table.
 //
-//     4. TODO: in order to support multiple elf modules running at the same
-//        time, this error logic needs to be extended to store multiple
-//        start/end ranges that refers to the loaded binaries.
+//    The main nuttx image is described by __exidx_start and __exidx_end
+//    from its linker script.  Addresses outside of the main image are
+//    looked up in the sorted table of loaded ELF modules; the main image is
+//    returned if no module contains the address.
 //
 //***************************************************************************
 
-extern "C"
+extern "C" _Unwind_Ptr __gnu_Unwind_Find_exidx(_Unwind_Ptr return_address,
+                                               int *nrecp)
 {
-  void init_unwind_exidx(Elf32_Addr start, Elf32_Word size)
-  {
-    __exidx_start_elf = (__EIT_entry *) start;
-    __exidx_end_elf   = __exidx_start_elf + size;
-  }
-
-  _Unwind_Ptr __gnu_Unwind_Find_exidx (_Unwind_Ptr return_address, int *nrecp)
-  {
-    if (return_address < 0x20000000)
-      {
-        *nrecp = &__exidx_end - &__exidx_start;
-        return (_Unwind_Ptr) &__exidx_start;
-      }
-    else
-      {
-        *nrecp = (__exidx_end_elf - __exidx_start_elf) / sizeof(__EIT_entry);
-        return (_Unwind_Ptr) __exidx_start_elf;
-      }
-  }
+  FAR __EIT_entry *table = &__exidx_start;
+  int nrec = &__exidx_end - &__exidx_start;
+  _uw addr = (_uw)return_address;
+  unsigned int seq;
+  int index;
+
+  if (nrec > 0 && addr >= exidx_fnaddr(&table[0]) &&
+      addr <= exidx_fnaddr(&table[nrec - 1]))
+    {
+      *nrecp = nrec;
+      return (_Unwind_Ptr)table;
+    }
+
+  do
+    {
+      seq = g_exidxseq;
+      __sync_synchronize();
+
+      index = exidx_search(addr);
+      if (index >= 0)
+        {
+          table = g_exidx[index].table;
+          nrec  = g_exidx[index].nrec;
+        }
+
+      __sync_synchronize();
+    }
+  while ((seq & 1) != 0 || seq != g_exidxseq);
+
+  *nrecp = nrec;
+  return (_Unwind_Ptr)table;
 }
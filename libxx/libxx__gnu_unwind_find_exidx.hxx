@@ -66,14 +66,12 @@ typedef struct __EIT_entry
 extern __EIT_entry __exidx_start;
 extern __EIT_entry __exidx_end;
 
-__EIT_entry *__exidx_start_elf;
-__EIT_entry *__exidx_end_elf;
-
 //***************************************************************************
 // Public Function Prototypes
 //***************************************************************************
 
- _Unwind_Ptr __gnu_Unwind_Find_exidx(_Unwind_Ptr return_address, int *nrecp);
+void init_unwind_exidx(Elf32_Addr start, Elf32_Word size);
+_Unwind_Ptr __gnu_Unwind_Find_exidx(_Unwind_Ptr return_address, int *nrecp);
 
 } // extern "C"
 
@@ -39,6 +39,10 @@
 
 #include <nuttx/compiler.h>
 
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+
 //***************************************************************************
 // Pre-processor Definitions
 //***************************************************************************
@@ -50,22 +54,70 @@
 #ifdef __ARM_EABI__
 // The 32-bit ARM C++ ABI specifies that the guard is a 32-bit
 // variable and the least significant bit contains 0 prior to
-// initialization, and 1 after.
+// initialization, and 1 after.  The remaining bits are ours to use; bit 8
+// marks an initialization in progress.
 
 typedef int __guard;
 
+#  define GUARD_DONE(g)     (__atomic_load_n(g, __ATOMIC_ACQUIRE) & 1)
+#  define GUARD_SETDONE(g)  __atomic_store_n(g, 1, __ATOMIC_RELEASE)
+#  define GUARD_BUSY(g)     ((*(g) & 0x100) != 0)
+#  define GUARD_SETBUSY(g)  (*(g) |= 0x100)
+#  define GUARD_CLRBUSY(g)  (*(g) &= ~0x100)
+
 #else
 // The "standard" C++ ABI specifies that the guard is a 64-bit
 // variable and the first byte contains 0 prior to initialization, and
-// 1 after.
+// 1 after.  The second byte marks an initialization in progress.
 
 __extension__ typedef int __guard __attribute__((mode(__DI__)));
+
+#  define GUARD_DONE(g)     __atomic_load_n((FAR char *)(g), __ATOMIC_ACQUIRE)
+#  define GUARD_SETDONE(g) \
+     __atomic_store_n((FAR char *)(g), 1, __ATOMIC_RELEASE)
+#  define GUARD_BUSY(g)     (((FAR char *)(g))[1] != 0)
+#  define GUARD_SETBUSY(g)  (((FAR char *)(g))[1] = 1)
+#  define GUARD_CLRBUSY(g)  (((FAR char *)(g))[1] = 0)
 #endif
 
 //***************************************************************************
 // Private Data
 //***************************************************************************
 
+// g_guardlock protects the busy marks of all guards.  It is not held while
+// an object is being initialized, so initializers may themselves use
+// function-local statics.  Threads that find an initialization in progress
+// wait on g_guardwait and are all woken when any initialization ends.
+
+static sem_t g_guardlock = SEM_INITIALIZER(1);
+static sem_t g_guardwait = SEM_INITIALIZER(0);
+static int g_guardwaiters;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static void guard_wait(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+static void guard_wakeup(void)
+{
+  int nwaiters = g_guardwaiters;
+
+  g_guardwaiters = 0;
+  sem_post(&g_guardlock);
+
+  while (nwaiters-- > 0)
+    {
+      sem_post(&g_guardwait);
+    }
+}
+
 //***************************************************************************
 // Public Functions
 //***************************************************************************
@@ -74,15 +126,42 @@ extern "C"
 {
   //*************************************************************************
   // Name: __cxa_guard_acquire
+  //
+  // Description:
+  //   Return non-zero if the caller must initialize the object.  Once the
+  //   object has been initialized this takes no lock.
+  //
   //*************************************************************************
 
   int __cxa_guard_acquire(FAR __guard *g)
   {
-#ifdef __ARM_EABI__
-    return !(*g & 1);
-#else
-    return !*(char *)g;
-#endif
+    if (GUARD_DONE(g))
+      {
+        return 0;
+      }
+
+    guard_wait(&g_guardlock);
+
+    while (GUARD_BUSY(g))
+      {
+        // Another thread is initializing the object.  Wait for it to finish
+        // or to abort.
+
+        g_guardwaiters++;
+        sem_post(&g_guardlock);
+        guard_wait(&g_guardwait);
+        guard_wait(&g_guardlock);
+      }
+
+    if (GUARD_DONE(g))
+      {
+        sem_post(&g_guardlock);
+        return 0;
+      }
+
+    GUARD_SETBUSY(g);
+    sem_post(&g_guardlock);
+    return 1;
   }
 
   //*************************************************************************
@@ -91,18 +170,20 @@ extern "C"
 
   void __cxa_guard_release(FAR __guard *g)
   {
-#ifdef __ARM_EABI__
-    *g = 1;
-#else
-    *(char *)g = 1;
-#endif
+    guard_wait(&g_guardlock);
+    GUARD_CLRBUSY(g);
+    GUARD_SETDONE(g);
+    guard_wakeup();
   }
 
   //*************************************************************************
   // Name: __cxa_guard_abort
   //*************************************************************************
 
-  void __cxa_guard_abort(FAR __guard *)
+  void __cxa_guard_abort(FAR __guard *g)
   {
+    guard_wait(&g_guardlock);
+    GUARD_CLRBUSY(g);
+    guard_wakeup();
   }
 }
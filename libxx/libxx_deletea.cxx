@@ -51,5 +51,5 @@
 
 void operator delete[](void *ptr)
 {
-  lib_free(ptr);
+  libxx_free(ptr, 0);
 }
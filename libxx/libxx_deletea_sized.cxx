@@ -59,7 +59,7 @@ void operator delete[](FAR void *ptr, unsigned long size)
 void operator delete[](FAR void *ptr, unsigned int size)
 #endif
 {
-  lib_free(ptr);
+  libxx_free(ptr, size);
 }
 
 #endif /* CONFIG_HAVE_CXX14 */
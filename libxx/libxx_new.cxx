@@ -77,7 +77,7 @@ void *operator new(unsigned int nbytes)
 
   // Perform the allocation
 
-  void *alloc = lib_malloc(nbytes);
+  void *alloc = libxx_alloc(nbytes);
 
 #ifdef CONFIG_DEBUG_ERROR
   if (alloc == 0)
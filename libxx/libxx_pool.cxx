@@ -0,0 +1,639 @@
+//***************************************************************************
+// libxx/libxx_pool.cxx
+//
+//   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX nor the names of its contributors may be
+//    used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <semaphore.h>
+#include <sched.h>
+#include <unistd.h>
+#include <assert.h>
+
+#include <nuttx/lib/cxxpool.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_CXX_POOLALLOC
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+#if (CONFIG_CXX_POOLALLOC_MAXSIZE % CXXPOOL_QUANTUM) != 0
+#  error CONFIG_CXX_POOLALLOC_MAXSIZE must be a multiple of 16
+#endif
+
+#ifndef CONFIG_CXX_POOLALLOC_NCACHES
+#  define CONFIG_CXX_POOLALLOC_NCACHES 0
+#endif
+
+#ifndef CONFIG_CXX_POOLALLOC_CACHEDEPTH
+#  define CONFIG_CXX_POOLALLOC_CACHEDEPTH 8
+#endif
+
+// Every allocation is preceded by a small header that records its size
+// class so that the unsized delete operators can find the pool.  The
+// header size preserves the alignment returned by the heap.
+
+#define POOL_HDRSIZE   8
+#define POOL_LARGE     0xff
+
+// A cache moves half of its depth to or from the shared pools at a time
+
+#define POOL_BATCH     ((CONFIG_CXX_POOLALLOC_CACHEDEPTH + 1) / 2)
+
+#define POOL_STRIDE(c) (POOL_HDRSIZE + ((c) + 1) * CXXPOOL_QUANTUM)
+#define POOL_HDR(p)    ((FAR uint8_t *)(p) - POOL_HDRSIZE)
+#define POOL_USER(h)   ((FAR void *)((FAR uint8_t *)(h) + POOL_HDRSIZE))
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+// A free block, linked through its user area
+
+struct pool_free_s
+{
+  FAR struct pool_free_s *flink;
+};
+
+// The shared free list of one size class.  Protected by g_poolsem.
+
+struct pool_class_s
+{
+  FAR struct pool_free_s *head;
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+  size_t nblocks;
+  unsigned long nalloc;
+  unsigned long nfree;
+#endif
+};
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+// A per-thread cache.  Only the owning thread touches the lists; the owner
+// field is changed only with g_poolsem held.
+
+struct pool_cache_s
+{
+  volatile pid_t owner;                  // Owner PID + 1; zero if unused
+  uint8_t count[CXXPOOL_NCLASSES];
+  FAR struct pool_free_s *head[CXXPOOL_NCLASSES];
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+  unsigned long nhits;
+  unsigned long nalloc[CXXPOOL_NCLASSES];
+  unsigned long nfree[CXXPOOL_NCLASSES];
+#endif
+};
+#endif
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static sem_t g_poolsem = SEM_INITIALIZER(1);
+static struct pool_class_s g_classes[CXXPOOL_NCLASSES];
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+static struct pool_cache_s g_caches[CONFIG_CXX_POOLALLOC_NCACHES];
+#endif
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+static size_t g_chunkmem;
+static unsigned long g_nhits;
+static unsigned long g_nmisses;
+static unsigned long g_nlarge;
+static unsigned long g_nlargefree;
+#endif
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: pool_lock and pool_unlock
+//***************************************************************************
+
+static void pool_lock(void)
+{
+  while (sem_wait(&g_poolsem) < 0)
+    {
+      // The only case that an error should occur here is if the wait was
+      // awakened by a signal.
+
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+static inline void pool_unlock(void)
+{
+  sem_post(&g_poolsem);
+}
+
+//***************************************************************************
+// Name: pool_carve
+//
+// Description:
+//   Carve a new chunk into blocks of class 'cls' and add them to the
+//   shared free list.  The pool lock must be held.
+//
+//***************************************************************************
+
+static int pool_carve(int cls)
+{
+  FAR struct pool_class_s *pool = &g_classes[cls];
+  size_t stride = POOL_STRIDE(cls);
+  size_t nblocks = CONFIG_CXX_POOLALLOC_CHUNKSIZE / stride;
+
+  if (nblocks < 1)
+    {
+      nblocks = 1;
+    }
+
+  // Chunks are never returned to the heap.  Keeping them is what makes the
+  // allocation time predictable once the working set has been reached.
+
+  FAR uint8_t *chunk = (FAR uint8_t *)lib_malloc(nblocks * stride);
+  if (chunk == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (size_t i = 0; i < nblocks; i++, chunk += stride)
+    {
+      FAR struct pool_free_s *blk = (FAR struct pool_free_s *)POOL_USER(chunk);
+
+      *chunk     = (uint8_t)cls;
+      blk->flink = pool->head;
+      pool->head = blk;
+    }
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+  pool->nblocks += nblocks;
+  g_chunkmem    += nblocks * stride;
+#endif
+  return OK;
+}
+
+//***************************************************************************
+// Name: pool_take
+//
+// Description:
+//   Remove one block from the shared free list of class 'cls', carving a
+//   new chunk if the list is empty.  The pool lock must be held.
+//
+//***************************************************************************
+
+static FAR struct pool_free_s *pool_take(int cls)
+{
+  FAR struct pool_class_s *pool = &g_classes[cls];
+  FAR struct pool_free_s *blk;
+
+  if (pool->head == NULL && pool_carve(cls) < 0)
+    {
+      return NULL;
+    }
+
+  blk        = pool->head;
+  pool->head = blk->flink;
+  return blk;
+}
+
+//***************************************************************************
+// Name: pool_give
+//
+// Description:
+//   Return one block to the shared free list of class 'cls'.  The pool lock
+//   must be held.
+//
+//***************************************************************************
+
+static inline void pool_give(int cls, FAR struct pool_free_s *blk)
+{
+  blk->flink           = g_classes[cls].head;
+  g_classes[cls].head  = blk;
+}
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+//***************************************************************************
+// Name: pool_drain
+//
+// Description:
+//   Move up to 'nblocks' blocks of class 'cls' from a cache to the shared
+//   free list.  The pool lock must be held.
+//
+//***************************************************************************
+
+static void pool_drain(FAR struct pool_cache_s *cache, int cls, int nblocks)
+{
+  while (nblocks-- > 0 && cache->head[cls] != NULL)
+    {
+      FAR struct pool_free_s *blk = cache->head[cls];
+
+      cache->head[cls] = blk->flink;
+      cache->count[cls]--;
+      pool_give(cls, blk);
+    }
+}
+
+//***************************************************************************
+// Name: pool_release
+//
+// Description:
+//   Empty a cache and mark it unused.  Its statistics are folded into the
+//   shared counts.  The pool lock must be held.
+//
+//***************************************************************************
+
+static void pool_release(FAR struct pool_cache_s *cache)
+{
+  for (int cls = 0; cls < CXXPOOL_NCLASSES; cls++)
+    {
+      pool_drain(cache, cls, cache->count[cls]);
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+      g_classes[cls].nalloc += cache->nalloc[cls];
+      g_classes[cls].nfree  += cache->nfree[cls];
+#endif
+    }
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+  g_nhits += cache->nhits;
+  cache->nhits = 0;
+  memset(cache->nalloc, 0, sizeof(cache->nalloc));
+  memset(cache->nfree, 0, sizeof(cache->nfree));
+#endif
+
+  cache->owner = 0;
+}
+
+//***************************************************************************
+// Name: pool_getcache
+//
+// Description:
+//   Return the cache owned by the calling thread, claiming one if it has
+//   none.  A cache whose owner no longer exists is reclaimed.  NULL is
+//   returned if all caches are in use; the caller then uses the shared
+//   pools directly.
+//
+//***************************************************************************
+
+static FAR struct pool_cache_s *pool_getcache(void)
+{
+  FAR struct pool_cache_s *cache;
+  pid_t owner = getpid() + 1;
+  int i;
+
+  for (i = 0; i < CONFIG_CXX_POOLALLOC_NCACHES; i++)
+    {
+      if (g_caches[i].owner == owner)
+        {
+          return &g_caches[i];
+        }
+    }
+
+  // We have no cache.  Only this thread can claim one on its own behalf, so
+  // there is no need to search again after taking the lock.
+
+  cache = NULL;
+  pool_lock();
+
+  for (i = 0; i < CONFIG_CXX_POOLALLOC_NCACHES && cache == NULL; i++)
+    {
+      if (g_caches[i].owner == 0)
+        {
+          cache = &g_caches[i];
+        }
+    }
+
+  for (i = 0; i < CONFIG_CXX_POOLALLOC_NCACHES && cache == NULL; i++)
+    {
+      struct sched_param param;
+
+      // Keep a new thread from taking the PID of the dead owner between the
+      // test and the change of ownership.
+
+      sched_lock();
+      if (sched_getparam(g_caches[i].owner - 1, &param) < 0)
+        {
+          cache        = &g_caches[i];
+          cache->owner = owner;
+        }
+
+      sched_unlock();
+    }
+
+  if (cache != NULL)
+    {
+      if (cache->owner != 0)
+        {
+          pool_release(cache);
+        }
+
+      cache->owner = owner;
+    }
+
+  pool_unlock();
+  return cache;
+}
+#endif
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_poolalloc
+//
+// Description:
+//   Allocate memory for operator new.  Requests of up to
+//   CONFIG_CXX_POOLALLOC_MAXSIZE bytes are served from size-class pools,
+//   through the calling thread's cache when it has one; larger requests go
+//   to the heap.
+//
+//***************************************************************************
+
+FAR void *libxx_poolalloc(size_t nbytes)
+{
+  FAR struct pool_free_s *blk;
+  int cls;
+
+  if (nbytes > CONFIG_CXX_POOLALLOC_MAXSIZE)
+    {
+      if (nbytes > SIZE_MAX - POOL_HDRSIZE)
+        {
+          return NULL;
+        }
+
+      FAR uint8_t *hdr = (FAR uint8_t *)lib_malloc(nbytes + POOL_HDRSIZE);
+      if (hdr == NULL)
+        {
+          return NULL;
+        }
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+      pool_lock();
+      g_nlarge++;
+      pool_unlock();
+#endif
+
+      *hdr = POOL_LARGE;
+      return POOL_USER(hdr);
+    }
+
+  cls = nbytes > 0 ? (int)((nbytes - 1) / CXXPOOL_QUANTUM) : 0;
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+  FAR struct pool_cache_s *cache = pool_getcache();
+  if (cache != NULL)
+    {
+      if (cache->head[cls] == NULL)
+        {
+          // Refill the cache with a batch of blocks
+
+          pool_lock();
+
+          for (int i = 0; i < POOL_BATCH; i++)
+            {
+              blk = pool_take(cls);
+              if (blk == NULL)
+                {
+                  break;
+                }
+
+              blk->flink        = cache->head[cls];
+              cache->head[cls]  = blk;
+              cache->count[cls]++;
+            }
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+          g_nmisses++;
+#endif
+          pool_unlock();
+
+          if (cache->head[cls] == NULL)
+            {
+              return NULL;
+            }
+        }
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+      else
+        {
+          cache->nhits++;
+        }
+
+      cache->nalloc[cls]++;
+#endif
+
+      blk              = cache->head[cls];
+      cache->head[cls] = blk->flink;
+      cache->count[cls]--;
+      return (FAR void *)blk;
+    }
+#endif
+
+  pool_lock();
+  blk = pool_take(cls);
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+  if (blk != NULL)
+    {
+      g_classes[cls].nalloc++;
+    }
+
+  g_nmisses++;
+#endif
+
+  pool_unlock();
+  return (FAR void *)blk;
+}
+
+//***************************************************************************
+// Name: libxx_poolfree
+//
+// Description:
+//   Free memory allocated by libxx_poolalloc().  'nbytes' is the size
+//   passed to a sized delete operator, or zero if the size is not known.
+//
+//***************************************************************************
+
+void libxx_poolfree(FAR void *ptr, size_t nbytes)
+{
+  FAR struct pool_free_s *blk = (FAR struct pool_free_s *)ptr;
+  FAR uint8_t *hdr;
+  int cls;
+
+  if (ptr == NULL)
+    {
+      return;
+    }
+
+  hdr = POOL_HDR(ptr);
+  if (*hdr == POOL_LARGE)
+    {
+      DEBUGASSERT(nbytes == 0 || nbytes > CONFIG_CXX_POOLALLOC_MAXSIZE);
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+      pool_lock();
+      g_nlargefree++;
+      pool_unlock();
+#endif
+
+      lib_free(hdr);
+      return;
+    }
+
+  cls = *hdr;
+  DEBUGASSERT(cls < CXXPOOL_NCLASSES);
+  DEBUGASSERT(nbytes <= (size_t)(cls + 1) * CXXPOOL_QUANTUM);
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+  FAR struct pool_cache_s *cache = pool_getcache();
+  if (cache != NULL)
+    {
+      if (cache->count[cls] >= CONFIG_CXX_POOLALLOC_CACHEDEPTH)
+        {
+          pool_lock();
+          pool_drain(cache, cls, POOL_BATCH);
+          pool_unlock();
+        }
+
+      blk->flink       = cache->head[cls];
+      cache->head[cls] = blk;
+      cache->count[cls]++;
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+      cache->nfree[cls]++;
+#endif
+      return;
+    }
+#endif
+
+  pool_lock();
+  pool_give(cls, blk);
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+  g_classes[cls].nfree++;
+#endif
+
+  pool_unlock();
+}
+
+//***************************************************************************
+// Name: cxxpool_flush
+//***************************************************************************
+
+void cxxpool_flush(void)
+{
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+  pid_t owner = getpid() + 1;
+
+  for (int i = 0; i < CONFIG_CXX_POOLALLOC_NCACHES; i++)
+    {
+      if (g_caches[i].owner == owner)
+        {
+          pool_lock();
+          pool_release(&g_caches[i]);
+          pool_unlock();
+          break;
+        }
+    }
+#endif
+}
+
+//***************************************************************************
+// Name: cxxpool_stats
+//***************************************************************************
+
+#ifdef CONFIG_CXX_POOLALLOC_STATS
+int cxxpool_stats(FAR struct cxxpool_stats_s *stats)
+{
+  DEBUGASSERT(stats != NULL);
+  memset(stats, 0, sizeof(struct cxxpool_stats_s));
+
+  pool_lock();
+
+  stats->chunkmem   = g_chunkmem;
+  stats->nhits      = g_nhits;
+  stats->nmisses    = g_nmisses;
+  stats->nlarge     = g_nlarge;
+  stats->nlargefree = g_nlargefree;
+
+  for (int cls = 0; cls < CXXPOOL_NCLASSES; cls++)
+    {
+      FAR struct cxxpool_class_s *info = &stats->classes[cls];
+
+      info->size    = (cls + 1) * CXXPOOL_QUANTUM;
+      info->nblocks = g_classes[cls].nblocks;
+      info->nalloc  = g_classes[cls].nalloc;
+      info->nfree   = g_classes[cls].nfree;
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+      for (int i = 0; i < CONFIG_CXX_POOLALLOC_NCACHES; i++)
+        {
+          FAR struct pool_cache_s *cache = &g_caches[i];
+
+          if (cache->owner != 0)
+            {
+              info->ncached += cache->count[cls];
+              info->nalloc  += cache->nalloc[cls];
+              info->nfree   += cache->nfree[cls];
+            }
+        }
+#endif
+    }
+
+#if CONFIG_CXX_POOLALLOC_NCACHES > 0
+  for (int i = 0; i < CONFIG_CXX_POOLALLOC_NCACHES; i++)
+    {
+      if (g_caches[i].owner != 0)
+        {
+          stats->nhits += g_caches[i].nhits;
+        }
+    }
+#endif
+
+  pool_unlock();
+  return OK;
+}
+#endif
+
+#endif // CONFIG_CXX_POOLALLOC
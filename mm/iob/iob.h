@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <semaphore.h>
 #include <debug.h>
 
@@ -53,6 +54,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_IOB_PERCPU
+#  if CONFIG_IOB_PERCPU_BATCH >= CONFIG_IOB_PERCPU_DEPTH
+#    error CONFIG_IOB_PERCPU_BATCH must be less than CONFIG_IOB_PERCPU_DEPTH
+#  endif
+#endif
+
 #if defined(CONFIG_DEBUG_FEATURES) && defined(CONFIG_IOB_DEBUG)
 #ifdef CONFIG_CPP_HAVE_VARARGS
 
@@ -95,6 +102,20 @@ extern FAR struct iob_s *g_iob_freelist;
 
 extern FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* A list of all free, unallocated small I/O buffers */
+
+extern FAR struct iob_s *g_iob_smallfree;
+extern int g_iob_smallnfree;  /* Number of buffers in the list */
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+extern FAR struct iob_s *g_iob_largefree;
+extern int g_iob_largenfree;  /* Number of buffers in the list */
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -154,6 +175,80 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the free list or to the committed list.  This
+ *   function is intended only for internal use by the IOB module.
+ *
+ * Assumptions:
+ *   Called from within the critical section.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty and enough buffers are free.
+ *   The returned buffer is not initialized.  Returns NULL if no buffer
+ *   could be taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_PERCPU
+FAR struct iob_s *iob_cache_alloc(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Try to add a freed I/O buffer to the cache of the current CPU.  Returns
+ *   true if the buffer was cached.  Otherwise, the caller must return the
+ *   buffer to the free list together with any buffers that were removed
+ *   from the cache and returned in 'flush'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_PERCPU
+bool iob_cache_free(FAR struct iob_s *iob, FAR struct iob_s **flush);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers in the caches of all CPUs to the free list (or to
+ *   the committed list if a thread is waiting).  Called before a thread
+ *   waits for a buffer so that no buffer is left idle in a cache.
+ *
+ * Assumptions:
+ *   Called from within the critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_PERCPU
+void iob_cache_drain(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_pool_free
+ *
+ * Description:
+ *   Return an I/O buffer to the pool of small or of large buffers that it
+ *   was allocated from.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IOB_POOLS
+void iob_pool_free(FAR struct iob_s *iob);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
 
@@ -45,6 +45,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/sched.h>
 #include <nuttx/mm/iob.h>
 
@@ -132,6 +133,19 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
    */
 
   iob = iob_tryalloc(throttled);
+
+#ifdef CONFIG_IOB_PERCPU
+  if (iob == NULL)
+    {
+      /* Buffers may be idle in the caches of other CPUs.  Return them to
+       * the free list and try again before waiting.
+       */
+
+      iob_cache_drain();
+      iob = iob_tryalloc(throttled);
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -235,6 +249,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
 {
   FAR struct iob_s *iob;
   irqstate_t flags;
+  irqstate_t cflags;
 #if CONFIG_IOB_THROTTLE > 0
   FAR sem_t *sem;
 #endif
@@ -245,6 +260,23 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   sem = (throttled ? &g_throttle_sem : &g_iob_sem);
 #endif
 
+#ifdef CONFIG_IOB_PERCPU
+  /* First try the cache of this CPU.  The cached buffers were all taken
+   * from above the throttle reserve, so they may be used by throttled
+   * allocations too.
+   */
+
+  iob = iob_cache_alloc();
+  if (iob != NULL)
+    {
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      return iob;
+    }
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -273,9 +305,12 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
            * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
            * because this function may be called from an interrupt
            * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
+           * so a simple decrement is all that is needed.  The count lock
+           * is required because nxsem_post() may modify the count outside
+           * of the critical section.
            */
 
+          cflags = nxsem_countlock();
           g_iob_sem.semcount--;
           DEBUGASSERT(g_iob_sem.semcount >= 0);
 
@@ -287,6 +322,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
           g_throttle_sem.semcount--;
           DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
+          nxsem_countunlock(cflags);
           leave_critical_section(flags);
 
           /* Put the I/O buffer in a known state */
@@ -45,6 +45,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -228,6 +229,7 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
 {
   FAR struct iob_qentry_s *iobq;
   irqstate_t flags;
+  irqstate_t cflags;
 
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
@@ -248,11 +250,15 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void)
        * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
        * because this function may be called from an interrupt
        * handler. Fortunately we know at at least one free buffer
-       * so a simple decrement is all that is needed.
+       * so a simple decrement is all that is needed.  The count lock is
+       * required because nxsem_post() may modify the count outside of the
+       * critical section.
        */
 
+      cflags = nxsem_countlock();
       g_qentry_sem.semcount--;
       DEBUGASSERT(g_qentry_sem.semcount >= 0);
+      nxsem_countunlock(cflags);
 
       /* Put the I/O buffer in a known state */
 
@@ -0,0 +1,344 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_PERCPU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The cache of the CPU that we are executing on.  Interrupts must be
+ * disabled on this CPU so that we cannot be moved to another CPU while the
+ * cache is being accessed.
+ */
+
+#define IOB_THIS_CACHE()    (&g_iob_cache[up_cpu_index()])
+
+/* The number of free buffers above the throttle reserve.  Buffers are held
+ * in the caches only while this is positive so that throttled allocations
+ * taken from a cache can never use the reserve.
+ */
+
+#if CONFIG_IOB_THROTTLE > 0
+#  define IOB_CACHE_NAVAIL() (g_throttle_sem.semcount)
+#else
+#  define IOB_CACHE_NAVAIL() (g_iob_sem.semcount)
+#endif
+
+/* The lock under which the semaphore counts are modified.  It must be held
+ * from the time that IOB_CACHE_NAVAIL() is sampled until the buffer is in
+ * the cache.  Otherwise a thread could find the caches empty and start
+ * waiting between the two steps, leaving the buffer idle in the cache.
+ * Both locks also disable local interrupts.
+ */
+
+#ifdef HAVE_SEM_COUNTLOCK
+#  define iob_navail_lock()    nxsem_countlock()
+#  define iob_navail_unlock(f) nxsem_countunlock(f)
+#else
+#  define iob_navail_lock()    enter_critical_section()
+#  define iob_navail_unlock(f) leave_critical_section(f)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The I/O buffer cache of one CPU.  The buffers in the cache are not
+ * counted by g_iob_sem or g_throttle_sem:  From the point of view of the
+ * free list, they are allocated.  The cache is normally only accessed by
+ * its own CPU; the spinlock protects it from iob_cache_drain() running on
+ * another CPU.
+ */
+
+struct iob_cache_s
+{
+  FAR struct iob_s *ic_head;    /* List of cached free buffers */
+  uint8_t ic_count;             /* Number of buffers in the list */
+  volatile spinlock_t ic_lock;  /* Protects the cache from other CPUs */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty and enough buffers are free.
+ *   The returned buffer is not initialized.  Returns NULL if no buffer
+ *   could be taken.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  irqstate_t cflags;
+  int n;
+
+  /* Try the cache of this CPU.  Disabling local interrupts keeps us on
+   * this CPU; the spinlock is only contended by iob_cache_drain().
+   */
+
+  flags = up_irq_save();
+  cache = IOB_THIS_CACHE();
+  spin_lock(&cache->ic_lock);
+
+  iob = cache->ic_head;
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
+  /* The cache is empty.  Move a batch of buffers from the free list into
+   * the cache, provided that they can be spared.  This is the only place
+   * where the global critical section is entered on the allocation path.
+   */
+
+  flags = enter_critical_section();
+
+  if (IOB_CACHE_NAVAIL() >= CONFIG_IOB_PERCPU_BATCH)
+    {
+      /* The critical section also disables local interrupts, so 'cache'
+       * still refers to the cache of this CPU.
+       */
+
+      cache = IOB_THIS_CACHE();
+      spin_lock(&cache->ic_lock);
+
+      for (n = 0;
+           n < CONFIG_IOB_PERCPU_BATCH && g_iob_freelist != NULL &&
+           cache->ic_count < CONFIG_IOB_PERCPU_DEPTH;
+           n++)
+        {
+          iob            = g_iob_freelist;
+          g_iob_freelist = iob->io_flink;
+
+          iob->io_flink  = cache->ic_head;
+          cache->ic_head = iob;
+          cache->ic_count++;
+        }
+
+      /* Then take one buffer from the refilled cache */
+
+      iob = cache->ic_head;
+      if (iob != NULL)
+        {
+          cache->ic_head = iob->io_flink;
+          cache->ic_count--;
+        }
+
+      spin_unlock(&cache->ic_lock);
+
+      /* Take the semaphore counts for the whole batch.  As in
+       * iob_tryalloc(), there are at least 'n' free buffers so a simple
+       * decrement suffices.
+       */
+
+      cflags = nxsem_countlock();
+      g_iob_sem.semcount -= n;
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
+#if CONFIG_IOB_THROTTLE > 0
+      g_throttle_sem.semcount -= n;
+#endif
+      nxsem_countunlock(cflags);
+    }
+
+  leave_critical_section(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Try to add a freed I/O buffer to the cache of the current CPU.  Returns
+ *   true if the buffer was cached.  Otherwise, the caller must return the
+ *   buffer to the free list together with any buffers that were removed
+ *   from the cache and returned in 'flush'.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob, FAR struct iob_s **flush)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  bool cached = false;
+  int n;
+
+  *flush = NULL;
+
+  /* Sample the semaphore counts and update the cache under the same lock
+   * as the counts are modified.  A thread that starts waiting for a buffer
+   * then either sees this buffer in the cache (and drains it) or has already
+   * made the count non-positive, in which case the cache is flushed here.
+   */
+
+  flags = iob_navail_lock();
+  cache = IOB_THIS_CACHE();
+  spin_lock(&cache->ic_lock);
+
+  if (IOB_CACHE_NAVAIL() > 0)
+    {
+      /* Buffers are plentiful and nobody is waiting.  Cache the buffer if
+       * there is space.
+       */
+
+      if (cache->ic_count < CONFIG_IOB_PERCPU_DEPTH)
+        {
+          iob->io_flink  = cache->ic_head;
+          cache->ic_head = iob;
+          cache->ic_count++;
+          cached         = true;
+        }
+      else
+        {
+          /* The cache is full.  Return a batch to the free list along with
+           * this buffer.
+           */
+
+          for (n = 0; n < CONFIG_IOB_PERCPU_BATCH; n++)
+            {
+              next           = cache->ic_head;
+              cache->ic_head = next->io_flink;
+              next->io_flink = *flush;
+              *flush         = next;
+            }
+
+          cache->ic_count -= CONFIG_IOB_PERCPU_BATCH;
+        }
+    }
+  else
+    {
+      /* Buffers are short or some thread is waiting for one.  Return the
+       * whole cache to the free list so that the waiters can be served.
+       */
+
+      *flush          = cache->ic_head;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  iob_navail_unlock(flags);
+  return cached;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers in the caches of all CPUs to the free list (or to
+ *   the committed list if a thread is waiting).  Called before a thread
+ *   waits for a buffer so that no buffer is left idle in a cache.
+ *
+ * Assumptions:
+ *   Called from within the critical section.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *flush;
+  FAR struct iob_s *iob;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* Detach the list under the spinlock of the cache.  The buffers are
+       * released afterwards because iob_release() takes the semaphore
+       * count lock, which iob_cache_free() takes before the spinlock.
+       */
+
+      cache = &g_iob_cache[cpu];
+      spin_lock(&cache->ic_lock);
+
+      flush           = cache->ic_head;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+
+      spin_unlock(&cache->ic_lock);
+
+      while (flush != NULL)
+        {
+          iob   = flush;
+          flush = iob->io_flink;
+          iob_release(iob);
+        }
+    }
+}
+
+#endif /* CONFIG_IOB_PERCPU */
@@ -148,7 +148,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
               /* Yes.. We can extend this buffer to the up to the very end. */
 
-              maxlen = CONFIG_IOB_BUFSIZE - iob->io_offset;
+              maxlen = IOB_BUFSIZE(iob) - iob->io_offset;
 
               /* This is the new buffer length that we need.  Of course,
                * clipped to the maximum possible size in this buffer.
@@ -196,7 +196,8 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
+          /* Yes.. allocate a new buffer, sized for the remaining data if
+           * there are pools of different buffer sizes.
            *
            * Copy as many bytes as possible.  If we have successfully copied
            * any already don't block, otherwise block if we're allowed.
@@ -204,11 +205,11 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
           if (!can_block || len < total)
             {
-              next = iob_tryalloc(throttled);
+              next = iob_tryalloc_size(len, throttled);
             }
           else
             {
-              next = iob_alloc(throttled);
+              next = iob_alloc_size(len, throttled);
             }
 
           if (next == NULL)
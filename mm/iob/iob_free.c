@@ -53,6 +53,48 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the free list or to the committed list.
+ *
+ * Assumptions:
+ *   Called from within the critical section.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob)
+{
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()).
+   */
+
+  if (g_iob_sem.semcount < 0)
+    {
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+    }
+  else
+    {
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+    }
+
+  /* Signal that an IOB is available.  If there is a thread waiting
+   * for an IOB, this will wake up exactly one thread.  The semaphore
+   * count will correctly indicated that the awakened task owns an
+   * IOB and should find it in the committed list.
+   */
+
+  nxsem_post(&g_iob_sem);
+#if CONFIG_IOB_THROTTLE > 0
+  nxsem_post(&g_throttle_sem);
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -65,6 +107,9 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
+#ifdef CONFIG_IOB_PERCPU
+  FAR struct iob_s *flush;
+#endif
   irqstate_t flags;
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
@@ -101,6 +146,25 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
               next, next->io_pktlen, next->io_len);
     }
 
+#ifdef HAVE_IOB_POOLS
+  /* Small and large buffers go back to their own pools */
+
+  if (iob->io_bufsize != CONFIG_IOB_BUFSIZE)
+    {
+      iob_pool_free(iob);
+      return next;
+    }
+#endif
+
+#ifdef CONFIG_IOB_PERCPU
+  /* Keep the buffer in the cache of this CPU if possible */
+
+  if (iob_cache_free(iob, &flush))
+    {
+      return next;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -108,34 +172,19 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
    */
 
   flags = enter_critical_section();
+  iob_release(iob);
 
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()).
-   */
+#ifdef CONFIG_IOB_PERCPU
+  /* Also return any buffers that were removed from the cache */
 
-  if (g_iob_sem.semcount < 0)
+  while (flush != NULL)
     {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
+      iob   = flush;
+      flush = iob->io_flink;
+      iob_release(iob);
     }
-  else
-    {
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-    }
-
-  /* Signal that an IOB is available.  If there is a thread waiting
-   * for an IOB, this will wake up exactly one thread.  The semaphore
-   * count will correctly indicated that the awakened task owns an
-   * IOB and should find it in the committed list.
-   */
-
-  nxsem_post(&g_iob_sem);
-#if CONFIG_IOB_THROTTLE > 0
-  nxsem_post(&g_throttle_sem);
 #endif
+
   leave_critical_section(flags);
 
   /* And return the I/O buffer after the one that was freed */
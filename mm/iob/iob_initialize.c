@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <nuttx/semaphore.h>
@@ -54,6 +55,13 @@
 #  define NULL ((FAR void *)0)
 #endif
 
+/* When there are multiple pools, the payload is held in separate storage.
+ * It is allocated in 32-bit words to keep the alignment of the original
+ * io_data[] array.
+ */
+
+#define IOB_NWORDS(s)  (((s) + 3) >> 2)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -65,6 +73,25 @@ static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
 
+#ifdef HAVE_IOB_POOLS
+/* Payload storage of the buffers of each pool */
+
+static uint32_t g_iob_data[CONFIG_IOB_NBUFFERS]
+                          [IOB_NWORDS(CONFIG_IOB_BUFSIZE)];
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+static struct iob_s        g_iob_smallpool[CONFIG_IOB_SMALL_NBUFFERS];
+static uint32_t g_iob_smalldata[CONFIG_IOB_SMALL_NBUFFERS]
+                               [IOB_NWORDS(CONFIG_IOB_SMALL_BUFSIZE)];
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static struct iob_s        g_iob_largepool[CONFIG_IOB_LARGE_NBUFFERS];
+static uint32_t g_iob_largedata[CONFIG_IOB_LARGE_NBUFFERS]
+                               [IOB_NWORDS(CONFIG_IOB_LARGE_BUFSIZE)];
+#endif
+#endif /* HAVE_IOB_POOLS */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -77,6 +104,20 @@ FAR struct iob_s *g_iob_freelist;
 
 FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* A list of all free, unallocated small I/O buffers */
+
+FAR struct iob_s *g_iob_smallfree;
+int g_iob_smallnfree;       /* Number of buffers in the list */
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+FAR struct iob_s *g_iob_largefree;
+int g_iob_largenfree;       /* Number of buffers in the list */
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -124,12 +165,49 @@ void iob_initialize(void)
         {
           FAR struct iob_s *iob = &g_iob_pool[i];
 
+#ifdef HAVE_IOB_POOLS
+          iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+          iob->io_data    = (FAR uint8_t *)g_iob_data[i];
+#endif
+
           /* Add the pre-allocate I/O buffer to the head of the free list */
 
           iob->io_flink  = g_iob_freelist;
           g_iob_freelist = iob;
         }
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+      /* Add each small I/O buffer to the small buffer free list */
+
+      for (i = 0; i < CONFIG_IOB_SMALL_NBUFFERS; i++)
+        {
+          FAR struct iob_s *iob = &g_iob_smallpool[i];
+
+          iob->io_bufsize = CONFIG_IOB_SMALL_BUFSIZE;
+          iob->io_data    = (FAR uint8_t *)g_iob_smalldata[i];
+          iob->io_flink   = g_iob_smallfree;
+          g_iob_smallfree = iob;
+        }
+
+      g_iob_smallnfree = CONFIG_IOB_SMALL_NBUFFERS;
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      /* Add each large I/O buffer to the large buffer free list */
+
+      for (i = 0; i < CONFIG_IOB_LARGE_NBUFFERS; i++)
+        {
+          FAR struct iob_s *iob = &g_iob_largepool[i];
+
+          iob->io_bufsize = CONFIG_IOB_LARGE_BUFSIZE;
+          iob->io_data    = (FAR uint8_t *)g_iob_largedata[i];
+          iob->io_flink   = g_iob_largefree;
+          g_iob_largefree = iob;
+        }
+
+      g_iob_largenfree = CONFIG_IOB_LARGE_NBUFFERS;
+#endif
+
       g_iob_committed = NULL;
 
       nxsem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
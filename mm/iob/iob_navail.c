@@ -0,0 +1,127 @@
+/****************************************************************************
+ * mm/iob/iob_navail.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_navail
+ *
+ * Description:
+ *   Return the number of available IOBs.  If 'throttled' is true, then
+ *   the IOBs reserved by CONFIG_IOB_THROTTLE are not counted:  That is the
+ *   the number of IOBs that a throttled allocation could get without
+ *   waiting.  The count is only a snapshot and may change at any time.
+ *
+ ****************************************************************************/
+
+int iob_navail(bool throttled)
+{
+  int navail = 0;
+  int ret;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Only the throttled count is of interest? */
+
+  if (throttled)
+    {
+      ret = nxsem_getvalue(&g_throttle_sem, &navail);
+    }
+  else
+#endif
+    {
+      ret = nxsem_getvalue(&g_iob_sem, &navail);
+    }
+
+  /* A negative count means that there are threads waiting for an IOB */
+
+  if (ret < 0 || navail < 0)
+    {
+      navail = 0;
+    }
+
+  return navail;
+}
+
+/****************************************************************************
+ * Name: iob_navail_size
+ *
+ * Description:
+ *   Return the number of bytes of free buffer space that iob_alloc_size()
+ *   and iob_copyin() can use for packets of 'size' bytes:  The free buffers
+ *   of the pool that is the best fit for 'size' plus the available
+ *   CONFIG_IOB_BUFSIZE buffers that they fall back to (as counted by
+ *   iob_navail()).  The count is only a snapshot.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IOB_POOLS
+uint32_t iob_navail_size(unsigned int size, bool throttled)
+{
+  uint32_t nbytes = (uint32_t)iob_navail(throttled) * CONFIG_IOB_BUFSIZE;
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE)
+    {
+      nbytes += (uint32_t)g_iob_smallnfree * CONFIG_IOB_SMALL_BUFSIZE;
+    }
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      nbytes += (uint32_t)g_iob_largenfree * CONFIG_IOB_LARGE_BUFSIZE;
+    }
+#endif
+
+  return nbytes;
+}
+#endif
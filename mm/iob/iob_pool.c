@@ -0,0 +1,221 @@
+/****************************************************************************
+ * mm/iob/iob_pool.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef HAVE_IOB_POOLS
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_pool_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the head of the free list 'freelist' of the
+ *   pool of small or of large buffers and decrement its count 'nfree'.
+ *   These pools are not counted by semaphores:  Allocations never wait for
+ *   them and are not throttled.  Callers fall back to the pool of
+ *   CONFIG_IOB_BUFSIZE buffers instead.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_pool_alloc(FAR struct iob_s **freelist,
+                                        FAR int *nfree)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  iob = *freelist;
+  if (iob != NULL)
+    {
+      *freelist = iob->io_flink;
+      (*nfree)--;
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_pool_select
+ *
+ * Description:
+ *   Try to take a buffer for 'size' bytes from the pool of small or of
+ *   large buffers.  Returns NULL if a buffer of CONFIG_IOB_BUFSIZE bytes is
+ *   the best fit or if the selected pool is empty.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_pool_select(unsigned int size)
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE)
+    {
+      return iob_pool_alloc(&g_iob_smallfree, &g_iob_smallnfree);
+    }
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      return iob_pool_alloc(&g_iob_largefree, &g_iob_largenfree);
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer for 'size' bytes of data.  The buffer is taken
+ *   from the pool of small or of large I/O buffers if that is the best fit
+ *   for 'size' and a buffer is available in that pool.  Otherwise, this is
+ *   equivalent to iob_alloc().  The returned buffer may hold less than
+ *   'size' bytes:  Use IOB_BUFSIZE() or iob_copyin() to extend the chain.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_pool_select(size);
+  if (iob == NULL)
+    {
+      iob = iob_alloc(throttled);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Like iob_alloc_size() but without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_pool_select(size);
+  if (iob == NULL)
+    {
+      iob = iob_tryalloc(throttled);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_pool_free
+ *
+ * Description:
+ *   Return an I/O buffer to the pool of small or of large buffers that it
+ *   was allocated from.
+ *
+ ****************************************************************************/
+
+void iob_pool_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s **freelist;
+  FAR int *nfree;
+  irqstate_t flags;
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0 && CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (iob->io_bufsize == CONFIG_IOB_SMALL_BUFSIZE)
+    {
+      freelist = &g_iob_smallfree;
+      nfree    = &g_iob_smallnfree;
+    }
+  else
+    {
+      freelist = &g_iob_largefree;
+      nfree    = &g_iob_largenfree;
+    }
+#elif CONFIG_IOB_SMALL_NBUFFERS > 0
+  freelist = &g_iob_smallfree;
+  nfree    = &g_iob_smallnfree;
+#else
+  freelist = &g_iob_largefree;
+  nfree    = &g_iob_largenfree;
+#endif
+
+  DEBUGASSERT(iob->io_bufsize != CONFIG_IOB_BUFSIZE);
+
+  flags = enter_critical_section();
+  iob->io_flink = *freelist;
+  *freelist     = iob;
+  (*nfree)++;
+  leave_critical_section(flags);
+}
+
+#endif /* HAVE_IOB_POOLS */
@@ -63,7 +63,7 @@
 
 FAR void *kmm_malloc(size_t size)
 {
-  return mm_malloc(&g_kmmheap, size);
+  return mm_malloc_caller(&g_kmmheap, size, MM_RETURN_ADDRESS());
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -66,7 +66,8 @@
 
 FAR void *kmm_memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(&g_kmmheap, alignment, size);
+  return mm_memalign_caller(&g_kmmheap, alignment, size,
+                            MM_RETURN_ADDRESS());
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
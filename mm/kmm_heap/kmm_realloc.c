@@ -64,7 +64,8 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
-  return mm_realloc(&g_kmmheap, oldmem, newsize);
+  return mm_realloc_caller(&g_kmmheap, oldmem, newsize,
+                           MM_RETURN_ADDRESS());
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -0,0 +1,90 @@
+/****************************************************************************
+ * mm/mempool/mempool.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_MEMPOOL_MEMPOOL_H
+#define __MM_MEMPOOL_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/mempool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Object pools hold kernel objects.  They are not available in the user
+ * space memory manager of protected and kernel builds.
+ */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+#  define HAVE_MEMPOOL 1
+#endif
+
+/* Each pool is protected by its own subsystem lock if subsystem locks are
+ * enabled.  Otherwise, the pool is protected by the critical section.  In
+ * either case, the pool may be accessed from interrupt handlers.
+ */
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+#  define mempool_lock(p)      subsys_lock(&(p)->mp_lock)
+#  define mempool_unlock(p,f)  subsys_unlock(&(p)->mp_lock, (f))
+#else
+#  define mempool_lock(p)      enter_critical_section()
+#  define mempool_unlock(p,f)  leave_critical_section(f)
+#endif
+
+/* Objects are aligned to the size of a pointer so that the free list link
+ * may be stored in the first word of each object.
+ */
+
+#define MEMPOOL_ALIGN          sizeof(FAR void *)
+#define MEMPOOL_ALIGN_UP(s)    (((s) + MEMPOOL_ALIGN - 1) & ~(MEMPOOL_ALIGN - 1))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef HAVE_MEMPOOL
+/* The list of all pools, in the order in which they were initialized */
+
+extern FAR struct mempool_s *g_mempools;
+#endif
+
+#endif /* __MM_MEMPOOL_MEMPOOL_H */
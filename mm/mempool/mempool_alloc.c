@@ -0,0 +1,133 @@
+/****************************************************************************
+ * mm/mempool/mempool_alloc.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool/mempool.h"
+
+#ifdef HAVE_MEMPOOL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_take
+ *
+ * Description:
+ *   Take one object from the pool.  If 'countfail' is true, then an empty
+ *   pool is counted as a failed allocation.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_take(FAR struct mempool_s *pool, bool countfail)
+{
+  FAR void *obj = NULL;
+  irqstate_t flags;
+  uint16_t nused;
+
+  DEBUGASSERT(pool != NULL);
+
+  flags = mempool_lock(pool);
+
+  if (pool->mp_nfree > pool->mp_reserve || up_interrupt_context())
+    {
+      obj = sq_remfirst(&pool->mp_freelist);
+    }
+
+  if (obj != NULL)
+    {
+      DEBUGASSERT(pool->mp_nfree > 0);
+      pool->mp_nfree--;
+      pool->mp_nalloc++;
+
+      nused = pool->mp_nobjs - pool->mp_nfree;
+      if (nused > pool->mp_maxused)
+        {
+          pool->mp_maxused = nused;
+        }
+    }
+  else if (countfail)
+    {
+      pool->mp_nfail++;
+    }
+
+  mempool_unlock(pool, flags);
+  return obj;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Take one object from the pool.  Outside of interrupt handlers, the
+ *   reserved objects are not used.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  return mempool_take(pool, true);
+}
+
+/****************************************************************************
+ * Name: mempool_tryalloc
+ *
+ * Description:
+ *   Like mempool_alloc(), but an empty pool is not counted as a failed
+ *   allocation.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_tryalloc(FAR struct mempool_s *pool)
+{
+  return mempool_take(pool, false);
+}
+
+#endif /* HAVE_MEMPOOL */
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * mm/mempool/mempool_initialize.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool/mempool.h"
+
+#ifdef HAVE_MEMPOOL
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of all pools, in the order in which they were initialized */
+
+FAR struct mempool_s *g_mempools;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Set up a pool of 'nobjs' objects of size 'objsize'.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       FAR void *storage, size_t objsize, uint16_t nobjs,
+                       uint16_t reserve, mempool_ctor_t ctor,
+                       FAR void *arg)
+{
+  FAR struct mempool_s **next;
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && objsize >= sizeof(sq_entry_t));
+
+  memset(pool, 0, sizeof(struct mempool_s));
+  sq_init(&pool->mp_freelist);
+
+  pool->mp_name    = name;
+  pool->mp_ctor    = ctor;
+  pool->mp_arg     = arg;
+  pool->mp_objsize = MEMPOOL_ALIGN_UP(objsize);
+  pool->mp_reserve = reserve;
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+  spin_initialize(&pool->mp_lock.sl_lock, SP_UNLOCKED);
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+  pool->mp_lock.sl_name = name;
+#endif
+#endif
+
+  /* Add the pool to the end of the list of all pools */
+
+  flags = enter_critical_section();
+  for (next = &g_mempools; *next != NULL; next = &(*next)->mp_next)
+    {
+      DEBUGASSERT(*next != pool);
+    }
+
+  *next = pool;
+  leave_critical_section(flags);
+
+  return nobjs > 0 ? mempool_extend(pool, storage, nobjs) : OK;
+}
+
+/****************************************************************************
+ * Name: mempool_extend
+ *
+ * Description:
+ *   Add 'nobjs' objects to an initialized pool.
+ *
+ ****************************************************************************/
+
+int mempool_extend(FAR struct mempool_s *pool, FAR void *storage,
+                   uint16_t nobjs)
+{
+  FAR uint8_t *obj;
+  sq_queue_t newobjs;
+  irqstate_t flags;
+  uint16_t i;
+
+  DEBUGASSERT(pool != NULL && nobjs > 0);
+
+  if ((uint32_t)pool->mp_nobjs + nobjs > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (storage == NULL)
+    {
+      storage = kmm_malloc(pool->mp_objsize * nobjs);
+      if (storage == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* Construct the new objects before they are visible in the pool */
+
+  sq_init(&newobjs);
+  for (i = 0, obj = (FAR uint8_t *)storage;
+       i < nobjs;
+       i++, obj += pool->mp_objsize)
+    {
+      if (pool->mp_ctor != NULL)
+        {
+          pool->mp_ctor(obj, pool->mp_arg);
+        }
+
+      sq_addlast((FAR sq_entry_t *)obj, &newobjs);
+    }
+
+  flags = mempool_lock(pool);
+  sq_cat(&newobjs, &pool->mp_freelist);
+  pool->mp_nobjs += nobjs;
+  pool->mp_nfree += nobjs;
+  mempool_unlock(pool, flags);
+
+  return OK;
+}
+
+#endif /* HAVE_MEMPOOL */
@@ -56,8 +56,11 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_GATSUMMARY(n) \
+  SIZEOF_GAT(SIZEOF_GAT(n))
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + sizeof(uint32_t) * \
+   (SIZEOF_GAT(n) + 2 * SIZEOF_GATSUMMARY(n) - 1))
 
 /* Debug */
 
@@ -99,6 +102,14 @@ struct gran_s
   sem_t      exclsem;   /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+
+  /* Summaries of the GAT with one bit per GAT entry.  A bit is set in
+   * gatfull[] if all 32 granules of the entry are allocated and in
+   * gatempty[] if none is allocated.  Both follow gat[] in memory.
+   */
+
+  FAR uint32_t *gatfull;
+  FAR uint32_t *gatempty;
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
@@ -142,4 +153,23 @@ void gran_leave_critical(FAR struct gran_s *priv);
 void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                          unsigned int ngranules);
 
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of granules as free.
+ *
+ * Input Parameters:
+ *   priv  - The granule heap state structure.
+ *   alloc - The address of the allocation.
+ *   ngranules - The number of granules to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, uintptr_t alloc,
+                    unsigned int ngranules);
+
 #endif /* __MM_MM_GRAN_MM_GRAN_H */
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <strings.h>
 #include <assert.h>
 
 #include <nuttx/mm/gran.h>
@@ -47,6 +48,138 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_next_clear
+ *
+ * Description:
+ *   Return the index of the first clear bit at or after 'start' in the
+ *   bitmap 'map' of 'nbits' bits, or 'nbits' if there is none.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_next_clear(FAR const uint32_t *map,
+                                    unsigned int start, unsigned int nbits)
+{
+  unsigned int nwords = SIZEOF_GAT(nbits);
+  unsigned int idx;
+  uint32_t bits;
+
+  if (start >= nbits)
+    {
+      return nbits;
+    }
+
+  idx  = start >> 5;
+  bits = ~map[idx] & (0xffffffff << (start & 31));
+
+  while (bits == 0)
+    {
+      if (++idx >= nwords)
+        {
+          return nbits;
+        }
+
+      bits = ~map[idx];
+    }
+
+  start = (idx << 5) + ffs((int)bits) - 1;
+  return start < nbits ? start : nbits;
+}
+
+/****************************************************************************
+ * Name: gran_find_free
+ *
+ * Description:
+ *   Return the number of the first free granule at or after 'granno', or
+ *   the number of granules in the heap if there is none.  GAT entries in
+ *   which all granules are allocated are skipped using the gatfull[]
+ *   summary.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_find_free(FAR struct gran_s *priv,
+                                   unsigned int granno)
+{
+  unsigned int gatidx;
+  uint32_t bits;
+
+  if (granno >= priv->ngranules)
+    {
+      return priv->ngranules;
+    }
+
+  /* Check the remainder of the GAT entry containing 'granno' */
+
+  gatidx = granno >> 5;
+  bits   = ~priv->gat[gatidx] & (0xffffffff << (granno & 31));
+
+  if (bits == 0)
+    {
+      /* Find the next GAT entry that is not full */
+
+      gatidx = gran_next_clear(priv->gatfull, gatidx + 1,
+                               SIZEOF_GAT(priv->ngranules));
+      if (gatidx >= SIZEOF_GAT(priv->ngranules))
+        {
+          return priv->ngranules;
+        }
+
+      bits = ~priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + ffs((int)bits) - 1;
+  return granno < priv->ngranules ? granno : priv->ngranules;
+}
+
+/****************************************************************************
+ * Name: gran_find_allocated
+ *
+ * Description:
+ *   Return the number of the first allocated granule at or after 'granno',
+ *   or the number of granules in the heap if there is none.  GAT entries
+ *   in which no granule is allocated are skipped using the gatempty[]
+ *   summary.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_find_allocated(FAR struct gran_s *priv,
+                                        unsigned int granno)
+{
+  unsigned int gatidx;
+  uint32_t bits;
+
+  if (granno >= priv->ngranules)
+    {
+      return priv->ngranules;
+    }
+
+  /* Check the remainder of the GAT entry containing 'granno' */
+
+  gatidx = granno >> 5;
+  bits   = priv->gat[gatidx] & (0xffffffff << (granno & 31));
+
+  if (bits == 0)
+    {
+      /* Find the next GAT entry that is not empty */
+
+      gatidx = gran_next_clear(priv->gatempty, gatidx + 1,
+                               SIZEOF_GAT(priv->ngranules));
+      if (gatidx >= SIZEOF_GAT(priv->ngranules))
+        {
+          return priv->ngranules;
+        }
+
+      bits = priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + ffs((int)bits) - 1;
+  return granno < priv->ngranules ? granno : priv->ngranules;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,9 +190,10 @@
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   A run of free granules of the required length is located using
+ *   summary bitmaps of the granule allocation table, so full and empty
+ *   regions of the table are skipped without examining them granule by
+ *   granule.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -75,17 +209,12 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
 {
   FAR struct gran_s *priv = (FAR struct gran_s *)handle;
   unsigned int ngranules;
+  unsigned int start;
+  unsigned int end;
   size_t       tmpmask;
   uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
 
-  DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv != NULL);
 
   if (priv != NULL && size > 0)
     {
@@ -98,153 +227,28 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
       tmpmask   = (1 << priv->log2gran) - 1;
       ngranules = (size + tmpmask) >> priv->log2gran;
 
-      /* Then create mask for that number of granules */
-
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
-
-      /* Now search the granule allocation table for that number of contiguous */
+      /* Now search the granule allocation table for that number of
+       * contiguous free granules.  Each pass finds the start of the next
+       * free run and then the end of that run, so the cost depends on the
+       * number of runs and not on their lengths.
+       */
 
-      alloc = priv->heapstart;
-
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      for (start = gran_find_free(priv, 0);
+           start + ngranules <= priv->ngranules;
+           start = gran_find_free(priv, end))
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
-
-          if (curr == 0xffffffff)
-            {
-              alloc += (32 << priv->log2gran);
-              continue;
-            }
-
-          /* Get the next entry from the GAT to support a 64 bit shift */
-
-          if (granidx < priv->ngranules)
+          end = gran_find_allocated(priv, start);
+          if (end - start >= ngranules)
             {
-              next = priv->gat[gatidx + 1];
-            }
+              /* Found it.. mark these granules allocated */
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
+              alloc = priv->heapstart + ((uintptr_t)start << priv->log2gran);
+              gran_mark_allocated(priv, alloc, ngranules);
 
-          else
-            {
-              next = 0xffffffff;
-            }
+              /* And return the allocation address */
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          for (bitidx = 0;
-               bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Check if we have the allocation at this bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
+              gran_leave_critical(priv);
+              return (FAR void *)alloc;
             }
         }
 
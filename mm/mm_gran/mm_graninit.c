@@ -84,10 +84,6 @@
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
@@ -115,6 +111,7 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
   unsigned int       mask;
   unsigned int       alignedsize;
   unsigned int       ngranules;
+  unsigned int       i;
 
   /* Check parameters if debug is on.  Note the size of a granule is
    * limited to 2**31 bytes and that the size of the granule must be greater
@@ -150,6 +147,18 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
       priv->ngranules = ngranules;
       priv->heapstart = alignedstart;
 
+      /* The GAT summaries follow the GAT.  Initially every GAT entry is
+       * empty.
+       */
+
+      priv->gatfull   = &priv->gat[SIZEOF_GAT(ngranules)];
+      priv->gatempty  = &priv->gatfull[SIZEOF_GATSUMMARY(ngranules)];
+
+      for (i = 0; i < SIZEOF_GAT(ngranules); i++)
+        {
+          priv->gatempty[i >> 5] |= (uint32_t)1 << (i & 31);
+        }
+
       /* Initialize mutual exclusion support */
 
 #ifndef CONFIG_GRAN_INTR
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <assert.h>
 
 #include <nuttx/mm/gran.h>
@@ -48,77 +49,150 @@
 #ifdef CONFIG_GRAN
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: gran_mark_allocated
+ * Name: gran_update_summary
  *
  * Description:
- *   Mark a range of granules as allocated.
+ *   Update the summary bits of GAT entry 'gatidx' after the entry has been
+ *   modified.
  *
- * Input Parameters:
- *   priv  - The granule heap state structure.
- *   alloc - The address of the allocation.
- *   ngranules - The number of granules allocated
+ ****************************************************************************/
+
+static inline void gran_update_summary(FAR struct gran_s *priv,
+                                       unsigned int gatidx)
+{
+  uint32_t value = priv->gat[gatidx];
+  unsigned int sumidx = gatidx >> 5;
+  uint32_t sumbit = (uint32_t)1 << (gatidx & 31);
+
+  if (value == 0xffffffff)
+    {
+      priv->gatfull[sumidx] |= sumbit;
+    }
+  else
+    {
+      priv->gatfull[sumidx] &= ~sumbit;
+    }
+
+  if (value == 0)
+    {
+      priv->gatempty[sumidx] |= sumbit;
+    }
+  else
+    {
+      priv->gatempty[sumidx] &= ~sumbit;
+    }
+}
+
+/****************************************************************************
+ * Name: gran_mark
  *
- * Returned Value:
- *   None
+ * Description:
+ *   Set or clear the GAT bits of a range of granules of any length and
+ *   update the GAT summaries.
  *
  ****************************************************************************/
 
-void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
-                         unsigned int ngranules)
+static void gran_mark(FAR struct gran_s *priv, uintptr_t alloc,
+                      unsigned int ngranules, bool allocated)
 {
   unsigned int granno;
   unsigned int gatidx;
   unsigned int gatbit;
-  unsigned int avail;
+  unsigned int nbits;
   uint32_t     gatmask;
 
   /* Determine the granule number of the allocation */
 
   granno = (alloc - priv->heapstart) >> priv->log2gran;
+  DEBUGASSERT(granno + ngranules <= priv->ngranules);
 
   /* Determine the GAT table index associated with the allocation */
 
   gatidx = granno >> 5;
   gatbit = granno & 31;
 
-  /* Mark bits in the GAT entry or entries */
+  /* Mark bits in each GAT entry spanned by the range */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Mark bits in the first GAT entry */
-
-      gatmask = 0xffffffff << gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
-      priv->gat[gatidx] |= gatmask;
-      ngranules -= avail;
+      nbits = 32 - gatbit;
+      if (nbits > ngranules)
+        {
+          nbits = ngranules;
+        }
 
-      /* Mark bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == 0);
+      gatmask   = 0xffffffff >> (32 - nbits);
+      gatmask <<= gatbit;
 
-      priv->gat[gatidx+1] |= gatmask;
+      if (allocated)
+        {
+          DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
+          priv->gat[gatidx] |= gatmask;
+        }
+      else
+        {
+          DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
+          priv->gat[gatidx] &= ~gatmask;
+        }
+
+      gran_update_summary(priv, gatidx);
+
+      ngranules -= nbits;
+      gatidx++;
+      gatbit     = 0;
     }
+}
 
-  /* Handle the case where where all of the granules come from one entry */
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  else
-    {
-      /* Mark bits in a single GAT entry */
+/****************************************************************************
+ * Name: gran_mark_allocated
+ *
+ * Description:
+ *   Mark a range of granules as allocated.
+ *
+ * Input Parameters:
+ *   priv  - The granule heap state structure.
+ *   alloc - The address of the allocation.
+ *   ngranules - The number of granules allocated
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
+void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
+                         unsigned int ngranules)
+{
+  gran_mark(priv, alloc, ngranules, true);
+}
 
-      priv->gat[gatidx] |= gatmask;
-      return;
-    }
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of granules as free.
+ *
+ * Input Parameters:
+ *   priv  - The granule heap state structure.
+ *   alloc - The address of the allocation.
+ *   ngranules - The number of granules to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, uintptr_t alloc,
+                    unsigned int ngranules)
+{
+  gran_mark(priv, alloc, ngranules, false);
 }
 
 #endif /* CONFIG_GRAN */
@@ -0,0 +1,349 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The cache of the CPU that we are executing on.  Interrupts must be
+ * disabled on this CPU so that we cannot be moved to another CPU while the
+ * cache is being accessed.
+ */
+
+#ifdef CONFIG_SMP
+#  define MM_THIS_CACHE(h)   (&(h)->mm_cache[up_cpu_index()])
+#else
+#  define MM_THIS_CACHE(h)   (&(h)->mm_cache[0])
+#endif
+
+/* Free chunks are linked through the first pointer of the user data */
+
+#define MM_CACHE_NEXT(m)     (*(FAR void **)(m))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_class
+ *
+ * Description:
+ *   Return the cache size class of a chunk size or -1 if chunks of that
+ *   size are not cached.
+ *
+ ****************************************************************************/
+
+static inline int mm_cache_class(size_t alignsize)
+{
+  int ndx = MM_CACHE_CLASS(alignsize);
+  return (ndx >= 0 && ndx < CONFIG_MM_CACHE_NCLASSES) ? ndx : -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU allocation caches of a heap.
+ *
+ ****************************************************************************/
+
+void mm_cache_initialize(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+}
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Take a chunk of size 'alignsize' from the cache of this CPU.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if chunks of that size are not cached or
+ *   if the cache is empty.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *ret;
+  irqstate_t flags;
+  int ndx;
+
+  ndx = mm_cache_class(alignsize);
+  if (ndx < 0)
+    {
+      return NULL;
+    }
+
+  flags = up_irq_save();
+  cache = MM_THIS_CACHE(heap);
+
+  ret = cache->mc_head[ndx];
+  if (ret != NULL)
+    {
+      cache->mc_head[ndx] = MM_CACHE_NEXT(ret);
+      cache->mc_count[ndx]--;
+    }
+
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_refill
+ *
+ * Description:
+ *   Move a batch of chunks of size 'alignsize' from the heap into the cache
+ *   of this CPU.  Called after a cache miss.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+void mm_cache_refill(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *batch = NULL;
+  FAR void *mem;
+  irqstate_t flags;
+  int ndx;
+  int i;
+
+  ndx = mm_cache_class(alignsize);
+  if (ndx < 0)
+    {
+      return;
+    }
+
+  /* Allocate the batch from the heap */
+
+  for (i = 0; i < CONFIG_MM_CACHE_BATCH; i++)
+    {
+      mem = mm_allocchunk(heap, alignsize);
+      if (mem == NULL)
+        {
+          break;
+        }
+
+      MM_CACHE_NEXT(mem) = batch;
+      batch = mem;
+    }
+
+  /* Add the batch to the cache.  Other threads on this CPU may have
+   * refilled the cache in the meantime:  Any chunks that do not fit go
+   * back to the heap.
+   */
+
+  flags = up_irq_save();
+  cache = MM_THIS_CACHE(heap);
+
+  while (batch != NULL && cache->mc_count[ndx] < CONFIG_MM_CACHE_DEPTH)
+    {
+      mem   = batch;
+      batch = MM_CACHE_NEXT(mem);
+
+#ifdef CONFIG_MM_PROFILE
+      mm_profile_mark(mem, NULL);
+#endif
+      MM_CACHE_NEXT(mem)  = cache->mc_head[ndx];
+      cache->mc_head[ndx] = mem;
+      cache->mc_count[ndx]++;
+    }
+
+  up_irq_restore(flags);
+
+  while (batch != NULL)
+    {
+      mem   = batch;
+      batch = MM_CACHE_NEXT(mem);
+      mm_freechunk(heap, mem);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Return a chunk to the cache of this CPU.  If the cache is full, then a
+ *   batch of chunks is first returned from the cache to the heap.
+ *
+ * Returned Value:
+ *   True if the chunk was cached; false if chunks of that size are not
+ *   cached and the caller must return the chunk to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cache_s *cache;
+  FAR void *batch = NULL;
+  FAR void *next;
+  irqstate_t flags;
+  int ndx;
+  int i;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+  ndx = mm_cache_class(node->size);
+  if (ndx < 0)
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = MM_THIS_CACHE(heap);
+
+  /* If the cache is full, then detach a batch of chunks from it */
+
+  if (cache->mc_count[ndx] >= CONFIG_MM_CACHE_DEPTH)
+    {
+      for (i = 0; i < CONFIG_MM_CACHE_BATCH; i++)
+        {
+          next                = cache->mc_head[ndx];
+          cache->mc_head[ndx] = MM_CACHE_NEXT(next);
+          cache->mc_count[ndx]--;
+
+          MM_CACHE_NEXT(next) = batch;
+          batch               = next;
+        }
+    }
+
+  /* Add the chunk to the cache */
+
+#ifdef CONFIG_MM_PROFILE
+  mm_profile_mark(mem, NULL);
+#endif
+  MM_CACHE_NEXT(mem)  = cache->mc_head[ndx];
+  cache->mc_head[ndx] = mem;
+  cache->mc_count[ndx]++;
+
+  up_irq_restore(flags);
+
+  /* Return the detached batch to the heap under a single acquisition of
+   * the MM semaphore.
+   */
+
+  if (batch != NULL)
+    {
+      mm_takesemaphore(heap);
+
+      do
+        {
+          next = MM_CACHE_NEXT(batch);
+          mm_freechunk(heap, batch);
+          batch = next;
+        }
+      while (batch != NULL);
+
+      mm_givesemaphore(heap);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return all chunks in the cache of this CPU to the heap so that they
+ *   may be coalesced with neighboring free chunks.  The caches of other
+ *   CPUs are not affected.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+void mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *batch[CONFIG_MM_CACHE_NCLASSES];
+  FAR void *next;
+  irqstate_t flags;
+  int ndx;
+
+  /* Detach all of the cached chunks */
+
+  flags = up_irq_save();
+  cache = MM_THIS_CACHE(heap);
+
+  for (ndx = 0; ndx < CONFIG_MM_CACHE_NCLASSES; ndx++)
+    {
+      batch[ndx]           = cache->mc_head[ndx];
+      cache->mc_head[ndx]  = NULL;
+      cache->mc_count[ndx] = 0;
+    }
+
+  up_irq_restore(flags);
+
+  /* And return them to the heap */
+
+  for (ndx = 0; ndx < CONFIG_MM_CACHE_NCLASSES; ndx++)
+    {
+      while (batch[ndx] != NULL)
+        {
+          next = MM_CACHE_NEXT(batch[ndx]);
+          mm_freechunk(heap, batch[ndx]);
+          batch[ndx] = next;
+        }
+    }
+}
+
+#endif /* CONFIG_MM_CACHE */
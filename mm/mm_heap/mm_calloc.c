@@ -46,20 +46,33 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_calloc
+ * Name: mm_calloc and mm_calloc_caller
  *
  * Descriptor:
  *   mm_calloc() calculates the size of the allocation and calls mm_zalloc()
  *
+ *   mm_calloc_caller() is the same but records 'caller' as the
+ *   allocating call site (CONFIG_MM_PROFILE only).
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
+{
+  return mm_calloc_caller(heap, n, elem_size, MM_RETURN_ADDRESS());
+}
+
+FAR void *mm_calloc_caller(FAR struct mm_heap_s *heap, size_t n,
+                           size_t elem_size, FAR void *caller)
+#else
 FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
+#endif
 {
   FAR void *ret = NULL;
 
   if (n > 0 && elem_size > 0)
     {
-      ret = mm_zalloc(heap, n * elem_size);
+      ret = mm_zalloc_caller(heap, n * elem_size, caller);
     }
 
   return ret;
@@ -58,86 +58,42 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
  *  that chunk, save the remaining, smaller chunk (if any).
  *
- *  8-byte alignment of the allocated data is assured.
+ * Input Parameters:
+ *   heap      - The heap to allocate from
+ *   alignsize - The size of the chunk, including the chunk header and
+ *               aligned to MM_MIN_CHUNK
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if there is no chunk of that size.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
   void *ret = NULL;
-  int ndx;
 
-  /* Ignore zero-length allocations */
-
-  if (size < 1)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
-   */
-
-  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
-  /* Get the location in the node list to start the search. Special case
-   * really big allocations
-   */
-
-  if (alignsize >= MM_MAX_CHUNK)
-    {
-      ndx = MM_NNODES-1;
-    }
-  else
-    {
-      /* Convert the request size into a nodelist index */
-
-      ndx = mm_size2ndx(alignsize);
-    }
-
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
-
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < alignsize;
-       node = node->flink);
-
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that is must be best fitting chunk
-   * available.
-   */
+  /* Search for a large enough free chunk */
 
+  node = mm_findfreechunk(heap, alignsize);
   if (node)
     {
       FAR struct mm_freenode_s *remainder;
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_remfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -182,6 +138,89 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
     }
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_malloc and mm_malloc_caller
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ *   mm_malloc_caller() is the same but records 'caller' as the
+ *   allocating call site (CONFIG_MM_PROFILE only).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  return mm_malloc_caller(heap, size, MM_RETURN_ADDRESS());
+}
+
+FAR void *mm_malloc_caller(FAR struct mm_heap_s *heap, size_t size,
+                           FAR void *caller)
+#else
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
+{
+  size_t alignsize;
+  void *ret;
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+
+#ifdef CONFIG_MM_CACHE
+  /* Small allocations are served from the cache of this CPU, if possible,
+   * without taking the MM semaphore.
+   */
+
+  ret = mm_cache_alloc(heap, alignsize);
+  if (ret != NULL)
+    {
+#ifdef CONFIG_MM_PROFILE
+      mm_profile_mark(ret, caller);
+#endif
+      return ret;
+    }
+#endif
+
+  /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+  mm_takesemaphore(heap);
+  ret = mm_allocchunk(heap, alignsize);
+
+#ifdef CONFIG_MM_CACHE
+  /* The cache missed.  Refill it while we hold the MM semaphore.  Or, if
+   * the heap has no chunk large enough, return the cached chunks of this
+   * CPU to the heap and try again.
+   */
+
+  if (ret != NULL)
+    {
+      mm_cache_refill(heap, alignsize);
+    }
+  else
+    {
+      mm_cache_flush(heap);
+      ret = mm_allocchunk(heap, alignsize);
+    }
+#endif
+
   mm_givesemaphore(heap);
 
   /* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
@@ -199,5 +238,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_PROFILE
+  mm_profile_mark(ret, caller);
+#endif
+
   return ret;
 }
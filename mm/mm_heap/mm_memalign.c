@@ -48,7 +48,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_memalign
+ * Name: mm_memalign and mm_memalign_caller
  *
  * Description:
  *   memalign requests more than enough space from malloc, finds a region
@@ -58,10 +58,24 @@
  *   The alignment argument must be a power of two (not checked).  8-byte
  *   alignment is guaranteed by normal malloc calls.
  *
+ *   mm_memalign_caller() is the same but records 'caller' as the
+ *   allocating call site (CONFIG_MM_PROFILE only).
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+  return mm_memalign_caller(heap, alignment, size, MM_RETURN_ADDRESS());
+}
+
+FAR void *mm_memalign_caller(FAR struct mm_heap_s *heap, size_t alignment,
+                             size_t size, FAR void *caller)
+#else
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size)
+#endif
 {
   FAR struct mm_allocnode_s *node;
   size_t rawchunk;
@@ -75,7 +89,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_MIN_CHUNK)
     {
-      return mm_malloc(heap, size);
+      return mm_malloc_caller(heap, size, caller);
     }
 
   /* Adjust the size to account for (1) the size of the allocated node, (2)
@@ -95,7 +109,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
-  rawchunk = (size_t)mm_malloc(heap, allocsize);
+  rawchunk = (size_t)mm_malloc_caller(heap, allocsize, caller);
   if (rawchunk == 0)
     {
       return NULL;
@@ -205,6 +219,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size);
     }
 
+#ifdef CONFIG_MM_PROFILE
+  mm_profile_mark((FAR void *)alignedchunk, caller);
+#endif
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
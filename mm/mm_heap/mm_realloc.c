@@ -51,7 +51,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_realloc
+ * Name: mm_realloc and mm_realloc_caller
  *
  * Description:
  *   If the reallocation is for less space, then:
@@ -67,20 +67,40 @@
  *     (2) Taking the additional space from the preceding free chunk.
  *     (3) Or both
  *
+ *  The following free chunk is always preferred because the data then
+ *  stays in place.  The preceding free chunk is used only for what the
+ *  following chunk cannot provide; the data is then moved down within the
+ *  merged chunk.
+ *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
  *  and free the old buffer.
  *
+ *   mm_realloc_caller() is the same but records 'caller' as the
+ *   allocating call site (CONFIG_MM_PROFILE only).
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_PROFILE
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                      size_t size)
+{
+  return mm_realloc_caller(heap, oldmem, size, MM_RETURN_ADDRESS());
+}
+
+FAR void *mm_realloc_caller(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                            size_t size, FAR void *caller)
+#else
+FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                     size_t size)
+#endif
 {
   FAR struct mm_allocnode_s *oldnode;
   FAR struct mm_freenode_s  *prev;
   FAR struct mm_freenode_s  *next;
   size_t newsize;
   size_t oldsize;
+  size_t datasize;
   size_t prevsize = 0;
   size_t nextsize = 0;
   FAR void *newmem;
@@ -89,7 +109,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   if (oldmem == NULL)
     {
-      return mm_malloc(heap, size);
+      return mm_malloc_caller(heap, size, caller);
     }
 
   /* If size is zero, then realloc is equivalent to free */
@@ -130,6 +150,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       /* Then return the original address */
 
+#ifdef CONFIG_MM_PROFILE
+      mm_profile_mark(oldmem, caller);
+#endif
       mm_givesemaphore(heap);
       return oldmem;
     }
@@ -159,60 +182,42 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
+      /* Can we get everything we need from the next chunk?  Then the
+       * data does not have to be moved at all.
        */
 
-      if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1))
+      if (needed <= nextsize)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
-
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = needed;
-              takenext = 0;
-            }
+          takenext = needed;
+        }
+      else
+        {
+          /* No, take the whole next chunk and get the rest that we need
+           * from the previous chunk.
+           */
 
-          needed = 0;
+          takenext = nextsize;
+          takeprev = needed - nextsize;
         }
 
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
+      /* Don't leave behind a free chunk that is too small to hold a free
+       * node.  Absorb the whole chunk instead.
        */
 
-      if (nextsize > 0 && needed)
+      if (takenext > 0 && nextsize - takenext < SIZEOF_MM_FREENODE)
         {
-          /* Can we get everything we need from the next chunk? */
-
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
-
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
+          takenext = nextsize;
+        }
 
-              takeprev = 0;
-              takenext = needed;
-            }
+      if (takeprev > 0 && prevsize - takeprev < SIZEOF_MM_FREENODE)
+        {
+          takeprev = prevsize;
         }
 
+#ifdef CONFIG_MM_PROFILE
+      heap->mm_realloc_grown++;
+#endif
+
       /* Extend into the previous free chunk */
 
       newmem = oldmem;
@@ -220,16 +225,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* This is the amount of user data that must be moved */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          datasize = oldsize - SIZEOF_MM_ALLOCNODE;
+
+          /* Remove the previous node from the free list */
+
+          mm_remfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -266,12 +268,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           oldnode = newnode;
           oldsize = newnode->size;
 
-          /* Now we have to move the user contents 'down' in memory.  memcpy should
-           * should be save for this.
+          /* Now we have to move the user contents 'down' in memory.  The
+           * source and destination may overlap.
            */
 
           newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-          memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+          memmove(newmem, oldmem, datasize);
+
+#ifdef CONFIG_MM_PROFILE
+          heap->mm_realloc_moved++;
+          heap->mm_realloc_bytes += datasize;
+#endif
         }
 
       /* Extend into the next free chunk */
@@ -287,16 +294,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
           andbeyond = (FAR struct mm_allocnode_s *)((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_remfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -327,6 +327,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+#ifdef CONFIG_MM_PROFILE
+      mm_profile_mark(newmem, caller);
+#endif
       mm_givesemaphore(heap);
       return newmem;
     }
@@ -339,11 +342,21 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
        * leave the original memory in place.
        */
 
+      datasize = oldsize - SIZEOF_MM_ALLOCNODE;
+
+#ifdef CONFIG_MM_PROFILE
+      /* Count the copy now while we still hold the semaphore */
+
+      heap->mm_realloc_grown++;
+      heap->mm_realloc_copied++;
+      heap->mm_realloc_bytes += datasize;
+#endif
+
       mm_givesemaphore(heap);
-      newmem = (FAR void *)mm_malloc(heap, size);
+      newmem = mm_malloc_caller(heap, size, caller);
       if (newmem)
         {
-          memcpy(newmem, oldmem, oldsize);
+          memcpy(newmem, oldmem, datasize);
           mm_free(heap, oldmem);
         }
 
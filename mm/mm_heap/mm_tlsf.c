@@ -0,0 +1,292 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if MM_TLSF_FLCOUNT > 32
+#  error MM_TLSF_FLCOUNT exceeds the width of the first level bitmap
+#endif
+
+/* The first and second level indices of the list holding chunks of size
+ * MM_MAX_CHUNK and larger.
+ */
+
+#define MM_TLSF_FLLAST   (MM_TLSF_FLCOUNT - 1)
+#define MM_TLSF_SLLAST   0
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Return the first and second level indices of the list that holds free
+ *   chunks of size 'size'.
+ *
+ ****************************************************************************/
+
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size < (1 << MM_TLSF_FLSHIFT))
+    {
+      *fl = 0;
+      *sl = size >> MM_MIN_SHIFT;
+    }
+  else if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_TLSF_FLLAST;
+      *sl = MM_TLSF_SLLAST;
+    }
+  else
+    {
+      msb = fls((int)size) - 1;
+      *fl = msb - MM_TLSF_FLSHIFT + 1;
+      *sl = (size >> (msb - MM_TLSF_SLBITS)) & (MM_TLSF_SLCOUNT - 1);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_roundup
+ *
+ * Description:
+ *   Round an allocation size up to the first size of the next list so that
+ *   any chunk in the list returned by mm_tlsf_mapping() is large enough.
+ *
+ ****************************************************************************/
+
+static inline size_t mm_tlsf_roundup(size_t size)
+{
+  int msb;
+
+  if (size >= (1 << MM_TLSF_FLSHIFT) && size < MM_MAX_CHUNK)
+    {
+      msb   = fls((int)size) - 1;
+      size += ((size_t)1 << (msb - MM_TLSF_SLBITS)) - 1;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_initfreelists
+ *
+ * Description:
+ *   Initialize the segregated free lists of a heap:  All lists are empty.
+ *
+ ****************************************************************************/
+
+void mm_initfreelists(FAR struct mm_heap_s *heap)
+{
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+}
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of its segregated list.  It is assumed
+ *   that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *next;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  next        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = next;
+
+  if (next)
+    {
+      next->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slbitmap[fl]    |= (uint32_t)1 << sl;
+  heap->mm_flbitmap        |= (uint32_t)1 << fl;
+}
+
+/****************************************************************************
+ * Name: mm_remfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from its segregated list.  It is assumed that the
+ *   caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_remfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      /* The node is at the head of its list */
+
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+      heap->mm_freelist[fl][sl] = node->flink;
+
+      /* Clear the bitmap bits if the list is now empty */
+
+      if (node->flink == NULL)
+        {
+          heap->mm_slbitmap[fl] &= ~((uint32_t)1 << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+    }
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The chunk is not removed
+ *   from its list.  Normally, the search time is constant:  The bitmaps
+ *   locate the first non-empty list whose chunks are all large enough.
+ *   Only if there is no such list, or for chunks of MM_MAX_CHUNK bytes or
+ *   more, is the single list that may hold a large enough chunk searched.
+ *   It is assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t bitmap;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(mm_tlsf_roundup(size), &fl, &sl);
+
+  /* Look for a non-empty list in the same first level range */
+
+  bitmap = heap->mm_slbitmap[fl] & (~(uint32_t)0 << sl);
+  if (bitmap == 0)
+    {
+      /* None.. Look for the next non-empty first level range */
+
+      if (fl >= MM_TLSF_FLLAST)
+        {
+          bitmap = 0;
+        }
+      else
+        {
+          bitmap = heap->mm_flbitmap & (~(uint32_t)0 << (fl + 1));
+        }
+
+      if (bitmap == 0)
+        {
+          /* There is no list whose chunks are all large enough.  The list
+           * that holds chunks of size 'size' may still have one.
+           */
+
+          mm_tlsf_mapping(size, &fl, &sl);
+          for (node = heap->mm_freelist[fl][sl];
+               node && node->size < size;
+               node = node->flink);
+
+          return node;
+        }
+
+      fl     = ffs((int)bitmap) - 1;
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  sl   = ffs((int)bitmap) - 1;
+  node = heap->mm_freelist[fl][sl];
+  DEBUGASSERT(node != NULL);
+
+  /* Chunks of all sizes of MM_MAX_CHUNK and larger share the final list
+   * so that list must be searched.
+   */
+
+  if (fl == MM_TLSF_FLLAST)
+    {
+      for (; node && node->size < size; node = node->flink);
+    }
+
+  return node;
+}
+
+#endif /* CONFIG_MM_TLSF */
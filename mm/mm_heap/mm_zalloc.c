@@ -48,16 +48,29 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_zalloc
+ * Name: mm_zalloc and mm_zalloc_caller
  *
  * Description:
  *   mm_zalloc calls mm_malloc, then zeroes out the allocated chunk.
  *
+ *   mm_zalloc_caller() is the same but records 'caller' as the
+ *   allocating call site (CONFIG_MM_PROFILE only).
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  return mm_zalloc_caller(heap, size, MM_RETURN_ADDRESS());
+}
+
+FAR void *mm_zalloc_caller(FAR struct mm_heap_s *heap, size_t size,
+                           FAR void *caller)
+#else
 FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
 {
-  FAR void *alloc = mm_malloc(heap, size);
+  FAR void *alloc = mm_malloc_caller(heap, size, caller);
   if (alloc)
     {
        memset(alloc, 0, size);
@@ -45,7 +45,9 @@
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
+#include <queue.h>
 
 #include <nuttx/addrenv.h>
 
@@ -64,6 +66,19 @@
  * Public Types
  ****************************************************************************/
 
+/* This structure represents one thread waiting in shmwait().  It is
+ * allocated from kernel memory because the waking thread may run in a
+ * different address environment than the waiting thread.
+ */
+
+struct shm_waiter_s
+{
+  FAR struct shm_waiter_s *sw_flink; /* Supports a singly linked list */
+  size_t sw_offset;                  /* Offset of the word in the region */
+  sem_t  sw_sem;                     /* The waiter blocks here */
+  bool   sw_woken;                   /* True: Removed by shmwake() */
+};
+
 /* This structure represents the state of one shared memory region
  * allocation.  Cast compatible with struct shmid_ds.
  */
@@ -74,6 +89,7 @@ struct shm_region_s
   bool  sr_flags;        /* See SRFLAGS_* definitions */
   key_t sr_key;          /* Lookup key */
   sem_t sr_sem;          /* Manages exclusive access to this region */
+  sq_queue_t sr_waitq;   /* Threads waiting in shmwait() */
 
   /* List of physical pages allocated for this memory region */
 
@@ -129,5 +145,25 @@ extern struct shm_info_s g_shminfo;
 
 void shm_destroy(int shmid);
 
+/****************************************************************************
+ * Name: shm_lookup
+ *
+ * Description:
+ *   Map an address in the shared memory of the calling process to the
+ *   shared memory region that contains it and the offset of the address
+ *   within that region.
+ *
+ * Input Parameters:
+ *   addr   - The address in the calling process' address space
+ *   offset - Location to return the offset into the region
+ *
+ * Returned Value:
+ *   The shared memory identifier of the region on success; -EINVAL if the
+ *   address does not lie in an attached shared memory region.
+ *
+ ****************************************************************************/
+
+int shm_lookup(FAR const void *addr, FAR size_t *offset);
+
 #endif /* CONFIG_MM_SHM */
 #endif /* __MM_SHM_SHM_H */
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * mm/shm/shm_lookup.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "shm/shm.h"
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_lookup
+ *
+ * Description:
+ *   Map an address in the shared memory of the calling process to the
+ *   shared memory region that contains it and the offset of the address
+ *   within that region.
+ *
+ * Input Parameters:
+ *   addr   - The address in the calling process' address space
+ *   offset - Location to return the offset into the region
+ *
+ * Returned Value:
+ *   The shared memory identifier of the region on success; -EINVAL if the
+ *   address does not lie in an attached shared memory region.
+ *
+ ****************************************************************************/
+
+int shm_lookup(FAR const void *addr, FAR size_t *offset)
+{
+  FAR struct task_group_s *group;
+  FAR struct tcb_s *tcb;
+  uintptr_t vaddr;
+  int shmid;
+
+  /* Get the TCB and group containing the process' mappings */
+
+  tcb = sched_self();
+  DEBUGASSERT(tcb && tcb->group);
+  group = tcb->group;
+
+  for (shmid = 0; shmid < CONFIG_ARCH_SHM_MAXREGIONS; shmid++)
+    {
+      vaddr = group->tg_shm.gs_vaddr[shmid];
+      if (vaddr != 0 && (uintptr_t)addr >= vaddr &&
+          (uintptr_t)addr < vaddr + g_shminfo.si_region[shmid].sr_ds.shm_segsz)
+        {
+          *offset = (uintptr_t)addr - vaddr;
+          return shmid;
+        }
+    }
+
+  return -EINVAL;
+}
+
+#endif /* CONFIG_MM_SHM */
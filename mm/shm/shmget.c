@@ -123,6 +123,7 @@ static int shm_reserve(key_t key, int shmflg)
           region->sr_flags = SRFLAG_INUSE;
 
           nxsem_init(&region->sr_sem, 0, 1);
+          sq_init(&region->sr_waitq);
 
           /* Set the low-order nine bits of shm_perm.mode to the low-order
            * nine bits of shmflg.
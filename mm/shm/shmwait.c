@@ -0,0 +1,202 @@
+/****************************************************************************
+ * mm/shm/shmwait.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/shm.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+
+#include "shm/shm.h"
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmwait
+ *
+ * Description:
+ *   If the 32-bit word at 'addr' in an attached shared memory region still
+ *   holds 'value', block the calling thread until another thread, possibly
+ *   in a different process, calls shmwake() on the same word of the same
+ *   region.  The comparison and the start of the wait are atomic with
+ *   respect to shmwake() so a wakeup that follows a change of the word
+ *   cannot be lost.
+ *
+ *   Waiters are keyed on the region and the offset of the word in the
+ *   region, so the processes sharing the region may have it attached at
+ *   different virtual addresses.
+ *
+ * Input Parameters:
+ *   addr    - The address of a naturally aligned 32-bit word in an attached
+ *             shared memory region.
+ *   value   - The value that the word is expected to hold.
+ *   abstime - The absolute time (CLOCK_REALTIME) at which the wait expires
+ *             or NULL to wait indefinitely.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned when woken by shmwake().  Otherwise, -1 (ERROR)
+ *   is returned and errno is set to indicate the error:
+ *
+ *   - EAGAIN:  The word did not hold 'value'.
+ *   - EINVAL:  'addr' is misaligned or not in an attached region.
+ *   - ENOMEM:  No memory for the wait state.
+ *   - ETIMEDOUT:  'abstime' expired.
+ *   - EINTR:  The wait was interrupted by a signal.
+ *
+ ****************************************************************************/
+
+int shmwait(FAR const void *addr, uint32_t value,
+            FAR const struct timespec *abstime)
+{
+  FAR struct shm_region_s *region;
+  FAR struct shm_waiter_s *waiter;
+  irqstate_t flags;
+  size_t offset;
+  int shmid;
+  int ret;
+
+  /* The word must be naturally aligned so that it is accessed atomically */
+
+  if (((uintptr_t)addr & (sizeof(uint32_t) - 1)) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  shmid = shm_lookup(addr, &offset);
+  if (shmid < 0)
+    {
+      shmerr("ERROR: No region contains this address: %p\n", addr);
+      ret = shmid;
+      goto errout;
+    }
+
+  region = &g_shminfo.si_region[shmid];
+
+  /* Allocate the wait state from kernel memory where shmwake() can reach
+   * it from any address environment.
+   */
+
+  waiter = (FAR struct shm_waiter_s *)kmm_malloc(sizeof(struct shm_waiter_s));
+  if (waiter == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  waiter->sw_offset = offset;
+  waiter->sw_woken  = false;
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&waiter->sw_sem, 0, 0);
+  nxsem_setprotocol(&waiter->sw_sem, SEM_PRIO_NONE);
+
+  /* Compare the word and queue the waiter atomically with respect to
+   * shmwake().
+   */
+
+  flags = enter_critical_section();
+
+  if (*(FAR volatile const uint32_t *)addr != value)
+    {
+      leave_critical_section(flags);
+      ret = -EAGAIN;
+      goto errout_with_waiter;
+    }
+
+  sq_addlast((FAR sq_entry_t *)waiter, &region->sr_waitq);
+
+  /* Wait to be woken.  The critical section is broken while we wait. */
+
+  if (abstime != NULL)
+    {
+      ret = nxsem_timedwait(&waiter->sw_sem, abstime);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter->sw_sem);
+    }
+
+  /* If the wait failed, then we are still in the wait queue unless
+   * shmwake() removed us in the meantime.  In that case, report the wakeup.
+   */
+
+  if (ret < 0)
+    {
+      if (waiter->sw_woken)
+        {
+          ret = OK;
+        }
+      else
+        {
+          sq_rem((FAR sq_entry_t *)waiter, &region->sr_waitq);
+        }
+    }
+
+  leave_critical_section(flags);
+
+errout_with_waiter:
+  nxsem_destroy(&waiter->sw_sem);
+  kmm_free(waiter);
+
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_MM_SHM */
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * mm/shm/shmwake.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/shm.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+
+#include "shm/shm.h"
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmwake
+ *
+ * Description:
+ *   Wake up to 'nwake' of the threads waiting in shmwait() on the 32-bit
+ *   word at 'addr' in an attached shared memory region.  The waiters are
+ *   woken in the order in which they started waiting.
+ *
+ * Input Parameters:
+ *   addr  - The address of the word in an attached shared memory region.
+ *   nwake - The maximum number of waiters to wake.  Use INT_MAX to wake
+ *           all waiters.
+ *
+ * Returned Value:
+ *   The number of waiters woken on success.  Otherwise, -1 (ERROR) is
+ *   returned and errno is set to indicate the error:
+ *
+ *   - EINVAL:  'addr' is not in an attached region.
+ *
+ ****************************************************************************/
+
+int shmwake(FAR const void *addr, int nwake)
+{
+  FAR struct shm_region_s *region;
+  FAR struct shm_waiter_s *waiter;
+  FAR struct shm_waiter_s *prev;
+  FAR struct shm_waiter_s *next;
+  irqstate_t flags;
+  size_t offset;
+  int nwoken = 0;
+  int shmid;
+
+  shmid = shm_lookup(addr, &offset);
+  if (shmid < 0)
+    {
+      shmerr("ERROR: No region contains this address: %p\n", addr);
+      set_errno(-shmid);
+      return ERROR;
+    }
+
+  region = &g_shminfo.si_region[shmid];
+
+  /* Remove the matching waiters from the wait queue and wake them.  The
+   * scheduler is locked so that the waiters do not run until all of them
+   * have been woken.
+   */
+
+  sched_lock();
+  flags = enter_critical_section();
+
+  for (prev = NULL,
+       waiter = (FAR struct shm_waiter_s *)sq_peek(&region->sr_waitq);
+       waiter != NULL && nwoken < nwake;
+       waiter = next)
+    {
+      next = waiter->sw_flink;
+      if (waiter->sw_offset != offset)
+        {
+          prev = waiter;
+          continue;
+        }
+
+      if (prev == NULL)
+        {
+          (void)sq_remfirst(&region->sr_waitq);
+        }
+      else
+        {
+          (void)sq_remafter((FAR sq_entry_t *)prev, &region->sr_waitq);
+        }
+
+      waiter->sw_woken = true;
+      nxsem_post(&waiter->sw_sem);
+      nwoken++;
+    }
+
+  leave_critical_section(flags);
+  sched_unlock();
+
+  return nwoken;
+}
+
+#endif /* CONFIG_MM_SHM */
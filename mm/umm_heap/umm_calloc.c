@@ -59,5 +59,6 @@
 
 FAR void *calloc(size_t n, size_t elem_size)
 {
-  return mm_calloc(USR_HEAP, n, elem_size);
+  return mm_calloc_caller(USR_HEAP_DEFAULT, n, elem_size,
+                          MM_RETURN_ADDRESS());
 }
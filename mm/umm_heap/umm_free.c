@@ -60,5 +60,5 @@
 
 void free(FAR void *mem)
 {
-  mm_free(USR_HEAP, mem);
+  mm_free(USR_HEAP_OWNER(mem), mem);
 }
@@ -74,6 +74,18 @@
 #  define USR_HEAP &g_mmheap
 #endif
 
+/* With named heaps, new allocations are served from the default heap of the
+ * calling thread and memory is returned to the heap that it came from.
+ */
+
+#ifdef CONFIG_MM_HEAPS
+#  define USR_HEAP_DEFAULT      mm_heap_default()
+#  define USR_HEAP_OWNER(m)     mm_heap_owner(m)
+#else
+#  define USR_HEAP_DEFAULT      USR_HEAP
+#  define USR_HEAP_OWNER(m)     USR_HEAP
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
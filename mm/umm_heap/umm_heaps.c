@@ -0,0 +1,237 @@
+/****************************************************************************
+ * mm/umm_heap/umm_heaps.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_HEAPS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of named heaps, most recently created first.  Heaps are never
+ * removed and a heap is fully initialized before it is added to the head
+ * of the list, so the list may be traversed without a lock.
+ */
+
+static FAR struct mm_heap_s *g_mmheaps;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heap_create
+ *
+ * Description:
+ *   Create a new, named heap in the memory region beginning at 'heapstart'.
+ *   The heap structure itself is placed at the beginning of the region and
+ *   the remainder of the region is managed by the new heap.
+ *
+ * Input Parameters:
+ *   name      - The name of the heap.  The string must persist for the
+ *               lifetime of the heap.
+ *   heapstart - Start of the memory region
+ *   heapsize  - Size of the memory region in bytes
+ *
+ * Returned Value:
+ *   The new heap on success; NULL if the region is too small.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_heap_create(FAR const char *name,
+                                     FAR void *heapstart, size_t heapsize)
+{
+  FAR struct mm_heap_s *heap;
+  irqstate_t flags;
+  uintptr_t start;
+  size_t hdrsize;
+
+  DEBUGASSERT(name != NULL && heapstart != NULL);
+
+  /* Place the heap structure at the aligned start of the region */
+
+  start   = MM_ALIGN_UP((uintptr_t)heapstart);
+  hdrsize = MM_ALIGN_UP(sizeof(struct mm_heap_s));
+
+  if (heapsize < (start - (uintptr_t)heapstart) + hdrsize +
+                 SIZEOF_MM_ALLOCNODE + 2 * MM_MIN_CHUNK)
+    {
+      return NULL;
+    }
+
+  heapsize -= (start - (uintptr_t)heapstart) + hdrsize;
+  heap      = (FAR struct mm_heap_s *)start;
+
+  memset(heap, 0, sizeof(struct mm_heap_s));
+  mm_initialize(heap, (FAR void *)(start + hdrsize), heapsize);
+  heap->mm_name = name;
+
+  /* Add the heap to the list of named heaps */
+
+  flags          = enter_critical_section();
+  heap->mm_flink = g_mmheaps;
+  g_mmheaps      = heap;
+  leave_critical_section(flags);
+
+  return heap;
+}
+
+/****************************************************************************
+ * Name: mm_heap_find
+ *
+ * Description:
+ *   Return the named heap with the name 'name'.
+ *
+ * Input Parameters:
+ *   name - The name of the heap
+ *
+ * Returned Value:
+ *   The heap or NULL if there is no heap with that name.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_heap_find(FAR const char *name)
+{
+  FAR struct mm_heap_s *heap;
+
+  for (heap = g_mmheaps; heap != NULL; heap = heap->mm_flink)
+    {
+      if (strcmp(heap->mm_name, name) == 0)
+        {
+          break;
+        }
+    }
+
+  return heap;
+}
+
+/****************************************************************************
+ * Name: mm_heap_select
+ *
+ * Description:
+ *   Select the default heap of the calling thread.  malloc(), zalloc(),
+ *   calloc() and memalign() allocate from the default heap and threads
+ *   created by the calling thread inherit it.
+ *
+ * Input Parameters:
+ *   heap - The new default heap.  NULL selects the system heap.
+ *
+ * Returned Value:
+ *   The previous default heap of the calling thread.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_heap_select(FAR struct mm_heap_s *heap)
+{
+  FAR struct tcb_s *rtcb = sched_self();
+  FAR struct mm_heap_s *prev;
+
+  prev       = mm_heap_default();
+  rtcb->heap = (heap == &g_mmheap) ? NULL : heap;
+  return prev;
+}
+
+/****************************************************************************
+ * Name: mm_heap_default
+ *
+ * Description:
+ *   Return the default heap of the calling thread.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_heap_default(void)
+{
+  FAR struct tcb_s *rtcb = sched_self();
+
+  if (rtcb != NULL && rtcb->heap != NULL)
+    {
+      return rtcb->heap;
+    }
+
+  return &g_mmheap;
+}
+
+/****************************************************************************
+ * Name: mm_heap_owner
+ *
+ * Description:
+ *   Return the heap that contains the memory at 'mem'.  Memory that does
+ *   not lie in any named heap (including NULL) belongs to the system heap.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_heap_owner(FAR void *mem)
+{
+  FAR struct mm_heap_s *heap;
+  int region;
+
+  if (mem != NULL)
+    {
+      for (heap = g_mmheaps; heap != NULL; heap = heap->mm_flink)
+        {
+#if CONFIG_MM_REGIONS > 1
+          for (region = 0; region < heap->mm_nregions; region++)
+#else
+          region = 0;
+#endif
+            {
+              if (mem > (FAR void *)heap->mm_heapstart[region] &&
+                  mem < (FAR void *)heap->mm_heapend[region])
+                {
+                  return heap;
+                }
+            }
+        }
+    }
+
+  return &g_mmheap;
+}
+
+#endif /* CONFIG_MM_HEAPS */
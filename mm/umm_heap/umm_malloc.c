@@ -83,7 +83,7 @@ FAR void *malloc(size_t size)
 
   do
     {
-      mem = mm_malloc(USR_HEAP, size);
+      mem = mm_malloc_caller(USR_HEAP, size, MM_RETURN_ADDRESS());
       if (!mem)
         {
           brkaddr = sbrk(size);
@@ -97,6 +97,6 @@ FAR void *malloc(size_t size)
 
   return mem;
 #else
-  return mm_malloc(USR_HEAP, size);
+  return mm_malloc_caller(USR_HEAP_DEFAULT, size, MM_RETURN_ADDRESS());
 #endif
 }
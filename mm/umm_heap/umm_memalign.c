@@ -64,5 +64,6 @@
 
 FAR void *memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(USR_HEAP, alignment, size);
+  return mm_memalign_caller(USR_HEAP_DEFAULT, alignment, size,
+                            MM_RETURN_ADDRESS());
 }
@@ -66,5 +66,7 @@
 
 FAR void *realloc(FAR void *oldmem, size_t size)
 {
-  return mm_realloc(USR_HEAP, oldmem, size);
+  return mm_realloc_caller(oldmem != NULL ? USR_HEAP_OWNER(oldmem) :
+                           USR_HEAP_DEFAULT, oldmem, size,
+                           MM_RETURN_ADDRESS());
 }
@@ -80,6 +80,6 @@ FAR void *zalloc(size_t size)
 #else
   /* Use mm_zalloc() becuase it implements the clear */
 
-  return mm_zalloc(USR_HEAP, size);
+  return mm_zalloc_caller(USR_HEAP_DEFAULT, size, MM_RETURN_ADDRESS());
 #endif
 }
@@ -394,20 +394,16 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there was no entry for
+ *   the IP address.
+ *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table
- *   (and because arp_find() is called).
+ *   The network is locked to assure exclusive access to the ARP table
  *
  ****************************************************************************/
 
-#define arp_delete(ipaddr) \
-{ \
-  struct arp_entry *tabptr = arp_find(ipaddr); \
-  if (tabptr) \
-    { \
-      tabptr->at_ipaddr = 0; \
-    } \
-}
+int arp_delete(in_addr_t ipaddr);
 
 /****************************************************************************
  * Name: arp_update
@@ -453,6 +449,88 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr);
 
 void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr);
 
+/****************************************************************************
+ * Name: arp_queue
+ *
+ * Description:
+ *   Called by arp_out() when the destination of the outgoing IPv4 packet in
+ *   d_buf is not in the ARP table.  A copy of the packet is held until the
+ *   address is resolved (or until the hold times out) and the ARP request
+ *   then replaces the packet in d_buf as before.  At most
+ *   CONFIG_NET_ARP_QUEUE_DEPTH packets are held per address; the oldest is
+ *   dropped to make room.
+ *
+ * Input Parameters:
+ *   dev    - The device that the packet will be sent on
+ *   ipaddr - The next hop IP address that must be resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+void arp_queue(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#else
+#  define arp_queue(d,i)
+#endif
+
+/****************************************************************************
+ * Name: arp_queue_resolved
+ *
+ * Description:
+ *   Called by arp_update() when a new mapping is available.  Any packets
+ *   held for the IP address are scheduled for transmission on the next
+ *   poll of the device.
+ *
+ * Input Parameters:
+ *   ipaddr - The IP address that was resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+void arp_queue_resolved(in_addr_t ipaddr);
+#else
+#  define arp_queue_resolved(i)
+#endif
+
+/****************************************************************************
+ * Name: arp_queue_poll
+ *
+ * Description:
+ *   Called from devif_poll().  Send packets that were held for addresses
+ *   that have since been resolved and discard those that have waited too
+ *   long.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback (non-zero
+ *   means that polling should stop).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_QUEUE
+int arp_queue_poll(FAR struct net_driver_s *dev,
+                   devif_poll_callback_t callback);
+#else
+#  define arp_queue_poll(d,c) (0)
+#endif
+
 /****************************************************************************
  * Name: arp_dump
  *
@@ -488,7 +566,10 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_wait(n,t) (0)
 #  define arp_notify(i)
 #  define arp_find(i) (NULL)
-#  define arp_delete(i)
+#  define arp_delete(i) (-ENOENT)
+#  define arp_queue(d,i)
+#  define arp_queue_resolved(i)
+#  define arp_queue_poll(d,c) (0)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
 #  define arp_dump(arp)
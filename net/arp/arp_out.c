@@ -48,6 +48,7 @@
 
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
+#include <nuttx/net/netstats.h>
 
 #include "route/route.h"
 #include "arp/arp.h"
@@ -126,7 +127,9 @@ static const uint8_t g_multicast_ethaddr[3] =
  *   packet in the d_buf is replaced by an ARP request packet for the
  *   IP address. The IP packet is dropped and it is assumed that the
  *   higher level protocols (e.g., TCP) eventually will retransmit the
- *   dropped packet.
+ *   dropped packet.  If CONFIG_NET_ARP_QUEUE is enabled, a copy of the
+ *   IP packet is first held by arp_queue() and is sent when the ARP reply
+ *   is received.
  *
  *   Upon return in either the case, a packet to be sent is present in the
  *   d_buf buffer and the d_len field holds the length of the Ethernet
@@ -254,6 +257,16 @@ void arp_out(FAR struct net_driver_s *dev)
     {
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.arp.miss++;
+#endif
+
+      /* Hold a copy of the IP packet (if so configured) so that it can be
+       * sent when the reply arrives.
+       */
+
+      arp_queue(dev, ipaddr);
+
       /* The destination address was not in our ARP table, so we overwrite
        * the IP packet with an ARP request.
        */
@@ -263,6 +276,10 @@ void arp_out(FAR struct net_driver_s *dev)
       return;
     }
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.hit++;
+#endif
+
   /* Build an Ethernet header. */
 
   memcpy(peth->dest, tabptr->at_ethaddr.ether_addr_octet, ETHER_ADDR_LEN);
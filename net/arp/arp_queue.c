@@ -0,0 +1,406 @@
+/****************************************************************************
+ * net/arp/arp_queue.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <net/if.h>
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/arp.h>
+
+#include "netdev/netdev.h"
+#include "arp/arp.h"
+
+#ifdef CONFIG_NET_ARP_QUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS < 1
+#  error CONFIG_NET_ARP_QUEUE requires CONFIG_IOB_NCHAINS > 0
+#endif
+
+#define ARP_QUEUE_TIMEOUT SEC2TICK(CONFIG_NET_ARP_QUEUE_TIMEOUT)
+
+#define IPBUF ((FAR uint8_t *)&dev->d_buf[ETH_HDRLEN])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The packets held for one unresolved IP address */
+
+struct arp_pending_s
+{
+  FAR struct net_driver_s *ap_dev;    /* Device that the packets go out on */
+  in_addr_t                ap_ipaddr; /* Next hop address (zero if unused) */
+  systime_t                ap_time;   /* Time that the hold started */
+  bool                     ap_ready;  /* The address has been resolved */
+  uint8_t                  ap_count;  /* Number of packets held */
+  struct iob_queue_s       ap_queue;  /* The held IPv4 packets */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct arp_pending_s g_arppending[CONFIG_NET_ARP_QUEUE_NENTRIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_queue_drop
+ *
+ * Description:
+ *   Discard the oldest packet held in the entry.
+ *
+ ****************************************************************************/
+
+static void arp_queue_drop(FAR struct arp_pending_s *pend)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_remove_queue(&pend->ap_queue);
+  if (iob != NULL)
+    {
+      iob_free_chain(iob);
+      pend->ap_count--;
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.arp.qdrop++;
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: arp_queue_release
+ *
+ * Description:
+ *   Discard all packets held in the entry and return it to the free pool.
+ *
+ ****************************************************************************/
+
+static void arp_queue_release(FAR struct arp_pending_s *pend)
+{
+  while (pend->ap_count > 0)
+    {
+      arp_queue_drop(pend);
+    }
+
+  pend->ap_ipaddr = 0;
+  pend->ap_dev    = NULL;
+  pend->ap_ready  = false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_queue
+ *
+ * Description:
+ *   Called by arp_out() when the destination of the outgoing IPv4 packet in
+ *   d_buf is not in the ARP table.  A copy of the packet is held until the
+ *   address is resolved (or until the hold times out) and the ARP request
+ *   then replaces the packet in d_buf as before.  At most
+ *   CONFIG_NET_ARP_QUEUE_DEPTH packets are held per address; the oldest is
+ *   dropped to make room.
+ *
+ * Input Parameters:
+ *   dev    - The device that the packet will be sent on
+ *   ipaddr - The next hop IP address that must be resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_queue(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_pending_s *pend = NULL;
+  FAR struct arp_pending_s *oldest = NULL;
+  FAR struct iob_s *iob;
+  systime_t now = clock_systimer();
+  int ret;
+  int i;
+
+  if (dev->d_len == 0)
+    {
+      return;
+    }
+
+  /* Find the entry for this address, or else a free entry or the oldest
+   * entry which will be reclaimed.
+   */
+
+  for (i = 0; i < CONFIG_NET_ARP_QUEUE_NENTRIES; i++)
+    {
+      FAR struct arp_pending_s *tmp = &g_arppending[i];
+
+      if (tmp->ap_ipaddr == 0)
+        {
+          if (pend == NULL)
+            {
+              pend = tmp;
+            }
+        }
+      else if (tmp->ap_dev == dev && net_ipv4addr_cmp(tmp->ap_ipaddr, ipaddr))
+        {
+          pend = tmp;
+          break;
+        }
+      else if (oldest == NULL ||
+               now - tmp->ap_time > now - oldest->ap_time)
+        {
+          oldest = tmp;
+        }
+    }
+
+  if (pend == NULL)
+    {
+      pend = oldest;
+      arp_queue_release(pend);
+    }
+
+  if (pend->ap_ipaddr == 0)
+    {
+      pend->ap_dev    = dev;
+      pend->ap_ipaddr = ipaddr;
+      pend->ap_time   = now;
+      pend->ap_ready  = false;
+      pend->ap_count  = 0;
+      IOB_QINIT(&pend->ap_queue);
+    }
+
+  /* Make room for the new packet if necessary */
+
+  if (pend->ap_count >= CONFIG_NET_ARP_QUEUE_DEPTH)
+    {
+      arp_queue_drop(pend);
+    }
+
+  /* Copy the IPv4 packet into an I/O buffer chain.  This must not wait
+   * for buffers since we are running on the driver's thread.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      goto errout;
+    }
+
+  ret = iob_trycopyin(iob, IPBUF, dev->d_len, 0, true);
+  if (ret < 0)
+    {
+      goto errout_with_iob;
+    }
+
+  ret = iob_tryadd_queue(iob, &pend->ap_queue);
+  if (ret < 0)
+    {
+      goto errout_with_iob;
+    }
+
+  pend->ap_count++;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.queued++;
+#endif
+  return;
+
+errout_with_iob:
+  iob_free_chain(iob);
+
+errout:
+  nwarn("WARNING: Could not hold packet for %08lx\n", (unsigned long)ipaddr);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.arp.qdrop++;
+#endif
+
+  /* Don't leave an empty entry behind */
+
+  if (pend->ap_count == 0)
+    {
+      arp_queue_release(pend);
+    }
+}
+
+/****************************************************************************
+ * Name: arp_queue_resolved
+ *
+ * Description:
+ *   Called by arp_update() when a new mapping is available.  Any packets
+ *   held for the IP address are scheduled for transmission on the next
+ *   poll of the device.
+ *
+ * Input Parameters:
+ *   ipaddr - The IP address that was resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_queue_resolved(in_addr_t ipaddr)
+{
+  FAR struct arp_pending_s *pend;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARP_QUEUE_NENTRIES; i++)
+    {
+      pend = &g_arppending[i];
+      if (pend->ap_ipaddr != 0 && !pend->ap_ready &&
+          net_ipv4addr_cmp(pend->ap_ipaddr, ipaddr))
+        {
+          /* Ask the driver to poll so that the packets go out now */
+
+          pend->ap_ready = true;
+          netdev_txnotify_dev(pend->ap_dev);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: arp_queue_poll
+ *
+ * Description:
+ *   Called from devif_poll().  Send packets that were held for addresses
+ *   that have since been resolved and discard those that have waited too
+ *   long.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback (non-zero
+ *   means that polling should stop).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int arp_queue_poll(FAR struct net_driver_s *dev,
+                   devif_poll_callback_t callback)
+{
+  FAR struct arp_pending_s *pend;
+  FAR struct iob_s *iob;
+  systime_t now = clock_systimer();
+  int bstop = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARP_QUEUE_NENTRIES && !bstop; i++)
+    {
+      pend = &g_arppending[i];
+      if (pend->ap_ipaddr == 0 || pend->ap_dev != dev)
+        {
+          continue;
+        }
+
+      /* The mapping may have been lost again (e.g., evicted) before we
+       * got here.  In that case, keep holding the packets; sending them
+       * now would only cause them to be queued again by arp_out().
+       */
+
+      if (pend->ap_ready && arp_find(pend->ap_ipaddr) == NULL)
+        {
+          pend->ap_ready = false;
+          pend->ap_time  = now;
+        }
+
+      if (!pend->ap_ready)
+        {
+          if (now - pend->ap_time >= ARP_QUEUE_TIMEOUT)
+            {
+              ninfo("Discarding %u packets for %08lx\n",
+                    pend->ap_count, (unsigned long)pend->ap_ipaddr);
+              arp_queue_release(pend);
+            }
+
+          continue;
+        }
+
+      /* Pass each held packet to the driver as if it had just been
+       * produced by the poll.  The driver's arp_out() call will now find
+       * the mapping and add the Ethernet header.
+       */
+
+      while (!bstop && (iob = iob_remove_queue(&pend->ap_queue)) != NULL)
+        {
+          pend->ap_count--;
+
+          dev->d_len = iob->io_pktlen;
+          (void)iob_copyout(IPBUF, iob, iob->io_pktlen, 0);
+          iob_free_chain(iob);
+
+          IFF_SET_IPv4(dev->d_flags);
+          bstop = callback(dev);
+        }
+
+      if (pend->ap_count == 0)
+        {
+          arp_queue_release(pend);
+        }
+    }
+
+  return bstop;
+}
+
+#endif /* CONFIG_NET_ARP_QUEUE */
@@ -2,7 +2,7 @@
  * net/arp/arp_table.c
  * Implementation of the ARP Address Resolution Protocol.
  *
- *   Copyright (C) 2007-2009, 2011, 2014 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2007-2009, 2011, 2014, 2018 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Based originally on uIP which also has a BSD style license:
@@ -48,6 +48,9 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
@@ -55,6 +58,7 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/ip.h>
 
@@ -62,15 +66,143 @@
 
 #ifdef CONFIG_NET_ARP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_ARP_HASHSIZE & (CONFIG_NET_ARP_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_ARP_HASHSIZE must be a power of two
+#endif
+
+/* Fold all four bytes of the IPv4 address into the hash so that the result
+ * does not depend on the host byte order.
+ */
+
+#define ARP_HASH(a) \
+  (((a) ^ ((a) >> 8) ^ ((a) >> 16) ^ ((a) >> 24)) & \
+   (CONFIG_NET_ARP_HASHSIZE - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One slot in the ARP table.  Slots are always members of the LRU list; the
+ * most recently used slot is at the head and the next slot to be reused is
+ * at the tail.  Slots holding a mapping are also members of a hash chain.
+ *
+ * An entry may be deleted (at_ipaddr set to zero) from arp_timer() or via
+ * SIOCDARP without being unlinked from its hash chain.  Such stale slots
+ * are never matched and are unlinked lazily.  at_bucket remembers the hash
+ * chain since the address can no longer be used to find it.
+ */
+
+struct arp_table_s
+{
+  dq_entry_t              at_node;   /* LRU list linkage (must be first) */
+  FAR struct arp_table_s *at_hnext;  /* Next slot in the same hash chain */
+  uint8_t                 at_bucket; /* Index of the hash chain */
+  struct arp_entry        at_entry;  /* The IP/HW address mapping */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_table_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static FAR struct arp_table_s *g_arphash[CONFIG_NET_ARP_HASHSIZE];
+static dq_queue_t g_arplru;
 static uint8_t g_arptime;
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_unhash
+ *
+ * Description:
+ *   Remove a slot from its hash chain and make it the next one to be
+ *   reused.
+ *
+ ****************************************************************************/
+
+static void arp_unhash(FAR struct arp_table_s *tab)
+{
+  FAR struct arp_table_s **prev = &g_arphash[tab->at_bucket];
+
+  while (*prev != NULL)
+    {
+      if (*prev == tab)
+        {
+          *prev = tab->at_hnext;
+          break;
+        }
+
+      prev = &(*prev)->at_hnext;
+    }
+
+  tab->at_hnext           = NULL;
+  tab->at_entry.at_ipaddr = 0;
+
+  dq_rem(&tab->at_node, &g_arplru);
+  dq_addlast(&tab->at_node, &g_arplru);
+}
+
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Find the slot holding the mapping for this IP address.  Stale slots
+ *   encountered along the way are removed from the chain.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_table_s *arp_lookup(in_addr_t ipaddr)
+{
+  FAR struct arp_table_s *tab;
+  FAR struct arp_table_s *next;
+
+  if (ipaddr == 0)
+    {
+      return NULL;
+    }
+
+  for (tab = g_arphash[ARP_HASH(ipaddr)]; tab != NULL; tab = next)
+    {
+      next = tab->at_hnext;
+
+      if (net_ipv4addr_cmp(ipaddr, tab->at_entry.at_ipaddr))
+        {
+          return tab;
+        }
+      else if (tab->at_entry.at_ipaddr == 0)
+        {
+          arp_unhash(tab);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Mark the slot as the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(FAR struct arp_table_s *tab)
+{
+  if (g_arplru.head != &tab->at_node)
+    {
+      dq_rem(&tab->at_node, &g_arplru);
+      dq_addfirst(&tab->at_node, &g_arplru);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,9 +219,15 @@ void arp_reset(void)
 {
   int i;
 
+  memset(g_arphash, 0, sizeof(g_arphash));
+  dq_init(&g_arplru);
+
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
+      g_arptable[i].at_hnext           = NULL;
+      g_arptable[i].at_bucket          = 0;
+      g_arptable[i].at_entry.at_ipaddr = 0;
+      dq_addlast(&g_arptable[i].at_node, &g_arplru);
     }
 }
 
@@ -102,6 +240,10 @@ void arp_reset(void)
  *   is 10 seconds between the calls.  It is responsible for flushing old
  *   entries in the ARP table.
  *
+ *   This runs from the timer interrupt level, so expired entries are only
+ *   marked as unused here; the hash chains and the LRU list are left for
+ *   the network logic to repair.
+ *
  ****************************************************************************/
 
 void arp_timer(void)
@@ -112,7 +254,7 @@ void arp_timer(void)
   ++g_arptime;
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &g_arptable[i].at_entry;
 
       if (tabptr->at_ipaddr != 0 &&
           g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
@@ -144,79 +286,50 @@ void arp_timer(void)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  struct arp_entry *tabptr = NULL;
-  int               i;
-
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  FAR struct arp_table_s *tab;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (ipaddr == 0)
     {
-      tabptr = &g_arptable[i];
-
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
-        {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
-
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
-
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return OK;
-            }
-        }
+      return -EINVAL;
     }
 
-  /* If we get here, no existing ARP table entry was found, so we create one. */
-  /* First, we try to find an unused entry in the ARP table. */
+  /* Look for an existing mapping to update. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tab = arp_lookup(ipaddr);
+  if (tab == NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr == 0)
-        {
-          break;
-        }
-    }
+      /* None found.  Reuse the least recently used slot.  Unused slots
+       * always migrate to the tail of the LRU list so this will be a free
+       * slot if there is one.
+       */
 
-  /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
-   */
+      tab = (FAR struct arp_table_s *)g_arplru.tail;
+      DEBUGASSERT(tab != NULL);
 
-  if (i == CONFIG_NET_ARPTAB_SIZE)
-    {
-      uint8_t tmpage = 0;
-      int j = 0;
-
-      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+      if (tab->at_entry.at_ipaddr != 0)
         {
-          tabptr = &g_arptable[i];
-          if (g_arptime - tabptr->at_time > tmpage)
-            {
-              tmpage = g_arptime - tabptr->at_time;
-              j = i;
-            }
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.arp.evict++;
+#endif
         }
 
-      i = j;
-      tabptr = &g_arptable[i];
+      arp_unhash(tab);
+
+      /* Add the slot to the head of its hash chain */
+
+      tab->at_entry.at_ipaddr   = ipaddr;
+      tab->at_bucket            = ARP_HASH(ipaddr);
+      tab->at_hnext             = g_arphash[tab->at_bucket];
+      g_arphash[tab->at_bucket] = tab;
     }
 
-  /* Now, i is the ARP table entry which we will fill with the new
-   * information.
-   */
+  memcpy(tab->at_entry.at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
+  tab->at_entry.at_time = g_arptime;
+  arp_touch(tab);
 
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = g_arptime;
+  /* Release any packets that were held waiting for this mapping */
+
+  arp_queue_resolved(ipaddr);
   return OK;
 }
 
@@ -259,27 +372,56 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
  *   ipaddr - Refers to an IP address in network order
  *
  * Assumptions
- *   Interrupts are disabled; Returned value will become unstable when
- *   interrupts are re-enabled or if any other network APIs are called.
+ *   The network is locked; Returned value will become unstable when the
+ *   network is unlocked or if any other network APIs are called.
  *
  ****************************************************************************/
 
 FAR struct arp_entry *arp_find(in_addr_t ipaddr)
 {
-  FAR struct arp_entry *tabptr;
-  int i;
+  FAR struct arp_table_s *tab;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tab = arp_lookup(ipaddr);
+  if (tab != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          return tabptr;
-        }
+      arp_touch(tab);
+      return &tab->at_entry;
     }
 
   return NULL;
 }
 
+/****************************************************************************
+ * Name: arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input Parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there was no entry for
+ *   the IP address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_delete(in_addr_t ipaddr)
+{
+  FAR struct arp_table_s *tab;
+
+  tab = arp_lookup(ipaddr);
+  if (tab == NULL)
+    {
+      return -ENOENT;
+    }
+
+  arp_unhash(tab);
+  return OK;
+}
+
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
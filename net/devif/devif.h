@@ -420,6 +420,27 @@ void devif_dev_callback_free(FAR struct net_driver_s *dev,
 uint16_t devif_conn_event(FAR struct net_driver_s *dev, FAR void *pvconn,
                           uint16_t flags, FAR struct devif_callback_s *list);
 
+/****************************************************************************
+ * Name: devif_conn_subscribed
+ *
+ * Description:
+ *   Return true if any callback in the connection list would be notified
+ *   of at least one of the events in the flag set.
+ *
+ * Input Parameters:
+ *   list  - The list of connection callbacks to examine
+ *   flags - The bit set of events of interest
+ *
+ * Returned Value:
+ *   True if there is at least one subscriber to the events.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+bool devif_conn_subscribed(FAR struct devif_callback_s *list, uint16_t flags);
+
 /****************************************************************************
  * Name: devif_dev_event
  *
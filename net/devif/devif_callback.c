@@ -459,6 +459,40 @@ uint16_t devif_conn_event(FAR struct net_driver_s *dev, void *pvconn,
   return flags;
 }
 
+/****************************************************************************
+ * Name: devif_conn_subscribed
+ *
+ * Description:
+ *   Return true if any callback in the connection list would be notified
+ *   of at least one of the events in the flag set.  This is used to avoid
+ *   setting up and performing a poll of connections that nobody is
+ *   waiting on.
+ *
+ * Input Parameters:
+ *   list  - The list of connection callbacks to examine
+ *   flags - The bit set of events of interest
+ *
+ * Returned Value:
+ *   True if there is at least one subscriber to the events.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+bool devif_conn_subscribed(FAR struct devif_callback_s *list, uint16_t flags)
+{
+  for (; list != NULL; list = list->nxtconn)
+    {
+      if (list->event != NULL && devif_event_trigger(flags, list->flags))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: devif_dev_event
  *
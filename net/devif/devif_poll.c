@@ -198,6 +198,26 @@ static void devif_packet_conversion(FAR struct net_driver_s *dev,
 #  define devif_packet_conversion(dev,pkttype)
 #endif /* CONFIG_NET_6LOWPAN */
 
+/****************************************************************************
+ * Name: devif_poll_out
+ *
+ * Description:
+ *   Pass the packet produced by a poll, if any, to the driver and add its
+ *   length to the byte count of the device.
+ *
+ ****************************************************************************/
+
+static int devif_poll_out(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback)
+{
+  if (dev->d_len > 0)
+    {
+      NETDEV_TXBYTES(dev, dev->d_len);
+    }
+
+  return callback(dev);
+}
+
 /****************************************************************************
  * Name: devif_poll_pkt_connections
  *
@@ -225,13 +245,20 @@ static int devif_poll_pkt_connections(FAR struct net_driver_s *dev,
 
       pkt_poll(dev, pkt_conn);
 
-      /* Perform any necessary conversions on outgoing packets */
+      /* Most connections have nothing to send on any given poll.  Only
+       * involve the driver when the poll actually produced a packet.
+       */
+
+      if (dev->d_len > 0)
+        {
+          /* Perform any necessary conversions on outgoing packets */
 
-      devif_packet_conversion(dev, DEVIF_PKT);
+          devif_packet_conversion(dev, DEVIF_PKT);
 
-      /* Call back into the driver */
+          /* Call back into the driver */
 
-      bstop = callback(dev);
+          bstop = devif_poll_out(dev, callback);
+        }
     }
 
   return bstop;
@@ -267,7 +294,7 @@ static int devif_poll_ieee802154_connections(FAR struct net_driver_s *dev,
 
       /* Call back into the driver */
 
-      bstop = callback(dev);
+      bstop = devif_poll_out(dev, callback);
     }
 
   return bstop;
@@ -296,7 +323,7 @@ static inline int devif_poll_icmp(FAR struct net_driver_s *dev,
 
   /* Call back into the driver */
 
-  return callback(dev);
+  return devif_poll_out(dev, callback);
 }
 #endif /* CONFIG_NET_ICMP && CONFIG_NET_ICMP_SOCKET */
 
@@ -322,7 +349,7 @@ static inline int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 
   /* Call back into the driver */
 
-  return callback(dev);
+  return devif_poll_out(dev, callback);
 }
 #endif /* CONFIG_NET_ICMPv6_SOCKET || CONFIG_NET_ICMPv6_NEIGHBOR*/
 
@@ -338,6 +365,18 @@ static inline int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 static inline int devif_poll_forward(FAR struct net_driver_s *dev,
                                      devif_poll_callback_t callback)
 {
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+  int bstop;
+
+  /* First send everything queued on the forwarding fast path */
+
+  bstop = ipfwd_fastpoll(dev, callback);
+  if (bstop)
+    {
+      return bstop;
+    }
+#endif
+
   /* Perform the forwarding poll */
 
   ipfwd_poll(dev);
@@ -349,7 +388,7 @@ static inline int devif_poll_forward(FAR struct net_driver_s *dev,
 
   /* Call back into the driver */
 
-  return callback(dev);
+  return devif_poll_out(dev, callback);
 }
 #endif /* CONFIG_NET_ICMPv6_SOCKET || CONFIG_NET_ICMPv6_NEIGHBOR*/
 
@@ -379,7 +418,7 @@ static inline int devif_poll_igmp(FAR struct net_driver_s *dev,
 
   /* Call back into the driver */
 
-  return callback(dev);
+  return devif_poll_out(dev, callback);
 }
 #endif /* CONFIG_NET_IGMP */
 
@@ -410,13 +449,20 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
       udp_poll(dev, conn);
 
-      /* Perform any necessary conversions on outgoing packets */
+      /* Most connections have nothing to send on any given poll.  Only
+       * involve the driver when the poll actually produced a packet.
+       */
 
-      devif_packet_conversion(dev, DEVIF_UDP);
+      if (dev->d_len > 0)
+        {
+          /* Perform any necessary conversions on outgoing packets */
 
-      /* Call back into the driver */
+          devif_packet_conversion(dev, DEVIF_UDP);
 
-      bstop = callback(dev);
+          /* Call back into the driver */
+
+          bstop = devif_poll_out(dev, callback);
+        }
     }
 
   return bstop;
@@ -450,13 +496,20 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 
       tcp_poll(dev, conn);
 
-      /* Perform any necessary conversions on outgoing packets */
+      /* Most connections have nothing to send on any given poll.  Only
+       * involve the driver when the poll actually produced a packet.
+       */
+
+      if (dev->d_len > 0)
+        {
+          /* Perform any necessary conversions on outgoing packets */
 
-      devif_packet_conversion(dev, DEVIF_TCP);
+          devif_packet_conversion(dev, DEVIF_TCP);
 
-      /* Call back into the driver */
+          /* Call back into the driver */
 
-      bstop = callback(dev);
+          bstop = devif_poll_out(dev, callback);
+        }
     }
 
   return bstop;
@@ -494,13 +547,20 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
 
       tcp_timer(dev, conn, hsec);
 
-      /* Perform any necessary conversions on outgoing packets */
+      /* Most connections have nothing to send on any given poll.  Only
+       * involve the driver when the poll actually produced a packet.
+       */
+
+      if (dev->d_len > 0)
+        {
+          /* Perform any necessary conversions on outgoing packets */
 
-      devif_packet_conversion(dev, DEVIF_TCP);
+          devif_packet_conversion(dev, DEVIF_TCP);
 
-      /* Call back into the driver */
+          /* Call back into the driver */
 
-      bstop = callback(dev);
+          bstop = devif_poll_out(dev, callback);
+        }
     }
 
   return bstop;
@@ -552,6 +612,15 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   bstop = arp_poll(dev, callback);
   if (!bstop)
 #endif
+#ifdef CONFIG_NET_ARP_QUEUE
+    {
+      /* Send any packets that were held awaiting ARP resolution */
+
+      bstop = arp_queue_poll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_PKT
     {
       /* Check for pending packet socket transfer */
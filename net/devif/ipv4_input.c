@@ -301,24 +301,14 @@ nullreturn:
 #endif /* CONFIG_NET_TCP_REASSEMBLY */
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: ipv4_input
+ * Name: ipv4_in
  *
  * Description:
- *
- * Returned Value:
- *   OK    - The packet was processed (or dropped) and can be discarded.
- *   ERROR - Hold the packet and try again later.  There is a listening
- *           socket but no receive in place to catch the packet yet.  The
- *           device's d_len will be set to zero in this case as there is
- *           no outgoing data.
+ *   Process one received IPv4 packet.  See ipv4_input() below.
  *
  ****************************************************************************/
 
-int ipv4_input(FAR struct net_driver_s *dev)
+static int ipv4_in(FAR struct net_driver_s *dev)
 {
   FAR struct ipv4_hdr_s *ipv4 = BUF;
   in_addr_t destipaddr;
@@ -505,7 +495,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
         }
     }
 
-  if (ipv4_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCSUMOK(dev) && ipv4_chksum(dev) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
@@ -577,4 +567,57 @@ drop:
   dev->d_len = 0;
   return OK;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_input
+ *
+ * Description:
+ *   Receive an IPv4 packet from the network device.  The lengths of the
+ *   packet and of any response to it are added to the byte counts of the
+ *   device.
+ *
+ * Returned Value:
+ *   OK    - The packet was processed (or dropped) and can be discarded.
+ *   ERROR - Hold the packet and try again later.  There is a listening
+ *           socket but no receive in place to catch the packet yet.  The
+ *           device's d_len will be set to zero in this case as there is
+ *           no outgoing data.
+ *
+ ****************************************************************************/
+
+int ipv4_input(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NETDEV_STATISTICS
+  uint16_t rxlen = dev->d_len;
+#endif
+  int ret;
+
+  ret = ipv4_in(dev);
+
+  /* Count the bytes of the packet once it has been consumed (a held packet
+   * is passed in again later) and those of any response to it.
+   */
+
+  if (ret == OK)
+    {
+      NETDEV_RXBYTES(dev, rxlen);
+      if (dev->d_len > 0)
+        {
+          NETDEV_TXBYTES(dev, dev->d_len);
+        }
+    }
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* The hardware timestamp applied to this packet only */
+
+  dev->d_rxtime.tv_sec  = 0;
+  dev->d_rxtime.tv_nsec = 0;
+#endif
+
+  return ret;
+}
 #endif /* CONFIG_NET_IPv4 */
@@ -208,36 +208,14 @@ static bool check_destipaddr(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: ipv6_input
+ * Name: ipv6_in
  *
  * Description:
- *   Receive an IPv6 packet from the network device.  Verify and forward to
- *   L3 packet handling logic if the packet is destined for us.
- *
- * Input Parameters:
- *   dev   - The device on which the packet was received and which contains
- *           the IPv6 packet.
- * Returned Value:
- *   OK    - The packet was processed (or dropped) and can be discarded.
- *   ERROR - Hold the packet and try again later.  There is a listening
- *           socket but no receive in place to catch the packet yet.  The
- *           device's d_len will be set to zero in this case as there is
- *           no outgoing data.
- *
- *   If this function returns to the network driver with dev->d_len > 0,
- *   that is an indication to the driver that there is an outgoing response
- *   to this input.
- *
- * Assumptions:
- *   The network is locked.
+ *   Process one received IPv6 packet.  See ipv6_input() below.
  *
  ****************************************************************************/
 
-int ipv6_input(FAR struct net_driver_s *dev)
+static int ipv6_in(FAR struct net_driver_s *dev)
 {
   FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
   uint16_t hdrlen;
@@ -491,4 +469,68 @@ drop:
   dev->d_len = 0;
   return OK;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv6_input
+ *
+ * Description:
+ *   Receive an IPv6 packet from the network device.  Verify and forward to
+ *   L3 packet handling logic if the packet is destined for us.  The
+ *   lengths of the packet and of any response to it are added to the byte
+ *   counts of the device.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which contains
+ *           the IPv6 packet.
+ * Returned Value:
+ *   OK    - The packet was processed (or dropped) and can be discarded.
+ *   ERROR - Hold the packet and try again later.  There is a listening
+ *           socket but no receive in place to catch the packet yet.  The
+ *           device's d_len will be set to zero in this case as there is
+ *           no outgoing data.
+ *
+ *   If this function returns to the network driver with dev->d_len > 0,
+ *   that is an indication to the driver that there is an outgoing response
+ *   to this input.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv6_input(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NETDEV_STATISTICS
+  uint16_t rxlen = dev->d_len;
+#endif
+  int ret;
+
+  ret = ipv6_in(dev);
+
+  /* Count the bytes of the packet once it has been consumed (a held packet
+   * is passed in again later) and those of any response to it.
+   */
+
+  if (ret == OK)
+    {
+      NETDEV_RXBYTES(dev, rxlen);
+      if (dev->d_len > 0)
+        {
+          NETDEV_TXBYTES(dev, dev->d_len);
+        }
+    }
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* The hardware timestamp applied to this packet only */
+
+  dev->d_rxtime.tv_sec  = 0;
+  dev->d_rxtime.tv_nsec = 0;
+#endif
+
+  return ret;
+}
 #endif /* CONFIG_NET_IPv6 */
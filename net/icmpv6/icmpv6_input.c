@@ -296,7 +296,8 @@ void icmpv6_input(FAR struct net_driver_s *dev)
               {
                 /* Save the sender's address mapping in our Neighbor Table. */
 
-                neighbor_add(dev, ipicmp->srcipaddr, adv->tgtlladdr);
+                neighbor_add(dev, ipicmp->srcipaddr, adv->tgtlladdr,
+                             (adv->flags[0] & ICMPv6_NADV_FLAG_S) != 0);
 
 #ifdef CONFIG_NET_ICMPv6_NEIGHBOR
                 /* Then notify any logic waiting for the Neighbor Advertisement */
@@ -371,7 +372,8 @@ void icmpv6_input(FAR struct net_driver_s *dev)
 
             if (sllopt->opttype == 1 && sllopt->optlen == 1)
               {
-                neighbor_add(dev, ipicmp->srcipaddr, sllopt->srclladdr);
+                neighbor_add(dev, ipicmp->srcipaddr, sllopt->srclladdr,
+                             false);
               }
 
             FAR struct icmpv6_prefixinfo_s *opt =
@@ -343,6 +343,12 @@ static inline int tcp_close_disconnect(FAR struct socket *psock)
   conn = (FAR struct tcp_conn_s *)psock->s_conn;
   DEBUGASSERT(conn != NULL);
 
+#ifdef CONFIG_NET_TCP_NAGLE
+  /* Don't hold back a partial segment that must be sent before the FIN */
+
+  conn->cork = false;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* If we have a semi-permanent write buffer callback in place, then
    * is needs to be be nullified.
@@ -431,7 +431,8 @@ static inline void inet_udp_readahead(struct inet_recvfrom_s *pstate)
       if (pstate->ir_buflen > 0)
         {
           recvlen = iob_copyout(pstate->ir_buffer, iob, pstate->ir_buflen,
-                                src_addr_size + sizeof(uint8_t));
+                                src_addr_size + sizeof(uint8_t) +
+                                UDP_RA_TSTAMPLEN);
 
           ninfo("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
 
@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "tcp/tcp.h"
@@ -418,6 +419,15 @@ static int inet_bind(FAR struct socket *psock,
       case SOCK_STREAM:
         {
 #ifdef NET_TCP_HAVE_STACK
+#ifdef CONFIG_NET_REUSEPORT
+          FAR struct tcp_conn_s *conn = psock->s_conn;
+
+          /* Pass the SO_REUSEPORT settings to the connection */
+
+          conn->reuseport = _SO_GETOPT(psock->s_options, SO_REUSEPORT);
+          conn->cpu       = psock->s_cpu;
+#endif
+
           /* Bind a TCP/IP stream socket. */
 
           ret = tcp_bind(psock->s_conn, addr);
@@ -440,6 +450,15 @@ static int inet_bind(FAR struct socket *psock,
       case SOCK_DGRAM:
         {
 #ifdef NET_UDP_HAVE_STACK
+#ifdef CONFIG_NET_REUSEPORT
+          FAR struct udp_conn_s *conn = psock->s_conn;
+
+          /* Pass the SO_REUSEPORT settings to the connection */
+
+          conn->reuseport = _SO_GETOPT(psock->s_options, SO_REUSEPORT);
+          conn->cpu       = psock->s_cpu;
+#endif
+
           /* Bind a UDP/IP datagram socket */
 
           ret = udp_bind(psock->s_conn, addr);
@@ -582,6 +601,12 @@ int inet_listen(FAR struct socket *psock, int backlog)
     }
 #endif
 
+#ifdef CONFIG_NET_REUSEPORT
+  /* SO_INCOMING_CPU may have been set after bind() */
+
+  conn->cpu = psock->s_cpu;
+#endif
+
   /* Start listening to the bound port.  This enables callbacks when
    * accept() is called and enables poll()/select() logic.
    */
@@ -1204,7 +1229,7 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
                              size_t count)
 {
 #if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
-  return tcp_sendfile(psock, infile, offset, size_t count);
+  return tcp_sendfile(psock, infile, offset, count);
 #else
   return -ENOSYS;
 #endif
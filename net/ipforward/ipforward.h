@@ -44,6 +44,8 @@
 
 #include <stdint.h>
 
+#include <nuttx/net/netdev.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -253,6 +255,56 @@ int ipfwd_forward(FAR struct forward_s *fwd);
 
 void ipfwd_poll(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: ipfwd_fastpath
+ *
+ * Description:
+ *   Queue a fully prepared packet to be sent on the next TX poll of the
+ *   forwarding device.  Unlike ipfwd_forward(), no device callback is
+ *   allocated; packets on the fast path are sent by ipfwd_fastpoll().
+ *
+ * Input Parameters:
+ *   fwd - An initialized instance of the common forwarding structure.  The
+ *         IOB chain holds the packet with the L3 header already updated.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+void ipfwd_fastpath(FAR struct forward_s *fwd);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_fastpoll
+ *
+ * Description:
+ *   Send all of the packets queued by ipfwd_fastpath() for this device,
+ *   calling back into the driver for each one.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback (non-zero
+ *   means that polling should stop).
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+int ipfwd_fastpoll(FAR struct net_driver_s *dev,
+                   devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: ipfwd_dropstats
  *
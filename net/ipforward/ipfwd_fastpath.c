@@ -0,0 +1,242 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_fastpath.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/net.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Packets waiting to be sent on the fast path, in FIFO order */
+
+static FAR struct forward_s *g_fasthead;
+static FAR struct forward_s *g_fasttail;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_fastremove
+ *
+ * Description:
+ *   Remove one entry from the fast path queue.
+ *
+ ****************************************************************************/
+
+static void ipfwd_fastremove(FAR struct forward_s *prev,
+                             FAR struct forward_s *fwd)
+{
+  if (prev == NULL)
+    {
+      g_fasthead = fwd->f_flink;
+    }
+  else
+    {
+      prev->f_flink = fwd->f_flink;
+    }
+
+  if (g_fasttail == fwd)
+    {
+      g_fasttail = prev;
+    }
+
+  fwd->f_flink = NULL;
+}
+
+/****************************************************************************
+ * Name: ipfwd_fastpurge
+ *
+ * Description:
+ *   Drop every queued packet whose forwarding device has gone down.  These
+ *   would otherwise hold IOBs and forwarding structures forever.
+ *
+ ****************************************************************************/
+
+static void ipfwd_fastpurge(void)
+{
+  FAR struct forward_s *prev = NULL;
+  FAR struct forward_s *fwd;
+  FAR struct forward_s *next;
+
+  for (fwd = g_fasthead; fwd != NULL; fwd = next)
+    {
+      next = fwd->f_flink;
+      if (!IFF_IS_UP(fwd->f_dev->d_flags))
+        {
+          ipfwd_fastremove(prev, fwd);
+          ipfwd_dropstats(fwd);
+          iob_free_chain(fwd->f_iob);
+          ipfwd_free(fwd);
+        }
+      else
+        {
+          prev = fwd;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_fastpath
+ *
+ * Description:
+ *   Queue a fully prepared packet to be sent on the next TX poll of the
+ *   forwarding device.  Unlike ipfwd_forward(), no device callback is
+ *   allocated; packets on the fast path are sent by ipfwd_fastpoll().
+ *
+ * Input Parameters:
+ *   fwd - An initialized instance of the common forwarding structure.  The
+ *         IOB chain holds the packet with the L3 header already updated.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfwd_fastpath(FAR struct forward_s *fwd)
+{
+  DEBUGASSERT(fwd != NULL && fwd->f_iob != NULL && fwd->f_dev != NULL);
+
+  /* Forwarding structures are a limited resource; don't let a dead
+   * interface hold on to them.
+   */
+
+  ipfwd_fastpurge();
+
+  fwd->f_flink = NULL;
+  if (g_fasttail == NULL)
+    {
+      g_fasthead = fwd;
+    }
+  else
+    {
+      g_fasttail->f_flink = fwd;
+    }
+
+  g_fasttail = fwd;
+
+  /* Notify the forwarding device that TX data is available */
+
+  netdev_txnotify_dev(fwd->f_dev);
+}
+
+/****************************************************************************
+ * Name: ipfwd_fastpoll
+ *
+ * Description:
+ *   Send all of the packets queued by ipfwd_fastpath() for this device,
+ *   calling back into the driver for each one.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the driver callback (non-zero
+ *   means that polling should stop).
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+int ipfwd_fastpoll(FAR struct net_driver_s *dev,
+                   devif_poll_callback_t callback)
+{
+  FAR struct forward_s *prev = NULL;
+  FAR struct forward_s *fwd;
+  FAR struct forward_s *next;
+  int bstop = 0;
+
+  for (fwd = g_fasthead; fwd != NULL && !bstop; fwd = next)
+    {
+      next = fwd->f_flink;
+      if (fwd->f_dev != dev)
+        {
+          prev = fwd;
+          continue;
+        }
+
+      ipfwd_fastremove(prev, fwd);
+
+      /* Copy the packet into the device's d_buf and let the driver send
+       * it.  The driver adds the Ethernet header; the next hop is
+       * normally still in the ARP table.
+       */
+
+#ifdef CONFIG_NET_IPv6
+      IFF_SET_IPv4(dev->d_flags);
+#endif
+      dev->d_appdata = NULL;
+      devif_forward(fwd);
+
+      iob_free_chain(fwd->f_iob);
+      ipfwd_free(fwd);
+
+      bstop = callback(dev);
+    }
+
+  return bstop;
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FASTPATH */
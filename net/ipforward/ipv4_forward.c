@@ -49,6 +49,8 @@
 #include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
+#include "arp/arp.h"
+#include "route/route.h"
 #include "utils/utils.h"
 #include "sixlowpan/sixlowpan.h"
 #include "ipforward/ipforward.h"
@@ -146,7 +148,7 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t sum;
+  uint32_t sum;
   int ttl = (int)ipv4->ttl - 1;
 
   if (ttl <= 0)
@@ -165,23 +167,14 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   ipv4->ttl = ttl;
 
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Update the IPv4 header checksum.  Rather than re-calculating it over
+   * the whole header, adjust it incrementally (RFC 1624):  The TTL is the
+   * upper byte of a 16-bit word so decrementing it by one lowers that word
+   * by 0x0100 and the one's complement checksum rises by the same amount.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, IPv4_HDRLEN);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = htons(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  sum            = (uint32_t)ipv4->ipchksum + HTONS(0x0100);
+  ipv4->ipchksum = (uint16_t)(sum + (sum >= 0xffff));
   return ttl;
 }
 
@@ -243,8 +236,8 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
   /* Initialize the easy stuff in the forwarding structure */
 
   fwd->f_dev    = fwddev;  /* Forwarding device */
-#ifdef CONFIG_NET_IPv5
-  fwd->f_domain = PF_INET; /* IPv64 address domain */
+#ifdef CONFIG_NET_IPv6
+  fwd->f_domain = PF_INET; /* IPv4 address domain */
 #endif
 
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -336,6 +329,143 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: ipv4_fwd_cached
+ *
+ * Description:
+ *   Return true if the packet can take the forwarding fast path:  The
+ *   forwarding device is an Ethernet device and the MAC address of the
+ *   next hop is already in the ARP table.
+ *
+ * Input Parameters:
+ *   fwddev     - The device on which the packet must be forwarded.
+ *   destipaddr - The destination address of the packet.
+ *
+ * Returned Value:
+ *   True if the fast path may be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+static bool ipv4_fwd_cached(FAR struct net_driver_s *fwddev,
+                            in_addr_t destipaddr)
+{
+  in_addr_t nexthop;
+
+  if (fwddev->d_lltype != NET_LL_ETHERNET)
+    {
+      return false;
+    }
+
+  /* Select the next hop the same way that arp_out() will */
+
+  if (net_ipv4addr_maskcmp(destipaddr, fwddev->d_ipaddr, fwddev->d_netmask))
+    {
+      net_ipv4addr_copy(nexthop, destipaddr);
+    }
+  else
+    {
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv4_router(fwddev, destipaddr, &nexthop);
+#else
+      net_ipv4addr_copy(nexthop, fwddev->d_draddr);
+#endif
+    }
+
+  return arp_find(nexthop) != NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv4_fast_forward
+ *
+ * Description:
+ *   This function is called from ipv4_forward for a unicast packet that
+ *   must be sent on a different device and whose next hop is already
+ *   resolved.  The TTL is decremented in place, the packet is copied once
+ *   into an IOB chain and is queued to be sent on the next TX poll of the
+ *   forwarding device.  No per-packet device callback is needed.
+ *
+ * Input Parameters:
+ *   dev      - The device on which the packet was received and which
+ *              contains the IPv4 packet.
+ *   fwdddev  - The device on which the packet must be forwarded.
+ *   ipv4     - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was successfully forward;  A negated
+ *   errno value is returned if the packet is not forwardable.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+static int ipv4_fast_forward(FAR struct net_driver_s *dev,
+                             FAR struct net_driver_s *fwddev,
+                             FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct forward_s *fwd;
+  int ret;
+
+  /* We provide no support for fragmenting forwarded packets */
+
+  if (NET_LL_HDRLEN(fwddev) + dev->d_len > NET_DEV_MTU(fwddev))
+    {
+      nwarn("WARNING: Packet > MTU... Dropping\n");
+      return -EFBIG;
+    }
+
+  /* The packet is not needed again once it is copied so the TTL can be
+   * updated in the receive buffer.  This also means that we don't copy
+   * packets that are going to be dropped.
+   */
+
+  if (ipv4_decr_ttl(ipv4) < 1)
+    {
+      nwarn("WARNING: Hop limit exceeded... Dropping!\n");
+      return -EMULTIHOP;
+    }
+
+  fwd = ipfwd_alloc();
+  if (fwd == NULL)
+    {
+      nwarn("WARNING: Failed to allocate forwarding structure\n");
+      return -ENOMEM;
+    }
+
+  fwd->f_dev    = fwddev;
+#ifdef CONFIG_NET_IPv6
+  fwd->f_domain = PF_INET;
+#endif
+
+  fwd->f_iob = iob_tryalloc(false);
+  if (fwd->f_iob == NULL)
+    {
+      nwarn("WARNING: iob_tryalloc() failed\n");
+      ret = -ENOMEM;
+      goto errout_with_fwd;
+    }
+
+  ret = iob_trycopyin(fwd->f_iob, (FAR const uint8_t *)ipv4,
+                      dev->d_len, 0, false);
+  if (ret < 0)
+    {
+      nwarn("WARNING: iob_trycopyin() failed: %d\n", ret);
+      goto errout_with_iobchain;
+    }
+
+  ipfwd_fastpath(fwd);
+  dev->d_len = 0;
+  return OK;
+
+errout_with_iobchain:
+  iob_free_chain(fwd->f_iob);
+
+errout_with_fwd:
+  ipfwd_free(fwd);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_forward_callback
  *
@@ -449,9 +579,21 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
 
   if (fwddev != dev)
     {
-      /* Send the packet asynchrously on the forwarding device. */
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+      /* Take the fast path if the next hop is already resolved */
+
+      if (ipv4_fwd_cached(fwddev, destipaddr))
+        {
+          ret = ipv4_fast_forward(dev, fwddev, ipv4);
+        }
+      else
+#endif
+        {
+          /* Send the packet asynchrously on the forwarding device. */
+
+          ret = ipv4_dev_forward(dev, fwddev, ipv4);
+        }
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
@@ -77,6 +77,18 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+/* Connection-oriented socket types */
+
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+#  define LOCAL_ISCONNTYPE(t) ((t) == SOCK_STREAM || (t) == SOCK_SEQPACKET)
+#else
+#  define LOCAL_ISCONNTYPE(t) ((t) == SOCK_STREAM)
+#endif
+
+#ifdef CONFIG_NET_LOCAL_RING
+#  define LOCAL_RING_NPOLLWAITERS 2
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -111,6 +123,34 @@ enum local_state_s
   LOCAL_STATE_DISCONNECTED     /* Peer disconnected */
 };
 
+/* One direction of a connection between two peers when
+ * CONFIG_NET_LOCAL_RING is selected.  The ring is shared by the sending
+ * and the receiving peer and is freed when both have released it.
+ */
+
+#ifdef CONFIG_NET_LOCAL_RING
+struct local_ring_s
+{
+  uint8_t lr_crefs;            /* Number of peers attached to the ring */
+  bool lr_rdclosed;            /* The receiving peer has been closed */
+  bool lr_wrclosed;            /* The sending peer has been closed */
+  uint16_t lr_head;            /* Index of the next byte to be written */
+  uint16_t lr_count;           /* Number of bytes in the ring */
+  sem_t lr_rdsem;              /* Receivers wait here for data */
+  sem_t lr_wrsem;              /* Senders wait here for space */
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+  uint8_t lr_rechead;          /* Index of the next record length to add */
+  uint8_t lr_nrecs;            /* Number of complete records in the ring */
+  uint16_t lr_reclen[CONFIG_NET_LOCAL_NRECORDS]; /* Record lengths */
+#endif
+#ifdef HAVE_LOCAL_POLL
+  struct pollfd *lr_rdfds[LOCAL_RING_NPOLLWAITERS]; /* Polling receivers */
+  struct pollfd *lr_wrfds[LOCAL_RING_NPOLLWAITERS]; /* Polling senders */
+#endif
+  uint8_t lr_buffer[CONFIG_NET_LOCAL_RINGSIZE]; /* Ring buffer data */
+};
+#endif
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -155,6 +195,11 @@ struct local_conn_s
 
   sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  FAR struct local_ring_s *lc_rxring; /* Data coming from the peer */
+  FAR struct local_ring_s *lc_txring; /* Data going to the peer */
+#endif
+
 #ifdef HAVE_LOCAL_POLL
   /* The following is a list if poll structures of threads waiting for
    * socket accept events.
@@ -652,6 +697,85 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
 #endif
 
 
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate the pair of ring buffers for a new connection between the
+ *   accepting server-side peer and the connecting client.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+int local_ring_alloc(FAR struct local_conn_s *server,
+                     FAR struct local_conn_s *client);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach a peer from the rings of its connection, waking up the other
+ *   peer.  Each ring is freed when the last peer detaches.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+void local_ring_release(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy data into the ring going to the peer.  On a SOCK_SEQPACKET
+ *   connection, the data is sent as one record.
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const uint8_t *buf,
+                        size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy data out of the ring coming from the peer.  On a SOCK_SEQPACKET
+ *   connection, one record is received and any part of it that does not
+ *   fit in the buffer is discarded.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero if the peer has closed the
+ *   connection, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR uint8_t *buf,
+                        size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of events on the rings of a connection.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_RING) && defined(HAVE_LOCAL_POLL)
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+                         FAR struct pollfd *fds, bool setup);
+#endif
+
 /****************************************************************************
  * Name: local_accept_pollnotify
  ****************************************************************************/
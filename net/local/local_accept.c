@@ -125,7 +125,7 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   /* Is the socket a stream? */
 
-  if (psock->s_domain != PF_LOCAL || psock->s_type != SOCK_STREAM)
+  if (psock->s_domain != PF_LOCAL || !LOCAL_ISCONNTYPE(psock->s_type))
     {
       return -EOPNOTSUPP;
     }
@@ -136,7 +136,7 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   server = (FAR struct local_conn_s *)psock->s_conn;
 
-  if (server->lc_proto != SOCK_STREAM ||
+  if (!LOCAL_ISCONNTYPE(server->lc_proto) ||
       server->lc_state != LOCAL_STATE_LISTENING ||
       server->lc_type  != LOCAL_TYPE_PATHNAME)
     {
@@ -176,7 +176,7 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               /* Initialize the new connection structure */
 
               conn->lc_crefs  = 1;
-              conn->lc_proto  = SOCK_STREAM;
+              conn->lc_proto  = server->lc_proto;
               conn->lc_type   = LOCAL_TYPE_PATHNAME;
               conn->lc_state  = LOCAL_STATE_CONNECTED;
 
@@ -184,6 +184,16 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX-1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_RING
+              /* Attach the rings shared by the two peers */
+
+              ret = local_ring_alloc(conn, client);
+              if (ret < 0)
+                {
+                   nerr("ERROR: Failed to allocate rings for %s: %d\n",
+                        conn->lc_path, ret);
+                }
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -195,8 +205,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                    nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                         conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_RING
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -222,6 +234,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+            }
+#endif
+
+          if (ret == OK)
+            {
 
               /* Return the address family */
 
@@ -236,7 +253,7 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               /* Setup the client socket structure */
 
               newsock->s_domain = psock->s_domain;
-              newsock->s_type   = SOCK_STREAM;
+              newsock->s_type   = psock->s_type;
               newsock->s_sockif = psock->s_sockif;
               newsock->s_conn   = (FAR void *)conn;
             }
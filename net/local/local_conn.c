@@ -141,9 +141,15 @@ void local_free(FAR struct local_conn_s *conn)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Detach from the rings shared with the peer */
+
+  local_ring_release(conn);
+#else
   /* Destroy all FIFOs associted with the connection */
 
   local_release_fifos(conn);
+#endif
   nxsem_destroy(&conn->lc_waitsem);
 #endif
 
@@ -156,6 +156,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifndef CONFIG_NET_LOCAL_RING
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -183,6 +184,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   /* Add ourself to the list of waiting connections and notify the server. */
 
@@ -209,6 +211,24 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 
   /* Did we successfully connect? */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (ret < 0)
+    {
+      /* There is nothing to clean up.  The server only attaches the rings
+       * when the connection is accepted.
+       */
+
+      nerr("ERROR: Failed to connect: %d\n", ret);
+      client->lc_state = LOCAL_STATE_BOUND;
+      return ret;
+    }
+
+  /* The server has attached the shared rings to both peers */
+
+  DEBUGASSERT(client->lc_rxring != NULL && client->lc_txring != NULL);
+  client->lc_state = LOCAL_STATE_CONNECTED;
+  return OK;
+#else
   if (ret < 0)
     {
       nerr("ERROR: Failed to connect: %d\n", ret);
@@ -237,6 +257,7 @@ errout_with_fifos:
   (void)local_release_fifos(client);
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
+#endif /* CONFIG_NET_LOCAL_RING */
 }
 
 /****************************************************************************
@@ -292,7 +313,7 @@ int psock_local_connect(FAR struct socket *psock,
        */
 
       DEBUGASSERT(conn->lc_state == LOCAL_STATE_LISTENING &&
-                  conn->lc_proto == SOCK_STREAM);
+                  LOCAL_ISCONNTYPE(conn->lc_proto));
 
       /* Handle according to the server connection type */
 
@@ -313,6 +334,14 @@ int psock_local_connect(FAR struct socket *psock,
               {
                 int ret = OK;
 
+                /* The client must be of the same type as the server */
+
+                if (psock->s_type != conn->lc_proto)
+                  {
+                    net_unlock();
+                    return -EPROTOTYPE;
+                  }
+
                 /* Bind the address and protocol */
 
                 client->lc_proto = conn->lc_proto;
@@ -326,7 +355,7 @@ int psock_local_connect(FAR struct socket *psock,
 
                 /* We have to do more for the SOCK_STREAM family */
 
-                if (conn->lc_proto == SOCK_STREAM)
+                if (LOCAL_ISCONNTYPE(conn->lc_proto))
                   {
                     ret = local_stream_connect(client, conn,
                                                _SS_ISNONBLOCK(psock->s_flags));
@@ -200,6 +200,17 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       goto pollerr;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Connected peers are monitored on the rings that they share */
+
+  ret = local_ring_pollsetup(conn, fds, true);
+  if (ret < 0)
+    {
+      fds->priv = NULL;
+      goto pollerr;
+    }
+#else
+
   switch (fds->events & (POLLIN | POLLOUT))
     {
       case (POLLIN | POLLOUT):
@@ -289,6 +300,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
         ret = OK;
         break;
     }
+#endif /* CONFIG_NET_LOCAL_RING */
 #endif
 
   return ret;
@@ -340,6 +352,9 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return OK;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  status = local_ring_pollsetup(conn, fds, false);
+#else
   switch (fds->events & (POLLIN | POLLOUT))
     {
       case (POLLIN | POLLOUT):
@@ -396,6 +411,7 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       default:
         break;
     }
+#endif /* CONFIG_NET_LOCAL_RING */
 #endif
 
   return status;
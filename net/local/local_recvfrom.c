@@ -159,6 +159,17 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Copy the data directly out of the ring shared with the peer */
+
+  ret = local_ring_recv(conn, buf, len, _SS_ISNONBLOCK(psock->s_flags));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   /* The incoming FIFO should be open */
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
@@ -199,6 +210,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
   conn->u.peer.lc_remaining -= readlen;
+#endif
 
   /* Return the address family */
 
@@ -424,7 +436,7 @@ ssize_t local_recvfrom(FAR struct socket *psock, FAR void *buf,
   /* Check for a stream socket */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-  if (psock->s_type == SOCK_STREAM)
+  if (LOCAL_ISCONNTYPE(psock->s_type))
     {
       return psock_stream_recvfrom(psock, buf, len, flags, from, fromlen);
     }
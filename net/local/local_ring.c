@@ -0,0 +1,683 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define LOCAL_RING_SPACE(r) (CONFIG_NET_LOCAL_RINGSIZE - (r)->lr_count)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_create
+ *
+ * Description:
+ *   Allocate and initialize one ring buffer.  The ring is created with a
+ *   reference for each of the two peers.
+ *
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_create(void)
+{
+  FAR struct local_ring_s *ring;
+
+  ring = (FAR struct local_ring_s *)kmm_zalloc(sizeof(struct local_ring_s));
+  if (ring != NULL)
+    {
+      ring->lr_crefs = 2;
+
+      /* These semaphores are used for signaling and, hence, should not
+       * have priority inheritance enabled.
+       */
+
+      nxsem_init(&ring->lr_rdsem, 0, 0);
+      nxsem_setprotocol(&ring->lr_rdsem, SEM_PRIO_NONE);
+      nxsem_init(&ring->lr_wrsem, 0, 0);
+      nxsem_setprotocol(&ring->lr_wrsem, SEM_PRIO_NONE);
+    }
+
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_detach
+ *
+ * Description:
+ *   Drop one peer's reference to a ring and free the ring if it was the
+ *   last one.
+ *
+ ****************************************************************************/
+
+static void local_ring_detach(FAR struct local_ring_s *ring)
+{
+  DEBUGASSERT(ring->lr_crefs > 0);
+
+  if (--ring->lr_crefs == 0)
+    {
+      nxsem_destroy(&ring->lr_rdsem);
+      nxsem_destroy(&ring->lr_wrsem);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on a ring semaphore.
+ *
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) >= 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_pollnotify
+ *
+ * Description:
+ *   Report events to the threads polling one side of a ring.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static void local_ring_pollnotify(FAR struct pollfd **slots,
+                                  pollevent_t eventset)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = slots[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset) |
+                          (eventset & (POLLERR | POLLHUP));
+          if (fds->revents != 0)
+            {
+              ninfo("Report events: %02x\n", fds->revents);
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+#else
+#  define local_ring_pollnotify(s,e)
+#endif
+
+/****************************************************************************
+ * Name: local_ring_put
+ *
+ * Description:
+ *   Copy as much data into the ring as there is space for.
+ *
+ ****************************************************************************/
+
+static size_t local_ring_put(FAR struct local_ring_s *ring,
+                             FAR const uint8_t *buf, size_t len)
+{
+  size_t ncopy;
+  size_t nhead;
+
+  ncopy = MIN(len, LOCAL_RING_SPACE(ring));
+
+  /* Copy up to the end of the buffer, then wrap around to the beginning */
+
+  nhead = MIN(ncopy, CONFIG_NET_LOCAL_RINGSIZE - ring->lr_head);
+  memcpy(&ring->lr_buffer[ring->lr_head], buf, nhead);
+  memcpy(ring->lr_buffer, buf + nhead, ncopy - nhead);
+
+  ring->lr_head   = (ring->lr_head + ncopy) % CONFIG_NET_LOCAL_RINGSIZE;
+  ring->lr_count += ncopy;
+  return ncopy;
+}
+
+/****************************************************************************
+ * Name: local_ring_get
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the ring.  If 'buf' is NULL, the data is
+ *   simply discarded.
+ *
+ ****************************************************************************/
+
+static size_t local_ring_get(FAR struct local_ring_s *ring,
+                             FAR uint8_t *buf, size_t len)
+{
+  size_t ncopy;
+  size_t ntail;
+  size_t tail;
+
+  ncopy = MIN(len, ring->lr_count);
+  tail  = (ring->lr_head + CONFIG_NET_LOCAL_RINGSIZE - ring->lr_count) %
+          CONFIG_NET_LOCAL_RINGSIZE;
+
+  if (buf != NULL)
+    {
+      ntail = MIN(ncopy, CONFIG_NET_LOCAL_RINGSIZE - tail);
+      memcpy(buf, &ring->lr_buffer[tail], ntail);
+      memcpy(buf + ntail, ring->lr_buffer, ncopy - ntail);
+    }
+
+  ring->lr_count -= ncopy;
+  return ncopy;
+}
+
+/****************************************************************************
+ * Name: local_ring_addfds and local_ring_remfds
+ *
+ * Description:
+ *   Bind a poll structure to, or unbind it from, one side of a ring.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static int local_ring_addfds(FAR struct pollfd **slots,
+                             FAR struct pollfd *fds)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      if (slots[i] == NULL)
+        {
+          slots[i] = fds;
+          return OK;
+        }
+    }
+
+  return -EBUSY;
+}
+
+static void local_ring_remfds(FAR struct pollfd **slots,
+                              FAR struct pollfd *fds)
+{
+  int i;
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      if (slots[i] == fds)
+        {
+          slots[i] = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate the pair of ring buffers for a new connection between the
+ *   accepting server-side peer and the connecting client.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings could not be allocated.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *server,
+                     FAR struct local_conn_s *client)
+{
+  FAR struct local_ring_s *sc;
+  FAR struct local_ring_s *cs;
+
+  sc = local_ring_create();
+  if (sc == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  cs = local_ring_create();
+  if (cs == NULL)
+    {
+      sc->lr_crefs = 1;
+      local_ring_detach(sc);
+      return -ENOMEM;
+    }
+
+  net_lock();
+  server->lc_txring = sc;
+  server->lc_rxring = cs;
+  client->lc_txring = cs;
+  client->lc_rxring = sc;
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach a peer from the rings of its connection, waking up the other
+ *   peer.  Each ring is freed when the last peer detaches.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+  FAR struct local_ring_s *ring;
+
+  net_lock();
+
+  /* The peer will receive end-of-file once it has drained the data that
+   * we sent.
+   */
+
+  ring = conn->lc_txring;
+  if (ring != NULL)
+    {
+      ring->lr_wrclosed = true;
+      local_ring_wakeup(&ring->lr_rdsem);
+      local_ring_pollnotify(ring->lr_rdfds, POLLIN | POLLHUP);
+      local_ring_detach(ring);
+      conn->lc_txring = NULL;
+    }
+
+  /* Any further sends by the peer will fail */
+
+  ring = conn->lc_rxring;
+  if (ring != NULL)
+    {
+      ring->lr_rdclosed = true;
+      local_ring_wakeup(&ring->lr_wrsem);
+      local_ring_pollnotify(ring->lr_wrfds, POLLERR | POLLHUP);
+      local_ring_detach(ring);
+      conn->lc_rxring = NULL;
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy data into the ring going to the peer.  On a SOCK_SEQPACKET
+ *   connection, the data is sent as one record.
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const uint8_t *buf,
+                        size_t len, bool nonblock)
+{
+  FAR struct local_ring_s *ring;
+  size_t nsent = 0;
+  ssize_t ret;
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+  bool record = (conn->lc_proto == SOCK_SEQPACKET);
+
+  /* A record is never split, so it must fit in the ring */
+
+  if (record && len > CONFIG_NET_LOCAL_RINGSIZE)
+    {
+      return -EMSGSIZE;
+    }
+#else
+  if (len == 0)
+    {
+      return 0;
+    }
+#endif
+
+  net_lock();
+
+  ring = conn->lc_txring;
+  if (ring == NULL)
+    {
+      net_unlock();
+      return -ENOTCONN;
+    }
+
+  for (; ; )
+    {
+      bool ready;
+
+      /* Has the peer gone away? */
+
+      if (ring->lr_rdclosed)
+        {
+          ret = nsent > 0 ? (ssize_t)nsent : -EPIPE;
+          break;
+        }
+
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      if (record)
+        {
+          ready = LOCAL_RING_SPACE(ring) >= len &&
+                  ring->lr_nrecs < CONFIG_NET_LOCAL_NRECORDS;
+        }
+      else
+#endif
+        {
+          ready = LOCAL_RING_SPACE(ring) > 0 || len == 0;
+        }
+
+      if (ready)
+        {
+          nsent += local_ring_put(ring, buf + nsent, len - nsent);
+
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+          if (record)
+            {
+              ring->lr_reclen[ring->lr_rechead] = (uint16_t)len;
+              ring->lr_rechead = (ring->lr_rechead + 1) %
+                                 CONFIG_NET_LOCAL_NRECORDS;
+              ring->lr_nrecs++;
+            }
+#endif
+
+          local_ring_wakeup(&ring->lr_rdsem);
+          local_ring_pollnotify(ring->lr_rdfds, POLLIN);
+
+          if (nsent >= len)
+            {
+              ret = nsent;
+              break;
+            }
+
+          continue;
+        }
+
+      if (nonblock)
+        {
+          ret = nsent > 0 ? (ssize_t)nsent : -EAGAIN;
+          break;
+        }
+
+      /* Wait for the peer to make space in the ring */
+
+      ret = net_lockedwait(&ring->lr_wrsem);
+      if (ret < 0)
+        {
+          ret = nsent > 0 ? (ssize_t)nsent : ret;
+          break;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy data out of the ring coming from the peer.  On a SOCK_SEQPACKET
+ *   connection, one record is received and any part of it that does not
+ *   fit in the buffer is discarded.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero if the peer has closed the
+ *   connection, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR uint8_t *buf,
+                        size_t len, bool nonblock)
+{
+  FAR struct local_ring_s *ring;
+  ssize_t ret;
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+  bool record = (conn->lc_proto == SOCK_SEQPACKET);
+#endif
+
+  net_lock();
+
+  ring = conn->lc_rxring;
+  if (ring == NULL)
+    {
+      net_unlock();
+      return -ENOTCONN;
+    }
+
+  for (; ; )
+    {
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      if (record && ring->lr_nrecs > 0)
+        {
+          uint16_t reclen;
+          int rectail;
+
+          rectail = (ring->lr_rechead + CONFIG_NET_LOCAL_NRECORDS -
+                     ring->lr_nrecs) % CONFIG_NET_LOCAL_NRECORDS;
+          reclen  = ring->lr_reclen[rectail];
+
+          /* Return what fits in the buffer and discard the rest */
+
+          ret = local_ring_get(ring, buf, MIN(reclen, len));
+          (void)local_ring_get(ring, NULL, reclen - ret);
+          ring->lr_nrecs--;
+          break;
+        }
+      else if (!record && ring->lr_count > 0)
+#else
+      if (ring->lr_count > 0)
+#endif
+        {
+          ret = local_ring_get(ring, buf, len);
+          break;
+        }
+
+      /* The ring is empty.  Return end-of-file if the peer has gone away */
+
+      if (ring->lr_wrclosed)
+        {
+          ret = 0;
+          goto errout;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      /* Wait for the peer to send more data */
+
+      ret = net_lockedwait(&ring->lr_rdsem);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Let the peer know that there is space in the ring */
+
+  local_ring_wakeup(&ring->lr_wrsem);
+  local_ring_pollnotify(ring->lr_wrfds, POLLOUT);
+
+errout:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of events on the rings of a connection.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+                         FAR struct pollfd *fds, bool setup)
+{
+  FAR struct local_ring_s *rx;
+  FAR struct local_ring_s *tx;
+  pollevent_t eventset;
+  int ret = OK;
+
+  net_lock();
+
+  rx = conn->lc_rxring;
+  tx = conn->lc_txring;
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll. */
+
+      if (rx != NULL)
+        {
+          local_ring_remfds(rx->lr_rdfds, fds);
+        }
+
+      if (tx != NULL)
+        {
+          local_ring_remfds(tx->lr_wrfds, fds);
+        }
+
+      goto errout;
+    }
+
+  if (rx == NULL || tx == NULL)
+    {
+      ret = -ENOTCONN;
+      goto errout;
+    }
+
+  /* Bind the poll structure to the sides of the rings that it is
+   * interested in.
+   */
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      ret = local_ring_addfds(rx->lr_rdfds, fds);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  if ((fds->events & POLLOUT) != 0)
+    {
+      ret = local_ring_addfds(tx->lr_wrfds, fds);
+      if (ret < 0)
+        {
+          local_ring_remfds(rx->lr_rdfds, fds);
+          goto errout;
+        }
+    }
+
+  /* Report any events that are already pending */
+
+  eventset = 0;
+  if (rx->lr_count > 0)
+    {
+      eventset |= POLLIN;
+    }
+
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+  if (rx->lr_nrecs > 0)
+    {
+      eventset |= POLLIN;
+    }
+#endif
+
+  if (rx->lr_wrclosed)
+    {
+      eventset |= (POLLIN | POLLHUP);
+    }
+
+  if (LOCAL_RING_SPACE(tx) > 0)
+    {
+      eventset |= POLLOUT;
+    }
+
+  if (tx->lr_rdclosed)
+    {
+      eventset |= POLLERR;
+    }
+
+  fds->revents |= (fds->events & eventset) | (eventset & (POLLERR | POLLHUP));
+  if (fds->revents != 0)
+    {
+      nxsem_post(fds->sem);
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET_LOCAL_RING */
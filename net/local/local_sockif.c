@@ -194,6 +194,18 @@ static int local_setup(FAR struct socket *psock, int protocol)
         return local_sockif_alloc(psock);
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+        if (protocol != 0)
+          {
+            return -EPROTONOSUPPORT;
+          }
+
+        /* Allocate and attach the local connection structure */
+
+        return local_sockif_alloc(psock);
+#endif /* CONFIG_NET_LOCAL_SEQPACKET */
+
 #ifdef CONFIG_NET_LOCAL_DGRAM
       case SOCK_DGRAM:
         if (protocol != 0 && protocol != IPPROTO_UDP)
@@ -302,6 +314,9 @@ static int local_bind(FAR struct socket *psock,
 #ifdef CONFIG_NET_LOCAL_STREAM
       case SOCK_STREAM:
 #endif
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
 #ifdef CONFIG_NET_LOCAL_DGRAM
       case SOCK_DGRAM:
 #endif
@@ -499,6 +514,9 @@ static int local_connect(FAR struct socket *psock,
     {
 #ifdef CONFIG_NET_LOCAL_STREAM
       case SOCK_STREAM:
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
         {
           /* Verify that the socket is not already connected */
 
@@ -651,6 +669,9 @@ static ssize_t local_send(FAR struct socket *psock, FAR const void *buf,
     {
 #ifdef CONFIG_NET_LOCAL_STREAM
       case SOCK_STREAM:
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
         {
           /* Local TCP packet send */
 
@@ -764,6 +785,9 @@ static int local_close(FAR struct socket *psock)
 #ifdef CONFIG_NET_LOCAL_STREAM
       case SOCK_STREAM:
 #endif
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
 #ifdef CONFIG_NET_LOCAL_DGRAM
       case SOCK_DGRAM:
 #endif
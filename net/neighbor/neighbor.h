@@ -46,6 +46,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <net/ethernet.h>
 
@@ -64,8 +65,44 @@
 #  define CONFIG_NET_IPv6_NCONF_ENTRIES 8
 #endif
 
+#ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#  define CONFIG_NET_IPv6_NCONF_HASHSIZE 8
+#endif
+
+#ifndef CONFIG_NET_IPv6_REACHABLE_TIME
+#  define CONFIG_NET_IPv6_REACHABLE_TIME 30
+#endif
+
 #define NEIGHBOR_MAXTIME 128
 
+/* RFC 4861 protocol constants, in units of half seconds */
+
+#define NEIGHBOR_REACHABLE_TIME  (2 * CONFIG_NET_IPv6_REACHABLE_TIME)
+#define NEIGHBOR_DELAY_TIME      (2 * 5) /* DELAY_FIRST_PROBE_TIME */
+#define NEIGHBOR_RETRANS_TIME    (2 * 1) /* RETRANS_TIMER */
+#define NEIGHBOR_MAX_PROBES      3       /* MAX_UNICAST_SOLICIT */
+
+/* Neighbor cache entry states (RFC 4861, section 7.3.2).  There is no
+ * INCOMPLETE state:  Address resolution in progress is tracked by the
+ * ICMPv6 neighbor logic and an entry is only created when the link layer
+ * address is known.
+ */
+
+#define NEIGHBOR_STATE_FREE      0 /* Entry is not in use */
+#define NEIGHBOR_STATE_REACHABLE 1 /* Reachability recently confirmed */
+#define NEIGHBOR_STATE_STALE     2 /* Not confirmed recently;  still usable */
+#define NEIGHBOR_STATE_DELAY     3 /* Traffic sent while STALE; waiting for
+                                    * an upper layer confirmation */
+#define NEIGHBOR_STATE_PROBE     4 /* Sending Neighbor Solicitations */
+
+/* Hash of an IPv6 address into the neighbor hash table.  Neighbors
+ * normally share a prefix so only the interface identifier is hashed.
+ */
+
+#define NEIGHBOR_HASH(a) \
+  ((uint16_t)((a)[4] ^ (a)[5] ^ (a)[6] ^ (a)[7]) % \
+   CONFIG_NET_IPv6_NCONF_HASHSIZE)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -94,9 +131,14 @@ struct neighbor_addr_s
 
 struct neighbor_entry
 {
+  FAR struct neighbor_entry *ne_flink; /* Next entry in the hash chain */
   net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
   struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
   uint8_t                ne_time;    /* For aging, units of half seconds */
+  uint8_t                ne_state;   /* See NEIGHBOR_STATE_* definitions */
+  uint8_t                ne_timer;   /* Time left in the state (half secs) */
+  uint8_t                ne_probes;  /* Number of probes sent */
+  bool                   ne_probe;   /* A probe is due */
 };
 
 /****************************************************************************
@@ -109,6 +151,11 @@ struct neighbor_entry
 
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash chains of the Neighbor table entries that are in use */
+
+extern FAR struct neighbor_entry *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -152,6 +199,23 @@ void neighbor_initialize(void);
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_delete
+ *
+ * Description:
+ *   Remove an entry from the Neighbor Table, making it available for
+ *   re-use.
+ *
+ * Input Parameters:
+ *   neighbor - The table entry to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_delete(FAR struct neighbor_entry *neighbor);
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -160,9 +224,13 @@ FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
  *   already there).
  *
  * Input Parameters:
- *   dev    - Driver instance associated with the MAC
- *   ipaddr - The IPv6 address of the mapping.
- *   addr   - The link layer address of the mapping
+ *   dev       - Driver instance associated with the MAC
+ *   ipaddr    - The IPv6 address of the mapping.
+ *   addr      - The link layer address of the mapping
+ *   reachable - True if the mapping comes from a solicited Neighbor
+ *               Advertisement and so confirms reachability.  Otherwise the
+ *               entry is created in (or, if the link layer address changed,
+ *               moved to) the STALE state.
  *
  * Returned Value:
  *   None
@@ -170,13 +238,15 @@ FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
  ****************************************************************************/
 
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
-                  FAR uint8_t *addr);
+                  FAR uint8_t *addr, bool reachable);
 
 /****************************************************************************
  * Name:  neighbor_lookup
  *
  * Description:
  *   Find an entry in the Neighbor Table and return its link layer address.
+ *   This is called when a packet is about to be sent to the neighbor:  A
+ *   STALE entry moves to the DELAY state.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
@@ -184,7 +254,9 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
  * Returned Value:
  *   A read-only reference to the link layer address in the Neighbor Table is
  *   returned on success.  NULL is returned if there is no matching entry in
- *   the Neighbor Table.
+ *   the Neighbor Table or if the entry is being probed and a probe is due;
+ *   in either case the caller should send a Neighbor Solicitation instead
+ *   of the packet.
  *
  ****************************************************************************/
 
@@ -196,7 +268,8 @@ FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr);
  * Description:
  *   Reset time on the Neighbor Table entry associated with the IPv6 address.
  *   This makes the associated entry the most recently used and not a
- *   candidate for removal.
+ *   candidate for removal.  This is also the upper layer reachability
+ *   confirmation of RFC 4861:  The entry returns to the REACHABLE state.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address of the entry to be updated
@@ -213,7 +286,7 @@ void neighbor_update(const net_ipv6addr_t ipaddr);
  *
  * Description:
  *   Called from the timer poll logic in order to perform agin operations on
- *   entries in the Neighbor Table
+ *   entries in the Neighbor Table and run the RFC 4861 state timers.
  *
  * Input Parameters:
  *   hsec - Elapsed time in half seconds since the last check
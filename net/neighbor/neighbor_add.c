@@ -68,9 +68,13 @@
  *   already there).
  *
  * Input Parameters:
- *   dev    - Driver instance associated with the MAC
- *   ipaddr - The IPv6 address of the mapping.
- *   addr   - The link layer address of the mapping
+ *   dev       - Driver instance associated with the MAC
+ *   ipaddr    - The IPv6 address of the mapping.
+ *   addr      - The link layer address of the mapping
+ *   reachable - True if the mapping comes from a solicited Neighbor
+ *               Advertisement and so confirms reachability.  Otherwise the
+ *               entry is created in (or, if the link layer address changed,
+ *               moved to) the STALE state.
  *
  * Returned Value:
  *   None
@@ -78,31 +82,67 @@
  ****************************************************************************/
 
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
-                  FAR uint8_t *addr)
+                  FAR uint8_t *addr, bool reachable)
 {
+  FAR struct neighbor_entry *neighbor;
   uint8_t lltype;
+  uint8_t llsize;
   uint8_t oldest_time;
   int     oldest_ndx;
+  int     hash;
   int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
+  lltype = dev->d_lltype;
+  llsize = netdev_dev_lladdrsize(dev);
+
+  /* Check if there is already an entry for this address */
+
+  neighbor = neighbor_findentry(ipaddr);
+  if (neighbor != NULL && neighbor->ne_addr.na_lltype == lltype)
+    {
+      if (memcmp(&neighbor->ne_addr.u, addr, llsize) != 0)
+        {
+          /* The link layer address changed.  Unless this confirms
+           * reachability, the new address must be verified (RFC 4861,
+           * section 7.2.5).
+           */
+
+          memcpy(&neighbor->ne_addr.u, addr, llsize);
+          neighbor->ne_addr.na_llsize = llsize;
+
+          if (!reachable)
+            {
+              neighbor->ne_state = NEIGHBOR_STATE_STALE;
+              neighbor->ne_probe = false;
+            }
+        }
+
+      if (reachable)
+        {
+          neighbor_update(ipaddr);
+        }
+
+      neighbor_dumpentry("Updated entry", neighbor);
+      return;
+    }
+
+  if (neighbor != NULL)
+    {
+      /* Same IPv6 address on a different link layer;  replace it */
+
+      neighbor_delete(neighbor);
+    }
+
   /* Find the first unused entry or the oldest used entry. */
 
   oldest_time = 0;
   oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (g_neighbors[i].ne_state == NEIGHBOR_STATE_FREE)
         {
           oldest_ndx = i;
           break;
@@ -119,16 +159,36 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
    * "oldest_ndx" variable).
    */
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor = &g_neighbors[oldest_ndx];
+  if (neighbor->ne_state != NEIGHBOR_STATE_FREE)
+    {
+      neighbor_delete(neighbor);
+    }
+
+  neighbor->ne_time   = 0;
+  neighbor->ne_state  = NEIGHBOR_STATE_STALE;
+  neighbor->ne_timer  = 0;
+  neighbor->ne_probes = 0;
+  neighbor->ne_probe  = false;
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = llsize;
+  memcpy(&neighbor->ne_addr.u, addr, llsize);
+
+  if (reachable)
+    {
+      neighbor->ne_state = NEIGHBOR_STATE_REACHABLE;
+      neighbor->ne_timer = NEIGHBOR_REACHABLE_TIME;
+    }
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
+  /* Add the entry to its hash chain */
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  hash               = NEIGHBOR_HASH(ipaddr);
+  neighbor->ne_flink = g_neighbor_hash[hash];
+  g_neighbor_hash[hash] = neighbor;
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
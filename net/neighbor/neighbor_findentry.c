@@ -70,12 +70,12 @@
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+       neighbor != NULL;
+       neighbor = neighbor->ne_flink)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
-
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
@@ -56,6 +56,10 @@
 
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash chains of the Neighbor table entries that are in use */
+
+FAR struct neighbor_entry *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -83,6 +87,13 @@ void neighbor_initialize(void)
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_flink = NULL;
+      g_neighbors[i].ne_state = NEIGHBOR_STATE_FREE;
+      g_neighbors[i].ne_time  = NEIGHBOR_MAXTIME;
+    }
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_HASHSIZE; ++i)
+    {
+      g_neighbor_hash[i] = NULL;
     }
 }
@@ -58,14 +58,18 @@
  *
  * Description:
  *   Find an entry in the Neighbor Table and return its link layer address.
+ *   This is called when a packet is about to be sent to the neighbor:  A
+ *   STALE entry moves to the DELAY state.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
- *   lladdr - The location to return the link layer address
  *
  * Returned Value:
- *   Returns OK if the address was successfully obtain; a negated errno
- *   value is returned on failure.
+ *   A read-only reference to the link layer address in the Neighbor Table is
+ *   returned on success.  NULL is returned if there is no matching entry in
+ *   the Neighbor Table or if the entry is being probed and a probe is due;
+ *   in either case the caller should send a Neighbor Solicitation instead
+ *   of the packet.
  *
  ****************************************************************************/
 
@@ -74,10 +78,31 @@ FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr)
   FAR struct neighbor_entry *neighbor;
 
   neighbor = neighbor_findentry(ipaddr);
-  if (neighbor != NULL)
+  if (neighbor == NULL)
     {
-      return &neighbor->ne_addr;
+      return NULL;
     }
 
-  return NULL;
+  /* The first packet sent to a STALE neighbor starts the DELAY timer.  The
+   * cached address continues to be used and a probe is only sent if
+   * nothing confirms reachability before the timer expires.
+   */
+
+  if (neighbor->ne_state == NEIGHBOR_STATE_STALE)
+    {
+      neighbor->ne_state = NEIGHBOR_STATE_DELAY;
+      neighbor->ne_timer = NEIGHBOR_DELAY_TIME;
+    }
+  else if (neighbor->ne_probe)
+    {
+      /* Let the caller send a Neighbor Solicitation in place of this
+       * packet.
+       */
+
+      neighbor->ne_probe = false;
+      return NULL;
+    }
+
+  neighbor->ne_time = 0;
+  return &neighbor->ne_addr;
 }
@@ -66,25 +66,82 @@
 
 void neighbor_periodic(int hsec)
 {
+  FAR struct neighbor_entry *neighbor;
+  uint32_t newtime;
   int i;
 
   /* Only perform the aging when more than a half second has elapsed */
 
-  if (hsec > 0)
+  if (hsec <= 0)
     {
-      /* Add the elapsed half seconds from each activate entry in the
-       * Neighbor table.
-       */
+      return;
+    }
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+    {
+      neighbor = &g_neighbors[i];
+      if (neighbor->ne_state == NEIGHBOR_STATE_FREE)
+        {
+          continue;
+        }
+
+      /* Add the elapsed half seconds to the age of the entry */
+
+      newtime = neighbor->ne_time + hsec;
+      if (newtime > NEIGHBOR_MAXTIME)
+        {
+          newtime = NEIGHBOR_MAXTIME;
+        }
+
+      neighbor->ne_time = newtime;
+
+      /* STALE entries have no timer; they wait for traffic */
+
+      if (neighbor->ne_state == NEIGHBOR_STATE_STALE)
+        {
+          continue;
+        }
+
+      if (neighbor->ne_timer > hsec)
+        {
+          neighbor->ne_timer -= hsec;
+          continue;
+        }
+
+      /* The state timer has expired */
 
-      for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+      switch (neighbor->ne_state)
         {
-          uint32_t newtime = g_neighbors[i].ne_time + hsec;
-          if (newtime > NEIGHBOR_MAXTIME)
-            {
-              newtime = NEIGHBOR_MAXTIME;
-            }
+          case NEIGHBOR_STATE_REACHABLE:
+            neighbor->ne_state = NEIGHBOR_STATE_STALE;
+            neighbor->ne_timer = 0;
+            break;
+
+          case NEIGHBOR_STATE_DELAY:
+            neighbor->ne_state  = NEIGHBOR_STATE_PROBE;
+            neighbor->ne_probes = 0;
+
+            /* Fall through */
+
+          case NEIGHBOR_STATE_PROBE:
+            if (neighbor->ne_probes >= NEIGHBOR_MAX_PROBES)
+              {
+                /* No answer; the neighbor is unreachable */
+
+                neighbor_dumpentry("Unreachable", neighbor);
+                neighbor_delete(neighbor);
+                break;
+              }
+
+            /* Request a probe on the next packet for this neighbor */
+
+            neighbor->ne_probes++;
+            neighbor->ne_probe = true;
+            neighbor->ne_timer = NEIGHBOR_RETRANS_TIME;
+            break;
 
-          g_neighbors[i].ne_time = newtime;
+          default:
+            break;
         }
     }
 }
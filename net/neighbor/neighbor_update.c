@@ -55,7 +55,8 @@
  * Description:
  *   Reset time on the Neighbor Table entry associated with the IPv6 address.
  *   This makes the associated entry the most recently used and not a
- *   candidate for removal.
+ *   candidate for removal.  This is also the upper layer reachability
+ *   confirmation of RFC 4861:  The entry returns to the REACHABLE state.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address of the entry to be updated
@@ -72,6 +73,10 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
-      neighbor->ne_time = 0;
+      neighbor->ne_time   = 0;
+      neighbor->ne_state  = NEIGHBOR_STATE_REACHABLE;
+      neighbor->ne_timer  = NEIGHBOR_REACHABLE_TIME;
+      neighbor->ne_probes = 0;
+      neighbor->ne_probe  = false;
     }
 }
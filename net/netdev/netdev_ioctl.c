@@ -859,6 +859,24 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         }
         break;
 
+#ifdef CONFIG_NETDEV_STATISTICS
+      case SIOCGIFSTATS:  /* Get the statistics of the device */
+        {
+          /* The counts are only incremented with the network locked, each
+           * by a single aligned word write, so the snapshot needs no lock.
+           */
+
+          dev = netdev_ifr_dev(req);
+          if (dev && req->ifr_data != NULL)
+            {
+              memcpy(req->ifr_data, &dev->d_statistics,
+                     sizeof(struct netdev_statistics_s));
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       /* MAC address operations only make sense if Ethernet or 6LoWPAN are
        * supported.
        */
@@ -1168,22 +1186,9 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
               FAR struct sockaddr_in *addr =
                 (FAR struct sockaddr_in *)&req->arp_pa;
 
-              /* Find the existing ARP table entry for this protocol address. */
-
-              FAR struct arp_entry *entry = arp_find(addr->sin_addr.s_addr);
-              if (entry != NULL)
-                {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
+              /* Remove the ARP table entry for this protocol address. */
 
-                  entry->at_ipaddr = 0;
-                  ret = OK;
-                }
-              else
-                {
-                  ret = -ENOENT;
-                }
+              ret = arp_delete(addr->sin_addr.s_addr);
             }
           else
             {
@@ -0,0 +1,265 @@
+/****************************************************************************
+ * net/netdev/netdev_rxbatch.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/arp.h>
+
+#ifdef CONFIG_NET_PKT
+#  include <nuttx/net/pkt.h>
+#endif
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NET_ETHERNET
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ETHBUF ((FAR struct eth_hdr_s *)&dev->d_buf[0])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxframe
+ *
+ * Description:
+ *   Dispatch one received Ethernet frame in d_buf[] to the network layer
+ *   and send any immediate response to it.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure
+ *   reply - Driver function that sends the frame in d_buf[] as-is
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void netdev_rxframe(FAR struct net_driver_s *dev,
+                           devif_poll_callback_t reply)
+{
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the packet tap */
+
+  (void)pkt_input(dev);
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (ETHBUF->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Handle ARP on input, then dispatch IPv4 packet to the network
+       * layer.
+       */
+
+      arp_ipin(dev);
+      (void)ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (ETHBUF->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Dispatch IPv6 packet to the network layer */
+
+      (void)ipv6_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (ETHBUF->type == HTONS(ETHTYPE_ARP))
+    {
+      ninfo("ARP frame\n");
+      NETDEV_RXARP(dev);
+
+      /* Dispatch ARP packet to the network layer.  Any ARP reply is a
+       * complete Ethernet frame and may be sent as-is.
+       */
+
+      arp_arpin(dev);
+      if (dev->d_len > 0)
+        {
+          (void)reply(dev);
+        }
+
+      return;
+    }
+  else
+#endif
+    {
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+      return;
+    }
+
+  /* If the IP packet resulted in a response, then add the Ethernet header
+   * and send it.
+   */
+
+  if (dev->d_len > 0)
+    {
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(dev->d_flags))
+#endif
+        {
+          arp_out(dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          neighbor_out(dev);
+        }
+#endif
+
+      (void)reply(dev);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxbatch
+ *
+ * Description:
+ *   Receive and process a batch of Ethernet frames within a single network
+ *   lock section.  The driver supplies a function that moves the next
+ *   received frame from the hardware into d_buf[] and a function that
+ *   transmits the frame in d_buf[] as-is.  Frames are processed until the
+ *   hardware has no more frames or until the budget is exhausted.
+ *
+ *   A driver that receives 'budget' frames should assume that more frames
+ *   are pending:  It should leave its RX interrupt disabled and reschedule
+ *   its receive work rather than re-enable the interrupt.  This switches
+ *   the driver to polling under heavy load so that an interrupt for every
+ *   frame cannot starve the work queue.  The driver re-enables the RX
+ *   interrupt when a batch ends with fewer than 'budget' frames.
+ *
+ *   The driver should poll for new TX data (devif_poll()) once after the
+ *   batch rather than after every frame.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   pull   - Driver function that loads the next received frame into
+ *            d_buf[] and sets d_len.  It returns a positive value if a
+ *            frame was loaded, zero if there are no further frames, or a
+ *            negated errno value if a frame was received in error and
+ *            discarded.
+ *   reply  - Driver function that sends the frame in d_buf[] (d_len bytes)
+ *            with no further processing.
+ *   budget - The maximum number of frames to process.
+ *
+ * Returned Value:
+ *   The number of frames removed from the hardware (including frames that
+ *   were discarded).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_rxbatch(FAR struct net_driver_s *dev, netdev_rxpull_t pull,
+                   devif_poll_callback_t reply, int budget)
+{
+  int nframes;
+  int ret;
+
+  DEBUGASSERT(dev != NULL && pull != NULL && reply != NULL);
+  DEBUGASSERT(dev->d_lltype == NET_LL_ETHERNET);
+
+  for (nframes = 0; nframes < budget; nframes++)
+    {
+      ret = pull(dev);
+      if (ret == 0)
+        {
+          /* No more frames */
+
+          break;
+        }
+      else if (ret < 0)
+        {
+          /* The frame was received in error and dropped by the driver */
+
+          NETDEV_RXERRORS(dev);
+          continue;
+        }
+
+      if (dev->d_len < ETH_HDRLEN)
+        {
+          NETDEV_RXDROPPED(dev);
+          continue;
+        }
+
+      netdev_rxframe(dev, reply);
+    }
+
+  dev->d_len = 0;
+  return nframes;
+}
+
+#endif /* CONFIG_NET_ETHERNET */
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #ifdef CONFIG_NET_PKT
@@ -62,6 +63,20 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* A memory mapped RX or TX ring shared with user space */
+
+struct pollfd;           /* Forward reference */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;     /* Start of the ring (NULL: no ring) */
+  uint16_t frame_size;   /* Size of one frame, including its header */
+  uint16_t frame_nr;     /* Number of frames in the ring */
+  uint16_t head;         /* Next frame to be used by the kernel */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
@@ -77,6 +92,20 @@ struct pkt_conn_s
   /* Defines the list of packet callbacks */
 
   struct devif_callback_s *list;
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Memory mapped rings.  When the RX ring is set up, received frames are
+   * copied from the driver's d_buf straight into it and recvfrom() is no
+   * longer served.
+   */
+
+  struct pkt_ring_s rx;
+  struct pkt_ring_s tx;
+  FAR struct pollfd *fds; /* The single poll() waiter on the rings */
+  uint32_t packets;       /* Frames placed in the RX ring */
+  uint32_t drops;         /* Frames dropped because the RX ring was full */
+  bool losing;            /* Frames dropped since the last one delivered */
+#endif
 };
 
 /****************************************************************************
@@ -301,6 +330,80 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_setsockopt and pkt_getsockopt
+ *
+ * Description:
+ *   Set or get a socket option at the SOL_PACKET level.  See
+ *   psock_setsockopt() and psock_getsockopt().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+int pkt_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in dev->d_buf into the next frame of the RX ring of
+ *   'conn', or count it as dropped if that frame is still owned by user
+ *   space.  A poll() waiter is woken by the first frame only; frames that
+ *   arrive before it runs are picked up by the same wakeup.
+ *
+ * Assumptions:
+ *   The network is locked and conn->rx.base is not NULL.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Place the next frame requested for sending in the TX ring of 'conn'
+ *   into dev->d_buf.
+ *
+ * Assumptions:
+ *   The network is locked and dev->d_sndlen is zero.
+ *
+ ****************************************************************************/
+
+void pkt_ring_poll(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_pollsetup
+ *
+ * Description:
+ *   Set up or tear down a poll() of the rings of the socket.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int pkt_ring_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a connection that is being closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+#endif /* CONFIG_NET_PKT_MMAP */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
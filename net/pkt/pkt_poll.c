@@ -94,6 +94,15 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn)
 
       /* If the application has data to send, setup the UDP/IP header */
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* Otherwise, send the next frame queued in the TX ring */
+
+      if (dev->d_sndlen == 0 && conn->tx.base != NULL)
+        {
+          pkt_ring_poll(dev, conn);
+        }
+#endif
+
       if (dev->d_sndlen > 0)
         {
           //devif_pkt_send(dev, conn);
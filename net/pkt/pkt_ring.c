@@ -0,0 +1,512 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the header of frame 'ndx' of a ring.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tpacket_hdr *
+  pkt_ring_frame(FAR struct pkt_ring_s *ring, unsigned int ndx)
+{
+  return (FAR struct tpacket_hdr *)(ring->base + ndx * ring->frame_size);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_advance
+ *
+ * Description:
+ *   Step the kernel's position in a ring to the next frame.
+ *
+ ****************************************************************************/
+
+static inline void pkt_ring_advance(FAR struct pkt_ring_s *ring)
+{
+  if (++ring->head >= ring->frame_nr)
+    {
+      ring->head = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_release
+ *
+ * Description:
+ *   Free the memory of a ring and mark it as not set up.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_release(FAR struct pkt_ring_s *ring)
+{
+  if (ring->base != NULL)
+    {
+      kumm_free(ring->base);
+    }
+
+  memset(ring, 0, sizeof(struct pkt_ring_s));
+}
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Allocate a ring with the geometry in 'req', replacing any ring that was
+ *   set up before.  A tp_frame_nr of zero just releases the ring.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_setup(FAR struct pkt_ring_s *ring,
+                          FAR const struct tpacket_req *req)
+{
+  FAR uint8_t *base = NULL;
+
+  if (req->tp_frame_nr > 0)
+    {
+      /* Frames must be aligned, large enough for the header and an
+       * Ethernet header, and must tile the blocks exactly.
+       */
+
+      if (req->tp_frame_size < TPACKET_HDRLEN + ETH_HDRLEN ||
+          req->tp_frame_size > UINT16_MAX ||
+          (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+          req->tp_block_size < req->tp_frame_size ||
+          (req->tp_block_size % req->tp_frame_size) != 0 ||
+          req->tp_frame_nr > UINT16_MAX ||
+          req->tp_frame_nr != (req->tp_block_size / req->tp_frame_size) *
+                              req->tp_block_nr)
+        {
+          return -EINVAL;
+        }
+
+      /* The ring is allocated from the user heap so that it is accessible
+       * to the application.  Zeroed frames are owned by the kernel (RX) or
+       * available to user space (TX).
+       */
+
+      base = (FAR uint8_t *)kumm_zalloc(req->tp_block_size *
+                                        req->tp_block_nr);
+      if (base == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  net_lock();
+  pkt_ring_release(ring);
+
+  if (base != NULL)
+    {
+      ring->base       = base;
+      ring->frame_size = req->tp_frame_size;
+      ring->frame_nr   = req->tp_frame_nr;
+    }
+
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_notify
+ *
+ * Description:
+ *   Report 'eventset' to the poll() waiter, if any.  The waiter is woken
+ *   only once for each event; the events of any further frames are picked
+ *   up when it examines the ring.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_notify(FAR struct pkt_conn_s *conn,
+                            pollevent_t eventset)
+{
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds = conn->fds;
+
+  if (fds != NULL && (fds->events & eventset) != 0 &&
+      (fds->revents & eventset) == 0)
+    {
+      fds->revents |= (fds->events & eventset);
+      nxsem_post(fds->sem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set a socket option at the SOL_PACKET level.  See psock_setsockopt().
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  switch (option)
+    {
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req))
+          {
+            return -EINVAL;
+          }
+
+        return pkt_ring_setup(option == PACKET_RX_RING ?
+                              &conn->rx : &conn->tx,
+                              (FAR const struct tpacket_req *)value);
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get a socket option at the SOL_PACKET level.  See psock_getsockopt().
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  switch (option)
+    {
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (*value_len < sizeof(FAR void *))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR void **)value = option == PACKET_RX_RING ?
+                              conn->rx.base : conn->tx.base;
+        *value_len          = sizeof(FAR void *);
+        return OK;
+
+      case PACKET_STATISTICS:
+        {
+          FAR struct tpacket_stats *stats =
+            (FAR struct tpacket_stats *)value;
+
+          if (*value_len < sizeof(struct tpacket_stats))
+            {
+              return -EINVAL;
+            }
+
+          /* As on Linux, reading the counters resets them */
+
+          net_lock();
+          stats->tp_packets = conn->packets;
+          stats->tp_drops   = conn->drops;
+          conn->packets     = 0;
+          conn->drops       = 0;
+          net_unlock();
+
+          *value_len = sizeof(struct tpacket_stats);
+          return OK;
+        }
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in dev->d_buf into the next frame of the RX ring of
+ *   'conn', or count it as dropped if that frame is still owned by user
+ *   space.
+ *
+ * Assumptions:
+ *   The network is locked and conn->rx.base is not NULL.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rx;
+  FAR struct tpacket_hdr *hdr;
+  struct timespec ts;
+  unsigned int snaplen;
+  uint32_t status;
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      /* The ring is full.  Flag the loss in the next frame delivered. */
+
+      conn->drops++;
+      conn->losing = true;
+      return;
+    }
+
+  snaplen = ring->frame_size - TPACKET_HDRLEN;
+  if (snaplen > dev->d_len)
+    {
+      snaplen = dev->d_len;
+    }
+
+  memcpy((FAR uint8_t *)hdr + TPACKET_HDRLEN, dev->d_buf, snaplen);
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = TPACKET_HDRLEN;
+  hdr->tp_net     = TPACKET_HDRLEN + ETH_HDRLEN;
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / NSEC_PER_USEC;
+
+  /* Hand the frame to user space only when it is complete */
+
+  status = TP_STATUS_USER;
+  if (conn->losing)
+    {
+      status      |= TP_STATUS_LOSING;
+      conn->losing = false;
+    }
+
+  hdr->tp_status = status;
+  conn->packets++;
+
+  pkt_ring_advance(ring);
+  pkt_ring_notify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Place the next frame requested for sending in the TX ring of 'conn'
+ *   into dev->d_buf.
+ *
+ * Assumptions:
+ *   The network is locked and dev->d_sndlen is zero.
+ *
+ ****************************************************************************/
+
+void pkt_ring_poll(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->tx;
+  FAR struct tpacket_hdr *hdr;
+  uint32_t len;
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+    {
+      return;
+    }
+
+  len = hdr->tp_len;
+  if (len == 0 || len > ring->frame_size - TPACKET_HDRLEN ||
+      len >= NET_DEV_MTU(dev))
+    {
+      nwarn("WARNING: Bad TX ring frame length: %lu\n",
+            (unsigned long)len);
+      hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+    }
+  else
+    {
+      devif_pkt_send(dev, (FAR uint8_t *)hdr + TPACKET_HDRLEN, len);
+
+      /* Make sure no ARP request overwrites this frame */
+
+      IFF_SET_NOARP(dev->d_flags);
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+    }
+
+  pkt_ring_advance(ring);
+  pkt_ring_notify(conn, POLLOUT);
+
+  /* Ask for another poll if more frames are waiting */
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status == TP_STATUS_SEND_REQUEST)
+    {
+      netdev_txnotify_dev(dev);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollsetup
+ *
+ * Description:
+ *   Set up or tear down a poll() of the rings of the socket.  POLLIN is
+ *   reported while the last frame placed in the RX ring is still owned by
+ *   user space; POLLOUT while the next frame of the TX ring is available.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int pkt_ring_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR struct tpacket_hdr *hdr;
+  int ret = OK;
+
+  net_lock();
+  if (!setup)
+    {
+      if (conn->fds == fds)
+        {
+          conn->fds = NULL;
+        }
+
+      fds->priv = NULL;
+    }
+  else if (conn->fds != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      conn->fds    = fds;
+      fds->priv    = conn;
+      fds->revents = 0;
+
+      if (conn->rx.base != NULL)
+        {
+          hdr = pkt_ring_frame(&conn->rx, conn->rx.head > 0 ?
+                               conn->rx.head - 1 : conn->rx.frame_nr - 1);
+          if (hdr->tp_status != TP_STATUS_KERNEL)
+            {
+              fds->revents |= POLLIN;
+            }
+        }
+
+      if (conn->tx.base == NULL)
+        {
+          fds->revents |= POLLOUT;
+        }
+      else
+        {
+          hdr = pkt_ring_frame(&conn->tx, conn->tx.head);
+          if (hdr->tp_status == TP_STATUS_AVAILABLE)
+            {
+              fds->revents |= POLLOUT;
+            }
+        }
+
+      fds->revents &= fds->events;
+      if (fds->revents != 0)
+        {
+          nxsem_post(fds->sem);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a connection that is being closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  net_lock();
+  pkt_ring_release(&conn->rx);
+  pkt_ring_release(&conn->tx);
+  conn->fds     = NULL;
+  conn->packets = 0;
+  conn->drops   = 0;
+  conn->losing  = false;
+  net_unlock();
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
@@ -216,6 +216,19 @@ ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
   state.snd_buflen    = len;            /* Number of bytes to send */
   state.snd_buffer    = buf;            /* Buffer to send from */
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* A zero length send() on a socket with a TX ring starts the
+   * transmission of the frames queued in the ring.  They are sent from
+   * pkt_poll() as the driver polls; the caller does not wait.
+   */
+
+  if (len == 0 &&
+      ((FAR struct pkt_conn_s *)psock->s_conn)->tx.base != NULL)
+    {
+      netdev_txnotify_dev(dev);
+    }
+  else
+#endif
   if (len > 0)
     {
       FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
@@ -481,7 +481,13 @@ int pkt_listen(FAR struct socket *psock, int backlog)
 static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
                           bool setup)
 {
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Only the memory mapped rings can be polled */
+
+  return pkt_ring_pollsetup(psock, fds, setup);
+#else
   return -ENOSYS;
+#endif
 }
 #endif /* !CONFIG_DISABLE_POLL */
 
@@ -593,6 +599,9 @@ static int pkt_close(FAR struct socket *psock)
               /* Yes... free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
+#ifdef CONFIG_NET_PKT_MMAP
+              pkt_ring_free(conn);      /* Release the shared rings */
+#endif
               pkt_free(psock->s_conn);  /* Free network resources */
             }
           else
@@ -79,6 +79,12 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_ARP
+static int     netprocfs_arp(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_ARP */
+#ifdef CONFIG_NET_6LOWPAN
+static int     netprocfs_sixlowpan(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_6LOWPAN */
 
 /****************************************************************************
  * Private Data
@@ -113,6 +119,14 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_NET_ARP
+  , netprocfs_arp
+#endif /* CONFIG_NET_ARP */
+
+#ifdef CONFIG_NET_6LOWPAN
+  , netprocfs_sixlowpan
+#endif /* CONFIG_NET_6LOWPAN */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -435,6 +449,39 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_arp
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_ARP)
+static int netprocfs_arp(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\nARP     Hit: %04x  Miss: %04x  Evict: %04x  "
+                  "Held: %04x  Drop: %04x\n",
+                  g_netstats.arp.hit, g_netstats.arp.miss,
+                  g_netstats.arp.evict, g_netstats.arp.queued,
+                  g_netstats.arp.qdrop);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_ARP */
+
+/****************************************************************************
+ * Name: netprocfs_sixlowpan
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_6LOWPAN)
+static int netprocfs_sixlowpan(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\n6LoWPAN Reass: %04x  Timeout: %04x  Evict: %04x  "
+                  "NoMem: %04x  Drop: %04x\n",
+                  g_netstats.sixlowpan.reassembled,
+                  g_netstats.sixlowpan.timeout,
+                  g_netstats.sixlowpan.evict, g_netstats.sixlowpan.nomem,
+                  g_netstats.sixlowpan.drop);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_6LOWPAN */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
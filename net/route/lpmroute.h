@@ -0,0 +1,178 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/net/netdev.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The longest prefix match index is only available for the in-memory
+ * routing tables.
+ */
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+#  define HAVE_LPM_IPv4 1
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define HAVE_LPM_IPv6 1
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match index of the routing tables.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void);
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add a routing table entry to the longest prefix match index.  The
+ *   netmask of the route must be contiguous.
+ *
+ * Parameters:
+ *   route - The routing table entry to be added.  The entry must remain
+ *     valid until it is removed with net_dellpm_ipv4/6().
+ *
+ * Returned Value:
+ *   OK on success; -EEXIST if there is already a route to the same network,
+ *   -EINVAL if the netmask is not contiguous, or -ENOMEM if the index is
+ *   full.
+ *
+ * Assumptions:
+ *   The caller holds both the network lock and the routing table lock.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+int net_addlpm_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_LPM_IPv6
+int net_addlpm_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove a routing table entry from the longest prefix match index.
+ *
+ * Parameters:
+ *   route - The routing table entry to be removed
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if the route is not in the index.
+ *
+ * Assumptions:
+ *   The caller holds both the network lock and the routing table lock.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+int net_dellpm_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_LPM_IPv6
+int net_dellpm_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the most specific route to the target address.
+ *
+ * Parameters:
+ *   target - The remote address to be routed
+ *   dev    - If non-NULL, only routes whose router lies on the network of
+ *            this device are considered.
+ *
+ * Returned Value:
+ *   The matching routing table entry or NULL if there is no route.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.  The routing table lock is not
+ *   needed:  The index is only modified with the network lock held so the
+ *   returned entry stays valid until the network is unlocked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+FAR struct net_route_ipv4_s *net_lpmroute_ipv4(in_addr_t target,
+                                               FAR struct net_driver_s *dev);
+#endif
+
+#ifdef HAVE_LPM_IPv6
+FAR struct net_route_ipv6_s *
+  net_lpmroute_ipv6(const net_ipv6addr_t target,
+                    FAR struct net_driver_s *dev);
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
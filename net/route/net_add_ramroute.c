@@ -50,6 +50,7 @@
 #include <arch/irq.h>
 
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -75,6 +76,9 @@
 int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
+#ifdef HAVE_LPM_IPv4
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -92,15 +96,41 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_ipv4addr_copy(route->router, router);
   net_ipv4_dumproute("New route", route);
 
-  /* Get exclusive address to the networking data structures */
+#ifdef HAVE_LPM_IPv4
+  /* Readers of the longest prefix match index rely on the network lock
+   * (not the routing table lock) so we need both here.
+   */
 
   net_lock();
+  net_wrlock_ramroute();
+
+  /* Index the new entry first.  This fails if there is already a route to
+   * the same network.
+   */
+
+  ret = net_addlpm_ipv4(route);
+  if (ret < 0)
+    {
+      net_wrunlock_ramroute();
+      net_unlock();
+      net_freeroute_ipv4(route);
+      return ret;
+    }
+#else
+  /* Get exclusive access to the routing table */
+
+  net_wrlock_ramroute();
+#endif
 
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+  net_wrunlock_ramroute();
+
+#ifdef HAVE_LPM_IPv4
   net_unlock();
+#endif
   return OK;
 }
 #endif
@@ -110,6 +140,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
                       net_ipv6addr_t router)
 {
   FAR struct net_route_ipv6_s *route;
+#ifdef HAVE_LPM_IPv6
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -127,15 +160,41 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   net_ipv6addr_copy(route->router, router);
   net_ipv6_dumproute("New route", route);
 
-  /* Get exclusive address to the networking data structures */
+#ifdef HAVE_LPM_IPv6
+  /* Readers of the longest prefix match index rely on the network lock
+   * (not the routing table lock) so we need both here.
+   */
 
   net_lock();
+  net_wrlock_ramroute();
+
+  /* Index the new entry first.  This fails if there is already a route to
+   * the same network.
+   */
+
+  ret = net_addlpm_ipv6(route);
+  if (ret < 0)
+    {
+      net_wrunlock_ramroute();
+      net_unlock();
+      net_freeroute_ipv6(route);
+      return ret;
+    }
+#else
+  /* Get exclusive access to the routing table */
+
+  net_wrlock_ramroute();
+#endif
 
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+  net_wrunlock_ramroute();
+
+#ifdef HAVE_LPM_IPv6
   net_unlock();
+#endif
   return OK;
 }
 #endif
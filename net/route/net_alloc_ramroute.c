@@ -67,10 +67,24 @@ FAR struct net_route_ipv4_queue_s g_ipv4_routes;
 FAR struct net_route_ipv6_queue_s g_ipv6_routes;
 #endif
 
+/* Protects the routing tables */
+
+#ifdef CONFIG_RWSEM
+rwsem_t g_ramroute_lock;
+#else
+struct net_rmutex_s g_ramroute_lock;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+/* Protects the free lists.  This is taken after the routing table lock
+ * when a route is freed while the table is locked.
+ */
+
+static struct net_rmutex_s g_freeroute_lock;
+
 /* These are lists of free routing table entries */
 
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
@@ -118,6 +132,13 @@ void net_init_ramroute(void)
 {
   int i;
 
+#ifdef CONFIG_RWSEM
+  (void)nxrwsem_init(&g_ramroute_lock);
+#else
+  net_rmutex_init(&g_ramroute_lock);
+#endif
+  net_rmutex_init(&g_freeroute_lock);
+
   /* Initialize the routing table and the free list */
 
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
@@ -165,15 +186,15 @@ FAR struct net_route_ipv4_s *net_allocroute_ipv4(void)
 {
   FAR struct net_route_ipv4_entry_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the free list */
 
-  net_lock();
+  net_rmutex_lock(&g_freeroute_lock);
 
   /* Then add the remove the first entry from the table */
 
   route = ramroute_ipv4_remfirst(&g_free_ipv4routes);
 
-  net_unlock();
+  net_rmutex_unlock(&g_freeroute_lock);
   return &route->entry;
 }
 #endif
@@ -183,15 +204,15 @@ FAR struct net_route_ipv6_s *net_allocroute_ipv6(void)
 {
   FAR struct net_route_ipv6_entry_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the free list */
 
-  net_lock();
+  net_rmutex_lock(&g_freeroute_lock);
 
   /* Then add the remove the first entry from the table */
 
   route = ramroute_ipv6_remfirst(&g_free_ipv6routes);
 
-  net_unlock();
+  net_rmutex_unlock(&g_freeroute_lock);
   return &route->entry;
 }
 #endif
@@ -215,15 +236,15 @@ void net_freeroute_ipv4(FAR struct net_route_ipv4_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the free list */
 
-  net_lock();
+  net_rmutex_lock(&g_freeroute_lock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_free_ipv4routes);
-  net_unlock();
+  net_rmutex_unlock(&g_freeroute_lock);
 }
 #endif
 
@@ -232,15 +253,15 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the free list */
 
-  net_lock();
+  net_rmutex_lock(&g_freeroute_lock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_free_ipv6routes);
-  net_unlock();
+  net_rmutex_unlock(&g_freeroute_lock);
 }
 #endif
 
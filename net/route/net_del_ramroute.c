@@ -45,9 +45,11 @@
 #include <debug.h>
 
 #include <arpa/inet.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -122,6 +124,12 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
           (void)ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef HAVE_LPM_IPv4
+      /* Remove it from the longest prefix match index as well */
+
+      (void)net_dellpm_ipv4(route);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -175,6 +183,12 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
           (void)ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+#ifdef HAVE_LPM_IPv6
+      /* Remove it from the longest prefix match index as well */
+
+      (void)net_dellpm_ipv6(route);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
@@ -212,6 +226,9 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
 int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 {
   struct route_match_ipv4_s match;
+#ifdef HAVE_LPM_IPv4
+  int ret;
+#endif
 
   /* Set up the comparison structure */
 
@@ -219,9 +236,20 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_ipv4addr_copy(match.target, target);
   net_ipv4addr_copy(match.netmask, netmask);
 
+#ifdef HAVE_LPM_IPv4
+  /* Readers of the longest prefix match index hold the network lock while
+   * using an entry.  Hold it too so that the entry is not freed under them.
+   */
+
+  net_lock();
+  ret = net_modifyroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  net_unlock();
+  return ret;
+#else
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  return net_modifyroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+#endif
 }
 #endif
 
@@ -229,6 +257,9 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 {
   struct route_match_ipv6_s match;
+#ifdef HAVE_LPM_IPv6
+  int ret;
+#endif
 
   /* Set up the comparison structure */
 
@@ -236,9 +267,20 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   net_ipv6addr_copy(match.target, target);
   net_ipv6addr_copy(match.netmask, netmask);
 
+#ifdef HAVE_LPM_IPv6
+  /* Readers of the longest prefix match index hold the network lock while
+   * using an entry.  Hold it too so that the entry is not freed under them.
+   */
+
+  net_lock();
+  ret = net_modifyroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  net_unlock();
+  return ret;
+#else
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  return net_modifyroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+#endif
 }
 #endif
 
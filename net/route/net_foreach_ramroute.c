@@ -52,37 +52,25 @@
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: net_foreachroute_ipv4 and net_foreachroute_ipv6
+ * Name: net_traverse_ipv4 and net_traverse_ipv6
  *
  * Description:
- *   Traverse the routing table
- *
- * Parameters:
- *   handler - Will be called for each route in the routing table.
- *   arg     - An arbitrary value that will be passed tot he handler.
- *
- * Returned Value:
- *   Zero (OK) returned if the entire table was search.  A negated errno
- *   value will be returned in the event of a failure.  Handlers may also
- *   terminate the search early with any non-zero, non-negative value.
+ *   Call the handler for each entry in the routing table until it returns
+ *   a non-zero value.  The caller holds the routing table lock.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
-int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
+static int net_traverse_ipv4(route_handler_ipv4_t handler, FAR void *arg)
 {
   FAR struct net_route_ipv4_entry_s *route;
   FAR struct net_route_ipv4_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
-
-  net_lock();
-
   /* Visit each entry in the routing table */
 
   for (route = g_ipv4_routes.head; ret == 0 && route != NULL; route = next)
@@ -95,24 +83,17 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
-
-  net_unlock();
   return ret;
 }
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_RAMROUTE
-int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
+static int net_traverse_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 {
   FAR struct net_route_ipv6_entry_s *route;
   FAR struct net_route_ipv6_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
-
-  net_lock();
-
   /* Visit each entry in the routing table */
 
   for (route = g_ipv6_routes.head; ret == 0 && route != NULL; route = next)
@@ -125,9 +106,104 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_foreachroute_ipv4 and net_foreachroute_ipv6
+ *
+ * Description:
+ *   Traverse the routing table
+ *
+ * Parameters:
+ *   handler - Will be called for each route in the routing table.
+ *   arg     - An arbitrary value that will be passed tot he handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if the entire table was search.  A negated errno
+ *   value will be returned in the event of a failure.  Handlers may also
+ *   terminate the search early with any non-zero, non-negative value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
+{
+  int ret;
+
+  /* Prevent concurrent modification of the routing table */
+
+  net_rdlock_ramroute();
+  ret = net_traverse_ipv4(handler, arg);
+  net_rdunlock_ramroute();
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
+{
+  int ret;
+
+  /* Prevent concurrent modification of the routing table */
+
+  net_rdlock_ramroute();
+  ret = net_traverse_ipv6(handler, arg);
+  net_rdunlock_ramroute();
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_modifyroute_ipv4 and net_modifyroute_ipv6
+ *
+ * Description:
+ *   Traverse the routing table like net_foreachroute_ipv4/6() but hold the
+ *   routing table lock for writing, so that the handler may remove the
+ *   entry that it is passed.
+ *
+ * Parameters:
+ *   handler - Will be called for each route in the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   As for net_foreachroute_ipv4/6().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_modifyroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
+{
+  int ret;
+
+  /* Get exclusive access to the routing table */
+
+  net_wrlock_ramroute();
+  ret = net_traverse_ipv4(handler, arg);
+  net_wrunlock_ramroute();
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_modifyroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
+{
+  int ret;
+
+  /* Get exclusive access to the routing table */
+
+  net_wrlock_ramroute();
+  ret = net_traverse_ipv6(handler, arg);
+  net_wrunlock_ramroute();
 
-  net_unlock();
   return ret;
 }
 #endif
@@ -0,0 +1,650 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/lpmroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A trie holding N routes never needs more than 2*N - 1 nodes:  Every node
+ * without a route is a branch with two children.
+ */
+
+#define LPM_IPv4_NNODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define LPM_IPv6_NNODES (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+#ifdef HAVE_LPM_IPv6
+#  define LPM_KEYLEN 16
+#else
+#  define LPM_KEYLEN 4
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path compressed binary (Patricia) trie.  The key holds the
+ * prefix in network order with all bits beyond plen cleared.  Nodes with a
+ * route represent that exact prefix; nodes without a route exist only to
+ * branch on bit plen of the key.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *child[2];        /* Sub-tries for next bit 0 and 1 */
+  FAR void              *route;           /* Route for this prefix or NULL */
+  uint8_t                plen;            /* Prefix length in bits */
+  uint8_t                key[LPM_KEYLEN]; /* The prefix */
+};
+
+/* One trie and its pool of free nodes */
+
+struct lpm_tree_s
+{
+  FAR struct lpm_node_s *root;            /* Root of the trie */
+  FAR struct lpm_node_s *freelist;        /* Free nodes, linked by child[0] */
+  uint16_t               nfree;           /* Number of free nodes */
+  uint8_t                keylen;          /* Size of the key in bytes */
+};
+
+/* Used to restrict a lookup to routes reachable through a device */
+
+typedef bool (*lpm_filter_t)(FAR void *route, FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+static struct lpm_node_s g_lpm_ipv4_nodes[LPM_IPv4_NNODES];
+static struct lpm_tree_s g_lpm_ipv4;
+#endif
+
+#ifdef HAVE_LPM_IPv6
+static struct lpm_node_s g_lpm_ipv6_nodes[LPM_IPv6_NNODES];
+static struct lpm_tree_s g_lpm_ipv6;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return the value of bit 'bit' of the key, counting from the most
+ *   significant bit of the first byte.
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, int bit)
+{
+  return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits (up to nbits) that are the same in
+ *   both keys.
+ *
+ ****************************************************************************/
+
+static int lpm_common(FAR const uint8_t *a, FAR const uint8_t *b, int nbits)
+{
+  uint8_t diff;
+  int i;
+
+  for (i = 0; i < nbits; i += 8)
+    {
+      diff = a[i >> 3] ^ b[i >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              i++;
+            }
+
+          return i < nbits ? i : nbits;
+        }
+    }
+
+  return nbits;
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   Convert a netmask to a prefix length.  Returns -EINVAL if the mask is
+ *   not contiguous.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint8_t *mask, int keylen)
+{
+  uint8_t bits;
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < keylen && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < keylen)
+    {
+      for (bits = mask[i]; (bits & 0x80) != 0; bits <<= 1)
+        {
+          plen++;
+        }
+
+      if (bits != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (i++; i < keylen; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_init
+ *
+ * Description:
+ *   Initialize an empty trie and its node pool.
+ *
+ ****************************************************************************/
+
+static void lpm_init(FAR struct lpm_tree_s *tree,
+                     FAR struct lpm_node_s *nodes, int nnodes, int keylen)
+{
+  int i;
+
+  tree->root     = NULL;
+  tree->freelist = NULL;
+  tree->nfree    = 0;
+  tree->keylen   = keylen;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      nodes[i].child[0] = tree->freelist;
+      tree->freelist    = &nodes[i];
+      tree->nfree++;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_alloc
+ *
+ * Description:
+ *   Take a node from the pool and initialize it with the first plen bits of
+ *   the key.  The caller has verified that a node is available.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_alloc(FAR struct lpm_tree_s *tree,
+                                        FAR const uint8_t *key, int plen,
+                                        FAR void *route)
+{
+  FAR struct lpm_node_s *node = tree->freelist;
+  int nbytes = (plen + 7) >> 3;
+
+  DEBUGASSERT(node != NULL);
+  tree->freelist = node->child[0];
+  tree->nfree--;
+
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->route    = route;
+  node->plen     = plen;
+
+  memset(node->key, 0, sizeof(node->key));
+  memcpy(node->key, key, nbytes);
+  if ((plen & 7) != 0)
+    {
+      node->key[nbytes - 1] &= (uint8_t)(0xff << (8 - (plen & 7)));
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_free
+ *
+ * Description:
+ *   Return a node to the pool.
+ *
+ ****************************************************************************/
+
+static void lpm_free(FAR struct lpm_tree_s *tree, FAR struct lpm_node_s *node)
+{
+  node->child[0] = tree->freelist;
+  node->child[1] = NULL;
+  node->route    = NULL;
+  tree->freelist = node;
+  tree->nfree++;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a route for the prefix key/plen to the trie.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_tree_s *tree, FAR const uint8_t *key,
+                      int plen, FAR void *route)
+{
+  FAR struct lpm_node_s **link = &tree->root;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *branch;
+  int common;
+
+  /* An insertion never takes more than two nodes.  Check up front so that
+   * the trie is never left partially modified.
+   */
+
+  if (tree->nfree < 2)
+    {
+      return -ENOMEM;
+    }
+
+  while ((node = *link) != NULL)
+    {
+      common = lpm_common(node->key, key,
+                          node->plen < plen ? node->plen : plen);
+
+      if (common == node->plen)
+        {
+          /* This node's prefix covers the new prefix */
+
+          if (node->plen == plen)
+            {
+              if (node->route != NULL)
+                {
+                  return -EEXIST;
+                }
+
+              node->route = route;
+              return OK;
+            }
+
+          link = &node->child[lpm_bit(key, node->plen)];
+          continue;
+        }
+
+      /* The prefixes diverge (or the new prefix is shorter) somewhere
+       * inside of this node.  Split here.
+       */
+
+      if (common == plen)
+        {
+          /* The new prefix covers this node */
+
+          branch = lpm_alloc(tree, key, plen, route);
+          branch->child[lpm_bit(node->key, plen)] = node;
+        }
+      else
+        {
+          /* Neither covers the other:  Add a branch where they diverge */
+
+          branch = lpm_alloc(tree, key, common, NULL);
+          branch->child[lpm_bit(key, common)] =
+            lpm_alloc(tree, key, plen, route);
+          branch->child[lpm_bit(node->key, common)] = node;
+        }
+
+      *link = branch;
+      return OK;
+    }
+
+  *link = lpm_alloc(tree, key, plen, route);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ *
+ * Description:
+ *   Remove the route for the prefix key/plen from the trie, releasing any
+ *   nodes that are no longer needed.
+ *
+ ****************************************************************************/
+
+static int lpm_remove(FAR struct lpm_tree_s *tree, FAR const uint8_t *key,
+                      int plen)
+{
+  FAR struct lpm_node_s **link = &tree->root;
+  FAR struct lpm_node_s **plink = NULL;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *child;
+  FAR struct lpm_node_s *parent;
+
+  while ((node = *link) != NULL)
+    {
+      if (node->plen > plen ||
+          lpm_common(node->key, key, node->plen) < node->plen)
+        {
+          return -ENOENT;
+        }
+
+      if (node->plen == plen)
+        {
+          break;
+        }
+
+      plink = link;
+      link  = &node->child[lpm_bit(key, node->plen)];
+    }
+
+  if (node == NULL || node->route == NULL)
+    {
+      return -ENOENT;
+    }
+
+  node->route = NULL;
+
+  /* A node with two children is still needed as a branch */
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      return OK;
+    }
+
+  /* Otherwise, splice the node out of the trie */
+
+  child = node->child[0] != NULL ? node->child[0] : node->child[1];
+  *link = child;
+  lpm_free(tree, node);
+
+  /* If that left the parent as a branch with a single child, then it is
+   * no longer needed either.
+   */
+
+  if (child == NULL && plink != NULL)
+    {
+      parent = *plink;
+      if (parent->route == NULL)
+        {
+          *plink = parent->child[0] != NULL ? parent->child[0] :
+                                              parent->child[1];
+          lpm_free(tree, parent);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Return the route with the longest prefix that matches the key and that
+ *   is accepted by the filter (if one is provided).
+ *
+ ****************************************************************************/
+
+static FAR void *lpm_lookup(FAR struct lpm_tree_s *tree,
+                            FAR const uint8_t *key, lpm_filter_t filter,
+                            FAR struct net_driver_s *dev)
+{
+  FAR struct lpm_node_s *node = tree->root;
+  FAR void *best = NULL;
+  int nbits = tree->keylen << 3;
+
+  while (node != NULL &&
+         lpm_common(node->key, key, node->plen) == node->plen)
+    {
+      if (node->route != NULL &&
+          (filter == NULL || filter(node->route, dev)))
+        {
+          best = node->route;
+        }
+
+      if (node->plen >= nbits)
+        {
+          break;
+        }
+
+      node = node->child[lpm_bit(key, node->plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: lpm_ipv4_devfilter and lpm_ipv6_devfilter
+ *
+ * Description:
+ *   Accept only routes whose router lies on the network of the device.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+static bool lpm_ipv4_devfilter(FAR void *route, FAR struct net_driver_s *dev)
+{
+  FAR struct net_route_ipv4_s *ipv4 = (FAR struct net_route_ipv4_s *)route;
+
+  return net_ipv4addr_maskcmp(ipv4->router, dev->d_ipaddr, dev->d_netmask);
+}
+#endif
+
+#ifdef HAVE_LPM_IPv6
+static bool lpm_ipv6_devfilter(FAR void *route, FAR struct net_driver_s *dev)
+{
+  FAR struct net_route_ipv6_s *ipv6 = (FAR struct net_route_ipv6_s *)route;
+
+  return net_ipv6addr_maskcmp(ipv6->router, dev->d_ipv6addr,
+                              dev->d_ipv6netmask);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match index of the routing tables.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void)
+{
+#ifdef HAVE_LPM_IPv4
+  lpm_init(&g_lpm_ipv4, g_lpm_ipv4_nodes, LPM_IPv4_NNODES,
+           sizeof(in_addr_t));
+#endif
+
+#ifdef HAVE_LPM_IPv6
+  lpm_init(&g_lpm_ipv6, g_lpm_ipv6_nodes, LPM_IPv6_NNODES,
+           sizeof(net_ipv6addr_t));
+#endif
+}
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add a routing table entry to the longest prefix match index.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+int net_addlpm_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)&route->netmask,
+                       sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      nerr("ERROR: Non-contiguous netmask %08lx\n",
+           (unsigned long)ntohl(route->netmask));
+      return plen;
+    }
+
+  return lpm_insert(&g_lpm_ipv4, (FAR const uint8_t *)&route->target, plen,
+                    route);
+}
+#endif
+
+#ifdef HAVE_LPM_IPv6
+int net_addlpm_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)route->netmask,
+                       sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      nerr("ERROR: Non-contiguous netmask\n");
+      return plen;
+    }
+
+  return lpm_insert(&g_lpm_ipv6, (FAR const uint8_t *)route->target, plen,
+                    route);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove a routing table entry from the longest prefix match index.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+int net_dellpm_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)&route->netmask,
+                       sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      return -ENOENT;
+    }
+
+  return lpm_remove(&g_lpm_ipv4, (FAR const uint8_t *)&route->target, plen);
+}
+#endif
+
+#ifdef HAVE_LPM_IPv6
+int net_dellpm_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)route->netmask,
+                       sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      return -ENOENT;
+    }
+
+  return lpm_remove(&g_lpm_ipv6, (FAR const uint8_t *)route->target, plen);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the most specific route to the target address.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LPM_IPv4
+FAR struct net_route_ipv4_s *net_lpmroute_ipv4(in_addr_t target,
+                                               FAR struct net_driver_s *dev)
+{
+  return (FAR struct net_route_ipv4_s *)
+    lpm_lookup(&g_lpm_ipv4, (FAR const uint8_t *)&target,
+               dev != NULL ? lpm_ipv4_devfilter : NULL, dev);
+}
+#endif
+
+#ifdef HAVE_LPM_IPv6
+FAR struct net_route_ipv6_s *
+  net_lpmroute_ipv6(const net_ipv6addr_t target,
+                    FAR struct net_driver_s *dev)
+{
+  return (FAR struct net_route_ipv6_s *)
+    lpm_lookup(&g_lpm_ipv6, (FAR const uint8_t *)target,
+               dev != NULL ? lpm_ipv6_devfilter : NULL, dev);
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
@@ -45,10 +45,12 @@
 
 #include <netinet/in.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -116,7 +118,7 @@ struct route_ipv6_match_s
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(HAVE_LPM_IPv4)
 static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 {
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
@@ -142,7 +144,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_IPv4 && !HAVE_LPM_IPv4 */
 
 /****************************************************************************
  * Name: net_ipv6_match
@@ -159,7 +161,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(HAVE_LPM_IPv6)
 static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 {
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
@@ -185,7 +187,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_IPv6 && !HAVE_LPM_IPv6 */
 
 /****************************************************************************
  * Public Functions
@@ -211,6 +213,32 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 #ifdef CONFIG_NET_IPv4
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 {
+#ifdef HAVE_LPM_IPv4
+  FAR struct net_route_ipv4_s *route;
+  int ret = -ENOENT;
+
+  /* Do not route the special broadcast IP address */
+
+  if (net_ipv4addr_cmp(target, INADDR_BROADCAST))
+    {
+      return -ENOENT;
+    }
+
+  /* Find the most specific route.  The routing table lock is not needed;
+   * holding the network lock keeps the entry valid while it is copied.
+   */
+
+  net_lock();
+  route = net_lpmroute_ipv4(target, NULL);
+  if (route != NULL)
+    {
+      net_ipv4addr_copy(*router, route->router);
+      ret = OK;
+    }
+
+  net_unlock();
+  return ret;
+#else
   struct route_ipv4_match_s match;
   int ret;
 
@@ -263,6 +291,7 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 
   net_ipv4addr_copy(*router, match.IPv4_ROUTER);
   return OK;
+#endif /* HAVE_LPM_IPv4 */
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -286,6 +315,32 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 #ifdef CONFIG_NET_IPv6
 int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
 {
+#ifdef HAVE_LPM_IPv6
+  FAR struct net_route_ipv6_s *route;
+  int ret = -ENOENT;
+
+  /* Do not route to any the special IPv6 multicast addresses */
+
+  if (target[0] == HTONS(0xff02))
+    {
+      return -ENOENT;
+    }
+
+  /* Find the most specific route.  The routing table lock is not needed;
+   * holding the network lock keeps the entry valid while it is copied.
+   */
+
+  net_lock();
+  route = net_lpmroute_ipv6(target, NULL);
+  if (route != NULL)
+    {
+      net_ipv6addr_copy(router, route->router);
+      ret = OK;
+    }
+
+  net_unlock();
+  return ret;
+#else
   struct route_ipv6_match_s match;
   int ret;
 
@@ -338,6 +393,7 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
 
   net_ipv6addr_copy(router, match.IPv6_ROUTER);
   return OK;
+#endif /* HAVE_LPM_IPv6 */
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -44,10 +44,12 @@
 #include <errno.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -117,7 +119,7 @@ struct route_ipv6_devmatch_s
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(HAVE_LPM_IPv4)
 static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
                              FAR void *arg)
 {
@@ -149,7 +151,7 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_IPv4 && !HAVE_LPM_IPv4 */
 
 /****************************************************************************
  * Name: net_ipv6_devmatch
@@ -166,7 +168,7 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(HAVE_LPM_IPv6)
 static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
                              FAR void *arg)
 {
@@ -199,7 +201,7 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_IPv6 && !HAVE_LPM_IPv6 */
 
 /****************************************************************************
  * Public Functions
@@ -230,6 +232,26 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
 void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
+#ifdef HAVE_LPM_IPv4
+  FAR struct net_route_ipv4_s *route;
+
+  /* Find the most specific route through this device or else fall back
+   * to the default router of the device.
+   */
+
+  net_lock();
+  route = net_lpmroute_ipv4(target, dev);
+  if (route != NULL)
+    {
+      net_ipv4addr_copy(*router, route->router);
+    }
+  else
+    {
+      net_ipv4addr_copy(*router, dev->d_draddr);
+    }
+
+  net_unlock();
+#else
   struct route_ipv4_devmatch_s match;
   int ret;
 
@@ -280,6 +302,7 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
 
       net_ipv4addr_copy(*router, dev->d_draddr);
     }
+#endif /* HAVE_LPM_IPv4 */
 }
 #endif
 
@@ -309,6 +332,26 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR const net_ipv6addr_t target,
                         FAR net_ipv6addr_t router)
 {
+#ifdef HAVE_LPM_IPv6
+  FAR struct net_route_ipv6_s *route;
+
+  /* Find the most specific route through this device or else fall back
+   * to the default router of the device.
+   */
+
+  net_lock();
+  route = net_lpmroute_ipv6(target, dev);
+  if (route != NULL)
+    {
+      net_ipv6addr_copy(router, route->router);
+    }
+  else
+    {
+      net_ipv6addr_copy(router, dev->d_ipv6draddr);
+    }
+
+  net_unlock();
+#else
   struct route_ipv6_devmatch_s match;
   int ret;
 
@@ -357,6 +400,7 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
 
       net_ipv6addr_copy(router, dev->d_ipv6draddr);
     }
+#endif /* HAVE_LPM_IPv6 */
 }
 #endif
 
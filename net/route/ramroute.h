@@ -42,6 +42,9 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/rwsem.h>
+
+#include "utils/utils.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -128,6 +131,36 @@ extern struct net_route_ipv4_queue_s g_ipv4_routes;
 extern struct net_route_ipv6_queue_s g_ipv6_routes;
 #endif
 
+/* The routing tables are protected by their own lock rather than by the
+ * global network lock.  Routes can then be listed or modified while the
+ * rest of the network is busy.  The locking order is the network lock,
+ * then the routing table lock:  The handlers passed to
+ * net_foreachroute_ipv4/6() must not take the network lock.
+ *
+ * Route lookups far outnumber route changes so, with CONFIG_RWSEM, the
+ * lock is a reader-writer semaphore:  Lookups on different CPUs do not
+ * serialize.  The lock is then not re-entrant.  A handler passed to
+ * net_foreachroute_ipv4/6() must not add or delete routes; use
+ * net_modifyroute_ipv4/6() instead.  Otherwise, the lock is a re-entrant
+ * mutex and readers and writers are not distinguished.
+ */
+
+#ifdef CONFIG_RWSEM
+extern rwsem_t g_ramroute_lock;
+
+#  define net_rdlock_ramroute()   (void)nxrwsem_rdlock(&g_ramroute_lock)
+#  define net_rdunlock_ramroute() (void)nxrwsem_rdunlock(&g_ramroute_lock)
+#  define net_wrlock_ramroute()   (void)nxrwsem_wrlock(&g_ramroute_lock)
+#  define net_wrunlock_ramroute() (void)nxrwsem_wrunlock(&g_ramroute_lock)
+#else
+extern struct net_rmutex_s g_ramroute_lock;
+
+#  define net_rdlock_ramroute()   net_rmutex_lock(&g_ramroute_lock)
+#  define net_rdunlock_ramroute() net_rmutex_unlock(&g_ramroute_lock)
+#  define net_wrlock_ramroute()   net_rmutex_lock(&g_ramroute_lock)
+#  define net_wrunlock_ramroute() net_rmutex_unlock(&g_ramroute_lock)
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -151,6 +184,31 @@ extern struct net_route_ipv6_queue_s g_ipv6_routes;
 
 void net_init_ramroute(void);
 
+/****************************************************************************
+ * Name: net_modifyroute_ipv4 and net_modifyroute_ipv6
+ *
+ * Description:
+ *   Traverse the routing table like net_foreachroute_ipv4/6() but hold the
+ *   routing table lock for writing, so that the handler may remove the
+ *   entry that it is passed.
+ *
+ * Parameters:
+ *   handler - Will be called for each route in the routing table.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   As for net_foreachroute_ipv4/6().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_modifyroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_modifyroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: net_allocroute_ipv4 and net_allocroute_ipv6
  *
@@ -86,6 +86,18 @@
 #define UNCOMPRESS_MACBASED (1 << 8)
 #define UNCOMPRESS_ZEROPAD  (1 << 9)
 
+/* Compressed header cache */
+
+#ifndef CONFIG_NET_6LOWPAN_HC06_NFLOWS
+#  define CONFIG_NET_6LOWPAN_HC06_NFLOWS 0
+#endif
+
+/* The largest IPHC header:  IPHC + CID, TF, NH, HLIM, two full addresses
+ * and the uncompressed LOWPAN_UDP header.
+ */
+
+#define HC06_MAXHDR (3 + 4 + 1 + 1 + 16 + 16 + 7)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -101,6 +113,40 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+/* Everything that the compressed IPHC header depends on.  The structure
+ * is zeroed before it is filled in so that it can be compared with memcmp.
+ */
+
+struct hc06_flowkey_s
+{
+  FAR struct radio_driver_s *radio;   /* Sending radio */
+  struct netdev_varaddr_s srcmac;     /* Local MAC address */
+  struct netdev_varaddr_s destmac;    /* L2 destination address */
+  net_ipv6addr_t srcipaddr;           /* IPv6 source address */
+  net_ipv6addr_t destipaddr;          /* IPv6 destination address */
+  uint8_t  vtc;                       /* Version/traffic class (MS) */
+  uint8_t  tcf;                       /* Traffic class (LS)/flow (MS) */
+  uint16_t flow;                      /* Flow label (LS) */
+  uint8_t  proto;                     /* Next header */
+  uint8_t  ttl;                       /* Hop limit */
+  uint16_t srcport;                   /* UDP source port */
+  uint16_t destport;                  /* UDP destination port */
+};
+
+/* One cached, compressed header */
+
+struct hc06_flow_s
+{
+  struct hc06_flowkey_s hf_key;       /* Flow that this header is for */
+  bool    hf_valid;                   /* True: Entry is in use */
+  uint8_t hf_hdrlen;                  /* Length of the IPHC header */
+  uint8_t hf_uncomp_hdrlen;           /* Length of the uncompressed headers */
+  uint8_t hf_ret;                     /* COMPRESS_HDR_* return value */
+  uint8_t hf_hdr[HC06_MAXHDR];        /* The compressed header */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -123,6 +169,12 @@ static struct sixlowpan_addrcontext_s
 
 static FAR uint8_t *g_hc06ptr;
 
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+/* Compressed headers of recent outgoing flows */
+
+static struct hc06_flow_s g_hc06_flows[CONFIG_NET_6LOWPAN_HC06_NFLOWS];
+#endif
+
 /* Constant Data ************************************************************/
 /* Uncompression of linklocal
  *
@@ -391,6 +443,57 @@ static uint8_t compress_laddr(FAR const net_ipv6addr_t srcipaddr,
   return tag;
 }
 
+/****************************************************************************
+ * Name: hc06_flowkey
+ *
+ * Description:
+ *   Collect the fields that determine the compressed header of a packet
+ *   and return the cache entry that the flow maps to.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+static FAR struct hc06_flow_s *
+  hc06_flowkey(FAR struct radio_driver_s *radio,
+               FAR const struct ipv6_hdr_s *ipv6,
+               FAR const struct netdev_varaddr_s *destmac,
+               FAR struct hc06_flowkey_s *key)
+{
+  FAR const struct netdev_varaddr_s *srcmac = &radio->r_dev.d_mac.radio;
+  uint16_t hash;
+
+  memset(key, 0, sizeof(struct hc06_flowkey_s));
+
+  key->radio              = radio;
+  key->srcmac.nv_addrlen  = srcmac->nv_addrlen;
+  memcpy(key->srcmac.nv_addr, srcmac->nv_addr, srcmac->nv_addrlen);
+  key->destmac.nv_addrlen = destmac->nv_addrlen;
+  memcpy(key->destmac.nv_addr, destmac->nv_addr, destmac->nv_addrlen);
+  net_ipv6addr_copy(key->srcipaddr, ipv6->srcipaddr);
+  net_ipv6addr_copy(key->destipaddr, ipv6->destipaddr);
+  key->vtc                = ipv6->vtc;
+  key->tcf                = ipv6->tcf;
+  key->flow               = ipv6->flow;
+  key->proto              = ipv6->proto;
+  key->ttl                = ipv6->ttl;
+
+#ifdef CONFIG_NET_UDP
+  if (ipv6->proto == IP_PROTO_UDP)
+    {
+      FAR const struct udp_hdr_s *udp =
+        (FAR const struct udp_hdr_s *)((FAR const uint8_t *)ipv6 + IPv6_HDRLEN);
+
+      key->srcport        = udp->srcport;
+      key->destport       = udp->destport;
+    }
+#endif
+
+  hash = ipv6->srcipaddr[7] ^ ipv6->destipaddr[7] ^ ipv6->destipaddr[6] ^
+         key->srcport ^ key->destport ^ ipv6->proto;
+  return &g_hc06_flows[hash % CONFIG_NET_6LOWPAN_HC06_NFLOWS];
+}
+#endif
+
 /****************************************************************************
  * Name: uncompress_addr
  *
@@ -558,6 +661,15 @@ void sixlowpan_hc06_initialize(void)
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1
   int i;
 #endif
+#endif
+
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+  /* Start with an empty compressed header cache */
+
+  memset(g_hc06_flows, 0, sizeof(g_hc06_flows));
+#endif
+
+#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
 
   /* Preinitialize any address contexts for better header compression
    * (Saves up to 13 bytes per 6lowpan packet).
@@ -682,6 +794,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 {
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
   FAR struct sixlowpan_addrcontext_s *addrcontext;
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+  FAR struct hc06_flow_s *flow;
+  struct hc06_flowkey_s key;
+#endif
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -689,6 +805,36 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   ninfo("fptr=%p g_frame_hdrlen=%u iphc=%p\n", fptr, g_frame_hdrlen, iphc);
 
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+  /* If this packet belongs to the same flow as the one cached, the
+   * compressed header is identical except for the UDP checksum.
+   */
+
+  flow = hc06_flowkey(radio, ipv6, destmac, &key);
+  if (flow->hf_valid &&
+      memcmp(&flow->hf_key, &key, sizeof(struct hc06_flowkey_s)) == 0)
+    {
+      memcpy(iphc, flow->hf_hdr, flow->hf_hdrlen);
+
+#ifdef CONFIG_NET_UDP
+      if (ipv6->proto == IP_PROTO_UDP)
+        {
+          /* The checksum is always inline at the end of the header */
+
+          FAR const struct udp_hdr_s *udp =
+            (FAR const struct udp_hdr_s *)
+              ((FAR const uint8_t *)ipv6 + IPv6_HDRLEN);
+
+          memcpy(iphc + flow->hf_hdrlen - 2, &udp->udpchksum, 2);
+        }
+#endif
+
+      g_uncomp_hdrlen = flow->hf_uncomp_hdrlen;
+      g_frame_hdrlen += flow->hf_hdrlen;
+      return flow->hf_ret;
+    }
+#endif
+
   /* As we copy some bit-length fields, in the IPHC encoding bytes,
    * we sometimes use |=
    * If the field is 0, and the current bit value in memory is 1,
@@ -1062,6 +1208,20 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
   ninfo("fptr=%p g_frame_hdrlen=%u iphc=%02x:%02x:%02x g_hc06ptr=%p\n",
          fptr, g_frame_hdrlen, iphc[0], iphc[1], iphc[2], g_hc06ptr);
 
+#if CONFIG_NET_6LOWPAN_HC06_NFLOWS > 0
+  /* Remember the compressed header for the next packet of this flow */
+
+  if (g_hc06ptr - iphc <= HC06_MAXHDR)
+    {
+      memcpy(&flow->hf_key, &key, sizeof(struct hc06_flowkey_s));
+      memcpy(flow->hf_hdr, iphc, g_hc06ptr - iphc);
+      flow->hf_hdrlen        = g_hc06ptr - iphc;
+      flow->hf_uncomp_hdrlen = g_uncomp_hdrlen;
+      flow->hf_ret           = ret;
+      flow->hf_valid         = true;
+    }
+#endif
+
   return ret;
 }
 
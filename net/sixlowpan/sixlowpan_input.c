@@ -60,6 +60,7 @@
 #include "nuttx/net/ip.h"
 #include "nuttx/net/icmpv6.h"
 #include "nuttx/net/sixlowpan.h"
+#include "nuttx/net/netstats.h"
 #include "nuttx/wireless/ieee802154/ieee802154_mac.h"
 
 #ifdef CONFIG_NET_PKT
@@ -276,8 +277,9 @@ static uint16_t sixlowpan_uncompress_ipv6proto(FAR uint8_t *fptr,
 static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
                                    FAR const void *metadata, FAR struct iob_s *iob)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reass_s *reass = NULL;
   struct netdev_varaddr_s fragsrc;
+  FAR uint8_t *rxbuf;         /* The radio driver's packet buffer */
   FAR uint8_t *fptr;          /* Convenience pointer to beginning of the frame */
   FAR uint8_t *bptr;          /* Used to redirect uncompressed header to the bitbucket */
   FAR uint8_t *hc1;           /* Convenience pointer to HC1 data */
@@ -302,6 +304,14 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
 
   DEBUGASSERT((unsigned)hdrsize < iob->io_len);
 
+  /* The driver must always provide a packet buffer.  Unfragmented packets
+   * are uncompressed directly into it and reassembled packets are copied
+   * into it when complete.
+   */
+
+  rxbuf = radio->r_dev.d_buf;
+  DEBUGASSERT(rxbuf != NULL);
+
   /* Initialize global data.  Locking the network guarantees that we have
    * exclusive use of the global values for intermediate calculations.
    */
@@ -355,7 +365,17 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
             return ret;
           }
 
-        /* Allocate a new reassembly buffer */
+        /* A FRAG1 matching a reassembly in progress means that the sender
+         * started over;  discard the old fragments.
+         */
+
+        reass = sixlowpan_reass_find(fragtag, &fragsrc);
+        if (reass != NULL)
+          {
+            sixlowpan_reass_free(reass);
+          }
+
+        /* Allocate a new reassembly */
 
         reass = sixlowpan_reass_allocate(fragtag, &fragsrc);
         if (reass == NULL)
@@ -364,13 +384,15 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
             return -ENOMEM;
           }
 
-        radio->r_dev.d_buf = reass->rb_buf;
         radio->r_dev.d_len = 0;
-        reass->rb_pktlen   = fragsize;
+        reass->ra_pktlen   = fragsize;
 
-        /* Indicate the first fragment of the reassembly */
+        /* Indicate the first fragment of the reassembly.  The headers are
+         * uncompressed into the driver's buffer and then copied into the
+         * reassembly with the payload.
+         */
 
-        bptr               = reass->rb_buf;
+        bptr               = rxbuf;
         isfrag1            = true;
         isfrag             = true;
       }
@@ -401,26 +423,28 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
           {
             nerr("ERROR: Failed to find a reassembly buffer for tag=%04x\n",
                  fragtag);
+#ifdef CONFIG_NET_STATISTICS
+            g_netstats.sixlowpan.drop++;
+#endif
             return -ENOENT;
           }
 
-       if (fragsize != reass->rb_pktlen)
+       if (fragsize != reass->ra_pktlen)
         {
           /* The packet is a fragment but its size does not match. */
 
           nwarn("WARNING: Dropping 6LoWPAN packet.  Bad fragsize: %u vs &u\n",
-                fragsize, reass->rb_pktlen);
+                fragsize, reass->ra_pktlen);
           ret = -EPERM;
           goto errout_with_reass;
         }
 
-        radio->r_dev.d_buf  = reass->rb_buf;
         radio->r_dev.d_len  = 0;
 
         ninfo("FRAGN: fragsize=%d fragtag=%d fragoffset=%d\n",
               fragsize, fragtag, fragoffset);
-        ninfo("FRAGN: rb_accumlen=%d paysize=%u fragsize=%u\n",
-              reass->rb_accumlen, iob->io_len - g_frame_hdrlen, fragsize);
+        ninfo("FRAGN: ra_accumlen=%d paysize=%u fragsize=%u\n",
+              reass->ra_accumlen, iob->io_len - g_frame_hdrlen, fragsize);
 
         /* Indicate that this frame is a another fragment for reassembly */
 
@@ -432,14 +456,9 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
     /* Not a fragment */
 
     default:
-      /* We still need a packet buffer.  But in this case, the driver should
-       * have provided one.
-       */
+      /* The packet is uncompressed directly into the driver's buffer */
 
-      DEBUGASSERT(radio->r_dev.d_buf != NULL);
-      reass = (FAR struct sixlowpan_reassbuf_s *)radio->r_dev.d_buf;
-      reass->rb_pool = REASS_POOL_RADIO;
-      bptr  = reass->rb_buf;
+      bptr  = rxbuf;
       break;
     }
 
@@ -500,7 +519,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
        * begin placing the data payload.
        */
 
-      reass->rb_boffset = g_uncomp_hdrlen - protosize;
+      reass->ra_boffset = g_uncomp_hdrlen - protosize;
     }
 
   /* No.. is this a subsequent fragment in the same sequence? */
@@ -511,7 +530,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
        * we began placing payload data.
        */
 
-      g_uncomp_hdrlen = reass->rb_boffset;
+      g_uncomp_hdrlen = reass->ra_boffset;
     }
 
   /* Copy "payload" from the frame buffer to the IEEE802.15.4 MAC driver's
@@ -541,53 +560,80 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
       goto errout_with_reass;
     }
 
-  memcpy(radio->r_dev.d_buf + g_uncomp_hdrlen + (fragoffset << 3),
-         fptr + g_frame_hdrlen, paysize);
+  /* A packet that is not fragmented is complete now */
 
-  /* Update reass->rb_accumlen if the frame is a fragment, reass->rb_pktlen
-   * otherwise.
+  if (!isfrag)
+    {
+      memcpy(rxbuf + g_uncomp_hdrlen, fptr + g_frame_hdrlen, paysize);
+
+      ninfo("IP packet ready (length %d)\n", paysize + g_uncomp_hdrlen);
+      radio->r_dev.d_len = paysize + g_uncomp_hdrlen;
+      return INPUT_COMPLETE;
+    }
+
+  /* Add the fragment to the reassembly.  The first fragment also carries
+   * the headers that were uncompressed into the driver's buffer.
    */
 
-  if (isfrag)
+  if (isfrag1)
     {
-      /* Check if it is the last fragment to be processed.
-       *
-       * If this is the last fragment, we may shave off any extrenous
-       * bytes at the end. We must be liberal in what we accept.
-       */
-
-      reass->rb_accumlen = g_uncomp_hdrlen + (fragoffset << 3) + paysize;
+      memcpy(rxbuf + g_uncomp_hdrlen, fptr + g_frame_hdrlen, paysize);
+      ret = sixlowpan_reass_write(reass, rxbuf, g_uncomp_hdrlen + paysize, 0);
     }
   else
     {
-      reass->rb_pktlen = paysize + g_uncomp_hdrlen;
+      ret = sixlowpan_reass_write(reass, fptr + g_frame_hdrlen, paysize,
+                                  g_uncomp_hdrlen + (fragoffset << 3));
+    }
+
+  if (ret < 0)
+    {
+      nwarn("WARNING: Failed to add fragment: %d\n", ret);
+      goto errout_with_reass;
     }
 
-  /* If we have a full IP packet in sixlowpan_buf, deliver it to
-   * the IP stack
+  /* The packet is complete when all of its bytes have been received.
+   * Counting bytes (rather than looking for the fragment at the end of the
+   * packet) lets the fragments after the first arrive in any order.  We
+   * may shave off any extrenous bytes at the end;  we must be liberal in
+   * what we accept.
    */
 
-  ninfo("rb_accumlen=%d rb_pktlen=%d paysize=%d\n",
-         reass->rb_accumlen, reass->rb_pktlen, paysize);
+  ninfo("ra_accumlen=%d ra_pktlen=%d paysize=%d\n",
+         reass->ra_accumlen, reass->ra_pktlen, paysize);
 
-  if (reass->rb_accumlen == 0 || reass->rb_accumlen >= reass->rb_pktlen)
+  if (reass->ra_accumlen >= reass->ra_pktlen)
     {
-      ninfo("IP packet ready (length %d)\n", reass->rb_pktlen);
+      unsigned int pktlen = reass->ra_pktlen;
+
+      ninfo("IP packet ready (length %d)\n", pktlen);
+
+      if (pktlen > reass->ra_iob->io_pktlen)
+        {
+          pktlen = reass->ra_iob->io_pktlen;
+        }
 
-      radio->r_dev.d_buf  = reass->rb_buf;
-      radio->r_dev.d_len  = reass->rb_pktlen;
-      reass->rb_active    = false;
-      reass->rb_pktlen    = 0;
-      reass->rb_accumlen  = 0;
+      /* Copy the reassembled packet into the driver's packet buffer */
+
+      iob_copyout(rxbuf, reass->ra_iob, pktlen, 0);
+      radio->r_dev.d_len = pktlen;
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.sixlowpan.reassembled++;
+#endif
+      sixlowpan_reass_free(reass);
       return INPUT_COMPLETE;
     }
 
-  radio->r_dev.d_buf  = NULL;
   radio->r_dev.d_len  = 0;
   return INPUT_PARTIAL;
 
 errout_with_reass:
-  sixlowpan_reass_free(reass);
+  if (reass != NULL)
+    {
+      sixlowpan_reass_free(reass);
+    }
+
   return ret;
 }
 
@@ -607,7 +653,6 @@ errout_with_reass:
 
 static int sixlowpan_dispatch(FAR struct radio_driver_s *radio)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
   int ret;
 
   sixlowpan_dumpbuffer("Incoming packet",
@@ -632,13 +677,6 @@ static int sixlowpan_dispatch(FAR struct radio_driver_s *radio)
    */
 
   ret = ipv6_input(&radio->r_dev);
-
-  /* Free the reassemby buffer */
-
-  reass = (FAR struct sixlowpan_reassbuf_s *)radio->r_dev.d_buf;
-  DEBUGASSERT(reass != NULL);
-  sixlowpan_reass_free(reass);
-
   return ret;
 }
 
@@ -673,10 +711,10 @@ static int sixlowpan_dispatch(FAR struct radio_driver_s *radio)
  *   they are received (meaning for the driver, that two packet buffers are
  *   required:  One for reassembly of RX packets and one used for TX polling).
  *
- *   After each frame is processed into d_buf, the IOB is deallocated.  If
- *   reassembly is incomplete, the partially reassembled packet must be
- *   preserved by the radio network drvier and provided again when the next
- *   frame is received.
+ *   After each frame is processed, the IOB is deallocated.  Fragments of
+ *   packets that are not yet complete are held by the 6LoWPAN layer in
+ *   IOB chains, so the driver's d_buf need not be preserved between
+ *   frames.
  *
  *   When the packet in the d_buf is fully reassembled, it will be provided
  *   to the network as with any other received packet.  d_len will be set
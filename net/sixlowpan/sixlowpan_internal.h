@@ -122,7 +122,12 @@
 
 #define REASS_POOL_PREALLOCATED 0
 #define REASS_POOL_DYNAMIC      1
-#define REASS_POOL_RADIO        2
+
+/* Reassembly hash table size */
+
+#ifndef CONFIG_NET_6LOWPAN_REASS_HASHSIZE
+#  define CONFIG_NET_6LOWPAN_REASS_HASHSIZE 8
+#endif
 
 /* Debug ********************************************************************/
 
@@ -206,6 +211,27 @@ union sixlowpan_metadata_u
 #endif
 };
 
+/* This structure holds the state of one reassembly in progress.  The
+ * fragments are accumulated in an IOB chain so that no full packet buffer
+ * is tied up while waiting for the remaining fragments.  When the last
+ * fragment arrives, the packet is copied into the radio driver's d_buf.
+ */
+
+struct iob_s;               /* Forward reference */
+
+struct sixlowpan_reass_s
+{
+  FAR struct sixlowpan_reass_s *ra_flink; /* Hash chain or free list link */
+  FAR struct iob_s *ra_iob;               /* The packet being reassembled */
+  struct netdev_varaddr_s ra_fragsrc;     /* Source MAC address */
+  systime_t ra_time;                      /* Time reassembly was started */
+  uint16_t ra_reasstag;                   /* Reassembly tag */
+  uint16_t ra_pktlen;                     /* Size of the IPv6 packet */
+  uint16_t ra_accumlen;                   /* Number of bytes received */
+  uint16_t ra_boffset;                    /* Offset to fragment data */
+  uint8_t  ra_pool;                       /* See REASS_POOL_* definitions */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -727,12 +753,14 @@ void sixlowpan_reass_initialize(void);
  * Name: sixlowpan_reass_allocate
  *
  * Description:
- *   The sixlowpan_reass_allocate function will get a free reassembly buffer
+ *   The sixlowpan_reass_allocate function will get a free reassembly
  *   structure for use by 6LoWPAN.
  *
  *   This function will first attempt to allocate from the g_free_reass
- *   list.  If that the list is empty, then the reassembly buffer structure
- *   will be allocated from the dynamic memory pool.
+ *   list.  If that the list is empty, then the reassembly structure will be
+ *   allocated from the dynamic memory pool or, if that is not possible, the
+ *   oldest reassembly in progress will be cancelled and its structure
+ *   reused.
  *
  * Input Parameters:
  *   reasstag - The reassembly tag for subsequent lookup.
@@ -740,15 +768,15 @@ void sixlowpan_reass_initialize(void);
  *
  * Returned Value:
  *   A reference to the allocated reass structure.  All fields used by the
- *   reasembly logic have been zeroed.  On a failure to allocate, NULL is
- *   returned.
+ *   reasembly logic have been initialized.  On a failure to allocate, NULL
+ *   is returned.
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-FAR struct sixlowpan_reassbuf_s *
+FAR struct sixlowpan_reass_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc);
 
@@ -756,8 +784,8 @@ FAR struct sixlowpan_reassbuf_s *
  * Name: sixlowpan_reass_find
  *
  * Description:
- *   Find a previously allocated, active reassembly buffer with the specified
- *   reassembly tag.
+ *   Find a previously allocated, active reassembly with the specified
+ *   reassembly tag and source address.
  *
  * Input Parameters:
  *   reasstag - The reassembly tag to match.
@@ -771,18 +799,44 @@ FAR struct sixlowpan_reassbuf_s *
  *
  ****************************************************************************/
 
-FAR struct sixlowpan_reassbuf_s *
+FAR struct sixlowpan_reass_s *
   sixlowpan_reass_find(uint16_t reasstag,
                        FAR const struct netdev_varaddr_s *fragsrc);
 
+/****************************************************************************
+ * Name: sixlowpan_reass_write
+ *
+ * Description:
+ *   Copy fragment data into the reassembly at the given offset in the IPv6
+ *   packet.  Fragments may arrive in any order after the first.
+ *
+ * Input Parameters:
+ *   reass  - The reassembly to receive the data
+ *   src    - The fragment data
+ *   len    - The number of bytes of data
+ *   offset - The offset of the data in the reassembled packet
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOMEM means
+ *   that no IOBs were available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int sixlowpan_reass_write(FAR struct sixlowpan_reass_s *reass,
+                          FAR const uint8_t *src, unsigned int len,
+                          unsigned int offset);
+
 /****************************************************************************
  * Name: sixlowpan_reass_free
  *
  * Description:
- *   The sixlowpan_reass_free function will return a reass structure
- *   to the free list of  messages if it was a pre-allocated reass
- *   structure. If the reass structure was allocated dynamically it will
- *   be deallocated.
+ *   The sixlowpan_reass_free function will release the IOB chain of a
+ *   reassembly and return the reass structure to the free list if it was
+ *   pre-allocated.  If the reass structure was allocated dynamically it
+ *   will be deallocated.
  *
  * Input Parameters:
  *   reass - reass structure to free
@@ -795,7 +849,7 @@ FAR struct sixlowpan_reassbuf_s *
  *
  ****************************************************************************/
 
-void sixlowpan_reass_free(FAR struct sixlowpan_reassbuf_s *reass);
+void sixlowpan_reass_free(FAR struct sixlowpan_reass_s *reass);
 
 #endif /* CONFIG_NET_6LOWPAN */
 #endif /* _NET_SIXLOWPAN_SIXLOWPAN_INTERNAL_H */
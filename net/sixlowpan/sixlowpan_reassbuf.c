@@ -1,7 +1,7 @@
 /****************************************************************************
  *  net/sixlowpan/sixlowpan_reassbuf.c
  *
- *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2017-2018 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,13 +42,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
-#include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
+#include <debug.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/netstats.h>
 
 #include "sixlowpan_internal.h"
 
@@ -64,25 +65,53 @@
  * Private Data
  ****************************************************************************/
 
-/* The g_free_reass is a list of reassembly buffer structures that are available for
- * general use.  The number of messages in this list is a system configuration
- * item.  Protected only by the network lock.
+/* The g_free_reass is a list of reassembly structures that are available
+ * for general use.  The number of structures in this list is a system
+ * configuration item.  Protected only by the network lock.
  */
 
-static FAR struct sixlowpan_reassbuf_s *g_free_reass;
+static FAR struct sixlowpan_reass_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* Active reassemblies, hashed by reassembly tag and source address */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reass_s *
+  g_reass_hash[CONFIG_NET_6LOWPAN_REASS_HASHSIZE];
 
-/* Pool of pre-allocated reassembly buffer stuctures */
+/* Pool of pre-allocated reassembly stuctures */
 
-static struct sixlowpan_reassbuf_s g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
+static struct sixlowpan_reass_s g_reass_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
+
+/* Used to fill the gaps left by fragments that arrive out of order */
+
+static const uint8_t g_reass_zeros[32];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the hash chain index for a reassembly tag and source address.
+ *
+ ****************************************************************************/
+
+static unsigned int
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash = (hash << 1) ^ fragsrc->nv_addr[i];
+    }
+
+  return hash % CONFIG_NET_6LOWPAN_REASS_HASHSIZE;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -91,7 +120,7 @@ static struct sixlowpan_reassbuf_s g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF]
  *   the previosly received fragements.
  *
  * Input Parameters:
- *   radio    - Radio network device driver state instance
+ *   reass    - The reassembly in progress
  *   fragsrc  - The source address of the fragment.
  *
  * Returned Value:
@@ -99,16 +128,16 @@ static struct sixlowpan_reassbuf_s g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF]
  *
  ****************************************************************************/
 
-static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
+static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reass_s *reass,
                                       FAR const struct netdev_varaddr_s *fragsrc)
 {
   /* The addresses cannot match if they are not the same size */
 
-  if (fragsrc->nv_addrlen == reass->rb_fragsrc.nv_addrlen)
+  if (fragsrc->nv_addrlen == reass->ra_fragsrc.nv_addrlen)
     {
       /* The are the same size, return the address comparison */
 
-      return (memcmp(fragsrc->nv_addr, reass->rb_fragsrc.nv_addr,
+      return (memcmp(fragsrc->nv_addr, reass->ra_fragsrc.nv_addr,
                      fragsrc->nv_addrlen) == 0);
     }
 
@@ -119,7 +148,7 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  * Name: sixlowpan_reass_expire
  *
  * Description:
- *   Free all expired or inactive reassembly buffers.
+ *   Free all expired reassemblies.
  *
  * Input Parameters:
  *   None
@@ -134,37 +163,27 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
 
 static void sixlowpan_reass_expire(void)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
-  FAR struct sixlowpan_reassbuf_s *next;
-  systime_t elapsed;
-
-  /* If reassembly timed out, cancel it */
+  FAR struct sixlowpan_reass_s *reass;
+  FAR struct sixlowpan_reass_s *next;
+  systime_t now = clock_systimer();
+  int i;
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_HASHSIZE; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
+      for (reass = g_reass_hash[i]; reass != NULL; reass = next)
         {
-          /* Get the elpased time of the reassembly */
+          /* Needed if 'reass' is freed */
 
-          elapsed = clock_systimer() - reass->rb_time;
+          next = reass->ra_flink;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* If the reassembly has expired, then free it */
 
-          if (elapsed > NET_6LOWPAN_TIMEOUT)
+          if (now - reass->ra_time > NET_6LOWPAN_TIMEOUT)
             {
               nwarn("WARNING: Reassembly timed out\n");
+#ifdef CONFIG_NET_STATISTICS
+              g_netstats.sixlowpan.timeout++;
+#endif
               sixlowpan_reass_free(reass);
             }
         }
@@ -172,52 +191,36 @@ static void sixlowpan_reass_expire(void)
 }
 
 /****************************************************************************
- * Name: sixlowpan_remove_active
+ * Name: sixlowpan_reass_oldest
  *
  * Description:
- *   Remove a reassembly buffer from the active reassembly buffer list.
- *
- * Input Parameters:
- *   reass - The reassembly buffer to be removed.
- *
- * Returned Value:
- *   None
+ *   Return the oldest reassembly in progress.
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
+static FAR struct sixlowpan_reass_s *sixlowpan_reass_oldest(void)
 {
-  FAR struct sixlowpan_reassbuf_s *curr;
-  FAR struct sixlowpan_reassbuf_s *prev;
-
-  /* Find the reassembly buffer in the list of active reassembly buffers */
-
-  for (prev = NULL, curr = g_active_reass;
-       curr != NULL && curr != reass;
-       prev = curr, curr = curr->rb_flink)
-    {
-    }
-
-  /* Did we find it? */
+  FAR struct sixlowpan_reass_s *oldest = NULL;
+  FAR struct sixlowpan_reass_s *reass;
+  systime_t now = clock_systimer();
+  int i;
 
-  if (curr != NULL)
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_HASHSIZE; i++)
     {
-      /* Yes.. remove it from the active reassembly buffer list */
-
-      if (prev == NULL)
-        {
-          g_active_reass = reass->rb_flink;
-        }
-      else
+      for (reass = g_reass_hash[i]; reass != NULL; reass = reass->ra_flink)
         {
-          prev->rb_flink = reass->rb_flink;
+          if (oldest == NULL ||
+              now - reass->ra_time > now - oldest->ra_time)
+            {
+              oldest = reass;
+            }
         }
     }
 
-  reass->rb_flink = NULL;
+  return oldest;
 }
 
 /****************************************************************************
@@ -244,37 +247,44 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
 void sixlowpan_reass_initialize(void)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reass_s *reass;
   int i;
 
-  /* Initialize g_free_reass, the list of reassembly buffer structures that are
+  /* Initialize g_free_reass, the list of reassembly structures that are
    * available for allocation.
    */
 
   g_free_reass = NULL;
-  for (i = 0, reass = g_metadata_pool;
+  for (i = 0, reass = g_reass_pool;
        i < CONFIG_NET_6LOWPAN_NREASSBUF;
        i++, reass++)
     {
-      /* Add the next meta data structure from the pool to the list of
-       * general structures.
+      /* Add the next structure from the pool to the list of general
+       * structures.
        */
 
-      reass->rb_flink = g_free_reass;
+      reass->ra_flink = g_free_reass;
       g_free_reass    = reass;
     }
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_HASHSIZE; i++)
+    {
+      g_reass_hash[i] = NULL;
+    }
 }
 
 /****************************************************************************
  * Name: sixlowpan_reass_allocate
  *
  * Description:
- *   The sixlowpan_reass_allocate function will get a free reassembly buffer
+ *   The sixlowpan_reass_allocate function will get a free reassembly
  *   structure for use by 6LoWPAN.
  *
  *   This function will first attempt to allocate from the g_free_reass
- *   list.  If that the list is empty, then the reassembly buffer structure
- *   will be allocated from the dynamic memory pool.
+ *   list.  If that the list is empty, then the reassembly structure will be
+ *   allocated from the dynamic memory pool or, if that is not possible, the
+ *   oldest reassembly in progress will be cancelled and its structure
+ *   reused.
  *
  * Input Parameters:
  *   reasstag - The reassembly tag for subsequent lookup.
@@ -282,69 +292,111 @@ void sixlowpan_reass_initialize(void)
  *
  * Returned Value:
  *   A reference to the allocated reass structure.  All fields used by the
- *   reasembly logic have been zeroed.  On a failure to allocate, NULL is
- *   returned.
+ *   reasembly logic have been initialized.  On a failure to allocate, NULL
+ *   is returned.
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-FAR struct sixlowpan_reassbuf_s *
+FAR struct sixlowpan_reass_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reass_s *reass;
+  FAR struct iob_s *iob;
+  unsigned int hash;
   uint8_t pool;
 
-  /* First, removed any expired or inactive reassembly buffers.  This might
-   * free up a pre-allocated buffer for this allocation.
+  /* First, removed any expired reassemblies.  This might free up a pre-
+   * allocated structure for this allocation.
    */
 
   sixlowpan_reass_expire();
 
+  /* The packet data is held in IOBs;  get the first one now */
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.sixlowpan.nomem++;
+#endif
+      return NULL;
+    }
+
   /* Now, try the free list first */
 
+  reass = NULL;
+  pool  = REASS_POOL_PREALLOCATED;
+
   if (g_free_reass != NULL)
     {
       reass         = g_free_reass;
-      g_free_reass  = reass->rb_flink;
-      pool          = REASS_POOL_PREALLOCATED;
+      g_free_reass  = reass->ra_flink;
     }
+#ifndef CONFIG_NET_6LOWPAN_REASS_STATIC
   else
     {
-#ifdef CONFIG_NET_6LOWPAN_REASS_STATIC
-      reass         = NULL;
-#else
-      /* If we cannot get a reassembly buffer instance from the free list, then we
+      /* If we cannot get a reassembly structure from the free list, then we
        * will have to allocate one from the kernal memory pool.
        */
 
-      reass = (FAR struct sixlowpan_reassbuf_s *)
-        kmm_malloc((sizeof (struct sixlowpan_reassbuf_s)));
+      reass = (FAR struct sixlowpan_reass_s *)
+        kmm_malloc((sizeof (struct sixlowpan_reass_s)));
       pool  = REASS_POOL_DYNAMIC;
-#endif
     }
+#endif
 
-  /* We have successfully allocated memory from some source? */
-
-  if (reass != NULL)
+  if (reass == NULL)
     {
-      /* Zero and tag the allocated reassembly buffer structure. */
+      /* Sacrifice the oldest reassembly in progress.  It is the one least
+       * likely to complete.
+       */
+
+      reass = sixlowpan_reass_oldest();
+      if (reass == NULL)
+        {
+          iob_free(iob);
+          return NULL;
+        }
+
+      nwarn("WARNING: Evicting reassembly tag=%04x\n", reass->ra_reasstag);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.sixlowpan.evict++;
+#endif
 
-      memset(reass, 0, sizeof(struct sixlowpan_reassbuf_s));
-      memcpy(&reass->rb_fragsrc, fragsrc, sizeof(struct netdev_varaddr_s));
-      reass->rb_pool     = pool;
-      reass->rb_active   = true;
-      reass->rb_reasstag = reasstag;
-      reass->rb_time     = clock_systimer();
+      sixlowpan_reass_free(reass);
 
-      /* Add the reassembly buffer to the list of active reassembly buffers */
+      /* A dynamically allocated structure was freed, not recycled */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      reass = g_free_reass;
+      if (reass == NULL)
+        {
+          iob_free(iob);
+          return NULL;
+        }
+
+      g_free_reass  = reass->ra_flink;
+      pool          = REASS_POOL_PREALLOCATED;
     }
 
+  /* Initialize and tag the allocated reassembly structure. */
+
+  memset(reass, 0, sizeof(struct sixlowpan_reass_s));
+  memcpy(&reass->ra_fragsrc, fragsrc, sizeof(struct netdev_varaddr_s));
+  reass->ra_iob      = iob;
+  reass->ra_pool     = pool;
+  reass->ra_reasstag = reasstag;
+  reass->ra_time     = clock_systimer();
+
+  /* Add the reassembly to its hash chain */
+
+  hash               = sixlowpan_reass_hash(reasstag, fragsrc);
+  reass->ra_flink    = g_reass_hash[hash];
+  g_reass_hash[hash] = reass;
+
   return reass;
 }
 
@@ -352,8 +404,8 @@ FAR struct sixlowpan_reassbuf_s *
  * Name: sixlowpan_reass_find
  *
  * Description:
- *   Find a previously allocated, active reassembly buffer with the specified
- *   reassembly tag.
+ *   Find a previously allocated, active reassembly with the specified
+ *   reassembly tag and source address.
  *
  * Input Parameters:
  *   reasstag - The reassembly tag to match.
@@ -367,30 +419,28 @@ FAR struct sixlowpan_reassbuf_s *
  *
  ****************************************************************************/
 
-FAR struct sixlowpan_reassbuf_s *
+FAR struct sixlowpan_reass_s *
   sixlowpan_reass_find(uint16_t reasstag,
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
-  FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reass_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+  /* First, removed any expired reassemblies (we don't want to return old
+   * reassembly with the same tag)
    */
 
   sixlowpan_reass_expire();
 
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+  /* Now search for the matching reassembly in the hash chain.  In order to
+   * be a match, it must have the same reassembly tag as well as source
+   * address (different sources might use the same reassembly tag).
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_reass_hash[sixlowpan_reass_hash(reasstag, fragsrc)];
+       reass != NULL;
+       reass = reass->ra_flink)
     {
-      /* In order to be a match, it must have the same reassembly tag as
-       * well as source address (different sources might use the same
-       * reassembly tag).
-       */
-
-      if (reass->rb_reasstag == reasstag &&
+      if (reass->ra_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
           return reass;
@@ -402,14 +452,79 @@ FAR struct sixlowpan_reassbuf_s *
   return NULL;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_write
+ *
+ * Description:
+ *   Copy fragment data into the reassembly at the given offset in the IPv6
+ *   packet.  Fragments may arrive in any order after the first.
+ *
+ * Input Parameters:
+ *   reass  - The reassembly to receive the data
+ *   src    - The fragment data
+ *   len    - The number of bytes of data
+ *   offset - The offset of the data in the reassembled packet
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOMEM means
+ *   that no IOBs were available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int sixlowpan_reass_write(FAR struct sixlowpan_reass_s *reass,
+                          FAR const uint8_t *src, unsigned int len,
+                          unsigned int offset)
+{
+  FAR struct iob_s *iob = reass->ra_iob;
+  unsigned int ncopy;
+  int ret;
+
+  DEBUGASSERT(iob != NULL);
+
+  /* An IOB chain cannot have holes.  Zero fill up to the offset; the
+   * missing fragment will overwrite the fill when it arrives.
+   */
+
+  while (iob->io_pktlen < offset)
+    {
+      ncopy = offset - iob->io_pktlen;
+      if (ncopy > sizeof(g_reass_zeros))
+        {
+          ncopy = sizeof(g_reass_zeros);
+        }
+
+      ret = iob_trycopyin(iob, g_reass_zeros, ncopy, iob->io_pktlen, false);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  ret = iob_trycopyin(iob, src, len, offset, false);
+  if (ret >= 0)
+    {
+      reass->ra_accumlen += len;
+      return OK;
+    }
+
+errout:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.sixlowpan.nomem++;
+#endif
+  return ret;
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_free
  *
  * Description:
- *   The sixlowpan_reass_free function will return a reass structure
- *   to the free list of  messages if it was a pre-allocated reass
- *   structure. If the reass structure was allocated dynamically it will
- *   be deallocated.
+ *   The sixlowpan_reass_free function will release the IOB chain of a
+ *   reassembly and return the reass structure to the free list if it was
+ *   pre-allocated.  If the reass structure was allocated dynamically it
+ *   will be deallocated.
  *
  * Input Parameters:
  *   reass - reass structure to free
@@ -422,37 +537,53 @@ FAR struct sixlowpan_reassbuf_s *
  *
  ****************************************************************************/
 
-void sixlowpan_reass_free(FAR struct sixlowpan_reassbuf_s *reass)
+void sixlowpan_reass_free(FAR struct sixlowpan_reass_s *reass)
 {
-  /* First, remove the reassembly buffer from the list of active reassembly
-   * buffers.
-   */
+  FAR struct sixlowpan_reass_s **link;
+
+  /* First, remove the reassembly from its hash chain */
+
+  for (link = &g_reass_hash[sixlowpan_reass_hash(reass->ra_reasstag,
+                                                 &reass->ra_fragsrc)];
+       *link != NULL;
+       link = &(*link)->ra_flink)
+    {
+      if (*link == reass)
+        {
+          *link = reass->ra_flink;
+          break;
+        }
+    }
 
-  sixlowpan_remove_active(reass);
+  reass->ra_flink = NULL;
 
-  /* If this is a pre-allocated reassembly buffer structure, then just put it back
+  /* Release the partially reassembled packet */
+
+  if (reass->ra_iob != NULL)
+    {
+      iob_free_chain(reass->ra_iob);
+      reass->ra_iob = NULL;
+    }
+
+  /* If this is a pre-allocated reassembly structure, then just put it back
    * in the free list.
    */
 
-  if (reass->rb_pool == REASS_POOL_PREALLOCATED)
+  if (reass->ra_pool == REASS_POOL_PREALLOCATED)
     {
-      reass->rb_flink = g_free_reass;
+      reass->ra_flink = g_free_reass;
       g_free_reass    = reass;
     }
-  else if (reass->rb_pool == REASS_POOL_DYNAMIC)
+  else
     {
 #ifdef CONFIG_NET_6LOWPAN_REASS_STATIC
       DEBUGPANIC();
 #else
-      DEBUGASSERT(reass->rb_pool == REASS_POOL_DYNAMIC);
+      DEBUGASSERT(reass->ra_pool == REASS_POOL_DYNAMIC);
 
       /* Otherwise, deallocate it. */
 
       sched_kfree(reass);
 #endif
     }
-
-  /* If the reassembly buffer structure was provided by the driver, nothing
-   * needs to be freed.
-   */
 }
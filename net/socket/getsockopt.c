@@ -43,12 +43,16 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <netinet/in.h>
+#include <netpacket/packet.h>
 #include <debug.h>
 #include <assert.h>
 #include <errno.h>
 
 #include "socket/socket.h"
 #include "usrsock/usrsock.h"
+#include "tcp/tcp.h"
+#include "pkt/pkt.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -99,6 +103,27 @@
 int psock_getsockopt(FAR struct socket *psock, int level, int option,
                      FAR void *value, FAR socklen_t *value_len)
 {
+#ifdef HAVE_TCP_SOCKOPTS
+  /* Options at the IPPROTO_TCP level are handled by the TCP layer */
+
+  if (level == IPPROTO_TCP && psock->s_type == SOCK_STREAM &&
+      (psock->s_domain == PF_INET || psock->s_domain == PF_INET6) &&
+      psock->s_conn != NULL && value != NULL && value_len != NULL)
+    {
+      return tcp_getsockopt(psock, option, value, value_len);
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Options at the SOL_PACKET level set up the packet socket rings */
+
+  if (level == SOL_PACKET && psock->s_domain == PF_PACKET &&
+      psock->s_conn != NULL && value != NULL && value_len != NULL)
+    {
+      return pkt_getsockopt(psock, option, value, value_len);
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_GETVALID(option) || !value || !value_len)
@@ -148,6 +173,12 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
                            * periodic transmission */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_DONTROUTE:  /* Requests outgoing messages bypass standard routing */
+#ifdef CONFIG_NET_REUSEPORT
+      case SO_REUSEPORT:  /* Allow load balanced sharing of a local port */
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMP:  /* Return SCM_TIMESTAMP with received datagrams */
+#endif
         {
           sockopt_t optionset;
 
@@ -204,6 +235,36 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
         }
         break;
 
+#ifdef CONFIG_NET_REUSEPORT
+      case SO_INCOMING_CPU: /* Preferred CPU of an SO_REUSEPORT socket */
+        {
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* s_cpu holds the CPU plus one so that zero means none */
+
+          *(FAR int *)value = (int)psock->s_cpu - 1;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMPING: /* Selected receive timestamps */
+        {
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = psock->s_tstamp;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       /* The following are valid only if the OS CLOCK feature is enabled */
 
       case SO_RCVTIMEO:
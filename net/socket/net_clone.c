@@ -98,6 +98,12 @@ int net_clone(FAR struct socket *psock1, FAR struct socket *psock2)
 #ifdef CONFIG_NET_SOLINGER
   psock2->s_linger   = psock1->s_linger;    /* Linger timeout value (in deciseconds) */
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+  psock2->s_cpu      = psock1->s_cpu;       /* Preferred CPU plus one */
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+  psock2->s_tstamp   = psock1->s_tstamp;    /* SO_TIMESTAMPING flags */
+#endif
 #endif
   psock2->s_conn     = psock1->s_conn;      /* UDP or TCP connection structure */
 
@@ -156,6 +156,7 @@ void net_releaselist(FAR struct socketlist *list)
 int sockfd_allocate(int minsd)
 {
   FAR struct socketlist *list;
+  uint32_t avail;
   int i;
 
   /* Get the socket list for this task/thread */
@@ -163,11 +164,38 @@ int sockfd_allocate(int minsd)
   list = sched_getsockets();
   if (list)
     {
-      /* Search for a socket structure with no references */
+      /* Search for a socket structure with no references, using the
+       * bitmap to skip over 32 sockets in use at a time.
+       */
+
+      if (minsd < 0)
+        {
+          minsd = 0;
+        }
 
       _net_semtake(list);
-      for (i = minsd; i < CONFIG_NSOCKET_DESCRIPTORS; i++)
+      for (i = minsd; i < CONFIG_NSOCKET_DESCRIPTORS; )
         {
+          avail = ~list->sl_inuse[i >> 5] &
+                  ((uint32_t)0xffffffff << (i & 31));
+          if (avail == 0)
+            {
+              i = ((i >> 5) + 1) << 5;
+              continue;
+            }
+
+          while ((avail & ((uint32_t)1 << (i & 31))) == 0)
+            {
+              i++;
+            }
+
+          if (i >= CONFIG_NSOCKET_DESCRIPTORS)
+            {
+              break;
+            }
+
+          list->sl_inuse[i >> 5] |= (uint32_t)1 << (i & 31);
+
           /* Are there references on this socket? */
 
           if (!list->sl_sockets[i].s_crefs)
@@ -181,6 +209,12 @@ int sockfd_allocate(int minsd)
                _net_semgive(list);
                return i + __SOCKFD_OFFSET;
             }
+
+          /* The socket was cloned into the list without setting its bit.
+           * The bit is now correct.
+           */
+
+          i++;
         }
 
       _net_semgive(list);
@@ -225,9 +259,15 @@ void sock_release(FAR struct socket *psock)
             }
           else
             {
+              int ndx = (int)(psock - list->sl_sockets);
+
               /* The socket will not persist... reset it */
 
               memset(psock, 0, sizeof(struct socket));
+              if (ndx >= 0 && ndx < CONFIG_NSOCKET_DESCRIPTORS)
+                {
+                  list->sl_inuse[ndx >> 5] &= ~((uint32_t)1 << (ndx & 31));
+                }
             }
 
           _net_semgive(list);
@@ -0,0 +1,367 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "inet/inet.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_READAHEAD) && \
+    defined(NET_UDP_HAVE_STACK)
+#  define HAVE_UDP_RECVMSG 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmsg_isudp
+ *
+ * Description:
+ *   Return true if the socket is an INET UDP socket that receives through
+ *   the read-ahead queue.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_RECVMSG
+static inline bool recvmsg_isudp(FAR struct socket *psock)
+{
+  return psock->s_type == SOCK_DGRAM &&
+         (psock->s_domain == PF_INET || psock->s_domain == PF_INET6) &&
+         psock->s_sockif == inet_sockif(psock->s_domain, SOCK_DGRAM,
+                                        IPPROTO_UDP);
+}
+#else
+#  define recvmsg_isudp(p) (false)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives a message into the I/O vector of a struct
+ *   msghdr.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   UDP datagrams are scattered directly from the read-ahead queue into
+ *   the I/O vector.  For other sockets, the message is received into the
+ *   first non-empty element of the I/O vector:  For stream sockets that
+ *   is a legal short read; datagram sockets of other types do not support
+ *   more than one non-empty element.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to receive
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On any
+ *   failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  FAR struct iovec *iov = NULL;
+  FAR socklen_t *fromlen = NULL;
+  socklen_t namelen;
+  ssize_t ret;
+  int nonempty = 0;
+  int i;
+
+  if (msg == NULL || msg->msg_iovlen < 0 ||
+      (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  msg->msg_flags = 0;
+
+  if (recvmsg_isudp(psock))
+    {
+#ifdef HAVE_UDP_RECVMSG
+      /* msg_controllen still holds the size of the control buffer here */
+
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+      ret = psock_udp_recvmsg(psock, msg, flags);
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+      return ret;
+#endif
+    }
+
+  msg->msg_controllen = 0;
+
+  /* Find the first non-empty element of the I/O vector */
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      if (msg->msg_iov[i].iov_len > 0)
+        {
+          if (iov == NULL)
+            {
+              iov = &msg->msg_iov[i];
+            }
+
+          nonempty++;
+        }
+    }
+
+  if (iov == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (nonempty > 1 && psock->s_type != SOCK_STREAM)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  if (msg->msg_name != NULL)
+    {
+      namelen = msg->msg_namelen;
+      fromlen = &namelen;
+    }
+
+  ret = psock_recvfrom(psock, iov->iov_base, iov->iov_len, flags,
+                       (FAR struct sockaddr *)msg->msg_name, fromlen);
+  if (ret >= 0 && fromlen != NULL)
+    {
+      msg->msg_namelen = namelen;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmsg
+ *
+ * Description:
+ *   recvmsg() receives a message from a socket into the scatter/gather
+ *   array described by 'msg'.
+ *
+ * Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msg    - The message to receive
+ *   flags  - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On  error,
+ *   -1 is returned, and errno is set appropriately.  See recvfrom().
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* recvmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let psock_recvmsg() do all of the work */
+
+  ret = psock_recvmsg(sockfd_socket(sockfd), msg, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   recvmmsg() receives up to 'vlen' messages with a single call and a
+ *   single acquisition of the network lock.  The call waits (unless the
+ *   socket is non-blocking or MSG_DONTWAIT is specified) for the first
+ *   message only:  It then returns as soon as no further message is
+ *   immediately available, as if MSG_WAITFORONE were always specified.
+ *   Batching beyond the first message requires a UDP socket with
+ *   read-ahead buffering or a non-blocking socket.
+ *
+ * Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - The vector of messages to receive.  The length of each
+ *             message is returned in msg_len.
+ *   vlen    - The number of messages in 'msgvec'
+ *   flags   - Receive flags
+ *   timeout - If not NULL, no further messages are received once this
+ *             interval has elapsed.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  struct timespec deadline;
+  struct timespec now;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  psock = sockfd_socket(sockfd);
+  if (msgvec == NULL)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (timeout != NULL)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_sec  += timeout->tv_sec;
+      deadline.tv_nsec += timeout->tv_nsec;
+      if (deadline.tv_nsec >= NSEC_PER_SEC)
+        {
+          deadline.tv_sec++;
+          deadline.tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+
+  /* Hold the network lock across the whole batch.  It is released while
+   * waiting for the first message.
+   */
+
+  net_lock();
+  flags &= ~MSG_WAITFORONE;
+
+  for (i = 0; i < vlen; i++)
+    {
+      if (i > 0)
+        {
+          /* Only the first message may wait */
+
+          if (!recvmsg_isudp(psock) && !_SS_ISNONBLOCK(psock->s_flags))
+            {
+              break;
+            }
+
+          flags |= MSG_DONTWAIT;
+
+          if (timeout != NULL)
+            {
+              (void)clock_gettime(CLOCK_REALTIME, &now);
+              if (now.tv_sec > deadline.tv_sec ||
+                  (now.tv_sec == deadline.tv_sec &&
+                   now.tv_nsec >= deadline.tv_nsec))
+                {
+                  break;
+                }
+            }
+        }
+
+      ret = psock_recvmsg(psock, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = (unsigned int)ret;
+    }
+
+  net_unlock();
+
+  /* Report the error only if no message was received */
+
+  if (i > 0)
+    {
+      leave_cancellation_point();
+      return (int)i;
+    }
+
+errout:
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return (int)ret;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,291 @@
+/****************************************************************************
+ * net/socket/sendmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "inet/inet.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+    defined(NET_UDP_HAVE_STACK)
+#  define HAVE_UDP_SENDMSG 1
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends the message described by a struct msghdr.  This
+ *   is an internal OS interface.  It is functionally equivalent to
+ *   sendmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   A UDP datagram is gathered from the I/O vector directly into a write
+ *   buffer.  For stream sockets, each element of the I/O vector is sent in
+ *   turn.  Datagram sockets of other types do not support more than one
+ *   non-empty element.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                      int flags)
+{
+  FAR const struct iovec *iov = NULL;
+  ssize_t nsent;
+  ssize_t ret;
+  int nonempty = 0;
+  int i;
+
+  if (msg == NULL || msg->msg_iovlen < 0 ||
+      (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      return -EINVAL;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      if (msg->msg_iov[i].iov_len > 0)
+        {
+          if (iov == NULL)
+            {
+              iov = &msg->msg_iov[i];
+            }
+
+          nonempty++;
+        }
+    }
+
+  /* A message with no more than one non-empty element is just sendto() */
+
+  if (nonempty <= 1)
+    {
+      return psock_sendto(psock, iov ? iov->iov_base : NULL,
+                          iov ? iov->iov_len : 0, flags,
+                          (FAR const struct sockaddr *)msg->msg_name,
+                          msg->msg_name ? msg->msg_namelen : 0);
+    }
+
+#ifdef HAVE_UDP_SENDMSG
+  if (psock->s_type == SOCK_DGRAM &&
+      (psock->s_domain == PF_INET || psock->s_domain == PF_INET6) &&
+      psock->s_sockif == inet_sockif(psock->s_domain, SOCK_DGRAM,
+                                     IPPROTO_UDP))
+    {
+      return psock_udp_sendmsg(psock, msg, flags);
+    }
+#endif
+
+  if (psock->s_type != SOCK_STREAM)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  /* Send each element of the I/O vector on the stream */
+
+  for (i = 0, nsent = 0; i < msg->msg_iovlen; i++)
+    {
+      if (msg->msg_iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = psock_send(psock, msg->msg_iov[i].iov_base,
+                       msg->msg_iov[i].iov_len, flags);
+      if (ret < 0)
+        {
+          return nsent > 0 ? nsent : ret;
+        }
+
+      nsent += ret;
+      if ((size_t)ret < msg->msg_iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return nsent;
+}
+
+/****************************************************************************
+ * Name: sendmsg
+ *
+ * Description:
+ *   sendmsg() sends a message gathered from the scatter/gather array
+ *   described by 'msg'.
+ *
+ * Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msg    - The message to send
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   -1 is returned, and errno is set appropriately.  See sendto().
+ *
+ ****************************************************************************/
+
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* sendmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let psock_sendmsg() do all of the work */
+
+  ret = psock_sendmsg(sockfd_socket(sockfd), msg, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   sendmmsg() sends up to 'vlen' messages with a single call and a single
+ *   acquisition of the network lock.
+ *
+ * Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msgvec - The vector of messages to send.  The number of bytes sent for
+ *            each message is returned in msg_len.
+ *   vlen   - The number of messages in 'msgvec'
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  If an error occurs
+ *   after at least one message has been sent, the number of messages sent
+ *   is returned.  Otherwise, -1 is returned, and errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  /* sendmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  if (msgvec == NULL)
+    {
+      set_errno(EINVAL);
+      leave_cancellation_point();
+      return ERROR;
+    }
+
+  psock = sockfd_socket(sockfd);
+
+  net_lock();
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = (unsigned int)ret;
+    }
+
+  net_unlock();
+
+  if (i == 0 && ret < 0)
+    {
+      set_errno(-ret);
+      leave_cancellation_point();
+      return ERROR;
+    }
+
+  leave_cancellation_point();
+  return (int)i;
+}
+
+#endif /* CONFIG_NET */
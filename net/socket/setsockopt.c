@@ -44,6 +44,8 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <netinet/in.h>
+#include <netpacket/packet.h>
 #include <errno.h>
 #include <debug.h>
 #include <assert.h>
@@ -53,6 +55,8 @@
 
 #include "socket/socket.h"
 #include "usrsock/usrsock.h"
+#include "tcp/tcp.h"
+#include "pkt/pkt.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -109,6 +113,27 @@
 int psock_setsockopt(FAR struct socket *psock, int level, int option,
                      FAR const void *value, socklen_t value_len)
 {
+#ifdef HAVE_TCP_SOCKOPTS
+  /* Options at the IPPROTO_TCP level are handled by the TCP layer */
+
+  if (level == IPPROTO_TCP && psock->s_type == SOCK_STREAM &&
+      (psock->s_domain == PF_INET || psock->s_domain == PF_INET6) &&
+      psock->s_conn != NULL && value != NULL)
+    {
+      return tcp_setsockopt(psock, option, value, value_len);
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Options at the SOL_PACKET level set up the packet socket rings */
+
+  if (level == SOL_PACKET && psock->s_domain == PF_PACKET &&
+      psock->s_conn != NULL && value != NULL)
+    {
+      return pkt_setsockopt(psock, option, value, value_len);
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_SETVALID(option) || !value)
@@ -157,6 +182,13 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
                            * periodic transmission */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_DONTROUTE:  /* Requests outgoing messages bypass standard routing */
+#ifdef CONFIG_NET_REUSEPORT
+      case SO_REUSEPORT:  /* Allow load balanced sharing of a local port.
+                           * Takes effect on the next bind() or listen() */
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMP:  /* Return SCM_TIMESTAMP with received datagrams */
+#endif
         {
           int setting;
 
@@ -237,6 +269,61 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         }
         break;
 
+#ifdef CONFIG_NET_REUSEPORT
+      case SO_INCOMING_CPU:
+        {
+          int cpu;
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* A negative value removes the preference.  Like SO_REUSEPORT,
+           * the setting is passed to the connection by bind() and listen().
+           */
+
+          cpu = *(FAR int *)value;
+#ifdef CONFIG_SMP
+          if (cpu >= CONFIG_SMP_NCPUS)
+#else
+          if (cpu > 0)
+#endif
+            {
+              return -EINVAL;
+            }
+
+          psock->s_cpu = cpu < 0 ? 0 : cpu + 1;
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMPING:
+        {
+          int flags;
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* Only the receive timestamps are supported */
+
+          flags = *(FAR int *)value;
+          if ((flags & ~(SOF_TIMESTAMPING_RX_HARDWARE |
+                         SOF_TIMESTAMPING_RX_SOFTWARE |
+                         SOF_TIMESTAMPING_SOFTWARE |
+                         SOF_TIMESTAMPING_RAW_HARDWARE)) != 0)
+            {
+              return -EINVAL;
+            }
+
+          psock->s_tstamp = (uint8_t)flags;
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_SOLINGER
       case SO_LINGER:
         {
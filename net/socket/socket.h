@@ -111,10 +111,14 @@
 #define _SO_SNDLOWAT     _SO_BIT(SO_SNDLOWAT)
 #define _SO_SNDTIMEO     _SO_BIT(SO_SNDTIMEO)
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
+#define _SO_INCOMING_CPU _SO_BIT(SO_INCOMING_CPU)
+#define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
+#define _SO_TIMESTAMPING _SO_BIT(SO_TIMESTAMPING)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (15)
+#define _SO_MAXOPT       (19)
 
 /* Macros to set, test, clear options */
 
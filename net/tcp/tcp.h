@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <queue.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 
@@ -63,6 +64,37 @@
 #  define HAVE_TCP_POLL
 #endif
 
+/* Conditions for support of socket options at the IPPROTO_TCP level */
+
+#if defined(CONFIG_NET_SOCKOPTS) && \
+    (defined(CONFIG_NET_TCP_CC) || defined(CONFIG_NET_TCP_NAGLE))
+#  define HAVE_TCP_SOCKOPTS
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+/* Delayed ACKs (RFC 1122).  The first TCP_DACK_QUICKACKS data segments of
+ * a connection are ACKed immediately so that the peer's slow start is not
+ * held back.
+ */
+
+#  define TCP_DACK_TICKS     MSEC2TICK(CONFIG_NET_TCP_DELAYED_ACK_MSEC)
+#  define TCP_DACK_QUICKACKS 8
+
+#  define tcp_dack_expired(conn) \
+     ((conn)->dack_bytes > 0 && \
+      clock_systimer() - (conn)->dack_time >= TCP_DACK_TICKS)
+#else
+#  define tcp_dack_expired(conn) false
+#endif
+
+/* True if the connection shares its port with SO_REUSEPORT */
+
+#ifdef CONFIG_NET_REUSEPORT
+#  define tcp_reuseport(conn) ((conn)->reuseport != 0)
+#else
+#  define tcp_reuseport(conn) false
+#endif
+
 /* Allocate a new TCP data callback */
 
 /* These macros allocate and free callback structures used for receiving
@@ -116,10 +148,15 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_cc_ops_s;      /* Forward reference */
 
 struct tcp_conn_s
 {
   dq_entry_t node;        /* Implements a doubly linked list */
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *hnext; /* Next active connection in the hash bucket */
+  FAR struct tcp_conn_s *lnext; /* Next listener in the hash bucket */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -137,11 +174,22 @@ struct tcp_conn_s
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
                            * segment sent */
+#ifdef CONFIG_NET_REUSEPORT
+  uint8_t  reuseport;     /* Port shared with SO_REUSEPORT (set by bind()) */
+  uint8_t  cpu;           /* SO_INCOMING_CPU plus one, zero if none */
+#endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+  bool     wsok;          /* True: Window scaling was negotiated */
+  uint8_t  snd_scale;     /* Scale shift applied to the peer's window */
+  uint8_t  rcv_scale;     /* Scale shift applied to our window */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -184,6 +232,90 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+  /* Fast retransmit and recovery
+   *
+   *   dupacks    - The number of duplicate ACKs received for the oldest
+   *                un-ACKed segment.
+   *   recovery   - True while in fast recovery.
+   *   recover    - The value of sndseq_max when fast recovery was
+   *                entered.  Recovery ends when that has been ACKed.
+   *   rexmit_seq - The next sequence number that may be retransmitted
+   *                during SACK-based recovery.
+   *   sackok     - The peer sent the SACK-permitted option.
+   */
+
+  uint8_t    dupacks;     /* Number of duplicate ACKs for the oldest segment */
+  bool       recovery;    /* True: Fast recovery in progress */
+  uint32_t   recover;     /* Recovery point (sndseq_max on entry) */
+#ifdef CONFIG_NET_TCP_SACK
+  bool       sackok;      /* True: Peer accepts SACK options */
+  uint32_t   rexmit_seq;  /* Next candidate for SACK retransmission */
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control
+   *
+   *   cc       - The congestion control algorithm (NULL until the first
+   *              data is sent, then the default algorithm unless another
+   *              one was selected with the TCP_CONGESTION socket option).
+   *   cwnd     - Congestion window (bytes).  Zero until initialized.
+   *   ssthresh - Slow start threshold (bytes).
+   *   cc_acked - Bytes ACKed but not yet accounted in congestion
+   *              avoidance.
+   */
+
+  FAR const struct tcp_cc_ops_s *cc;
+  uint32_t   cwnd;        /* Congestion window */
+  uint32_t   ssthresh;    /* Slow start threshold */
+  uint32_t   cc_acked;    /* Congestion avoidance byte counter */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t   cubic_wmax;  /* CUBIC: Window before the last reduction */
+  uint32_t   cubic_west;  /* CUBIC: Reno-friendly window estimate */
+  uint32_t   cubic_k;     /* CUBIC: Time to reach cubic_wmax (msec) */
+  uint32_t   cubic_origin; /* CUBIC: Window at the cubic plateau */
+  systime_t  cubic_epoch; /* CUBIC: Start of the congestion avoidance epoch */
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_NAGLE
+  /* Small segment avoidance
+   *
+   *   nodelay - TCP_NODELAY:  Do not hold small segments (Nagle off).
+   *   cork    - TCP_CORK:  Hold all partial segments.
+   */
+
+  bool       nodelay;     /* True: TCP_NODELAY is set */
+  bool       cork;        /* True: TCP_CORK is set */
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Delayed ACK
+   *
+   *   dack_bytes - Bytes received in order but not yet ACKed.  Cleared by
+   *                every segment that we send with the ACK flag.
+   *   dack_time  - Time at which the oldest of those bytes arrived.
+   *   dack_segs  - Data segments ACKed, saturating at TCP_DACK_QUICKACKS.
+   */
+
+  uint32_t   dack_bytes;  /* Un-ACKed received bytes */
+  systime_t  dack_time;   /* Start of the ACK delay */
+  uint8_t    dack_segs;   /* Count of ACKed segments (quick-ACK) */
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+  /* Per-connection retransmission statistics */
+
+  net_stats_t rtx_timeout; /* Retransmissions due to retransmit time-out */
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+  net_stats_t rtx_fast;    /* Fast and partial-ACK retransmissions */
+#ifdef CONFIG_NET_TCP_SACK
+  net_stats_t rtx_sack;    /* Retransmissions of holes reported by SACK */
+#endif
+#endif
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -245,6 +377,29 @@ struct tcp_conn_s
   int (*accept)(FAR struct tcp_conn_s *listener, FAR struct tcp_conn_s *conn);
 };
 
+#ifdef CONFIG_NET_TCP_CC
+/* This structure describes one congestion control algorithm.  All methods
+ * are called with the network locked.
+ *
+ *   name - The name used with the TCP_CONGESTION socket option
+ *   init - Initialize the algorithm's state in the connection.  cwnd and
+ *          ssthresh have already been set up.
+ *   ack  - 'acked' bytes of new data were ACKed outside of fast recovery.
+ *          Open the congestion window.
+ *   loss - A loss was detected, either by duplicate ACKs or, if 'timeout'
+ *          is true, by the retransmission timer.  Reduce the congestion
+ *          window.  conn->unacked holds the amount of data in flight.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*ack)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE void (*loss)(FAR struct tcp_conn_s *conn, bool timeout);
+};
+#endif
+
 /* This structure supports TCP write buffering */
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -790,6 +945,22 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain);
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_flowlistener
+ *
+ * Description:
+ *   Return the listener that owns a new connection.  This is the listener
+ *   on the local port of the connection or, if several listeners share the
+ *   port with SO_REUSEPORT, the one selected by a hash of the remote
+ *   address and the port numbers of the connection.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_flowlistener(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -936,6 +1107,133 @@ void tcp_reset(FAR struct net_driver_s *dev);
 void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack);
 
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize congestion control for a connection that is about to send
+ *   its first data:  Select the default algorithm (unless one was already
+ *   selected), set the initial window (RFC 3390) and an unlimited slow
+ *   start threshold.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm with the given name for the
+ *   connection.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   Called with the network stack locked
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of the connection
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_reno_ack and tcp_cc_reno_loss
+ *
+ * Description:
+ *   The standard (RFC 5681) slow start, congestion avoidance and window
+ *   reduction.  These may be re-used by other algorithms.
+ *
+ ****************************************************************************/
+
+void tcp_cc_reno_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+void tcp_cc_reno_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+#define tcp_cc_ack(conn,acked)   ((conn)->cc->ack((conn), (acked)))
+#define tcp_cc_loss(conn,tmo)    ((conn)->cc->loss((conn), (tmo)))
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#endif /* CONFIG_NET_TCP_CC */
+
+/****************************************************************************
+ * Name: tcp_dack_defer
+ *
+ * Description:
+ *   Decide whether the ACK of 'len' bytes of new, in-order data may be
+ *   delayed.  It may not be if this is one of the first segments of the
+ *   connection or if at least two full sized segments are now un-ACKed.
+ *   Otherwise the data is accounted as un-ACKed and the ACK is sent when
+ *   the delay expires, unless data that we send carries it first.
+ *
+ * Returned Value:
+ *   True if the ACK should be delayed; false if it should be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+bool tcp_dack_defer(FAR struct tcp_conn_s *conn, uint16_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_setsockopt and tcp_getsockopt
+ *
+ * Description:
+ *   Set or get a socket option at the IPPROTO_TCP level.  See
+ *   psock_setsockopt() and psock_getsockopt().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_TCP_SOCKOPTS
+int tcp_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+int tcp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_get_recvwindow
+ *
+ * Description:
+ *   Calculate the (unscaled) receive window to advertise for the
+ *   connection.
+ *
+ * Parameters:
+ *   dev  - The device driver structure
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   The receive window size in bytes
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_appsend
  *
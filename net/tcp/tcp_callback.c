@@ -238,10 +238,11 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
 
   /* Try to allocate on I/O buffer to start the chain without waiting (and
    * throttling as necessary).  If we would have to wait, then drop the
-   * packet.
+   * packet.  The buffer is sized for the data if there are pools of small
+   * or of large I/O buffers.
    */
 
-  iob = iob_tryalloc(true);
+  iob = iob_tryalloc_size(buflen, true);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to create new I/O buffer chain\n");
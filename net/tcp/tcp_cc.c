@@ -0,0 +1,254 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC_DEFAULT_CUBIC
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_reno)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_cc_reno_init(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct tcp_cc_ops_s g_tcp_cc_reno =
+{
+  "reno",                 /* name */
+  tcp_cc_reno_init,       /* init */
+  tcp_cc_reno_ack,        /* ack */
+  tcp_cc_reno_loss        /* loss */
+};
+
+/* All available congestion control algorithms */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc[] =
+{
+  &g_tcp_cc_reno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+};
+
+#define TCP_CC_NALGORITHMS (sizeof(g_tcp_cc) / sizeof(g_tcp_cc[0]))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_reno_init
+ *
+ * Description:
+ *   Reno has no state beyond cwnd, ssthresh and cc_acked.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_reno_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cc_acked = 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_reno_ack
+ *
+ * Description:
+ *   Open the congestion window when 'acked' bytes of new data are ACKed:
+ *   By up to one MSS per ACK in slow start and by one MSS per window of
+ *   ACKed data in congestion avoidance (RFC 5681, appropriate byte
+ *   counting).
+ *
+ ****************************************************************************/
+
+void tcp_cc_reno_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* Slow start */
+
+      conn->cwnd += acked < conn->mss ? acked : conn->mss;
+    }
+  else
+    {
+      /* Congestion avoidance */
+
+      conn->cc_acked += acked;
+      if (conn->cc_acked >= conn->cwnd)
+        {
+          conn->cc_acked -= conn->cwnd;
+          conn->cwnd     += conn->mss;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_reno_loss
+ *
+ * Description:
+ *   Halve the amount of data in flight to get the new slow start
+ *   threshold.  After a timeout, restart from a window of one segment.
+ *   Otherwise, continue in congestion avoidance from the threshold.
+ *
+ ****************************************************************************/
+
+void tcp_cc_reno_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  uint32_t minwnd = 2 * (uint32_t)conn->mss;
+
+  conn->ssthresh = conn->unacked / 2;
+  if (conn->ssthresh < minwnd)
+    {
+      conn->ssthresh = minwnd;
+    }
+
+  conn->cwnd     = timeout ? conn->mss : conn->ssthresh;
+  conn->cc_acked = 0;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize congestion control for a connection that is about to send
+ *   its first data.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  uint32_t mss = conn->mss;
+
+  if (conn->cc == NULL)
+    {
+      conn->cc = TCP_CC_DEFAULT;
+    }
+
+  /* The initial window of RFC 3390:  min(4*MSS, max(2*MSS, 4380 bytes)) */
+
+  conn->cwnd = 4380;
+  if (conn->cwnd < 2 * mss)
+    {
+      conn->cwnd = 2 * mss;
+    }
+
+  if (conn->cwnd > 4 * mss)
+    {
+      conn->cwnd = 4 * mss;
+    }
+
+  conn->ssthresh = UINT32_MAX;
+  conn->cc->init(conn);
+
+  ninfo("%s: cwnd=%u\n", conn->cc->name, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of the connection
+ *   (or of the algorithm that it will use).
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn)
+{
+  return conn->cc != NULL ? conn->cc->name : TCP_CC_DEFAULT->name;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm with the given name for the
+ *   connection.  If the connection is already sending, the new algorithm
+ *   continues from the current congestion window.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < TCP_CC_NALGORITHMS; i++)
+    {
+      if (strcmp(g_tcp_cc[i]->name, name) == 0)
+        {
+          conn->cc = g_tcp_cc[i];
+          if (conn->cwnd != 0)
+            {
+              conn->cc->init(conn);
+            }
+
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -0,0 +1,289 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC_CUBIC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CUBIC (RFC 8312) constants:  C = 0.4 and beta = 0.7.  The window is
+ *
+ *   W(t) = C * (t - K)^3 + W_max   (segments, t and K in seconds)
+ *
+ * With t and K in milliseconds, C * (t - K)^3 = 4 * (t - K)^3 / 10^10.
+ */
+
+#define CUBIC_BETA_NUM   7       /* beta = 7 / 10 */
+#define CUBIC_BETA_DEN   10
+#define CUBIC_RC_MSEC    2500000000ull  /* (1 / C) * 1000^3 */
+#define CUBIC_MAX_DELTA  100000  /* Clamp |t - K| to 100 seconds */
+
+/* The Reno-friendly estimate grows by alpha = 3 * (1 - beta) / (1 + beta)
+ * segments per window, i.e. 0.529.
+ */
+
+#define CUBIC_ALPHA_NUM  529
+#define CUBIC_ALPHA_DEN  1000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_cc_cubic_init(FAR struct tcp_conn_s *conn);
+static void tcp_cc_cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void tcp_cc_cubic_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                /* name */
+  tcp_cc_cubic_init,      /* init */
+  tcp_cc_cubic_ack,       /* ack */
+  tcp_cc_cubic_loss       /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root (rounded down), computed bit-by-bit.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y += y;
+      b  = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_cubic_init
+ ****************************************************************************/
+
+static void tcp_cc_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cc_acked     = 0;
+  conn->cubic_wmax   = 0;
+  conn->cubic_west   = 0;
+  conn->cubic_k      = 0;
+  conn->cubic_origin = 0;
+  conn->cubic_epoch  = 0;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_cubic_ack
+ *
+ * Description:
+ *   Slow start as Reno.  In congestion avoidance, grow the window toward
+ *   the cubic function of the time since the last window reduction, but
+ *   never slower than the Reno-friendly estimate.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t mss = conn->mss;
+  uint32_t target;
+  systime_t now;
+  uint64_t need;
+  int64_t delta;
+  int64_t dwnd;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_reno_ack(conn, acked);
+      return;
+    }
+
+  now = clock_systimer();
+  if (conn->cubic_epoch == 0)
+    {
+      /* Start of a new congestion avoidance epoch */
+
+      conn->cubic_epoch = now != 0 ? now : 1;
+      conn->cubic_west  = conn->cwnd;
+
+      if (conn->cwnd < conn->cubic_wmax)
+        {
+          conn->cubic_k = cubic_root((uint64_t)(conn->cubic_wmax -
+                                                conn->cwnd) *
+                                     CUBIC_RC_MSEC / mss);
+          conn->cubic_origin = conn->cubic_wmax;
+        }
+      else
+        {
+          conn->cubic_k      = 0;
+          conn->cubic_origin = conn->cwnd;
+        }
+    }
+
+  /* W_cubic(t) in bytes */
+
+  delta = (int64_t)TICK2MSEC(now - conn->cubic_epoch) - conn->cubic_k;
+  if (delta > CUBIC_MAX_DELTA)
+    {
+      delta = CUBIC_MAX_DELTA;
+    }
+  else if (delta < -CUBIC_MAX_DELTA)
+    {
+      delta = -CUBIC_MAX_DELTA;
+    }
+
+  dwnd = (4 * delta * delta * delta / 10000000) * (int64_t)mss / 1000;
+  if (dwnd < -(int64_t)conn->cubic_origin)
+    {
+      target = 0;
+    }
+  else
+    {
+      target = conn->cubic_origin + dwnd;
+    }
+
+  /* The Reno-friendly estimate */
+
+  conn->cubic_west += (uint32_t)((uint64_t)acked * mss * CUBIC_ALPHA_NUM /
+                                 ((uint64_t)conn->cwnd * CUBIC_ALPHA_DEN));
+  if (target < conn->cubic_west)
+    {
+      target = conn->cubic_west;
+    }
+
+  /* Approach the target by (target - cwnd) / cwnd segments per ACKed
+   * segment:  That is one MSS each time cwnd * MSS / (target - cwnd) bytes
+   * have been ACKed, but not faster than one MSS per two segments ACKed
+   * (target <= 1.5 * cwnd).  Above the target, grow very slowly.
+   */
+
+  if (target > conn->cwnd)
+    {
+      need = (uint64_t)conn->cwnd * mss / (target - conn->cwnd);
+      if (need < 2 * mss)
+        {
+          need = 2 * mss;
+        }
+    }
+  else
+    {
+      need = (uint64_t)conn->cwnd * 100;
+    }
+
+  conn->cc_acked += acked;
+  if (conn->cc_acked >= need)
+    {
+      conn->cc_acked = 0;
+      conn->cwnd    += mss;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_cubic_loss
+ *
+ * Description:
+ *   Remember the window at the time of the loss (reduced further if the
+ *   window did not recover since the previous loss:  Fast convergence) and
+ *   multiply the window by beta.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_cubic_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  uint32_t minwnd = 2 * (uint32_t)conn->mss;
+  uint32_t cwnd   = conn->cwnd;
+
+  if (cwnd < conn->cubic_wmax)
+    {
+      conn->cubic_wmax = (uint32_t)((uint64_t)cwnd *
+                                    (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                                    (2 * CUBIC_BETA_DEN));
+    }
+  else
+    {
+      conn->cubic_wmax = cwnd;
+    }
+
+  conn->ssthresh = (uint32_t)((uint64_t)cwnd * CUBIC_BETA_NUM /
+                              CUBIC_BETA_DEN);
+  if (conn->ssthresh < minwnd)
+    {
+      conn->ssthresh = minwnd;
+    }
+
+  conn->cwnd        = timeout ? conn->mss : conn->ssthresh;
+  conn->cc_acked    = 0;
+  conn->cubic_epoch = 0;
+
+  ninfo("cwnd=%u ssthresh=%u wmax=%u\n",
+        conn->cwnd, conn->ssthresh, conn->cubic_wmax);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC_CUBIC */
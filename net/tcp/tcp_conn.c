@@ -44,6 +44,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -58,6 +59,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/mm/mempool.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
@@ -74,13 +76,15 @@
  * Private Data
  ****************************************************************************/
 
-/* The array containing all TCP connections. */
+/* The array containing all TCP connections.  Free connections are kept
+ * in g_tcp_connpool and are marked TCP_CLOSED.
+ */
 
 static struct tcp_conn_s g_tcp_connections[CONFIG_NET_TCP_CONNS];
 
-/* A list of all free TCP connections */
+/* The pool of all free TCP connections */
 
-static dq_queue_t g_free_tcp_connections;
+static struct mempool_s g_tcp_connpool;
 
 /* A list of all connected TCP connections */
 
@@ -90,10 +94,117 @@ static dq_queue_t g_active_tcp_connections;
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* Active connections hashed on the port numbers and the remote address.
+ * Each bucket is a singly linked list through the hnext field.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_hash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Return the hash bucket index for a connection given its remote address
+ *   (folded to 32-bits) and its local and remote port numbers.  The local
+ *   address is not included because it may be INADDR_ANY.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+static inline unsigned int tcp_hashkey(uint32_t raddr, uint16_t lport,
+                                       uint16_t rport)
+{
+  uint32_t key = raddr ^ ((uint32_t)lport << 16 | rport);
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key % CONFIG_NET_TCP_HASHSIZE;
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *ipaddr)
+{
+  return ((uint32_t)(ipaddr[0] ^ ipaddr[2] ^ ipaddr[4] ^ ipaddr[6]) << 16) |
+         (ipaddr[1] ^ ipaddr[3] ^ ipaddr[5] ^ ipaddr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hashbucket
+ *
+ * Description:
+ *   Return the hash bucket of an active connection.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s **tcp_hashbucket(FAR struct tcp_conn_s *conn)
+{
+  uint32_t raddr;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      raddr = conn->u.ipv4.raddr;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      raddr = tcp_ipv6_fold(conn->u.ipv6.raddr);
+    }
+#endif
+
+  return &g_tcp_hash[tcp_hashkey(raddr, conn->lport, conn->rport)];
+}
+
+/****************************************************************************
+ * Name: tcp_hashadd and tcp_hashrem
+ *
+ * Description:
+ *   Add or remove an active connection to or from the hash table.  The
+ *   addresses and port numbers of the connection must not change while it
+ *   is in the table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_hashadd(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **bucket = tcp_hashbucket(conn);
+
+  conn->hnext = *bucket;
+  *bucket     = conn;
+}
+
+static void tcp_hashrem(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link;
+
+  for (link = tcp_hashbucket(conn); *link != NULL; link = &(*link)->hnext)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->hnext;
+          conn->hnext = NULL;
+          break;
+        }
+    }
+}
+#endif /* CONFIG_NET_TCP_HASH */
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -104,11 +215,15 @@ static uint16_t g_last_tcp_port;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If 'reuseport' is true, the connections that do not prevent an
+ *   SO_REUSEPORT socket from binding the port are ignored.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
 static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
-                                                       uint16_t portno)
+                                                       uint16_t portno,
+                                                       bool reuseport)
 {
   FAR struct tcp_conn_s *conn;
   int i;
@@ -123,6 +238,21 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
        * matches the requested port number.
        */
 
+#ifdef CONFIG_NET_REUSEPORT
+      /* With SO_REUSEPORT, the port may be shared with other sockets that
+       * set it and with the connections accepted on the port.  Only a
+       * bound socket without SO_REUSEPORT is in the way.
+       */
+
+      if (reuseport &&
+          (conn->reuseport || conn->tcpstateflags != TCP_ALLOCATED))
+        {
+          continue;
+        }
+#else
+      UNUSED(reuseport);
+#endif
+
       if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno)
         {
           /* If there are multiple interface devices, then the local IP
@@ -155,11 +285,15 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If 'reuseport' is true, the connections that do not prevent an
+ *   SO_REUSEPORT socket from binding the port are ignored.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
 static inline FAR struct tcp_conn_s *
-tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
+tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno,
+                  bool reuseport)
 {
   FAR struct tcp_conn_s *conn;
   int i;
@@ -174,6 +308,21 @@ tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
        * matches the requested port number.
        */
 
+#ifdef CONFIG_NET_REUSEPORT
+      /* With SO_REUSEPORT, the port may be shared with other sockets that
+       * set it and with the connections accepted on the port.  Only a
+       * bound socket without SO_REUSEPORT is in the way.
+       */
+
+      if (reuseport &&
+          (conn->reuseport || conn->tcpstateflags != TCP_ALLOCATED))
+        {
+          continue;
+        }
+#else
+      UNUSED(reuseport);
+#endif
+
       if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno)
         {
           /* If there are multiple interface devices, then the local IP
@@ -206,18 +355,21 @@ tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If 'reuseport' is true, the connections that do not prevent an
+ *   SO_REUSEPORT socket from binding the port are ignored.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, bool reuseport)
 {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (domain == PF_INET)
 #endif
     {
-      return tcp_ipv4_listener(ipaddr->ipv4, portno);
+      return tcp_ipv4_listener(ipaddr->ipv4, portno, reuseport);
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -226,7 +378,7 @@ static FAR struct tcp_conn_s *
   else
 #endif
     {
-      return tcp_ipv6_listener(ipaddr->ipv6, portno);
+      return tcp_ipv6_listener(ipaddr->ipv6, portno, reuseport);
     }
 #endif /* CONFIG_NET_IPv6 */
 }
@@ -242,6 +394,7 @@ static FAR struct tcp_conn_s *
  * Input Parameters:
  *   portno -- the selected port number in host order. Zero means no port
  *     selected.
+ *   reuseport -- True if the connection set SO_REUSEPORT.
  *
  * Returned Value:
  *   Selected or verified port number in host order on success, a negated
@@ -258,7 +411,7 @@ static FAR struct tcp_conn_s *
  ****************************************************************************/
 
 static int tcp_selectport(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-                          uint16_t portno)
+                          uint16_t portno, bool reuseport)
 {
   if (portno == 0)
     {
@@ -283,7 +436,7 @@ static int tcp_selectport(uint8_t domain, FAR const union ip_addr_u *ipaddr,
               g_last_tcp_port = 4096;
             }
         }
-      while (tcp_listener(domain, ipaddr, htons(g_last_tcp_port)));
+      while (tcp_listener(domain, ipaddr, htons(g_last_tcp_port), false));
     }
   else
     {
@@ -291,7 +444,7 @@ static int tcp_selectport(uint8_t domain, FAR const union ip_addr_u *ipaddr,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno))
+      if (tcp_listener(domain, ipaddr, portno, reuseport))
         {
           /* It is in use... return EADDRINUSE */
 
@@ -325,10 +478,17 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Only the connections in the matching hash bucket need be examined */
+
+  conn = g_tcp_hash[tcp_hashkey(srcipaddr, tcp->destport, tcp->srcport)];
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -364,7 +524,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -392,10 +556,18 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Only the connections in the matching hash bucket need be examined */
+
+  conn = g_tcp_hash[tcp_hashkey(tcp_ipv6_fold(ip->srcipaddr),
+                                tcp->destport, tcp->srcport)];
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -431,7 +603,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -468,7 +644,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                        ntohs(addr->sin_port));
+                        ntohs(addr->sin_port), tcp_reuseport(conn));
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -535,7 +711,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET6,
                         (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                        ntohs(addr->sin6_port));
+                        ntohs(addr->sin6_port), tcp_reuseport(conn));
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -570,6 +746,19 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: tcp_connctor
+ *
+ * Description:
+ *   Mark a connection in the pool as closed.
+ *
+ ****************************************************************************/
+
+static void tcp_connctor(FAR void *obj, FAR void *arg)
+{
+  ((FAR struct tcp_conn_s *)obj)->tcpstateflags = TCP_CLOSED;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -585,22 +774,26 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
 void tcp_initialize(void)
 {
+#ifdef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Initialize the queues */
 
-  dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
-  /* Now initialize each connection structure */
-
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#ifdef CONFIG_NET_TCP_HASH
+  for (i = 0; i < CONFIG_NET_TCP_HASHSIZE; i++)
     {
-      /* Mark the connection closed and move it to the free list */
-
-      g_tcp_connections[i].tcpstateflags = TCP_CLOSED;
-      dq_addlast(&g_tcp_connections[i].node, &g_free_tcp_connections);
+      g_tcp_hash[i] = NULL;
     }
+#endif
+
+  /* Now mark each connection structure closed and put it into the pool */
+
+  (void)mempool_initialize(&g_tcp_connpool, "tcpconn", g_tcp_connections,
+                           sizeof(struct tcp_conn_s), CONFIG_NET_TCP_CONNS,
+                           0, tcp_connctor, NULL);
 
   g_last_tcp_port = 1024;
 }
@@ -622,17 +815,17 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
   /* Because this routine is called from both event processing (with the
    * network locked) and and from user level.  Make sure that the network
-   * locked in any cased while accessing g_free_tcp_connections[];
+   * locked in any cased while accessing the connection lists.
    */
 
   net_lock();
 
-  /* Return the entry from the head of the free list */
+  /* Take a free connection from the pool */
 
-  conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+  conn = (FAR struct tcp_conn_s *)mempool_alloc(&g_tcp_connpool);
 
 #ifndef CONFIG_NET_SOLINGER
-  /* Is the free list empty? */
+  /* Is the pool empty? */
 
   if (!conn)
     {
@@ -699,7 +892,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
           /* Now there is guaranteed to be one free connection.  Get it! */
 
-          conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+          conn = (FAR struct tcp_conn_s *)mempool_alloc(&g_tcp_connpool);
         }
     }
 #endif
@@ -737,7 +930,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   FAR struct tcp_wrbuffer_s *wrbuffer;
 #endif
 
-  /* Because g_free_tcp_connections is accessed from user level and event
+  /* Because the connection lists are accessed from user level and event
    * processing logic, it is necessary to keep the newtork locked during this
    * operation.
    */
@@ -764,6 +957,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+      tcp_hashrem(conn);
+#endif
     }
 
 #ifdef CONFIG_NET_TCP_READAHEAD
@@ -804,10 +1000,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     }
 #endif
 
-  /* Mark the connection available and put it into the free list */
+  /* Mark the connection available and put it back into the pool */
 
   conn->tcpstateflags = TCP_CLOSED;
-  dq_addlast(&conn->node, &g_free_tcp_connections);
+  mempool_free(&g_tcp_connpool, conn);
   net_unlock();
 }
 
@@ -1027,6 +1223,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+      tcp_hashadd(conn);
+#endif
     }
 
   return conn;
@@ -1127,7 +1326,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
       port = tcp_selectport(PF_INET,
                             (FAR const union ip_addr_u *)&conn->u.ipv4.laddr,
-                            ntohs(conn->lport));
+                            ntohs(conn->lport), tcp_reuseport(conn));
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1142,7 +1341,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
       port = tcp_selectport(PF_INET6,
                             (FAR const union ip_addr_u *)conn->u.ipv6.laddr,
-                            ntohs(conn->lport));
+                            ntohs(conn->lport), tcp_reuseport(conn));
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1262,6 +1461,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+  tcp_hashadd(conn);
+#endif
   ret = OK;
 
 errout_with_lock:
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * net/tcp/tcp_dack.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_DELAYED_ACK)
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define TCP_DACK_WORK LPWORK
+#else
+#  define TCP_DACK_WORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* One work item serves the delayed ACKs of all connections */
+
+static struct work_s g_tcp_dack_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_dack_worker
+ *
+ * Description:
+ *   Ask the driver of each connection whose ACK delay has expired to poll,
+ *   so that tcp_poll() sends the ACK.  Re-schedule for the connection
+ *   whose delay expires next.
+ *
+ ****************************************************************************/
+
+static void tcp_dack_worker(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+  systime_t now = clock_systimer();
+  systime_t next = TCP_DACK_TICKS;
+  bool pending = false;
+
+  net_lock();
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      systime_t elapsed;
+
+      if (conn->dack_bytes == 0 || conn->dev == NULL)
+        {
+          continue;
+        }
+
+      elapsed = now - conn->dack_time;
+      if (elapsed >= TCP_DACK_TICKS)
+        {
+          netdev_txnotify_dev(conn->dev);
+        }
+      else
+        {
+          if (TCP_DACK_TICKS - elapsed < next)
+            {
+              next = TCP_DACK_TICKS - elapsed;
+            }
+
+          pending = true;
+        }
+    }
+
+  if (pending)
+    {
+      (void)work_queue(TCP_DACK_WORK, &g_tcp_dack_work, tcp_dack_worker,
+                       NULL, next);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_dack_defer
+ *
+ * Description:
+ *   Decide whether the ACK of 'len' bytes of new, in-order data may be
+ *   delayed.
+ *
+ * Returned Value:
+ *   True if the ACK should be delayed; false if it should be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_dack_defer(FAR struct tcp_conn_s *conn, uint16_t len)
+{
+  bool first = (conn->dack_bytes == 0);
+
+  conn->dack_bytes += len;
+
+  /* Quick-ACK the first segments of the connection */
+
+  if (conn->dack_segs < TCP_DACK_QUICKACKS)
+    {
+      conn->dack_segs++;
+      return false;
+    }
+
+  /* ACK at least every second full sized segment (RFC 1122 4.2.3.2).
+   * The MSS negotiated for sending is used as the segment size.
+   */
+
+  if (conn->dack_bytes >= 2 * (uint32_t)conn->mss)
+    {
+      return false;
+    }
+
+  if (first)
+    {
+      conn->dack_time = clock_systimer();
+      if (work_available(&g_tcp_dack_work))
+        {
+          (void)work_queue(TCP_DACK_WORK, &g_tcp_dack_work, tcp_dack_worker,
+                           NULL, TCP_DACK_TICKS);
+        }
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_DELAYED_ACK */
@@ -93,11 +93,14 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
     {
       /* The TCP connection is established and, hence, should be bound
        * to a device. Make sure that the polling device is the one that
-       * we are bound to.
+       * we are bound to.  There is also nothing to do unless someone
+       * is actually waiting for the poll event or a delayed ACK is due.
        */
 
       DEBUGASSERT(conn->dev != NULL);
-      if (dev == conn->dev)
+      if (dev == conn->dev &&
+          (devif_conn_subscribed(conn->list, TCP_POLL) ||
+           tcp_dack_expired(conn)))
         {
           /* Set up for the callback.  We can't know in advance if the
            * application is going to send a IPv4 or an IPv6 packet, so this
@@ -124,6 +127,15 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
           result = tcp_callback(dev, conn, TCP_POLL);
 
+          /* Send a delayed ACK that is due, alone if the application has
+           * nothing to send.
+           */
+
+          if (tcp_dack_expired(conn))
+            {
+              result |= TCP_SNDACK;
+            }
+
           /* Handle the callback response */
 
           tcp_appsend(dev, conn, result);
@@ -59,12 +59,117 @@
 
 #include "devif/devif.h"
 #include "utils/utils.h"
+#include "neighbor/neighbor.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_option
+ *
+ * Description:
+ *   Parse the options of an incoming SYN or SYNACK segment:  Set the MSS
+ *   of the connection and record whether the peer permits SACK and window
+ *   scaling.
+ *
+ * Parameters:
+ *   dev    - The device driver structure containing the received packet.
+ *   conn   - The TCP connection that the segment belongs to.
+ *   iplen  - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_option(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *optdata;
+  unsigned int optlen;
+  unsigned int i;
+  uint16_t tmp16;
+  uint8_t opt;
+
+  tcp = (FAR struct tcp_hdr_s *)&dev->d_buf[iplen + NET_LL_HDRLEN(dev)];
+  optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+
+  for (i = 0; i < optlen; )
+    {
+      opt = optdata[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+          continue;
+        }
+
+      /* All other options have a length field */
+
+      if (i + 1 >= optlen || optdata[i + 1] == 0)
+        {
+          /* If the length field is missing or zero, the options are
+           * malformed and we don't process them further.
+           */
+
+          break;
+        }
+
+      if (opt == TCP_OPT_MSS && optdata[i + 1] == TCP_OPT_MSS_LEN)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)optdata[i + 2] << 8) | (uint16_t)optdata[i + 3];
+          conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+        }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (opt == TCP_OPT_WS && optdata[i + 1] == TCP_OPT_WS_LEN &&
+               i + TCP_OPT_WS_LEN <= optlen)
+        {
+          /* Window scaling is in effect in both directions once both
+           * sides have sent the option.  Our SYN always includes it and
+           * our SYNACK includes it only if the peer's SYN did.
+           */
+
+          conn->wsok      = true;
+          conn->snd_scale = optdata[i + 2] > TCP_WS_MAXSHIFT ?
+                            TCP_WS_MAXSHIFT : optdata[i + 2];
+          conn->rcv_scale = CONFIG_NET_TCP_WINDOW_SCALE_FACTOR;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+      else if (opt == TCP_OPT_SACK_PERM &&
+               optdata[i + 1] == TCP_OPT_SACK_PERM_LEN)
+        {
+          /* The peer will accept (and 'may' send) SACK options */
+
+          conn->sackok = true;
+        }
+#endif
+
+      /* Skip past the option using its length field */
+
+      i += optdata[i + 1];
+    }
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -90,13 +195,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_hdr_s *tcp;
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
-  unsigned int hdrlen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -114,13 +216,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcpiplen = iplen + TCP_HDRLEN;
 
-  /* Get the size of the link layer header, the IP header, and the TCP header */
-
-  hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
-
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCSUMOK(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -226,57 +324,11 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP MSS and SACK-permitted options, if present. */
 
           if ((tcp->tcpoffset & 0xf0) > 0x50)
             {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
+              tcp_parse_option(dev, conn, iplen);
             }
 
           /* Our response will be a SYNACK. */
@@ -313,6 +365,15 @@ found:
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window in SYN segments is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_scale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -336,11 +397,7 @@ found:
 
           /* Notify the listener for the connection of the reset event */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-          listener = tcp_findlistener(conn->lport, domain);
-#else
-          listener = tcp_findlistener(conn->lport);
-#endif
+          listener = tcp_flowlistener(conn);
 
           /* We must free this TCP connection structure; this connection
            * will never be established.  There should only be one reference
@@ -500,6 +557,19 @@ found:
        /* Reset the retransmission timer. */
 
        conn->timer = conn->rto;
+
+#ifdef CONFIG_NET_IPv6
+       /* Forward progress confirms that the neighbor is reachable (RFC
+        * 4861, section 7.3.1).  This avoids probing active neighbors.
+        */
+
+#ifdef CONFIG_NET_IPv4
+       if (domain == PF_INET6)
+#endif
+         {
+           neighbor_update(conn->u.ipv6.raddr);
+         }
+#endif
     }
 
   /* Do different things depending on in what state the connection is. */
@@ -591,58 +661,11 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP MSS and SACK-permitted options, if present. */
 
             if ((tcp->tcpoffset & 0xf0) > 0x50)
               {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
+                tcp_parse_option(dev, conn, iplen);
               }
 
             conn->tcpstateflags = TCP_ESTABLISHED;
@@ -817,6 +840,19 @@ found:
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+                /* If the application is not sending anything that would
+                 * carry the ACK, it may be delayed.
+                 */
+
+                if (len > 0 && dev->d_sndlen == 0 &&
+                    (result & (TCP_CLOSE | TCP_ABORT)) == 0 &&
+                    tcp_dack_defer(conn, len))
+                  {
+                    result &= ~TCP_SNDACK;
+                  }
+#endif
               }
 
             /* Send the response, ACKing the data or not, as appropriate */
@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -53,6 +54,7 @@
 
 #include "devif/devif.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
@@ -62,6 +64,16 @@
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
+#ifdef CONFIG_NET_TCP_HASH
+/* The same listeners hashed on the local port number.  Each bucket is a
+ * singly linked list through the lnext field.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_listenhash[CONFIG_NET_TCP_HASHSIZE];
+
+#define TCP_LISTENHASH(p) (&g_tcp_listenhash[(p) % CONFIG_NET_TCP_HASHSIZE])
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -83,6 +95,25 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno, uint8_t domain)
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *conn;
+
+  /* Examine only the listeners in the hash bucket of this port */
+
+  for (conn = *TCP_LISTENHASH(portno); conn != NULL; conn = conn->lnext)
+    {
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (conn->lport == portno && conn->domain == domain)
+#else
+      if (conn->lport == portno)
+#endif
+        {
+          /* Yes.. we found a listener on this port */
+
+          return conn;
+        }
+    }
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -105,6 +136,7 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
           return conn;
         }
     }
+#endif
 
   /* No listener for this port */
 
@@ -134,6 +166,13 @@ void tcp_listen_initialize(void)
     {
       tcp_listenports[ndx] = NULL;
     }
+
+#ifdef CONFIG_NET_TCP_HASH
+  for (ndx = 0; ndx < CONFIG_NET_TCP_HASHSIZE; ndx++)
+    {
+      g_tcp_listenhash[ndx] = NULL;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -149,6 +188,9 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s **link;
+#endif
   int ndx;
   int ret = -EINVAL;
 
@@ -163,6 +205,21 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
         }
     }
 
+#ifdef CONFIG_NET_TCP_HASH
+  /* Remove the listener from its hash bucket too */
+
+  for (link = TCP_LISTENHASH(conn->lport); *link != NULL;
+       link = &(*link)->lnext)
+    {
+      if (*link == conn)
+        {
+          *link       = conn->lnext;
+          conn->lnext = NULL;
+          break;
+        }
+    }
+#endif
+
   net_unlock();
   return ret;
 }
@@ -180,6 +237,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s *listener;
   int ndx;
   int ret;
 
@@ -192,10 +250,15 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
   /* First, check if there is already a socket listening on this port */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(conn->lport, conn->domain))
+  listener = tcp_findlistener(conn->lport, conn->domain);
 #else
-  if (tcp_islistener(conn->lport))
+  listener = tcp_findlistener(conn->lport);
 #endif
+
+  /* Listeners that all set SO_REUSEPORT may share the port */
+
+  if (listener != NULL &&
+      !(tcp_reuseport(conn) && tcp_reuseport(listener)))
     {
       /* Yes, then we must refuse this request */
 
@@ -220,6 +283,10 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               /* Yes.. we found it */
 
               tcp_listenports[ndx] = conn;
+#ifdef CONFIG_NET_TCP_HASH
+              conn->lnext = *TCP_LISTENHASH(conn->lport);
+              *TCP_LISTENHASH(conn->lport) = conn;
+#endif
               ret = OK;
               break;
             }
@@ -253,6 +320,106 @@ bool tcp_islistener(uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_flowlistener
+ *
+ * Description:
+ *   Return the listener that owns a new connection.  This is the listener
+ *   on the local port of the connection or, if several listeners share the
+ *   port with SO_REUSEPORT, the one selected by a hash of the remote
+ *   address and the port numbers of the connection.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the nework locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_flowlistener(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_REUSEPORT
+  FAR struct tcp_conn_s *listener;
+  FAR struct tcp_conn_s *best;
+  uint32_t bestscore;
+  uint32_t score;
+  uint32_t flow;
+#ifndef CONFIG_NET_TCP_HASH
+  int ndx;
+#endif
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  best = tcp_findlistener(conn->lport, conn->domain);
+#else
+  best = tcp_findlistener(conn->lport);
+#endif
+
+  if (best == NULL || !tcp_reuseport(best))
+    {
+      return best;
+    }
+
+  /* The port is shared with SO_REUSEPORT.  Hash the flow and give the
+   * connection to the listener with the best score.
+   */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      flow = net_reuseport_flow((FAR const uint16_t *)&conn->u.ipv4.raddr,
+                                2, conn->rport, conn->lport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      flow = net_reuseport_flow(conn->u.ipv6.raddr, 8, conn->rport,
+                                conn->lport);
+    }
+#endif
+
+  bestscore = net_reuseport_score(flow, best, best->cpu);
+
+#ifdef CONFIG_NET_TCP_HASH
+  for (listener = best->lnext; listener != NULL; listener = listener->lnext)
+    {
+#else
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      listener = tcp_listenports[ndx];
+      if (listener == NULL || listener == best)
+        {
+          continue;
+        }
+#endif
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (listener->lport == conn->lport &&
+          listener->domain == conn->domain && tcp_reuseport(listener))
+#else
+      if (listener->lport == conn->lport && tcp_reuseport(listener))
+#endif
+        {
+          score = net_reuseport_score(flow, listener, listener->cpu);
+          if (score > bestscore)
+            {
+              bestscore = score;
+              best      = listener;
+            }
+        }
+    }
+
+  return best;
+#elif defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  return tcp_findlistener(conn->lport, conn->domain);
+#else
+  return tcp_findlistener(conn->lport);
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -275,11 +442,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
    * the connection.
    */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  listener = tcp_findlistener(portno, conn->domain);
-#else
-  listener = tcp_findlistener(portno);
-#endif
+  DEBUGASSERT(conn->lport == portno);
+
+  listener = tcp_flowlistener(conn);
   if (listener != NULL)
     {
       /* Yes, there is a listener.  Is it accepting connections now? */
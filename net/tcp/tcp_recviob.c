@@ -0,0 +1,247 @@
+/****************************************************************************
+ * net/tcp/tcp_recviob.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_READAHEAD)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of the receive operation while it waits
+ * for new data to arrive.
+ */
+
+struct tcp_recviob_s
+{
+  FAR struct devif_callback_s *ri_cb;  /* Reference to callback instance */
+  sem_t ri_sem;                        /* Semaphore signals recv completion */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_recviob_eventhandler
+ *
+ * Description:
+ *   Wake up the waiting receiver when new data arrives or the connection
+ *   is lost.  The new data is not consumed here:  The flags are returned
+ *   unchanged so that tcp_data_event() will add the incoming packet to the
+ *   read-ahead queue where it will be removed, in place, by the receiver.
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   conn     The connection structure associated with the socket
+ *   pvpriv   An instance of struct tcp_recviob_s
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   The unmodified event flags
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_recviob_eventhandler(FAR struct net_driver_s *dev,
+                                         FAR void *pvconn, FAR void *pvpriv,
+                                         uint16_t flags)
+{
+  FAR struct tcp_recviob_s *pstate = (FAR struct tcp_recviob_s *)pvpriv;
+
+  if (pstate != NULL && (flags & (TCP_NEWDATA | TCP_DISCONN_EVENTS)) != 0)
+    {
+      /* Disable further callbacks and wake up the receiver */
+
+      pstate->ri_cb->flags = 0;
+      pstate->ri_cb->priv  = NULL;
+      pstate->ri_cb->event = NULL;
+
+      nxsem_post(&pstate->ri_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_tcp_recviob
+ *
+ * Description:
+ *   Receive the next packet of TCP data as an I/O buffer chain.  This is
+ *   an internal OS interface intended for in-kernel consumers of TCP
+ *   streams.  Unlike psock_recvfrom(), no data is copied:  The I/O buffer
+ *   chain that holds the packet in the read-ahead queue is removed from the
+ *   queue and returned to the caller.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a connected, SOCK_STREAM socket structure
+ *   iob     - The location to return the I/O buffer chain.  On success,
+ *             the caller owns the chain and must release it with
+ *             iob_free_chain().
+ *   flags   - Receive flags.  Only MSG_DONTWAIT is supported.
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned I/O buffer
+ *   chain.  Zero is returned (and *iob is set to NULL) if the peer has
+ *   performed an orderly shutdown.  Otherwise a negated errno value is
+ *   returned:
+ *
+ *   EBADF      - The socket is not valid.
+ *   EOPNOTSUPP - The socket is not a TCP stream socket.
+ *   ENOTCONN   - The socket is not connected.
+ *   EAGAIN     - No data is available and the socket is non-blocking or
+ *                MSG_DONTWAIT was specified.
+ *   ENOMEM     - Failed to allocate a callback.
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                          int flags)
+{
+  FAR struct tcp_conn_s *conn;
+  struct tcp_recviob_s state;
+  FAR struct iob_s *head;
+  ssize_t ret;
+
+  DEBUGASSERT(iob != NULL);
+  *iob = NULL;
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (psock->s_type != SOCK_STREAM ||
+      (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+    {
+      return -EOPNOTSUPP;
+    }
+
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn != NULL);
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&state.ri_sem, 0, 0);
+  (void)nxsem_setprotocol(&state.ri_sem, SEM_PRIO_NONE);
+
+  net_lock();
+  for (; ; )
+    {
+      /* Hand off the oldest packet in the read-ahead queue, if any */
+
+      head = iob_remove_queue(&conn->readahead);
+      if (head != NULL)
+        {
+          *iob = head;
+          ret  = head->io_pktlen;
+          break;
+        }
+
+      /* Nothing buffered.  Verify that the stream is still connected. */
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          ret = _SS_ISCLOSED(psock->s_flags) ? 0 : -ENOTCONN;
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      /* Wait for new data or for the connection to be lost */
+
+      state.ri_cb = tcp_callback_alloc(conn);
+      if (state.ri_cb == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      state.ri_cb->flags = (TCP_NEWDATA | TCP_DISCONN_EVENTS);
+      state.ri_cb->priv  = (FAR void *)&state;
+      state.ri_cb->event = tcp_recviob_eventhandler;
+
+      ret = net_lockedwait(&state.ri_sem);
+      tcp_callback_free(conn, state.ri_cb);
+
+      if (ret < 0)
+        {
+          /* Interrupted by a signal */
+
+          break;
+        }
+    }
+
+  net_unlock();
+  nxsem_destroy(&state.ri_sem);
+  return ret;
+}
+
+#endif /* CONFIG_NET_TCP && CONFIG_NET_TCP_READAHEAD */
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * net/tcp/tcp_recvwindow.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
+
+#include <stdint.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_get_recvwindow
+ *
+ * Description:
+ *   Calculate the receive window to advertise for the connection.
+ *
+ *   If window scaling was negotiated for the connection, the window is the
+ *   read-ahead space that is currently available:  Incoming segments are
+ *   held in I/O buffers allocated with throttling by iob_tryalloc_size(),
+ *   so that is the free space of the IOB pool that is the best fit for a
+ *   full segment plus the IOBs available above the CONFIG_IOB_THROTTLE
+ *   reserve.  The window therefore grows and shrinks with the IOB pools
+ *   instead of being fixed.
+ *
+ *   Otherwise, this is the receive window of the device (as adjusted by
+ *   CONFIG_NET_TCP_RWND_CONTROL).
+ *
+ * Parameters:
+ *   dev  - The device driver structure
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   The receive window size in bytes (not scaled)
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_RWND_CONTROL
+  extern sem_t g_qentry_sem;
+  int qentry_sem_count;
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (conn->wsok)
+    {
+      uint32_t recvwndo;
+      uint32_t maxwndo;
+
+      recvwndo = iob_navail_size(conn->mss, true);
+      maxwndo  = (uint32_t)UINT16_MAX << conn->rcv_scale;
+
+      return recvwndo > maxwndo ? maxwndo : recvwndo;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_RWND_CONTROL
+  /* Update the TCP received window based on I/O buffer */
+  /* NOTE: This algorithm is still experimental */
+
+  if (OK == nxsem_getvalue(&g_qentry_sem, &qentry_sem_count))
+    {
+      NET_DEV_RCVWNDO(dev) =
+        (uint16_t)((qentry_sem_count * CONFIG_NET_ETH_TCP_RECVWNDO) /
+                   CONFIG_IOB_NCHAINS);
+    }
+#endif
+
+  return NET_DEV_RCVWNDO(dev);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP */
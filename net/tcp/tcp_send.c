@@ -54,10 +54,6 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/tcp.h>
 
-#ifdef CONFIG_NET_TCP_RWND_CONTROL
-#  include <nuttx/semaphore.h>
-#endif
-
 #include "devif/devif.h"
 #include "inet/inet.h"
 #include "tcp/tcp.h"
@@ -155,7 +151,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+  if (!NETDEV_TXCSUM(dev, NETDEV_TXCSUM_TCP))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -170,7 +169,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!NETDEV_TXCSUM(dev, NETDEV_TXCSUM_IPv4))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -227,7 +229,10 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+  if (!NETDEV_TXCSUM(dev, NETDEV_TXCSUM_TCP))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -313,11 +318,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                            FAR struct tcp_conn_s *conn,
                            FAR struct tcp_hdr_s *tcp)
 {
-#ifdef CONFIG_NET_TCP_RWND_CONTROL
-  extern sem_t g_qentry_sem;
-  int  qentry_sem_count;
-  uint32_t rwnd;
-#endif
+  uint32_t recvwndo;
 
   /* Copy the IP address into the IPv6 header */
 
@@ -348,22 +349,18 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   memcpy(tcp->ackno, conn->rcvseq, 4);
   memcpy(tcp->seqno, conn->sndseq, 4);
 
-  tcp->srcport  = conn->lport;
-  tcp->destport = conn->rport;
-
-#ifdef CONFIG_NET_TCP_RWND_CONTROL
-  /* Update the TCP received window based on I/O buffer */
-  /* NOTE: This algorithm is still experimental */
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* This segment ACKs everything received so far */
 
-  if (OK == nxsem_getvalue(&g_qentry_sem, &qentry_sem_count))
+  if ((tcp->flags & TCP_ACK) != 0)
     {
-      rwnd = (qentry_sem_count * CONFIG_NET_ETH_TCP_RECVWNDO)
-             / CONFIG_IOB_NCHAINS;
-
-      NET_DEV_RCVWNDO(dev) = (uint16_t)rwnd;
+      conn->dack_bytes = 0;
     }
 #endif
 
+  tcp->srcport  = conn->lport;
+  tcp->destport = conn->rport;
+
   /* Set the TCP window */
 
   if (conn->tcpstateflags & TCP_STOPPED)
@@ -377,8 +374,24 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      tcp->wnd[0] = ((NET_DEV_RCVWNDO(dev)) >> 8);
-      tcp->wnd[1] = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+      recvwndo = tcp_get_recvwindow(dev, conn);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window field of SYN and SYNACK segments is never scaled */
+
+      if ((tcp->flags & TCP_SYN) == 0)
+        {
+          recvwndo >>= conn->rcv_scale;
+        }
+#endif
+
+      if (recvwndo > UINT16_MAX)
+        {
+          recvwndo = UINT16_MAX;
+        }
+
+      tcp->wnd[0] = recvwndo >> 8;
+      tcp->wnd[1] = recvwndo & 0xff;
     }
 
   /* Finish the IP portion of the message and calculate checksums */
@@ -561,6 +574,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 {
   struct tcp_hdr_s *tcp;
   uint16_t tcp_mss;
+  uint16_t optlen;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -576,7 +590,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       /* Set the packet length for the TCP Maximum Segment Size */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -592,7 +606,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       /* Set the packet length for the TCP Maximum Segment Size */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -606,7 +620,41 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[1] = TCP_OPT_MSS_LEN;
   tcp->optdata[2] = tcp_mss >> 8;
   tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optlen          = TCP_OPT_MSS_LEN;
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Tell the peer that we can process SACK options.  In a SYNACK, only if
+   * the peer offered SACK in its SYN.  The option is padded with two NOPs
+   * to keep the header aligned.
+   */
+
+  if ((ack & TCP_ACK) == 0 || conn->sackok)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+
+      optdata[optlen++] = TCP_OPT_NOOP;
+      optdata[optlen++] = TCP_OPT_NOOP;
+      optdata[optlen++] = TCP_OPT_SACK_PERM;
+      optdata[optlen++] = TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer window scaling.  In a SYNACK, only if the peer offered it. */
+
+  if ((ack & TCP_ACK) == 0 || conn->wsok)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+
+      optdata[optlen++] = TCP_OPT_NOOP;
+      optdata[optlen++] = TCP_OPT_WS;
+      optdata[optlen++] = TCP_OPT_WS_LEN;
+      optdata[optlen++] = CONFIG_NET_TCP_WINDOW_SCALE_FACTOR;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
+  dev->d_len     += optlen;
 
   /* Complete the common portions of the TCP message */
 
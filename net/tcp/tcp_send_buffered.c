@@ -68,6 +68,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -93,6 +94,20 @@
 #define TCPIPv4BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define TCPIPv6BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
+/* With congestion control, new data is also sent when an ACK (without new
+ * incoming data) opens the congestion window, not only when polled.
+ */
+
+#ifdef CONFIG_NET_TCP_CC
+#  define SEND_ACKCLOCKED(f) (((f) & (TCP_ACKDATA | TCP_NEWDATA)) == TCP_ACKDATA)
+#else
+#  define SEND_ACKCLOCKED(f) (false)
+#endif
+
+/* The 40 bytes of TCP options can hold at most 4 SACK blocks */
+
+#define TCP_SACK_NBLOCKS 4
+
 /* Debug */
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
@@ -103,6 +118,20 @@
 #  define TCP_WBDUMP(msg,wrb,len,offset)
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+/* One block of data that the peer has reported as received (SACK) */
+
+struct tcp_sackblock_s
+{
+  uint32_t left;           /* First sequence number of the block */
+  uint32_t right;          /* Sequence number following the block */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -207,6 +236,10 @@ static inline void psock_lost_connection(FAR struct socket *psock,
       sq_init(&conn->write_q);
       conn->sent       = 0;
       conn->sndseq_max = 0;
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      conn->dupacks    = 0;
+      conn->recovery   = false;
+#endif
     }
 }
 
@@ -385,6 +418,254 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
 #  define psock_send_addrchck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Name: psock_oldest_seqno
+ *
+ * Description:
+ *   Get the sequence number of the oldest sent but un-ACKed data.  That is
+ *   the head of the unacked_q or, if that is empty, the partially sent
+ *   head of the write_q.
+ *
+ * Parameters:
+ *   conn     The TCP connection of interest
+ *   seqno    The location to return the sequence number
+ *
+ * Returned Value:
+ *   True if there is any un-ACKed data
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+static bool psock_oldest_seqno(FAR struct tcp_conn_s *conn,
+                               FAR uint32_t *seqno)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+  if (wrb == NULL)
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || TCP_WBSENT(wrb) == 0)
+        {
+          return false;
+        }
+    }
+
+  *seqno = TCP_WBSEQNO(wrb);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_sack_parse
+ *
+ * Description:
+ *   Extract the SACK blocks from the options of an incoming ACK.
+ *
+ * Parameters:
+ *   tcp      The TCP header of the incoming segment
+ *   sack     The location to return up to TCP_SACK_NBLOCKS blocks
+ *
+ * Returned Value:
+ *   The number of SACK blocks returned
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+static int psock_sack_parse(FAR struct tcp_hdr_s *tcp,
+                            FAR struct tcp_sackblock_s *sack)
+{
+  FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  unsigned int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  unsigned int i = 0;
+  int nsack = 0;
+  int j;
+
+  while (i < optlen && optdata[i] != TCP_OPT_END)
+    {
+      if (optdata[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      if (i + 1 >= optlen || optdata[i + 1] < 2 ||
+          i + optdata[i + 1] > optlen)
+        {
+          /* Malformed options */
+
+          break;
+        }
+
+      if (optdata[i] == TCP_OPT_SACK)
+        {
+          FAR uint8_t *blk = &optdata[i + 2];
+
+          for (j = (optdata[i + 1] - 2) / TCP_OPT_SACK_BLKLEN;
+               j > 0 && nsack < TCP_SACK_NBLOCKS;
+               j--, blk += TCP_OPT_SACK_BLKLEN)
+            {
+              sack[nsack].left  = tcp_getsequence(blk);
+              sack[nsack].right = tcp_getsequence(blk + 4);
+              nsack++;
+            }
+
+          break;
+        }
+
+      i += optdata[i + 1];
+    }
+
+  return nsack;
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_send_fastrexmit
+ *
+ * Description:
+ *   Retransmit one segment worth of data beginning at 'seqno' immediately,
+ *   without waiting for the retransmission timer.  With SACK, data that
+ *   the peer has already reported as received is skipped.
+ *
+ * Parameters:
+ *   dev      The structure of the network driver that will send the data
+ *   conn     The TCP connection structure
+ *   seqno    The sequence number of the first byte to retransmit
+ *   sack     The SACK blocks reported in the last ACK
+ *   nsack    The number of SACK blocks (zero without SACK)
+ *
+ * Returned Value:
+ *   True if a segment was retransmitted
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+static bool psock_send_fastrexmit(FAR struct net_driver_s *dev,
+                                  FAR struct tcp_conn_s *conn,
+                                  uint32_t seqno,
+                                  FAR const struct tcp_sackblock_s *sack,
+                                  int nsack)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t limit;
+  size_t sndlen;
+  bool moved;
+  int i;
+
+  limit = conn->sndseq_max;
+
+  /* Skip over any data that the peer has already received.  Then stop the
+   * retransmission at the beginning of the next received block.
+   */
+
+  do
+    {
+      moved = false;
+      for (i = 0; i < nsack; i++)
+        {
+          if (sack[i].left <= seqno && seqno < sack[i].right)
+            {
+              seqno = sack[i].right;
+              moved = true;
+            }
+        }
+    }
+  while (moved);
+
+  for (i = 0; i < nsack; i++)
+    {
+      if (sack[i].left > seqno && sack[i].left < limit)
+        {
+          limit = sack[i].left;
+        }
+    }
+
+  if (seqno >= limit)
+    {
+      return false;
+    }
+
+  /* Find the write buffer that holds the data.  The unacked_q is in
+   * sequence number order; the head of the write_q may also hold some
+   * sent data.
+   */
+
+  wrb = NULL;
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (seqno >= TCP_WBSEQNO(wrb) &&
+          seqno < TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb))
+        {
+          break;
+        }
+
+      wrb = NULL;
+    }
+
+  if (wrb == NULL)
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || seqno < TCP_WBSEQNO(wrb) ||
+          seqno >= TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb))
+        {
+          return false;
+        }
+    }
+
+  /* Send at most one MSS from that write buffer */
+
+  sndlen = TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb) - seqno;
+  if (sndlen > limit - seqno)
+    {
+      sndlen = limit - seqno;
+    }
+
+  if (sndlen > conn->mss)
+    {
+      sndlen = conn->mss;
+    }
+
+  ninfo("FASTREXMIT: wrb=%p seqno=%u sndlen=%u\n", wrb, seqno, sndlen);
+
+  tcp_setsequence(conn->sndseq, seqno);
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  send_ipselect(dev, conn);
+#endif
+
+  devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, seqno - TCP_WBSEQNO(wrb));
+
+#ifdef CONFIG_NET_TCP_SACK
+  conn->rexmit_seq = seqno + sndlen;
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#ifdef CONFIG_NET_TCP_SACK
+  if (nsack > 0)
+    {
+      conn->rtx_sack++;
+    }
+  else
+#endif
+    {
+      conn->rtx_fast++;
+    }
+#endif
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -411,6 +692,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)pvconn;
   FAR struct socket *psock = (FAR struct socket *)pvpriv;
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+  struct tcp_sackblock_s sack[TCP_SACK_NBLOCKS];
+  uint32_t rexmit_seqno = 0;
+  bool fastrexmit = false;
+  int nsack = 0;
+#endif
 
   /* The TCP socket is connected and, hence, should be bound to a device.
    * Make sure that the polling device is the one that we are bound to.
@@ -435,6 +722,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       FAR sq_entry_t *entry;
       FAR sq_entry_t *next;
       uint32_t ackno;
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      uint32_t oldseq = 0;
+      bool haveold;
+#endif
 
       /* Get the offset address of the TCP header */
 
@@ -463,6 +754,21 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%u flags=%04x\n", ackno, flags);
 
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      /* Remember where the oldest un-ACKed data began before this ACK is
+       * applied so that duplicate ACKs can be recognized below.
+       */
+
+      haveold = psock_oldest_seqno(conn, &oldseq);
+
+#ifdef CONFIG_NET_TCP_SACK
+      if (conn->sackok)
+        {
+          nsack = psock_sack_parse(tcp, sack);
+        }
+#endif
+#endif
+
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -569,6 +875,90 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      if (haveold)
+        {
+          if (ackno == oldseq && (flags & TCP_NEWDATA) == 0)
+            {
+              /* A duplicate ACK:  Some later segment has arrived, but the
+               * oldest un-ACKed one apparently has not.
+               */
+
+              if (conn->dupacks < UINT8_MAX)
+                {
+                  conn->dupacks++;
+                }
+
+              if (!conn->recovery &&
+                  conn->dupacks == CONFIG_NET_TCP_FAST_RETRANSMIT_WATERMARK)
+                {
+                  /* Enter fast recovery and retransmit the lost segment */
+
+                  ninfo("ACK: %u duplicate ACKs for seqno=%u\n",
+                        conn->dupacks, ackno);
+
+                  conn->recovery = true;
+                  conn->recover  = conn->sndseq_max;
+                  rexmit_seqno   = ackno;
+                  fastrexmit     = true;
+
+#ifdef CONFIG_NET_TCP_CC
+                  tcp_cc_loss(conn, false);
+#endif
+                }
+#ifdef CONFIG_NET_TCP_SACK
+              else if (conn->recovery && nsack > 0)
+                {
+                  /* Each further duplicate ACK means that another segment
+                   * has left the network.  Use that to retransmit the next
+                   * hole reported by the SACK blocks.
+                   */
+
+                  rexmit_seqno = conn->rexmit_seq;
+                  fastrexmit   = true;
+                }
+#endif
+            }
+          else if (ackno > oldseq)
+            {
+              conn->dupacks = 0;
+
+              if (conn->recovery)
+                {
+                  if (ackno >= conn->recover)
+                    {
+                      /* Full ACK:  Everything outstanding at the time of
+                       * the loss has been received.
+                       */
+
+                      conn->recovery = false;
+                    }
+                  else
+                    {
+                      /* Partial ACK:  The next hole begins at ackno */
+
+                      rexmit_seqno = ackno;
+#ifdef CONFIG_NET_TCP_SACK
+                      if (conn->rexmit_seq > ackno)
+                        {
+                          rexmit_seqno = conn->rexmit_seq;
+                        }
+#endif
+                      fastrexmit = true;
+                    }
+                }
+#ifdef CONFIG_NET_TCP_CC
+              else
+                {
+                  /* New data was ACKed:  Open the congestion window */
+
+                  tcp_cc_ack(conn, ackno - oldseq);
+                }
+#endif
+            }
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -604,6 +994,22 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* A retransmission time-out closes the congestion window */
+
+      if (conn->cwnd != 0)
+        {
+          tcp_cc_loss(conn, true);
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+      /* Fast recovery failed; everything will be retransmitted */
+
+      conn->dupacks  = 0;
+      conn->recovery = false;
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -755,6 +1161,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+  /* Retransmit without waiting for the timer if the ACK processing above
+   * determined that it is necessary.
+   */
+
+  if (fastrexmit && (conn->tcpstateflags & TCP_ESTABLISHED) &&
+      psock_send_addrchck(conn) &&
+      psock_send_fastrexmit(dev, conn, rexmit_seqno, sack, nsack))
+    {
+      return flags & ~TCP_POLL;
+    }
+#endif
+
   /* We get here if (1) not all of the data has been ACKed, (2) we have been
    * asked to retransmit data, (3) the connection is still healthy, and (4)
    * the outgoing packet is available for our use.  In this case, we are
@@ -764,7 +1183,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
    */
 
   if ((conn->tcpstateflags & TCP_ESTABLISHED) &&
-      (flags & (TCP_POLL | TCP_REXMIT)) &&
+      ((flags & (TCP_POLL | TCP_REXMIT)) != 0 || SEND_ACKCLOCKED(flags)) &&
       !(sq_empty(&conn->write_q)))
     {
       /* Check if the destination IP address is in the ARP  or Neighbor
@@ -803,6 +1222,41 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = conn->winsize;
             }
 
+#ifdef CONFIG_NET_TCP_NAGLE
+          /* Hold a new segment that is smaller than the MSS because it is
+           * the last of the queued data:  While earlier data is un-ACKed
+           * (Nagle, RFC 896) or, with TCP_CORK, until more data is written
+           * or the cork is removed.
+           */
+
+          if (sndlen < conn->mss && TCP_WBNRTX(wrb) == 0 &&
+              sq_next(&wrb->wb_node) == NULL &&
+              sndlen == TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb) &&
+              (conn->cork || (!conn->nodelay && conn->unacked > 0)))
+            {
+              ninfo("SEND: Holding %u bytes\n", sndlen);
+              return flags;
+            }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+          /* Don't exceed the congestion window.  If only part of the
+           * segment fits, wait for more data to be ACKed.
+           */
+
+          if (conn->cwnd == 0)
+            {
+              tcp_cc_init(conn);
+            }
+
+          if (conn->unacked >= conn->cwnd ||
+              (conn->unacked > 0 && sndlen > conn->cwnd - conn->unacked))
+            {
+              ninfo("SEND: cwnd=%u unacked=%u\n", conn->cwnd, conn->unacked);
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                 wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen);
 
@@ -900,11 +1354,86 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
         }
     }
 
+  /* If there is no more data queued for transmission, then stop asking
+   * for poll events.  psock_tcp_send() will re-enable them the next time
+   * that data is added to the write queue.
+   */
+
+  if (sq_empty(&conn->write_q) && psock->s_sndcb != NULL)
+    {
+      psock->s_sndcb->flags &= ~TCP_POLL;
+    }
+
   /* Continue waiting */
 
   return flags;
 }
 
+/****************************************************************************
+ * Name: psock_send_coalesce
+ *
+ * Description:
+ *   Append a small write to the last write buffer in the write queue if
+ *   none of that buffer has been sent yet and the result still fits in one
+ *   segment.  Small writes then go out as one segment rather than one
+ *   segment each.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *   buf  - Data to send
+ *   len  - Length of data to send
+ *
+ * Returned Value:
+ *   True if the data was appended.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static bool psock_send_coalesce(FAR struct tcp_conn_s *conn,
+                                FAR const void *buf, size_t len)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  unsigned int pktlen;
+  int ret;
+
+  wrb = (FAR struct tcp_wrbuffer_s *)conn->write_q.tail;
+  if (conn->nodelay || wrb == NULL || TCP_WBSEQNO(wrb) != (unsigned)-1)
+    {
+      return false;
+    }
+
+  pktlen = TCP_WBPKTLEN(wrb);
+  if (pktlen + len > conn->mss)
+    {
+      return false;
+    }
+
+  /* Don't wait for I/O buffers here.  If the copy fails part way, remove
+   * what was appended and let the caller queue the data normally.
+   */
+
+  ret = iob_trycopyin(TCP_WBIOB(wrb), (FAR const uint8_t *)buf, len,
+                      pktlen, false);
+  if (ret < 0)
+    {
+      if (TCP_WBPKTLEN(wrb) > pktlen)
+        {
+          wrb->wb_iob = iob_trimtail(TCP_WBIOB(wrb),
+                                     TCP_WBPKTLEN(wrb) - pktlen);
+        }
+
+      return false;
+    }
+
+  ninfo("Appended %u bytes to WRB=%p pktlen=%u\n",
+        (unsigned int)len, wrb, TCP_WBPKTLEN(wrb));
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: send_txnotify
  *
@@ -1044,9 +1573,18 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   if (psock->s_domain == PF_INET)
 #endif
     {
+#ifdef CONFIG_NET_ARP_QUEUE
+      /* Don't wait for the IP address mapping.  If it is still missing
+       * when the data is sent, arp_out() will hold the packet until the
+       * ARP reply arrives.
+       */
+
+      ret = OK;
+#else
       /* Make sure that the IP address mapping is in the ARP table */
 
       ret = arp_send(conn->u.ipv4.raddr);
+#endif
     }
 #endif /* CONFIG_NET_ARP_SEND */
 
@@ -1081,11 +1619,26 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* Unless TCP_NODELAY is set, try to add the data to the unsent tail of
+       * the write queue.
+       */
+
+      if (psock_send_coalesce(conn, buf, len))
+        {
+          result = len;
+          send_txnotify(psock, conn);
+          net_unlock();
+          goto done;
+        }
+#endif
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       wrb = tcp_wrbuffer_alloc();
       if (!wrb)
         {
@@ -1158,6 +1711,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       net_unlock();
     }
 
+#ifdef CONFIG_NET_TCP_NAGLE
+done:
+#endif
+
   /* Set the socket state to idle */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
@@ -58,6 +58,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -99,6 +100,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_map;     /* Address of directly accessible file data */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -418,21 +420,37 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_map != NULL)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              /* The file data is directly accessible (e.g., an XIP ROMFS
+               * file).  Copy it straight into the device buffer without
+               * the seek and read through the file system.
+               */
+
+              memcpy(dev->d_appdata,
+                     pstate->snd_map + pstate->snd_foffset + pstate->snd_sent,
+                     sndlen);
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to lseek: %d\n", ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       (int)ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -584,6 +602,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *map = NULL;
   struct sendfile_s state;
   int ret;
 
@@ -631,6 +650,37 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* If the file data is directly accessible in memory, then each packet
+   * can be built directly from the file data.  Clip the transfer to the
+   * end of the file since there will be no short read to end it.
+   */
+
+  if (file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&map)) >= 0 &&
+      map != NULL)
+    {
+      off_t start = offset ? *offset : file_seek(infile, 0, SEEK_CUR);
+      off_t pos   = file_seek(infile, 0, SEEK_CUR);
+      off_t fsize = file_seek(infile, 0, SEEK_END);
+
+      if (start < 0 || pos < 0 || fsize < 0)
+        {
+          map = NULL;
+        }
+      else
+        {
+          (void)file_seek(infile, pos, SEEK_SET);
+
+          if (start >= fsize)
+            {
+              return 0;
+            }
+          else if (count > (size_t)(fsize - start))
+            {
+              count = fsize - start;
+            }
+        }
+    }
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -654,6 +704,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : 0; /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_map     = map;                  /* Mapped file data or NULL */
 
   /* Allocate resources to receive a callback */
 
@@ -0,0 +1,265 @@
+/****************************************************************************
+ * net/tcp/tcp_sockopt.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/net/net.h>
+
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP) && defined(HAVE_TCP_SOCKOPTS)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_setcongestion
+ *
+ * Description:
+ *   Select the congestion control algorithm by name.  'value' need not be
+ *   NUL terminated if 'value_len' gives the length of the name.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static int tcp_setcongestion(FAR struct tcp_conn_s *conn,
+                             FAR const void *value, socklen_t value_len)
+{
+  char name[TCP_CA_NAME_MAX];
+  int ret;
+
+  if (value_len == 0 || value_len > TCP_CA_NAME_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Get a NUL terminated copy of the name */
+
+  memcpy(name, value, value_len);
+  name[value_len < TCP_CA_NAME_MAX ? value_len : TCP_CA_NAME_MAX - 1] = '\0';
+
+  net_lock();
+  ret = tcp_cc_select(conn, name);
+  net_unlock();
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_setflag
+ *
+ * Description:
+ *   Set TCP_NODELAY or TCP_CORK from an integer argument.  If that may
+ *   release a partial segment that is being held, ask the driver to poll
+ *   for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static int tcp_setflag(FAR struct tcp_conn_s *conn, FAR bool *flag,
+                       bool release, FAR const void *value,
+                       socklen_t value_len)
+{
+  if (value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  *flag = (*(FAR const int *)value != 0);
+
+  if (*flag == release && conn->dev != NULL)
+    {
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  net_unlock();
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_setsockopt
+ *
+ * Description:
+ *   Set a socket option at the IPPROTO_TCP level.  The supported options
+ *   are:
+ *
+ *   TCP_CONGESTION - 'value' is the name of the congestion control
+ *                    algorithm ("reno" or "cubic").  CONFIG_NET_TCP_CC.
+ *   TCP_NODELAY    - int: Non-zero disables the Nagle algorithm.
+ *                    CONFIG_NET_TCP_NAGLE.
+ *   TCP_CORK       - int: Non-zero holds all partial segments; zero sends
+ *                    any that were held.  CONFIG_NET_TCP_NAGLE.
+ *
+ * Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure:
+ *
+ *   ENOPROTOOPT - The option is not supported
+ *   EINVAL      - The name is too long or the value is too short
+ *   ENOENT      - There is no such congestion control algorithm
+ *
+ ****************************************************************************/
+
+int tcp_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+  DEBUGASSERT(conn != NULL);
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION:
+        return tcp_setcongestion(conn, value, value_len);
+#endif
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_NODELAY:
+        return tcp_setflag(conn, &conn->nodelay, true, value, value_len);
+
+      case TCP_CORK:
+        return tcp_setflag(conn, &conn->cork, false, value, value_len);
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_getsockopt
+ *
+ * Description:
+ *   Get a socket option at the IPPROTO_TCP level.  For TCP_CONGESTION, the
+ *   name of the connection's congestion control algorithm is returned.
+ *   TCP_NODELAY and TCP_CORK return an int.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     The location to return the value
+ *   value_len The size of 'value' on input; the returned size on output
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tcp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+  DEBUGASSERT(conn != NULL);
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION:
+        {
+          FAR const char *name;
+          socklen_t len;
+
+          if (*value_len == 0)
+            {
+              return -EINVAL;
+            }
+
+          net_lock();
+          name = tcp_cc_name(conn);
+          net_unlock();
+
+          len = strlen(name) + 1;
+          if (len > *value_len)
+            {
+              len = *value_len;
+            }
+
+          memcpy(value, name, len);
+          ((FAR char *)value)[len - 1] = '\0';
+          *value_len = len;
+          return OK;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_NODELAY:
+      case TCP_CORK:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = option == TCP_NODELAY ? conn->nodelay :
+                                                    conn->cork;
+        *value_len        = sizeof(int);
+        return OK;
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+#endif /* CONFIG_NET_TCP && HAVE_TCP_SOCKOPTS */
@@ -232,11 +232,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
                   /* Find the listener for this connection. */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-                  listener = tcp_findlistener(conn->lport, conn->domain);
-#else
-                  listener = tcp_findlistener(conn->lport);
-#endif
+                  listener = tcp_flowlistener(conn);
                   if (listener != NULL)
                     {
                       /* We call tcp_callback() for the connection with
@@ -303,6 +299,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.tcp.rexmit++;
+              conn->rtx_timeout++;
 #endif
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
@@ -360,6 +357,11 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
           if (dev == conn->dev)
             {
               result = tcp_callback(dev, conn, TCP_POLL);
+              if (tcp_dack_expired(conn))
+                {
+                  result |= TCP_SNDACK;
+                }
+
               tcp_appsend(dev, conn, result);
               goto done;
             }
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <nuttx/clock.h>
@@ -68,6 +69,27 @@
 #  define HAVE_UDP_POLL
 #endif
 
+/* Datagrams sent on the loopback device may be delivered directly into the
+ * read-ahead buffer of the receiving connection.
+ */
+
+#if defined(CONFIG_NETDEV_LOOPBACK_FASTPATH) && \
+    defined(CONFIG_NET_UDP_READAHEAD)
+#  define NET_UDP_LOOPBACK_DIRECT 1
+#endif
+
+/* Each entry of the read-ahead queue holds the size of the source address,
+ * the source address, then, with CONFIG_NET_TIMESTAMP, the software and
+ * the hardware receive timestamps, and finally the payload.  This is the
+ * size of the timestamps.
+ */
+
+#ifdef CONFIG_NET_TIMESTAMP
+#  define UDP_RA_TSTAMPLEN (2 * sizeof(struct timespec))
+#else
+#  define UDP_RA_TSTAMPLEN 0
+#endif
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
 /* UDP write buffer dump macros */
 
@@ -98,12 +120,19 @@ struct udp_hdr_s;         /* Forward reference */
 struct udp_conn_s
 {
   dq_entry_t node;        /* Supports a doubly linked list */
+#ifdef CONFIG_NET_UDP_HASH
+  FAR struct udp_conn_s *hnext; /* Next bound connection in the hash bucket */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
+#ifdef CONFIG_NET_REUSEPORT
+  uint8_t  reuseport;     /* Port shared with SO_REUSEPORT (set by bind()) */
+  uint8_t  cpu;           /* SO_INCOMING_CPU plus one, zero if none */
+#endif
 
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Read-ahead buffering.
@@ -115,7 +144,7 @@ struct udp_conn_s
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 #endif
 
-#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
    *
    *   write_q   - The queue of unsent I/O buffers.  The head of this
@@ -554,6 +583,34 @@ FAR struct net_driver_s *udp_find_raddr_device(FAR struct udp_conn_s *conn);
 uint16_t udp_callback(FAR struct net_driver_s *dev,
                       FAR struct udp_conn_s *conn, uint16_t flags);
 
+/****************************************************************************
+ * Name: udp_loopback_send
+ *
+ * Description:
+ *   Deliver a datagram sent on the loopback device directly to the
+ *   read-ahead buffer of the receiving UDP connection.
+ *
+ * Input Parameters:
+ *   dev  - The device selected to send the datagram
+ *   conn - The sending UDP connection, connected to the destination
+ *   buf  - The datagram payload
+ *   len  - The size of the payload
+ *
+ * Returned Value:
+ *   true if the datagram was handled; false if it must be sent in the
+ *   normal way.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef NET_UDP_LOOPBACK_DIRECT
+bool udp_loopback_send(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn,
+                       FAR const void *buf, size_t len);
+#endif
+
 /****************************************************************************
  * Name: psock_udp_send
  *
@@ -594,6 +651,51 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendtov
+ *
+ * Description:
+ *   Like psock_udp_sendto() except that the payload of the datagram is
+ *   gathered from an I/O vector.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen);
+#endif
+
+/****************************************************************************
+ * Name: psock_udp_sendmsg
+ *
+ * Description:
+ *   Implements sendmsg() for UDP sockets with write buffering.  The
+ *   datagram is gathered from the I/O vector directly into a write buffer
+ *   and sent to msg_name or, if msg_name is NULL, to the peer of a
+ *   connected socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct msghdr *msg, int flags);
+#endif
+
+/****************************************************************************
+ * Name: psock_udp_recvmsg
+ *
+ * Description:
+ *   Implements recvmsg() for UDP sockets by scattering the next datagram
+ *   in the read-ahead queue directly into the I/O vector of the message.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+ssize_t psock_udp_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                          int flags);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -42,6 +42,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -89,12 +90,26 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
 #endif
   FAR void  *src_addr;
   uint8_t src_addr_size;
+#ifdef CONFIG_NET_TIMESTAMP
+  struct timespec tstamp[2];
+
+  /* Stamp the datagram with the time that the stack received it and with
+   * the hardware time of reception, if the driver provided one.
+   */
+
+  (void)clock_gettime(CLOCK_REALTIME, &tstamp[0]);
+  tstamp[1] = dev->d_rxtime;
+#endif
 
   /* Allocate on I/O buffer to start the chain (throttling as necessary).
    * We will not wait for an I/O buffer to become available in this context.
+   * The buffer is sized for the data and the source address that precedes
+   * it if there are pools of small or of large I/O buffers.
    */
 
-  iob = iob_tryalloc(true);
+  iob = iob_tryalloc_size(buflen + sizeof(uint8_t) +
+                          sizeof(struct sockaddr_storage) +
+                          UDP_RA_TSTAMPLEN, true);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to create new I/O buffer chain\n");
@@ -195,12 +210,24 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       return 0;
     }
 
+#ifdef CONFIG_NET_TIMESTAMP
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)tstamp, UDP_RA_TSTAMPLEN,
+                      src_addr_size + sizeof(uint8_t), true);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
+      (void)iob_free_chain(iob);
+      return 0;
+    }
+#endif
+
   if (buflen > 0)
     {
       /* Copy the new appdata into the I/O buffer chain */
 
       ret = iob_trycopyin(iob, buffer, buflen,
-                          src_addr_size + sizeof(uint8_t), true);
+                          src_addr_size + sizeof(uint8_t) +
+                          UDP_RA_TSTAMPLEN, true);
       if (ret < 0)
         {
           /* On a failure, iob_trycopyin return a negated error value but
@@ -45,6 +45,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -65,6 +66,7 @@
 #include "netdev/netdev.h"
 #include "inet/inet.h"
 #include "udp/udp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -94,10 +96,69 @@ static dq_queue_t g_active_udp_connections;
 
 static uint16_t g_last_udp_port;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* Bound connections hashed on the local port number.  Each bucket is a
+ * singly linked list through the hnext field in the order in which the
+ * connections were bound.
+ */
+
+static FAR struct udp_conn_s *g_udp_hash[CONFIG_NET_UDP_HASHSIZE];
+
+#define UDP_HASH(p) (&g_udp_hash[(p) % CONFIG_NET_UDP_HASHSIZE])
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Set the local port number (network byte order) of a connection and
+ *   move the connection to the hash bucket of the new port.  A port number
+ *   of zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_HASH
+  FAR struct udp_conn_s **link;
+
+  net_lock();
+
+  if (conn->lport != 0)
+    {
+      for (link = UDP_HASH(conn->lport); *link != NULL;
+           link = &(*link)->hnext)
+        {
+          if (*link == conn)
+            {
+              *link = conn->hnext;
+              break;
+            }
+        }
+    }
+
+  conn->lport = portno;
+  conn->hnext = NULL;
+
+  if (portno != 0)
+    {
+      for (link = UDP_HASH(portno); *link != NULL; link = &(*link)->hnext)
+        {
+        }
+
+      *link = conn;
+    }
+
+  net_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: _udp_semtake() and _udp_semgive()
  *
@@ -130,7 +191,9 @@ static inline void _udp_semtake(FAR sem_t *sem)
  * Name: udp_find_conn()
  *
  * Description:
- *   Find the UDP connection that uses this local port number.
+ *   Find the UDP connection that uses this local port number.  If
+ *   'reuseport' is true, connections that share the port with SO_REUSEPORT
+ *   are not reported.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -139,16 +202,36 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
-                                            uint16_t portno)
+                                            uint16_t portno, bool reuseport)
 {
   FAR struct udp_conn_s *conn;
+#ifndef CONFIG_NET_UDP_HASH
   int i;
+#endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure (or, with the hash table, only
+   * those bound to this port number).
+   */
 
+#ifdef CONFIG_NET_UDP_HASH
+  for (conn = *UDP_HASH(portno); conn != NULL; conn = conn->hnext)
+    {
+#else
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       conn = &g_udp_connections[i];
+#endif
+
+#ifdef CONFIG_NET_REUSEPORT
+      /* Both connections may bind the port if both set SO_REUSEPORT */
+
+      if (reuseport && conn->reuseport)
+        {
+          continue;
+        }
+#else
+      UNUSED(reuseport);
+#endif
 
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
@@ -232,7 +315,7 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
           g_last_udp_port = 4096;
         }
     }
-  while (udp_find_conn(domain, u, htons(g_last_udp_port)) != NULL);
+  while (udp_find_conn(domain, u, htons(g_last_udp_port), false) != NULL);
 
   /* Initialize and return the connection structure, bind it to the
    * port number
@@ -265,8 +348,21 @@ static inline FAR struct udp_conn_s *
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
+#ifdef CONFIG_NET_REUSEPORT
+  FAR struct udp_conn_s *best = NULL;
+  uint32_t bestscore = 0;
+  uint32_t flow = 0;
+  uint32_t score;
+#endif
+
+#ifdef CONFIG_NET_UDP_HASH
+  /* Only the connections bound to the destination port need be examined */
 
+  conn = *UDP_HASH(udp->destport);
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
+
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -322,15 +418,51 @@ static inline FAR struct udp_conn_s *
 #endif
            net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
         {
-          /* Matching connection found.. return a reference to it */
+#ifdef CONFIG_NET_REUSEPORT
+          /* If the port is shared with SO_REUSEPORT, examine all of the
+           * sockets that share it and give the flow to the one with the
+           * best score.
+           */
+
+          if (conn->reuseport)
+            {
+              if (flow == 0)
+                {
+                  flow = net_reuseport_flow(ip->srcipaddr, 2, udp->srcport,
+                                            udp->destport);
+                }
+
+              score = net_reuseport_score(flow, conn, conn->cpu);
+              if (score > bestscore)
+                {
+                  bestscore = score;
+                  best      = conn;
+                }
+            }
+          else
+#endif
+            {
+              /* Matching connection found.. return a reference to it */
 
-          break;
+              break;
+            }
         }
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_UDP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct udp_conn_s *)conn->node.flink;
+#endif
+    }
+
+#ifdef CONFIG_NET_REUSEPORT
+  if (conn == NULL)
+    {
+      conn = best;
     }
+#endif
 
   return conn;
 }
@@ -354,8 +486,21 @@ static inline FAR struct udp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
+#ifdef CONFIG_NET_REUSEPORT
+  FAR struct udp_conn_s *best = NULL;
+  uint32_t bestscore = 0;
+  uint32_t flow = 0;
+  uint32_t score;
+#endif
+
+#ifdef CONFIG_NET_UDP_HASH
+  /* Only the connections bound to the destination port need be examined */
 
+  conn = *UDP_HASH(udp->destport);
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
+
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -411,15 +556,51 @@ static inline FAR struct udp_conn_s *
 #endif
            net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
         {
-          /* Matching connection found.. return a reference to it */
+#ifdef CONFIG_NET_REUSEPORT
+          /* If the port is shared with SO_REUSEPORT, examine all of the
+           * sockets that share it and give the flow to the one with the
+           * best score.
+           */
+
+          if (conn->reuseport)
+            {
+              if (flow == 0)
+                {
+                  flow = net_reuseport_flow(ip->srcipaddr, 8, udp->srcport,
+                                            udp->destport);
+                }
+
+              score = net_reuseport_score(flow, conn, conn->cpu);
+              if (score > bestscore)
+                {
+                  bestscore = score;
+                  best      = conn;
+                }
+            }
+          else
+#endif
+            {
+              /* Matching connection found.. return a reference to it */
 
-          break;
+              break;
+            }
         }
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_UDP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct udp_conn_s *)conn->node.flink;
+#endif
+    }
+
+#ifdef CONFIG_NET_REUSEPORT
+  if (conn == NULL)
+    {
+      conn = best;
     }
+#endif
 
   return conn;
 }
@@ -448,6 +629,13 @@ void udp_initialize(void)
   dq_init(&g_active_udp_connections);
   nxsem_init(&g_free_sem, 0, 1);
 
+#ifdef CONFIG_NET_UDP_HASH
+  for (i = 0; i < CONFIG_NET_UDP_HASHSIZE; i++)
+    {
+      g_udp_hash[i] = NULL;
+    }
+#endif
+
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       /* Mark the connection closed and move it to the free list */
@@ -485,8 +673,15 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 #endif
       conn->lport  = 0;
       conn->ttl    = IP_TTL;
+#ifdef CONFIG_NET_REUSEPORT
+      conn->reuseport = 0;
+      conn->cpu    = 0;
+#endif
+#ifdef CONFIG_NET_UDP_HASH
+      conn->hnext  = NULL;
+#endif
 
-#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
 
       sq_init(&conn->write_q);
@@ -520,7 +715,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+  udp_setlport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -669,7 +864,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
       ret         = OK;
     }
   else
@@ -680,11 +875,16 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
       /* Is any other UDP connection already bound to this address and port? */
 
-      if (udp_find_conn(conn->domain, &conn->u, portno) == NULL)
+#ifdef CONFIG_NET_REUSEPORT
+      if (udp_find_conn(conn->domain, &conn->u, portno,
+                        conn->reuseport != 0) == NULL)
+#else
+      if (udp_find_conn(conn->domain, &conn->u, portno, false) == NULL)
+#endif
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setlport(conn, portno);
           ret         = OK;
         }
       else
@@ -735,7 +935,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
@@ -123,7 +123,11 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = &dev->d_buf[hdrlen];
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* A zero checksum means that the sender did not compute one.  There is
+   * nothing to verify in that case or if the hardware already verified it.
+   */
+
+  chksum = NETDEV_RXCSUMOK(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
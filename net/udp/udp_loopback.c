@@ -0,0 +1,194 @@
+/****************************************************************************
+ * net/udp/udp_loopback.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <net/if.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "udp/udp.h"
+
+#ifdef NET_UDP_LOOPBACK_DIRECT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define UDPIPv4BUF ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
+#define UDPIPv6BUF ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_loopback_send
+ *
+ * Description:
+ *   Deliver a datagram sent on the loopback device directly to the
+ *   receiving UDP connection.  Only the UDP/IP headers are formatted in the
+ *   device buffer so that the receiving connection can be found and the
+ *   source address recorded.  The payload is then passed to udp_callback()
+ *   exactly as udp_input() would, so it is copied once, from the caller's
+ *   buffer into the read-ahead queue of the receiver, and any receiver
+ *   waiting in recvmsg() or poll() is awakened.  No checksums are computed
+ *   and the worker thread of the loopback device is not involved.
+ *
+ *   As with any UDP datagram, the datagram is silently dropped if there is
+ *   no receiver or if the receiver has no read-ahead buffer space.
+ *
+ * Input Parameters:
+ *   dev  - The device selected to send the datagram
+ *   conn - The sending UDP connection.  The remote address and port must
+ *          have been set with udp_connect().
+ *   buf  - The datagram payload
+ *   len  - The size of the payload
+ *
+ * Returned Value:
+ *   true if the datagram was handled here; false if 'dev' is not the
+ *   loopback device or the datagram does not fit in a loopback packet and
+ *   must be sent in the normal way.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool udp_loopback_send(FAR struct net_driver_s *dev,
+                       FAR struct udp_conn_s *conn,
+                       FAR const void *buf, size_t len)
+{
+  FAR struct udp_conn_s *peer;
+  FAR struct udp_hdr_s *udp;
+  unsigned int iplen;
+
+  if (dev->d_lltype != NET_LL_LOOPBACK || (dev->d_flags & IFF_UP) == 0 ||
+      len == 0)
+    {
+      return false;
+    }
+
+  /* The checksums are never computed on the loopback device */
+
+  DEBUGASSERT(NETDEV_TXCSUM(dev, NETDEV_TXCSUM_UDP));
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET ||
+      (conn->domain == PF_INET6 &&
+       ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
+#endif
+    {
+      udp_ipv4_select(dev);
+      udp   = UDPIPv4BUF;
+      iplen = IPv4_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      udp_ipv6_select(dev);
+      udp   = UDPIPv6BUF;
+      iplen = IPv6_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  if (len > UDP_MSS(dev, iplen))
+    {
+      return false;
+    }
+
+  /* Format the UDP/IP headers as if the datagram were being sent */
+
+  dev->d_sndlen = len;
+  udp_send(dev, conn);
+
+  NETDEV_TXPACKETS(dev);
+  NETDEV_TXBYTES(dev, dev->d_len);
+  NETDEV_RXPACKETS(dev);
+  NETDEV_RXBYTES(dev, dev->d_len);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.udp.recv++;
+#endif
+
+  /* And hand the payload to the receiving connection as if the datagram
+   * had been received.
+   */
+
+  peer = udp_active(dev, udp);
+  if (peer != NULL)
+    {
+      dev->d_appdata = (FAR uint8_t *)buf;
+      dev->d_len     = len;
+      dev->d_sndlen  = 0;
+
+      (void)udp_callback(dev, peer, UDP_NEWDATA);
+    }
+  else
+    {
+      nwarn("WARNING: No listener on UDP port\n");
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.drop++;
+#endif
+    }
+
+  NETDEV_TXDONE(dev);
+
+  dev->d_len    = 0;
+  dev->d_sndlen = 0;
+  return true;
+}
+
+#endif /* NET_UDP_LOOPBACK_DIRECT */
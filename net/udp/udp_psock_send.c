@@ -43,6 +43,7 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <debug.h>
 
 #include <nuttx/net/net.h>
 
@@ -50,32 +51,36 @@
 #include "udp/udp.h"
 
 /****************************************************************************
- * Public Functions
+ * Private Types
  ****************************************************************************/
 
+union udp_sockaddr_u
+{
+  struct sockaddr     addr;
+#ifdef CONFIG_NET_IPv4
+  struct sockaddr_in  addr4;
+#endif
+#ifdef CONFIG_NET_IPv6
+  struct sockaddr_in6 addr6;
+#endif
+};
+
 /****************************************************************************
- * Name: psock_udp_send
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_peeraddr
  *
  * Description:
- *   Implements send() for connected UDP sockets
+ *   Get the address of the peer of a connected UDP socket
  *
  ****************************************************************************/
 
-ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+static int udp_peeraddr(FAR struct socket *psock,
+                        FAR union udp_sockaddr_u *to, FAR socklen_t *tolen)
 {
   FAR struct udp_conn_s *conn;
-  union
-  {
-    struct sockaddr     addr;
-#ifdef CONFIG_NET_IPv4
-    struct sockaddr_in  addr4;
-#endif
-#ifdef CONFIG_NET_IPv6
-    struct sockaddr_in6 addr6;
-#endif
-  } to;
-  socklen_t tolen;
 
   DEBUGASSERT(psock != NULL && psock->s_crefs > 0);
   DEBUGASSERT(psock->s_type == SOCK_DGRAM);
@@ -87,22 +92,20 @@ ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (!_SS_ISCONNECTED(psock->s_flags))
     {
-      /* No, then it is not legal to call send() with this socket. */
+      /* No, then there is no implied destination for the datagram */
 
       return -ENOTCONN;
     }
 
-  /* Yes, then let psock_sendto to the work */
-
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   if (conn->domain == PF_INET)
 #endif
     {
-      tolen               = sizeof(struct sockaddr_in);
-      to.addr4.sin_family = AF_INET;
-      to.addr4.sin_port   = conn->rport;
-      net_ipv4addr_copy(to.addr4.sin_addr.s_addr, conn->u.ipv4.raddr);
+      *tolen               = sizeof(struct sockaddr_in);
+      to->addr4.sin_family = AF_INET;
+      to->addr4.sin_port   = conn->rport;
+      net_ipv4addr_copy(to->addr4.sin_addr.s_addr, conn->u.ipv4.raddr);
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -111,12 +114,113 @@ ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
   else
 #endif
     {
-      tolen               = sizeof(struct sockaddr_in6);
-      to.addr6.sin6_family = AF_INET6;
-      to.addr6.sin6_port   = conn->rport;
-      net_ipv6addr_copy(to.addr6.sin6_addr.s6_addr, conn->u.ipv6.raddr);
+      *tolen                = sizeof(struct sockaddr_in6);
+      to->addr6.sin6_family = AF_INET6;
+      to->addr6.sin6_port   = conn->rport;
+      net_ipv6addr_copy(to->addr6.sin6_addr.s6_addr, conn->u.ipv6.raddr);
     }
 #endif /* CONFIG_NET_IPv6 */
 
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_send
+ *
+ * Description:
+ *   Implements send() for connected UDP sockets
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len)
+{
+  union udp_sockaddr_u to;
+  socklen_t tolen;
+  int ret;
+
+  /* It is not legal to call send() with an unconnected socket */
+
+  ret = udp_peeraddr(psock, &to, &tolen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Let psock_sendto to the work */
+
   return psock_udp_sendto(psock, buf, len, 0, &to.addr, tolen);
 }
+
+/****************************************************************************
+ * Name: psock_udp_sendmsg
+ *
+ * Description:
+ *   Implements sendmsg() for UDP sockets with write buffering.  The
+ *   datagram is gathered from the I/O vector of the message directly into
+ *   a write buffer and sent to msg_name or, if msg_name is NULL, to the
+ *   peer of a connected socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct msghdr *msg, int flags)
+{
+  FAR const struct sockaddr *to;
+  union udp_sockaddr_u peer;
+  socklen_t minlen;
+  socklen_t tolen;
+  int ret;
+
+  if (msg->msg_name == NULL)
+    {
+      ret = udp_peeraddr(psock, &peer, &tolen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      to = &peer.addr;
+    }
+  else
+    {
+      to    = (FAR const struct sockaddr *)msg->msg_name;
+      tolen = msg->msg_namelen;
+
+      /* Verify that a valid address has been provided */
+
+      switch (to->sa_family)
+        {
+#ifdef CONFIG_NET_IPv4
+        case AF_INET:
+          minlen = sizeof(struct sockaddr_in);
+          break;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+        case AF_INET6:
+          minlen = sizeof(struct sockaddr_in6);
+          break;
+#endif
+
+        default:
+          nerr("ERROR: Unrecognized address family: %d\n", to->sa_family);
+          return -EAFNOSUPPORT;
+        }
+
+      if (tolen < minlen)
+        {
+          nerr("ERROR: Invalid address length: %d < %d\n", tolen, minlen);
+          return -EBADF;
+        }
+    }
+
+  return psock_udp_sendtov(psock, msg->msg_iov, msg->msg_iovlen, flags,
+                           to, tolen);
+}
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
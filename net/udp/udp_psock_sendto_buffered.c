@@ -587,23 +587,21 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: psock_udp_sendtov
  *
  * Description:
- *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   Send one datagram whose payload is gathered from an I/O vector.  The
+ *   data is copied from each vector element directly into the I/O buffer
+ *   chain of the write buffer.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      The I/O vector that describes the data to send
+ *   iovcnt   The number of elements in the I/O vector
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
  *
- *   NOTE: All input parameters were verified by sendto() before this
- *   function was called.
- *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
  *   a negated errno value is returned.  See the description in
@@ -611,13 +609,23 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct udp_wrbuffer_s *wrb;
+  unsigned int offset;
+  size_t len;
   int ret = OK;
+  int i;
+
+  /* Get the total size of the datagram */
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
 
   /* Make sure that we have the IP address mapping */
 
@@ -630,9 +638,18 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   if (psock->s_domain == PF_INET)
 #endif
     {
+#ifdef CONFIG_NET_ARP_QUEUE
+      /* Don't wait for the IP address mapping.  If it is still missing
+       * when the data is sent, arp_out() will hold the packet until the
+       * ARP reply arrives.
+       */
+
+      ret = OK;
+#else
       /* Make sure that the IP address mapping is in the ARP table */
 
       ret = arp_send(conn->u.ipv4.raddr);
+#endif
     }
 #endif /* CONFIG_NET_ARP_SEND */
 
@@ -656,21 +673,39 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
-
-  BUF_DUMP("psock_udp_send", buf, len);
-
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
 
   if (len > 0)
     {
+      net_lock();
+
+#ifdef NET_UDP_LOOPBACK_DIRECT
+      /* A datagram to a receiver on the loopback device can be delivered
+       * now without buffering, provided that no earlier datagrams are still
+       * waiting in the write buffer queue.
+       */
+
+      if (iovcnt == 1 && to != NULL && sq_empty(&conn->write_q) &&
+          udp_connect(conn, to) >= 0)
+        {
+          FAR struct net_driver_s *dev = udp_find_raddr_device(conn);
+
+          if (dev != NULL &&
+              udp_loopback_send(dev, conn, iov[0].iov_base, len))
+            {
+              net_unlock();
+              psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+              return len;
+            }
+        }
+#endif
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       wrb = udp_wrbuffer_alloc();
       if (wrb == NULL)
         {
@@ -690,18 +725,32 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * buffer space if the socket was opened non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-      else
-        {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-
-      if (ret < 0)
+      for (i = 0, offset = 0; i < iovcnt; i++)
         {
-          goto errout_with_wrb;
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = iob_trycopyin(wrb->wb_iob,
+                                  (FAR const uint8_t *)iov[i].iov_base,
+                                  iov[i].iov_len, offset, false);
+            }
+          else
+            {
+              ret = iob_copyin(wrb->wb_iob,
+                               (FAR const uint8_t *)iov[i].iov_base,
+                               iov[i].iov_len, offset, false);
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_wrb;
+            }
+
+          offset += iov[i].iov_len;
         }
 
       /* Dump I/O buffer chain */
@@ -755,4 +804,45 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ *   NOTE: All input parameters were verified by sendto() before this
+ *   function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  struct iovec iov;
+
+  /* Dump the incoming buffer */
+
+  BUF_DUMP("psock_udp_send", buf, len);
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_udp_sendtov(psock, &iov, 1, flags, to, tolen);
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
@@ -433,6 +433,16 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       goto errout_with_lock;
     }
 
+#ifdef NET_UDP_LOOPBACK_DIRECT
+  /* A datagram to a receiver on the loopback device can be delivered now */
+
+  if (udp_loopback_send(dev, conn, buf, len))
+    {
+      ret = len;
+      goto errout_with_lock;
+    }
+#endif
+
   /* Set up the callback in the connection */
 
   state.st_cb = udp_callback_alloc(dev, conn);
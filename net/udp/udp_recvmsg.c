@@ -0,0 +1,486 @@
+/****************************************************************************
+ * net/udp/udp_recvmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "udp/udp.h"
+
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_READAHEAD) && \
+    defined(NET_UDP_HAVE_STACK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of the receive operation while it waits
+ * for a datagram to arrive.
+ */
+
+struct udp_recvmsg_s
+{
+  FAR struct devif_callback_s *rm_cb;  /* Reference to callback instance */
+  sem_t rm_sem;                        /* Semaphore signals new data */
+  int rm_result;                       /* Error reported by the callback */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_recvmsg_eventhandler
+ *
+ * Description:
+ *   Wake up the waiting receiver when a new datagram arrives or the network
+ *   goes down.  The datagram is not consumed here:  The flags are returned
+ *   unchanged so that udp_callback() will add the datagram to the
+ *   read-ahead queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t udp_recvmsg_eventhandler(FAR struct net_driver_s *dev,
+                                         FAR void *pvconn, FAR void *pvpriv,
+                                         uint16_t flags)
+{
+  FAR struct udp_recvmsg_s *pstate = (FAR struct udp_recvmsg_s *)pvpriv;
+
+  if (pstate != NULL && (flags & (UDP_NEWDATA | NETDEV_DOWN)) != 0)
+    {
+      if ((flags & NETDEV_DOWN) != 0)
+        {
+          nerr("ERROR: Network is down\n");
+          pstate->rm_result = -ENETUNREACH;
+        }
+
+      /* Disable further callbacks and wake up the receiver */
+
+      pstate->rm_cb->flags = 0;
+      pstate->rm_cb->priv  = NULL;
+      pstate->rm_cb->event = NULL;
+
+      nxsem_post(&pstate->rm_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: udp_recvmsg_cmsg
+ *
+ * Description:
+ *   Append one SOL_SOCKET control message to the ancillary data of the
+ *   message.  If it does not fit into the controllen bytes of the control
+ *   buffer, the message is dropped and MSG_CTRUNC is reported instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMP
+static void udp_recvmsg_cmsg(FAR struct msghdr *msg, socklen_t controllen,
+                             int type, FAR const void *data, size_t len)
+{
+  FAR struct cmsghdr *cmsg;
+
+  if (msg->msg_controllen + CMSG_SPACE(len) > controllen)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+      return;
+    }
+
+  cmsg = (FAR struct cmsghdr *)
+    ((FAR uint8_t *)msg->msg_control + msg->msg_controllen);
+
+  cmsg->cmsg_len   = CMSG_LEN(len);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type  = type;
+  memcpy(CMSG_DATA(cmsg), data, len);
+
+  msg->msg_controllen += CMSG_SPACE(len);
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_recvmsg_tstamp
+ *
+ * Description:
+ *   Return the receive timestamps of the datagram at 'offset' in 'iob' as
+ *   the SCM_TIMESTAMP and SCM_TIMESTAMPING control messages selected by the
+ *   socket options.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMP
+static void udp_recvmsg_tstamp(FAR struct socket *psock,
+                               FAR struct msghdr *msg, socklen_t controllen,
+                               FAR struct iob_s *iob, unsigned int offset)
+{
+  struct timespec tstamp[2];
+  uint8_t tsflags = psock->s_tstamp;
+  bool sw;
+  bool hw;
+
+  sw = (tsflags & SOF_TIMESTAMPING_RX_SOFTWARE) != 0 &&
+       (tsflags & SOF_TIMESTAMPING_SOFTWARE) != 0;
+  hw = (tsflags & SOF_TIMESTAMPING_RX_HARDWARE) != 0 &&
+       (tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0;
+
+  if ((!sw && !hw && !_SO_GETOPT(psock->s_options, SO_TIMESTAMP)) ||
+      iob_copyout((FAR uint8_t *)tstamp, iob, sizeof(tstamp), offset) !=
+      sizeof(tstamp))
+    {
+      return;
+    }
+
+  if (_SO_GETOPT(psock->s_options, SO_TIMESTAMP))
+    {
+      struct timeval tv;
+
+      tv.tv_sec  = tstamp[0].tv_sec;
+      tv.tv_usec = tstamp[0].tv_nsec / NSEC_PER_USEC;
+      udp_recvmsg_cmsg(msg, controllen, SCM_TIMESTAMP, &tv, sizeof(tv));
+    }
+
+  /* A datagram without a hardware timestamp reports only the software
+   * one, like Linux.  The unused middle entry is legacy and always zero.
+   */
+
+  hw = hw && (tstamp[1].tv_sec != 0 || tstamp[1].tv_nsec != 0);
+  if (sw || hw)
+    {
+      struct timespec ts[3];
+
+      memset(ts, 0, sizeof(ts));
+      if (sw)
+        {
+          ts[0] = tstamp[0];
+        }
+
+      if (hw)
+        {
+          ts[2] = tstamp[1];
+        }
+
+      udp_recvmsg_cmsg(msg, controllen, SCM_TIMESTAMPING, ts, sizeof(ts));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_recvmsg_readahead
+ *
+ * Description:
+ *   Remove the oldest datagram from the read-ahead queue and scatter it
+ *   into the I/O vector of the message.  The receive timestamps, if any
+ *   were requested, are returned in up to 'controllen' bytes of control
+ *   data.
+ *
+ * Returned Value:
+ *   The number of bytes transferred into the I/O vector.  -EAGAIN is
+ *   returned if the read-ahead queue is empty.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static ssize_t udp_recvmsg_readahead(FAR struct socket *psock,
+                                     FAR struct msghdr *msg,
+                                     socklen_t controllen)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct iob_s *iob;
+  uint8_t src_addr_size;
+  unsigned int offset;
+  ssize_t recvlen = 0;
+  int ret;
+  int i;
+
+  iob = iob_remove_queue(&conn->readahead);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  DEBUGASSERT(iob->io_pktlen > 0);
+
+  /* The datagram is preceded by the size of the source address and the
+   * source address itself.
+   */
+
+  msg->msg_flags = 0;
+
+  ret = iob_copyout(&src_addr_size, iob, sizeof(uint8_t), 0);
+  if (ret != sizeof(uint8_t))
+    {
+      goto out;
+    }
+
+  offset = sizeof(uint8_t);
+  if (msg->msg_name != NULL)
+    {
+      socklen_t len = msg->msg_namelen;
+
+      if ((socklen_t)src_addr_size < len)
+        {
+          len = src_addr_size;
+        }
+
+      ret = iob_copyout((FAR uint8_t *)msg->msg_name, iob, len, offset);
+      if (ret != len)
+        {
+          goto out;
+        }
+
+      msg->msg_namelen = src_addr_size;
+    }
+
+  offset += src_addr_size;
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* Then come the receive timestamps */
+
+  udp_recvmsg_tstamp(psock, msg, controllen, iob, offset);
+  offset += UDP_RA_TSTAMPLEN;
+#endif
+
+  /* Scatter the payload into the I/O vector */
+
+  for (i = 0; i < msg->msg_iovlen && offset < iob->io_pktlen; i++)
+    {
+      FAR struct iovec *iov = &msg->msg_iov[i];
+
+      if (iov->iov_len > 0)
+        {
+          ret = iob_copyout((FAR uint8_t *)iov->iov_base, iob, iov->iov_len,
+                            offset);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          recvlen += ret;
+          offset  += ret;
+        }
+    }
+
+  if (offset < iob->io_pktlen)
+    {
+      /* The remainder of the datagram did not fit and is discarded */
+
+      msg->msg_flags |= MSG_TRUNC;
+    }
+
+  ninfo("Received %d bytes (of %d)\n", (int)recvlen, iob->io_pktlen);
+
+out:
+  (void)iob_free_chain(iob);
+  return recvlen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_recvmsg
+ *
+ * Description:
+ *   Implements recvmsg() for UDP sockets with read-ahead buffering.  The
+ *   next datagram is removed from the read-ahead queue and scattered
+ *   directly into the caller's I/O vector.  If the queue is empty then,
+ *   unless the socket is non-blocking or MSG_DONTWAIT is specified, wait
+ *   for a datagram to be queued.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to receive.  msg_namelen must be initialized to
+ *           the size of the buffer at msg_name and msg_controllen to the
+ *           size of the buffer at msg_control.
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, the number of bytes received.  On failure, a negated errno
+ *   value:  -EAGAIN if no datagram is available and the socket is
+ *   non-blocking or the receive timeout expired.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                          int flags)
+{
+  FAR struct udp_conn_s *conn;
+  FAR struct net_driver_s *dev;
+  struct udp_recvmsg_s state;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timespec abstime;
+#endif
+  socklen_t controllen;
+  ssize_t ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && msg != NULL);
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+  /* On entry msg_controllen holds the size of the control buffer.  On
+   * return it holds the length of the control data returned in it.
+   */
+
+  controllen          = msg->msg_control != NULL ? msg->msg_controllen : 0;
+  msg->msg_controllen = 0;
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&state.rm_sem, 0, 0);
+  (void)nxsem_setprotocol(&state.rm_sem, SEM_PRIO_NONE);
+
+#ifdef CONFIG_NET_SOCKOPTS
+  /* Determine when the receive timeout (if any) expires */
+
+  if (psock->s_rcvtimeo != 0)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &abstime);
+      abstime.tv_sec  += psock->s_rcvtimeo / DSEC_PER_SEC;
+      abstime.tv_nsec += (psock->s_rcvtimeo % DSEC_PER_SEC) * NSEC_PER_DSEC;
+      if (abstime.tv_nsec >= NSEC_PER_SEC)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+#endif
+
+  net_lock();
+  for (; ; )
+    {
+      /* Take the next buffered datagram, if there is one */
+
+      ret = udp_recvmsg_readahead(psock, msg, controllen);
+      if (ret != -EAGAIN)
+        {
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          break;
+        }
+
+      /* Wait for a datagram to be queued.  The device may be NULL if the
+       * socket is bound to INADDR_ANY.  In that case, no NETDEV_DOWN
+       * notifications will be received.
+       */
+
+      dev = udp_find_laddr_device(conn);
+
+      state.rm_cb = udp_callback_alloc(dev, conn);
+      if (state.rm_cb == NULL)
+        {
+          ret = -EBUSY;
+          break;
+        }
+
+      state.rm_result    = OK;
+      state.rm_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+      state.rm_cb->priv  = (FAR void *)&state;
+      state.rm_cb->event = udp_recvmsg_eventhandler;
+
+#ifdef CONFIG_NET_SOCKOPTS
+      if (psock->s_rcvtimeo != 0)
+        {
+          ret = net_timedwait(&state.rm_sem, &abstime);
+        }
+      else
+#endif
+        {
+          ret = net_lockedwait(&state.rm_sem);
+        }
+
+      udp_callback_free(dev, conn, state.rm_cb);
+
+      if (ret < 0)
+        {
+          /* A timeout is reported as EAGAIN, like recvfrom() */
+
+          if (ret == -ETIMEDOUT)
+            {
+              ret = -EAGAIN;
+            }
+
+          break;
+        }
+
+      if (state.rm_result < 0)
+        {
+          ret = state.rm_result;
+          break;
+        }
+    }
+
+  net_unlock();
+  nxsem_destroy(&state.rm_sem);
+  return ret;
+}
+
+#endif /* CONFIG_NET_UDP && CONFIG_NET_UDP_READAHEAD && NET_UDP_HAVE_STACK */
@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <string.h>
+#include <queue.h>
 #include <poll.h>
 #include <errno.h>
 #include <assert.h>
@@ -69,10 +70,27 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A request waiting to be read and acknowledged by the daemon.  This
+ * lives on the stack of the thread that issued the request.
+ */
+
+struct usrsockdev_req_s
+{
+  sq_entry_t node;               /* Supports a singly linked list */
+  FAR const struct iovec *iov;   /* Request buffers */
+  int     iovcnt;                /* Number of request buffers */
+  sem_t   acksem;                /* Request acknowledgment notification */
+  uint8_t xid;                   /* Exchange id for which waiting ack */
+};
+
 struct usrsockdev_s
 {
   sem_t   devsem;     /* Lock for device node */
@@ -80,15 +98,9 @@ struct usrsockdev_s
 
   struct
   {
-    FAR const struct iovec *iov; /* Pending request buffers */
-    int     iovcnt;              /* Number of request buffers */
+    sq_queue_t queue;            /* Requests waiting for acknowledgment */
+    FAR struct usrsockdev_req_s *cur; /* Request being read by the daemon */
     size_t  pos;                 /* Reader position on request buffer */
-    sem_t   sem;                 /* Request semaphore (only one outstanding
-                                  * request) */
-    sem_t   acksem;              /* Request acknowledgment notification */
-    uint8_t ack_xid;             /* Exchange id for which waiting ack */
-    uint16_t nbusy;              /* Number of requests blocked from different
-                                    threads */
   } req;
 
   FAR struct usrsock_conn_s *datain_conn; /* Connection instance to receive
@@ -361,6 +373,54 @@ static void usrsockdev_pollnotify(FAR struct usrsockdev_s *dev, pollevent_t even
 #endif
 }
 
+/****************************************************************************
+ * Name: usrsockdev_ack_request
+ *
+ * Description:
+ *   Remove the request with exchange id 'xid' from the queue of requests
+ *   waiting for acknowledgment and wake up the requesting thread.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_ack_request(FAR struct usrsockdev_s *dev, uint8_t xid)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  for (req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.queue);
+       req != NULL;
+       req = (FAR struct usrsockdev_req_s *)sq_next(&req->node))
+    {
+      if (req->xid == xid)
+        {
+          break;
+        }
+    }
+
+  if (req == NULL)
+    {
+      return;
+    }
+
+  /* If the daemon was reading this request, move on to the next one */
+
+  if (dev->req.cur == req)
+    {
+      dev->req.cur = (FAR struct usrsockdev_req_s *)sq_next(&req->node);
+      dev->req.pos = 0;
+
+      if (dev->req.cur != NULL)
+        {
+          usrsockdev_pollnotify(dev, POLLIN);
+        }
+    }
+
+  sq_rem(&req->node, &dev->req.queue);
+  nxsem_post(&req->acksem);
+}
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -370,6 +430,10 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct inode        *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
+  ssize_t rlen;
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  size_t nread;
+#endif
 
   if (len == 0)
     {
@@ -390,15 +454,43 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
   usrsockdev_semtake(&dev->devsem);
   net_lock();
 
-  /* Is request available? */
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  /* Return as many of the queued requests as fit in the buffer.  Requests
+   * stay queued until they are acknowledged but are not read again.
+   */
 
-  if (dev->req.iov)
+  nread = 0;
+  while (dev->req.cur != NULL && len > 0)
     {
-      ssize_t rlen;
+      rlen = iovec_get(buffer, len, dev->req.cur->iov, dev->req.cur->iovcnt,
+                       dev->req.pos);
+      if (rlen <= 0)
+        {
+          /* This request has been read completely.  Continue with the
+           * next one.
+           */
 
+          dev->req.cur = (FAR struct usrsockdev_req_s *)
+                         sq_next(&dev->req.cur->node);
+          dev->req.pos = 0;
+          continue;
+        }
+
+      dev->req.pos += rlen;
+      buffer       += rlen;
+      len          -= rlen;
+      nread        += rlen;
+    }
+
+  len = nread;
+#else
+  /* Is request available? */
+
+  if (dev->req.cur)
+    {
       /* Copy request to user-space. */
 
-      rlen = iovec_get(buffer, len, dev->req.iov, dev->req.iovcnt,
+      rlen = iovec_get(buffer, len, dev->req.cur->iov, dev->req.cur->iovcnt,
                        dev->req.pos);
       if (rlen < 0)
         {
@@ -416,6 +508,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
     {
       len = 0;
     }
+#endif
 
   net_unlock();
   usrsockdev_semgive(&dev->devsem);
@@ -449,7 +542,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Is request available? */
 
-  if (dev->req.iov)
+  if (dev->req.cur)
     {
       ssize_t rlen;
 
@@ -464,7 +557,8 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 
       /* Copy request to user-space. */
 
-      rlen = iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt, pos);
+      rlen = iovec_get(NULL, 0, dev->req.cur->iov, dev->req.cur->iovcnt,
+                       pos);
       if (rlen < 0)
         {
           /* Tried seek beyond buffer. */
@@ -786,15 +880,11 @@ static ssize_t usrsockdev_handle_req_response(FAR struct usrsockdev_s *dev,
       goto unlock_out;
     }
 
-  if (dev->req.ack_xid == hdr->xid && dev->req.iov)
-    {
-      /* Signal that request was received and read by daemon and acknowledgment
-       * response was received. */
-
-      dev->req.iov = NULL;
+  /* Signal that request was received and read by daemon and acknowledgment
+   * response was received.
+   */
 
-      nxsem_post(&dev->req.acksem);
-    }
+  usrsockdev_ack_request(dev, hdr->xid);
 
   ret = handle_response(dev, conn, buffer);
 
@@ -857,69 +947,92 @@ static ssize_t usrsockdev_write(FAR struct file *filep, FAR const char *buffer,
 
   usrsockdev_semtake(&dev->devsem);
 
-  if (!dev->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header. */
+  /* The daemon may write several responses and events, each optionally
+   * followed by its data, with one write().
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!dev->datain_conn)
         {
-          nwarn("message too short, %d < %d.\n", len,
-                sizeof(struct usrsock_message_common_s));
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-          ret = -EINVAL;
-          goto errout;
-        }
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %d < %d.\n", len,
+                    sizeof(struct usrsock_message_common_s));
+
+              ret = -EINVAL;
+              break;
+            }
 
-      /* Handle message. */
+          /* Handle message. */
+
+          ret = usrsockdev_handle_message(dev, buffer, len);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      ret = usrsockdev_handle_message(dev, buffer, len);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
           ret = origlen - len;
         }
-    }
 
-  /* Data input handling. */
+      /* Data input handling. */
 
-  if (dev->datain_conn)
-    {
-      conn = dev->datain_conn;
+      if (dev->datain_conn)
+        {
+          conn = dev->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
-                      conn->resp.datain.pos, buffer, len);
-      if (ret < 0)
-        {
-          /* Tried writing beyond buffer. */
+          ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
+                          conn->resp.datain.pos, buffer,
+                          MIN(len, conn->resp.datain.total -
+                                   conn->resp.datain.pos));
+          if (ret < 0)
+            {
+              /* Tried writing beyond buffer. */
 
-          ret = -EINVAL;
-          conn->resp.result = -EINVAL;
-          conn->resp.datain.pos =
-              conn->resp.datain.total;
-        }
-      else
-        {
-          conn->resp.datain.pos += ret;
-          buffer += ret;
-          len -= ret;
-          ret = origlen - len;
-        }
+              ret = -EINVAL;
+              conn->resp.result = -EINVAL;
+              conn->resp.datain.pos =
+                  conn->resp.datain.total;
+            }
+          else
+            {
+              conn->resp.datain.pos += ret;
+              buffer += ret;
+              len -= ret;
+              ret = origlen - len;
+            }
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          dev->datain_conn = NULL;
+          if (conn->resp.datain.pos == conn->resp.datain.total)
+            {
+              dev->datain_conn = NULL;
 
-          /* Done with data response. */
+              /* Done with data response. */
 
-          (void)usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+              (void)usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
         }
     }
 
-errout:
+  /* Report the messages that were consumed before any error */
+
+  if (ret < 0 && len < origlen)
+    {
+      ret = origlen - len;
+    }
+
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
@@ -975,7 +1088,7 @@ static int usrsockdev_close(FAR struct file *filep)
   FAR struct inode *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
   FAR struct usrsock_conn_s *conn;
-  struct timespec abstime;
+  FAR struct usrsockdev_req_s *req;
   int ret;
 
   DEBUGASSERT(inode);
@@ -1012,57 +1125,18 @@ static int usrsockdev_close(FAR struct file *filep)
   DEBUGASSERT(dev->ocount == 0);
   ret = OK;
 
-  do
-    {
-      /* Give other threads short time window to complete recently completed
-       * requests.
-       */
-
-      DEBUGVERIFY(clock_gettime(CLOCK_REALTIME, &abstime));
-
-      abstime.tv_sec += 0;
-      abstime.tv_nsec += 10 * NSEC_PER_MSEC;
-      if (abstime.tv_nsec >= NSEC_PER_SEC)
-        {
-          abstime.tv_sec++;
-          abstime.tv_nsec -= NSEC_PER_SEC;
-        }
-
-      ret = net_timedwait(&dev->req.sem, &abstime);
-      if (ret < 0)
-        {
-          if (ret != -ETIMEDOUT && ret != -EINTR)
-            {
-              ninfo("net_timedwait errno: %d\n", ret);
-              DEBUGASSERT(false);
-            }
-        }
-      else
-        {
-          usrsockdev_semgive(&dev->req.sem);
-        }
-
-      /* Wake-up pending requests. */
-
-      if (dev->req.nbusy == 0)
-        {
-          break;
-        }
-
-      dev->req.iov = NULL;
-      nxsem_post(&dev->req.acksem);
-    }
-  while (true);
-
-  net_unlock();
+  /* Wake-up pending requests. */
 
-  /* Check if request line is active */
-
-  if (dev->req.iov != NULL)
+  while ((req = (FAR struct usrsockdev_req_s *)
+                sq_remfirst(&dev->req.queue)) != NULL)
     {
-      dev->req.iov = NULL;
+      nxsem_post(&req->acksem);
     }
 
+  dev->req.cur = NULL;
+  dev->req.pos = 0;
+
+  net_unlock();
   usrsockdev_semgive(&dev->devsem);
 
   return ret;
@@ -1132,9 +1206,9 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
-      if (dev->req.iov != NULL &&
-          !(iovec_get(NULL, 0, dev->req.iov,
-                      dev->req.iovcnt, dev->req.pos) < 0))
+      if (dev->req.cur != NULL &&
+          !(iovec_get(NULL, 0, dev->req.cur->iov,
+                      dev->req.cur->iovcnt, dev->req.pos) < 0))
         {
           eventset |= POLLIN;
         }
@@ -1182,6 +1256,7 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
 {
   FAR struct usrsockdev_s *dev = conn->dev;
   FAR struct usrsock_request_common_s *req_head = iov[0].iov_base;
+  struct usrsockdev_req_s req;
   int ret;
 
   if (!dev)
@@ -1209,45 +1284,43 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
-  ++dev->req.nbusy; /* net_lock held. */
+  /* Queue the request for the daemon to handle.  Requests from other
+   * threads may be queued behind it without waiting for this one to be
+   * acknowledged.
+   */
 
-  /* Set outstanding request for daemon to handle. */
+  req.iov    = iov;
+  req.iovcnt = iovcnt;
+  req.xid    = req_head->xid;
 
-  while ((ret = net_lockedwait(&dev->req.sem)) < 0)
-    {
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-    }
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
 
-  if (usrsockdev_is_opened(dev))
+  nxsem_init(&req.acksem, 0, 0);
+  nxsem_setprotocol(&req.acksem, SEM_PRIO_NONE);
+
+  sq_addlast(&req.node, &dev->req.queue); /* net_lock held. */
+  if (dev->req.cur == NULL)
     {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.ack_xid = req_head->xid;
-      dev->req.iov = iov;
+      dev->req.cur = &req;
       dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+    }
 
-      /* Notify daemon of new request. */
+  /* Notify daemon of new request. */
 
-      usrsockdev_pollnotify(dev, POLLIN);
+  usrsockdev_pollnotify(dev, POLLIN);
 
-      /* Wait ack for request. */
+  /* Wait ack for request.  The request is removed from the queue when it
+   * is acknowledged or when the daemon closes /dev/usrsock.
+   */
 
-      while ((ret = net_lockedwait(&dev->req.acksem)) < 0)
-        {
-          DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-        }
-    }
-  else
+  while ((ret = net_lockedwait(&req.acksem)) < 0)
     {
-      ninfo("usockid=%d; daemon abruptly closed /usr/usrsock.\n", conn->usockid);
+      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
     }
 
-  /* Free request line for next command. */
-
-  usrsockdev_semgive(&dev->req.sem);
-
-  --dev->req.nbusy; /* net_lock held. */
-
+  nxsem_destroy(&req.acksem);
   return OK;
 }
 
@@ -1264,10 +1337,10 @@ void usrsockdev_register(void)
   /* Initialize device private structure. */
 
   g_usrsockdev.ocount = 0;
-  g_usrsockdev.req.nbusy = 0;
+  g_usrsockdev.req.cur = NULL;
+  g_usrsockdev.req.pos = 0;
+  sq_init(&g_usrsockdev.req.queue);
   nxsem_init(&g_usrsockdev.devsem, 0, 1);
-  nxsem_init(&g_usrsockdev.req.sem, 0, 1);
-  nxsem_init(&g_usrsockdev.req.acksem, 0, 0);
 
   (void)register_driver("/dev/usrsock", &g_usrsockdevops, 0666, &g_usrsockdev);
 }
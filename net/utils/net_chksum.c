@@ -43,6 +43,8 @@
 #include <stdint.h>
 #include <debug.h>
 
+#include <arpa/inet.h>
+
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
@@ -57,6 +59,100 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Fold a 32-bit one's complement sum to 16 bits */
+
+#define CHKSUM_FOLD(s) (((s) & 0xffff) + ((s) >> 16))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_aligned
+ *
+ * Description:
+ *   Return the one's complement sum of a halfword aligned buffer summed as
+ *   16-bit words in host byte order.  By the byte order independence of
+ *   the Internet checksum (RFC 1071), this is the byte swapped sum of the
+ *   big-endian words on a little-endian machine.  An odd final byte is
+ *   summed as if followed by a zero byte.
+ *
+ *   The words are added to a 32-bit accumulator without carry checks:  At
+ *   most 32767 words cannot overflow it.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_CHKSUM_PARTIAL)
+static uint16_t chksum_aligned(FAR const uint8_t *data, uint16_t len)
+{
+  FAR const uint16_t *wptr = (FAR const uint16_t *)data;
+  uint32_t sum = 0;
+
+  /* Sum 16 bytes per iteration */
+
+  while (len >= 16)
+    {
+      sum += (uint32_t)wptr[0] + wptr[1] + wptr[2] + wptr[3] +
+             wptr[4] + wptr[5] + wptr[6] + wptr[7];
+      wptr += 8;
+      len  -= 16;
+    }
+
+  while (len >= 2)
+    {
+      sum += *wptr++;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      sum += HTONS((uint16_t)(*(FAR const uint8_t *)wptr) << 8);
+    }
+
+  sum = CHKSUM_FOLD(sum);
+  return (uint16_t)CHKSUM_FOLD(sum);
+}
+
+/****************************************************************************
+ * Name: chksum_unaligned
+ *
+ * Description:
+ *   Return the one's complement sum of a buffer with an odd address summed
+ *   as big-endian 16-bit words assembled a byte at a time.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_unaligned(FAR const uint8_t *data, uint16_t len)
+{
+  uint32_t sum = 0;
+
+  while (len >= 8)
+    {
+      sum += ((uint32_t)data[0] << 8) + data[1] +
+             ((uint32_t)data[2] << 8) + data[3] +
+             ((uint32_t)data[4] << 8) + data[5] +
+             ((uint32_t)data[6] << 8) + data[7];
+      data += 8;
+      len  -= 8;
+    }
+
+  while (len >= 2)
+    {
+      sum  += ((uint32_t)data[0] << 8) + data[1];
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      sum += (uint32_t)data[0] << 8;
+    }
+
+  sum = CHKSUM_FOLD(sum);
+  return (uint16_t)CHKSUM_FOLD(sum);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,40 +178,31 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t total;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* Get the sum of the data as big-endian words.  The sum of host order
+   * words only needs to be swapped back.
+   */
 
-  while (dataptr < last_byte)
+#ifdef CONFIG_NET_ARCH_CHKSUM_PARTIAL
+  total = NTOHS(up_chksum(data, len));
+#else
+  if (((uintptr_t)data & 1) == 0)
     {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      total = NTOHS(chksum_aligned(data, len));
     }
-
-  if (dataptr == last_byte)
+  else
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      total = chksum_unaligned(data, len);
     }
+#endif
 
-  /* Return sum in host byte order. */
+  /* Add the partial sum carried over from the previous call with the
+   * end-around carry.  Return sum in host byte order.
+   */
 
-  return sum;
+  total += sum;
+  return (uint16_t)CHKSUM_FOLD(total);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
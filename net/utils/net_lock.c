@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <stdbool.h>
+#include <string.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
@@ -62,9 +64,21 @@
  * Private Data
  ****************************************************************************/
 
-static sem_t        g_netlock;
-static pid_t        g_holder  = NO_HOLDER;
-static unsigned int g_count   = 0;
+/* The global network lock */
+
+static struct net_rmutex_s g_netlock =
+{
+  SEM_INITIALIZER(1), NO_HOLDER, 0
+};
+
+#ifdef CONFIG_NET_LOCK_STATS
+/* Statistics of the global network lock.  These are protected by the lock
+ * itself.
+ */
+
+static struct net_lockstats_s g_netlockstats;
+static uint32_t g_netlocktaken;  /* up_cyclecount() when the lock was taken */
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -79,7 +93,7 @@ static unsigned int g_count   = 0;
  *
  ****************************************************************************/
 
-static void _net_takesem(void)
+static void _net_takesem(FAR sem_t *sem)
 {
   int ret;
 
@@ -87,7 +101,7 @@ static void _net_takesem(void)
     {
       /* Take the semaphore (perhaps waiting) */
 
-      ret = nxsem_wait(&g_netlock);
+      ret = nxsem_wait(sem);
 
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -98,96 +112,189 @@ static void _net_takesem(void)
   while (ret == -EINTR);
 }
 
+/****************************************************************************
+ * Name: net_statstaken and net_statsreleased
+ *
+ * Description:
+ *   Account for the global network lock being taken or released by its
+ *   outermost holder.  Both are called while the lock is held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+static inline void net_statstaken(bool contended)
+{
+  g_netlockstats.nlocks++;
+  if (contended)
+    {
+      g_netlockstats.ncontended++;
+    }
+
+  g_netlocktaken = up_cyclecount();
+}
+
+static inline void net_statsreleased(void)
+{
+  uint32_t elapsed = up_cyclecount() - g_netlocktaken;
+
+  g_netlockstats.holdcycles += elapsed;
+  if (elapsed > g_netlockstats.maxhold)
+    {
+      g_netlockstats.maxhold = elapsed;
+    }
+}
+#else
+#  define net_statstaken(c)
+#  define net_statsreleased()
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: net_lockinitialize
+ * Name: net_rmutex_init
  *
  * Description:
- *   Initialize the locking facility
+ *   Initialize a re-entrant network lock.
  *
  ****************************************************************************/
 
-void net_lockinitialize(void)
+void net_rmutex_init(FAR struct net_rmutex_s *lock)
 {
-  nxsem_init(&g_netlock, 0, 1);
+  nxsem_init(&lock->sem, 0, 1);
+  lock->holder = NO_HOLDER;
+  lock->count  = 0;
 }
 
 /****************************************************************************
- * Name: net_lock
+ * Name: net_rmutex_lock
  *
  * Description:
- *   Take the network lock
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   None
+ *   Take a re-entrant network lock, waiting if another thread holds it.
  *
  ****************************************************************************/
 
-void net_lock(void)
+void net_rmutex_lock(FAR struct net_rmutex_s *lock)
 {
   pid_t me = getpid();
 
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  if (lock->holder == me)
     {
       /* Yes.. just increment the reference count */
 
-      g_count++;
+      lock->count++;
     }
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      _net_takesem();
+      _net_takesem(&lock->sem);
 
       /* Now this thread holds the semaphore */
 
-      g_holder = me;
-      g_count  = 1;
+      lock->holder = me;
+      lock->count  = 1;
     }
 }
 
 /****************************************************************************
- * Name: net_unlock
+ * Name: net_rmutex_unlock
  *
  * Description:
- *   Release the network lock.
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   None
+ *   Release one reference to a re-entrant network lock.
  *
  ****************************************************************************/
 
-void net_unlock(void)
+void net_rmutex_unlock(FAR struct net_rmutex_s *lock)
 {
-  DEBUGASSERT(g_holder == getpid() && g_count > 0);
+  DEBUGASSERT(lock->holder == getpid() && lock->count > 0);
 
   /* If the count would go to zero, then release the semaphore */
 
-  if (g_count == 1)
+  if (lock->count == 1)
     {
       /* We no longer hold the semaphore */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      nxsem_post(&g_netlock);
+      lock->holder = NO_HOLDER;
+      lock->count  = 0;
+      nxsem_post(&lock->sem);
     }
   else
     {
       /* We still hold the semaphore. Just decrement the count */
 
-      g_count--;
+      lock->count--;
+    }
+}
+
+/****************************************************************************
+ * Name: net_lockinitialize
+ *
+ * Description:
+ *   Initialize the locking facility
+ *
+ ****************************************************************************/
+
+void net_lockinitialize(void)
+{
+  net_rmutex_init(&g_netlock);
+}
+
+/****************************************************************************
+ * Name: net_lock
+ *
+ * Description:
+ *   Take the network lock
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_lock(void)
+{
+#ifdef CONFIG_NET_LOCK_STATS
+  pid_t holder = g_netlock.holder;
+  pid_t me     = getpid();
+
+  net_rmutex_lock(&g_netlock);
+  if (holder != me)
+    {
+      net_statstaken(holder != NO_HOLDER);
+    }
+#else
+  net_rmutex_lock(&g_netlock);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_unlock
+ *
+ * Description:
+ *   Release the network lock.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_unlock(void)
+{
+  if (g_netlock.count == 1)
+    {
+      net_statsreleased();
     }
+
+  net_rmutex_unlock(&g_netlock);
 }
 
 /****************************************************************************
@@ -216,14 +323,16 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
   flags = enter_critical_section(); /* No interrupts */
   sched_lock();      /* No context switches */
-  if (g_holder == me)
+  if (g_netlock.holder == me)
     {
       /* Release the network lock, remembering my count */
 
-      count    = g_count;
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      nxsem_post(&g_netlock);
+      net_statsreleased();
+
+      count            = g_netlock.count;
+      g_netlock.holder = NO_HOLDER;
+      g_netlock.count  = 0;
+      nxsem_post(&g_netlock.sem);
 
       /* Now take the semaphore, waiting if so requested. */
 
@@ -242,9 +351,11 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
       /* Recover the network lock at the proper count */
 
-      _net_takesem();
-      g_holder = me;
-      g_count  = count;
+      _net_takesem(&g_netlock.sem);
+      g_netlock.holder = me;
+      g_netlock.count  = count;
+
+      net_statstaken(false);
     }
   else
     {
@@ -276,3 +387,36 @@ int net_lockedwait(sem_t *sem)
   return net_timedwait(sem, NULL);
 }
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return the statistics of the network lock and optionally reset them.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics (may be NULL)
+ *   reset - True: Reset the statistics after they have been returned
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats, bool reset)
+{
+  net_lock();
+
+  if (stats != NULL)
+    {
+      memcpy(stats, &g_netlockstats, sizeof(struct net_lockstats_s));
+    }
+
+  if (reset)
+    {
+      memset(&g_netlockstats, 0, sizeof(struct net_lockstats_s));
+    }
+
+  net_unlock();
+}
+#endif
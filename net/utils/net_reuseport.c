@@ -0,0 +1,148 @@
+/****************************************************************************
+ * net/utils/net_reuseport.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_REUSEPORT
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_mix32
+ *
+ * Description:
+ *   Spread the bits of a 32-bit value (the MurmurHash3 finalizer).
+ *
+ ****************************************************************************/
+
+static inline uint32_t net_mix32(uint32_t hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_reuseport_flow
+ *
+ * Description:
+ *   Hash the remote address and the port numbers of a flow.
+ *
+ * Input Parameters:
+ *   addr   - The remote IP address as an array of 16-bit words
+ *   nwords - The number of words in 'addr' (2 for IPv4, 8 for IPv6)
+ *   rport  - The remote port number
+ *   lport  - The local port number
+ *
+ * Returned Value:
+ *   The flow hash
+ *
+ ****************************************************************************/
+
+uint32_t net_reuseport_flow(FAR const uint16_t *addr, int nwords,
+                            uint16_t rport, uint16_t lport)
+{
+  uint32_t hash = (uint32_t)rport << 16 | lport;
+  int i;
+
+  for (i = 0; i < nwords; i += 2)
+    {
+      hash = net_mix32(hash ^ ((uint32_t)addr[i] << 16 | addr[i + 1]));
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: net_reuseport_score
+ *
+ * Description:
+ *   Score one of the sockets that share a port with SO_REUSEPORT for a
+ *   flow.  The flow is given to the socket with the highest score.  As
+ *   with rendezvous hashing, a flow keeps its socket when other sockets
+ *   join or leave the group unless that socket is the one that leaves.
+ *   Under SMP, sockets whose SO_INCOMING_CPU is the current CPU always
+ *   score higher than the others.
+ *
+ * Input Parameters:
+ *   flow - The flow hash from net_reuseport_flow()
+ *   conn - The connection of the socket
+ *   cpu  - The SO_INCOMING_CPU of the socket plus one, zero if none
+ *
+ * Returned Value:
+ *   The non-zero score
+ *
+ ****************************************************************************/
+
+uint32_t net_reuseport_score(uint32_t flow, FAR const void *conn,
+                             uint8_t cpu)
+{
+  uint32_t score;
+
+  score = net_mix32(flow ^ (uint32_t)(uintptr_t)conn);
+  score = (score >> 1) | 1;
+
+#ifdef CONFIG_SMP
+  if (cpu != 0 && cpu - 1 == up_cpu_index())
+    {
+      score |= 0x80000000;
+    }
+#else
+  UNUSED(cpu);
+#endif
+
+  return score;
+}
+
+#endif /* CONFIG_NET_REUSEPORT */
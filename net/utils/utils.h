@@ -41,6 +41,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <semaphore.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
@@ -57,6 +61,19 @@ enum tv2ds_remainder_e
   TV2DS_CEIL       /* Force to next larger full decisecond */
 };
 
+/* A re-entrant lock like the global network lock.  These protect network
+ * data structures that need not be serialized with the rest of the stack
+ * (see net_rmutex_init()).  A thread holding the global network lock may
+ * take such a lock, but not the reverse.
+ */
+
+struct net_rmutex_s
+{
+  sem_t        sem;      /* Provides mutual exclusion */
+  pid_t        holder;   /* The thread holding the lock */
+  unsigned int count;    /* Number of times the holder has taken the lock */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -86,6 +103,19 @@ struct timeval;           /* Forward reference */
 
 void net_lockinitialize(void);
 
+/****************************************************************************
+ * Name: net_rmutex_init, net_rmutex_lock, and net_rmutex_unlock
+ *
+ * Description:
+ *   Initialize, take, and release a re-entrant lock that protects one
+ *   network data structure independently of the global network lock.
+ *
+ ****************************************************************************/
+
+void net_rmutex_init(FAR struct net_rmutex_s *lock);
+void net_rmutex_lock(FAR struct net_rmutex_s *lock);
+void net_rmutex_unlock(FAR struct net_rmutex_s *lock);
+
 /****************************************************************************
  * Name: net_dsec2timeval
  *
@@ -213,6 +243,19 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Architecture-specific summation of the data as 16-bit words in host
+ *   byte order (see CONFIG_NET_ARCH_CHKSUM_PARTIAL).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARCH_CHKSUM_PARTIAL
+uint16_t up_chksum(FAR const uint8_t *data, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -368,6 +411,35 @@ uint16_t icmp_chksum(FAR struct net_driver_s *dev, int len);
 uint16_t icmpv6_chksum(FAR struct net_driver_s *dev);
 #endif
 
+/****************************************************************************
+ * Name: net_reuseport_flow
+ *
+ * Description:
+ *   Hash the remote address (an array of 'nwords' 16-bit words) and the
+ *   port numbers of a flow for SO_REUSEPORT socket selection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+uint32_t net_reuseport_flow(FAR const uint16_t *addr, int nwords,
+                            uint16_t rport, uint16_t lport);
+#endif
+
+/****************************************************************************
+ * Name: net_reuseport_score
+ *
+ * Description:
+ *   Score a socket of an SO_REUSEPORT group for a flow.  The flow is given
+ *   to the socket with the highest score.  'cpu' is the SO_INCOMING_CPU of
+ *   the socket plus one, or zero if none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+uint32_t net_reuseport_score(uint32_t flow, FAR const void *conn,
+                             uint8_t cpu);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -102,6 +102,9 @@ int  clock_abstime2ticks(clockid_t clockid,
 int  clock_time2ticks(FAR const struct timespec *reltime,
                       FAR ssystime_t *ticks);
 int  clock_ticks2time(ssystime_t ticks, FAR struct timespec *reltime);
+#ifdef CONFIG_CLOCK_TIMEPAGE
+void clock_timepage_update(void);
+#endif
 void clock_timespec_add(FAR const struct timespec *ts1,
                         FAR const struct timespec *ts2,
                         FAR struct timespec *ts3);
@@ -49,6 +49,10 @@
 #include <nuttx/arch.h>
 
 #include "clock/clock.h"
+#ifdef CONFIG_SCHED_CPUTIME
+#  include <unistd.h>
+#  include <nuttx/clock.h>
+#endif
 #ifdef CONFIG_CLOCK_TIMEKEEPING
 #  include "clock/clock_timekeeping.h"
 #endif
@@ -186,6 +190,14 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
         }
 #endif /* CONFIG_CLOCK_TIMEKEEPING */
     }
+#ifdef CONFIG_SCHED_CPUTIME
+  else if (clock_id == CLOCK_THREAD_CPUTIME_ID)
+    {
+      /* Return the execution time accumulated by the calling thread */
+
+      ret = clock_cputime(getpid(), tp);
+    }
+#endif
   else
     {
       ret = -EINVAL;
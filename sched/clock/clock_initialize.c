@@ -484,5 +484,11 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  /* Publish the new time to user space */
+
+  clock_timepage_update();
+#endif
 }
 #endif
@@ -130,6 +130,14 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 #else
       ret = clock_timekeeping_set_wall_time(tp);
 #endif
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+      /* Publish the new time of day to user space now rather than on the
+       * next system timer tick.
+       */
+
+      clock_timepage_update();
+#endif
     }
   else
     {
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * sched/clock/clock_timepage.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Update the user-space time page with the current system timer,
+ *   CLOCK_MONOTONIC and CLOCK_REALTIME values.  This is called on each
+ *   system timer tick and whenever the time of day is set.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt or from clock_settime().  The time page
+ *   has a single writer:  Interrupts are disabled here so that the timer
+ *   interrupt cannot nest within an update made by clock_settime().
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(void)
+{
+  FAR struct clock_timepage_s *page = USERSPACE->us_timepage;
+  struct timespec mono;
+  struct timespec real;
+  irqstate_t flags;
+
+  if (page == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  (void)clock_gettime(CLOCK_MONOTONIC, &mono);
+#else
+  (void)clock_systimespec(&mono);
+#endif
+  (void)clock_gettime(CLOCK_REALTIME, &real);
+
+  /* Make the sequence count odd while the page is inconsistent */
+
+  page->tp_seq++;
+  CLOCK_TIMEPAGE_BARRIER();
+
+  page->tp_systimer  = clock_systimer();
+  page->tp_monosec   = mono.tv_sec;
+  page->tp_mononsec  = mono.tv_nsec;
+  page->tp_realsec   = real.tv_sec;
+  page->tp_realnsec  = real.tv_nsec;
+
+  /* And even again when it is consistent */
+
+  CLOCK_TIMEPAGE_BARRIER();
+  page->tp_seq++;
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE */
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_HRTIMER_HRTIMER_H
+#define __SCHED_HRTIMER_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* True if the absolute time 'a' is strictly before the absolute time 'b' */
+
+#define HRTIMER_BEFORE(a,b) \
+  ((a)->tv_sec < (b)->tv_sec || \
+   ((a)->tv_sec == (b)->tv_sec && (a)->tv_nsec < (b)->tv_nsec))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* This is the list of active high resolution timers, ordered by absolute
+ * expiration time.  It is protected by the critical section.
+ */
+
+EXTERN FAR struct hrtimer_s *g_hrtimerlist;
+
+/* Non-zero while hrtimer_process() is running the expiration functions.
+ * The alarm is reprogrammed once when all expired timers have been
+ * processed rather than on each hrtimer_start() or hrtimer_cancel() call
+ * made by the expiration functions.  This is a nesting count because an
+ * expiration function may re-enter hrtimer_process() (for example, via
+ * sched_timer_cancel()); only the outermost call clears it.
+ */
+
+EXTERN uint8_t g_hrtimerbusy;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Remove all timers that have expired at time 'now' from the list of
+ *   active high resolution timers and call their expiration functions.
+ *   Called from the alarm logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(FAR const struct timespec *now);
+
+/****************************************************************************
+ * Name: hrtimer_nextexpiry
+ *
+ * Description:
+ *   Return the absolute expiration time of the next high resolution timer.
+ *   Returns false if no high resolution timer is active.
+ *
+ ****************************************************************************/
+
+bool hrtimer_nextexpiry(FAR struct timespec *ts);
+
+/****************************************************************************
+ * Name: hrtimer_remove
+ *
+ * Description:
+ *   Remove an active timer from the list of active high resolution timers
+ *   and mark it inactive.  Returns true if the timer was at the head of the
+ *   list, i.e., if the alarm must be reassessed.  Called with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+bool hrtimer_remove(FAR struct hrtimer_s *hrtimer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __SCHED_HRTIMER_HRTIMER_H */
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_cancel.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "sched/sched.h"
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_remove
+ *
+ * Description:
+ *   Remove an active timer from the list of active high resolution timers
+ *   and mark it inactive.
+ *
+ * Input Parameters:
+ *   hrtimer - The active high resolution timer to remove
+ *
+ * Returned Value:
+ *   True if the timer was at the head of the list.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool hrtimer_remove(FAR struct hrtimer_s *hrtimer)
+{
+  FAR struct hrtimer_s *prev;
+  FAR struct hrtimer_s *curr;
+  bool head = false;
+
+  for (prev = NULL, curr = g_hrtimerlist;
+       curr != NULL && curr != hrtimer;
+       prev = curr, curr = curr->flink);
+
+  if (curr != NULL)
+    {
+      if (prev == NULL)
+        {
+          g_hrtimerlist = curr->flink;
+          head          = true;
+        }
+      else
+        {
+          prev->flink   = curr->flink;
+        }
+    }
+
+  hrtimer->flink = NULL;
+  hrtimer->func  = NULL;
+  return head;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a high resolution timer.  It is not an error to cancel a timer
+ *   that is not active.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer)
+{
+  irqstate_t flags;
+
+  if (hrtimer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (hrtimer->func != NULL && hrtimer_remove(hrtimer) &&
+      g_hrtimerbusy == 0)
+    {
+      /* The next expiration time has changed.  Reprogram the alarm. */
+
+      sched_alarm_reassess();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_process.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of active high resolution timers, ordered by expiration time */
+
+FAR struct hrtimer_s *g_hrtimerlist;
+
+/* The nesting depth of hrtimer_process() calls */
+
+uint8_t g_hrtimerbusy;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Remove all timers that have expired at time 'now' from the list of
+ *   active high resolution timers and call their expiration functions.
+ *
+ * Input Parameters:
+ *   now - The current time
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the alarm logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(FAR const struct timespec *now)
+{
+  FAR struct hrtimer_s *hrtimer;
+  hrtimer_entry_t func;
+
+  g_hrtimerbusy++;
+
+  /* The expiration function may restart the timer or start or cancel other
+   * timers so the head of the list is re-examined on each pass.
+   */
+
+  while ((hrtimer = g_hrtimerlist) != NULL &&
+         !HRTIMER_BEFORE(now, &hrtimer->expire))
+    {
+      /* Remove the timer from the list and mark it inactive before calling
+       * the expiration function.
+       */
+
+      g_hrtimerlist  = hrtimer->flink;
+      hrtimer->flink = NULL;
+
+      func           = hrtimer->func;
+      hrtimer->func  = NULL;
+
+      func(hrtimer->arg);
+    }
+
+  g_hrtimerbusy--;
+}
+
+/****************************************************************************
+ * Name: hrtimer_nextexpiry
+ *
+ * Description:
+ *   Return the absolute expiration time of the next high resolution timer.
+ *
+ * Input Parameters:
+ *   ts - The location to return the expiration time
+ *
+ * Returned Value:
+ *   True if a high resolution timer is active; false otherwise.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool hrtimer_nextexpiry(FAR struct timespec *ts)
+{
+  FAR struct hrtimer_s *hrtimer = g_hrtimerlist;
+
+  if (hrtimer == NULL)
+    {
+      return false;
+    }
+
+  ts->tv_sec  = hrtimer->expire.tv_sec;
+  ts->tv_nsec = hrtimer->expire.tv_nsec;
+  return true;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_start.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/hrtimer.h>
+
+#include "sched/sched.h"
+#include "clock/clock.h"
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a high resolution timer.  'func' will be called
+ *   from the alarm interrupt handler once 'delay' has elapsed.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer to start
+ *   delay   - The delay relative to the current time
+ *   func    - The function to call on expiration
+ *   arg     - The argument to pass to 'func'
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer,
+                  FAR const struct timespec *delay,
+                  hrtimer_entry_t func, FAR void *arg)
+{
+  FAR struct hrtimer_s *prev;
+  FAR struct hrtimer_s *curr;
+  struct timespec now;
+  irqstate_t flags;
+  bool reassess = false;
+
+  if (hrtimer == NULL || delay == NULL || func == NULL ||
+      delay->tv_sec < 0 || delay->tv_nsec < 0 ||
+      delay->tv_nsec >= NSEC_PER_SEC)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  /* Remove the timer from the active list if it was already started */
+
+  if (hrtimer->func != NULL)
+    {
+      reassess = hrtimer_remove(hrtimer);
+    }
+
+  /* Convert the delay to an absolute time in the time base of the alarm */
+
+  (void)up_timer_gettime(&now);
+  clock_timespec_add(&now, delay, &hrtimer->expire);
+
+  hrtimer->func = func;
+  hrtimer->arg  = arg;
+
+  /* Insert the timer after all timers that expire at the same time or
+   * earlier.
+   */
+
+  for (prev = NULL, curr = g_hrtimerlist;
+       curr != NULL && !HRTIMER_BEFORE(&hrtimer->expire, &curr->expire);
+       prev = curr, curr = curr->flink);
+
+  hrtimer->flink = curr;
+  if (prev == NULL)
+    {
+      g_hrtimerlist = hrtimer;
+      reassess      = true;
+    }
+  else
+    {
+      prev->flink   = hrtimer;
+    }
+
+  /* Reprogram the alarm if the next expiration time has changed */
+
+  if (reassess && g_hrtimerbusy == 0)
+    {
+      sched_alarm_reassess();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * sched/init/os_bootprof.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <syslog.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+
+#ifdef CONFIG_BOOT_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_BOOT_PROFILE_NMARKS
+#  define CONFIG_BOOT_PROFILE_NMARKS 32
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry in the boot log */
+
+struct boot_mark_s
+{
+  FAR const char *name;  /* Phase or operation */
+  uint32_t end;          /* Time at the end (usec) */
+  uint32_t span;         /* Duration of an operation, zero for a phase */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct boot_mark_s g_bootlog[CONFIG_BOOT_PROFILE_NMARKS];
+static uint8_t g_bootnmarks;    /* Number of entries in g_bootlog */
+static uint8_t g_bootlost;      /* Number of entries that did not fit */
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+static uint64_t g_bootcycles;   /* Cycles since the first call */
+static uint32_t g_bootlast;     /* up_cyclecount() at the last call */
+static bool g_bootstarted;      /* True after the first call */
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boot_record
+ ****************************************************************************/
+
+static void boot_record(FAR const char *name, uint64_t end, uint64_t span)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (g_bootnmarks < CONFIG_BOOT_PROFILE_NMARKS)
+    {
+      g_bootlog[g_bootnmarks].name = name;
+      g_bootlog[g_bootnmarks].end  = (uint32_t)end;
+      g_bootlog[g_bootnmarks].span = (uint32_t)span;
+      g_bootnmarks++;
+    }
+  else if (g_bootlost < UINT8_MAX)
+    {
+      g_bootlost++;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boot_elapsed
+ *
+ * Description:
+ *   Return the time in microseconds since the first boot profiling call.
+ *   The 32-bit cycle counter is accumulated on each call, so calls must
+ *   not be further apart than one wrap of the counter.  Before the system
+ *   timer runs, the fallback clock reads zero.
+ *
+ ****************************************************************************/
+
+uint64_t boot_elapsed(void)
+{
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNT
+  irqstate_t flags;
+  uint32_t now;
+  uint64_t cycles;
+
+  flags = enter_critical_section();
+  now   = up_cyclecount();
+
+  if (!g_bootstarted)
+    {
+      g_bootstarted = true;
+      g_bootlast    = now;
+    }
+
+  g_bootcycles += now - g_bootlast;
+  g_bootlast    = now;
+  cycles        = g_bootcycles;
+  leave_critical_section(flags);
+
+  return cycles / (up_cyclefreq() / 1000000);
+#else
+  return (uint64_t)clock_systimer() * USEC_PER_TICK;
+#endif
+}
+
+/****************************************************************************
+ * Name: boot_mark
+ *
+ * Description:
+ *   Record the end of the boot phase 'name' in the boot log.
+ *
+ ****************************************************************************/
+
+void boot_mark(FAR const char *name)
+{
+  boot_record(name, boot_elapsed(), 0);
+}
+
+/****************************************************************************
+ * Name: boot_span
+ *
+ * Description:
+ *   Record an operation 'name' that started at time 'start'.
+ *
+ ****************************************************************************/
+
+void boot_span(FAR const char *name, uint64_t start)
+{
+  uint64_t end = boot_elapsed();
+
+  /* A zero span marks a phase, so report at least one microsecond */
+
+  boot_record(name, end, end > start ? end - start : 1);
+}
+
+/****************************************************************************
+ * Name: boot_dump
+ *
+ * Description:
+ *   Send the boot log to the SYSLOG.  Each phase is shown with the time
+ *   since the previous phase; operations are shown with their duration.
+ *
+ ****************************************************************************/
+
+void boot_dump(void)
+{
+  FAR struct boot_mark_s *mark;
+  uint32_t prev = 0;
+  int i;
+
+  syslog(LOG_INFO, "boot:     end usec   phase usec  name\n");
+
+  for (i = 0; i < g_bootnmarks; i++)
+    {
+      mark = &g_bootlog[i];
+      if (mark->span > 0)
+        {
+          syslog(LOG_INFO, "boot: %12lu %12lu  [%s]\n",
+                 (unsigned long)mark->end, (unsigned long)mark->span,
+                 mark->name);
+        }
+      else
+        {
+          syslog(LOG_INFO, "boot: %12lu %12lu  %s\n",
+                 (unsigned long)mark->end,
+                 (unsigned long)(mark->end - prev), mark->name);
+          prev = mark->end;
+        }
+    }
+
+  if (g_bootlost > 0)
+    {
+      syslog(LOG_INFO, "boot: %u entries lost\n", g_bootlost);
+    }
+}
+
+#endif /* CONFIG_BOOT_PROFILE */
@@ -60,6 +60,9 @@
 #endif
 # include "wqueue/wqueue.h"
 # include "init/init.h"
+#ifdef CONFIG_STACK_MONITOR
+# include "sched/sched.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -212,6 +215,8 @@ static inline void os_workqueues(void)
   DEBUGASSERT(pid > 0);
   UNUSED(pid);
 #endif
+
+  boot_mark("workqueues");
 }
 
 #else /* CONFIG_SCHED_WORKQUEUE */
@@ -245,6 +250,7 @@ static inline void os_do_appstart(void)
    */
 
   board_initialize();
+  boot_mark("board");
 #endif
 
   /* Start the application initialization task.  In a flat build, this is
@@ -281,6 +287,7 @@ static inline void os_do_appstart(void)
    */
 
   board_initialize();
+  boot_mark("board");
 #endif
 
   /* Start the application initialization program from a program in a
@@ -303,6 +310,34 @@ static inline void os_do_appstart(void)
 
 #endif
 
+/****************************************************************************
+ * Name: os_app_started
+ *
+ * Description:
+ *   Called after the application initialization thread has been started.
+ *   Start the deferred initializers which then run concurrently with the
+ *   application.  The boot log is dumped when the last one completes or,
+ *   if there are no deferred initializers, now.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void os_app_started(void)
+{
+  boot_mark("appstart");
+
+#ifdef CONFIG_DEFERRED_INIT
+  deferred_init_start();
+#else
+  boot_dump();
+#endif
+}
+
 /****************************************************************************
  * Name: os_start_task
  *
@@ -325,6 +360,7 @@ static int os_start_task(int argc, FAR char **argv)
   /* Do the board/application initialization and exit */
 
   os_do_appstart();
+  os_app_started();
   return OK;
 }
 #endif
@@ -364,6 +400,7 @@ static inline void os_start_application(void)
   /* Do the board/application initialization on this thread of execution. */
 
   os_do_appstart();
+  os_app_started();
 
 #endif
 }
@@ -432,6 +469,12 @@ int os_bringup(void)
 
   os_workqueues();
 
+#ifdef CONFIG_STACK_MONITOR
+  /* Start watching the stack high-water marks */
+
+  sched_stackmon_start();
+#endif
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
@@ -0,0 +1,398 @@
+/****************************************************************************
+ * sched/init/os_deferred.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/init.h>
+
+#ifdef CONFIG_DEFERRED_INIT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The work queue that runs the initializers.  Several initializers run at
+ * the same time only if the queue has several threads.
+ */
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define DEFERRED_WORK LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define DEFERRED_WORK HPWORK
+#else
+#  error Deferred initialization requires a work queue
+#endif
+
+/* Values of struct deferred_init_s::state */
+
+#define DEFERRED_WAITING  0  /* Waiting for its dependencies */
+#define DEFERRED_QUEUED   1  /* Queued or running */
+#define DEFERRED_DONE     2  /* Completed; 'result' is valid */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_deferlock = SEM_INITIALIZER(1);  /* Protects the list */
+static sem_t g_deferwait = SEM_INITIALIZER(0);  /* Wakes up waiters */
+static FAR struct deferred_init_s *g_deferlist; /* Registered initializers */
+static uint16_t g_deferpending;                 /* Not yet DONE */
+static uint16_t g_deferqueued;                  /* In state QUEUED */
+static uint16_t g_deferwaiters;                 /* Threads waiting */
+static bool g_deferstarted;                     /* Initializers may run */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deferred_lock and deferred_unlock
+ ****************************************************************************/
+
+static void deferred_lock(void)
+{
+  while (nxsem_wait(&g_deferlock) < 0);
+}
+
+static void deferred_unlock(void)
+{
+  (void)nxsem_post(&g_deferlock);
+}
+
+/****************************************************************************
+ * Name: deferred_find
+ ****************************************************************************/
+
+static FAR struct deferred_init_s *deferred_find(FAR const char *name)
+{
+  FAR struct deferred_init_s *entry;
+
+  for (entry = g_deferlist; entry != NULL; entry = entry->flink)
+    {
+      if (strcmp(entry->name, name) == 0)
+        {
+          break;
+        }
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: deferred_complete
+ *
+ * Description:
+ *   Mark an initializer as done.  The caller holds the lock.
+ *
+ ****************************************************************************/
+
+static void deferred_complete(FAR struct deferred_init_s *entry, int result)
+{
+  entry->state  = DEFERRED_DONE;
+  entry->result = result;
+  g_deferpending--;
+
+  if (result < 0 && result != -ECANCELED)
+    {
+      serr("ERROR: Deferred initializer %s failed: %d\n", entry->name,
+           result);
+    }
+}
+
+/****************************************************************************
+ * Name: deferred_worker
+ *
+ * Description:
+ *   Run one initializer on the work queue, then start the initializers
+ *   that were waiting for it.
+ *
+ ****************************************************************************/
+
+static void deferred_schedule(void);
+
+static void deferred_worker(FAR void *arg)
+{
+  FAR struct deferred_init_s *entry = (FAR struct deferred_init_s *)arg;
+  int result;
+
+  entry->start = boot_elapsed();
+  result = entry->init(entry->arg);
+  boot_span(entry->name, entry->start);
+
+  deferred_lock();
+  g_deferqueued--;
+  deferred_complete(entry, result);
+  deferred_schedule();
+  deferred_unlock();
+}
+
+/****************************************************************************
+ * Name: deferred_schedule
+ *
+ * Description:
+ *   Queue every waiting initializer whose dependencies have completed and
+ *   cancel those with a failed dependency.  Names that are not registered
+ *   are ignored.  If nothing can make progress, the remaining initializers
+ *   have circular dependencies and are cancelled.  Waiters are woken up
+ *   and, when the last initializer is done, the boot log is dumped.  The
+ *   caller holds the lock.
+ *
+ ****************************************************************************/
+
+static void deferred_schedule(void)
+{
+  FAR struct deferred_init_s *entry;
+  FAR struct deferred_init_s *dep;
+  FAR const char * const *name;
+  bool changed;
+  bool ready;
+  int result;
+
+  if (!g_deferstarted)
+    {
+      return;
+    }
+
+  do
+    {
+      changed = false;
+
+      for (entry = g_deferlist; entry != NULL; entry = entry->flink)
+        {
+          if (entry->state != DEFERRED_WAITING)
+            {
+              continue;
+            }
+
+          ready  = true;
+          result = OK;
+
+          for (name = entry->depends; name != NULL && *name != NULL; name++)
+            {
+              dep = deferred_find(*name);
+              if (dep == NULL)
+                {
+                  continue;
+                }
+
+              if (dep->state != DEFERRED_DONE)
+                {
+                  ready = false;
+                }
+              else if (dep->result < 0)
+                {
+                  result = -ECANCELED;
+                }
+            }
+
+          if (result < 0)
+            {
+              deferred_complete(entry, result);
+              changed = true;
+            }
+          else if (ready)
+            {
+              entry->state = DEFERRED_QUEUED;
+              g_deferqueued++;
+              (void)work_queue(DEFERRED_WORK, &entry->work, deferred_worker,
+                               entry, 0);
+            }
+        }
+
+      /* Nothing queued or running but initializers still waiting means
+       * that they wait for each other.
+       */
+
+      if (!changed && g_deferqueued == 0 && g_deferpending > 0)
+        {
+          for (entry = g_deferlist; entry != NULL; entry = entry->flink)
+            {
+              if (entry->state == DEFERRED_WAITING)
+                {
+                  serr("ERROR: %s has circular dependencies\n", entry->name);
+                  deferred_complete(entry, -ELOOP);
+                  changed = true;
+                }
+            }
+        }
+    }
+  while (changed);
+
+  if (g_deferpending == 0)
+    {
+      boot_dump();
+    }
+
+  /* Let the waiters check the state again */
+
+  while (g_deferwaiters > 0)
+    {
+      g_deferwaiters--;
+      (void)nxsem_post(&g_deferwait);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deferred_init_register
+ *
+ * Description:
+ *   Register a deferred initializer.  See include/nuttx/init.h.
+ *
+ ****************************************************************************/
+
+int deferred_init_register(FAR struct deferred_init_s *entry)
+{
+  DEBUGASSERT(entry != NULL && entry->name != NULL && entry->init != NULL);
+
+  deferred_lock();
+
+  if (deferred_find(entry->name) != NULL)
+    {
+      deferred_unlock();
+      return -EEXIST;
+    }
+
+  entry->state  = DEFERRED_WAITING;
+  entry->result = OK;
+  memset(&entry->work, 0, sizeof(struct work_s));
+
+  entry->flink  = g_deferlist;
+  g_deferlist   = entry;
+  g_deferpending++;
+
+  /* Run it now if the initializers have already been started */
+
+  deferred_schedule();
+  deferred_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: deferred_init_wait
+ *
+ * Description:
+ *   Wait for a deferred initializer or for all of them.  See
+ *   include/nuttx/init.h.
+ *
+ ****************************************************************************/
+
+int deferred_init_wait(FAR const char *name)
+{
+  FAR struct deferred_init_s *entry;
+  int ret;
+
+  deferred_lock();
+
+  for (; ; )
+    {
+      if (name == NULL)
+        {
+          if (g_deferstarted && g_deferpending == 0)
+            {
+              ret = OK;
+              break;
+            }
+        }
+      else
+        {
+          entry = deferred_find(name);
+          if (entry == NULL)
+            {
+              ret = -ENOENT;
+              break;
+            }
+
+          if (entry->state == DEFERRED_DONE)
+            {
+              ret = entry->result;
+              break;
+            }
+        }
+
+      g_deferwaiters++;
+      deferred_unlock();
+
+      ret = nxsem_wait(&g_deferwait);
+
+      deferred_lock();
+      if (ret < 0)
+        {
+          /* Interrupted: Give up our claim on a future post */
+
+          if (g_deferwaiters > 0)
+            {
+              g_deferwaiters--;
+            }
+
+          break;
+        }
+    }
+
+  deferred_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: deferred_init_start
+ *
+ * Description:
+ *   Start the registered initializers.
+ *
+ ****************************************************************************/
+
+void deferred_init_start(void)
+{
+  deferred_lock();
+  g_deferstarted = true;
+  deferred_schedule();
+  deferred_unlock();
+}
+
+#endif /* CONFIG_DEFERRED_INIT */
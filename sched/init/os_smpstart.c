@@ -163,6 +163,12 @@ int os_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SCHED_LOADBALANCE
+      /* Pull waiting work from the busiest CPU if this CPU is idle */
+
+      sched_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
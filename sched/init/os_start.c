@@ -428,7 +428,9 @@ void os_start(void)
   for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++, g_lastpid++)
 #endif
     {
+#ifndef CONFIG_SCHED_READYTORUN_BITMAP
       FAR dq_queue_t *tasklist;
+#endif
       int hashndx;
 
       /* Assign the process ID(s) of ZERO to the idle task(s) */
@@ -522,12 +524,16 @@ void os_start(void)
        * run list.
        */
 
+#if defined(CONFIG_SCHED_READYTORUN_BITMAP)
+      (void)sched_rtradd(&g_idletcb[cpu].cmn);
+#else
 #ifdef CONFIG_SMP
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING, cpu);
 #else
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
 #endif
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+#endif
 
       /* Initialize the processor-specific portion of the TCB */
 
@@ -537,6 +543,7 @@ void os_start(void)
   /* Task lists are initialized */
 
   g_os_initstate = OSINIT_TASKLISTS;
+  boot_mark("tasklists");
 
   /* Initialize RTOS facilities *********************************************/
   /* Initialize the semaphore facility.  This has to be done very early
@@ -545,6 +552,12 @@ void os_start(void)
 
   nxsem_initialize();
 
+#ifdef CONFIG_SCHED_TCBPOOL
+  /* Initialize the pool of pre-allocated TCBs and stacks */
+
+  sched_tcbpool_initialize();
+#endif
+
 #if defined(MM_KERNEL_USRHEAP_INIT) || defined(CONFIG_MM_KERNEL_HEAP) || \
     defined(CONFIG_MM_PGALLOC)
   /* Initialize the memory manager */
@@ -586,6 +599,7 @@ void os_start(void)
   /* The memory manager is available */
 
   g_os_initstate = OSINIT_MEMORY;
+  boot_mark("memory");
 
 #if defined(CONFIG_SCHED_HAVE_PARENT) && defined(CONFIG_SCHED_CHILD_STATUS)
   /* Initialize tasking data structures */
@@ -671,6 +685,7 @@ void os_start(void)
   /* Initialize the file system (needed to support device drivers) */
 
   fs_initialize();
+  boot_mark("fs");
 #endif
 
 #ifdef CONFIG_NET
@@ -696,6 +711,7 @@ void os_start(void)
   /* Hardware resources are available */
 
   g_os_initstate = OSINIT_HARDWARE;
+  boot_mark("hardware");
 
 #ifdef CONFIG_NET
   /* Complete initialization the networking system now that interrupts
@@ -703,6 +719,7 @@ void os_start(void)
    */
 
   net_initialize();
+  boot_mark("net");
 #endif
 
 #ifdef CONFIG_MM_SHM
@@ -716,6 +733,7 @@ void os_start(void)
    */
 
   lib_initialize();
+  boot_mark("lib");
 
   /* IDLE Group Initialization **********************************************/
   /* Announce that the CPU0 IDLE task has started */
@@ -795,6 +813,7 @@ void os_start(void)
   /* The OS is fully initialized and we are beginning multi-tasking */
 
   g_os_initstate = OSINIT_OSREADY;
+  boot_mark("osready");
 
   /* Create initial tasks and bring-up the system */
 
@@ -839,6 +858,12 @@ void os_start(void)
         }
 #endif
 
+#ifdef CONFIG_SCHED_LOADBALANCE
+      /* Pull waiting work from the busiest CPU if this CPU is idle */
+
+      sched_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -64,6 +64,15 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+/* Number of interrupt duration histogram buckets.  Bucket n counts the
+ * handlers that ran for less than 2^n microseconds (the last bucket counts
+ * all of the longer ones).
+ */
+
+#  define IRQ_NHISTOGRAM 8
+#endif
+
 /* This is the type of the list of interrupt handlers, one for each IRQ.
  * This type provided all of the information necessary to irq_dispatch to
  * transfer control to interrupt handlers after the occurrence of an
@@ -82,6 +91,26 @@ struct irq_info_s
   uint32_t mscount;  /* Number of interrupts on this IRQ (MS) */
   uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
 #endif
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  struct
+  {
+    uint32_t max;      /* Longest handler duration (cycles) */
+#ifdef CONFIG_HAVE_LONG_LONG
+    uint64_t total;    /* Sum of the handler durations (cycles) */
+#else
+    uint32_t total;    /* Sum of the handler durations (cycles) */
+#endif
+#ifdef CONFIG_ARCH_HAVE_IRQTIMESTAMP
+    uint32_t latmax;   /* Longest entry latency (cycles) */
+#ifdef CONFIG_HAVE_LONG_LONG
+    uint64_t lattotal; /* Sum of the entry latencies (cycles) */
+#else
+    uint32_t lattotal; /* Sum of the entry latencies (cycles) */
+#endif
+#endif
+    uint32_t hist[IRQ_NHISTOGRAM]; /* Histogram of the handler durations */
+  } timing;
+#endif
 #endif
 };
 
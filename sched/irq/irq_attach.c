@@ -40,10 +40,12 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <errno.h>
 
 #include <nuttx/irq.h>
 
+#include "sched/sched.h"
 #include "irq/irq.h"
 
 /****************************************************************************
@@ -111,6 +113,14 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
           isr = irq_unexpected_isr;
           arg = NULL;
         }
+#if defined(CONFIG_SMP_ISOLCPUS) && defined(CONFIG_ARCH_HAVE_IRQAFFINITY)
+      else
+        {
+          /* Do not route the interrupt to the isolated CPUs */
+
+          (void)up_affinity_irq(irq, SCHED_HOUSEKEEPING_CPUS);
+        }
+#endif
 
       /* Save the new ISR and its argument in the table. */
 
@@ -124,6 +134,9 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
       g_irqvector[ndx].mscount = 0;
       g_irqvector[ndx].lscount = 0;
 #endif
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+      memset(&g_irqvector[ndx].timing, 0, sizeof(g_irqvector[ndx].timing));
+#endif
 #endif
 
       leave_critical_section(flags);
@@ -49,7 +49,8 @@
 #include "sched/sched.h"
 #include "irq/irq.h"
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Data
@@ -375,6 +376,11 @@ try_again:
                           &g_cpu_irqlock);
               rtcb->irqcount = 1;
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+              /* Start timing the critical section */
+
+              sched_critmon_csection(rtcb, true, CRITMON_CALLER);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
               /* Note that we have entered the critical section */
 
@@ -388,7 +394,7 @@ try_again:
 
   return ret;
 }
-#else /* defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) */
+#else /* CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
 irqstate_t enter_critical_section(void)
 {
   irqstate_t ret;
@@ -406,9 +412,20 @@ irqstate_t enter_critical_section(void)
       FAR struct tcb_s *rtcb = this_task();
       DEBUGASSERT(rtcb != NULL);
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start timing if this is the outermost critical section */
+
+      if (rtcb->irqcount++ == 0)
+        {
+          sched_critmon_csection(rtcb, true, CRITMON_CALLER);
+        }
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
       /* Yes.. Note that we have entered the critical section */
 
       sched_note_csection(rtcb, true);
+#endif
     }
 
   /* Return interrupt status */
@@ -511,6 +528,11 @@ void leave_critical_section(irqstate_t flags)
               /* No.. Note that we have left the critical section */
 
               sched_note_csection(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+              /* Record the duration of the critical section */
+
+              sched_critmon_csection(rtcb, false, NULL);
 #endif
               /* Decrement our count on the lock.  If all CPUs have
                * released, then unlock the spinlock.
@@ -563,7 +585,7 @@ void leave_critical_section(irqstate_t flags)
 
   up_irq_restore(flags);
 }
-#else /* defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) */
+#else /* CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
 void leave_critical_section(irqstate_t flags)
 {
   /* Check if we were called from an interrupt handler and that the tasks
@@ -575,9 +597,20 @@ void leave_critical_section(irqstate_t flags)
       FAR struct tcb_s *rtcb = this_task();
       DEBUGASSERT(rtcb != NULL);
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
       /* Yes.. Note that we have left the critical section */
 
       sched_note_csection(rtcb, false);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Record the duration if this is the outermost critical section */
+
+      if (rtcb->irqcount > 0 && --rtcb->irqcount == 0)
+        {
+          sched_critmon_csection(rtcb, false, NULL);
+        }
+#endif
     }
 
   /* Restore the previous interrupt state. */
@@ -669,4 +702,5 @@ bool irq_cpu_locked(int cpu)
 }
 #endif
 
-#endif /* CONFIG_SMP || CONFIG_SCHED_INSTRUMENTATION_CSECTION */
+#endif /* CONFIG_SMP || CONFIG_SCHED_INSTRUMENTATION_CSECTION ||
+        * CONFIG_SCHED_CRITMONITOR */
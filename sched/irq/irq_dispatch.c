@@ -73,6 +73,80 @@
 #  define INCR_COUNT(ndx)
 #endif
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+/* The number of cycle counter cycles in one microsecond.  This is the
+ * limit of the first histogram bucket.
+ */
+
+static uint32_t g_irq_usec_cycles;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_timing
+ *
+ * Description:
+ *   Accumulate the duration (and the entry latency) of one interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+static inline void irq_timing(FAR struct irq_info_s *info, uint32_t start)
+{
+  uint32_t elapsed = up_cyclecount() - start;
+  uint32_t limit;
+  int bucket;
+
+  if (elapsed > info->timing.max)
+    {
+      info->timing.max = elapsed;
+    }
+
+  info->timing.total += elapsed;
+
+#ifdef CONFIG_ARCH_HAVE_IRQTIMESTAMP
+  limit = start - up_irq_entrycycles();
+  if (limit > info->timing.latmax)
+    {
+      info->timing.latmax = limit;
+    }
+
+  info->timing.lattotal += limit;
+#endif
+
+  /* Find the histogram bucket: the bucket limits double starting at one
+   * microsecond.
+   */
+
+  limit = g_irq_usec_cycles;
+  if (limit == 0)
+    {
+      limit = up_cyclefreq() / 1000000;
+      if (limit == 0)
+        {
+          limit = 1;
+        }
+
+      g_irq_usec_cycles = limit;
+    }
+
+  for (bucket = 0; bucket < IRQ_NHISTOGRAM - 1 && elapsed >= limit; bucket++)
+    {
+      limit <<= 1;
+    }
+
+  info->timing.hist[bucket]++;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -91,6 +165,10 @@ void irq_dispatch(int irq, FAR void *context)
 {
   xcpt_t vector;
   FAR void *arg;
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  FAR struct irq_info_s *info = NULL;
+  uint32_t start = up_cyclecount();
+#endif
 
   /* Perform some sanity checks */
 
@@ -114,11 +192,17 @@ void irq_dispatch(int irq, FAR void *context)
           vector = g_irqvector[ndx].handler;
           arg    = g_irqvector[ndx].arg;
           INCR_COUNT(ndx);
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+          info   = &g_irqvector[ndx];
+#endif
         }
 #else
       vector = g_irqvector[irq].handler;
       arg    = g_irqvector[irq].arg;
       INCR_COUNT(irq);
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+      info   = &g_irqvector[irq];
+#endif
 #endif
     }
 #else
@@ -135,4 +219,11 @@ void irq_dispatch(int irq, FAR void *context)
   /* Then dispatch to the interrupt handler */
 
   vector(irq, context, arg);
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  if (info != NULL)
+    {
+      irq_timing(info, start);
+    }
+#endif
 }
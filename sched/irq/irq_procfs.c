@@ -46,6 +46,7 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -69,17 +70,39 @@
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
+ *
+ * With CONFIG_SCHED_IRQMONITOR_TIMING, each line is followed by the maximum
+ * and average handler duration (and entry latency, if the architecture can
+ * timestamp the exception) in microseconds, then by the duration histogram
+ * (<1, <2, <4, ... <64, >=64 microseconds).
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu\n"
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+#  ifdef CONFIG_ARCH_HAVE_IRQTIMESTAMP
+#    define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TMAX   TAVG" \
+                    "    LMAX   LAVG HISTOGRAM\n"
+#  else
+#    define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TMAX   TAVG" \
+                    " HISTOGRAM\n"
+#  endif
+#  define IRQ_FMT   "%3u %08lx %08lx %10lu %4lu.%03lu"
+#  define TIME_FMT  " %7lu %6lu"
+#  define HIST_FMT  " %lu"
+#else
+#  define HDR_FMT   "IRQ HANDLER  ARGUMENT    COUNT    RATE\n"
+#  define IRQ_FMT   "%3u %08lx %08lx %10lu %4lu.%03lu\n"
+#endif
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 44
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+#  define IRQ_LINELEN (44 + 2 * 16 + 11 * IRQ_NHISTOGRAM)
+#else
+#  define IRQ_LINELEN 44
+#endif
 
 /****************************************************************************
  * Private Types
@@ -147,6 +170,24 @@ const struct procfs_operations irq_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: irq_cycles2usec
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+static unsigned long irq_cycles2usec(uint64_t cycles)
+{
+  uint32_t freq = up_cyclefreq();
+
+  if (freq == 0)
+    {
+      return 0;
+    }
+
+  return (unsigned long)((cycles * 1000000) / freq);
+}
+#endif
+
 /****************************************************************************
  * Name: irq_callback
  ****************************************************************************/
@@ -164,6 +205,9 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  int i;
+#endif
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -178,6 +222,9 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
 #else
   info->mscount = 0;
   info->lscount = 0;
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  memset(&info->timing, 0, sizeof(info->timing));
 #endif
   leave_critical_section(flags);
 
@@ -253,6 +300,29 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart);
 
+#ifdef CONFIG_SCHED_IRQMONITOR_TIMING
+  /* Append the handler timing and the histogram */
+
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       TIME_FMT, irq_cycles2usec(copy.timing.max),
+                       irq_cycles2usec(copy.timing.total / copy.count));
+#ifdef CONFIG_ARCH_HAVE_IRQTIMESTAMP
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       TIME_FMT, irq_cycles2usec(copy.timing.latmax),
+                       irq_cycles2usec(copy.timing.lattotal / copy.count));
+#endif
+
+  for (i = 0; i < IRQ_NHISTOGRAM; i++)
+    {
+      linesize += snprintf(&irqfile->line[linesize],
+                           IRQ_LINELEN - linesize, HIST_FMT,
+                           (unsigned long)copy.timing.hist[i]);
+    }
+
+  linesize += snprintf(&irqfile->line[linesize], IRQ_LINELEN - linesize,
+                       "\n");
+#endif
+
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
 
@@ -0,0 +1,157 @@
+/****************************************************************************
+ * sched/irq/irq_subsyslock.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: subsys_lock
+ *
+ * Description:
+ *   Disable local interrupts and take the subsystem spinlock 'lock'.  The
+ *   lock may be taken recursively by the CPU that holds it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the subsystem lock
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to subsys_lock();
+ *
+ ****************************************************************************/
+
+irqstate_t subsys_lock(FAR struct subsys_lock_s *lock)
+{
+  irqstate_t flags;
+  int me;
+
+  DEBUGASSERT(lock != NULL);
+
+  /* Disable local interrupts first so that we cannot be moved to a
+   * different CPU and so that the lock cannot be re-entered by an interrupt
+   * handler on this CPU while it is being taken.
+   */
+
+  flags = up_irq_save();
+  me    = this_cpu();
+
+  /* Do we already hold the lock? */
+
+  if (lock->sl_count == 0 || lock->sl_cpu != me)
+    {
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+      uint32_t spins = 0;
+
+      /* Try once to take the lock.  If that fails, then the lock is
+       * contended and we will have to spin until it becomes available.
+       */
+
+      while (up_testset(&lock->sl_lock) == SP_LOCKED)
+        {
+          spins++;
+          SP_DSB();
+        }
+
+      SP_DMB();
+
+      /* The statistics are protected by the lock itself */
+
+      lock->sl_acquired++;
+      if (spins > 0)
+        {
+          lock->sl_contended++;
+          lock->sl_spins += spins;
+        }
+#else
+      spin_lock(&lock->sl_lock);
+#endif
+
+      lock->sl_cpu = me;
+    }
+
+  lock->sl_count++;
+  DEBUGASSERT(lock->sl_count != 0);
+  return flags;
+}
+
+/****************************************************************************
+ * Name: subsys_unlock
+ *
+ * Description:
+ *   Release one count on the subsystem spinlock 'lock'.  When the count
+ *   decrements to zero, the spinlock is released and the interrupt state
+ *   is restored to the state prior to the matching call to subsys_lock().
+ *
+ * Input Parameters:
+ *   lock  - A reference to the subsystem lock
+ *   flags - The value returned by the matching call to subsys_lock()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void subsys_unlock(FAR struct subsys_lock_s *lock, irqstate_t flags)
+{
+  DEBUGASSERT(lock != NULL && lock->sl_count > 0 &&
+              lock->sl_cpu == this_cpu());
+
+  if (--lock->sl_count == 0)
+    {
+      spin_unlock(&lock->sl_lock);
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SPINLOCK_SUBSYS */
@@ -61,18 +61,18 @@ struct mq_des_block_s
  * Public Data
  ****************************************************************************/
 
-/* The g_msgfree is a list of messages that are available for general
- * use.  The number of messages in this list is a system configuration
- * item.
+/* The g_msgpool is the pool of pre-allocated messages.  The number of
+ * messages for general use is a system configuration item.  Another
+ * NUM_INTERRUPT_MSGS messages are held in reserve for interrupt handlers.
  */
 
-sq_queue_t  g_msgfree;
+struct mempool_s g_msgpool;
 
-/* The g_msgfreeInt is a list of messages that are reserved for use by
- * interrupt handlers.
- */
+#ifdef CONFIG_SPINLOCK_SUBSYS
+/* This spinlock protects the msgfree list of each message queue */
 
-sq_queue_t  g_msgfreeirq;
+struct subsys_lock_s g_mqlock SP_SECTION = SUBSYS_LOCK_INITIALIZER("mqueue");
+#endif
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -85,18 +85,6 @@ sq_queue_t  g_desfree;
  * Private Data
  ****************************************************************************/
 
-/* g_msgalloc is a pointer to the start of the allocated block of
- * messages.
- */
-
-static struct mqueue_msg_s  *g_msgalloc;
-
-/* g_msgfreeirqalloc is a pointer to the start of the allocated block of
- * messages.
- */
-
-static struct mqueue_msg_s  *g_msgfreeirqalloc;
-
 /* g_desalloc is a list of allocated block of message queue descriptors. */
 
 static sq_queue_t g_desalloc;
@@ -106,42 +94,17 @@ static sq_queue_t g_desalloc;
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mq_msgblockalloc
+ * Name: mq_msgctor
  *
  * Description:
- *   Allocate a block of messages and place them on the free list.
- *
- * Input Parameters:
- *  queue
+ *   Mark each pre-allocated message so that it is returned to the pool
+ *   when it is freed.
  *
  ****************************************************************************/
 
-static struct mqueue_msg_s *
-mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nmsgs,
-                 uint8_t alloc_type)
+static void mq_msgctor(FAR void *obj, FAR void *arg)
 {
-  struct mqueue_msg_s *mqmsgblock;
-
-  /* The g_msgfree must be loaded at initialization time to hold the
-   * configured number of messages.
-   */
-
-  mqmsgblock = (FAR struct mqueue_msg_s *)
-    kmm_malloc(sizeof(struct mqueue_msg_s) * nmsgs);
-
-  if (mqmsgblock)
-    {
-      struct mqueue_msg_s *mqmsg = mqmsgblock;
-      int      i;
-
-      for (i = 0; i < nmsgs; i++)
-        {
-          mqmsg->type = alloc_type;
-          sq_addlast((FAR sq_entry_t *)mqmsg++, queue);
-        }
-    }
-
-  return mqmsgblock;
+  ((FAR struct mqueue_msg_s *)obj)->type = MQ_ALLOC_FIXED;
 }
 
 /****************************************************************************
@@ -166,25 +129,16 @@ mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nmsgs,
 
 void nxmq_initialize(void)
 {
-  /* Initialize the message free lists */
-
-  sq_init(&g_msgfree);
-  sq_init(&g_msgfreeirq);
   sq_init(&g_desalloc);
 
-  /* Allocate a block of messages for general use */
-
-  g_msgalloc =
-    mq_msgblockalloc(&g_msgfree, CONFIG_PREALLOC_MQ_MSGS,
-                     MQ_ALLOC_FIXED);
-
-  /* Allocate a block of messages for use exclusively by
-   * interrupt handlers
+  /* Allocate a block of messages for general use plus the messages that
+   * are reserved for use exclusively by interrupt handlers.
    */
 
-  g_msgfreeirqalloc =
-    mq_msgblockalloc(&g_msgfreeirq, NUM_INTERRUPT_MSGS,
-                     MQ_ALLOC_IRQ);
+  (void)mempool_initialize(&g_msgpool, "mqmsg", NULL,
+                           sizeof(struct mqueue_msg_s),
+                           CONFIG_PREALLOC_MQ_MSGS + NUM_INTERRUPT_MSGS,
+                           NUM_INTERRUPT_MSGS, mq_msgctor, NULL);
 
   /* Allocate a block of message queue descriptors */
 
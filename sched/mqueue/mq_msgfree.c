@@ -69,37 +69,31 @@
 
 void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 {
+#ifdef CONFIG_MQ_ZEROCOPY
   irqstate_t flags;
+#endif
 
-  /* If this is a generally available pre-allocated message,
-   * then just put it back in the free list.
+  /* If this is a pre-allocated message, then just put it back in the
+   * pool.
    */
 
   if (mqmsg->type == MQ_ALLOC_FIXED)
     {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfree);
-      leave_critical_section(flags);
+      mempool_free(&g_msgpool, mqmsg);
     }
 
-  /* If this is a message pre-allocated for interrupts,
-   * then put it back in the correct  free list.
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* If this message is part of the storage of a message queue, then
+   * return it to that queue's free list.
    */
 
-  else if (mqmsg->type == MQ_ALLOC_IRQ)
+  else if (mqmsg->type == MQ_ALLOC_SLAB)
     {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfreeirq);
-      leave_critical_section(flags);
+      flags = nxmq_lock();
+      sq_addlast((FAR sq_entry_t *)mqmsg, &mqmsg->msgq->msgfree);
+      nxmq_unlock(flags);
     }
+#endif
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate messages because they will not
@@ -0,0 +1,282 @@
+/****************************************************************************
+ * sched/mqueue/mq_msgloan.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Get the message containing a loaned message buffer */
+
+#define MQ_BUFFER2MSG(b) \
+  ((FAR struct mqueue_msg_s *)((FAR char *)(b) - \
+                               offsetof(struct mqueue_msg_s, mail)))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_msg_reserve
+ *
+ * Description:
+ *   Reserve a message for the message queue.  The caller builds the
+ *   message in the returned buffer and then sends it with
+ *   nxmq_msg_commit() or gives it back with nxmq_msg_release().  If the
+ *   queue is full, this waits for space just as nxmq_send() does.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor opened for writing
+ *   buffer - The location to return the message buffer.  The buffer can
+ *            hold the mq_msgsize bytes of the queue.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:
+ *
+ *   EINVAL   mqdes or buffer is NULL
+ *   EPERM    The queue was not opened for writing
+ *   EAGAIN   The queue is full and O_NONBLOCK is set
+ *   EINTR    The wait was interrupted by a signal
+ *   ENOMEM   No message could be allocated
+ *
+ ****************************************************************************/
+
+int nxmq_msg_reserve(mqd_t mqdes, FAR void **buffer)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret = OK;
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_WROK) == 0)
+    {
+      return -EPERM;
+    }
+
+  sched_lock();
+  msgq = mqdes->msgq;
+
+  /* Wait for space in the queue, as for nxmq_send() */
+
+  flags = enter_critical_section();
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      mqmsg = nxmq_alloc_qmsg(msgq);
+      if (mqmsg == NULL)
+        {
+          ret = -ENOMEM;
+        }
+      else
+        {
+          *buffer = mqmsg->mail;
+        }
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_msg_commit
+ *
+ * Description:
+ *   Send a message that was built in place in a buffer obtained from
+ *   nxmq_msg_reserve().  The message is not copied.  Ownership of the
+ *   buffer passes to the message queue.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor opened for writing
+ *   buffer - The buffer returned by nxmq_msg_reserve()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure (see nxmq_send()).  On failure, the caller still owns the
+ *   buffer.
+ *
+ ****************************************************************************/
+
+int nxmq_msg_commit(mqd_t mqdes, FAR void *buffer, size_t msglen, int prio)
+{
+  int ret;
+
+  ret = nxmq_verify_send(mqdes, (FAR const char *)buffer, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The message may exceed the mq_maxmsg limit if several messages were
+   * reserved at once, just as messages sent from interrupt handlers may.
+   */
+
+  return nxmq_do_send(mqdes, MQ_BUFFER2MSG(buffer),
+                      (FAR const char *)buffer, msglen, prio);
+}
+
+/****************************************************************************
+ * Name: nxmq_msg_receive
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages in the queue by
+ *   reference.  The message is not copied.  The caller must give the
+ *   buffer back with nxmq_msg_release() before closing 'mqdes'.  If the
+ *   queue is empty, this waits for a message just as nxmq_receive() does.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor opened for reading
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to return the message priority
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure:
+ *
+ *   EINVAL   mqdes or buffer is NULL
+ *   EPERM    The queue was not opened for reading
+ *   EAGAIN   The queue is empty and O_NONBLOCK is set
+ *   EINTR    The wait was interrupted by a signal
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_msg_receive(mqd_t mqdes, FAR void **buffer, FAR int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      return -EPERM;
+    }
+
+  /* Get the next message from the message queue, as for nxmq_receive() */
+
+  sched_lock();
+
+  flags = enter_critical_section();
+  ret   = nxmq_wait_receive(mqdes, &mqmsg);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      /* Without a user buffer, nxmq_do_receive() leaves the message with
+       * us.
+       */
+
+      DEBUGASSERT(mqmsg != NULL);
+      ret     = nxmq_do_receive(mqdes, mqmsg, NULL, prio);
+      *buffer = mqmsg->mail;
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_msg_release
+ *
+ * Description:
+ *   Give back a message buffer obtained from nxmq_msg_receive(), or one
+ *   obtained from nxmq_msg_reserve() that will not be sent.
+ *
+ * Input Parameters:
+ *   mqdes  - The message queue descriptor used to obtain the buffer
+ *   buffer - The message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EINVAL is returned if mqdes or
+ *   buffer is NULL.
+ *
+ ****************************************************************************/
+
+int nxmq_msg_release(mqd_t mqdes, FAR void *buffer)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  mqmsg = MQ_BUFFER2MSG(buffer);
+  DEBUGASSERT(mqmsg->type != MQ_ALLOC_SLAB || mqmsg->msgq == mqdes->msgq);
+
+  nxmq_free_msg(mqmsg);
+  return OK;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
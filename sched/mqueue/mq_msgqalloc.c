@@ -39,7 +39,9 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <mqueue.h>
+#include <queue.h>
 #include <assert.h>
 
 #include <nuttx/kmalloc.h>
@@ -76,6 +78,12 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
                                            FAR struct mq_attr *attr)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_ZEROCOPY
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR uint8_t *slab;
+  size_t msgsize;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -111,6 +119,34 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
 #ifndef CONFIG_DISABLE_SIGNALS
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
+
+#ifdef CONFIG_MQ_ZEROCOPY
+      /* Preallocate storage for all of the messages that the queue can
+       * hold.  Each message carries only the payload size of this queue.
+       */
+
+      sq_init(&msgq->msgfree);
+      if (msgq->maxmsgs > 0)
+        {
+          msgsize    = MQ_SLABMSG_SIZE(msgq->maxmsgsize);
+          slab       = (FAR uint8_t *)kmm_malloc(msgsize * msgq->maxmsgs);
+          msgq->slab = slab;
+
+          if (slab == NULL)
+            {
+              sched_kfree(msgq);
+              return NULL;
+            }
+
+          for (i = 0; i < msgq->maxmsgs; i++, slab += msgsize)
+            {
+              mqmsg       = (FAR struct mqueue_msg_s *)slab;
+              mqmsg->type = MQ_ALLOC_SLAB;
+              mqmsg->msgq = msgq;
+              sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msgfree);
+            }
+        }
+#endif
     }
 
   return msgq;
@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
+#include <queue.h>
 #include <debug.h>
 #include <nuttx/kmalloc.h>
 #include "mqueue/mqueue.h"
@@ -82,6 +84,20 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       curr = next;
     }
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Then the preallocated message storage.  Any loaned messages must have
+   * been released before the last descriptor was closed.
+   */
+
+  DEBUGASSERT(msgq->slab == NULL ||
+              sq_count(&msgq->msgfree) == msgq->maxmsgs);
+
+  if (msgq->slab != NULL)
+    {
+      sched_kfree(msgq->slab);
+    }
+#endif
+
   /* Then deallocate the message queue itself */
 
   sched_kfree(msgq);
@@ -240,6 +240,8 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
  *   mqdes - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
  *   ubuffer - The address of the user provided buffer to receive the message
+ *             or NULL.  If NULL, the message is neither copied nor freed:
+ *             The caller keeps the message and must free it later.
  *   prio    - The user-provided location to return the message priority.
  *
  * Returned Value:
@@ -266,20 +268,22 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   rcvmsglen = mqmsg->msglen;
 
-  /* Copy the message into the caller's buffer */
-
-  memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
-
-  /* Copy the message priority as well (if a buffer is provided) */
+  /* Copy the message priority (if a buffer is provided) */
 
   if (prio)
     {
       *prio = mqmsg->priority;
     }
 
-  /* We are done with the message.  Deallocate it now. */
+  /* Copy the message into the caller's buffer.  We are then done with the
+   * message.  Deallocate it now.
+   */
 
-  nxmq_free_msg(mqmsg);
+  if (ubuffer != NULL)
+    {
+      memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+      nxmq_free_msg(mqmsg);
+    }
 
   /* Check if any tasks are waiting for the MQ not full event. */
 
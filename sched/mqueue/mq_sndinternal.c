@@ -118,8 +118,8 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  The message will be allocated from the g_msgpool
+ *   pool.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -128,7 +128,7 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  *   If the list is empty AND the message IS being allocated from the
  *   interrupt level.  This function will attempt to get a message from
- *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
+ *   the pool reserve.  If this is unsuccessful, the calling interrupt
  *   handler will be notified.
  *
  * Input Parameters:
@@ -143,39 +143,28 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
 FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
 {
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
 
-  /* If we were called from an interrupt handler, then try to get the message
-   * from generally available list of messages. If this fails, then try the
-   * list of messages reserved for interrupt handlers
+  /* If we were called from an interrupt handler, then get the message from
+   * the pool.  Interrupt handlers may also use the messages in the pool
+   * reserve.
    */
 
   if (up_interrupt_context())
     {
-      /* Try the general free list */
-
-      mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-      if (mqmsg == NULL)
-        {
-          /* Try the free list reserved for interrupt handlers */
-
-          mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfreeirq);
-        }
+      mqmsg = (FAR struct mqueue_msg_s *)mempool_alloc(&g_msgpool);
     }
 
   /* We were not called from an interrupt handler. */
 
   else
     {
-      /* Try to get the message from the generally available free list.
-       * Disable interrupts -- we might be called from an interrupt handler.
+      /* Try to get the message from the generally available messages in
+       * the pool.
        */
 
-      flags = enter_critical_section();
-      mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-      leave_critical_section(flags);
+      mqmsg = (FAR struct mqueue_msg_s *)mempool_tryalloc(&g_msgpool);
 
-      /* If we cannot a message from the free list, then we will have to
+      /* If we cannot a message from the pool, then we will have to
        * allocate one.
        */
 
@@ -198,6 +187,42 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
   return mqmsg;
 }
 
+/****************************************************************************
+ * Name: nxmq_alloc_qmsg
+ *
+ * Description:
+ *   Get a free message for the message queue 'msgq'.  The message is taken
+ *   from the storage preallocated with the message queue if possible.
+ *   Otherwise, it is allocated by nxmq_alloc_msg().
+ *
+ * Input Parameters:
+ *   msgq - The message queue that the message will be sent to
+ *
+ * Returned Value:
+ *   A reference to the allocated msg structure or NULL on a failure to
+ *   allocate.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+FAR struct mqueue_msg_s *nxmq_alloc_qmsg(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+
+  flags = nxmq_lock();
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msgfree);
+  nxmq_unlock(flags);
+
+  if (mqmsg == NULL)
+    {
+      mqmsg = nxmq_alloc_msg();
+    }
+
+  return mqmsg;
+}
+#endif
+
 /****************************************************************************
  * Name: nxmq_wait_send
  *
@@ -328,7 +353,8 @@ int nxmq_wait_send(mqd_t mqdes)
  *
  * Input Parameters:
  *   mqdes  - Message queue descriptor
- *   msg    - Message to send
+ *   msg    - Message to send.  This may be the message data of 'mqmsg'
+ *            itself if the message was built in place.
  *   msglen - The length of the message in bytes
  *   prio   - The priority of the message
  *
@@ -356,9 +382,12 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message (unless it is already there) */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
@@ -46,12 +46,16 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <limits.h>
 #include <mqueue.h>
 #include <sched.h>
 #include <signal.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/mempool.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -69,21 +73,34 @@
 
 #define NUM_MSG_DESCRIPTORS 24
 
-/* This defines the number of messages to set aside for exclusive use by
- * interrupt handlers
+/* This defines the number of messages in the pool reserve that is set
+ * aside for exclusive use by interrupt handlers
  */
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* In SMP configurations, the per-queue message free lists may be protected
+ * by a subsystem spinlock rather than by the global critical section.  The
+ * message pool has its own lock.
+ */
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+#  define nxmq_lock()    subsys_lock(&g_mqlock)
+#  define nxmq_unlock(f) subsys_unlock(&g_mqlock, (f))
+#else
+#  define nxmq_lock()    enter_critical_section()
+#  define nxmq_unlock(f) leave_critical_section(f)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
 enum mqalloc_e
 {
-  MQ_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
+  MQ_ALLOC_FIXED = 0,  /* From g_msgpool; returned to the pool */
   MQ_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_SLAB        /* Preallocated with one message queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -97,10 +114,23 @@ struct mqueue_msg_s
   uint8_t msglen;                 /* Message data length */
 #else
   uint16_t msglen;                /* Message data length */
+#endif
+#ifdef CONFIG_MQ_ZEROCOPY
+  FAR struct mqueue_inode_s *msgq; /* Owner of MQ_ALLOC_SLAB storage */
 #endif
   char mail[MQ_MAX_BYTES];        /* Message data */
 };
 
+/* The size of one message in the preallocated storage of a message queue.
+ * Only the payload that the queue can carry is allocated.
+ */
+
+#ifdef CONFIG_MQ_ZEROCOPY
+#  define MQ_SLABMSG_SIZE(n) \
+     ((offsetof(struct mqueue_msg_s, mail) + (n) + sizeof(uintptr_t) - 1) & \
+      ~(sizeof(uintptr_t) - 1))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -113,17 +143,11 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_msgfree is a list of messages that are available for general use.
- * The number of messages in this list is a system configuration item.
+/* The g_msgpool is the pool of pre-allocated messages.  NUM_INTERRUPT_MSGS
+ * of them are held in reserve for interrupt handlers.
  */
 
-EXTERN sq_queue_t  g_msgfree;
-
-/* The g_msgfreeInt is a list of messages that are reserved for use by
- * interrupt handlers.
- */
-
-EXTERN sq_queue_t  g_msgfreeirq;
+EXTERN struct mempool_s g_msgpool;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -132,6 +156,12 @@ EXTERN sq_queue_t  g_msgfreeirq;
 
 EXTERN sq_queue_t  g_desfree;
 
+#ifdef CONFIG_SPINLOCK_SUBSYS
+/* This spinlock protects the msgfree list of each message queue */
+
+EXTERN struct subsys_lock_s g_mqlock;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -160,6 +190,11 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
 int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
 FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+#ifdef CONFIG_MQ_ZEROCOPY
+FAR struct mqueue_msg_s *nxmq_alloc_qmsg(FAR struct mqueue_inode_s *msgq);
+#else
+#  define nxmq_alloc_qmsg(msgq) nxmq_alloc_msg()
+#endif
 int nxmq_wait_send(mqd_t mqdes);
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, int prio);
@@ -41,8 +41,12 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
 #include <queue.h>
 
+#include <nuttx/clock.h>
+
 #ifdef CONFIG_PAGING
 
 /****************************************************************************
@@ -67,15 +71,43 @@
 #  define CONFIG_PAGING_STACKSIZE  CONFIG_IDLETHREAD_STACKSIZE
 #endif
 
+#ifndef CONFIG_PAGING_READAHEAD
+#  define CONFIG_PAGING_READAHEAD 0
+#endif
+
+/* A blocking up_fillpage() performs one fill at a time */
+
+#ifdef CONFIG_PAGING_BLOCKINGFILL
+#  undef  CONFIG_PAGING_NFILLS
+#  define CONFIG_PAGING_NFILLS 1
+#elif !defined(CONFIG_PAGING_NFILLS)
+#  define CONFIG_PAGING_NFILLS 1
+#endif
+
 #ifdef CONFIG_DISABLE_SIGNALS
 #  warning "Page fill support requires signals"
 #endif
 
+#ifndef __ASSEMBLY__
+
 /****************************************************************************
- * Public Data
+ * Public Types
  ****************************************************************************/
 
-#ifndef __ASSEMBLY
+/* Paging statistics, reported in /proc/sched/paging */
+
+struct pg_stats_s
+{
+  uint32_t faults;       /* Page faults reported by pg_miss() */
+  uint32_t fills;        /* Pages filled for a faulting task */
+  uint32_t readahead;    /* Pages filled by read-ahead */
+  uint32_t mapped;       /* Faults on pages that were already mapped */
+  systime_t fillticks;   /* Total time spent in fills */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
 
 /* This is the task IDof the page fill worker thread.  This value was set in
  * os_start when the page fill worker thread was started.
@@ -83,18 +115,16 @@
 
 extern pid_t g_pgworker;
 
-/* The page fill worker thread maintains a static variable called g_pftcb.
- * If no page fill is in progress, g_pftcb will be NULL. Otherwise, g_pftcb
- * will point to the TCB of the task which is receiving the fill that is
- * in progess.
- *
- * NOTE: I think that this is the only state in which a TCB does not reside
- * in some list.  Here is it in limbo, outside of the normally queuing while
- * the page file is in progress.  Where here, it will be marked with
- * TSTATE_TASK_INVALID.
+/* The number of page fills in progress.  pg_miss() signals the page fill
+ * worker thread only if another fill may be started.  A task receiving a
+ * fill remains in the g_waitingforfill list until the fill completes.
  */
 
-extern FAR struct tcb_s *g_pftcb;
+extern volatile uint8_t g_pgnfills;
+
+/* Paging statistics.  These are modified only with interrupts disabled. */
+
+extern struct pg_stats_s g_pgstats;
 
 /****************************************************************************
  * Public Function Prototypes
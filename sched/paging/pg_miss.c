@@ -83,7 +83,7 @@
  *        priority of the page fill worker thread, then boost the priority
  *        of the page fill worker thread to that priority.
  *   4) Signal the page fill worker thread.
- *      - Is there a page fill pending?  If not then signal the worker
+ *      - Can another page fill be started?  If so then signal the worker
  *        thread to start working on the queued page fill requests.
  *
  * Input Parameters:
@@ -166,11 +166,13 @@ void pg_miss(void)
     }
 
   /* Signal the page fill worker thread.
-   * - Is there a page fill pending?  If not then signal the worker
+   * - Can another page fill be started?  If so then signal the worker
    *   thread to start working on the queued page fill requests.
    */
 
-  if (!g_pftcb)
+  g_pgstats.faults++;
+
+  if (g_pgnfills < CONFIG_PAGING_NFILLS)
     {
       pginfo("Signaling worker. PID: %d\n", g_pgworker);
       (void)nxsig_kill(g_pgworker, SIGWORK);
@@ -70,6 +70,22 @@
 #    warning "Signals needed by this function (CONFIG_DISABLE_SIGNALS=n)"
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifndef CONFIG_PAGING_BLOCKINGFILL
+/* This structure describes one asynchronous page fill in progress */
+
+struct pg_fill_s
+{
+  FAR struct tcb_s *tcb;  /* Task receiving the fill; NULL if slot is free */
+  uintptr_t vpage;        /* Virtual address of the page being filled */
+  volatile int result;    /* -EBUSY until pg_callback() is received */
+  systime_t start;        /* Time when the fill was started */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -80,37 +96,34 @@
 
 pid_t g_pgworker;
 
-/* The page fill worker thread maintains a static variable called g_pftcb.
- * If no fill is in progress, g_pftcb will be NULL. Otherwise, g_pftcb will
- * point to the TCB of the task which is receiving the fill that is in progess.
- *
- * NOTE: I think that this is the only state in which a TCB does not reside
- * in some list.  Here is it in limbo, outside of the normally queuing while
- * the page file is in progress.  Where here, it will be marked with
- * TSTATE_TASK_INVALID.
- */
+/* The number of page fills in progress */
+
+volatile uint8_t g_pgnfills;
 
-FAR struct tcb_s *g_pftcb;
+/* Paging statistics */
+
+struct pg_stats_s g_pgstats;
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 #ifndef CONFIG_PAGING_BLOCKINGFILL
-
-/* When a page fill completes, the result of the fill is stored here.  The
- * value -EBUSY means that the page fill callback has not yet been received.
+/* The fills in progress.  A slot whose result is not -EBUSY has completed
+ * but has not yet been retired by the page fill worker thread.
  */
 
-static int g_fillresult;
+static struct pg_fill_s g_pgfills[CONFIG_PAGING_NFILLS];
+#endif
 
-/* A configurable timeout period (in clock ticks) may be select to detect
- * page fill failures.
+#if CONFIG_PAGING_READAHEAD > 0
+/* The read-ahead window:  The next page to read ahead and the number of
+ * pages remaining in the window.  The window follows the most recent page
+ * filled on demand.
  */
 
-#ifdef CONFIG_PAGING_TIMEOUT_TICKS
-static systime_t g_starttime;
-#endif
+static uintptr_t g_raaddr;
+static uint16_t g_racount;
 #endif
 
 /****************************************************************************
@@ -130,15 +143,13 @@ static systime_t g_starttime;
  *
  * When pg_callback() is called, it will perform the following operations:
  *
- * - Verify that g_pftcb is non-NULL.
- * - Find the higher priority between the task waiting for the fill to
- *   complete in g_pftcb and the task waiting at the head of the
- *   g_waitingforfill list.  That will be the priority of he highest priority
- *   task waiting for a fill.
- * - If this higher priority is higher than current page fill worker thread,
- *   then boost worker thread's priority to that level. Thus, the page fill
- *   worker thread will always run at the priority of the highest priority
- *   task that is waiting for a fill.
+ * - Find the fill in progress for 'tcb' and save the result of the fill.
+ * - If the priority of the task at the head of the g_waitingforfill list
+ *   (the highest priority task waiting for a fill) is higher than the
+ *   priority of the page fill worker thread, then boost worker thread's
+ *   priority to that level.  Thus, the page fill worker thread will always
+ *   run at the priority of the highest priority task that is waiting for a
+ *   fill.
  * - Signal the page fill worker thread.
  *
  * Input Parameters:
@@ -156,47 +167,30 @@ static systime_t g_starttime;
 #ifndef CONFIG_PAGING_BLOCKINGFILL
 static void pg_callback(FAR struct tcb_s *tcb, int result)
 {
-  /* Verify that g_pftcb is non-NULL */
+  FAR struct tcb_s *htcb = (FAR struct tcb_s *)g_waitingforfill.head;
+  FAR struct tcb_s *wtcb = sched_gettcb(g_pgworker);
+  int i;
 
-  pginfo("g_pftcb: %p\n", g_pftcb);
-  if (g_pftcb)
-    {
-      FAR struct tcb_s *htcb = (FAR struct tcb_s *)g_waitingforfill.head;
-      FAR struct tcb_s *wtcb = sched_gettcb(g_pgworker);
+  pginfo("TCB: %p result: %d\n", tcb, result);
 
-      /* Find the higher priority between the task waiting for the fill to
-       * complete in g_pftcb and the task waiting at the head of the
-       * g_waitingforfill list.  That will be the priority of he highest
-       * priority task waiting for a fill.
-       */
-
-      int priority = g_pftcb->sched_priority;
-      if (htcb && priority < htcb->sched_priority)
+  for (i = 0; i < CONFIG_PAGING_NFILLS; i++)
+    {
+      if (g_pgfills[i].tcb == tcb && g_pgfills[i].result == -EBUSY)
         {
-          priority = htcb->sched_priority;
-        }
+          /* Save the page fill result (don't permit the value -EBUSY) */
 
-      /* If this higher priority is higher than current page fill worker
-       * thread, then boost worker thread's priority to that level. Thus,
-       * the page fill worker thread will always run at the priority of
-       * the highest priority task that is waiting for a fill.
-       */
-
-      if (priority > wtcb->sched_priority)
-        {
-          pginfo("New worker priority. %d->%d\n",
-                 wtcb->sched_priority, priority);
-          (void)nxsched_setpriority(wtcb, priority);
+          g_pgfills[i].result = (result == -EBUSY) ? -ENOSYS : result;
+          break;
         }
+    }
 
-      /* Save the page fill result (don't permit the value -EBUSY) */
-
-      if (result == -EBUSY)
-        {
-          result = -ENOSYS;
-        }
+  /* Boost the priority of the page fill worker thread, if necessary */
 
-      g_fillresult = result;
+  if (htcb != NULL && htcb->sched_priority > wtcb->sched_priority)
+    {
+      pginfo("New worker priority. %d->%d\n",
+             wtcb->sched_priority, htcb->sched_priority);
+      (void)nxsched_setpriority(wtcb, htcb->sched_priority);
     }
 
   /* Signal the page fill worker thread (in any event) */
@@ -207,30 +201,92 @@ static void pg_callback(FAR struct tcb_s *tcb, int result)
 #endif
 
 /****************************************************************************
- * Name: pg_dequeue
+ * Name: pg_setpriority
  *
  * Description:
- *   Dequeue the next, highest priority TCB from the g_waitingforfill task
- *   list.  Call up_checkmapping() see if the still needs to be performed
- *   for that task. In certain conditions, the page fault may occur on
- *   several threads for the same page and be queued multiple times. In this
- *   corner case, the blocked task will simply be restarted.
+ *   Set the priority of the page fill worker thread to the priority of
+ *   the highest priority task waiting for a fill, but not lower than the
+ *   configured minimum.  pg_miss() boosts the priority of the page fill
+ *   worker thread as each TCB is added to the g_waitingforfill list, so
+ *   this will reduce the priority as fills complete.
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void pg_setpriority(void)
+{
+  FAR struct tcb_s *htcb = (FAR struct tcb_s *)g_waitingforfill.head;
+  FAR struct tcb_s *wtcb = this_task();
+  int priority = CONFIG_PAGING_DEFPRIO;
+
+  if (htcb != NULL && htcb->sched_priority > priority)
+    {
+      priority = htcb->sched_priority;
+    }
+
+  if (wtcb->sched_priority != priority)
+    {
+      pginfo("New worker priority. %d->%d\n",
+             wtcb->sched_priority, priority);
+      (void)nxsched_setpriority(wtcb, priority);
+    }
+}
+
+/****************************************************************************
+ * Name: pg_inprogress
+ *
+ * Description:
+ *   Return true if a fill of the page containing 'vaddr' is in progress.
+ *   Such a page is already mapped (by up_allocpage()) but does not yet hold
+ *   valid data.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_PAGING_BLOCKINGFILL
+static bool pg_inprogress(uintptr_t vaddr)
+{
+  int i;
+
+  vaddr = PG_ALIGNDOWN(vaddr);
+  for (i = 0; i < CONFIG_PAGING_NFILLS; i++)
+    {
+      if (g_pgfills[i].tcb != NULL && g_pgfills[i].vpage == vaddr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#else
+/* With a blocking fill, no fill is in progress when looking for a task */
+
+#  define pg_inprogress(vaddr) false
+#endif
+
+/****************************************************************************
+ * Name: pg_dequeue
  *
- *   This function will continue to examine g_waitingforfill until either
- *   (1) a task is found that still needs the page fill, or (2) the
- *   g_waitingforfill task list becomes empty.
+ * Description:
+ *   Find the highest priority TCB in the g_waitingforfill task list that
+ *   still needs a page fill.  Call up_checkmapping() see if the fill still
+ *   needs to be performed for that task.  In certain conditions, the page
+ *   fault may occur on several threads for the same page (or on a page
+ *   that was read ahead).  In this corner case, the blocked task will
+ *   simply be restarted.  Tasks waiting for a page whose fill is already in
+ *   progress are skipped; they will be restarted after that fill completes.
  *
- *   The result (NULL or a TCB pointer) will be returned in the global
- *   variable, g_pftcb.
+ *   The TCB that is returned remains in the g_waitingforfill list until
+ *   its fill completes and the task is restarted with up_unblock_task().
  *
  * Input Parameters:
  *   None
  *
  * Returned Value:
- *   If there are no further queue page fill operations to be performed,
- *   pg_dequeue() will return false.  Otherwise, it will return
- *   true to that the full is in process (any errors will result in
- *   assertions and this function will not return).
+ *   The TCB of the task that needs a fill; NULL if there is none.
  *
  * Assumptions:
  *   Executing in the context of the page fill worker thread with all
@@ -238,268 +294,295 @@ static void pg_callback(FAR struct tcb_s *tcb, int result)
  *
  ****************************************************************************/
 
-static inline bool pg_dequeue(void)
+static FAR struct tcb_s *pg_dequeue(void)
 {
-  /* Loop until either (1) the TCB of a task that requires a fill is found, OR
-   * (2) the g_watingforfill list becomes empty.
-   */
+  FAR struct tcb_s *tcb;
+  FAR struct tcb_s *next;
 
-  do
+  for (tcb = (FAR struct tcb_s *)g_waitingforfill.head; tcb != NULL;
+       tcb = next)
     {
-      /* Remove the TCB from the head of the list (if any) */
+      next = tcb->flink;
 
-      g_pftcb = (FAR struct tcb_s *)dq_remfirst((dq_queue_t *)&g_waitingforfill);
-      pginfo("g_pftcb: %p\n", g_pftcb);
-      if (g_pftcb != NULL)
+      if (pg_inprogress(PG_FAULTADDR(tcb)))
         {
-          /* Call the architecture-specific function up_checkmapping() to see if
-           * the page fill still needs to be performed. In certain conditions,
-           * the page fault may occur on several threads for the same page and
-           * be queues multiple times. In this corner case, the blocked task will
-           * simply be restarted.
-           */
-
-          if (!up_checkmapping(g_pftcb))
-            {
-              /* This page needs to be filled.  pg_miss bumps up
-               * the priority of the page fill worker thread as each
-               * TCB is added to the g_waitingforfill list.  So we
-               * may need to also drop the priority of the worker
-               * thread as the next TCB comes off of the list.
-               *
-               * If wtcb->sched_priority > CONFIG_PAGING_DEFPRIO,
-               * then the page fill worker thread is executing at
-               * an elevated priority that may be reduced.
-               *
-               * If wtcb->sched_priority > g_pftcb->sched_priority
-               * then the page fill worker thread is executing at
-               * a higher priority than is appropriate for this
-               * fill (this priority can get re-boosted by pg_miss()
-               * if a new higher priority fill is required).
-               */
-
-              FAR struct tcb_s *wtcb = this_task();
-              if (wtcb->sched_priority > CONFIG_PAGING_DEFPRIO &&
-                  wtcb->sched_priority > g_pftcb->sched_priority)
-                {
-                  /* Don't reduce the priority of the page fill
-                   * worker thread lower than the configured
-                   * minimum.
-                   */
-
-                  int priority = g_pftcb->sched_priority;
-                  if (priority < CONFIG_PAGING_DEFPRIO)
-                    {
-                      priority = CONFIG_PAGING_DEFPRIO;
-                    }
-
-                  /* Reduce the priority of the page fill worker thread */
-
-                  pginfo("New worker priority. %d->%d\n",
-                         wtcb->sched_priority, priority);
-                  (void)nxsched_setpriority(wtcb, priority);
-                }
-
-              /* Return with g_pftcb holding the pointer to
-               * the TCB associated with task that requires the page fill.
-               */
-
-              return true;
-            }
-
-          /* The page need by this task has already been mapped into the
-           * virtual address space -- just restart it.
-           */
+          continue;
+        }
 
-          pginfo("Restarting TCB: %p\n", g_pftcb);
-          up_unblock_task(g_pftcb);
+      if (!up_checkmapping(tcb))
+        {
+          return tcb;
         }
+
+      /* The page need by this task has already been mapped into the
+       * virtual address space -- just restart it.
+       */
+
+      pginfo("Restarting TCB: %p\n", tcb);
+      g_pgstats.mapped++;
+      up_unblock_task(tcb);
     }
-  while (g_pftcb != NULL);
 
-  return false;
+  return NULL;
 }
 
 /****************************************************************************
  * Name: pg_startfill
  *
  * Description:
- *   Start a page fill operation on the thread whose TCB is at the head of
- *   of the g_waitingforfill task list.  That is a prioritized list so that
- *   will be the highest priority task waiting for a page fill (in the event
- *   that are multiple tasks waiting for a page fill).
- *
- *   This function may be called either (1) when the page fill worker thread
- *   is notified that there is a new page fill TCB in the g_waitingforfill
- *   prioritized list, or (2) when a page fill completes and there are more
- *   pages to be filled in g_waitingforfill list.
+ *   Call up_allocpage() to set aside a page in memory and map it to the
+ *   virtual address PG_FAULTADDR(tcb), then call up_fillpage() to fill it.
+ *   If all available pages are in-use (the typical case), up_allocpage()
+ *   will select a page in-use, un-map it, and make it available.
+ *
+ *   If CONFIG_PAGING_BLOCKINGFILL is defined, then up_fillpage() blocks and
+ *   the fill is complete when this function returns.  Otherwise, the fill
+ *   is recorded in a free slot and pg_callback() will be called when the
+ *   fill is finished (or an error occurs), probably from interrupt level.
+ *   While the fill is in progress, other tasks may execute.  NOTE: The IDLE
+ *   task must also be fully locked in memory.  The IDLE task cannot be
+ *   blocked.  In the case where all tasks are blocked waiting for a page
+ *   fill, the IDLE task must still be available to run.
  *
  * Input Parameters:
- *   None
+ *   tcb - The task that needs the fill, or the page fill worker thread for
+ *         a read-ahead fill.
  *
  * Returned Value:
- *   If there are no further queue page fill operations to be performed,
- *   pg_startfill() will return false.  Otherwise, it will return
- *   true to that the full is in process (any errors will result in
- *   assertions and this function will not return).
+ *   None (any errors will result in assertions).
  *
  * Assumptions:
  *   Executing in the context of the page fill worker thread with all
- *   interrupts disabled.
+ *   interrupts disabled.  For an asynchronous fill, a slot is free.
  *
  ****************************************************************************/
 
-static inline bool pg_startfill(void)
+static void pg_startfill(FAR struct tcb_s *tcb)
 {
+#ifndef CONFIG_PAGING_BLOCKINGFILL
+  FAR struct pg_fill_s *fill;
+#else
+  systime_t start;
+#endif
   FAR void *vpage;
   int result;
 
-  /* Remove the TCB at the head of the g_waitfor fill list and check if there
-   * is any task waiting for a page fill. pg_dequeue will handle this (plus
-   * some cornercases) and will true if the next page TCB was successfully
-   * dequeued.
-   */
-
-  if (pg_dequeue())
-    {
-      /* Call up_allocpage(tcb, &vpage). This architecture-specific function will
-       * set aside page in memory and map to virtual address (vpage). If all
-       * available pages are in-use (the typical case), this function will select
-       * a page in-use, un-map it, and make it available.
-       */
+  pginfo("Call up_allocpage(%p)\n", tcb);
+  result = up_allocpage(tcb, &vpage);
+  DEBUGASSERT(result == OK);
 
-      pginfo("Call up_allocpage(%p)\n", g_pftcb);
-      result = up_allocpage(g_pftcb, &vpage);
-      DEBUGASSERT(result == OK);
+  pginfo("Call up_fillpage(%p)\n", tcb);
 
-      /* Start the fill.  The exact way that the fill is started depends upon
-       * the nature of the architecture-specific up_fillpage() function -- Is it
-       * a blocking or a non-blocking call?
-       */
 #ifdef CONFIG_PAGING_BLOCKINGFILL
-      /* If CONFIG_PAGING_BLOCKINGFILL is defined, then up_fillpage is blocking
-       * call. In this case, up_fillpage() will accept only (1) a reference to
-       * the TCB that requires the fill. Architecture-specific context information
-       * within the TCB will be sufficient to perform the fill. And (2) the
-       * (virtual) address of the allocated page to be filled. The resulting
-       * status of the fill will be provided by return value from up_fillpage().
-       */
+  /* pg_miss() must not signal this thread while it is blocked in the fill */
 
-      pginfo("Call up_fillpage(%p)\n", g_pftcb);
-      result = up_fillpage(g_pftcb, vpage);
-      DEBUGASSERT(result == OK);
-#else
-      /* If CONFIG_PAGING_BLOCKINGFILL is defined, then up_fillpage is non-blocking
-       * call. In this case up_fillpage() will accept an additional argument: The page
-       * fill worker thread will provide a callback function, pg_callback.
-       *
-       * Calling up_fillpage will start an asynchronous page fill. pg_callback
-       * ill be called when the page fill is finished (or an error occurs). This
-       * This callback will probably from interrupt level.
-       */
+  g_pgnfills = 1;
+  start      = clock_systimer();
+  result     = up_fillpage(tcb, vpage);
+  g_pgstats.fillticks += clock_systimer() - start;
+  g_pgnfills = 0;
 
-      pginfo("Call up_fillpage(%p)\n", g_pftcb);
-      result = up_fillpage(g_pftcb, vpage, pg_callback);
-      DEBUGASSERT(result == OK);
+  DEBUGASSERT(result == OK);
+#else
+  for (fill = g_pgfills; fill->tcb != NULL; fill++)
+    {
+      DEBUGASSERT(fill < &g_pgfills[CONFIG_PAGING_NFILLS - 1]);
+    }
 
-      /* Save the time that the fill was started.  These will be used to check for
-       * timeouts.
-       */
+  fill->tcb    = tcb;
+  fill->vpage  = PG_ALIGNDOWN(PG_FAULTADDR(tcb));
+  fill->result = -EBUSY;
+  fill->start  = clock_systimer();
+  g_pgnfills++;
 
-#ifdef CONFIG_PAGING_TIMEOUT_TICKS
-      g_starttime = clock_systimer();
+  result = up_fillpage(tcb, vpage, pg_callback);
+  DEBUGASSERT(result == OK);
 #endif
 
-      /* Return and wait to be signaled for the next event -- the fill completion
-       * event. While the fill is in progress, other tasks may execute. If
-       * another page fault occurs during this time, the faulting task will be
-       * blocked, its TCB will be added (in priority order) to g_waitingforfill
-       * and the priority of the page worker task may be boosted. But no action
-       * will be taken until the current page fill completes. NOTE: The IDLE task
-       * must also be fully locked in memory. The IDLE task cannot be blocked. It
-       * the case where all tasks are blocked waiting for a page fill, the IDLE
-       * task must still be available to run.
-       */
-#endif /* CONFIG_PAGING_BLOCKINGFILL */
-
-      return true;
-    }
-
-  pginfo("Queue empty\n");
-  return false;
+  UNUSED(result);
 }
 
 /****************************************************************************
- * Name: pg_alldone
+ * Name: pg_demandfill
  *
  * Description:
- *   Called by the page fill worker thread when all pending page fill
- *   operations have been completed and the g_waitingforfill list is empty.
+ *   Start a fill for the highest priority task that is waiting for one and
+ *   move the read-ahead window behind the faulting page.  With a blocking
+ *   fill, the task is restarted when the fill is complete.
  *
- *   This functin will perform the following operations:
+ * Returned Value:
+ *   True if a fill was started; false if no task needs a fill.
  *
- *   - Set g_pftcb to NULL.
- *   - Restore the default priority of the page fill worker thread.
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
  *
- * Input Parameters:
- *   None.
+ ****************************************************************************/
+
+static bool pg_demandfill(void)
+{
+  FAR struct tcb_s *tcb = pg_dequeue();
+
+  if (tcb == NULL)
+    {
+      return false;
+    }
+
+  pg_setpriority();
+
+#if CONFIG_PAGING_READAHEAD > 0
+  g_raaddr  = PG_ALIGNDOWN(PG_FAULTADDR(tcb)) + PAGESIZE;
+  g_racount = CONFIG_PAGING_READAHEAD;
+#endif
+
+  g_pgstats.fills++;
+  pg_startfill(tcb);
+
+#ifdef CONFIG_PAGING_BLOCKINGFILL
+  /* Restart the task that was blocked waiting for this page fill */
+
+  pginfo("Restarting TCB: %p\n", tcb);
+  up_unblock_task(tcb);
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: pg_readahead
+ *
+ * Description:
+ *   Start a fill of the next unmapped page in the read-ahead window.  The
+ *   fill is performed on behalf of the page fill worker thread: its
+ *   PG_FAULTADDR() is set to the page to be filled.
  *
  * Returned Value:
- *   None
+ *   True if a fill was started; false if the window is exhausted.
  *
  * Assumptions:
- *   Executing in the context of the page fill worker thread with interrupts
- *   disabled.
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.  No other read-ahead fill is in progress.
  *
  ****************************************************************************/
 
-static inline void pg_alldone(void)
+#if CONFIG_PAGING_READAHEAD > 0
+static bool pg_readahead(void)
 {
   FAR struct tcb_s *wtcb = this_task();
-  g_pftcb = NULL;
-  pginfo("New worker priority. %d->%d\n",
-         wtcb->sched_priority, CONFIG_PAGING_DEFPRIO);
-  (void)nxsched_setpriority(wtcb, CONFIG_PAGING_DEFPRIO);
+
+  while (g_racount > 0 && g_raaddr < PG_PAGED_VEND)
+    {
+      PG_FAULTADDR(wtcb) = g_raaddr;
+      g_raaddr += PAGESIZE;
+      g_racount--;
+
+      if (!up_checkmapping(wtcb))
+        {
+          pginfo("Read-ahead: %08lx\n", (unsigned long)PG_FAULTADDR(wtcb));
+          g_pgstats.readahead++;
+          pg_startfill(wtcb);
+          return true;
+        }
+    }
+
+  g_racount = 0;
+  return false;
 }
+#else
+#  define pg_readahead() false
+#endif
 
 /****************************************************************************
- * Name: pg_fillcomplete
+ * Name: pg_retire
  *
  * Description:
- *   Called by the page fill worker thread when a page fill completes.
- *   Either (1) in the non-blocking up_fillpage(), after the architecture-
- *   specific driver call the pg_callback() to wake up the page fill worker
- *   thread, or (2) after the blocking up_fillpage() returens (when
- *   CONFIG_PAGING_BLOCKINGFILL is defined).
+ *   Retire the asynchronous fills that have completed:  Restart the tasks
+ *   that received the fills and free the slots.  Other tasks that faulted
+ *   on the same pages will be restarted by the next pg_dequeue().
  *
- *   This function is just a dumb wrapper around up_unblocktask().  This
- *   function simply makes the task that just received the fill ready-to-run.
- *
- * Input Parameters:
- *   None.
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with all
+ *   interrupts disabled.
  *
- * Returned Value:
- *   None
+ ****************************************************************************/
+
+#ifndef CONFIG_PAGING_BLOCKINGFILL
+static void pg_retire(void)
+{
+  FAR struct pg_fill_s *fill;
+  FAR struct tcb_s *wtcb = this_task();
+  int i;
+
+  for (i = 0; i < CONFIG_PAGING_NFILLS; i++)
+    {
+      fill = &g_pgfills[i];
+      if (fill->tcb == NULL)
+        {
+          continue;
+        }
+
+      if (fill->result != -EBUSY)
+        {
+          /* Any value other than OK, brings the system down */
+
+          ASSERT(fill->result == OK);
+
+          g_pgstats.fillticks += clock_systimer() - fill->start;
+          if (fill->tcb != wtcb)
+            {
+              pginfo("Restarting TCB: %p\n", fill->tcb);
+              up_unblock_task(fill->tcb);
+            }
+
+          fill->tcb = NULL;
+          g_pgnfills--;
+        }
+
+      /* If a configurable timeout period expires with no page fill
+       * completion event, then declare a failure.
+       */
+
+#ifdef CONFIG_PAGING_TIMEOUT_TICKS
+      else
+        {
+          ASSERT(clock_systimer() - fill->start <
+                 CONFIG_PAGING_TIMEOUT_TICKS);
+        }
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: pg_rainprogress
  *
- * Assumptions:
- *   Executing in the context of the page fill worker thread with interrupts
- *   disabled.
+ * Description:
+ *   Return true if a read-ahead fill is in progress.
  *
  ****************************************************************************/
 
-static inline void pg_fillcomplete(void)
+#if CONFIG_PAGING_READAHEAD > 0
+static bool pg_rainprogress(void)
 {
-  /* Call up_unblocktask(g_pftcb) to make the task that just
-   * received the fill ready-to-run.
-   */
+  FAR struct tcb_s *wtcb = this_task();
+  int i;
 
-  pginfo("Restarting TCB: %p\n", g_pftcb);
-  up_unblock_task(g_pftcb);
+  for (i = 0; i < CONFIG_PAGING_NFILLS; i++)
+    {
+      if (g_pgfills[i].tcb == wtcb)
+        {
+          return true;
+        }
+    }
+
+  return false;
 }
+#endif
+#endif /* !CONFIG_PAGING_BLOCKINGFILL */
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
 /****************************************************************************
  * Name: pg_worker
  *
@@ -515,6 +598,8 @@ static inline void pg_fillcomplete(void)
  *     after completing a page fill.
  *   - A configurable timeout with no activity.
  *
+ *   Fills for waiting tasks always take precedence over read-ahead fills.
+ *
  * Input Parameters:
  *   argc, argv (not used)
  *
@@ -541,7 +626,8 @@ int pg_worker(int argc, char *argv[])
     {
       /* Wait awhile.  We will wait here until either the configurable timeout
        * elapses or until we are awakened by a signal (which terminates the
-       * nxsig_usleep with an EINTR error).  Note that interrupts will be re- * enabled while this task sleeps.
+       * nxsig_usleep with an EINTR error).  Note that interrupts will be
+       * re-enabled while this task sleeps.
        *
        * The timeout is a failsafe that will handle any cases where a single
        * is lost (that would really be a bug and shouldn't happen!) and also
@@ -550,122 +636,56 @@ int pg_worker(int argc, char *argv[])
 
       nxsig_usleep(CONFIG_PAGING_WORKPERIOD);
 
-      /* The page fill worker thread will be awakened on one of three conditions:
-       *
-       *   - When signaled by pg_miss(), the page fill worker thread will be awakenend,
-       *   - if CONFIG_PAGING_BLOCKINGFILL is not defined, from pg_callback()
-       *     after completing a page fill, or
-       *   - On a configurable timeout expires with no activity.
-       *
-       * Interrupts are still disabled.
-       */
-
 #ifndef CONFIG_PAGING_BLOCKINGFILL
-      /* For the non-blocking up_fillpage(), the page fill worker thread will detect
-       * that the page fill is complete when it is awakened with g_pftcb non-NULL
-       * and fill completion status from pg_callback.
+      /* Restart the tasks whose fills have completed */
+
+      pg_retire();
+
+      /* Start as many fills as there are free slots, tasks waiting for a
+       * fill first.  Only one read-ahead fill may be in progress since all
+       * read-ahead fills use the TCB of this thread.
        */
 
-      if (g_pftcb != NULL)
+      while (g_pgnfills < CONFIG_PAGING_NFILLS)
         {
-          /* If it is a real page fill completion event, then the result of the page
-           * fill will be in g_fillresult and will not be equal to -EBUSY.
-           */
-
-          if (g_fillresult != -EBUSY)
+          if (pg_demandfill())
             {
-              /* Any value other than OK, brings the system down */
-
-              ASSERT(g_fillresult == OK);
-
-              /* Handle the successful page fill complete event by restarting the
-               * task that was blocked waiting for this page fill.
-               */
-
-              pginfo("Restarting TCB: %p\n", g_pftcb);
-              up_unblock_task(g_pftcb);
-
-              /* Yes .. Start the next asynchronous fill.  Check the return
-               * value to see a fill was actually started (false means that
-               * no fill was started).
-               */
-
-              pginfo("Calling pg_startfill\n");
-              if (!pg_startfill())
-                {
-                  /* No fill was started.  This can mean only that all queued
-                   * page fill actions have and been completed and there is
-                   * nothing more to do.
-                   */
-
-                  pginfo("Call pg_alldone()\n");
-                  pg_alldone();
-                }
+              continue;
             }
 
-          /* If a configurable timeout period expires with no page fill completion
-           * event, then declare a failure.
-           */
-
-#ifdef CONFIG_PAGING_TIMEOUT_TICKS
-          else
+#if CONFIG_PAGING_READAHEAD > 0
+          if (!pg_rainprogress() && g_waitingforfill.head == NULL &&
+              pg_readahead())
             {
-              pgerr("ERROR: Timeout!\n");
-              ASSERT(clock_systimer() - g_starttime < CONFIG_PAGING_TIMEOUT_TICKS);
+              continue;
             }
 #endif
+
+          break;
         }
 
-      /* Otherwise, this might be a page fill initiation event.  When
-       * awakened from pg_miss(), no fill will be in progress and
-       * g_pftcb will be NULL.
-       */
+      /* Drop the priority when no task is waiting for a fill any longer */
 
-      else
-        {
-          /* Are there tasks blocked and waiting for a fill?  If so,
-           * pg_startfill() will start the asynchronous fill (and set
-           * g_pftcb).
-           */
-
-          pginfo("Calling pg_startfill\n");
-          (void)pg_startfill();
-        }
+      pg_setpriority();
 #else
       /* Are there tasks blocked and waiting for a fill?  Loop until all
-       * pending fills have been processed.
+       * pending fills have been processed, then read ahead at the minimum
+       * priority until a task faults again or the window is exhausted.
        */
 
       for (; ; )
         {
-          /* Yes .. Start the fill and block until the fill completes.
-           * Check the return value to see a fill was actually performed.
-           * (false means that no fill was perforemd).
-           */
-
-          pginfo("Calling pg_startfill\n");
-          if (!pg_startfill())
+          if (pg_demandfill())
             {
-              /* Break out of the loop -- there is nothing more to do */
+              continue;
+            }
 
+          pg_setpriority();
+          if (!pg_readahead())
+            {
               break;
             }
-
-          /* Handle the page fill complete event by restarting the
-           * task that was blocked waiting for this page fill. In the
-           * non-blocking fill case, the page fill worker thread will
-           * know that the page fill is  complete when pg_startfill()
-           * returns true.
-           */
-
-          pginfo("Restarting TCB: %p\n", g_pftcb);
-          up_unblock_task(g_pftcb);
         }
-
-      /* All queued fills have been processed */
-
-      pginfo("Call pg_alldone()\n");
-      pg_alldone();
 #endif
     }
 
@@ -74,6 +74,18 @@ struct join_s
   pthread_addr_t exit_value;     /* Returned data */
 };
 
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+/* Per-CPU statistics of the adaptive mutex spin logic */
+
+struct pthread_spinstats_s
+{
+  uint32_t contended;            /* Locks that found the mutex held */
+  uint32_t acquired;             /* Mutex became available while spinning */
+  uint32_t blocked;              /* Gave up spinning and blocked */
+  uint32_t spins;                /* Total polls of the mutex state */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -86,6 +98,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+/* Adaptive mutex spin statistics, one set for each CPU */
+
+EXTERN struct pthread_spinstats_s g_mutex_spinstats[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -129,6 +147,10 @@ void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 int pthread_mutexattr_verifytype(int type);
 #endif
 
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+void pthread_mutex_spin(FAR struct pthread_mutex_s *mutex);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -51,6 +51,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 
@@ -141,6 +142,24 @@ static void pthread_condtimedout(int argc, uint32_t pid, uint32_t signo)
 #endif /* HAVE_GROUP_MEMBERS */
 }
 
+/****************************************************************************
+ * Name: pthread_hrtimedout
+ *
+ * Description:
+ *   This function is called if the high resolution timer set up by
+ *   pthread_cond_timedwait() expires.  This is the same as
+ *   pthread_condtimedout(); 'arg' is the pid of the waiting thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void pthread_hrtimedout(FAR void *arg)
+{
+  pthread_condtimedout(2, (uint32_t)((uintptr_t)arg),
+                       (uint32_t)SIGCONDTIMEDOUT);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -272,12 +291,26 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                     }
                   else
                     {
+#ifdef CONFIG_HRTIMER
+                      struct timespec delay;
+
+                      /* Start the high resolution timer.  The delay to the
+                       * absolute time is not rounded to the system tick.
+                       */
+
+                      (void)clock_gettime(CLOCK_REALTIME, &delay);
+                      clock_timespec_subtract(abstime, &delay, &delay);
+                      (void)hrtimer_start(&rtcb->waithrt, &delay,
+                                          pthread_hrtimedout,
+                                          (FAR void *)((uintptr_t)mypid));
+#else
                       /* Start the watchdog */
 
                       (void)wd_start(rtcb->waitdog, ticks,
                                      (wdentry_t)pthread_condtimedout,
                                      2, (uint32_t)mypid,
                                      (uint32_t)SIGCONDTIMEDOUT);
+#endif
 
                       /* Take the condition semaphore.  Do not restore interrupts
                        * until we return from the wait.  This is necessary to
@@ -340,6 +373,9 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
 
           /* We no longer need the watchdog */
 
+#ifdef CONFIG_HRTIMER
+          (void)hrtimer_cancel(&rtcb->waithrt);
+#endif
           wd_delete(rtcb->waitdog);
           rtcb->waitdog = NULL;
         }
@@ -261,7 +261,8 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 
   /* Allocate a TCB for the new task. */
 
-  ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+  ptcb = (FAR struct pthread_tcb_s *)
+    sched_tcballoc(sizeof(struct pthread_tcb_s));
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -304,8 +305,8 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 
   /* Allocate the stack for the TCB */
 
-  ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
-                        TCB_FLAG_TTYPE_PTHREAD);
+  ret = sched_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
+                           TCB_FLAG_TTYPE_PTHREAD);
   if (ret != OK)
     {
       errcode = ENOMEM;
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * sched/pthread/pthread_mutexspin.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Adaptive mutex spin statistics, one set for each CPU */
+
+struct pthread_spinstats_s g_mutex_spinstats[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_spin
+ *
+ * Description:
+ *   Called before locking an adaptive mutex.  If the mutex is held by a
+ *   thread that is running on another CPU, then poll the mutex until it is
+ *   released, until the holder stops running, or until the spin count is
+ *   exhausted.  The caller should then lock the mutex in the normal way:
+ *   If the mutex was released, it will then usually be taken without
+ *   blocking.
+ *
+ *   The holder's TCB is examined without any lock.  That is only a hint:
+ *   The result affects only how long the caller spins, never whether it
+ *   acquires the mutex.
+ *
+ * Parameters:
+ *   mutex - The adaptive mutex to be locked
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from a thread with the scheduler unlocked.
+ *
+ ****************************************************************************/
+
+void pthread_mutex_spin(FAR struct pthread_mutex_s *mutex)
+{
+  FAR struct pthread_spinstats_s *stats;
+  FAR struct tcb_s *holder;
+  irqstate_t flags;
+  pid_t pid;
+  int me;
+  int i;
+
+  /* Nothing to do if the mutex is available */
+
+  if (mutex->sem.semcount > 0)
+    {
+      return;
+    }
+
+  me = this_cpu();
+
+  for (i = 0; i < CONFIG_PTHREAD_MUTEX_ADAPTIVE_SPINS; i++)
+    {
+      if (mutex->sem.semcount > 0)
+        {
+          break;
+        }
+
+      /* Stop spinning if the holder is not running on another CPU.  The pid
+       * may be transiently invalid while the mutex changes hands.
+       */
+
+      pid = mutex->pid;
+      if (pid > 0)
+        {
+          holder = sched_gettcb(pid);
+          if (holder == NULL || holder->task_state != TSTATE_TASK_RUNNING ||
+              holder->cpu == me)
+            {
+              break;
+            }
+        }
+    }
+
+  /* Update the statistics of this CPU.  Disabling local interrupts is
+   * sufficient to keep the update atomic because the counts are per-CPU.
+   */
+
+  flags = up_irq_save();
+  stats = &g_mutex_spinstats[this_cpu()];
+
+  stats->contended++;
+  stats->spins += i;
+
+  if (mutex->sem.semcount > 0)
+    {
+      stats->acquired++;
+    }
+  else
+    {
+      stats->blocked++;
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_PTHREAD_MUTEX_ADAPTIVE */
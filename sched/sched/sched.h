@@ -112,6 +112,51 @@
 #  define TLIST_BLOCKED(s)       __TLIST_HEAD(s)
 #endif
 
+/* Scheduler latency histograms:  One histogram per band of priorities */
+
+#ifdef CONFIG_SCHED_LATENCY
+#  define SCHED_LATENCY_NBANDS   (256 >> CONFIG_SCHED_LATENCY_PRIOSHIFT)
+#  define SCHED_LATENCY_BAND(p)  ((p) >> CONFIG_SCHED_LATENCY_PRIOSHIFT)
+#endif
+
+/* Critical section monitor:  The types of the monitored sections and the
+ * address from which a section is entered.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+#  define CRITMON_CSECTION       0
+#  define CRITMON_PREEMPTION     1
+
+#  ifdef __GNUC__
+#    define CRITMON_CALLER       __builtin_return_address(0)
+#  else
+#    define CRITMON_CALLER       NULL
+#  endif
+#endif
+
+/* CPU isolation:  The isolated CPUs and the remaining, housekeeping CPUs */
+
+#ifdef CONFIG_SMP_ISOLCPUS
+#  if (CONFIG_SMP_ISOLCPUS_SET & 1) != 0
+#    error CPU0 may not be isolated
+#  endif
+
+#  define SCHED_ISOLATED_CPUS \
+     ((cpu_set_t)CONFIG_SMP_ISOLCPUS_SET)
+#  define SCHED_HOUSEKEEPING_CPUS \
+     ((((cpu_set_t)1 << CONFIG_SMP_NCPUS) - 1) & ~SCHED_ISOLATED_CPUS)
+#  define sched_cpu_isolated(cpu) \
+     ((SCHED_ISOLATED_CPUS & ((cpu_set_t)1 << (cpu))) != 0)
+#endif
+
+/* A SCHED_DEADLINE thread is a sporadic thread with a relative deadline */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define sched_isdeadline(tcb) \
+  (((tcb)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC && \
+   (tcb)->sporadic != NULL && (tcb)->sporadic->deadline > 0)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -127,6 +172,18 @@
  * this would require a little more overhead.
  */
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* One of the longest critical sections or pre-emption disabled sections */
+
+struct critmon_worst_s
+{
+  uint8_t type;              /* CRITMON_CSECTION or CRITMON_PREEMPTION */
+  pid_t pid;                 /* The task that held the section */
+  FAR void *caller;          /* Where the section was entered */
+  uint32_t cycles;           /* Duration of the section (cycles) */
+};
+#endif
+
 struct pidhash_s
 {
   FAR struct tcb_s *tcb;       /* TCB assigned to this PID */
@@ -146,6 +203,26 @@ struct tasklist_s
   uint8_t attr;                   /* List attribute flags */
 };
 
+#ifdef CONFIG_SMP_CALL
+/* This is the form of a function that is executed on another CPU by
+ * sched_smp_call().
+ */
+
+typedef CODE void (*smp_callback_t)(FAR void *arg);
+#endif
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+/* This structure holds the per-CPU load balancing statistics */
+
+struct sched_balance_s
+{
+  systime_t lastscan;      /* Time of the last scan of the other CPUs */
+  uint32_t scans;          /* Number of scans performed by this CPU */
+  uint32_t pulled;         /* Number of tasks migrated by this idle CPU */
+  uint32_t stolen;         /* Number of tasks migrated away from this CPU */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -201,6 +278,12 @@ extern volatile dq_queue_t g_readytorun;
  */
 
 extern volatile dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
+
+/* If CONFIG_SCHED_PERCPU_READYTORUN is selected, then the g_readytorun list
+ * is not used:  Every ready-to-run task is assigned to a CPU as soon as it
+ * becomes ready.  The g_assignedtasks[] lists are still protected by the
+ * tasklist lock (see sched_tasklist_lock()).
+ */
 #endif
 
 /* This is the list of all tasks that are ready-to-run, but cannot be placed
@@ -382,8 +465,32 @@ extern volatile spinlock_t g_cpu_tasklistlock SP_SECTION;
 extern volatile int16_t g_global_lockcount;
 #endif
 
+#ifdef CONFIG_SCHED_LOADBALANCE
+/* Declared in sched_balance.c **********************************************/
+
+extern struct sched_balance_s g_balance[CONFIG_SMP_NCPUS];
+#endif
+
 #endif /* CONFIG_SMP */
 
+#ifdef CONFIG_SCHED_LATENCY
+/* Declared in sched_latency.c **********************************************/
+
+/* The wakeup-to-run latency histograms, indexed by priority band and by
+ * log2 of the latency in microseconds.
+ */
+
+extern uint32_t g_latency[SCHED_LATENCY_NBANDS][CONFIG_SCHED_LATENCY_NBUCKETS];
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* Declared in sched_critmonitor.c ******************************************/
+
+/* The longest critical sections and pre-emption disabled sections */
+
+extern struct critmon_worst_s g_critmon_worst[CONFIG_SCHED_CRITMONITOR_NWORST];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -400,6 +507,14 @@ void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
 
+/* Indexed ready-to-run list support */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool sched_rtradd(FAR struct tcb_s *tcb);
+void sched_rtrremove(FAR struct tcb_s *tcb);
+int  sched_rtrhighest(void);
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -415,6 +530,9 @@ int  nxsched_reprioritize(FAR struct tcb_s *tcb, int sched_priority);
 unsigned int sched_timer_cancel(void);
 void sched_timer_resume(void);
 void sched_timer_reassess(void);
+#ifdef CONFIG_HRTIMER
+void sched_alarm_reassess(void);
+#endif
 #else
 #  define sched_timer_cancel() (0)
 #  define sched_timer_resume()
@@ -440,6 +558,41 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+void sched_latency_ready(FAR struct tcb_s *tcb);
+void sched_latency_resume(FAR struct tcb_s *tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+void sched_cputime_suspend(FAR struct tcb_s *tcb);
+void sched_cputime_resume(FAR struct tcb_s *tcb);
+void sched_cputime_process(void);
+#ifdef CONFIG_SCHED_TICKLESS
+uint32_t sched_cputime_maxticks(void);
+#endif
+#endif
+
+#ifdef CONFIG_STACK_MONITOR
+void sched_stackmon_start(void);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller);
+void sched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                            FAR void *caller);
+void sched_critmon_suspend(FAR struct tcb_s *tcb);
+void sched_critmon_resume(FAR struct tcb_s *tcb);
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+int  sched_deadline_check(FAR struct tcb_s *tcb, uint32_t runtime,
+                          uint32_t period);
+void sched_deadline_admit(FAR struct tcb_s *tcb, int bandwidth);
+void sched_deadline_release(FAR struct tcb_s *tcb);
+bool sched_deadline_before(FAR struct tcb_s *tcb1, FAR struct tcb_s *tcb2);
+#endif
+
 #ifdef CONFIG_SMP
 #if defined(CONFIG_ARCH_GLOBAL_IRQDISABLE) || defined(CONFIG_ARCH_HAVE_FETCHADD)
 FAR struct tcb_s *this_task(void);
@@ -451,6 +604,15 @@ int  sched_cpu_pause(FAR struct tcb_s *tcb);
 irqstate_t sched_tasklist_lock(void);
 void sched_tasklist_unlock(irqstate_t lock);
 
+#ifdef CONFIG_SCHED_LOADBALANCE
+void sched_balance(void);
+#endif
+
+#ifdef CONFIG_SMP_CALL
+int  sched_smp_call(int cpu, smp_callback_t func, FAR void *arg);
+void sched_smp_call_handler(void);
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_FETCHADD) && !defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
 #  define sched_islocked_global() \
      (spin_islocked(&g_cpu_schedlock) || g_global_lockcount > 0)
@@ -478,4 +640,18 @@ void weak_function sched_process_cpuload(void);
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int  sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+#ifdef CONFIG_SCHED_TCBPOOL
+void sched_tcbpool_initialize(void);
+FAR void *sched_tcballoc(size_t size);
+void sched_tcbfree(FAR struct tcb_s *tcb);
+int  sched_create_stack(FAR struct tcb_s *tcb, size_t stack_size,
+                        uint8_t ttype);
+void sched_release_stack(FAR struct tcb_s *tcb, uint8_t ttype);
+#else
+#  define sched_tcballoc(s)           kmm_zalloc(s)
+#  define sched_tcbfree(t)            sched_kfree(t)
+#  define sched_create_stack(t,s,y)   up_create_stack(t,s,y)
+#  define sched_release_stack(t,y)    up_release_stack(t,y)
+#endif
+
 #endif /* __SCHED_SCHED_SCHED_H */
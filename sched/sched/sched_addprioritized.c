@@ -91,9 +91,21 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
    * Each is list is maintained in descending sched_priority order.
    */
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE threads in the CONFIG_SCHED_DEADLINE_PRIORITY band are
+   * maintained in ascending absolute deadline order.
+   */
+
+  for (next = (FAR struct tcb_s *)list->head;
+       (next && (sched_priority < next->sched_priority ||
+                 (sched_priority == next->sched_priority &&
+                  !sched_deadline_before(tcb, next))));
+       next = next->flink);
+#else
   for (next = (FAR struct tcb_s *)list->head;
        (next && sched_priority <= next->sched_priority);
        next = next->flink);
+#endif
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -104,7 +104,11 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  else if (sched_rtradd(btcb))
+#else
   else if (sched_addprioritized(btcb, (FAR dq_queue_t *)&g_readytorun))
+#endif
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -163,7 +167,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP) && !defined(CONFIG_SCHED_PERCPU_READYTORUN)
 bool sched_addreadytorun(FAR struct tcb_s *btcb)
 {
   FAR struct tcb_s *rtcb;
@@ -436,4 +440,173 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   return doswitch;
 }
 
-#endif /* CONFIG_SMP */
+#endif /* CONFIG_SMP && !CONFIG_SCHED_PERCPU_READYTORUN */
+
+/****************************************************************************
+ * Name:  sched_addreadytorun
+ *
+ * Description:
+ *   This function adds a TCB to the g_assignedtasks[cpu] list of the CPU
+ *   selected to run the task.  With CONFIG_SCHED_PERCPU_READYTORUN, there
+ *   is no global list of unassigned, ready-to-run tasks:  Each CPU owns a
+ *   prioritized list of all of the tasks assigned to it.
+ *
+ *   If the new task would pre-empt the running task on the selected CPU,
+ *   but pre-emption is disabled, then the new task is added to the
+ *   g_pendingtasks list instead.  Otherwise, if the new task does not
+ *   pre-empt the running task, it is simply queued in the selected CPU's
+ *   list without disturbing that CPU.
+ *
+ * Input Parameters:
+ *   btcb - Points to the blocked TCB that is ready-to-run
+ *
+ * Returned Value:
+ *   true if the currently active task on this CPU has changed.
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The caller has already removed the input rtcb from whatever list it
+ *   was in.
+ * - The caller handles the condition that occurs if the head of the
+ *   ready-to-run list is changed.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_PERCPU_READYTORUN)
+bool sched_addreadytorun(FAR struct tcb_s *btcb)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *next;
+  FAR dq_queue_t *tasklist;
+  irqstate_t lock;
+  bool doswitch = false;
+  int cpu;
+  int me;
+
+  /* Lock the tasklists before accessing */
+
+  lock = sched_tasklist_lock();
+
+  /* Select the CPU that will run the task */
+
+  if ((btcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
+    {
+      cpu = btcb->cpu;
+    }
+  else
+    {
+      cpu = sched_cpu_select(btcb->affinity);
+    }
+
+  me       = this_cpu();
+  tasklist = (FAR dq_queue_t *)&g_assignedtasks[cpu];
+
+  /* Get the task currently running on the CPU (may be the IDLE task) */
+
+  rtcb = (FAR struct tcb_s *)tasklist->head;
+
+  /* Will the new task pre-empt the running task on the selected CPU? */
+
+  if (rtcb->sched_priority >= btcb->sched_priority)
+    {
+      /* No.. Just queue the task in the CPU's list.  The head of the list
+       * does not change so there is no need to pause the other CPU.  The
+       * task will run when it becomes the highest priority task assigned
+       * to that CPU.
+       */
+
+      (void)sched_addprioritized(btcb, tasklist);
+
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+
+      sched_tasklist_unlock(lock);
+      return false;
+    }
+
+  /* Yes.. check if pre-emption is disabled.  Even if pre-emption is
+   * enabled, tasks will be forced to pend if the IRQ lock is also set
+   * UNLESS the CPU starting the thread is also the holder of the IRQ lock.
+   */
+
+  if (sched_islocked_global() || irq_cpu_locked(me))
+    {
+      (void)sched_addprioritized(btcb, (FAR dq_queue_t *)&g_pendingtasks);
+      btcb->task_state = TSTATE_TASK_PENDING;
+      sched_tasklist_unlock(lock);
+      return false;
+    }
+
+  /* If we are modifying the head of some assigned task list other than
+   * our own, we will need to stop that CPU.
+   */
+
+  if (cpu != me)
+    {
+      DEBUGVERIFY(up_cpu_pause(cpu));
+    }
+
+  /* Add the task to the head of the assigned task list.  Since we hold
+   * the tasklist lock, the new TCB must go at the head of the list.
+   */
+
+  (void)sched_addprioritized(btcb, tasklist);
+  DEBUGASSERT(tasklist->head == (FAR dq_entry_t *)btcb);
+
+  btcb->cpu        = cpu;
+  btcb->task_state = TSTATE_TASK_RUNNING;
+
+  /* Adjust global pre-emption controls.  If the lockcount is greater than
+   * zero, then this task/this CPU holds the scheduler lock.
+   */
+
+  if (btcb->lockcount > 0)
+    {
+      spin_setbit(&g_cpu_lockset, cpu, &g_cpu_locksetlock,
+                  &g_cpu_schedlock);
+    }
+  else
+    {
+      spin_clrbit(&g_cpu_lockset, cpu, &g_cpu_locksetlock,
+                  &g_cpu_schedlock);
+    }
+
+  /* Adjust global IRQ controls.  If irqcount is greater than zero, then
+   * this task/this CPU holds the IRQ lock.  Otherwise, spin_clrbit() will
+   * be done in sched_resumescheduler().
+   */
+
+  if (btcb->irqcount > 0)
+    {
+      spin_setbit(&g_cpu_irqset, cpu, &g_cpu_irqsetlock,
+                  &g_cpu_irqlock);
+    }
+  else
+    {
+      DEBUGASSERT(g_cpu_nestcount[me] <= 0 || up_interrupt_context());
+    }
+
+  /* The previously running task remains in the CPU's list, now in the
+   * assigned state.  It may migrate to another CPU the next time that it
+   * is made ready-to-run.
+   */
+
+  next = (FAR struct tcb_s *)btcb->flink;
+  DEBUGASSERT(next != NULL);
+  next->task_state = TSTATE_TASK_ASSIGNED;
+
+  doswitch = true;
+
+  /* All done, restart the other CPU (if it was paused). */
+
+  if (cpu != me)
+    {
+      DEBUGVERIFY(up_cpu_resume(cpu));
+      doswitch = false;
+    }
+
+  sched_tasklist_unlock(lock);
+  return doswitch;
+}
+#endif /* CONFIG_SMP && CONFIG_SCHED_PERCPU_READYTORUN */
@@ -0,0 +1,234 @@
+/****************************************************************************
+ * sched/sched/sched_balance.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Per-CPU load balancing statistics */
+
+struct sched_balance_s g_balance[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_balance_candidate
+ *
+ * Description:
+ *   Examine the assigned task list of one CPU.  Return the highest
+ *   priority task in that list that is waiting to run (i.e., is not
+ *   running and is not the IDLE task), that is not locked to its CPU, and
+ *   that may run on the CPU 'me'.  Also return the number of tasks
+ *   waiting in the list.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *sched_balance_candidate(int cpu, int me,
+                                                 FAR int *nwaiting)
+{
+  FAR struct tcb_s *candidate = NULL;
+  FAR struct tcb_s *tcb;
+  irqstate_t lock;
+  int count = 0;
+
+  lock = sched_tasklist_lock();
+
+  /* Skip over the running task at the head of the list.  The IDLE task is
+   * always the final entry in the list.
+   */
+
+  tcb = (FAR struct tcb_s *)g_assignedtasks[cpu].head;
+  for (tcb = (FAR struct tcb_s *)tcb->flink;
+       tcb != NULL && tcb->flink != NULL;
+       tcb = (FAR struct tcb_s *)tcb->flink)
+    {
+      count++;
+
+      /* The list is prioritized so the first match is the highest priority
+       * matching task.
+       */
+
+      if (candidate == NULL &&
+          (tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 &&
+          CPU_ISSET(me, &tcb->affinity))
+        {
+          candidate = tcb;
+        }
+    }
+
+  sched_tasklist_unlock(lock);
+
+  *nwaiting = count;
+  return candidate;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_balance
+ *
+ * Description:
+ *   Called from the IDLE loop of each CPU.  If this CPU has no tasks other
+ *   than its IDLE task, then find the CPU with the most tasks waiting to
+ *   run and migrate the highest priority of those waiting tasks that is
+ *   permitted to run on this CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called only from the IDLE task.  The IDLE task may be suspended
+ *   within this function if a task is migrated to this CPU.
+ *
+ ****************************************************************************/
+
+void sched_balance(void)
+{
+  FAR struct sched_balance_s *balance;
+  FAR struct tcb_s *victim = NULL;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  systime_t now;
+  int maxwaiting = 0;
+  int nwaiting;
+  int src = 0;
+  int cpu;
+  int me;
+
+  me      = this_cpu();
+  balance = &g_balance[me];
+
+#ifdef CONFIG_SMP_ISOLCPUS
+  /* An isolated CPU runs only the threads that were pinned to it */
+
+  if (sched_cpu_isolated(me))
+    {
+      return;
+    }
+#endif
+
+  /* Don't bother if this CPU is not idle or if the scheduler is locked.
+   * These checks require no lock:  The IDLE task is always the last entry
+   * in the list so the CPU is idle if the head of the list has no
+   * successor.
+   */
+
+  tcb = (FAR struct tcb_s *)g_assignedtasks[me].head;
+  if (tcb->flink != NULL || sched_islocked_global())
+    {
+      return;
+    }
+
+  /* Limit the rate at which the other CPUs' task lists are scanned */
+
+  now = clock_systimer();
+  if ((systime_t)(now - balance->lastscan) < CONFIG_SCHED_LOADBALANCE_INTERVAL)
+    {
+      return;
+    }
+
+  balance->lastscan = now;
+  balance->scans++;
+
+  flags = enter_critical_section();
+
+  /* Find the busiest CPU that has a task that could run on this CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me)
+        {
+          tcb = sched_balance_candidate(cpu, me, &nwaiting);
+          if (tcb != NULL && nwaiting > maxwaiting)
+            {
+              maxwaiting = nwaiting;
+              victim     = tcb;
+              src        = cpu;
+            }
+        }
+    }
+
+  /* Migrate the selected task.  We are within the critical section so the
+   * task cannot have changed state since it was selected.
+   * up_reprioritize_rtr() will remove the task from the assigned task list
+   * of its CPU and then add it back to the ready-to-run list of the CPU
+   * running the lowest priority task:  Normally that is this idle CPU and
+   * this will cause a context switch away from the IDLE task.
+   */
+
+  if (victim != NULL && victim->task_state == TSTATE_TASK_ASSIGNED &&
+      victim->cpu == src)
+    {
+      /* Update the statistics first:  If a context switch occurs, then we
+       * will not return here until this IDLE task runs again and, by then,
+       * the TCB may no longer be valid.
+       */
+
+      g_balance[src].stolen++;
+      balance->pulled++;
+
+      up_reprioritize_rtr(victim, victim->sched_priority);
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_LOADBALANCE */
@@ -82,6 +82,17 @@ int sched_cpu_select(cpu_set_t affinity)
   int cpu;
   int i;
 
+#ifdef CONFIG_SMP_ISOLCPUS
+  /* Avoid the isolated CPUs unless the thread may run only on isolated
+   * CPUs.
+   */
+
+  if ((affinity & SCHED_HOUSEKEEPING_CPUS) != 0)
+    {
+      affinity &= SCHED_HOUSEKEEPING_CPUS;
+    }
+
+#endif
   /* Otherwise, find the CPU that is executing the lowest priority task
    * (possibly its IDLE task).
    */
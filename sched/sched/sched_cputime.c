@@ -0,0 +1,259 @@
+/****************************************************************************
+ * sched/sched/sched_cputime.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define CPUTIME_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CPUTIME_NCPUS 1
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The value of the cycle counter when the running task on each CPU was
+ * last charged for its execution time.
+ */
+
+static uint32_t g_cputime_start[CPUTIME_NCPUS];
+
+#ifdef CONFIG_SCHED_TICKLESS
+/* The longest tickless sleep, in ticks, that cannot let the cycle counter
+ * wrap before the running task is charged again.  Zero until computed.
+ */
+
+static uint32_t g_cputime_maxticks;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_cputime_suspend
+ *
+ * Description:
+ *   Charge the task that is running on this CPU for the cycles that have
+ *   elapsed since it was last charged.  Called when the task is suspended
+ *   and periodically while it continues to run.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task running on this CPU
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_cputime_suspend(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_cyclecount();
+  int cpu = this_cpu();
+
+  tcb->cputime         += (uint32_t)(now - g_cputime_start[cpu]);
+  g_cputime_start[cpu]  = now;
+}
+
+/****************************************************************************
+ * Name: sched_cputime_resume
+ *
+ * Description:
+ *   A task is resuming execution on this CPU.  Start charging execution
+ *   time to it.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task that is resuming execution
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_cputime_resume(FAR struct tcb_s *tcb)
+{
+  g_cputime_start[this_cpu()] = up_cyclecount();
+}
+
+/****************************************************************************
+ * Name: sched_cputime_process
+ *
+ * Description:
+ *   Called from the timer interrupt handler to charge the running task.
+ *   The cycle counter is only 32-bits wide so a task that runs without
+ *   interruption must be charged before the counter wraps.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+void sched_cputime_process(void)
+{
+  sched_cputime_suspend(this_task());
+}
+
+/****************************************************************************
+ * Name: sched_cputime_maxticks
+ *
+ * Description:
+ *   Return the longest interval, in ticks, that the tickless timer may be
+ *   programmed for.  The 32-bit cycle counter wraps in 2^32 cycles (about
+ *   25 seconds at 168MHz); if the running task were not charged within that
+ *   time, whole wraps would be lost.  The limit is half of the wrap period
+ *   so that a late timer interrupt still charges the task in time.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The maximum number of ticks in one tickless timer interval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+uint32_t sched_cputime_maxticks(void)
+{
+  uint64_t usecs;
+
+  if (g_cputime_maxticks == 0)
+    {
+      usecs = ((uint64_t)UINT32_MAX * USEC_PER_SEC) / up_cyclefreq();
+      usecs = usecs / 2 / USEC_PER_TICK;
+
+      g_cputime_maxticks = usecs > 0 ? (uint32_t)usecs : 1;
+    }
+
+  return g_cputime_maxticks;
+}
+#endif
+
+/****************************************************************************
+ * Name: clock_cputime
+ *
+ * Description:
+ *   Return the accumulated execution time of the select PID.
+ *
+ * Input Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE
+ *         thread.
+ *   tp  - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+int clock_cputime(int pid, FAR struct timespec *tp)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t cycles;
+  uint32_t freq;
+  int ret = -ESRCH;
+
+  DEBUGASSERT(tp != NULL);
+
+  /* The task must stay valid and its accumulated time must not change while
+   * it is being read.
+   */
+
+  flags = enter_critical_section();
+
+  tcb = sched_gettcb((pid_t)pid);
+  if (tcb != NULL)
+    {
+      /* If the thread is running on this CPU, then bring its accumulated
+       * time up to date.
+       */
+
+      if (tcb == this_task())
+        {
+          sched_cputime_suspend(tcb);
+        }
+
+      cycles = tcb->cputime;
+      ret    = OK;
+    }
+
+  leave_critical_section(flags);
+
+  if (ret == OK)
+    {
+      freq        = up_cyclefreq();
+      tp->tv_sec  = (time_t)(cycles / freq);
+      tp->tv_nsec = (long)(((cycles % freq) * NSEC_PER_SEC) / freq);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_CPUTIME */
@@ -0,0 +1,316 @@
+/****************************************************************************
+ * sched/sched/sched_critmonitor.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The worst offenders, longest first.  There is at most one entry for each
+ * combination of type and caller, so that a single bad code path does not
+ * crowd out all of the others.
+ */
+
+struct critmon_worst_s g_critmon_worst[CONFIG_SCHED_CRITMONITOR_NWORST];
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static volatile spinlock_t g_critmon_lock;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critmon_record
+ *
+ * Description:
+ *   Record one completed critical section or pre-emption disabled section
+ *   in the list of worst offenders.
+ *
+ * Input Parameters:
+ *   type   - CRITMON_CSECTION or CRITMON_PREEMPTION
+ *   tcb    - The task that held the section
+ *   caller - The address from which the section was entered
+ *   cycles - The duration of the section in cycle counter cycles
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void critmon_record(uint8_t type, FAR struct tcb_s *tcb,
+                           FAR void *caller, uint32_t cycles)
+{
+  struct critmon_worst_s entry;
+  irqstate_t flags;
+  int ndx;
+
+  /* Quick check without the lock:  Most sections are short */
+
+  if (cycles <= g_critmon_worst[CONFIG_SCHED_CRITMONITOR_NWORST - 1].cycles)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock_wo_note(&g_critmon_lock);
+#endif
+
+  /* Is the code path already in the list? */
+
+  for (ndx = 0; ndx < CONFIG_SCHED_CRITMONITOR_NWORST; ndx++)
+    {
+      if (g_critmon_worst[ndx].type == type &&
+          g_critmon_worst[ndx].caller == caller)
+        {
+          break;
+        }
+    }
+
+  if (ndx >= CONFIG_SCHED_CRITMONITOR_NWORST)
+    {
+      /* No.. replace the shortest entry */
+
+      ndx = CONFIG_SCHED_CRITMONITOR_NWORST - 1;
+    }
+
+  if (cycles > g_critmon_worst[ndx].cycles)
+    {
+      entry.type   = type;
+      entry.pid    = tcb->pid;
+      entry.caller = caller;
+      entry.cycles = cycles;
+
+      /* Move the entry up to keep the list sorted */
+
+      for (; ndx > 0 && g_critmon_worst[ndx - 1].cycles < cycles; ndx--)
+        {
+          g_critmon_worst[ndx] = g_critmon_worst[ndx - 1];
+        }
+
+      g_critmon_worst[ndx] = entry;
+    }
+
+#ifdef CONFIG_SMP
+  spin_unlock_wo_note(&g_critmon_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_critmon_preemption
+ *
+ * Description:
+ *   Called when the outermost sched_lock() is taken (state == true) or the
+ *   outermost sched_unlock() releases it (state == false).
+ *
+ * Input Parameters:
+ *   tcb    - The task that locks or unlocks the scheduler
+ *   state  - True if pre-emption is being disabled
+ *   caller - The address from which the scheduler was locked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller)
+{
+  uint32_t now = up_cyclecount();
+  uint32_t elapsed;
+
+  if (state)
+    {
+      /* Zero means that no section is being timed */
+
+      tcb->premp_start  = (now != 0) ? now : 1;
+      tcb->premp_time   = 0;
+      tcb->premp_caller = caller;
+    }
+  else if (tcb->premp_start != 0)
+    {
+      elapsed = tcb->premp_time + (now - tcb->premp_start);
+      tcb->premp_start = 0;
+
+      if (elapsed > tcb->premp_max)
+        {
+          tcb->premp_max = elapsed;
+        }
+
+      critmon_record(CRITMON_PREEMPTION, tcb, tcb->premp_caller, elapsed);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_csection
+ *
+ * Description:
+ *   Called when the outermost enter_critical_section() is entered by a
+ *   task (state == true) or the outermost leave_critical_section() leaves
+ *   it (state == false).
+ *
+ * Input Parameters:
+ *   tcb    - The task that enters or leaves the critical section
+ *   state  - True if the critical section is being entered
+ *   caller - The address from which the critical section was entered
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                            FAR void *caller)
+{
+  uint32_t now = up_cyclecount();
+  uint32_t elapsed;
+
+  if (state)
+    {
+      /* Zero means that no section is being timed */
+
+      tcb->crit_start  = (now != 0) ? now : 1;
+      tcb->crit_time   = 0;
+      tcb->crit_caller = caller;
+    }
+  else if (tcb->crit_start != 0)
+    {
+      elapsed = tcb->crit_time + (now - tcb->crit_start);
+      tcb->crit_start = 0;
+
+      if (elapsed > tcb->crit_max)
+        {
+          tcb->crit_max = elapsed;
+        }
+
+      critmon_record(CRITMON_CSECTION, tcb, tcb->crit_caller, elapsed);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_suspend
+ *
+ * Description:
+ *   A task is being suspended.  If it holds a critical section or has
+ *   pre-emption disabled, then stop the clock:  While it is suspended, other
+ *   tasks run and interrupts are not held off on its behalf.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task being suspended
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_critmon_suspend(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_cyclecount();
+
+  if (tcb->crit_start != 0)
+    {
+      tcb->crit_time += now - tcb->crit_start;
+    }
+
+  if (tcb->premp_start != 0)
+    {
+      tcb->premp_time += now - tcb->premp_start;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_resume
+ *
+ * Description:
+ *   A task is resuming execution.  Restart the clock of any critical section
+ *   or pre-emption disabled section that it holds.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task that is resuming
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_critmon_resume(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_cyclecount();
+
+  if (now == 0)
+    {
+      now = 1;
+    }
+
+  if (tcb->crit_start != 0)
+    {
+      tcb->crit_start = now;
+    }
+
+  if (tcb->premp_start != 0)
+    {
+      tcb->premp_start = now;
+    }
+}
+
+#endif /* CONFIG_SCHED_CRITMONITOR */
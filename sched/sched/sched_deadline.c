@@ -0,0 +1,217 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidth is expressed in parts per thousand of the CPU */
+
+#define DEADLINE_BW_UNITS    1000
+#define DEADLINE_BW_CAPACITY (CONFIG_SCHED_DEADLINE_MAXUTIL * 10)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidth of all admitted SCHED_DEADLINE threads */
+
+static uint32_t g_deadline_bandwidth;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_deadline_check
+ *
+ * Description:
+ *   Admission control.  Determine if the thread may be admitted to the
+ *   SCHED_DEADLINE policy with the given runtime and period.  If the thread
+ *   already uses the SCHED_DEADLINE policy, then its current bandwidth is
+ *   replaced by the new bandwidth.
+ *
+ * Input Parameters:
+ *   tcb     - The TCB of the thread to be admitted.
+ *   runtime - The runtime budget in each period (in clock ticks).
+ *   period  - The period (in clock ticks).
+ *
+ * Returned Value:
+ *   The bandwidth to be passed to sched_deadline_admit() on success.  A
+ *   negated errno value is returned on failure:  -EBUSY if the total
+ *   bandwidth would exceed CONFIG_SCHED_DEADLINE_MAXUTIL.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int sched_deadline_check(FAR struct tcb_s *tcb, uint32_t runtime,
+                         uint32_t period)
+{
+  uint32_t bandwidth;
+  uint32_t current = 0;
+
+  DEBUGASSERT(runtime > 0 && runtime <= period);
+
+  /* Round up so that admitted threads can never exceed the capacity */
+
+  bandwidth = ((uint64_t)runtime * DEADLINE_BW_UNITS + period - 1) / period;
+
+  if (sched_isdeadline(tcb))
+    {
+      current = tcb->sporadic->bandwidth;
+    }
+
+  if (g_deadline_bandwidth - current + bandwidth > DEADLINE_BW_CAPACITY)
+    {
+      return -EBUSY;
+    }
+
+  return (int)bandwidth;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_admit
+ *
+ * Description:
+ *   Account for the bandwidth of a thread that has been admitted to the
+ *   SCHED_DEADLINE policy.  Any previous bandwidth must have been released
+ *   by sched_sporadic_reset().
+ *
+ * Input Parameters:
+ *   tcb       - The TCB of the admitted thread.
+ *   bandwidth - The value returned by sched_deadline_check().
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_deadline_admit(FAR struct tcb_s *tcb, int bandwidth)
+{
+  DEBUGASSERT(tcb->sporadic != NULL && tcb->sporadic->bandwidth == 0);
+
+  tcb->sporadic->bandwidth = (uint16_t)bandwidth;
+  g_deadline_bandwidth    += bandwidth;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_release
+ *
+ * Description:
+ *   Release the bandwidth of a thread that is leaving the SCHED_DEADLINE
+ *   policy (or that is exiting).
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_deadline_release(FAR struct tcb_s *tcb)
+{
+  FAR struct sporadic_s *sporadic = tcb->sporadic;
+
+  DEBUGASSERT(sporadic != NULL &&
+              g_deadline_bandwidth >= sporadic->bandwidth);
+
+  g_deadline_bandwidth   -= sporadic->bandwidth;
+  sporadic->bandwidth     = 0;
+  sporadic->deadline      = 0;
+  sporadic->abs_deadline  = 0;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_before
+ *
+ * Description:
+ *   Earliest-deadline-first ordering of two threads of the same priority.
+ *   This is used when a TCB is added to a prioritized list.  All
+ *   SCHED_DEADLINE threads that have runtime remaining share the priority
+ *   CONFIG_SCHED_DEADLINE_PRIORITY so, within that band, the threads are
+ *   ordered by absolute deadline alone.  Threads of other policies are
+ *   skipped over so the SCHED_DEADLINE threads in the band stay sorted.
+ *
+ * Input Parameters:
+ *   tcb1 - The TCB being added to the list.
+ *   tcb2 - A TCB of the same priority already in the list.
+ *
+ * Returned Value:
+ *   True if both threads use the SCHED_DEADLINE policy and tcb1 has the
+ *   earlier absolute deadline.  tcb1 is never placed ahead of a thread
+ *   that has pre-emption disabled.
+ *
+ ****************************************************************************/
+
+bool sched_deadline_before(FAR struct tcb_s *tcb1, FAR struct tcb_s *tcb2)
+{
+  if (!sched_isdeadline(tcb1) || !sched_isdeadline(tcb2) ||
+      tcb2->lockcount > 0)
+    {
+      return false;
+    }
+
+  return (ssystime_t)(tcb1->sporadic->abs_deadline -
+                      tcb2->sporadic->abs_deadline) < 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -106,6 +106,15 @@ int nxsched_getscheduler(pid_t pid)
    * interpretable values are 1 based; the TCB values are zero-based.
    */
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE threads are managed as sporadic threads */
+
+  if (sched_isdeadline(tcb))
+    {
+      return SCHED_DEADLINE;
+    }
+#endif
+
   policy = (tcb->flags & TCB_FLAG_POLICY_MASK) >> TCB_FLAG_POLICY_SHIFT;
   return policy + 1;
 }
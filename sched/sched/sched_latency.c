@@ -0,0 +1,163 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The wakeup-to-run latency histograms */
+
+uint32_t g_latency[SCHED_LATENCY_NBANDS][CONFIG_SCHED_LATENCY_NBUCKETS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_latency_now
+ *
+ * Description:
+ *   Return the current time in microseconds.  The value wraps; only
+ *   differences are meaningful.
+ *
+ ****************************************************************************/
+
+static inline uint32_t sched_latency_now(void)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+  struct timespec ts;
+
+  (void)up_timer_gettime(&ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC +
+         (uint32_t)ts.tv_nsec / NSEC_PER_USEC;
+#else
+  return (uint32_t)TICK2USEC(clock_systimer());
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_latency_ready
+ *
+ * Description:
+ *   Record the time that a blocked task is made ready-to-run.  Called from
+ *   sched_removeblocked() just before the task is passed to
+ *   sched_addreadytorun().
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task being made ready-to-run
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_latency_ready(FAR struct tcb_s *tcb)
+{
+  uint32_t now = sched_latency_now();
+
+  /* Zero means that no time was recorded */
+
+  tcb->readytime = (now != 0) ? now : 1;
+}
+
+/****************************************************************************
+ * Name: sched_latency_resume
+ *
+ * Description:
+ *   A task is resuming execution.  If it was made ready-to-run since it
+ *   last ran, add the elapsed time to the histogram for its priority.
+ *   Tasks resuming after pre-emption are not counted.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task that is resuming execution
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_latency_resume(FAR struct tcb_s *tcb)
+{
+  uint32_t latency;
+  int bucket;
+
+  if (tcb->readytime != 0)
+    {
+      latency        = sched_latency_now() - tcb->readytime;
+      tcb->readytime = 0;
+
+      /* Bucket 0 holds latencies below 2 microseconds; bucket n holds
+       * latencies in the range [2**n, 2**(n+1)).
+       */
+
+      bucket = (latency > 1) ? flsl((long)latency) - 1 : 0;
+      if (bucket >= CONFIG_SCHED_LATENCY_NBUCKETS)
+        {
+          bucket = CONFIG_SCHED_LATENCY_NBUCKETS - 1;
+        }
+
+      g_latency[SCHED_LATENCY_BAND(tcb->sched_priority)][bucket]++;
+    }
+}
+
+#endif /* CONFIG_SCHED_LATENCY */
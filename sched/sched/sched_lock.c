@@ -250,6 +250,15 @@ int sched_lock(void)
       (void)up_fetchsub16(&g_global_lockcount, 1);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start timing if we just acquired the lock */
+
+      if (rtcb->lockcount == 1)
+        {
+          sched_critmon_preemption(rtcb, true, CRITMON_CALLER);
+        }
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
       /* Check if we just acquired the lock */
 
@@ -261,14 +270,17 @@ int sched_lock(void)
         }
 #endif
 
+#ifndef CONFIG_SCHED_PERCPU_READYTORUN
       /* Move any tasks in the ready-to-run list to the pending task list
        * where they will not be available to run until the scheduler is
-       * unlocked and sched_mergepending() is called.
+       * unlocked and sched_mergepending() is called.  There is no such
+       * list if each CPU has its own ready-to-run list.
        */
 
       sched_mergeprioritized((FAR dq_queue_t *)&g_readytorun,
                              (FAR dq_queue_t *)&g_pendingtasks,
                              TSTATE_TASK_PENDING);
+#endif
     }
 
   return OK;
@@ -299,6 +311,15 @@ int sched_lock(void)
 
       rtcb->lockcount++;
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start timing if we just acquired the lock */
+
+      if (rtcb->lockcount == 1)
+        {
+          sched_critmon_preemption(rtcb, true, CRITMON_CALLER);
+        }
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
       /* Check if we just acquired the lock */
 
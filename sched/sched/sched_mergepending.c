@@ -84,7 +84,43 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_READYTORUN_BITMAP)
+bool sched_mergepending(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *ptcb;
+
+  /* Remember the task that is currently running */
+
+  rtcb = this_task();
+
+  /* Move each TCB from the g_pendingtasks list into the indexed
+   * ready-to-run list.  No search of the ready-to-run list is required.
+   */
+
+  while ((ptcb = (FAR struct tcb_s *)
+                 dq_remfirst((FAR dq_queue_t *)&g_pendingtasks)) != NULL)
+    {
+      ptcb->task_state = TSTATE_TASK_READYTORUN;
+      (void)sched_rtradd(ptcb);
+    }
+
+  /* Did the head of the ready-to-run list change? */
+
+  ptcb = this_task();
+  DEBUGASSERT(ptcb->sched_priority == sched_rtrhighest());
+
+  if (ptcb != rtcb)
+    {
+      rtcb->task_state = TSTATE_TASK_READYTORUN;
+      ptcb->task_state = TSTATE_TASK_RUNNING;
+      return true;
+    }
+
+  return false;
+}
+
+#elif !defined(CONFIG_SMP)
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -164,7 +200,7 @@ bool sched_mergepending(void)
 
   return ret;
 }
-#endif /* !CONFIG_SMP */
+#endif /* !CONFIG_SMP && !CONFIG_SCHED_READYTORUN_BITMAP */
 
 /****************************************************************************
  * Name: sched_mergepending
@@ -189,7 +225,7 @@ bool sched_mergepending(void)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP) && !defined(CONFIG_SCHED_PERCPU_READYTORUN)
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *rtcb;
@@ -296,4 +332,68 @@ errout_with_lock:
   sched_tasklist_unlock(lock);
   return ret;
 }
-#endif /* CONFIG_SMP */
+#endif /* CONFIG_SMP && !CONFIG_SCHED_PERCPU_READYTORUN */
+
+/****************************************************************************
+ * Name: sched_mergepending
+ *
+ * Description:
+ *   This function merges the prioritized g_pendingtasks list back into the
+ *   per-CPU ready-to-run lists.  Each pending task is simply made
+ *   ready-to-run again:  sched_addreadytorun() will either start it on the
+ *   CPU running the lowest priority task or queue it in the assigned task
+ *   list of that CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   true if the head of the ready-to-run task list of this CPU has changed
+ *     indicating a context switch is needed.
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The caller handles the condition that occurs if the head of the
+ *   ready-to-run task list is changed.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_PERCPU_READYTORUN)
+bool sched_mergepending(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t lock;
+  bool ret = false;
+  int me;
+
+  /* Lock the tasklist before accessing */
+
+  lock = sched_tasklist_lock();
+
+  /* Do nothing if (1) pre-emption is still disabled (by any CPU), or (2) if
+   * some CPU other than this one is in a critical section.  Stop if
+   * making a pending task ready-to-run causes the scheduler to become
+   * locked; any remaining tasks will stay in the pending task list.
+   */
+
+  me = this_cpu();
+  while (!sched_islocked_global() && !irq_cpu_locked(me))
+    {
+      tcb = (FAR struct tcb_s *)dq_remfirst((FAR dq_queue_t *)&g_pendingtasks);
+      if (tcb == NULL)
+        {
+          /* The pending task list is empty */
+
+          break;
+        }
+
+      ret |= sched_addreadytorun(tcb);
+    }
+
+  /* Unlock the tasklist */
+
+  sched_tasklist_unlock(lock);
+  return ret;
+}
+#endif /* CONFIG_SMP && CONFIG_SCHED_PERCPU_READYTORUN */
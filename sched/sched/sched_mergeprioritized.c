@@ -91,6 +91,14 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
 
   DEBUGASSERT(list1 != NULL && list2 != NULL);
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The indexed ready-to-run list may only be modified via sched_rtradd()
+   * and sched_rtrremove().  See sched_mergepending().
+   */
+
+  DEBUGASSERT(list2 != (FAR dq_queue_t *)&g_readytorun);
+#endif
+
   /* Get a private copy of list1, clearing list1.  We do this early so that
    * we can be assured that the list is stationary before we start any
    * operations on it.
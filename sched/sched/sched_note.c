@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -65,6 +67,7 @@ struct note_info_s
 {
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
+  volatile uint32_t ni_dropped;    /* Notes overwritten before being read */
   uint8_t ni_buffer[CONFIG_SCHED_NOTE_BUFSIZE];
 };
 
@@ -82,6 +85,16 @@ struct note_startalloc_s
 #  define SIZEOF_NOTE_START(n) (sizeof(struct note_start_s))
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+struct note_stringalloc_s
+{
+  struct note_common_s nsa_cmn; /* Common note parameters */
+  char nsa_data[CONFIG_SCHED_NOTE_STRING_SIZE];
+};
+
+#  define SIZEOF_NOTE_STRING(n) (sizeof(struct note_string_s) + (n) - 1)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -327,6 +340,7 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
           /* Yes, then remove the note at the tail index */
 
           note_remove();
+          g_note_info.ni_dropped++;
         }
 
       /* Save the next byte at the head index */
@@ -345,6 +359,50 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
 #endif
 }
 
+/****************************************************************************
+ * Name: note_string
+ *
+ * Description:
+ *   Add a user trace point note whose NUL terminated string has already
+ *   been placed in the note.  Unlike the scheduler hooks, this may be
+ *   called outside of a critical section.
+ *
+ * Input Parameters:
+ *   note - The note with the string in place
+ *   type - The type of the note
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+static void note_string(FAR struct note_stringalloc_s *note, uint8_t type)
+{
+  unsigned int length;
+#ifndef CONFIG_SMP
+  irqstate_t flags;
+#endif
+
+  length = SIZEOF_NOTE_STRING(strlen(note->nsa_data) + 1);
+
+#ifndef CONFIG_SMP
+  /* note_add() relies on the caller to exclude other producers; in the SMP
+   * case it takes care of that itself.
+   */
+
+  flags = up_irq_save();
+#endif
+
+  note_common(this_task(), &note->nsa_cmn, length, type);
+  note_add((FAR const uint8_t *)note, length);
+
+#ifndef CONFIG_SMP
+  up_irq_restore(flags);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -386,7 +444,7 @@ void sched_note_start(FAR struct tcb_s *tcb)
 
   length = SIZEOF_NOTE_START(namelen + 1);
 #else
-  length = SIZEOF_NOTE_START(0)
+  length = SIZEOF_NOTE_START(0);
 #endif
 
   /* Finish formatting the note */
@@ -586,6 +644,40 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+void sched_note_printf(FAR const char *fmt, ...)
+{
+  struct note_stringalloc_s note;
+  va_list ap;
+
+  /* Format directly into the note */
+
+  va_start(ap, fmt);
+  (void)vsnprintf(note.nsa_data, CONFIG_SCHED_NOTE_STRING_SIZE, fmt, ap);
+  va_end(ap);
+
+  note_string(&note, NOTE_DUMP_STRING);
+}
+
+void sched_note_begin(FAR const char *name)
+{
+  struct note_stringalloc_s note;
+
+  strncpy(note.nsa_data, name, CONFIG_SCHED_NOTE_STRING_SIZE - 1);
+  note.nsa_data[CONFIG_SCHED_NOTE_STRING_SIZE - 1] = '\0';
+  note_string(&note, NOTE_DUMP_BEGIN);
+}
+
+void sched_note_end(FAR const char *name)
+{
+  struct note_stringalloc_s note;
+
+  strncpy(note.nsa_data, name, CONFIG_SCHED_NOTE_STRING_SIZE - 1);
+  note.nsa_data[CONFIG_SCHED_NOTE_STRING_SIZE - 1] = '\0';
+  note_string(&note, NOTE_DUMP_END);
+}
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
@@ -726,4 +818,26 @@ errout_with_csection:
 }
 #endif
 
+/****************************************************************************
+ * Name: sched_note_dropped
+ *
+ * Description:
+ *   Return the number of notes that have been overwritten in the circular
+ *   buffer before they could be read.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   The total (free-running) number of notes lost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+uint32_t sched_note_dropped(void)
+{
+  return g_note_info.ni_dropped;
+}
+#endif
+
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
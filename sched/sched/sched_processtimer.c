@@ -213,6 +213,14 @@ void sched_process_timer(void)
     }
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* Charge the running task for its execution time before the cycle
+   * counter can wrap.
+   */
+
+  sched_cputime_process();
+#endif
+
   /* Process watchdogs */
 
   wd_timer();
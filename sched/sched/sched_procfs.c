@@ -0,0 +1,861 @@
+/****************************************************************************
+ * sched/sched/sched_procfs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+#if defined(CONFIG_SPINLOCK_SUBSYS_STATISTICS) || defined(CONFIG_WDOG_SLACK)
+#  include "wdog/wdog.h"
+#endif
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+#  ifndef CONFIG_DISABLE_MQUEUE
+#    include "mqueue/mqueue.h"
+#  endif
+#  ifndef CONFIG_DISABLE_SIGNALS
+#    include "signal/signal.h"
+#  endif
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+#  include "pthread/pthread.h"
+#endif
+#if defined(CONFIG_SIG_FASTPATH) && !defined(CONFIG_SPINLOCK_SUBSYS_STATISTICS)
+#  include "signal/signal.h"
+#endif
+#ifdef CONFIG_PAGING
+#  include "paging/paging.h"
+#endif
+#ifdef CONFIG_SYSCALL_STATS
+#  include <syscall.h>
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic (plus a couple of
+ * bytes).
+ */
+
+#define SCHED_LINELEN 64
+
+/* Are there any scheduler procfs nodes? */
+
+#undef HAVE_SCHED_PROCFS
+#if defined(CONFIG_SCHED_LOADBALANCE) || \
+    defined(CONFIG_SPINLOCK_SUBSYS_STATISTICS) || \
+    defined(CONFIG_SCHED_LATENCY) || defined(CONFIG_WDOG_SLACK) || \
+    defined(CONFIG_PTHREAD_MUTEX_ADAPTIVE) || defined(CONFIG_SIG_FASTPATH) || \
+    defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_PAGING) || \
+    defined(CONFIG_SYSCALL_STATS)
+#  define HAVE_SCHED_PROCFS 1
+#endif
+
+#ifdef HAVE_SCHED_PROCFS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct sched_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  FAR const struct sched_node_s *node; /* The node that was opened */
+  FAR char *buffer;           /* User provided buffer */
+  size_t remaining;           /* Number of available characters in buffer */
+  size_t ncopied;             /* Number of characters in buffer */
+  off_t offset;               /* Current file offset */
+  char line[SCHED_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure describes one scheduler procfs node */
+
+typedef void (*sched_gen_t)(FAR struct sched_file_s *schedfile);
+
+struct sched_node_s
+{
+  FAR const char *relpath;    /* Relative path to the node */
+  sched_gen_t generate;       /* Generates the node content */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Content generators */
+
+static void    sched_printf(FAR struct sched_file_s *schedfile,
+                 FAR const IPTR char *fmt, ...);
+#ifdef CONFIG_SCHED_LOADBALANCE
+static void    sched_balance_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+static void    sched_locks_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_SCHED_LATENCY
+static void    sched_latency_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_WDOG_SLACK
+static void    sched_wdog_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+static void    sched_mutex_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_SIG_FASTPATH
+static void    sched_signal_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+static void    sched_critmon_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_PAGING
+static void    sched_paging_generate(FAR struct sched_file_s *schedfile);
+#endif
+#ifdef CONFIG_SYSCALL_STATS
+static void    sched_syscall_generate(FAR struct sched_file_s *schedfile);
+#endif
+
+/* File system methods */
+
+static int     sched_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     sched_close(FAR struct file *filep);
+static ssize_t sched_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     sched_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     sched_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Table of all scheduler procfs nodes */
+
+static const struct sched_node_s g_sched_nodes[] =
+{
+#ifdef CONFIG_SCHED_LOADBALANCE
+  { "sched/balance", sched_balance_generate },
+#endif
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+  { "sched/locks",   sched_locks_generate },
+#endif
+#ifdef CONFIG_SCHED_LATENCY
+  { "sched/latency", sched_latency_generate },
+#endif
+#ifdef CONFIG_WDOG_SLACK
+  { "sched/wdog",    sched_wdog_generate },
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+  { "sched/mutex",   sched_mutex_generate },
+#endif
+#ifdef CONFIG_SIG_FASTPATH
+  { "sched/signal",  sched_signal_generate },
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+  { "sched/critmon", sched_critmon_generate },
+#endif
+#ifdef CONFIG_PAGING
+  { "sched/paging",  sched_paging_generate },
+#endif
+#ifdef CONFIG_SYSCALL_STATS
+  { "sched/syscall", sched_syscall_generate },
+#endif
+};
+
+#define SCHED_NNODES (sizeof(g_sched_nodes) / sizeof(struct sched_node_s))
+
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+/* Table of all subsystem locks */
+
+static FAR struct subsys_lock_s * const g_sched_locks[] =
+{
+#ifdef HAVE_WDOG_LOCK
+  &g_wdlock,
+#endif
+#ifdef HAVE_SEM_COUNTLOCK
+  &g_semlock,
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+  &g_mqlock,
+#endif
+#ifndef CONFIG_DISABLE_SIGNALS
+  &g_siglock,
+#endif
+};
+
+#define SCHED_NLOCKS (sizeof(g_sched_locks) / sizeof(FAR struct subsys_lock_s *))
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations sched_procfsoperations =
+{
+  sched_open,     /* open */
+  sched_close,    /* close */
+  sched_read,     /* read */
+  NULL,           /* write */
+
+  sched_dup,      /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  sched_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_findnode
+ ****************************************************************************/
+
+static FAR const struct sched_node_s *sched_findnode(FAR const char *relpath)
+{
+  int i;
+
+  for (i = 0; i < SCHED_NNODES; i++)
+    {
+      if (strcmp(relpath, g_sched_nodes[i].relpath) == 0)
+        {
+          return &g_sched_nodes[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: sched_printf
+ *
+ * Description:
+ *   Format one line of output and copy it to the user buffer, honoring the
+ *   current file offset.
+ *
+ ****************************************************************************/
+
+static void sched_printf(FAR struct sched_file_s *schedfile,
+                         FAR const IPTR char *fmt, ...)
+{
+  va_list ap;
+  size_t linesize;
+  size_t copysize;
+
+  va_start(ap, fmt);
+  linesize = vsnprintf(schedfile->line, SCHED_LINELEN, fmt, ap);
+  va_end(ap);
+
+  if (linesize >= SCHED_LINELEN)
+    {
+      linesize = SCHED_LINELEN - 1;
+    }
+
+  copysize = procfs_memcpy(schedfile->line, linesize, schedfile->buffer,
+                           schedfile->remaining, &schedfile->offset);
+
+  schedfile->ncopied   += copysize;
+  schedfile->buffer    += copysize;
+  schedfile->remaining -= copysize;
+}
+
+/****************************************************************************
+ * Name: sched_balance_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/balance.  Output format:
+ *
+ *   CPU      SCANS     PULLED     STOLEN
+ *   DDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOADBALANCE
+static void sched_balance_generate(FAR struct sched_file_s *schedfile)
+{
+  int cpu;
+
+  sched_printf(schedfile, "CPU      SCANS     PULLED     STOLEN\n");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && schedfile->remaining > 0; cpu++)
+    {
+      sched_printf(schedfile, "%3d %10lu %10lu %10lu\n", cpu,
+                   (unsigned long)g_balance[cpu].scans,
+                   (unsigned long)g_balance[cpu].pulled,
+                   (unsigned long)g_balance[cpu].stolen);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_locks_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/locks.  Output format:
+ *
+ *   LOCK       ACQUIRED  CONTENDED      SPINS
+ *   SSSSSSS  DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+static void sched_locks_generate(FAR struct sched_file_s *schedfile)
+{
+  FAR struct subsys_lock_s *lock;
+  int i;
+
+  sched_printf(schedfile, "LOCK       ACQUIRED  CONTENDED      SPINS\n");
+
+  for (i = 0; i < SCHED_NLOCKS && schedfile->remaining > 0; i++)
+    {
+      lock = g_sched_locks[i];
+      sched_printf(schedfile, "%-7s  %10lu %10lu %10lu\n", lock->sl_name,
+                   (unsigned long)lock->sl_acquired,
+                   (unsigned long)lock->sl_contended,
+                   (unsigned long)lock->sl_spins);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_latency_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/latency.  There is one column for
+ *   each histogram bucket, headed by the upper bound of the bucket in
+ *   microseconds.  Only priority bands with recorded samples are shown.
+ *   Output format:
+ *
+ *   PRIO          2        4        8 ...      INF
+ *   DDD-DDD DDDDDDDD DDDDDDDD DDDDDDDD ... DDDDDDDD
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+static void sched_latency_generate(FAR struct sched_file_s *schedfile)
+{
+  FAR uint32_t *counts;
+  int band;
+  int i;
+
+  sched_printf(schedfile, "PRIO   ");
+  for (i = 0; i < CONFIG_SCHED_LATENCY_NBUCKETS - 1; i++)
+    {
+      sched_printf(schedfile, " %8lu", 2ul << i);
+    }
+
+  sched_printf(schedfile, "      INF\n");
+
+  for (band = 0;
+       band < SCHED_LATENCY_NBANDS && schedfile->remaining > 0;
+       band++)
+    {
+      counts = g_latency[band];
+
+      for (i = 0; i < CONFIG_SCHED_LATENCY_NBUCKETS; i++)
+        {
+          if (counts[i] != 0)
+            {
+              break;
+            }
+        }
+
+      if (i < CONFIG_SCHED_LATENCY_NBUCKETS)
+        {
+          sched_printf(schedfile, "%3d-%3d",
+                       band << CONFIG_SCHED_LATENCY_PRIOSHIFT,
+                       ((band + 1) << CONFIG_SCHED_LATENCY_PRIOSHIFT) - 1);
+
+          for (i = 0; i < CONFIG_SCHED_LATENCY_NBUCKETS; i++)
+            {
+              sched_printf(schedfile, " %8lu", (unsigned long)counts[i]);
+            }
+
+          sched_printf(schedfile, "\n");
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_wdog_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/wdog.  Output format:
+ *
+ *    COALESCED SLACKTICKS
+ *   DDDDDDDDDD DDDDDDDDDD
+ *
+ *   COALESCED is the number of watchdogs that were deferred onto the
+ *   expiration of another watchdog, i.e., the number of wakeups saved.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_SLACK
+static void sched_wdog_generate(FAR struct sched_file_s *schedfile)
+{
+  sched_printf(schedfile, " COALESCED SLACKTICKS\n");
+  sched_printf(schedfile, "%10lu %10lu\n",
+               (unsigned long)g_wdcoalesced,
+               (unsigned long)g_wdslackticks);
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_mutex_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/mutex.  Output format:
+ *
+ *   CPU  CONTENDED   ACQUIRED    BLOCKED      SPINS
+ *   DDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ *   CONTENDED is the number of adaptive mutex locks that found the mutex
+ *   held.  Of those, ACQUIRED saw the mutex released while spinning and
+ *   BLOCKED gave up spinning.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_MUTEX_ADAPTIVE
+static void sched_mutex_generate(FAR struct sched_file_s *schedfile)
+{
+  FAR struct pthread_spinstats_s *stats;
+  int cpu;
+
+  sched_printf(schedfile,
+               "CPU  CONTENDED   ACQUIRED    BLOCKED      SPINS\n");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && schedfile->remaining > 0; cpu++)
+    {
+      stats = &g_mutex_spinstats[cpu];
+      sched_printf(schedfile, "%3d %10lu %10lu %10lu %10lu\n", cpu,
+                   (unsigned long)stats->contended,
+                   (unsigned long)stats->acquired,
+                   (unsigned long)stats->blocked,
+                   (unsigned long)stats->spins);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_signal_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/signal.  Output format:
+ *
+ *     HANDOFFS     QUEUED
+ *   DDDDDDDDDD DDDDDDDDDD
+ *
+ *   HANDOFFS is the number of signals handed directly to a thread waiting
+ *   in sigtimedwait().  QUEUED is the number that took the normal path.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIG_FASTPATH
+static void sched_signal_generate(FAR struct sched_file_s *schedfile)
+{
+  sched_printf(schedfile, "  HANDOFFS     QUEUED\n");
+  sched_printf(schedfile, "%10lu %10lu\n",
+               (unsigned long)g_sigstats.handoffs,
+               (unsigned long)g_sigstats.queued);
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_critmon_cycles2usec and sched_critmon_task
+ *
+ * Description:
+ *   Helpers for sched_critmon_generate().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+static unsigned long sched_critmon_cycles2usec(uint32_t cycles)
+{
+  uint32_t freq = up_cyclefreq();
+
+  if (freq == 0)
+    {
+      return 0;
+    }
+
+  return (unsigned long)(((uint64_t)cycles * 1000000) / freq);
+}
+
+static void sched_critmon_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct sched_file_s *schedfile = (FAR struct sched_file_s *)arg;
+
+  if (schedfile->remaining > 0 &&
+      (tcb->crit_max != 0 || tcb->premp_max != 0))
+    {
+      sched_printf(schedfile, "%5d %10lu %10lu\n", (int)tcb->pid,
+                   sched_critmon_cycles2usec(tcb->crit_max),
+                   sched_critmon_cycles2usec(tcb->premp_max));
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/critmon.  The longest critical
+ *   sections and pre-emption disabled sections with the address from which
+ *   they were entered come first, then the worst case of each task.  All
+ *   times are in microseconds.  Output format:
+ *
+ *   TYPE     PID   CALLER       TIME
+ *   CSECT  DDDDD XXXXXXXX DDDDDDDDDD
+ *   PREEMP DDDDD XXXXXXXX DDDDDDDDDD
+ *
+ *     PID   CSECTION    PREEMPT
+ *   DDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ ****************************************************************************/
+
+static void sched_critmon_generate(FAR struct sched_file_s *schedfile)
+{
+  struct critmon_worst_s worst[CONFIG_SCHED_CRITMONITOR_NWORST];
+  irqstate_t flags;
+  int i;
+
+  /* Take a consistent snapshot of the list */
+
+  flags = enter_critical_section();
+  memcpy(worst, g_critmon_worst, sizeof(worst));
+  leave_critical_section(flags);
+
+  sched_printf(schedfile, "TYPE     PID   CALLER       TIME\n");
+
+  for (i = 0;
+       i < CONFIG_SCHED_CRITMONITOR_NWORST && worst[i].cycles != 0 &&
+       schedfile->remaining > 0;
+       i++)
+    {
+      sched_printf(schedfile, "%-6s %5d %08lx %10lu\n",
+                   worst[i].type == CRITMON_CSECTION ? "CSECT" : "PREEMP",
+                   (int)worst[i].pid,
+                   (unsigned long)((uintptr_t)worst[i].caller),
+                   sched_critmon_cycles2usec(worst[i].cycles));
+    }
+
+  sched_printf(schedfile, "\n  PID   CSECTION    PREEMPT\n");
+  sched_foreach(sched_critmon_task, schedfile);
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_paging_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/paging.  Output format:
+ *
+ *       FAULTS      FILLS  READAHEAD     MAPPED  FILLTICKS
+ *   DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ *   FILLS counts the pages filled for faulting tasks and READAHEAD those
+ *   filled ahead of a fault.  MAPPED counts faults that found the page
+ *   already mapped, typically because it was read ahead.  FILLTICKS is the
+ *   total time spent in fills.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING
+static void sched_paging_generate(FAR struct sched_file_s *schedfile)
+{
+  struct pg_stats_s stats;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  stats = g_pgstats;
+  leave_critical_section(flags);
+
+  sched_printf(schedfile,
+               "    FAULTS      FILLS  READAHEAD     MAPPED  FILLTICKS\n");
+  sched_printf(schedfile, "%10lu %10lu %10lu %10lu %10lu\n",
+               (unsigned long)stats.faults,
+               (unsigned long)stats.fills,
+               (unsigned long)stats.readahead,
+               (unsigned long)stats.mapped,
+               (unsigned long)stats.fillticks);
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_syscall_generate
+ *
+ * Description:
+ *   Generate the content of /proc/sched/syscall.  Output format:
+ *
+ *   NAME                          COUNT    AVGUSEC    MAXUSEC
+ *   SSSSSSSSSSSSSSSSSSSSSSSS DDDDDDDDDD DDDDDDDDDD DDDDDDDDDD
+ *
+ *   Only the system calls that have been called are listed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_STATS
+static void sched_syscall_generate(FAR struct sched_file_s *schedfile)
+{
+  struct syscall_stats_s stats;
+  uint32_t freq = up_cyclefreq() / 1000000;
+  irqstate_t flags;
+  int nbr;
+
+  if (freq == 0)
+    {
+      freq = 1;
+    }
+
+  sched_printf(schedfile,
+               "NAME                          COUNT    AVGUSEC    MAXUSEC\n");
+
+  for (nbr = 0; nbr < SYS_nsyscalls && schedfile->remaining > 0; nbr++)
+    {
+      flags = enter_critical_section();
+      stats = g_syscallstats[nbr];
+      leave_critical_section(flags);
+
+      if (stats.count > 0)
+        {
+          sched_printf(schedfile, "%-24.24s %10lu %10lu %10lu\n",
+                       g_syscallnames[nbr],
+                       (unsigned long)stats.count,
+                       (unsigned long)(stats.cycles / stats.count / freq),
+                       (unsigned long)(stats.maxcycles / freq));
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_open
+ ****************************************************************************/
+
+static int sched_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR const struct sched_node_s *node;
+  FAR struct sched_file_s *schedfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  node = sched_findnode(relpath);
+  if (node == NULL)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  schedfile = (FAR struct sched_file_s *)
+    kmm_zalloc(sizeof(struct sched_file_s));
+
+  if (!schedfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  schedfile->node = node;
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)schedfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_close
+ ****************************************************************************/
+
+static int sched_close(FAR struct file *filep)
+{
+  FAR struct sched_file_s *schedfile;
+
+  /* Recover our private data from the struct file instance */
+
+  schedfile = (FAR struct sched_file_s *)filep->f_priv;
+  DEBUGASSERT(schedfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(schedfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_read
+ ****************************************************************************/
+
+static ssize_t sched_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct sched_file_s *schedfile;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  schedfile = (FAR struct sched_file_s *)filep->f_priv;
+  DEBUGASSERT(schedfile && schedfile->node);
+
+  /* Save the file offset and the user buffer information */
+
+  schedfile->offset    = filep->f_pos;
+  schedfile->buffer    = buffer;
+  schedfile->remaining = buflen;
+  schedfile->ncopied   = 0;
+
+  /* Generate the node content */
+
+  schedfile->node->generate(schedfile);
+
+  /* Update the file position */
+
+  filep->f_pos += schedfile->ncopied;
+  return schedfile->ncopied;
+}
+
+/****************************************************************************
+ * Name: sched_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int sched_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct sched_file_s *oldattr;
+  FAR struct sched_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct sched_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct sched_file_s *)
+    kmm_malloc(sizeof(struct sched_file_s));
+
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct sched_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int sched_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  if (sched_findnode(relpath) == NULL)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* All scheduler nodes are read-only files */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* HAVE_SCHED_PROCFS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
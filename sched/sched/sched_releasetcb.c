@@ -160,7 +160,7 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
           if ((tcb->flags & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_KERNEL)
 #endif
             {
-              up_release_stack(tcb, ttype);
+              sched_release_stack(tcb, ttype);
             }
         }
 
@@ -200,7 +200,7 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* And, finally, release the TCB itself */
 
-      sched_kfree(tcb);
+      sched_tcbfree(tcb);
     }
 
   return ret;
@@ -87,4 +87,10 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_INVALID;
+
+#ifdef CONFIG_SCHED_LATENCY
+  /* The task is about to be made ready-to-run */
+
+  sched_latency_ready(btcb);
+#endif
 }
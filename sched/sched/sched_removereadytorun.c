@@ -101,7 +101,11 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  sched_rtrremove(rtcb);
+#else
   dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -136,13 +140,10 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 {
   FAR dq_queue_t *tasklist;
+  irqstate_t lock;
   bool doswitch = false;
   int cpu;
 
-  /* Lock the tasklists before accessing */
-
-  irqstate_t lock = sched_tasklist_lock();
-
   /* Which CPU (if any) is the task running on?  Which task list holds the
    * TCB?
    */
@@ -150,6 +151,17 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
   cpu      = rtcb->cpu;
   tasklist = TLIST_HEAD(rtcb->task_state, cpu);
 
+  /* Lock the tasklists before accessing.  With per-CPU ready-to-run lists,
+   * the TCB must be in the g_assignedtasks[] list of its CPU.
+   */
+
+#ifdef CONFIG_SCHED_PERCPU_READYTORUN
+  DEBUGASSERT(rtcb->task_state == TSTATE_TASK_RUNNING ||
+              rtcb->task_state == TSTATE_TASK_ASSIGNED);
+#endif
+
+  lock = sched_tasklist_lock();
+
   /* Check if the TCB to be removed is at the head of a ready-to-run list.
    * For the case of SMP, there are two lists involved:  (1) the
    * g_readytorun list that holds non-running tasks that have not been
@@ -208,6 +220,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * REVISIT: What if it is not the IDLE thread?
        */
 
+#ifndef CONFIG_SCHED_PERCPU_READYTORUN
       if (!sched_islocked_global() && !irq_cpu_locked(me))
         {
           /* Search for the highest priority task that can run on this
@@ -218,6 +231,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
                rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
                rtrtcb = (FAR struct tcb_s *)rtrtcb->flink);
         }
+#endif
 
       /* Did we find a task in the g_readytorun list?  Which task should
        * we use?  We decide strictly by the priority of the two tasks:
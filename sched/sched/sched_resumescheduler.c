@@ -49,7 +49,9 @@
 #include "sched/sched.h"
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
-    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SMP)
+    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SMP) || \
+    defined(CONFIG_SCHED_LATENCY) || defined(CONFIG_SCHED_CPUTIME) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Functions
@@ -102,6 +104,24 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
   sched_note_resume(tcb);
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+  /* Account for the time that the task waited to run */
+
+  sched_latency_resume(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+  /* Start charging execution time to the task */
+
+  sched_cputime_resume(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Restart the clock of any critical section held by the task */
+
+  sched_critmon_resume(tcb);
+#endif
+
 #ifdef CONFIG_SMP
   /* NOTE: The following logic for adjusting global IRQ controls were
    * derived from sched_addreadytorun() and sched_removedreadytorun()
@@ -142,4 +162,6 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
 }
 
 #endif /* CONFIG_RR_INTERVAL > 0 || CONFIG_SCHED_SPORADIC || \
-        * CONFIG_SCHED_INSTRUMENTATION || CONFIG_SMP */
+        * CONFIG_SCHED_INSTRUMENTATION || CONFIG_SMP || \
+        * CONFIG_SCHED_LATENCY || CONFIG_SCHED_CPUTIME || \
+        * CONFIG_SCHED_CRITMONITOR */
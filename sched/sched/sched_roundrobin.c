@@ -112,6 +112,16 @@ uint32_t sched_roundrobin_process(FAR struct tcb_s *tcb, uint32_t ticks,
    */
 
   DEBUGASSERT(tcb != NULL);
+
+#ifdef CONFIG_SMP_ISOLCPUS
+  /* There is no time slicing on an isolated CPU */
+
+  if (sched_cpu_isolated(tcb->cpu))
+    {
+      return 0;
+    }
+#endif
+
   decr = MIN(tcb->timeslice, ticks);
 
   /* Decrement the timeslice counter */
@@ -0,0 +1,311 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of priorities and the number of 32-bit words in the priority
+ * bitmap.  The summary bitmap holds one bit for each word, so there may be
+ * at most 8 words (i.e., 256 priorities).
+ */
+
+#define RTRMAP_NPRIOS     (SCHED_PRIORITY_MAX + 1)
+#define RTRMAP_NWORDS     ((RTRMAP_NPRIOS + 31) >> 5)
+
+#if RTRMAP_NWORDS > 8
+#  error SCHED_PRIORITY_MAX is too large for the ready-to-run bitmap
+#endif
+
+#define RTRMAP_WORD(p)    ((p) >> 5)
+#define RTRMAP_BIT(p)     ((uint32_t)1 << ((p) & 31))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure indexes the ready-to-run list by priority.  The list
+ * itself is still the doubly linked g_readytorun list in descending order
+ * of priority so all logic that traverses the list is unaffected.
+ */
+
+struct sched_rtrmap_s
+{
+  uint8_t  summary;                      /* Bit n set if map[n] != 0 */
+  uint32_t map[RTRMAP_NWORDS];           /* Bit p set if a task of priority
+                                          * p is in the list */
+  FAR struct tcb_s *first[RTRMAP_NPRIOS]; /* First task of each priority */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sched_rtrmap_s g_rtrmap;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_rtrbelow
+ *
+ * Description:
+ *   Return the highest priority of any task in the ready-to-run list that
+ *   is strictly lower than 'prio' or -1 if there is no such task.
+ *
+ ****************************************************************************/
+
+static int sched_rtrbelow(int prio)
+{
+  uint32_t bits;
+  uint8_t summary;
+  int word;
+
+  if (prio <= 0)
+    {
+      return -1;
+    }
+
+  /* Look first in the word containing priority prio - 1 */
+
+  prio--;
+  word = RTRMAP_WORD(prio);
+  bits = g_rtrmap.map[word] & ((uint32_t)0xffffffff >> (31 - (prio & 31)));
+
+  if (bits == 0)
+    {
+      /* Then find the next lower, non-empty word in the summary bitmap */
+
+      summary = g_rtrmap.summary & (uint8_t)((1 << word) - 1);
+      if (summary == 0)
+        {
+          return -1;
+        }
+
+      word = fls(summary) - 1;
+      bits = g_rtrmap.map[word];
+    }
+
+  return (word << 5) + flsl((long)bits) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_rtradd
+ *
+ * Description:
+ *   Add a TCB to the ready-to-run list, behind all other tasks of the same
+ *   priority, and update the priority index.  This is the indexed
+ *   equivalent of sched_addprioritized() for the g_readytorun list.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to the ready-to-run list
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ * - The caller has already removed the input tcb from whatever list it
+ *   was in.
+ * - The caller must set the task_state field of the TCB.
+ *
+ ****************************************************************************/
+
+bool sched_rtradd(FAR struct tcb_s *tcb)
+{
+  int prio = tcb->sched_priority;
+  int lower;
+
+  DEBUGASSERT(prio >= SCHED_PRIORITY_MIN && prio < RTRMAP_NPRIOS);
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE threads in the CONFIG_SCHED_DEADLINE_PRIORITY band are
+   * maintained in ascending absolute deadline order.
+   */
+
+  if (sched_isdeadline(tcb) &&
+      (g_rtrmap.map[RTRMAP_WORD(prio)] & RTRMAP_BIT(prio)) != 0)
+    {
+      FAR struct tcb_s *next;
+
+      for (next = g_rtrmap.first[prio];
+           next != NULL && next->sched_priority == prio;
+           next = next->flink)
+        {
+          if (sched_deadline_before(tcb, next))
+            {
+              dq_addbefore((FAR dq_entry_t *)next, (FAR dq_entry_t *)tcb,
+                           (FAR dq_queue_t *)&g_readytorun);
+
+              if (g_rtrmap.first[prio] == next)
+                {
+                  g_rtrmap.first[prio] = tcb;
+                }
+
+              return (FAR struct tcb_s *)g_readytorun.head == tcb;
+            }
+        }
+    }
+#endif
+
+  /* The new TCB goes just before the first TCB of the next lower priority.
+   * If there is no lower priority TCB then it goes at the end of the list.
+   */
+
+  lower = sched_rtrbelow(prio);
+  if (lower >= 0)
+    {
+      dq_addbefore((FAR dq_entry_t *)g_rtrmap.first[lower],
+                   (FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+    }
+  else
+    {
+      dq_addlast((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+    }
+
+  /* If this is the only TCB of its priority, then it is also the first */
+
+  if ((g_rtrmap.map[RTRMAP_WORD(prio)] & RTRMAP_BIT(prio)) == 0)
+    {
+      g_rtrmap.map[RTRMAP_WORD(prio)] |= RTRMAP_BIT(prio);
+      g_rtrmap.summary                |= (uint8_t)(1 << RTRMAP_WORD(prio));
+      g_rtrmap.first[prio]             = tcb;
+    }
+
+  return (FAR struct tcb_s *)g_readytorun.head == tcb;
+}
+
+/****************************************************************************
+ * Name: sched_rtrremove
+ *
+ * Description:
+ *   Remove a TCB from the ready-to-run list and update the priority index.
+ *   The priority of the TCB must not have changed since it was added.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the ready-to-run list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_rtrremove(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *next;
+  int prio = tcb->sched_priority;
+
+  DEBUGASSERT((g_rtrmap.map[RTRMAP_WORD(prio)] & RTRMAP_BIT(prio)) != 0);
+
+  if (g_rtrmap.first[prio] == tcb)
+    {
+      /* Is there another TCB of the same priority?  It would have to be the
+       * next one in the list.
+       */
+
+      next = (FAR struct tcb_s *)tcb->flink;
+      if (next != NULL && next->sched_priority == prio)
+        {
+          g_rtrmap.first[prio] = next;
+        }
+      else
+        {
+          g_rtrmap.first[prio] = NULL;
+          g_rtrmap.map[RTRMAP_WORD(prio)] &= ~RTRMAP_BIT(prio);
+          if (g_rtrmap.map[RTRMAP_WORD(prio)] == 0)
+            {
+              g_rtrmap.summary &= (uint8_t)~(1 << RTRMAP_WORD(prio));
+            }
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+}
+
+/****************************************************************************
+ * Name: sched_rtrhighest
+ *
+ * Description:
+ *   Return the priority of the highest priority task in the ready-to-run
+ *   list (or -1 if the list is empty).
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The highest ready-to-run priority.
+ *
+ ****************************************************************************/
+
+int sched_rtrhighest(void)
+{
+  int word;
+
+  if (g_rtrmap.summary == 0)
+    {
+      return -1;
+    }
+
+  word = fls(g_rtrmap.summary) - 1;
+  return (word << 5) + flsl((long)g_rtrmap.map[word]) - 1;
+}
+
+#endif /* CONFIG_SCHED_READYTORUN_BITMAP */
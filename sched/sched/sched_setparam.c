@@ -134,6 +134,19 @@ int nxsched_setparam(pid_t pid, FAR const struct sched_param *param)
 #ifdef CONFIG_SCHED_SPORADIC
   /* Update parameters associated with SCHED_SPORADIC */
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* The SCHED_DEADLINE parameters can only be changed via
+   * sched_setscheduler() and all SCHED_DEADLINE threads run at the same
+   * priority, CONFIG_SCHED_DEADLINE_PRIORITY.  There is nothing to change.
+   */
+
+  if (sched_isdeadline(tcb))
+    {
+      ret = OK;
+      goto errout_with_lock;
+    }
+  else
+#endif
   if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
     {
       FAR struct sporadic_s *sporadic;
@@ -48,6 +48,7 @@
 
 #include "irq/irq.h"
 #include "sched/sched.h"
+#include "semaphore/semaphore.h"
 
 /****************************************************************************
  * Private Functions
@@ -164,9 +165,20 @@ static inline void sched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      /* Change the task priority.  The task remains at the head of the
+       * ready-to-run list but its entry in the priority index must be
+       * moved.
+       */
+
+      sched_rtrremove(tcb);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      (void)sched_rtradd(tcb);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -298,6 +310,16 @@ static inline void sched_blocked_setpriority(FAR struct tcb_s *tcb,
       /* Put it back into the prioritized list at the correct position. */
 
       sched_addprioritized(tcb, tasklist);
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+      /* The semaphore's own list of waiters must keep the same order */
+
+      if (task_state == TSTATE_WAIT_SEM && tcb->waitsem != NULL)
+        {
+          nxsem_remwaiter(tcb->waitsem, tcb);
+          nxsem_addwaiter(tcb->waitsem, tcb);
+        }
+#endif
     }
 
   /* CASE 3b. The task resides in a non-prioritized list. */
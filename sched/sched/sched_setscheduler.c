@@ -88,6 +88,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control failed.
  *
  ****************************************************************************/
 
@@ -96,6 +97,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+#ifdef CONFIG_SCHED_SPORADIC
+  uint16_t oldpolicy;
+#endif
   int ret;
 
   /* Check for supported scheduling policy */
@@ -106,6 +110,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -136,6 +143,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+#ifdef CONFIG_SCHED_SPORADIC
+  oldpolicy   = tcb->flags & TCB_FLAG_POLICY_MASK;
+#endif
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -148,7 +158,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #ifdef CONFIG_SCHED_SPORADIC
           /* Cancel any on-going sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               DEBUGVERIFY(sched_sporadic_stop(tcb));
             }
@@ -168,7 +178,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #ifdef CONFIG_SCHED_SPORADIC
           /* Cancel any on-going sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               DEBUGVERIFY(sched_sporadic_stop(tcb));
             }
@@ -231,7 +241,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 
           /* Initialize/reset current sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               ret = sched_sporadic_reset(tcb);
             }
@@ -271,6 +281,106 @@ int nxsched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          FAR struct sporadic_s *sporadic;
+          ssystime_t runtime_ticks;
+          ssystime_t deadline_ticks;
+          ssystime_t period_ticks;
+          int bandwidth;
+
+          /* Convert timespec values to system clock ticks */
+
+          (void)clock_time2ticks(&param->sched_dl_runtime, &runtime_ticks);
+          (void)clock_time2ticks(&param->sched_dl_deadline, &deadline_ticks);
+          (void)clock_time2ticks(&param->sched_dl_period, &period_ticks);
+
+          /* A zero deadline means that the deadline is the end of the
+           * period.
+           */
+
+          if (deadline_ticks < 1)
+            {
+              deadline_ticks = period_ticks;
+            }
+
+          /* We require runtime <= deadline <= period.
+           *
+           * REVISIT: As for SCHED_SPORADIC, the sporadic server
+           * replenishment logic cannot honour a budget that exceeds half
+           * of the period.
+           */
+
+          if (runtime_ticks < 1 || runtime_ticks > deadline_ticks ||
+              deadline_ticks > period_ticks ||
+              period_ticks < (2 * runtime_ticks))
+            {
+              ret = -EINVAL;
+              goto errout_with_irq;
+            }
+
+          /* Admission control */
+
+          bandwidth = sched_deadline_check(tcb, runtime_ticks, period_ticks);
+          if (bandwidth < 0)
+            {
+              ret = bandwidth;
+              goto errout_with_irq;
+            }
+
+          /* Initialize/reset current sporadic scheduling */
+
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
+            {
+              ret = sched_sporadic_reset(tcb);
+            }
+          else
+            {
+              ret = sched_sporadic_initialize(tcb);
+            }
+
+          /* A SCHED_DEADLINE thread is a sporadic thread with a single
+           * replenishment:  It runs at CONFIG_SCHED_DEADLINE_PRIORITY for
+           * its runtime in each period, then at the low priority for the
+           * remainder of the period.  The absolute deadline is set at the
+           * start of each period.  param->sched_priority is ignored:  All
+           * SCHED_DEADLINE threads share one priority so that they are
+           * ordered only by their absolute deadlines.
+           */
+
+          if (ret >= 0)
+            {
+              tcb->flags            |= TCB_FLAG_SCHED_SPORADIC;
+              tcb->timeslice         = runtime_ticks;
+
+              sporadic               = tcb->sporadic;
+              DEBUGASSERT(sporadic != NULL);
+
+              sporadic->hi_priority  = CONFIG_SCHED_DEADLINE_PRIORITY;
+              sporadic->low_priority = SCHED_PRIORITY_MIN;
+              sporadic->max_repl     = 1;
+              sporadic->repl_period  = period_ticks;
+              sporadic->budget       = runtime_ticks;
+              sporadic->deadline     = deadline_ticks;
+
+              sched_deadline_admit(tcb, bandwidth);
+
+              /* And start the first period */
+
+              ret = sched_sporadic_start(tcb);
+            }
+
+          /* Handle errors */
+
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
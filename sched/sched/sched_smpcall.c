@@ -0,0 +1,215 @@
+/****************************************************************************
+ * sched/sched/sched_smpcall.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_CALL
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One queued request */
+
+struct smp_call_s
+{
+  smp_callback_t func;          /* The function to execute */
+  FAR void *arg;                /* The argument passed to the function */
+};
+
+/* The queue of requests for one CPU.  This is a circular buffer of
+ * CONFIG_SMP_CALL_NQUEUE entries.
+ */
+
+struct smp_callq_s
+{
+  volatile spinlock_t lock;     /* Protects the queue */
+  uint8_t head;                 /* Index of the oldest request */
+  uint8_t count;                /* Number of queued requests */
+  struct smp_call_s call[CONFIG_SMP_CALL_NQUEUE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct smp_callq_s g_smp_callq[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_smp_call
+ *
+ * Description:
+ *   Queue a request for 'func' to be executed on 'cpu'.  If the queue of
+ *   that CPU was empty, then the inter-CPU call interrupt is raised;
+ *   otherwise the interrupt is already pending and the request will be
+ *   executed when the earlier requests are drained.  This function does
+ *   not wait for the request to be executed.
+ *
+ *   The function is executed in interrupt context on the target CPU.  It
+ *   must not assume that any object referenced by 'arg' is still valid
+ *   unless the caller guarantees that.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU that will execute the function.
+ *   func - The function to execute.
+ *   arg  - The argument passed to the function.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -EAGAIN is
+ *   returned if the queue of the target CPU is full.  The caller must then
+ *   fall back to some other mechanism:  It must not spin waiting for space
+ *   in the queue because the target CPU may be waiting for the caller.
+ *
+ ****************************************************************************/
+
+int sched_smp_call(int cpu, smp_callback_t func, FAR void *arg)
+{
+  FAR struct smp_callq_s *callq;
+  FAR struct smp_call_s *call;
+  irqstate_t flags;
+  uint8_t count;
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && func != NULL);
+
+  /* Execute the function now if the target is this CPU */
+
+  if (cpu == this_cpu())
+    {
+      func(arg);
+      return OK;
+    }
+
+  callq = &g_smp_callq[cpu];
+
+  /* The queue lock is also taken from interrupt handlers on this CPU */
+
+  flags = up_irq_save();
+  spin_lock(&callq->lock);
+
+  count = callq->count;
+  if (count >= CONFIG_SMP_CALL_NQUEUE)
+    {
+      spin_unlock(&callq->lock);
+      up_irq_restore(flags);
+      return -EAGAIN;
+    }
+
+  call         = &callq->call[(callq->head + count) %
+                              CONFIG_SMP_CALL_NQUEUE];
+  call->func   = func;
+  call->arg    = arg;
+  callq->count = count + 1;
+
+  spin_unlock(&callq->lock);
+
+  /* Only the first request in an empty queue raises the interrupt */
+
+  if (count == 0)
+    {
+      DEBUGVERIFY(up_cpu_call(cpu));
+    }
+
+  up_irq_restore(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_smp_call_handler
+ *
+ * Description:
+ *   Execute all requests queued for this CPU.  Called by the architecture
+ *   specific inter-CPU call interrupt handler.  Requests added while the
+ *   queue is being drained are also executed.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_smp_call_handler(void)
+{
+  FAR struct smp_callq_s *callq = &g_smp_callq[this_cpu()];
+  smp_callback_t func;
+  FAR void *arg;
+
+  for (; ; )
+    {
+      /* Remove the oldest request from the queue.  The lock is not held
+       * while the request executes so that other CPUs may continue to add
+       * requests.
+       */
+
+      spin_lock(&callq->lock);
+      if (callq->count == 0)
+        {
+          spin_unlock(&callq->lock);
+          break;
+        }
+
+      func         = callq->call[callq->head].func;
+      arg          = callq->call[callq->head].arg;
+      callq->head  = (callq->head + 1) % CONFIG_SMP_CALL_NQUEUE;
+      callq->count--;
+      spin_unlock(&callq->lock);
+
+      func(arg);
+    }
+}
+
+#endif /* CONFIG_SMP_CALL */
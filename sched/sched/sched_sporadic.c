@@ -287,6 +287,15 @@ static int sporadic_budget_start(FAR struct replenishment_s *mrepl)
 
   sporadic->eventtime = clock_systimer();
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* This is the start of a new period for a SCHED_DEADLINE thread.  The
+   * new absolute deadline takes effect when the thread is re-prioritized
+   * below.
+   */
+
+  sporadic->abs_deadline = sporadic->eventtime + sporadic->deadline;
+#endif
+
   /* And start the timer for the budget interval */
 
   DEBUGVERIFY(wd_start(&mrepl->timer, sporadic->budget,
@@ -954,6 +963,12 @@ int sched_sporadic_reset(FAR struct tcb_s *tcb)
       repl->flags        = 0;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release any SCHED_DEADLINE bandwidth */
+
+  sched_deadline_release(tcb);
+#endif
+
   /* Reset sporadic scheduling parameters and state data */
 
   sporadic->suspended    = true;
@@ -0,0 +1,170 @@
+/****************************************************************************
+ * sched/sched/sched_stackmon.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <syslog.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_STACK_MONITOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define STACKMON_PERIOD MSEC2TICK(CONFIG_STACK_MONITOR_PERIOD)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct work_s g_stackmon_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stackmon_worker
+ *
+ * Description:
+ *   Scan the stack high-water mark of every task and report new peaks that
+ *   exceed the warning threshold.  Each task is examined in its own critical
+ *   section so that interrupts are held off for the scan of only one stack
+ *   at a time.
+ *
+ ****************************************************************************/
+
+static void stackmon_worker(FAR void *arg)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  size_t stacksize;
+  size_t used;
+  unsigned int percent;
+  pid_t pid;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_MAX_TASKS; ndx++)
+    {
+      percent   = 0;
+      stacksize = 0;
+      used      = 0;
+      pid       = 0;
+
+      flags = enter_critical_section();
+
+      tcb = g_pidhash[ndx].tcb;
+
+      /* The IDLE tasks run on the stacks set up by the start-up logic and
+       * are not colored.
+       */
+
+#ifdef CONFIG_SMP
+      if (tcb != NULL && tcb->pid >= CONFIG_SMP_NCPUS &&
+          tcb->adj_stack_size > 0)
+#else
+      if (tcb != NULL && tcb->pid != 0 && tcb->adj_stack_size > 0)
+#endif
+        {
+          stacksize = tcb->adj_stack_size;
+          used      = up_check_tcbstack(tcb);
+          percent   = (unsigned int)((used * 100) / stacksize);
+
+          if (percent >= CONFIG_STACK_MONITOR_WARN &&
+              percent > tcb->stack_peak)
+            {
+              tcb->stack_peak = (uint8_t)percent;
+              pid = tcb->pid;
+            }
+          else
+            {
+              percent = 0;
+            }
+        }
+
+      leave_critical_section(flags);
+
+      if (percent > 0)
+        {
+          syslog(LOG_WARNING,
+                 "WARNING: PID %d stack usage %lu of %lu bytes (%u%%)\n",
+                 (int)pid, (unsigned long)used, (unsigned long)stacksize,
+                 percent);
+        }
+    }
+
+  (void)work_queue(LPWORK, &g_stackmon_work, stackmon_worker, NULL,
+                   STACKMON_PERIOD);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_stackmon_start
+ *
+ * Description:
+ *   Start the periodic scan of the stack high-water marks.  Called from
+ *   os_bringup() after the work queues have been started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_stackmon_start(void)
+{
+  (void)work_queue(LPWORK, &g_stackmon_work, stackmon_worker, NULL,
+                   STACKMON_PERIOD);
+}
+
+#endif /* CONFIG_STACK_MONITOR */
@@ -50,7 +50,8 @@
 #include "clock/clock.h"
 #include "sched/sched.h"
 
-#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION)
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION) || \
+    defined(CONFIG_SCHED_CPUTIME) || defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Functions
@@ -88,6 +89,19 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
 
   sched_note_suspend(tcb);
 #endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+  /* Charge the task for the time that it has been running */
+
+  sched_cputime_suspend(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Stop the clock of any critical section held by the task */
+
+  sched_critmon_suspend(tcb);
+#endif
 }
 
-#endif /* CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION */
+#endif /* CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION ||
+        * CONFIG_SCHED_CPUTIME || CONFIG_SCHED_CRITMONITOR */
@@ -0,0 +1,292 @@
+/****************************************************************************
+ * sched/sched/sched_tcbpool.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TCBPOOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Pooled stacks are allocated as arrays of uint64_t for alignment */
+
+#define TCBPOOL_STACKWORDS \
+  ((CONFIG_SCHED_TCBPOOL_STACKSIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One pooled TCB.  Each block is large enough to hold either kind of TCB.
+ * While the block is free, the first word holds the free list link.
+ */
+
+union sched_tcbblock_u
+{
+  sq_entry_t link;
+  struct task_tcb_s task;
+#ifndef CONFIG_DISABLE_PTHREAD
+  struct pthread_tcb_s pthread;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pooled TCBs and the list of free pooled TCBs.  Free TCBs are kept
+ * zeroed (except for the free list link) so that allocation is cheap.
+ */
+
+static union sched_tcbblock_u g_tcbpool[CONFIG_SCHED_TCBPOOL_NTCBS];
+static sq_queue_t g_tcbfree;
+
+#if CONFIG_SCHED_TCBPOOL_NSTACKS > 0
+/* The pooled stacks and the list of free pooled stacks */
+
+static uint64_t g_stackpool[CONFIG_SCHED_TCBPOOL_NSTACKS][TCBPOOL_STACKWORDS];
+static sq_queue_t g_stackfree;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_tcbpool_initialize
+ *
+ * Description:
+ *   Place all of the pooled TCBs and stacks in their free lists.  Called
+ *   once during OS initialization, before any task is created.
+ *
+ ****************************************************************************/
+
+void sched_tcbpool_initialize(void)
+{
+  int i;
+
+  sq_init(&g_tcbfree);
+  for (i = 0; i < CONFIG_SCHED_TCBPOOL_NTCBS; i++)
+    {
+      sq_addlast(&g_tcbpool[i].link, &g_tcbfree);
+    }
+
+#if CONFIG_SCHED_TCBPOOL_NSTACKS > 0
+  sq_init(&g_stackfree);
+  for (i = 0; i < CONFIG_SCHED_TCBPOOL_NSTACKS; i++)
+    {
+      sq_addlast((FAR sq_entry_t *)g_stackpool[i], &g_stackfree);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_tcballoc
+ *
+ * Description:
+ *   Allocate a zeroed TCB of the specified size.  A pooled TCB is used if
+ *   one is available; otherwise, the TCB is allocated from the kernel heap.
+ *
+ * Input Parameters:
+ *   size - The size of the TCB, i.e., sizeof(struct task_tcb_s) or
+ *     sizeof(struct pthread_tcb_s).
+ *
+ * Returned Value:
+ *   The zeroed TCB or NULL if no memory is available.
+ *
+ ****************************************************************************/
+
+FAR void *sched_tcballoc(size_t size)
+{
+  FAR sq_entry_t *block;
+  irqstate_t flags;
+
+  DEBUGASSERT(size <= sizeof(union sched_tcbblock_u));
+
+  flags = enter_critical_section();
+  block = sq_remfirst(&g_tcbfree);
+  leave_critical_section(flags);
+
+  if (block == NULL)
+    {
+      return kmm_zalloc(size);
+    }
+
+  /* The remainder of the block was zeroed when it was freed */
+
+  block->flink = NULL;
+  return block;
+}
+
+/****************************************************************************
+ * Name: sched_tcbfree
+ *
+ * Description:
+ *   Free a TCB allocated by sched_tcballoc() (or by kmm_zalloc()).  Pooled
+ *   TCBs are zeroed and returned to the pool.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be freed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_tcbfree(FAR struct tcb_s *tcb)
+{
+  FAR union sched_tcbblock_u *block = (FAR union sched_tcbblock_u *)tcb;
+  irqstate_t flags;
+
+  if (block >= &g_tcbpool[0] &&
+      block < &g_tcbpool[CONFIG_SCHED_TCBPOOL_NTCBS])
+    {
+      memset(block, 0, sizeof(union sched_tcbblock_u));
+
+      flags = enter_critical_section();
+      sq_addlast(&block->link, &g_tcbfree);
+      leave_critical_section(flags);
+    }
+  else
+    {
+      sched_kfree(tcb);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_create_stack
+ *
+ * Description:
+ *   Allocate a stack for a new thread.  A pooled stack is used if the
+ *   requested size is no larger than CONFIG_SCHED_TCBPOOL_STACKSIZE and a
+ *   pooled stack is available; otherwise, up_create_stack() is used.  In
+ *   the former case, the thread receives the full size of the pooled
+ *   stack.
+ *
+ * Input Parameters:
+ *   Same as up_create_stack()
+ *
+ * Returned Value:
+ *   Same as up_create_stack()
+ *
+ ****************************************************************************/
+
+int sched_create_stack(FAR struct tcb_s *tcb, size_t stack_size,
+                       uint8_t ttype)
+{
+#if CONFIG_SCHED_TCBPOOL_NSTACKS > 0
+  FAR sq_entry_t *stack = NULL;
+  irqstate_t flags;
+  int ret;
+
+  if (stack_size <= CONFIG_SCHED_TCBPOOL_STACKSIZE)
+    {
+      flags = enter_critical_section();
+      stack = sq_remfirst(&g_stackfree);
+      leave_critical_section(flags);
+    }
+
+  if (stack != NULL)
+    {
+      ret = up_use_stack(tcb, stack, TCBPOOL_STACKWORDS * sizeof(uint64_t));
+      if (ret == OK)
+        {
+          return OK;
+        }
+
+      flags = enter_critical_section();
+      sq_addfirst(stack, &g_stackfree);
+      leave_critical_section(flags);
+    }
+#endif
+
+  return up_create_stack(tcb, stack_size, ttype);
+}
+
+/****************************************************************************
+ * Name: sched_release_stack
+ *
+ * Description:
+ *   Release the stack of a thread.  Pooled stacks are returned to the pool;
+ *   other stacks are released with up_release_stack().
+ *
+ * Input Parameters:
+ *   Same as up_release_stack()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_release_stack(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+#if CONFIG_SCHED_TCBPOOL_NSTACKS > 0
+  FAR uint64_t *stack = (FAR uint64_t *)tcb->stack_alloc_ptr;
+  irqstate_t flags;
+
+  if (stack >= &g_stackpool[0][0] &&
+      stack < &g_stackpool[CONFIG_SCHED_TCBPOOL_NSTACKS][0])
+    {
+      tcb->stack_alloc_ptr = NULL;
+      tcb->adj_stack_ptr   = NULL;
+      tcb->adj_stack_size  = 0;
+
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)stack, &g_stackfree);
+      leave_critical_section(flags);
+      return;
+    }
+#endif
+
+  up_release_stack(tcb, ttype);
+}
+
+#endif /* CONFIG_SCHED_TCBPOOL */
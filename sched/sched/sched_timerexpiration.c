@@ -57,6 +57,10 @@
 #  include "clock/clock_timekeeping.h"
 #endif
 
+#ifdef CONFIG_HRTIMER
+#  include "hrtimer/hrtimer.h"
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
 
 /****************************************************************************
@@ -123,6 +127,9 @@ static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches);
 static uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches);
 #endif
 static unsigned int sched_timer_process(unsigned int ticks, bool noswitches);
+#ifdef CONFIG_HRTIMER
+static int sched_alarm_start(void);
+#endif
 static void sched_timer_start(unsigned int ticks);
 
 /****************************************************************************
@@ -151,6 +158,15 @@ static struct timespec g_sched_time;
 static struct timespec g_stop_time;
 #endif
 
+#ifdef CONFIG_HRTIMER
+/* This is the absolute time of the next tick-based event.  It is valid
+ * only while g_timer_interval is non-zero.  The alarm may be programmed
+ * for an earlier time if a high resolution timer expires first.
+ */
+
+static struct timespec g_tick_time;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -352,6 +368,12 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
   clock_update_wall_time();
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* Charge the running task for its execution time */
+
+  sched_cputime_process();
+#endif
+
   /* Process watchdogs */
 
   tmp = wd_timer(ticks);
@@ -374,6 +396,41 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
   return rettime;
 }
 
+/****************************************************************************
+ * Name:  sched_alarm_start
+ *
+ * Description:
+ *   Program the alarm for the earlier of the next tick-based event (if
+ *   any) and the next high resolution timer (if any).
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The value returned by up_alarm_start() or zero (OK) if there is no
+ *   event to be timed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int sched_alarm_start(void)
+{
+  struct timespec ts;
+  bool pending;
+
+  pending = hrtimer_nextexpiry(&ts);
+  if (g_timer_interval > 0 &&
+      (!pending || HRTIMER_BEFORE(&g_tick_time, &ts)))
+    {
+      ts.tv_sec  = g_tick_time.tv_sec;
+      ts.tv_nsec = g_tick_time.tv_nsec;
+      pending    = true;
+    }
+
+  return pending ? up_alarm_start(&ts) : OK;
+}
+#endif
+
 /****************************************************************************
  * Name:  sched_timer_start
  *
@@ -400,6 +457,17 @@ static void sched_timer_start(unsigned int ticks)
   uint32_t nsecs;
   int ret;
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* The running task must be charged for its execution time before the
+   * cycle counter wraps, even if there is nothing else to wake up for.
+   */
+
+  if (ticks == 0 || ticks > sched_cputime_maxticks())
+    {
+      ticks = sched_cputime_maxticks();
+    }
+#endif
+
   /* Set up the next timer interval (or not) */
 
   g_timer_interval = 0;
@@ -442,7 +510,13 @@ static void sched_timer_start(unsigned int ticks)
        */
 
       clock_timespec_add(&g_stop_time, &ts, &ts);
+#ifdef CONFIG_HRTIMER
+      g_tick_time.tv_sec  = ts.tv_sec;
+      g_tick_time.tv_nsec = ts.tv_nsec;
+      ret = OK;
+#else
       ret = up_alarm_start(&ts);
+#endif
 
 #else
       /* [Re-]start the interval timer */
@@ -456,6 +530,16 @@ static void sched_timer_start(unsigned int ticks)
           UNUSED(ret);
         }
     }
+
+#ifdef CONFIG_HRTIMER
+  /* The alarm is also needed if only high resolution timers are active */
+
+  ret = sched_alarm_start();
+  if (ret < 0)
+    {
+      serr("ERROR: up_alarm_start failed: %d\n", ret);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -490,6 +574,22 @@ void sched_alarm_expiration(FAR const struct timespec *ts)
 
   DEBUGASSERT(ts);
 
+#ifdef CONFIG_HRTIMER
+  /* Run the expired high resolution timers.  If the alarm was programmed
+   * for a high resolution timer before the next tick-based event, then
+   * there is nothing more to do but to program the alarm for the next
+   * event.
+   */
+
+  hrtimer_process(ts);
+
+  if (g_timer_interval == 0 || HRTIMER_BEFORE(ts, &g_tick_time))
+    {
+      (void)sched_alarm_start();
+      return;
+    }
+#endif
+
   /* Save the time that the alarm occurred */
 
   g_stop_time.tv_sec  = ts->tv_sec;
@@ -595,6 +695,14 @@ unsigned int sched_timer_cancel(void)
 
   (void)up_alarm_cancel(&g_stop_time);
 
+#ifdef CONFIG_HRTIMER
+  /* Run any high resolution timers that expired while the alarm was being
+   * cancelled.  The alarm will be restarted by the caller.
+   */
+
+  hrtimer_process(&g_stop_time);
+#endif
+
 #ifdef CONFIG_SCHED_SPORADIC
   /* Save the last time that the scheduler ran */
 
@@ -737,4 +845,38 @@ void sched_timer_reassess(void)
   sched_timer_start(nexttime);
 }
 
+/****************************************************************************
+ * Name:  sched_alarm_reassess
+ *
+ * Description:
+ *   It is necessary to reprogram the alarm when the high resolution timer
+ *   at the head of the list of active high resolution timers changes.
+ *   Unlike sched_timer_reassess(), this does not process the elapsed ticks:
+ *   The alarm is simply restarted for the earlier of the next tick-based
+ *   event and the next high resolution timer.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+void sched_alarm_reassess(void)
+{
+  int ret;
+
+  ret = sched_alarm_start();
+  if (ret < 0)
+    {
+      serr("ERROR: up_alarm_start failed: %d\n", ret);
+    }
+}
+#endif
+
 #endif /* CONFIG_SCHED_TICKLESS */
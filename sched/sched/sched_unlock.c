@@ -107,6 +107,11 @@ int sched_unlock(void)
           /* Note that we no longer have pre-emption disabled. */
 
           sched_note_premption(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+          /* Record how long pre-emption was disabled */
+
+          sched_critmon_preemption(rtcb, false, NULL);
 #endif
           /* Set the lock count to zero */
 
@@ -258,6 +263,11 @@ int sched_unlock(void)
           /* Note that we no longer have pre-emption disabled. */
 
           sched_note_premption(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+          /* Record how long pre-emption was disabled */
+
+          sched_critmon_preemption(rtcb, false, NULL);
 #endif
           /* Set the lock count to zero */
 
@@ -45,6 +45,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <nuttx/arch.h>
+#include <nuttx/mm/mempool.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -72,11 +73,93 @@ typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
  * Private Data
  ****************************************************************************/
 
-/* Preallocated holder structures */
+/* Preallocated holder structures and the pool that they are kept in */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
 static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
-static FAR struct semholder_s *g_freeholders;
+static struct mempool_s g_holderpool;
+#endif
+
+/****************************************************************************
+ * Name: nxsem_linkholding
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+static inline void nxsem_linkholding(FAR struct tcb_s *htcb,
+                                     FAR struct semholder_s *pholder)
+{
+  /* Add the holder to the list of semaphores held by the thread */
+
+  pholder->tlink = htcb->holdings;
+  htcb->holdings = pholder;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsem_unlinkholding
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+static inline void nxsem_unlinkholding(FAR struct tcb_s *htcb,
+                                       FAR struct semholder_s *pholder)
+{
+  FAR struct semholder_s *curr;
+  FAR struct semholder_s *prev;
+
+  /* Search the list of semaphores held by the thread.  This is bounded by
+   * the number of semaphores that the thread holds.
+   */
+
+  for (prev = NULL, curr = htcb->holdings;
+       curr && curr != pholder;
+       prev = curr, curr = curr->tlink);
+
+  if (curr != NULL)
+    {
+      if (prev != NULL)
+        {
+          prev->tlink = pholder->tlink;
+        }
+      else
+        {
+          htcb->holdings = pholder->tlink;
+        }
+
+      pholder->tlink = NULL;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsem_holderprio
+ *
+ * Description:
+ *   Return the priority that the holder thread should run at:  Its base
+ *   priority or, if higher, the priority of the highest priority thread
+ *   waiting for any of the semaphores that it holds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+static int nxsem_holderprio(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+  FAR struct tcb_s *wtcb;
+  int priority = htcb->base_priority;
+
+  for (pholder = htcb->holdings; pholder != NULL; pholder = pholder->tlink)
+    {
+      /* The head of the waiter list is the highest priority waiter */
+
+      wtcb = pholder->sem->whead;
+      if (wtcb != NULL && wtcb->sched_priority > priority)
+        {
+          priority = wtcb->sched_priority;
+        }
+    }
+
+  return priority;
+}
 #endif
 
 /****************************************************************************
@@ -93,14 +176,11 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
+  pholder = (FAR struct semholder_s *)mempool_alloc(&g_holderpool);
   if (pholder != NULL)
     {
-      /* Remove the holder from the free list an put it into the semaphore's
-       * holder list
-       */
+      /* Put the holder from the pool into the semaphore's holder list */
 
-      g_freeholders    = pholder->flink;
       pholder->flink   = sem->hhead;
       sem->hhead       = pholder;
 
@@ -204,6 +284,17 @@ static inline void nxsem_freeholder(sem_t *sem,
   FAR struct semholder_s *prev;
 #endif
 
+#ifdef CONFIG_SEM_HOLDERLISTS
+  /* Remove the holder from the list of semaphores held by the thread */
+
+  if (pholder->htcb != NULL)
+    {
+      nxsem_unlinkholding(pholder->htcb, pholder);
+    }
+
+  pholder->sem    = NULL;
+#endif
+
   /* Release the holder and counts */
 
   pholder->htcb   = NULL;
@@ -229,10 +320,9 @@ static inline void nxsem_freeholder(sem_t *sem,
           sem->hhead = pholder->flink;
         }
 
-      /* And put it in the free list */
+      /* And put it back in the pool */
 
-      pholder->flink = g_freeholders;
-      g_freeholders  = pholder;
+      mempool_free(&g_holderpool, pholder);
     }
 #endif
 }
@@ -312,7 +402,7 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
  * Name: nxsem_recoverholders
  ****************************************************************************/
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 || defined(CONFIG_SEM_HOLDERLISTS)
 static int nxsem_recoverholders(FAR struct semholder_s *pholder,
                                 FAR sem_t *sem, FAR void *arg)
 {
@@ -485,7 +575,9 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
                                    FAR sem_t *sem, FAR void *arg)
 {
   FAR struct semholder_s *pholder = 0;
-#if CONFIG_SEM_NNESTPRIO > 0
+#if defined(CONFIG_SEM_HOLDERLISTS)
+  int rpriority;
+#elif CONFIG_SEM_NNESTPRIO > 0
   FAR struct tcb_s *stcb = (FAR struct tcb_s *)arg;
   int rpriority;
   int i;
@@ -509,6 +601,21 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
         }
     }
 
+#ifdef CONFIG_SEM_HOLDERLISTS
+  /* Recompute the priority of the holder thread from the semaphores that it
+   * still holds.  The waiter that received the count (if any) has already
+   * been removed from the semaphore's list of waiters.
+   */
+
+  else
+    {
+      rpriority = nxsem_holderprio(htcb);
+      if (rpriority != htcb->sched_priority)
+        {
+          (void)nxsched_setpriority(htcb, rpriority);
+        }
+    }
+#else
   /* Was the priority of the holder thread boosted? If so, then drop its
    * priority back to the correct level.  What is the correct level?
    */
@@ -621,6 +728,7 @@ static int nxsem_restoreholderprio(FAR struct tcb_s *htcb,
       (void)nxsched_reprioritize(htcb, htcb->base_priority);
 #endif
     }
+#endif /* CONFIG_SEM_HOLDERLISTS */
 
   return 0;
 }
@@ -677,11 +785,15 @@ static int nxsem_restoreholderprioB(FAR struct semholder_s *pholder,
 
       /* The running task has given up a count on the semaphore */
 
-#if CONFIG_SEM_PREALLOCHOLDERS == 0
+#if CONFIG_SEM_PREALLOCHOLDERS == 0 || defined(CONFIG_SEM_HOLDERLISTS)
       /* In the case where there are only 2 holders. This step
        * is necessary to insure we have space. Release the holder
        * if all counts have been given up. before reprioritizing
        * causes a context switch.
+       *
+       * With per-thread holder lists, the holder must also be released
+       * first so that this semaphore no longer contributes to the
+       * priority of the running task.
        */
 
       nxsem_findandfreeholder(sem, rtcb);
@@ -858,17 +970,11 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
 void nxsem_initholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  int i;
+  /* Put all of the pre-allocated holder structures into the pool */
 
-  /* Put all of the pre-allocated holder structures into the free list */
-
-  g_freeholders = g_holderalloc;
-  for (i = 0; i < (CONFIG_SEM_PREALLOCHOLDERS - 1); i++)
-    {
-      g_holderalloc[i].flink = &g_holderalloc[i + 1];
-    }
-
-  g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS - 1].flink = NULL;
+  (void)mempool_initialize(&g_holderpool, "semholder", g_holderalloc,
+                           sizeof(struct semholder_s),
+                           CONFIG_SEM_PREALLOCHOLDERS, 0, NULL, NULL);
 #endif
 }
 
@@ -917,9 +1023,13 @@ void nxsem_destroyholder(FAR sem_t *sem)
       DEBUGPANIC();
     }
 
+#ifdef CONFIG_SEM_HOLDERLISTS
+  (void)nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
+#else
   sem->holder[0].htcb = NULL;
   sem->holder[1].htcb = NULL;
 #endif
+#endif
 }
 
 /****************************************************************************
@@ -957,6 +1067,18 @@ void nxsem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
       pholder = nxsem_findorallocateholder(sem, htcb);
       if (pholder != NULL)
         {
+#ifdef CONFIG_SEM_HOLDERLISTS
+          /* If this is a new holder, then add the semaphore to the list of
+           * semaphores held by the thread.
+           */
+
+          if (pholder->htcb == NULL)
+            {
+              pholder->sem = sem;
+              nxsem_linkholding(htcb, pholder);
+            }
+
+#endif
           /* Then set the holder and increment the number of counts held by this
            * holder
            */
@@ -1142,6 +1264,37 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsem_freeholdings
+ *
+ * Description:
+ *   Called from nxsem_recover() when a thread is deleted.  Release every
+ *   holder record that still refers to the thread so that no semaphore is
+ *   left with a stale holder.  The counts held by the thread are lost.
+ *
+ * Parameters:
+ *   htcb - The TCB of the deleted thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+void nxsem_freeholdings(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+
+  while ((pholder = htcb->holdings) != NULL)
+    {
+      nxsem_freeholder(pholder->sem, pholder);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: sem_enumholders
  *
@@ -1188,15 +1341,10 @@ void sem_enumholders(FAR sem_t *sem)
 int nxsem_nfreeholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *pholder;
-  int n;
-
-  for (pholder = g_freeholders, n = 0; pholder; pholder = pholder->flink)
-    {
-      n++;
-    }
+  struct mempoolinfo_s info;
 
-  return n;
+  mempool_info(&g_holderpool, &info);
+  return info.nfree;
 #else
   return 0;
 #endif
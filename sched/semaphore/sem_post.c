@@ -51,6 +51,16 @@
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef HAVE_SEM_COUNTLOCK
+/* This spinlock protects the counts of all semaphores */
+
+struct subsys_lock_s g_semlock SP_SECTION = SUBSYS_LOCK_INITIALIZER("sem");
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -88,12 +98,32 @@ int nxsem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
   irqstate_t flags;
+  irqstate_t cflags;
+  int16_t semcount;
   int ret = -EINVAL;
 
   /* Make sure we were supplied with a valid semaphore. */
 
   if (sem != NULL)
     {
+#ifdef HAVE_SEM_COUNTLOCK
+      /* If no thread is waiting for the semaphore (i.e., the count is non-
+       * negative), then the count can simply be incremented while holding
+       * the count lock.  There is no need to enter the critical section.
+       */
+
+      cflags = nxsem_countlock();
+      if (sem->semcount >= 0)
+        {
+          ASSERT(sem->semcount < SEM_VALUE_MAX);
+          sem->semcount++;
+          nxsem_countunlock(cflags);
+          return OK;
+        }
+
+      nxsem_countunlock(cflags);
+#endif
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -120,7 +150,15 @@ int nxsem_post(FAR sem_t *sem)
 
       ASSERT(sem->semcount < SEM_VALUE_MAX);
       nxsem_releaseholder(sem);
-      sem->semcount++;
+
+      /* Keep a copy of the new count:  The count may be incremented again
+       * by the fast path on another CPU as soon as the count lock is
+       * released.
+       */
+
+      cflags   = nxsem_countlock();
+      semcount = ++sem->semcount;
+      nxsem_countunlock(cflags);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       /* Don't let any unblocked tasks run until we complete any priority
@@ -137,7 +175,7 @@ int nxsem_post(FAR sem_t *sem)
        * there must be some task waiting for the semaphore.
        */
 
-      if (sem->semcount <= 0)
+      if (semcount <= 0)
         {
           /* Check if there are any tasks in the waiting for semaphore
            * task list that are waiting for this semaphore. This is a
@@ -145,12 +183,24 @@ int nxsem_post(FAR sem_t *sem)
            * that we want.
            */
 
+#ifdef CONFIG_SEM_HOLDERLISTS
+          /* The semaphore keeps its own prioritized list of waiters so
+           * there is no need to search.
+           */
+
+          stcb = sem->whead;
+#else
           for (stcb = (FAR struct tcb_s *)g_waitingforsemaphore.head;
                (stcb && stcb->waitsem != sem);
                stcb = stcb->flink);
+#endif
 
           if (stcb != NULL)
             {
+              /* The task is no longer waiting for the semaphore */
+
+              nxsem_remwaiter(sem, stcb);
+
               /* The task will be the new holder of the semaphore when
                * it is awakened.
                */
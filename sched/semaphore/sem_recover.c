@@ -62,7 +62,8 @@
  *   semaphores held by the thread.  That would, however, require some
  *   significant extension to the semaphore data structures because given
  *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   with counts held by the task.  With CONFIG_SEM_HOLDERLISTS, the holder
+ *   records of the task are discarded, but the counts are not posted.
  *
  * Input Parameters:
  *   tcb - The TCB of the terminated task or thread
@@ -78,6 +79,7 @@
 void nxsem_recover(FAR struct tcb_s *tcb)
 {
   irqstate_t flags;
+  irqstate_t cflags;
 
   /* The task is being deleted.  If it is waiting for a semphore, then
    * increment the count on the semaphores.  This logic is almost identical
@@ -98,6 +100,10 @@ void nxsem_recover(FAR struct tcb_s *tcb)
       sem_t *sem = tcb->waitsem;
       DEBUGASSERT(sem != NULL && sem->semcount < 0);
 
+      /* The thread is no longer waiting for the semaphore */
+
+      nxsem_remwaiter(sem, tcb);
+
       /* Restore the correct priority of all threads that hold references
        * to this semaphore.
        */
@@ -110,7 +116,9 @@ void nxsem_recover(FAR struct tcb_s *tcb)
        * place.
        */
 
+      cflags = nxsem_countlock();
       sem->semcount++;
+      nxsem_countunlock(cflags);
 
       /* Clear the semaphore to assure that it is not reused.  But leave the
        * state as TSTATE_WAIT_SEM.  This is necessary because this is a
@@ -121,5 +129,10 @@ void nxsem_recover(FAR struct tcb_s *tcb)
       tcb->waitsem = NULL;
     }
 
+  /* Release any counts still held by the task so that no holder record is
+   * left referring to the deleted TCB.
+   */
+
+  nxsem_freeholdings(tcb);
   leave_critical_section(flags);
 }
@@ -74,6 +74,7 @@
 int nxsem_reset(FAR sem_t *sem, int16_t count)
 {
   irqstate_t flags;
+  irqstate_t cflags;
 
   DEBUGASSERT(sem != NULL && count >= 0);
 
@@ -112,11 +113,14 @@ int nxsem_reset(FAR sem_t *sem, int16_t count)
    * value of sem->semcount is already correct in this case.
    */
 
+  cflags = nxsem_countlock();
   if (sem->semcount >= 0)
     {
       sem->semcount = count;
     }
 
+  nxsem_countunlock(cflags);
+
   /* Allow any pending context switches to occur now */
 
   leave_critical_section(flags);
@@ -0,0 +1,587 @@
+/****************************************************************************
+ * sched/semaphore/sem_rw.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/rwsem.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_RWSEM
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrwsem_nreaders
+ *
+ * Description:
+ *   Return the number of readers holding the lock.  This is the sum of the
+ *   per-CPU counts.
+ *
+ ****************************************************************************/
+
+static int32_t nxrwsem_nreaders(FAR rwsem_t *rwsem)
+{
+  int32_t nreaders = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nreaders += rwsem->readers[cpu].count;
+    }
+
+  return nreaders;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_wait
+ *
+ * Description:
+ *   Wait on one of the internal semaphores, retrying if the wait is
+ *   interrupted by a signal.
+ *
+ ****************************************************************************/
+
+static int nxrwsem_wait(FAR sem_t *sem, FAR const struct timespec *abstime)
+{
+  int ret;
+
+  do
+    {
+      if (abstime != NULL)
+        {
+          ret = nxsem_timedwait(sem, abstime);
+        }
+      else
+        {
+          ret = nxsem_wait(sem);
+        }
+    }
+  while (ret == -EINTR);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_waitsignal
+ *
+ * Description:
+ *   Wait on one of the internal semaphores that are used for signaling.
+ *   Priority inheritance would record the awakened thread as a holder that
+ *   never releases its count, so it is disabled here in case the
+ *   reader-writer semaphore was statically initialized.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static int nxrwsem_waitsignal(FAR sem_t *sem,
+                              FAR const struct timespec *abstime)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  (void)nxsem_setprotocol(sem, SEM_PRIO_NONE);
+#endif
+  return nxrwsem_wait(sem, abstime);
+}
+
+/****************************************************************************
+ * Name: nxrwsem_wakeall
+ *
+ * Description:
+ *   Wake up all threads waiting on an internal signaling semaphore.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void nxrwsem_wakeall(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) >= 0 && sval < 0)
+    {
+      (void)nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: nxrwsem_readerleave
+ *
+ * Description:
+ *   Remove one reader.  If a writer is present, then the last reader to
+ *   leave must wake up the writer that is waiting for the readers to
+ *   drain.
+ *
+ ****************************************************************************/
+
+static void nxrwsem_readerleave(FAR rwsem_t *rwsem)
+{
+  irqstate_t flags;
+  int sval;
+
+  /* The reader may have migrated since it entered:  The count of another
+   * CPU may be decremented, but only the sum of the counts matters.
+   */
+
+  SP_DMB();
+  (void)up_fetchsub32(&rwsem->readers[this_cpu()].count, 1);
+  SP_DMB();
+
+  if (rwsem->writers > 0)
+    {
+      flags = enter_critical_section();
+      if (nxrwsem_nreaders(rwsem) == 0 &&
+          nxsem_getvalue(&rwsem->wsem, &sval) >= 0 && sval < 0)
+        {
+          (void)nxsem_post(&rwsem->wsem);
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: nxrwsem_readerenter
+ *
+ * Description:
+ *   Try to add one reader.  This fails, and the reader backs out, if any
+ *   writer holds or is waiting for the lock.
+ *
+ ****************************************************************************/
+
+static bool nxrwsem_readerenter(FAR rwsem_t *rwsem)
+{
+  /* The increment must be visible to a writer before we check for one:
+   * Either the writer sees this reader or this reader sees the writer.
+   */
+
+  (void)up_fetchadd32(&rwsem->readers[this_cpu()].count, 1);
+  SP_DMB();
+
+  if (rwsem->writers == 0)
+    {
+      /* Don't let accesses to the protected data precede the check */
+
+      SP_DMB();
+      return true;
+    }
+
+  nxrwsem_readerleave(rwsem);
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_writerleave
+ *
+ * Description:
+ *   Remove one writer that holds or was waiting for the lock.  When no
+ *   writer remains, the readers waiting for the lock are awakened.
+ *
+ ****************************************************************************/
+
+static void nxrwsem_writerleave(FAR rwsem_t *rwsem)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  SP_DMB();
+  if (up_fetchsub32(&rwsem->writers, 1) == 0)
+    {
+      nxrwsem_wakeall(&rwsem->rsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxrwsem_init
+ *
+ * Description:
+ *   Initialize a reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be initialized
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_init(FAR rwsem_t *rwsem)
+{
+  int cpu;
+
+  DEBUGASSERT(rwsem != NULL);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      rwsem->readers[cpu].count = 0;
+    }
+
+  rwsem->writers = 0;
+  rwsem->holder  = RWSEM_NO_HOLDER;
+
+  /* The writer lock is a mutex.  The other two semaphores are used for
+   * signaling and must not participate in priority inheritance.
+   */
+
+  (void)nxsem_init(&rwsem->wlock, 0, 1);
+  (void)nxsem_init(&rwsem->wsem, 0, 0);
+  (void)nxsem_init(&rwsem->rsem, 0, 0);
+
+  (void)nxsem_setprotocol(&rwsem->wsem, SEM_PRIO_NONE);
+  (void)nxsem_setprotocol(&rwsem->rsem, SEM_PRIO_NONE);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_destroy
+ *
+ * Description:
+ *   Destroy a reader-writer semaphore that is not locked.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to be destroyed
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure:  -EBUSY if the semaphore is locked.
+ *
+ ****************************************************************************/
+
+int nxrwsem_destroy(FAR rwsem_t *rwsem)
+{
+  DEBUGASSERT(rwsem != NULL);
+
+  if (rwsem->writers != 0 || nxrwsem_nreaders(rwsem) != 0)
+    {
+      return -EBUSY;
+    }
+
+  (void)nxsem_destroy(&rwsem->wlock);
+  (void)nxsem_destroy(&rwsem->wsem);
+  (void)nxsem_destroy(&rwsem->rsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_timedrdlock
+ *
+ * Description:
+ *   Lock a reader-writer semaphore for reading, waiting until the absolute
+ *   time 'abstime' (if non-NULL) for any writers to finish.
+ *
+ * Input Parameters:
+ *   rwsem   - The reader-writer semaphore to lock
+ *   abstime - The absolute time to wait until (CLOCK_REALTIME) or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_timedrdlock(FAR rwsem_t *rwsem,
+                        FAR const struct timespec *abstime)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(rwsem != NULL && !up_interrupt_context());
+
+  if (rwsem->holder == getpid())
+    {
+      return -EDEADLK;
+    }
+
+  while (!nxrwsem_readerenter(rwsem))
+    {
+      /* A writer holds or is waiting for the lock.  Wait until there are
+       * no writers.  This is checked within the critical section so that
+       * the wake-up from the last writer cannot be missed.
+       */
+
+      flags = enter_critical_section();
+      while (rwsem->writers > 0 && ret >= 0)
+        {
+          ret = nxrwsem_waitsignal(&rwsem->rsem, abstime);
+        }
+
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_tryrdlock
+ *
+ * Description:
+ *   Lock a reader-writer semaphore for reading if no writer holds or is
+ *   waiting for the lock.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to lock
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_tryrdlock(FAR rwsem_t *rwsem)
+{
+  DEBUGASSERT(rwsem != NULL);
+
+  if (rwsem->holder == getpid())
+    {
+      return -EDEADLK;
+    }
+
+  return nxrwsem_readerenter(rwsem) ? OK : -EBUSY;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_rdunlock
+ *
+ * Description:
+ *   Release a read lock on a reader-writer semaphore.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to unlock
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int nxrwsem_rdunlock(FAR rwsem_t *rwsem)
+{
+  DEBUGASSERT(rwsem != NULL);
+
+  nxrwsem_readerleave(rwsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_timedwrlock
+ *
+ * Description:
+ *   Lock a reader-writer semaphore for writing, waiting until the absolute
+ *   time 'abstime' (if non-NULL) for other writers and readers to finish.
+ *
+ * Input Parameters:
+ *   rwsem   - The reader-writer semaphore to lock
+ *   abstime - The absolute time to wait until (CLOCK_REALTIME) or NULL
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_timedwrlock(FAR rwsem_t *rwsem,
+                        FAR const struct timespec *abstime)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+  int ret;
+
+  DEBUGASSERT(rwsem != NULL && !up_interrupt_context());
+
+  if (rwsem->holder == me)
+    {
+      return -EDEADLK;
+    }
+
+  /* Announce the writer.  From this point, no new reader will enter. */
+
+  (void)up_fetchadd32(&rwsem->writers, 1);
+  SP_DMB();
+
+  /* Wait for any other writer to release the lock */
+
+  ret = nxrwsem_wait(&rwsem->wlock, abstime);
+  if (ret >= 0)
+    {
+      /* Then wait for the readers already holding the lock to leave */
+
+      flags = enter_critical_section();
+      while (nxrwsem_nreaders(rwsem) != 0 && ret >= 0)
+        {
+          ret = nxrwsem_waitsignal(&rwsem->wsem, abstime);
+        }
+
+      if (ret >= 0)
+        {
+          rwsem->holder = me;
+          leave_critical_section(flags);
+
+          SP_DMB();
+          return OK;
+        }
+
+      leave_critical_section(flags);
+      (void)nxsem_post(&rwsem->wlock);
+    }
+
+  /* The wait failed.  Let the readers back in if no other writer remains */
+
+  nxrwsem_writerleave(rwsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_trywrlock
+ *
+ * Description:
+ *   Lock a reader-writer semaphore for writing if it is not locked and no
+ *   other writer is waiting for it.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to lock
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxrwsem_trywrlock(FAR rwsem_t *rwsem)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+
+  DEBUGASSERT(rwsem != NULL);
+
+  if (rwsem->holder == me)
+    {
+      return -EDEADLK;
+    }
+
+  /* Only succeed if this is the only writer */
+
+  if (up_fetchadd32(&rwsem->writers, 1) == 1)
+    {
+      SP_DMB();
+
+      if (nxsem_trywait(&rwsem->wlock) >= 0)
+        {
+          flags = enter_critical_section();
+          if (nxrwsem_nreaders(rwsem) == 0)
+            {
+              rwsem->holder = me;
+              leave_critical_section(flags);
+
+              SP_DMB();
+              return OK;
+            }
+
+          leave_critical_section(flags);
+          (void)nxsem_post(&rwsem->wlock);
+        }
+    }
+
+  nxrwsem_writerleave(rwsem);
+  return -EBUSY;
+}
+
+/****************************************************************************
+ * Name: nxrwsem_wrunlock
+ *
+ * Description:
+ *   Release the write lock on a reader-writer semaphore.  A waiting writer
+ *   receives the lock next; otherwise, the waiting readers are awakened.
+ *
+ * Input Parameters:
+ *   rwsem - The reader-writer semaphore to unlock
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EPERM is returned if the caller
+ *   does not hold the write lock.
+ *
+ ****************************************************************************/
+
+int nxrwsem_wrunlock(FAR rwsem_t *rwsem)
+{
+  DEBUGASSERT(rwsem != NULL);
+
+  if (rwsem->holder != getpid())
+    {
+      return -EPERM;
+    }
+
+  rwsem->holder = RWSEM_NO_HOLDER;
+
+  /* Any waiting writer is still counted in 'writers' so the readers remain
+   * locked out until the last writer leaves.
+   */
+
+  (void)nxsem_post(&rwsem->wlock);
+  nxrwsem_writerleave(rwsem);
+  return OK;
+}
+
+#endif /* CONFIG_RWSEM */
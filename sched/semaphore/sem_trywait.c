@@ -82,6 +82,7 @@ int nxsem_trywait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+  irqstate_t cflags;
   int ret;
 
   /* This API should not be called from interrupt handlers */
@@ -98,11 +99,14 @@ int nxsem_trywait(FAR sem_t *sem)
 
       /* If the semaphore is available, give it to the requesting task */
 
+      cflags = nxsem_countlock();
       if (sem->semcount > 0)
         {
           /* It is, let the task take the semaphore */
 
           sem->semcount--;
+          nxsem_countunlock(cflags);
+
           rtcb->waitsem = NULL;
           ret = OK;
         }
@@ -110,6 +114,7 @@ int nxsem_trywait(FAR sem_t *sem)
         {
           /* Semaphore is not available */
 
+          nxsem_countunlock(cflags);
           ret = -EAGAIN;
         }
 
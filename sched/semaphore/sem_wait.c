@@ -87,6 +87,8 @@ int nxsem_wait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+  irqstate_t cflags;
+  int16_t semcount;
   int ret = -EINVAL;
 
   /* This API should not be called from interrupt handlers */
@@ -104,13 +106,20 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+      /* Take one count from the semaphore.  If the count was not positive,
+       * this will indicate that we are waiting for the semaphore.
+       */
+
+      cflags   = nxsem_countlock();
+      semcount = sem->semcount--;
+      nxsem_countunlock(cflags);
+
       /* Check if the lock is available */
 
-      if (sem->semcount > 0)
+      if (semcount > 0)
         {
           /* It is, let the task take the semaphore. */
 
-          sem->semcount--;
           nxsem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -130,14 +139,14 @@ int nxsem_wait(FAR sem_t *sem)
 
           ASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-          sem->semcount--;
-
           /* Save the waited on semaphore in the TCB */
 
           rtcb->waitsem = sem;
 
+          /* And add the thread to the list of threads waiting on it */
+
+          nxsem_addwaiter(sem, rtcb);
+
           /* If priority inheritance is enabled, then check the priority of
            * the holder of the semaphore.
            */
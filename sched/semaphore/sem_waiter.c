@@ -0,0 +1,151 @@
+/****************************************************************************
+ * sched/semaphore/sem_waiter.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <semaphore.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_addwaiter
+ *
+ * Description:
+ *   Add a thread to the prioritized list of threads waiting for a count on
+ *   the semaphore.  Threads of equal priority are kept in FIFO order, the
+ *   same order that they have in the g_waitingforsemaphore list, so the
+ *   head of the list is always the thread that sem_post() will awaken.
+ *
+ * Parameters:
+ *   sem  - The semaphore being waited for
+ *   wtcb - The TCB of the waiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_addwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb)
+{
+  FAR struct tcb_s *prev;
+  FAR struct tcb_s *curr;
+
+  DEBUGASSERT(sem != NULL && wtcb != NULL);
+
+  /* Find the first waiter with a lower priority than the new waiter */
+
+  for (prev = NULL, curr = sem->whead;
+       curr != NULL && curr->sched_priority >= wtcb->sched_priority;
+       prev = curr, curr = curr->wflink);
+
+  /* And insert the new waiter in front of it */
+
+  wtcb->wflink = curr;
+  if (prev != NULL)
+    {
+      prev->wflink = wtcb;
+    }
+  else
+    {
+      sem->whead = wtcb;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsem_remwaiter
+ *
+ * Description:
+ *   Remove a thread from the list of threads waiting for a count on the
+ *   semaphore.  This happens when the thread receives the count, when the
+ *   wait is canceled, or when the thread is deleted while waiting.
+ *
+ * Parameters:
+ *   sem  - The semaphore that was being waited for
+ *   wtcb - The TCB of the thread that is no longer waiting
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsem_remwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb)
+{
+  FAR struct tcb_s *prev;
+  FAR struct tcb_s *curr;
+
+  DEBUGASSERT(sem != NULL && wtcb != NULL);
+
+  /* The thread receiving a count is normally the head of the list */
+
+  for (prev = NULL, curr = sem->whead;
+       curr != NULL && curr != wtcb;
+       prev = curr, curr = curr->wflink);
+
+  if (curr != NULL)
+    {
+      if (prev != NULL)
+        {
+          prev->wflink = curr->wflink;
+        }
+      else
+        {
+          sem->whead = curr->wflink;
+        }
+
+      curr->wflink = NULL;
+    }
+}
+
+#endif /* CONFIG_SEM_HOLDERLISTS */
@@ -80,6 +80,7 @@
 void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
 {
   irqstate_t flags;
+  irqstate_t cflags;
 
   /* Disable interrupts.  This is necessary (unfortunately) because an
    * interrupt handler may attempt to post the semaphore while we are
@@ -97,6 +98,10 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
       sem_t *sem = wtcb->waitsem;
       DEBUGASSERT(sem != NULL && sem->semcount < 0);
 
+      /* The thread is no longer waiting for the semaphore */
+
+      nxsem_remwaiter(sem, wtcb);
+
       /* Restore the correct priority of all threads that hold references
        * to this semaphore.
        */
@@ -109,7 +114,9 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
        * place.
        */
 
+      cflags = nxsem_countlock();
       sem->semcount++;
+      nxsem_countunlock(cflags);
 
       /* Indicate that the semaphore wait is over. */
 
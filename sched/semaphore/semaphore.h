@@ -109,6 +109,18 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define nxsem_canceled(stcb,sem)
 #endif
 
+/* Per-semaphore waiter lists and per-thread holder lists */
+
+#ifdef CONFIG_SEM_HOLDERLISTS
+void nxsem_addwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb);
+void nxsem_remwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb);
+void nxsem_freeholdings(FAR struct tcb_s *htcb);
+#else
+#  define nxsem_addwaiter(sem,wtcb)
+#  define nxsem_remwaiter(sem,wtcb)
+#  define nxsem_freeholdings(htcb)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -77,21 +77,21 @@ static FAR sigactq_t *nxsig_alloc_action(void)
 {
   FAR sigactq_t *sigact;
 
-  /* Try to get the signal action structure from the free list */
+  /* Try to get the signal action structure from the pool */
 
-  sigact = (FAR sigactq_t *)sq_remfirst(&g_sigfreeaction);
+  sigact = (FAR sigactq_t *)mempool_tryalloc(&g_sigactpool);
 
   /* Check if we got one. */
 
   if (!sigact)
     {
-      /* Add another block of signal actions to the list */
+      /* Add another block of signal actions to the pool */
 
-      nxsig_alloc_actionblock();
+      (void)mempool_extend(&g_sigactpool, NULL, NUM_SIGNAL_ACTIONS);
 
       /* And try again */
 
-      sigact = (FAR sigactq_t *)sq_remfirst(&g_sigfreeaction);
+      sigact = (FAR sigactq_t *)mempool_alloc(&g_sigactpool);
       ASSERT(sigact);
     }
 
@@ -306,7 +306,7 @@ int sigaction(int signo, FAR const struct sigaction *act, FAR struct sigaction *
 
 void nxsig_release_action(FAR sigactq_t *sigact)
 {
-  /* Just put it back on the free list */
+  /* Just put it back in the pool */
 
-  sq_addlast((FAR sq_entry_t *)sigact, &g_sigfreeaction);
+  mempool_free(&g_sigactpool, sigact);
 }
@@ -61,25 +61,17 @@
 
 FAR sigq_t *nxsig_alloc_pendingsigaction(void)
 {
-  FAR sigq_t    *sigq;
-  irqstate_t flags;
+  FAR sigq_t *sigq;
 
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
     {
-      /* Try to get the pending signal action structure from the free list */
-
-      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-
-      /* If so, then try the special list of structures reserved for
-       * interrupt handlers
+      /* Take a pending signal action structure from the pool.  Interrupt
+       * handlers may also use the structures in the pool reserve.
        */
 
-      if (!sigq)
-        {
-          sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingirqaction);
-        }
+      sigq = (FAR sigq_t *)mempool_alloc(&g_sigqpool);
     }
 
   /* If we were not called from an interrupt handler, then we are
@@ -87,22 +79,17 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
 
   else
     {
-      /* Try to get the pending signal action structure from the free list */
+      /* Try to get the pending signal action structure from the pool */
 
-      flags = enter_critical_section();
-      sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-      leave_critical_section(flags);
+      sigq = (FAR sigq_t *)mempool_tryalloc(&g_sigqpool);
 
       /* Check if we got one. */
 
       if (!sigq)
         {
-          /* No...Try the resource pool */
+          /* No...Try the heap */
 
-          if (!sigq)
-            {
-              sigq = (FAR sigq_t *)kmm_malloc((sizeof (sigq_t)));
-            }
+          sigq = (FAR sigq_t *)kmm_malloc((sizeof (sigq_t)));
 
           /* Check if we got an allocated message */
 
@@ -115,4 +102,3 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
 
   return sigq;
 }
-
@@ -93,10 +93,10 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
        * time, there should never be more than one signal in the sigpostedq
        */
 
-      flags = enter_critical_section();
+      flags = nxsig_lock();
       sq_rem((FAR sq_entry_t *)sigq, &(stcb->sigpendactionq));
       sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpostedq));
-      leave_critical_section(flags);
+      nxsig_unlock(flags);
 
       /* Call the signal handler (unless the signal was cancelled)
        *
@@ -155,9 +155,9 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
 
       /* Remove the signal from the sigpostedq */
 
-      flags = enter_critical_section();
+      flags = nxsig_lock();
       sq_rem((FAR sq_entry_t *)sigq, &(stcb->sigpostedq));
-      leave_critical_section(flags);
+      nxsig_unlock(flags);
 
       /* Then deallocate it */
 
@@ -40,6 +40,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <signal.h>
 #include <unistd.h>
@@ -56,6 +57,16 @@
 #include "signal/signal.h"
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SIG_FASTPATH
+/* Signal dispatch statistics */
+
+struct sig_stats_s g_sigstats;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -110,9 +121,9 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 
           /* Put it at the end of the pending signals list */
 
-          flags = enter_critical_section();
+          flags = nxsig_lock();
           sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpendactionq));
-          leave_critical_section(flags);
+          nxsig_unlock(flags);
         }
     }
 
@@ -131,24 +142,16 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
 static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 {
   FAR sigpendq_t *sigpend;
-  irqstate_t      flags;
 
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
     {
-      /* Try to get the pending signal structure from the free list */
-
-      sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
-      if (!sigpend)
-        {
-          /* If no pending signal structure is available in the free list,
-           * then try the special list of structures reserved for
-           * interrupt handlers
-           */
+      /* Take a pending signal structure from the pool.  Interrupt handlers
+       * may also use the structures in the pool reserve.
+       */
 
-          sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingirqsignal);
-        }
+      sigpend = (FAR sigpendq_t *)mempool_alloc(&g_sigpendpool);
     }
 
   /* If we were not called from an interrupt handler, then we are
@@ -157,11 +160,9 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 
   else
     {
-      /* Try to get the pending signal structure from the free list */
+      /* Try to get the pending signal structure from the pool */
 
-      flags = enter_critical_section();
-      sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
-      leave_critical_section(flags);
+      sigpend = (FAR sigpendq_t *)mempool_tryalloc(&g_sigpendpool);
 
       /* Check if we got one. */
 
@@ -169,10 +170,7 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
         {
           /* No... Allocate the pending signal */
 
-          if (!sigpend)
-            {
-              sigpend = (FAR sigpendq_t *)kmm_malloc((sizeof (sigpendq_t)));
-            }
+          sigpend = (FAR sigpendq_t *)kmm_malloc((sizeof (sigpendq_t)));
 
           /* Check if we got an allocated message */
 
@@ -271,6 +269,38 @@ static FAR sigpendq_t *nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
   return sigpend;
 }
 
+/****************************************************************************
+ * Name: nxsig_smp_schedule
+ *
+ * Description:
+ *   Executed by sched_smp_call() on the CPU that the signal recipient was
+ *   running on when the signal was dispatched.  The recipient is now most
+ *   likely the interrupted task on this CPU so the signal action can be
+ *   scheduled without pausing any CPU.
+ *
+ *   The task is identified by its PID.  It may have exited after the
+ *   request was queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+static void nxsig_smp_schedule(FAR void *arg)
+{
+  FAR struct tcb_s *stcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  stcb = sched_gettcb((pid_t)(uintptr_t)arg);
+  if (stcb != NULL)
+    {
+      up_schedule_sigaction(stcb, nxsig_deliver);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -308,6 +338,31 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
 
   DEBUGASSERT(stcb != NULL && info != NULL);
 
+#ifdef CONFIG_SIG_FASTPATH
+  /************************** HAND-OFF FAST PATH ***************************/
+
+  /* If the task is waiting for this signal, then the waiter accepts the
+   * signal whether or not it is masked:  Just hand it the signal
+   * information and unblock it.  There is no need to allocate and schedule
+   * a signal action.
+   */
+
+  flags = enter_critical_section();
+  if (stcb->task_state == TSTATE_WAIT_SIG &&
+      sigismember(&stcb->sigwaitmask, info->si_signo))
+    {
+      memcpy(&stcb->sigunbinfo, info, sizeof(siginfo_t));
+      stcb->sigwaitmask = NULL_SIGNAL_SET;
+      g_sigstats.handoffs++;
+      up_unblock_task(stcb);
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  g_sigstats.queued++;
+  leave_critical_section(flags);
+#endif
+
   /************************* MASKED SIGNAL HANDLING ************************/
 
   /* Check if the signal is masked -- if it is, it will be added to the list
@@ -359,7 +414,20 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
        * up_schedule_sigaction()
        */
 
-      up_schedule_sigaction(stcb, nxsig_deliver);
+#ifdef CONFIG_SMP_CALL
+      /* If the recipient is running on another CPU, then ask that CPU to
+       * schedule the signal action itself rather than pausing it.  Fall
+       * back to up_schedule_sigaction() if the request cannot be queued.
+       */
+
+      if (stcb->task_state != TSTATE_TASK_RUNNING ||
+          stcb->cpu == this_cpu() ||
+          sched_smp_call(stcb->cpu, nxsig_smp_schedule,
+                         (FAR void *)(uintptr_t)stcb->pid) < 0)
+#endif
+        {
+          up_schedule_sigaction(stcb, nxsig_deliver);
+        }
 
       /* Check if the task is waiting for an unmasked signal.  If so, then
        * unblock it. This must be performed in a critical section because
@@ -40,8 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
-#include <queue.h>
-#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 #include "signal/signal.h"
 
@@ -49,143 +48,55 @@
  * Public Data
  ****************************************************************************/
 
-/* The g_sigfreeaction data structure is a list of available signal
- * action structures.
+/* g_sigactpool is the pool of signal action structures.  It is extended
+ * from the heap when it is empty.
  */
 
-sq_queue_t  g_sigfreeaction;
+struct mempool_s g_sigactpool;
 
-/* The g_sigpendingaction data structure is a list of available pending
- * signal action structures.
- */
-
-sq_queue_t  g_sigpendingaction;
-
-/* The g_sigpendingirqaction is a list of available pending signal actions
- * that are reserved for use by interrupt handlers.
- */
-
-sq_queue_t  g_sigpendingirqaction;
-
-/* The g_sigpendingsignal data structure is a list of available pending
- * signal structures.
- */
-
-sq_queue_t  g_sigpendingsignal;
-
-/* The g_sigpendingirqsignal data structure is a list of available
- * pending signal structures that are reserved for use by interrupt
+/* g_sigqpool is the pool of pending signal action structures.
+ * NUM_PENDING_INT_ACTIONS of them are held in reserve for interrupt
  * handlers.
  */
 
-sq_queue_t  g_sigpendingirqsignal;
-
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-/* g_sigactionalloc is a pointer to the start of the allocated blocks of
- * signal actions.
- */
-
-static sigactq_t  *g_sigactionalloc;
-
-/* g_sigpendingactionalloc is a pointer to the start of the allocated
- * blocks of pending signal actions.
- */
-
-static sigq_t     *g_sigpendingactionalloc;
-
-/* g_sigpendingirqactionalloc is a pointer to the start of the allocated
- * block of pending signal actions.
- */
-
-static sigq_t     *g_sigpendingirqactionalloc;
+struct mempool_s g_sigqpool;
 
-/* g_sigpendingsignalalloc is a pointer to the start of the allocated
- * blocks of pending signals.
+/* g_sigpendpool is the pool of pending signal structures.
+ * NUM_INT_SIGNALS_PENDING of them are held in reserve for interrupt
+ * handlers.
  */
 
-static sigpendq_t *g_sigpendingsignalalloc;
+struct mempool_s g_sigpendpool;
 
-/* g_sigpendingirqsignalalloc is a pointer to the start of the allocated
- * blocks of pending signals.
+#ifdef CONFIG_SPINLOCK_SUBSYS
+/* This spinlock protects the sigpendactionq and sigpostedq lists of each
+ * thread.
  */
 
-static sigpendq_t *g_sigpendingirqsignalalloc;
-
-/****************************************************************************
- * Private Function Prototypes
- ****************************************************************************/
-
-static sigq_t     *nxsig_alloc_block(sq_queue_t *siglist, uint16_t nsigs,
-                                     uint8_t sigtype);
-static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
-                                                  uint16_t nsigs, uint8_t sigtype);
+struct subsys_lock_s g_siglock SP_SECTION = SUBSYS_LOCK_INITIALIZER("signal");
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxsig_alloc_block
+ * Name: nxsig_sigq_ctor and nxsig_sigpend_ctor
  *
  * Description:
- *   Allocate a block of pending signal actions and place them
- *   on the free list.
+ *   Mark each pre-allocated structure so that it is returned to its pool
+ *   when it is released.
  *
  ****************************************************************************/
 
-static sigq_t *nxsig_alloc_block(sq_queue_t *siglist, uint16_t nsigs,
-                                 uint8_t sigtype)
+static void nxsig_sigq_ctor(FAR void *obj, FAR void *arg)
 {
-  FAR sigq_t *sigqalloc;
-  FAR sigq_t *sigq;
-  int i;
-
-  /* Allocate a block of pending signal actions */
-
-  sigqalloc = (FAR sigq_t *)kmm_malloc((sizeof(sigq_t)) * nsigs);
-
-  sigq = sigqalloc;
-  for (i = 0; i < nsigs; i++)
-    {
-      sigq->type = sigtype;
-      sq_addlast((FAR sq_entry_t *)sigq++, siglist);
-    }
-
-  return sigqalloc;
+  ((FAR sigq_t *)obj)->type = SIG_ALLOC_FIXED;
 }
 
-/****************************************************************************
- * Name: nxsig_alloc_pendingsignalblock
- *
- * Description:
- *   Allocate a block of pending signal structures  and place them on
- *   the free list.
- *
- ****************************************************************************/
-
-static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
-                                                  uint16_t nsigs, uint8_t sigtype)
+static void nxsig_sigpend_ctor(FAR void *obj, FAR void *arg)
 {
-  FAR sigpendq_t *sigpendalloc;
-  FAR sigpendq_t *sigpend;
-  int i;
-
-  /* Allocate a block of pending signal structures  */
-
-  sigpendalloc =
-    (FAR sigpendq_t *)kmm_malloc((sizeof(sigpendq_t)) * nsigs);
-
-  sigpend = sigpendalloc;
-  for (i = 0; i < nsigs; i++)
-    {
-      sigpend->type = sigtype;
-      sq_addlast((FAR sq_entry_t *)sigpend++, siglist);
-    }
-
-  return sigpendalloc;
+  ((FAR sigpendq_t *)obj)->type = SIG_ALLOC_FIXED;
 }
 
 /****************************************************************************
@@ -202,61 +113,19 @@ static sigpendq_t *nxsig_alloc_pendingsignalblock(sq_queue_t *siglist,
 
 void nxsig_initialize(void)
 {
-  /* Initialize free lists */
-
-  sq_init(&g_sigfreeaction);
-  sq_init(&g_sigpendingaction);
-  sq_init(&g_sigpendingirqaction);
-  sq_init(&g_sigpendingsignal);
-  sq_init(&g_sigpendingirqsignal);
-
-  /* Add a block of signal structures to each list */
-
-  g_sigpendingactionalloc =
-    nxsig_alloc_block(&g_sigpendingaction,
-                      NUM_PENDING_ACTIONS,
-                      SIG_ALLOC_FIXED);
-
-  g_sigpendingirqactionalloc =
-    nxsig_alloc_block(&g_sigpendingirqaction,
-                      NUM_PENDING_INT_ACTIONS,
-                      SIG_ALLOC_IRQ);
-
-  nxsig_alloc_actionblock();
-
-  g_sigpendingsignalalloc =
-    nxsig_alloc_pendingsignalblock(&g_sigpendingsignal,
-                                   NUM_SIGNALS_PENDING,
-                                   SIG_ALLOC_FIXED);
-
-  g_sigpendingirqsignalalloc =
-    nxsig_alloc_pendingsignalblock(&g_sigpendingirqsignal,
-                                   NUM_INT_SIGNALS_PENDING,
-                                   SIG_ALLOC_IRQ);
-}
-
-/****************************************************************************
- * Name: nxsig_alloc_actionblock
- *
- * Description:
- *   Allocate a block of signal actions and place them
- *   on the free list.
- *
- ****************************************************************************/
-
-void nxsig_alloc_actionblock(void)
-{
-  FAR sigactq_t *sigact;
-  int i;
+  /* Load each pool with a block of structures allocated from the heap */
 
-  /* Allocate a block of signal actions */
+  (void)mempool_initialize(&g_sigactpool, "sigact", NULL,
+                           sizeof(sigactq_t), NUM_SIGNAL_ACTIONS,
+                           0, NULL, NULL);
 
-  g_sigactionalloc =
-    (FAR sigactq_t *)kmm_malloc((sizeof(sigactq_t)) * NUM_SIGNAL_ACTIONS);
+  (void)mempool_initialize(&g_sigqpool, "sigq", NULL, sizeof(sigq_t),
+                           NUM_PENDING_ACTIONS + NUM_PENDING_INT_ACTIONS,
+                           NUM_PENDING_INT_ACTIONS, nxsig_sigq_ctor, NULL);
 
-  sigact = g_sigactionalloc;
-  for (i = 0; i < NUM_SIGNAL_ACTIONS; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)sigact++, &g_sigfreeaction);
-    }
+  (void)mempool_initialize(&g_sigpendpool, "sigpend", NULL,
+                           sizeof(sigpendq_t),
+                           NUM_SIGNALS_PENDING + NUM_INT_SIGNALS_PENDING,
+                           NUM_INT_SIGNALS_PENDING, nxsig_sigpend_ctor,
+                           NULL);
 }
@@ -45,6 +45,7 @@
 #include <errno.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
@@ -107,7 +108,11 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
                     FAR struct timespec *rmtp)
 {
   irqstate_t flags;
+#ifdef CONFIG_HRTIMER
+  struct timespec starttime;
+#else
   systime_t starttick;
+#endif
   sigset_t set;
   int ret;
 
@@ -124,7 +129,11 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
    */
 
   flags     = enter_critical_section();
+#ifdef CONFIG_HRTIMER
+  (void)up_timer_gettime(&starttime);
+#else
   starttick = clock_systimer();
+#endif
 
   /* Set up for the sleep.  Using the empty set means that we are not
    * waiting for any particular signal.  However, any unmasked signal can
@@ -158,6 +167,18 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
 
   if (rmtp)
     {
+#ifdef CONFIG_HRTIMER
+      struct timespec elapsed;
+
+      /* The sleep was not rounded to the system tick so neither is the
+       * remaining time.  clock_timespec_subtract() returns zero if the
+       * difference is negative.
+       */
+
+      (void)up_timer_gettime(&elapsed);
+      clock_timespec_subtract(&elapsed, &starttime, &elapsed);
+      clock_timespec_subtract(rqtp, &elapsed, rmtp);
+#else
       systime_t elapsed;
       systime_t remaining;
       ssystime_t ticks;
@@ -192,6 +213,7 @@ int nxsig_nanosleep(FAR const struct timespec *rqtp,
         }
 
       (void)clock_ticks2time((ssystime_t)remaining, rmtp);
+#endif
     }
 
   leave_critical_section(flags);
@@ -59,34 +59,13 @@
 
 void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
 {
-  irqstate_t flags;
-
-  /* If this is a generally available pre-allocated structyre,
-   * then just put it back in the free list.
+  /* If this is a pre-allocated structure, then just put it back in the
+   * pool.
    */
 
   if (sigq->type == SIG_ALLOC_FIXED)
     {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers. */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingaction);
-      leave_critical_section(flags);
-    }
-
-  /* If this is a message pre-allocated for interrupts,
-   * then put it back in the correct  free list.
-   */
-
-  else if (sigq->type == SIG_ALLOC_IRQ)
-    {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers. */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingirqaction);
-      leave_critical_section(flags);
+      mempool_free(&g_sigqpool, sigq);
     }
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
@@ -67,36 +67,13 @@
 
 void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
 {
-  irqstate_t flags;
-
-  /* If this is a generally available pre-allocated structyre,
-   * then just put it back in the free list.
+  /* If this is a pre-allocated structure, then just put it back in the
+   * pool.
    */
 
   if (sigpend->type == SIG_ALLOC_FIXED)
     {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingsignal);
-      leave_critical_section(flags);
-    }
-
-  /* If this is a message pre-allocated for interrupts,
-   * then put it back in the correct free list.
-   */
-
-  else if (sigpend->type == SIG_ALLOC_IRQ)
-    {
-      /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
-       */
-
-      flags = enter_critical_section();
-      sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingirqsignal);
-      leave_critical_section(flags);
+      mempool_free(&g_sigpendpool, sigpend);
     }
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
@@ -52,6 +52,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 
@@ -143,6 +144,26 @@ static void nxsig_timeout(int argc, wdparm_t itcb)
 #endif
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   A high resolution timeout elapsed while waiting for signals to be
+ *   queued.
+ *
+ * Assumptions:
+ *   This function executes in the context of the alarm interrupt handler.
+ *   Local interrupts are assumed to be disabled on entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void nxsig_hrtimeout(FAR void *arg)
+{
+  nxsig_timeout(1, (wdparm_t)((uintptr_t)arg));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -244,7 +265,9 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
   sigset_t intersection;
   FAR sigpendq_t *sigpend;
   irqstate_t flags;
+#ifndef CONFIG_HRTIMER
   int32_t waitticks;
+#endif
   int ret;
 
   DEBUGASSERT(set != NULL && rtcb->waitdog == NULL);
@@ -319,6 +342,22 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       if (timeout != NULL)
         {
+#ifdef CONFIG_HRTIMER
+          /* Start the high resolution timer.  The timeout is not rounded
+           * to the system tick.
+           */
+
+          (void)hrtimer_start(&rtcb->waithrt, timeout, nxsig_hrtimeout,
+                              (FAR void *)rtcb);
+
+          /* Now wait for either the signal or the timeout */
+
+          up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+          /* We no longer need the timer */
+
+          (void)hrtimer_cancel(&rtcb->waithrt);
+#else
           /* Convert the timespec to system clock ticks, making sure that
            * the resulting delay is greater than or equal to the requested
            * time in nanoseconds.
@@ -372,6 +411,7 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
           /* REVISIT: And do what if there are no watchdog timers?  The wait
            * will fail and we will return something bogus.
            */
+#endif
         }
 
       /* No timeout, just wait */
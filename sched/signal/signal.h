@@ -48,13 +48,17 @@
 #include <sched.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mempool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* The following definition determines the number of signal structures to
- * allocate in a block
+/* The following definitions determine the number of signal structures to
+ * allocate in a block.  The *_INT_* structures are the pool reserve that
+ * only interrupt handlers may use.
  */
 
 #define NUM_SIGNAL_ACTIONS      16
@@ -63,15 +67,27 @@
 #define NUM_SIGNALS_PENDING     16
 #define NUM_INT_SIGNALS_PENDING  8
 
+/* In SMP configurations, the per-thread queues of pending signal actions
+ * may be protected by a subsystem spinlock rather than by the global
+ * critical section.  The signal pools have their own locks.
+ */
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+#  define nxsig_lock()    subsys_lock(&g_siglock)
+#  define nxsig_unlock(f) subsys_unlock(&g_siglock, (f))
+#else
+#  define nxsig_lock()    enter_critical_section()
+#  define nxsig_unlock(f) leave_critical_section(f)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
 enum sigalloc_e
 {
-  SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
-  SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_FIXED = 0,  /* From the pool; returned to the pool */
+  SIG_ALLOC_DYN         /* dynamically allocated; free when unused */
 };
 typedef enum sigalloc_e sigalloc_t;
 
@@ -117,39 +133,45 @@ struct sigq_s
 };
 typedef struct sigq_s sigq_t;
 
+#ifdef CONFIG_SIG_FASTPATH
+/* Signal dispatch statistics */
+
+struct sig_stats_s
+{
+  uint32_t handoffs;             /* Signals handed directly to a waiter */
+  uint32_t queued;               /* Signals that took the normal path */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* The g_sigfreeaction data structure is a list of available signal action
- * structures.
- */
+/* The pool of signal action structures */
 
-extern sq_queue_t  g_sigfreeaction;
+extern struct mempool_s g_sigactpool;
 
-/* The g_sigpendingaction data structure is a list of available pending
- * signal action structures.
- */
+/* The pool of pending signal action structures */
 
-extern sq_queue_t  g_sigpendingaction;
+extern struct mempool_s g_sigqpool;
 
-/* The g_sigpendingirqaction is a list of available pending signal actions
- * that are reserved for use by interrupt handlers.
- */
+/* The pool of pending signal structures */
 
-extern sq_queue_t  g_sigpendingirqaction;
+extern struct mempool_s g_sigpendpool;
 
-/* The g_sigpendingsignal data structure is a list of available pending
- * signal structures.
- */
+#ifdef CONFIG_SIG_FASTPATH
+/* Signal dispatch statistics.  Modified only within a critical section. */
 
-extern sq_queue_t  g_sigpendingsignal;
+extern struct sig_stats_s g_sigstats;
+#endif
 
-/* The g_sigpendingirqsignal data structure is a list of available pending
- * signal structures that are reserved for use by interrupt handlers.
+#ifdef CONFIG_SPINLOCK_SUBSYS
+/* This spinlock protects the sigpendactionq and sigpostedq lists of each
+ * thread.
  */
 
-extern sq_queue_t  g_sigpendingirqsignal;
+extern struct subsys_lock_s g_siglock;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -163,7 +185,6 @@ struct task_group_s;
 /* sig_initializee.c */
 
 void weak_function nxsig_initialize(void);
-void               nxsig_alloc_actionblock(void);
 
 /* sig_action.c */
 
@@ -81,6 +81,19 @@ struct spawn_parms_s
   } u;
 };
 
+/* This structure passes the file actions and attributes to the start hook
+ * of a new task.  It lives on the stack of the parent task which waits
+ * until the start hook has run.
+ */
+
+struct spawn_hook_s
+{
+  FAR const posix_spawn_file_actions_t *file_actions;
+  FAR const posix_spawnattr_t *attr;
+  sem_t done;                 /* Posted when the start hook has run */
+  int result;                 /* Result of the file actions */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -159,4 +172,51 @@ int spawn_execattrs(pid_t pid, FAR const posix_spawnattr_t *attr);
 int spawn_proxyattrs(FAR const posix_spawnattr_t *attr,
                      FAR const posix_spawn_file_actions_t *file_actions);
 
+/****************************************************************************
+ * Name: spawn_sethook
+ *
+ * Description:
+ *   Arrange for the file actions and the signal mask to be applied on the
+ *   thread of the new child task, before its entry point is called.
+ *
+ * Input Parameters:
+ *   pid - The pid of the new task.
+ *   hook - Caller allocated start hook state holding the attributes and
+ *     the file actions to use
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   That task has been started but has not yet executed because pre-
+ *   emption is disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+void spawn_sethook(pid_t pid, FAR struct spawn_hook_s *hook);
+#endif
+
+/****************************************************************************
+ * Name: spawn_waithook
+ *
+ * Description:
+ *   Wait for the start hook configured by spawn_sethook() to run.  If the
+ *   file actions failed, the new task exits with status 127.
+ *
+ * Input Parameters:
+ *   hook - The start hook state passed to spawn_sethook()
+ *
+ * Returned Value:
+ *   0 (OK) on success; An errno value if a file action failed.
+ *
+ * Assumptions:
+ *   Pre-emption is enabled so that the new task can run.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+int spawn_waithook(FAR struct spawn_hook_s *hook);
+#endif
+
 #endif /* __SCHED_TASK_SPAWN_H */
@@ -181,5 +181,13 @@ int task_exit(void)
       (void)sched_mergepending();
     }
 
+#ifdef CONFIG_SCHED_CPUTIME
+  /* The exiting task was not suspended in the normal way.  Start charging
+   * execution time to the task that will run next.
+   */
+
+  sched_cputime_resume(this_task());
+#endif
+
   return ret;
 }
@@ -689,6 +689,14 @@ void task_exithook(FAR struct tcb_s *tcb, int status, bool nonblocking)
       task_flushstreams(tcb);
     }
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Remove the thread's persistent poll() registrations while its files
+   * are still open.
+   */
+
+  poll_releasecache(tcb);
+#endif
+
 #ifdef HAVE_TASK_GROUP
   /* Leave the task group.  Perhaps discarding any un-reaped child
    * status (no zombies here!)
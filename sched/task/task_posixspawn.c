@@ -88,6 +88,11 @@
  *     array of pointers to null-terminated strings. The list is terminated
  *     with a null pointer.
  *
+ *   hook - If non-NULL, the file actions and signal mask described by this
+ *     start hook state will be applied on the thread of the new task before
+ *     its entry point is called.  This function will not return until that
+ *     has been done.
+ *
  * Returned Value:
  *   This function will return zero on success. Otherwise, an error number
  *   will be returned as the function return value to indicate the error.
@@ -98,7 +103,8 @@
 
 static int posix_spawn_exec(FAR pid_t *pidp, FAR const char *path,
                             FAR const posix_spawnattr_t *attr,
-                            FAR char * const argv[])
+                            FAR char * const argv[],
+                            FAR struct spawn_hook_s *hook)
 {
   FAR const struct symtab_s *symtab;
   int nsymbols;
@@ -145,10 +151,29 @@ static int posix_spawn_exec(FAR pid_t *pidp, FAR const char *path,
       (void)spawn_execattrs(pid, attr);
     }
 
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  /* The new task will perform its own file actions when it first runs */
+
+  if (hook != NULL)
+    {
+      spawn_sethook(pid, hook);
+    }
+#endif
+
   /* Re-enable pre-emption and return */
 
 errout:
   sched_unlock();
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  /* Wait for the new task to perform the file actions */
+
+  if (ret == OK && hook != NULL)
+    {
+      ret = spawn_waithook(hook);
+    }
+#endif
+
   return ret;
 }
 
@@ -158,15 +183,14 @@ errout:
  * Description:
  *   Perform file_actions, then execute the task from the file system.
  *
- *   Do we really need this proxy task?  Isn't that wasteful?
- *
- *   Q: Why not use a starthook so that there is callout from task_start()
- *      to perform these operations after the file is loaded from
- *      the file system?
- *   A: That existing task_starthook() implementation cannot be used in
- *      this context; any of task_starthook() will also conflict with
- *      binfmt's use of the start hook to call C++ static initializers.
- *      task_restart() would also be an issue.
+ *   The proxy task is only used if CONFIG_POSIX_SPAWN_STARTHOOK is not
+ *   selected.  Otherwise, posix_spawn_exec() installs a start hook with
+ *   spawn_sethook() and the file actions are performed on the thread of
+ *   the new task, directly on its own file descriptors, before its entry
+ *   point is called.  That option cannot be used together with
+ *   CONFIG_BINFMT_CONSTRUCTORS because binfmt uses the start hook to call
+ *   C++ static initializers.  The file actions are also not performed
+ *   again if the new task is restarted with task_restart().
  *
  * Input Parameters:
  *   Standard task start-up parameters
@@ -176,6 +200,7 @@ errout:
  *
  ****************************************************************************/
 
+#ifndef CONFIG_POSIX_SPAWN_STARTHOOK
 static int posix_spawn_proxy(int argc, FAR char *argv[])
 {
   int ret;
@@ -201,7 +226,7 @@ static int posix_spawn_proxy(int argc, FAR char *argv[])
       /* Start the task */
 
       ret = posix_spawn_exec(g_spawn_parms.pid, g_spawn_parms.u.posix.path,
-                             g_spawn_parms.attr, g_spawn_parms.argv);
+                             g_spawn_parms.attr, g_spawn_parms.argv, NULL);
 
 #ifdef CONFIG_SCHED_HAVE_PARENT
       if (ret == OK)
@@ -229,6 +254,7 @@ static int posix_spawn_proxy(int argc, FAR char *argv[])
 #endif
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -339,12 +365,16 @@ int posix_spawn(FAR pid_t *pid, FAR const char *path,
                 FAR char *const argv[], FAR char *const envp[])
 #endif
 {
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  struct spawn_hook_s hook;
+#else
   struct sched_param param;
   pid_t proxy;
 #ifdef CONFIG_SCHED_WAITPID
   int status;
 #endif
   int ret;
+#endif
 
   DEBUGASSERT(path);
 
@@ -363,9 +393,19 @@ int posix_spawn(FAR pid_t *pid, FAR const char *path,
   if (file_actions ==  NULL || *file_actions == NULL)
 #endif
     {
-      return posix_spawn_exec(pid, path, attr, argv);
+      return posix_spawn_exec(pid, path, attr, argv, NULL);
     }
 
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  /* Otherwise, the file actions and the signal mask change will be
+   * performed on the thread of the new task before its entry point is
+   * called.  No intermediary/proxy task is needed.
+   */
+
+  hook.file_actions = file_actions ? *file_actions : NULL;
+  hook.attr         = attr;
+  return posix_spawn_exec(pid, path, attr, argv, &hook);
+#else
   /* Otherwise, we will have to go through an intermediary/proxy task in order
    * to perform the I/O redirection.  This would be a natural place to fork().
    * However, true fork() behavior requires an MMU and most implementations
@@ -448,4 +488,5 @@ errout_with_lock:
 #endif
   spawn_semgive(&g_spawn_parmsem);
   return ret;
+#endif
 }
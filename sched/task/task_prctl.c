@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/prctl.h>
+#include <stdint.h>
 #include <stdarg.h>
 #include <string.h>
 #include <errno.h>
@@ -153,17 +154,81 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+      case PR_SET_TIMERSLACK:
+      case PR_GET_TIMERSLACK:
+#ifdef CONFIG_WDOG_SLACK
+        {
+          FAR struct tcb_s *tcb;
+          unsigned long slack = 0;
+          FAR unsigned long *pslack = NULL;
+          int pid;
+
+          /* Get the prctl arguments */
+
+          if (option == PR_SET_TIMERSLACK)
+            {
+              slack  = va_arg(ap, unsigned long);
+            }
+          else
+            {
+              pslack = va_arg(ap, FAR unsigned long *);
+            }
+
+          pid = va_arg(ap, int);
+
+          /* Get the TCB associated with the PID (handling the special case of
+           * pid==0 meaning "this thread")
+           */
+
+          tcb = pid ? sched_gettcb(pid) : this_task();
+          if (!tcb)
+            {
+              serr("ERROR: Pid does not correspond to a task: %d\n", pid);
+              errcode = ESRCH;
+              goto errout;
+            }
+
+          /* Now get or set the timer slack */
+
+          if (option == PR_SET_TIMERSLACK)
+            {
+              if (slack > UINT32_MAX)
+                {
+                  errcode = EINVAL;
+                  goto errout;
+                }
+
+              tcb->timerslack = (uint32_t)slack;
+            }
+          else
+            {
+              if (!pslack)
+                {
+                  errcode = EFAULT;
+                  goto errout;
+                }
+
+              *pslack = tcb->timerslack;
+            }
+        }
+        break;
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
         goto errout;
     }
 
-  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0.  NOTE: This might
-   * change if additional commands are supported.
+  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0 or CONFIG_WDOG_SLACK
+   * is selected.
    */
 
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_WDOG_SLACK)
   va_end(ap);
   return OK;
 #endif
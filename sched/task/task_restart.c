@@ -153,7 +153,19 @@ int task_restart(pid_t pid)
   tasklist = TLIST_HEAD(tcb->cmn.task_state);
 #endif
 
-  dq_rem((FAR dq_entry_t *)tcb, tasklist);
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The indexed ready-to-run list must be updated with the index */
+
+  if (tasklist == (FAR dq_queue_t *)&g_readytorun)
+    {
+      sched_rtrremove((FAR struct tcb_s *)tcb);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+    }
+
   tcb->cmn.task_state = TSTATE_TASK_INVALID;
 
   /* Deallocate anything left in the TCB's queues */
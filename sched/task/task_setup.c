@@ -403,6 +403,18 @@ static int thread_schedsetup(FAR struct tcb_s *tcb, int priority,
       task_inherit_affinity(tcb);
 #endif
 
+#ifdef CONFIG_MM_HEAPS
+      /* All threads inherit the default heap of the parent thread */
+
+      tcb->heap = this_task()->heap;
+#endif
+
+#ifdef CONFIG_WDOG_SLACK
+      /* And the watchdog timer slack */
+
+      tcb->timerslack = this_task()->timerslack;
+#endif
+
 #ifndef CONFIG_DISABLE_SIGNALS
       /* exec(), pthread_create(), task_create(), and vfork() all
        * inherit the signal mask of the parent thread.
@@ -504,7 +516,6 @@ static inline int task_stackargsetup(FAR struct task_tcb_s *tcb,
   FAR char *str;
   size_t strtablen;
   size_t argvlen;
-  int nbytes;
   int argc;
   int i;
 
@@ -576,14 +587,14 @@ static inline int task_stackargsetup(FAR struct task_tcb_s *tcb,
 
   str = (FAR char *)stackargv + argvlen;
 
-  /* Copy the task name.  Increment str to skip over the task name and its
-   * NUL terminator in the string buffer.
+  /* Copy the task name.  stpcpy() returns the address of the copied NUL
+   * terminator so each string is only scanned once while it is copied.
+   * Increment str to skip over the task name and its NUL terminator in the
+   * string buffer.
    */
 
   stackargv[0] = str;
-  nbytes       = strlen(name) + 1;
-  strcpy(str, name);
-  str         += nbytes;
+  str          = stpcpy(str, name) + 1;
 
   /* Copy each argument */
 
@@ -595,9 +606,7 @@ static inline int task_stackargsetup(FAR struct task_tcb_s *tcb,
        */
 
       stackargv[i + 1] = str;
-      nbytes           = strlen(argv[i]) + 1;
-      strcpy(str, argv[i]);
-      str             += nbytes;
+      str              = stpcpy(str, argv[i]) + 1;
     }
 
   /* Put a terminator entry at the end of the argv[] array.  Then save the
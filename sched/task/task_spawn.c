@@ -89,6 +89,11 @@
  *     array of pointers to null-terminated strings. The list is terminated
  *     with a null pointer.
  *
+ *   hook - If non-NULL, the file actions and signal mask described by this
+ *     start hook state will be applied on the thread of the new task before
+ *     its entry point is called.  This function will not return until that
+ *     has been done.
+ *
  * Returned Value:
  *   This function will return zero on success. Otherwise, an error number
  *   will be returned as the function return value to indicate the error.
@@ -99,7 +104,8 @@
 
 static int task_spawn_exec(FAR pid_t *pidp, FAR const char *name,
                            main_t entry, FAR const posix_spawnattr_t *attr,
-                           FAR char * const *argv)
+                           FAR char * const *argv,
+                           FAR struct spawn_hook_s *hook)
 {
   size_t stacksize;
   int priority;
@@ -164,10 +170,29 @@ static int task_spawn_exec(FAR pid_t *pidp, FAR const char *name,
       (void)spawn_execattrs(pid, attr);
     }
 
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  /* The new task will perform its own file actions when it first runs */
+
+  if (hook != NULL)
+    {
+      spawn_sethook(pid, hook);
+    }
+#endif
+
   /* Re-enable pre-emption and return */
 
 errout:
   sched_unlock();
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  /* Wait for the new task to perform the file actions */
+
+  if (ret == OK && hook != NULL)
+    {
+      ret = spawn_waithook(hook);
+    }
+#endif
+
   return ret;
 }
 
@@ -177,22 +202,14 @@ errout:
  * Description:
  *   Perform file_actions, then execute the task from the file system.
  *
- *   Do we really need a proxy task in this case?  Isn't that wasteful?
- *
- *   Q: Why can we do what we need to do here and the just call the
- *      new task's entry point.
- *   A: This would require setting up the name, priority, and stacksize from
- *      the task_spawn, but it do-able.  The only issue I can think of is
- *      that NuttX supports task_restart(), and you would never be able to
- *      restart a task from this point.
- *
- *   Q: Why not use a starthook so that there is callout from task_start()
- *      to perform these operations?
- *   A: Good idea, except that existing task_starthook() implementation
- *      cannot be used here unless we get rid of task_create and, instead,
- *      use task_init() and task_activate().  start_taskhook() could then
- *      be called between task_init() and task)activate().  task_restart()
- *      would still be an issue.
+ *   The proxy task is only used if CONFIG_POSIX_SPAWN_STARTHOOK is not
+ *   selected.  Otherwise, task_spawn_exec() installs a start hook with
+ *   spawn_sethook() while pre-emption is still disabled after
+ *   nxtask_create().  The file actions are then performed on the thread of
+ *   the new task, directly on its own file descriptors, before its entry
+ *   point is called, and the caller waits in spawn_waithook() for the
+ *   result.  The file actions are not performed again if the new task is
+ *   restarted with task_restart().
  *
  * Input Parameters:
  *   Standard task start-up parameters
@@ -202,6 +219,7 @@ errout:
  *
  ****************************************************************************/
 
+#ifndef CONFIG_POSIX_SPAWN_STARTHOOK
 static int task_spawn_proxy(int argc, FAR char *argv[])
 {
   int ret;
@@ -228,7 +246,7 @@ static int task_spawn_proxy(int argc, FAR char *argv[])
 
       ret = task_spawn_exec(g_spawn_parms.pid, g_spawn_parms.u.task.name,
                             g_spawn_parms.u.task.entry, g_spawn_parms.attr,
-                            g_spawn_parms.argv);
+                            g_spawn_parms.argv, NULL);
 
 #ifdef CONFIG_SCHED_HAVE_PARENT
       if (ret == OK)
@@ -256,6 +274,7 @@ static int task_spawn_proxy(int argc, FAR char *argv[])
 #endif
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -331,12 +350,16 @@ int task_spawn(FAR pid_t *pid, FAR const char *name, main_t entry,
                FAR const posix_spawnattr_t *attr,
                FAR char *const argv[], FAR char *const envp[])
 {
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  struct spawn_hook_s hook;
+#else
   struct sched_param param;
   pid_t proxy;
 #ifdef CONFIG_SCHED_WAITPID
   int status;
 #endif
   int ret;
+#endif
 
   sinfo("pid=%p name=%s entry=%p file_actions=%p attr=%p argv=%p\n",
         pid, name, entry, file_actions, attr, argv);
@@ -352,9 +375,19 @@ int task_spawn(FAR pid_t *pid, FAR const char *name, main_t entry,
   if (file_actions ==  NULL || *file_actions == NULL)
 #endif
     {
-      return task_spawn_exec(pid, name, entry, attr, argv);
+      return task_spawn_exec(pid, name, entry, attr, argv, NULL);
     }
 
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+  /* Otherwise, the file actions and the signal mask change will be
+   * performed on the thread of the new task before its entry point is
+   * called.  No intermediary/proxy task is needed.
+   */
+
+  hook.file_actions = file_actions ? *file_actions : NULL;
+  hook.attr         = attr;
+  return task_spawn_exec(pid, name, entry, attr, argv, &hook);
+#else
   /* Otherwise, we will have to go through an intermediary/proxy task in order
    * to perform the I/O redirection.  This would be a natural place to fork().
    * However, true fork() behavior requires an MMU and most implementations
@@ -438,6 +471,7 @@ errout_with_lock:
 #endif
   spawn_semgive(&g_spawn_parmsem);
   return ret;
+#endif
 }
 
 #endif /* CONFIG_BUILD_KERNEL */
@@ -39,14 +39,17 @@
 
 #include <nuttx/config.h>
 
+#include <stdlib.h>
 #include <semaphore.h>
 #include <fcntl.h>
 #include <spawn.h>
 #include <debug.h>
 
+#include <nuttx/semaphore.h>
 #include <nuttx/signal.h>
 #include <nuttx/spawn.h>
 
+#include "sched/sched.h"
 #include "task/spawn.h"
 #include "task/task.h"
 
@@ -151,6 +154,46 @@ static inline int spawn_open(FAR struct spawn_open_file_action_s *action)
   return ret;
 }
 
+/****************************************************************************
+ * Name: spawn_starthook
+ *
+ * Description:
+ *   Runs on the thread of the new task before its entry point is called.
+ *   Applies the signal mask and performs the file actions directly on the
+ *   file descriptors of the new task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+static void spawn_starthook(FAR void *arg)
+{
+  FAR struct spawn_hook_s *hook = (FAR struct spawn_hook_s *)arg;
+  FAR struct task_tcb_s *rtcb = (FAR struct task_tcb_s *)this_task();
+  int ret;
+
+  /* The hook state belongs to the parent.  Make sure that it is never
+   * referenced again if this task is restarted.
+   */
+
+  rtcb->starthook    = NULL;
+  rtcb->starthookarg = NULL;
+
+  ret = spawn_proxyattrs(hook->attr, hook->file_actions);
+
+  /* Inform the parent.  The hook state may not be accessed after this */
+
+  hook->result = ret;
+  spawn_semgive(&hook->done);
+
+  /* The new task must not run with partially applied file actions */
+
+  if (ret != OK)
+    {
+      exit(127);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -363,3 +406,71 @@ int spawn_proxyattrs(FAR const posix_spawnattr_t *attr,
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: spawn_sethook
+ *
+ * Description:
+ *   Arrange for the file actions and the signal mask to be applied on the
+ *   thread of the new child task, before its entry point is called.
+ *
+ * Input Parameters:
+ *   pid - The pid of the new task.
+ *   hook - Caller allocated start hook state holding the attributes and
+ *     the file actions to use
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   That task has been started but has not yet executed because pre-
+ *   emption is disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+void spawn_sethook(pid_t pid, FAR struct spawn_hook_s *hook)
+{
+  FAR struct tcb_s *tcb = sched_gettcb(pid);
+
+  DEBUGASSERT(tcb != NULL && hook != NULL);
+
+  hook->result = OK;
+
+  /* The semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&hook->done, 0, 0);
+  (void)nxsem_setprotocol(&hook->done, SEM_PRIO_NONE);
+
+  task_starthook((FAR struct task_tcb_s *)tcb, spawn_starthook, hook);
+}
+#endif
+
+/****************************************************************************
+ * Name: spawn_waithook
+ *
+ * Description:
+ *   Wait for the start hook configured by spawn_sethook() to run.  If the
+ *   file actions failed, the new task exits with status 127.
+ *
+ * Input Parameters:
+ *   hook - The start hook state passed to spawn_sethook()
+ *
+ * Returned Value:
+ *   0 (OK) on success; An errno value if a file action failed.
+ *
+ * Assumptions:
+ *   Pre-emption is enabled so that the new task can run.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_POSIX_SPAWN_STARTHOOK
+int spawn_waithook(FAR struct spawn_hook_s *hook)
+{
+  spawn_semtake(&hook->done);
+  (void)nxsem_destroy(&hook->done);
+  return hook->result;
+}
+#endif
@@ -159,7 +159,19 @@ int task_terminate(pid_t pid, bool nonblocking)
 
   /* Remove the task from the task list */
 
-  dq_rem((FAR dq_entry_t *)dtcb, tasklist);
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The indexed ready-to-run list must be updated with the index */
+
+  if (tasklist == (FAR dq_queue_t *)&g_readytorun)
+    {
+      sched_rtrremove(dtcb);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)dtcb, tasklist);
+    }
+
   dtcb->task_state = TSTATE_TASK_INVALID;
 
   /* At this point, the TCB should no longer be accessible to the system */
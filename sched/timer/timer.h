@@ -48,6 +48,7 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -71,6 +72,10 @@ struct posix_timer_s
   int             pt_delay;        /* If non-zero, used to reset repetitive timers */
   int             pt_last;         /* Last value used to set watchdog */
   WDOG_ID         pt_wdog;         /* The watchdog that provides the timing */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s pt_hrtimer;     /* Used instead of pt_wdog for timing */
+  struct timespec pt_interval;     /* If non-zero, used to reset repetitive timers */
+#endif
   struct sigevent pt_event;        /* Notification information */
 };
 
@@ -205,6 +205,12 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_delay = 0;
   ret->pt_wdog  = wdog;
 
+#ifdef CONFIG_HRTIMER
+  memset(&ret->pt_hrtimer, 0, sizeof(struct hrtimer_s));
+  ret->pt_interval.tv_sec  = 0;
+  ret->pt_interval.tv_nsec = 0;
+#endif
+
   /* Was a struct sigevent provided? */
 
   if (evp)
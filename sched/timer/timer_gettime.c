@@ -86,7 +86,9 @@
 int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
 {
   FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)timerid;
+#ifndef CONFIG_HRTIMER
   ssystime_t ticks;
+#endif
 
   if (!timer || !value)
     {
@@ -94,6 +96,15 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
       return ERROR;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Get the time remaining before the high resolution timer expires */
+
+  (void)hrtimer_gettime(&timer->pt_hrtimer, &value->it_value);
+  value->it_interval.tv_sec  = timer->pt_interval.tv_sec;
+  value->it_interval.tv_nsec = timer->pt_interval.tv_nsec;
+  return OK;
+#else
+
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(timer->pt_wdog);
@@ -103,6 +114,7 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
   (void)clock_ticks2time(ticks, &value->it_value);
   (void)clock_ticks2time(timer->pt_last, &value->it_interval);
   return OK;
+#endif
 }
 
 #endif /* CONFIG_DISABLE_POSIX_TIMERS */
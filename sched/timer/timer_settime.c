@@ -59,9 +59,15 @@
  ****************************************************************************/
 
 static inline void timer_signotify(FAR struct posix_timer_s *timer);
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR void *arg);
+static int timer_hrsettime(FAR struct posix_timer_s *timer, int flags,
+                           FAR const struct itimerspec *value);
+#else
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer);
 static void timer_timeout(int argc, wdparm_t itimer);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -123,6 +129,144 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
 #endif
 }
 
+#ifdef CONFIG_HRTIMER
+/****************************************************************************
+ * Name: timer_hrtimeout
+ *
+ * Description:
+ *   This function is called when the high resolution timer of a POSIX
+ *   timer expires.
+ *
+ * Parameters:
+ *   arg - A reference to the POSIX timer that just timed out
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function executes in the context of the alarm interrupt.
+ *
+ ****************************************************************************/
+
+static void timer_hrtimeout(FAR void *arg)
+{
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)arg;
+
+  /* Send the specified signal to the specified task.   Increment the
+   * reference count on the timer first so that will not be deleted until
+   * after the signal handler returns.
+   */
+
+  timer->pt_crefs++;
+  timer_signotify(timer);
+
+  /* Release the reference.  timer_release will return nonzero if the timer
+   * was not deleted.
+   */
+
+  if (timer_release(timer) &&
+      (timer->pt_interval.tv_sec > 0 || timer->pt_interval.tv_nsec > 0))
+    {
+      /* This is a repetitive timer:  Restart the high resolution timer */
+
+      (void)hrtimer_start(&timer->pt_hrtimer, &timer->pt_interval,
+                          timer_hrtimeout, timer);
+    }
+}
+
+/****************************************************************************
+ * Name: timer_hrsettime
+ *
+ * Description:
+ *   The high resolution implementation of timer_settime():  Arm or disarm
+ *   the high resolution timer of a POSIX timer.  Neither the initial
+ *   expiration nor the interval are rounded to the system tick.
+ *
+ * Parameters:
+ *   timer - The POSIX timer to arm or disarm
+ *   flags - TIMER_ABSTIME or zero
+ *   value - The new expiration time and interval
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int timer_hrsettime(FAR struct posix_timer_s *timer, int flags,
+                           FAR const struct itimerspec *value)
+{
+  struct timespec delay;
+  irqstate_t intflags;
+  int ret = OK;
+
+  /* Disarm the timer (in case the timer was already armed when
+   * timer_settime() is called).
+   */
+
+  (void)hrtimer_cancel(&timer->pt_hrtimer);
+
+  /* If the it_value member of value is zero, the timer will not be
+   * re-armed.
+   */
+
+  if (value->it_value.tv_sec <= 0 && value->it_value.tv_nsec <= 0)
+    {
+      return OK;
+    }
+
+  /* Setup up any repetitive timer */
+
+  if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
+    {
+      timer->pt_interval.tv_sec  = value->it_interval.tv_sec;
+      timer->pt_interval.tv_nsec = value->it_interval.tv_nsec;
+    }
+  else
+    {
+      timer->pt_interval.tv_sec  = 0;
+      timer->pt_interval.tv_nsec = 0;
+    }
+
+  intflags = enter_critical_section();
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      /* Calculate the delay to the absolute time in 'value'.
+       * clock_timespec_subtract() returns zero if the time is in the past.
+       */
+
+      (void)clock_gettime(CLOCK_REALTIME, &delay);
+      clock_timespec_subtract(&value->it_value, &delay, &delay);
+    }
+  else
+    {
+      delay.tv_sec  = value->it_value.tv_sec;
+      delay.tv_nsec = value->it_value.tv_nsec;
+    }
+
+  /* If the time is in the past or now, then set up the next interval
+   * instead (assuming a repetitive timer).
+   */
+
+  if (delay.tv_sec == 0 && delay.tv_nsec == 0)
+    {
+      delay.tv_sec  = timer->pt_interval.tv_sec;
+      delay.tv_nsec = timer->pt_interval.tv_nsec;
+    }
+
+  /* Then start the high resolution timer */
+
+  if (delay.tv_sec > 0 || delay.tv_nsec > 0)
+    {
+      ret = hrtimer_start(&timer->pt_hrtimer, &delay, timer_hrtimeout,
+                          timer);
+    }
+
+  leave_critical_section(intflags);
+  return ret;
+}
+
+#else
 /****************************************************************************
  * Name: timer_restart
  *
@@ -230,6 +374,7 @@ static void timer_timeout(int argc, wdparm_t itimer)
     }
 #endif
 }
+#endif /* CONFIG_HRTIMER */
 
 /****************************************************************************
  * Public Functions
@@ -304,8 +449,10 @@ int timer_settime(timer_t timerid, int flags,
                   FAR struct itimerspec *ovalue)
 {
   FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)timerid;
+#ifndef CONFIG_HRTIMER
   irqstate_t intflags;
   ssystime_t delay;
+#endif
   int ret = OK;
 
   /* Some sanity checks */
@@ -316,6 +463,19 @@ int timer_settime(timer_t timerid, int flags,
       return ERROR;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Use the high resolution timer */
+
+  ret = timer_hrsettime(timer, flags, value);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+#else
+
   /* Disarm the timer (in case the timer was already armed when timer_settime()
    * is called).
    */
@@ -404,6 +564,7 @@ int timer_settime(timer_t timerid, int flags,
 
   leave_critical_section(intflags);
   return ret;
+#endif
 }
 
 #endif /* CONFIG_DISABLE_POSIX_TIMERS */
@@ -72,16 +72,27 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
+#ifdef HAVE_WDOG_LOCK
+  irqstate_t wdflags;
+#endif
   int ret = -EINVAL;
 
   /* Prohibit timer interactions with the timer queue until the
-   * cancellation is complete
+   * cancellation is complete.  The critical section is still required
+   * when the list is protected by the watchdog lock:  Watchdog functions
+   * run in the critical section so, once we are in the critical section,
+   * we know that the watchdog function is not running on another CPU.
    */
 
   flags = enter_critical_section();
+#ifdef HAVE_WDOG_LOCK
+  wdflags = wd_lock();
+#endif
 
   /* Make sure that the watchdog is initialized (non-NULL) and is still
    * active.
@@ -89,6 +100,16 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Remove the watchdog from the timer wheel.  If it was the next
+       * timing event, reassess the interval timer.
+       */
+
+      if (wd_wheel_remove(wdog))
+        {
+          sched_timer_reassess();
+        }
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -139,9 +160,11 @@ int wd_cancel(WDOG_ID wdog)
           sched_timer_reassess();
         }
 
+      wdog->next = NULL;
+#endif
+
       /* Mark the watchdog inactive */
 
-      wdog->next = NULL;
       WDOG_CLRACTIVE(wdog);
 
       /* Return success */
@@ -149,6 +172,9 @@ int wd_cancel(WDOG_ID wdog)
       ret = OK;
     }
 
+#ifdef HAVE_WDOG_LOCK
+  wd_unlock(wdflags);
+#endif
   leave_critical_section(flags);
   return ret;
 }
@@ -43,9 +43,10 @@
 #include <queue.h>
 
 #include <nuttx/irq.h>
-#include <nuttx/wdog.h>
+#include <nuttx/arch.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
 
 #include "wdog/wdog.h"
 
@@ -72,50 +73,29 @@
 WDOG_ID wd_create (void)
 {
   FAR struct wdog_s *wdog;
-  irqstate_t flags;
-
-  /* These actions must be atomic with respect to other tasks and also with
-   * respect to interrupt handlers that may be allocating or freeing watchdog
-   * timers.
-   */
-
-  flags = enter_critical_section();
 
   /* If we are in an interrupt handler -OR- if the number of pre-allocated
    * timer structures exceeds the reserve, then take the next timer from
-   * the head of the free list.
+   * the pool.  The pool enforces the reserve.  Outside of an interrupt
+   * handler an empty pool is not a failure because we can still fall back
+   * to the heap below.
    */
 
-  if (g_wdnfree > CONFIG_WDOG_INTRESERVE || up_interrupt_context())
+  if (up_interrupt_context())
     {
-      /* Remove the watchdog timer from the free list */
-
-      wdog = (FAR struct wdog_s *)sq_remfirst(&g_wdfreelist);
-
-      /* Did we get one? */
-
-      if (wdog != NULL)
-        {
-          /* Yes.. decrement the count of free, pre-allocated timers (all
-           * with interrupts disabled).
-           */
-
-          DEBUGASSERT(g_wdnfree > 0);
-          g_wdnfree--;
-
-          /* Clear the forward link and all flags */
-
-          wdog->next  = NULL;
-          wdog->flags = 0;
-        }
-      else
-        {
-          /* We didn't get one... The count should then be exactly zero */
+      wdog = (FAR struct wdog_s *)mempool_alloc(&g_wdpool);
+    }
+  else
+    {
+      wdog = (FAR struct wdog_s *)mempool_tryalloc(&g_wdpool);
+    }
 
-          DEBUGASSERT(g_wdnfree == 0);
-        }
+  if (wdog != NULL)
+    {
+      /* Clear the forward link and all flags */
 
-      leave_critical_section(flags);
+      wdog->next  = NULL;
+      wdog->flags = 0;
     }
 
   /* We are in a normal tasking context AND there are not enough unreserved,
@@ -123,11 +103,8 @@ WDOG_ID wd_create (void)
    * heap.
    */
 
-  else
+  else if (!up_interrupt_context())
     {
-      /* We do not require that interrupts be disabled to do this. */
-
-      leave_critical_section(flags);
       wdog = (FAR struct wdog_s *)kmm_malloc(sizeof(struct wdog_s));
 
       /* Did we get one? */
@@ -71,9 +71,17 @@ int wd_gettime(WDOG_ID wdog)
 
   /* Verify the wdog */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* The watchdog holds its absolute expiration time */
+
+      int delay = wd_wheel_remaining(wdog);
+
+      wd_unlock(flags);
+      return delay;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -88,12 +96,58 @@ int wd_gettime(WDOG_ID wdog)
           delay += curr->lag;
           if (curr == wdog)
             {
-              leave_critical_section(flags);
+              wd_unlock(flags);
               return delay;
             }
         }
+#endif
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return 0;
 }
+
+/****************************************************************************
+ * Name: wd_getnext
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that there are no active watchdogs.
+ *
+ ****************************************************************************/
+
+int wd_getnext(void)
+{
+  irqstate_t flags;
+  int delay;
+
+  flags = wd_lock();
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* The wheel knows the delay to its next timing event.  That may be a
+   * cascade rather than an expiration so this is a lower bound.
+   */
+
+  delay = (int)wd_wheel_delay();
+#else
+  /* The lag of the watchdog at the head of the list is the delay until it
+   * expires.
+   */
+
+  delay = 0;
+  if (g_wdactivelist.head != NULL)
+    {
+      delay = ((FAR struct wdog_s *)g_wdactivelist.head)->lag;
+    }
+#endif
+
+  wd_unlock(flags);
+  return delay;
+}
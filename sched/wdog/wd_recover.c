@@ -42,6 +42,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/sched.h>
 
 #include "wdog/wdog.h"
@@ -88,5 +89,11 @@ void wd_recover(FAR struct tcb_s *tcb)
       tcb->waitdog = NULL;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* The same applies to a high resolution timed wait */
+
+  (void)hrtimer_cancel(&tcb->waithrt);
+#endif
+
   leave_critical_section(flags);
 }
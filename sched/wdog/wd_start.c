@@ -91,6 +91,55 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_callback
+ *
+ * Description:
+ *   Execute the function of an expired watchdog.
+ *
+ ****************************************************************************/
+
+static inline void wd_callback(FAR struct wdog_s *wdog)
+{
+  up_setpicbase(wdog->picbase);
+  switch (wdog->argc)
+    {
+      default:
+        DEBUGPANIC();
+        break;
+
+      case 0:
+        (*((wdentry0_t)(wdog->func)))(0);
+        break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+      case 1:
+        (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+      case 2:
+        (*((wdentry2_t)(wdog->func)))(2,
+                        wdog->parm[0], wdog->parm[1]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+      case 3:
+        (*((wdentry3_t)(wdog->func)))(3,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+      case 4:
+        (*((wdentry4_t)(wdog->func)))(4,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2], wdog->parm[3]);
+        break;
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -104,8 +153,34 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  * Returned Value:
  *   None
  *
+ * Assumptions:
+ *   Called from the timer interrupt within the critical section and, if
+ *   the watchdog lists are protected by the watchdog lock, with the
+ *   watchdog lock held.  The watchdog list is not empty.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+
+  /* Run all of the watchdogs that expired on the last tick.  A watchdog
+   * function may start or cancel other watchdogs meanwhile.
+   */
+
+  while ((wdog = wd_wheel_expired()) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      WDOG_CLRACTIVE(wdog);
+
+      /* Execute the watchdog function */
+
+      wd_callback(wdog);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -140,46 +215,64 @@ static inline void wd_expiration(void)
 
           /* Execute the watchdog function */
 
-          up_setpicbase(wdog->picbase);
-          switch (wdog->argc)
-            {
-              default:
-                DEBUGPANIC();
-                break;
+          wd_callback(wdog);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: wd_coalesce
+ *
+ * Description:
+ *   Look for an active watchdog that expires no earlier than 'delay' and no
+ *   later than 'delay' + 'slack' ticks.  If there is one, then return its
+ *   delay so that both watchdogs expire on the same timer interrupt.
+ *
+ * Parameters:
+ *   delay - The requested delay in ticks
+ *   slack - The number of ticks by which the expiration may be deferred
+ *
+ * Returned Value:
+ *   The delay to use for the watchdog
+ *
+ * Assumptions:
+ *   Called from wd_start() within the critical section after the lags of
+ *   the active watchdogs have been updated by sched_timer_cancel().
+ *
+ ****************************************************************************/
 
-              case 0:
-                (*((wdentry0_t)(wdog->func)))(0);
-                break;
+#ifdef CONFIG_WDOG_SLACK
+static int32_t wd_coalesce(int32_t delay, int32_t slack)
+{
+  FAR struct wdog_s *curr;
+  int32_t now = 0;
 
-#if CONFIG_MAX_WDOGPARMS > 0
-              case 1:
-                (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-              case 2:
-                (*((wdentry2_t)(wdog->func)))(2,
-                                wdog->parm[0], wdog->parm[1]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-              case 3:
-                (*((wdentry3_t)(wdog->func)))(3,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-              case 4:
-                (*((wdentry4_t)(wdog->func)))(4,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2], wdog->parm[3]);
-                break;
-#endif
+  /* The list is ordered by expiration time so only the first watchdog that
+   * does not expire before 'delay' needs to be considered.
+   */
+
+  for (curr = (FAR struct wdog_s *)g_wdactivelist.head;
+       curr != NULL;
+       curr = curr->next)
+    {
+      now += curr->lag;
+      if (now >= delay)
+        {
+          if (now > delay && now - delay <= slack)
+            {
+              g_wdcoalesced++;
+              g_wdslackticks += now - delay;
+              return now;
             }
+
+          break;
         }
     }
+
+  return delay;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -222,10 +315,15 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
+#ifdef CONFIG_WDOG_SLACK
+  int32_t slack;
+#endif
   irqstate_t flags;
   int i;
 
@@ -242,10 +340,20 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
    * the critical section is established.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
   if (WDOG_ISACTIVE(wdog))
     {
+#ifdef HAVE_WDOG_LOCK
+      /* wd_cancel() enters the critical section.  That must not be done
+       * while holding the watchdog lock.
+       */
+
+      wd_unlock(flags);
+      wd_cancel(wdog);
+      flags = wd_lock();
+#else
       wd_cancel(wdog);
+#endif
     }
 
   /* Save the data in the watchdog structure */
@@ -288,6 +396,36 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Add the watchdog to the timer wheel */
+
+  wd_wheel_insert(wdog, delay);
+#else
+#ifdef CONFIG_WDOG_SLACK
+  /* If the watchdog has slack, try to expire it together with another
+   * watchdog rather than to program a timer interrupt of its own.  There
+   * is no slack for watchdogs started from interrupt handlers.
+   */
+
+  if (WDOG_ISSLACK(wdog))
+    {
+      slack = wdog->slack;
+    }
+  else if (!up_interrupt_context())
+    {
+      slack = this_task()->timerslack / USEC_PER_TICK;
+    }
+  else
+    {
+      slack = 0;
+    }
+
+  if (slack > 0)
+    {
+      delay = wd_coalesce(delay, slack);
+    }
+#endif
+
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -373,9 +511,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active. */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -387,7 +529,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   sched_timer_resume();
 #endif
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return OK;
 }
 
@@ -416,7 +558,109 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_WDOG_TIMERWHEEL) && defined(CONFIG_SCHED_TICKLESS)
+unsigned int wd_timer(int ticks)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+  unsigned int delay;
+
+#ifdef CONFIG_SMP
+  /* In the SMP case, we must follow rules for critical sections even here
+   * in the interrupt handler.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  while (ticks > 0)
+    {
+      /* Skip over the ticks in which nothing happens */
+
+      delay = wd_wheel_delay();
+      if (delay == 0 || delay > (unsigned int)ticks)
+        {
+          wd_wheel_skip(ticks);
+          break;
+        }
+
+      wd_wheel_skip(delay - 1);
+      ticks -= delay;
+
+      /* Then process the tick with the next timing event */
+
+      if (wd_wheel_advance())
+        {
+          wd_expiration();
+        }
+    }
+
+  /* Return the delay for the next timing event */
+
+  delay = wd_wheel_delay();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return delay;
+}
+
+#elif defined(CONFIG_WDOG_TIMERWHEEL) && defined(HAVE_WDOG_LOCK)
+void wd_timer(void)
+{
+  irqstate_t csflags;
+  irqstate_t flags;
+
+  /* Only the watchdog lock is needed to advance the wheel.  Watchdog
+   * functions are executed within the critical section and the critical
+   * section must be entered before the watchdog lock is taken.
+   */
+
+  flags = wd_lock();
+  if (wd_wheel_advance())
+    {
+      wd_unlock(flags);
+      csflags = enter_critical_section();
+      flags   = wd_lock();
+
+      wd_expiration();
+
+      wd_unlock(flags);
+      leave_critical_section(csflags);
+      return;
+    }
+
+  wd_unlock(flags);
+}
+
+#elif defined(CONFIG_WDOG_TIMERWHEEL)
+void wd_timer(void)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+
+  /* In the SMP case, we must follow rules for critical sections even here
+   * in the interrupt handler.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  /* Advance the wheel by one tick and run the watchdogs that expired */
+
+  if (wd_wheel_advance())
+    {
+      wd_expiration();
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+
+#elif defined(CONFIG_SCHED_TICKLESS)
 unsigned int wd_timer(int ticks)
 {
   FAR struct wdog_s *wdog;
@@ -483,6 +727,45 @@ unsigned int wd_timer(int ticks)
   return ret;
 }
 
+#elif defined(HAVE_WDOG_LOCK)
+void wd_timer(void)
+{
+  FAR struct wdog_s *wdog;
+  irqstate_t csflags;
+  irqstate_t flags;
+
+  /* Only the watchdog lock is needed to decrement the lag counter of the
+   * watchdog at the head of the list.  This is the common case.
+   */
+
+  flags = wd_lock();
+  wdog  = (FAR struct wdog_s *)g_wdactivelist.head;
+
+  if (wdog != NULL && --(wdog->lag) <= 0)
+    {
+      /* A watchdog has expired.  Watchdog functions are executed within the
+       * critical section and the critical section must be entered before
+       * the watchdog lock is taken.  The list may change while the lock is
+       * released so wd_expiration() must re-examine the head of the list.
+       */
+
+      wd_unlock(flags);
+      csflags = enter_critical_section();
+      flags   = wd_lock();
+
+      if (g_wdactivelist.head != NULL)
+        {
+          wd_expiration();
+        }
+
+      wd_unlock(flags);
+      leave_critical_section(csflags);
+      return;
+    }
+
+  wd_unlock(flags);
+}
+
 #else
 void wd_timer(void)
 {
@@ -0,0 +1,441 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Level 0 of the wheel has one slot for each of the next 256 ticks.  Each
+ * of the levels 1 through 4 has 64 slots, each spanning 64 times as many
+ * ticks as a slot of the level below it.  Together the levels span the
+ * full 32-bit range of expiration times.
+ */
+
+#define WD_L0BITS         8
+#define WD_L0SLOTS        (1 << WD_L0BITS)
+#define WD_L0MASK         (WD_L0SLOTS - 1)
+#define WD_LNBITS         6
+#define WD_LNSLOTS        (1 << WD_LNBITS)
+#define WD_LNMASK         (WD_LNSLOTS - 1)
+#define WD_NLEVELS        5
+#define WD_NSLOTS         (WD_L0SLOTS + (WD_NLEVELS - 1) * WD_LNSLOTS)
+
+/* The first slot of a level and the log2 of the number of ticks spanned by
+ * one slot of a level (levels 1 through 4).
+ */
+
+#define WD_LEVEL(l)       (WD_L0SLOTS + ((l) - 1) * WD_LNSLOTS)
+#define WD_SHIFT(l)       (WD_L0BITS + ((l) - 1) * WD_LNBITS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slots of all levels of the wheel.  Each slot holds a singly linked
+ * list of watchdogs.  The 'pprev' link of each watchdog points back either
+ * to the slot or to the 'next' link of the preceding watchdog so that any
+ * watchdog can be removed in constant time.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WD_NSLOTS];
+
+/* One bit per slot is set when the slot holds watchdogs */
+
+static uint32_t g_wdmap[WD_NSLOTS / 32];
+
+/* The watchdogs that expired on the last tick and that are waiting to be
+ * run.
+ */
+
+static FAR struct wdog_s *g_wdexpired;
+
+/* The next tick to be processed and the number of watchdogs in the wheel */
+
+static uint32_t g_wdbase;
+static unsigned int g_wdcount;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Add a watchdog to the list of at '*head'.
+ *
+ ****************************************************************************/
+
+static inline void wd_wheel_link(FAR struct wdog_s **head,
+                                 FAR struct wdog_s *wdog)
+{
+  wdog->next = *head;
+  if (wdog->next != NULL)
+    {
+      wdog->next->pprev = &wdog->next;
+    }
+
+  wdog->pprev = head;
+  *head       = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Remove a watchdog from whatever list it is in and clear the occupancy
+ *   bit of a wheel slot that becomes empty.
+ *
+ ****************************************************************************/
+
+static inline void wd_wheel_unlink(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **pprev = wdog->pprev;
+  int slot;
+
+  *pprev = wdog->next;
+  if (wdog->next != NULL)
+    {
+      wdog->next->pprev = pprev;
+    }
+  else if (pprev >= &g_wdwheel[0] && pprev < &g_wdwheel[WD_NSLOTS] &&
+           *pprev == NULL)
+    {
+      slot = pprev - g_wdwheel;
+      g_wdmap[slot >> 5] &= ~(1u << (slot & 31));
+    }
+
+  wdog->next  = NULL;
+  wdog->pprev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_place
+ *
+ * Description:
+ *   Add a watchdog to the wheel slot for its expiration time relative to
+ *   the next tick to be processed.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_place(FAR struct wdog_s *wdog)
+{
+  uint32_t delta = wdog->expire - g_wdbase;
+  int level;
+  int slot;
+
+  if (delta < WD_L0SLOTS)
+    {
+      slot = wdog->expire & WD_L0MASK;
+    }
+  else
+    {
+      for (level = 1;
+           level < WD_NLEVELS - 1 &&
+           delta >= ((uint32_t)1 << (WD_SHIFT(level) + WD_LNBITS));
+           level++);
+
+      slot = WD_LEVEL(level) +
+             ((wdog->expire >> WD_SHIFT(level)) & WD_LNMASK);
+    }
+
+  wd_wheel_link(&g_wdwheel[slot], wdog);
+  g_wdmap[slot >> 5] |= 1u << (slot & 31);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-distribute the watchdogs of the current slot of a level 1 through 4
+ *   to the finer levels.  Returns the index of that slot so that the caller
+ *   knows when the next higher level must be cascaded as well.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_cascade(int level)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  int index;
+  int slot;
+
+  index = (g_wdbase >> WD_SHIFT(level)) & WD_LNMASK;
+  slot  = WD_LEVEL(level) + index;
+
+  wdog            = g_wdwheel[slot];
+  g_wdwheel[slot] = NULL;
+  g_wdmap[slot >> 5] &= ~(1u << (slot & 31));
+
+  for (; wdog != NULL; wdog = next)
+    {
+      next = wdog->next;
+      wd_wheel_place(wdog);
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_search
+ *
+ * Description:
+ *   Return the distance in slots from slot 'start' of a level to the first
+ *   occupied slot of that level (wrapping around), or -1 if the level is
+ *   empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_search(int first, int nslots, int start)
+{
+  FAR const uint32_t *map = &g_wdmap[first >> 5];
+  int nwords = nslots >> 5;
+  int word   = start >> 5;
+  uint32_t bits;
+  int i;
+
+  /* The word holding 'start' is examined first for the slots at or after
+   * 'start' and, after all other words, once more for the slots before it.
+   */
+
+  bits = map[word] & (0xffffffff << (start & 31));
+  for (i = 0; i <= nwords; i++)
+    {
+      if (bits != 0)
+        {
+          return (((word << 5) + ffs(bits) - 1) - start) & (nslots - 1);
+        }
+
+      word = (word + 1) & (nwords - 1);
+      bits = map[word];
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+  g_wdexpired = NULL;
+  g_wdbase    = 0;
+  g_wdcount   = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay)
+{
+  DEBUGASSERT(delay > 0);
+
+  /* The current time is the last tick processed */
+
+  wdog->expire = g_wdbase - 1 + (uint32_t)delay;
+  wd_wheel_place(wdog);
+  g_wdcount++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  bool next = false;
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Is this the next timing event?  Then the interval timer must be
+   * reassessed.
+   */
+
+  next = ((unsigned int)wd_wheel_remaining(wdog) == wd_wheel_delay());
+#endif
+
+  wd_wheel_unlink(wdog);
+  g_wdcount--;
+  return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return (int)(wdog->expire - (g_wdbase - 1));
+}
+
+/****************************************************************************
+ * Name: wd_wheel_delay
+ ****************************************************************************/
+
+unsigned int wd_wheel_delay(void)
+{
+  uint32_t delay = UINT32_MAX;
+  uint32_t start;
+  uint32_t span;
+  int level;
+  int dist;
+
+  if (g_wdcount == 0)
+    {
+      return 0;
+    }
+
+  /* The watchdogs in level 0 expire exactly on the tick of their slot */
+
+  dist = wd_wheel_search(0, WD_L0SLOTS, g_wdbase & WD_L0MASK);
+  if (dist >= 0)
+    {
+      delay = dist;
+    }
+
+  /* The watchdogs of a higher level are moved down when the time reaches
+   * the start of their slot.  That is the next timing event for them.
+   */
+
+  for (level = 1; level < WD_NLEVELS; level++)
+    {
+      span  = (uint32_t)1 << WD_SHIFT(level);
+      start = (g_wdbase + span - 1) & ~(span - 1);
+      dist  = wd_wheel_search(WD_LEVEL(level), WD_LNSLOTS,
+                              (start >> WD_SHIFT(level)) & WD_LNMASK);
+      if (dist >= 0 && (start - g_wdbase) + (uint32_t)dist * span < delay)
+        {
+          delay = (start - g_wdbase) + (uint32_t)dist * span;
+        }
+    }
+
+  /* Return the delay relative to the last tick processed.  There are only
+   * expired watchdogs if the wheel itself is empty.
+   */
+
+  return delay == UINT32_MAX ? 0 : delay + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_skip
+ ****************************************************************************/
+
+void wd_wheel_skip(unsigned int ticks)
+{
+  g_wdbase += ticks;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ ****************************************************************************/
+
+bool wd_wheel_advance(void)
+{
+  FAR struct wdog_s *wdog;
+  int index;
+  int level;
+
+  /* At the start of each round of level 0, move the watchdogs of the
+   * current slot of level 1 down; at the start of each round of level 1,
+   * those of level 2, and so on.
+   */
+
+  index = g_wdbase & WD_L0MASK;
+  if (index == 0)
+    {
+      for (level = 1;
+           level < WD_NLEVELS && wd_wheel_cascade(level) == 0;
+           level++);
+    }
+
+  g_wdbase++;
+
+  /* Move the watchdogs that expire on this tick to the expired list */
+
+  wdog = g_wdwheel[index];
+  if (wdog != NULL)
+    {
+      DEBUGASSERT(g_wdexpired == NULL);
+
+      g_wdwheel[index] = NULL;
+      g_wdmap[index >> 5] &= ~(1u << (index & 31));
+
+      g_wdexpired = wdog;
+      wdog->pprev = &g_wdexpired;
+    }
+
+  return g_wdexpired != NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+  FAR struct wdog_s *wdog = g_wdexpired;
+
+  if (wdog != NULL)
+    {
+      wd_wheel_unlink(wdog);
+      g_wdcount--;
+    }
+
+  return wdog;
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
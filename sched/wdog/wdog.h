@@ -46,7 +46,34 @@
 #include <stdbool.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/mm/mempool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* In SMP configurations, the watchdog lists may be protected by a
+ * subsystem spinlock rather than by the global critical section.  This is
+ * not possible in the tickless mode where the watchdog logic is re-entered
+ * from the interval timer logic.  In all other configurations, wd_lock()
+ * is simply the critical section.
+ *
+ * Lock ordering:  If both the critical section and the watchdog lock are
+ * required, the critical section must be entered first.
+ */
+
+#if defined(CONFIG_SPINLOCK_SUBSYS) && !defined(CONFIG_SCHED_TICKLESS)
+#  define HAVE_WDOG_LOCK 1
+#  define wd_lock()      subsys_lock(&g_wdlock)
+#  define wd_unlock(f)   subsys_unlock(&g_wdlock, (f))
+#else
+#  undef  HAVE_WDOG_LOCK
+#  define wd_lock()      enter_critical_section()
+#  define wd_unlock(f)   leave_critical_section(f)
+#endif
 
 /****************************************************************************
  * Public Data
@@ -60,25 +87,37 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* The g_wdpool is the pool of pre-allocated watchdogs available to the
+ * system for delayed function use.  CONFIG_WDOG_INTRESERVE watchdogs in
+ * the pool are reserved for interrupt handlers.
  */
 
-extern sq_queue_t g_wdfreelist;
+extern struct mempool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
+#ifdef HAVE_WDOG_LOCK
+/* This spinlock protects g_wdactivelist (or the timer wheel) */
+
+extern struct subsys_lock_s g_wdlock;
+#endif
+
+#ifdef CONFIG_WDOG_SLACK
+/* Timer slack statistics:  The number of watchdogs whose expiration was
+ * deferred onto that of another active watchdog (i.e., the number of
+ * wakeups saved) and the total number of ticks by which they were deferred.
  */
 
-extern uint16_t g_wdnfree;
+extern uint32_t g_wdcoalesced;
+extern uint32_t g_wdslackticks;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -158,6 +197,41 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/****************************************************************************
+ * Timer wheel interfaces (wd_wheel.c)
+ *
+ *   wd_wheel_initialize - Initialize the (empty) timer wheel
+ *   wd_wheel_insert     - Start a watchdog that expires after 'delay' > 0
+ *                         calls to wd_wheel_advance()
+ *   wd_wheel_remove     - Remove an active watchdog.  Returns true if the
+ *                         watchdog was the next timing event in the
+ *                         tickless mode.
+ *   wd_wheel_remaining  - Ticks remaining until a watchdog expires
+ *   wd_wheel_delay      - Ticks until the next timing event (a watchdog
+ *                         expiration or a move between levels) or zero if
+ *                         no watchdog is active
+ *   wd_wheel_skip       - Advance the time by 'ticks' that contain no
+ *                         timing events
+ *   wd_wheel_advance    - Advance the time by one tick.  Returns true if
+ *                         watchdogs expired on that tick.
+ *   wd_wheel_expired    - Remove and return the next watchdog that expired
+ *                         on the last tick, or NULL when there are no more.
+ *
+ * All must be called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void);
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+int  wd_wheel_remaining(FAR struct wdog_s *wdog);
+unsigned int wd_wheel_delay(void);
+void wd_wheel_skip(unsigned int ticks);
+bool wd_wheel_advance(void);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -156,6 +156,15 @@ int work_cancel(int qid, FAR struct work_s *work)
       return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
     }
   else
+#endif
+#ifdef CONFIG_SCHED_WORKPOOL
+  if (qid >= WORKPOOL_BASE)
+    {
+      /* Cancel work queued to a work queue pool */
+
+      return work_pool_cancel(qid, work);
+    }
+  else
 #endif
     {
       return -EINVAL;
@@ -48,6 +48,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/clock.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_HPWORK
@@ -166,6 +167,15 @@ int work_hpstart(void)
       return (int)pid;
     }
 
+#ifdef CONFIG_SMP_ISOLCPUS
+  /* Keep the worker thread off of the isolated CPUs */
+
+  {
+    cpu_set_t cpuset = SCHED_HOUSEKEEPING_CPUS;
+    (void)nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+  }
+#endif
+
   g_hpwork.worker[0].pid  = pid;
   g_hpwork.worker[0].busy = true;
   return pid;
@@ -51,6 +51,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/clock.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -214,6 +215,15 @@ int work_lpstart(void)
           return (int)pid;
         }
 
+#ifdef CONFIG_SMP_ISOLCPUS
+      /* Keep the worker threads off of the isolated CPUs */
+
+      {
+        cpu_set_t cpuset = SCHED_HOUSEKEEPING_CPUS;
+        (void)nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+      }
+#endif
+
       g_lpwork.worker[wndx].pid  = pid;
       g_lpwork.worker[wndx].busy = true;
     }
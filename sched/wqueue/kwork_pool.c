@@ -0,0 +1,548 @@
+/****************************************************************************
+ * sched/wqueue/kwork_pool.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKPOOL
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The work queue pools and the number of pools created */
+
+struct kwork_pool_s g_workpool[CONFIG_SCHED_WORKPOOL_NPOOLS];
+uint8_t g_nworkpools;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_pool_get
+ *
+ * Description:
+ *   Return the pool corresponding to a pool work queue ID or NULL if the
+ *   ID does not refer to a pool that has been created.
+ *
+ ****************************************************************************/
+
+static FAR struct kwork_pool_s *work_pool_get(int qid)
+{
+  int ndx = qid - WORKPOOL_BASE;
+
+  if (ndx < 0 || ndx >= g_nworkpools)
+    {
+      return NULL;
+    }
+
+  return &g_workpool[ndx];
+}
+
+/****************************************************************************
+ * Name: work_pool_wakeup
+ *
+ * Description:
+ *   Wake up one worker thread of a pool queue.  The semaphore is posted
+ *   only if there is a waiting worker thread or no wakeup is already
+ *   pending.  A redundant wakeup only causes one extra scan of the queue.
+ *
+ ****************************************************************************/
+
+static void work_pool_wakeup(FAR struct kwork_pqueue_s *pq)
+{
+  int sval;
+
+  if (nxsem_getvalue(&pq->sem, &sval) < 0 || sval <= 0)
+    {
+      (void)nxsem_post(&pq->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: work_pool_remove
+ *
+ * Description:
+ *   Remove pending work from the pool queue that holds it.  Returns true if
+ *   the work was pending.
+ *
+ ****************************************************************************/
+
+static bool work_pool_remove(FAR struct work_s *work)
+{
+  FAR struct kwork_pqueue_s *pq;
+  irqstate_t flags;
+  bool pending = false;
+
+  pq = (FAR struct kwork_pqueue_s *)work->pqueue;
+  if (pq != NULL)
+    {
+      flags = work_pool_lock(pq);
+
+      /* Check again now that we hold the lock:  The work may have been
+       * dequeued by a worker thread in the meantime.
+       */
+
+      if (work->pqueue == pq)
+        {
+          if (work->worker != NULL)
+            {
+              dq_rem((FAR dq_entry_t *)work, &pq->q);
+              work->worker = NULL;
+              pending      = true;
+            }
+
+          work->pqueue = NULL;
+        }
+
+      work_pool_unlock(pq, flags);
+    }
+
+  return pending;
+}
+
+/****************************************************************************
+ * Name: work_pool_thread
+ *
+ * Description:
+ *   The worker threads of the work queue pools.  argv[1] is the index of
+ *   the pool and argv[2] is the index of the queue within the pool.
+ *
+ ****************************************************************************/
+
+static int work_pool_thread(int argc, FAR char *argv[])
+{
+  FAR struct kwork_pool_s *pool;
+  FAR struct kwork_pqueue_s *pq;
+  FAR struct work_s *work;
+  FAR struct work_s *next;
+  irqstate_t flags;
+  systime_t elapsed;
+  systime_t wait;
+  systime_t now;
+  worker_t worker;
+  FAR void *arg;
+  int ret;
+
+  DEBUGASSERT(argc == 3);
+
+  pool = &g_workpool[atoi(argv[1])];
+  pq   = &pool->pq[atoi(argv[2])];
+
+  for (; ; )
+    {
+      /* Find the first work in the queue that is ready and the time until
+       * the next delayed work becomes ready.
+       */
+
+      worker = NULL;
+      arg    = NULL;
+      wait   = 0;
+
+      flags  = work_pool_lock(pq);
+      now    = clock_systimer();
+
+      for (work = (FAR struct work_s *)pq->q.head; work != NULL; work = next)
+        {
+          next    = (FAR struct work_s *)work->dq.flink;
+          elapsed = now - work->qtime;
+
+          if (elapsed >= work->delay)
+            {
+              /* Dequeue the work and capture the work description before
+               * releasing the lock:  The work structure may be re-used as
+               * soon as the work is dequeued.
+               */
+
+              dq_rem((FAR dq_entry_t *)work, &pq->q);
+
+              worker       = work->worker;
+              arg          = work->arg;
+              work->worker = NULL;
+              work->pqueue = NULL;
+              break;
+            }
+          else if (wait == 0 || work->delay - elapsed < wait)
+            {
+              wait = work->delay - elapsed;
+            }
+        }
+
+      work_pool_unlock(pq, flags);
+
+      if (worker != NULL)
+        {
+          /* Wait for an execution slot if the concurrency of the pool is
+           * limited.
+           */
+
+          if (pool->limited)
+            {
+              do
+                {
+                  ret = nxsem_wait(&pool->active);
+                }
+              while (ret == -EINTR);
+            }
+
+          worker(arg);
+
+          if (pool->limited)
+            {
+              (void)nxsem_post(&pool->active);
+            }
+        }
+      else if (wait > 0)
+        {
+          /* Wait until the next delayed work is ready or until new work is
+           * queued.
+           */
+
+          (void)nxsem_tickwait(&pq->sem, clock_systimer(), wait);
+        }
+      else
+        {
+          /* Wait until new work is queued */
+
+          (void)nxsem_wait(&pq->sem);
+        }
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_pool_create
+ *
+ * Description:
+ *   Create a new kernel work queue pool and start its worker threads.
+ *
+ * Input Parameters:
+ *   name      - The name of the worker threads
+ *   priority  - The priority of the worker threads
+ *   stacksize - The stack size of the worker threads
+ *   nthreads  - The number of worker threads per queue
+ *   maxactive - The maximum number of work items of the pool that may
+ *               execute at the same time or zero for no limit
+ *   flags     - Zero or WORKPOOL_PERCPU
+ *
+ * Returned Value:
+ *   The work queue ID of the new pool is returned on success.  A negated
+ *   errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int work_pool_create(FAR const char *name, int priority, int stacksize,
+                     int nthreads, int maxactive, uint8_t flags)
+{
+  FAR struct kwork_pool_s *pool;
+  FAR struct kwork_pqueue_s *pq;
+  FAR char *argv[3];
+  char poolstr[4];
+  char queuestr[4];
+  pid_t pid;
+  int ndx;
+  int qndx;
+  int i;
+
+  if (name == NULL || nthreads < 1 ||
+      nthreads > CONFIG_SCHED_WORKPOOL_NTHREADS || maxactive < 0)
+    {
+      return -EINVAL;
+    }
+
+  sched_lock();
+
+  ndx = g_nworkpools;
+  if (ndx >= CONFIG_SCHED_WORKPOOL_NPOOLS)
+    {
+      sched_unlock();
+      return -ENOMEM;
+    }
+
+  /* Initialize the pool */
+
+  pool = &g_workpool[ndx];
+  memset(pool, 0, sizeof(struct kwork_pool_s));
+
+  pool->flags   = flags;
+  pool->nqueues = (flags & WORKPOOL_PERCPU) != 0 ? WORKPOOL_NQUEUES : 1;
+  pool->limited = (maxactive > 0);
+
+  if (pool->limited)
+    {
+      (void)nxsem_init(&pool->active, 0, maxactive);
+    }
+
+  for (qndx = 0; qndx < pool->nqueues; qndx++)
+    {
+      pq = &pool->pq[qndx];
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+      pq->lock.sl_lock = SP_UNLOCKED;
+#ifdef CONFIG_SPINLOCK_SUBSYS_STATISTICS
+      pq->lock.sl_name = name;
+#endif
+#endif
+      dq_init(&pq->q);
+
+      /* The queue semaphore is used for signaling and, hence, should not
+       * have priority inheritance enabled.
+       */
+
+      (void)nxsem_init(&pq->sem, 0, 0);
+      (void)nxsem_setprotocol(&pq->sem, SEM_PRIO_NONE);
+      pq->pool = pool;
+    }
+
+  /* Make the pool visible before its worker threads run.  The threads
+   * cannot run until the scheduler is unlocked.
+   */
+
+  g_nworkpools = ndx + 1;
+
+  /* Start the worker threads of each queue */
+
+  snprintf(poolstr, sizeof(poolstr), "%d", ndx);
+  argv[0] = poolstr;
+  argv[1] = queuestr;
+  argv[2] = NULL;
+
+  sinfo("Starting work queue pool %s\n", name);
+
+  for (qndx = 0; qndx < pool->nqueues; qndx++)
+    {
+      snprintf(queuestr, sizeof(queuestr), "%d", qndx);
+
+      for (i = 0; i < nthreads; i++)
+        {
+          pid = kthread_create(name, priority, stacksize,
+                               (main_t)work_pool_thread,
+                               (FAR char * const *)argv);
+          if (pid < 0)
+            {
+              serr("ERROR: kthread_create %s failed: %d\n", name, (int)pid);
+              sched_unlock();
+              return (int)pid;
+            }
+
+#ifdef CONFIG_SMP
+          /* Pin the worker threads of a per-CPU queue to their CPU */
+
+          if ((flags & WORKPOOL_PERCPU) != 0)
+            {
+              cpu_set_t cpuset;
+
+              CPU_ZERO(&cpuset);
+              CPU_SET(qndx, &cpuset);
+              (void)nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+            }
+#ifdef CONFIG_SMP_ISOLCPUS
+          else
+            {
+              /* Keep the worker threads off of the isolated CPUs */
+
+              cpu_set_t cpuset = SCHED_HOUSEKEEPING_CPUS;
+              (void)nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+            }
+#endif
+#endif
+        }
+    }
+
+  sched_unlock();
+  return WORKPOOL_BASE + ndx;
+}
+
+/****************************************************************************
+ * Name: work_pool_queue
+ *
+ * Description:
+ *   Queue work to a work queue pool.  A negative 'cpu' selects the queue of
+ *   the calling CPU.  The work is protected only by the lock of the
+ *   selected queue so that work may be queued to different CPUs, including
+ *   from interrupt handlers, without contention.
+ *
+ ****************************************************************************/
+
+int work_pool_queue(int qid, int cpu, FAR struct work_s *work,
+                    worker_t worker, FAR void *arg, systime_t delay)
+{
+  FAR struct kwork_pool_s *pool;
+  FAR struct kwork_pqueue_s *pq;
+  irqstate_t flags;
+
+  DEBUGASSERT(work != NULL && worker != NULL);
+
+  pool = work_pool_get(qid);
+  if (pool == NULL || cpu >= WORKPOOL_NQUEUES)
+    {
+      return -EINVAL;
+    }
+
+  /* Select the queue */
+
+  if (pool->nqueues == 1)
+    {
+      pq = &pool->pq[0];
+    }
+  else
+    {
+      pq = &pool->pq[cpu < 0 ? this_cpu() : cpu];
+    }
+
+  /* Is there already pending work?  If so, it is removed and re-queued at
+   * the end of the selected queue.
+   */
+
+  (void)work_pool_remove(work);
+
+  flags = work_pool_lock(pq);
+
+  work->worker = worker;           /* Work callback. non-NULL means queued */
+  work->arg    = arg;              /* Callback argument */
+  work->delay  = delay;            /* Delay until work performed */
+  work->qtime  = clock_systimer(); /* Time work queued */
+  work->pqueue = pq;               /* Queue holding the work */
+
+  dq_addlast((FAR dq_entry_t *)work, &pq->q);
+  work_pool_unlock(pq, flags);
+
+  /* Wake up a worker thread to perform the work or to re-assess the delay */
+
+  work_pool_wakeup(pq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_pool_cancel
+ *
+ * Description:
+ *   Cancel work previously queued to a work queue pool.
+ *
+ ****************************************************************************/
+
+int work_pool_cancel(int qid, FAR struct work_s *work)
+{
+  DEBUGASSERT(work != NULL);
+
+  if (work_pool_get(qid) == NULL)
+    {
+      return -EINVAL;
+    }
+
+  return work_pool_remove(work) ? OK : -ENOENT;
+}
+
+/****************************************************************************
+ * Name: work_pool_signal
+ *
+ * Description:
+ *   Wake up a worker thread of each queue of a pool.
+ *
+ ****************************************************************************/
+
+int work_pool_signal(int qid)
+{
+  FAR struct kwork_pool_s *pool;
+  int qndx;
+
+  pool = work_pool_get(qid);
+  if (pool == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (qndx = 0; qndx < pool->nqueues; qndx++)
+    {
+      work_pool_wakeup(&pool->pq[qndx]);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Like work_queue(), but queue the work to the queue of a specific CPU of
+ *   a per-CPU work queue pool.  For other work queues, the CPU is ignored.
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, systime_t delay)
+{
+  if (qid >= WORKPOOL_BASE)
+    {
+      if (cpu < 0)
+        {
+          return -EINVAL;
+        }
+
+      return work_pool_queue(qid, cpu, work, worker, arg, delay);
+    }
+
+  return work_queue(qid, work, worker, arg, delay);
+}
+
+#endif /* CONFIG_SCHED_WORKPOOL */
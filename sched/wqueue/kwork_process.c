@@ -112,6 +112,12 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx)
   next  = period;
   flags = enter_critical_section();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  /* Any pending signal is handled by this pass over the work queue */
+
+  wqueue->signaled = false;
+#endif
+
   /* Get the time that we started this polling cycle in clock ticks. */
 
   stick = clock_systimer();
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -82,15 +83,20 @@
  *            is invoked. Zero means to perform the work immediately.
  *
  * Returned Value:
- *   None
+ *   True if the work was queued; false if the request was coalesced into
+ *   the identical work that was already pending.
  *
  ****************************************************************************/
 
-static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
+static bool work_qqueue(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work, worker_t worker,
                         FAR void *arg, systime_t delay)
 {
   irqstate_t flags;
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  systime_t now;
+  systime_t early;
+#endif
 
   DEBUGASSERT(work != NULL && worker != NULL);
 
@@ -100,6 +106,30 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  wqueue->stats.queued++;
+
+  /* Is the same work already pending?  If so, keep the pending work if it
+   * will be performed no later than requested and no more than the
+   * coalescing window before that.  Then the work stays in place in the
+   * queue and the worker need not be signaled.
+   */
+
+  if (work->worker == worker && work->arg == arg)
+    {
+      now   = clock_systimer();
+      early = (now + delay) - (work->qtime + work->delay);
+
+      if ((ssystime_t)early >= 0 &&
+          early <= CONFIG_SCHED_WORKQUEUE_BATCH_WINDOW)
+        {
+          wqueue->stats.coalesced++;
+          leave_critical_section(flags);
+          return false;
+        }
+    }
+#endif
+
   /* Is there already pending work? */
 
   if (work->worker != NULL)
@@ -124,6 +154,7 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
   dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
 
   leave_critical_section(flags);
+  return true;
 }
 
 /****************************************************************************
@@ -169,7 +200,12 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Queue high priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
+      if (!work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work,
+                       worker, arg, delay))
+        {
+          return OK;
+        }
+
       return work_signal(HPWORK);
     }
   else
@@ -179,10 +215,24 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Queue low priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
+      if (!work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work,
+                       worker, arg, delay))
+        {
+          return OK;
+        }
+
       return work_signal(LPWORK);
     }
   else
+#endif
+#ifdef CONFIG_SCHED_WORKPOOL
+  if (qid >= WORKPOOL_BASE)
+    {
+      /* Queue work to the calling CPU's queue of a work queue pool */
+
+      return work_pool_queue(qid, -1, work, worker, arg, delay);
+    }
+  else
 #endif
     {
       return -EINVAL;
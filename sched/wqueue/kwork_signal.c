@@ -42,6 +42,7 @@
 #include <signal.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/signal.h>
 
@@ -71,6 +72,10 @@
 
 int work_signal(int qid)
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t flags;
+#endif
   pid_t pid;
 
   /* Get the process ID of the worker thread */
@@ -79,6 +84,9 @@ int work_signal(int qid)
   if (qid == HPWORK)
     {
       pid = g_hpwork.worker[0].pid;
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+      wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
+#endif
     }
   else
 #endif
@@ -111,6 +119,18 @@ int work_signal(int qid)
       /* Otherwise, signal the first IDLE thread found */
 
       pid = g_lpwork.worker[i].pid;
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+      wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
+#endif
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_WORKPOOL
+  if (qid >= WORKPOOL_BASE)
+    {
+      /* Work queue pools are woken up by their semaphores */
+
+      return work_pool_signal(qid);
     }
   else
 #endif
@@ -118,6 +138,24 @@ int work_signal(int qid)
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  /* Don't signal again if a previous signal has not yet been handled:  The
+   * worker will examine the whole work queue when it runs.
+   */
+
+  flags = enter_critical_section();
+  if (wqueue->signaled)
+    {
+      wqueue->stats.suppressed++;
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  wqueue->signaled = true;
+  wqueue->stats.signals++;
+  leave_critical_section(flags);
+#endif
+
   /* Signal the worker thread */
 
   return nxsig_kill(pid, SIGWORK);
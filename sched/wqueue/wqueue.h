@@ -43,10 +43,14 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <semaphore.h>
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -59,6 +63,34 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Work queue pools *********************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL
+
+/* A per-CPU pool has one queue per CPU */
+
+#ifdef CONFIG_SMP
+#  define WORKPOOL_NQUEUES CONFIG_SMP_NCPUS
+#else
+#  define WORKPOOL_NQUEUES 1
+#endif
+
+/* Each queue of a pool is protected by its own subsystem spinlock, if
+ * available, so that work may be queued to the queue of one CPU without
+ * stalling the other CPUs in the global critical section.  Otherwise, the
+ * queue is protected by the critical section.
+ */
+
+#ifdef CONFIG_SPINLOCK_SUBSYS
+#  define work_pool_lock(p)     subsys_lock(&(p)->lock)
+#  define work_pool_unlock(p,f) subsys_unlock(&(p)->lock, (f))
+#else
+#  define work_pool_lock(p)     enter_critical_section()
+#  define work_pool_unlock(p,f) leave_critical_section(f)
+#endif
+
+#endif /* CONFIG_SCHED_WORKPOOL */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -76,6 +108,10 @@ struct kwork_wqueue_s
 {
   systime_t         delay;     /* Delay between polling cycles (ticks) */
   struct dq_queue_s q;         /* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  volatile bool     signaled;  /* A signal is pending for the worker */
+  struct work_stats_s stats;   /* Batching statistics */
+#endif
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -88,6 +124,10 @@ struct hp_wqueue_s
 {
   systime_t         delay;     /* Delay between polling cycles (ticks) */
   struct dq_queue_s q;         /* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  volatile bool     signaled;  /* A signal is pending for the worker */
+  struct work_stats_s stats;   /* Batching statistics */
+#endif
   struct kworker_s  worker[1]; /* Describes the single high priority worker */
 };
 #endif
@@ -101,6 +141,10 @@ struct lp_wqueue_s
 {
   systime_t         delay;  /* Delay between polling cycles (ticks) */
   struct dq_queue_s q;      /* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_BATCH
+  volatile bool     signaled;  /* A signal is pending for a worker */
+  struct work_stats_s stats;   /* Batching statistics */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -108,6 +152,32 @@ struct lp_wqueue_s
 };
 #endif
 
+#ifdef CONFIG_SCHED_WORKPOOL
+/* This structure describes one queue of a work queue pool */
+
+struct kwork_pool_s;
+struct kwork_pqueue_s
+{
+#ifdef CONFIG_SPINLOCK_SUBSYS
+  struct subsys_lock_s lock;       /* Protects the queue */
+#endif
+  struct dq_queue_s q;             /* The queue of pending work */
+  sem_t             sem;           /* Wakes up the worker threads */
+  FAR struct kwork_pool_s *pool;   /* The pool that owns the queue */
+};
+
+/* This structure describes one work queue pool */
+
+struct kwork_pool_s
+{
+  uint8_t           flags;         /* See WORKPOOL_* definitions */
+  uint8_t           nqueues;       /* Number of queues in pq[] */
+  bool              limited;       /* True: Concurrency is limited */
+  sem_t             active;        /* Counts the free execution slots */
+  struct kwork_pqueue_s pq[WORKPOOL_NQUEUES];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -124,6 +194,13 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#ifdef CONFIG_SCHED_WORKPOOL
+/* The work queue pools and the number of pools created */
+
+extern struct kwork_pool_s g_workpool[CONFIG_SCHED_WORKPOOL_NPOOLS];
+extern uint8_t g_nworkpools;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -187,5 +264,25 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx);
 
+/****************************************************************************
+ * Name: work_pool_queue, work_pool_cancel, and work_pool_signal
+ *
+ * Description:
+ *   The work_queue(), work_cancel(), and work_signal() logic for work queue
+ *   pools.  'qid' must be a pool work queue ID.  For work_pool_queue(), a
+ *   negative 'cpu' selects the queue of the calling CPU.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKPOOL
+int work_pool_queue(int qid, int cpu, FAR struct work_s *work,
+                    worker_t worker, FAR void *arg, systime_t delay);
+int work_pool_cancel(int qid, FAR struct work_s *work);
+int work_pool_signal(int qid);
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
 #endif /* __SCHED_WQUEUE_WQUEUE_H */
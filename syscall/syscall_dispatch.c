@@ -0,0 +1,226 @@
+/****************************************************************************
+ * syscall/syscall_dispatch.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <syscall.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL) && defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* All stubs are called with the same parameters.  Stubs ignore the
+ * parameters that they do not use.
+ */
+
+typedef uintptr_t (*syscall_stub_t)(unsigned int nbr, uintptr_t parm1,
+                                    uintptr_t parm2, uintptr_t parm3,
+                                    uintptr_t parm4, uintptr_t parm5,
+                                    uintptr_t parm6);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_STATS
+/* Per-system call statistics */
+
+struct syscall_stats_s g_syscallstats[SYS_nsyscalls];
+
+/* System call names for /proc/sched/syscall */
+
+FAR const char * const g_syscallnames[SYS_nsyscalls] =
+{
+#  undef SYSCALL_LOOKUP1
+#  define SYSCALL_LOOKUP1(f,n,p) #f
+#  undef SYSCALL_LOOKUP
+#  define SYSCALL_LOOKUP(f,n,p)  , #f
+#  include "syscall_lookup.h"
+};
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_dispatch
+ *
+ * Description:
+ *   Call the stub of a system call.  See include/sys/syscall.h.
+ *
+ ****************************************************************************/
+
+uintptr_t syscall_dispatch(unsigned int nbr, uintptr_t parm1,
+                           uintptr_t parm2, uintptr_t parm3,
+                           uintptr_t parm4, uintptr_t parm5,
+                           uintptr_t parm6)
+{
+  syscall_stub_t stub = (syscall_stub_t)g_stublookup[nbr];
+#ifdef CONFIG_SYSCALL_STATS
+  FAR struct syscall_stats_s *stats = &g_syscallstats[nbr];
+  irqstate_t flags;
+  uint32_t elapsed;
+  uint32_t start;
+#endif
+  uintptr_t ret;
+
+#ifdef CONFIG_SYSCALL_STATS
+  start   = up_cyclecount();
+  ret     = stub(nbr, parm1, parm2, parm3, parm4, parm5, parm6);
+  elapsed = up_cyclecount() - start;
+
+  flags = enter_critical_section();
+  stats->count++;
+  stats->cycles += elapsed;
+  if (elapsed > stats->maxcycles)
+    {
+      stats->maxcycles = elapsed;
+    }
+
+  leave_critical_section(flags);
+#else
+  ret = stub(nbr, parm1, parm2, parm3, parm4, parm5, parm6);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syscall_isfast
+ *
+ * Description:
+ *   Return true if the system call may be performed in the system call
+ *   exception handler.  See include/sys/syscall.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_FASTPATH
+bool syscall_isfast(unsigned int nbr)
+{
+  switch (nbr + CONFIG_SYS_RESERVED)
+    {
+      case SYS_getpid:
+      case SYS_get_errno:
+      case SYS_set_errno:
+      case SYS_sched_getparam:
+      case SYS_sched_getscheduler:
+      case SYS_sched_lockcount:
+      case SYS_sem_post:
+      case SYS_sem_trywait:
+      case SYS_clock_systimer:
+      case SYS_clock_getres:
+      case SYS_clock_gettime:
+        return true;
+
+      default:
+        return false;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Perform a vector of system calls.  See include/sys/syscall.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_BATCH
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls)
+{
+  FAR struct syscall_batch_s *call;
+  unsigned int nbr;
+  int i;
+
+  if (calls == NULL || ncalls < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Verify all of the system call numbers first so that a bad batch has
+   * no effect at all.
+   */
+
+  for (i = 0; i < ncalls; i++)
+    {
+      nbr = calls[i].nbr;
+      if (nbr < CONFIG_SYS_RESERVED || nbr >= SYS_maxsyscall ||
+          nbr == SYS_syscall_batch || nbr == SYS__exit || nbr == SYS_exit
+#ifdef CONFIG_ARCH_HAVE_VFORK
+          || nbr == SYS_vfork
+#endif
+         )
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+    }
+
+  for (i = 0, call = calls; i < ncalls; i++, call++)
+    {
+      set_errno(0);
+      call->result  = syscall_dispatch(call->nbr - CONFIG_SYS_RESERVED,
+                                       call->parm[0], call->parm[1],
+                                       call->parm[2], call->parm[3],
+                                       call->parm[4], call->parm[5]);
+      call->errcode = get_errno();
+    }
+
+  set_errno(0);
+  return ncalls;
+}
+#endif
+
+#endif /* CONFIG_LIB_SYSCALL && __KERNEL__ */
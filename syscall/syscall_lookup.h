@@ -285,6 +285,8 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(shmat,                    3, STUB_shmat)
   SYSCALL_LOOKUP(shmctl,                   3, STUB_shmctl)
   SYSCALL_LOOKUP(shmdt,                    1, STUB_shmdt)
+  SYSCALL_LOOKUP(shmwait,                  3, STUB_shmwait)
+  SYSCALL_LOOKUP(shmwake,                  2, STUB_shmwake)
 #endif
 
 /* The following are defined if pthreads are enabled */
@@ -369,7 +371,11 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(listen,                   2, STUB_listen)
   SYSCALL_LOOKUP(recv,                     4, STUB_recv)
   SYSCALL_LOOKUP(recvfrom,                 6, STUB_recvfrom)
+  SYSCALL_LOOKUP(recvmmsg,                 5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(recvmsg,                  3, STUB_recvmsg)
   SYSCALL_LOOKUP(send,                     4, STUB_send)
+  SYSCALL_LOOKUP(sendmmsg,                 4, STUB_sendmmsg)
+  SYSCALL_LOOKUP(sendmsg,                  3, STUB_sendmsg)
   SYSCALL_LOOKUP(sendto,                   6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,               5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                   3, STUB_socket)
@@ -388,6 +394,12 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(getrandom,               2, STUB_getrandom)
 #endif
 
+/* The following is defined only if batched system calls are enabled */
+
+#ifdef CONFIG_SYSCALL_BATCH
+  SYSCALL_LOOKUP(syscall_batch,           2, STUB_syscall_batch)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -92,6 +92,9 @@ static void mac802154_sfevent(FAR const struct ieee802154_radiocb_s *radiocb,
 
 static void mac802154_purge_worker(FAR void *arg);
 
+static FAR struct ieee802154_txdesc_s *
+  mac802154_findindirect(FAR struct ieee802154_privmac_s *priv,
+                         FAR const struct ieee802154_addr_s *addr);
 static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
                                 FAR struct ieee802154_data_ind_s *ind);
 static void mac802154_rxdataframe(FAR struct ieee802154_privmac_s *priv,
@@ -217,6 +220,7 @@ int mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
   primitive = ieee802154_primitive_allocate();
 
   (*txdesc)->purgetime = 0;
+  (*txdesc)->reqtime = clock_systimer();
   (*txdesc)->retrycount = priv->maxretries;
 
   (*txdesc)->conf = &primitive->u.dataconf;
@@ -380,14 +384,24 @@ static void mac802154_notify_worker(FAR void *arg)
   FAR struct ieee802154_privmac_s *priv = (FAR struct ieee802154_privmac_s *)arg;
   FAR struct mac802154_maccb_s *cb;
   FAR struct ieee802154_primitive_s *primitive;
+  sq_queue_t batch;
   int ret;
 
+  /* Take all of the queued primitives at once so that the MAC is locked only
+   * once per batch rather than once per primitive.
+   */
 
   mac802154_lock(priv, false);
-  primitive =
-    (FAR struct ieee802154_primitive_s *)sq_remfirst(&priv->primitive_queue);
+  batch = priv->primitive_queue;
+  sq_init(&priv->primitive_queue);
+  if (!sq_empty(&batch))
+    {
+      priv->stats.rxbatches++;
+    }
+
   mac802154_unlock(priv);
 
+  primitive = (FAR struct ieee802154_primitive_s *)sq_remfirst(&batch);
   while (primitive != NULL)
     {
       /* Data indications are a special case since the frame can only be passed to
@@ -453,12 +467,25 @@ static void mac802154_notify_worker(FAR void *arg)
             }
         }
 
-      /* Get the next primitive then loop */
+      /* Get the next primitive of the batch.  When the batch is exhausted,
+       * pick up any primitives that were queued in the meantime.
+       */
 
-      mac802154_lock(priv, false);
-      primitive =
-        (FAR struct ieee802154_primitive_s *)sq_remfirst(&priv->primitive_queue);
-      mac802154_unlock(priv);
+      primitive = (FAR struct ieee802154_primitive_s *)sq_remfirst(&batch);
+      if (primitive == NULL)
+        {
+          mac802154_lock(priv, false);
+          batch = priv->primitive_queue;
+          sq_init(&priv->primitive_queue);
+          if (!sq_empty(&batch))
+            {
+              priv->stats.rxbatches++;
+            }
+
+          mac802154_unlock(priv);
+
+          primitive = (FAR struct ieee802154_primitive_s *)sq_remfirst(&batch);
+        }
     }
 }
 
@@ -581,6 +608,18 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
 
   while(txdesc != NULL)
     {
+      /* List each destination only once, however many transactions are
+       * pending for it.  The device will keep extracting while the frame
+       * pending bit is set in the data it receives.
+       */
+
+      if (mac802154_findindirect(priv, &txdesc->destaddr) != txdesc)
+        {
+          txdesc = (FAR struct ieee802154_txdesc_s *)
+            sq_next((FAR sq_entry_t *)txdesc);
+          continue;
+        }
+
       if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_SHORT)
         {
           pendsaddr++;
@@ -644,6 +683,8 @@ void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
   /* Link the tx descriptor into the list */
 
   sq_addlast((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+  priv->stats.txindirect++;
+  priv->stats.npending++;
 
   /* Update the timestamp for purging the transaction */
 
@@ -737,6 +778,8 @@ static void mac802154_purge_worker(FAR void *arg)
         /* Unlink the transaction */
 
         sq_remfirst(&priv->indirect_queue);
+        priv->stats.txpurged++;
+        priv->stats.npending--;
 
         /* Free the IOB, the notification, and the tx descriptor */
 
@@ -894,6 +937,22 @@ static void mac802154_txdone_worker(FAR void *arg)
         {
           case IEEE802154_FRAME_DATA:
             {
+              if (txdesc->conf->status == IEEE802154_STATUS_SUCCESS)
+                {
+                  uint32_t latency = clock_systimer() - txdesc->reqtime;
+
+                  priv->stats.txdata++;
+                  priv->stats.txlatency += latency;
+                  if (latency > priv->stats.txlatencymax)
+                    {
+                      priv->stats.txlatencymax = latency;
+                    }
+                }
+              else
+                {
+                  priv->stats.txfail++;
+                }
+
               primitive->type = IEEE802154_PRIMITIVE_CONF_DATA;
               mac802154_notify(priv, primitive);
             }
@@ -1260,6 +1319,7 @@ static void mac802154_rxdataframe(FAR struct ieee802154_privmac_s *priv,
   /* Get exclusive access to the MAC */
 
   mac802154_lock(priv, false);
+  priv->stats.rxdata++;
 
   /* If we are currently performing a POLL operation and we've
     * received a data response, use the addressing information
@@ -1398,6 +1458,48 @@ static void mac802154_rxdataframe(FAR struct ieee802154_privmac_s *priv,
   mac802154_unlock(priv)
 }
 
+/****************************************************************************
+ * Name: mac802154_findindirect
+ *
+ * Description:
+ *   Find the oldest indirect transaction pending for a destination address.
+ *
+ * Assumptions:
+ *    Called with the MAC locked
+ *
+ ****************************************************************************/
+
+static FAR struct ieee802154_txdesc_s *
+  mac802154_findindirect(FAR struct ieee802154_privmac_s *priv,
+                         FAR const struct ieee802154_addr_s *addr)
+{
+  FAR struct ieee802154_txdesc_s *txdesc;
+
+  for (txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
+       txdesc != NULL;
+       txdesc = (FAR struct ieee802154_txdesc_s *)sq_next((FAR sq_entry_t *)txdesc))
+    {
+      if (txdesc->destaddr.mode != addr->mode)
+        {
+          continue;
+        }
+
+      if (addr->mode == IEEE802154_ADDRMODE_SHORT &&
+          IEEE802154_SADDRCMP(txdesc->destaddr.saddr, addr->saddr))
+        {
+          return txdesc;
+        }
+
+      if (addr->mode == IEEE802154_ADDRMODE_EXTENDED &&
+          IEEE802154_EADDRCMP(txdesc->destaddr.eaddr, addr->eaddr))
+        {
+          return txdesc;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: mac802154_rxdatareq
  *
@@ -1428,60 +1530,39 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
    * need to check for this condition.
    */
 
-  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
-
-  while(txdesc != NULL)
+  txdesc = mac802154_findindirect(priv, &ind->src);
+  if (txdesc != NULL)
     {
-      if (txdesc->destaddr.mode == ind->src.mode)
-        {
-          if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_SHORT)
-            {
-              if (IEEE802154_SADDRCMP(txdesc->destaddr.saddr, ind->src.saddr))
-                {
-                  /* Remove the transaction from the queue */
-
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
-
-                  /* NOTE: We don't do anything with the purge timeout, because
-                   * we really don't need to. As of now, I see no disadvantage
-                   * to just letting the timeout expire, which won't purge the
-                   * transaction since it is no longer on the list, and then it
-                   * will reschedule the next timeout appropriately. The logic
-                   * otherwise may get complicated even though it may save a few
-                   * clock cycles.
-                   */
+      /* Remove the transaction from the queue */
 
-                  /* The addresses match, send the transaction immediately */
-
-                  priv->radio->txdelayed(priv->radio, txdesc, 0);
-                  priv->beaconupdate = true;
-                  mac802154_unlock(priv)
-                  return;
-                }
-            }
-          else if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_EXTENDED)
-            {
-              if (IEEE802154_EADDRCMP(txdesc->destaddr.eaddr, ind->src.eaddr))
-                {
-                  /* Remove the transaction from the queue */
+      sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+      priv->stats.npending--;
 
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+      /* NOTE: We don't do anything with the purge timeout, because we
+       * really don't need to. As of now, I see no disadvantage to just
+       * letting the timeout expire, which won't purge the transaction since
+       * it is no longer on the list, and then it will reschedule the next
+       * timeout appropriately. The logic otherwise may get complicated even
+       * though it may save a few clock cycles.
+       */
 
-                  /* The addresses match, send the transaction immediately */
+      /* If more transactions are pending for the same device, set the frame
+       * pending bit so that the device extracts them without waiting for
+       * the next beacon. [1] pg. 43
+       */
 
-                  priv->radio->txdelayed(priv->radio, txdesc, 0);
-                  priv->beaconupdate = true;
-                  mac802154_unlock(priv)
-                  return;
-                }
-            }
-          else
-            {
-              DEBUGASSERT(false);
-            }
+      if (mac802154_findindirect(priv, &ind->src) != NULL)
+        {
+          frame_ctrl = (FAR uint16_t *)&txdesc->frame->io_data[0];
+          *frame_ctrl |= IEEE802154_FRAMECTRL_PEND;
         }
 
-      txdesc = (FAR struct ieee802154_txdesc_s *)sq_next((FAR sq_entry_t *)txdesc);
+      /* The addresses match, send the transaction immediately */
+
+      priv->radio->txdelayed(priv->radio, txdesc, 0);
+      priv->beaconupdate = true;
+      mac802154_unlock(priv)
+      return;
     }
 
   /* If there is no data frame pending for the requesting device, the coordinator
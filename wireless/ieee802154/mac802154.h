@@ -340,6 +340,17 @@ int mac802154_req_sync(MACHANDLE mac, FAR struct ieee802154_sync_req_s *req);
 
 int mac802154_req_poll(MACHANDLE mac, FAR struct ieee802154_poll_req_s *req);
 
+/****************************************************************************
+ * Name: mac802154_get_stats
+ *
+ * Description:
+ *   Return the throughput and latency counters of the MAC.
+ *
+ ****************************************************************************/
+
+int mac802154_get_stats(MACHANDLE mac,
+                        FAR struct ieee802154_macstats_s *stats);
+
 /****************************************************************************
  * Name: mac802154_resp_associate
  *
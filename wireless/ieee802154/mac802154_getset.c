@@ -230,4 +230,32 @@ int mac802154_req_set(MACHANDLE mac, enum ieee802154_attr_e attr,
         break;
     }
   return ret;
-}
\ No newline at end of file
+}
+/****************************************************************************
+ * Name: mac802154_get_stats
+ *
+ * Description:
+ *   Return the throughput and latency counters of the MAC.  This is not an
+ *   IEEE 802.15.4 primitive; it is provided for tuning and diagnostics.
+ *
+ ****************************************************************************/
+
+int mac802154_get_stats(MACHANDLE mac,
+                        FAR struct ieee802154_macstats_s *stats)
+{
+  FAR struct ieee802154_privmac_s *priv =
+    (FAR struct ieee802154_privmac_s *)mac;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && stats != NULL);
+
+  ret = mac802154_lock(priv, true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(stats, &priv->stats, sizeof(struct ieee802154_macstats_s));
+  mac802154_unlock(priv)
+  return OK;
+}
@@ -194,6 +194,10 @@ struct ieee802154_privmac_s
 
   sq_queue_t dataind_queue;
 
+  /* Throughput and latency counters */
+
+  struct ieee802154_macstats_s stats;
+
   /************* Fields related to addressing and coordinator *****************/
 
   /* Holds all address information (Extended, Short, and PAN ID) for the MAC. */
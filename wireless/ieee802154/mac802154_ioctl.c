@@ -156,6 +156,11 @@ int mac802154_ioctl(MACHANDLE mac, int cmd, unsigned long arg)
               ret = mac802154_req_poll(mac, &macarg->pollreq);
             }
             break;
+          case MAC802154IOC_GET_STATS:
+            {
+              ret = mac802154_get_stats(mac, &macarg->stats);
+            }
+            break;
           default:
               wlerr("ERROR: Unrecognized cmd: %d\n", cmd);
               ret = -ENOTTY;